@@ -43,6 +43,8 @@
 
 from __future__ import print_function
 
+import math
+
 import m5
 from m5.objects import *
 from Caches import *
@@ -82,7 +84,9 @@ def config_cache(options, system):
     if options.l2cache and options.elastic_trace_en:
         fatal("When elastic trace is enabled, do not configure L2 caches.")
 
-    if options.l2cache:
+    if options.l2cache and options.l2_interconnect != "xbar":
+        config_sliced_l2(options, system, l2_cache_class)
+    elif options.l2cache:
         # Provide a clock for the L2 and the L1-to-L2 bus here as they
         # are not connected using addTwoLevelCacheHierarchy. Use the
         # same clock as the CPUs.
@@ -166,6 +170,44 @@ def config_cache(options, system):
 
     return system
 
+# Create num_l2caches L2 slices, each of size l2_size, with the
+# addresses interleaved across the slices at cache line granularity,
+# and connect them to the private caches using a ring or mesh with one
+# slice per stop.
+def config_sliced_l2(options, system, l2_cache_class):
+    slices = options.num_l2caches
+    intlv_bits = int(math.log(slices, 2))
+    if 2 ** intlv_bits != slices:
+        fatal("Number of L2 slices must be a power of 2")
+    intlv_low_bit = int(math.log(options.cacheline_size, 2))
+
+    system.tol2bus = L2MeshXBar(clk_domain = system.cpu_clk_domain)
+    if options.l2_interconnect == "ring":
+        system.tol2bus.columns = slices
+        system.tol2bus.torus = True
+    else:
+        columns = int(math.ceil(math.sqrt(slices)))
+        system.tol2bus.columns = columns
+        system.tol2bus.rows = (slices + columns - 1) // columns
+
+    l2s = []
+    for i in xrange(slices):
+        ranges = []
+        for r in system.mem_ranges:
+            ranges.append(AddrRange(r.start, size = r.size(),
+                                    intlvHighBit = \
+                                        intlv_low_bit + intlv_bits - 1,
+                                    intlvBits = intlv_bits,
+                                    intlvMatch = i))
+        l2 = l2_cache_class(clk_domain=system.cpu_clk_domain,
+                            size=options.l2_size,
+                            assoc=options.l2_assoc,
+                            addr_ranges=ranges)
+        l2.cpu_side = system.tol2bus.master
+        l2.mem_side = system.membus.slave
+        l2s.append(l2)
+    system.l2 = l2s
+
 # ExternalSlave provides a "port", but when that port connects to a cache,
 # the connecting CPU SimObject wants to refer to its "cpu_side".
 # The 'ExternalCache' class provides this adaptation by rewriting the name,
@@ -89,9 +89,9 @@ def cpu_names():
     return _cpu_classes.keys()
 
 def config_etrace(cpu_cls, cpu_list, options):
+    # The name of the listener, and thus of the cpu, is prepended to the trace
+    # file names so each cpu of a multi processor system has its own traces.
     if issubclass(cpu_cls, m5.objects.DerivO3CPU):
-        # Assign the same file name to all cpus for now. This must be
-        # revisited when creating elastic traces for multi processor systems.
         for cpu in cpu_list:
             # Attach the elastic trace probe listener. Set the protobuf trace
             # file names. Set the dependency window size equal to the cpu it
@@ -108,9 +108,18 @@ def config_etrace(cpu_cls, cpu_list, options):
             cpu.numROBEntries = 512;
             cpu.LQEntries = 128;
             cpu.SQEntries = 128;
+    elif issubclass(cpu_cls, m5.objects.MinorCPU):
+        for cpu in cpu_list:
+            # The dependency window must cover the instructions in flight in
+            # Execute, which are bounded by its input buffer, the FU
+            # pipelines and the LSQ.
+            cpu.traceListener = m5.objects.MinorElasticTrace(
+                                instFetchTraceFile = options.inst_trace_file,
+                                dataDepTraceFile = options.data_trace_file,
+                                depWindowSize = 128)
     else:
         fatal("%s does not support data dependency tracing. Use a CPU model of"
-              " type or inherited from DerivO3CPU.", cpu_cls)
+              " type or inherited from DerivO3CPU or MinorCPU.", cpu_cls)
 
 # Add all CPUs in the object hierarchy.
 for name, cls in inspect.getmembers(m5.objects, is_cpu_class):
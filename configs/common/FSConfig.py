@@ -713,7 +713,9 @@ def makeDistRoot(testSystem,
                  sync_start,
                  linkspeed,
                  linkdelay,
-                 dumpfile):
+                 dumpfile,
+                 transport = 'tcp',
+                 adaptive_sync = False):
     self = Root(full_system = True)
     self.testsys = testSystem
 
@@ -724,7 +726,9 @@ def makeDistRoot(testSystem,
                                    server_name = server_name,
                                    server_port = server_port,
                                    sync_start = sync_start,
-                                   sync_repeat = sync_repeat)
+                                   sync_repeat = sync_repeat,
+                                   transport = transport,
+                                   adaptive_sync = adaptive_sync)
 
     if hasattr(testSystem, 'realview'):
         self.etherlink.int0 = Parent.testsys.realview.ethernet.interface
@@ -164,6 +164,7 @@ def config_mem(options, system):
                                          None)
     opt_elastic_trace_en = getattr(options, "elastic_trace_en", False)
     opt_mem_ranks = getattr(options, "mem_ranks", None)
+    opt_mem_shared_ctrl = getattr(options, "mem_shared_ctrl", False)
 
     if opt_mem_type == "HMC_2500_1x32":
         HMChost = HMC.config_hmc_host_ctrl(options, system)
@@ -215,9 +216,21 @@ def config_mem(options, system):
     # array of controllers and set their parameters to match their
     # address mapping in the case of a DRAM
     for r in system.mem_ranges:
-        for i in xrange(nbr_mem_ctrls):
+        # Optionally let a single DRAM controller serve all the
+        # channels of the range, scheduling them jointly
+        shared_ctrl = opt_mem_shared_ctrl and nbr_mem_ctrls > 1 and \
+            issubclass(cls, m5.objects.DRAMCtrl)
+        for i in xrange(1 if shared_ctrl else nbr_mem_ctrls):
             mem_ctrl = create_mem_ctrl(cls, r, i, nbr_mem_ctrls, intlv_bits,
                                        intlv_size)
+            if shared_ctrl:
+                mem_ctrl.channel_ranges = \
+                    [ create_mem_ctrl(cls, r, j, nbr_mem_ctrls, intlv_bits,
+                                      intlv_size).range
+                      for j in xrange(nbr_mem_ctrls) ]
+                mem_ctrl.range = m5.objects.AddrRange(r.start,
+                                                      size = r.size())
+
             # Set the number of ranks based on the command-line
             # options if it was explicitly set
             if issubclass(cls, m5.objects.DRAMCtrl) and opt_mem_ranks:
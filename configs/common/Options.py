@@ -82,6 +82,9 @@ def addNoISAOptions(parser):
                       help = "type of memory to use")
     parser.add_option("--mem-channels", type="int", default=1,
                       help = "number of memory channels")
+    parser.add_option("--mem-shared-ctrl", action="store_true",
+                      help = "serve all memory channels from a single "
+                      "DRAM controller")
     parser.add_option("--mem-ranks", type="int", default=None,
                       help = "number of memory ranks per channel")
     parser.add_option("--mem-size", action="store", type="string",
@@ -100,6 +103,10 @@ def addNoISAOptions(parser):
     parser.add_option("--l2cache", action="store_true")
     parser.add_option("--num-dirs", type="int", default=1)
     parser.add_option("--num-l2caches", type="int", default=1)
+    parser.add_option("--l2-interconnect", type="choice", default="xbar",
+                      choices=["xbar", "ring", "mesh"],
+                      help="interconnect between the L1s and the L2, with "
+                      "ring and mesh slicing the L2 in --num-l2caches slices")
     parser.add_option("--num-l3caches", type="int", default=1)
     parser.add_option("--l1d_size", type="string", default="64kB")
     parser.add_option("--l1i_size", type="string", default="32kB")
@@ -186,10 +193,18 @@ def addCommonOptions(parser):
                       default=2200,
                       action="store", type="int",
                       help="Message server listen port\nDEFAULT: 2200")
+    parser.add_option("--dist-transport", default="tcp",
+                      type="choice", choices=["tcp", "shm"],
+                      help="Transport among dist-gem5 processes, shm needs "\
+                      "all of them on the same host\nDEFAULT: tcp")
     parser.add_option("--dist-sync-repeat",
                       default="0us",
                       action="store", type="string",
                       help="Repeat interval for synchronisation barriers among dist-gem5 processes\nDEFAULT: --ethernet-linkdelay")
+    parser.add_option("--dist-adaptive-sync", action="store_true",
+                      help="Let dist-gem5 processes run ahead of each other "\
+                      "by up to --ethernet-linkdelay instead of waiting at "\
+                      "every barrier (use with a shorter --dist-sync-repeat)")
     parser.add_option("--dist-sync-start",
                       default="5200000000000t",
                       action="store", type="string",
@@ -263,6 +278,9 @@ def addCommonOptions(parser):
     parser.add_option("--repeat-switch", action="store", type="int",
         default=None,
         help="switch back and forth between CPUs with period <N>")
+    parser.add_option("--repeat-switch-drain-cpus-only", action="store_true",
+        help="""only drain the CPUs on repeated switches and keep the
+              memory system running""")
     parser.add_option("-s", "--standard-switch", action="store", type="int",
         default=None,
         help="switch from timing to Detailed CPU after warmup period of <N>")
@@ -308,6 +326,15 @@ def addSEOptions(parser):
                       help="Redirect stdout to a file.")
     parser.add_option("--errout", default="",
                       help="Redirect stderr to a file.")
+    parser.add_option("--read-ahead", type="string", default="0B",
+                      help="""Read this much ahead of sequential reads from
+                              input files on a host thread""")
+    parser.add_option("--event-queues", type="int", default=0,
+                      help="""Run the CPUs of a multithreaded workload on
+                              this many event queues (and host threads)""")
+    parser.add_option("--sim-quantum", type="string", default="1us",
+                      help="""Synchronization quantum of the event queues
+                              when using --event-queues""")
 
 def addFSOptions(parser):
     from FSConfig import os_types
@@ -408,7 +408,8 @@ def restoreSimpointCheckpoint():
     print('Exiting @ tick %i because %s' % (m5.curTick(), exit_cause))
     sys.exit(exit_event.getCode())
 
-def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
+def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq,
+                 drain_cpus_only=False):
     print("starting switch loop")
     while True:
         exit_event = m5.simulate(switch_freq)
@@ -417,7 +418,8 @@ def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
         if exit_cause != "simulate() limit reached":
             return exit_event
 
-        m5.switchCpus(testsys, repeat_switch_cpu_list)
+        m5.switchCpus(testsys, repeat_switch_cpu_list,
+                      drain_cpus_only=drain_cpus_only)
 
         tmp_cpu_list = []
         for old_cpu, new_cpu in repeat_switch_cpu_list:
@@ -707,7 +709,8 @@ def run(options, root, testsys, cpu_class):
         # will occur in the benchmark code it self.
         if options.repeat_switch and maxtick > options.repeat_switch:
             exit_event = repeatSwitch(testsys, repeat_switch_cpu_list,
-                                      maxtick, options.repeat_switch)
+                maxtick, options.repeat_switch,
+                options.repeat_switch_drain_cpus_only)
         else:
             exit_event = benchCheckpoints(options, maxtick, cptdir)
 
@@ -56,7 +56,10 @@ def build_switch(options):
                                       sync_start = options.dist_sync_start,
                                       sync_repeat = options.dist_sync_repeat,
                                       is_switch = True,
-                                      num_nodes = options.dist_size)
+                                      num_nodes = options.dist_size,
+                                      transport = options.dist_transport,
+                                      adaptive_sync =
+                                          options.dist_adaptive_sync)
                        for i in xrange(options.dist_size)]
 
     for (i, link) in enumerate(switch.portlink):
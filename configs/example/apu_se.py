@@ -158,6 +158,10 @@ parser.add_option('--fast-forward-pseudo-op', action='store_true',
 parser.add_option('--outOfOrderDataDelivery', action='store_true',
                   default=False, help='enable OoO data delivery in the GM'
                   ' pipeline')
+parser.add_option('--gpu-functional', action='store_true', default=False,
+                  help='execute GPU kernels functionally, without the CU'
+                  ' pipeline, and estimate their run time with a simple'
+                  ' throughput model')
 
 Ruby.define_options(parser)
 
@@ -202,6 +206,7 @@ options.num_sqc = num_sqc # pass this to Ruby
 ########################## Creating the GPU system ########################
 # shader is the GPU
 shader = Shader(n_wf = options.wfs_per_simd,
+                functional_exec = options.gpu_functional,
                 clk_domain = SrcClockDomain(
                     clock = options.GPUClock,
                     voltage_domain = VoltageDomain(
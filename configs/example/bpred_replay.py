@@ -0,0 +1,65 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replays a branch trace through a branch predictor and reports its
+# MPKI without simulating a CPU. See src/cpu/pred/trace_replayer.hh for
+# the trace format. For example:
+#
+#   build/X86/gem5.opt configs/example/bpred_replay.py \
+#       --bpred-type TAGE_SC_L branches.trace
+
+from __future__ import print_function
+
+import argparse
+
+import m5
+from m5.objects import *
+from m5.util import fatal
+
+parser = argparse.ArgumentParser(
+    description="Measure the MPKI of a branch predictor on a trace")
+parser.add_argument("trace", help="Branch trace to replay")
+parser.add_argument("--bpred-type", default="TAGE_SC_L",
+                    help="Branch predictor class (e.g., LTAGE, "
+                    "HashedPerceptronBP, BiModeBP)")
+parser.add_argument("--max-branches", type=int, default=0,
+                    help="Number of branches to replay (default: all)")
+
+args = parser.parse_args()
+
+bpred_class = getattr(m5.objects, args.bpred_type, None)
+if bpred_class is None or not issubclass(bpred_class, BranchPredictor):
+    fatal("%s is not a branch predictor." % args.bpred_type)
+
+root = Root(full_system=False)
+root.replayer = BranchTraceReplayer(bpred=bpred_class(),
+                                    trace_file=args.trace,
+                                    max_branches=args.max_branches)
+
+m5.instantiate()
+exit_event = m5.simulate()
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
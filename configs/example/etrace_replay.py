@@ -71,15 +71,19 @@ if options.cpu_type != "TraceCPU":
     fatal("This is a script for elastic trace replay simulation, use "\
             "--cpu-type=TraceCPU\n");
 
-if options.num_cpus > 1:
-    fatal("This script does not support multi-processor trace replay.\n")
+# To replay the traces of a multi-processor capture, there is one Trace CPU
+# per core and "%d" in the trace file names stands for the core index.
+if options.num_cpus > 1 and not ('%d' in options.inst_trace_file and
+                                 '%d' in options.data_trace_file):
+    fatal("For multi-processor trace replay, the trace file names must "\
+            "contain %d for the index of the core.\n")
 
 # In this case FutureClass will be None as there is not fast forwarding or
 # switching
 (CPUClass, test_mem_mode, FutureClass) = Simulation.setCPUClass(options)
 CPUClass.numThreads = numThreads
 
-system = System(cpu = CPUClass(cpu_id=0),
+system = System(cpu = [CPUClass(cpu_id=i) for i in xrange(options.num_cpus)],
                 mem_mode = test_mem_mode,
                 mem_ranges = [AddrRange(options.mem_size)],
                 cache_line_size = options.cacheline_size)
@@ -111,9 +115,14 @@ for cpu in system.cpu:
 for cpu in system.cpu:
     cpu.createThreads()
 
-# Assign input trace files to the Trace CPU
-system.cpu.instTraceFile=options.inst_trace_file
-system.cpu.dataTraceFile=options.data_trace_file
+# Assign input trace files to the Trace CPUs
+for i, cpu in enumerate(system.cpu):
+    if options.num_cpus > 1:
+        cpu.instTraceFile = options.inst_trace_file % i
+        cpu.dataTraceFile = options.data_trace_file % i
+    else:
+        cpu.instTraceFile = options.inst_trace_file
+        cpu.dataTraceFile = options.data_trace_file
 
 # Configure the classic memory system options
 MemClass = Simulation.setMemClass(options)
@@ -355,7 +355,9 @@ elif len(bm) == 1 and options.dist:
                         options.dist_sync_start,
                         options.ethernet_linkspeed,
                         options.ethernet_linkdelay,
-                        options.etherdump);
+                        options.etherdump,
+                        options.dist_transport,
+                        options.dist_adaptive_sync);
 elif len(bm) == 1:
     root = Root(full_system=True, system=test_sys)
 else:
@@ -82,6 +82,11 @@ parser.add_option("--inj-vnet", type="int", default=-1,
                         0 and 1 are 1-flit, 2 is 5-flit.\
                         Set to -1 to inject randomly in all vnets.")
 
+parser.add_option("--replay-trace", type="string", default="",
+                  help="Replay the messages recorded with --garnet-trace\
+                        instead of generating synthetic traffic. Needs the\
+                        protocol and controllers of the recorded run.")
+
 #
 # Add the ruby specific and protocol specific options
 #
@@ -102,6 +107,12 @@ if options.inj_vnet > 2:
     sys.exit(1)
 
 
+# The testers stay idle during a trace replay, which ends once all
+# messages have been delivered
+if options.replay_trace:
+    options.injectionrate = 0
+    options.sim_cycles = -1
+
 cpus = [ GarnetSyntheticTraffic(
                      num_packets_max=options.num_packets_max,
                      single_sender=options.single_sender_id,
@@ -114,6 +125,10 @@ cpus = [ GarnetSyntheticTraffic(
                      num_dest=options.num_dirs) \
          for i in xrange(options.num_cpus) ]
 
+if options.replay_trace:
+    for cpu in cpus:
+        cpu.response_limit = options.abs_max_tick
+
 # create the desired simulated system
 system = System(cpu = cpus, mem_ranges = [AddrRange(options.mem_size)])
 
@@ -130,6 +145,11 @@ Ruby.create_system(options, False, system)
 system.ruby.clk_domain = SrcClockDomain(clock = options.ruby_clock,
                                         voltage_domain = system.voltage_domain)
 
+if options.replay_trace:
+    system.trace_replay = GarnetTraceReplay(
+        network = system.ruby.network, trace_file = options.replay_trace,
+        clk_domain = system.ruby.clk_domain)
+
 i = 0
 for ruby_port in system.ruby._cpu_ports:
      #
@@ -145,8 +165,10 @@ for ruby_port in system.ruby._cpu_ports:
 root = Root(full_system = False, system = system)
 root.system.mem_mode = 'timing'
 
-# Not much point in this being higher than the L1 latency
-m5.ticks.setGlobalFrequency('1ns')
+# Not much point in this being higher than the L1 latency. Replays use
+# the default frequency of the traced full-system runs.
+if not options.replay_trace:
+    m5.ticks.setGlobalFrequency('1ns')
 
 # instantiate configuration
 m5.instantiate()
@@ -96,6 +96,7 @@ def get_processes(options):
         process = Process(pid = 100 + idx)
         process.executable = wrkld
         process.cwd = os.getcwd()
+        process.read_ahead = options.read_ahead
 
         if options.env:
             with open(options.env, 'r') as f:
@@ -283,4 +284,8 @@ else:
     MemConfig.config_mem(options, system)
 
 root = Root(full_system = False, system = system)
+if options.event_queues > 1:
+    root.auto_event_queues = options.event_queues
+    root.sim_quantum = m5.ticks.fromSeconds(
+        m5.util.convert.anyToLatency(options.sim_quantum))
 Simulation.run(options, root, system, FutureClass)
@@ -41,8 +41,8 @@ def define_options(parser):
     parser.add_option("--mesh-rows", type="int", default=0,
                       help="the number of rows in the mesh topology")
     parser.add_option("--network", type="choice", default="simple",
-                      choices=['simple', 'garnet2.0'],
-                      help="'simple'|'garnet2.0'")
+                      choices=['simple', 'garnet2.0', 'analytical'],
+                      help="'simple'|'garnet2.0'|'analytical'")
     parser.add_option("--router-latency", action="store", type="int",
                       default=1,
                       help="""number of pipeline stages in the garnet router.
@@ -65,7 +65,33 @@ def define_options(parser):
                       help="""routing algorithm in network.
                             0: weight-based table
                             1: XY (for Mesh. see garnet2.0/RoutingUnit.cc)
-                            2: Custom (see garnet2.0/RoutingUnit.cc""")
+                            2: Custom (see garnet2.0/RoutingUnit.cc
+                            3: West-first adaptive (for Mesh)
+                            4: Odd-even adaptive (for Mesh)
+                            5: Minimal adaptive with escape VCs
+                               (for Mesh, needs 2 or more VCs per vnet)""")
+    parser.add_option("--event-driven-throttles", action="store_true",
+                      default=False,
+                      help="""schedule one throttle event per message
+                            instead of one per cycle in the simple
+                            network.""")
+    parser.add_option("--garnet-trace", action="store", type="string",
+                      default="",
+                      help="""record the messages of the garnet network
+                            into this file, which can be replayed by
+                            garnet_synth_traffic.py --replay-trace.""")
+    parser.add_option("--garnet-sample-interval", action="store",
+                      type="int", default=0,
+                      help="""write the link utilization and router
+                            buffer occupancy of the garnet network to
+                            garnet_samples.csv every this many cycles
+                            (0 disables sampling).""")
+    parser.add_option("--garnet-bypass-hpc-max", action="store",
+                      type="int", default=0,
+                      help="""let flits that go straight through an idle
+                            garnet router bypass its pipeline, for at most
+                            this many routers in a row (0 disables
+                            bypassing).""")
     parser.add_option("--network-fault-model", action="store_true",
                       default=False,
                       help="""enable network fault model:
@@ -85,6 +111,13 @@ def create_network(options, ruby):
         RouterClass = GarnetRouter
         InterfaceClass = GarnetNetworkInterface
 
+    elif options.network == "analytical":
+        NetworkClass = AnalyticalNetwork
+        IntLinkClass = BasicIntLink
+        ExtLinkClass = BasicExtLink
+        RouterClass = BasicRouter
+        InterfaceClass = None
+
     else:
         NetworkClass = SimpleNetwork
         IntLinkClass = SimpleIntLink
@@ -107,8 +140,11 @@ def init_network(options, network, InterfaceClass):
         network.ni_flit_size = options.link_width_bits / 8
         network.routing_algorithm = options.routing_algorithm
         network.garnet_deadlock_threshold = options.garnet_deadlock_threshold
+        network.sample_interval = options.garnet_sample_interval
+        network.bypass_hpc_max = options.garnet_bypass_hpc_max
 
     if options.network == "simple":
+        network.event_driven_throttles = options.event_driven_throttles
         network.setup_buffers()
 
     if InterfaceClass != None:
@@ -116,6 +152,14 @@ def init_network(options, network, InterfaceClass):
                   for (i,n) in enumerate(network.ext_links)]
         network.netifs = netifs
 
+    if options.garnet_trace:
+        if options.network != "garnet2.0":
+            fatal("--garnet-trace requires the garnet2.0 network")
+        if "GarnetTraceProbe" not in globals():
+            fatal("Tracing the network requires protobuf support")
+        network.trace_probe = GarnetTraceProbe(
+            trace_file = options.garnet_trace)
+
     if options.network_fault_model:
         assert(options.network == "garnet2.0")
         network.enable_fault_model = True
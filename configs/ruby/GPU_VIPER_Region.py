@@ -340,6 +340,8 @@ class RegionCntrl(RegionDir_Controller, CntrlBase):
             max(self.cacheMemory.dataAccessLatency,
             self.cacheMemory.tagAccessLatency)
         self.ruby_system = ruby_system
+        # Region permissions change on transitions of the whole region
+        self.functional_line_index = False
         self.always_migrate = options.always_migrate
         self.sym_migrate = options.symmetric_migrate
         self.asym_migrate = options.asymmetric_migrate
@@ -381,6 +383,8 @@ class RBCntrl(RegionBuffer_Controller, CntrlBase):
         TCC_bits = int(math.log(options.num_tccs, 2))
         self.TCC_select_num_bits = TCC_bits
         self.ruby_system = ruby_system
+        # Region permissions change on transitions of the whole region
+        self.functional_line_index = False
 
         if options.recycle_latency:
             self.recycle_latency = options.recycle_latency
@@ -63,6 +63,11 @@ def define_options(parser):
     parser.add_option("--access-backing-store", action="store_true", default=False,
                       help="Should ruby maintain a second copy of memory")
 
+    parser.add_option("--ruby-fast-warmup", action="store_true",
+                      default=False,
+                      help="Restore the ruby caches from a checkpoint by "
+                           "installing the recorded lines directly")
+
     # Options related to cache structure
     parser.add_option("--ports", action="store", type="int", default=4,
                       help="used of transitions per cycle which is a proxy \
@@ -191,6 +196,7 @@ def create_system(options, full_system, system, piobus = None, dma_ports = []):
     ruby.number_of_virtual_networks = ruby.network.number_of_virtual_networks
     ruby._cpu_ports = cpu_sequencers
     ruby.num_of_sequencers = len(cpu_sequencers)
+    ruby.fast_warmup = options.ruby_fast_warmup
 
     # Create a backing copy of physical memory in case required
     if options.access_backing_store:
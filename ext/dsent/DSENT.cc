@@ -275,12 +275,22 @@ namespace DSENT
     }
 
     Model *initialize(const char *config_file_name, map<String, String> &config)
+    {
+        return initialize(config_file_name, config, map<String, String>());
+    }
+
+    Model *initialize(const char *config_file_name,
+                      map<String, String> &config,
+                      const map<String, String> &overrides)
     {
         // Init the log file
         Log::allocate("/tmp/dsent.log");
 
         // Init the config file
         LibUtil::readFile(config_file_name, config);
+        for (const auto &it : overrides) {
+            config[it.first] = it.second;
+        }
 
         // Overwrite the technology file
         TechModel *tech_model = constructTechModel(config);
@@ -320,6 +330,13 @@ namespace DSENT
         calc.evaluateString(eval_str, params, ms_model, outputs);
     }
 
+    double query(Model *ms_model, const String &query_str)
+    {
+        const Result* result = (const Result*)DSENT::processQuery(
+            query_str + "@0", ms_model, false);
+        return result->calculateSum();
+    }
+
     DSENTCalculator::DSENTCalculator() {}
 
     DSENTCalculator::~DSENTCalculator() {}
@@ -59,11 +59,21 @@ namespace DSENT
     Model *initialize(const char *config_file_name,
                       std::map<String, String> &config);
 
+    // Like initialize(), but the values in overrides replace the ones
+    // read from the config file before the model is built.
+    Model *initialize(const char *config_file_name,
+                      std::map<String, String> &config,
+                      const std::map<String, String> &overrides);
+
     void finalize(std::map<String, String> &config,
                   Model *ms_model);
 
     void run(const std::map<String, String> &config, Model *ms_model,
              std::map<std::string, double> &outputs);
+
+    // Evaluate a single query such as "Energy>>Router:ReadBuffer"
+    // without printing anything.
+    double query(Model *ms_model, const String &query_str);
 } // namespace DSENT
 
 #endif // __DSENT_DSENT_H__
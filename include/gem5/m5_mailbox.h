@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __GEM5_M5_MAILBOX_H__
+#define __GEM5_M5_MAILBOX_H__
+
+/*
+ * Layout of the m5op mailbox shared between gem5 (dev/m5_mailbox.hh)
+ * and guest code (util/m5/m5_mailbox.c).
+ *
+ * The mailbox is ordinary memory as far as the guest is concerned, so
+ * posting to it never traps, even under KVM. It holds:
+ *
+ *  - a header, padded to 64 bytes;
+ *  - a ring of num_entries entries carrying m5ops that don't need an
+ *    immediate answer (work and region markers). Producers reserve a
+ *    slot by advancing head with a compare-and-swap, fill it in and
+ *    then publish it by storing seq = slot + 1 with release semantics.
+ *    gem5 consumes entries in order, advancing tail;
+ *  - num_counters 64-bit counters that the guest updates in place and
+ *    gem5 reads when stats are dumped.
+ *
+ * gem5 writes the header when the simulation starts.
+ */
+
+#include <stdint.h>
+
+#define M5_MAILBOX_MAGIC   0x78626d35 /* "5mbx" */
+#define M5_MAILBOX_VERSION 1
+
+struct m5_mailbox_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_entries;
+    uint32_t num_counters;
+    /* Next slot a producer will reserve */
+    uint64_t head;
+    /* Next slot gem5 will consume */
+    uint64_t tail;
+    uint8_t pad[32];
+};
+
+struct m5_mailbox_entry
+{
+    /* Slot number + 1 once the entry is complete */
+    uint64_t seq;
+    /* M5OP_* function number */
+    uint32_t op;
+    /* Context (CPU) that posted the entry */
+    uint32_t context;
+    uint64_t args[2];
+};
+
+#endif // __GEM5_M5_MAILBOX_H__
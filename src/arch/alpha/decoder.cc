@@ -33,6 +33,6 @@
 namespace AlphaISA
 {
 
-GenericISA::BasicDecodeCache Decoder::defaultCache;
+thread_local GenericISA::BasicDecodeCache Decoder::defaultCache;
 
 }
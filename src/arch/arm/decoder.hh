@@ -75,7 +75,7 @@ class Decoder
     Enums::DecoderFlavour decoderFlavour;
 
     /// A cache of decoded instruction objects.
-    static GenericISA::BasicDecodeCache defaultCache;
+    static thread_local GenericISA::BasicDecodeCache defaultCache;
 
     /**
      * Pre-decode an instruction from the current state of the
@@ -48,40 +48,18 @@
 #include "dev/platform.hh"
 
 /**
- * KVM in-kernel GIC abstraction
+ * Interrupt lines of a KVM in-kernel GIC
  *
- * This class defines a high-level interface to the KVM in-kernel GIC
- * model. It exposes an API that is similar to that of
- * software-emulated GIC models in gem5.
+ * This is the part of the in-kernel GIC interface that is the same
+ * for all versions of the GIC: raising and clearing interrupts.
  */
-class KvmKernelGicV2 : public BaseGicRegisters
+class KvmKernelGic
 {
   public:
-    /**
-     * Instantiate a KVM in-kernel GIC model.
-     *
-     * This constructor instantiates an in-kernel GIC model and wires
-     * it up to the virtual memory system.
-     *
-     * @param vm KVM VM representing this system
-     * @param cpu_addr GIC CPU interface base address
-     * @param dist_addr GIC distributor base address
-     * @param it_lines Number of interrupt lines to support
-     */
-    KvmKernelGicV2(KvmVM &vm, Addr cpu_addr, Addr dist_addr,
-                   unsigned it_lines);
-    virtual ~KvmKernelGicV2();
-
-    KvmKernelGicV2(const KvmKernelGicV2 &other) = delete;
-    KvmKernelGicV2(const KvmKernelGicV2 &&other) = delete;
-    KvmKernelGicV2 &operator=(const KvmKernelGicV2 &&rhs) = delete;
-    KvmKernelGicV2 &operator=(const KvmKernelGicV2 &rhs) = delete;
-
-  public:
-    /**
-     * @{
-     * @name In-kernel GIC API
-     */
+    KvmKernelGic(const KvmKernelGic &other) = delete;
+    KvmKernelGic(const KvmKernelGic &&other) = delete;
+    KvmKernelGic &operator=(const KvmKernelGic &&rhs) = delete;
+    KvmKernelGic &operator=(const KvmKernelGic &rhs) = delete;
 
     /**
      * Raise a shared peripheral interrupt
@@ -112,6 +90,68 @@ class KvmKernelGicV2 : public BaseGicRegisters
      */
     void clearPPI(unsigned vcpu, unsigned ppi);
 
+  protected:
+    /**
+     * Create an in-kernel GIC device
+     *
+     * @param vm KVM VM representing this system
+     * @param type KVM device type (KVM_DEV_TYPE_ARM_VGIC_*)
+     */
+    KvmKernelGic(KvmVM &vm, uint32_t type);
+
+    /**
+     * Update the kernel's VGIC interrupt state
+     *
+     * @param type Interrupt type (KVM_ARM_IRQ_TYPE_PPI/KVM_ARM_IRQ_TYPE_SPI)
+     * @param vcpu CPU id within KVM (ignored for SPIs)
+     * @param irq Interrupt number
+     * @param high True to signal an interrupt, false to clear it.
+     */
+    void setIntState(unsigned type, unsigned vcpu, unsigned irq, bool high);
+
+    /** KVM VM in the parent system */
+    KvmVM &vm;
+
+    /** Kernel interface to the GIC */
+    KvmDevice kdev;
+};
+
+/**
+ * KVM in-kernel GIC abstraction
+ *
+ * This class defines a high-level interface to the KVM in-kernel GIC
+ * model. It exposes an API that is similar to that of
+ * software-emulated GIC models in gem5.
+ */
+class KvmKernelGicV2 : public KvmKernelGic, public BaseGicRegisters
+{
+  public:
+    /**
+     * Instantiate a KVM in-kernel GIC model.
+     *
+     * This constructor instantiates an in-kernel GIC model and wires
+     * it up to the virtual memory system.
+     *
+     * @param vm KVM VM representing this system
+     * @param cpu_addr GIC CPU interface base address
+     * @param dist_addr GIC distributor base address
+     * @param it_lines Number of interrupt lines to support
+     */
+    KvmKernelGicV2(KvmVM &vm, Addr cpu_addr, Addr dist_addr,
+                   unsigned it_lines);
+    virtual ~KvmKernelGicV2();
+
+    KvmKernelGicV2(const KvmKernelGicV2 &other) = delete;
+    KvmKernelGicV2(const KvmKernelGicV2 &&other) = delete;
+    KvmKernelGicV2 &operator=(const KvmKernelGicV2 &&rhs) = delete;
+    KvmKernelGicV2 &operator=(const KvmKernelGicV2 &rhs) = delete;
+
+  public:
+    /**
+     * @{
+     * @name In-kernel GIC API
+     */
+
     /** Address range for the CPU interfaces */
     const AddrRange cpuRange;
     /** Address range for the distributor interface */
@@ -128,16 +168,6 @@ class KvmKernelGicV2 : public BaseGicRegisters
     /* @} */
 
   protected:
-    /**
-     * Update the kernel's VGIC interrupt state
-     *
-     * @param type Interrupt type (KVM_ARM_IRQ_TYPE_PPI/KVM_ARM_IRQ_TYPE_SPI)
-     * @param vcpu CPU id within KVM (ignored for SPIs)
-     * @param irq Interrupt number
-     * @param high True to signal an interrupt, false to clear it.
-     */
-    void setIntState(unsigned type, unsigned vcpu, unsigned irq, bool high);
-
     /**
      * Get value of GIC register "from" a cpu
      *
@@ -157,12 +187,6 @@ class KvmKernelGicV2 : public BaseGicRegisters
      */
     void setGicReg(unsigned group, unsigned vcpu, unsigned offset,
                    unsigned value);
-
-    /** KVM VM in the parent system */
-    KvmVM &vm;
-
-    /** Kernel interface to the GIC */
-    KvmDevice kdev;
 };
 
 
@@ -0,0 +1,535 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arch/arm/kvm/gic_v3.hh"
+
+#include <linux/kvm.h>
+
+#include "arch/arm/miscregs.hh"
+#include "cpu/kvm/vm.hh"
+#include "cpu/thread_context.hh"
+#include "debug/GIC.hh"
+#include "debug/Interrupt.hh"
+#include "params/KvmGicV3.hh"
+#include "sim/system.hh"
+
+namespace
+{
+
+/** Encode a system register the way KVM_DEV_ARM_VGIC_GRP_CPU_SYSREGS
+ * expects it */
+constexpr uint64_t
+sysReg(unsigned op0, unsigned op1, unsigned crn, unsigned crm, unsigned op2)
+{
+    return (op0 << 14) | (op1 << 11) | (crn << 7) | (crm << 3) | op2;
+}
+
+/**
+ * @{
+ * @name GICv3 register offsets
+ */
+const Addr GICD_CTLR = 0x0000;
+const Addr GICD_IGROUPR = 0x0080;
+const Addr GICD_ISENABLER = 0x0100;
+const Addr GICD_ICENABLER = 0x0180;
+const Addr GICD_ISPENDR = 0x0200;
+const Addr GICD_ICPENDR = 0x0280;
+const Addr GICD_ISACTIVER = 0x0300;
+const Addr GICD_ICACTIVER = 0x0380;
+const Addr GICD_IPRIORITYR = 0x0400;
+const Addr GICD_ICFGR = 0x0c00;
+const Addr GICD_IGRPMODR = 0x0d00;
+const Addr GICD_IROUTER = 0x6000;
+
+const Addr GICR_CTLR = 0x0000;
+const Addr GICR_PROPBASER = 0x0070;
+const Addr GICR_PENDBASER = 0x0078;
+// Registers in the SGI_base frame
+const Addr GICR_SGI_BASE = 0x10000;
+const Addr GICR_IGROUPR0 = GICR_SGI_BASE + 0x0080;
+const Addr GICR_ISENABLER0 = GICR_SGI_BASE + 0x0100;
+const Addr GICR_ICENABLER0 = GICR_SGI_BASE + 0x0180;
+const Addr GICR_ISPENDR0 = GICR_SGI_BASE + 0x0200;
+const Addr GICR_ICPENDR0 = GICR_SGI_BASE + 0x0280;
+const Addr GICR_ISACTIVER0 = GICR_SGI_BASE + 0x0300;
+const Addr GICR_ICACTIVER0 = GICR_SGI_BASE + 0x0380;
+const Addr GICR_IPRIORITYR = GICR_SGI_BASE + 0x0400;
+const Addr GICR_ICFGR0 = GICR_SGI_BASE + 0x0c00;
+const Addr GICR_ICFGR1 = GICR_SGI_BASE + 0x0c04;
+const Addr GICR_IGRPMODR0 = GICR_SGI_BASE + 0x0d00;
+
+const Addr GITS_CTLR = 0x0000;
+const Addr GITS_IIDR = 0x0004;
+const Addr GITS_CBASER = 0x0080;
+const Addr GITS_CWRITER = 0x0088;
+const Addr GITS_CREADR = 0x0090;
+const Addr GITS_BASER = 0x0100;
+const unsigned GITS_NUM_BASER = 8;
+
+const uint64_t ICC_PMR_EL1 = sysReg(3, 0, 4, 6, 0);
+const uint64_t ICC_BPR0_EL1 = sysReg(3, 0, 12, 8, 3);
+const uint64_t ICC_AP0R_EL1 = sysReg(3, 0, 12, 8, 4);
+const uint64_t ICC_AP1R_EL1 = sysReg(3, 0, 12, 9, 0);
+const uint64_t ICC_BPR1_EL1 = sysReg(3, 0, 12, 12, 3);
+const uint64_t ICC_CTLR_EL1 = sysReg(3, 0, 12, 12, 4);
+const uint64_t ICC_SRE_EL1 = sysReg(3, 0, 12, 12, 5);
+const uint64_t ICC_IGRPEN0_EL1 = sysReg(3, 0, 12, 12, 6);
+const uint64_t ICC_IGRPEN1_EL1 = sysReg(3, 0, 12, 12, 7);
+/** @} */
+
+/** Build a distributor/redistributor/CPU interface attribute */
+uint64_t
+regAttr(uint32_t affinity, uint64_t offset)
+{
+    return ((uint64_t)affinity << KVM_DEV_ARM_VGIC_V3_MPIDR_SHIFT) | offset;
+}
+
+} // anonymous namespace
+
+KvmKernelGicV3::KvmKernelGicV3(KvmVM &_vm, Addr dist_addr, Addr redist_addr,
+                               Addr its_addr, unsigned num_cpus,
+                               unsigned it_lines)
+    : KvmKernelGic(_vm, KVM_DEV_TYPE_ARM_VGIC_V3),
+      distRange(RangeSize(dist_addr, KVM_VGIC_V3_DIST_SIZE)),
+      redistRange(RangeSize(redist_addr,
+                            num_cpus * KVM_VGIC_V3_REDIST_SIZE)),
+      itsRange(its_addr ? RangeSize(its_addr, KVM_VGIC_V3_ITS_SIZE) :
+               AddrRange())
+{
+    kdev.setAttr<uint64_t>(
+        KVM_DEV_ARM_VGIC_GRP_ADDR, KVM_VGIC_V3_ADDR_TYPE_DIST, dist_addr);
+    kdev.setAttr<uint64_t>(
+        KVM_DEV_ARM_VGIC_GRP_ADDR, KVM_VGIC_V3_ADDR_TYPE_REDIST, redist_addr);
+
+    kdev.setAttr<uint32_t>(KVM_DEV_ARM_VGIC_GRP_NR_IRQS, 0, it_lines);
+
+    if (its_addr) {
+        itsDev.reset(new KvmDevice(
+                         vm.createDevice(KVM_DEV_TYPE_ARM_VGIC_ITS)));
+        itsDev->setAttr<uint64_t>(
+            KVM_DEV_ARM_VGIC_GRP_ADDR, KVM_VGIC_ITS_ADDR_TYPE, its_addr);
+    }
+}
+
+KvmKernelGicV3::~KvmKernelGicV3()
+{
+}
+
+void
+KvmKernelGicV3::init()
+{
+    kdev.setAttr<uint64_t>(
+        KVM_DEV_ARM_VGIC_GRP_CTRL, KVM_DEV_ARM_VGIC_CTRL_INIT, 0);
+    if (itsDev) {
+        itsDev->setAttr<uint64_t>(
+            KVM_DEV_ARM_VGIC_GRP_CTRL, KVM_DEV_ARM_VGIC_CTRL_INIT, 0);
+    }
+}
+
+uint32_t
+KvmKernelGicV3::readDist(Addr daddr)
+{
+    uint32_t data;
+    kdev.getAttrPtr(KVM_DEV_ARM_VGIC_GRP_DIST_REGS, regAttr(0, daddr),
+                    &data);
+    return data;
+}
+
+void
+KvmKernelGicV3::writeDist(Addr daddr, uint32_t data)
+{
+    kdev.setAttrPtr(KVM_DEV_ARM_VGIC_GRP_DIST_REGS, regAttr(0, daddr),
+                    &data);
+}
+
+uint32_t
+KvmKernelGicV3::readRedist(uint32_t affinity, Addr daddr)
+{
+    uint32_t data;
+    kdev.getAttrPtr(KVM_DEV_ARM_VGIC_GRP_REDIST_REGS,
+                    regAttr(affinity, daddr), &data);
+    return data;
+}
+
+void
+KvmKernelGicV3::writeRedist(uint32_t affinity, Addr daddr, uint32_t data)
+{
+    kdev.setAttrPtr(KVM_DEV_ARM_VGIC_GRP_REDIST_REGS,
+                    regAttr(affinity, daddr), &data);
+}
+
+bool
+KvmKernelGicV3::hasSysReg(uint32_t affinity, uint64_t reg)
+{
+    return kdev.hasAttr(KVM_DEV_ARM_VGIC_GRP_CPU_SYSREGS,
+                        regAttr(affinity, reg));
+}
+
+uint64_t
+KvmKernelGicV3::readSysReg(uint32_t affinity, uint64_t reg)
+{
+    return kdev.getAttr<uint64_t>(KVM_DEV_ARM_VGIC_GRP_CPU_SYSREGS,
+                                  regAttr(affinity, reg));
+}
+
+void
+KvmKernelGicV3::writeSysReg(uint32_t affinity, uint64_t reg, uint64_t data)
+{
+    kdev.setAttr<uint64_t>(KVM_DEV_ARM_VGIC_GRP_CPU_SYSREGS,
+                           regAttr(affinity, reg), data);
+}
+
+uint64_t
+KvmKernelGicV3::readIts(Addr daddr)
+{
+    assert(itsDev);
+    return itsDev->getAttr<uint64_t>(KVM_DEV_ARM_VGIC_GRP_ITS_REGS, daddr);
+}
+
+void
+KvmKernelGicV3::writeIts(Addr daddr, uint64_t data)
+{
+    assert(itsDev);
+    itsDev->setAttr<uint64_t>(KVM_DEV_ARM_VGIC_GRP_ITS_REGS, daddr, data);
+}
+
+void
+KvmKernelGicV3::saveTables()
+{
+    if (itsDev) {
+        itsDev->setAttr<uint64_t>(
+            KVM_DEV_ARM_VGIC_GRP_CTRL, KVM_DEV_ARM_ITS_SAVE_TABLES, 0);
+    }
+    kdev.setAttr<uint64_t>(
+        KVM_DEV_ARM_VGIC_GRP_CTRL, KVM_DEV_ARM_VGIC_SAVE_PENDING_TABLES, 0);
+}
+
+void
+KvmKernelGicV3::restoreItsTables()
+{
+    assert(itsDev);
+    itsDev->setAttr<uint64_t>(
+        KVM_DEV_ARM_VGIC_GRP_CTRL, KVM_DEV_ARM_ITS_RESTORE_TABLES, 0);
+}
+
+
+KvmGicV3::KvmGicV3(const KvmGicV3Params *p)
+    : BaseGic(p),
+      system(*p->system),
+      itLines(p->it_lines),
+      kernelGicReady(false), pendingRestore(false)
+{
+    KvmVM *vm = system.getKvmVM();
+    fatal_if(!vm, "KvmGicV3 requires a KVM VM in the system\n");
+
+    kernelGic.reset(new KvmKernelGicV3(*vm, p->dist_addr, p->redist_addr,
+                                       p->its_addr, p->num_cpus, itLines));
+    buildRegLists();
+}
+
+KvmGicV3::~KvmGicV3()
+{
+}
+
+void
+KvmGicV3::buildRegLists()
+{
+    // Registers for SGIs and PPIs live in the redistributors, so the
+    // distributor only holds the state of the SPIs.
+    for (Addr i = 32; i < itLines; i += 32) {
+        distRegList.push_back({ GICD_IGROUPR + i / 8, 0 });
+        distRegList.push_back({ GICD_IGRPMODR + i / 8, 0 });
+    }
+    for (Addr i = 32; i < itLines; i += 16)
+        distRegList.push_back({ GICD_ICFGR + i / 4, 0 });
+    for (Addr i = 32; i < itLines; i += 4)
+        distRegList.push_back({ GICD_IPRIORITYR + i, 0 });
+    for (Addr i = 32; i < itLines; ++i) {
+        distRegList.push_back({ GICD_IROUTER + i * 8, 0 });
+        distRegList.push_back({ GICD_IROUTER + i * 8 + 4, 0 });
+    }
+    for (Addr i = 32; i < itLines; i += 32) {
+        distRegList.push_back({ GICD_ISPENDR + i / 8, GICD_ICPENDR + i / 8 });
+        distRegList.push_back(
+            { GICD_ISACTIVER + i / 8, GICD_ICACTIVER + i / 8 });
+        distRegList.push_back(
+            { GICD_ISENABLER + i / 8, GICD_ICENABLER + i / 8 });
+    }
+    distRegList.push_back({ GICD_CTLR, 0 });
+
+    // The LPI tables have to be set up before LPIs are enabled in
+    // GICR_CTLR.
+    redistRegList = {
+        { GICR_PROPBASER, 0 }, { GICR_PROPBASER + 4, 0 },
+        { GICR_PENDBASER, 0 }, { GICR_PENDBASER + 4, 0 },
+        { GICR_IGROUPR0, 0 }, { GICR_IGRPMODR0, 0 },
+        { GICR_ICFGR0, 0 }, { GICR_ICFGR1, 0 },
+    };
+    for (Addr i = 0; i < 32; i += 4)
+        redistRegList.push_back({ GICR_IPRIORITYR + i, 0 });
+    redistRegList.push_back({ GICR_ISPENDR0, GICR_ICPENDR0 });
+    redistRegList.push_back({ GICR_ISACTIVER0, GICR_ICACTIVER0 });
+    redistRegList.push_back({ GICR_ISENABLER0, GICR_ICENABLER0 });
+    redistRegList.push_back({ GICR_CTLR, 0 });
+
+    // ICC_CTLR_EL1 determines how many of the active priority
+    // registers exist, so it has to be restored first.
+    sysRegList = { ICC_SRE_EL1, ICC_CTLR_EL1, ICC_PMR_EL1,
+                   ICC_BPR0_EL1, ICC_BPR1_EL1 };
+    for (unsigned i = 0; i < 4; ++i) {
+        sysRegList.push_back(ICC_AP0R_EL1 + i);
+        sysRegList.push_back(ICC_AP1R_EL1 + i);
+    }
+    sysRegList.push_back(ICC_IGRPEN0_EL1);
+    sysRegList.push_back(ICC_IGRPEN1_EL1);
+
+    if (kernelGic->hasIts()) {
+        itsRegList.push_back(GITS_IIDR);
+        for (unsigned i = 0; i < GITS_NUM_BASER; ++i)
+            itsRegList.push_back(GITS_BASER + i * 8);
+        itsRegList.push_back(GITS_CBASER);
+        itsRegList.push_back(GITS_CREADR);
+        itsRegList.push_back(GITS_CWRITER);
+    }
+}
+
+void
+KvmGicV3::startup()
+{
+    BaseGic::startup();
+
+    system.getKvmVM()->whenVCPUsCreated([this]() { initKernelGic(); });
+}
+
+void
+KvmGicV3::initKernelGic()
+{
+    DPRINTF(GIC, "Initializing in-kernel GICv3\n");
+    kernelGic->init();
+    kernelGicReady = true;
+
+    if (pendingRestore) {
+        restoreState();
+        pendingRestore = false;
+    }
+}
+
+DrainState
+KvmGicV3::drain()
+{
+    if (kernelGicReady && !pendingRestore)
+        saveState();
+    return DrainState::Drained;
+}
+
+void
+KvmGicV3::drainResume()
+{
+    // There is no software GICv3 to hand the state over to.
+    fatal_if(!system.validKvmEnvironment(),
+             "KvmGicV3 can only be used with KVM CPUs\n");
+}
+
+uint32_t
+KvmGicV3::affinity(ContextID ctx) const
+{
+    const uint64_t mpidr(
+        system.getThreadContext(ctx)->readMiscReg(ArmISA::MISCREG_MPIDR_EL1));
+    return (mpidr & 0xffffff) | (((mpidr >> 32) & 0xff) << 24);
+}
+
+void
+KvmGicV3::saveState()
+{
+    DPRINTF(GIC, "Saving in-kernel GICv3 state\n");
+
+    // Flush the LPI pending bits and the ITS tables to guest memory
+    // before reading the registers that point to them.
+    kernelGic->saveTables();
+
+    distRegs.clear();
+    for (const auto &reg : distRegList)
+        distRegs.push_back(kernelGic->readDist(reg.offset));
+
+    redistRegs.clear();
+    sysRegs.clear();
+    sysRegIds.clear();
+    for (ContextID ctx = 0; ctx < system.numContexts(); ++ctx) {
+        const uint32_t aff(affinity(ctx));
+        for (const auto &reg : redistRegList)
+            redistRegs.push_back(kernelGic->readRedist(aff, reg.offset));
+
+        for (auto reg : sysRegList) {
+            if (!kernelGic->hasSysReg(aff, reg))
+                continue;
+            sysRegIds.push_back(reg);
+            sysRegs.push_back(kernelGic->readSysReg(aff, reg));
+        }
+    }
+
+    itsRegs.clear();
+    if (kernelGic->hasIts()) {
+        for (auto offset : itsRegList)
+            itsRegs.push_back(kernelGic->readIts(offset));
+        itsRegs.push_back(kernelGic->readIts(GITS_CTLR));
+    }
+}
+
+void
+KvmGicV3::restoreState()
+{
+    DPRINTF(GIC, "Restoring in-kernel GICv3 state\n");
+
+    const unsigned num_contexts(system.numContexts());
+    fatal_if(distRegs.size() != distRegList.size() ||
+             redistRegs.size() != redistRegList.size() * num_contexts ||
+             sysRegs.size() != sysRegIds.size() ||
+             sysRegIds.size() % num_contexts ||
+             itsRegs.size() !=
+             (kernelGic->hasIts() ? itsRegList.size() + 1 : 0),
+             "KvmGicV3: Checkpointed state doesn't match the GIC "
+             "configuration\n");
+
+    for (int i = 0; i < distRegList.size(); ++i) {
+        const Reg &reg(distRegList[i]);
+        if (reg.clearOffset)
+            kernelGic->writeDist(reg.clearOffset, 0xffffffff);
+        kernelGic->writeDist(reg.offset, distRegs[i]);
+    }
+
+    auto redist_val(redistRegs.cbegin());
+    const unsigned sysregs_per_ctx(sysRegIds.size() / num_contexts);
+    for (ContextID ctx = 0; ctx < num_contexts; ++ctx) {
+        const uint32_t aff(affinity(ctx));
+        for (const auto &reg : redistRegList) {
+            if (reg.clearOffset)
+                kernelGic->writeRedist(aff, reg.clearOffset, 0xffffffff);
+            kernelGic->writeRedist(aff, reg.offset, *redist_val++);
+        }
+
+        for (unsigned i = ctx * sysregs_per_ctx;
+             i < (ctx + 1) * sysregs_per_ctx; ++i) {
+            kernelGic->writeSysReg(aff, sysRegIds[i], sysRegs[i]);
+        }
+    }
+
+    if (kernelGic->hasIts()) {
+        for (int i = 0; i < itsRegList.size(); ++i)
+            kernelGic->writeIts(itsRegList[i], itsRegs[i]);
+        kernelGic->restoreItsTables();
+        kernelGic->writeIts(GITS_CTLR, itsRegs.back());
+    }
+}
+
+void
+KvmGicV3::serialize(CheckpointOut &cp) const
+{
+    SERIALIZE_CONTAINER(distRegs);
+    SERIALIZE_CONTAINER(redistRegs);
+    SERIALIZE_CONTAINER(sysRegs);
+    SERIALIZE_CONTAINER(sysRegIds);
+    SERIALIZE_CONTAINER(itsRegs);
+}
+
+void
+KvmGicV3::unserialize(CheckpointIn &cp)
+{
+    UNSERIALIZE_CONTAINER(distRegs);
+    UNSERIALIZE_CONTAINER(redistRegs);
+    UNSERIALIZE_CONTAINER(sysRegs);
+    UNSERIALIZE_CONTAINER(sysRegIds);
+    UNSERIALIZE_CONTAINER(itsRegs);
+
+    // Nothing was saved if the checkpoint was taken before the kernel
+    // GIC was initialized.
+    if (distRegs.empty())
+        return;
+
+    // The kernel GIC can't be written until it has been initialized,
+    // which happens once the vCPUs have been created.
+    pendingRestore = true;
+    if (kernelGicReady) {
+        restoreState();
+        pendingRestore = false;
+    }
+}
+
+AddrRangeList
+KvmGicV3::getAddrRanges() const
+{
+    AddrRangeList ranges = { kernelGic->distRange, kernelGic->redistRange };
+    if (kernelGic->hasIts())
+        ranges.push_back(kernelGic->itsRange);
+    return ranges;
+}
+
+Tick
+KvmGicV3::read(PacketPtr pkt)
+{
+    panic("KvmGicV3: PIO from gem5 is currently unsupported\n");
+}
+
+Tick
+KvmGicV3::write(PacketPtr pkt)
+{
+    panic("KvmGicV3: PIO from gem5 is currently unsupported\n");
+}
+
+void
+KvmGicV3::sendInt(uint32_t num)
+{
+    DPRINTF(Interrupt, "Set SPI %d\n", num);
+    kernelGic->setSPI(num);
+}
+
+void
+KvmGicV3::clearInt(uint32_t num)
+{
+    DPRINTF(Interrupt, "Clear SPI %d\n", num);
+    kernelGic->clearSPI(num);
+}
+
+void
+KvmGicV3::sendPPInt(uint32_t num, uint32_t cpu)
+{
+    DPRINTF(Interrupt, "Set PPI %d:%d\n", cpu, num);
+    kernelGic->setPPI(system.getKvmVM()->contextIdToVCpuId(cpu), num);
+}
+
+void
+KvmGicV3::clearPPInt(uint32_t num, uint32_t cpu)
+{
+    DPRINTF(Interrupt, "Clear PPI %d:%d\n", cpu, num);
+    kernelGic->clearPPI(system.getKvmVM()->contextIdToVCpuId(cpu), num);
+}
+
+KvmGicV3 *
+KvmGicV3Params::create()
+{
+    return new KvmGicV3(this);
+}
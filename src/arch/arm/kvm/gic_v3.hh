@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARCH_ARM_KVM_GIC_V3_HH__
+#define __ARCH_ARM_KVM_GIC_V3_HH__
+
+#include <memory>
+#include <vector>
+
+#include "arch/arm/kvm/gic.hh"
+#include "dev/arm/base_gic.hh"
+
+/**
+ * KVM in-kernel GICv3
+ *
+ * This wraps a KVM in-kernel GICv3 (and optionally an ITS). Unlike
+ * the GICv2 interface, the distributor and redistributor registers
+ * are addressed by the affinity of the CPU that accesses them rather
+ * than by vCPU number, and the CPU interface is accessed as system
+ * registers.
+ */
+class KvmKernelGicV3 : public KvmKernelGic
+{
+  public:
+    /**
+     * Instantiate a KVM in-kernel GICv3 model.
+     *
+     * @param vm KVM VM representing this system
+     * @param dist_addr GIC distributor base address
+     * @param redist_addr Base address of the first redistributor
+     * @param its_addr ITS base address, 0 to leave out the ITS
+     * @param num_cpus Number of CPUs, and so of redistributors
+     * @param it_lines Number of interrupt lines to support
+     */
+    KvmKernelGicV3(KvmVM &vm, Addr dist_addr, Addr redist_addr,
+                   Addr its_addr, unsigned num_cpus, unsigned it_lines);
+    ~KvmKernelGicV3();
+
+    /**
+     * Finish setting up the GIC. This has to be done after all the
+     * vCPUs have been created, but before any of them runs.
+     */
+    void init();
+
+    /** Is there an ITS? */
+    bool hasIts() const { return itsDev != nullptr; }
+
+    /**
+     * @{
+     * @name Register access
+     * @param affinity Affinity of the accessing CPU (Aff3.Aff2.Aff1.Aff0)
+     */
+    uint32_t readDist(Addr daddr);
+    void writeDist(Addr daddr, uint32_t data);
+
+    uint32_t readRedist(uint32_t affinity, Addr daddr);
+    void writeRedist(uint32_t affinity, Addr daddr, uint32_t data);
+
+    bool hasSysReg(uint32_t affinity, uint64_t reg);
+    uint64_t readSysReg(uint32_t affinity, uint64_t reg);
+    void writeSysReg(uint32_t affinity, uint64_t reg, uint64_t data);
+
+    uint64_t readIts(Addr daddr);
+    void writeIts(Addr daddr, uint64_t data);
+    /** @} */
+
+    /**
+     * Write the LPI pending state and the ITS tables out to guest
+     * memory, so that they're included in a checkpoint of it.
+     */
+    void saveTables();
+
+    /** Reload the ITS tables from guest memory. */
+    void restoreItsTables();
+
+    /** Address range for the distributor */
+    const AddrRange distRange;
+    /** Address range for all the redistributors */
+    const AddrRange redistRange;
+    /** Address range for the ITS, if there is one */
+    const AddrRange itsRange;
+
+  protected:
+    /** Kernel interface to the ITS, if there is one */
+    std::unique_ptr<KvmDevice> itsDev;
+};
+
+
+struct KvmGicV3Params;
+
+/**
+ * GICv3 for systems that only use KVM CPUs
+ *
+ * gem5 has no GICv3 model of its own, so unlike MuxingKvmGic this
+ * can't hand its state over when switching to simulated CPUs. It
+ * does keep its state across draining and checkpoints by reading
+ * the kernel's registers in drain() and writing them back after a
+ * checkpoint is restored.
+ */
+class KvmGicV3 : public BaseGic
+{
+  public:
+    KvmGicV3(const KvmGicV3Params *p);
+    ~KvmGicV3();
+
+  public: // SimObject / Serializable / Drainable
+    void startup() override;
+    DrainState drain() override;
+    void drainResume() override;
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
+  public: // PioDevice
+    AddrRangeList getAddrRanges() const override;
+    Tick read(PacketPtr pkt) override;
+    Tick write(PacketPtr pkt) override;
+
+  public: // BaseGic
+    void sendInt(uint32_t num) override;
+    void clearInt(uint32_t num) override;
+
+    void sendPPInt(uint32_t num, uint32_t cpu) override;
+    void clearPPInt(uint32_t num, uint32_t cpu) override;
+
+  protected:
+    /**
+     * A register whose state is saved. Registers with a clear
+     * offset are made up of set and clear halves, and are cleared
+     * before they're restored.
+     */
+    struct Reg
+    {
+        Addr offset;
+        Addr clearOffset;
+    };
+
+    /** Build the lists of registers to save */
+    void buildRegLists();
+
+    /** Initialize the kernel GIC once all the vCPUs exist */
+    void initKernelGic();
+
+    /** Copy the kernel's GIC state into the saved registers */
+    void saveState();
+    /** Write the saved registers back to the kernel */
+    void restoreState();
+
+    /** Affinity of a context, in the format KVM expects */
+    uint32_t affinity(ContextID ctx) const;
+
+    /** System this interrupt controller belongs to */
+    System &system;
+
+    /** Number of interrupt lines */
+    const unsigned itLines;
+
+    /** Kernel GIC device */
+    std::unique_ptr<KvmKernelGicV3> kernelGic;
+
+    /** Has the kernel GIC been initialized? */
+    bool kernelGicReady;
+
+    /** Do the saved registers need writing back to the kernel? */
+    bool pendingRestore;
+
+    /**
+     * @{
+     * @name Registers saved, in the order they're restored in
+     */
+    std::vector<Reg> distRegList;
+    std::vector<Reg> redistRegList;
+    std::vector<uint64_t> sysRegList;
+    std::vector<Addr> itsRegList;
+    /** @} */
+
+    /**
+     * @{
+     * @name Saved register values. Redistributor and CPU interface
+     * registers are saved for each context in turn. CPU interface
+     * registers the kernel doesn't implement are left out.
+     */
+    std::vector<uint32_t> distRegs;
+    std::vector<uint32_t> redistRegs;
+    std::vector<uint64_t> sysRegs;
+    std::vector<uint64_t> sysRegIds;
+    std::vector<uint64_t> itsRegs;
+    /** @} */
+};
+
+#endif // __ARCH_ARM_KVM_GIC_V3_HH__
@@ -365,6 +365,7 @@ class TLB : public BaseTLB
     // Checkpointing
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
+    bool parallelCheckpoint() const override { return true; }
 
     void regStats() override;
 
@@ -44,6 +44,12 @@ namespace TheISA
 namespace GenericISA
 {
 
+/**
+ * Cache of decoded instructions, by address and by machine
+ * instruction. ISAs keep a single cache per simulation thread, which
+ * all their decoders share, so that CPUs running the same code decode
+ * it once, and so that no locking is needed in parallel simulations.
+ */
 class BasicDecodeCache
 {
   private:
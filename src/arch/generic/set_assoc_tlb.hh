@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARCH_GENERIC_SET_ASSOC_TLB_HH__
+#define __ARCH_GENERIC_SET_ASSOC_TLB_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/logging.hh"
+#include "base/types.hh"
+
+namespace GenericISA
+{
+
+/**
+ * Storage for the entries of a TLB that supports several page sizes.
+ *
+ * The entries are organized in sets, and are replaced in LRU order
+ * within their set. A single set makes the TLB fully associative.
+ * Lookups don't search the sets: entries are indexed by page in a hash
+ * table, so a lookup takes one probe per page size in use, smallest
+ * first. The entry of the previous translation is checked before that,
+ * as consecutive accesses tend to hit the same page.
+ *
+ * Entries can be tagged, e.g. with the address space they belong to,
+ * in which case the same page can be mapped once per tag and lookups
+ * only match entries with the requested tag.
+ *
+ * Entry must have a vaddr member holding the start of its page, and a
+ * logBytes member holding log2 of the page size, which must be at least
+ * 6.
+ */
+template <class Entry>
+class SetAssocTLB
+{
+  public:
+    /**
+     * @param size Number of entries
+     * @param assoc Number of ways per set, or 0 for fully associative
+     */
+    SetAssocTLB(unsigned size, unsigned assoc)
+        : assoc(assoc ? assoc : size), numSets(size / this->assoc),
+          entries(size), tags(size, 0), lru(size, 0), valid(size, false),
+          numValid(0), seq(0), last(-1)
+    {
+        fatal_if(!size, "TLBs must have a non-zero size.\n");
+        fatal_if(size % this->assoc,
+                 "TLB size %d is not a multiple of its associativity %d.\n",
+                 size, this->assoc);
+    }
+
+    /** Number of entries. */
+    unsigned size() const { return entries.size(); }
+
+    /** Number of entries in use. */
+    unsigned used() const { return numValid; }
+
+    /**
+     * Find the entry translating an address.
+     *
+     * @param va Virtual address
+     * @param update_lru Mark the entry as most recently used
+     * @param tag Tag the entry must have
+     * @return The entry, or nullptr on a miss
+     */
+    Entry *
+    lookup(Addr va, bool update_lru = true, uint64_t tag = 0)
+    {
+        int idx = -1;
+        if (last >= 0 && tags[last] == tag && contains(entries[last], va)) {
+            idx = last;
+        } else {
+            for (const auto &s : pageSizes) {
+                auto it = index.find(key(va, s.first, tag));
+                if (it != index.end()) {
+                    idx = it->second;
+                    break;
+                }
+            }
+            if (idx < 0)
+                return nullptr;
+            last = idx;
+        }
+
+        if (update_lru)
+            lru[idx] = ++seq;
+        return &entries[idx];
+    }
+
+    /**
+     * Insert an entry, replacing the least recently used one of its
+     * set if needed.
+     *
+     * @param vpn Start of the page the entry maps
+     * @param entry Entry to copy
+     * @param tag Tag of the entry
+     * @return The entry in the TLB, which is an existing one if the
+     *         page is already mapped with the same tag
+     */
+    Entry *
+    insert(Addr vpn, const Entry &entry, uint64_t tag = 0)
+    {
+        assert(entry.logBytes >= 6);
+        auto it = index.find(key(vpn, entry.logBytes, tag));
+        if (it != index.end())
+            return &entries[it->second];
+
+        const unsigned set = (vpn >> entry.logBytes) % numSets;
+        const unsigned first = set * assoc;
+        unsigned victim = first;
+        for (unsigned i = first; i < first + assoc; ++i) {
+            if (!valid[i]) {
+                victim = i;
+                break;
+            }
+            if (lru[i] < lru[victim])
+                victim = i;
+        }
+        if (valid[victim])
+            remove(victim);
+
+        entries[victim] = entry;
+        entries[victim].vaddr = vpn;
+        tags[victim] = tag;
+        lru[victim] = ++seq;
+        valid[victim] = true;
+        ++numValid;
+        index[key(vpn, entry.logBytes, tag)] = victim;
+        addPageSize(entry.logBytes, 1);
+        // a smaller page may now hide part of the cached one
+        last = -1;
+
+        return &entries[victim];
+    }
+
+    /** Remove an entry returned by lookup() or insert(). */
+    void
+    remove(Entry *entry)
+    {
+        remove(entry - &entries[0]);
+    }
+
+    /** Remove all entries for which pred(entry) is true. */
+    template <class Pred>
+    void
+    removeIf(Pred pred)
+    {
+        for (unsigned i = 0; i < entries.size(); ++i) {
+            if (valid[i] && pred(entries[i]))
+                remove(i);
+        }
+    }
+
+    /** Remove all entries with a given tag. */
+    void
+    removeTag(uint64_t tag)
+    {
+        for (unsigned i = 0; i < entries.size(); ++i) {
+            if (valid[i] && tags[i] == tag)
+                remove(i);
+        }
+    }
+
+    /** Remove all entries. */
+    void clear() { removeIf([](const Entry &) { return true; }); }
+
+    /**
+     * Call f(entry) for every entry in use, from the least to the most
+     * recently used one. Inserting the entries in that order restores
+     * the replacement state.
+     */
+    template <class F>
+    void
+    forEach(F f) const
+    {
+        std::vector<unsigned> order;
+        for (unsigned i = 0; i < entries.size(); ++i) {
+            if (valid[i])
+                order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(),
+                  [this](unsigned a, unsigned b) { return lru[a] < lru[b]; });
+        for (unsigned i : order)
+            f(entries[i]);
+    }
+
+  private:
+    static bool
+    contains(const Entry &entry, Addr va)
+    {
+        return (va >> entry.logBytes) == (entry.vaddr >> entry.logBytes);
+    }
+
+    /** Hash table key of the page of a given size holding va. */
+    struct Key
+    {
+        Addr page;
+        uint64_t tag;
+
+        bool
+        operator==(const Key &other) const
+        {
+            return page == other.page && tag == other.tag;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t
+        operator()(const Key &k) const
+        {
+            return std::hash<Addr>()(k.page ^ (k.tag * 0x9e3779b97f4a7c15ULL));
+        }
+    };
+
+    static Key
+    key(Addr va, unsigned log_bytes, uint64_t tag)
+    {
+        return Key{(va & ~mask(log_bytes)) | log_bytes, tag};
+    }
+
+    void
+    remove(unsigned idx)
+    {
+        assert(valid[idx]);
+        const Entry &entry = entries[idx];
+        index.erase(key(entry.vaddr, entry.logBytes, tags[idx]));
+        addPageSize(entry.logBytes, -1);
+        valid[idx] = false;
+        --numValid;
+        if (last == (int)idx)
+            last = -1;
+    }
+
+    /** Count entries per page size, keeping the sizes sorted. */
+    void
+    addPageSize(unsigned log_bytes, int delta)
+    {
+        auto it = std::lower_bound(pageSizes.begin(), pageSizes.end(),
+                                   std::make_pair(log_bytes, 0u));
+        if (it == pageSizes.end() || it->first != log_bytes)
+            it = pageSizes.insert(it, std::make_pair(log_bytes, 0u));
+        it->second += delta;
+        if (!it->second)
+            pageSizes.erase(it);
+    }
+
+    const unsigned assoc;
+    const unsigned numSets;
+
+    std::vector<Entry> entries;
+    std::vector<uint64_t> tags;
+    std::vector<uint64_t> lru;
+    std::vector<bool> valid;
+    unsigned numValid;
+
+    /** Entry indices by page, see key(). */
+    std::unordered_map<Key, unsigned, KeyHash> index;
+    /** Page sizes in use and their number of entries. */
+    std::vector<std::pair<unsigned, unsigned>> pageSizes;
+
+    uint64_t seq;
+    /** Entry of the most recent lookup, or -1. */
+    int last;
+};
+
+} // namespace GenericISA
+
+#endif // __ARCH_GENERIC_SET_ASSOC_TLB_HH__
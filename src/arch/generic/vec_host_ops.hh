@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Element wise operations on guest vector registers that are carried out
+ * with host vector instructions where the compiler supports them. The
+ * ISA description generates a call to apply() for the simple integer
+ * operations instead of walking the lanes one at a time. Registers are
+ * expected to be stored little endian, which is what both ARM and x86
+ * guests use.
+ */
+
+#ifndef __ARCH_GENERIC_VEC_HOST_OPS_HH__
+#define __ARCH_GENERIC_VEC_HOST_OPS_HH__
+
+#include <cstddef>
+#include <cstring>
+
+#include "sim/byteswap.hh"
+
+namespace VecHostOps
+{
+
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+/** Lanes can be processed in place as they're already in host order. */
+static constexpr bool HostVectors = true;
+#else
+static constexpr bool HostVectors = false;
+#endif
+
+/** A host vector of Bytes bytes holding elements of type E. */
+template <typename E, size_t Bytes>
+struct HostVec;
+
+template <typename E>
+struct HostVec<E, 8>
+{
+    typedef E Type __attribute__((vector_size(8)));
+};
+
+template <typename E>
+struct HostVec<E, 16>
+{
+    typedef E Type __attribute__((vector_size(16)));
+};
+
+/**
+ * Each operation has a vec() form for host vectors, where comparisons
+ * produce all ones or all zeros in every lane, and an elem() form that
+ * matches the lane by lane code in the ISA description.
+ */
+/** @{ */
+struct Add
+{
+    template <class V> static V vec(V a, V b) { return a + b; }
+    template <class E> static E elem(E a, E b) { return a + b; }
+};
+
+struct Sub
+{
+    template <class V> static V vec(V a, V b) { return a - b; }
+    template <class E> static E elem(E a, E b) { return a - b; }
+};
+
+struct Mul
+{
+    template <class V> static V vec(V a, V b) { return a * b; }
+    template <class E> static E elem(E a, E b) { return a * b; }
+};
+
+struct And
+{
+    template <class V> static V vec(V a, V b) { return a & b; }
+    template <class E> static E elem(E a, E b) { return a & b; }
+};
+
+struct Bic
+{
+    template <class V> static V vec(V a, V b) { return a & ~b; }
+    template <class E> static E elem(E a, E b) { return a & ~b; }
+};
+
+struct Orr
+{
+    template <class V> static V vec(V a, V b) { return a | b; }
+    template <class E> static E elem(E a, E b) { return a | b; }
+};
+
+struct Orn
+{
+    template <class V> static V vec(V a, V b) { return a | ~b; }
+    template <class E> static E elem(E a, E b) { return a | ~b; }
+};
+
+struct Eor
+{
+    template <class V> static V vec(V a, V b) { return a ^ b; }
+    template <class E> static E elem(E a, E b) { return a ^ b; }
+};
+
+struct CmpEq
+{
+    template <class V> static V vec(V a, V b) { return (V)(a == b); }
+    template <class E> static E elem(E a, E b) { return a == b ? -1 : 0; }
+};
+
+struct CmpGt
+{
+    template <class V> static V vec(V a, V b) { return (V)(a > b); }
+    template <class E> static E elem(E a, E b) { return a > b ? -1 : 0; }
+};
+
+struct CmpGe
+{
+    template <class V> static V vec(V a, V b) { return (V)(a >= b); }
+    template <class E> static E elem(E a, E b) { return a >= b ? -1 : 0; }
+};
+
+struct Tst
+{
+    template <class V> static V vec(V a, V b) { return (V)((a & b) != 0); }
+    template <class E> static E elem(E a, E b) { return (a & b) ? -1 : 0; }
+};
+
+struct Max
+{
+    template <class V>
+    static V
+    vec(V a, V b)
+    {
+        V gt = (V)(a > b);
+        return (a & gt) | (b & ~gt);
+    }
+    template <class E> static E elem(E a, E b) { return a > b ? a : b; }
+};
+
+struct Min
+{
+    template <class V>
+    static V
+    vec(V a, V b)
+    {
+        V lt = (V)(a < b);
+        return (a & lt) | (b & ~lt);
+    }
+    template <class E> static E elem(E a, E b) { return a < b ? a : b; }
+};
+/** @} */
+
+/**
+ * Apply Op to the N elements of two little endian registers.
+ * @param dest Destination elements, which may alias the sources
+ * @param src1 First source elements
+ * @param src2 Second source elements
+ */
+template <class Op, typename E, size_t N>
+inline void
+apply(E *dest, const E *src1, const E *src2)
+{
+    static_assert(N * sizeof(E) == 8 || N * sizeof(E) == 16,
+                  "Host vectors are either 8 or 16 bytes");
+
+    if (HostVectors) {
+        typedef typename HostVec<E, N * sizeof(E)>::Type V;
+        V a, b;
+        // memcpy lets the compiler pick the loads, which are aligned
+        // when the registers are.
+        std::memcpy(&a, src1, sizeof(V));
+        std::memcpy(&b, src2, sizeof(V));
+        V r = Op::vec(a, b);
+        std::memcpy(dest, &r, sizeof(V));
+    } else {
+        for (size_t i = 0; i < N; i++)
+            dest[i] = htole((E)Op::elem(letoh(src1[i]), letoh(src2[i])));
+    }
+}
+
+} // namespace VecHostOps
+
+#endif // __ARCH_GENERIC_VEC_HOST_OPS_HH__
@@ -297,6 +297,11 @@ $class_name::execute(GPUDynInstPtr gpuDynInst)
 
 '''
 
+# The templates below gather the operands of all the lanes first, and
+# compute the lanes in a separate loop, which the compiler can vectorize
+# since the lanes of a register are contiguous. The results of the
+# active lanes are written back at the end.
+
 exec_template_1dt_varsrcs = '''
 template<typename DataType>
 void
@@ -305,25 +310,38 @@ $class_name<DataType>::execute(GPUDynInstPtr gpuDynInst)
     Wavefront *w = gpuDynInst->wavefront();
 
     const VectorMask &mask = w->getPred();
+    const int num_lanes = w->computeUnit->wfSize();
+    const bool all_active = allLanesActive(mask, num_lanes);
 
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
-        if (mask[lane]) {
+    CType dest_vals[MaxLanes];
+    CType src_vals[$num_srcs][MaxLanes];
+
+    if ($dest_is_src_flag) {
+        this->dest.template getLanes<CType>(w, dest_vals);
+    }
+
+    for (int i = 0; i < $num_srcs; ++i) {
+        this->src[i].template getLanes<CType>(w, src_vals[i]);
+    }
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
+        if (all_active || mask[lane]) {
             CType dest_val;
             if ($dest_is_src_flag) {
-                dest_val = this->dest.template get<CType>(w, lane);
+                dest_val = dest_vals[lane];
             }
 
             CType src_val[$num_srcs];
 
             for (int i = 0; i < $num_srcs; ++i) {
-                src_val[i] = this->src[i].template get<CType>(w, lane);
+                src_val[i] = src_vals[i][lane];
             }
 
-            dest_val = (CType)($expr);
-
-            this->dest.set(w, lane, dest_val);
+            dest_vals[lane] = (CType)($expr);
         }
     }
+
+    this->dest.setLanes(w, dest_vals, mask);
 }
 
 '''
@@ -340,24 +358,39 @@ $class_name<DataType>::execute(GPUDynInstPtr gpuDynInst)
     typedef typename Base::Src2CType Src2T;
 
     const VectorMask &mask = w->getPred();
+    const int num_lanes = w->computeUnit->wfSize();
+    const bool all_active = allLanesActive(mask, num_lanes);
 
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
-        if (mask[lane]) {
+    CType dest_vals[MaxLanes];
+    Src0T src_vals0[MaxLanes];
+    Src1T src_vals1[MaxLanes];
+    Src2T src_vals2[MaxLanes];
+
+    if ($dest_is_src_flag) {
+        this->dest.template getLanes<CType>(w, dest_vals);
+    }
+
+    this->src0.template getLanes<Src0T>(w, src_vals0);
+    this->src1.template getLanes<Src1T>(w, src_vals1);
+    this->src2.template getLanes<Src2T>(w, src_vals2);
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
+        if (all_active || mask[lane]) {
             CType dest_val;
 
             if ($dest_is_src_flag) {
-                dest_val = this->dest.template get<CType>(w, lane);
+                dest_val = dest_vals[lane];
             }
 
-            Src0T src_val0 = this->src0.template get<Src0T>(w, lane);
-            Src1T src_val1 = this->src1.template get<Src1T>(w, lane);
-            Src2T src_val2 = this->src2.template get<Src2T>(w, lane);
-
-            dest_val = $expr;
+            Src0T src_val0 = src_vals0[lane];
+            Src1T src_val1 = src_vals1[lane];
+            Src2T src_val2 = src_vals2[lane];
 
-            this->dest.set(w, lane, dest_val);
+            dest_vals[lane] = $expr;
         }
     }
+
+    this->dest.setLanes(w, dest_vals, mask);
 }
 
 '''
@@ -374,21 +407,34 @@ $class_name<DataType>::execute(GPUDynInstPtr gpuDynInst)
     typedef typename Base::Src1CType Src1T;
 
     const VectorMask &mask = w->getPred();
+    const int num_lanes = w->computeUnit->wfSize();
+    const bool all_active = allLanesActive(mask, num_lanes);
 
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
-        if (mask[lane]) {
+    DestT dest_vals[MaxLanes];
+    Src0T src_vals0[MaxLanes];
+    Src1T src_vals1[MaxLanes];
+
+    if ($dest_is_src_flag) {
+        this->dest.template getLanes<DestT>(w, dest_vals);
+    }
+
+    this->src0.template getLanes<Src0T>(w, src_vals0);
+    this->src1.template getLanes<Src1T>(w, src_vals1);
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
+        if (all_active || mask[lane]) {
             DestT dest_val;
             if ($dest_is_src_flag) {
-                dest_val = this->dest.template get<DestT>(w, lane);
+                dest_val = dest_vals[lane];
             }
-            Src0T src_val0 = this->src0.template get<Src0T>(w, lane);
-            Src1T src_val1 = this->src1.template get<Src1T>(w, lane);
-
-            dest_val = $expr;
+            Src0T src_val0 = src_vals0[lane];
+            Src1T src_val1 = src_vals1[lane];
 
-            this->dest.set(w, lane, dest_val);
+            dest_vals[lane] = $expr;
         }
     }
+
+    this->dest.setLanes(w, dest_vals, mask);
 }
 
 '''
@@ -401,22 +447,36 @@ $class_name<DataType>::execute(GPUDynInstPtr gpuDynInst)
     Wavefront *w = gpuDynInst->wavefront();
 
     const VectorMask &mask = w->getPred();
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
-        if (mask[lane]) {
+    const int num_lanes = w->computeUnit->wfSize();
+    const bool all_active = allLanesActive(mask, num_lanes);
+
+    CType dest_vals[MaxLanes];
+    CType src_vals0[MaxLanes];
+    uint32_t src_vals1[MaxLanes];
+
+    if ($dest_is_src_flag) {
+        this->dest.template getLanes<CType>(w, dest_vals);
+    }
+
+    this->src0.template getLanes<CType>(w, src_vals0);
+    this->src1.template getLanes<uint32_t>(w, src_vals1);
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
+        if (all_active || mask[lane]) {
             CType dest_val;
 
             if ($dest_is_src_flag) {
-                dest_val = this->dest.template get<CType>(w, lane);
+                dest_val = dest_vals[lane];
             }
 
-            CType src_val0 = this->src0.template get<CType>(w, lane);
-            uint32_t src_val1 = this->src1.template get<uint32_t>(w, lane);
+            CType src_val0 = src_vals0[lane];
+            uint32_t src_val1 = src_vals1[lane];
 
-            dest_val = $expr;
-
-            this->dest.set(w, lane, dest_val);
+            dest_vals[lane] = $expr;
         }
     }
+
+    this->dest.setLanes(w, dest_vals, mask);
 }
 
 '''
@@ -429,21 +489,29 @@ $class_name<DestDataType, SrcDataType>::execute(GPUDynInstPtr gpuDynInst)
     Wavefront *w = gpuDynInst->wavefront();
 
     const VectorMask &mask = w->getPred();
+    const int num_lanes = w->computeUnit->wfSize();
+    const bool all_active = allLanesActive(mask, num_lanes);
 
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
-        if (mask[lane]) {
-            DestCType dest_val;
+    DestCType dest_vals[MaxLanes];
+    SrcCType src_vals[$num_srcs][MaxLanes];
+
+    for (int i = 0; i < $num_srcs; ++i) {
+        this->src[i].template getLanes<SrcCType>(w, src_vals[i]);
+    }
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
+        if (all_active || mask[lane]) {
             SrcCType src_val[$num_srcs];
 
             for (int i = 0; i < $num_srcs; ++i) {
-                src_val[i] = this->src[i].template get<SrcCType>(w, lane);
+                src_val[i] = src_vals[i][lane];
             }
 
-            dest_val = $expr;
-
-            this->dest.set(w, lane, dest_val);
+            dest_vals[lane] = $expr;
         }
     }
+
+    this->dest.setLanes(w, dest_vals, mask);
 }
 
 '''
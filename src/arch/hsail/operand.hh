@@ -42,8 +42,10 @@
  *  Defines classes encapsulating HSAIL instruction operands.
  */
 
+#include <algorithm>
 #include <limits>
 #include <string>
+#include <type_traits>
 
 #include "arch/hsail/Brig.h"
 #include "base/trace.hh"
@@ -194,6 +196,37 @@ class SRegOperand : public BaseRegOperand
 
     template<typename OperandType>
     void set(Wavefront *w, int lane, OperandType &val);
+
+    // get the operand of all the lanes of the wavefront
+    template<typename OperandType>
+    void
+    getLanes(Wavefront *w, OperandType *vals)
+    {
+        assert(sizeof(OperandType) <= sizeof(uint32_t));
+        assert(regIdx < w->maxSpVgprs);
+        const int num_lanes = w->computeUnit->wfSize();
+        uint32_t vgprIdx = w->remap(regIdx, sizeof(OperandType), 1);
+
+        if (sizeof(OperandType) == sizeof(uint32_t)) {
+            w->computeUnit->vrf[w->simdId]->
+                readLanes<OperandType>(vgprIdx, vals, num_lanes);
+        } else {
+            // if OperandType is smaller than 32-bit, we truncate the value
+            uint32_t regs[MaxLanes];
+            w->computeUnit->vrf[w->simdId]->
+                readLanes<uint32_t>(vgprIdx, regs, num_lanes);
+
+            for (int lane = 0; lane < num_lanes; ++lane) {
+                vals[lane] = (OperandType)regs[lane];
+            }
+        }
+    }
+
+    // set the operand of the active lanes of the wavefront
+    template<typename OperandType>
+    void setLanes(Wavefront *w, const OperandType *vals,
+                  const VectorMask &mask);
+
     std::string disassemble();
 };
 
@@ -222,6 +255,43 @@ SRegOperand::set(Wavefront *w, int lane, uint64_t &val)
     w->computeUnit->vrf[w->simdId]->write<uint32_t>(vgprIdx, val, lane);
 }
 
+template<typename OperandType>
+void
+SRegOperand::setLanes(Wavefront *w, const OperandType *vals,
+                      const VectorMask &mask)
+{
+    const int num_lanes = w->computeUnit->wfSize();
+
+    if (DTRACE(GPUReg)) {
+        for (int lane = 0; lane < num_lanes; ++lane) {
+            if (mask[lane]) {
+                DPRINTF(GPUReg, "CU%d, WF[%d][%d], lane %d: $s%d <- %d\n",
+                        w->computeUnit->cu_id, w->simdId, w->wfSlotId, lane,
+                        regIdx, vals[lane]);
+            }
+        }
+    }
+
+    // 64-bit values are truncated, as they are by set()
+    assert((sizeof(OperandType) == sizeof(uint32_t) ||
+            std::is_same<OperandType, uint64_t>::value));
+    assert(regIdx < w->maxSpVgprs);
+    uint32_t vgprIdx = w->remap(regIdx, sizeof(uint32_t), 1);
+
+    if (sizeof(OperandType) == sizeof(uint32_t)) {
+        w->computeUnit->vrf[w->simdId]->
+            writeLanes<OperandType>(vgprIdx, vals, num_lanes, mask);
+    } else {
+        uint32_t regs[MaxLanes];
+        for (int lane = 0; lane < num_lanes; ++lane) {
+            regs[lane] = vals[lane];
+        }
+
+        w->computeUnit->vrf[w->simdId]->
+            writeLanes<uint32_t>(vgprIdx, regs, num_lanes, mask);
+    }
+}
+
 class DRegOperand : public BaseRegOperand
 {
   public:
@@ -283,6 +353,43 @@ class DRegOperand : public BaseRegOperand
         w->computeUnit->vrf[w->simdId]->write<OperandType>(vgprIdx,val,lane);
     }
 
+    template<typename OperandType>
+    void
+    getLanes(Wavefront *w, OperandType *vals)
+    {
+        assert(sizeof(OperandType) <= sizeof(uint64_t));
+        // TODO: this check is valid only for HSAIL
+        assert(regIdx < w->maxDpVgprs);
+        uint32_t vgprIdx = w->remap(regIdx, sizeof(OperandType), 1);
+
+        w->computeUnit->vrf[w->simdId]->
+            readLanes<OperandType>(vgprIdx, vals, w->computeUnit->wfSize());
+    }
+
+    template<typename OperandType>
+    void
+    setLanes(Wavefront *w, const OperandType *vals, const VectorMask &mask)
+    {
+        const int num_lanes = w->computeUnit->wfSize();
+
+        if (DTRACE(GPUReg)) {
+            for (int lane = 0; lane < num_lanes; ++lane) {
+                if (mask[lane]) {
+                    DPRINTF(GPUReg, "CU%d, WF[%d][%d], lane %d: $d%d <- %d\n",
+                            w->computeUnit->cu_id, w->simdId, w->wfSlotId,
+                            lane, regIdx, vals[lane]);
+                }
+            }
+        }
+
+        assert(sizeof(OperandType) <= sizeof(uint64_t));
+        // TODO: this check is valid only for HSAIL
+        assert(regIdx < w->maxDpVgprs);
+        uint32_t vgprIdx = w->remap(regIdx, sizeof(OperandType), 1);
+        w->computeUnit->vrf[w->simdId]->
+            writeLanes<OperandType>(vgprIdx, vals, num_lanes, mask);
+    }
+
     std::string disassemble();
 };
 
@@ -341,6 +448,28 @@ class CRegOperand : public BaseRegOperand
         w->condRegState->write<OperandType>(regIdx,lane,val);
     }
 
+    // condition registers are bit masks, so they are accessed lane by lane
+    template<typename OperandType>
+    void
+    getLanes(Wavefront *w, OperandType *vals)
+    {
+        for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
+            vals[lane] = get<OperandType>(w, lane);
+        }
+    }
+
+    template<typename OperandType>
+    void
+    setLanes(Wavefront *w, const OperandType *vals, const VectorMask &mask)
+    {
+        for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
+            if (mask[lane]) {
+                OperandType val = vals[lane];
+                set(w, lane, val);
+            }
+        }
+    }
+
     std::string disassemble();
 };
 
@@ -383,6 +512,14 @@ class ImmOperand : public BaseOperand
     {
         return get<OperandType>(w);
     }
+
+    template<typename OperandType>
+    void
+    getLanes(Wavefront *w, OperandType *vals)
+    {
+        std::fill(vals, vals + w->computeUnit->wfSize(),
+                  get<OperandType>(w));
+    }
 };
 
 template<typename T>
@@ -477,6 +614,17 @@ class RegOrImmOperand : public BaseOperand
                          reg_op.template get<OperandType>(w, lane);
     }
 
+    template<typename OperandType>
+    void
+    getLanes(Wavefront *w, OperandType *vals)
+    {
+        if (is_imm) {
+            imm_op.template getLanes<OperandType>(w, vals);
+        } else {
+            reg_op.template getLanes<OperandType>(w, vals);
+        }
+    }
+
     uint32_t
     opSize()
     {
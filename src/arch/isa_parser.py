@@ -206,6 +206,9 @@ class Template(object):
                     op_wb_str = op_desc.op_wb + op_wb_str
             myDict['op_wb'] = op_wb_str
 
+            (myDict['exec_variant_decls'], myDict['exec_variant_defs']) = \
+                self.parser.execVariants(d.class_name)
+
         elif isinstance(d, dict):
             # if the argument is a dictionary, we just use it.
             myDict.update(d)
@@ -1453,10 +1456,15 @@ class LineTracker(object):
 #
 
 class ISAParser(Grammar):
-    def __init__(self, output_dir):
+    def __init__(self, output_dir, exec_contexts=()):
         super(ISAParser, self).__init__()
         self.output_dir = output_dir
 
+        # Concrete ExecContext types of the CPU models being built, as
+        # (class name, header) pairs. Templates can generate execute()
+        # variants on them, see execVariants().
+        self.exec_contexts = exec_contexts
+
         self.filename = None # for output file watermarking/scaremongering
 
         # variable to hold templates
@@ -1613,6 +1621,8 @@ class ISAParser(Grammar):
                 assert(fn in self.files)
                 f.write('#include "%s"\n' % fn)
                 f.write('#include "cpu/exec_context.hh"\n')
+                for (_, header) in self.exec_contexts:
+                    f.write('#include "%s"\n' % header)
                 f.write('#include "decoder.hh"\n')
 
                 fn = 'exec-ns.cc.inc'
@@ -2600,6 +2610,32 @@ StaticInstPtr
 
         ISAParser.AlreadyGenerated[isa_desc_file] = None
 
+    # Declarations and definitions of the execute() variants of a class
+    # on each concrete ExecContext. The variant for FooExecContext
+    # overrides StaticInst::executeFoo() and calls the class'
+    # executeImpl() member template, which the template using these
+    # must declare and define. Since executeImpl() is instantiated on
+    # the concrete type, calls to the register accessors are bound
+    # statically and can be inlined.
+    def execVariants(self, class_name):
+        decls = ''
+        defs = ''
+        for (exec_context, _) in self.exec_contexts:
+            assert exec_context.endswith('ExecContext')
+            method = 'execute' + exec_context[:-len('ExecContext')]
+            decls += 'Fault %s(ExecContext *, Trace::InstRecord *) ' \
+                     'const override;\n' % method
+            defs += '''
+Fault
+%(class_name)s::%(method)s(ExecContext *xc,
+        Trace::InstRecord *traceData) const
+{
+    return executeImpl(static_cast<%(exec_context)s *>(xc), traceData);
+}
+''' % { 'class_name' : class_name, 'method' : method,
+       'exec_context' : exec_context }
+        return (decls, defs)
+
     def parse_isa_desc(self, *args, **kwargs):
         try:
             self._parse_isa_desc(*args, **kwargs)
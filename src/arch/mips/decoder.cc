@@ -33,6 +33,6 @@
 namespace MipsISA
 {
 
-GenericISA::BasicDecodeCache Decoder::defaultCache;
+thread_local GenericISA::BasicDecodeCache Decoder::defaultCache;
 
 }
@@ -33,6 +33,6 @@
 namespace PowerISA
 {
 
-GenericISA::BasicDecodeCache Decoder::defaultCache;
+thread_local GenericISA::BasicDecodeCache Decoder::defaultCache;
 
 }
@@ -40,6 +40,8 @@ namespace RiscvISA
 static const MachInst LowerBitMask = (1 << sizeof(MachInst) * 4) - 1;
 static const MachInst UpperBitMask = LowerBitMask << sizeof(MachInst) * 4;
 
+thread_local DecodeCache::InstMap Decoder::instMap;
+
 void Decoder::reset()
 {
     aligned = true;
@@ -83,13 +85,10 @@ Decoder::decode(ExtMachInst mach_inst, Addr addr)
 {
     DPRINTF(Decode, "Decoding instruction 0x%08x at address %#x\n",
             mach_inst, addr);
-    if (instMap.find(mach_inst) != instMap.end())
-        return instMap[mach_inst];
-    else {
-        StaticInstPtr si = decodeInst(mach_inst);
-        instMap[mach_inst] = si;
-        return si;
-    }
+    StaticInstPtr &si = instMap[mach_inst];
+    if (!si)
+        si = decodeInst(mach_inst);
+    return si;
 }
 
 StaticInstPtr
@@ -48,7 +48,8 @@ class ISA;
 class Decoder
 {
   private:
-    DecodeCache::InstMap instMap;
+    /** Decoded instructions shared by the decoders of a thread. */
+    static thread_local DecodeCache::InstMap instMap;
     bool aligned;
     bool mid;
     bool more;
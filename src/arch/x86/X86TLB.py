@@ -35,6 +35,7 @@
 #
 # Authors: Gabe Black
 
+from m5.SimObject import SimObject
 from m5.params import *
 from m5.proxy import *
 
@@ -49,11 +50,35 @@ class X86PagetableWalker(MemObject):
     system = Param.System(Parent.any, "system object")
     num_squash_per_cycle = Param.Unsigned(4,
             "Number of outstanding walks that can be squashed per cycle")
+    num_walkers = Param.Unsigned(1,
+            "Number of walks that can be in progress at once")
+    walk_cache_size = Param.Unsigned(0,
+            "Number of cached PML4, PDP and PD entries (0 for none)")
+    walk_cache_assoc = Param.Unsigned(0,
+            "Walk cache associativity (0 for fully associative)")
+
+class X86SharedTLB(SimObject):
+    type = 'X86SharedTLB'
+    cxx_class = 'X86ISA::SharedTLB'
+    cxx_header = 'arch/x86/shared_tlb.hh'
+    size = Param.Unsigned(1536, "TLB size")
+    assoc = Param.Unsigned(12,
+        "TLB associativity (0 for fully associative)")
+    latency = Param.Latency('4ns', "Latency of a lookup")
 
 class X86TLB(BaseTLB):
     type = 'X86TLB'
     cxx_class = 'X86ISA::TLB'
     cxx_header = 'arch/x86/tlb.hh'
     size = Param.Unsigned(64, "TLB size")
+    assoc = Param.Unsigned(0, "TLB associativity (0 for fully associative)")
+    # A second level holds copies of all entries, and refills the first
+    # level on a miss without a page table walk.
+    l2_size = Param.Unsigned(0, "second level TLB size (0 for none)")
+    l2_assoc = Param.Unsigned(8,
+        "second level TLB associativity (0 for fully associative)")
+    # Several TLBs can share a last level, which they look up after
+    # their private ones.
+    shared_tlb = Param.X86SharedTLB(NULL, "shared last level TLB")
     walker = Param.X86PagetableWalker(\
             X86PagetableWalker(), "page table walker")
@@ -30,6 +30,8 @@
 
 #include "arch/x86/decoder.hh"
 
+#include <cstring>
+
 #include "arch/x86/regs/misc.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
@@ -88,6 +90,8 @@ Decoder::process()
     } else {
         instBytes->chunks.push_back(fetchChunk);
     }
+    if (state == PrefixState && basePC + offset == origPC && doFastDecode())
+        state = ResetState;
 
     //While there's still something to do...
     while (!instDone && !outOfBytes) {
@@ -503,15 +507,102 @@ Decoder::processOpcode(ByteTable &immTable, ByteTable &modrmTable,
     return nextState;
 }
 
-//Get the ModRM byte and determine what displacement, if any, there is.
-//Also determine whether or not to get the SIB byte, displacement, or
-//immediate next.
-Decoder::State
-Decoder::doModRMState(uint8_t nextByte)
+bool
+Decoder::doFastDecode()
+{
+    const uint8_t *bytes = (const uint8_t *)&fetchChunk;
+    const int end = sizeof(MachInst);
+    int pos = offset;
+
+    // Only handle a REX prefix, anything else goes the long way.
+    uint8_t rex = 0;
+    uint8_t prefix = Prefixes[bytes[pos]];
+    if (prefix == RexPrefix && emi.mode.submode == SixtyFourBitMode) {
+        rex = bytes[pos++];
+        if (pos == end)
+            return false;
+        prefix = Prefixes[bytes[pos]];
+    }
+    if (prefix && !(prefix == RexPrefix &&
+                    emi.mode.submode != SixtyFourBitMode)) {
+        return false;
+    }
+    emi.rex = rex;
+
+    State nextState;
+    if (bytes[pos] == 0x0f) {
+        if (++pos == end)
+            return false;
+        const uint8_t op = bytes[pos++];
+        if (op == 0x38 || op == 0x3a)
+            return false;
+        emi.opcode.type = TwoByteOpcode;
+        emi.opcode.op = op;
+        nextState = processOpcode(ImmediateTypeTwoByte, UsesModRMTwoByte);
+    } else {
+        const uint8_t op = bytes[pos++];
+        emi.opcode.type = OneByteOpcode;
+        emi.opcode.op = op;
+        nextState = processOpcode(ImmediateTypeOneByte, UsesModRMOneByte,
+                                  op >= 0xA0 && op <= 0xA3);
+    }
+
+    displacementSize = 0;
+    if (nextState == ModRMState) {
+        if (pos == end)
+            return false;
+        emi.modRM = bytes[pos++];
+        if (processModRM(emi.modRM)) {
+            if (pos == end)
+                return false;
+            emi.sib = bytes[pos++];
+            if (emi.modRM.mod == 0 && emi.sib.base == 5)
+                displacementSize = 4;
+        }
+    }
+    // Let the slow path start over from the first byte if the
+    // instruction continues in the next chunk.
+    if (pos + displacementSize + immediateSize > end)
+        return false;
+
+    if (displacementSize) {
+        uint64_t disp = 0;
+        memcpy(&disp, bytes + pos, displacementSize);
+        pos += displacementSize;
+        switch (displacementSize) {
+          case 1:
+            emi.displacement = sext<8>(disp);
+            break;
+          case 2:
+            emi.displacement = sext<16>(disp);
+            break;
+          default:
+            emi.displacement = sext<32>(disp);
+            break;
+        }
+        emi.dispSize = displacementSize;
+    }
+    if (immediateSize) {
+        uint64_t imm = 0;
+        memcpy(&imm, bytes + pos, immediateSize);
+        pos += immediateSize;
+        // Sign extend like doImmediateState does.
+        if (immediateSize == 4)
+            imm = sext<32>(imm);
+        else if (immediateSize == 1)
+            imm = sext<8>(imm);
+        emi.immediate = imm;
+    }
+
+    DPRINTF(Decoder, "Fast decoded %d byte instruction.\n", pos - offset);
+    consumeBytes(pos - offset);
+    instDone = true;
+    return true;
+}
+
+bool
+Decoder::processModRM(ModRM modRM)
 {
-    State nextState = ErrorState;
-    ModRM modRM = nextByte;
-    DPRINTF(Decoder, "Found modrm byte %#x.\n", nextByte);
     if (defOp == 1) {
         //figure out 16 bit displacement size
         if ((modRM.mod == 0 && modRM.rm == 6) || modRM.mod == 2)
@@ -539,10 +630,22 @@ Decoder::doModRMState(uint8_t nextByte)
            immediateSize = (emi.opSize == 8) ? 4 : emi.opSize;
     }
 
-    //If there's an SIB, get that next.
     //There is no SIB in 16 bit mode.
-    if (modRM.rm == 4 && modRM.mod != 3) {
-            // && in 32/64 bit mode)
+    return modRM.rm == 4 && modRM.mod != 3; // && in 32/64 bit mode
+}
+
+//Get the ModRM byte and determine what displacement, if any, there is.
+//Also determine whether or not to get the SIB byte, displacement, or
+//immediate next.
+Decoder::State
+Decoder::doModRMState(uint8_t nextByte)
+{
+    State nextState = ErrorState;
+    ModRM modRM = nextByte;
+    DPRINTF(Decoder, "Found modrm byte %#x.\n", nextByte);
+
+    //If there's an SIB, get that next.
+    if (processModRM(modRM)) {
         nextState = SIBState;
     } else if (displacementSize) {
         nextState = DisplacementState;
@@ -676,11 +779,16 @@ Decoder::doImmediateState()
 }
 
 Decoder::InstBytes Decoder::dummy;
-Decoder::InstCacheMap Decoder::instCacheMap;
+thread_local Decoder::InstCacheMap Decoder::instCacheMap;
 
 StaticInstPtr
 Decoder::decode(ExtMachInst mach_inst, Addr addr)
 {
+    // The mode may have been set from another thread, e.g., while
+    // restoring a checkpoint.
+    if (instMapOwner != &instCacheMap)
+        updateInstMap();
+
     DecodeCache::InstMap::iterator iter = instMap->find(mach_inst);
     if (iter != instMap->end())
         return iter->second;
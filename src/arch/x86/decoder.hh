@@ -216,6 +216,12 @@ class Decoder
     //Process the actual opcode found earlier, using the supplied tables.
     State processOpcode(ByteTable &immTable, ByteTable &modrmTable,
                         bool addrSizedImm = false);
+    //Set the displacement size and fix up the immediate size for a ModRM
+    //byte. Returns whether a SIB byte follows.
+    bool processModRM(ModRM modRM);
+    //Decode a whole instruction from fetchChunk with table lookups if it
+    //has no prefixes other than REX and is contained in the chunk.
+    bool doFastDecode();
     // Process the opcode found with VEX / XOP prefix.
     State processExtendedOpcode(ByteTable &immTable);
 
@@ -229,9 +235,34 @@ class Decoder
     typedef std::unordered_map<CacheKey, DecodePages *> AddrCacheMap;
     AddrCacheMap addrCacheMap;
 
+    /**
+     * Instructions are cached by their bytes for each mode, and the
+     * cache is shared by all the decoders of a simulation thread. Each
+     * thread has its own cache so that no locking is needed in
+     * parallel simulations.
+     */
     DecodeCache::InstMap *instMap;
     typedef std::unordered_map<CacheKey, DecodeCache::InstMap *> InstCacheMap;
-    static InstCacheMap instCacheMap;
+    static thread_local InstCacheMap instCacheMap;
+
+    /** Mode of the cache instMap points to. */
+    CacheKey instMapKey;
+    /** Caches instMap belongs to, i.e., instCacheMap of some thread. */
+    InstCacheMap *instMapOwner;
+
+    /** Points instMap to the cache of this thread for instMapKey. */
+    void
+    updateInstMap()
+    {
+        InstCacheMap::iterator imIter = instCacheMap.find(instMapKey);
+        if (imIter != instCacheMap.end()) {
+            instMap = imIter->second;
+        } else {
+            instMap = new DecodeCache::InstMap;
+            instCacheMap[instMapKey] = instMap;
+        }
+        instMapOwner = &instCacheMap;
+    }
 
   public:
     Decoder(ISA* isa = nullptr) : basePC(0), origPC(0), offset(0),
@@ -251,6 +282,8 @@ class Decoder
         instBytes = &dummy;
         decodePages = NULL;
         instMap = NULL;
+        instMapKey = 0;
+        instMapOwner = NULL;
     }
 
     void setM5Reg(HandyM5Reg m5Reg)
@@ -273,13 +306,8 @@ class Decoder
             addrCacheMap[m5Reg] = decodePages;
         }
 
-        InstCacheMap::iterator imIter = instCacheMap.find(m5Reg);
-        if (imIter != instCacheMap.end()) {
-            instMap = imIter->second;
-        } else {
-            instMap = new DecodeCache::InstMap;
-            instCacheMap[m5Reg] = instMap;
-        }
+        instMapKey = m5Reg;
+        updateInstMap();
     }
 
     void takeOverFrom(Decoder *old)
@@ -41,6 +41,8 @@
 #define __ARCH_X86_INSTS_MICROREGOP_HH__
 
 #include "arch/x86/insts/microop.hh"
+#include "arch/x86/regs/misc.hh"
+#include "base/condcodes.hh"
 
 namespace X86ISA
 {
@@ -70,10 +72,43 @@ namespace X86ISA
             foldOBit = (dataSize == 1 && !_machInst.rex.present) ? 1 << 6 : 0;
         }
 
-        //Figure out what the condition code flags should be.
-        uint64_t genFlags(uint64_t oldFlags, uint64_t flagMask,
+        /**
+         * Figure out what the condition code flags should be. The data
+         * size is passed in rather than read from the microop so that
+         * microops specialized on their size fold it into the flag
+         * computation.
+         */
+        static uint64_t
+        genFlags(int size, uint64_t oldFlags, uint64_t flagMask,
                 uint64_t _dest, uint64_t _src1, uint64_t _src2,
-                bool subtract = false) const;
+                bool subtract = false)
+        {
+            uint64_t flags = oldFlags & ~flagMask;
+            if (flagMask & (ECFBit | CFBit))
+            {
+                if (findCarry(size * 8, _dest, _src1, _src2))
+                    flags |= (flagMask & (ECFBit | CFBit));
+                if (subtract)
+                    flags ^= (flagMask & (ECFBit | CFBit));
+            }
+            if (flagMask & PFBit && !findParity(8, _dest))
+                flags |= PFBit;
+            if (flagMask & AFBit)
+            {
+                if (findCarry(4, _dest, _src1, _src2))
+                    flags |= AFBit;
+                if (subtract)
+                    flags ^= AFBit;
+            }
+            if (flagMask & (EZFBit | ZFBit) && findZero(size * 8, _dest))
+                flags |= (flagMask & (EZFBit | ZFBit));
+            if (flagMask & SFBit && findNegative(size * 8, _dest))
+                flags |= SFBit;
+            if (flagMask & OFBit &&
+                    findOverflow(size * 8, _dest, _src1, _src2))
+                flags |= OFBit;
+            return flags;
+        }
     };
 
     class RegOp : public RegOpBase
@@ -63,6 +63,7 @@
 #include "mem/packet_access.hh"
 #include "sim/full_system.hh"
 #include "sim/system.hh"
+#include "sim/timer_wheel.hh"
 
 int
 divideFromConf(uint32_t conf)
@@ -377,12 +378,13 @@ X86ISA::Interrupts::readReg(ApicRegIndex reg)
         break;
       case APIC_CURRENT_COUNT:
         {
-            if (apicTimerEvent.scheduled()) {
+            const Tick expiry = timerExpiry();
+            if (expiry != MaxTick) {
                 // Compute how many m5 ticks happen per count.
                 uint64_t ticksPerCount = clockPeriod() *
                     divideFromConf(regs[APIC_DIVIDE_CONFIGURATION]);
                 // Compute how many m5 ticks are left.
-                uint64_t val = apicTimerEvent.when() - curTick();
+                uint64_t val = expiry - curTick();
                 // Turn that into a count.
                 val = (val + ticksPerCount - 1) / ticksPerCount;
                 return val;
@@ -550,6 +552,12 @@ X86ISA::Interrupts::setReg(ApicRegIndex reg, uint32_t val)
             uint64_t readOnlyMask = (1 << 12) | (1 << 14);
             newVal = (val & ~readOnlyMask) |
                      (regs[reg] & readOnlyMask);
+            if (reg == APIC_LVT_TIMER && timerWheel) {
+                // (Un)masking the timer (de)schedules it.
+                regs[reg] = newVal;
+                updateTimer();
+                return;
+            }
         }
         break;
       case APIC_INITIAL_COUNT:
@@ -560,18 +568,16 @@ X86ISA::Interrupts::setReg(ApicRegIndex reg, uint32_t val)
                 (divideFromConf(regs[APIC_DIVIDE_CONFIGURATION]));
             // Schedule on the edge of the next tick plus the new count.
             Tick offset = curTick() % clockPeriod();
+            regs[reg] = newVal;
             if (offset) {
-                reschedule(apicTimerEvent,
-                           curTick() + (newCount + 1) *
-                           clockPeriod() - offset, true);
+                armTimer(curTick() + (newCount + 1) *
+                         clockPeriod() - offset);
             } else {
                 if (newCount)
-                    reschedule(apicTimerEvent,
-                               curTick() + newCount *
-                               clockPeriod(), true);
+                    armTimer(curTick() + newCount * clockPeriod());
             }
+            return;
         }
-        break;
       case APIC_CURRENT_COUNT:
         //Local APIC Current Count register is read only.
         return;
@@ -589,6 +595,8 @@ X86ISA::Interrupts::setReg(ApicRegIndex reg, uint32_t val)
 X86ISA::Interrupts::Interrupts(Params * p)
     : BasicPioDevice(p, PageBytes), IntDevice(this, p->int_latency),
       apicTimerEvent([this]{ processApicTimerEvent(); }, name()),
+      timerWheel(p->system->timerWheel(eventQueue())), timerSlot(0),
+      timerTarget(MaxTick),
       pendingSmi(false), smiVector(0),
       pendingNmi(false), nmiVector(0),
       pendingExtInt(false), extIntVector(0),
@@ -603,6 +611,9 @@ X86ISA::Interrupts::Interrupts(Params * p)
     regs[APIC_DESTINATION_FORMAT] = (uint32_t)(-1);
     ISRV = 0;
     IRRV = 0;
+
+    if (timerWheel)
+        timerSlot = timerWheel->add([this]{ processApicTimerEvent(); });
 }
 
 
@@ -724,9 +735,9 @@ X86ISA::Interrupts::serialize(CheckpointOut &cp) const
     SERIALIZE_SCALAR(pendingIPIs);
     SERIALIZE_SCALAR(IRRV);
     SERIALIZE_SCALAR(ISRV);
-    bool apicTimerEventScheduled = apicTimerEvent.scheduled();
+    Tick apicTimerEventTick = timerExpiry();
+    bool apicTimerEventScheduled = apicTimerEventTick != MaxTick;
     SERIALIZE_SCALAR(apicTimerEventScheduled);
-    Tick apicTimerEventTick = apicTimerEvent.when();
     SERIALIZE_SCALAR(apicTimerEventTick);
 }
 
@@ -754,11 +765,7 @@ X86ISA::Interrupts::unserialize(CheckpointIn &cp)
     if (apicTimerEventScheduled) {
         Tick apicTimerEventTick;
         UNSERIALIZE_SCALAR(apicTimerEventTick);
-        if (apicTimerEvent.scheduled()) {
-            reschedule(apicTimerEvent, apicTimerEventTick, true);
-        } else {
-            schedule(apicTimerEvent, apicTimerEventTick);
-        }
+        armTimer(apicTimerEventTick);
     }
 }
 
@@ -770,6 +777,70 @@ X86LocalApicParams::create()
 
 void
 X86ISA::Interrupts::processApicTimerEvent() {
-    if (triggerTimerInterrupt())
-        setReg(APIC_INITIAL_COUNT, readReg(APIC_INITIAL_COUNT));
+    if (!timerWheel) {
+        if (triggerTimerInterrupt())
+            setReg(APIC_INITIAL_COUNT, readReg(APIC_INITIAL_COUNT));
+        return;
+    }
+
+    // Count periods from the programmed expiry rather than the
+    // current tick, which may be later if the timer was deferred.
+    const Tick target = timerTarget;
+    timerTarget = MaxTick;
+    if (triggerTimerInterrupt() && timerPeriod())
+        armTimer(target + timerPeriod());
+}
+
+void
+X86ISA::Interrupts::armTimer(Tick when)
+{
+    if (!timerWheel) {
+        reschedule(apicTimerEvent, when, true);
+        return;
+    }
+
+    timerTarget = when;
+    updateTimer();
+}
+
+void
+X86ISA::Interrupts::updateTimer()
+{
+    LVTEntry entry = regs[APIC_LVT_TIMER];
+    timerTarget = timerExpiry();
+    if (timerTarget == MaxTick || entry.masked) {
+        // Nothing to deliver, the count runs down lazily.
+        timerWheel->deactivate(timerSlot);
+        return;
+    }
+
+    // The periodic ticks of idle cores can be coalesced.
+    const bool idle = cpu &&
+        sys->contextIdle(cpu->getContext(0)->contextId());
+    timerWheel->activate(timerSlot, timerTarget, idle);
+}
+
+Tick
+X86ISA::Interrupts::timerPeriod() const
+{
+    return (Tick)regs[APIC_INITIAL_COUNT] *
+        divideFromConf(regs[APIC_DIVIDE_CONFIGURATION]) * clockPeriod();
+}
+
+Tick
+X86ISA::Interrupts::timerExpiry() const
+{
+    if (!timerWheel)
+        return apicTimerEvent.scheduled() ? apicTimerEvent.when() : MaxTick;
+
+    if (timerTarget == MaxTick || timerTarget >= curTick())
+        return timerTarget;
+
+    // The timer expired without being serviced, because it's masked
+    // or was deferred. A periodic timer has been reloaded since.
+    LVTEntry entry = regs[APIC_LVT_TIMER];
+    const Tick period = timerPeriod();
+    if (!entry.periodic || !period)
+        return MaxTick;
+    return timerTarget + divCeil(curTick() - timerTarget, period) * period;
 }
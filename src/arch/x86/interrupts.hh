@@ -65,6 +65,7 @@
 
 class ThreadContext;
 class BaseCPU;
+class TimerWheel;
 
 int divideFromConf(uint32_t conf);
 
@@ -95,6 +96,26 @@ class Interrupts : public BasicPioDevice, IntDevice
     EventFunctionWrapper apicTimerEvent;
     void processApicTimerEvent();
 
+    /*
+     * With tickless timers, the timer is serviced by the timer wheel
+     * of the system instead of apicTimerEvent. A masked timer is not
+     * scheduled at all, the count is derived from timerTarget when
+     * it's read.
+     */
+    TimerWheel *timerWheel;
+    unsigned timerSlot;
+    /** Tick the timer was last programmed to expire, or MaxTick */
+    Tick timerTarget;
+
+    /** Make the timer expire at a tick. */
+    void armTimer(Tick when);
+    /** Update the timer wheel after a change of the timer state. */
+    void updateTimer();
+    /** Ticks between two expiries of a periodic timer. */
+    Tick timerPeriod() const;
+    /** Next expiry of the timer, MaxTick if it's not counting. */
+    Tick timerExpiry() const;
+
     /*
      * A set of variables to keep track of interrupts that don't go through
      * the IRR.
@@ -75,7 +75,10 @@ Walker::start(ThreadContext * _tc, BaseTLB::Translation *_translation,
     // another one (i.e. either coalesce or start walk)
     WalkerState * newState = new WalkerState(this, _translation, _req);
     newState->initState(_tc, _mode, sys->isTimingMode());
-    if (currStates.size()) {
+    walks++;
+    // Start right away if a walker is free and nobody is waiting for one.
+    const unsigned active = activeWalks();
+    if (active < currStates.size() || active >= numWalkers) {
         assert(newState->isTiming());
         DPRINTF(PageTableWalker, "Walks in progress: %d\n", currStates.size());
         currStates.push_back(newState);
@@ -84,7 +87,7 @@ Walker::start(ThreadContext * _tc, BaseTLB::Translation *_translation,
         currStates.push_back(newState);
         Fault fault = newState->startWalk();
         if (!newState->isTiming()) {
-            currStates.pop_front();
+            currStates.pop_back();
             delete newState;
         }
         return fault;
@@ -123,9 +126,10 @@ Walker::recvTimingResp(PacketPtr pkt)
             }
         }
         delete senderWalk;
-        // Since we block requests when another is outstanding, we
+        // Since we block requests when all walkers are busy, we
         // need to check if there is a waiting request to be serviced
-        if (currStates.size() && !startWalkWrapperEvent.scheduled())
+        if (activeWalks() < currStates.size() &&
+            !startWalkWrapperEvent.scheduled())
             // delay sending any new requests until we are finished
             // with the responses
             schedule(startWalkWrapperEvent, clockEdge());
@@ -187,35 +191,79 @@ Walker::WalkerState::initState(ThreadContext * _tc,
     timing = _isTiming;
 }
 
+unsigned
+Walker::activeWalks() const
+{
+    unsigned active = 0;
+    for (auto walker_state : currStates) {
+        if (walker_state->wasStarted())
+            active++;
+    }
+    return active;
+}
+
 void
 Walker::startWalkWrapper()
 {
     unsigned num_squashed = 0;
-    WalkerState *currState = currStates.front();
-    while ((num_squashed < numSquashable) && currState &&
-        currState->translation->squashed()) {
-        currStates.pop_front();
-        num_squashed++;
-
-        DPRINTF(PageTableWalker, "Squashing table walk for address %#x\n",
-            currState->req->getVaddr());
-
-        // finish the translation which will delete the translation object
-        currState->translation->finish(
-            std::make_shared<UnimpFault>("Squashed Inst"),
-            currState->req, currState->tc, currState->mode);
-
-        // delete the current request
-        delete currState;
-
-        // check the next translation request, if it exists
-        if (currStates.size())
-            currState = currStates.front();
-        else
-            currState = NULL;
-    }
-    if (currState && !currState->wasStarted())
+    unsigned active = activeWalks();
+    auto iter = currStates.begin();
+    while (iter != currStates.end() && active < numWalkers) {
+        WalkerState *currState = *iter;
+        if (currState->wasStarted()) {
+            iter++;
+            continue;
+        }
+
+        if (num_squashed < numSquashable &&
+            currState->translation->squashed()) {
+            iter = currStates.erase(iter);
+            num_squashed++;
+
+            DPRINTF(PageTableWalker, "Squashing table walk for address %#x\n",
+                currState->req->getVaddr());
+
+            // finish the translation which will delete the translation object
+            currState->translation->finish(
+                std::make_shared<UnimpFault>("Squashed Inst"),
+                currState->req, currState->tc, currState->mode);
+
+            // delete the current request
+            delete currState;
+            continue;
+        }
+
         currState->startWalk();
+        active++;
+        iter++;
+    }
+}
+
+void
+Walker::flushWalkCache()
+{
+    if (walkCache)
+        walkCache->clear();
+}
+
+void
+Walker::regStats()
+{
+    MemObject::regStats();
+
+    walks
+        .name(name() + ".walks")
+        .desc("Table walks requested");
+
+    walkCacheHits
+        .name(name() + ".walkCacheHits")
+        .desc("Table walks started from a paging-structure cache entry");
+
+    walkLatency
+        .init(16)
+        .name(name() + ".walkLatency")
+        .desc("Ticks from the request of a timing walk to its completion")
+        .flags(Stats::pdf);
 }
 
 Fault
@@ -304,6 +352,8 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             break;
         }
         entry.noExec = pte.nx;
+        pathNX = pte.nx;
+        cacheTable(39, (uint64_t)pte & (mask(40) << 12), uncacheable);
         nextState = LongPDP;
         break;
       case LongPDP:
@@ -319,6 +369,8 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             fault = pageFault(pte.p);
             break;
         }
+        pathNX = pathNX || pte.nx;
+        cacheTable(30, (uint64_t)pte & (mask(40) << 12), uncacheable);
         nextState = LongPD;
         break;
       case LongPD:
@@ -338,6 +390,8 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             entry.logBytes = 12;
             nextRead =
                 ((uint64_t)pte & (mask(40) << 12)) + vaddr.longl1 * dataSize;
+            pathNX = pathNX || pte.nx;
+            cacheTable(21, (uint64_t)pte & (mask(40) << 12), uncacheable);
             nextState = LongPTE;
             break;
         } else {
@@ -533,6 +587,24 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
     return fault;
 }
 
+void
+Walker::WalkerState::cacheTable(unsigned logBytes, Addr table,
+                                bool uncacheable)
+{
+    if (!walker->walkCache || functional)
+        return;
+
+    WalkCacheEntry cached;
+    cached.logBytes = logBytes;
+    cached.table = table;
+    cached.uncacheable = uncacheable;
+    cached.writable = entry.writable;
+    cached.user = entry.user;
+    cached.noExec = entry.noExec;
+    cached.pathNX = pathNX;
+    walker->walkCache->insert(entry.vaddr & ~mask(logBytes), cached);
+}
+
 void
 Walker::WalkerState::endWalk()
 {
@@ -550,12 +622,48 @@ Walker::WalkerState::setupWalk(Addr vaddr)
     // Check if we're in long mode or not
     Efer efer = tc->readMiscRegNoEffect(MISCREG_EFER);
     dataSize = 8;
+    pathNX = false;
     Addr topAddr;
+    bool uncacheable = cr3.pcd;
     if (efer.lma) {
         // Do long mode.
         state = LongPML4;
         topAddr = (cr3.longPdtb << 12) + addr.longl4 * dataSize;
         enableNX = efer.nxe;
+
+        // Skip the levels of the walk held in the paging-structure cache.
+        // Walks that would fault on an NX bit take the long way around.
+        WalkCacheEntry *cached =
+            walker->walkCache && !functional ?
+            walker->walkCache->lookup(vaddr) : nullptr;
+        if (cached && !(cached->pathNX && mode == BaseTLB::Execute &&
+                        enableNX)) {
+            walker->walkCacheHits++;
+            switch (cached->logBytes) {
+              case 39:
+                state = LongPDP;
+                topAddr = cached->table + addr.longl3 * dataSize;
+                break;
+              case 30:
+                state = LongPD;
+                topAddr = cached->table + addr.longl2 * dataSize;
+                break;
+              case 21:
+                state = LongPTE;
+                topAddr = cached->table + addr.longl1 * dataSize;
+                entry.logBytes = 12;
+                break;
+              default:
+                panic("Bad walk cache entry size %d.\n", cached->logBytes);
+            }
+            uncacheable = cached->uncacheable;
+            entry.writable = cached->writable;
+            entry.user = cached->user;
+            entry.noExec = cached->noExec;
+            pathNX = cached->pathNX;
+            DPRINTF(PageTableWalker, "Walk cache hit for %#x, starting at "
+                    "%#x.\n", vaddr, topAddr);
+        }
     } else {
         // We're in some flavor of legacy mode.
         CR4 cr4 = tc->readMiscRegNoEffect(MISCREG_CR4);
@@ -582,7 +690,7 @@ Walker::WalkerState::setupWalk(Addr vaddr)
     entry.vaddr = vaddr;
 
     Request::Flags flags = Request::PHYSICAL;
-    if (cr3.pcd)
+    if (uncacheable)
         flags.set(Request::UNCACHEABLE);
     RequestPtr request = new Request(topAddr, dataSize, flags,
                                      walker->masterId);
@@ -621,6 +729,7 @@ Walker::WalkerState::recvPacket(PacketPtr pkt)
     if (inflight == 0 && read == NULL && writes.size() == 0) {
         state = Ready;
         nextState = Waiting;
+        walker->walkLatency.sample(curTick() - startTick);
         if (timingFault == NoFault) {
             /*
              * Finish the translation. Now that we know the right entry is
@@ -40,8 +40,10 @@
 #ifndef __ARCH_X86_PAGE_TABLE_WALKER_HH__
 #define __ARCH_X86_PAGE_TABLE_WALKER_HH__
 
+#include <memory>
 #include <vector>
 
+#include "arch/generic/set_assoc_tlb.hh"
 #include "arch/x86/pagetable.hh"
 #include "arch/x86/tlb.hh"
 #include "base/types.hh"
@@ -111,6 +113,10 @@ namespace X86ISA
             bool timing;
             bool retrying;
             bool started;
+            // Whether an NX bit was set in any entry walked so far
+            bool pathNX;
+            // When the walk was requested, for statistics
+            Tick startTick;
           public:
             WalkerState(Walker * _walker, BaseTLB::Translation *_translation,
                     RequestPtr _req, bool _isFunctional = false) :
@@ -118,7 +124,8 @@ namespace X86ISA
                         nextState(Ready), inflight(0),
                         translation(_translation),
                         functional(_isFunctional), timing(false),
-                        retrying(false), started(false)
+                        retrying(false), started(false), pathNX(false),
+                        startTick(curTick())
             {
             }
             void initState(ThreadContext * _tc, BaseTLB::Mode _mode,
@@ -135,6 +142,7 @@ namespace X86ISA
           private:
             void setupWalk(Addr vaddr);
             Fault stepWalk(PacketPtr &write);
+            void cacheTable(unsigned logBytes, Addr table, bool uncacheable);
             void sendPackets();
             void endWalk();
             Fault pageFault(bool present);
@@ -147,6 +155,32 @@ namespace X86ISA
         // State for functional accesses (only need one of these per walker)
         WalkerState funcState;
 
+        /**
+         * Paging-structure cache entry. It holds the address of the
+         * next level table for the region of 2^logBytes bytes starting
+         * at vaddr, together with the permissions gathered by the walk
+         * down to that table.
+         */
+        struct WalkCacheEntry
+        {
+            Addr vaddr;
+            unsigned logBytes;
+            Addr table;
+            bool uncacheable;
+            bool writable;
+            bool user;
+            bool noExec;
+            bool pathNX;
+        };
+
+        /**
+         * Cache of the PML4, PDP and PD entries of long mode walks,
+         * indexed by the 512GB, 1GB and 2MB regions they map. A lookup
+         * returns the deepest level cached, so a walk resumes as close
+         * to the leaf as possible.
+         */
+        std::unique_ptr<GenericISA::SetAssocTLB<WalkCacheEntry>> walkCache;
+
         struct WalkerSenderState : public Packet::SenderState
         {
             WalkerState * senderWalk;
@@ -172,6 +206,17 @@ namespace X86ISA
         // The number of outstanding walks that can be squashed per cycle.
         unsigned numSquashable;
 
+        // The number of walks that can be in progress at once.
+        unsigned numWalkers;
+
+        // Number of walks currently in progress.
+        unsigned activeWalks() const;
+
+        // Statistics
+        Stats::Scalar walks;
+        Stats::Scalar walkCacheHits;
+        Stats::Histogram walkLatency;
+
         // Wrapper for checking for squashes before starting a translation.
         void startWalkWrapper();
 
@@ -192,6 +237,11 @@ namespace X86ISA
             tlb = _tlb;
         }
 
+        // Invalidate the paging-structure caches.
+        void flushWalkCache();
+
+        void regStats() override;
+
         typedef X86PagetableWalkerParams Params;
 
         const Params *
@@ -205,8 +255,15 @@ namespace X86ISA
             funcState(this, NULL, NULL, true), tlb(NULL), sys(params->system),
             masterId(sys->getMasterId(name())),
             numSquashable(params->num_squash_per_cycle),
+            numWalkers(params->num_walkers),
             startWalkWrapperEvent([this]{ startWalkWrapper(); }, name())
         {
+            fatal_if(!numWalkers, "%s: num_walkers must be at least 1.\n",
+                     name());
+            if (params->walk_cache_size) {
+                walkCache.reset(new GenericISA::SetAssocTLB<WalkCacheEntry>(
+                    params->walk_cache_size, params->walk_cache_assoc));
+            }
         }
     };
 }
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arch/x86/shared_tlb.hh"
+
+#include "debug/TLB.hh"
+
+namespace X86ISA {
+
+SharedTLB::SharedTLB(const Params *p)
+    : SimObject(p), tlb(p->size, p->assoc), _latency(p->latency)
+{
+}
+
+TlbEntry *
+SharedTLB::lookup(Addr va, uint64_t asid)
+{
+    TlbEntry *entry = tlb.lookup(va, true, asid);
+    if (!entry)
+        entry = tlb.lookup(va, true, GlobalAsid);
+    if (entry)
+        hits++;
+    else
+        misses++;
+    return entry;
+}
+
+void
+SharedTLB::insert(Addr vpn, const TlbEntry &entry, uint64_t asid)
+{
+    tlb.insert(vpn, entry, entry.global ? GlobalAsid : asid);
+}
+
+void
+SharedTLB::flushAll()
+{
+    DPRINTF(TLB, "Invalidating all shared entries.\n");
+    tlb.clear();
+}
+
+void
+SharedTLB::flushNonGlobal(uint64_t asid)
+{
+    DPRINTF(TLB, "Invalidating shared entries of address space %#x.\n",
+            asid);
+    tlb.removeTag(asid);
+}
+
+void
+SharedTLB::demapPage(Addr va, uint64_t asid)
+{
+    if (TlbEntry *entry = tlb.lookup(va, false, asid))
+        tlb.remove(entry);
+    if (TlbEntry *entry = tlb.lookup(va, false, GlobalAsid))
+        tlb.remove(entry);
+}
+
+void
+SharedTLB::regStats()
+{
+    SimObject::regStats();
+
+    hits
+        .name(name() + ".hits")
+        .desc("Private TLB misses that hit in the shared TLB");
+
+    misses
+        .name(name() + ".misses")
+        .desc("Private TLB misses that missed in the shared TLB");
+}
+
+} // namespace X86ISA
+
+X86ISA::SharedTLB *
+X86SharedTLBParams::create()
+{
+    return new X86ISA::SharedTLB(this);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARCH_X86_SHARED_TLB_HH__
+#define __ARCH_X86_SHARED_TLB_HH__
+
+#include "arch/generic/set_assoc_tlb.hh"
+#include "arch/x86/pagetable.hh"
+#include "base/statistics.hh"
+#include "params/X86SharedTLB.hh"
+#include "sim/sim_object.hh"
+
+namespace X86ISA
+{
+    /**
+     * Second level TLB shared by the private TLBs of several CPUs.
+     *
+     * The private TLBs look translations up here when they miss, and
+     * copy the translations they walk here. Entries are tagged with the
+     * address space they belong to, so CPUs running different processes
+     * or guests don't see each other's translations. Global entries are
+     * shared by all address spaces.
+     */
+    class SharedTLB : public SimObject
+    {
+      public:
+        typedef X86SharedTLBParams Params;
+
+        /** Tag of the entries of global pages. */
+        static const uint64_t GlobalAsid = ~(uint64_t)0;
+
+        SharedTLB(const Params *p);
+
+        /** Time it takes to look up a translation. */
+        Tick latency() const { return _latency; }
+
+        TlbEntry *lookup(Addr va, uint64_t asid);
+        void insert(Addr vpn, const TlbEntry &entry, uint64_t asid);
+
+        /** Drop the entries of all address spaces. */
+        void flushAll();
+        /** Drop the entries of an address space, but not global ones. */
+        void flushNonGlobal(uint64_t asid);
+        /** Drop the translation of a page in an address space. */
+        void demapPage(Addr va, uint64_t asid);
+
+        void regStats() override;
+
+      protected:
+        GenericISA::SetAssocTLB<TlbEntry> tlb;
+
+        const Tick _latency;
+
+        Stats::Scalar hits;
+        Stats::Scalar misses;
+    };
+}
+
+#endif // __ARCH_X86_SHARED_TLB_HH__
@@ -39,6 +39,7 @@
 
 #include "arch/x86/tlb.hh"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -60,69 +61,46 @@
 namespace X86ISA {
 
 TLB::TLB(const Params *p)
-    : BaseTLB(p), configAddress(0), size(p->size),
-      tlb(size), lruSeq(0)
+    : BaseTLB(p), configAddress(0), tlb(p->size, p->assoc),
+      shared(p->shared_tlb), asid(0), lookupLatency(0)
 {
-    if (!size)
-        fatal("TLBs must have a non-zero size.\n");
-
-    for (int x = 0; x < size; x++) {
-        tlb[x].trieHandle = NULL;
-        freeList.push_back(&tlb[x]);
-    }
+    if (p->l2_size)
+        l2.reset(new EntryStore(p->l2_size, p->l2_assoc));
 
     walker = p->walker;
     walker->setTLB(this);
 }
 
-void
-TLB::evictLRU()
-{
-    // Find the entry with the lowest (and hence least recently updated)
-    // sequence number.
-
-    unsigned lru = 0;
-    for (unsigned i = 1; i < size; i++) {
-        if (tlb[i].lruSeq < tlb[lru].lruSeq)
-            lru = i;
-    }
-
-    assert(tlb[lru].trieHandle);
-    trie.remove(tlb[lru].trieHandle);
-    tlb[lru].trieHandle = NULL;
-    freeList.push_back(&tlb[lru]);
-}
-
 TlbEntry *
 TLB::insert(Addr vpn, const TlbEntry &entry)
 {
-    // If somebody beat us to it, just use that existing entry.
-    TlbEntry *newEntry = trie.lookup(vpn);
-    if (newEntry) {
-        assert(newEntry->vaddr == vpn);
-        return newEntry;
-    }
-
-    if (freeList.empty())
-        evictLRU();
-
-    newEntry = freeList.front();
-    freeList.pop_front();
-
-    *newEntry = entry;
-    newEntry->lruSeq = nextSeq();
-    newEntry->vaddr = vpn;
-    newEntry->trieHandle =
-    trie.insert(vpn, TlbEntryTrie::MaxBits - entry.logBytes, newEntry);
-    return newEntry;
+    if (shared)
+        shared->insert(vpn, entry, asid);
+    if (l2)
+        l2->insert(vpn, entry);
+    return tlb.insert(vpn, entry);
 }
 
 TlbEntry *
 TLB::lookup(Addr va, bool update_lru)
 {
-    TlbEntry *entry = trie.lookup(va);
-    if (entry && update_lru)
-        entry->lruSeq = nextSeq();
+    TlbEntry *entry = tlb.lookup(va, update_lru);
+    if (!entry && l2) {
+        TlbEntry *l2_entry = l2->lookup(va, update_lru);
+        if (l2_entry) {
+            l2Hits++;
+            entry = tlb.insert(l2_entry->vaddr, *l2_entry);
+        }
+    }
+    if (!entry && shared) {
+        TlbEntry *shared_entry = shared->lookup(va, asid);
+        if (shared_entry) {
+            lookupLatency = shared->latency();
+            if (l2)
+                l2->insert(shared_entry->vaddr, *shared_entry);
+            entry = tlb.insert(shared_entry->vaddr, *shared_entry);
+        }
+    }
     return entry;
 }
 
@@ -130,13 +108,12 @@ void
 TLB::flushAll()
 {
     DPRINTF(TLB, "Invalidating all entries.\n");
-    for (unsigned i = 0; i < size; i++) {
-        if (tlb[i].trieHandle) {
-            trie.remove(tlb[i].trieHandle);
-            tlb[i].trieHandle = NULL;
-            freeList.push_back(&tlb[i]);
-        }
-    }
+    tlb.clear();
+    if (l2)
+        l2->clear();
+    if (shared)
+        shared->flushAll();
+    walker->flushWalkCache();
 }
 
 void
@@ -149,24 +126,27 @@ void
 TLB::flushNonGlobal()
 {
     DPRINTF(TLB, "Invalidating all non global entries.\n");
-    for (unsigned i = 0; i < size; i++) {
-        if (tlb[i].trieHandle && !tlb[i].global) {
-            trie.remove(tlb[i].trieHandle);
-            tlb[i].trieHandle = NULL;
-            freeList.push_back(&tlb[i]);
-        }
-    }
+    auto non_global = [](const TlbEntry &entry) { return !entry.global; };
+    tlb.removeIf(non_global);
+    if (l2)
+        l2->removeIf(non_global);
+    if (shared)
+        shared->flushNonGlobal(asid);
+    walker->flushWalkCache();
 }
 
 void
 TLB::demapPage(Addr va, uint64_t asn)
 {
-    TlbEntry *entry = trie.lookup(va);
-    if (entry) {
-        trie.remove(entry->trieHandle);
-        entry->trieHandle = NULL;
-        freeList.push_back(entry);
+    if (TlbEntry *entry = tlb.lookup(va, false))
+        tlb.remove(entry);
+    if (l2) {
+        if (TlbEntry *entry = l2->lookup(va, false))
+            l2->remove(entry);
     }
+    if (shared)
+        shared->demapPage(va, asid);
+    walker->flushWalkCache();
 }
 
 Fault
@@ -330,6 +310,12 @@ TLB::translate(RequestPtr req, ThreadContext *tc, Translation *translation,
         // If paging is enabled, do the translation.
         if (m5Reg.paging) {
             DPRINTF(TLB, "Paging enabled.\n");
+            if (shared) {
+                // Tag shared entries with the page table base, or the
+                // process in SE mode.
+                asid = FullSystem ? tc->readMiscRegNoEffect(MISCREG_CR3) :
+                                    tc->getProcessPtr()->pid();
+            }
             // The vaddr already has the segment base applied.
             TlbEntry *entry = lookup(vaddr);
             if (mode == Read) {
@@ -361,7 +347,7 @@ TLB::translate(RequestPtr req, ThreadContext *tc, Translation *translation,
                         p->pTable->lookup(vaddr);
                     if (!pte && mode != Execute) {
                         // Check if we just need to grow the stack.
-                        if (p->fixupStackFault(vaddr)) {
+                        if (p->fixupFault(vaddr)) {
                             // If we did, lookup the entry for the new page.
                             pte = p->pTable->lookup(vaddr);
                         }
@@ -437,10 +423,23 @@ TLB::translateTiming(RequestPtr req, ThreadContext *tc,
 {
     bool delayedResponse;
     assert(translation);
+    lookupLatency = 0;
     Fault fault =
         TLB::translate(req, tc, translation, mode, delayedResponse, true);
-    if (!delayedResponse)
+    if (delayedResponse)
+        return;
+
+    if (lookupLatency) {
+        // The translation came from the shared level, respond when it
+        // would have.
+        schedule(new EventFunctionWrapper(
+                     [fault, req, tc, translation, mode] {
+                         translation->finish(fault, req, tc, mode);
+                     }, name() + ".sharedResponse", true),
+                 curTick() + lookupLatency);
+    } else {
         translation->finish(fault, req, tc, mode);
+    }
 }
 
 Walker *
@@ -470,21 +469,25 @@ TLB::regStats()
         .name(name() + ".wrMisses")
         .desc("TLB misses on write requests");
 
+    l2Hits
+        .name(name() + ".l2Hits")
+        .desc("TLB misses that hit in the second level");
+
 }
 
 void
 TLB::serialize(CheckpointOut &cp) const
 {
-    // Only store the entries in use.
-    uint32_t _size = size - freeList.size();
+    // Only store the entries in use, from the least recently used one.
+    uint32_t _size = tlb.used();
     SERIALIZE_SCALAR(_size);
-    SERIALIZE_SCALAR(lruSeq);
 
     uint32_t _count = 0;
-    for (uint32_t x = 0; x < size; x++) {
-        if (tlb[x].trieHandle != NULL)
-            tlb[x].serializeSection(cp, csprintf("Entry%d", _count++));
-    }
+    tlb.forEach([&cp, &_count](const TlbEntry &entry) {
+        TlbEntry copy = entry;
+        copy.lruSeq = _count;
+        copy.serializeSection(cp, csprintf("Entry%d", _count++));
+    });
 }
 
 void
@@ -493,20 +496,21 @@ TLB::unserialize(CheckpointIn &cp)
     // Do not allow to restore with a smaller tlb.
     uint32_t _size;
     UNSERIALIZE_SCALAR(_size);
-    if (_size > size) {
+    if (_size > tlb.size()) {
         fatal("TLB size less than the one in checkpoint!");
     }
 
-    UNSERIALIZE_SCALAR(lruSeq);
-
-    for (uint32_t x = 0; x < _size; x++) {
-        TlbEntry *newEntry = freeList.front();
-        freeList.pop_front();
-
-        newEntry->unserializeSection(cp, csprintf("Entry%d", x));
-        newEntry->trieHandle = trie.insert(newEntry->vaddr,
-            TlbEntryTrie::MaxBits - newEntry->logBytes, newEntry);
-    }
+    std::vector<TlbEntry> entries(_size);
+    for (uint32_t x = 0; x < _size; x++)
+        entries[x].unserializeSection(cp, csprintf("Entry%d", x));
+
+    // Insert the entries in LRU order to restore the replacement state.
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const TlbEntry &a, const TlbEntry &b) {
+                         return a.lruSeq < b.lruSeq;
+                     });
+    for (const auto &entry : entries)
+        tlb.insert(entry.vaddr, entry);
 }
 
 BaseMasterPort *
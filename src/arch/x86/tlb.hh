@@ -40,12 +40,13 @@
 #ifndef __ARCH_X86_TLB_HH__
 #define __ARCH_X86_TLB_HH__
 
-#include <list>
+#include <memory>
 #include <vector>
 
+#include "arch/generic/set_assoc_tlb.hh"
 #include "arch/generic/tlb.hh"
 #include "arch/x86/pagetable.hh"
-#include "base/trie.hh"
+#include "arch/x86/shared_tlb.hh"
 #include "mem/request.hh"
 #include "params/X86TLB.hh"
 
@@ -60,7 +61,7 @@ namespace X86ISA
       protected:
         friend class Walker;
 
-        typedef std::list<TlbEntry *> EntryList;
+        typedef GenericISA::SetAssocTLB<TlbEntry> EntryStore;
 
         uint32_t configAddress;
 
@@ -77,8 +78,6 @@ namespace X86ISA
 
       protected:
 
-        EntryList::iterator lookupIt(Addr va, bool update_lru = true);
-
         Walker * walker;
 
       public:
@@ -91,20 +90,24 @@ namespace X86ISA
         void demapPage(Addr va, uint64_t asn) override;
 
       protected:
-        uint32_t size;
-
-        std::vector<TlbEntry> tlb;
+        EntryStore tlb;
 
-        EntryList freeList;
+        /** Second level, if any. */
+        std::unique_ptr<EntryStore> l2;
 
-        TlbEntryTrie trie;
-        uint64_t lruSeq;
+        /** Level shared with other TLBs, if any. */
+        SharedTLB *shared;
+        /** Address space of the last translation, to tag shared entries. */
+        uint64_t asid;
+        /** Extra latency of the current lookup, from the shared level. */
+        Tick lookupLatency;
 
         // Statistics
         Stats::Scalar rdAccesses;
         Stats::Scalar wrAccesses;
         Stats::Scalar rdMisses;
         Stats::Scalar wrMisses;
+        Stats::Scalar l2Hits;
 
         Fault translateInt(RequestPtr req, ThreadContext *tc);
 
@@ -114,14 +117,6 @@ namespace X86ISA
 
       public:
 
-        void evictLRU();
-
-        uint64_t
-        nextSeq()
-        {
-            return ++lruSeq;
-        }
-
         Fault translateAtomic(
             RequestPtr req, ThreadContext *tc, Mode mode) override;
         void translateTiming(
@@ -154,6 +149,7 @@ namespace X86ISA
         // Checkpointing
         void serialize(CheckpointOut &cp) const override;
         void unserialize(CheckpointIn &cp) override;
+        bool parallelCheckpoint() const override { return true; }
 
         /**
          * Get the table walker master port. This is used for
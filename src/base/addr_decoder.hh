@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_ADDR_DECODER_HH__
+#define __BASE_ADDR_DECODER_HH__
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/addr_range_map.hh"
+
+/**
+ * The AddrDecoder is a flattened, read-only copy of an AddrRangeMap
+ * for address decoding on the critical path. Contiguous ranges are
+ * kept in a vector sorted on their start address and are found using
+ * a binary search. All the interleaved ranges that together make up
+ * a contiguous chunk share a single entry in the vector, and the
+ * range within the chunk is found by using the interleaving bits of
+ * the address as an index into a table. A lookup thus never walks
+ * the ranges of a chunk, regardless of the number of stripes.
+ *
+ * The decoder does not track the map it is built from, and has to
+ * be rebuilt whenever the map changes.
+ */
+template <typename V>
+class AddrDecoder
+{
+  public:
+    typedef std::pair<AddrRange, V> Entry;
+
+    AddrDecoder() {}
+
+    explicit AddrDecoder(const AddrRangeMap<V> &map) { build(map); }
+
+    /**
+     * Replace the contents of the decoder with the ranges of a map.
+     *
+     * @param map Map of non-overlapping ranges to decode
+     */
+    void
+    build(const AddrRangeMap<V> &map)
+    {
+        clear();
+        entries.reserve(map.size());
+
+        // the map is sorted on start address, and the ranges of an
+        // interleaved chunk share their start address, so they are
+        // always next to each other
+        for (const auto &e : map) {
+            const AddrRange &r = e.first;
+            if (chunks.empty() || !chunks.back().range.mergesWith(r)) {
+                chunks.push_back(Chunk(r, table.size()));
+                table.resize(table.size() + r.stripes(), -1);
+            }
+            table[chunks.back().index + r.intlvMatchValue()] = entries.size();
+            entries.push_back(e);
+        }
+    }
+
+    /**
+     * Find the range that contains an address.
+     *
+     * @param a Address to decode
+     * @return the matching range and its value, or nullptr if none
+     */
+    const Entry *
+    find(Addr a) const
+    {
+        auto c = std::upper_bound(chunks.begin(), chunks.end(), a,
+                                  [](Addr a, const Chunk &c)
+                                  { return a < c.start; });
+        if (c == chunks.begin())
+            return nullptr;
+
+        --c;
+        if (a > c->end)
+            return nullptr;
+
+        const int i = table[c->index + c->range.intlvSelect(a)];
+        return i < 0 ? nullptr : &entries[i];
+    }
+
+    void
+    clear()
+    {
+        chunks.clear();
+        table.clear();
+        entries.clear();
+    }
+
+    std::size_t size() const { return entries.size(); }
+
+    bool empty() const { return entries.empty(); }
+
+  private:
+    /** A contiguous range, or a chunk of interleaved ranges. */
+    struct Chunk
+    {
+        Chunk(const AddrRange &r, std::size_t index)
+            : start(r.start()), end(r.end()), range(r), index(index)
+        {}
+
+        Addr start;
+        Addr end;
+
+        /** Any range of the chunk, used to extract the interleaving bits. */
+        AddrRange range;
+
+        /** Offset of the first stripe of the chunk in the table. */
+        std::size_t index;
+    };
+
+    /** Chunks sorted on start address. */
+    std::vector<Chunk> chunks;
+
+    /**
+     * Index of the entry for every stripe of each chunk, or -1 for
+     * stripes that are not part of the map.
+     */
+    std::vector<int> table;
+
+    std::vector<Entry> entries;
+};
+
+#endif // __BASE_ADDR_DECODER_HH__
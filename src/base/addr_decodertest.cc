@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "base/addr_decoder.hh"
+
+TEST(AddrDecoderTest, Contiguous)
+{
+    AddrRangeMap<int> map;
+    map.insert(AddrRange(0x0, 0xfff), 0);
+    map.insert(AddrRange(0x2000, 0x2fff), 1);
+    map.insert(AddrRange(0x3000, 0x3fff), 2);
+
+    AddrDecoder<int> decoder(map);
+    EXPECT_EQ(3, decoder.size());
+
+    EXPECT_EQ(0, decoder.find(0x0)->second);
+    EXPECT_EQ(0, decoder.find(0xfff)->second);
+    EXPECT_EQ(nullptr, decoder.find(0x1000));
+    EXPECT_EQ(1, decoder.find(0x2000)->second);
+    EXPECT_EQ(2, decoder.find(0x3fff)->second);
+    EXPECT_EQ(nullptr, decoder.find(0x4000));
+}
+
+TEST(AddrDecoderTest, Interleaved)
+{
+    AddrRangeMap<int> map;
+    map.insert(AddrRange(0x0, 0xff), 8);
+    // four stripes of 64 bytes, interleaved on bits 7:6
+    for (int i = 0; i < 4; ++i)
+        map.insert(AddrRange(0x1000, 0x1fff, 7, 0, 2, i), i);
+
+    AddrDecoder<int> decoder(map);
+    for (Addr a = 0x1000; a < 0x2000; a += 0x40) {
+        const auto *e = decoder.find(a);
+        ASSERT_NE(nullptr, e);
+        EXPECT_EQ(map.find(a)->second, e->second);
+        EXPECT_TRUE(e->first.contains(a));
+    }
+    EXPECT_EQ(8, decoder.find(0x80)->second);
+    EXPECT_EQ(nullptr, decoder.find(0x2000));
+}
+
+TEST(AddrDecoderTest, HashedWithMissingStripe)
+{
+    AddrRangeMap<int> map;
+    // only three of the four stripes are present
+    for (int i = 0; i < 3; ++i)
+        map.insert(AddrRange(0x0, 0xffff, 7, 13, 2, i), i);
+
+    AddrDecoder<int> decoder(map);
+    for (Addr a = 0; a < 0x10000; a += 0x40) {
+        const auto *e = decoder.find(a);
+        const auto m = map.find(a);
+        if (m == map.end()) {
+            EXPECT_EQ(nullptr, e);
+        } else {
+            ASSERT_NE(nullptr, e);
+            EXPECT_EQ(m->second, e->second);
+        }
+    }
+}
+
+TEST(AddrDecoderTest, Rebuild)
+{
+    AddrRangeMap<int> map;
+    map.insert(AddrRange(0x0, 0xfff), 0);
+
+    AddrDecoder<int> decoder(map);
+    map.clear();
+    map.insert(AddrRange(0x1000, 0x1fff), 1);
+    decoder.build(map);
+
+    EXPECT_EQ(nullptr, decoder.find(0x0));
+    EXPECT_EQ(1, decoder.find(0x1000)->second);
+
+    decoder.clear();
+    EXPECT_TRUE(decoder.empty());
+    EXPECT_EQ(nullptr, decoder.find(0x1000));
+}
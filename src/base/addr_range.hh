@@ -334,18 +334,38 @@ class AddrRange
         if (!interleaved()) {
             return in_range;
         } else if (in_range) {
-            if (!hashed()) {
-                return bits(a, intlvHighBit, intlvHighBit - intlvBits + 1) ==
-                    intlvMatch;
-            } else {
-                return (bits(a, intlvHighBit, intlvHighBit - intlvBits + 1) ^
-                        bits(a, xorHighBit, xorHighBit - intlvBits + 1)) ==
-                    intlvMatch;
-            }
+            return intlvSelect(a) == intlvMatch;
         }
         return false;
     }
 
+    /**
+     * Get the value of the interleaving bits of an address, after
+     * XOR hashing if the range is hashed. An address within the
+     * start and end of the range belongs to the range if this value
+     * matches that of the range.
+     *
+     * @param a Address to get the interleaving bits of
+     * @return the (hashed) interleaving bits, 0 if not interleaved
+     */
+    uint64_t intlvSelect(const Addr& a) const
+    {
+        if (!interleaved()) {
+            return 0;
+        } else if (!hashed()) {
+            return bits(a, intlvHighBit, intlvHighBit - intlvBits + 1);
+        } else {
+            return bits(a, intlvHighBit, intlvHighBit - intlvBits + 1) ^
+                bits(a, xorHighBit, xorHighBit - intlvBits + 1);
+        }
+    }
+
+    /**
+     * Get the value the interleaving bits of an address are matched
+     * against.
+     */
+    uint8_t intlvMatchValue() const { return intlvMatch; }
+
     /**
      * Remove the interleaving bits from an input address.
      *
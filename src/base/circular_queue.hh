@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Growable double-ended queue stored in a circular buffer.
+ */
+
+#ifndef __BASE_CIRCULAR_QUEUE_HH__
+#define __BASE_CIRCULAR_QUEUE_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Queue of values that can be pushed at the back and popped at either
+ * end, like a std::deque that is only appended at the back.
+ *
+ * The elements live in a power-of-two sized vector that doubles when
+ * it is full. Pushing and popping never allocate once the queue has
+ * reached its working size, unlike a std::deque which allocates and
+ * frees a chunk every few elements as the queue moves through memory.
+ * Elements are indexed from the oldest (front) to the youngest (back).
+ */
+template <class T>
+class CircularQueue
+{
+  public:
+    explicit CircularQueue(size_t capacity = 64)
+        : _head(0), _size(0)
+    {
+        size_t slots = 1;
+        while (slots < capacity)
+            slots <<= 1;
+        buf.resize(slots);
+        mask = slots - 1;
+    }
+
+    bool empty() const { return _size == 0; }
+    size_t size() const { return _size; }
+    /** Number of slots in the backing store. */
+    size_t capacity() const { return buf.size(); }
+
+    /** The i-th oldest element. */
+    T &
+    operator[](size_t i)
+    {
+        assert(i < _size);
+        return buf[(_head + i) & mask];
+    }
+
+    const T &
+    operator[](size_t i) const
+    {
+        assert(i < _size);
+        return buf[(_head + i) & mask];
+    }
+
+    T &front() { return (*this)[0]; }
+    const T &front() const { return (*this)[0]; }
+    T &back() { return (*this)[_size - 1]; }
+    const T &back() const { return (*this)[_size - 1]; }
+
+    void
+    push_back(const T &elem)
+    {
+        if (_size == buf.size())
+            grow();
+        buf[(_head + _size) & mask] = elem;
+        ++_size;
+    }
+
+    /** Remove the oldest element. */
+    void
+    pop_front()
+    {
+        assert(_size);
+        buf[_head] = T();
+        _head = (_head + 1) & mask;
+        --_size;
+    }
+
+    /** Remove the youngest element. */
+    void
+    pop_back()
+    {
+        assert(_size);
+        --_size;
+        buf[(_head + _size) & mask] = T();
+    }
+
+    void
+    clear()
+    {
+        while (!empty())
+            pop_back();
+        _head = 0;
+    }
+
+  private:
+    void
+    grow()
+    {
+        std::vector<T> new_buf(buf.size() * 2);
+        for (size_t i = 0; i < _size; ++i)
+            new_buf[i] = std::move(buf[(_head + i) & mask]);
+        buf.swap(new_buf);
+        mask = buf.size() - 1;
+        _head = 0;
+    }
+
+    std::vector<T> buf;
+    size_t mask;
+
+    /** Slot of the oldest element. */
+    size_t _head;
+    size_t _size;
+};
+
+#endif // __BASE_CIRCULAR_QUEUE_HH__
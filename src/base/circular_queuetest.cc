@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <deque>
+
+#include "base/circular_queue.hh"
+
+TEST(CircularQueueTest, PopAtBothEnds)
+{
+    CircularQueue<int> queue(4);
+    for (int i = 0; i < 4; ++i)
+        queue.push_back(i);
+    EXPECT_EQ(queue.size(), 4U);
+    EXPECT_EQ(queue.front(), 0);
+    EXPECT_EQ(queue.back(), 3);
+
+    queue.pop_front();
+    queue.pop_back();
+    EXPECT_EQ(queue.size(), 2U);
+    EXPECT_EQ(queue[0], 1);
+    EXPECT_EQ(queue[1], 2);
+
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(CircularQueueTest, MatchesDequeWhileWrappingAndGrowing)
+{
+    CircularQueue<int> queue(4);
+    std::deque<int> ref;
+
+    // Move through the buffer a few times, growing it on the way.
+    for (int i = 0; i < 1000; ++i) {
+        queue.push_back(i);
+        ref.push_back(i);
+        if (i % 3 == 0) {
+            queue.pop_front();
+            ref.pop_front();
+        }
+        if (i % 7 == 0 && !ref.empty()) {
+            queue.pop_back();
+            ref.pop_back();
+        }
+
+        ASSERT_EQ(queue.size(), ref.size());
+        for (size_t j = 0; j < ref.size(); ++j)
+            ASSERT_EQ(queue[j], ref[j]);
+    }
+
+    EXPECT_GE(queue.capacity(), queue.size());
+}
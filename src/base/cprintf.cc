@@ -61,6 +61,35 @@ Print::~Print()
 {
 }
 
+thread_local std::stringstream ScratchStream::cached;
+thread_local bool ScratchStream::cachedInUse = false;
+
+ScratchStream::ScratchStream()
+{
+    if (cachedInUse) {
+        fresh.reset(new std::stringstream);
+        _stream = fresh.get();
+        return;
+    }
+
+    cachedInUse = true;
+    _stream = &cached;
+
+    // Start from a clean slate
+    _stream->str(std::string());
+    _stream->clear();
+    _stream->flags(ios::skipws | ios::dec);
+    _stream->fill(' ');
+    _stream->precision(6);
+    _stream->width(0);
+}
+
+ScratchStream::~ScratchStream()
+{
+    if (_stream == &cached)
+        cachedInUse = false;
+}
+
 void
 Print::process()
 {
@@ -37,6 +37,8 @@
 #include <ios>
 #include <iostream>
 #include <list>
+#include <memory>
+#include <sstream>
 #include <string>
 
 #include "base/cprintf_formats.hh"
@@ -124,6 +126,32 @@ struct Print
     void end_args();
 };
 
+/**
+ * A string stream for csprintf(). Constructing a stream costs more
+ * than most of the formatting done with it, so every thread keeps one
+ * around. Calls made while it is in use, e.g., from the output
+ * operator of an argument, get a fresh one.
+ */
+class ScratchStream
+{
+  private:
+    static thread_local std::stringstream cached;
+    static thread_local bool cachedInUse;
+
+    std::unique_ptr<std::stringstream> fresh;
+    std::stringstream *_stream;
+
+  public:
+    ScratchStream();
+    ~ScratchStream();
+
+    ScratchStream(const ScratchStream &) = delete;
+    ScratchStream &operator=(const ScratchStream &) = delete;
+
+    std::ostream &stream() { return *_stream; }
+    std::string str() const { return _stream->str(); }
+};
+
 } // namespace cp
 
 inline void
@@ -160,8 +188,8 @@ cprintf(const char *format, const Args &...args)
 template<typename ...Args> std::string
 csprintf(const char *format, const Args &...args)
 {
-    std::stringstream stream;
-    ccprintf(stream, format, args...);
+    cp::ScratchStream stream;
+    ccprintf(stream.stream(), format, args...);
     return stream.str();
 }
 
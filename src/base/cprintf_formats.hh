@@ -32,8 +32,11 @@
 #define __BASE_CPRINTF_FORMATS_HH__
 
 #include <cstring>
+#include <limits>
 #include <ostream>
 #include <sstream>
+#include <string>
+#include <type_traits>
 
 namespace cp {
 
@@ -82,12 +85,121 @@ _format_char(std::ostream &out, const T &data, Format &fmt)
     out << data;
 }
 
+/**
+ * Write a formatted value to a stream, padded to a given width.
+ */
+inline void
+_write_padded(std::ostream &out, const char *data, int len, int width,
+              char fill, bool left)
+{
+    int pad = width - len;
+    if (pad <= 0) {
+        out.write(data, len);
+        return;
+    }
+
+    if (left)
+        out.write(data, len);
+    for (; pad > 0; --pad)
+        out.put(fill);
+    if (!left)
+        out.write(data, len);
+}
+
+/**
+ * Format a built-in integer into a buffer instead of going through
+ * the stream's formatting flags. This matches what _format_integer()
+ * does for everything but explicit signs, which are left to the
+ * stream.
+ */
+template <typename T>
+inline bool
+_format_integer_fast(std::ostream &out, const T &data, Format &fmt,
+                     std::true_type)
+{
+    typedef typename std::make_unsigned<T>::type U;
+
+    if (fmt.print_sign)
+        return false;
+
+    // Digits of the largest value in octal, a prefix and a sign
+    char buf[std::numeric_limits<U>::digits / 3 + 4];
+    char *const end = buf + sizeof(buf);
+    char *p = end;
+
+    const bool negative = fmt.base == Format::dec && data < 0;
+    U value = negative ? U(0) - U(data) : U(data);
+    const bool zero = value == 0;
+
+    const char *digits = fmt.uppercase ?
+        "0123456789ABCDEF" : "0123456789abcdef";
+    const unsigned shift = fmt.base == Format::hex ? 4 : 3;
+    switch (fmt.base) {
+      case Format::dec:
+        do {
+            *--p = '0' + value % 10;
+            value /= 10;
+        } while (value);
+        break;
+      case Format::hex:
+      case Format::oct:
+        do {
+            *--p = digits[value & ((1 << shift) - 1)];
+            value >>= shift;
+        } while (value);
+        break;
+    }
+
+    if (fmt.alternate_form) {
+        // The prefix is only upper case if the stream adds it
+        const char *prefix = "";
+        if (fmt.base == Format::hex)
+            prefix = fmt.uppercase && !fmt.fill_zero ? "0X" : "0x";
+        else if (fmt.base == Format::oct)
+            prefix = "0";
+
+        if (fmt.fill_zero) {
+            // The prefix goes before the zero padding
+            int len = strlen(prefix);
+            out.write(prefix, len);
+            fmt.width -= len;
+        } else if (!zero) {
+            // The stream doesn't decorate zero with a base
+            for (int i = strlen(prefix) - 1; i >= 0; --i)
+                *--p = prefix[i];
+        }
+    }
+
+    if (negative)
+        *--p = '-';
+
+    // Padding goes in front of any sign and prefix, like the stream
+    // does it
+    _write_padded(out, p, end - p, fmt.width, fmt.fill_zero ? '0' : ' ',
+                  fmt.flush_left && !fmt.fill_zero);
+    return true;
+}
+
+template <typename T>
+inline bool
+_format_integer_fast(std::ostream &out, const T &data, Format &fmt,
+                     std::false_type)
+{
+    return false;
+}
+
 template <typename T>
 inline void
 _format_integer(std::ostream &out, const T &data, Format &fmt)
 {
     using namespace std;
 
+    if (_format_integer_fast(out, data, fmt,
+                             integral_constant<bool,
+                                 is_integral<T>::value &&
+                                 !is_same<T, bool>::value>()))
+        return;
+
     ios::fmtflags flags(out.flags());
 
     switch (fmt.base) {
@@ -337,6 +449,26 @@ inline void
 format_string(std::ostream &out, const T &data, Format &fmt)
 { _format_string(out, data, fmt); }
 
+inline void
+format_string(std::ostream &out, const std::string &data, Format &fmt)
+{ _write_padded(out, data.data(), data.size(), fmt.width, ' ',
+                fmt.flush_left); }
+
+inline void
+format_string(std::ostream &out, const char *data, Format &fmt)
+{
+    // Let the stream deal with null strings
+    if (data)
+        _write_padded(out, data, strlen(data), fmt.width, ' ',
+                      fmt.flush_left);
+    else
+        _format_string(out, data, fmt);
+}
+
+inline void
+format_string(std::ostream &out, char *data, Format &fmt)
+{ format_string(out, (const char *)data, fmt); }
+
 } // namespace cp
 
 #endif // __CPRINTF_FORMATS_HH__
@@ -180,3 +180,27 @@ TEST(CPrintf, SpecialFormatting)
     CPRINTF_TEST("%07.*f\n", 4, 1.234);
     CPRINTF_TEST("%#0*x\n", 9, 123412);
 }
+
+TEST(CPrintf, Integers)
+{
+    CPRINTF_TEST("%d %d %u %x %X %o\n", 0, -42, 42u, 0xbeef, 0xbeef, 8);
+    CPRINTF_TEST("%5d|%-5d|%05d\n", 42, 42, 42);
+    CPRINTF_TEST("%#x %#o %#08x %#6x\n", 0xbeef, 8, 0xbeef, 0xbeef);
+    CPRINTF_TEST("%#x %#o\n", 0, 0);
+    CPRINTF_TEST("%llx %lld\n", 0xffffffffffffffffULL, -1LL);
+}
+
+struct Nested {};
+
+std::ostream &
+operator<<(std::ostream &os, const Nested &n)
+{
+    return os << csprintf("<%d>", 1);
+}
+
+TEST(CPrintf, NestedCsprintf)
+{
+    EXPECT_EQ(csprintf("%s %s %d", Nested(), csprintf("%x", 255), 2),
+              "<1> ff 2");
+    EXPECT_EQ(csprintf("%5s|%-5s|", Nested(), "ab"), "  <1>|ab   |");
+}
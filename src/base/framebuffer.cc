@@ -41,19 +41,25 @@
 
 #include <zlib.h>
 
+#include <algorithm>
+
 #include "base/bitfield.hh"
+#include "base/intmath.hh"
+
+const unsigned FrameBuffer::TileSize;
 
 const FrameBuffer FrameBuffer::dummy(320, 240);
 
 FrameBuffer::FrameBuffer(unsigned width, unsigned height)
     : pixels(width * height),
-      _width(width), _height(height)
+      _width(width), _height(height), _version(0), tilesX(0)
 {
+    resizeTiles();
     clear();
 }
 
 FrameBuffer::FrameBuffer()
-    : _width(0), _height(0)
+    : _width(0), _height(0), _version(0), tilesX(0)
 {
 }
 
@@ -76,6 +82,9 @@ FrameBuffer::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(_width);
     UNSERIALIZE_SCALAR(_height);
     UNSERIALIZE_CONTAINER(pixels);
+
+    resizeTiles();
+    markAllDirty();
 }
 
 void
@@ -85,6 +94,15 @@ FrameBuffer::resize(unsigned width, unsigned height)
     _height = height;
 
     pixels.resize(width * height);
+    resizeTiles();
+    markAllDirty();
+}
+
+void
+FrameBuffer::resizeTiles()
+{
+    tilesX = divCeil(_width, TileSize);
+    tileVersions.assign(tilesX * divCeil(_height, TileSize), _version);
 }
 
 void
@@ -92,6 +110,8 @@ FrameBuffer::fill(const Pixel &pixel)
 {
     for (auto &p : pixels)
         p = pixel;
+
+    markAllDirty();
 }
 
 void
@@ -105,9 +125,11 @@ FrameBuffer::clear()
 void
 FrameBuffer::copyIn(const uint8_t *fb, const PixelConverter &conv)
 {
-    for (auto &p : pixels) {
-        p = conv.toPixel(fb);
-        fb += conv.length;
+    for (unsigned y = 0; y < _height; ++y) {
+        for (unsigned x = 0; x < _width; ++x) {
+            setPixel(x, y, conv.toPixel(fb));
+            fb += conv.length;
+        }
     }
 }
 
@@ -127,3 +149,42 @@ FrameBuffer::getHash() const
                    reinterpret_cast<const Bytef *>(pixels.data()),
                    area() * sizeof(Pixel));
 }
+
+void
+FrameBuffer::markAllDirty()
+{
+    ++_version;
+    for (auto &v : tileVersions)
+        v = _version;
+}
+
+std::vector<FrameBuffer::Rect>
+FrameBuffer::dirtyRects(uint64_t since) const
+{
+    std::vector<Rect> rects;
+    if (!changedSince(since))
+        return rects;
+
+    const unsigned tiles_y = tilesX ? tileVersions.size() / tilesX : 0;
+    for (unsigned ty = 0; ty < tiles_y; ++ty) {
+        const uint64_t *row = tileVersions.data() + ty * tilesX;
+        for (unsigned tx = 0; tx < tilesX; ++tx) {
+            if (row[tx] <= since)
+                continue;
+
+            unsigned end = tx + 1;
+            while (end < tilesX && row[end] > since)
+                ++end;
+
+            const unsigned x = tx * TileSize;
+            const unsigned y = ty * TileSize;
+            rects.push_back(Rect{
+                x, y,
+                std::min(end * TileSize, _width) - x,
+                std::min(y + TileSize, _height) - y });
+            tx = end;
+        }
+    }
+
+    return rects;
+}
@@ -63,6 +63,14 @@
  * image. That is, the pixel at position (0, 0) is the upper left
  * corner. The backing store is a linear vector of Pixels ordered left
  * to right starting in the upper left corner.
+ *
+ * The frame buffer keeps track of which parts of the image have
+ * changed. It is divided into tiles of TileSize x TileSize pixels,
+ * and each tile records the version of the frame buffer when it was
+ * last changed. Every change bumps the version. A consumer, such as a
+ * VNC server, remembers the version it last saw and asks for the
+ * regions that changed since then. This lets several consumers track
+ * changes independently without modifying the frame buffer.
  */
 class FrameBuffer : public Serializable
 {
@@ -166,6 +174,9 @@ class FrameBuffer : public Serializable
     /**
      * Get a pixel from an (x, y) coordinate
      *
+     * Changes made through the returned reference aren't tracked,
+     * callers need to call markDirty() themselves.
+     *
      * @param x Distance from the left margin.
      * @param y Distance from the top of the frame.
      */
@@ -176,6 +187,59 @@ class FrameBuffer : public Serializable
         return pixels[y * _width + x];
     }
 
+    /**
+     * Store a pixel at an (x, y) coordinate, and mark it as changed
+     * if it has a different value.
+     *
+     * @param x Distance from the left margin.
+     * @param y Distance from the top of the frame.
+     * @param p New pixel value.
+     */
+    void setPixel(unsigned x, unsigned y, const Pixel &p) {
+        Pixel &dst(pixel(x, y));
+        if (!(dst == p)) {
+            dst = p;
+            markDirty(x, y);
+        }
+    }
+
+    /** A rectangular region of the frame buffer */
+    struct Rect {
+        unsigned x;
+        unsigned y;
+        unsigned width;
+        unsigned height;
+    };
+
+    /** Width and height of a damage tracking tile in pixels */
+    static const unsigned TileSize = 16;
+
+    /** Current version of the frame buffer contents */
+    uint64_t version() const { return _version; }
+
+    /** Has anything changed since a given version? */
+    bool changedSince(uint64_t since) const { return _version > since; }
+
+    /** Mark the pixel at an (x, y) coordinate as changed. */
+    void markDirty(unsigned x, unsigned y) {
+        tileVersions[(y / TileSize) * tilesX + x / TileSize] = ++_version;
+    }
+
+    /** Mark the whole frame buffer as changed. */
+    void markAllDirty();
+
+    /**
+     * Get the regions that changed since a given version.
+     *
+     * Changed tiles are merged into horizontal runs, so the number of
+     * regions is at most the number of tile rows times half the number
+     * of tile columns. Regions are clipped to the frame buffer.
+     *
+     * @param since Version the caller last saw.
+     * @return List of changed regions, empty if nothing changed.
+     */
+    std::vector<Rect> dirtyRects(uint64_t since) const;
+
     /**
      * Create a hash of the image that can be used for quick
      * comparisons.
@@ -194,10 +258,20 @@ class FrameBuffer : public Serializable
     std::vector<Pixel> pixels;
 
   protected:
+    /** Resize the tile versions to match the frame buffer size */
+    void resizeTiles();
+
     /** Width in pixels */
     unsigned _width;
     /** Height in pixels */
     unsigned _height;
+
+    /** Version of the contents, bumped on every change */
+    uint64_t _version;
+    /** Number of tile columns */
+    unsigned tilesX;
+    /** Version of the last change to each tile, row by row */
+    std::vector<uint64_t> tileVersions;
 };
 
 #endif // __BASE_FRAMEBUFFER_HH__
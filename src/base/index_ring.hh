@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Growable circular buffer with stable indices and holes.
+ */
+
+#ifndef __BASE_INDEX_RING_HH__
+#define __BASE_INDEX_RING_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Sequence of nullable elements (e.g., pointers) stored in a circular
+ * buffer.
+ *
+ * Elements are appended at the back and identified by an index that
+ * stays valid until the element is erased, like a std::list iterator.
+ * Elements can also be appended at a given index, leaving holes in
+ * between. Elements can be erased anywhere. An erased element leaves
+ * a hole that is skipped by prev() and next(), and that is reclaimed
+ * as soon as it reaches either end of the sequence, after which its
+ * index may be handed out again. The buffer doubles in size when it is full,
+ * which keeps all indices valid.
+ *
+ * This replaces a std::list in structures such as the list of
+ * in-flight instructions of a CPU, which are mostly appended at the
+ * back and erased at either end, without allocating a node per
+ * element.
+ */
+template <class T>
+class IndexRing
+{
+  public:
+    typedef uint64_t Index;
+
+    explicit IndexRing(size_t capacity = 64)
+        : _head(0), _tail(0), _size(0)
+    {
+        size_t slots = 1;
+        while (slots < capacity)
+            slots <<= 1;
+        buf.resize(slots);
+        mask = slots - 1;
+    }
+
+    /** Is the sequence empty? */
+    bool empty() const { return _size == 0; }
+    /** Number of elements, not counting holes. */
+    size_t size() const { return _size; }
+    /** Number of slots in the backing store. */
+    size_t capacity() const { return buf.size(); }
+
+    /**
+     * @{
+     * Index of the oldest slot, and of the slot after the youngest
+     * one. Neither of them is a hole if the sequence is not empty.
+     */
+    Index begin() const { return _head; }
+    Index end() const { return _tail; }
+    /** @} */
+
+    /** Does idx refer to an element that hasn't been erased? */
+    bool
+    valid(Index idx) const
+    {
+        return idx >= _head && idx < _tail && buf[idx & mask];
+    }
+
+    T &
+    operator[](Index idx)
+    {
+        assert(valid(idx));
+        return buf[idx & mask];
+    }
+
+    const T &
+    operator[](Index idx) const
+    {
+        assert(valid(idx));
+        return buf[idx & mask];
+    }
+
+    T &front() { return (*this)[_head]; }
+    T &back() { return (*this)[_tail - 1]; }
+
+    /** Index of the next element after idx, or end() if there is none. */
+    Index
+    next(Index idx) const
+    {
+        do {
+            ++idx;
+        } while (idx < _tail && !buf[idx & mask]);
+        return idx;
+    }
+
+    /**
+     * Index of the previous element before idx, or end() if there is
+     * none.
+     */
+    Index
+    prev(Index idx) const
+    {
+        while (idx > _head) {
+            --idx;
+            if (buf[idx & mask])
+                return idx;
+        }
+        return _tail;
+    }
+
+    /** Append an element, which must not be null. Returns its index. */
+    Index
+    push_back(const T &elem)
+    {
+        assert(elem);
+        if (_tail - _head == buf.size())
+            grow();
+        buf[_tail & mask] = elem;
+        ++_size;
+        return _tail++;
+    }
+
+    /**
+     * Append an element, which must not be null, at a given index at
+     * or after end(), or anywhere if the sequence is empty. The
+     * indices in between become holes. This makes it possible to
+     * index the sequence by an external, increasing number that may
+     * have gaps, such as an instruction sequence number. The buffer
+     * grows until it covers the range from begin() to idx.
+     */
+    void
+    push_at(Index idx, const T &elem)
+    {
+        assert(elem);
+        if (empty())
+            _head = _tail = idx;
+        assert(idx >= _tail);
+        while (idx - _head >= buf.size())
+            grow();
+        buf[idx & mask] = elem;
+        ++_size;
+        _tail = idx + 1;
+    }
+
+    /**
+     * Erase the element at idx. Erasing an element again does nothing
+     * as long as no element has been appended in the meantime.
+     */
+    void
+    erase(Index idx)
+    {
+        if (!valid(idx))
+            return;
+
+        buf[idx & mask] = T();
+        --_size;
+
+        while (_head < _tail && !buf[_head & mask])
+            ++_head;
+        while (_tail > _head && !buf[(_tail - 1) & mask])
+            --_tail;
+    }
+
+    /** Erase all elements. */
+    void
+    clear()
+    {
+        for (Index idx = _head; idx < _tail; ++idx)
+            buf[idx & mask] = T();
+        _head = _tail;
+        _size = 0;
+    }
+
+  private:
+    void
+    grow()
+    {
+        std::vector<T> new_buf(buf.size() * 2);
+        const Index new_mask = new_buf.size() - 1;
+        for (Index idx = _head; idx < _tail; ++idx)
+            new_buf[idx & new_mask] = std::move(buf[idx & mask]);
+        buf.swap(new_buf);
+        mask = new_mask;
+    }
+
+    std::vector<T> buf;
+    Index mask;
+
+    Index _head;
+    Index _tail;
+    size_t _size;
+};
+
+#endif // __BASE_INDEX_RING_HH__
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "base/index_ring.hh"
+
+namespace {
+
+typedef IndexRing<int *> TestRing;
+
+std::vector<int *>
+contents(const TestRing &ring)
+{
+    std::vector<int *> elems;
+    for (auto idx = ring.begin(); idx != ring.end(); idx = ring.next(idx))
+        elems.push_back(ring[idx]);
+    return elems;
+}
+
+} // anonymous namespace
+
+TEST(IndexRingTest, EraseAtEnds)
+{
+    int v[3];
+    TestRing ring(4);
+    auto a = ring.push_back(&v[0]);
+    auto b = ring.push_back(&v[1]);
+    auto c = ring.push_back(&v[2]);
+    EXPECT_EQ(ring.size(), 3U);
+
+    ring.erase(a);
+    EXPECT_EQ(ring.begin(), b);
+    ring.erase(c);
+    EXPECT_EQ(ring.end(), c);
+    EXPECT_EQ(ring.front(), &v[1]);
+    EXPECT_EQ(ring.back(), &v[1]);
+
+    ring.erase(b);
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.begin(), ring.end());
+}
+
+TEST(IndexRingTest, HolesAreSkipped)
+{
+    int v[4];
+    TestRing ring(4);
+    std::vector<TestRing::Index> idx;
+    for (int i = 0; i < 4; ++i)
+        idx.push_back(ring.push_back(&v[i]));
+
+    ring.erase(idx[1]);
+    ring.erase(idx[2]);
+    EXPECT_FALSE(ring.valid(idx[1]));
+    EXPECT_EQ(contents(ring), std::vector<int *>({&v[0], &v[3]}));
+    EXPECT_EQ(ring.prev(idx[3]), idx[0]);
+    EXPECT_EQ(ring.prev(idx[0]), ring.end());
+
+    // Erasing twice is harmless, and the holes go with the front.
+    ring.erase(idx[1]);
+    ring.erase(idx[0]);
+    EXPECT_EQ(ring.size(), 1U);
+    EXPECT_EQ(ring.begin(), idx[3]);
+}
+
+TEST(IndexRingTest, IndicesSurviveGrowth)
+{
+    std::vector<int> v(100);
+    TestRing ring(4);
+    std::vector<TestRing::Index> idx;
+
+    // Keep a hole near the front while the ring wraps around and grows.
+    for (size_t i = 0; i < 3; ++i)
+        idx.push_back(ring.push_back(&v[i]));
+    ring.erase(idx[0]);
+    ring.erase(idx[2]);
+    idx[2] = ring.push_back(&v[2]);
+    for (size_t i = 3; i < v.size(); ++i)
+        idx.push_back(ring.push_back(&v[i]));
+
+    EXPECT_GE(ring.capacity(), 101U);
+    EXPECT_EQ(ring.size(), 99U);
+    EXPECT_EQ(ring.begin(), idx[1]);
+    for (size_t i = 1; i < v.size(); ++i)
+        EXPECT_EQ(ring[idx[i]], &v[i]);
+
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_FALSE(ring.valid(idx[50]));
+}
+
+TEST(IndexRingTest, PushAtIndex)
+{
+    int v[3];
+    TestRing ring(4);
+
+    // The first element sets the start of the sequence.
+    ring.push_at(1000, &v[0]);
+    EXPECT_EQ(ring.begin(), 1000U);
+    EXPECT_EQ(ring.end(), 1001U);
+
+    // Gaps become holes, and the ring grows to cover them.
+    ring.push_at(1003, &v[1]);
+    ring.push_at(1010, &v[2]);
+    EXPECT_EQ(ring.size(), 3U);
+    EXPECT_GE(ring.capacity(), 11U);
+    EXPECT_FALSE(ring.valid(1005));
+    EXPECT_EQ(ring[1003], &v[1]);
+    EXPECT_EQ(ring.next(1003), 1010U);
+    EXPECT_EQ(contents(ring), std::vector<int *>({&v[0], &v[1], &v[2]}));
+
+    ring.erase(1000);
+    EXPECT_EQ(ring.begin(), 1003U);
+    ring.erase(1010);
+    ring.erase(1003);
+    EXPECT_TRUE(ring.empty());
+
+    // An empty ring restarts wherever the next element is.
+    ring.push_at(5000, &v[0]);
+    EXPECT_EQ(ring.begin(), 5000U);
+    EXPECT_EQ(ring.front(), &v[0]);
+}
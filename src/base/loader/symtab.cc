@@ -30,7 +30,9 @@
 
 #include "base/loader/symtab.hh"
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -47,26 +49,51 @@ SymbolTable *debugSymbolTable = NULL;
 void
 SymbolTable::clear()
 {
-    addrTable.clear();
-    symbolTable.clear();
+    pool.clear();
+    symbols.clear();
+    sortedCount = 0;
+    nameIndex.clear();
 }
 
 bool
-SymbolTable::insert(Addr address, string symbol)
+SymbolTable::insert(Addr address, const string &symbol)
 {
     if (symbol.empty())
         return false;
 
-    if (!symbolTable.insert(make_pair(symbol, address)).second)
+    Addr existing;
+    if (findAddress(symbol, existing))
         return false;
 
     // There can be multiple symbols for the same address, so always
-    // update the addrTable multimap when we see a new symbol name.
-    addrTable.insert(make_pair(address, symbol));
+    // add a new entry when we see a new symbol name.
+    Symbol sym = { address, pool.size() };
+    pool.append(symbol.c_str(), symbol.size() + 1);
+    symbols.push_back(sym);
+    nameIndex.emplace(hash<string>()(symbol), sym);
 
     return true;
 }
 
+void
+SymbolTable::sort() const
+{
+    if (sortedCount == symbols.size())
+        return;
+
+    auto by_addr = [](const Symbol &a, const Symbol &b) {
+        return a.address < b.address;
+    };
+
+    // Symbols are mostly inserted in bulk before the first lookup, so
+    // only the new ones need sorting before merging them in. Both
+    // steps are stable to keep the insertion order of aliases.
+    auto middle = symbols.begin() + sortedCount;
+    stable_sort(middle, symbols.end(), by_addr);
+    inplace_merge(symbols.begin(), middle, symbols.end(), by_addr);
+    sortedCount = symbols.size();
+}
+
 
 bool
 SymbolTable::load(const string &filename)
@@ -112,14 +139,11 @@ SymbolTable::load(const string &filename)
 void
 SymbolTable::serialize(const string &base, CheckpointOut &cp) const
 {
-    paramOut(cp, base + ".size", addrTable.size());
-
-    int i = 0;
-    ATable::const_iterator p, end = addrTable.end();
-    for (p = addrTable.begin(); p != end; ++p) {
-        paramOut(cp, csprintf("%s.addr_%d", base, i), p->first);
-        paramOut(cp, csprintf("%s.symbol_%d", base, i), p->second);
-        ++i;
+    paramOut(cp, base + ".size", size());
+
+    for (size_t i = 0; i < size(); ++i) {
+        paramOut(cp, csprintf("%s.addr_%d", base, i), address(i));
+        paramOut(cp, csprintf("%s.symbol_%d", base, i), string(name(i)));
     }
 }
 
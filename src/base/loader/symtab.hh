@@ -32,48 +32,111 @@
 #ifndef __SYMTAB_HH__
 #define __SYMTAB_HH__
 
+#include <algorithm>
+#include <cstring>
 #include <iosfwd>
-#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/types.hh"
 #include "sim/serialize.hh"
 
+/**
+ * A table of symbols that can be searched by name or by address.
+ *
+ * Kernels have hundreds of thousands of symbols, so the names are kept
+ * in a single string pool and the symbols in a flat array that is
+ * sorted by address the first time it is searched after an
+ * insertion. Lookups are therefore not thread safe.
+ */
 class SymbolTable
 {
-  public:
-    typedef std::multimap<Addr, std::string> ATable;
-    typedef std::map<std::string, Addr> STable;
-
   private:
-    ATable addrTable;
-    STable symbolTable;
+    struct Symbol
+    {
+        Addr address;
+        /** Offset of the name in the string pool */
+        size_t name;
+    };
+
+    /** NUL separated names of all symbols */
+    std::string pool;
+
+    /**
+     * All symbols. The first sortedCount entries are sorted by
+     * address, and symbols with the same address are kept in
+     * insertion order.
+     */
+    mutable std::vector<Symbol> symbols;
+    mutable size_t sortedCount;
+
+    /** Symbols indexed by the hash of their name */
+    std::unordered_multimap<size_t, Symbol> nameIndex;
+
+    const char *poolName(const Symbol &sym) const
+    {
+        return pool.c_str() + sym.name;
+    }
 
-  private:
+    /** Sort the symbols inserted since the last lookup by address. */
+    void sort() const;
+
+    /**
+     * Find the first symbol with an address *larger* than addr.
+     * @return false if there is no symbol at or below addr.
+     */
     bool
-    upperBound(Addr addr, ATable::const_iterator &iter) const
+    upperBound(Addr addr, size_t &idx) const
     {
-        // find first key *larger* than desired address
-        iter = addrTable.upper_bound(addr);
+        sort();
+        auto i = std::upper_bound(symbols.begin(), symbols.end(), addr,
+                                  [](Addr a, const Symbol &sym) {
+                                      return a < sym.address;
+                                  });
 
         // if very first key is larger, we're out of luck
-        if (iter == addrTable.begin())
+        if (i == symbols.begin())
             return false;
 
+        idx = i - symbols.begin();
         return true;
     }
 
+    /** Address of the idx-th symbol, or MaxAddr past the end. */
+    Addr
+    nextAddress(size_t idx) const
+    {
+        return idx < symbols.size() ? symbols[idx].address : MaxAddr;
+    }
+
   public:
-    SymbolTable() {}
-    SymbolTable(const std::string &file) { load(file); }
+    SymbolTable() : sortedCount(0) {}
+    SymbolTable(const std::string &file) : sortedCount(0) { load(file); }
     ~SymbolTable() {}
 
     void clear();
-    bool insert(Addr address, std::string symbol);
+    bool insert(Addr address, const std::string &symbol);
     bool load(const std::string &file);
 
-    const ATable &getAddrTable() const { return addrTable; }
-    const STable &getSymbolTable() const { return symbolTable; }
+    /** Number of symbols in the table. */
+    size_t size() const { return symbols.size(); }
+
+    /** Address of the idx-th symbol in address order. */
+    Addr
+    address(size_t idx) const
+    {
+        sort();
+        return symbols[idx].address;
+    }
+
+    /** Name of the idx-th symbol in address order. */
+    const char *
+    name(size_t idx) const
+    {
+        sort();
+        return poolName(symbols[idx]);
+    }
 
   public:
     void serialize(const std::string &base, CheckpointOut &cp) const;
@@ -83,25 +146,32 @@ class SymbolTable
     bool
     findSymbol(Addr address, std::string &symbol) const
     {
-        ATable::const_iterator i = addrTable.find(address);
-        if (i == addrTable.end())
+        sort();
+        auto i = std::lower_bound(symbols.begin(), symbols.end(), address,
+                                  [](const Symbol &sym, Addr a) {
+                                      return sym.address < a;
+                                  });
+        if (i == symbols.end() || i->address != address)
             return false;
 
         // There are potentially multiple symbols that map to the same
         // address. For simplicity, just return the first one.
-        symbol = (*i).second;
+        symbol = poolName(*i);
         return true;
     }
 
     bool
     findAddress(const std::string &symbol, Addr &address) const
     {
-        STable::const_iterator i = symbolTable.find(symbol);
-        if (i == symbolTable.end())
-            return false;
-
-        address = (*i).second;
-        return true;
+        auto range = nameIndex.equal_range(std::hash<std::string>()(symbol));
+        for (auto i = range.first; i != range.second; ++i) {
+            if (std::strcmp(poolName(i->second), symbol.c_str()) == 0) {
+                address = i->second.address;
+                return true;
+            }
+        }
+
+        return false;
     }
 
     /// Find the nearest symbol equal to or less than the supplied
@@ -116,14 +186,13 @@ class SymbolTable
     findNearestSymbol(Addr addr, std::string &symbol, Addr &symaddr,
                       Addr &nextaddr) const
     {
-        ATable::const_iterator i;
+        size_t i;
         if (!upperBound(addr, i))
             return false;
 
-        nextaddr = i->first;
-        --i;
-        symaddr = i->first;
-        symbol = i->second;
+        nextaddr = nextAddress(i);
+        symaddr = symbols[i - 1].address;
+        symbol = poolName(symbols[i - 1]);
         return true;
     }
 
@@ -132,13 +201,12 @@ class SymbolTable
     bool
     findNearestSymbol(Addr addr, std::string &symbol, Addr &symaddr) const
     {
-        ATable::const_iterator i;
+        size_t i;
         if (!upperBound(addr, i))
             return false;
 
-        --i;
-        symaddr = i->first;
-        symbol = i->second;
+        symaddr = symbols[i - 1].address;
+        symbol = poolName(symbols[i - 1]);
         return true;
     }
 
@@ -146,25 +214,23 @@ class SymbolTable
     bool
     findNearestAddr(Addr addr, Addr &symaddr, Addr &nextaddr) const
     {
-        ATable::const_iterator i;
+        size_t i;
         if (!upperBound(addr, i))
             return false;
 
-        nextaddr = i->first;
-        --i;
-        symaddr = i->first;
+        nextaddr = nextAddress(i);
+        symaddr = symbols[i - 1].address;
         return true;
     }
 
     bool
     findNearestAddr(Addr addr, Addr &symaddr) const
     {
-        ATable::const_iterator i;
+        size_t i;
         if (!upperBound(addr, i))
             return false;
 
-        --i;
-        symaddr = i->first;
+        symaddr = symbols[i - 1].address;
         return true;
     }
 };
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Free-list based allocator for small, frequently allocated objects.
+ */
+
+#ifndef __BASE_POOL_ALLOC_HH__
+#define __BASE_POOL_ALLOC_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "config/use_pool_alloc.hh"
+
+/**
+ * Size-class allocator with thread-local free lists.
+ *
+ * Requests are rounded up to a multiple of Granularity bytes and
+ * served from a free list for that size. Memory is never returned to
+ * the system; freed blocks go back on the free list of the thread
+ * that releases them, so no locking is needed on the common path even
+ * if objects are allocated and freed on different threads.
+ *
+ * To keep a thread that only frees blocks (e.g., the consumer of
+ * packets or messages sent from another thread) from hoarding them,
+ * a thread-local free list holds at most two slabs worth of blocks.
+ * The excess, and the whole list when the thread exits, is moved to
+ * a shared depot under a lock. An empty free list is refilled from
+ * the depot, and only if the depot is empty as well by carving up a
+ * freshly allocated slab. Requests larger than MaxSize bytes bypass
+ * the pool.
+ *
+ * Each Tag type gets its own set of free lists, which allows
+ * different object types (e.g., events and packets) to use separate
+ * pools. Allocation counters are kept per thread and summed on demand
+ * to report pool statistics. Pooling can be disabled at build time
+ * (USE_POOL_ALLOC=False) to make heap checkers such as valgrind
+ * useful again.
+ */
+template <class Tag, size_t MaxSize = 512, size_t Granularity = 16>
+class PoolAllocator
+{
+  public:
+    static void *
+    allocate(size_t size)
+    {
+        if (!USE_POOL_ALLOC || size > MaxSize || size == 0)
+            return ::operator new(size);
+
+        const size_t size_class = sizeClass(size);
+        ThreadCache &cache = threadCache;
+        if (!cache.lists[size_class])
+            refill(cache, size_class);
+
+        Block *block = cache.lists[size_class];
+        cache.lists[size_class] = block->next;
+        --cache.counts[size_class];
+        ++localCounters().allocs;
+        return block;
+    }
+
+    static void
+    deallocate(void *p, size_t size)
+    {
+        if (!p)
+            return;
+
+        if (!USE_POOL_ALLOC || size > MaxSize || size == 0) {
+            ::operator delete(p);
+            return;
+        }
+
+        const size_t size_class = sizeClass(size);
+        ThreadCache &cache = threadCache;
+        Block *block = static_cast<Block *>(p);
+        block->next = cache.lists[size_class];
+        cache.lists[size_class] = block;
+        ++localCounters().frees;
+
+        if (++cache.counts[size_class] >= 2 * slabBlocks(size_class))
+            release(cache, size_class);
+    }
+
+    /** Number of pooled blocks in use, over all threads. */
+    static int64_t
+    inUse()
+    {
+        return (int64_t)sum(&Counters::allocs) -
+            (int64_t)sum(&Counters::frees);
+    }
+
+    /** Number of slabs allocated by the calling thread. */
+    static uint64_t slabs() { return localCounters().misses; }
+
+    /**
+     * @{
+     * Number of pooled allocations, and the number of those that
+     * needed a new slab, summed over all threads.
+     */
+    static uint64_t totalAllocs() { return sum(&Counters::allocs); }
+    static uint64_t totalMisses() { return sum(&Counters::misses); }
+    /** @} */
+
+    /** Fraction of pooled allocations served without a new slab. */
+    static double
+    hitRate()
+    {
+        const uint64_t allocs = totalAllocs();
+        return allocs ? 1.0 - (double)totalMisses() / allocs : 0.0;
+    }
+
+  private:
+    struct Block
+    {
+        Block *next;
+    };
+
+    /**
+     * Allocation counters of a single thread. They are allocated on
+     * the heap and never freed, so that the counts of threads that
+     * have exited are still included in the totals.
+     */
+    struct Counters
+    {
+        uint64_t allocs;
+        uint64_t frees;
+        uint64_t misses;
+    };
+
+    static const size_t NumClasses = MaxSize / Granularity;
+
+    /**
+     * Free lists of a thread, and their lengths. The lists are handed
+     * over to the depot when the thread exits.
+     */
+    struct ThreadCache
+    {
+        Block *lists[NumClasses];
+        size_t counts[NumClasses];
+
+        ~ThreadCache()
+        {
+            for (size_t c = 0; c < NumClasses; ++c) {
+                if (lists[c])
+                    depotPush(c, lists[c], counts[c]);
+                lists[c] = nullptr;
+                counts[c] = 0;
+            }
+        }
+    };
+
+    /** Chains of free blocks shared by all threads, per size class. */
+    struct Depot
+    {
+        std::mutex mutex;
+        std::vector<std::pair<Block *, size_t>> chains[NumClasses];
+    };
+
+    static Depot &
+    depot()
+    {
+        static Depot d;
+        return d;
+    }
+
+    static void
+    depotPush(size_t size_class, Block *chain, size_t count)
+    {
+        Depot &d = depot();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.chains[size_class].emplace_back(chain, count);
+    }
+
+    /** Counters of all threads that have used the pool. */
+    static std::vector<const Counters *> &
+    threadCounters()
+    {
+        static std::vector<const Counters *> all;
+        return all;
+    }
+
+    static Counters &
+    localCounters()
+    {
+        if (!counters) {
+            counters = new Counters();
+            std::lock_guard<std::mutex> lock(threadCountersMutex());
+            threadCounters().push_back(counters);
+        }
+        return *counters;
+    }
+
+    static std::mutex &
+    threadCountersMutex()
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    static uint64_t
+    sum(uint64_t Counters::*field)
+    {
+        std::lock_guard<std::mutex> lock(threadCountersMutex());
+        uint64_t total = 0;
+        for (const Counters *c : threadCounters())
+            total += c->*field;
+        return total;
+    }
+
+    static_assert(Granularity % alignof(std::max_align_t) == 0 ||
+                  alignof(std::max_align_t) % Granularity == 0,
+                  "Granularity must be compatible with allocation alignment");
+    static_assert(Granularity >= sizeof(Block),
+                  "Granularity must be large enough to hold a pointer");
+
+    /** Minimum number of bytes carved up when refilling a free list. */
+    static const size_t SlabSize = 64 * 1024;
+
+    static size_t sizeClass(size_t size) { return (size - 1) / Granularity; }
+
+    /** Number of blocks of a size class in a slab. */
+    static size_t
+    slabBlocks(size_t size_class)
+    {
+        return SlabSize / ((size_class + 1) * Granularity);
+    }
+
+    /** Refill an empty free list, from the depot if possible. */
+    static void
+    refill(ThreadCache &cache, size_t size_class)
+    {
+        {
+            Depot &d = depot();
+            std::lock_guard<std::mutex> lock(d.mutex);
+            auto &chains = d.chains[size_class];
+            if (!chains.empty()) {
+                cache.lists[size_class] = chains.back().first;
+                cache.counts[size_class] = chains.back().second;
+                chains.pop_back();
+                return;
+            }
+        }
+
+        const size_t block_size = (size_class + 1) * Granularity;
+        const size_t count = slabBlocks(size_class);
+        char *slab = static_cast<char *>(::operator new(count * block_size));
+        ++localCounters().misses;
+
+        Block *&list = cache.lists[size_class];
+        for (size_t i = count; i > 0; --i) {
+            Block *block = reinterpret_cast<Block *>(
+                slab + (i - 1) * block_size);
+            block->next = list;
+            list = block;
+        }
+        cache.counts[size_class] = count;
+    }
+
+    /**
+     * Move the blocks beyond the first slab worth of a free list to
+     * the depot, keeping the most recently freed ones local.
+     */
+    static void
+    release(ThreadCache &cache, size_t size_class)
+    {
+        const size_t keep = slabBlocks(size_class);
+        Block *last = cache.lists[size_class];
+        for (size_t i = 1; i < keep; ++i)
+            last = last->next;
+
+        depotPush(size_class, last->next, cache.counts[size_class] - keep);
+        last->next = nullptr;
+        cache.counts[size_class] = keep;
+    }
+
+    static thread_local ThreadCache threadCache;
+    static thread_local Counters *counters;
+};
+
+template <class Tag, size_t MaxSize, size_t Granularity>
+thread_local typename PoolAllocator<Tag, MaxSize, Granularity>::ThreadCache
+PoolAllocator<Tag, MaxSize, Granularity>::threadCache;
+
+template <class Tag, size_t MaxSize, size_t Granularity>
+thread_local typename PoolAllocator<Tag, MaxSize, Granularity>::Counters *
+PoolAllocator<Tag, MaxSize, Granularity>::counters = nullptr;
+
+#endif // __BASE_POOL_ALLOC_HH__
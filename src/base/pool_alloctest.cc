@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "base/pool_alloc.hh"
+
+namespace {
+
+struct TestTag {};
+typedef PoolAllocator<TestTag, 128, 16> TestPool;
+
+} // anonymous namespace
+
+TEST(PoolAllocTest, ReusesFreedBlocks)
+{
+    void *p = TestPool::allocate(40);
+    TestPool::deallocate(p, 40);
+
+    // Sizes in the same size class share a free list.
+    void *q = TestPool::allocate(48);
+    EXPECT_EQ(p, q);
+    TestPool::deallocate(q, 48);
+}
+
+TEST(PoolAllocTest, DistinctBlocks)
+{
+    const int64_t in_use = TestPool::inUse();
+
+    std::vector<void *> blocks;
+    for (int i = 0; i < 10000; ++i)
+        blocks.push_back(TestPool::allocate(24));
+    EXPECT_EQ(TestPool::inUse(), in_use + 10000);
+
+    std::set<void *> unique(blocks.begin(), blocks.end());
+    EXPECT_EQ(unique.size(), blocks.size());
+    for (void *p : blocks)
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 16, 0);
+
+    for (void *p : blocks)
+        TestPool::deallocate(p, 24);
+    EXPECT_EQ(TestPool::inUse(), in_use);
+}
+
+TEST(PoolAllocTest, LargeAllocationsBypassPool)
+{
+    const int64_t in_use = TestPool::inUse();
+    void *p = TestPool::allocate(1024);
+    EXPECT_EQ(TestPool::inUse(), in_use);
+    TestPool::deallocate(p, 1024);
+}
+
+TEST(PoolAllocTest, HitRate)
+{
+    struct HitRateTag {};
+    typedef PoolAllocator<HitRateTag, 64, 16> Pool;
+
+    EXPECT_EQ(Pool::hitRate(), 0.0);
+
+    // The first allocation needs a new slab, the others reuse the
+    // freed block.
+    for (int i = 0; i < 4; ++i)
+        Pool::deallocate(Pool::allocate(16), 16);
+
+    EXPECT_EQ(Pool::totalAllocs(), 4);
+    EXPECT_EQ(Pool::totalMisses(), 1);
+    EXPECT_DOUBLE_EQ(Pool::hitRate(), 0.75);
+}
+
+TEST(PoolAllocTest, RemoteFreesAreReused)
+{
+    struct RemoteTag {};
+    typedef PoolAllocator<RemoteTag, 64, 16> Pool;
+
+    // Blocks allocated here and freed on other threads come back
+    // through the depot, so only the first round needs new slabs.
+    uint64_t misses = 0;
+    for (int round = 0; round < 10; ++round) {
+        std::vector<void *> blocks;
+        for (int i = 0; i < 10000; ++i)
+            blocks.push_back(Pool::allocate(16));
+        EXPECT_EQ(Pool::inUse(), 10000);
+
+        std::thread([&blocks] {
+                for (void *p : blocks)
+                    Pool::deallocate(p, 16);
+            }).join();
+        EXPECT_EQ(Pool::inUse(), 0);
+
+        if (round == 0)
+            misses = Pool::totalMisses();
+        EXPECT_EQ(Pool::totalMisses(), misses);
+    }
+}
@@ -44,6 +44,8 @@
 
 #include "base/random.hh"
 
+#include <map>
+#include <mutex>
 #include <sstream>
 
 #include "base/logging.hh"
@@ -98,3 +100,112 @@ Random::unserialize(CheckpointIn &cp)
 }
 
 Random random_mt;
+
+namespace
+{
+
+/** Seed all streams are derived from */
+uint64_t globalSeed = 5489;
+
+/**
+ * All the streams, by name. Streams are normally created while the
+ * system is being built, but objects that create them on the fly may
+ * do so from several event queues at once.
+ */
+std::map<std::string, RandomStream *> &
+streams()
+{
+    static std::map<std::string, RandomStream *> map;
+    return map;
+}
+
+std::mutex streamsLock;
+
+/** Section that holds the state of the streams in a checkpoint */
+const char *const streamsSection = "RandomStreams";
+
+} // anonymous namespace
+
+RandomStream::RandomStream(const std::string &name)
+    : _name(name)
+{
+    seed();
+
+    std::lock_guard<std::mutex> lock(streamsLock);
+    panic_if(!streams().emplace(_name, this).second,
+             "Random stream %s already exists\n", _name);
+}
+
+RandomStream::~RandomStream()
+{
+    std::lock_guard<std::mutex> lock(streamsLock);
+    streams().erase(_name);
+}
+
+void
+RandomStream::seed()
+{
+    // FNV-1a, so the seed doesn't depend on the standard library
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : _name)
+        hash = (hash ^ (uint8_t)c) * 0x100000001b3ULL;
+
+    gen.seed(hash ^ Xoshiro256(globalSeed)());
+}
+
+void
+RandomStream::setGlobalSeed(uint64_t seed)
+{
+    std::lock_guard<std::mutex> lock(streamsLock);
+    globalSeed = seed;
+    for (auto &stream : streams())
+        stream.second->seed();
+}
+
+void
+RandomStream::serializeAll(CheckpointOut &cp)
+{
+    struct Streams : public Serializable
+    {
+        void
+        serialize(CheckpointOut &cp) const override
+        {
+            for (const auto &stream : streams()) {
+                const Xoshiro256 &gen = stream.second->gen;
+                arrayParamOut(cp, stream.first, gen.state.data(),
+                              gen.state.size());
+            }
+        }
+
+        void unserialize(CheckpointIn &cp) override {}
+    };
+
+    Streams().serializeSection(cp, streamsSection);
+}
+
+void
+RandomStream::unserializeAll(CheckpointIn &cp)
+{
+    struct Streams : public Serializable
+    {
+        void serialize(CheckpointOut &cp) const override {}
+
+        void
+        unserialize(CheckpointIn &cp) override
+        {
+            const std::string &section(Serializable::currentSection());
+            for (auto &stream : streams()) {
+                if (!cp.entryExists(section, stream.first))
+                    continue;
+
+                Xoshiro256 &gen = stream.second->gen;
+                arrayParamIn(cp, stream.first, gen.state.data(),
+                             gen.state.size());
+            }
+        }
+    };
+
+    // Checkpoints taken before streams existed don't have the section
+    if (cp.sectionExists(streamsSection))
+        Streams().unserializeSection(cp, streamsSection);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Bounded single-producer single-consumer ring.
+ */
+
+#ifndef __BASE_SPSC_RING_HH__
+#define __BASE_SPSC_RING_HH__
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Bounded FIFO for passing elements from one producer thread to one
+ * consumer thread without locks.
+ *
+ * Each side owns one index and only reads the other one, so pushing
+ * or popping an element costs an atomic load and store. The indices
+ * live on separate cache lines so that the two threads don't contend
+ * for the same line on every element. Neither side ever blocks; the
+ * caller decides how to wait when the ring is full or empty.
+ */
+template <class T>
+class SPSCRing
+{
+  public:
+    explicit SPSCRing(size_t capacity)
+        : _head(0), _tail(0)
+    {
+        size_t slots = 1;
+        while (slots < capacity)
+            slots <<= 1;
+        buf.resize(slots);
+        mask = slots - 1;
+    }
+
+    /** Number of slots. */
+    size_t capacity() const { return buf.size(); }
+
+    /**
+     * Number of elements. This is exact when called from either side
+     * while the other one is idle, and a snapshot otherwise.
+     */
+    size_t
+    size() const
+    {
+        return _tail.load(std::memory_order_acquire) -
+            _head.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    /** Append an element. Producer only. Returns false if full. */
+    bool
+    push(const T &elem)
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == buf.size())
+            return false;
+        buf[tail & mask] = elem;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Remove the oldest element. Consumer only. Returns false if empty. */
+    bool
+    pop(T &elem)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return false;
+        elem = buf[head & mask];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    std::vector<T> buf;
+    size_t mask;
+
+    /** Next element to pop, written by the consumer */
+    alignas(64) std::atomic<size_t> _head;
+    /** Next slot to push to, written by the producer */
+    alignas(64) std::atomic<size_t> _tail;
+};
+
+#endif // __BASE_SPSC_RING_HH__
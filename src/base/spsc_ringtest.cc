@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "base/spsc_ring.hh"
+
+TEST(SPSCRingTest, FillAndDrain)
+{
+    SPSCRing<int> ring(3);
+    EXPECT_EQ(ring.capacity(), 4U);
+    EXPECT_TRUE(ring.empty());
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(ring.push(i));
+    EXPECT_FALSE(ring.push(4));
+    EXPECT_EQ(ring.size(), 4U);
+
+    int v;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.pop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_FALSE(ring.pop(v));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SPSCRingTest, WrapAround)
+{
+    SPSCRing<int> ring(4);
+    int v;
+    int next = 0;
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(ring.push(3 * i));
+        EXPECT_TRUE(ring.push(3 * i + 1));
+        EXPECT_TRUE(ring.push(3 * i + 2));
+        EXPECT_EQ(ring.size(), 3U);
+        for (int j = 0; j < 3; ++j) {
+            ASSERT_TRUE(ring.pop(v));
+            EXPECT_EQ(v, next++);
+        }
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SPSCRingTest, TwoThreads)
+{
+    const int count = 100000;
+    SPSCRing<int> ring(64);
+
+    std::thread consumer([&ring, count]{
+        int expected = 0;
+        int v;
+        while (expected < count) {
+            if (ring.pop(v)) {
+                EXPECT_EQ(v, expected);
+                ++expected;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (int i = 0; i < count; ++i) {
+        while (!ring.push(i))
+            std::this_thread::yield();
+    }
+
+    consumer.join();
+    EXPECT_TRUE(ring.empty());
+}
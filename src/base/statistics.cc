@@ -30,11 +30,15 @@
 
 #include "base/statistics.hh"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <list>
 #include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "base/callback.hh"
 #include "base/cprintf.hh"
@@ -59,27 +63,14 @@ statsList()
     return the_list;
 }
 
-MapType &
-statsMap()
-{
-    static MapType the_map;
-    return the_map;
-}
-
 void
 InfoAccess::setInfo(Info *info)
 {
-    if (statsMap().find(this) != statsMap().end())
+    if (_info)
         panic("shouldn't register stat twice!");
 
     statsList().push_back(info);
-
-#ifndef NDEBUG
-    pair<MapType::iterator, bool> result =
-#endif
-        statsMap().insert(make_pair(this, info));
-    assert(result.second && "this should never fail");
-    assert(statsMap().find(this) != statsMap().end());
+    _info = info;
 }
 
 void
@@ -94,22 +85,6 @@ InfoAccess::setInit()
     info()->flags.set(init);
 }
 
-Info *
-InfoAccess::info()
-{
-    MapType::const_iterator i = statsMap().find(this);
-    assert(i != statsMap().end());
-    return (*i).second;
-}
-
-const Info *
-InfoAccess::info() const
-{
-    MapType::const_iterator i = statsMap().find(this);
-    assert(i != statsMap().end());
-    return (*i).second;
-}
-
 StorageParams::~StorageParams()
 {
 }
@@ -121,12 +96,19 @@ nameMap()
     return the_map;
 }
 
+/**
+ * Protects the name map and the storage arena, since SimObjects that
+ * support it register their stats in parallel.
+ */
+static std::mutex registryMutex;
+
 int Info::id_count = 0;
 
 int debug_break_id = -1;
 
 Info::Info()
-    : flags(none), precision(-1), prereq(0), storageParams(NULL)
+    : flags(none), precision(-1), prereq(0), storageParams(NULL),
+      resetByArena(false)
 {
     id = id_count++;
     if (debug_break_id >= 0 and debug_break_id == id)
@@ -143,26 +125,22 @@ validateStatName(const string &name)
     if (name.empty())
         return false;
 
-    vector<string> vec;
-    tokenize(vec, name, '.');
-    vector<string>::const_iterator item = vec.begin();
-    while (item != vec.end()) {
-        if (item->empty())
-            return false;
-
-        string::const_iterator c = item->begin();
-
-        // The first character is different
-        if (!isalpha(*c) && *c != '_')
-            return false;
-
-        // The rest of the characters have different rules.
-        while (++c != item->end()) {
-            if (!isalnum(*c) && *c != '_')
+    // Check each of the components separated by dots in a single
+    // pass, as this is done for every stat that is registered
+    bool first = true;
+    for (char c : name) {
+        if (c == '.') {
+            first = true;
+        } else if (first) {
+            // The first character is different
+            if (!isalpha(c) && c != '_')
+                return false;
+            first = false;
+        } else {
+            // The rest of the characters have different rules.
+            if (!isalnum(c) && c != '_')
                 return false;
         }
-
-        ++item;
     }
 
     return true;
@@ -174,11 +152,16 @@ Info::setName(const string &name)
     if (!validateStatName(name))
         panic("invalid stat name '%s'", name);
 
-    pair<NameMapType::iterator, bool> p =
-        nameMap().insert(make_pair(name, this));
+    Info *other;
+    bool result;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        pair<NameMapType::iterator, bool> p =
+            nameMap().insert(make_pair(name, this));
 
-    Info *other = p.first->second;
-    bool result = p.second;
+        other = p.first->second;
+        result = p.second;
+    }
 
     if (!result) {
       // using other->name instead of just name to avoid a compiler
@@ -475,8 +458,150 @@ registerHandlers(Handler reset_handler, Handler dump_handler)
     dumpHandler = dump_handler;
 }
 
+thread_local std::vector<Counter> *ShardedCounters::localBlock = nullptr;
+
+namespace {
+
+/** Protects the list of blocks, and their sizes */
+std::mutex shardMutex;
+std::vector<std::vector<Counter> *> shardBlocks;
+size_t numShardSlots = 0;
+
+} // anonymous namespace
+
+size_t
+ShardedCounters::allocSlot()
+{
+    std::lock_guard<std::mutex> lock(shardMutex);
+    return numShardSlots++;
+}
+
+Counter &
+ShardedCounters::localSlow(size_t slot)
+{
+    std::lock_guard<std::mutex> lock(shardMutex);
+
+    if (!localBlock) {
+        localBlock = new std::vector<Counter>();
+        shardBlocks.push_back(localBlock);
+    }
+    // Grow to fit all the slots, to avoid coming back here
+    localBlock->resize(std::max(numShardSlots, slot + 1), Counter());
+    return (*localBlock)[slot];
+}
+
+Counter
+ShardedCounters::sum(size_t slot)
+{
+    std::lock_guard<std::mutex> lock(shardMutex);
+
+    Counter total = Counter();
+    for (auto block : shardBlocks) {
+        if (slot < block->size())
+            total += (*block)[slot];
+    }
+    return total;
+}
+
+void
+ShardedCounters::reset(size_t slot)
+{
+    std::lock_guard<std::mutex> lock(shardMutex);
+
+    for (auto block : shardBlocks) {
+        if (slot < block->size())
+            (*block)[slot] = Counter();
+    }
+}
+
+bool StorageArena::enabled = false;
+
+namespace {
+
+struct ArenaChunk
+{
+    char *data;
+    size_t used;
+    size_t size;
+};
+
+/** Chunks of storage which reset to 0, and of other storage */
+std::vector<ArenaChunk> zeroChunks;
+std::vector<ArenaChunk> otherChunks;
+
+const size_t arenaChunkSize = 1 << 20;
+
+/** Stats in dump order */
+std::vector<Info *> statsOrder;
+
+} // anonymous namespace
+
+void *
+StorageArena::allocate(size_t bytes, bool zero_reset)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::vector<ArenaChunk> &chunks = zero_reset ? zeroChunks : otherChunks;
+    bytes = roundUp(bytes, 8);
+
+    if (chunks.empty() || chunks.back().used + bytes > chunks.back().size) {
+        ArenaChunk chunk;
+        chunk.size = std::max(bytes, arenaChunkSize);
+        chunk.data = new char[chunk.size];
+        chunk.used = 0;
+        chunks.push_back(chunk);
+    }
+
+    ArenaChunk &chunk = chunks.back();
+    void *ptr = chunk.data + chunk.used;
+    chunk.used += bytes;
+    return ptr;
+}
+
+void
+StorageArena::zeroReset()
+{
+    for (auto &chunk : zeroChunks)
+        std::memset(chunk.data, 0, chunk.used);
+}
+
+void
+setStatsOrder(const std::vector<Info *> &stats)
+{
+    statsOrder = stats;
+}
+
+void
+prepareAll()
+{
+    processPrepareQueue();
+
+    for (auto info : statsOrder)
+        info->prepare();
+}
+
+void
+visitAll(Output &output)
+{
+    for (auto info : statsOrder)
+        info->visit(output);
+}
+
+void
+resetAll()
+{
+    StorageArena::zeroReset();
+
+    for (auto info : statsList()) {
+        if (!info->resetByArena)
+            info->reset();
+    }
+}
+
 CallbackQueue dumpQueue;
 CallbackQueue resetQueue;
+CallbackQueue prepareQueue;
+CallbackQueue sampleQueue;
 
 void
 processResetQueue()
@@ -490,6 +615,18 @@ processDumpQueue()
     dumpQueue.process();
 }
 
+void
+processPrepareQueue()
+{
+    prepareQueue.process();
+}
+
+void
+processSampleQueue()
+{
+    sampleQueue.process();
+}
+
 void
 registerResetCallback(Callback *cb)
 {
@@ -537,6 +674,18 @@ registerDumpCallback(Callback *cb)
     dumpQueue.add(cb);
 }
 
+void
+registerPrepareCallback(Callback *cb)
+{
+    prepareQueue.add(cb);
+}
+
+void
+registerSampleCallback(Callback *cb)
+{
+    sampleQueue.add(cb);
+}
+
 } // namespace Stats
 
 void
@@ -61,6 +61,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "base/stats/info.hh"
@@ -98,6 +100,7 @@ class InfoProxy : public Base
         visitor.visit(*static_cast<Base *>(this));
     }
     bool zero() const { return s.zero(); }
+    CounterView counters() const { return s.counters(); }
 };
 
 template <class Stat>
@@ -172,7 +175,13 @@ struct StorageParams
 
 class InfoAccess
 {
+  private:
+    /** The information class of this statistic */
+    Info *_info;
+
   protected:
+    InfoAccess() : _info(nullptr) { }
+
     /** Set up an info class for this statistic */
     void setInfo(Info *info);
     /** Save Storage class parameters if any */
@@ -181,9 +190,9 @@ class InfoAccess
     void setInit();
 
     /** Grab the information class for this statistic */
-    Info *info();
+    Info *info() { assert(_info); return _info; }
     /** Grab the information class for this statistic */
-    const Info *info() const;
+    const Info *info() const { assert(_info); return _info; }
 
   public:
     /**
@@ -245,6 +254,12 @@ class DataWrap : public InfoAccess
         this->setInfo(new Info(self()));
     }
 
+    /**
+     * Stats don't expose their counters in memory unless they
+     * override this.
+     */
+    CounterView counters() const { return CounterView(); }
+
     /**
      * Set the name and marks this stat to print at the end of simulation.
      * @param name The new name.
@@ -521,6 +536,9 @@ class StatStor
      * @return true if zero value
      */
     bool zero() const { return data == Counter(); }
+
+    /** @return The counter in memory */
+    const Counter *counter() const { return &data; }
 };
 
 /**
@@ -584,6 +602,9 @@ class AvgStor
      */
     Counter value() const { return current; }
 
+    /** @return The current count in memory */
+    const Counter *counter() const { return &current; }
+
     /**
      * Return the current average.
      * @return The current average.
@@ -623,6 +644,84 @@ class AvgStor
 
 };
 
+/**
+ * Counters with a copy per host thread, for stats which are updated
+ * from several event queues at once. Each counter is a slot in a block
+ * of counters owned by every thread, so updates neither race nor share
+ * cache lines with other threads. Reading a counter sums the slot over
+ * all the threads, and is meant to be done at global synchronisation
+ * points, such as stats dumps and resets.
+ */
+class ShardedCounters
+{
+  private:
+    /** Block of counters of the calling thread */
+    static thread_local std::vector<Counter> *localBlock;
+
+    /** Create or grow the calling thread's block */
+    static Counter &localSlow(size_t slot);
+
+  public:
+    /** Get a new slot, initially zero in all threads */
+    static size_t allocSlot();
+
+    /** The calling thread's copy of a slot */
+    static Counter &
+    local(size_t slot)
+    {
+        std::vector<Counter> *block = localBlock;
+        if (block && slot < block->size())
+            return (*block)[slot];
+        return localSlow(slot);
+    }
+
+    /** Sum of a slot over all the threads */
+    static Counter sum(size_t slot);
+
+    /** Zero a slot in all the threads */
+    static void reset(size_t slot);
+};
+
+/**
+ * Storage for a simple scalar stat which is updated from several
+ * threads. @sa ShardedCounters
+ */
+class ShardedStor
+{
+  private:
+    size_t slot;
+
+  public:
+    struct Params : public StorageParams {};
+
+  public:
+    ShardedStor(Info *info)
+        : slot(ShardedCounters::allocSlot())
+    { }
+
+    /**
+     * Set the stat to the given value. This isn't meant to be done
+     * while other threads update the stat.
+     * @param val The new value.
+     */
+    void
+    set(Counter val)
+    {
+        ShardedCounters::reset(slot);
+        ShardedCounters::local(slot) = val;
+    }
+    void inc(Counter val) { ShardedCounters::local(slot) += val; }
+    void dec(Counter val) { ShardedCounters::local(slot) -= val; }
+    Counter value() const { return ShardedCounters::sum(slot); }
+    Result result() const { return (Result)value(); }
+    void prepare(Info *info) { }
+    void reset(Info *info) { ShardedCounters::reset(slot); }
+    bool zero() const { return value() == Counter(); }
+
+    /** The counter is spread over the shards, so it has no view. */
+    const Counter *counter() const { return nullptr; }
+};
+
 /**
  * Implementation of a scalar stat. The type of stat is determined by the
  * Storage template.
@@ -740,6 +839,18 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
 
     void reset() { data()->reset(this->info()); }
     void prepare() { data()->prepare(this->info()); }
+
+    CounterView
+    counters() const
+    {
+        CounterView view;
+        if (!data()->counter())
+            return view;
+        view.data = data()->counter();
+        view.shape = { 1 };
+        view.strides = { sizeof(Counter) };
+        return view;
+    }
 };
 
 class ProxyInfo : public ScalarInfo
@@ -988,6 +1099,48 @@ class ScalarProxy
     }
 };
 
+/**
+ * Contiguous storage for the elements of vector stats. Vector stats
+ * normally allocate their storage separately, which scatters it over
+ * the heap. Once enabled, which has to happen before any stat is
+ * initialised, they allocate it from large chunks instead.
+ * StatStor elements, which reset to 0, get chunks of their own, and
+ * resetAll() clears those with memset instead of resetting each stat.
+ * Storage in the arena is only freed at exit.
+ */
+class StorageArena
+{
+  public:
+    static bool enabled;
+
+    /** Allocate bytes, aligned to 8 bytes */
+    static void *allocate(size_t bytes, bool zero_reset);
+
+    /** Clear all the storage that resets to 0 */
+    static void zeroReset();
+};
+
+/**
+ * Allocate uninitialised storage for size elements of a vector stat.
+ * @return Whether the storage is in the StorageArena.
+ */
+template <class Storage>
+bool
+allocStorage(Storage *&storage, size_type size, Info *info)
+{
+    if (!StorageArena::enabled) {
+        storage = reinterpret_cast<Storage *>(
+            new char[size * sizeof(Storage)]);
+        return false;
+    }
+
+    const bool zero_reset = std::is_same<Storage, StatStor>::value;
+    storage = reinterpret_cast<Storage *>(
+        StorageArena::allocate(size * sizeof(Storage), zero_reset));
+    info->resetByArena = zero_reset;
+    return true;
+}
+
 /**
  * Implementation of a vector of stats. The type of stat is determined by the
  * Storage class. @sa ScalarBase
@@ -1008,6 +1161,8 @@ class VectorBase : public DataWrapVec<Derived, VectorInfoProxy>
     /** The storage of this stat. */
     Storage *storage;
     size_type _size;
+    /** Is storage in the StorageArena? */
+    bool inArena;
 
   protected:
     /**
@@ -1031,8 +1186,7 @@ class VectorBase : public DataWrapVec<Derived, VectorInfoProxy>
         assert(!storage && "already initialized");
         _size = s;
 
-        char *ptr = new char[_size * sizeof(Storage)];
-        storage = reinterpret_cast<Storage *>(ptr);
+        inArena = allocStorage(storage, _size, this->info());
 
         for (off_type i = 0; i < _size; ++i)
             new (&storage[i]) Storage(this->info());
@@ -1094,9 +1248,21 @@ class VectorBase : public DataWrapVec<Derived, VectorInfoProxy>
         return storage != NULL;
     }
 
+    CounterView
+    counters() const
+    {
+        CounterView view;
+        if (!storage || !storage->counter())
+            return view;
+        view.data = storage->counter();
+        view.shape = { size() };
+        view.strides = { sizeof(Storage) };
+        return view;
+    }
+
   public:
     VectorBase()
-        : storage(nullptr), _size(0)
+        : storage(nullptr), _size(0), inArena(false)
     {}
 
     ~VectorBase()
@@ -1106,7 +1272,8 @@ class VectorBase : public DataWrapVec<Derived, VectorInfoProxy>
 
         for (off_type i = 0; i < _size; ++i)
             data(i)->~Storage();
-        delete [] reinterpret_cast<char *>(storage);
+        if (!inArena)
+            delete [] reinterpret_cast<char *>(storage);
     }
 
     /**
@@ -1229,6 +1396,8 @@ class Vector2dBase : public DataWrapVec2d<Derived, Vector2dInfoProxy>
     size_type y;
     size_type _size;
     Storage *storage;
+    /** Is storage in the StorageArena? */
+    bool inArena;
 
   protected:
     Storage *data(off_type index) { return &storage[index]; }
@@ -1236,7 +1405,7 @@ class Vector2dBase : public DataWrapVec2d<Derived, Vector2dInfoProxy>
 
   public:
     Vector2dBase()
-        : x(0), y(0), _size(0), storage(nullptr)
+        : x(0), y(0), _size(0), storage(nullptr), inArena(false)
     {}
 
     ~Vector2dBase()
@@ -1246,7 +1415,8 @@ class Vector2dBase : public DataWrapVec2d<Derived, Vector2dInfoProxy>
 
         for (off_type i = 0; i < _size; ++i)
             data(i)->~Storage();
-        delete [] reinterpret_cast<char *>(storage);
+        if (!inArena)
+            delete [] reinterpret_cast<char *>(storage);
     }
 
     Derived &
@@ -1264,8 +1434,7 @@ class Vector2dBase : public DataWrapVec2d<Derived, Vector2dInfoProxy>
         info->y = _y;
         _size = x * y;
 
-        char *ptr = new char[_size * sizeof(Storage)];
-        storage = reinterpret_cast<Storage *>(ptr);
+        inArena = allocStorage(storage, _size, info);
 
         for (off_type i = 0; i < _size; ++i)
             new (&storage[i]) Storage(info);
@@ -1346,6 +1515,18 @@ class Vector2dBase : public DataWrapVec2d<Derived, Vector2dInfoProxy>
     {
         return storage != NULL;
     }
+
+    CounterView
+    counters() const
+    {
+        CounterView view;
+        if (!storage || !storage->counter())
+            return view;
+        view.data = storage->counter();
+        view.shape = { x, y };
+        view.strides = { y * sizeof(Storage), sizeof(Storage) };
+        return view;
+    }
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -1414,6 +1595,9 @@ class DistStor
         reset(info);
     }
 
+    /** @return The bucket counters */
+    const VCounter *buckets() const { return &cvec; }
+
     /**
      * Add a value to the distribution for the given number of times.
      * @param val The value to add.
@@ -1552,6 +1736,9 @@ class HistStor
         reset(info);
     }
 
+    /** @return The bucket counters */
+    const VCounter *buckets() const { return &cvec; }
+
     void grow_up();
     void grow_out();
     void grow_convert();
@@ -1685,6 +1872,9 @@ class SampleStor
         : sum(Counter()), squares(Counter()), samples(Counter())
     { }
 
+    /** This storage has no buckets. */
+    const VCounter *buckets() const { return nullptr; }
+
     /**
      * Add a value the given number of times to this running average.
      * Update the running sum and sum of squares, increment the number of
@@ -1763,6 +1953,9 @@ class AvgSampleStor
         : sum(Counter()), squares(Counter())
     {}
 
+    /** This storage has no buckets. */
+    const VCounter *buckets() const { return nullptr; }
+
     /**
      * Add a value to the distribution for the given number of times.
      * Update the running sum and sum of squares.
@@ -1900,6 +2093,19 @@ class DistBase : public DataWrap<Derived, DistInfoProxy>
      */
     void add(DistBase &d) { data()->add(d.data()); }
 
+    CounterView
+    counters() const
+    {
+        CounterView view;
+        const VCounter *buckets = data()->buckets();
+        if (!buckets || buckets->empty())
+            return view;
+        view.data = buckets->data();
+        view.shape = { (size_type)buckets->size() };
+        view.strides = { sizeof(Counter) };
+        return view;
+    }
+
 };
 
 template <class Stat>
@@ -2488,6 +2694,16 @@ class Average : public ScalarBase<Average, AvgStor>
     using ScalarBase<Average, AvgStor>::operator=;
 };
 
+/**
+ * A scalar stat which can be updated from several threads.
+ * @sa Stat, ScalarBase, ShardedStor
+ */
+class ShardedScalar : public ScalarBase<ShardedScalar, ShardedStor>
+{
+  public:
+    using ScalarBase<ShardedScalar, ShardedStor>::operator=;
+};
+
 class Value : public ValueBase<Value>
 {
 };
@@ -2500,6 +2716,14 @@ class Vector : public VectorBase<Vector, StatStor>
 {
 };
 
+/**
+ * A vector of scalar stats which can be updated from several threads.
+ * @sa Stat, VectorBase, ShardedStor
+ */
+class ShardedVector : public VectorBase<ShardedVector, ShardedStor>
+{
+};
+
 /**
  * A vector of Average stats.
  * @sa Stat, VectorBase, AvgStor
@@ -3253,6 +3477,24 @@ void registerResetCallback(Callback *cb);
  */
 void registerDumpCallback(Callback *cb);
 
+/**
+ * Register a callback that should be called before the values of the
+ * statistics are read, e.g., to add counts that an object accumulates
+ * outside of its stats. It is called from prepareAll(), either while
+ * the simulation is stopped or from a global event, so all event queues
+ * are quiescent.
+ */
+void registerPrepareCallback(Callback *cb);
+
+/**
+ * Register a callback that should be called before the values of the
+ * statistics are sampled while the simulation runs, e.g., by a power
+ * model. In parallel mode it is called from the thread of the event
+ * queue doing the sampling, so it must only touch state that belongs
+ * to the current event queue.
+ */
+void registerSampleCallback(Callback *cb);
+
 /**
  * Process all the callbacks in the reset callbacks queue
  */
@@ -3263,12 +3505,41 @@ void processResetQueue();
  */
 void processDumpQueue();
 
+/**
+ * Process all the callbacks in the prepare callbacks queue
+ */
+void processPrepareQueue();
+
+/**
+ * Process all the callbacks in the sample callbacks queue
+ */
+void processSampleQueue();
+
 std::list<Info *> &statsList();
 
-typedef std::map<const void *, Info *> MapType;
-MapType &statsMap();
+/**
+ * Set the order in which prepareAll and visitAll go through the stats,
+ * which is the order they are dumped in. This is done once, after the
+ * stats have been enabled.
+ */
+void setStatsOrder(const std::vector<Info *> &stats);
+
+/**
+ * Prepare all the stats for dumping, after processing the prepare
+ * callbacks queue
+ */
+void prepareAll();
+
+/** Visit all the stats with output, in dump order */
+void visitAll(Output &output);
+
+/**
+ * Reset all the stats. Stats which have their storage in the
+ * StorageArena and reset to 0 are cleared in bulk.
+ */
+void resetAll();
 
-typedef std::map<std::string, Info *> NameMapType;
+typedef std::unordered_map<std::string, Info *> NameMapType;
 NameMapType &nameMap();
 
 bool validateStatName(const std::string &name);
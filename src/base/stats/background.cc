@@ -0,0 +1,428 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/background.hh"
+
+#include <cassert>
+#include <map>
+
+#include "base/callback.hh"
+#include "base/stats/info.hh"
+#include "sim/core.hh"
+
+namespace Stats {
+
+namespace {
+
+/**
+ * Copy the description of a stat. Prerequisites are resolved when
+ * freezing, by pointing at zeroPrereq or at nothing, so that the
+ * frozen stat never refers to a live one.
+ */
+void
+copyInfo(Info &frozen, const Info &info)
+{
+    frozen.name = info.name;
+    frozen.desc = info.desc;
+    frozen.flags = info.flags;
+    frozen.precision = info.precision;
+    frozen.storageParams = info.storageParams;
+}
+
+/**
+ * Frozen stats only need to report being zero when they stand for a
+ * prerequisite, which is what zeroPrereq is for.
+ */
+template <class Base>
+class Frozen : public Base
+{
+  public:
+    bool check() const override { return true; }
+    void prepare() override { }
+    void reset() override { }
+    bool zero() const override { return false; }
+    void visit(Output &visitor) override { visitor.visit(*this); }
+};
+
+class FrozenScalar : public Frozen<ScalarInfo>
+{
+  public:
+    Counter _value;
+    Result _result;
+    Result _total;
+    bool _zero;
+
+    FrozenScalar() : _value(0), _result(0), _total(0), _zero(false) { }
+
+    void
+    freeze(const ScalarInfo &info)
+    {
+        _value = info.value();
+        _result = info.result();
+        _total = info.total();
+    }
+
+    Counter value() const override { return _value; }
+    Result result() const override { return _result; }
+    Result total() const override { return _total; }
+    bool zero() const override { return _zero; }
+};
+
+/** Prerequisite of the frozen stats whose prerequisite was zero */
+FrozenScalar *
+zeroPrereq()
+{
+    static FrozenScalar *prereq = nullptr;
+    if (!prereq) {
+        prereq = new FrozenScalar();
+        prereq->_zero = true;
+    }
+    return prereq;
+}
+
+/** Vectors and formulas, which are vectors with a description */
+class FrozenVector : public Frozen<FormulaInfo>
+{
+  public:
+    bool formula;
+    size_type _size;
+    VCounter _value;
+    VResult _result;
+    Result _total;
+    std::string _str;
+
+    FrozenVector() : formula(false), _size(0), _total(0) { }
+
+    void
+    freeze(const VectorInfo &info)
+    {
+        _size = info.size();
+        _value = info.value();
+        _result = info.result();
+        _total = info.total();
+    }
+
+    void
+    freeze(const FormulaInfo &info)
+    {
+        freeze((const VectorInfo &)info);
+        formula = true;
+    }
+
+    size_type size() const override { return _size; }
+    const VCounter &value() const override { return _value; }
+    const VResult &result() const override { return _result; }
+    Result total() const override { return _total; }
+    std::string str() const override { return _str; }
+
+    void
+    visit(Output &visitor) override
+    {
+        if (formula)
+            visitor.visit((const FormulaInfo &)*this);
+        else
+            visitor.visit((const VectorInfo &)*this);
+    }
+};
+
+class FrozenDist : public Frozen<DistInfo>
+{
+  public:
+    void freeze(const DistInfo &info) { data = info.data; }
+};
+
+class FrozenVectorDist : public Frozen<VectorDistInfo>
+{
+  public:
+    void freeze(const VectorDistInfo &info) { data = info.data; }
+
+    size_type size() const override { return data.size(); }
+};
+
+class FrozenVector2d : public Frozen<Vector2dInfo>
+{
+  public:
+    Result _total;
+
+    FrozenVector2d() : _total(0) { }
+
+    void
+    freeze(const Vector2dInfo &info)
+    {
+        cvec = info.cvec;
+        _total = info.total();
+    }
+
+    Result total() const override { return _total; }
+};
+
+class FrozenSparseHist : public Frozen<SparseHistInfo>
+{
+  public:
+    void freeze(const SparseHistInfo &info) { data = info.data; }
+};
+
+/** Copy the parts of a stat's description which never change */
+void
+copyDescription(FrozenScalar &frozen, const ScalarInfo &info)
+{
+}
+
+void
+copyDescription(FrozenVector &frozen, const VectorInfo &info)
+{
+    frozen.subnames = info.subnames;
+    frozen.subdescs = info.subdescs;
+}
+
+void
+copyDescription(FrozenVector &frozen, const FormulaInfo &info)
+{
+    copyDescription(frozen, (const VectorInfo &)info);
+    frozen._str = info.str();
+}
+
+void
+copyDescription(FrozenDist &frozen, const DistInfo &info)
+{
+}
+
+void
+copyDescription(FrozenVectorDist &frozen, const VectorDistInfo &info)
+{
+    frozen.subnames = info.subnames;
+    frozen.subdescs = info.subdescs;
+}
+
+void
+copyDescription(FrozenVector2d &frozen, const Vector2dInfo &info)
+{
+    frozen.subnames = info.subnames;
+    frozen.subdescs = info.subdescs;
+    frozen.y_subnames = info.y_subnames;
+    frozen.x = info.x;
+    frozen.y = info.y;
+}
+
+void
+copyDescription(FrozenSparseHist &frozen, const SparseHistInfo &info)
+{
+}
+
+std::vector<Background *> &
+backgroundOutputs()
+{
+    static std::vector<Background *> outputs;
+    return outputs;
+}
+
+/** Write out the remaining dumps when the simulator exits */
+class StopBackgroundOutputs : public Callback
+{
+  public:
+    void
+    process() override
+    {
+        for (auto output : backgroundOutputs())
+            output->stop();
+    }
+};
+
+} // anonymous namespace
+
+Background::Background(Output *_output)
+    : output(_output), outputValid(_output->valid()), current(nullptr),
+      next(0), stopping(false)
+{
+}
+
+Background::~Background()
+{
+    stop();
+
+    for (auto snapshot : freeList)
+        delete snapshot;
+    delete current;
+}
+
+template <class Frozen, class Src>
+void
+Background::freeze(const Src &info)
+{
+    assert(current);
+
+    Frozen *frozen;
+    if (next < current->stats.size()) {
+        frozen = static_cast<Frozen *>(current->stats[next].get());
+        assert(frozen->name == info.name);
+    } else {
+        frozen = new Frozen();
+        copyInfo(*frozen, info);
+        copyDescription(*frozen, info);
+        current->stats.emplace_back(frozen);
+    }
+    ++next;
+
+    frozen->prereq =
+        (info.prereq && info.prereq->zero()) ? zeroPrereq() : nullptr;
+    frozen->freeze(info);
+}
+
+void
+Background::begin()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!freeList.empty()) {
+        current = freeList.back();
+        freeList.pop_back();
+    } else {
+        current = new Snapshot();
+    }
+    next = 0;
+}
+
+void
+Background::end()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if (!writer.joinable() && !stopping)
+        writer = std::thread(&Background::writeDumps, this);
+
+    cond.wait(lock, [this]{ return pending.size() < maxPending; });
+    pending.push_back(current);
+    current = nullptr;
+    cond.notify_all();
+}
+
+void
+Background::writeDumps()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        cond.wait(lock, [this]{ return !pending.empty() || stopping; });
+        if (pending.empty())
+            break;
+
+        Snapshot *snapshot = pending.front();
+        lock.unlock();
+
+        output->begin();
+        for (auto &info : snapshot->stats)
+            info->visit(*output);
+        output->end();
+
+        lock.lock();
+        pending.pop_front();
+        freeList.push_back(snapshot);
+        cond.notify_all();
+    }
+}
+
+void
+Background::drain()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [this]{ return pending.empty(); });
+}
+
+void
+Background::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        cond.notify_all();
+    }
+
+    // The writer only stops once the queue is empty
+    if (writer.joinable())
+        writer.join();
+}
+
+void
+Background::visit(const ScalarInfo &info)
+{
+    freeze<FrozenScalar>(info);
+}
+
+void
+Background::visit(const VectorInfo &info)
+{
+    freeze<FrozenVector>(info);
+}
+
+void
+Background::visit(const DistInfo &info)
+{
+    freeze<FrozenDist>(info);
+}
+
+void
+Background::visit(const VectorDistInfo &info)
+{
+    freeze<FrozenVectorDist>(info);
+}
+
+void
+Background::visit(const Vector2dInfo &info)
+{
+    freeze<FrozenVector2d>(info);
+}
+
+void
+Background::visit(const FormulaInfo &info)
+{
+    freeze<FrozenVector>(info);
+}
+
+void
+Background::visit(const SparseHistInfo &info)
+{
+    freeze<FrozenSparseHist>(info);
+}
+
+Output *
+initBackground(Output *output)
+{
+    static std::map<Output *, Background *> wrapped;
+
+    if (backgroundOutputs().empty())
+        registerExitCallback(new StopBackgroundOutputs());
+
+    Background *&background = wrapped[output];
+    if (!background) {
+        background = new Background(output);
+        backgroundOutputs().push_back(background);
+    }
+    return background;
+}
+
+} // namespace Stats
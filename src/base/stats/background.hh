@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_BACKGROUND_HH__
+#define __BASE_STATS_BACKGROUND_HH__
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/stats/output.hh"
+
+namespace Stats {
+
+class Info;
+
+/**
+ * Stats output which passes the dumps to another output on a
+ * background thread.
+ *
+ * While the simulation thread visits the stats, their values are
+ * copied into a snapshot of frozen Info objects, which can be visited
+ * without touching the stats themselves. At the end of the dump the
+ * snapshot is queued, and the background thread formats and writes
+ * it using the wrapped output while the simulation carries on.
+ *
+ * Stats are always visited in the same order, so the frozen objects
+ * of a snapshot are reused from one dump to the next, and only their
+ * values are copied. The simulation waits if too many dumps are
+ * still being written.
+ */
+class Background : public Output
+{
+  protected:
+    struct Snapshot
+    {
+        std::vector<std::unique_ptr<Info>> stats;
+    };
+
+    /** Number of snapshots queued before dump blocks */
+    static const size_t maxPending = 2;
+
+    Output *output;
+    bool outputValid;
+
+    /** Snapshot being filled by the current dump, and its next slot */
+    Snapshot *current;
+    size_t next;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<Snapshot *> pending;
+    std::vector<Snapshot *> freeList;
+    bool stopping;
+    std::thread writer;
+
+    /** Get the next slot of the current snapshot, freezing info */
+    template <class Frozen, class Src>
+    void freeze(const Src &info);
+
+    void writeDumps();
+
+  public:
+    Background(Output *output);
+    ~Background();
+
+    /** Wait for all the queued dumps to be written */
+    void drain();
+
+    /** Drain and stop the background thread */
+    void stop();
+
+    // Implement Visit
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+    // Implement Output
+    bool valid() const override { return outputValid; }
+    void begin() override;
+    void end() override;
+};
+
+/**
+ * Write the dumps of output on a background thread. Outputs are
+ * drained when the simulator exits.
+ */
+Output *initBackground(Output *output);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_BACKGROUND_HH__
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/binary.hh"
+
+#include <cstring>
+#include <iostream>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/stats/info.hh"
+
+using namespace std;
+
+namespace Stats {
+
+Binary::Binary()
+    : stream(NULL), schemaDone(false)
+{
+}
+
+void
+Binary::open(std::ostream &_stream)
+{
+    if (stream)
+        panic("stream already set!");
+
+    stream = &_stream;
+    if (!valid())
+        fatal("Unable to open output stream for writing\n");
+}
+
+bool
+Binary::valid() const
+{
+    return stream != NULL && stream->good();
+}
+
+bool
+Binary::noOutput(const Info &info)
+{
+    return !info.flags.isSet(display);
+}
+
+void
+Binary::begin()
+{
+    row.clear();
+}
+
+void
+Binary::writeHeader()
+{
+    const uint32_t num_columns = columns.size();
+
+    stream->write("gem5stat", 8);
+    stream->write((const char *)&version, sizeof(version));
+    stream->write((const char *)&num_columns, sizeof(num_columns));
+    for (const auto &column : columns) {
+        const uint32_t len = column.size();
+        stream->write((const char *)&len, sizeof(len));
+        stream->write(column.data(), len);
+    }
+}
+
+void
+Binary::end()
+{
+    if (!schemaDone) {
+        writeHeader();
+        schemaDone = true;
+    }
+
+    panic_if(row.size() != columns.size(),
+             "Stats dump has %d values for %d binary stats columns\n",
+             row.size(), columns.size());
+
+    stream->write((const char *)row.data(), row.size() * sizeof(double));
+    stream->flush();
+}
+
+void
+Binary::visit(const ScalarInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    add(info.name, info.result());
+}
+
+void
+Binary::visit(const VectorInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    const VResult &vec = info.result();
+    const size_type size = info.size();
+
+    for (off_type i = 0; i < size; ++i) {
+        if (schemaDone) {
+            row.push_back(vec[i]);
+        } else {
+            bool has_subname = i < info.subnames.size() &&
+                !info.subnames[i].empty();
+            add(info.name + info.separatorString +
+                (has_subname ? info.subnames[i] : to_string(i)), vec[i]);
+        }
+    }
+
+    if (info.flags.isSet(::Stats::total) && size > 1) {
+        if (schemaDone)
+            row.push_back(info.total());
+        else
+            add(info.name + info.separatorString, "total", info.total());
+    }
+}
+
+void
+Binary::visit(const Vector2dInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    for (off_type i = 0; i < info.x; ++i) {
+        string x_name;
+        if (!schemaDone) {
+            bool has_subname = i < info.subnames.size() &&
+                !info.subnames[i].empty();
+            x_name = info.name + "_" +
+                (has_subname ? info.subnames[i] : to_string(i)) +
+                info.separatorString;
+        }
+
+        for (off_type j = 0; j < info.y; ++j) {
+            if (schemaDone) {
+                row.push_back(info.cvec[i * info.y + j]);
+            } else {
+                bool has_subname = j < info.y_subnames.size() &&
+                    !info.y_subnames[j].empty();
+                add(x_name +
+                    (has_subname ? info.y_subnames[j] : to_string(j)),
+                    info.cvec[i * info.y + j]);
+            }
+        }
+    }
+
+    if (info.flags.isSet(::Stats::total) && info.x > 1) {
+        if (schemaDone)
+            row.push_back(info.total());
+        else
+            add(info.name + info.separatorString, "total", info.total());
+    }
+}
+
+void
+Binary::addDist(const string &prefix, const DistData &data)
+{
+    add(prefix, "samples", data.samples);
+    add(prefix, "sum", data.sum);
+    add(prefix, "squares", data.squares);
+    add(prefix, "min_value", data.min_val);
+    add(prefix, "max_value", data.max_val);
+
+    if (data.type == Deviation)
+        return;
+
+    // Histograms change their bucket size as they grow, so keep it
+    // next to the bucket counts, which are named by index
+    add(prefix, "min", data.min);
+    add(prefix, "bucket_size", data.bucket_size);
+    add(prefix, "underflows", data.underflow);
+    for (off_type i = 0; i < data.cvec.size(); ++i) {
+        if (schemaDone)
+            row.push_back(data.cvec[i]);
+        else
+            add(prefix + to_string(i), data.cvec[i]);
+    }
+    add(prefix, "overflows", data.overflow);
+}
+
+void
+Binary::visit(const DistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    string prefix;
+    if (!schemaDone)
+        prefix = info.name + info.separatorString;
+    addDist(prefix, info.data);
+}
+
+void
+Binary::visit(const VectorDistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    for (off_type i = 0; i < info.size(); ++i) {
+        string prefix;
+        if (!schemaDone) {
+            bool has_subname = i < info.subnames.size() &&
+                !info.subnames[i].empty();
+            prefix = info.name + "_" +
+                (has_subname ? info.subnames[i] : to_string(i)) +
+                info.separatorString;
+        }
+        addDist(prefix, info.data[i]);
+    }
+}
+
+void
+Binary::visit(const FormulaInfo &info)
+{
+    visit((const VectorInfo &)info);
+}
+
+void
+Binary::visit(const SparseHistInfo &info)
+{
+    if (noOutput(info) || schemaDone)
+        return;
+
+    warn("Sparse histogram %s isn't written to binary stats\n", info.name);
+}
+
+Output *
+initBinary(const string &filename)
+{
+    static Binary binary;
+    static bool connected = false;
+
+    if (!connected) {
+        binary.open(*simout.findOrCreate(filename, true)->stream());
+        connected = true;
+    }
+
+    return &binary;
+}
+
+} // namespace Stats
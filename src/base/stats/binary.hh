@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace Stats {
+
+struct DistData;
+
+/**
+ * Binary, column oriented statistics output.
+ *
+ * Each dump is written as one row of doubles, one per column. The
+ * columns are the displayed stats, with one column per element of a
+ * vector or a distribution. Their names are collected during the
+ * first dump and written once in a header:
+ *
+ *   "gem5stat"                  8 byte magic
+ *   uint32_t version
+ *   uint32_t number of columns
+ *   for each column:
+ *     uint32_t length, char name[length]
+ *
+ * The rows follow, in host byte order, so that the file can be
+ * loaded with numpy.fromfile (see util/read_stats_binary.py).
+ *
+ * Unlike the text output, stats are never omitted because they are
+ * zero or because of a prerequisite, which keeps every row the same
+ * shape. Sparse histograms don't have a fixed shape and are skipped.
+ */
+class Binary : public Output
+{
+  protected:
+    static const uint32_t version = 1;
+
+    std::ostream *stream;
+
+    /** Have the header and the first row been written? */
+    bool schemaDone;
+    std::vector<std::string> columns;
+    std::vector<double> row;
+
+    bool noOutput(const Info &info);
+
+    /** Append a value, and its column name on the first dump */
+    void
+    add(const std::string &name, Result value)
+    {
+        if (!schemaDone)
+            columns.push_back(name);
+        row.push_back(value);
+    }
+
+    /** Same, naming the column prefix followed by suffix */
+    void
+    add(const std::string &prefix, const char *suffix, Result value)
+    {
+        if (!schemaDone)
+            columns.push_back(prefix + suffix);
+        row.push_back(value);
+    }
+
+    /** Add the columns of a distribution, whose names start with
+     *  prefix. prefix is only used, and only needs to be set, on the
+     *  first dump */
+    void addDist(const std::string &prefix, const DistData &data);
+
+    void writeHeader();
+
+  public:
+    Binary();
+
+    void open(std::ostream &stream);
+
+    // Implement Visit
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+    // Implement Output
+    bool valid() const override;
+    void begin() override;
+    void end() override;
+};
+
+Output *initBinary(const std::string &filename);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_BINARY_HH__
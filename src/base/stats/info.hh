@@ -66,6 +66,24 @@ const FlagsType __reserved =    init | display;
 struct StorageParams;
 struct Output;
 
+/**
+ * Where the counters of a stat live in memory, so that they can be
+ * read in place instead of being copied, e.g. through the Python
+ * buffer protocol. Only stats that store plain Counters have a view;
+ * data is nullptr for the others.
+ */
+struct CounterView
+{
+    /** The first counter */
+    const Counter *data;
+    /** The number of counters in each dimension */
+    std::vector<size_type> shape;
+    /** The distance between counters in bytes in each dimension */
+    std::vector<size_t> strides;
+
+    CounterView() : data(nullptr) {}
+};
+
 class Info
 {
   public:
@@ -91,6 +109,9 @@ class Info
   public:
     const StorageParams *storageParams;
 
+    /** Is this stat reset by StorageArena::zeroReset? */
+    bool resetByArena;
+
   public:
     Info();
     virtual ~Info();
@@ -133,6 +154,11 @@ class Info
      */
     virtual void visit(Output &visitor) = 0;
 
+    /**
+     * @return A view of the counters of this stat in memory
+     */
+    virtual CounterView counters() const { return CounterView(); }
+
     /**
      * Checks if the first stat's name is alphabetically less than the second.
      * This function breaks names up at periods and considers each subname
@@ -38,9 +38,11 @@
 #include <cctype>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
 
+#include "base/callback.hh"
 #include "base/debug.hh"
 #include "base/logging.hh"
 #include "base/output.hh"
@@ -87,6 +89,13 @@ setDebugLogger(Logger *logger)
         debug_logger = logger;
 }
 
+void
+flushOnError()
+{
+    if (debug_logger)
+        debug_logger->flushOnError();
+}
+
 void
 enable()
 {
@@ -157,4 +166,193 @@ OstreamLogger::logMessage(Tick when, const std::string &name,
     stream.flush();
 }
 
+namespace
+{
+
+/** Magic string and version at the start of a binary trace */
+const char binaryTraceMagic[8] = {'g', 'e', 'm', '5', 't', 'r', 'c', '\0'};
+const uint32_t binaryTraceVersion = 1;
+
+/** Guards the site table and the output stream of binary loggers */
+std::mutex binaryMutex;
+
+/** Format strings of all call sites, indexed by site id - 1 */
+std::vector<const char *> siteFormats;
+
+/** Ids of object names, shared by all threads */
+std::atomic<uint32_t> nextNameId(1);
+
+/** Call site used for preformatted messages */
+Site messageSite;
+
+thread_local BinaryLogger::Buffer *localBuf = nullptr;
+thread_local const BinaryLogger *localBufOwner = nullptr;
+
+class FlushBinaryLogger : public Callback
+{
+  protected:
+    BinaryLogger &logger;
+
+  public:
+    FlushBinaryLogger(BinaryLogger &_logger) : logger(_logger) { }
+    void process() override { logger.flushAll(); }
+};
+
+} // anonymous namespace
+
+BinaryLogger::BinaryLogger(std::ostream &stream_, size_t ring_size)
+    : stream(stream_), lineBuf(*this), lineStream(&lineBuf),
+      ringSize(ring_size),
+      bufferLimit(ring_size ? ring_size / 2 : flushThreshold),
+      sitesWritten(0)
+{
+    binary = this;
+    stream.write(binaryTraceMagic, sizeof(binaryTraceMagic));
+    stream.write((const char *)&binaryTraceVersion,
+                 sizeof(binaryTraceVersion));
+    registerExitCallback(new FlushBinaryLogger(*this));
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    flushAll();
+    for (auto buf : buffers)
+        delete buf;
+}
+
+BinaryLogger::Buffer &
+BinaryLogger::localBuffer()
+{
+    if (localBufOwner != this) {
+        localBuf = new Buffer;
+        localBuf->data.reserve(bufferLimit + 4096);
+        localBufOwner = this;
+
+        std::lock_guard<std::mutex> lock(binaryMutex);
+        buffers.push_back(localBuf);
+    }
+    return *localBuf;
+}
+
+uint32_t
+BinaryLogger::registerSite(Site &site, const char *fmt)
+{
+    std::lock_guard<std::mutex> lock(binaryMutex);
+    uint32_t id = site.id.load(std::memory_order_relaxed);
+    if (!id) {
+        siteFormats.push_back(fmt);
+        id = siteFormats.size();
+        site.id.store(id, std::memory_order_relaxed);
+    }
+    return id;
+}
+
+uint32_t
+BinaryLogger::nameId(Buffer &buf, const std::string &name)
+{
+    if (name.empty())
+        return 0;
+
+    // Most messages come from the same few objects in a row, so look
+    // for the name starting with the most recently used ones.
+    for (auto it = buf.names.rbegin(); it != buf.names.rend(); ++it) {
+        if (it->first == name) {
+            uint32_t id = it->second;
+            if (it != buf.names.rbegin())
+                std::swap(*it, buf.names.back());
+            return id;
+        }
+    }
+
+    uint32_t id = nextNameId++;
+    buf.names.emplace_back(name, id);
+    buf.put<char>('N');
+    buf.put<uint32_t>(id);
+    buf.putString(name.data(), name.size());
+    return id;
+}
+
+void
+BinaryLogger::flush(Buffer &buf)
+{
+    std::lock_guard<std::mutex> lock(binaryMutex);
+
+    // Sites are written before any buffer that could refer to them, so
+    // the trace can be decoded in a single pass.
+    for (; sitesWritten < siteFormats.size(); ++sitesWritten) {
+        const char *fmt = siteFormats[sitesWritten];
+        uint32_t id = sitesWritten + 1;
+        uint32_t len = strlen(fmt);
+        stream.put('S');
+        stream.write((const char *)&id, sizeof(id));
+        stream.write((const char *)&len, sizeof(len));
+        stream.write(fmt, len);
+    }
+
+    // The name registrations of a flight recorder may have been
+    // dropped along with old messages, so repeat them all.
+    if (ringSize) {
+        for (const auto &name : buf.names) {
+            uint32_t len = name.first.size();
+            stream.put('N');
+            stream.write((const char *)&name.second, sizeof(name.second));
+            stream.write((const char *)&len, sizeof(len));
+            stream.write(name.first.data(), len);
+        }
+        stream.write(buf.older.data(), buf.older.size());
+        buf.older.clear();
+    }
+
+    stream.write(buf.data.data(), buf.data.size());
+    stream.flush();
+    buf.data.clear();
+}
+
+void
+BinaryLogger::full(Buffer &buf)
+{
+    if (ringSize) {
+        buf.older.swap(buf.data);
+        buf.data.clear();
+    } else {
+        flush(buf);
+    }
+}
+
+void
+BinaryLogger::flushAll()
+{
+    std::vector<Buffer *> bufs;
+    {
+        std::lock_guard<std::mutex> lock(binaryMutex);
+        bufs = buffers;
+    }
+    for (auto buf : bufs)
+        flush(*buf);
+}
+
+void
+BinaryLogger::logMessage(Tick when, const std::string &name,
+                         const std::string &message)
+{
+    if (!name.empty() && ignore.match(name))
+        return;
+
+    record(messageSite, when, name, "%s", message);
+}
+
+int
+BinaryLogger::LineBuf::overflow(int c)
+{
+    if (c == traits_type::eof())
+        return traits_type::not_eof(c);
+
+    line.push_back(c);
+    if (c == '\n') {
+        logger.logMessage(MaxTick, std::string(), line);
+        line.clear();
+    }
+    return c;
+}
+
 } // namespace Trace
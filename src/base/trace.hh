@@ -36,7 +36,12 @@
 #ifndef __BASE_TRACE_HH__
 #define __BASE_TRACE_HH__
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "base/cprintf.hh"
 #include "base/debug.hh"
@@ -46,6 +51,20 @@
 
 namespace Trace {
 
+class BinaryLogger;
+
+/**
+ * A DPRINTF call site. Each site is a function-local static so that the
+ * binary logger can record its format string once and refer to it by
+ * id afterwards. The id is zero until the site is first recorded.
+ */
+struct Site
+{
+    std::atomic<uint32_t> id;
+
+    constexpr Site() : id(0) { }
+};
+
 /** Debug logging base class.  Handles formatting and outputting
  *  time/name/message messages */
 class Logger
@@ -54,7 +73,12 @@ class Logger
     /** Name match for objects to ignore */
     ObjectMatch ignore;
 
+    /** This logger, if it records raw arguments instead of text */
+    BinaryLogger *binary;
+
   public:
+    Logger() : binary(nullptr) { }
+
     /** Log a single message */
     template <typename ...Args>
     void dprintf(Tick when, const std::string &name, const char *fmt,
@@ -68,6 +92,14 @@ class Logger
         logMessage(when, name, line.str());
     }
 
+    /**
+     * Log a single message from a DPRINTF call site. A binary logger
+     * records the arguments without formatting them.
+     */
+    template <typename ...Args>
+    void dprintf(Site &site, Tick when, const std::string &name,
+                 const char *fmt, const Args &...args);
+
     /** Dump a block of data of length len */
     virtual void dump(Tick when, const std::string &name,
                       const void *d, int len);
@@ -86,6 +118,12 @@ class Logger
     /** Set objects to ignore */
     void setIgnore(ObjectMatch &ignore_) { ignore = ignore_; }
 
+    /**
+     * Write out anything that is still buffered, as the simulator is
+     * about to die.
+     */
+    virtual void flushOnError() { }
+
     virtual ~Logger() { }
 };
 
@@ -106,6 +144,253 @@ class OstreamLogger : public Logger
     std::ostream &getOstream() override { return stream; }
 };
 
+/**
+ * Logger that writes a compact binary trace instead of text. Each call
+ * site registers its format string once, and every message is then
+ * recorded as (tick, site id, name id, raw arguments) into a per-thread
+ * buffer that is written out whenever it fills up and at exit. The trace
+ * is turned back into text by util/decode_binary_trace.py, which
+ * produces the same output as OstreamLogger.
+ *
+ * Messages that don't come from a call site (e.g., dump() or text
+ * written to getOstream()) are recorded as preformatted strings.
+ *
+ * As a flight recorder, the logger only keeps the most recent messages
+ * of each thread in memory, and writes them out when the simulator
+ * exits, panics or crashes. Each thread's buffer is split in two
+ * halves: when the current half is full it replaces the older one,
+ * so at least half of the buffer always holds the latest messages.
+ */
+class BinaryLogger : public Logger
+{
+  public:
+    /** Per-thread record buffer and name table */
+    struct Buffer
+    {
+        std::vector<char> data;
+        /** Previous records, if the logger is a flight recorder */
+        std::vector<char> older;
+        std::vector<std::pair<std::string, uint32_t>> names;
+
+        void
+        put(const void *p, size_t len)
+        {
+            const char *c = static_cast<const char *>(p);
+            data.insert(data.end(), c, c + len);
+        }
+
+        template <typename T>
+        void
+        put(const T &val)
+        {
+            put(&val, sizeof(val));
+        }
+
+        void
+        putString(const char *s, size_t len)
+        {
+            put<uint32_t>(len);
+            put(s, len);
+        }
+    };
+
+    /** Buffer size at which records are written out */
+    static const size_t flushThreshold = 1 << 20;
+
+    /**
+     * @param stream_ Stream to write the trace to.
+     * @param ring_size Bytes of messages kept per thread, or 0 to
+     *                  write all messages out.
+     */
+    BinaryLogger(std::ostream &stream_, size_t ring_size = 0);
+    ~BinaryLogger();
+
+    template <typename ...Args>
+    void
+    record(Site &site, Tick when, const std::string &name, const char *fmt,
+           const Args &...args)
+    {
+        Buffer &buf = localBuffer();
+        uint32_t site_id = site.id.load(std::memory_order_relaxed);
+        if (!site_id)
+            site_id = registerSite(site, fmt);
+        uint32_t name_id = nameId(buf, name);
+
+        buf.put<char>('M');
+        buf.put<uint64_t>(when);
+        buf.put<uint32_t>(site_id);
+        buf.put<uint32_t>(name_id);
+        buf.put<uint8_t>(sizeof...(args));
+        putArgs(buf, args...);
+
+        if (buf.data.size() >= bufferLimit)
+            full(buf);
+    }
+
+    void logMessage(Tick when, const std::string &name,
+                    const std::string &message) override;
+
+    /**
+     * Text written to this stream is recorded as one raw message per
+     * line. Like the stream of OstreamLogger, it isn't thread safe.
+     */
+    std::ostream &getOstream() override { return lineStream; }
+
+    /** Write out the buffers of all threads */
+    void flushAll();
+
+    void flushOnError() override { flushAll(); }
+
+  protected:
+    /** Get the buffer of the calling thread */
+    Buffer &localBuffer();
+
+    /** Assign an id to a call site, unless another thread beat us to it */
+    uint32_t registerSite(Site &site, const char *fmt);
+
+    /** Get the id of an object name, registering it in buf if needed */
+    uint32_t nameId(Buffer &buf, const std::string &name);
+
+    /** Write out and clear a buffer */
+    void flush(Buffer &buf);
+
+    /** Make room in a buffer that reached bufferLimit */
+    void full(Buffer &buf);
+
+    static void putArgs(Buffer &buf) { }
+
+    template <typename T, typename ...Args>
+    static void
+    putArgs(Buffer &buf, const T &arg, const Args &...args)
+    {
+        putArg(buf, arg);
+        putArgs(buf, args...);
+    }
+
+    static void
+    putArg(Buffer &buf, char c)
+    {
+        buf.put<char>('c');
+        buf.put(c);
+    }
+
+    static void
+    putArg(Buffer &buf, bool b)
+    {
+        buf.put<char>('u');
+        buf.put<uint64_t>(b);
+    }
+
+    static void
+    putArg(Buffer &buf, const char *s)
+    {
+        buf.put<char>('s');
+        buf.putString(s, strlen(s));
+    }
+
+    static void
+    putArg(Buffer &buf, char *s)
+    {
+        putArg(buf, (const char *)s);
+    }
+
+    static void
+    putArg(Buffer &buf, const std::string &s)
+    {
+        buf.put<char>('s');
+        buf.putString(s.data(), s.size());
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value &&
+                                   std::is_signed<T>::value>::type
+    putArg(Buffer &buf, const T &val)
+    {
+        buf.put<char>('i');
+        buf.put<int64_t>(val);
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value &&
+                                   std::is_unsigned<T>::value>::type
+    putArg(Buffer &buf, const T &val)
+    {
+        buf.put<char>('u');
+        buf.put<uint64_t>(val);
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    putArg(Buffer &buf, const T &val)
+    {
+        buf.put<char>('f');
+        buf.put<double>(val);
+    }
+
+    template <typename T>
+    static void
+    putArg(Buffer &buf, T *ptr)
+    {
+        buf.put<char>('p');
+        buf.put<uint64_t>(reinterpret_cast<uintptr_t>(ptr));
+    }
+
+    /** Anything else is recorded as it would be printed */
+    template <typename T>
+    static typename std::enable_if<!std::is_arithmetic<T>::value>::type
+    putArg(Buffer &buf, const T &val)
+    {
+        std::ostringstream str;
+        str << val;
+        putArg(buf, str.str());
+    }
+
+    /** Turns text written to lineStream into messages */
+    class LineBuf : public std::streambuf
+    {
+      protected:
+        BinaryLogger &logger;
+        std::string line;
+
+        int overflow(int c) override;
+
+      public:
+        LineBuf(BinaryLogger &_logger) : logger(_logger) { }
+    };
+
+    std::ostream &stream;
+    LineBuf lineBuf;
+    std::ostream lineStream;
+
+    /** Bytes of messages kept per thread as a flight recorder, or 0 */
+    const size_t ringSize;
+    /** Buffer size at which full() is called */
+    const size_t bufferLimit;
+
+    /** Number of registered sites already written to stream */
+    size_t sitesWritten;
+    /** Buffers of all threads that have recorded a message */
+    std::vector<Buffer *> buffers;
+};
+
+template <typename ...Args>
+void
+Logger::dprintf(Site &site, Tick when, const std::string &name,
+                const char *fmt, const Args &...args)
+{
+    if (!name.empty() && ignore.match(name))
+        return;
+
+    if (binary) {
+        binary->record(site, when, name, fmt, args...);
+        return;
+    }
+
+    std::ostringstream line;
+    ccprintf(line, fmt, args...);
+    logMessage(when, name, line.str());
+}
+
 /** Get the current global debug logger.  This takes ownership of the given
  *  logger which should be allocated using 'new' */
 Logger *getDebugLogger();
@@ -116,6 +401,9 @@ std::ostream &output();
 /** Delete the current global logger and assign a new one */
 void setDebugLogger(Logger *logger);
 
+/** Flush the current global logger, if any, before dying */
+void flushOnError();
+
 /** Enable/disable debug logging */
 void enable();
 void disable();
@@ -172,7 +460,8 @@ class Named
 #define DPRINTF(x, ...) do {                                              \
     using namespace Debug;                                                \
     if (DTRACE(x)) {                                                      \
-        Trace::getDebugLogger()->dprintf(curTick(), name(),               \
+        static Trace::Site _trace_site;                                   \
+        Trace::getDebugLogger()->dprintf(_trace_site, curTick(), name(),  \
             __VA_ARGS__);                                                 \
     }                                                                     \
 } while (0)
@@ -180,16 +469,18 @@ class Named
 #define DPRINTFS(x, s, ...) do {                                          \
     using namespace Debug;                                                \
     if (DTRACE(x)) {                                                      \
-        Trace::getDebugLogger()->dprintf(curTick(), s->name(),            \
-            __VA_ARGS__);                                                 \
+        static Trace::Site _trace_site;                                   \
+        Trace::getDebugLogger()->dprintf(_trace_site, curTick(),          \
+            s->name(), __VA_ARGS__);                                      \
     }                                                                     \
 } while (0)
 
 #define DPRINTFR(x, ...) do {                                             \
     using namespace Debug;                                                \
     if (DTRACE(x)) {                                                      \
-        Trace::getDebugLogger()->dprintf((Tick)-1, std::string(),         \
-            __VA_ARGS__);                                                 \
+        static Trace::Site _trace_site;                                   \
+        Trace::getDebugLogger()->dprintf(_trace_site, (Tick)-1,           \
+            std::string(), __VA_ARGS__);                                  \
     }                                                                     \
 } while (0)
 
@@ -198,11 +489,15 @@ class Named
 } while (0)
 
 #define DPRINTFN(...) do {                                                \
-    Trace::getDebugLogger()->dprintf(curTick(), name(), __VA_ARGS__);     \
+    static Trace::Site _trace_site;                                       \
+    Trace::getDebugLogger()->dprintf(_trace_site, curTick(), name(),      \
+        __VA_ARGS__);                                                     \
 } while (0)
 
 #define DPRINTFNR(...) do {                                               \
-    Trace::getDebugLogger()->dprintf((Tick)-1, string(), __VA_ARGS__);    \
+    static Trace::Site _trace_site;                                       \
+    Trace::getDebugLogger()->dprintf(_trace_site, (Tick)-1, string(),     \
+        __VA_ARGS__);                                                     \
 } while (0)
 
 #else // !TRACING_ON
@@ -60,6 +60,7 @@ VncInput::VncInput(const Params *p)
       _videoWidth(fb->width()), _videoHeight(fb->height()),
       captureEnabled(p->frame_capture),
       captureCurrentFrame(0), captureLastHash(0),
+      captureLastVersion(0), captureLastFb(NULL),
       imgFormat(p->img_format)
 {
     if (captureEnabled) {
@@ -116,7 +117,12 @@ VncInput::captureFrameBuffer()
 {
     assert(captureImage);
 
-    // skip identical frames
+    // skip frames that haven't been touched, and then identical frames
+    if (fb == captureLastFb && !fb->changedSince(captureLastVersion))
+        return;
+    captureLastFb = fb;
+    captureLastVersion = fb->version();
+
     uint64_t new_hash = fb->getHash();
     if (captureLastHash == new_hash)
         return;
@@ -226,6 +226,15 @@ class VncInput : public SimObject
     /** Computed hash of the last captured frame */
     uint64_t captureLastHash;
 
+    /**
+     * Frame buffer version of the last captured frame, used to skip
+     * unchanged frames without hashing them.
+     */
+    uint64_t captureLastVersion;
+
+    /** Frame buffer the last captured frame came from */
+    const FrameBuffer *captureLastFb;
+
     /** Cached ImgWriter object for writing out frame buffers to file */
     std::unique_ptr<ImgWriter> captureImage;
 
@@ -59,9 +59,11 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstddef>
 #include <cstdio>
+#include <cstring>
 
 #include "base/atomicio.hh"
 #include "base/logging.hh"
@@ -121,8 +123,14 @@ VncServer::DataEvent::process(int revent)
 VncServer::VncServer(const Params *p)
     : VncInput(p), listenEvent(NULL), dataEvent(NULL), number(p->number),
       dataFd(-1), sendUpdate(false),
-      supportsRawEnc(false), supportsResizeEnc(false)
+      supportsRawEnc(false), supportsResizeEnc(false),
+      supportsZrleEnc(false), sentFb(NULL), sentVersion(0),
+      fullUpdate(true)
 {
+    memset(&zrleStream, 0, sizeof(zrleStream));
+    if (deflateInit(&zrleStream, Z_DEFAULT_COMPRESSION) != Z_OK)
+        panic("%s: Failed to initialize ZRLE stream\n", name());
+
     if (p->port)
         listen(p->port);
 
@@ -155,6 +163,8 @@ VncServer::~VncServer()
 
     if (dataEvent)
         delete dataEvent;
+
+    deflateEnd(&zrleStream);
 }
 
 
@@ -211,6 +221,11 @@ VncServer::accept()
 
     dataFd = fd;
 
+    // A new client hasn't seen anything yet, and starts with a fresh
+    // compression stream.
+    fullUpdate = true;
+    deflateReset(&zrleStream);
+
     // Send our version number to the client
     write((uint8_t *)vncVersion(), strlen(vncVersion()));
 
@@ -527,7 +542,7 @@ VncServer::setEncodings()
     pem.num_encodings = betoh(pem.num_encodings);
 
     DPRINTF(VNC, " -- %d encoding present\n", pem.num_encodings);
-    supportsRawEnc = supportsResizeEnc = false;
+    supportsRawEnc = supportsResizeEnc = supportsZrleEnc = false;
 
     for (int x = 0; x < pem.num_encodings; x++) {
         int32_t encoding;
@@ -542,6 +557,9 @@ VncServer::setEncodings()
           case EncodingDesktopSize:
             supportsResizeEnc = true;
             break;
+          case EncodingZRLE:
+            supportsZrleEnc = true;
+            break;
         }
     }
 
@@ -568,6 +586,13 @@ VncServer::requestFbUpdate()
     DPRINTF(VNC, " -- x = %d y = %d w = %d h = %d\n", fbr.x, fbr.y, fbr.width,
             fbr.height);
 
+    // The client lost track of the frame buffer contents and needs
+    // all of it.
+    if (!fbr.incremental) {
+        fullUpdate = true;
+        sendUpdate = true;
+    }
+
     sendFrameBufferUpdate();
 }
 
@@ -641,45 +666,133 @@ VncServer::sendFrameBufferUpdate()
     // The client will request data constantly, unless we throttle it
     sendUpdate = false;
 
-    DPRINTF(VNC, "Sending framebuffer update\n");
+    assert(fb);
 
-    FrameBufferUpdate fbu;
-    FrameBufferRect fbr;
+    std::vector<FrameBuffer::Rect> rects;
+    if (fullUpdate || fb != sentFb) {
+        rects.push_back(FrameBuffer::Rect{ 0, 0, fb->width(), fb->height() });
+    } else {
+        rects = fb->dirtyRects(sentVersion);
+    }
 
-    fbu.type = ServerFrameBufferUpdate;
-    fbu.num_rects = 1;
-    fbr.x = 0;
-    fbr.y = 0;
-    fbr.width = videoWidth();
-    fbr.height = videoHeight();
-    fbr.encoding = EncodingRaw;
+    if (rects.empty()) {
+        DPRINTF(VNC, "Frame buffer unchanged, skipping update\n");
+        return;
+    }
 
-    // fix up endian
-    fbu.num_rects = htobe(fbu.num_rects);
-    fbr.x = htobe(fbr.x);
-    fbr.y = htobe(fbr.y);
-    fbr.width = htobe(fbr.width);
-    fbr.height = htobe(fbr.height);
-    fbr.encoding = htobe(fbr.encoding);
+    DPRINTF(VNC, "Sending framebuffer update with %d rectangles\n",
+            rects.size());
 
-    // send headers to client
-    if (!write(&fbu) || !write(&fbr))
+    sentFb = fb;
+    sentVersion = fb->version();
+    fullUpdate = false;
+
+    FrameBufferUpdate fbu;
+    fbu.type = ServerFrameBufferUpdate;
+    fbu.num_rects = htobe((uint16_t)rects.size());
+    if (!write(&fbu))
         return;
 
-    assert(fb);
+    const int32_t encoding = supportsZrleEnc ? EncodingZRLE : EncodingRaw;
+    for (const auto &rect : rects) {
+        FrameBufferRect fbr;
+        fbr.x = htobe((uint16_t)rect.x);
+        fbr.y = htobe((uint16_t)rect.y);
+        fbr.width = htobe((uint16_t)rect.width);
+        fbr.height = htobe((uint16_t)rect.height);
+        fbr.encoding = htobe(encoding);
+
+        if (!write(&fbr))
+            return;
 
-    std::vector<uint8_t> line_buffer(pixelConverter.length * fb->width());
-    for (int y = 0; y < fb->height(); ++y) {
+        const bool ok = encoding == EncodingZRLE ?
+            sendRectZrle(rect) : sendRectRaw(rect);
+        if (!ok)
+            return;
+    }
+}
+
+bool
+VncServer::sendRectRaw(const FrameBuffer::Rect &rect)
+{
+    std::vector<uint8_t> line_buffer(pixelConverter.length * rect.width);
+    for (unsigned y = rect.y; y < rect.y + rect.height; ++y) {
         // Convert and send a line at a time
         uint8_t *raw_pixel(line_buffer.data());
-        for (unsigned x = 0; x < fb->width(); ++x) {
+        for (unsigned x = rect.x; x < rect.x + rect.width; ++x) {
             pixelConverter.fromPixel(raw_pixel, fb->pixel(x, y));
             raw_pixel += pixelConverter.length;
         }
 
         if (!write(line_buffer.data(), line_buffer.size()))
-            return;
+            return false;
     }
+
+    return true;
+}
+
+bool
+VncServer::sendRectZrle(const FrameBuffer::Rect &rect)
+{
+    // ZRLE splits the rectangle into 64x64 tiles, which are either
+    // raw or a single solid colour. Pixels are sent as 3 byte CPIXELs
+    // since our pixel format has 24 bits of colour in the least
+    // significant bytes of a little endian word.
+    static const unsigned ZrleTileSize = 64;
+    static const unsigned CPixelLength = 3;
+    assert(pixelConverter.length == 4 && pixelConverter.depth <= 24 &&
+           pixelConverter.byte_order == LittleEndianByteOrder);
+
+    zrleRaw.clear();
+    uint8_t cpixel[4];
+    for (unsigned ty = rect.y; ty < rect.y + rect.height;
+         ty += ZrleTileSize) {
+        const unsigned th = std::min(ZrleTileSize, rect.y + rect.height - ty);
+        for (unsigned tx = rect.x; tx < rect.x + rect.width;
+             tx += ZrleTileSize) {
+            const unsigned tw =
+                std::min(ZrleTileSize, rect.x + rect.width - tx);
+
+            const Pixel &first(fb->pixel(tx, ty));
+            bool solid = true;
+            for (unsigned y = ty; y < ty + th && solid; ++y) {
+                for (unsigned x = tx; x < tx + tw && solid; ++x)
+                    solid = fb->pixel(x, y) == first;
+            }
+
+            if (solid) {
+                zrleRaw.push_back(1);
+                pixelConverter.fromPixel(cpixel, first);
+                zrleRaw.insert(zrleRaw.end(), cpixel, cpixel + CPixelLength);
+                continue;
+            }
+
+            zrleRaw.push_back(0);
+            for (unsigned y = ty; y < ty + th; ++y) {
+                for (unsigned x = tx; x < tx + tw; ++x) {
+                    pixelConverter.fromPixel(cpixel, fb->pixel(x, y));
+                    zrleRaw.insert(zrleRaw.end(), cpixel,
+                                   cpixel + CPixelLength);
+                }
+            }
+        }
+    }
+
+    zrleOut.resize(deflateBound(&zrleStream, zrleRaw.size()) + 64);
+    zrleStream.next_in = zrleRaw.data();
+    zrleStream.avail_in = zrleRaw.size();
+    zrleStream.next_out = zrleOut.data();
+    zrleStream.avail_out = zrleOut.size();
+    if (deflate(&zrleStream, Z_SYNC_FLUSH) != Z_OK ||
+        zrleStream.avail_in != 0) {
+        warn("%s: ZRLE compression failed\n", name());
+        detach();
+        return false;
+    }
+
+    const uint32_t length = zrleOut.size() - zrleStream.avail_out;
+    const uint32_t be_length = htobe(length);
+    return write(&be_length) && write(zrleOut.data(), length);
 }
 
 void
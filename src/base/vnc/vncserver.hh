@@ -45,7 +45,10 @@
 #ifndef __BASE_VNC_VNC_SERVER_HH__
 #define __BASE_VNC_VNC_SERVER_HH__
 
+#include <zlib.h>
+
 #include <iostream>
+#include <vector>
 
 #include "base/vnc/vncinput.hh"
 #include "base/circlebuf.hh"
@@ -86,6 +89,7 @@ class VncServer : public VncInput
         EncodingRaw         = 0,
         EncodingCopyRect    = 1,
         EncodingHextile     = 5,
+        EncodingZRLE        = 16,
         EncodingDesktopSize = -223
     };
 
@@ -202,6 +206,29 @@ class VncServer : public VncInput
     /** If the vnc client supports the desktop resize command */
     bool supportsResizeEnc;
 
+    /** If the vnc client supports ZRLE encoding */
+    bool supportsZrleEnc;
+
+    /** @{ */
+    /**
+     * What the client has seen. Only the parts of the frame buffer
+     * that changed since version sentVersion of frame buffer sentFb
+     * need to be sent, unless the client asked for a full update.
+     */
+    const FrameBuffer *sentFb;
+    uint64_t sentVersion;
+    bool fullUpdate;
+    /** @} */
+
+    /**
+     * ZRLE compression stream. There is one stream per connection,
+     * and the client keeps its state across rectangles.
+     */
+    z_stream zrleStream;
+    /** Buffers for the ZRLE encoder */
+    std::vector<uint8_t> zrleRaw;
+    std::vector<uint8_t> zrleOut;
+
   protected:
     /**
      * vnc client Interface
@@ -272,11 +299,23 @@ class VncServer : public VncInput
      */
     void sendError(std::string error_msg);
 
-    /** Send a updated frame buffer to the client.
-     * @todo this doesn't do anything smart and just sends the entire image
+    /** Send the parts of the frame buffer that changed since the last
+     * update to the client. Nothing is sent if nothing changed.
      */
     void sendFrameBufferUpdate();
 
+    /** Send the pixels of a rectangle using raw encoding
+     * @param rect rectangle to send
+     * @return whether the write was successful
+     */
+    bool sendRectRaw(const FrameBuffer::Rect &rect);
+
+    /** Send the pixels of a rectangle using ZRLE encoding
+     * @param rect rectangle to send
+     * @return whether the write was successful
+     */
+    bool sendRectZrle(const FrameBuffer::Rect &rect);
+
     /** Receive pixel foramt message from client and process it. */
     void setPixelFormat();
 
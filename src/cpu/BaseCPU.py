@@ -109,6 +109,7 @@ class BaseCPU(MemObject):
         PyBindMethod("takeOverFrom"),
         PyBindMethod("switchedOut"),
         PyBindMethod("flushTLBs"),
+        PyBindMethod("warmCaches"),
         PyBindMethod("totalInsts"),
         PyBindMethod("scheduleInstStop"),
         PyBindMethod("scheduleLoadStop"),
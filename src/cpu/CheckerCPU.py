@@ -38,3 +38,10 @@ class CheckerCPU(BaseCPU):
         "Update the checker with the main CPU's state on an error")
     warnOnlyOnLoadError = Param.Bool(True,
         "If a load result is incorrect, only print a warning and do not exit")
+    sampleWindow = Param.Unsigned(0,
+        "Only verify windows of this many instructions, resynchronising "
+        "with the main CPU at the start of each window (0 verifies every "
+        "instruction)")
+    samplePeriod = Param.Unsigned(100000,
+        "Mean number of instructions between the starts of two windows "
+        "when sampling")
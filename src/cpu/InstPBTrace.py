@@ -35,3 +35,7 @@ class InstPBTrace(InstTracer):
     cxx_class = 'Trace::InstPBTrace'
     cxx_header = 'cpu/inst_pb_trace.hh'
     file_name = Param.String("Instruction trace output file")
+    micro_ops = Param.Bool(False, "Record every micro-op rather than " \
+                           "only macro-ops")
+    reg_writes = Param.Bool(False, "Record the registers written by " \
+                            "each instruction and their values")
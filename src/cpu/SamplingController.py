@@ -0,0 +1,66 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.SimObject import *
+
+class SamplingController(SimObject):
+    """Phase sequencer and CPI estimator for statistical sampling.
+
+    Sampling alternates between functional warming on the functional
+    CPUs, and detailed warming followed by a measurement interval on
+    the detailed CPUs. m5.sample() runs the loop and switches CPUs
+    between the phases. All lengths are in instructions committed by
+    the first CPU of the list that runs the phase.
+    """
+    type = 'SamplingController'
+    cxx_header = "cpu/sampling_controller.hh"
+
+    cxx_exports = [
+        PyBindMethod("nextPhase"),
+        PyBindMethod("startPhase"),
+    ]
+
+    functional_cpus = VectorParam.BaseCPU("CPUs used for functional warming")
+    detailed_cpus = VectorParam.BaseCPU(
+        "CPUs used for detailed warming and measurement")
+
+    functional_warming = Param.Counter(2000000,
+        "Instructions of functional warming before each sample")
+    detailed_warming = Param.Counter(2000,
+        "Instructions of detailed warming before each measurement")
+    measurement = Param.Counter(1000,
+        "Instructions measured in each sample")
+
+    target_error = Param.Float(0.03,
+        "Stop once the confidence interval of the mean CPI is within this "
+        "fraction of the mean")
+    confidence_z = Param.Float(3.0,
+        "z-score of the confidence level (3.0 for 99.7%)")
+    min_samples = Param.Unsigned(30,
+        "Samples to take before checking the target error")
+    max_samples = Param.Unsigned(0,
+        "Stop after this many samples (0 for no limit)")
@@ -53,6 +53,7 @@
 
 #include "arch/generic/tlb.hh"
 #include "base/cprintf.hh"
+#include "base/intmath.hh"
 #include "base/loader/symtab.hh"
 #include "base/logging.hh"
 #include "base/output.hh"
@@ -731,6 +732,28 @@ BaseCPU::flushTLBs()
     }
 }
 
+void
+BaseCPU::warmCaches(const std::vector<Addr> &pages)
+{
+    fatal_if(!system->isAtomicMode(),
+             "%s: Caches can only be warmed in atomic mode.\n", name());
+    fatal_if(switchedOut(),
+             "%s: Can't warm caches from a switched out CPU.\n", name());
+
+    const unsigned line_size = cacheLineSize();
+    std::vector<uint8_t> buf(line_size);
+    for (const Addr page : pages) {
+        const Addr base = roundDown(page, TheISA::PageBytes);
+        for (Addr addr = base; addr < base + TheISA::PageBytes;
+             addr += line_size) {
+            Request req(addr, line_size, 0, dataMasterId());
+            Packet pkt(&req, MemCmd::ReadReq);
+            pkt.dataStatic(buf.data());
+            getDataPort().sendAtomic(&pkt);
+        }
+    }
+}
+
 void
 BaseCPU::processProfileEvent()
 {
@@ -346,6 +346,20 @@ class BaseCPU : public MemObject
      */
     void flushTLBs();
 
+    /**
+     * Warm the caches below this CPU by reading every cache line of
+     * the given physical pages through the data port.
+     *
+     * The reads are sent as atomic accesses, so this must only be
+     * called while the system is in atomic mode and the CPU is
+     * active, e.g., right after switching from a KVM CPU to an
+     * atomic CPU. Pages are read in order, so the last pages in the
+     * list end up as the most recently used lines.
+     *
+     * @param pages Physical page addresses to read.
+     */
+    void warmCaches(const std::vector<Addr> &pages);
+
     /**
      * Determine if the CPU is switched out.
      *
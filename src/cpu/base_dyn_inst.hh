@@ -54,6 +54,7 @@
 
 #include "arch/generic/tlb.hh"
 #include "arch/utility.hh"
+#include "base/index_ring.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
@@ -88,8 +89,8 @@ class BaseDynInst : public ExecContext, public RefCounted
     typedef typename Impl::DynInstPtr DynInstPtr;
     typedef RefCountingPtr<BaseDynInst<Impl> > BaseDynInstPtr;
 
-    // The list of instructions iterator type.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    // The index type of the list of instructions.
+    typedef typename IndexRing<DynInstPtr>::Index ListIdx;
 
     enum {
         MaxInstSrcRegs = TheISA::MaxInstSrcRegs,        /// Max source regs
@@ -184,8 +185,8 @@ class BaseDynInst : public ExecContext, public RefCounted
     /** The thread this instruction is from. */
     ThreadID threadNumber;
 
-    /** Iterator pointing to this BaseDynInst in the list of all insts. */
-    ListIt instListIt;
+    /** Index of this BaseDynInst in the list of all insts. */
+    ListIdx instListIdx;
 
     ////////////////////// Branch Data ///////////////
     /** Predicted PC state after this instruction. */
@@ -862,11 +863,11 @@ class BaseDynInst : public ExecContext, public RefCounted
     /** Has this instruction generated a memory request. */
     bool hasRequest() { return instFlags[ReqMade]; }
 
-    /** Returns iterator to this instruction in the list of all insts. */
-    ListIt &getInstListIt() { return instListIt; }
+    /** Returns the index of this instruction in the list of all insts. */
+    ListIdx getInstListIdx() const { return instListIdx; }
 
-    /** Sets iterator for this instruction in the list of all insts. */
-    void setInstListIt(ListIt _instListIt) { instListIt = _instListIt; }
+    /** Sets the index of this instruction in the list of all insts. */
+    void setInstListIdx(ListIdx _instListIdx) { instListIdx = _instListIdx; }
 
   public:
     /** Returns the number of consecutive store conditional failures. */
@@ -922,9 +923,10 @@ BaseDynInst<Impl>::initiateMemRead(Addr addr, unsigned size,
 
             if (cpu->checker) {
                 if (reqToVerify != NULL) {
-                    delete reqToVerify;
+                    *reqToVerify = *req;
+                } else {
+                    reqToVerify = new Request(*req);
                 }
-                reqToVerify = new Request(*req);
             }
             fault = cpu->read(req, sreqLow, sreqHigh, lqIdx);
         } else {
@@ -977,9 +979,10 @@ BaseDynInst<Impl>::writeMem(uint8_t *data, unsigned size, Addr addr,
 
         if (cpu->checker) {
             if (reqToVerify != NULL) {
-                delete reqToVerify;
+                *reqToVerify = *req;
+            } else {
+                reqToVerify = new Request(*req);
             }
-            reqToVerify = new Request(*req);
         }
         fault = cpu->write(req, sreqLow, sreqHigh, data, sqIdx);
     }
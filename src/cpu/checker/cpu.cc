@@ -49,6 +49,7 @@
 #include "arch/generic/tlb.hh"
 #include "arch/kernel_stats.hh"
 #include "arch/vtophys.hh"
+#include "base/random.hh"
 #include "cpu/base.hh"
 #include "cpu/simple_thread.hh"
 #include "cpu/static_inst.hh"
@@ -88,12 +89,64 @@ CheckerCPU::CheckerCPU(Params *p)
     workload = p->workload;
 
     updateOnError = true;
+
+    sampleWindow = p->sampleWindow;
+    samplePeriod = p->samplePeriod;
+    fatal_if(sampling() && samplePeriod < sampleWindow,
+             "%s: samplePeriod (%d) is shorter than sampleWindow (%d)\n",
+             name(), samplePeriod, sampleWindow);
+    // The checker starts in sync with the main CPU
+    inWindow = true;
+    windowInsts = 0;
+    skipInsts = 0;
 }
 
 CheckerCPU::~CheckerCPU()
 {
 }
 
+void
+CheckerCPU::regStats()
+{
+    BaseCPU::regStats();
+
+    numVerifiedInsts
+        .name(name() + ".numVerifiedInsts")
+        .desc("Number of instructions verified")
+        ;
+
+    numSkippedInsts
+        .name(name() + ".numSkippedInsts")
+        .desc("Number of instructions skipped between sampled windows")
+        ;
+
+    numWindows
+        .name(name() + ".numWindows")
+        .desc("Number of sampled windows started by resynchronising")
+        ;
+
+    verifiedCoverage
+        .name(name() + ".verifiedCoverage")
+        .desc("Fraction of the committed instructions that were verified")
+        .precision(6)
+        ;
+    verifiedCoverage =
+        numVerifiedInsts / (numVerifiedInsts + numSkippedInsts);
+}
+
+void
+CheckerCPU::endWindow()
+{
+    inWindow = false;
+    windowInsts = 0;
+    // Gaps are uniformly distributed so that windows start every
+    // samplePeriod instructions on average
+    skipInsts = random_mt.random<Counter>(
+        0, 2 * (Counter)(samplePeriod - sampleWindow));
+    DPRINTF(Checker, "Ending window, skipping %d instructions\n",
+            skipInsts);
+}
+
 void
 CheckerCPU::setSystem(System *system)
 {
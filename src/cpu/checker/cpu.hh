@@ -181,6 +181,8 @@ class CheckerCPU : public BaseCPU, public ExecContext
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 
+    void regStats() override;
+
     // The register accessor methods provide the index of the
     // instruction's operand (e.g., 0 or 1), not the architectural
     // register index, to simplify the implementation of register
@@ -551,6 +553,35 @@ class CheckerCPU : public BaseCPU, public ExecContext
     bool warnOnlyOnLoadError;
 
     InstSeqNum youngestSN;
+
+    /**
+     * @{
+     * Sampled verification.  Instructions are only verified in windows
+     * of sampleWindow instructions, which start on average every
+     * samplePeriod instructions.  Between windows the checker skips
+     * instructions, and it copies the main CPU's state before the first
+     * instruction of the next one.
+     */
+    unsigned sampleWindow;
+    unsigned samplePeriod;
+    /** Is the checker in sync with the main CPU? */
+    bool inWindow;
+    /** Instructions verified in the current window */
+    unsigned windowInsts;
+    /** Instructions to skip before the next window */
+    Counter skipInsts;
+    /** @} */
+
+    /** Is sampled verification enabled? */
+    bool sampling() const { return sampleWindow != 0; }
+
+    /** Close the current window and pick the length of the gap */
+    void endWindow();
+
+    Stats::Scalar numVerifiedInsts;
+    Stats::Scalar numSkippedInsts;
+    Stats::Scalar numWindows;
+    Stats::Formula verifiedCoverage;
 };
 
 /**
@@ -585,6 +616,13 @@ class Checker : public CheckerCPU
                     int start_idx);
     void handlePendingInt();
 
+    /**
+     * Skip a committed instruction between two sampled windows, and
+     * start the next window after it if it is time to and the main
+     * CPU's state is known to be in sync with its commit.
+     */
+    void skipInst(DynInstPtr &inst);
+
   private:
     void handleError(DynInstPtr &inst)
     {
@@ -128,6 +128,11 @@ Checker<Impl>::verify(DynInstPtr &completed_inst)
 {
     DynInstPtr inst;
 
+    if (sampling() && !inWindow) {
+        skipInst(completed_inst);
+        return;
+    }
+
     // Make sure serializing instructions are actually
     // seen as serializing to commit. instList should be
     // empty in these cases.
@@ -414,7 +419,7 @@ Checker<Impl>::verify(DynInstPtr &completed_inst)
             int count = 0;
             do {
                 oldpc = thread->instAddr();
-                system->pcEventQueue.service(tc);
+                system->pcEventQueue.service(oldpc, tc);
                 count++;
             } while (oldpc != thread->instAddr());
             if (count > 1) {
@@ -428,6 +433,16 @@ Checker<Impl>::verify(DynInstPtr &completed_inst)
         // that have been modified).
         validateState();
 
+        numVerifiedInsts++;
+
+        // Close a sampled window once it's long enough and nothing is
+        // left waiting in instList
+        if (sampling() && ++windowInsts >= sampleWindow &&
+            instList.empty()) {
+            endWindow();
+            break;
+        }
+
         // Continue verifying instructions if there's another completed
         // instruction waiting to be verified.
         if (instList.empty()) {
@@ -443,6 +458,54 @@ Checker<Impl>::verify(DynInstPtr &completed_inst)
     unverifiedInst = NULL;
 }
 
+template <class Impl>
+void
+Checker<Impl>::skipInst(DynInstPtr &inst)
+{
+    // Stores that complete after they commit may be reported twice
+    if (youngestSN >= inst->seqNum)
+        return;
+    youngestSN = inst->seqNum;
+    numSkippedInsts++;
+
+    if (skipInsts > 0) {
+        skipInsts--;
+        return;
+    }
+
+    // The main CPU's committed state only includes all of this
+    // instruction's effects if it has completed without a fault, and
+    // it must not leave the checker in the middle of a macroop.
+    // Memory references may have stores still waiting to be written
+    // back, so wait for another instruction.
+    if (!inst->isCompleted() || inst->isMemRef() ||
+        inst->getFault() != NoFault ||
+        (inst->isMicroop() && !inst->isLastMicroop())) {
+        return;
+    }
+
+    DPRINTF(Checker, "Starting window after [sn:%lli] PC:%s\n",
+            inst->seqNum, inst->pcState());
+
+    // Same dance as in validateState to copy all registers
+    bool no_squash_from_TC = inst->thread->noSquashFromTC;
+    inst->thread->noSquashFromTC = true;
+    thread->copyArchRegs(inst->tcBase());
+    inst->thread->noSquashFromTC = no_squash_from_TC;
+
+    // Commit hasn't moved the main CPU's PC past the instruction yet
+    TheISA::PCState pc_state = inst->pcState();
+    TheISA::advancePC(pc_state, inst->staticInst);
+    thread->pcState(pc_state);
+
+    thread->decoder.reset();
+    curMacroStaticInst = StaticInst::nullStaticInstPtr;
+    changedPC = willChangePC = false;
+
+    inWindow = true;
+    numWindows++;
+}
+
 template <class Impl>
 void
 Checker<Impl>::switchOut()
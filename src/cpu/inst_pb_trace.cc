@@ -39,14 +39,18 @@
 
 #include "cpu/inst_pb_trace.hh"
 
+#include <cstring>
+
 #include "base/callback.hh"
 #include "base/output.hh"
 #include "config/the_isa.hh"
 #include "cpu/static_inst.hh"
 #include "cpu/thread_context.hh"
 #include "debug/ExecEnable.hh"
+#include "mem/fs_translating_port_proxy.hh"
 #include "params/InstPBTrace.hh"
 #include "proto/inst.pb.h"
+#include "sim/byteswap.hh"
 #include "sim/core.hh"
 
 namespace Trace {
@@ -56,9 +60,9 @@ ProtoOutputStream *InstPBTrace::traceStream;
 void
 InstPBTraceRecord::dump()
 {
-    // We're trying to build an instruction trace so we just want macro-ops and
+    // Unless we're tracing micro-ops we just want macro-ops and
     // instructions that aren't macro-oped
-    if ((macroStaticInst && staticInst->isFirstMicroop()) ||
+    if (tracer.microOps || (macroStaticInst && staticInst->isFirstMicroop()) ||
             !staticInst->isMicroop()) {
         tracer.traceInst(thread, staticInst, pc);
     }
@@ -66,10 +70,14 @@ InstPBTraceRecord::dump()
     // If this instruction accessed memory lets record it
     if (getMemValid())
         tracer.traceMem(staticInst, getAddr(), getSize(), getFlags());
+
+    if (tracer.regWrites)
+        tracer.traceRegWrites(thread, staticInst);
 }
 
 InstPBTrace::InstPBTrace(const InstPBTraceParams *p)
-    : InstTracer(p), curMsg(nullptr)
+    : InstTracer(p), curMsg(nullptr),
+      microOps(p->micro_ops), regWrites(p->reg_writes)
 {
     // Create our output file
     createTraceFile(p->file_name);
@@ -87,7 +95,7 @@ InstPBTrace::createTraceFile(std::string filename)
     // Output the header
     ProtoMessage::InstHeader header_msg;
     header_msg.set_obj_id("gem5 generated instruction trace");
-    header_msg.set_ver(0);
+    header_msg.set_ver(1);
     header_msg.set_tick_freq(SimClock::Frequency);
     header_msg.set_has_mem(true);
     traceStream->write(header_msg);
@@ -144,12 +152,28 @@ InstPBTrace::traceInst(ThreadContext *tc, StaticInstPtr si, TheISA::PCState pc)
     // Create a new instruction message and fill out the fields
     curMsg = new ProtoMessage::Inst;
     curMsg->set_pc(pc.pc());
-    curMsg->set_inst(static_cast<uint32_t>(bits(si->machInst, 31, 0)));
     curMsg->set_cpuid(tc->cpuId());
     curMsg->set_tick(curTick());
     curMsg->set_type(static_cast<ProtoMessage::Inst_InstType>(si->opClass()));
+
+#if THE_ISA == X86_ISA
+    // x86 instructions are up to 15 bytes long and ExtMachInst is already
+    // decoded, so read the encoding back from memory for the offline
+    // decoder. Only the first micro-op carries all of it.
+    uint8_t inst_bytes[16] = {};
+    tc->getVirtProxy().readBlob(pc.pc(), inst_bytes, pc.size());
+    uint32_t inst_word;
+    std::memcpy(&inst_word, inst_bytes, sizeof(inst_word));
+    curMsg->set_inst(letoh(inst_word));
+    if (pc.microPC() == 0)
+        curMsg->set_inst_bytes(inst_bytes, pc.size());
+#else
+    curMsg->set_inst(static_cast<uint32_t>(bits(si->machInst, 31, 0)));
     curMsg->set_inst_flags(bits(si->machInst, 7, 0));
+#endif
 
+    if (microOps)
+        curMsg->set_upc(pc.microPC());
 }
 
 void
@@ -167,6 +191,38 @@ InstPBTrace::traceMem(StaticInstPtr si, Addr a, Addr s, unsigned f)
 
 }
 
+void
+InstPBTrace::traceRegWrites(ThreadContext *tc, StaticInstPtr si)
+{
+    panic_if(!curMsg, "Register write w/o msg?!");
+
+    for (int i = 0; i < si->numDestRegs(); i++) {
+        const RegId reg = tc->flattenRegId(si->destRegIdx(i));
+        if (reg.isZeroReg())
+            continue;
+
+        ProtoMessage::Inst::RegWrite *reg_msg = curMsg->add_reg_write();
+        reg_msg->set_reg_class(reg.classValue());
+        reg_msg->set_reg_index(reg.index());
+        switch (reg.classValue()) {
+          case IntRegClass:
+            reg_msg->set_value(tc->readIntRegFlat(reg.index()));
+            break;
+          case FloatRegClass:
+            reg_msg->set_value(tc->readFloatRegBitsFlat(reg.index()));
+            break;
+          case CCRegClass:
+            reg_msg->set_value(tc->readCCRegFlat(reg.index()));
+            break;
+          case MiscRegClass:
+            reg_msg->set_value(tc->readMiscRegNoEffect(reg.index()));
+            break;
+          default:
+            break;
+        }
+    }
+}
+
 } // namespace Trace
 
 
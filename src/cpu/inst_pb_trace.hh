@@ -59,7 +59,8 @@ namespace Trace {
 /**
  * This in an instruction tracer that records the flow of instructions through
  * multiple cpus and systems to a protobuf file specified by proto/inst.proto
- * for further analysis.
+ * for further analysis. It is a much cheaper alternative to the Exec text
+ * trace, as it leaves disassembly to util/decode_inst_trace.py.
  */
 
 class InstPBTraceRecord : public InstRecord
@@ -104,6 +105,12 @@ class InstPBTrace : public InstTracer
      */
     ProtoMessage::Inst *curMsg;
 
+    /** Record every micro-op rather than only macro-ops */
+    const bool microOps;
+
+    /** Record the registers written by each instruction */
+    const bool regWrites;
+
     /** Create the output file and write the header into it
      * @param filename the file to create (if ends with .gz it will be
      * compressed)
@@ -129,6 +136,13 @@ class InstPBTrace : public InstTracer
      */
     void traceMem(StaticInstPtr si, Addr a, Addr s, unsigned f);
 
+    /** Add the registers written by an instruction, and their values, to
+     * the current instruction
+     * @param tc thread context to read the values from
+     * @param si for the destination registers
+     */
+    void traceRegWrites(ThreadContext *tc, StaticInstPtr si);
+
     friend class InstPBTraceRecord;
 };
 } // namespace Trace
@@ -38,7 +38,7 @@
 from m5.params import *
 from m5.proxy import *
 
-from m5.SimObject import SimObject
+from m5.SimObject import SimObject, PyBindMethod
 
 class KvmVM(SimObject):
     type = 'KvmVM'
@@ -46,3 +46,22 @@ class KvmVM(SimObject):
 
     coalescedMMIO = \
       VectorParam.AddrRange([], "memory ranges for coalesced MMIO")
+    coalesceDeviceWrites = Param.Bool(False,
+        "Let devices coalesce writes to some of their registers "
+        "(requires useCoalescedMMIO in all KVM CPUs)")
+    useIOEventFDs = Param.Bool(True,
+        "Let devices be notified of doorbell writes through eventfds "
+        "rather than MMIO exits")
+
+    cxx_exports = [
+        PyBindMethod("recentDirtyPages"),
+    ]
+
+    # Dirty page logging records the guest pages written while running
+    # in KVM, so that they can be used to warm caches before switching
+    # to a simulated CPU (see m5.warmCachesFromKvm()).
+    dirtyPageLog = Param.Bool(False, "Log the guest pages written by vCPUs")
+    dirtyPageLogPeriod = Param.Latency('10ms',
+        "How often to collect the dirty page log")
+    dirtyPageLogSize = Param.Unsigned(262144,
+        "Number of recently written pages to remember")
@@ -161,6 +161,9 @@ BaseKvmCPU::startup()
     } else {
         inform("KVM: Coalesced not supported by host OS\n");
     }
+    fatal_if(vm.coalesceDeviceWrites && !mmioRing,
+             "%s: Devices coalesce MMIO writes, but this CPU doesn't "
+             "handle coalesced MMIO.\n", name());
 
     thread->startup();
 
@@ -822,7 +825,10 @@ BaseKvmCPU::kvmRun(Tick ticks)
 
     ++numVMExits;
 
-    return ticksExecuted + flushCoalescedMMIO();
+    const Tick mmio_ticks = flushCoalescedMMIO();
+    vm.serviceIOEventFDs(deviceEventQueue());
+
+    return ticksExecuted + mmio_ticks;
 }
 
 void
@@ -1192,10 +1198,16 @@ BaseKvmCPU::flushCoalescedMMIO()
     if (!mmioRing)
         return 0;
 
+    if (mmioRing->first == mmioRing->last)
+        return 0;
+
     DPRINTF(KvmIO, "KVM: Flushing the coalesced MMIO ring buffer\n");
 
-    // TODO: We might need to do synchronization when we start to
-    // support multiple CPUs
+    // Migrate to the device event queue once for the whole batch
+    // rather than once per access (see doMMIOAccess()). This matters
+    // when the vCPU runs on its own event queue.
+    EventQueue::ScopedMigration migrate(deviceEventQueue());
+
     Tick ticks(0);
     while (mmioRing->first != mmioRing->last) {
         struct kvm_coalesced_mmio &ent(
@@ -160,6 +160,17 @@ class PerfKvmCounterConfig
         return *this;
     }
 
+    /**
+     * Exclude events from the kernel, which also allows
+     * unprivileged users to count events.
+     *
+     * @param val true to exclude kernel events
+     */
+    PerfKvmCounterConfig &exclude_kernel(bool val) {
+        attr.exclude_kernel = val;
+        return *this;
+    }
+
     /** Underlying perf_event_attr structure describing the counter */
     struct perf_event_attr attr;
 };
@@ -223,6 +234,20 @@ public:
         attach(config, tid, parent.fd);
     }
 
+    /**
+     * Attach a counter, or a member of an existing counter group if
+     * parent is given, if the host allows it.
+     *
+     * @param config Counter configuration
+     * @param tid Thread to sample (0 indicates current thread)
+     * @param parent Group leader, or nullptr to create a new group
+     * @return false if the counter could not be attached
+     */
+    bool tryAttach(PerfKvmCounterConfig &config, pid_t tid,
+                   const PerfKvmCounter *parent = nullptr) {
+        return tryAttach(config, tid, parent ? parent->fd : -1);
+    }
+
     /** Detach a counter from PerfEvent. */
     void detach();
 
@@ -306,6 +331,7 @@ private:
     PerfKvmCounter &operator=(const PerfKvmCounter &that);
 
     void attach(PerfKvmCounterConfig &config, pid_t tid, int group_fd);
+    bool tryAttach(PerfKvmCounterConfig &config, pid_t tid, int group_fd);
 
     /**
      * Get the TID of the current thread.
@@ -42,19 +42,28 @@
 
 #include <fcntl.h>
 #include <linux/kvm.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <cstring>
 #include <memory>
 
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
 #include "cpu/kvm/base.hh"
 #include "debug/Kvm.hh"
 #include "params/KvmVM.hh"
 #include "sim/system.hh"
 
+#if defined(__i386__) || defined(__x86_64__)
+#include "arch/x86/x86_traits.hh"
+#endif
+
 #define EXPECTED_KVM_API_VERSION 12
 
 #if EXPECTED_KVM_API_VERSION != KVM_API_VERSION
@@ -137,6 +146,16 @@ Kvm::capNumMemSlots() const
 #endif
 }
 
+bool
+Kvm::capIOEventFD() const
+{
+#ifdef KVM_CAP_IOEVENTFD
+    return checkExtension(KVM_CAP_IOEVENTFD) != 0;
+#else
+    return false;
+#endif
+}
+
 bool
 Kvm::capOneReg() const
 {
@@ -296,8 +315,18 @@ KvmVM::KvmVM(KvmVMParams *params)
       kvm(new Kvm()), system(nullptr),
       vmFD(kvm->createVM()),
       started(false),
-      nextVCPUID(0)
-{
+      nextVCPUID(0), numCreatedVCPUs(0),
+      dirtyPageLog(params->dirtyPageLog),
+      dirtyPageLogPeriod(params->dirtyPageLogPeriod),
+      dirtyPageLogSize(params->dirtyPageLogSize),
+      dirtyPageLogEvent([this]{ sampleDirtyPages(); }, name()),
+      coalesceDeviceWrites(params->coalesceDeviceWrites),
+      useIOEventFDs(params->useIOEventFDs && kvm->capIOEventFD()),
+      nextIOEventFDID(0)
+{
+    if (params->useIOEventFDs && !useIOEventFDs)
+        inform("KVM: ioeventfd not supported by host OS\n");
+
     maxMemorySlot = kvm->capNumMemSlots();
     /* If we couldn't determine how memory slots there are, guess 32. */
     if (!maxMemorySlot)
@@ -309,6 +338,9 @@ KvmVM::KvmVM(KvmVMParams *params)
 
 KvmVM::~KvmVM()
 {
+    for (auto &iofd : ioEventFDs)
+        close(iofd->fd);
+
     if (vmFD != -1)
         close(vmFD);
 
@@ -367,12 +399,71 @@ KvmVM::delayedStartup()
             }
 
             const MemSlot slot = allocMemSlot(range.size());
-            setupMemSlot(slot, pmem, range.start(), 0/* flags */);
+            setupMemSlot(slot, pmem, range.start(),
+                         dirtyPageLog ? KVM_MEM_LOG_DIRTY_PAGES : 0);
         } else {
             DPRINTF(Kvm, "Zero-region not mapped: [0x%llx]\n", range.start());
             hack("KVM: Zero memory handled as IO\n");
         }
     }
+
+    if (dirtyPageLog)
+        schedule(dirtyPageLogEvent, curTick() + dirtyPageLogPeriod);
+}
+
+void
+KvmVM::sampleDirtyPages()
+{
+    const Addr page_size = sysconf(_SC_PAGESIZE);
+
+    for (const auto &slot : memorySlots) {
+        if (!slot.active || !(slot.flags & KVM_MEM_LOG_DIRTY_PAGES))
+            continue;
+
+        const uint64_t num_pages = divCeil(slot.size, page_size);
+        std::vector<uint64_t> bitmap(divCeil(num_pages, 64));
+
+        struct kvm_dirty_log log;
+        memset(&log, 0, sizeof(log));
+        log.slot = slot.slot;
+        log.dirty_bitmap = bitmap.data();
+        if (ioctl(KVM_GET_DIRTY_LOG, (void *)&log) == -1)
+            panic("KVM: Failed to get the dirty log of slot %i (errno: %i)\n",
+                  slot.slot, errno);
+
+        for (uint64_t word = 0; word < bitmap.size(); ++word) {
+            for (uint64_t bits = bitmap[word]; bits; bits &= bits - 1) {
+                const uint64_t page = word * 64 + findLsbSet(bits);
+                touchDirtyPage(slot.guestAddr + page * page_size);
+            }
+        }
+    }
+
+    DPRINTF(Kvm, "Tracking %i recently written pages\n", dirtyPages.size());
+    schedule(dirtyPageLogEvent, curTick() + dirtyPageLogPeriod);
+}
+
+void
+KvmVM::touchDirtyPage(Addr page)
+{
+    auto it = dirtyPageIndex.find(page);
+    if (it != dirtyPageIndex.end()) {
+        dirtyPages.splice(dirtyPages.begin(), dirtyPages, it->second);
+        return;
+    }
+
+    dirtyPages.push_front(page);
+    dirtyPageIndex[page] = dirtyPages.begin();
+    if (dirtyPages.size() > dirtyPageLogSize) {
+        dirtyPageIndex.erase(dirtyPages.back());
+        dirtyPages.pop_back();
+    }
+}
+
+std::vector<Addr>
+KvmVM::recentDirtyPages() const
+{
+    return std::vector<Addr>(dirtyPages.rbegin(), dirtyPages.rend());
 }
 
 const KvmVM::MemSlot
@@ -409,6 +500,8 @@ KvmVM::setupMemSlot(const KvmVM::MemSlot num, void *host_addr, Addr guest,
 {
     MemorySlot &slot = memorySlots.at(num.num);
     slot.active = true;
+    slot.guestAddr = guest;
+    slot.flags = flags;
     setUserMemoryRegion(num.num, host_addr, guest, slot.size, flags);
 }
 
@@ -476,6 +569,125 @@ KvmVM::coalesceMMIO(Addr start, int size)
               errno);
 }
 
+bool
+KvmVM::coalesceDeviceMMIO(Addr start, int size)
+{
+    if (!coalesceDeviceWrites)
+        return false;
+
+    coalesceMMIO(start, size);
+    return true;
+}
+
+bool
+KvmVM::setIOEventFD(const IOEventFD &iofd, bool assign)
+{
+    struct kvm_ioeventfd ioeventfd;
+    memset(&ioeventfd, 0, sizeof(ioeventfd));
+
+    ioeventfd.addr = iofd.addr;
+    ioeventfd.len = iofd.size;
+    ioeventfd.datamatch = iofd.data;
+    ioeventfd.fd = iofd.fd;
+    ioeventfd.flags = KVM_IOEVENTFD_FLAG_DATAMATCH;
+    if (!assign)
+        ioeventfd.flags |= KVM_IOEVENTFD_FLAG_DEASSIGN;
+
+#if defined(__i386__) || defined(__x86_64__)
+    // I/O ports live in their own address range in gem5, but in a
+    // separate address space in KVM.
+    if ((iofd.addr & ~mask(16)) == X86ISA::PhysAddrPrefixIO) {
+        ioeventfd.addr = iofd.addr & mask(16);
+        ioeventfd.flags |= KVM_IOEVENTFD_FLAG_PIO;
+    }
+#endif
+
+    return ioctl(KVM_IOEVENTFD, (void *)&ioeventfd) != -1;
+}
+
+int
+KvmVM::registerIOEventFD(Addr addr, unsigned size, uint64_t data,
+                         std::function<void()> callback)
+{
+    if (!useIOEventFDs)
+        return -1;
+
+    auto iofd = std::make_shared<IOEventFD>();
+    iofd->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (iofd->fd == -1)
+        panic("KVM: Failed to create eventfd (errno: %i)\n", errno);
+    iofd->addr = addr;
+    iofd->size = size;
+    iofd->data = data;
+    iofd->callback = std::move(callback);
+
+    if (!setIOEventFD(*iofd, true)) {
+        warn("KVM: Failed to register ioeventfd at 0x%x (errno: %i)\n",
+             addr, errno);
+        close(iofd->fd);
+        return -1;
+    }
+
+    DPRINTF(Kvm, "KVM: Registered ioeventfd (addr: 0x%x, len: %u, "
+            "data: 0x%x)\n", addr, size, data);
+
+    std::lock_guard<std::mutex> lock(ioEventFDLock);
+    iofd->id = nextIOEventFDID++;
+    ioEventFDs.push_back(iofd);
+    return iofd->id;
+}
+
+void
+KvmVM::unregisterIOEventFD(int id)
+{
+    std::shared_ptr<IOEventFD> iofd;
+    {
+        std::lock_guard<std::mutex> lock(ioEventFDLock);
+        auto it = std::find_if(ioEventFDs.begin(), ioEventFDs.end(),
+                               [id](const std::shared_ptr<IOEventFD> &e) {
+                                   return e->id == id;
+                               });
+        if (it == ioEventFDs.end())
+            return;
+        iofd = *it;
+        ioEventFDs.erase(it);
+    }
+
+    if (!setIOEventFD(*iofd, false))
+        panic("KVM: Failed to unregister ioeventfd at 0x%x (errno: %i)\n",
+              iofd->addr, errno);
+    close(iofd->fd);
+}
+
+void
+KvmVM::serviceIOEventFDs(EventQueue *device_queue)
+{
+    if (!useIOEventFDs)
+        return;
+
+    std::vector<std::shared_ptr<IOEventFD>> pending;
+    {
+        std::lock_guard<std::mutex> lock(ioEventFDLock);
+        for (auto &iofd : ioEventFDs) {
+            // Reading an eventfd returns and clears its counter, so
+            // only one vCPU sees each batch of notifications.
+            uint64_t count;
+            if (read(iofd->fd, &count, sizeof(count)) == sizeof(count))
+                pending.push_back(iofd);
+        }
+    }
+
+    if (pending.empty())
+        return;
+
+    EventQueue::ScopedMigration migrate(device_queue);
+    for (auto &iofd : pending) {
+        DPRINTF(Kvm, "KVM: Servicing ioeventfd (addr: 0x%x, data: 0x%x)\n",
+                iofd->addr, iofd->data);
+        iofd->callback();
+    }
+}
+
 void
 KvmVM::setTSSAddress(Addr tss_address)
 {
@@ -553,9 +765,24 @@ KvmVM::createVCPU(long vcpuID)
     if (fd == -1)
         panic("KVM: Failed to create virtual CPU");
 
+    if (++numCreatedVCPUs == nextVCPUID) {
+        for (auto &callback : vcpusCreatedCallbacks)
+            callback();
+        vcpusCreatedCallbacks.clear();
+    }
+
     return fd;
 }
 
+void
+KvmVM::whenVCPUsCreated(std::function<void()> callback)
+{
+    if (numCreatedVCPUs == nextVCPUID)
+        callback();
+    else
+        vcpusCreatedCallbacks.push_back(callback);
+}
+
 long
 KvmVM::allocVCPUID()
 {
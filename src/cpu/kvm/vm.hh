@@ -41,9 +41,15 @@
 #ifndef __CPU_KVM_KVMVM_HH__
 #define __CPU_KVM_KVMVM_HH__
 
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "base/addr_range.hh"
+#include "sim/eventq.hh"
 #include "sim/sim_object.hh"
 
 // forward declarations
@@ -114,6 +120,9 @@ class Kvm
      */
     int capNumMemSlots() const;
 
+    /** Support for KvmVM::registerIOEventFD(). */
+    bool capIOEventFD() const;
+
     /**
      * Support for reading and writing single registers.
      *
@@ -298,6 +307,16 @@ class KvmVM : public SimObject
 
     void notifyFork();
 
+    /**
+     * Get the guest physical pages that the vCPUs wrote recently, as
+     * seen by dirty page logging. Pages are ordered from the least to
+     * the most recently written one, so that warming caches in that
+     * order leaves the hottest pages in them.
+     *
+     * @return Page addresses, empty if dirty page logging is disabled.
+     */
+    std::vector<Addr> recentDirtyPages() const;
+
     /**
      * Setup a shared three-page memory region used by the internals
      * of KVM. This is currently only needed by x86 implementations.
@@ -321,6 +340,63 @@ class KvmVM : public SimObject
      * @param range Coalesced MMIO range
      */
     void coalesceMMIO(const AddrRange &range);
+
+    /**
+     * Request coalescing of device writes to a range of MMIO
+     * registers, if enabled in the VM.
+     *
+     * Coalesced writes are buffered by the kernel and handled in
+     * order the next time a vCPU exits from KVM, so devices should
+     * only use this for registers where writes have no side effects
+     * that the guest could observe before its next register read.
+     *
+     * @param start Physical start address in guest
+     * @param size Size of the MMIO region
+     * @return true if the range is coalesced, false otherwise.
+     */
+    bool coalesceDeviceMMIO(Addr start, int size);
+    /** @} */
+
+    /**
+     * @{
+     * @name Device doorbells
+     *
+     * A device can ask to be notified through an eventfd, rather
+     * than through an MMIO or IO exit, when the guest writes a
+     * given value to a doorbell register. Pending notifications are
+     * serviced asynchronously the next time any vCPU exits from
+     * KVM. The value written is not available to the callback, so
+     * each value of interest needs its own registration.
+     */
+    /**
+     * Register a doorbell.
+     *
+     * @param addr Physical address of the register in gem5's address
+     * map (I/O ports use the architecture's I/O address range).
+     * @param size Size of the guest write
+     * @param data Value that triggers the notification
+     * @param callback Function called, with the device event queue
+     * locked, when the guest has written data to the register.
+     * @return ID of the doorbell, or -1 if doorbells aren't supported
+     * or are disabled.
+     */
+    int registerIOEventFD(Addr addr, unsigned size, uint64_t data,
+                          std::function<void()> callback);
+
+    /**
+     * Unregister a doorbell.
+     *
+     * @param id Doorbell ID returned by registerIOEventFD().
+     */
+    void unregisterIOEventFD(int id);
+
+    /**
+     * Call the callbacks of all pending doorbells.
+     *
+     * @param device_queue Event queue to migrate to while calling the
+     * callbacks.
+     */
+    void serviceIOEventFDs(EventQueue *device_queue);
     /** @} */
 
     /**
@@ -360,6 +436,17 @@ class KvmVM : public SimObject
      * using the KvmVM::createIRQChip() API.
      */
     void enableKernelIRQChip() { _hasKernelIRQChip = true; }
+
+    /**
+     * Call a function once every allocated vCPU has been created.
+     *
+     * Some in-kernel devices, like the GICv3, have to be finalized
+     * after the vCPUs exist but before any of them runs. vCPUs are
+     * created in the CPUs' startup(), so the function is called
+     * right away if that has already happened for all of them, and
+     * otherwise from the startup() of the last one.
+     */
+    void whenVCPUsCreated(std::function<void()> callback);
     /** @} */
 
     struct MemSlot
@@ -537,6 +624,30 @@ class KvmVM : public SimObject
     /** Next unallocated vCPU ID */
     long nextVCPUID;
 
+    /** Number of vCPUs created so far */
+    long numCreatedVCPUs;
+
+    /** Functions waiting for all the vCPUs to be created */
+    std::vector<std::function<void()>> vcpusCreatedCallbacks;
+
+    /**
+     * @{
+     * Dirty page logging. The dirty log of every memory slot is read
+     * (and cleared) periodically, and the written pages are kept in
+     * LRU order, most recently written at the front.
+     */
+    void sampleDirtyPages();
+    void touchDirtyPage(Addr page);
+
+    const bool dirtyPageLog;
+    const Tick dirtyPageLogPeriod;
+    const size_t dirtyPageLogSize;
+    EventFunctionWrapper dirtyPageLogEvent;
+
+    std::list<Addr> dirtyPages;
+    std::unordered_map<Addr, std::list<Addr>::iterator> dirtyPageIndex;
+    /** @} */
+
     /**
      *  Structures tracking memory slots.
      */
@@ -546,9 +657,46 @@ class KvmVM : public SimObject
         uint64_t size;
         uint32_t slot;
         bool active;
+        /** Guest address and flags of the slot, if active */
+        Addr guestAddr;
+        uint32_t flags;
     };
     std::vector<MemorySlot> memorySlots;
     uint32_t maxMemorySlot;
+
+    /** Let devices coalesce writes to their registers */
+    const bool coalesceDeviceWrites;
+
+    /** Let devices register doorbells */
+    const bool useIOEventFDs;
+
+    /** A device doorbell and the eventfd it signals */
+    struct IOEventFD
+    {
+        int id;
+        int fd;
+        Addr addr;
+        unsigned size;
+        uint64_t data;
+        std::function<void()> callback;
+    };
+
+    /**
+     * Assign or deassign a doorbell in the kernel.
+     *
+     * @return true on success, false otherwise.
+     */
+    bool setIOEventFD(const IOEventFD &iofd, bool assign);
+
+    /**
+     * Registered doorbells. They can be registered and unregistered
+     * by devices while other vCPUs service them, so the list is
+     * protected by a lock and the callbacks are only called once it
+     * has been released.
+     */
+    std::vector<std::shared_ptr<IOEventFD>> ioEventFDs;
+    std::mutex ioEventFDLock;
+    int nextIOEventFDID;
 };
 
 #endif
@@ -49,7 +49,9 @@
 
 MinorCPU::MinorCPU(MinorCPUParams *params) :
     BaseCPU(params),
-    threadPolicy(params->threadPolicy)
+    threadPolicy(params->threadPolicy),
+    ppCommit(nullptr),
+    ppFetchRequest(nullptr)
 {
     /* This is only written for one thread at the moment */
     Minor::MinorThread *thread;
@@ -130,6 +132,17 @@ MinorCPU::regStats()
     pipeline->regStats();
 }
 
+void
+MinorCPU::regProbePoints()
+{
+    BaseCPU::regProbePoints();
+
+    ppCommit = new ProbePointArg<Minor::MinorDynInstPtr>(getProbeManager(),
+        "Commit");
+    ppFetchRequest = new ProbePointArg<RequestPtr>(getProbeManager(),
+        "FetchRequest");
+}
+
 void
 MinorCPU::serializeThread(CheckpointOut &cp, ThreadID thread_id) const
 {
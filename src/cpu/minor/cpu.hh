@@ -47,11 +47,13 @@
 #define __CPU_MINOR_CPU_HH__
 
 #include "cpu/minor/activity.hh"
+#include "cpu/minor/dyn_inst.hh"
 #include "cpu/minor/stats.hh"
 #include "cpu/base.hh"
 #include "cpu/simple_thread.hh"
 #include "enums/ThreadPolicy.hh"
 #include "params/MinorCPU.hh"
+#include "sim/probe/probe.hh"
 
 namespace Minor
 {
@@ -138,6 +140,16 @@ class MinorCPU : public BaseCPU
     /** Stats interface from SimObject (by way of BaseCPU) */
     void regStats() override;
 
+    /** Probe points used by the elastic trace */
+    void regProbePoints() override;
+
+    /** Instructions that commit without a fault and with a true
+     *  predicate */
+    ProbePointArg<Minor::MinorDynInstPtr> *ppCommit;
+
+    /** Line fetch requests sent to memory */
+    ProbePointArg<RequestPtr> *ppFetchRequest;
+
     /** Simple inst count interface from BaseCPU */
     Counter totalInsts() const override;
     Counter totalOps() const override;
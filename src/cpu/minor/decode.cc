@@ -91,6 +91,17 @@ Decode::getInput(ThreadID tid)
     }
 }
 
+bool
+Decode::isStalled()
+{
+    for (ThreadID tid = 0; tid < cpu.numThreads; tid++) {
+        if (getInput(tid) && !decodeInfo[tid].blocked)
+            return false;
+    }
+
+    return true;
+}
+
 void
 Decode::popInput(ThreadID tid)
 {
@@ -134,6 +145,16 @@ Decode::evaluate()
     for (ThreadID tid = 0; tid < cpu.numThreads; tid++)
         decodeInfo[tid].blocked = !nextStageReserve[tid].canReserve();
 
+    /* With no new input and no thread able to pass anything on, there is
+     *  nothing to do this cycle.  Leave before thread selection builds its
+     *  priority list.  The random policy still selects a thread to keep
+     *  the sequence of random draws unchanged */
+    if (inp.outputWire->isBubble() && isStalled() &&
+        cpu.threadPolicy != Enums::Random)
+    {
+        return;
+    }
+
     ThreadID tid = getScheduledThread();
 
     if (tid != InvalidThreadID) {
@@ -186,6 +207,7 @@ Decode::evaluate()
                     output_inst->pc = decode_info.microopPC;
                     output_inst->staticInst = static_micro_inst;
                     output_inst->fault = NoFault;
+                    output_inst->fetchTick = inst->fetchTick;
 
                     /* Allow a predicted next address only on the last
                      *  microop */
@@ -230,6 +252,7 @@ Decode::evaluate()
 
                 /* Set execSeqNum of output_inst */
                 output_inst->id.execSeqNum = decode_info.execSeqNum;
+                output_inst->decodeTick = curTick();
                 /* Add tracing */
 #if TRACING_ON
                 dynInstAddTracing(output_inst, parent_static_inst, cpu);
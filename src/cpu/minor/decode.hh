@@ -137,6 +137,10 @@ class Decode : public Named
     /** Use the current threading policy to determine the next thread to
      *  decode from. */
     ThreadID getScheduledThread();
+
+    /** Is every thread either without input or blocked by Execute?
+     *  Uses the blocked flags set at the start of evaluate */
+    bool isStalled();
   public:
     Decode(const std::string &name,
         MinorCPU &cpu_,
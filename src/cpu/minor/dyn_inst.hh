@@ -55,6 +55,7 @@
 #include "cpu/inst_seq.hh"
 #include "cpu/static_inst.hh"
 #include "cpu/timing_expr.hh"
+#include "mem/request.hh"
 #include "sim/faults.hh"
 
 namespace Minor
@@ -221,6 +222,36 @@ class MinorDynInst : public RefCounted
      *  up */
     RegId flatDestRegIdx[TheISA::MaxInstDestRegs];
 
+    /** Timing and memory access details recorded for listeners to the
+     *  Commit probe point, such as the elastic trace */
+
+    /** Tick at which this instruction left Fetch2 */
+    Tick fetchTick;
+
+    /** Tick at which this instruction left Decode */
+    Tick decodeTick;
+
+    /** Tick at which this instruction was issued */
+    Tick issueTick;
+
+    /** Tick at which the results of an instruction issued to an FU are
+     *  available */
+    Tick resultTick;
+
+    /** Tick at which the (first) memory request of a mem ref instruction
+     *  was sent to memory */
+    Tick memSendTick;
+
+    /** Tick at which a mem ref instruction completed its access */
+    Tick memRespTick;
+
+    /** The completed memory access of a mem ref instruction */
+    Addr memPhysAddr;
+    Addr memVirtAddr;
+    uint32_t memAsid;
+    unsigned int memSize;
+    Request::FlagsType memFlags;
+
   public:
     MinorDynInst(InstId id_ = InstId(), Fault fault_ = NoFault) :
         staticInst(NULL), id(id_), traceData(NULL),
@@ -229,7 +260,11 @@ class MinorDynInst : public RefCounted
         fuIndex(0), inLSQ(false), inStoreBuffer(false),
         canEarlyIssue(false),
         instToWaitFor(0), extraCommitDelay(Cycles(0)),
-        extraCommitDelayExpr(NULL), minimumCommitCycle(Cycles(0))
+        extraCommitDelayExpr(NULL), minimumCommitCycle(Cycles(0)),
+        fetchTick(MaxTick), decodeTick(MaxTick),
+        issueTick(MaxTick), resultTick(MaxTick), memSendTick(MaxTick),
+        memRespTick(MaxTick), memPhysAddr(0), memVirtAddr(0), memAsid(0),
+        memSize(0), memFlags(0)
     { }
 
   public:
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/minor/elastic_trace.hh"
+
+#include <algorithm>
+
+#include "base/trace.hh"
+#include "debug/ElasticTrace.hh"
+
+MinorElasticTrace::MinorElasticTrace(const MinorElasticTraceParams *params) :
+    BaseElasticTrace(params),
+    minorCpu(dynamic_cast<MinorCPU *>(cpu))
+{
+    fatal_if(!minorCpu, "Manager of %s is not of type MinorCPU and thus"
+        " does not support dependency tracing.\n", name());
+}
+
+void
+MinorElasticTrace::regEtraceListeners()
+{
+    BaseElasticTrace::regEtraceListeners();
+    listeners.push_back(
+        new ProbeListenerArg<MinorElasticTrace, Minor::MinorDynInstPtr>(
+            this, "Commit", &MinorElasticTrace::addCommittedInst));
+}
+
+void
+MinorElasticTrace::addCommittedInst(const Minor::MinorDynInstPtr &inst)
+{
+    const StaticInstPtr &static_inst = inst->staticInst;
+    ThreadContext *thread = minorCpu->getContext(inst->id.threadId);
+    InstSeqNum seq_num = inst->id.execSeqNum;
+
+    if (static_inst->isNop())
+        return;
+
+    DPRINTFR(ElasticTrace, "Attempt to add committed inst [sn:%lli]\n",
+        seq_num);
+
+    TraceInfo *new_record = new TraceInfo;
+    new_record->instNum = seq_num;
+    new_record->pc = inst->pc.instAddr();
+
+    if (static_inst->isLoad() || static_inst->isStore()) {
+        new_record->type = static_inst->isLoad() ? Record::LOAD :
+            Record::STORE;
+        new_record->reqFlags = inst->memFlags;
+        new_record->physAddr = inst->memPhysAddr;
+        new_record->virtAddr = inst->memVirtAddr;
+        new_record->asid = inst->memAsid;
+        new_record->size = inst->memSize;
+
+        /* A load executes when its request is sent, unless the store
+         *  buffer provides its data.  A store is sent after it commits */
+        if (static_inst->isLoad() && inst->memSendTick != MaxTick)
+            new_record->executeTick = inst->memSendTick;
+        else if (static_inst->isLoad())
+            new_record->executeTick = inst->memRespTick;
+        else
+            new_record->executeTick = inst->issueTick;
+        new_record->toCommitTick = inst->memRespTick;
+    } else {
+        new_record->type = Record::COMP;
+        new_record->executeTick = inst->issueTick;
+        new_record->toCommitTick = std::min(inst->resultTick, curTick());
+    }
+
+    /* Look up the last writers of the source registers, within the
+     *  window */
+    std::set<InstSeqNum> reg_deps;
+    Tick deps_done = 0;
+    for (int src_idx = 0; src_idx < static_inst->numSrcRegs(); src_idx++) {
+        RegId src_reg = thread->flattenRegId(static_inst->srcRegIdx(src_idx));
+        if (src_reg.isMiscReg() || src_reg.isZeroReg())
+            continue;
+
+        auto writer = regDepMap.find(src_reg);
+        if (writer != regDepMap.end() &&
+            seq_num - writer->second.first < depWindowSize)
+        {
+            reg_deps.insert(writer->second.first);
+            deps_done = std::max(deps_done, writer->second.second);
+        }
+    }
+
+    /* Operand forwarding can issue an instruction slightly before the
+     *  results it reads are considered available, but it can't execute
+     *  before them */
+    if (new_record->isLoad())
+        new_record->executeTick = std::max(new_record->executeTick,
+            deps_done);
+    else if (new_record->isComp())
+        new_record->toCommitTick = std::max(new_record->toCommitTick,
+            deps_done);
+    new_record->toCommitTick = std::max(new_record->toCommitTick,
+        new_record->executeTick);
+
+    /* This is now the last writer of its destination registers */
+    Tick done_tick = new_record->isStore() ? curTick() :
+        new_record->toCommitTick;
+    for (int dest_idx = 0; dest_idx < static_inst->numDestRegs();
+        dest_idx++)
+    {
+        RegId dest_reg =
+            thread->flattenRegId(static_inst->destRegIdx(dest_idx));
+        if (!dest_reg.isMiscReg() && !dest_reg.isZeroReg())
+            regDepMap[dest_reg] = std::make_pair(seq_num, done_tick);
+    }
+
+    bool is_sync = static_inst->isMemBarrier() ||
+        static_inst->isWriteBarrier() ||
+        (static_inst->isMemRef() && isSyncReq(inst->memFlags));
+
+    addDepTraceRecord(new_record, reg_deps, true, is_sync);
+}
+
+MinorElasticTrace *
+MinorElasticTraceParams::create()
+{
+    return new MinorElasticTrace(this);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ *  Elastic trace probe listener for the Minor CPU
+ */
+
+#ifndef __CPU_MINOR_ELASTIC_TRACE_HH__
+#define __CPU_MINOR_ELASTIC_TRACE_HH__
+
+#include <map>
+#include <utility>
+
+#include "cpu/minor/cpu.hh"
+#include "cpu/minor/dyn_inst.hh"
+#include "cpu/reg_class.hh"
+#include "cpu/trace/base_elastic_trace.hh"
+#include "params/MinorElasticTrace.hh"
+
+/** Elastic trace of the instructions committed by a MinorCPU.
+ *
+ *  Minor executes in order, so the whole record of an instruction is built
+ *  when it commits from the timing and memory access details that Execute
+ *  and the LSQ leave on the MinorDynInst.  Register dependencies are found
+ *  in commit order on the flattened architectural registers, which is exact
+ *  for an in-order pipeline and never involves discarded instructions.
+ *  The dependency window should cover the instructions in flight in
+ *  Execute, including the store buffer. */
+class MinorElasticTrace : public BaseElasticTrace
+{
+  protected:
+    /** The CPU that is being traced */
+    MinorCPU *minorCpu;
+
+    /** Last committed writer of each register and the tick at which
+     *  the value was available */
+    std::map<RegId, std::pair<InstSeqNum, Tick>> regDepMap;
+
+  public:
+    MinorElasticTrace(const MinorElasticTraceParams *params);
+
+  public:
+    /** Register the Commit listener as well as the fetch one */
+    void regEtraceListeners() override;
+
+    /** Add an instruction that committed to the trace */
+    void addCommittedInst(const Minor::MinorDynInstPtr &inst);
+};
+
+#endif /* __CPU_MINOR_ELASTIC_TRACE_HH__ */
@@ -376,6 +376,15 @@ Execute::handleMemResponse(MinorDynInstPtr inst,
         fault = inst->staticInst->completeAcc(packet, &context,
             inst->traceData);
 
+        /* Remember the access for the Commit probe point */
+        const RequestPtr req = packet->req;
+        inst->memRespTick = curTick();
+        inst->memPhysAddr = req->getPaddr();
+        inst->memVirtAddr = req->hasVaddr() ? req->getVaddr() : 0;
+        inst->memAsid = req->hasVaddr() ? req->getAsid() : 0;
+        inst->memSize = packet->getSize();
+        inst->memFlags = req->getFlags();
+
         if (fault != NoFault) {
             /* Invoke fault created by instruction completion */
             DPRINTF(MinorMem, "Fault in memory completeAcc: %s\n",
@@ -400,6 +409,8 @@ Execute::handleMemResponse(MinorDynInstPtr inst,
     }
 
     doInstCommitAccounting(inst);
+    if (fault == NoFault && packet && context.readPredicate())
+        cpu.ppCommit->notify(inst);
 
     /* Generate output to account for branches */
     tryToBranch(inst, fault, branch);
@@ -612,6 +623,8 @@ Execute::issue(ThreadID thread_id)
                     inst->fuIndex = noCostFUIndex;
                     inst->extraCommitDelay = Cycles(0);
                     inst->extraCommitDelayExpr = NULL;
+                    inst->issueTick = curTick();
+                    inst->resultTick = curTick();
 
                     /* Push the instruction onto the inFlight queue so
                      *  it can be committed in order */
@@ -688,6 +701,9 @@ Execute::issue(ThreadID thread_id)
                         inst->extraCommitDelay = extra_dest_retire_lat;
                         inst->extraCommitDelayExpr =
                             extra_dest_retire_lat_expr;
+                        inst->issueTick = curTick();
+                        inst->resultTick = cpu.clockEdge(
+                            fu->description.opLat + extra_dest_retire_lat);
 
                         if (issued_mem_ref) {
                             /* Remember which instruction this memory op
@@ -822,7 +838,7 @@ Execute::tryPCEvents(ThreadID thread_id)
     Addr oldPC;
     do {
         oldPC = thread->instAddr();
-        cpu.system->pcEventQueue.service(thread);
+        cpu.system->pcEventQueue.service(oldPC, thread);
         num_pc_event_checks++;
     } while (oldPC != thread->instAddr());
 
@@ -967,6 +983,8 @@ Execute::commitInst(MinorDynInstPtr inst, bool early_memory_issue,
         }
 
         doInstCommitAccounting(inst);
+        if (fault == NoFault && context.readPredicate())
+            cpu.ppCommit->notify(inst);
         tryToBranch(inst, fault, branch);
     }
 
@@ -1225,11 +1243,8 @@ Execute::commit(ThreadID thread_id, bool only_commit_microops, bool discard,
 
                         ThreadContext *thread = cpu.getContext(thread_id);
 
-                        TimingExprEvalContext context(inst->staticInst,
-                            thread, NULL);
-
                         uint64_t extra_delay = inst->extraCommitDelayExpr->
-                            eval(context);
+                            evaluate(inst->staticInst, thread);
 
                         DPRINTF(MinorExecute, "Extra commit delay expr"
                             " result: %d\n", extra_delay);
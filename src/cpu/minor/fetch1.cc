@@ -332,6 +332,8 @@ Fetch1::tryToSend(FetchRequestPtr request)
     bool ret = false;
 
     if (icachePort.sendTimingReq(request->packet)) {
+        cpu.ppFetchRequest->notify(request->packet->req);
+
         /* Invalidate the fetch_requests packet so we don't
          *  accidentally fail to deallocate it (or use it!)
          *  later by overwriting it */
@@ -101,6 +101,17 @@ Fetch2::getInput(ThreadID tid)
     }
 }
 
+bool
+Fetch2::isStalled()
+{
+    for (ThreadID tid = 0; tid < cpu.numThreads; tid++) {
+        if (getInput(tid) && !fetchInfo[tid].blocked)
+            return false;
+    }
+
+    return true;
+}
+
 void
 Fetch2::popInput(ThreadID tid)
 {
@@ -291,6 +302,13 @@ Fetch2::evaluate()
         }
     }
 
+    /* As in Decode, leave early when nothing can move this cycle */
+    if (inp.outputWire->isBubble() && isStalled() &&
+        cpu.threadPolicy != Enums::Random)
+    {
+        return;
+    }
+
     ThreadID tid = getScheduledThread();
     DPRINTF(Fetch, "Scheduled Thread: %d\n", tid);
 
@@ -413,6 +431,7 @@ Fetch2::evaluate()
                     dyn_inst->staticInst = decoded_inst;
 
                     dyn_inst->pc = fetch_info.pc;
+                    dyn_inst->fetchTick = curTick();
                     DPRINTF(Fetch, "decoder inst %s\n", *dyn_inst);
 
                     // Collect some basic inst class stats
@@ -197,6 +197,10 @@ class Fetch2 : public Named
      *  fetch from. */
     ThreadID getScheduledThread();
 
+    /** Is every thread either without input or blocked by Decode?
+     *  Uses the blocked flags set at the start of evaluate */
+    bool isStalled();
+
   public:
     Fetch2(const std::string &name,
         MinorCPU &cpu_,
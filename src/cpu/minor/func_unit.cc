@@ -101,6 +101,13 @@ MinorFUTiming::MinorFUTiming(
     opClasses(params->opClasses)
 { }
 
+void
+MinorFUTiming::init()
+{
+    if (extraCommitLatExpr)
+        extraCommitLatExpr->compileProgram();
+}
+
 namespace Minor
 {
 
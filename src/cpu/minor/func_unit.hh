@@ -133,6 +133,9 @@ class MinorFUTiming: public SimObject
   public:
     MinorFUTiming(const MinorFUTimingParams *params);
 
+    /** Compile extraCommitLatExpr */
+    void init() override;
+
   public:
     /** Does the extra decode in this object support the given op class */
     bool provides(OpClass op_class) { return opClasses->provides(op_class); }
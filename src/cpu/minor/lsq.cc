@@ -1107,6 +1107,9 @@ LSQ::tryToSend(LSQRequestPtr request)
 
             numAccessesInMemorySystem++;
 
+            if (request->inst->memSendTick == MaxTick)
+                request->inst->memSendTick = curTick();
+
             request->stepToNextPacket();
 
             ret = request->sentAllPackets();
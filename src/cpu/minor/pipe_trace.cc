@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/minor/pipe_trace.hh"
+
+#include <algorithm>
+
+MinorPipeTrace::MinorPipeTrace(const MinorPipeTraceParams *params) :
+    BasePipeTrace(params)
+{
+    fatal_if(!dynamic_cast<MinorCPU *>(params->manager), "Manager of %s "
+        "is not of type MinorCPU and thus does not support pipeline "
+        "tracing.\n", name());
+}
+
+void
+MinorPipeTrace::regProbeListeners()
+{
+    listeners.push_back(
+        new ProbeListenerArg<MinorPipeTrace, Minor::MinorDynInstPtr>(
+            this, "Commit", &MinorPipeTrace::traceCommit));
+}
+
+void
+MinorPipeTrace::traceCommit(const Minor::MinorDynInstPtr &inst)
+{
+    if (inst->fetchTick == MaxTick)
+        return;
+
+    InstRecord rec;
+    rec.seqNum = inst->id.execSeqNum;
+    rec.pc = inst->pc.instAddr();
+    rec.upc = inst->pc.microPC();
+    rec.tick[Fetch] = inst->fetchTick;
+    rec.tick[Decode] = inst->decodeTick;
+    rec.tick[Rename] = MaxTick;
+    rec.tick[Dispatch] = MaxTick;
+    rec.tick[Issue] = inst->issueTick;
+    rec.tick[Complete] = std::min(inst->staticInst->isMemRef() ?
+        inst->memRespTick : inst->resultTick, curTick());
+    rec.tick[Retire] = curTick();
+    rec.tick[Store] = MaxTick;
+    addInst(rec, inst->staticInst);
+}
+
+MinorPipeTrace *
+MinorPipeTraceParams::create()
+{
+    return new MinorPipeTrace(this);
+}
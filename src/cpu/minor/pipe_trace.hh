@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_MINOR_PIPE_TRACE_HH__
+#define __CPU_MINOR_PIPE_TRACE_HH__
+
+#include "cpu/minor/cpu.hh"
+#include "cpu/minor/dyn_inst.hh"
+#include "cpu/trace/base_pipe_trace.hh"
+#include "params/MinorPipeTrace.hh"
+
+/** Pipeline trace of the instructions committed by a MinorCPU.
+ *
+ *  The stage ticks come from the MinorDynInst: fetch is when Fetch2
+ *  decoded the instruction, decode when Decode passed it to Execute.
+ *  Minor has no rename or dispatch stages, complete is when the result
+ *  or the memory response was available and retire is the commit.
+ *  Stores drain from the store buffer after commit and have no store
+ *  tick.  Minor has no probe point for discarded instructions, so
+ *  only committed ones are traced. */
+class MinorPipeTrace : public BasePipeTrace
+{
+  public:
+    MinorPipeTrace(const MinorPipeTraceParams *params);
+
+    /** Register the Commit listener */
+    void regProbeListeners() override;
+
+  private:
+    void traceCommit(const Minor::MinorDynInstPtr &inst);
+};
+
+#endif /* __CPU_MINOR_PIPE_TRACE_HH__ */
@@ -78,6 +78,9 @@ class DerivO3CPU(BaseCPU):
     fetchBufferSize = Param.Unsigned(64, "Fetch buffer size in bytes")
     fetchQueueSize = Param.Unsigned(32, "Fetch queue size in micro-ops "
                                     "per-thread")
+    ftqSize = Param.Unsigned(0, "Fetch target queue size in fetch buffer "
+                             "blocks per-thread, 0 disables fetch-directed "
+                             "instruction prefetching")
 
     renameToDecodeDelay = Param.Cycles(1, "Rename to decode delay")
     iewToDecodeDelay = Param.Cycles(1, "Issue/Execute/Writeback to decode "
@@ -91,6 +94,9 @@ class DerivO3CPU(BaseCPU):
     commitToRenameDelay = Param.Cycles(1, "Commit to rename delay")
     decodeToRenameDelay = Param.Cycles(1, "Decode to rename delay")
     renameWidth = Param.Unsigned(8, "Rename width")
+    renameCheckpoints = Param.Unsigned(16, "Number of rename map "
+                                       "checkpoints taken at control "
+                                       "instructions (only used without SMT)")
 
     commitToIEWDelay = Param.Cycles(1, "Commit to "
                "Issue/Execute/Writeback delay")
@@ -144,6 +150,8 @@ class DerivO3CPU(BaseCPU):
     numPhysCCRegs = Param.Unsigned(_defaultNumPhysCCRegs,
                                    "Number of physical cc registers")
     numIQEntries = Param.Unsigned(64, "Number of instruction queue entries")
+    iqBitmapScheduler = Param.Bool(False, "Track dependencies and ready "
+                                   "instructions in the IQ with bitmaps")
     numROBEntries = Param.Unsigned(192, "Number of reorder buffer entries")
 
     smtNumFetchingThreads = Param.Unsigned(1, "SMT Number of Fetching Threads")
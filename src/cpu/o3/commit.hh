@@ -49,6 +49,7 @@
 #include "base/statistics.hh"
 #include "cpu/exetrace.hh"
 #include "cpu/inst_seq.hh"
+#include "cpu/o3/thread_list.hh"
 #include "cpu/timebuf.hh"
 #include "sim/probe/probe.hh"
 
@@ -182,7 +183,7 @@ class DefaultCommit
     IEW *iewStage;
 
     /** Sets pointer to list of active threads. */
-    void setActiveThreads(std::list<ThreadID> *at_ptr);
+    void setActiveThreads(ThreadList *at_ptr);
 
     /** Sets pointer to the commited state rename map. */
     void setRenameMap(RenameMap rm_ptr[Impl::MaxThreads]);
@@ -393,7 +394,7 @@ class DefaultCommit
     DynInstPtr squashAfterInst[Impl::MaxThreads];
 
     /** Priority List used for Commit Policy */
-    std::list<ThreadID> priority_list;
+    ThreadList priority_list;
 
     /** IEW to Commit delay. */
     const Cycles iewToCommitDelay;
@@ -462,7 +463,7 @@ class DefaultCommit
     bool checkEmptyROB[Impl::MaxThreads];
 
     /** Pointer to the list of active threads. */
-    std::list<ThreadID> *activeThreads;
+    ThreadList *activeThreads;
 
     /** Rename map interface. */
     RenameMap *renameMap[Impl::MaxThreads];
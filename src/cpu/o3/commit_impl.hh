@@ -63,7 +63,6 @@
 #include "debug/CommitRate.hh"
 #include "debug/Drain.hh"
 #include "debug/ExecFaulting.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/faults.hh"
 #include "sim/full_system.hh"
@@ -340,7 +339,7 @@ DefaultCommit<Impl>::setIEWStage(IEW *iew_stage)
 
 template<class Impl>
 void
-DefaultCommit<Impl>::setActiveThreads(list<ThreadID> *at_ptr)
+DefaultCommit<Impl>::setActiveThreads(ThreadList *at_ptr)
 {
     activeThreads = at_ptr;
 }
@@ -452,7 +451,7 @@ template <class Impl>
 void
 DefaultCommit<Impl>::deactivateThread(ThreadID tid)
 {
-    list<ThreadID>::iterator thread_it = std::find(priority_list.begin(),
+    ThreadList::iterator thread_it = std::find(priority_list.begin(),
             priority_list.end(), tid);
 
     if (thread_it != priority_list.end()) {
@@ -466,8 +465,8 @@ void
 DefaultCommit<Impl>::updateStatus()
 {
     // reset ROB changed variable
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -496,8 +495,8 @@ template <class Impl>
 bool
 DefaultCommit<Impl>::changedROBEntries()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -656,8 +655,8 @@ DefaultCommit<Impl>::tick()
     if (activeThreads->empty())
         return;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     // Check if any of the threads are done squashing.  Change the
     // status if they are done.
@@ -817,8 +816,8 @@ DefaultCommit<Impl>::commit()
     ////////////////////////////////////
     // Check for any possible squashes, handle them first
     ////////////////////////////////////
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     int num_squashing_threads = 0;
 
@@ -1097,7 +1096,8 @@ DefaultCommit<Impl>::commitInsts()
                            !thread[tid]->trapPending);
                     do {
                         oldpc = pc[tid].instAddr();
-                        cpu->system->pcEventQueue.service(thread[tid]->getTC());
+                        cpu->system->pcEventQueue.service(
+                            oldpc, thread[tid]->getTC());
                         count++;
                     } while (oldpc != pc[tid].instAddr());
                     if (count > 1) {
@@ -1293,11 +1293,9 @@ DefaultCommit<Impl>::commitHead(DynInstPtr &head_inst, unsigned inst_num)
     // Finally clear the head ROB entry.
     rob->retireHead(tid);
 
-#if TRACING_ON
-    if (DTRACE(O3PipeView)) {
+    if (cpu->tracePipeTimes()) {
         head_inst->commitTick = curTick() - head_inst->fetchTick;
     }
-#endif
 
     // If this was a store, record it for this cycle.
     if (head_inst->isStore())
@@ -1463,8 +1461,8 @@ template<class Impl>
 ThreadID
 DefaultCommit<Impl>::roundRobin()
 {
-    list<ThreadID>::iterator pri_iter = priority_list.begin();
-    list<ThreadID>::iterator end      = priority_list.end();
+    ThreadList::iterator pri_iter = priority_list.begin();
+    ThreadList::iterator end      = priority_list.end();
 
     while (pri_iter != end) {
         ThreadID tid = *pri_iter;
@@ -1494,8 +1492,8 @@ DefaultCommit<Impl>::oldestReady()
     unsigned oldest = 0;
     bool first = true;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
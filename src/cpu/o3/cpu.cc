@@ -147,6 +147,7 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
       instcount(0),
 #endif
       removeInstsThisCycle(false),
+      pipeTraceListeners(0),
       fetch(this, params),
       decode(this, params),
       rename(this, params),
@@ -665,7 +666,7 @@ template <class Impl>
 void
 FullO3CPU<Impl>::activateThread(ThreadID tid)
 {
-    list<ThreadID>::iterator isActive =
+    ThreadList::iterator isActive =
         std::find(activeThreads.begin(), activeThreads.end(), tid);
 
     DPRINTF(O3CPU, "[tid:%i]: Calling activate thread.\n", tid);
@@ -684,7 +685,7 @@ void
 FullO3CPU<Impl>::deactivateThread(ThreadID tid)
 {
     //Remove From Active List, if Active
-    list<ThreadID>::iterator thread_it =
+    ThreadList::iterator thread_it =
         std::find(activeThreads.begin(), activeThreads.end(), tid);
 
     DPRINTF(O3CPU, "[tid:%i]: Calling deactivate thread.\n", tid);
@@ -1563,12 +1564,10 @@ FullO3CPU<Impl>::squashFromTC(ThreadID tid)
 }
 
 template <class Impl>
-typename FullO3CPU<Impl>::ListIt
+typename FullO3CPU<Impl>::ListIdx
 FullO3CPU<Impl>::addInst(DynInstPtr &inst)
 {
-    instList.push_back(inst);
-
-    return --(instList.end());
+    return instList.push_back(inst);
 }
 
 template <class Impl>
@@ -1604,7 +1603,7 @@ FullO3CPU<Impl>::removeFrontInst(DynInstPtr &inst)
     removeInstsThisCycle = true;
 
     // Remove the front instruction.
-    removeList.push(inst->getInstListIt());
+    removeList.push_back(inst->getInstListIdx());
 }
 
 template <class Impl>
@@ -1614,7 +1613,7 @@ FullO3CPU<Impl>::removeInstsNotInROB(ThreadID tid)
     DPRINTF(O3CPU, "Thread %i: Deleting instructions from instruction"
             " list.\n", tid);
 
-    ListIt end_it;
+    ListIdx end_idx;
 
     bool rob_empty = false;
 
@@ -1622,33 +1621,31 @@ FullO3CPU<Impl>::removeInstsNotInROB(ThreadID tid)
         return;
     } else if (rob.isEmpty(tid)) {
         DPRINTF(O3CPU, "ROB is empty, squashing all insts.\n");
-        end_it = instList.begin();
+        end_idx = instList.begin();
         rob_empty = true;
     } else {
-        end_it = (rob.readTailInst(tid))->getInstListIt();
+        end_idx = (rob.readTailInst(tid))->getInstListIdx();
         DPRINTF(O3CPU, "ROB is not empty, squashing insts not in ROB.\n");
     }
 
     removeInstsThisCycle = true;
 
-    ListIt inst_it = instList.end();
-
-    inst_it--;
+    ListIdx inst_idx = instList.prev(instList.end());
 
     // Walk through the instruction list, removing any instructions
-    // that were inserted after the given instruction iterator, end_it.
-    while (inst_it != end_it) {
-        assert(!instList.empty());
+    // that were inserted after the given instruction index, end_idx.
+    while (inst_idx != end_idx) {
+        assert(instList.valid(inst_idx));
 
-        squashInstIt(inst_it, tid);
+        squashInstIt(inst_idx, tid);
 
-        inst_it--;
+        inst_idx = instList.prev(inst_idx);
     }
 
     // If the ROB was empty, then we actually need to remove the first
     // instruction as well.
     if (rob_empty) {
-        squashInstIt(inst_it, tid);
+        squashInstIt(inst_idx, tid);
     }
 }
 
@@ -1660,45 +1657,39 @@ FullO3CPU<Impl>::removeInstsUntil(const InstSeqNum &seq_num, ThreadID tid)
 
     removeInstsThisCycle = true;
 
-    ListIt inst_iter = instList.end();
-
-    inst_iter--;
+    ListIdx inst_idx = instList.prev(instList.end());
 
     DPRINTF(O3CPU, "Deleting instructions from instruction "
             "list that are from [tid:%i] and above [sn:%lli] (end=%lli).\n",
-            tid, seq_num, (*inst_iter)->seqNum);
-
-    while ((*inst_iter)->seqNum > seq_num) {
-
-        bool break_loop = (inst_iter == instList.begin());
+            tid, seq_num, instList[inst_idx]->seqNum);
 
-        squashInstIt(inst_iter, tid);
+    while (inst_idx != instList.end() &&
+           instList[inst_idx]->seqNum > seq_num) {
+        squashInstIt(inst_idx, tid);
 
-        inst_iter--;
-
-        if (break_loop)
-            break;
+        inst_idx = instList.prev(inst_idx);
     }
 }
 
 template <class Impl>
 inline void
-FullO3CPU<Impl>::squashInstIt(const ListIt &instIt, ThreadID tid)
+FullO3CPU<Impl>::squashInstIt(ListIdx idx, ThreadID tid)
 {
-    if ((*instIt)->threadNumber == tid) {
+    DynInstPtr &inst = instList[idx];
+    if (inst->threadNumber == tid) {
         DPRINTF(O3CPU, "Squashing instruction, "
                 "[tid:%i] [sn:%lli] PC %s\n",
-                (*instIt)->threadNumber,
-                (*instIt)->seqNum,
-                (*instIt)->pcState());
+                inst->threadNumber,
+                inst->seqNum,
+                inst->pcState());
 
         // Mark it as squashed.
-        (*instIt)->setSquashed();
+        inst->setSquashed();
 
         // @todo: Formulate a consistent method for deleting
         // instructions from the instruction list
         // Remove the instruction from the list.
-        removeList.push(instIt);
+        removeList.push_back(idx);
     }
 }
 
@@ -1706,17 +1697,18 @@ template <class Impl>
 void
 FullO3CPU<Impl>::cleanUpRemovedInsts()
 {
-    while (!removeList.empty()) {
-        DPRINTF(O3CPU, "Removing instruction, "
-                "[tid:%i] [sn:%lli] PC %s\n",
-                (*removeList.front())->threadNumber,
-                (*removeList.front())->seqNum,
-                (*removeList.front())->pcState());
-
-        instList.erase(removeList.front());
+    for (ListIdx idx : removeList) {
+        if (instList.valid(idx)) {
+            DPRINTF(O3CPU, "Removing instruction, "
+                    "[tid:%i] [sn:%lli] PC %s\n",
+                    instList[idx]->threadNumber,
+                    instList[idx]->seqNum,
+                    instList[idx]->pcState());
+        }
 
-        removeList.pop();
+        instList.erase(idx);
     }
+    removeList.clear();
 
     removeInstsThisCycle = false;
 }
@@ -1734,17 +1726,18 @@ FullO3CPU<Impl>::dumpInsts()
 {
     int num = 0;
 
-    ListIt inst_list_it = instList.begin();
+    ListIdx inst_idx = instList.begin();
 
     cprintf("Dumping Instruction List\n");
 
-    while (inst_list_it != instList.end()) {
+    while (inst_idx != instList.end()) {
+        const DynInstPtr &inst = instList[inst_idx];
         cprintf("Instruction:%i\nPC:%#x\n[tid:%i]\n[sn:%lli]\nIssued:%i\n"
                 "Squashed:%i\n\n",
-                num, (*inst_list_it)->instAddr(), (*inst_list_it)->threadNumber,
-                (*inst_list_it)->seqNum, (*inst_list_it)->isIssued(),
-                (*inst_list_it)->isSquashed());
-        inst_list_it++;
+                num, inst->instAddr(), inst->threadNumber,
+                inst->seqNum, inst->isIssued(),
+                inst->isSquashed());
+        inst_idx = instList.next(inst_idx);
         ++num;
     }
 }
@@ -1812,7 +1805,7 @@ FullO3CPU<Impl>::updateThreadPriority()
     if (activeThreads.size() > 1) {
         //DEFAULT TO ROUND ROBIN SCHEME
         //e.g. Move highest priority to end of thread list
-        list<ThreadID>::iterator list_begin = activeThreads.begin();
+        ThreadList::iterator list_begin = activeThreads.begin();
 
         unsigned high_thread = *list_begin;
 
@@ -55,16 +55,20 @@
 
 #include "arch/generic/types.hh"
 #include "arch/types.hh"
+#include "base/index_ring.hh"
 #include "base/statistics.hh"
+#include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/cpu_policy.hh"
 #include "cpu/o3/scoreboard.hh"
+#include "cpu/o3/thread_list.hh"
 #include "cpu/o3/thread_state.hh"
 #include "cpu/activity.hh"
 #include "cpu/base.hh"
 #include "cpu/simple_thread.hh"
 #include "cpu/timebuf.hh"
+#include "debug/O3PipeView.hh"
 //#include "cpu/o3/thread_context.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/process.hh"
@@ -110,7 +114,7 @@ class FullO3CPU : public BaseO3CPU
     typedef O3ThreadState<Impl> ImplState;
     typedef O3ThreadState<Impl> Thread;
 
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename IndexRing<DynInstPtr>::Index ListIdx;
 
     friend class O3ThreadContext<Impl>;
 
@@ -537,7 +541,7 @@ class FullO3CPU : public BaseO3CPU
     /** Function to add instruction onto the head of the list of the
      *  instructions.  Used when new instructions are fetched.
      */
-    ListIt addInst(DynInstPtr &inst);
+    ListIdx addInst(DynInstPtr &inst);
 
     /** Function to tell the CPU that an instruction has completed. */
     void instDone(ThreadID tid, DynInstPtr &inst);
@@ -554,8 +558,8 @@ class FullO3CPU : public BaseO3CPU
     /** Remove all instructions younger than the given sequence number. */
     void removeInstsUntil(const InstSeqNum &seq_num, ThreadID tid);
 
-    /** Removes the instruction pointed to by the iterator. */
-    inline void squashInstIt(const ListIt &instIt, ThreadID tid);
+    /** Removes the instruction at the given index of the list. */
+    inline void squashInstIt(ListIdx idx, ThreadID tid);
 
     /** Cleans up all instructions on the remove list. */
     void cleanUpRemovedInsts();
@@ -569,13 +573,16 @@ class FullO3CPU : public BaseO3CPU
     int instcount;
 #endif
 
-    /** List of all the instructions in flight. */
-    std::list<DynInstPtr> instList;
+    /** List of all the instructions in flight, oldest first. It is a
+     *  circular buffer rather than a std::list, so adding and removing
+     *  instructions doesn't allocate.
+     */
+    IndexRing<DynInstPtr> instList;
 
     /** List of all the instructions that will be removed at the end of this
      *  cycle.
      */
-    std::queue<ListIt> removeList;
+    std::vector<ListIdx> removeList;
 
 #ifdef DEBUG
     /** Debug structure to keep track of the sequence numbers still in
@@ -589,6 +596,18 @@ class FullO3CPU : public BaseO3CPU
      */
     bool removeInstsThisCycle;
 
+    /** Number of pipeline trace listeners attached to this CPU. */
+    unsigned pipeTraceListeners;
+
+    /** Whether to record the tick at which each instruction reaches
+     *  each stage, for the O3PipeView output or a pipeline trace.
+     */
+    bool
+    tracePipeTimes() const
+    {
+        return DTRACE(O3PipeView) || pipeTraceListeners;
+    }
+
   protected:
     /** The fetch stage. */
     typename CPUPolicy::Fetch fetch;
@@ -624,7 +643,7 @@ class FullO3CPU : public BaseO3CPU
     typename CPUPolicy::ROB rob;
 
     /** Active Threads List */
-    std::list<ThreadID> activeThreads;
+    ThreadList activeThreads;
 
     /** Integer Register Scoreboard */
     Scoreboard scoreboard;
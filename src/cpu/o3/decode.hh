@@ -46,6 +46,7 @@
 #include <queue>
 
 #include "base/statistics.hh"
+#include "cpu/o3/thread_list.hh"
 #include "cpu/timebuf.hh"
 
 struct DerivO3CPUParams;
@@ -120,7 +121,7 @@ class DefaultDecode
     void setFetchQueue(TimeBuffer<FetchStruct> *fq_ptr);
 
     /** Sets pointer to list of active threads. */
-    void setActiveThreads(std::list<ThreadID> *at_ptr);
+    void setActiveThreads(ThreadList *at_ptr);
 
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
@@ -276,7 +277,7 @@ class DefaultDecode
     ThreadID numThreads;
 
     /** List of active thread ids */
-    std::list<ThreadID> *activeThreads;
+    ThreadList *activeThreads;
 
     /** Maximum size of the skid buffer. */
     unsigned skidBufferMax;
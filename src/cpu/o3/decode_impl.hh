@@ -50,7 +50,6 @@
 #include "cpu/inst_seq.hh"
 #include "debug/Activity.hh"
 #include "debug/Decode.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/full_system.hh"
 
@@ -189,7 +188,7 @@ DefaultDecode<Impl>::setFetchQueue(TimeBuffer<FetchStruct> *fq_ptr)
 
 template<class Impl>
 void
-DefaultDecode<Impl>::setActiveThreads(std::list<ThreadID> *at_ptr)
+DefaultDecode<Impl>::setActiveThreads(ThreadList *at_ptr)
 {
     activeThreads = at_ptr;
 }
@@ -414,8 +413,8 @@ template<class Impl>
 bool
 DefaultDecode<Impl>::skidsEmpty()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -432,8 +431,8 @@ DefaultDecode<Impl>::updateStatus()
 {
     bool any_unblocking = false;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -556,8 +555,8 @@ DefaultDecode<Impl>::tick()
 
     toRenameIndex = 0;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     sortInsts();
 
@@ -698,11 +697,9 @@ DefaultDecode<Impl>::decodeInsts(ThreadID tid)
         ++decodeDecodedInsts;
         --insts_available;
 
-#if TRACING_ON
-        if (DTRACE(O3PipeView)) {
+        if (cpu->tracePipeTimes()) {
             inst->decodeTick = curTick() - inst->fetchTick;
         }
-#endif
 
         // Ensure that if it was predicted as a branch, it really is a
         // branch.
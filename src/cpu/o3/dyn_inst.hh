@@ -47,6 +47,7 @@
 #include <array>
 
 #include "arch/isa_traits.hh"
+#include "base/pool_alloc.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/cpu.hh"
 #include "cpu/o3/isa_specific.hh"
@@ -84,6 +85,23 @@ class BaseO3DynInst : public BaseDynInst<Impl>
         MaxInstDestRegs = TheISA::MaxInstDestRegs       //< Max dest regs
     };
 
+    /**
+     * A dynamic instruction is created for every fetched instruction
+     * and freed when the last reference to it goes away after it has
+     * committed or been squashed, so they are pooled. Recycled blocks
+     * tend to be the ones freed most recently, i.e., still in the
+     * host cache.
+     */
+    typedef PoolAllocator<BaseO3DynInst, 4096, 64> Pool;
+
+    static void *operator new(size_t size) { return Pool::allocate(size); }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        Pool::deallocate(p, size);
+    }
+
   public:
     /** BaseDynInst constructor given a binary instruction. */
     BaseO3DynInst(const StaticInstPtr &staticInst, const StaticInstPtr
@@ -129,8 +147,13 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
 
   public:
-#if TRACING_ON
-    /** Tick records used for the pipeline activity viewer. */
+    /** Slot of the instruction in the IQ with the bitmap scheduler, -1 if
+     *  it has none.
+     */
+    int iqSlot;
+
+    /** Tick records used for the pipeline activity viewer and the
+     *  pipeline trace, only kept when FullO3CPU::tracePipeTimes(). */
     Tick fetchTick;      // instruction fetch is completed.
     int32_t decodeTick;  // instruction enters decode phase
     int32_t renameTick;  // instruction enters rename phase
@@ -139,7 +162,6 @@ class BaseO3DynInst : public BaseDynInst<Impl>
     int32_t completeTick;
     int32_t commitTick;
     int32_t storeTick;
-#endif
 
     /** Reads a misc. register, including any side-effects the read
      * might have as defined by the architecture.
@@ -110,7 +110,8 @@ BaseO3DynInst<Impl>::initVars()
 
     _numDestMiscRegs = 0;
 
-#if TRACING_ON
+    iqSlot = -1;
+
     // Value -1 indicates that particular phase
     // hasn't happened (yet).
     fetchTick = -1;
@@ -121,7 +122,6 @@ BaseO3DynInst<Impl>::initVars()
     completeTick = -1;
     commitTick = -1;
     storeTick = -1;
-#endif
 }
 
 template <class Impl>
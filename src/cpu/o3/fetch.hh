@@ -46,7 +46,9 @@
 
 #include "arch/decoder.hh"
 #include "arch/utility.hh"
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
+#include "cpu/o3/thread_list.hh"
 #include "config/the_isa.hh"
 #include "cpu/pc_event.hh"
 #include "cpu/pred/bpred_unit.hh"
@@ -109,6 +111,31 @@ class DefaultFetch
         }
     };
 
+    /** Translation of a fetch-directed instruction prefetch. */
+    class PrefetchTranslation : public BaseTLB::Translation
+    {
+      protected:
+        DefaultFetch<Impl> *fetch;
+
+      public:
+        PrefetchTranslation(DefaultFetch<Impl> *_fetch)
+            : fetch(_fetch)
+        {}
+
+        void
+        markDelayed()
+        {}
+
+        void
+        finish(const Fault &fault, RequestPtr req, ThreadContext *tc,
+               BaseTLB::Mode mode)
+        {
+            assert(mode == BaseTLB::Execute);
+            fetch->finishPrefetchTranslation(fault, req);
+            delete this;
+        }
+    };
+
   private:
     /* Event to delay delivery of a fetch translation result in case of
      * a fault and the nop to carry the fault cannot be generated
@@ -193,7 +220,7 @@ class DefaultFetch
     FetchPriority fetchPolicy;
 
     /** List that has the threads organized by priority. */
-    std::list<ThreadID> priorityList;
+    ThreadList priorityList;
 
     /** Probe points. */
     ProbePointArg<DynInstPtr> *ppFetch;
@@ -217,7 +244,7 @@ class DefaultFetch
     void setTimeBuffer(TimeBuffer<TimeStruct> *time_buffer);
 
     /** Sets pointer to list of active threads. */
-    void setActiveThreads(std::list<ThreadID> *at_ptr);
+    void setActiveThreads(ThreadList *at_ptr);
 
     /** Sets pointer to time buffer used to communicate to the next stage. */
     void setFetchQueue(TimeBuffer<FetchStruct> *fq_ptr);
@@ -298,6 +325,9 @@ class DefaultFetch
     bool fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc);
     void finishTranslation(const Fault &fault, RequestPtr mem_req);
 
+    /** Sends a translated instruction prefetch to the icache. */
+    void finishPrefetchTranslation(const Fault &fault, RequestPtr mem_req);
+
 
     /** Check if an interrupt is pending and that we need to handle
      */
@@ -376,6 +406,9 @@ class DefaultFetch
     /** Returns the appropriate thread to fetch using the LSQ count policy. */
     ThreadID lsqCount();
 
+    /** Returns the fetchable thread with the lowest backend count. */
+    ThreadID lowestCount(unsigned TimeStruct::iewComm::*count);
+
     /** Returns the appropriate thread to fetch using the branch count
      * policy. */
     ThreadID branchCount();
@@ -383,6 +416,25 @@ class DefaultFetch
     /** Pipeline the next I-cache access to the current one. */
     void pipelineIcacheAccesses(ThreadID tid);
 
+    /**
+     * Restarts the fetch target queue of a thread from a PC, e.g.,
+     * after a squash.
+     */
+    void resetFTQ(ThreadID tid, Addr pc);
+
+    /**
+     * Tells the fetch target queue that fetch moved to the fetch buffer
+     * block holding vaddr. The queue is restarted from vaddr if that
+     * block isn't the one at its head.
+     */
+    void advanceFTQ(ThreadID tid, Addr vaddr);
+
+    /**
+     * Predicts the next fetch block of a thread using the BTB, adds it
+     * to the fetch target queue and prefetches its cache line.
+     */
+    void fillFTQ(ThreadID tid);
+
     /** Profile the reasons of fetch stall. */
     void profileStall(ThreadID tid);
 
@@ -501,7 +553,7 @@ class DefaultFetch
     Counter lastIcacheStall[Impl::MaxThreads];
 
     /** List of Active Threads */
-    std::list<ThreadID> *activeThreads;
+    ThreadList *activeThreads;
 
     /** Number of threads. */
     ThreadID numThreads;
@@ -523,6 +575,32 @@ class DefaultFetch
     /** Event used to delay fault generation of translation faults */
     FinishTranslationEvent finishTranslationEvent;
 
+    /**
+     * Size of the fetch target queues in fetch buffer blocks, or 0 if
+     * fetch-directed prefetching is disabled.
+     */
+    unsigned ftqSize;
+
+    /**
+     * Fetch target queues: start PCs of the fetch buffer blocks that the
+     * BTB predicts fetch will read next, oldest first. They run ahead of
+     * fetch and drive instruction prefetches, which hide icache misses
+     * on the predicted path.
+     */
+    CircularQueue<Addr> ftq[Impl::MaxThreads];
+
+    /** PC from which the fetch target queue predicts the next block. */
+    Addr ftqPC[Impl::MaxThreads];
+
+    /** Fetch buffer block fetch is reading, as seen by the queue. */
+    Addr ftqFetchBlock[Impl::MaxThreads];
+
+    /** Last cache line prefetched for the queue. */
+    Addr ftqLastLine[Impl::MaxThreads];
+
+    /** Number of prefetch translations in flight. */
+    unsigned pendingPrefetchTranslations;
+
     // @todo: Consider making these vectors and tracking on a per thread basis.
     /** Stat for total number of cycles stalled due to an icache miss. */
     Stats::Scalar icacheStallCycles;
@@ -566,6 +644,10 @@ class DefaultFetch
      * due to a squash.
      */
     Stats::Scalar fetchTlbSquashes;
+    /** Number of instruction prefetches sent for the fetch target queue. */
+    Stats::Scalar ftqPrefetches;
+    /** Number of times fetch left the path of the fetch target queue. */
+    Stats::Scalar ftqRestarts;
     /** Distribution of number of instructions fetched each cycle. */
     Stats::Distribution fetchNisnDist;
     /** Rate of how often fetch was idle. */
@@ -47,9 +47,6 @@
 
 #include <algorithm>
 #include <cstring>
-#include <list>
-#include <map>
-#include <queue>
 
 #include "arch/generic/tlb.hh"
 #include "arch/isa_traits.hh"
@@ -65,7 +62,6 @@
 #include "debug/Activity.hh"
 #include "debug/Drain.hh"
 #include "debug/Fetch.hh"
-#include "debug/O3PipeView.hh"
 #include "mem/packet.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/byteswap.hh"
@@ -94,7 +90,9 @@ DefaultFetch<Impl>::DefaultFetch(O3CPU *_cpu, DerivO3CPUParams *params)
       fetchQueueSize(params->fetchQueueSize),
       numThreads(params->numThreads),
       numFetchingThreads(params->smtNumFetchingThreads),
-      finishTranslationEvent(this)
+      finishTranslationEvent(this),
+      ftqSize(params->ftqSize),
+      pendingPrefetchTranslations(0)
 {
     if (numThreads > Impl::MaxThreads)
         fatal("numThreads (%d) is larger than compiled limit (%d),\n"
@@ -272,6 +270,18 @@ DefaultFetch<Impl>::regStats()
         .desc("Number of outstanding ITLB misses that were squashed")
         .prereq(fetchTlbSquashes);
 
+    ftqPrefetches
+        .name(name() + ".ftqPrefetches")
+        .desc("Number of instruction prefetches sent by the fetch target "
+              "queue")
+        .prereq(ftqPrefetches);
+
+    ftqRestarts
+        .name(name() + ".ftqRestarts")
+        .desc("Number of times fetch left the path predicted by the fetch "
+              "target queue")
+        .prereq(ftqRestarts);
+
     fetchNisnDist
         .init(/* base value */ 0,
               /* last value */ fetchWidth,
@@ -314,7 +324,7 @@ DefaultFetch<Impl>::setTimeBuffer(TimeBuffer<TimeStruct> *time_buffer)
 
 template<class Impl>
 void
-DefaultFetch<Impl>::setActiveThreads(std::list<ThreadID> *at_ptr)
+DefaultFetch<Impl>::setActiveThreads(ThreadList *at_ptr)
 {
     activeThreads = at_ptr;
 }
@@ -366,6 +376,7 @@ DefaultFetch<Impl>::resetStage()
         fetchBufferValid[tid] = false;
 
         fetchQueue[tid].clear();
+        resetFTQ(tid, pc[tid].instAddr());
 
         priorityList.push_back(tid);
     }
@@ -378,6 +389,13 @@ template<class Impl>
 void
 DefaultFetch<Impl>::processCacheCompletion(PacketPtr pkt)
 {
+    if (pkt->req->isPrefetch()) {
+        // Prefetch responses carry no data and nobody waits for them.
+        delete pkt->req;
+        delete pkt;
+        return;
+    }
+
     ThreadID tid = cpu->contextToThread(pkt->req->contextId());
 
     DPRINTF(Fetch, "[tid:%u] Waking up from cache miss.\n", tid);
@@ -474,9 +492,11 @@ DefaultFetch<Impl>::isDrained() const
 
     /* The pipeline might start up again in the middle of the drain
      * cycle if the finish translation event is scheduled, so make
-     * sure that's not the case.
+     * sure that's not the case. Prefetch translations must not finish
+     * after a switch either.
      */
-    return !finishTranslationEvent.scheduled();
+    return !finishTranslationEvent.scheduled() &&
+        pendingPrefetchTranslations == 0;
 }
 
 template <class Impl>
@@ -612,6 +632,9 @@ DefaultFetch<Impl>::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
         return false;
     }
 
+    if (ftqSize)
+        advanceFTQ(tid, vaddr);
+
     // Align the fetch address to the start of a fetch buffer segment.
     Addr fetchBufferBlockPC = fetchBufferAlignPC(vaddr);
 
@@ -789,6 +812,7 @@ DefaultFetch<Impl>::doSquash(const TheISA::PCState &newPC,
 
     // Empty fetch queue
     fetchQueue[tid].clear();
+    resetFTQ(tid, newPC.instAddr());
 
     // microops are being squashed, it is not known wheather the
     // youngest non-squashed microop was  marked delayed commit
@@ -835,8 +859,8 @@ typename DefaultFetch<Impl>::FetchStatus
 DefaultFetch<Impl>::updateFetchStatus()
 {
     //Check Running
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -888,8 +912,8 @@ template <class Impl>
 void
 DefaultFetch<Impl>::tick()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
     bool status_change = false;
 
     wroteToTimeBuffer = false;
@@ -933,6 +957,12 @@ DefaultFetch<Impl>::tick()
         _status = updateFetchStatus();
     }
 
+    // Let the fetch target queues run ahead of fetch.
+    if (ftqSize) {
+        for (auto tid : *activeThreads)
+            fillFTQ(tid);
+    }
+
     // Issue the next I-cache request if possible.
     for (ThreadID i = 0; i < numThreads; ++i) {
         if (issuePipelinedIfetch[i]) {
@@ -1128,7 +1158,7 @@ DefaultFetch<Impl>::buildInst(ThreadID tid, StaticInstPtr staticInst,
 #endif
 
     // Add instruction to the CPU's list of instructions.
-    instruction->setInstListIt(cpu->addInst(instruction));
+    instruction->setInstListIdx(cpu->addInst(instruction));
 
     // Write the instruction to the first slot in the queue
     // that heads to decode.
@@ -1329,11 +1359,9 @@ DefaultFetch<Impl>::fetch(bool &status_change)
             ppFetch->notify(instruction);
             numInst++;
 
-#if TRACING_ON
-            if (DTRACE(O3PipeView)) {
+            if (cpu->tracePipeTimes()) {
                 instruction->fetchTick = curTick();
             }
-#endif
 
             nextPC = thisPC;
 
@@ -1465,7 +1493,7 @@ DefaultFetch<Impl>::getFetchingThread(FetchPriority &fetch_priority)
             return InvalidThreadID;
         }
     } else {
-        list<ThreadID>::iterator thread = activeThreads->begin();
+        ThreadList::iterator thread = activeThreads->begin();
         if (thread == activeThreads->end()) {
             return InvalidThreadID;
         }
@@ -1487,8 +1515,8 @@ template<class Impl>
 ThreadID
 DefaultFetch<Impl>::roundRobin()
 {
-    list<ThreadID>::iterator pri_iter = priorityList.begin();
-    list<ThreadID>::iterator end      = priorityList.end();
+    ThreadList::iterator pri_iter = priorityList.begin();
+    ThreadList::iterator end      = priorityList.end();
 
     ThreadID high_pri;
 
@@ -1515,75 +1543,42 @@ DefaultFetch<Impl>::roundRobin()
 
 template<class Impl>
 ThreadID
-DefaultFetch<Impl>::iqCount()
+DefaultFetch<Impl>::lowestCount(unsigned TimeStruct::iewComm::*count)
 {
-    //sorted from lowest->highest
-    std::priority_queue<unsigned,vector<unsigned>,
-                        std::greater<unsigned> > PQ;
-    std::map<unsigned, ThreadID> threadMap;
-
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
-
-    while (threads != end) {
-        ThreadID tid = *threads++;
-        unsigned iqCount = fromIEW->iewInfo[tid].iqCount;
-
-        //we can potentially get tid collisions if two threads
-        //have the same iqCount, but this should be rare.
-        PQ.push(iqCount);
-        threadMap[iqCount] = tid;
+    // A single pass over the active threads finds the fetchable
+    // thread with the fewest instructions in the backend. Ties go to
+    // the thread first in the active list, which the CPU rotates.
+    ThreadID high_pri = InvalidThreadID;
+    unsigned lowest = 0;
+
+    for (ThreadID tid : *activeThreads) {
+        if (fetchStatus[tid] != Running &&
+            fetchStatus[tid] != IcacheAccessComplete &&
+            fetchStatus[tid] != Idle)
+            continue;
+
+        const unsigned tid_count = fromIEW->iewInfo[tid].*count;
+        if (high_pri == InvalidThreadID || tid_count < lowest) {
+            high_pri = tid;
+            lowest = tid_count;
+        }
     }
 
-    while (!PQ.empty()) {
-        ThreadID high_pri = threadMap[PQ.top()];
-
-        if (fetchStatus[high_pri] == Running ||
-            fetchStatus[high_pri] == IcacheAccessComplete ||
-            fetchStatus[high_pri] == Idle)
-            return high_pri;
-        else
-            PQ.pop();
-
-    }
+    return high_pri;
+}
 
-    return InvalidThreadID;
+template<class Impl>
+ThreadID
+DefaultFetch<Impl>::iqCount()
+{
+    return lowestCount(&TimeStruct::iewComm::iqCount);
 }
 
 template<class Impl>
 ThreadID
 DefaultFetch<Impl>::lsqCount()
 {
-    //sorted from lowest->highest
-    std::priority_queue<unsigned,vector<unsigned>,
-                        std::greater<unsigned> > PQ;
-    std::map<unsigned, ThreadID> threadMap;
-
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
-
-    while (threads != end) {
-        ThreadID tid = *threads++;
-        unsigned ldstqCount = fromIEW->iewInfo[tid].ldstqCount;
-
-        //we can potentially get tid collisions if two threads
-        //have the same iqCount, but this should be rare.
-        PQ.push(ldstqCount);
-        threadMap[ldstqCount] = tid;
-    }
-
-    while (!PQ.empty()) {
-        ThreadID high_pri = threadMap[PQ.top()];
-
-        if (fetchStatus[high_pri] == Running ||
-            fetchStatus[high_pri] == IcacheAccessComplete ||
-            fetchStatus[high_pri] == Idle)
-            return high_pri;
-        else
-            PQ.pop();
-    }
-
-    return InvalidThreadID;
+    return lowestCount(&TimeStruct::iewComm::ldstqCount);
 }
 
 template<class Impl>
@@ -1591,7 +1586,7 @@ ThreadID
 DefaultFetch<Impl>::branchCount()
 {
 #if 0
-    list<ThreadID>::iterator thread = activeThreads->begin();
+    ThreadList::iterator thread = activeThreads->begin();
     assert(thread != activeThreads->end());
     ThreadID tid = *thread;
 #endif
@@ -1630,6 +1625,121 @@ DefaultFetch<Impl>::pipelineIcacheAccesses(ThreadID tid)
     }
 }
 
+template<class Impl>
+void
+DefaultFetch<Impl>::resetFTQ(ThreadID tid, Addr pc)
+{
+    ftq[tid].clear();
+    ftqPC[tid] = pc;
+    ftqFetchBlock[tid] = fetchBufferAlignPC(pc);
+    ftqLastLine[tid] = pc & ~Addr(cacheBlkSize - 1);
+}
+
+template<class Impl>
+void
+DefaultFetch<Impl>::advanceFTQ(ThreadID tid, Addr vaddr)
+{
+    const Addr block = fetchBufferAlignPC(vaddr);
+    if (block == ftqFetchBlock[tid])
+        return;
+
+    if (!ftq[tid].empty()) {
+        if (fetchBufferAlignPC(ftq[tid].front()) == block) {
+            ftqFetchBlock[tid] = block;
+            ftq[tid].pop_front();
+            return;
+        }
+
+        DPRINTF(Fetch, "[tid:%i]: Fetch target queue mispredicted %#x, "
+                "restarting.\n", tid, vaddr);
+        ++ftqRestarts;
+    }
+
+    resetFTQ(tid, vaddr);
+}
+
+template<class Impl>
+void
+DefaultFetch<Impl>::fillFTQ(ThreadID tid)
+{
+    if (ftq[tid].size() >= ftqSize || stalls[tid].drain)
+        return;
+
+    switch (fetchStatus[tid]) {
+      case Idle:
+      case Squashing:
+      case TrapPending:
+      case QuiescePending:
+        return;
+      default:
+        break;
+    }
+
+    // Fetch leaves a block at the first taken branch in it. Only taken
+    // branches are in the BTB, so a BTB hit is predicted taken.
+    const Addr block_end = fetchBufferAlignPC(ftqPC[tid]) + fetchBufferSize;
+    Addr next = block_end;
+    for (Addr addr = ftqPC[tid]; addr < block_end; addr += instSize) {
+        if (branchPred->BTBValid(addr)) {
+            next = branchPred->BTBLookup(addr).instAddr();
+            break;
+        }
+    }
+
+    ftq[tid].push_back(next);
+    ftqPC[tid] = next;
+
+    const Addr line = next & ~Addr(cacheBlkSize - 1);
+    if (line == ftqLastLine[tid])
+        return;
+    ftqLastLine[tid] = line;
+
+    DPRINTF(Fetch, "[tid:%i]: Prefetching cache line %#x for fetch target "
+            "%#x.\n", tid, line, next);
+
+    RequestPtr mem_req =
+        new Request(tid, line, cacheBlkSize,
+                    Request::INST_FETCH | Request::PREFETCH,
+                    cpu->instMasterId(), next,
+                    cpu->thread[tid]->contextId());
+    mem_req->taskId(cpu->taskId());
+
+    ++pendingPrefetchTranslations;
+    cpu->itb->translateTiming(mem_req, cpu->thread[tid]->getTC(),
+                              new PrefetchTranslation(this),
+                              BaseTLB::Execute);
+}
+
+template<class Impl>
+void
+DefaultFetch<Impl>::finishPrefetchTranslation(const Fault &fault,
+                                              RequestPtr mem_req)
+{
+    assert(pendingPrefetchTranslations > 0);
+    --pendingPrefetchTranslations;
+
+    // Prefetches are best effort: drop them rather than fault, touch
+    // uncacheable memory, or wait for a blocked cache.
+    if (fault != NoFault || mem_req->isUncacheable() || cacheBlocked ||
+        cpu->switchedOut()) {
+        delete mem_req;
+        return;
+    }
+
+    PacketPtr pkt = new Packet(mem_req, MemCmd::SoftPFReq);
+    pkt->dataDynamic(new uint8_t[cacheBlkSize]);
+
+    if (!cpu->getInstPort().sendTimingReq(pkt)) {
+        // The cache will ask for a retry, which unblocks fetch.
+        cacheBlocked = true;
+        delete mem_req;
+        delete pkt;
+        return;
+    }
+
+    ++ftqPrefetches;
+}
+
 template<class Impl>
 void
 DefaultFetch<Impl>::profileStall(ThreadID tid) {
@@ -44,8 +44,9 @@
 #ifndef __CPU_O3_FREE_LIST_HH__
 #define __CPU_O3_FREE_LIST_HH__
 
+#include <algorithm>
 #include <iostream>
-#include <queue>
+#include <iterator>
 #include <vector>
 
 #include "base/logging.hh"
@@ -65,40 +66,102 @@ class SimpleFreeList
 {
   private:
 
-    /** The actual free list */
-    std::queue<PhysRegIdPtr> freeRegs;
+    /**
+     * The actual free list. It's kept as a ring, rather than a queue, so
+     * that registers handed out by getReg() stay in their slots behind
+     * the head until the ring wraps around to them. Rename can then give
+     * registers back in the opposite order to the one it took them in,
+     * or give back everything taken since a saved head position, just by
+     * moving the head.
+     */
+    std::vector<PhysRegIdPtr> freeRegs;
+
+    /** Position of the head, the number of registers ever taken. */
+    uint64_t head;
+
+    /** Position of the tail, the number of registers ever added. */
+    uint64_t tail;
+
+    PhysRegIdPtr &
+    slot(uint64_t pos)
+    {
+        return freeRegs[pos % freeRegs.size()];
+    }
+
+    /**
+     * Make room for at least size registers. This moves the registers
+     * in the ring, so positions saved before this are no longer valid.
+     */
+    void
+    resize(size_t size)
+    {
+        std::vector<PhysRegIdPtr> new_regs(size);
+        for (uint64_t pos = head; pos != tail; pos++)
+            new_regs[pos % size] = slot(pos);
+        freeRegs.swap(new_regs);
+    }
 
   public:
 
-    SimpleFreeList() {};
+    SimpleFreeList() : head(0), tail(0) {};
 
     /** Add a physical register to the free list */
-    void addReg(PhysRegIdPtr reg) { freeRegs.push(reg); }
+    void
+    addReg(PhysRegIdPtr reg)
+    {
+        if (tail - head == freeRegs.size())
+            resize(2 * freeRegs.size() + 1);
+        slot(tail++) = reg;
+    }
 
     /** Add physical registers to the free list */
     template<class InputIt>
     void
     addRegs(InputIt first, InputIt last) {
+        size_t needed = tail - head + std::distance(first, last);
+        if (needed > freeRegs.size())
+            resize(needed);
         std::for_each(first, last,
             [this](const typename InputIt::value_type& reg) {
-                this->freeRegs.push(&reg);
+                this->slot(this->tail++) = &reg;
             });
     }
 
     /** Get the next available register from the free list */
     PhysRegIdPtr getReg()
     {
-        assert(!freeRegs.empty());
-        PhysRegIdPtr free_reg = freeRegs.front();
-        freeRegs.pop();
-        return free_reg;
+        assert(hasFreeRegs());
+        return slot(head++);
+    }
+
+    /**
+     * Give back the register most recently returned by getReg() that
+     * hasn't been given back already.
+     */
+    void
+    undoGetReg(PhysRegIdPtr reg)
+    {
+        assert(tail - head < freeRegs.size());
+        assert(slot(head - 1) == reg);
+        head--;
+    }
+
+    /** The position of the head, to be passed to restoreHead(). */
+    uint64_t headPos() const { return head; }
+
+    /** Give back all the registers taken since headPos() returned pos. */
+    void
+    restoreHead(uint64_t pos)
+    {
+        assert(pos <= head && tail - pos <= freeRegs.size());
+        head = pos;
     }
 
     /** Return the number of free registers on the list. */
-    unsigned numFreeRegs() const { return freeRegs.size(); }
+    unsigned numFreeRegs() const { return tail - head; }
 
     /** True iff there are free registers on the list. */
-    bool hasFreeRegs() const { return !freeRegs.empty(); }
+    bool hasFreeRegs() const { return tail != head; }
 };
 
 
@@ -210,6 +273,46 @@ class UnifiedFreeList
     /** Adds a cc register back to the free list. */
     void addCCReg(PhysRegIdPtr freed_reg) { ccList.addReg(freed_reg); }
 
+    /**
+     * Puts back a register taken by the rename map, as when squashing
+     * the instruction it was renamed for. Registers have to be put back
+     * youngest first, and only while a single thread is renaming.
+     */
+    void undoGetReg(PhysRegIdPtr reg);
+
+    /** Head positions of each of the per-class lists. */
+    struct Heads
+    {
+        uint64_t intHead;
+        uint64_t floatHead;
+        uint64_t vecHead;
+        uint64_t vecElemHead;
+        uint64_t ccHead;
+    };
+
+    /** Save the current head positions. */
+    Heads
+    heads() const
+    {
+        return Heads{intList.headPos(), floatList.headPos(),
+                     vecList.headPos(), vecElemList.headPos(),
+                     ccList.headPos()};
+    }
+
+    /**
+     * Put back every register taken since heads() returned saved. The
+     * same restrictions apply as for undoGetReg().
+     */
+    void
+    restoreHeads(const Heads &saved)
+    {
+        intList.restoreHead(saved.intHead);
+        floatList.restoreHead(saved.floatHead);
+        vecList.restoreHead(saved.vecHead);
+        vecElemList.restoreHead(saved.vecElemHead);
+        ccList.restoreHead(saved.ccHead);
+    }
+
     /** Checks if there are any free integer registers. */
     bool hasFreeIntRegs() const { return intList.hasFreeRegs(); }
 
@@ -315,5 +418,32 @@ UnifiedFreeList::addReg(PhysRegIdPtr freed_reg)
     // assert(freeFloatRegs.size() <= numPhysicalFloatRegs);
 }
 
+inline void
+UnifiedFreeList::undoGetReg(PhysRegIdPtr reg)
+{
+    DPRINTF(FreeList,"Returning register %i (%s).\n", reg->index(),
+            reg->className());
+    switch (reg->classValue()) {
+        case IntRegClass:
+            intList.undoGetReg(reg);
+            break;
+        case FloatRegClass:
+            floatList.undoGetReg(reg);
+            break;
+        case VecRegClass:
+            vecList.undoGetReg(reg);
+            break;
+        case VecElemClass:
+            vecElemList.undoGetReg(reg);
+            break;
+        case CCRegClass:
+            ccList.undoGetReg(reg);
+            break;
+        default:
+            panic("Unexpected RegClass (%s)",
+                                   reg->className());
+    }
+}
+
 
 #endif // __CPU_O3_FREE_LIST_HH__
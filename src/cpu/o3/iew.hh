@@ -50,6 +50,7 @@
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/lsq.hh"
 #include "cpu/o3/scoreboard.hh"
+#include "cpu/o3/thread_list.hh"
 #include "cpu/timebuf.hh"
 #include "debug/IEW.hh"
 #include "sim/probe/probe.hh"
@@ -157,7 +158,7 @@ class DefaultIEW
     void setIEWQueue(TimeBuffer<IEWStruct> *iq_ptr);
 
     /** Sets pointer to list of active threads. */
-    void setActiveThreads(std::list<ThreadID> *at_ptr);
+    void setActiveThreads(ThreadList *at_ptr);
 
     /** Sets pointer to the scoreboard. */
     void setScoreboard(Scoreboard *sb_ptr);
@@ -410,7 +411,7 @@ class DefaultIEW
     ThreadID numThreads;
 
     /** Pointer to list of active threads. */
-    std::list<ThreadID> *activeThreads;
+    ThreadList *activeThreads;
 
     /** Maximum size of the skid buffer. */
     unsigned skidBufferMax;
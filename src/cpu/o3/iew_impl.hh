@@ -59,7 +59,6 @@
 #include "debug/Activity.hh"
 #include "debug/Drain.hh"
 #include "debug/IEW.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 
 using namespace std;
@@ -361,7 +360,7 @@ DefaultIEW<Impl>::setIEWQueue(TimeBuffer<IEWStruct> *iq_ptr)
 
 template<class Impl>
 void
-DefaultIEW<Impl>::setActiveThreads(list<ThreadID> *at_ptr)
+DefaultIEW<Impl>::setActiveThreads(ThreadList *at_ptr)
 {
     activeThreads = at_ptr;
 
@@ -670,8 +669,8 @@ DefaultIEW<Impl>::skidCount()
 {
     int max=0;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -687,8 +686,8 @@ template<class Impl>
 bool
 DefaultIEW<Impl>::skidsEmpty()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -706,8 +705,8 @@ DefaultIEW<Impl>::updateStatus()
 {
     bool any_unblocking = false;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -1127,9 +1126,7 @@ DefaultIEW<Impl>::dispatchInsts(ThreadID tid)
 
         ++iewDispatchedInsts;
 
-#if TRACING_ON
         inst->dispatchTick = curTick() - inst->fetchTick;
-#endif
         ppDispatch->notify(inst);
     }
 
@@ -1178,8 +1175,8 @@ DefaultIEW<Impl>::executeInsts()
     wbNumInst = 0;
     wbCycle = 0;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -1463,8 +1460,8 @@ DefaultIEW<Impl>::tick()
     // Free function units marked as being freed this cycle.
     fuPool->processFreeUnits();
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     // Check stall and squash signals, dispatch any instructions.
     while (threads != end) {
@@ -1584,11 +1581,9 @@ DefaultIEW<Impl>::updateExeInstStats(DynInstPtr &inst)
 
     iewExecutedInsts++;
 
-#if TRACING_ON
-    if (DTRACE(O3PipeView)) {
+    if (cpu->tracePipeTimes()) {
         inst->completeTick = curTick() - inst->fetchTick;
     }
-#endif
 
     //
     //  Control operations
@@ -44,6 +44,8 @@
 #ifndef __CPU_O3_INST_QUEUE_HH__
 #define __CPU_O3_INST_QUEUE_HH__
 
+#include <array>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <queue>
@@ -52,6 +54,7 @@
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/o3/dep_graph.hh"
+#include "cpu/o3/thread_list.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/op_class.hh"
 #include "cpu/timebuf.hh"
@@ -76,6 +79,9 @@ class MemInterface;
  * requiring IEW to be able to peek into the IQ. At the end of the execution
  * latency, the instruction is put into the queue to execute, where it will
  * have the execute() function called on it.
+ * Optionally, dependencies and ready instructions are tracked with bitmaps
+ * over the IQ entries instead of the dependency graph and the ready queues
+ * (see iqBitmapScheduler).
  * @todo: Make IQ able to handle multiple FU pools.
  */
 template <class Impl>
@@ -137,7 +143,7 @@ class InstructionQueue
     void resetState();
 
     /** Sets active threads list. */
-    void setActiveThreads(std::list<ThreadID> *at_ptr);
+    void setActiveThreads(ThreadList *at_ptr);
 
     /** Sets the timer buffer between issue and execute. */
     void setIssueToExecuteQueue(TimeBuffer<IssueStruct> *i2eQueue);
@@ -275,6 +281,12 @@ class InstructionQueue
     /** Does the actual squashing. */
     void doSquash(ThreadID tid);
 
+    /**
+     * Issues an instruction if a FU that can execute it is free.
+     * Returns false if all such FUs are busy.
+     */
+    bool issueInst(DynInstPtr &issuing_inst, IssueStruct *i2e_info);
+
     /////////////////////////
     // Various pointers
     /////////////////////////
@@ -399,6 +411,77 @@ class InstructionQueue
 
     DependencyGraph<DynInstPtr> dependGraph;
 
+    //////////////////////////////////////
+    // Bitmap scheduler
+    //////////////////////////////////////
+
+    /**
+     * Are dependencies and ready instructions tracked with bitmaps over
+     * the IQ entries (slots)? A set bit in the consumer bitmap of a
+     * physical register marks an instruction waiting for it, and a set
+     * bit in the ready bitmap of an op class an instruction ready to
+     * issue. Neither wakeup nor select allocate, and instructions are
+     * selected oldest first, as with the ready queues.
+     */
+    bool bitmapScheduler;
+
+    /** Number of 64-bit words in a bitmap over the slots. */
+    int slotWords;
+
+    /** Instruction held by each slot. */
+    std::vector<DynInstPtr> slotInsts;
+
+    /** Sequence number of the instruction held by each slot. */
+    std::vector<InstSeqNum> slotSeqNums;
+
+    /** Slots that hold no instruction. */
+    std::vector<int> freeSlots;
+
+    /** Consumer bitmap of each physical register, slotWords words each. */
+    std::vector<uint64_t> regConsumers;
+
+    /** Ready bitmap of each op class, slotWords words each. */
+    std::vector<uint64_t> readySlots;
+
+    /** Number of ready instructions of each op class. */
+    std::array<int, Num_OpClasses> numReadySlots;
+
+    /** Slot of the oldest ready instruction of each op class, or -1. */
+    std::array<int, Num_OpClasses> oldestReadySlot;
+
+    /** Number of ready instructions of all op classes. */
+    int totalReadySlots;
+
+    /** Gives an instruction entering the IQ a slot. */
+    void allocSlot(DynInstPtr &inst);
+
+    /** Takes the slot of an instruction leaving the IQ, if it has one. */
+    void freeSlot(DynInstPtr &inst);
+
+    /** Marks the instruction in a slot as ready to issue. */
+    void setSlotReady(DynInstPtr &inst);
+
+    /** Marks the instruction in a slot as not ready to issue. */
+    void clearSlotReady(int slot, OpClass op_class);
+
+    /** Finds the oldest ready instruction of an op class. */
+    void findOldestReadySlot(OpClass op_class);
+
+    /** Does any instruction wait for a physical register? */
+    bool hasConsumers(PhysRegIndex reg) const;
+
+    /** Does any instruction wait for any physical register? */
+    bool hasConsumers() const;
+
+    /**
+     * Marks the sources of the instructions waiting for a physical
+     * register as ready. Returns the number of sources woken up.
+     */
+    int wakeSlots(PhysRegIndex reg);
+
+    /** Bitmap scheduler version of scheduleReadyInsts(). */
+    int scheduleReadySlots(IssueStruct *i2e_info);
+
     //////////////////////////////////////
     // Various parameters
     //////////////////////////////////////
@@ -417,7 +500,7 @@ class InstructionQueue
     ThreadID numThreads;
 
     /** Pointer to list of active threads. */
-    std::list<ThreadID> *activeThreads;
+    ThreadList *activeThreads;
 
     /** Per Thread IQ count */
     unsigned count[Impl::MaxThreads];
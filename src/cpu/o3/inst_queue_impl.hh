@@ -48,6 +48,7 @@
 #include <limits>
 #include <vector>
 
+#include "base/bitfield.hh"
 #include "cpu/o3/fu_pool.hh"
 #include "cpu/o3/inst_queue.hh"
 #include "debug/IQ.hh"
@@ -108,6 +109,16 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
     //dependency graph.
     dependGraph.resize(numPhysRegs);
 
+    bitmapScheduler = params->iqBitmapScheduler;
+    slotWords = (numEntries + 63) / 64;
+    if (bitmapScheduler) {
+        slotInsts.resize(numEntries);
+        slotSeqNums.resize(numEntries);
+        freeSlots.reserve(numEntries);
+        regConsumers.resize(numPhysRegs * slotWords);
+        readySlots.resize(Num_OpClasses * slotWords);
+    }
+
     // Resize the register scoreboard.
     regScoreboard.resize(numPhysRegs);
 
@@ -435,6 +446,20 @@ InstructionQueue<Impl>::resetState()
     }
     nonSpecInsts.clear();
     listOrder.clear();
+
+    if (bitmapScheduler) {
+        freeSlots.clear();
+        for (int slot = numEntries - 1; slot >= 0; --slot) {
+            slotInsts[slot] = NULL;
+            freeSlots.push_back(slot);
+        }
+        std::fill(regConsumers.begin(), regConsumers.end(), 0);
+        std::fill(readySlots.begin(), readySlots.end(), 0);
+        numReadySlots.fill(0);
+        oldestReadySlot.fill(-1);
+        totalReadySlots = 0;
+    }
+
     deferredMemInsts.clear();
     blockedMemInsts.clear();
     retryMemInsts.clear();
@@ -443,7 +468,7 @@ InstructionQueue<Impl>::resetState()
 
 template <class Impl>
 void
-InstructionQueue<Impl>::setActiveThreads(list<ThreadID> *at_ptr)
+InstructionQueue<Impl>::setActiveThreads(ThreadList *at_ptr)
 {
     activeThreads = at_ptr;
 }
@@ -468,7 +493,7 @@ template <class Impl>
 bool
 InstructionQueue<Impl>::isDrained() const
 {
-    bool drained = dependGraph.empty() &&
+    bool drained = dependGraph.empty() && !hasConsumers() &&
                    instsToExecute.empty() &&
                    wbOutstanding == 0;
     for (ThreadID tid = 0; tid < numThreads; ++tid)
@@ -482,6 +507,7 @@ void
 InstructionQueue<Impl>::drainSanityCheck() const
 {
     assert(dependGraph.empty());
+    assert(!hasConsumers());
     assert(instsToExecute.empty());
     for (ThreadID tid = 0; tid < numThreads; ++tid)
         memDepUnit[tid].drainSanityCheck();
@@ -513,8 +539,8 @@ InstructionQueue<Impl>::resetEntries()
     if (iqPolicy != Dynamic || numThreads > 1) {
         int active_threads = activeThreads->size();
 
-        list<ThreadID>::iterator threads = activeThreads->begin();
-        list<ThreadID>::iterator end = activeThreads->end();
+        ThreadList::iterator threads = activeThreads->begin();
+        ThreadList::iterator end = activeThreads->end();
 
         while (threads != end) {
             ThreadID tid = *threads++;
@@ -570,7 +596,7 @@ template <class Impl>
 bool
 InstructionQueue<Impl>::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
+    if (!listOrder.empty() || totalReadySlots) {
         return true;
     }
 
@@ -607,6 +633,7 @@ InstructionQueue<Impl>::insert(DynInstPtr &new_inst)
     --freeEntries;
 
     new_inst->setInIQ();
+    allocSlot(new_inst);
 
     // Look through its source registers (physical regs), and mark any
     // dependencies.
@@ -658,6 +685,7 @@ InstructionQueue<Impl>::insertNonSpec(DynInstPtr &new_inst)
     --freeEntries;
 
     new_inst->setInIQ();
+    allocSlot(new_inst);
 
     // Have this instruction set itself as the producer of its destination
     // register(s).
@@ -807,6 +835,10 @@ InstructionQueue<Impl>::scheduleReadyInsts()
     // This will avoid trying to schedule a certain op class if there are no
     // FUs that handle it.
     int total_issued = 0;
+
+    if (bitmapScheduler)
+        total_issued = scheduleReadySlots(i2e_info);
+
     ListOrderIt order_it = listOrder.begin();
     ListOrderIt order_end_it = listOrder.end();
 
@@ -844,60 +876,7 @@ InstructionQueue<Impl>::scheduleReadyInsts()
             continue;
         }
 
-        int idx = FUPool::NoCapableFU;
-        Cycles op_latency = Cycles(1);
-        ThreadID tid = issuing_inst->threadNumber;
-
-        if (op_class != No_OpClass) {
-            idx = fuPool->getUnit(op_class);
-            if (issuing_inst->isFloating()) {
-                fpAluAccesses++;
-            } else if (issuing_inst->isVector()) {
-                vecAluAccesses++;
-            } else {
-                intAluAccesses++;
-            }
-            if (idx > FUPool::NoFreeFU) {
-                op_latency = fuPool->getOpLatency(op_class);
-            }
-        }
-
-        // If we have an instruction that doesn't require a FU, or a
-        // valid FU, then schedule for execution.
-        if (idx != FUPool::NoFreeFU) {
-            if (op_latency == Cycles(1)) {
-                i2e_info->size++;
-                instsToExecute.push_back(issuing_inst);
-
-                // Add the FU onto the list of FU's to be freed next
-                // cycle if we used one.
-                if (idx >= 0)
-                    fuPool->freeUnitNextCycle(idx);
-            } else {
-                bool pipelined = fuPool->isPipelined(op_class);
-                // Generate completion event for the FU
-                ++wbOutstanding;
-                FUCompletion *execution = new FUCompletion(issuing_inst,
-                                                           idx, this);
-
-                cpu->schedule(execution,
-                              cpu->clockEdge(Cycles(op_latency - 1)));
-
-                if (!pipelined) {
-                    // If FU isn't pipelined, then it must be freed
-                    // upon the execution completing.
-                    execution->setFreeFU();
-                } else {
-                    // Add the FU onto the list of FU's to be freed next cycle.
-                    fuPool->freeUnitNextCycle(idx);
-                }
-            }
-
-            DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
-                    "[sn:%lli]\n",
-                    tid, issuing_inst->pcState(),
-                    issuing_inst->seqNum);
-
+        if (issueInst(issuing_inst, i2e_info)) {
             readyInsts[op_class].pop();
 
             if (!readyInsts[op_class].empty()) {
@@ -907,28 +886,10 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                 queueOnList[op_class] = false;
             }
 
-            issuing_inst->setIssued();
             ++total_issued;
 
-#if TRACING_ON
-            issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
-#endif
-
-            if (!issuing_inst->isMemRef()) {
-                // Memory instructions can not be freed from the IQ until they
-                // complete.
-                ++freeEntries;
-                count[tid]--;
-                issuing_inst->clearInIQ();
-            } else {
-                memDepUnit[tid].issue(issuing_inst);
-            }
-
             listOrder.erase(order_it++);
-            statIssuedInstType[tid][op_class]++;
         } else {
-            statFuBusy[op_class]++;
-            fuBusy[tid]++;
             ++order_it;
         }
     }
@@ -947,6 +908,91 @@ InstructionQueue<Impl>::scheduleReadyInsts()
     }
 }
 
+template <class Impl>
+bool
+InstructionQueue<Impl>::issueInst(DynInstPtr &issuing_inst,
+                                  IssueStruct *i2e_info)
+{
+    OpClass op_class = issuing_inst->opClass();
+    int idx = FUPool::NoCapableFU;
+    Cycles op_latency = Cycles(1);
+    ThreadID tid = issuing_inst->threadNumber;
+
+    if (op_class != No_OpClass) {
+        idx = fuPool->getUnit(op_class);
+        if (issuing_inst->isFloating()) {
+            fpAluAccesses++;
+        } else if (issuing_inst->isVector()) {
+            vecAluAccesses++;
+        } else {
+            intAluAccesses++;
+        }
+        if (idx > FUPool::NoFreeFU) {
+            op_latency = fuPool->getOpLatency(op_class);
+        }
+    }
+
+    // If we have an instruction that doesn't require a FU, or a
+    // valid FU, then schedule for execution.
+    if (idx == FUPool::NoFreeFU) {
+        statFuBusy[op_class]++;
+        fuBusy[tid]++;
+        return false;
+    }
+
+    if (op_latency == Cycles(1)) {
+        i2e_info->size++;
+        instsToExecute.push_back(issuing_inst);
+
+        // Add the FU onto the list of FU's to be freed next
+        // cycle if we used one.
+        if (idx >= 0)
+            fuPool->freeUnitNextCycle(idx);
+    } else {
+        bool pipelined = fuPool->isPipelined(op_class);
+        // Generate completion event for the FU
+        ++wbOutstanding;
+        FUCompletion *execution = new FUCompletion(issuing_inst,
+                                                   idx, this);
+
+        cpu->schedule(execution,
+                      cpu->clockEdge(Cycles(op_latency - 1)));
+
+        if (!pipelined) {
+            // If FU isn't pipelined, then it must be freed
+            // upon the execution completing.
+            execution->setFreeFU();
+        } else {
+            // Add the FU onto the list of FU's to be freed next cycle.
+            fuPool->freeUnitNextCycle(idx);
+        }
+    }
+
+    DPRINTF(IQ, "Thread %i: Issuing instruction PC %s "
+            "[sn:%lli]\n",
+            tid, issuing_inst->pcState(),
+            issuing_inst->seqNum);
+
+    issuing_inst->setIssued();
+
+    issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
+
+    if (!issuing_inst->isMemRef()) {
+        // Memory instructions can not be freed from the IQ until they
+        // complete.
+        ++freeEntries;
+        count[tid]--;
+        issuing_inst->clearInIQ();
+        freeSlot(issuing_inst);
+    } else {
+        memDepUnit[tid].issue(issuing_inst);
+    }
+
+    statIssuedInstType[tid][op_class]++;
+
+    return true;
+}
+
 template <class Impl>
 void
 InstructionQueue<Impl>::scheduleNonSpec(const InstSeqNum &inst)
@@ -1045,6 +1091,12 @@ InstructionQueue<Impl>::wakeDependents(DynInstPtr &completed_inst)
                 dest_reg->index(),
                 dest_reg->className());
 
+        if (bitmapScheduler) {
+            dependents += wakeSlots(dest_reg->flatIndex());
+            regScoreboard[dest_reg->flatIndex()] = true;
+            continue;
+        }
+
         //Go through the dependency chain, marking the registers as
         //ready within the waiting instructions.
         DynInstPtr dep_inst = dependGraph.pop(dest_reg->flatIndex());
@@ -1083,6 +1135,21 @@ InstructionQueue<Impl>::addReadyMemInst(DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
+    if (bitmapScheduler) {
+        // Squashed instructions have already given up their slot.
+        if (ready_inst->iqSlot == -1) {
+            ++iqSquashedInstsIssued;
+            return;
+        }
+
+        setSlotReady(ready_inst);
+
+        DPRINTF(IQ, "Instruction is ready to issue, marking its slot "
+                "ready, PC %s opclass:%i [sn:%lli].\n",
+                ready_inst->pcState(), op_class, ready_inst->seqNum);
+        return;
+    }
+
     readyInsts[op_class].push(ready_inst);
 
     // Will need to reorder the list if either a queue is not on the list,
@@ -1133,6 +1200,7 @@ InstructionQueue<Impl>::completeMemInst(DynInstPtr &completed_inst)
     ++freeEntries;
 
     completed_inst->memOpDone(true);
+    freeSlot(completed_inst);
 
     memDepUnit[tid].completed(completed_inst);
     count[tid]--;
@@ -1290,8 +1358,15 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
 
                     if (!squashed_inst->isReadySrcRegIdx(src_reg_idx) &&
                         !src_reg->isFixedMapping()) {
-                        dependGraph.remove(src_reg->flatIndex(),
-                                           squashed_inst);
+                        if (bitmapScheduler) {
+                            int slot = squashed_inst->iqSlot;
+                            regConsumers[src_reg->flatIndex() * slotWords +
+                                         slot / 64] &=
+                                ~(1ULL << (slot % 64));
+                        } else {
+                            dependGraph.remove(src_reg->flatIndex(),
+                                               squashed_inst);
+                        }
                     }
 
 
@@ -1331,6 +1406,7 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
             squashed_inst->setIssued();
             squashed_inst->setCanCommit();
             squashed_inst->clearInIQ();
+            freeSlot(squashed_inst);
 
             //Update Thread IQ Count
             count[squashed_inst->threadNumber]--;
@@ -1372,7 +1448,13 @@ InstructionQueue<Impl>::addToDependents(DynInstPtr &new_inst)
                         new_inst->pcState(), src_reg->index(),
                         src_reg->className());
 
-                dependGraph.insert(src_reg->flatIndex(), new_inst);
+                if (bitmapScheduler) {
+                    int slot = new_inst->iqSlot;
+                    regConsumers[src_reg->flatIndex() * slotWords +
+                                 slot / 64] |= 1ULL << (slot % 64);
+                } else {
+                    dependGraph.insert(src_reg->flatIndex(), new_inst);
+                }
 
                 // Change the return value to indicate that something
                 // was added to the dependency graph.
@@ -1413,14 +1495,21 @@ InstructionQueue<Impl>::addToProducers(DynInstPtr &new_inst)
             continue;
         }
 
-        if (!dependGraph.empty(dest_reg->flatIndex())) {
-            dependGraph.dump();
-            panic("Dependency graph %i (%s) (flat: %i) not empty!",
-                  dest_reg->index(), dest_reg->className(),
-                  dest_reg->flatIndex());
-        }
+        if (bitmapScheduler) {
+            panic_if(hasConsumers(dest_reg->flatIndex()),
+                     "Consumer bitmap %i (%s) (flat: %i) not empty!",
+                     dest_reg->index(), dest_reg->className(),
+                     dest_reg->flatIndex());
+        } else {
+            if (!dependGraph.empty(dest_reg->flatIndex())) {
+                dependGraph.dump();
+                panic("Dependency graph %i (%s) (flat: %i) not empty!",
+                      dest_reg->index(), dest_reg->className(),
+                      dest_reg->flatIndex());
+            }
 
-        dependGraph.setInst(dest_reg->flatIndex(), new_inst);
+            dependGraph.setInst(dest_reg->flatIndex(), new_inst);
+        }
 
         // Mark the scoreboard to say it's not yet ready.
         regScoreboard[dest_reg->flatIndex()] = false;
@@ -1453,6 +1542,11 @@ InstructionQueue<Impl>::addIfReady(DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%lli].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
+        if (bitmapScheduler) {
+            setSlotReady(inst);
+            return;
+        }
+
         readyInsts[op_class].push(inst);
 
         // Will need to reorder the list if either a queue is not on the list,
@@ -1467,6 +1561,208 @@ InstructionQueue<Impl>::addIfReady(DynInstPtr &inst)
     }
 }
 
+template <class Impl>
+void
+InstructionQueue<Impl>::allocSlot(DynInstPtr &inst)
+{
+    if (!bitmapScheduler)
+        return;
+
+    panic_if(freeSlots.empty(), "No free IQ slot for [sn:%lli].",
+             inst->seqNum);
+
+    int slot = freeSlots.back();
+    freeSlots.pop_back();
+
+    slotInsts[slot] = inst;
+    slotSeqNums[slot] = inst->seqNum;
+    inst->iqSlot = slot;
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::freeSlot(DynInstPtr &inst)
+{
+    int slot = inst->iqSlot;
+    if (!bitmapScheduler || slot == -1)
+        return;
+
+    OpClass op_class = inst->opClass();
+    if (readySlots[op_class * slotWords + slot / 64] & (1ULL << (slot % 64)))
+        clearSlotReady(slot, op_class);
+
+    slotInsts[slot] = NULL;
+    freeSlots.push_back(slot);
+    inst->iqSlot = -1;
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::setSlotReady(DynInstPtr &inst)
+{
+    int slot = inst->iqSlot;
+    OpClass op_class = inst->opClass();
+    uint64_t &word = readySlots[op_class * slotWords + slot / 64];
+    uint64_t bit = 1ULL << (slot % 64);
+
+    if (word & bit)
+        return;
+
+    word |= bit;
+    ++numReadySlots[op_class];
+    ++totalReadySlots;
+
+    int oldest = oldestReadySlot[op_class];
+    if (oldest == -1 || slotSeqNums[slot] < slotSeqNums[oldest])
+        oldestReadySlot[op_class] = slot;
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::clearSlotReady(int slot, OpClass op_class)
+{
+    readySlots[op_class * slotWords + slot / 64] &= ~(1ULL << (slot % 64));
+    --numReadySlots[op_class];
+    --totalReadySlots;
+
+    if (oldestReadySlot[op_class] == slot)
+        findOldestReadySlot(op_class);
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::findOldestReadySlot(OpClass op_class)
+{
+    int oldest = -1;
+
+    if (numReadySlots[op_class]) {
+        const uint64_t *words = &readySlots[op_class * slotWords];
+        for (int w = 0; w < slotWords; ++w) {
+            for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+                int slot = w * 64 + findLsbSet(bits);
+                if (oldest == -1 || slotSeqNums[slot] < slotSeqNums[oldest])
+                    oldest = slot;
+            }
+        }
+    }
+
+    oldestReadySlot[op_class] = oldest;
+}
+
+template <class Impl>
+bool
+InstructionQueue<Impl>::hasConsumers(PhysRegIndex reg) const
+{
+    for (int w = 0; w < slotWords; ++w) {
+        if (regConsumers[reg * slotWords + w])
+            return true;
+    }
+    return false;
+}
+
+template <class Impl>
+bool
+InstructionQueue<Impl>::hasConsumers() const
+{
+    for (auto word : regConsumers) {
+        if (word)
+            return true;
+    }
+    return false;
+}
+
+template <class Impl>
+int
+InstructionQueue<Impl>::wakeSlots(PhysRegIndex reg)
+{
+    int woken = 0;
+
+    for (int w = 0; w < slotWords; ++w) {
+        uint64_t bits = regConsumers[reg * slotWords + w];
+        regConsumers[reg * slotWords + w] = 0;
+
+        for (; bits; bits &= bits - 1) {
+            DynInstPtr &dep_inst = slotInsts[w * 64 + findLsbSet(bits)];
+
+            DPRINTF(IQ, "Waking up a dependent instruction, [sn:%lli] "
+                    "PC %s.\n", dep_inst->seqNum, dep_inst->pcState());
+
+            // An instruction may read the same register more than once.
+            for (int src_reg_idx = 0;
+                 src_reg_idx < dep_inst->numSrcRegs();
+                 src_reg_idx++)
+            {
+                PhysRegIdPtr src_reg = dep_inst->renamedSrcRegIdx(src_reg_idx);
+                if (!dep_inst->isReadySrcRegIdx(src_reg_idx) &&
+                    !src_reg->isFixedMapping() &&
+                    src_reg->flatIndex() == reg) {
+                    dep_inst->markSrcRegReady(src_reg_idx);
+                    ++woken;
+                }
+            }
+
+            addIfReady(dep_inst);
+        }
+    }
+
+    return woken;
+}
+
+template <class Impl>
+int
+InstructionQueue<Impl>::scheduleReadySlots(IssueStruct *i2e_info)
+{
+    int total_issued = 0;
+    std::array<bool, Num_OpClasses> fu_busy;
+    fu_busy.fill(false);
+
+    while (total_issued < totalWidth && totalReadySlots) {
+        // Pick the oldest ready instruction among the op classes that
+        // still have a free FU this cycle.
+        int op_class = -1;
+        for (int i = 0; i < Num_OpClasses; ++i) {
+            int slot = oldestReadySlot[i];
+            if (slot == -1 || fu_busy[i])
+                continue;
+            if (op_class == -1 ||
+                slotSeqNums[slot] < slotSeqNums[oldestReadySlot[op_class]]) {
+                op_class = i;
+            }
+        }
+
+        if (op_class == -1)
+            break;
+
+        int slot = oldestReadySlot[op_class];
+        DynInstPtr issuing_inst = slotInsts[slot];
+
+        if (issuing_inst->isFloating()) {
+            fpInstQueueReads++;
+        } else if (issuing_inst->isVector()) {
+            vecInstQueueReads++;
+        } else {
+            intInstQueueReads++;
+        }
+
+        if (issuing_inst->isSquashed()) {
+            clearSlotReady(slot, (OpClass)op_class);
+            ++iqSquashedInstsIssued;
+            continue;
+        }
+
+        if (issueInst(issuing_inst, i2e_info)) {
+            // Non-memory instructions have already left their slot.
+            if (issuing_inst->iqSlot != -1)
+                clearSlotReady(slot, (OpClass)op_class);
+            ++total_issued;
+        } else {
+            fu_busy[op_class] = true;
+        }
+    }
+
+    return total_issued;
+}
+
 template <class Impl>
 int
 InstructionQueue<Impl>::countInsts()
@@ -1508,7 +1804,11 @@ void
 InstructionQueue<Impl>::dumpLists()
 {
     for (int i = 0; i < Num_OpClasses; ++i) {
-        cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
+        if (bitmapScheduler) {
+            cprintf("Ready slots %i count: %i\n", i, numReadySlots[i]);
+        } else {
+            cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
+        }
 
         cprintf("\n");
     }
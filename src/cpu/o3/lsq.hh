@@ -48,6 +48,7 @@
 #include <queue>
 
 #include "cpu/o3/lsq_unit.hh"
+#include "cpu/o3/thread_list.hh"
 #include "cpu/inst_seq.hh"
 #include "mem/port.hh"
 #include "sim/sim_object.hh"
@@ -82,7 +83,7 @@ class LSQ {
     void regStats();
 
     /** Sets the pointer to the list of active threads. */
-    void setActiveThreads(std::list<ThreadID> *at_ptr);
+    void setActiveThreads(ThreadList *at_ptr);
 
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
@@ -312,7 +313,7 @@ class LSQ {
     LSQUnit *thread;
 
     /** List of Active Threads in System. */
-    std::list<ThreadID> *activeThreads;
+    ThreadList *activeThreads;
 
     /** Total Size of LQ Entries. */
     unsigned LQEntries;
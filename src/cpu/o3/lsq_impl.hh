@@ -45,7 +45,6 @@
 #define __CPU_O3_LSQ_IMPL_HH__
 
 #include <algorithm>
-#include <list>
 #include <string>
 
 #include "cpu/o3/lsq.hh"
@@ -142,7 +141,7 @@ LSQ<Impl>::regStats()
 
 template<class Impl>
 void
-LSQ<Impl>::setActiveThreads(list<ThreadID> *at_ptr)
+LSQ<Impl>::setActiveThreads(ThreadList *at_ptr)
 {
     activeThreads = at_ptr;
     assert(activeThreads != 0);
@@ -214,8 +213,8 @@ LSQ<Impl>::resetEntries()
             maxEntries = LQEntries;
         }
 
-        list<ThreadID>::iterator threads  = activeThreads->begin();
-        list<ThreadID>::iterator end = activeThreads->end();
+        ThreadList::iterator threads  = activeThreads->begin();
+        ThreadList::iterator end = activeThreads->end();
 
         while (threads != end) {
             ThreadID tid = *threads++;
@@ -245,8 +244,8 @@ template<class Impl>
 void
 LSQ<Impl>::tick()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -295,8 +294,8 @@ template<class Impl>
 void
 LSQ<Impl>::writebackStores()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -315,8 +314,8 @@ bool
 LSQ<Impl>::violation()
 {
     /* Answers: Does Anybody Have a Violation?*/
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -398,8 +397,8 @@ LSQ<Impl>::getCount()
 {
     unsigned total = 0;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -416,8 +415,8 @@ LSQ<Impl>::numLoads()
 {
     unsigned total = 0;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -434,8 +433,8 @@ LSQ<Impl>::numStores()
 {
     unsigned total = 0;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -452,8 +451,8 @@ LSQ<Impl>::numFreeLoadEntries()
 {
     unsigned total = 0;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -470,8 +469,8 @@ LSQ<Impl>::numFreeStoreEntries()
 {
     unsigned total = 0;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -500,8 +499,8 @@ template<class Impl>
 bool
 LSQ<Impl>::isFull()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -536,8 +535,8 @@ template<class Impl>
 bool
 LSQ<Impl>::lqEmpty() const
 {
-    list<ThreadID>::const_iterator threads = activeThreads->begin();
-    list<ThreadID>::const_iterator end = activeThreads->end();
+    ThreadList::const_iterator threads = activeThreads->begin();
+    ThreadList::const_iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -553,8 +552,8 @@ template<class Impl>
 bool
 LSQ<Impl>::sqEmpty() const
 {
-    list<ThreadID>::const_iterator threads = activeThreads->begin();
-    list<ThreadID>::const_iterator end = activeThreads->end();
+    ThreadList::const_iterator threads = activeThreads->begin();
+    ThreadList::const_iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -570,8 +569,8 @@ template<class Impl>
 bool
 LSQ<Impl>::lqFull()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -599,8 +598,8 @@ template<class Impl>
 bool
 LSQ<Impl>::sqFull()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -628,8 +627,8 @@ template<class Impl>
 bool
 LSQ<Impl>::isStalled()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -655,8 +654,8 @@ template<class Impl>
 bool
 LSQ<Impl>::hasStoresToWB()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -672,8 +671,8 @@ template<class Impl>
 bool
 LSQ<Impl>::willWB()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -689,8 +688,8 @@ template<class Impl>
 void
 LSQ<Impl>::dumpInsts() const
 {
-    list<ThreadID>::const_iterator threads = activeThreads->begin();
-    list<ThreadID>::const_iterator end = activeThreads->end();
+    ThreadList::const_iterator threads = activeThreads->begin();
+    ThreadList::const_iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
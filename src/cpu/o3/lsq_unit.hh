@@ -49,6 +49,8 @@
 #include <cstring>
 #include <map>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 #include "arch/generic/debugfaults.hh"
 #include "arch/isa_traits.hh"
@@ -256,6 +258,15 @@ class LSQUnit {
     /** Decrements the given load index (circular queue). */
     inline void decrLdIdx(int &load_idx) const;
 
+    /** Adds a store with data to the forwarding index. */
+    void indexStore(int store_idx);
+    /** Removes a store from the forwarding index, if it is there. */
+    void unindexStore(int store_idx);
+    /** Adds a load with a valid address to the violation index. */
+    void indexLoad(int load_idx);
+    /** Removes a load from the violation index, if it is there. */
+    void unindexLoad(int load_idx);
+
   public:
     /** Debugging function to dump instructions in the LSQ. */
     void dumpInsts() const;
@@ -390,6 +401,23 @@ class LSQUnit {
     /** The load queue. */
     std::vector<DynInstPtr> loadQueue;
 
+    /**
+     * Stores that have their data but haven't been written back, by
+     * cache line. Loads only look for stores to forward from in the
+     * lines they access, instead of walking the whole SQ.
+     */
+    std::unordered_multimap<Addr, int> storeIndex;
+
+    /**
+     * Loads that have a valid address, by address shifted right by
+     * depCheckShift. Stores only check the loads that fall in the same
+     * ranges for ordering violations, instead of walking the whole LQ.
+     */
+    std::unordered_multimap<Addr, int> loadIndex;
+
+    /** Scratch list of the SQ or LQ indices found in an index. */
+    std::vector<int> indexMatches;
+
     /** The number of LQ entries, plus a sentinel entry (circular queue).
      *  @todo: Consider having var that records the true number of LQ entries.
      */
@@ -558,6 +586,9 @@ LSQUnit<Impl>::read(Request *req, Request *sreqLow, Request *sreqHigh,
 
     assert(!load_inst->isExecuted());
 
+    // The address of the load is valid from now on.
+    indexLoad(load_idx);
+
     // Make sure this isn't a strictly ordered load
     // A bit of a hackish way to get strictly ordered accesses to work
     // only if they're at the head of the LSQ and are ready to commit
@@ -636,15 +667,34 @@ LSQUnit<Impl>::read(Request *req, Request *sreqLow, Request *sreqHigh,
         return NoFault;
     }
 
-    while (store_idx != -1) {
-        // End once we've reached the top of the LSQ
-        if (store_idx == storeWBIdx) {
-            break;
+    // Look up the stores older than the load that haven't been
+    // written back and write to the lines the load reads, youngest
+    // first.
+    indexMatches.clear();
+    if (store_idx != -1) {
+        Addr first_line = req->getVaddr() & cacheBlockMask;
+        Addr last_line = (req->getVaddr() + req->getSize() - 1) &
+            cacheBlockMask;
+        for (Addr line = first_line; line <= last_line;
+             line += cpu->cacheLineSize()) {
+            auto range = storeIndex.equal_range(line);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (storeQueue[it->second].inst->seqNum < load_inst->seqNum)
+                    indexMatches.push_back(it->second);
+            }
         }
+        std::sort(indexMatches.begin(), indexMatches.end(),
+                  [this](int a, int b) {
+                      return storeQueue[a].inst->seqNum >
+                          storeQueue[b].inst->seqNum;
+                  });
+        indexMatches.erase(std::unique(indexMatches.begin(),
+                                       indexMatches.end()),
+                           indexMatches.end());
+    }
 
-        // Move the index to one younger
-        if (--store_idx < 0)
-            store_idx += SQEntries;
+    for (int match : indexMatches) {
+        store_idx = match;
 
         assert(storeQueue[store_idx].inst);
 
@@ -893,6 +943,8 @@ LSQUnit<Impl>::write(Request *req, Request *sreqLow, Request *sreqHigh,
             store_idx, req->getPaddr(), storeHead,
             storeQueue[store_idx].inst->seqNum);
 
+    unindexStore(store_idx);
+
     storeQueue[store_idx].req = req;
     storeQueue[store_idx].sreqLow = sreqLow;
     storeQueue[store_idx].sreqHigh = sreqHigh;
@@ -912,6 +964,8 @@ LSQUnit<Impl>::write(Request *req, Request *sreqLow, Request *sreqHigh,
         !req->isCacheMaintenance())
         memcpy(storeQueue[store_idx].data, data, size);
 
+    indexStore(store_idx);
+
     // This function only writes the data to the store queue, so no fault
     // can happen here.
     return NoFault;
@@ -56,7 +56,6 @@
 #include "debug/Activity.hh"
 #include "debug/IEW.hh"
 #include "debug/LSQUnit.hh"
-#include "debug/O3PipeView.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 
@@ -196,6 +195,9 @@ LSQUnit<Impl>::resetState()
 
     storeHead = storeWBIdx = storeTail = 0;
 
+    storeIndex.clear();
+    loadIndex.clear();
+
     usedStorePorts = 0;
 
     retryPkt = NULL;
@@ -274,6 +276,7 @@ void
 LSQUnit<Impl>::clearLQ()
 {
     loadQueue.clear();
+    loadIndex.clear();
 }
 
 template<class Impl>
@@ -281,6 +284,7 @@ void
 LSQUnit<Impl>::clearSQ()
 {
     storeQueue.clear();
+    storeIndex.clear();
 }
 
 template<class Impl>
@@ -532,15 +536,32 @@ LSQUnit<Impl>::checkViolations(int load_idx, DynInstPtr &inst)
     Addr inst_eff_addr1 = inst->effAddr >> depCheckShift;
     Addr inst_eff_addr2 = (inst->effAddr + inst->effSize - 1) >> depCheckShift;
 
+    // Look up the loads from load_idx to the tail of the LQ that fall
+    // in the same ranges as the instruction, oldest first.
+    int num_checked = (loadTail - load_idx + LQEntries) % LQEntries;
+    indexMatches.clear();
+    for (Addr key = inst_eff_addr1; key <= inst_eff_addr2; ++key) {
+        auto range = loadIndex.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if ((it->second - load_idx + LQEntries) % LQEntries < num_checked)
+                indexMatches.push_back(it->second);
+        }
+    }
+    std::sort(indexMatches.begin(), indexMatches.end(),
+              [this](int a, int b) {
+                  return loadQueue[a]->seqNum < loadQueue[b]->seqNum;
+              });
+    indexMatches.erase(std::unique(indexMatches.begin(), indexMatches.end()),
+                       indexMatches.end());
+
     /** @todo in theory you only need to check an instruction that has executed
      * however, there isn't a good way in the pipeline at the moment to check
      * all instructions that will execute before the store writes back. Thus,
      * like the implementation that came before it, we're overly conservative.
      */
-    while (load_idx != loadTail) {
-        DynInstPtr ld_inst = loadQueue[load_idx];
+    for (int match : indexMatches) {
+        DynInstPtr ld_inst = loadQueue[match];
         if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered()) {
-            incrLdIdx(load_idx);
             continue;
         }
 
@@ -596,8 +617,6 @@ LSQUnit<Impl>::checkViolations(int load_idx, DynInstPtr &inst)
                     inst->seqNum, ld_inst->seqNum, ld_eff_addr1);
             }
         }
-
-        incrLdIdx(load_idx);
     }
     return NoFault;
 }
@@ -716,6 +735,7 @@ LSQUnit<Impl>::commitLoad()
     DPRINTF(LSQUnit, "Committing head load instruction, PC %s\n",
             loadQueue[loadHead]->pcState());
 
+    unindexLoad(loadHead);
     loadQueue[loadHead] = NULL;
 
     incrLdIdx(loadHead);
@@ -816,6 +836,7 @@ LSQUnit<Impl>::writebackStores()
         ++usedStorePorts;
 
         if (storeQueue[storeWBIdx].inst->isDataPrefetch()) {
+            unindexStore(storeWBIdx);
             incrStIdx(storeWBIdx);
 
             continue;
@@ -902,6 +923,7 @@ LSQUnit<Impl>::writebackStores()
                 WritebackEvent *wb = new WritebackEvent(inst, data_pkt, this);
                 cpu->schedule(wb, curTick() + 1);
                 completeStore(storeWBIdx);
+                unindexStore(storeWBIdx);
                 incrStIdx(storeWBIdx);
                 continue;
             }
@@ -929,6 +951,7 @@ LSQUnit<Impl>::writebackStores()
             delete state;
             delete req;
             completeStore(storeWBIdx);
+            unindexStore(storeWBIdx);
             incrStIdx(storeWBIdx);
         } else if (!sendStore(data_pkt)) {
             DPRINTF(IEW, "D-Cache became blocked when writing [sn:%lli], will"
@@ -1014,6 +1037,7 @@ LSQUnit<Impl>::squash(const InstSeqNum &squashed_num)
         }
 
         // Clear the smart pointer to make sure it is decremented.
+        unindexLoad(load_idx);
         loadQueue[load_idx]->setSquashed();
         loadQueue[load_idx] = NULL;
         --loads;
@@ -1054,6 +1078,7 @@ LSQUnit<Impl>::squash(const InstSeqNum &squashed_num)
         }
 
         // Clear the smart pointer to make sure it is decremented.
+        unindexStore(store_idx);
         storeQueue[store_idx].inst->setSquashed();
         storeQueue[store_idx].inst = NULL;
         storeQueue[store_idx].canWB = 0;
@@ -1110,6 +1135,7 @@ LSQUnit<Impl>::storePostSend(PacketPtr pkt)
         storeInFlight = true;
     }
 
+    unindexStore(storeWBIdx);
     incrStIdx(storeWBIdx);
 }
 
@@ -1182,12 +1208,10 @@ LSQUnit<Impl>::completeStore(int store_idx)
             "idx:%i\n",
             storeQueue[store_idx].inst->seqNum, store_idx, storeHead);
 
-#if TRACING_ON
-    if (DTRACE(O3PipeView)) {
+    if (cpu->tracePipeTimes()) {
         storeQueue[store_idx].inst->storeTick =
             curTick() - storeQueue[store_idx].inst->fetchTick;
     }
-#endif
 
     if (isStalled() &&
         storeQueue[store_idx].inst->seqNum == stallingStoreIsn) {
@@ -1299,6 +1323,81 @@ LSQUnit<Impl>::decrLdIdx(int &load_idx) const
         load_idx += LQEntries;
 }
 
+template <class Impl>
+void
+LSQUnit<Impl>::indexStore(int store_idx)
+{
+    const SQEntry &entry = storeQueue[store_idx];
+    if (!entry.size)
+        return;
+
+    Addr first_line = entry.inst->effAddr & cacheBlockMask;
+    Addr last_line = (entry.inst->effAddr + entry.size - 1) & cacheBlockMask;
+    for (Addr line = first_line; line <= last_line;
+         line += cpu->cacheLineSize()) {
+        storeIndex.emplace(line, store_idx);
+    }
+}
+
+template <class Impl>
+void
+LSQUnit<Impl>::unindexStore(int store_idx)
+{
+    const SQEntry &entry = storeQueue[store_idx];
+    if (!entry.size || !entry.inst)
+        return;
+
+    Addr first_line = entry.inst->effAddr & cacheBlockMask;
+    Addr last_line = (entry.inst->effAddr + entry.size - 1) & cacheBlockMask;
+    for (Addr line = first_line; line <= last_line;
+         line += cpu->cacheLineSize()) {
+        auto range = storeIndex.equal_range(line);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == store_idx) {
+                storeIndex.erase(it);
+                break;
+            }
+        }
+    }
+}
+
+template <class Impl>
+void
+LSQUnit<Impl>::indexLoad(int load_idx)
+{
+    const DynInstPtr &ld_inst = loadQueue[load_idx];
+    if (!ld_inst->effAddrValid())
+        return;
+
+    unindexLoad(load_idx);
+
+    Addr first_key = ld_inst->effAddr >> depCheckShift;
+    Addr last_key = (ld_inst->effAddr + ld_inst->effSize - 1) >> depCheckShift;
+    for (Addr key = first_key; key <= last_key; ++key)
+        loadIndex.emplace(key, load_idx);
+}
+
+template <class Impl>
+void
+LSQUnit<Impl>::unindexLoad(int load_idx)
+{
+    const DynInstPtr &ld_inst = loadQueue[load_idx];
+    if (!ld_inst->effAddrValid())
+        return;
+
+    Addr first_key = ld_inst->effAddr >> depCheckShift;
+    Addr last_key = (ld_inst->effAddr + ld_inst->effSize - 1) >> depCheckShift;
+    for (Addr key = first_key; key <= last_key; ++key) {
+        auto range = loadIndex.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == load_idx) {
+                loadIndex.erase(it);
+                break;
+            }
+        }
+    }
+}
+
 template <class Impl>
 void
 LSQUnit<Impl>::dumpInsts() const
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/probe/pipe_trace.hh"
+
+O3PipeTrace::O3PipeTrace(const O3PipeTraceParams *params)
+    : BasePipeTrace(params),
+      o3cpu(dynamic_cast<FullO3CPU<O3CPUImpl> *>(params->manager))
+{
+    fatal_if(!o3cpu, "Manager of %s is not of type O3CPU and thus does "
+             "not support pipeline tracing.\n", name());
+}
+
+void
+O3PipeTrace::regProbeListeners()
+{
+    typedef ProbeListenerArg<O3PipeTrace, DynInstPtr> DynInstListener;
+    listeners.push_back(new DynInstListener(this, "Commit",
+                                            &O3PipeTrace::traceCommit));
+    listeners.push_back(new DynInstListener(this, "Squash",
+                                            &O3PipeTrace::traceSquash));
+    ++o3cpu->pipeTraceListeners;
+}
+
+void
+O3PipeTrace::traceCommit(const DynInstPtr &inst)
+{
+    drainStores();
+    if (inst->isStore() && inst->storeTick == -1 &&
+        inst->fetchTick != MaxTick) {
+        pendingStores.push_back(inst);
+        if (pendingStores.size() > maxPendingStores) {
+            addDynInst(pendingStores.front(), true);
+            pendingStores.pop_front();
+        }
+    } else {
+        addDynInst(inst, true);
+    }
+}
+
+void
+O3PipeTrace::traceSquash(const DynInstPtr &inst)
+{
+    drainStores();
+    if (traceSquashed)
+        addDynInst(inst, false);
+}
+
+void
+O3PipeTrace::drainStores()
+{
+    while (!pendingStores.empty() &&
+           pendingStores.front()->storeTick != -1) {
+        addDynInst(pendingStores.front(), true);
+        pendingStores.pop_front();
+    }
+}
+
+void
+O3PipeTrace::addDynInst(const DynInstPtr &inst, bool committed)
+{
+    // Instructions fetched before the trace started have no ticks
+    const Tick fetch = inst->fetchTick;
+    if (fetch == MaxTick)
+        return;
+
+    auto stage_tick = [fetch](int32_t tick) {
+        return tick == -1 ? MaxTick : fetch + tick;
+    };
+
+    InstRecord rec;
+    rec.seqNum = inst->seqNum;
+    rec.pc = inst->instAddr();
+    rec.upc = inst->microPC();
+    rec.tick[Fetch] = fetch;
+    rec.tick[Decode] = stage_tick(inst->decodeTick);
+    rec.tick[Rename] = stage_tick(inst->renameTick);
+    rec.tick[Dispatch] = stage_tick(inst->dispatchTick);
+    rec.tick[Issue] = stage_tick(inst->issueTick);
+    rec.tick[Complete] = stage_tick(inst->completeTick);
+    rec.tick[Retire] = committed ? stage_tick(inst->commitTick) : MaxTick;
+    rec.tick[Store] = committed ? stage_tick(inst->storeTick) : MaxTick;
+    addInst(rec, inst->staticInst);
+}
+
+void
+O3PipeTrace::flushTrace()
+{
+    for (const auto &inst : pendingStores)
+        addDynInst(inst, true);
+    pendingStores.clear();
+    BasePipeTrace::flushTrace();
+}
+
+O3PipeTrace *
+O3PipeTraceParams::create()
+{
+    return new O3PipeTrace(this);
+}
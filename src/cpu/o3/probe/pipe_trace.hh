@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_PROBE_PIPE_TRACE_HH__
+#define __CPU_O3_PROBE_PIPE_TRACE_HH__
+
+#include <deque>
+
+#include "cpu/o3/cpu.hh"
+#include "cpu/o3/dyn_inst.hh"
+#include "cpu/o3/impl.hh"
+#include "cpu/trace/base_pipe_trace.hh"
+#include "params/O3PipeTrace.hh"
+
+/**
+ * Pipeline trace of an O3CPU. It turns on the stage tick records of the
+ * dynamic instructions, as the O3PipeView debug flag does, and writes
+ * them out when an instruction commits or is squashed in the ROB.
+ * Stores complete after they commit, so they are held back until their
+ * store tick is known.
+ */
+class O3PipeTrace : public BasePipeTrace
+{
+  public:
+    typedef O3CPUImpl::DynInstPtr DynInstPtr;
+
+    O3PipeTrace(const O3PipeTraceParams *params);
+
+    /** Register the Commit and Squash listeners */
+    void regProbeListeners() override;
+
+    /** Write out the stores that are still waiting to complete */
+    void flushTrace() override;
+
+  private:
+    void traceCommit(const DynInstPtr &inst);
+    void traceSquash(const DynInstPtr &inst);
+
+    /** Add the stage ticks of an instruction to the trace */
+    void addDynInst(const DynInstPtr &inst, bool committed);
+
+    /** Write out the oldest committed stores that have completed */
+    void drainStores();
+
+    /** The CPU that is being traced */
+    FullO3CPU<O3CPUImpl> *o3cpu;
+
+    /** Committed stores waiting to complete, oldest first */
+    std::deque<DynInstPtr> pendingStores;
+
+    /** Bound on pendingStores, beyond which the oldest store is written
+     *  out without a store tick */
+    static const size_t maxPendingStores = 1024;
+};
+
+#endif // __CPU_O3_PROBE_PIPE_TRACE_HH__
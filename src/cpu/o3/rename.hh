@@ -48,6 +48,7 @@
 #include <utility>
 
 #include "base/statistics.hh"
+#include "cpu/o3/thread_list.hh"
 #include "config/the_isa.hh"
 #include "cpu/timebuf.hh"
 #include "sim/probe/probe.hh"
@@ -170,7 +171,7 @@ class DefaultRename
     void startupStage();
 
     /** Sets pointer to list of active threads. */
-    void setActiveThreads(std::list<ThreadID> *at_ptr);
+    void setActiveThreads(ThreadList *at_ptr);
 
     /** Sets pointer to rename maps (per-thread structures). */
     void setRenameMap(RenameMap rm_ptr[Impl::MaxThreads]);
@@ -322,6 +323,34 @@ class DefaultRename
      */
     std::list<RenameHistory> historyBuffer[Impl::MaxThreads];
 
+    /** A copy of the rename map and the free list heads taken right after
+     * renaming a control instruction. Squashing back to that instruction
+     * restores these in one go instead of undoing each younger rename from
+     * the history buffer.
+     */
+    struct RenameCheckpoint {
+        /** The sequence number of the control instruction. */
+        InstSeqNum instSeqNum;
+        /** The rename map after renaming it. */
+        RenameMap renameMap;
+        /** Where the free lists started after renaming it. */
+        typename FreeList::Heads freeListHeads;
+    };
+
+    /** Ring of checkpoints, oldest first. Slots are reused so the copies
+     * of the rename map don't allocate once they've been filled.
+     */
+    std::vector<RenameCheckpoint> checkpoints;
+
+    /** Index of the oldest checkpoint. */
+    unsigned checkpointHead;
+
+    /** Number of checkpoints in use. */
+    unsigned numLiveCheckpoints;
+
+    /** Take a checkpoint after renaming a control instruction. */
+    void takeCheckpoint(const DynInstPtr &inst, ThreadID tid);
+
     /** Pointer to CPU. */
     O3CPU *cpu;
 
@@ -362,7 +391,7 @@ class DefaultRename
     FreeList *freeList;
 
     /** Pointer to the list of active threads. */
-    std::list<ThreadID> *activeThreads;
+    ThreadList *activeThreads;
 
     /** Pointer to the scoreboard. */
     Scoreboard *scoreboard;
@@ -461,6 +490,12 @@ class DefaultRename
     /** The number of threads active in rename. */
     ThreadID numThreads;
 
+    /** Maximum number of rename checkpoints, 0 if they're not used. The
+     * free list is shared between threads, so they're only used with a
+     * single thread.
+     */
+    unsigned numCheckpoints;
+
     /** The maximum skid buffer size. */
     unsigned skidBufferMax;
 
@@ -518,6 +553,8 @@ class DefaultRename
     Stats::Scalar renameCommittedMaps;
     /** Stat for total number of mappings that were undone due to a squash. */
     Stats::Scalar renameUndoneMaps;
+    /** Stat for total number of squashes that restored a checkpoint. */
+    Stats::Scalar renameCheckpointRestores;
     /** Number of serialize instructions handled. */
     Stats::Scalar renamedSerializing;
     /** Number of instructions marked as temporarily serializing. */
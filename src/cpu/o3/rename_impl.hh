@@ -54,7 +54,6 @@
 #include "cpu/reg_class.hh"
 #include "debug/Activity.hh"
 #include "debug/Rename.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 
 using namespace std;
@@ -67,7 +66,8 @@ DefaultRename<Impl>::DefaultRename(O3CPU *_cpu, DerivO3CPUParams *params)
       commitToRenameDelay(params->commitToRenameDelay),
       renameWidth(params->renameWidth),
       commitWidth(params->commitWidth),
-      numThreads(params->numThreads)
+      numThreads(params->numThreads),
+      numCheckpoints(numThreads == 1 ? params->renameCheckpoints : 0)
 {
     if (renameWidth > Impl::MaxWidth)
         fatal("renameWidth (%d) is larger than compiled limit (%d),\n"
@@ -76,6 +76,10 @@ DefaultRename<Impl>::DefaultRename(O3CPU *_cpu, DerivO3CPUParams *params)
 
     // @todo: Make into a parameter.
     skidBufferMax = (decodeToRenameDelay + 1) * params->decodeWidth;
+
+    checkpoints.resize(numCheckpoints);
+    checkpointHead = 0;
+    numLiveCheckpoints = 0;
 }
 
 template <class Impl>
@@ -157,6 +161,10 @@ DefaultRename<Impl>::regStats()
         .name(name() + ".UndoneMaps")
         .desc("Number of HB maps that are undone due to squashing")
         .prereq(renameUndoneMaps);
+    renameCheckpointRestores
+        .name(name() + ".CheckpointRestores")
+        .desc("Number of squashes that restored a rename checkpoint")
+        .prereq(renameCheckpointRestores);
     renamedSerializing
         .name(name() + ".serializingInsts")
         .desc("count of serializing insts renamed")
@@ -266,11 +274,14 @@ DefaultRename<Impl>::resetStage()
 
         serializeOnNextInst[tid] = false;
     }
+
+    checkpointHead = 0;
+    numLiveCheckpoints = 0;
 }
 
 template<class Impl>
 void
-DefaultRename<Impl>::setActiveThreads(list<ThreadID> *at_ptr)
+DefaultRename<Impl>::setActiveThreads(ThreadList *at_ptr)
 {
     activeThreads = at_ptr;
 }
@@ -397,8 +408,8 @@ DefaultRename<Impl>::tick()
 
     sortInsts();
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     // Check stall and squash signals.
     while (threads != end) {
@@ -704,6 +715,9 @@ DefaultRename<Impl>::renameInsts(ThreadID tid)
 
         renameDestRegs(inst, inst->threadNumber);
 
+        if (numCheckpoints && inst->isControl())
+            takeCheckpoint(inst, tid);
+
         if (inst->isLoad()) {
                 loadsInProgress[tid]++;
         }
@@ -789,11 +803,9 @@ DefaultRename<Impl>::sortInsts()
     for (int i = 0; i < insts_from_decode; ++i) {
         DynInstPtr inst = fromDecode->insts[i];
         insts[inst->threadNumber].push_back(inst);
-#if TRACING_ON
-        if (DTRACE(O3PipeView)) {
+        if (cpu->tracePipeTimes()) {
             inst->renameTick = curTick() - inst->fetchTick;
         }
-#endif
     }
 }
 
@@ -801,8 +813,8 @@ template<class Impl>
 bool
 DefaultRename<Impl>::skidsEmpty()
 {
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -820,8 +832,8 @@ DefaultRename<Impl>::updateStatus()
 {
     bool any_unblocking = false;
 
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
+    ThreadList::iterator threads = activeThreads->begin();
+    ThreadList::iterator end = activeThreads->end();
 
     while (threads != end) {
         ThreadID tid = *threads++;
@@ -915,14 +927,41 @@ DefaultRename<Impl>::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
     typename std::list<RenameHistory>::iterator hb_it =
         historyBuffer[tid].begin();
 
+    // Drop the checkpoints of squashed instructions. The oldest one at or
+    // after the squash point holds the state right after it, so start
+    // from there.
+    const RenameCheckpoint *restore = nullptr;
+    while (numLiveCheckpoints) {
+        const RenameCheckpoint &youngest = checkpoints[
+            (checkpointHead + numLiveCheckpoints - 1) % numCheckpoints];
+        if (youngest.instSeqNum < squashed_seq_num)
+            break;
+        restore = &youngest;
+        // The instruction squashed to stays, and so does its checkpoint.
+        if (youngest.instSeqNum == squashed_seq_num)
+            break;
+        --numLiveCheckpoints;
+    }
+
     // After a syscall squashes everything, the history buffer may be empty
     // but the ROB may still be squashing instructions.
     if (historyBuffer[tid].empty()) {
         return;
     }
 
+    if (restore && hb_it->instSeqNum > restore->instSeqNum) {
+        DPRINTF(Rename, "[tid:%u]: Restoring checkpoint at [sn:%lli].\n",
+                tid, restore->instSeqNum);
+        *renameMap[tid] = restore->renameMap;
+        freeList->restoreHeads(restore->freeListHeads);
+        ++renameCheckpointRestores;
+    } else {
+        restore = nullptr;
+    }
+
     // Go through the most recent instructions, undoing the mappings
-    // they did and freeing up the registers.
+    // they did and freeing up the registers. Those younger than a restored
+    // checkpoint have already been undone and only need to be dropped.
     while (!historyBuffer[tid].empty() &&
            hb_it->instSeqNum > squashed_seq_num) {
         assert(hb_it != historyBuffer[tid].end());
@@ -936,13 +975,19 @@ DefaultRename<Impl>::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
         // is the same as the old one.  While it would be merely a
         // waste of time to update the rename table, we definitely
         // don't want to put these on the free list.
-        if (hb_it->newPhysReg != hb_it->prevPhysReg) {
+        if (hb_it->newPhysReg != hb_it->prevPhysReg &&
+            !(restore && hb_it->instSeqNum > restore->instSeqNum)) {
             // Tell the rename map to set the architected register to the
             // previous physical register that it was renamed to.
             renameMap[tid]->setEntry(hb_it->archReg, hb_it->prevPhysReg);
 
             // Put the renamed physical register back on the free list.
-            freeList->addReg(hb_it->newPhysReg);
+            // Outstanding checkpoints expect it to go back where it was
+            // taken from, in front of the registers taken after it.
+            if (numCheckpoints)
+                freeList->undoGetReg(hb_it->newPhysReg);
+            else
+                freeList->addReg(hb_it->newPhysReg);
         }
 
         // Notify potential listeners that the register mapping needs to be
@@ -965,6 +1010,13 @@ DefaultRename<Impl>::removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid)
             "history buffer %u (size=%i), until [sn:%lli].\n",
             tid, tid, historyBuffer[tid].size(), inst_seq_num);
 
+    // Checkpoints of committed instructions can't be squashed to anymore.
+    while (numLiveCheckpoints &&
+           checkpoints[checkpointHead].instSeqNum <= inst_seq_num) {
+        checkpointHead = (checkpointHead + 1) % numCheckpoints;
+        --numLiveCheckpoints;
+    }
+
     typename std::list<RenameHistory>::iterator hb_it =
         historyBuffer[tid].end();
 
@@ -1006,6 +1058,26 @@ DefaultRename<Impl>::removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid)
     }
 }
 
+template <class Impl>
+void
+DefaultRename<Impl>::takeCheckpoint(const DynInstPtr &inst, ThreadID tid)
+{
+    // Without a free slot, a squash to this instruction falls back to
+    // walking the history buffer.
+    if (numLiveCheckpoints == numCheckpoints)
+        return;
+
+    DPRINTF(Rename, "[tid:%u]: Taking checkpoint at [sn:%lli].\n",
+            tid, inst->seqNum);
+
+    RenameCheckpoint &ckpt = checkpoints[
+        (checkpointHead + numLiveCheckpoints) % numCheckpoints];
+    ckpt.instSeqNum = inst->seqNum;
+    ckpt.renameMap = *renameMap[tid];
+    ckpt.freeListHeads = freeList->heads();
+    ++numLiveCheckpoints;
+}
+
 template <class Impl>
 inline void
 DefaultRename<Impl>::renameSrcRegs(DynInstPtr &inst, ThreadID tid)
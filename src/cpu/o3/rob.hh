@@ -51,6 +51,7 @@
 #include "arch/registers.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
+#include "cpu/o3/thread_list.hh"
 
 struct DerivO3CPUParams;
 
@@ -101,7 +102,7 @@ class ROB
     /** Sets pointer to the list of active threads.
      *  @param at_ptr Pointer to the list of active threads.
      */
-    void setActiveThreads(std::list<ThreadID> *at_ptr);
+    void setActiveThreads(ThreadList *at_ptr);
 
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
@@ -277,7 +278,7 @@ class ROB
     O3CPU *cpu;
 
     /** Active Threads in CPU */
-    std::list<ThreadID> *activeThreads;
+    ThreadList *activeThreads;
 
     /** Number of instructions in the ROB. */
     unsigned numEntries;
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_THREAD_LIST_HH__
+#define __CPU_O3_THREAD_LIST_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "base/types.hh"
+
+/**
+ * Ordered set of thread IDs, used for the active threads of the CPU
+ * and the priority lists of the pipeline stages. The stages walk
+ * these lists several times every cycle, so the threads are linked
+ * through fixed arrays indexed by thread ID rather than through
+ * allocated list nodes, with a bitmap for membership tests.
+ *
+ * The interface is the subset of std::list that the stages use, with
+ * the same iterator semantics: end() is a sentinel that stays valid
+ * as threads are added and removed, and removing a thread only
+ * invalidates the iterators to that thread. The stages rely on this,
+ * as committing or executing an instruction can suspend a thread
+ * while they walk the active threads.
+ */
+class ThreadList
+{
+  public:
+    /** Largest number of threads, the width of the bitmap. */
+    static const unsigned MaxThreads = 64;
+
+    class iterator
+    {
+      public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef ThreadID value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const ThreadID *pointer;
+        typedef ThreadID reference;
+
+        iterator() : list(nullptr), tid(InvalidThreadID) {}
+
+        ThreadID operator*() const { return tid; }
+
+        iterator &
+        operator++()
+        {
+            tid = list->next[tid];
+            return *this;
+        }
+
+        iterator
+        operator++(int)
+        {
+            iterator it(*this);
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const iterator &it) const { return tid == it.tid; }
+        bool operator!=(const iterator &it) const { return tid != it.tid; }
+
+      private:
+        friend class ThreadList;
+
+        iterator(const ThreadList *_list, ThreadID _tid)
+            : list(_list), tid(_tid)
+        {}
+
+        const ThreadList *list;
+        ThreadID tid;
+    };
+
+    typedef iterator const_iterator;
+
+    ThreadList()
+        : head(InvalidThreadID), tail(InvalidThreadID), _size(0), _mask(0)
+    {}
+
+    iterator begin() const { return iterator(this, head); }
+    iterator end() const { return iterator(this, InvalidThreadID); }
+
+    unsigned size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    ThreadID
+    front() const
+    {
+        assert(_size);
+        return head;
+    }
+
+    /** Bitmap of the threads in the list. */
+    uint64_t mask() const { return _mask; }
+
+    bool
+    contains(ThreadID tid) const
+    {
+        return _mask & bit(tid);
+    }
+
+    void
+    push_back(ThreadID tid)
+    {
+        assert(!contains(tid));
+        prev[tid] = tail;
+        next[tid] = InvalidThreadID;
+        if (tail != InvalidThreadID)
+            next[tail] = tid;
+        else
+            head = tid;
+        tail = tid;
+        _mask |= bit(tid);
+        ++_size;
+    }
+
+    /**
+     * Remove a thread, keeping the order of the others. The link of
+     * the removed thread to its successor is kept, so that an
+     * iterator that is still on it can move on to the next thread.
+     */
+    iterator
+    erase(iterator it)
+    {
+        const ThreadID tid = *it;
+        assert(contains(tid));
+        if (prev[tid] != InvalidThreadID)
+            next[prev[tid]] = next[tid];
+        else
+            head = next[tid];
+        if (next[tid] != InvalidThreadID)
+            prev[next[tid]] = prev[tid];
+        else
+            tail = prev[tid];
+        _mask &= ~bit(tid);
+        --_size;
+        return iterator(this, next[tid]);
+    }
+
+    void
+    clear()
+    {
+        head = tail = InvalidThreadID;
+        _size = 0;
+        _mask = 0;
+    }
+
+  private:
+    static uint64_t
+    bit(ThreadID tid)
+    {
+        assert(tid >= 0 && tid < MaxThreads);
+        return 1ULL << tid;
+    }
+
+    /** Neighbours of each thread in the list. */
+    ThreadID next[MaxThreads];
+    ThreadID prev[MaxThreads];
+    ThreadID head;
+    ThreadID tail;
+    unsigned _size;
+    uint64_t _mask;
+};
+
+#endif // __CPU_O3_THREAD_LIST_HH__
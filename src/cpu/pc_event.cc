@@ -32,6 +32,7 @@
 #include "cpu/pc_event.hh"
 
 #include <algorithm>
+#include <map>
 #include <string>
 #include <utility>
 
@@ -46,38 +47,50 @@
 using namespace std;
 
 PCEventQueue::PCEventQueue()
+    : pageFilter(filterBits / 64, 0)
 {}
 
 PCEventQueue::~PCEventQueue()
 {}
 
+void
+PCEventQueue::addToFilter(Addr pc)
+{
+    unsigned idx = filterIndex(pc);
+    pageFilter[idx / 64] |= ULL(1) << (idx % 64);
+}
+
 bool
 PCEventQueue::remove(PCEvent *event)
 {
-    int removed = 0;
-    range_t range = equal_range(event);
-    iterator i = range.first;
-    while (i != range.second &&
-           i != pc_map.end()) {
-        if (*i == event) {
-            DPRINTF(PCEvent, "PC based event removed at %#x: %s\n",
-                    event->pc(), event->descr());
-            i = pc_map.erase(i);
-            ++removed;
-        } else {
-            i++;
-        }
+    auto it = pcEvents.find(event->pc());
+    if (it == pcEvents.end())
+        return false;
 
-    }
+    EventList &events = it->second;
+    auto new_end = std::remove(events.begin(), events.end(), event);
+    int removed = events.end() - new_end;
+    if (!removed)
+        return false;
 
-    return removed > 0;
+    DPRINTF(PCEvent, "PC based event removed at %#x: %s\n",
+            event->pc(), event->descr());
+    events.erase(new_end, events.end());
+    if (events.empty())
+        pcEvents.erase(it);
+
+    std::fill(pageFilter.begin(), pageFilter.end(), 0);
+    for (const auto &pc_events : pcEvents)
+        addToFilter(pc_events.first);
+
+    return true;
 }
 
 bool
 PCEventQueue::schedule(PCEvent *event)
 {
-    pc_map.push_back(event);
-    sort(pc_map.begin(), pc_map.end(), MapCompare());
+    pcEvents[event->pc()].push_back(event);
+    addToFilter(event->pc());
 
     DPRINTF(PCEvent, "PC based event scheduled for %#x: %s\n",
             event->pc(), event->descr());
@@ -86,25 +99,37 @@ PCEventQueue::schedule(PCEvent *event)
 }
 
 bool
-PCEventQueue::doService(ThreadContext *tc)
+PCEventQueue::service(ThreadContext *tc)
+{
+    return service(tc->instAddr(), tc);
+}
+
+bool
+PCEventQueue::doService(Addr pc, ThreadContext *tc)
 {
     // This will fail to break on Alpha PALcode addresses, but that is
     // a rare use case.
-    Addr pc = tc->instAddr();
     int serviced = 0;
-    range_t range = equal_range(pc);
-    for (iterator i = range.first; i != range.second; ++i) {
+
+    // Events may remove themselves or others, so look the list up again
+    // for each one rather than holding on to it.
+    for (size_t i = 0; ; ++i) {
+        auto it = pcEvents.find(pc);
+        if (it == pcEvents.end() || i >= it->second.size())
+            break;
+
         // Make sure that the pc wasn't changed as the side effect of
         // another event.  This for example, prevents two invocations
         // of the SkipFuncEvent.  Maybe we should have separate PC
         // event queues for each processor?
         if (pc != tc->instAddr())
-            continue;
+            break;
 
+        PCEvent *event = it->second[i];
         DPRINTF(PCEvent, "PC based event serviced at %#x: %s\n",
-                (*i)->pc(), (*i)->descr());
+                event->pc(), event->descr());
 
-        (*i)->process(tc);
+        event->process(tc);
         ++serviced;
     }
 
@@ -114,18 +139,15 @@ PCEventQueue::doService(ThreadContext *tc)
 void
 PCEventQueue::dump() const
 {
-    const_iterator i = pc_map.begin();
-    const_iterator e = pc_map.end();
-
-    for (; i != e; ++i)
-        cprintf("%d: event at %#x: %s\n", curTick(), (*i)->pc(),
-                (*i)->descr());
-}
-
-PCEventQueue::range_t
-PCEventQueue::equal_range(Addr pc)
-{
-    return std::equal_range(pc_map.begin(), pc_map.end(), pc, MapCompare());
+    std::map<Addr, const EventList *> sorted;
+    for (const auto &pc_events : pcEvents)
+        sorted[pc_events.first] = &pc_events.second;
+
+    for (const auto &pc_events : sorted) {
+        for (const PCEvent *event : *pc_events.second)
+            cprintf("%d: event at %#x: %s\n", curTick(), event->pc(),
+                    event->descr());
+    }
 }
 
 BreakPCEvent::BreakPCEvent(PCEventQueue *q, const std::string &desc, Addr addr,
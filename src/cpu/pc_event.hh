@@ -32,6 +32,7 @@
 #ifndef __PC_EVENT_HH__
 #define __PC_EVENT_HH__
 
+#include <unordered_map>
 #include <vector>
 
 #include "base/logging.hh"
@@ -66,33 +67,32 @@ class PCEvent
 class PCEventQueue
 {
   protected:
-    typedef PCEvent * record_t;
-    class MapCompare {
-      public:
-        bool operator()(const record_t &l, const record_t &r) const {
-            return l->pc() < r->pc();
-        }
-        bool operator()(const record_t &l, Addr pc) const {
-            return l->pc() < pc;
-        }
-        bool operator()(Addr pc, const record_t &r) const {
-            return pc < r->pc();
-        }
-    };
-    typedef std::vector<record_t> map_t;
-
-  public:
-    typedef map_t::iterator iterator;
-    typedef map_t::const_iterator const_iterator;
-
-  protected:
-    typedef std::pair<iterator, iterator> range_t;
-    typedef std::pair<const_iterator, const_iterator> const_range_t;
+    /** Events at a PC, in the order they were scheduled */
+    typedef std::vector<PCEvent *> EventList;
+
+    /** All the events, by PC */
+    std::unordered_map<Addr, EventList> pcEvents;
+
+    /**
+     * A one-hash Bloom filter of the pages that have events, so that
+     * instructions on other pages are turned down with a single bit
+     * test. Bits can't be cleared, so the filter is rebuilt when an
+     * event is removed.
+     */
+    static const unsigned filterPageShift = 12;
+    static const unsigned filterBits = 1 << 16;
+    std::vector<uint64_t> pageFilter;
+
+    static unsigned
+    filterIndex(Addr pc)
+    {
+        Addr page = pc >> filterPageShift;
+        return (page ^ (page >> 16) ^ (page >> 32)) & (filterBits - 1);
+    }
 
-  protected:
-    map_t pc_map;
+    void addToFilter(Addr pc);
 
-    bool doService(ThreadContext *tc);
+    bool doService(Addr pc, ThreadContext *tc);
 
   public:
     PCEventQueue();
@@ -100,16 +100,23 @@ class PCEventQueue
 
     bool remove(PCEvent *event);
     bool schedule(PCEvent *event);
-    bool service(ThreadContext *tc)
+
+    /**
+     * Process the events at the PC of an instruction.
+     * @param pc The PC of the instruction, tc->instAddr()
+     * @return Whether any event was processed
+     */
+    bool
+    service(Addr pc, ThreadContext *tc)
     {
-        if (pc_map.empty())
+        unsigned idx = filterIndex(pc);
+        if (!(pageFilter[idx / 64] & (ULL(1) << (idx % 64))))
             return false;
 
-        return doService(tc);
+        return doService(pc, tc);
     }
 
-    range_t equal_range(Addr pc);
-    range_t equal_range(PCEvent *event) { return equal_range(event->pc()); }
+    bool service(ThreadContext *tc);
 
     void dump() const;
 };
@@ -102,3 +102,35 @@ class LTAGE(BranchPredictor):
     maxHist = Param.Unsigned(640, "Maximum history size of LTAGE")
     minTagWidth = Param.Unsigned(7, "Minimum tag size in tag tables")
 
+
+class TAGE_SC_L(LTAGE):
+    type = 'TAGE_SC_L'
+    cxx_class = 'TAGE_SC_L'
+    cxx_header = "cpu/pred/tage_sc_l.hh"
+
+    logSizeSC = Param.Unsigned(10,
+        "Log size of the statistical corrector tables")
+    scHistLengths = VectorParam.Unsigned([4, 8, 13, 21, 34, 55],
+        "Global history lengths of the corrector GEHL tables (at most 64)")
+    scCounterBits = Param.Unsigned(6, "Bits per corrector counter")
+    scThreshold = Param.Unsigned(35,
+        "Initial threshold for the corrector to revert TAGE")
+
+class HashedPerceptronBP(BranchPredictor):
+    type = 'HashedPerceptronBP'
+    cxx_class = 'HashedPerceptronBP'
+    cxx_header = "cpu/pred/hashed_perceptron.hh"
+
+    logTableSize = Param.Unsigned(10, "Log size of the weight tables")
+    histLengths = VectorParam.Unsigned([0, 2, 4, 8, 12, 16, 24, 32, 44, 56],
+        "Global history length of each weight table (at most 64)")
+    weightBits = Param.Unsigned(8, "Bits per weight (at most 8)")
+
+class BranchTraceReplayer(SimObject):
+    type = 'BranchTraceReplayer'
+    cxx_header = "cpu/pred/trace_replayer.hh"
+
+    bpred = Param.BranchPredictor("Branch predictor to evaluate")
+    trace_file = Param.String("Branch trace to replay")
+    max_branches = Param.Counter(0,
+        "Number of branches to replay, 0 for the whole trace")
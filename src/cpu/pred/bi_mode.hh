@@ -35,6 +35,7 @@
 #ifndef __CPU_PRED_BI_MODE_PRED_HH__
 #define __CPU_PRED_BI_MODE_PRED_HH__
 
+#include "base/pool_alloc.hh"
 #include "cpu/pred/bpred_unit.hh"
 #include "cpu/pred/sat_counter.hh"
 #include "params/BiModeBP.hh"
@@ -86,6 +87,22 @@ class BiModeBP : public BPredUnit
         // true: predict taken
         // false: predict not-taken
         bool finalPred;
+
+        /**
+         * @{
+         * Histories are allocated from a thread-local free-list pool, see
+         * PoolAllocator, as every predicted branch creates one.
+         */
+        typedef PoolAllocator<BPHistory> Pool;
+
+        static void *operator new(size_t size) { return Pool::allocate(size); }
+
+        static void
+        operator delete(void *p, size_t size)
+        {
+            Pool::deallocate(p, size);
+        }
+        /** @} */
     };
 
     // choice predictors
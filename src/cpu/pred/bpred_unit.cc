@@ -312,7 +312,7 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
 
     pc = target;
 
-    predHist[tid].push_front(predict_record);
+    predHist[tid].push_back(predict_record);
 
     DPRINTF(Branch, "[tid:%i]: [sn:%i]: History entry added."
             "predHist.size(): %i\n", tid, seqNum, predHist[tid].size());
@@ -328,13 +328,13 @@ BPredUnit::update(const InstSeqNum &done_sn, ThreadID tid)
 
     iPred.commit(done_sn, tid);
     while (!predHist[tid].empty() &&
-           predHist[tid].back().seqNum <= done_sn) {
+           predHist[tid].front().seqNum <= done_sn) {
         // Update the branch predictor with the correct results.
-        update(tid, predHist[tid].back().pc,
-                    predHist[tid].back().predTaken,
-                    predHist[tid].back().bpHistory, false);
+        update(tid, predHist[tid].front().pc,
+                    predHist[tid].front().predTaken,
+                    predHist[tid].front().bpHistory, false);
 
-        predHist[tid].pop_back();
+        predHist[tid].pop_front();
     }
 }
 
@@ -345,30 +345,30 @@ BPredUnit::squash(const InstSeqNum &squashed_sn, ThreadID tid)
 
     iPred.squash(squashed_sn, tid);
     while (!pred_hist.empty() &&
-           pred_hist.front().seqNum > squashed_sn) {
-        if (pred_hist.front().usedRAS) {
+           pred_hist.back().seqNum > squashed_sn) {
+        if (pred_hist.back().usedRAS) {
             DPRINTF(Branch, "[tid:%i]: Restoring top of RAS to: %i,"
                     " target: %s.\n", tid,
-                    pred_hist.front().RASIndex, pred_hist.front().RASTarget);
+                    pred_hist.back().RASIndex, pred_hist.back().RASTarget);
 
-            RAS[tid].restore(pred_hist.front().RASIndex,
-                             pred_hist.front().RASTarget);
-        } else if (pred_hist.front().wasCall && pred_hist.front().pushedRAS) {
+            RAS[tid].restore(pred_hist.back().RASIndex,
+                             pred_hist.back().RASTarget);
+        } else if (pred_hist.back().wasCall && pred_hist.back().pushedRAS) {
              // Was a call but predicated false. Pop RAS here
              DPRINTF(Branch, "[tid: %i] Squashing"
                      "  Call [sn:%i] PC: %s Popping RAS\n", tid,
-                     pred_hist.front().seqNum, pred_hist.front().pc);
+                     pred_hist.back().seqNum, pred_hist.back().pc);
              RAS[tid].pop();
         }
 
         // This call should delete the bpHistory.
-        squash(tid, pred_hist.front().bpHistory);
+        squash(tid, pred_hist.back().bpHistory);
 
         DPRINTF(Branch, "[tid:%i]: Removing history for [sn:%i] "
-                "PC %s.\n", tid, pred_hist.front().seqNum,
-                pred_hist.front().pc);
+                "PC %s.\n", tid, pred_hist.back().seqNum,
+                pred_hist.back().pc);
 
-        pred_hist.pop_front();
+        pred_hist.pop_back();
 
         DPRINTF(Branch, "[tid:%i]: predHist.size(): %i\n",
                 tid, predHist[tid].size());
@@ -407,16 +407,16 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
     // fix up the entry.
     if (!pred_hist.empty()) {
 
-        auto hist_it = pred_hist.begin();
+        auto hist_it = &pred_hist.back();
         //HistoryIt hist_it = find(pred_hist.begin(), pred_hist.end(),
         //                       squashed_sn);
 
         //assert(hist_it != pred_hist.end());
-        if (pred_hist.front().seqNum != squashed_sn) {
+        if (pred_hist.back().seqNum != squashed_sn) {
             DPRINTF(Branch, "Front sn %i != Squash sn %i\n",
-                    pred_hist.front().seqNum, squashed_sn);
+                    pred_hist.back().seqNum, squashed_sn);
 
-            assert(pred_hist.front().seqNum == squashed_sn);
+            assert(pred_hist.back().seqNum == squashed_sn);
         }
 
 
@@ -439,10 +439,10 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
         // the branch actually commits.
 
         // Remember the correct direction for the update at commit.
-        pred_hist.front().predTaken = actually_taken;
+        pred_hist.back().predTaken = actually_taken;
 
         update(tid, (*hist_it).pc, actually_taken,
-               pred_hist.front().bpHistory, true);
+               pred_hist.back().bpHistory, true);
 
         if (actually_taken) {
             if (hist_it->wasReturn && !hist_it->usedRAS) {
@@ -493,17 +493,15 @@ BPredUnit::dump()
     int i = 0;
     for (const auto& ph : predHist) {
         if (!ph.empty()) {
-            auto pred_hist_it = ph.begin();
-
             cprintf("predHist[%i].size(): %i\n", i++, ph.size());
 
-            while (pred_hist_it != ph.end()) {
+            // Youngest first
+            for (size_t idx = ph.size(); idx-- > 0; ) {
+                const PredictorHistory &hist = ph[idx];
                 cprintf("[sn:%lli], PC:%#x, tid:%i, predTaken:%i, "
                         "bpHistory:%#x\n",
-                        pred_hist_it->seqNum, pred_hist_it->pc,
-                        pred_hist_it->tid, pred_hist_it->predTaken,
-                        pred_hist_it->bpHistory);
-                pred_hist_it++;
+                        hist.seqNum, hist.pc, hist.tid, hist.predTaken,
+                        hist.bpHistory);
             }
 
             cprintf("\n");
@@ -47,8 +47,7 @@
 #ifndef __CPU_PRED_BPRED_UNIT_HH__
 #define __CPU_PRED_BPRED_UNIT_HH__
 
-#include <deque>
-
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/pred/btb.hh"
@@ -194,6 +193,9 @@ class BPredUnit : public SimObject
 
   private:
     struct PredictorHistory {
+        /** Empty entry for the slots of the history queue */
+        PredictorHistory() = default;
+
         /**
          * Makes a predictor history struct that contains any
          * information needed to update the predictor, BTB, and RAS.
@@ -250,7 +252,12 @@ class BPredUnit : public SimObject
         bool wasIndirect;
     };
 
-    typedef std::deque<PredictorHistory> History;
+    /**
+     * History of the in-flight branches of a thread, oldest first. It
+     * is a circular queue as it is pushed and popped for every
+     * predicted branch.
+     */
+    typedef CircularQueue<PredictorHistory> History;
 
     /** Number of the threads for which the branch history is maintained. */
     const unsigned numThreads;
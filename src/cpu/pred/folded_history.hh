@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Global branch history with incrementally folded views.
+ */
+
+#ifndef __CPU_PRED_FOLDED_HISTORY_HH__
+#define __CPU_PRED_FOLDED_HISTORY_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/logging.hh"
+
+/**
+ * Global branch history of up to 64 branches, together with folded
+ * views of its most recent bits.
+ *
+ * A view of length L and width W is the XOR of the L youngest history
+ * bits cut into W-bit chunks, which is what history-hashed predictors
+ * combine with the branch PC to index their tables. Views are updated
+ * in constant time when a branch is pushed instead of being recomputed
+ * from the history. The whole state is a small value that predictors
+ * save in their per-branch history and restore on squashes.
+ */
+class FoldedGlobalHistory
+{
+  public:
+    /** Maximum number of views */
+    static const unsigned MaxViews = 16;
+
+    struct State
+    {
+        /** Branch outcomes, youngest in bit 0 */
+        uint64_t bits;
+        /** Folded views, one per configured length */
+        uint32_t views[MaxViews];
+
+        State() : bits(0), views() { }
+    };
+
+    /**
+     * @param lengths Number of history bits folded into each view.
+     * @param width Width of the views in bits.
+     */
+    FoldedGlobalHistory(const std::vector<unsigned> &lengths,
+                        unsigned width)
+        : lengths(lengths), width(width), viewMask((1U << width) - 1)
+    {
+        fatal_if(lengths.size() > MaxViews,
+                 "At most %d folded history views are supported.\n",
+                 MaxViews);
+        fatal_if(width == 0 || width > 31,
+                 "Invalid folded history width %d.\n", width);
+        for (auto len : lengths) {
+            fatal_if(len > 64, "History length %d is longer than 64.\n",
+                     len);
+            outpoints.push_back(len % width);
+        }
+    }
+
+    unsigned numViews() const { return lengths.size(); }
+
+    /** Shift a branch outcome into the history and update the views. */
+    void
+    push(State &state, bool taken) const
+    {
+        for (unsigned i = 0; i < lengths.size(); ++i) {
+            const unsigned len = lengths[i];
+            if (len == 0)
+                continue;
+            uint32_t view = (state.views[i] << 1) | taken;
+            view ^= uint32_t((state.bits >> (len - 1)) & 1) << outpoints[i];
+            view ^= view >> width;
+            state.views[i] = view & viewMask;
+        }
+        state.bits = (state.bits << 1) | taken;
+    }
+
+  private:
+    const std::vector<unsigned> lengths;
+    std::vector<unsigned> outpoints;
+    const unsigned width;
+    const uint32_t viewMask;
+};
+
+#endif // __CPU_PRED_FOLDED_HISTORY_HH__
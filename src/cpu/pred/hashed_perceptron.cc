@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Implementation of a hashed perceptron branch predictor
+ */
+
+#include "cpu/pred/hashed_perceptron.hh"
+
+#include <cstdlib>
+
+#include "base/bitfield.hh"
+#include "debug/Perceptron.hh"
+
+HashedPerceptronBP::HashedPerceptronBP(
+        const HashedPerceptronBPParams *params)
+    : BPredUnit(params),
+      numTables(params->histLengths.size()),
+      logTableSize(params->logTableSize),
+      weightMax((1 << (params->weightBits - 1)) - 1),
+      weightMin(-(1 << (params->weightBits - 1))),
+      foldedHistory(params->histLengths, params->logTableSize),
+      threadHistory(params->numThreads),
+      weights(params->histLengths.size() << params->logTableSize, 0),
+      theta(params->histLengths.size()), thetaCounter(0)
+{
+    if (numTables == 0)
+        fatal("The hashed perceptron needs at least one table.\n");
+    if (params->weightBits < 2 || params->weightBits > 8)
+        fatal("Perceptron weights must be 2 to 8 bits wide.\n");
+}
+
+unsigned
+HashedPerceptronBP::index(Addr pc, const FoldedGlobalHistory::State &history,
+                          unsigned table) const
+{
+    const Addr pc_idx = pc >> instShiftAmt;
+    const unsigned entry = (pc_idx ^ (pc_idx >> logTableSize) ^
+                            history.views[table]) & mask(logTableSize);
+    return (table << logTableSize) | entry;
+}
+
+int
+HashedPerceptronBP::weightSum(Addr pc,
+                              const FoldedGlobalHistory::State &history) const
+{
+    int sum = 0;
+    for (unsigned t = 0; t < numTables; ++t)
+        sum += weights[index(pc, history, t)];
+    return sum;
+}
+
+void
+HashedPerceptronBP::uncondBranch(ThreadID tid, Addr pc, void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    history->history = threadHistory[tid];
+    history->sum = 0;
+    history->predTaken = true;
+    history->condBranch = false;
+    bp_history = static_cast<void *>(history);
+    foldedHistory.push(threadHistory[tid], true);
+}
+
+void
+HashedPerceptronBP::squash(ThreadID tid, void *bp_history)
+{
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+    threadHistory[tid] = history->history;
+    delete history;
+}
+
+bool
+HashedPerceptronBP::lookup(ThreadID tid, Addr branch_addr,
+                           void * &bp_history)
+{
+    BPHistory *history = new BPHistory;
+    history->history = threadHistory[tid];
+    history->sum = weightSum(branch_addr, history->history);
+    history->predTaken = history->sum >= 0;
+    history->condBranch = true;
+    bp_history = static_cast<void *>(history);
+
+    DPRINTF(Perceptron, "Lookup %#x: sum %d, taken %d\n", branch_addr,
+            history->sum, history->predTaken);
+
+    foldedHistory.push(threadHistory[tid], history->predTaken);
+    return history->predTaken;
+}
+
+void
+HashedPerceptronBP::btbUpdate(ThreadID tid, Addr branch_addr,
+                              void * &bp_history)
+{
+    // The branch missed in the BTB and is treated as not taken.
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+    threadHistory[tid] = history->history;
+    foldedHistory.push(threadHistory[tid], false);
+}
+
+void
+HashedPerceptronBP::train(Addr pc, const BPHistory *history, bool taken)
+{
+    const bool mispredicted = history->predTaken != taken;
+    if (!mispredicted && std::abs(history->sum) > theta)
+        return;
+
+    for (unsigned t = 0; t < numTables; ++t) {
+        int8_t &weight = weights[index(pc, history->history, t)];
+        if (taken && weight < weightMax)
+            ++weight;
+        else if (!taken && weight > weightMin)
+            --weight;
+    }
+
+    // Raise the threshold when mispredictions dominate the updates,
+    // and lower it when low-confidence correct predictions do.
+    if (mispredicted) {
+        if (++thetaCounter == 63) {
+            ++theta;
+            thetaCounter = 0;
+        }
+    } else if (--thetaCounter == -64) {
+        if (theta > 0)
+            --theta;
+        thetaCounter = 0;
+    }
+}
+
+void
+HashedPerceptronBP::update(ThreadID tid, Addr branch_addr, bool taken,
+                           void *bp_history, bool squashed)
+{
+    assert(bp_history);
+
+    BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+    if (squashed) {
+        // Mispredicted branch: repair the global history with the
+        // actual outcome. The tables are trained at commit.
+        threadHistory[tid] = history->history;
+        foldedHistory.push(threadHistory[tid], taken);
+        return;
+    }
+
+    if (history->condBranch)
+        train(branch_addr, history, taken);
+
+    delete history;
+}
+
+unsigned
+HashedPerceptronBP::getGHR(ThreadID tid, void *bp_history) const
+{
+    return static_cast<BPHistory *>(bp_history)->history.bits;
+}
+
+HashedPerceptronBP*
+HashedPerceptronBPParams::create()
+{
+    return new HashedPerceptronBP(this);
+}
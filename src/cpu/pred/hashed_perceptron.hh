@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Implementation of a hashed perceptron branch predictor
+ */
+
+#ifndef __CPU_PRED_HASHED_PERCEPTRON_HH__
+#define __CPU_PRED_HASHED_PERCEPTRON_HH__
+
+#include <vector>
+
+#include "base/pool_alloc.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/folded_history.hh"
+#include "params/HashedPerceptronBP.hh"
+
+/**
+ * Hashed perceptron predictor (Tarjan and Skadron). Each table holds
+ * signed weights and is indexed by the branch PC hashed with a folded
+ * view of a different length of the global history; the first table
+ * usually uses no history at all and acts as a bias. The prediction is
+ * the sign of the sum of the selected weights. Weights are trained
+ * when the prediction was wrong or the sum was within a threshold of
+ * zero, and the threshold itself adapts to the ratio of the two
+ * (Seznec, O-GEHL).
+ *
+ * Weights are stored as bytes in one array, so a table of 1024 entries
+ * costs 1KiB regardless of the configured weight width.
+ */
+class HashedPerceptronBP : public BPredUnit
+{
+  public:
+    HashedPerceptronBP(const HashedPerceptronBPParams *params);
+    void uncondBranch(ThreadID tid, Addr pc, void * &bp_history) override;
+    void squash(ThreadID tid, void *bp_history) override;
+    bool lookup(ThreadID tid, Addr branch_addr, void * &bp_history) override;
+    void btbUpdate(ThreadID tid, Addr branch_addr, void * &bp_history) override;
+    void update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history,
+                bool squashed) override;
+    unsigned getGHR(ThreadID tid, void *bp_history) const override;
+
+  private:
+    struct BPHistory
+    {
+        /** Global history before this branch */
+        FoldedGlobalHistory::State history;
+        /** Weight sum at prediction time */
+        int sum;
+        bool predTaken;
+        bool condBranch;
+
+        /**
+         * @{
+         * A history is allocated for every branch in flight, so it is
+         * taken from a pool (see PoolAllocator).
+         */
+        typedef PoolAllocator<BPHistory> Pool;
+
+        static void *operator new(size_t size) { return Pool::allocate(size); }
+
+        static void
+        operator delete(void *p, size_t size)
+        {
+            Pool::deallocate(p, size);
+        }
+        /** @} */
+    };
+
+    /** Index of the weight used by a branch in a table */
+    unsigned index(Addr pc, const FoldedGlobalHistory::State &history,
+                   unsigned table) const;
+
+    /** Sum of the weights selected by a branch */
+    int weightSum(Addr pc, const FoldedGlobalHistory::State &history) const;
+
+    /** Train the weights and the threshold on a committed branch */
+    void train(Addr pc, const BPHistory *history, bool taken);
+
+    const unsigned numTables;
+    const unsigned logTableSize;
+    const int weightMax;
+    const int weightMin;
+
+    /** Global history and its folded views, which are logTableSize wide */
+    const FoldedGlobalHistory foldedHistory;
+    std::vector<FoldedGlobalHistory::State> threadHistory;
+
+    /** numTables tables of 2^logTableSize weights each */
+    std::vector<int8_t> weights;
+
+    /** Training threshold */
+    int theta;
+    /** Counter steering the adaptation of the threshold */
+    int thetaCounter;
+};
+
+#endif // __CPU_PRED_HASHED_PERCEPTRON_HH__
@@ -480,7 +480,6 @@ LTAGE::predict(ThreadID tid, Addr branch_pc, bool cond_branch, void* &b)
     }
     bi->branchPC = branch_pc;
     bi->condBranch = cond_branch;
-    specLoopUpdate(branch_pc, pred_taken, bi);
     return pred_taken;
 }
 
@@ -702,6 +701,7 @@ bool
 LTAGE::lookup(ThreadID tid, Addr branch_pc, void* &bp_history)
 {
     bool retval = predict(tid, branch_pc, true, bp_history);
+    specLoopUpdate(branch_pc, retval, static_cast<BranchInfo*>(bp_history));
 
     DPRINTF(LTage, "Lookup branch: %lx; predict:%d\n", branch_pc, retval);
     updateHistories(tid, branch_pc, retval, bp_history);
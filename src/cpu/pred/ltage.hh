@@ -54,6 +54,7 @@
 
 #include <vector>
 
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "cpu/pred/bpred_unit.hh"
 #include "params/LTAGE.hh"
@@ -72,7 +73,7 @@ class LTAGE: public BPredUnit
     void squash(ThreadID tid, void *bp_history) override;
     unsigned getGHR(ThreadID tid, void *bp_history) const override;
 
-  private:
+  protected:
     // Prediction Structures
     // Loop Predictor Entry
     struct LoopEntry
@@ -162,6 +163,7 @@ class LTAGE: public BPredUnit
         // to save table indices and folded histories.
         // To do one call to new instead of five.
         int *storage;
+        size_t storageSize;
 
         // Pointers to actual saved array within the dynamically
         // allocated storage.
@@ -179,9 +181,11 @@ class LTAGE: public BPredUnit
               tagePred(false), altTaken(false), loopPred(false),
               loopPredValid(false), loopIndex(0), loopHit(0),
               condBranch(false), longestMatchPred(false),
-              pseudoNewAlloc(false), branchPC(0)
+              pseudoNewAlloc(false), branchPC(0),
+              storageSize(sz * 5 * sizeof(int))
         {
-            storage = new int [sz * 5];
+            storage = static_cast<int *>(
+                StoragePool::allocate(storageSize));
             tableIndices = storage;
             tableTags = storage + sz;
             ci = tableTags + sz;
@@ -191,8 +195,27 @@ class LTAGE: public BPredUnit
 
         ~BranchInfo()
         {
-            delete[] storage;
+            StoragePool::deallocate(storage, storageSize);
         }
+
+        /**
+         * @{
+         * Branch infos and their index storage come from thread-local
+         * pools (see PoolAllocator), as there is one per predicted
+         * branch.
+         */
+        struct StorageTag {};
+        typedef PoolAllocator<BranchInfo> Pool;
+        typedef PoolAllocator<StorageTag, 4096> StoragePool;
+
+        static void *operator new(size_t size) { return Pool::allocate(size); }
+
+        static void
+        operator delete(void *p, size_t size)
+        {
+            Pool::deallocate(p, size);
+        }
+        /** @} */
     };
 
     /**
@@ -301,6 +324,8 @@ class LTAGE: public BPredUnit
      * @param cond_branch True if the branch is conditional.
      * @param b Reference to wrapping pointer to allow storing
      * derived class prediction information in the base class.
+     * @note The caller speculatively updates the loop predictor with
+     * its final prediction (see specLoopUpdate()).
      */
     bool predict(ThreadID tid, Addr branch_pc, bool cond_branch, void* &b);
 
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Implementation of a TAGE-SC-L branch predictor
+ */
+
+#include "cpu/pred/tage_sc_l.hh"
+
+#include <cstdlib>
+
+#include "base/bitfield.hh"
+#include "debug/TageSCL.hh"
+
+TAGE_SC_L::TAGE_SC_L(const TAGE_SC_LParams *params)
+    : LTAGE(params),
+      numGEHLTables(params->scHistLengths.size()),
+      logSizeSC(params->logSizeSC),
+      scCounterMax((1 << (params->scCounterBits - 1)) - 1),
+      scCounterMin(-(1 << (params->scCounterBits - 1))),
+      scFoldedHistory(params->scHistLengths, params->logSizeSC),
+      scThreadHistory(params->numThreads),
+      biasTable(ULL(1) << params->logSizeSC, 0),
+      gehlTables(params->scHistLengths.size() << params->logSizeSC, 0),
+      theta(params->scThreshold), thetaCounter(0)
+{
+    if (params->scCounterBits < 2 || params->scCounterBits > 8)
+        fatal("Corrector counters must be 2 to 8 bits wide.\n");
+    if (logSizeSC < 3)
+        fatal("The corrector tables need at least 8 entries.\n");
+}
+
+void
+TAGE_SC_L::regStats()
+{
+    LTAGE::regStats();
+
+    scOverrides
+        .name(name() + ".scOverrides")
+        .desc("Number of TAGE predictions reverted by the corrector")
+        ;
+
+    scOverridesIncorrect
+        .name(name() + ".scOverridesIncorrect")
+        .desc("Number of reverted TAGE predictions that were correct")
+        ;
+}
+
+TAGE_SC_L::Confidence
+TAGE_SC_L::tageConfidence(const BranchInfo *bi) const
+{
+    if (bi->hitBank == 0)
+        return MediumConf;
+
+    const int ctr = gtable[bi->hitBank][bi->hitBankIndex].ctr;
+    const int strength = abs(2 * ctr + 1);
+    if (strength <= 1)
+        return LowConf;
+    if (strength >= (1 << tagTableCounterBits) - 1)
+        return HighConf;
+    return MediumConf;
+}
+
+unsigned
+TAGE_SC_L::biasIndex(Addr pc, bool tage_pred, Confidence conf) const
+{
+    const Addr pc_idx = pc >> instShiftAmt;
+    return ((pc_idx << 3) | (tage_pred << 2) | conf) & mask(logSizeSC);
+}
+
+unsigned
+TAGE_SC_L::gehlIndex(Addr pc, const FoldedGlobalHistory::State &history,
+                     unsigned table) const
+{
+    const Addr pc_idx = pc >> instShiftAmt;
+    const unsigned entry = (pc_idx ^ (pc_idx >> logSizeSC) ^
+                            history.views[table]) & mask(logSizeSC);
+    return (table << logSizeSC) | entry;
+}
+
+int
+TAGE_SC_L::scSum(Addr pc, const FoldedGlobalHistory::State &history,
+                 bool tage_pred, Confidence conf) const
+{
+    int sum = 2 * biasTable[biasIndex(pc, tage_pred, conf)] + 1;
+    for (unsigned t = 0; t < numGEHLTables; ++t)
+        sum += 2 * gehlTables[gehlIndex(pc, history, t)] + 1;
+    return sum;
+}
+
+void
+TAGE_SC_L::ctrUpdateSC(int8_t &ctr, bool taken)
+{
+    if (taken && ctr < scCounterMax)
+        ++ctr;
+    else if (!taken && ctr > scCounterMin)
+        --ctr;
+}
+
+void
+TAGE_SC_L::scUpdate(Addr pc, const SCHistory *history, bool taken)
+{
+    const bool mispredicted = history->scPred != taken;
+    if (!mispredicted && abs(history->sum) >= theta)
+        return;
+
+    ctrUpdateSC(biasTable[biasIndex(pc, history->tagePred,
+                                    history->confidence)], taken);
+    for (unsigned t = 0; t < numGEHLTables; ++t)
+        ctrUpdateSC(gehlTables[gehlIndex(pc, history->history, t)], taken);
+
+    if (mispredicted) {
+        if (++thetaCounter == 63) {
+            ++theta;
+            thetaCounter = 0;
+        }
+    } else if (--thetaCounter == -64) {
+        if (theta > 0)
+            --theta;
+        thetaCounter = 0;
+    }
+}
+
+bool
+TAGE_SC_L::lookup(ThreadID tid, Addr branch_pc, void* &bp_history)
+{
+    SCHistory *history = new SCHistory;
+    bool pred_taken = predict(tid, branch_pc, true, history->ltageHistory);
+    BranchInfo *bi = static_cast<BranchInfo*>(history->ltageHistory);
+
+    history->history = scThreadHistory[tid];
+    history->tagePred = bi->tagePred;
+    history->confidence = tageConfidence(bi);
+    history->sum = scSum(branch_pc, history->history, history->tagePred,
+                         history->confidence);
+    history->scPred = history->sum >= 0;
+    history->condBranch = true;
+
+    // Revert TAGE when the corrector disagrees with enough margin for
+    // the confidence of TAGE, unless the loop predictor is in charge.
+    const int margin = abs(history->sum);
+    const bool revert = history->scPred != history->tagePred &&
+        (history->confidence == LowConf ||
+         (history->confidence == MediumConf && margin >= theta / 2) ||
+         margin >= theta);
+    const bool loop_used = loopUseCounter >= 0 && bi->loopPredValid;
+    history->overridden = revert && !loop_used;
+    if (history->overridden)
+        pred_taken = history->scPred;
+
+    DPRINTF(TageSCL, "Lookup %lx: tage:%d, conf:%d, sum:%d, theta:%d, "
+            "taken:%d\n", branch_pc, history->tagePred, history->confidence,
+            history->sum, theta, pred_taken);
+
+    specLoopUpdate(branch_pc, pred_taken, bi);
+    updateHistories(tid, branch_pc, pred_taken, history->ltageHistory);
+    scFoldedHistory.push(scThreadHistory[tid], pred_taken);
+
+    bp_history = static_cast<void*>(history);
+    return pred_taken;
+}
+
+void
+TAGE_SC_L::uncondBranch(ThreadID tid, Addr br_pc, void* &bp_history)
+{
+    SCHistory *history = new SCHistory;
+    LTAGE::uncondBranch(tid, br_pc, history->ltageHistory);
+    history->history = scThreadHistory[tid];
+    history->sum = 0;
+    history->tagePred = true;
+    history->confidence = HighConf;
+    history->scPred = true;
+    history->overridden = false;
+    history->condBranch = false;
+    scFoldedHistory.push(scThreadHistory[tid], true);
+    bp_history = static_cast<void*>(history);
+}
+
+void
+TAGE_SC_L::btbUpdate(ThreadID tid, Addr branch_pc, void* &bp_history)
+{
+    SCHistory *history = static_cast<SCHistory*>(bp_history);
+    LTAGE::btbUpdate(tid, branch_pc, history->ltageHistory);
+    scThreadHistory[tid] = history->history;
+    scFoldedHistory.push(scThreadHistory[tid], false);
+}
+
+void
+TAGE_SC_L::update(ThreadID tid, Addr branch_pc, bool taken,
+                  void *bp_history, bool squashed)
+{
+    assert(bp_history);
+
+    SCHistory *history = static_cast<SCHistory*>(bp_history);
+
+    if (squashed) {
+        LTAGE::update(tid, branch_pc, taken, history->ltageHistory, true);
+        scThreadHistory[tid] = history->history;
+        scFoldedHistory.push(scThreadHistory[tid], taken);
+        return;
+    }
+
+    if (history->condBranch) {
+        scUpdate(branch_pc, history, taken);
+        if (history->overridden) {
+            ++scOverrides;
+            if (history->scPred != taken)
+                ++scOverridesIncorrect;
+        }
+    }
+
+    // This frees the L-TAGE branch info.
+    LTAGE::update(tid, branch_pc, taken, history->ltageHistory, false);
+    delete history;
+}
+
+void
+TAGE_SC_L::squash(ThreadID tid, void *bp_history)
+{
+    SCHistory *history = static_cast<SCHistory*>(bp_history);
+    LTAGE::squash(tid, history->ltageHistory);
+    scThreadHistory[tid] = history->history;
+    delete history;
+}
+
+unsigned
+TAGE_SC_L::getGHR(ThreadID tid, void *bp_history) const
+{
+    return LTAGE::getGHR(tid,
+        static_cast<SCHistory*>(bp_history)->ltageHistory);
+}
+
+TAGE_SC_L*
+TAGE_SC_LParams::create()
+{
+    return new TAGE_SC_L(this);
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Implementation of a TAGE-SC-L branch predictor
+ */
+
+#ifndef __CPU_PRED_TAGE_SC_L_HH__
+#define __CPU_PRED_TAGE_SC_L_HH__
+
+#include <vector>
+
+#include "base/pool_alloc.hh"
+#include "base/statistics.hh"
+#include "cpu/pred/folded_history.hh"
+#include "cpu/pred/ltage.hh"
+#include "params/TAGE_SC_L.hh"
+
+/**
+ * TAGE-SC-L (Seznec): L-TAGE followed by a statistical corrector.
+ *
+ * The corrector sums signed counters from a bias table, indexed by the
+ * PC, the TAGE prediction and the confidence of TAGE, and from GEHL
+ * tables indexed by the PC hashed with folded views of the global
+ * history. It reverts the TAGE prediction when the sum disagrees with
+ * it strongly enough for the confidence of TAGE, the bar being an
+ * adaptive threshold. A confident loop predictor still has the final
+ * word, as in L-TAGE.
+ */
+class TAGE_SC_L : public LTAGE
+{
+  public:
+    TAGE_SC_L(const TAGE_SC_LParams *params);
+
+    void regStats() override;
+
+    void uncondBranch(ThreadID tid, Addr br_pc, void* &bp_history) override;
+    bool lookup(ThreadID tid, Addr branch_addr, void* &bp_history) override;
+    void btbUpdate(ThreadID tid, Addr branch_addr, void* &bp_history) override;
+    void update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history,
+                bool squashed) override;
+    void squash(ThreadID tid, void *bp_history) override;
+    unsigned getGHR(ThreadID tid, void *bp_history) const override;
+
+  private:
+    /** Confidence of TAGE in its prediction */
+    enum Confidence { LowConf, MediumConf, HighConf };
+
+    struct SCHistory
+    {
+        /** L-TAGE information on the branch */
+        void *ltageHistory;
+        /** Corrector global history before this branch */
+        FoldedGlobalHistory::State history;
+        /** Corrector sum at prediction time */
+        int sum;
+        bool tagePred;
+        Confidence confidence;
+        bool scPred;
+        /** Did the corrector revert the prediction of TAGE? */
+        bool overridden;
+        bool condBranch;
+
+        /**
+         * @{
+         * Like the L-TAGE branch info they wrap, these are allocated
+         * per predicted branch and come from a pool (see
+         * PoolAllocator).
+         */
+        typedef PoolAllocator<SCHistory> Pool;
+
+        static void *operator new(size_t size) { return Pool::allocate(size); }
+
+        static void
+        operator delete(void *p, size_t size)
+        {
+            Pool::deallocate(p, size);
+        }
+        /** @} */
+    };
+
+    /** Confidence of the TAGE prediction recorded in bi */
+    Confidence tageConfidence(const BranchInfo *bi) const;
+
+    unsigned biasIndex(Addr pc, bool tage_pred, Confidence conf) const;
+    unsigned gehlIndex(Addr pc, const FoldedGlobalHistory::State &history,
+                       unsigned table) const;
+
+    /** Corrector sum, counting each counter c as 2c+1 */
+    int scSum(Addr pc, const FoldedGlobalHistory::State &history,
+              bool tage_pred, Confidence conf) const;
+
+    /** Train the corrector on a committed branch */
+    void scUpdate(Addr pc, const SCHistory *history, bool taken);
+
+    void ctrUpdateSC(int8_t &ctr, bool taken);
+
+    const unsigned numGEHLTables;
+    const unsigned logSizeSC;
+    const int scCounterMax;
+    const int scCounterMin;
+
+    const FoldedGlobalHistory scFoldedHistory;
+    std::vector<FoldedGlobalHistory::State> scThreadHistory;
+
+    std::vector<int8_t> biasTable;
+    /** numGEHLTables tables of 2^logSizeSC counters each */
+    std::vector<int8_t> gehlTables;
+
+    /** Threshold above which the corrector reverts confident TAGE */
+    int theta;
+    int thetaCounter;
+
+    /** Number of committed predictions reverted by the corrector */
+    Stats::Scalar scOverrides;
+    /** Number of committed reverted predictions that were wrong */
+    Stats::Scalar scOverridesIncorrect;
+};
+
+#endif // __CPU_PRED_TAGE_SC_L_HH__
@@ -47,6 +47,7 @@
 
 #include <vector>
 
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "cpu/pred/bpred_unit.hh"
 #include "cpu/pred/sat_counter.hh"
@@ -169,6 +170,22 @@ class TournamentBP : public BPredUnit
         bool localPredTaken;
         bool globalPredTaken;
         bool globalUsed;
+
+        /**
+         * @{
+         * Pooled, see PoolAllocator. A history lives from the lookup of
+         * a branch until it commits or is squashed.
+         */
+        typedef PoolAllocator<BPHistory> Pool;
+
+        static void *operator new(size_t size) { return Pool::allocate(size); }
+
+        static void
+        operator delete(void *p, size_t size)
+        {
+            Pool::deallocate(p, size);
+        }
+        /** @} */
     };
 
     /** Flag for invalid predictor index */
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/trace_replayer.hh"
+
+#include <fstream>
+#include <sstream>
+
+#include "base/logging.hh"
+#include "sim/sim_exit.hh"
+
+BranchTraceReplayer::BranchTraceReplayer(const BranchTraceReplayerParams *p)
+    : SimObject(p), bpred(p->bpred), traceFile(p->trace_file),
+      maxBranches(p->max_branches),
+      replayEvent([this]{ replay(); }, name())
+{
+}
+
+void
+BranchTraceReplayer::startup()
+{
+    schedule(replayEvent, curTick());
+}
+
+void
+BranchTraceReplayer::regStats()
+{
+    SimObject::regStats();
+
+    branches
+        .name(name() + ".branches")
+        .desc("Number of replayed branches")
+        ;
+
+    condBranches
+        .name(name() + ".condBranches")
+        .desc("Number of replayed conditional branches")
+        ;
+
+    condIncorrect
+        .name(name() + ".condIncorrect")
+        .desc("Number of mispredicted conditional branches")
+        ;
+
+    insts
+        .name(name() + ".insts")
+        .desc("Number of instructions covered by the trace")
+        ;
+
+    mpki
+        .name(name() + ".mpki")
+        .desc("Mispredictions per thousand instructions")
+        .precision(4)
+        ;
+    mpki = condIncorrect * 1000 / insts;
+}
+
+void
+BranchTraceReplayer::replayBranch(Addr pc, bool cond, bool taken)
+{
+    void *bp_history = nullptr;
+
+    if (!cond) {
+        bpred->uncondBranch(0, pc, bp_history);
+        bpred->update(0, pc, true, bp_history, false);
+        return;
+    }
+
+    ++condBranches;
+    if (bpred->lookup(0, pc, bp_history) != taken) {
+        ++condIncorrect;
+        // Repair the speculative history as the CPU would on a squash.
+        bpred->update(0, pc, taken, bp_history, true);
+    }
+    bpred->update(0, pc, taken, bp_history, false);
+}
+
+void
+BranchTraceReplayer::replay()
+{
+    std::ifstream trace(traceFile);
+    if (!trace)
+        fatal("Can't open branch trace %s.\n", traceFile);
+
+    std::string line;
+    unsigned line_no = 0;
+    while (std::getline(trace, line)) {
+        ++line_no;
+        if (maxBranches && branches.value() >= maxBranches)
+            break;
+
+        std::istringstream fields(line);
+        std::string pc_str, kind;
+        if (!(fields >> pc_str) || pc_str[0] == '#')
+            continue;
+
+        Addr pc = 0;
+        uint64_t n;
+        std::istringstream pc_field(pc_str);
+        if (!(pc_field >> std::hex >> pc) || !(fields >> kind) ||
+            kind.size() != 1 || kind.find_first_of("TNU") != 0) {
+            fatal("%s:%d: Malformed branch record.\n", traceFile, line_no);
+        }
+        if (!(fields >> n))
+            n = 1;
+
+        replayBranch(pc, kind[0] != 'U', kind[0] != 'N');
+        ++branches;
+        insts += n;
+    }
+
+    exitSimLoop("branch trace replayed");
+}
+
+BranchTraceReplayer *
+BranchTraceReplayerParams::create()
+{
+    return new BranchTraceReplayer(this);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Replays a branch trace through a branch predictor
+ */
+
+#ifndef __CPU_PRED_TRACE_REPLAYER_HH__
+#define __CPU_PRED_TRACE_REPLAYER_HH__
+
+#include <string>
+
+#include "base/statistics.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "params/BranchTraceReplayer.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * Drives the direction predictor of a BPredUnit with a branch trace,
+ * so that predictors can be compared without simulating a CPU.
+ *
+ * The trace is a text file with one branch per line:
+ *
+ *     <pc in hex> <T|N|U> [<instructions>]
+ *
+ * where T and N are taken and not taken conditional branches, and U is
+ * an unconditional branch. The optional last field is the number of
+ * instructions since the previous branch, this one included, and
+ * defaults to 1. Blank lines and lines starting with '#' are ignored.
+ *
+ * Each branch is predicted and resolved before the next one, as if
+ * the predictor was updated at fetch, and the BTB is not used. The
+ * simulation exits when the trace has been replayed.
+ */
+class BranchTraceReplayer : public SimObject
+{
+  public:
+    BranchTraceReplayer(const BranchTraceReplayerParams *p);
+
+    void startup() override;
+    void regStats() override;
+
+  private:
+    /** Replay the whole trace and exit the simulation loop. */
+    void replay();
+
+    /** Predict and resolve one branch. */
+    void replayBranch(Addr pc, bool cond, bool taken);
+
+    BPredUnit *bpred;
+    const std::string traceFile;
+    const Counter maxBranches;
+
+    EventFunctionWrapper replayEvent;
+
+    Stats::Scalar branches;
+    Stats::Scalar condBranches;
+    Stats::Scalar condIncorrect;
+    Stats::Scalar insts;
+    Stats::Formula mpki;
+};
+
+#endif // __CPU_PRED_TRACE_REPLAYER_HH__
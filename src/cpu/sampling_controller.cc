@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/sampling_controller.hh"
+
+#include <cmath>
+#include <limits>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "cpu/base.hh"
+#include "debug/Sampling.hh"
+
+SamplingController::SamplingController(const Params *p)
+    : SimObject(p),
+      functionalCPUs(p->functional_cpus),
+      detailedCPUs(p->detailed_cpus),
+      functionalWarming(p->functional_warming),
+      detailedWarming(p->detailed_warming),
+      measurementLength(p->measurement),
+      targetError(p->target_error),
+      confidenceZ(p->confidence_z),
+      minSamples(p->min_samples),
+      maxSamples(p->max_samples),
+      phase(Idle),
+      measurementStart(0),
+      measurementStartInsts(p->detailed_cpus.size(), 0),
+      numSamples(0),
+      mean(0),
+      sumSquaredDiffs(0)
+{
+    fatal_if(detailedCPUs.empty(), "%s: No detailed CPUs to measure.\n",
+             name());
+    fatal_if(functionalWarming != 0 && functionalCPUs.empty(),
+             "%s: Functional warming needs functional CPUs.\n", name());
+    fatal_if(measurementLength == 0,
+             "%s: The measurement interval can't be empty.\n", name());
+}
+
+void
+SamplingController::regStats()
+{
+    SimObject::regStats();
+
+    samplesStat
+        .method(this, &SamplingController::samples)
+        .name(name() + ".samples")
+        .desc("Number of measurement intervals sampled")
+        ;
+
+    cpiMeanStat
+        .method(this, &SamplingController::cpiMean)
+        .name(name() + ".cpi")
+        .desc("Mean CPI of the samples")
+        ;
+
+    cpiStdevStat
+        .method(this, &SamplingController::cpiStdev)
+        .name(name() + ".cpi_stdev")
+        .desc("Standard deviation of the sampled CPI")
+        ;
+
+    cpiErrorStat
+        .method(this, &SamplingController::cpiError)
+        .name(name() + ".cpi_error")
+        .desc("Confidence interval of the mean CPI relative to the mean")
+        ;
+}
+
+const char *
+SamplingController::phaseName(Phase phase)
+{
+    switch (phase) {
+      case Idle:
+        return "idle";
+      case FunctionalWarming:
+        return "functional_warming";
+      case DetailedWarming:
+        return "detailed_warming";
+      case Measurement:
+        return "measurement";
+      case Done:
+        return "done";
+      default:
+        panic("Invalid sampling phase %d\n", phase);
+    }
+}
+
+SamplingController::Phase
+SamplingController::followingPhase(Phase p)
+{
+    switch (p) {
+      case Idle:
+      case Measurement:
+        return FunctionalWarming;
+      case FunctionalWarming:
+        return DetailedWarming;
+      case DetailedWarming:
+        return Measurement;
+      default:
+        return Done;
+    }
+}
+
+Counter
+SamplingController::phaseLength(Phase p) const
+{
+    switch (p) {
+      case FunctionalWarming:
+        return functionalWarming;
+      case DetailedWarming:
+        return detailedWarming;
+      case Measurement:
+        return measurementLength;
+      default:
+        return 0;
+    }
+}
+
+std::string
+SamplingController::nextPhase()
+{
+    if (phase == Measurement)
+        recordSample();
+
+    if (phase != Done) {
+        if (isDone()) {
+            phase = Done;
+        } else {
+            // Skip the warming phases that have been disabled
+            do {
+                phase = followingPhase(phase);
+            } while (phaseLength(phase) == 0);
+        }
+    }
+
+    DPRINTF(Sampling, "Entering phase %s\n", phaseName(phase));
+    return phaseName(phase);
+}
+
+void
+SamplingController::startPhase()
+{
+    panic_if(phase == Idle || phase == Done,
+             "%s: No sampling phase to start.\n", name());
+
+    BaseCPU *cpu = phase == FunctionalWarming ?
+        functionalCPUs.front() : detailedCPUs.front();
+    fatal_if(cpu->switchedOut(), "%s: %s must be switched in for %s.\n",
+             name(), cpu->name(), phaseName(phase));
+
+    if (phase == Measurement) {
+        measurementStart = curTick();
+        for (size_t i = 0; i < detailedCPUs.size(); ++i)
+            measurementStartInsts[i] = detailedCPUs[i]->totalInsts();
+    }
+
+    cpu->scheduleInstStop(0, phaseLength(phase), "sampling phase done");
+}
+
+void
+SamplingController::recordSample()
+{
+    const Tick ticks = curTick() - measurementStart;
+    Counter insts = 0;
+    double cycles = 0;
+    for (size_t i = 0; i < detailedCPUs.size(); ++i) {
+        insts += detailedCPUs[i]->totalInsts() - measurementStartInsts[i];
+        cycles += double(ticks) / detailedCPUs[i]->clockPeriod();
+    }
+
+    if (insts == 0) {
+        warn("%s: Dropping a sample without committed instructions.\n",
+             name());
+        return;
+    }
+
+    const double cpi = cycles / insts;
+    ++numSamples;
+    const double delta = cpi - mean;
+    mean += delta / numSamples;
+    sumSquaredDiffs += delta * (cpi - mean);
+
+    DPRINTF(Sampling, "Sample %d: CPI %f, mean %f, error %f\n",
+            numSamples, cpi, mean, cpiError());
+}
+
+double
+SamplingController::cpiStdev() const
+{
+    if (numSamples < 2)
+        return 0;
+
+    return std::sqrt(sumSquaredDiffs / (numSamples - 1));
+}
+
+double
+SamplingController::cpiError() const
+{
+    if (numSamples < 2 || mean == 0)
+        return std::numeric_limits<double>::infinity();
+
+    return confidenceZ * cpiStdev() / std::sqrt(numSamples) / mean;
+}
+
+bool
+SamplingController::isDone() const
+{
+    if (maxSamples != 0 && numSamples >= maxSamples)
+        return true;
+
+    return numSamples >= minSamples && cpiError() <= targetError;
+}
+
+SamplingController *
+SamplingControllerParams::create()
+{
+    return new SamplingController(this);
+}
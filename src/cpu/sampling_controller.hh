@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Phase sequencer and CPI estimator for statistical sampling.
+ */
+
+#ifndef __CPU_SAMPLING_CONTROLLER_HH__
+#define __CPU_SAMPLING_CONTROLLER_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "params/SamplingController.hh"
+#include "sim/sim_object.hh"
+
+class BaseCPU;
+
+/**
+ * Controller for statistical sampling in the style of SMARTS.
+ *
+ * Sampling repeats three phases: functional warming on a fast CPU,
+ * detailed warming on a detailed CPU and a measurement interval on
+ * the same detailed CPU. The controller sequences the phases, exits
+ * the simulation loop at the end of each of them and records the CPI
+ * of every measurement interval. The mean and variance of the samples
+ * are updated online, and sampling is done once the confidence
+ * interval of the mean CPI is within the target error.
+ *
+ * Switching CPUs needs a drain, which is driven from Python, so the
+ * controller leaves that to m5.sample(). A phase is entered in two
+ * steps: nextPhase() picks the phase, the script switches CPUs if
+ * needed, and startPhase() starts it on the CPUs that are now running.
+ */
+class SamplingController : public SimObject
+{
+  public:
+    enum Phase {
+        Idle,
+        FunctionalWarming,
+        DetailedWarming,
+        Measurement,
+        Done,
+    };
+
+    typedef SamplingControllerParams Params;
+    SamplingController(const Params *p);
+
+    void regStats() override;
+
+    /**
+     * End the current phase and select the next one. A measurement
+     * interval is recorded as a sample when it ends.
+     *
+     * @return The name of the new phase, see phaseName().
+     */
+    std::string nextPhase();
+
+    /**
+     * Start the selected phase and schedule a simulation loop exit
+     * with the cause "sampling phase done" at its end. The first CPU
+     * that runs the phase must be switched in.
+     */
+    void startPhase();
+
+    /** Name of a phase as returned to Python */
+    static const char *phaseName(Phase phase);
+
+    /** Number of samples taken so far */
+    double samples() const { return numSamples; }
+    /** Mean CPI of the samples */
+    double cpiMean() const { return mean; }
+    /** Standard deviation of the sampled CPI */
+    double cpiStdev() const;
+    /**
+     * Half-width of the confidence interval of the mean CPI relative
+     * to the mean, or infinity with fewer than two samples.
+     */
+    double cpiError() const;
+
+  protected:
+    /** Phase that follows phase p in the sampling loop */
+    static Phase followingPhase(Phase p);
+
+    /** Length of phase p in instructions */
+    Counter phaseLength(Phase p) const;
+
+    /** Have we met the target error or the sample limit? */
+    bool isDone() const;
+
+    /** Record the CPI of the measurement interval that just ended */
+    void recordSample();
+
+    const std::vector<BaseCPU *> functionalCPUs;
+    const std::vector<BaseCPU *> detailedCPUs;
+
+    const Counter functionalWarming;
+    const Counter detailedWarming;
+    const Counter measurementLength;
+
+    const double targetError;
+    const double confidenceZ;
+    const unsigned minSamples;
+    const unsigned maxSamples;
+
+    Phase phase;
+
+    /** Tick and instruction counts at the start of the measurement */
+    Tick measurementStart;
+    std::vector<Counter> measurementStartInsts;
+
+    /** Running CPI statistics, updated with Welford's method */
+    unsigned numSamples;
+    double mean;
+    double sumSquaredDiffs;
+
+    Stats::Value samplesStat;
+    Stats::Value cpiMeanStat;
+    Stats::Value cpiStdevStat;
+    Stats::Value cpiErrorStat;
+};
+
+#endif // __CPU_SAMPLING_CONTROLLER_HH__
@@ -62,6 +62,9 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
     fastmem = Param.Bool(False, "Access memory directly")
+    max_run_ahead = Param.Unsigned(0, "Maximum number of cycles to execute "
+        "back to back, without going through the event queue, when no "
+        "other event is due in between")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
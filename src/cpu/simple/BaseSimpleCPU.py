@@ -51,3 +51,11 @@ class BaseSimpleCPU(BaseCPU):
             exit(1)
 
     branchPred = Param.BranchPredictor(NULL, "Branch Predictor")
+
+    spin_detection = Param.Bool(False, "Put threads that poll memory in "
+        "a tight loop to sleep until the memory is written or an "
+        "interrupt arrives")
+    spin_detect_iterations = Param.Unsigned(16, "Identical loop "
+        "iterations before a thread is considered to be spinning")
+    spin_detect_max_insts = Param.Unsigned(32, "Longest loop body (in "
+        "micro-ops) considered for spin detection")
@@ -83,10 +83,16 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
       simulate_inst_stalls(p->simulate_inst_stalls),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
-      fastmem(p->fastmem), dcache_access(false), dcache_latency(0),
+      fastmem(p->fastmem), maxRunAhead(p->max_run_ahead),
+      dcache_access(false), dcache_latency(0),
       ppCommit(nullptr)
 {
     _status = Idle;
+
+    // Accesses that bypass the memory system aren't snooped, so they
+    // wouldn't wake up a thread sleeping in a spin loop.
+    fatal_if(fastmem && !spinDetectors.empty(),
+             "%s: Spin loop detection doesn't work with fastmem\n", name());
 }
 
 
@@ -106,6 +112,8 @@ AtomicSimpleCPU::drain()
     if (switchedOut())
         return DrainState::Drained;
 
+    wakeSpinningThreads();
+
     if (!isDrained()) {
         DPRINTF(Drain, "Requesting drain.\n");
         return DrainState::Draining;
@@ -130,6 +138,7 @@ AtomicSimpleCPU::threadSnoop(PacketPtr pkt, ThreadID sender)
             if (getCpuAddrMonitor(tid)->doMonitor(pkt)) {
                 wakeup(tid);
             }
+            spinSnoop(tid, pkt);
 
             TheISA::handleLockedSnoop(threadInfo[tid]->thread,
                                       pkt, dcachePort.cacheBlockMask);
@@ -282,6 +291,7 @@ AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
         if (cpu->getCpuAddrMonitor(tid)->doMonitor(pkt)) {
             cpu->wakeup(tid);
         }
+        cpu->spinSnoop(tid, pkt);
     }
 
     // if snoop invalidates, release any associated locks
@@ -311,6 +321,7 @@ AtomicSimpleCPU::AtomicCPUDPort::recvFunctionalSnoop(PacketPtr pkt)
         if (cpu->getCpuAddrMonitor(tid)->doMonitor(pkt)) {
             cpu->wakeup(tid);
         }
+        cpu->spinSnoop(tid, pkt);
     }
 
     // if snoop invalidates, release any associated locks
@@ -376,6 +387,9 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data, unsigned size,
             if (req->isLLSC()) {
                 TheISA::handleLockedRead(thread, req);
             }
+
+            if (!spinDetectors.empty())
+                spinRecordLoad(req, data, size);
         }
 
         //If there's a fault, return it
@@ -535,6 +549,45 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
 
 void
 AtomicSimpleCPU::tick()
+{
+    for (unsigned run_ahead = 0; ; ++run_ahead) {
+        Tick latency = executeCycle();
+
+        if (tryCompleteDrain())
+            return;
+
+        // instruction takes at least one cycle
+        if (latency < clockPeriod())
+            latency = clockPeriod();
+
+        if (_status == Idle)
+            return;
+
+        // Nothing else is due before the next cycle of this CPU, so run
+        // it right away instead of going through the event queue.
+        if (run_ahead < maxRunAhead && canRunAhead(curTick() + latency)) {
+            setCurTick(curTick() + latency);
+            continue;
+        }
+
+        reschedule(tickEvent, curTick() + latency, true);
+        return;
+    }
+}
+
+bool
+AtomicSimpleCPU::canRunAhead(Tick when) const
+{
+    // Other threads may insert events into this queue at any time in
+    // parallel mode.
+    if (inParallelMode)
+        return false;
+
+    return eventQueue()->empty() || eventQueue()->nextTick() > when;
+}
+
+Tick
+AtomicSimpleCPU::executeCycle()
 {
     DPRINTF(SimpleCPU, "Tick\n");
 
@@ -565,10 +618,8 @@ AtomicSimpleCPU::tick()
         }
 
         // We must have just got suspended by a PC event
-        if (_status == Idle) {
-            tryCompleteDrain();
-            return;
-        }
+        if (_status == Idle)
+            return latency;
 
         Fault fault = NoFault;
 
@@ -616,7 +667,7 @@ AtomicSimpleCPU::tick()
 
             Tick stall_ticks = 0;
             if (curStaticInst) {
-                fault = curStaticInst->execute(&t_info, traceData);
+                fault = curStaticInst->executeSimple(&t_info, traceData);
 
                 // keep an instruction count
                 if (fault == NoFault) {
@@ -662,15 +713,7 @@ AtomicSimpleCPU::tick()
             advancePC(fault);
     }
 
-    if (tryCompleteDrain())
-        return;
-
-    // instruction takes at least one cycle
-    if (latency < clockPeriod())
-        latency = clockPeriod();
-
-    if (_status != Idle)
-        reschedule(tickEvent, curTick() + latency, true);
+    return latency;
 }
 
 void
@@ -70,6 +70,19 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     // main simulation loop (one cycle)
     void tick();
 
+    /**
+     * Executes one cycle worth of instructions and returns the stall
+     * latency it incurred.
+     */
+    Tick executeCycle();
+
+    /**
+     * Can the CPU move on to its next cycle at the given tick without
+     * going through the event queue, i.e., is no other event due by
+     * then?
+     */
+    bool canRunAhead(Tick when) const;
+
     /**
      * Check if a system is in a drained state.
      *
@@ -159,6 +172,13 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     AtomicCPUDPort dcachePort;
 
     bool fastmem;
+
+    /**
+     * Maximum number of consecutive cycles executed in a single tick
+     * event when no other event is due in between.
+     */
+    const unsigned maxRunAhead;
+
     Request ifetch_req;
     Request data_read_req;
     Request data_write_req;
@@ -47,6 +47,7 @@
 #include "arch/stacktrace.hh"
 #include "arch/utility.hh"
 #include "arch/vtophys.hh"
+#include "base/callback.hh"
 #include "base/cp_annotate.hh"
 #include "base/cprintf.hh"
 #include "base/inifile.hh"
@@ -70,6 +71,7 @@
 #include "debug/Decode.hh"
 #include "debug/Fetch.hh"
 #include "debug/Quiesce.hh"
+#include "debug/SpinLoop.hh"
 #include "mem/mem_object.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
@@ -109,6 +111,14 @@ BaseSimpleCPU::BaseSimpleCPU(BaseSimpleCPUParams *p)
         threadContexts.push_back(tc);
     }
 
+    if (p->spin_detection) {
+        for (unsigned i = 0; i < numThreads; i++) {
+            spinDetectors.emplace_back(p->spin_detect_iterations,
+                                       p->spin_detect_max_insts,
+                                       cacheLineSize());
+        }
+    }
+
     if (p->checker) {
         if (numThreads != 1)
             fatal("Checker currently does not support SMT");
@@ -146,7 +156,7 @@ BaseSimpleCPU::checkPcEventQueue()
     Addr oldpc, pc = threadInfo[curThread]->thread->instAddr();
     do {
         oldpc = pc;
-        system->pcEventQueue.service(threadContexts[curThread]);
+        system->pcEventQueue.service(oldpc, threadContexts[curThread]);
         pc = threadInfo[curThread]->thread->instAddr();
     } while (oldpc != pc);
 }
@@ -174,10 +184,10 @@ BaseSimpleCPU::countInst()
 
     if (!curStaticInst->isMicroop() || curStaticInst->isLastMicroop()) {
         t_info.numInst++;
-        t_info.numInsts++;
+        t_info.pendingStats.insts++;
     }
     t_info.numOp++;
-    t_info.numOps++;
+    t_info.pendingStats.ops++;
 
     system->totalNumInsts++;
     t_info.thread->funcExeInst++;
@@ -400,7 +410,23 @@ BaseSimpleCPU::regStats()
             .name(thread_str + ".BranchMispred")
             .desc("Number of branch mispredictions")
             .prereq(t_info.numBranchMispred);
+
+        t_info.numSpinSleeps
+            .name(thread_str + ".spinSleeps")
+            .desc("Number of times the thread slept in a spin loop")
+            .prereq(t_info.numSpinSleeps);
+
+        t_info.numSpinSleepCycles
+            .name(thread_str + ".spinSleepCycles")
+            .desc("Number of cycles spent sleeping in spin loops")
+            .prereq(t_info.numSpinSleepCycles);
     }
+
+    registerPrepareCallback(
+        new MakeCallback<BaseSimpleCPU, &BaseSimpleCPU::flushStats>(this));
+    registerSampleCallback(
+        new MakeCallback<BaseSimpleCPU,
+                         &BaseSimpleCPU::flushLocalStats>(this));
 }
 
 void
@@ -408,9 +434,29 @@ BaseSimpleCPU::resetStats()
 {
     for (auto &thread_info : threadInfo) {
         thread_info->notIdleFraction = (_status != Idle);
+        thread_info->clearPendingStats();
     }
 }
 
+void
+BaseSimpleCPU::flushStats()
+{
+    for (auto &thread_info : threadInfo)
+        thread_info->flushStats();
+}
+
+void
+BaseSimpleCPU::flushLocalStats()
+{
+    // The pending counts belong to the thread simulating this CPU, so
+    // leave them alone if another event queue samples the stats in
+    // parallel mode.
+    if (inParallelMode && curEventQueue() != eventQueue())
+        return;
+
+    flushStats();
+}
+
 void
 BaseSimpleCPU::serializeThread(CheckpointOut &cp, ThreadID tid) const
 {
@@ -443,10 +489,84 @@ BaseSimpleCPU::wakeup(ThreadID tid)
 
     if (threadInfo[tid]->thread->status() == ThreadContext::Suspended) {
         DPRINTF(Quiesce,"[tid:%d] Suspended Processor awoke\n", tid);
+        if (!spinDetectors.empty() && spinDetectors[tid].sleeping())
+            endSpinSleep(tid);
         threadInfo[tid]->thread->activate();
     }
 }
 
+void
+BaseSimpleCPU::spinSnoop(ThreadID tid, PacketPtr pkt)
+{
+    if (spinDetectors.empty())
+        return;
+
+    if (spinDetectors[tid].snoop(pkt->getAddr())) {
+        DPRINTF(SpinLoop, "[tid:%d] Snoop to %#x ends spin\n",
+                tid, pkt->getAddr());
+        wakeup(tid);
+    }
+}
+
+void
+BaseSimpleCPU::checkSpinLoop(const Fault &fault, Addr inst_addr)
+{
+    SpinLoopDetector &detector = spinDetectors[curThread];
+
+    // The thread may have been activated by something other than a
+    // snoop or an interrupt, e.g. an IPI.
+    if (detector.sleeping())
+        endSpinSleep(curThread);
+
+    if (fault != NoFault || !curStaticInst) {
+        detector.reset();
+        return;
+    }
+
+    SimpleThread *thread = threadInfo[curThread]->thread;
+    if (!detector.commit(curStaticInst, inst_addr, thread->instAddr(),
+                         threadContexts[curThread])) {
+        return;
+    }
+
+    DPRINTF(SpinLoop, "[tid:%d] Spinning at %#x, suspending\n",
+            curThread, thread->instAddr());
+    detector.sleep(curTick());
+    ++threadInfo[curThread]->numSpinSleeps;
+    threadContexts[curThread]->suspend();
+}
+
+void
+BaseSimpleCPU::spinRecordLoad(Request *req, const uint8_t *data,
+                              unsigned size)
+{
+    if (req->getFlags().isSet(Request::NO_ACCESS))
+        return;
+
+    spinDetectors[curThread].recordLoad(
+        req->getPaddr(), data, size,
+        req->isUncacheable() || req->isMmappedIpr());
+}
+
+void
+BaseSimpleCPU::endSpinSleep(ThreadID tid)
+{
+    const Tick slept(curTick() - spinDetectors[tid].wake());
+    DPRINTF(SpinLoop, "[tid:%d] Woke up after %d ticks\n", tid, slept);
+    threadInfo[tid]->numSpinSleepCycles += ticksToCycles(slept);
+}
+
+void
+BaseSimpleCPU::wakeSpinningThreads()
+{
+    for (ThreadID tid = 0; tid < spinDetectors.size(); tid++) {
+        if (spinDetectors[tid].sleeping()) {
+            endSpinSleep(tid);
+            threadInfo[tid]->thread->setStatus(ThreadContext::Active);
+        }
+    }
+}
+
 void
 BaseSimpleCPU::checkForInterrupts()
 {
@@ -593,8 +713,10 @@ BaseSimpleCPU::postExecute()
             thread->profileNode = node;
     }
 
+    SimpleExecContext::PendingStats &pending = t_info.pendingStats;
+
     if (curStaticInst->isMemRef()) {
-        t_info.numMemRefs++;
+        pending.memRefs++;
     }
 
     if (curStaticInst->isLoad()) {
@@ -607,49 +729,46 @@ BaseSimpleCPU::postExecute()
     }
 
     if (curStaticInst->isControl()) {
-        ++t_info.numBranches;
+        ++pending.branches;
     }
 
     /* Power model statistics */
     //integer alu accesses
     if (curStaticInst->isInteger()){
-        t_info.numIntAluAccesses++;
-        t_info.numIntInsts++;
+        pending.intInsts++;
     }
 
     //float alu accesses
     if (curStaticInst->isFloating()){
-        t_info.numFpAluAccesses++;
-        t_info.numFpInsts++;
+        pending.fpInsts++;
     }
 
     //vector alu accesses
     if (curStaticInst->isVector()){
-        t_info.numVecAluAccesses++;
-        t_info.numVecInsts++;
+        pending.vecInsts++;
     }
 
     //number of function calls/returns to get window accesses
     if (curStaticInst->isCall() || curStaticInst->isReturn()){
-        t_info.numCallsReturns++;
+        pending.callsReturns++;
     }
 
     //the number of branch predictions that will be made
     if (curStaticInst->isCondCtrl()){
-        t_info.numCondCtrlInsts++;
+        pending.condCtrlInsts++;
     }
 
     //result bus acceses
     if (curStaticInst->isLoad()){
-        t_info.numLoadInsts++;
+        pending.loadInsts++;
     }
 
     if (curStaticInst->isStore()){
-        t_info.numStoreInsts++;
+        pending.storeInsts++;
     }
     /* End power model statistics */
 
-    t_info.statExecutedInstType[curStaticInst->opClass()]++;
+    pending.instType[curStaticInst->opClass()]++;
 
     if (FullSystem)
         traceFunctions(instAddr);
@@ -671,6 +790,7 @@ BaseSimpleCPU::advancePC(const Fault &fault)
     SimpleThread* thread = t_info.thread;
 
     const bool branching(thread->pcState().branching());
+    const Addr inst_addr(thread->instAddr());
 
     //Since we're moving to a new pc, zero out the offset
     t_info.fetchOffset = 0;
@@ -702,6 +822,9 @@ BaseSimpleCPU::advancePC(const Fault &fault)
             ++t_info.numBranchMispred;
         }
     }
+
+    if (!spinDetectors.empty())
+        checkSpinLoop(fault, inst_addr);
 }
 
 void
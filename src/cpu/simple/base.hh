@@ -52,6 +52,7 @@
 #include "cpu/checker/cpu.hh"
 #include "cpu/exec_context.hh"
 #include "cpu/pc_event.hh"
+#include "cpu/simple/spin_detector.hh"
 #include "cpu/simple_thread.hh"
 #include "cpu/static_inst.hh"
 #include "mem/packet.hh"
@@ -136,10 +137,59 @@ class BaseSimpleCPU : public BaseCPU
 
     void haltContext(ThreadID thread_num) override;
 
+    /**
+     * Check a snoop against the lines polled by a thread spinning in a
+     * loop, and wake the thread up if it was sleeping on one of them.
+     */
+    void spinSnoop(ThreadID tid, PacketPtr pkt);
+
+  protected:
+    /** Per-thread spin loop detectors, empty if detection is disabled */
+    std::vector<SpinLoopDetector> spinDetectors;
+
+    /**
+     * Feed the instruction that has just been committed to the spin
+     * loop detector and put the thread to sleep if it is spinning.
+     *
+     * @param fault Fault raised by the instruction
+     * @param inst_addr Address of the instruction
+     */
+    void checkSpinLoop(const Fault &fault, Addr inst_addr);
+
+    /** Record a load by the current thread for the spin loop detector */
+    void spinRecordLoad(Request *req, const uint8_t *data,
+                        unsigned size);
+
+    /** Account for the end of a thread's sleep in a spin loop */
+    void endSpinSleep(ThreadID tid);
+
+    /**
+     * Make threads that sleep in a spin loop runnable again. Only this
+     * CPU model wakes them up on a snoop, so they mustn't be left
+     * suspended when the CPU is drained for a switch or a checkpoint.
+     */
+    void wakeSpinningThreads();
+
+  public:
+
     // statistics
     void regStats() override;
     void resetStats() override;
 
+    /**
+     * Adds the per instruction counts accumulated by all threads to
+     * their stats. Called whenever the stats are prepared, see
+     * Stats::registerPrepareCallback().
+     */
+    void flushStats();
+
+    /**
+     * Flushes the pending counts before the stats are sampled, unless
+     * the sampling runs on another event queue in parallel mode. See
+     * Stats::registerSampleCallback().
+     */
+    void flushLocalStats();
+
     void startup() override;
 
     virtual Fault readMem(Addr addr, uint8_t* data, unsigned size,
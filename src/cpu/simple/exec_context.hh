@@ -45,11 +45,14 @@
 #ifndef __CPU_SIMPLE_EXEC_CONTEXT_HH__
 #define __CPU_SIMPLE_EXEC_CONTEXT_HH__
 
+#include <array>
+
 #include "arch/registers.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
 #include "cpu/base.hh"
 #include "cpu/exec_context.hh"
+#include "cpu/op_class.hh"
 #include "cpu/reg_class.hh"
 #include "cpu/simple/base.hh"
 #include "cpu/static_inst_fwd.hh"
@@ -58,7 +61,7 @@
 
 class BaseSimpleCPU;
 
-class SimpleExecContext : public ExecContext {
+class SimpleExecContext final : public ExecContext {
   protected:
     typedef TheISA::MiscReg MiscReg;
     typedef TheISA::FloatReg FloatReg;
@@ -163,14 +166,75 @@ class SimpleExecContext : public ExecContext {
     Stats::Scalar numBranchMispred;
     /// @}
 
+    /// Number of times the thread was put to sleep in a spin loop
+    Stats::Scalar numSpinSleeps;
+    /// Number of cycles spent sleeping in spin loops
+    Stats::Scalar numSpinSleepCycles;
+
    // Instruction mix histogram by OpClass
    Stats::Vector statExecutedInstType;
 
+    /**
+     * Per instruction counts that haven't been added to the stats above
+     * yet. Bumping these adjacent counters is much cheaper than
+     * updating the scattered stats for every instruction. They are
+     * flushed before the stats are read, see flushStats().
+     */
+    struct PendingStats
+    {
+        Counter insts;
+        Counter ops;
+        Counter memRefs;
+        Counter branches;
+        Counter intInsts;
+        Counter fpInsts;
+        Counter vecInsts;
+        Counter callsReturns;
+        Counter condCtrlInsts;
+        Counter loadInsts;
+        Counter storeInsts;
+        std::array<Counter, Num_OpClasses> instType;
+    };
+
+    PendingStats pendingStats;
+
+    /** Adds the pending counts to the stats. */
+    void
+    flushStats()
+    {
+        PendingStats &p = pendingStats;
+
+        numInsts += p.insts;
+        numOps += p.ops;
+        numMemRefs += p.memRefs;
+        numBranches += p.branches;
+        numIntAluAccesses += p.intInsts;
+        numIntInsts += p.intInsts;
+        numFpAluAccesses += p.fpInsts;
+        numFpInsts += p.fpInsts;
+        numVecAluAccesses += p.vecInsts;
+        numVecInsts += p.vecInsts;
+        numCallsReturns += p.callsReturns;
+        numCondCtrlInsts += p.condCtrlInsts;
+        numLoadInsts += p.loadInsts;
+        numStoreInsts += p.storeInsts;
+        for (int i = 0; i < Num_OpClasses; ++i) {
+            if (p.instType[i])
+                statExecutedInstType[i] += p.instType[i];
+        }
+
+        clearPendingStats();
+    }
+
+    /** Drops the pending counts, e.g., when the stats are reset. */
+    void clearPendingStats() { pendingStats = PendingStats(); }
+
   public:
     /** Constructor */
     SimpleExecContext(BaseSimpleCPU* _cpu, SimpleThread* _thread)
         : cpu(_cpu), thread(_thread), fetchOffset(0), stayAtPC(false),
-        numInst(0), numOp(0), numLoad(0), lastIcacheStall(0), lastDcacheStall(0)
+        numInst(0), numOp(0), numLoad(0), lastIcacheStall(0),
+        lastDcacheStall(0), pendingStats()
     { }
 
     /** Reads an integer register. */
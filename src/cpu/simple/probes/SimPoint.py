@@ -46,3 +46,5 @@ class SimPoint(ProbeListenerObject):
 
     interval = Param.UInt64(100000000, "Interval Size (insts)")
     profile_file = Param.String("simpoint.bb.gz", "BBV (output) file")
+    binary_output = Param.Bool(False, "Write BBVs in the compact binary "
+        "format read by util/simpoint instead of the SimPoint text format")
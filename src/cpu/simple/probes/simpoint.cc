@@ -45,15 +45,28 @@
 SimPoint::SimPoint(const SimPointParams *p)
     : ProbeListenerObject(p),
       intervalSize(p->interval),
+      binaryOutput(p->binary_output),
       intervalCount(0),
       intervalDrift(0),
       simpointStream(NULL),
       currentBBV(0, 0),
       currentBBVInstCount(0)
 {
-    simpointStream = simout.create(p->profile_file, false);
+    simpointStream = simout.create(p->profile_file, binaryOutput);
     if (!simpointStream)
         fatal("unable to open SimPoint profile_file");
+
+    if (binaryOutput) {
+        std::ostream &os = *simpointStream->stream();
+        os.write(simpointBinaryMagic, sizeof(simpointBinaryMagic));
+        os.write((const char *)&simpointBinaryVersion,
+                 sizeof(simpointBinaryVersion));
+    }
+
+    for (auto &entry : bbCache) {
+        entry.bb = BasicBlockRange(0, 0);
+        entry.id = 0;
+    }
 }
 
 SimPoint::~SimPoint()
@@ -93,54 +106,83 @@ SimPoint::profile(const std::pair<SimpleThread*, StaticInstPtr>& p)
     if (inst->isControl()) {
         currentBBV.second = thread->pcState().instAddr();
 
-        auto map_itr = bbMap.find(currentBBV);
-        if (map_itr == bbMap.end()){
-            // If a new (previously unseen) basic block is found,
-            // add a new unique id, record num of insts and insert into bbMap.
-            BBInfo info;
-            info.id = bbMap.size() + 1;
-            info.insts = currentBBVInstCount;
-            info.count = currentBBVInstCount;
-            bbMap.insert(std::make_pair(currentBBV, info));
-        } else {
-            // If basic block is seen before, just increment the count by the
-            // number of insts in basic block.
-            BBInfo& info = map_itr->second;
-            info.count += currentBBVInstCount;
-        }
+        uint32_t id = lookupBB(currentBBV, currentBBVInstCount);
+        BBInfo& info = bbInfo[id - 1];
+        if (info.count == 0)
+            touchedBBs.push_back(id);
+        info.count += currentBBVInstCount;
         currentBBVInstCount = 0;
 
         // Reached end of interval if the sum of the current inst count
         // (intervalCount) and the excessive inst count from the previous
         // interval (intervalDrift) is greater than/equal to the interval size.
         if (intervalCount + intervalDrift >= intervalSize) {
-            // summarize interval and display BBV info
-            std::vector<std::pair<uint64_t, uint64_t> > counts;
-            for (auto map_itr = bbMap.begin(); map_itr != bbMap.end();
-                    ++map_itr) {
-                BBInfo& info = map_itr->second;
-                if (info.count != 0) {
-                    counts.push_back(std::make_pair(info.id, info.count));
-                    info.count = 0;
-                }
-            }
-            std::sort(counts.begin(), counts.end());
-
-            // Print output BBV info
-            *simpointStream->stream() << "T";
-            for (auto cnt_itr = counts.begin(); cnt_itr != counts.end();
-                    ++cnt_itr) {
-                *simpointStream->stream() << ":" << cnt_itr->first
-                                << ":" << cnt_itr->second << " ";
-            }
-            *simpointStream->stream() << "\n";
-
+            dumpInterval();
             intervalDrift = (intervalCount + intervalDrift) - intervalSize;
             intervalCount = 0;
         }
     }
 }
 
+uint32_t
+SimPoint::lookupBB(const BasicBlockRange &bb, uint64_t insts)
+{
+    BBCacheEntry &entry = bbCache[(bb.second ^ (bb.second >> 10)) %
+                                  bbCacheSize];
+    if (entry.id && entry.bb == bb)
+        return entry.id;
+
+    auto map_itr = bbMap.find(bb);
+    uint32_t id;
+    if (map_itr == bbMap.end()) {
+        // If a new (previously unseen) basic block is found, add a new
+        // unique id, record num of insts and insert into bbMap.
+        id = bbInfo.size() + 1;
+        BBInfo info;
+        info.insts = insts;
+        info.count = 0;
+        bbInfo.push_back(info);
+        bbMap.insert(std::make_pair(bb, id));
+    } else {
+        id = map_itr->second;
+    }
+
+    entry.bb = bb;
+    entry.id = id;
+    return id;
+}
+
+void
+SimPoint::dumpInterval()
+{
+    // Only the blocks executed in this interval have non-zero counts,
+    // so there is no need to walk every block seen so far.
+    std::sort(touchedBBs.begin(), touchedBBs.end());
+
+    std::ostream &os = *simpointStream->stream();
+    if (binaryOutput) {
+        uint32_t entries = touchedBBs.size();
+        os.write((const char *)&entries, sizeof(entries));
+    } else {
+        os << "T";
+    }
+
+    for (uint32_t id : touchedBBs) {
+        BBInfo& info = bbInfo[id - 1];
+        if (binaryOutput) {
+            os.write((const char *)&id, sizeof(id));
+            os.write((const char *)&info.count, sizeof(info.count));
+        } else {
+            os << ":" << id << ":" << info.count << " ";
+        }
+        info.count = 0;
+    }
+
+    if (!binaryOutput)
+        os << "\n";
+    touchedBBs.clear();
+}
+
 /** SimPoint SimObject */
 SimPoint*
 SimPointParams::create()
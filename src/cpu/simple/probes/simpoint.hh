@@ -41,7 +41,9 @@
 #ifndef __CPU_SIMPLE_PROBES_SIMPOINT_HH__
 #define __CPU_SIMPLE_PROBES_SIMPOINT_HH__
 
+#include <array>
 #include <unordered_map>
+#include <vector>
 
 #include "base/output.hh"
 #include "cpu/simple_thread.hh"
@@ -72,6 +74,17 @@ struct hash<BasicBlockRange>
 };
 }
 
+/**
+ * Binary BBV files, written when SimPoint::binary_output is set, start
+ * with the magic string below followed by a uint32_t format version.
+ * Each interval is then a uint32_t entry count followed by that many
+ * (uint32_t basic block id, uint64_t instruction count) pairs, in
+ * increasing id order. All values are in host byte order. Basic block
+ * ids are the same dense, 1-based ids used by the text format.
+ */
+const char simpointBinaryMagic[8] = {'g', 'e', 'm', '5', 'b', 'b', 'v', '\0'};
+const uint32_t simpointBinaryVersion = 1;
+
 class SimPoint : public ProbeListenerObject
 {
   public:
@@ -90,8 +103,15 @@ class SimPoint : public ProbeListenerObject
     void profile(const std::pair<SimpleThread*, StaticInstPtr>&);
 
   private:
+    /** Dense id of a basic block, assigning one on first sight */
+    uint32_t lookupBB(const BasicBlockRange &bb, uint64_t insts);
+    /** Write out and reset the counts of the interval just finished */
+    void dumpInterval();
+
     /** SimPoint profiling interval size in instructions */
     const uint64_t intervalSize;
+    /** Write BBVs in the binary format instead of text */
+    const bool binaryOutput;
 
     /** Inst count in current basic block */
     uint64_t intervalCount;
@@ -102,16 +122,31 @@ class SimPoint : public ProbeListenerObject
 
     /** Basic Block information */
     struct BBInfo {
-        /** Unique ID */
-        uint64_t id;
         /** Num of static insts in BB */
         uint64_t insts;
         /** Accumulated dynamic inst count executed by BB */
         uint64_t count;
     };
 
-    /** Hash table containing all previously seen basic blocks */
-    std::unordered_map<BasicBlockRange, BBInfo> bbMap;
+    /** Ids of all previously seen basic blocks */
+    std::unordered_map<BasicBlockRange, uint32_t> bbMap;
+    /** Per-block information, indexed by id - 1 */
+    std::vector<BBInfo> bbInfo;
+    /** Ids of the blocks executed in the current interval */
+    std::vector<uint32_t> touchedBBs;
+
+    /**
+     * Small direct-mapped cache of recently executed blocks, indexed
+     * by the PC of their last instruction. Hot loops hit here and
+     * never hash the full range into bbMap.
+     */
+    struct BBCacheEntry {
+        BasicBlockRange bb;
+        uint32_t id;
+    };
+    static const unsigned bbCacheSize = 1024;
+    std::array<BBCacheEntry, bbCacheSize> bbCache;
+
     /** Currently executing basic block */
     BasicBlockRange currentBBV;
     /** inst count in current basic block */
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/spin_detector.hh"
+
+#include <algorithm>
+
+#include "arch/registers.hh"
+#include "config/the_isa.hh"
+#include "cpu/static_inst.hh"
+#include "cpu/thread_context.hh"
+
+namespace
+{
+
+const uint64_t hashSeed = 0xcbf29ce484222325ULL;
+
+uint64_t
+hashMix(uint64_t hash, uint64_t value)
+{
+    hash = (hash ^ value) * 0x100000001b3ULL;
+    return hash ^ (hash >> 29);
+}
+
+} // anonymous namespace
+
+SpinLoopDetector::SpinLoopDetector(unsigned _iterations,
+                                   unsigned max_loop_insts,
+                                   unsigned line_size)
+    : iterations(_iterations), maxLoopInsts(max_loop_insts),
+      lineMask(~Addr(line_size - 1)),
+      asleep(false), sleepTick(0)
+{
+    reset();
+}
+
+void
+SpinLoopDetector::reset()
+{
+    loopHead = MaxAddr;
+    matches = 0;
+    lastHash = 0;
+    startIteration();
+}
+
+void
+SpinLoopDetector::startIteration()
+{
+    iterInsts = 0;
+    loadHash = hashSeed;
+    clean = true;
+    disturbed = false;
+    lines.clear();
+}
+
+void
+SpinLoopDetector::recordLoad(Addr paddr, const uint8_t *data,
+                             unsigned size, bool uncacheable)
+{
+    // Only polling of cacheable memory can be woken up by a snoop
+    if (uncacheable || loopHead == MaxAddr) {
+        clean = false;
+        return;
+    }
+
+    const Addr line(paddr & lineMask);
+    if (std::find(lines.begin(), lines.end(), line) == lines.end()) {
+        if (lines.size() == maxLines) {
+            clean = false;
+            return;
+        }
+        lines.push_back(line);
+    }
+
+    loadHash = hashMix(loadHash, paddr);
+    for (unsigned i = 0; i < size; ++i)
+        loadHash = hashMix(loadHash, data[i]);
+}
+
+bool
+SpinLoopDetector::commit(const StaticInstPtr &inst, Addr pc, Addr next_pc,
+                         ThreadContext *tc)
+{
+    if (inst->isStore() || inst->isFloating() || inst->isVector() ||
+        inst->isSyscall() || inst->isQuiesce() || inst->isIprAccess()) {
+        clean = false;
+    }
+
+    ++iterInsts;
+
+    // Only a taken backward branch can close an iteration
+    if (!inst->isControl() || next_pc > pc) {
+        if (iterInsts > maxLoopInsts && loopHead != MaxAddr)
+            reset();
+        return false;
+    }
+
+    if (next_pc != loopHead) {
+        // A new loop
+        matches = 0;
+        loopHead = next_pc;
+        startIteration();
+        return false;
+    }
+
+    if (clean && !disturbed && !lines.empty() &&
+        iterInsts <= maxLoopInsts) {
+        const uint64_t hash(hashMix(loadHash, hashState(tc)));
+        if (matches && hash == lastHash) {
+            ++matches;
+        } else {
+            matches = 1;
+        }
+        lastHash = hash;
+    } else {
+        matches = 0;
+    }
+
+    if (matches >= iterations) {
+        // Keep the lines polled in the last iteration so that they
+        // are monitored while the thread sleeps.
+        iterInsts = 0;
+        disturbed = false;
+        return true;
+    }
+
+    startIteration();
+    return false;
+}
+
+bool
+SpinLoopDetector::snoop(Addr paddr)
+{
+    const Addr line(paddr & lineMask);
+    if (std::find(lines.begin(), lines.end(), line) == lines.end())
+        return false;
+
+    disturbed = true;
+    return asleep;
+}
+
+void
+SpinLoopDetector::sleep(Tick when)
+{
+    assert(!asleep);
+    asleep = true;
+    sleepTick = when;
+}
+
+Tick
+SpinLoopDetector::wake()
+{
+    assert(asleep);
+    asleep = false;
+    reset();
+    return sleepTick;
+}
+
+uint64_t
+SpinLoopDetector::hashState(ThreadContext *tc)
+{
+    uint64_t hash(hashSeed);
+    for (int i = 0; i < TheISA::NumIntRegs; ++i)
+        hash = hashMix(hash, tc->readIntRegFlat(i));
+    for (int i = 0; i < TheISA::NumCCRegs; ++i)
+        hash = hashMix(hash, tc->readCCRegFlat(i));
+    return hash;
+}
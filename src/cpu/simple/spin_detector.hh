@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_SPIN_DETECTOR_HH__
+#define __CPU_SIMPLE_SPIN_DETECTOR_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/static_inst_fwd.hh"
+
+class ThreadContext;
+
+/**
+ * Detects a thread polling memory in a tight loop.
+ *
+ * An iteration of a loop ends whenever a taken backward branch goes
+ * back to the start of the previous iteration. If an iteration
+ * doesn't store, only reads cacheable memory and leaves the registers
+ * and the loaded values the same as the iteration before it, then
+ * the next one will do exactly the same thing until either another
+ * agent writes one of the polled lines or the thread takes an
+ * interrupt. After a number of such iterations the thread can be put
+ * to sleep and woken up by a snoop or an interrupt instead.
+ *
+ * The check is deliberately conservative: loops that touch FP or
+ * vector state, make system calls, access IPRs or are longer than a
+ * few instructions are never considered to be spinning.
+ */
+class SpinLoopDetector
+{
+  public:
+    /**
+     * @param iterations Identical iterations before the loop is
+     * considered to be spinning
+     * @param max_loop_insts Longest loop body to look at
+     * @param line_size Cache line size
+     */
+    SpinLoopDetector(unsigned iterations, unsigned max_loop_insts,
+                     unsigned line_size);
+
+    /** Forget about the current loop */
+    void reset();
+
+    /**
+     * Record a load by the current instruction.
+     *
+     * @param paddr Physical address of the access
+     * @param data Loaded data
+     * @param size Size of the access
+     * @param uncacheable True if the load bypassed the caches
+     */
+    void recordLoad(Addr paddr, const uint8_t *data, unsigned size,
+                    bool uncacheable);
+
+    /**
+     * Record a committed instruction.
+     *
+     * @param inst The instruction
+     * @param pc Address of the instruction
+     * @param next_pc Address of the next instruction to execute
+     * @param tc Thread that executed it
+     * @return True if the thread is spinning and can go to sleep
+     */
+    bool commit(const StaticInstPtr &inst, Addr pc, Addr next_pc,
+                ThreadContext *tc);
+
+    /**
+     * Check a snoop against the lines polled by the current loop.
+     *
+     * @param paddr Physical address of the snoop
+     * @return True if the thread is sleeping and should be woken up
+     */
+    bool snoop(Addr paddr);
+
+    /** Put the thread to sleep at the given tick */
+    void sleep(Tick when);
+    /** Is the thread sleeping in a spin loop? */
+    bool sleeping() const { return asleep; }
+    /**
+     * Wake the thread up.
+     * @return When the thread went to sleep
+     */
+    Tick wake();
+
+  protected:
+    /** Hash the architectural state the loop can depend on */
+    static uint64_t hashState(ThreadContext *tc);
+
+    /** Start a new iteration at the current loop head */
+    void startIteration();
+
+    /** Identical iterations before the loop is considered spinning */
+    const unsigned iterations;
+    /** Longest loop body to look at */
+    const unsigned maxLoopInsts;
+    /** Mask to get a cache line address */
+    const Addr lineMask;
+
+    /** Start of the loop, MaxAddr if there isn't one */
+    Addr loopHead;
+    /** Instructions committed so far in this iteration */
+    unsigned iterInsts;
+    /** Hash of the addresses and values loaded in this iteration */
+    uint64_t loadHash;
+    /** Has this iteration done nothing to rule out spinning? */
+    bool clean;
+    /** Has another agent accessed a line polled in this iteration? */
+    bool disturbed;
+    /** Lines read in this iteration */
+    std::vector<Addr> lines;
+
+    /** State at the end of the previous iteration */
+    uint64_t lastHash;
+    /** Number of identical iterations seen in a row */
+    unsigned matches;
+
+    /** Is the thread sleeping? */
+    bool asleep;
+    /** When did the thread go to sleep? */
+    Tick sleepTick;
+
+    /** Most lines a spin loop is allowed to poll */
+    static const unsigned maxLines = 4;
+};
+
+#endif // __CPU_SIMPLE_SPIN_DETECTOR_HH__
@@ -99,6 +99,8 @@ TimingSimpleCPU::drain()
     if (switchedOut())
         return DrainState::Drained;
 
+    wakeSpinningThreads();
+
     if (_status == Idle ||
         (_status == BaseSimpleCPU::Running && isDrained())) {
         DPRINTF(Drain, "No need to drain.\n");
@@ -562,6 +564,7 @@ TimingSimpleCPU::threadSnoop(PacketPtr pkt, ThreadID sender)
             if (getCpuAddrMonitor(tid)->doMonitor(pkt)) {
                 wakeup(tid);
             }
+            spinSnoop(tid, pkt);
             TheISA::handleLockedSnoop(threadInfo[tid]->thread, pkt,
                     dcachePort.cacheBlockMask);
         }
@@ -754,7 +757,7 @@ TimingSimpleCPU::completeIfetch(PacketPtr pkt)
         }
     } else if (curStaticInst) {
         // non-memory instruction: execute completely now
-        Fault fault = curStaticInst->execute(&t_info, traceData);
+        Fault fault = curStaticInst->executeSimple(&t_info, traceData);
 
         // keep an instruction count
         if (fault == NoFault)
@@ -827,7 +830,8 @@ TimingSimpleCPU::completeDataAccess(PacketPtr pkt)
     updateCycleCounts();
     updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
-    if (pkt->senderState) {
+    const bool split(pkt->senderState);
+    if (split) {
         SplitFragmentSenderState * send_state =
             dynamic_cast<SplitFragmentSenderState *>(pkt->senderState);
         assert(send_state);
@@ -854,6 +858,15 @@ TimingSimpleCPU::completeDataAccess(PacketPtr pkt)
 
     _status = BaseSimpleCPU::Running;
 
+    if (!spinDetectors.empty() && pkt->isRead()) {
+        // Only the first line of a split access would be monitored
+        if (split)
+            spinDetectors[curThread].reset();
+        else
+            spinRecordLoad(pkt->req, pkt->getConstPtr<uint8_t>(),
+                           pkt->getSize());
+    }
+
     Fault fault = curStaticInst->completeAcc(pkt, threadInfo[curThread],
                                              traceData);
 
@@ -891,6 +904,7 @@ TimingSimpleCPU::DcachePort::recvTimingSnoopReq(PacketPtr pkt)
         if (cpu->getCpuAddrMonitor(tid)->doMonitor(pkt)) {
             cpu->wakeup(tid);
         }
+        cpu->spinSnoop(tid, pkt);
     }
 
     // Making it uniform across all CPUs:
@@ -911,6 +925,7 @@ TimingSimpleCPU::DcachePort::recvFunctionalSnoop(PacketPtr pkt)
         if (cpu->getCpuAddrMonitor(tid)->doMonitor(pkt)) {
             cpu->wakeup(tid);
         }
+        cpu->spinSnoop(tid, pkt);
     }
 }
 
@@ -256,6 +256,17 @@ class StaticInst : public RefCounted, public StaticInstFlags
     virtual Fault execute(ExecContext *xc,
                           Trace::InstRecord *traceData) const = 0;
 
+    /**
+     * Execute with a SimpleExecContext, which xc must point to. ISAs
+     * can override this with a variant of execute() instantiated on
+     * the concrete type, see ISAParser.execVariants().
+     */
+    virtual Fault
+    executeSimple(ExecContext *xc, Trace::InstRecord *traceData) const
+    {
+        return execute(xc, traceData);
+    }
+
     virtual Fault initiateAcc(ExecContext *xc,
                               Trace::InstRecord *traceData) const
     {
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/garnet_trace_replay/GarnetTraceReplay.hh"
+
+#include <algorithm>
+
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/GarnetTraceReplay.hh"
+#include "mem/ruby/common/NetDest.hh"
+#include "mem/ruby/network/MessageBuffer.hh"
+#include "mem/ruby/slicc_interface/Message.hh"
+#include "proto/network_trace.pb.h"
+#include "proto/protoio.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+
+namespace
+{
+
+/** A message of the trace, which only the network gets to see. */
+class ReplayMessage : public Message
+{
+  public:
+    ReplayMessage(Tick cur_time, size_t index, const NetDest &dest,
+                  MessageSizeType size)
+        : Message(cur_time), m_index(index), m_dest(dest), m_size(size)
+    {}
+
+    // Index of the record of the message in the trace
+    size_t getIndex() const { return m_index; }
+
+    MsgPtr clone() const override { return new ReplayMessage(*this); }
+
+    void
+    print(std::ostream& out) const override
+    {
+        ccprintf(out, "[ReplayMessage index=%d size=%s]", m_index,
+                 MessageSizeType_to_string(m_size));
+    }
+
+    const MessageSizeType &
+    getMessageSize() const override { return m_size; }
+    MessageSizeType &getMessageSize() override { return m_size; }
+
+    const NetDest &getDestination() const override { return m_dest; }
+    NetDest &getDestination() override { return m_dest; }
+
+    bool functionalRead(Packet *pkt) override { return false; }
+    bool functionalWrite(Packet *pkt) override { return false; }
+
+    FunctionalScope
+    functionalScope(Addr &line) const override
+    {
+        return FunctionalNone;
+    }
+
+  private:
+    const size_t m_index;
+    NetDest m_dest;
+    MessageSizeType m_size;
+};
+
+MachineID
+nodeToMachineID(NodeID node)
+{
+    for (int m = 0; m < (int)MachineType_NUM; m++) {
+        MachineType type = (MachineType)m;
+        if (node >= MachineType_base_number(type) &&
+            node < MachineType_base_number((MachineType)(m + 1))) {
+            return MachineID(type, node - MachineType_base_number(type));
+        }
+    }
+    panic("Node %d is not a Ruby controller\n", node);
+}
+
+}
+
+GarnetTraceReplay::GarnetTraceReplay(const Params *p)
+    : ClockedObject(p), network(p->network),
+      respectDependencies(p->respect_dependencies), numDelivered(0),
+      injectEvent([this]{ inject(); }, name())
+{
+    readTrace(p->trace_file);
+}
+
+void
+GarnetTraceReplay::readTrace(const std::string &filename)
+{
+    ProtoInputStream trace(filename);
+
+    ProtoMessage::NetworkHeader header_msg;
+    if (!trace.read(header_msg)) {
+        fatal("%s: Failed to read the header of %s\n", name(), filename);
+    } else if (header_msg.tick_freq() != SimClock::Frequency) {
+        fatal("%s: Trace was recorded with a different tick frequency %d\n",
+              name(), header_msg.tick_freq());
+    } else if (header_msg.num_nodes() != network->getNumNodes()) {
+        fatal("%s: Trace was recorded with %d nodes, the network has %d\n",
+              name(), header_msg.num_nodes(), network->getNumNodes());
+    }
+
+    std::unordered_map<uint64_t, size_t> index;
+    std::vector<uint64_t> dep_ids;
+    ProtoMessage::NetworkMessage msg_record;
+    while (trace.read(msg_record)) {
+        Record record;
+        record.id = msg_record.id();
+        record.tick = msg_record.tick();
+        record.src = msg_record.src();
+        record.dest = msg_record.dest();
+        record.vnet = msg_record.vnet();
+        record.size = (MessageSizeType)msg_record.size();
+        record.hasDep = respectDependencies && msg_record.has_dep_id();
+        record.depDelay = msg_record.dep_delay();
+
+        fatal_if(record.src >= network->getNumNodes() ||
+                 record.dest >= network->getNumNodes() ||
+                 record.size >= MessageSizeType_NUM,
+                 "%s: Invalid message %d in the trace\n", name(), record.id);
+
+        index[record.id] = records.size();
+        dep_ids.push_back(msg_record.dep_id());
+        records.push_back(record);
+    }
+
+    // Messages whose dependency is missing from the trace are sent
+    // at the time they were recorded.
+    for (size_t idx = 0; idx < records.size(); idx++) {
+        Record &record = records[idx];
+        if (!record.hasDep)
+            continue;
+        auto it = index.find(dep_ids[idx]);
+        if (it == index.end() || it->second >= idx)
+            record.hasDep = false;
+        else
+            dependents[records[it->second].id].push_back(idx);
+    }
+}
+
+void
+GarnetTraceReplay::init()
+{
+    ClockedObject::init();
+
+    for (const Record &record : records) {
+        fatal_if(!network->getToNetQueue(record.src, record.vnet),
+                 "%s: Node %d has no buffer into vnet %d\n", name(),
+                 record.src, record.vnet);
+    }
+
+    // The controllers don't know what to do with the messages
+    network->setTraceReplay();
+}
+
+void
+GarnetTraceReplay::startup()
+{
+    if (records.empty()) {
+        exitSimLoop("Network trace replay completed");
+        return;
+    }
+
+    const Tick first = records.front().tick;
+    for (size_t idx = 0; idx < records.size(); idx++) {
+        if (!records[idx].hasDep)
+            release(idx, curTick() + records[idx].tick - first);
+    }
+}
+
+void
+GarnetTraceReplay::regProbeListeners()
+{
+    listener.reset(new DeliveryListener(*this,
+                                        network->getProbeManager()));
+}
+
+void
+GarnetTraceReplay::release(size_t idx, Tick when)
+{
+    pending.push(std::make_pair(when, idx));
+    Tick next = clockEdge(Cycles(divCeil(
+        std::max(pending.top().first, curTick()) - curTick(),
+        clockPeriod())));
+    if (!injectEvent.scheduled())
+        schedule(injectEvent, next);
+    else if (next < injectEvent.when())
+        reschedule(injectEvent, next);
+}
+
+void
+GarnetTraceReplay::inject()
+{
+    const Tick now = clockEdge();
+    while (!pending.empty() && pending.top().first <= now) {
+        const size_t idx = pending.top().second;
+        const Record &record = records[idx];
+        MessageBuffer *buffer =
+            network->getToNetQueue(record.src, record.vnet);
+
+        pending.pop();
+        if (!buffer->areNSlotsAvailable(1, now)) {
+            pending.push(std::make_pair(clockEdge(Cycles(1)), idx));
+            continue;
+        }
+
+        NetDest dest;
+        dest.add(nodeToMachineID(record.dest));
+        MsgPtr msg = new ReplayMessage(now, idx, dest, record.size);
+
+        DPRINTF(GarnetTraceReplay, "Injecting message %d from %d to %d "
+                "on vnet %d\n", record.id, record.src, record.dest,
+                record.vnet);
+        buffer->enqueue(msg, now, cyclesToTicks(Cycles(1)));
+        msgsInjected++;
+    }
+
+    if (!pending.empty()) {
+        schedule(injectEvent, clockEdge(Cycles(divCeil(
+            std::max(pending.top().first, now) - now, clockPeriod()))));
+    }
+}
+
+void
+GarnetTraceReplay::msgDelivered(const ProbePoints::NetworkMsgInfo &info)
+{
+    const ReplayMessage *msg = dynamic_cast<const ReplayMessage *>(info.msg);
+    if (!msg)
+        return;
+
+    const Record &record = records[msg->getIndex()];
+    DPRINTF(GarnetTraceReplay, "Message %d delivered to %d\n", record.id,
+            info.node);
+    msgsDelivered++;
+
+    auto it = dependents.find(record.id);
+    if (it != dependents.end()) {
+        for (size_t idx : it->second)
+            release(idx, curTick() + records[idx].depDelay);
+        dependents.erase(it);
+    }
+
+    if (++numDelivered == records.size())
+        exitSimLoop("Network trace replay completed");
+}
+
+void
+GarnetTraceReplay::regStats()
+{
+    ClockedObject::regStats();
+
+    msgsInjected
+        .name(name() + ".msgs_injected")
+        .desc("Number of messages injected into the network")
+        ;
+
+    msgsDelivered
+        .name(name() + ".msgs_delivered")
+        .desc("Number of messages delivered by the network")
+        ;
+}
+
+GarnetTraceReplay *
+GarnetTraceReplayParams::create()
+{
+    return new GarnetTraceReplay(this);
+}
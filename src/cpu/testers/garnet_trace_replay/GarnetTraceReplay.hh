@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Replay of a network message trace into a Garnet network.
+ */
+
+#ifndef __CPU_TESTERS_GARNET_TRACE_REPLAY_GARNETTRACEREPLAY_HH__
+#define __CPU_TESTERS_GARNET_TRACE_REPLAY_GARNETTRACEREPLAY_HH__
+
+#include <functional>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
+#include "params/GarnetTraceReplay.hh"
+#include "sim/clocked_object.hh"
+#include "sim/eventq.hh"
+#include "sim/probe/probe.hh"
+
+/**
+ * Injects the messages of a trace recorded by a GarnetTraceProbe into
+ * the message buffers between the controllers and the network, and
+ * removes them from the network at their destinations. The system has
+ * to have the same controllers as the traced one, but they take no
+ * part in the replay, so that network designs can be evaluated on the
+ * traffic of a full-system run without simulating the rest of it.
+ *
+ * Messages that depend on another one are only sent once that has
+ * been delivered, after the delay recorded in the trace. The other
+ * messages are sent at the time they were recorded, relative to the
+ * first message in the trace. The simulation exits once every message
+ * has been delivered.
+ */
+class GarnetTraceReplay : public ClockedObject
+{
+  public:
+    typedef GarnetTraceReplayParams Params;
+    GarnetTraceReplay(const Params *p);
+
+    void init() override;
+    void startup() override;
+    void regStats() override;
+    void regProbeListeners() override;
+
+  private:
+    struct Record
+    {
+        uint64_t id;
+        Tick tick;
+        NodeID src;
+        NodeID dest;
+        int vnet;
+        MessageSizeType size;
+        bool hasDep;
+        Tick depDelay;
+    };
+
+    class DeliveryListener
+        : public ProbeListenerArgBase<ProbePoints::NetworkMsgInfo>
+    {
+      public:
+        DeliveryListener(GarnetTraceReplay &_parent, ProbeManager *pm)
+            : ProbeListenerArgBase(pm, "MsgDelivered"), parent(_parent)
+        {}
+
+        void
+        notify(const ProbePoints::NetworkMsgInfo &info) override
+        {
+            parent.msgDelivered(info);
+        }
+
+      private:
+        GarnetTraceReplay &parent;
+    };
+
+    void readTrace(const std::string &filename);
+
+    /** Queue a record to be sent at the given time. */
+    void release(size_t idx, Tick when);
+
+    /** Send the records that are due. */
+    void inject();
+
+    void msgDelivered(const ProbePoints::NetworkMsgInfo &info);
+
+    GarnetNetwork *network;
+    const bool respectDependencies;
+
+    std::vector<Record> records;
+
+    /** Indices of the records that depend on each record */
+    std::unordered_map<uint64_t, std::vector<size_t>> dependents;
+
+    typedef std::pair<Tick, size_t> Pending;
+    std::priority_queue<Pending, std::vector<Pending>,
+                        std::greater<Pending>> pending;
+
+    uint64_t numDelivered;
+
+    EventFunctionWrapper injectEvent;
+
+    std::unique_ptr<DeliveryListener> listener;
+
+    Stats::Scalar msgsInjected;
+    Stats::Scalar msgsDelivered;
+};
+
+#endif // __CPU_TESTERS_GARNET_TRACE_REPLAY_GARNETTRACEREPLAY_HH__
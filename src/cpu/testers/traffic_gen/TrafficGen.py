@@ -83,3 +83,8 @@ class TrafficGen(MemObject):
     # somewhat arbitrary and may well have to be tuned.
     progress_check = Param.Latency('1ms', "Time before exiting " \
                                    "due to lack of progress")
+
+    # Number of independent streams, each of which walks through its
+    # own copy of the state graph. This is a lot faster to simulate
+    # than the same number of separate traffic generators.
+    num_streams = Param.Unsigned(1, "Number of concurrent streams")
@@ -67,11 +67,12 @@ BaseGen::getPacket(Addr addr, unsigned size, const MemCmd& cmd,
     // Embed it in a packet
     PacketPtr pkt = new Packet(req, cmd);
 
-    uint8_t* pkt_data = new uint8_t[req->getSize()];
-    pkt->dataDynamic(pkt_data);
+    // Take the payload from the packet data pool rather than the heap
+    pkt->allocate();
 
     if (cmd.isWrite()) {
-        std::fill_n(pkt_data, req->getSize(), (uint8_t)masterID);
+        std::fill_n(pkt->getPtr<uint8_t>(), req->getSize(),
+                    (uint8_t)masterID);
     }
 
     return pkt;
@@ -44,7 +44,6 @@
 
 #include <algorithm>
 
-#include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/TrafficGen.hh"
 #include "proto/packet.pb.h"
@@ -59,7 +58,7 @@ DramGen::getNextPacket()
 
         // choose if we generate a read or a write here
         isRead = readPercent != 0 &&
-            (readPercent == 100 || random_mt.random(0, 100) < readPercent);
+            (readPercent == 100 || rng.random(0, 100) < readPercent);
 
         assert((readPercent == 0 && !isRead) ||
                (readPercent == 100 && isRead) ||
@@ -67,11 +66,11 @@ DramGen::getNextPacket()
 
         // pick a random bank
         unsigned int new_bank =
-            random_mt.random<unsigned int>(0, nbrOfBanksUtil - 1);
+            rng.random<unsigned int>(0, nbrOfBanksUtil - 1);
 
         // pick a random rank
         unsigned int new_rank =
-            random_mt.random<unsigned int>(0, nbrOfRanks - 1);
+            rng.random<unsigned int>(0, nbrOfRanks - 1);
 
         // Generate the start address of the command series
         // routine will update addr variable with bank, rank, and col
@@ -119,7 +118,7 @@ void
 DramGen::genStartAddr(unsigned int new_bank, unsigned int new_rank)
 {
     // start by picking a random address in the range
-    addr = random_mt.random<Addr>(startAddr, endAddr - 1);
+    addr = rng.random<Addr>(startAddr, endAddr - 1);
 
     // round down to start address of a block, i.e. a DRAM burst
     addr -= addr % blocksize;
@@ -140,7 +139,7 @@ DramGen::genStartAddr(unsigned int new_bank, unsigned int new_rank)
     // pick a random column, but ensure that there is room for
     // numSeqPkts sequential columns in the same page
     unsigned int new_col =
-        random_mt.random<unsigned int>(0, columns_per_page - numSeqPkts);
+        rng.random<unsigned int>(0, columns_per_page - numSeqPkts);
 
     if (addrMapping == 1) {
         // addrMapping=1: RoRaBaCoCh/RoRaBaChCo
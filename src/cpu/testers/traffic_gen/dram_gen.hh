@@ -70,6 +70,7 @@ class DramGen : public RandomGen
      *
      * @param _name Name to use for status and debug
      * @param master_id MasterID set on each request
+     * @param _rng Random numbers to draw from
      * @param _duration duration of this state before transitioning
      * @param start_addr Start address
      * @param end_addr End address
@@ -87,7 +88,8 @@ class DramGen : public RandomGen
      *                     0: RoCoRaBaCh, 1: RoRaBaCoCh/RoRaBaChCo
      *                     assumes single channel system
      */
-    DramGen(const std::string& _name, MasterID master_id, Tick _duration,
+    DramGen(const std::string& _name, MasterID master_id,
+            RandomStream &_rng, Tick _duration,
             Addr start_addr, Addr end_addr, Addr _blocksize,
             Tick min_period, Tick max_period,
             uint8_t read_percent, Addr data_limit,
@@ -95,7 +97,7 @@ class DramGen : public RandomGen
             unsigned int nbr_of_banks_DRAM, unsigned int nbr_of_banks_util,
             unsigned int addr_mapping,
             unsigned int nbr_of_ranks)
-        : RandomGen(_name, master_id, _duration, start_addr, end_addr,
+        : RandomGen(_name, master_id, _rng, _duration, start_addr, end_addr,
           _blocksize, min_period, max_period, read_percent, data_limit),
           numSeqPkts(num_seq_pkts), countNumSeqPkts(0), addr(0),
           isRead(true), pageSize(page_size),
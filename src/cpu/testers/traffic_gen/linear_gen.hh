@@ -51,6 +51,7 @@
 
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
+#include "base/random.hh"
 #include "base_gen.hh"
 #include "mem/packet.hh"
 #include "proto/protoio.hh"
@@ -74,6 +75,7 @@ class LinearGen : public BaseGen
      *
      * @param _name Name to use for status and debug
      * @param master_id MasterID set on each request
+     * @param _rng Random numbers to draw from
      * @param _duration duration of this state before transitioning
      * @param start_addr Start address
      * @param end_addr End address
@@ -83,11 +85,12 @@ class LinearGen : public BaseGen
      * @param read_percent Percent of transactions that are reads
      * @param data_limit Upper limit on how much data to read/write
      */
-    LinearGen(const std::string& _name, MasterID master_id, Tick _duration,
+    LinearGen(const std::string& _name, MasterID master_id,
+              RandomStream &_rng, Tick _duration,
               Addr start_addr, Addr end_addr, Addr _blocksize,
               Tick min_period, Tick max_period,
               uint8_t read_percent, Addr data_limit)
-        : BaseGen(_name, master_id, _duration),
+        : BaseGen(_name, master_id, _duration), rng(_rng),
           startAddr(start_addr), endAddr(end_addr),
           blocksize(_blocksize), minPeriod(min_period),
           maxPeriod(max_period), readPercent(read_percent),
@@ -102,6 +105,9 @@ class LinearGen : public BaseGen
 
   private:
 
+    /** Random numbers, shared with the other states of the generator */
+    RandomStream &rng;
+
     /** Start of address range */
     const Addr startAddr;
 
@@ -43,6 +43,7 @@
 #include <libgen.h>
 #include <unistd.h>
 
+#include <memory>
 #include <sstream>
 
 #include "base/intmath.hh"
@@ -62,15 +63,17 @@ TrafficGen::TrafficGen(const TrafficGenParams* p)
       elasticReq(p->elastic_req),
       progressCheck(p->progress_check),
       noProgressEvent([this]{ noProgress(); }, name()),
-      nextTransitionTick(0),
-      nextPacketTick(0),
-      currState(0),
+      streams(p->num_streams),
       port(name() + ".port", *this),
       retryPkt(NULL),
       retryPktTick(0),
+      retryStream(NULL),
       updateEvent([this]{ update(); }, name()),
-      numSuppressed(0)
+      numSuppressed(0),
+      rng(name())
 {
+    if (streams.empty())
+        fatal("%s must have at least one stream\n", name());
 }
 
 TrafficGen*
@@ -99,10 +102,12 @@ TrafficGen::init()
     if (system->isTimingMode()) {
         DPRINTF(TrafficGen, "Timing mode, activating request generator\n");
 
-        parseConfig();
+        for (auto &stream : streams) {
+            parseConfig(stream);
 
-        // enter initial state
-        enterState(currState);
+            // enter initial state
+            enterState(stream, stream.currState);
+        }
     } else {
         DPRINTF(TrafficGen,
                 "Traffic generator is only active in timing mode\n");
@@ -115,8 +120,12 @@ TrafficGen::initState()
     // when not restoring from a checkpoint, make sure we kick things off
     if (system->isTimingMode()) {
         // call nextPacketTick on the state to advance it
-        nextPacketTick = states[currState]->nextPacketTick(elasticReq, 0);
-        schedule(updateEvent, std::min(nextPacketTick, nextTransitionTick));
+        for (auto &stream : streams) {
+            stream.nextPacketTick =
+                stream.states[stream.currState]->nextPacketTick(elasticReq,
+                                                                0);
+        }
+        schedule(updateEvent, nextEventTick());
     } else {
         DPRINTF(TrafficGen,
                 "Traffic generator is only active in timing mode\n");
@@ -133,8 +142,10 @@ TrafficGen::drain()
 
     if (retryPkt == NULL) {
         // shut things down
-        nextPacketTick = MaxTick;
-        nextTransitionTick = MaxTick;
+        for (auto &stream : streams) {
+            stream.nextPacketTick = MaxTick;
+            stream.nextTransitionTick = MaxTick;
+        }
         deschedule(updateEvent);
         return DrainState::Drained;
     } else {
@@ -154,11 +165,19 @@ TrafficGen::serialize(CheckpointOut &cp) const
 
     SERIALIZE_SCALAR(nextEvent);
 
-    SERIALIZE_SCALAR(nextTransitionTick);
-
-    SERIALIZE_SCALAR(nextPacketTick);
-
-    SERIALIZE_SCALAR(currState);
+    // the first stream uses the same names as a single stream
+    // generator, so checkpoints are compatible with it
+    for (size_t i = 0; i < streams.size(); i++) {
+        std::unique_ptr<ScopedCheckpointSection> sec;
+        if (i > 0)
+            sec.reset(new ScopedCheckpointSection(cp, csprintf("stream%d",
+                                                                i)));
+
+        const Stream &stream = streams[i];
+        paramOut(cp, "nextTransitionTick", stream.nextTransitionTick);
+        paramOut(cp, "nextPacketTick", stream.nextPacketTick);
+        paramOut(cp, "currState", stream.currState);
+    }
 }
 
 void
@@ -171,14 +190,30 @@ TrafficGen::unserialize(CheckpointIn &cp)
         schedule(updateEvent, nextEvent);
     }
 
-    UNSERIALIZE_SCALAR(nextTransitionTick);
+    for (size_t i = 0; i < streams.size(); i++) {
+        std::unique_ptr<ScopedCheckpointSection> sec;
+        if (i > 0)
+            sec.reset(new ScopedCheckpointSection(cp, csprintf("stream%d",
+                                                                i)));
 
-    UNSERIALIZE_SCALAR(nextPacketTick);
+        Stream &stream = streams[i];
+        paramIn(cp, "nextTransitionTick", stream.nextTransitionTick);
+        paramIn(cp, "nextPacketTick", stream.nextPacketTick);
 
-    // @todo In the case of a stateful generator state such as the
-    // trace player we would also have to restore the position in the
-    // trace playback and the tick offset
-    UNSERIALIZE_SCALAR(currState);
+        // @todo In the case of a stateful generator state such as the
+        // trace player we would also have to restore the position in
+        // the trace playback and the tick offset
+        paramIn(cp, "currState", stream.currState);
+    }
+}
+
+Tick
+TrafficGen::nextEventTick() const
+{
+    Tick tick = MaxTick;
+    for (const auto &stream : streams)
+        tick = std::min(tick, stream.nextEventTick());
+    return tick;
 }
 
 void
@@ -187,46 +222,63 @@ TrafficGen::update()
     // shift our progress-tracking event forward
     reschedule(noProgressEvent, curTick() + progressCheck, true);
 
-    // if we have reached the time for the next state transition, then
-    // perform the transition
-    if (curTick() >= nextTransitionTick) {
-        transition();
-    } else {
-        assert(curTick() >= nextPacketTick);
-        // get the next packet and try to send it
-        PacketPtr pkt = states[currState]->getNextPacket();
-
-        // suppress packets that are not destined for a memory, such as
-        // device accesses that could be part of a trace
-        if (system->isMemAddr(pkt->getAddr())) {
-            numPackets++;
-            if (!port.sendTimingReq(pkt)) {
-                retryPkt = pkt;
-                retryPktTick = curTick();
-            }
-        } else {
-            DPRINTF(TrafficGen, "Suppressed packet %s 0x%x\n",
-                    pkt->cmdString(), pkt->getAddr());
+    // serve all the streams that are due, stopping if the port
+    // asks us to wait for a retry
+    for (auto &stream : streams) {
+        if (retryPkt != NULL)
+            break;
+
+        if (curTick() < stream.nextEventTick())
+            continue;
 
-            ++numSuppressed;
-            if (numSuppressed % 10000)
-                warn("%s suppressed %d packets with non-memory addresses\n",
-                     name(), numSuppressed);
+        // if we have reached the time for the next state transition,
+        // then perform the transition
+        if (curTick() >= stream.nextTransitionTick) {
+            transition(stream);
+        } else {
+            assert(curTick() >= stream.nextPacketTick);
+            // get the next packet and try to send it
+            PacketPtr pkt = stream.states[stream.currState]->getNextPacket();
+
+            // suppress packets that are not destined for a memory, such
+            // as device accesses that could be part of a trace
+            if (system->isMemAddr(pkt->getAddr())) {
+                numPackets++;
+                if (!port.sendTimingReq(pkt)) {
+                    retryPkt = pkt;
+                    retryPktTick = curTick();
+                    retryStream = &stream;
+                }
+            } else {
+                DPRINTF(TrafficGen, "Suppressed packet %s 0x%x\n",
+                        pkt->cmdString(), pkt->getAddr());
+
+                ++numSuppressed;
+                if (numSuppressed % 10000)
+                    warn("%s suppressed %d packets with non-memory "
+                         "addresses\n", name(), numSuppressed);
+
+                delete pkt->req;
+                delete pkt;
+                pkt = nullptr;
+            }
+        }
 
-            delete pkt->req;
-            delete pkt;
-            pkt = nullptr;
+        // in the case of a transition or a successful send, determine
+        // when the next packet of this stream is due
+        if (retryPkt == NULL) {
+            stream.nextPacketTick =
+                stream.states[stream.currState]->nextPacketTick(elasticReq,
+                                                                0);
         }
     }
 
     // if we are waiting for a retry, do not schedule any further
-    // events, in the case of a transition or a successful send, go
-    // ahead and determine when the next update should take place
+    // events, otherwise go ahead and determine when the next update
+    // should take place, which is the next execute tick or the next
+    // transition of any stream, which ever comes first
     if (retryPkt == NULL) {
-        // schedule next update event based on either the next execute
-        // tick or the next transition, which ever comes first
-        nextPacketTick = states[currState]->nextPacketTick(elasticReq, 0);
-        Tick nextEventTick = std::min(nextPacketTick, nextTransitionTick);
+        Tick nextEventTick = this->nextEventTick();
         DPRINTF(TrafficGen, "Next event scheduled at %lld\n", nextEventTick);
         schedule(updateEvent, nextEventTick);
     }
@@ -254,8 +306,11 @@ TrafficGen::resolveFile(const std::string &name)
 }
 
 void
-TrafficGen::parseConfig()
+TrafficGen::parseConfig(Stream &stream)
 {
+    // the generator states of the stream
+    std::unordered_map<uint32_t, BaseGen*> &states = stream.states;
+
     // keep track of the transitions parsed to create the matrix when
     // done
     vector<Transition> transitions;
@@ -339,14 +394,14 @@ TrafficGen::parseConfig()
                         fatal("%s cannot have min_period > max_period", name());
 
                     if (mode == "LINEAR") {
-                        states[id] = new LinearGen(name(), masterID,
+                        states[id] = new LinearGen(name(), masterID, rng,
                                                    duration, start_addr,
                                                    end_addr, blocksize,
                                                    min_period, max_period,
                                                    read_percent, data_limit);
                         DPRINTF(TrafficGen, "State: %d LinearGen\n", id);
                     } else if (mode == "RANDOM") {
-                        states[id] = new RandomGen(name(), masterID,
+                        states[id] = new RandomGen(name(), masterID, rng,
                                                    duration, start_addr,
                                                    end_addr, blocksize,
                                                    min_period, max_period,
@@ -388,7 +443,7 @@ TrafficGen::parseConfig()
                         }
 
                         if (mode == "DRAM") {
-                            states[id] = new DramGen(name(), masterID,
+                            states[id] = new DramGen(name(), masterID, rng,
                                                      duration, start_addr,
                                                      end_addr, blocksize,
                                                      min_period, max_period,
@@ -408,7 +463,7 @@ TrafficGen::parseConfig()
                                 (read_percent == 50) ? nbr_of_banks_util * 2
                                                      : nbr_of_banks_util;
 
-                            states[id] = new DramRotGen(name(), masterID,
+                            states[id] = new DramRotGen(name(), masterID, rng,
                                                      duration, start_addr,
                                                      end_addr, blocksize,
                                                      min_period, max_period,
@@ -437,11 +492,11 @@ TrafficGen::parseConfig()
                         transition.to);
             } else if (keyword == "INIT") {
                 // set the initial state as the active state
-                is >> currState;
+                is >> stream.currState;
 
                 init_state_set = true;
 
-                DPRINTF(TrafficGen, "Initial state: %d\n", currState);
+                DPRINTF(TrafficGen, "Initial state: %d\n", stream.currState);
             }
         }
     }
@@ -450,6 +505,13 @@ TrafficGen::parseConfig()
         fatal("%s: initial state not specified (add 'INIT <id>' line "
               "to the config file)\n", name());
 
+    // the transition matrix is the same for all streams, so only
+    // build it for the first one
+    if (&stream != &streams.front()) {
+        infile.close();
+        return;
+    }
+
     // resize and populate state transition matrix
     transitionMatrix.resize(states.size());
     for (size_t i = 0; i < states.size(); i++) {
@@ -480,13 +542,15 @@ TrafficGen::parseConfig()
 }
 
 void
-TrafficGen::transition()
+TrafficGen::transition(Stream &stream)
 {
+    const uint32_t currState = stream.currState;
+
     // exit the current state
-    states[currState]->exit();
+    stream.states[currState]->exit();
 
     // determine next state
-    double p = random_mt.random<double>();
+    double p = rng.random<double>();
     assert(currState < transitionMatrix.size());
     double cumulative = 0.0;
     size_t i = 0;
@@ -495,20 +559,20 @@ TrafficGen::transition()
         ++i;
     } while (cumulative < p && i < transitionMatrix[currState].size());
 
-    enterState(i - 1);
+    enterState(stream, i - 1);
 }
 
 void
-TrafficGen::enterState(uint32_t newState)
+TrafficGen::enterState(Stream &stream, uint32_t newState)
 {
     DPRINTF(TrafficGen, "Transition to state %d\n", newState);
 
-    currState = newState;
+    stream.currState = newState;
     // we could have been delayed and not transitioned on the exact
     // tick when we were supposed to (due to back pressure when
     // sending a packet)
-    nextTransitionTick = curTick() + states[currState]->duration;
-    states[currState]->enter();
+    stream.nextTransitionTick = curTick() + stream.states[newState]->duration;
+    stream.states[newState]->enter();
 }
 
 void
@@ -529,16 +593,21 @@ TrafficGen::recvReqRetry()
         retryPktTick = 0;
         retryTicks += delay;
 
+        Stream &stream = *retryStream;
+        retryStream = NULL;
+
         if (drainState() != DrainState::Draining) {
             // packet is sent, so find out when the next one is due
-            nextPacketTick = states[currState]->nextPacketTick(elasticReq,
-                                                               delay);
-            Tick nextEventTick = std::min(nextPacketTick, nextTransitionTick);
-            schedule(updateEvent, std::max(curTick(), nextEventTick));
+            stream.nextPacketTick =
+                stream.states[stream.currState]->nextPacketTick(elasticReq,
+                                                                delay);
+            schedule(updateEvent, std::max(curTick(), nextEventTick()));
         } else {
             // shut things down
-            nextPacketTick = MaxTick;
-            nextTransitionTick = MaxTick;
+            for (auto &s : streams) {
+                s.nextPacketTick = MaxTick;
+                s.nextTransitionTick = MaxTick;
+            }
             signalDrainDone();
         }
     }
@@ -65,23 +65,67 @@
  * memory controllers, or function as a black box replacement for
  * system components that are not yet modelled in detail, e.g. a video
  * engine or baseband subsystem.
+ *
+ * A single traffic generator can run several independent streams,
+ * each with its own copy of the generator states and its own walk
+ * through the state graph. All streams share the port, and every
+ * stream that is due is served by the same update, which is a lot
+ * cheaper to simulate than the same number of traffic generators.
  */
 class TrafficGen : public MemObject
 {
 
   private:
 
+    /**
+     * An independent walk through the state graph, with its own
+     * generator states.
+     */
+    struct Stream
+    {
+        Stream()
+            : nextTransitionTick(0), nextPacketTick(0), currState(0)
+        { }
+
+        /** Time of next transition */
+        Tick nextTransitionTick;
+
+        /** Time of the next packet. */
+        Tick nextPacketTick;
+
+        /** Index of the current state */
+        uint32_t currState;
+
+        /** Map of generator states */
+        std::unordered_map<uint32_t, BaseGen*> states;
+
+        /** Time when this stream next needs an update */
+        Tick
+        nextEventTick() const
+        {
+            return std::min(nextPacketTick, nextTransitionTick);
+        }
+    };
+
     /**
      * Determine next state and perform the transition.
+     *
+     * @param stream stream to transition
      */
-    void transition();
+    void transition(Stream &stream);
 
     /**
      * Enter a new state.
      *
+     * @param stream stream entering the state
      * @param newState identifier of state to enter
      */
-    void enterState(uint32_t newState);
+    void enterState(Stream &stream, uint32_t newState);
+
+    /**
+     * Time of the earliest update needed by any of the streams.
+     */
+    Tick nextEventTick() const;
 
     /**
      * Resolve a file path in the configuration file.
@@ -99,10 +143,12 @@ class TrafficGen : public MemObject
     std::string resolveFile(const std::string &name);
 
     /**
-     * Parse the config file and build the state map and
-     * transition matrix.
+     * Parse the config file and build the state map of a stream and
+     * the transition matrix.
+     *
+     * @param stream stream to create the generator states for
      */
-    void parseConfig();
+    void parseConfig(Stream &stream);
 
     /**
      * Schedules event for next update and executes an update on the
@@ -162,20 +208,11 @@ class TrafficGen : public MemObject
      */
     EventFunctionWrapper noProgressEvent;
 
-    /** Time of next transition */
-    Tick nextTransitionTick;
-
-    /** Time of the next packet. */
-    Tick nextPacketTick;
-
-    /** State transition matrix */
+    /** State transition matrix, shared by all the streams */
     std::vector<std::vector<double> > transitionMatrix;
 
-    /** Index of the current state */
-    uint32_t currState;
-
-    /** Map of generator states */
-    std::unordered_map<uint32_t, BaseGen*> states;
+    /** The streams, stream 0 being the only one by default */
+    std::vector<Stream> streams;
 
     /** Master port specialisation for the traffic generator */
     class TrafficGenPort : public MasterPort
@@ -213,11 +250,17 @@ class TrafficGen : public MemObject
     /** Tick when the stalled packet was meant to be sent. */
     Tick retryPktTick;
 
+    /** Stream that generated the packet waiting to be sent. */
+    Stream *retryStream;
+
     /** Event for scheduling updates */
     EventFunctionWrapper updateEvent;
 
     uint64_t numSuppressed;
 
+    /** Random numbers used by the generator states and transitions */
+    RandomStream rng;
+
     /** Count the number of generated packets. */
     Stats::Scalar numPackets;
 
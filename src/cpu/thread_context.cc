@@ -255,3 +255,10 @@ takeOverFrom(ThreadContext &ntc, ThreadContext &otc)
 
     otc.setStatus(ThreadContext::Halted);
 }
+
+void
+remoteActivate(ThreadContext *tc)
+{
+    EventQueue::ScopedMigration migrate(tc->getCpuPtr()->eventQueue());
+    tc->activate();
+}
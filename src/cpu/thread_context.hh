@@ -648,4 +648,15 @@ void unserialize(ThreadContext &tc, CheckpointIn &cp);
  */
 void takeOverFrom(ThreadContext &new_tc, ThreadContext &old_tc);
 
+/**
+ * Activate a thread context whose CPU may be on a different event
+ * queue than the caller, e.g., when a guest thread wakes up another
+ * one in SE mode. This temporarily migrates to the event queue of the
+ * CPU, which is not deterministic when several queues run in
+ * parallel.
+ *
+ * @param tc Thread context to activate.
+ */
+void remoteActivate(ThreadContext *tc);
+
 #endif
@@ -39,7 +39,10 @@
 
 #include "cpu/timing_expr.hh"
 
+#include <algorithm>
+
 #include "base/intmath.hh"
+#include "base/logging.hh"
 
 TimingExprEvalContext::TimingExprEvalContext(const StaticInstPtr &inst_,
     ThreadContext *thread_,
@@ -88,7 +91,11 @@ uint64_t TimingExprRef::eval(TimingExprEvalContext &context)
 
 uint64_t TimingExprUn::eval(TimingExprEvalContext &context)
 {
-    uint64_t arg_value = arg->eval(context);
+    return apply(op, arg->eval(context));
+}
+
+uint64_t TimingExprUn::apply(Enums::TimingExprOp op, uint64_t arg_value)
+{
     uint64_t ret = 0;
 
     switch (op) {
@@ -125,6 +132,13 @@ uint64_t TimingExprBin::eval(TimingExprEvalContext &context)
 {
     uint64_t left_value = left->eval(context);
     uint64_t right_value = right->eval(context);
+
+    return apply(op, left_value, right_value);
+}
+
+uint64_t TimingExprBin::apply(Enums::TimingExprOp op, uint64_t left_value,
+    uint64_t right_value)
+{
     uint64_t ret = 0;
 
     switch (op) {
@@ -200,6 +214,299 @@ uint64_t TimingExprIf::eval(TimingExprEvalContext &context)
         return falseExpr->eval(context);
 }
 
+void TimingExprSrcReg::compile(TimingExprProgram &program)
+{
+    program.emitSrcReg(index);
+}
+
+void TimingExprReadIntReg::compile(TimingExprProgram &program)
+{
+    reg->compile(program);
+    program.emitReadIntReg();
+}
+
+void TimingExprLet::compile(TimingExprProgram &program)
+{
+    size_t start = program.size();
+
+    program.beginLet(this);
+    expr->compile(program);
+    program.endLet(start);
+}
+
+void TimingExprRef::compile(TimingExprProgram &program)
+{
+    program.emitRef(index);
+}
+
+void TimingExprUn::compile(TimingExprProgram &program)
+{
+    size_t start = program.size();
+
+    arg->compile(program);
+    program.emitUn(op, start);
+}
+
+void TimingExprBin::compile(TimingExprProgram &program)
+{
+    size_t start = program.size();
+
+    left->compile(program);
+    size_t mid = program.size();
+    right->compile(program);
+    program.emitBin(op, start, mid);
+}
+
+void TimingExprIf::compile(TimingExprProgram &program)
+{
+    size_t start = program.size();
+
+    cond->compile(program);
+
+    /* Only keep the taken side of a constant condition */
+    if (program.isLiteral(start)) {
+        if (program.popLiteral() != 0)
+            trueExpr->compile(program);
+        else
+            falseExpr->compile(program);
+        return;
+    }
+
+    size_t to_false = program.emitJump(TimingExprProgram::JumpIfZero);
+    trueExpr->compile(program);
+    size_t to_end = program.emitJump(TimingExprProgram::Jump);
+    program.patchJump(to_false);
+    falseExpr->compile(program);
+    program.patchJump(to_end);
+}
+
+void TimingExpr::compileProgram()
+{
+    program.reset(new TimingExprProgram(this));
+}
+
+TimingExprProgram::TimingExprProgram(TimingExpr *expr) :
+    numSlots(0), readsThread(false)
+{
+    expr->compile(*this);
+    assert(lets.empty());
+
+    slots.resize(numSlots, 0);
+    slotAvailable.resize(numSlots, false);
+}
+
+void
+TimingExprProgram::emit(Opcode opcode, unsigned int arg, uint64_t value,
+    Enums::TimingExprOp op)
+{
+    Instr instr;
+
+    instr.opcode = opcode;
+    instr.op = op;
+    instr.arg = arg;
+    instr.value = value;
+    code.push_back(instr);
+}
+
+bool
+TimingExprProgram::isLiteral(size_t start) const
+{
+    return code.size() == start + 1 && code.back().opcode == Literal;
+}
+
+uint64_t
+TimingExprProgram::popLiteral()
+{
+    assert(code.back().opcode == Literal);
+    uint64_t value = code.back().value;
+    code.pop_back();
+    return value;
+}
+
+void
+TimingExprProgram::emitLiteral(uint64_t value)
+{
+    emit(Literal, 0, value);
+}
+
+void
+TimingExprProgram::emitSrcReg(unsigned int index)
+{
+    emit(SrcReg, index);
+}
+
+void
+TimingExprProgram::emitReadIntReg()
+{
+    emit(ReadIntReg);
+    readsThread = true;
+}
+
+void
+TimingExprProgram::beginLet(TimingExprLet *let)
+{
+    /* Each let being compiled gets its own slots, which are forgotten
+     *  when entering it as a new context is made for each let's
+     *  evaluation */
+    unsigned int num_defns = let->defns.size();
+
+    lets.push_back(std::make_pair(let, numSlots));
+    emit(LetEnter, numSlots, num_defns);
+    numSlots += num_defns;
+}
+
+void
+TimingExprProgram::endLet(size_t start)
+{
+    lets.pop_back();
+
+    /* A constant body doesn't need its slots */
+    if (code.size() == start + 2 && code.back().opcode == Literal)
+        code.erase(code.begin() + start);
+}
+
+void
+TimingExprProgram::emitRef(unsigned int index)
+{
+    fatal_if(lets.empty(), "TimingExprRef outside of a TimingExprLet\n");
+
+    TimingExprLet *let = lets.back().first;
+    unsigned int slot = lets.back().second + index;
+
+    fatal_if(index >= let->defns.size(), "%s: TimingExprRef to binding"
+        " %d of %d\n", let->name(), index, let->defns.size());
+
+    /* Inline the definition, which is skipped once evaluated.  Inside
+     *  it, refs still go to the same let */
+    size_t start = code.size();
+    emit(Ref, slot);
+    let->defns[index]->compile(*this);
+
+    if (code.size() == start + 2 && code.back().opcode == Literal) {
+        code.erase(code.begin() + start);
+    } else {
+        emit(Store, slot);
+        code[start].value = code.size();
+    }
+}
+
+void
+TimingExprProgram::emitUn(Enums::TimingExprOp op, size_t start)
+{
+    if (isLiteral(start))
+        code.back().value = TimingExprUn::apply(op, code.back().value);
+    else
+        emit(Un, 0, 0, op);
+}
+
+void
+TimingExprProgram::emitBin(Enums::TimingExprOp op, size_t start,
+    size_t mid)
+{
+    if (mid == start + 1 && isLiteral(mid) &&
+        code[start].opcode == Literal)
+    {
+        uint64_t right_value = popLiteral();
+        code.back().value = TimingExprBin::apply(op, code.back().value,
+            right_value);
+    } else {
+        emit(Bin, 0, 0, op);
+    }
+}
+
+size_t
+TimingExprProgram::emitJump(Opcode opcode)
+{
+    emit(opcode);
+    return code.size() - 1;
+}
+
+void
+TimingExprProgram::patchJump(size_t jump)
+{
+    code[jump].value = code.size();
+}
+
+uint64_t
+TimingExprProgram::eval(const StaticInstPtr &inst, ThreadContext *thread)
+{
+    if (isConstant())
+        return code[0].value;
+
+    if (!readsThread) {
+        auto cached = cache.find(inst.get());
+        if (cached != cache.end())
+            return cached->second.second;
+    }
+
+    stack.clear();
+
+    size_t pc = 0;
+    while (pc < code.size()) {
+        const Instr &instr = code[pc];
+        pc++;
+
+        switch (instr.opcode) {
+          case Literal:
+            stack.push_back(instr.value);
+            break;
+          case SrcReg:
+            stack.push_back(inst->srcRegIdx(instr.arg).index());
+            break;
+          case ReadIntReg:
+            stack.back() = thread->readIntReg(stack.back());
+            break;
+          case LetEnter:
+            std::fill(slotAvailable.begin() + instr.arg,
+                slotAvailable.begin() + instr.arg + instr.value, false);
+            break;
+          case Ref:
+            if (slotAvailable[instr.arg]) {
+                stack.push_back(slots[instr.arg]);
+                pc = instr.value;
+            }
+            break;
+          case Store:
+            slots[instr.arg] = stack.back();
+            slotAvailable[instr.arg] = true;
+            break;
+          case Un:
+            stack.back() = TimingExprUn::apply(instr.op, stack.back());
+            break;
+          case Bin:
+            {
+                uint64_t right_value = stack.back();
+                stack.pop_back();
+                stack.back() = TimingExprBin::apply(instr.op,
+                    stack.back(), right_value);
+            }
+            break;
+          case JumpIfZero:
+            {
+                uint64_t cond_value = stack.back();
+                stack.pop_back();
+                if (cond_value == 0)
+                    pc = instr.value;
+            }
+            break;
+          case Jump:
+            pc = instr.value;
+            break;
+        }
+    }
+
+    assert(stack.size() == 1);
+    uint64_t ret = stack.back();
+
+    if (!readsThread) {
+        if (cache.size() >= maxCacheSize)
+            cache.clear();
+        cache[inst.get()] = std::make_pair(inst, ret);
+    }
+
+    return ret;
+}
+
 TimingExprLiteral *
 TimingExprLiteralParams::create()
 {
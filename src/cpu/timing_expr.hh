@@ -49,6 +49,11 @@
 #ifndef __CPU_TIMING_EXPR_HH__
 #define __CPU_TIMING_EXPR_HH__
 
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "cpu/static_inst.hh"
 #include "cpu/thread_context.hh"
 #include "enums/TimingExprOp.hh"
@@ -87,14 +92,142 @@ class TimingExprEvalContext
         ThreadContext *thread_, TimingExprLet *let_);
 };
 
+class TimingExpr;
+
+/** Flat, stack based form of a TimingExpr tree.  Sub-expressions
+ *  which don't depend on the instruction or the thread are folded
+ *  into literals when compiling.  let's definitions are still
+ *  evaluated lazily, on their first reference, and the result of a
+ *  program which doesn't read the thread's registers is cached per
+ *  StaticInst */
+class TimingExprProgram
+{
+  public:
+    enum Opcode
+    {
+        /** Push value */
+        Literal,
+        /** Push the index of source register arg of the inst */
+        SrcReg,
+        /** Replace the top with the value of that integer register */
+        ReadIntReg,
+        /** Forget the results in slots [arg, arg + value) */
+        LetEnter,
+        /** If slot arg holds a result, push it and jump to value */
+        Ref,
+        /** Store the top into slot arg */
+        Store,
+        /** Apply op to the top */
+        Un,
+        /** Pop the right hand side and apply op to it and the top */
+        Bin,
+        /** Pop the top and jump to value if it is 0 */
+        JumpIfZero,
+        /** Jump to value */
+        Jump
+    };
+
+    struct Instr
+    {
+        Opcode opcode;
+        Enums::TimingExprOp op;
+        unsigned int arg;
+        uint64_t value;
+    };
+
+  protected:
+    std::vector<Instr> code;
+
+    /** Number of let's result slots */
+    unsigned int numSlots;
+
+    /** Does any instruction read the thread's state? */
+    bool readsThread;
+
+    /** Lets being compiled, innermost last, with their first slot */
+    std::vector<std::pair<TimingExprLet *, unsigned int>> lets;
+
+    /** Evaluation scratch space */
+    std::vector<uint64_t> stack;
+    std::vector<uint64_t> slots;
+    std::vector<bool> slotAvailable;
+
+    /** Results of thread independent programs.  The StaticInstPtr keeps
+     *  the key alive */
+    std::unordered_map<const StaticInst *,
+        std::pair<StaticInstPtr, uint64_t>> cache;
+
+    /** Bound on the size of cache, which is dropped when full */
+    static const size_t maxCacheSize = 4096;
+
+  public:
+    /** Compile the tree rooted at expr */
+    TimingExprProgram(TimingExpr *expr);
+
+    uint64_t eval(const StaticInstPtr &inst, ThreadContext *thread);
+
+    /** Is the program a single literal? */
+    bool
+    isConstant() const
+    {
+        return code.size() == 1 && code[0].opcode == Literal;
+    }
+
+    /** Interface for TimingExpr::compile.  start arguments are the
+     *  size of the program before compiling the corresponding
+     *  sub-expression */
+    size_t size() const { return code.size(); }
+    void emitLiteral(uint64_t value);
+    void emitSrcReg(unsigned int index);
+    void emitReadIntReg();
+    void beginLet(TimingExprLet *let);
+    void endLet(size_t start);
+    void emitRef(unsigned int index);
+    void emitUn(Enums::TimingExprOp op, size_t start);
+    void emitBin(Enums::TimingExprOp op, size_t start, size_t mid);
+    /** Is the code from start on a single literal? */
+    bool isLiteral(size_t start) const;
+    /** Remove that literal and return its value */
+    uint64_t popLiteral();
+    /** Emit a jump to be pointed at the next instruction emitted by
+     *  patchJump */
+    size_t emitJump(Opcode opcode);
+    void patchJump(size_t jump);
+
+  protected:
+    void emit(Opcode opcode, unsigned int arg = 0, uint64_t value = 0,
+        Enums::TimingExprOp op = Enums::timingExprAdd);
+};
+
 class TimingExpr : public SimObject
 {
+  protected:
+    /** Compiled form of this expression, if it is used as a root */
+    std::unique_ptr<TimingExprProgram> program;
+
   public:
     TimingExpr(const TimingExprParams *params) :
         SimObject(params)
     { }
 
+    /** Interpret the tree */
     virtual uint64_t eval(TimingExprEvalContext &context) = 0;
+
+    /** Append this sub-expression to program */
+    virtual void compile(TimingExprProgram &program) = 0;
+
+    /** Compile this expression as the root of a program.  Users should
+     *  call this at init so that evaluate doesn't have to */
+    void compileProgram();
+
+    /** Evaluate the compiled form of this expression */
+    uint64_t
+    evaluate(const StaticInstPtr &inst, ThreadContext *thread)
+    {
+        if (!program)
+            compileProgram();
+        return program->eval(inst, thread);
+    }
 };
 
 class TimingExprLiteral : public TimingExpr
@@ -108,6 +241,9 @@ class TimingExprLiteral : public TimingExpr
     { }
 
     uint64_t eval(TimingExprEvalContext &context) { return value; }
+
+    void compile(TimingExprProgram &program)
+    { program.emitLiteral(value); }
 };
 
 class TimingExprSrcReg : public TimingExpr
@@ -121,6 +257,7 @@ class TimingExprSrcReg : public TimingExpr
     { }
 
     uint64_t eval(TimingExprEvalContext &context);
+    void compile(TimingExprProgram &program);
 };
 
 class TimingExprReadIntReg : public TimingExpr
@@ -134,6 +271,7 @@ class TimingExprReadIntReg : public TimingExpr
     { }
 
     uint64_t eval(TimingExprEvalContext &context);
+    void compile(TimingExprProgram &program);
 };
 
 class TimingExprLet : public TimingExpr
@@ -149,6 +287,7 @@ class TimingExprLet : public TimingExpr
     { }
 
     uint64_t eval(TimingExprEvalContext &context);
+    void compile(TimingExprProgram &program);
 };
 
 class TimingExprRef : public TimingExpr
@@ -162,6 +301,7 @@ class TimingExprRef : public TimingExpr
     { }
 
     uint64_t eval(TimingExprEvalContext &context);
+    void compile(TimingExprProgram &program);
 };
 
 class TimingExprUn : public TimingExpr
@@ -176,7 +316,10 @@ class TimingExprUn : public TimingExpr
         arg(params->arg)
     { }
 
+    static uint64_t apply(Enums::TimingExprOp op, uint64_t arg_value);
+
     uint64_t eval(TimingExprEvalContext &context);
+    void compile(TimingExprProgram &program);
 };
 
 class TimingExprBin : public TimingExpr
@@ -193,7 +336,11 @@ class TimingExprBin : public TimingExpr
         right(params->right)
     { }
 
+    static uint64_t apply(Enums::TimingExprOp op, uint64_t left_value,
+        uint64_t right_value);
+
     uint64_t eval(TimingExprEvalContext &context);
+    void compile(TimingExprProgram &program);
 };
 
 class TimingExprIf : public TimingExpr
@@ -211,6 +358,7 @@ class TimingExprIf : public TimingExpr
     { }
 
     uint64_t eval(TimingExprEvalContext &context);
+    void compile(TimingExprProgram &program);
 };
 
 #endif
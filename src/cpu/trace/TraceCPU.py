@@ -42,7 +42,8 @@ from BaseCPU import BaseCPU
 
 class TraceCPU(BaseCPU):
     """Trace CPU model which replays traces generated in a prior simulation
-     using DerivO3CPU or its derived classes. It interfaces with L1 caches.
+     using DerivO3CPU, MinorCPU or their derived classes. It interfaces with
+     L1 caches.
     """
     type = 'TraceCPU'
     cxx_header = "cpu/trace/trace_cpu.hh"
@@ -69,6 +70,11 @@ class TraceCPU(BaseCPU):
     sizeLoadBuffer = Param.Unsigned(16, "Number of entries in the load buffer")
     sizeROB =  Param.Unsigned(40, "Number of entries in the re-order buffer")
 
+    # Records of the data dependency trace are decoded ahead of time on a
+    # separate thread. Setting this to 0 decodes them on demand instead.
+    readAheadSize = Param.Unsigned(16384, "Number of data trace records "\
+        "to decode ahead of the replay")
+
     # Frequency multiplier used to effectively scale the Trace CPU frequency
     # either up or down. Note that the Trace CPU's clock domain must also be
     # changed when frequency is scaled. A default value of 1.0 means the same
@@ -76,6 +82,13 @@ class TraceCPU(BaseCPU):
     freqMultiplier = Param.Float(1.0, "Multiplier scale the Trace CPU "\
                                  "frequency up or down")
 
+    # Instructions that synchronise with other cores are replayed in the
+    # order in which they committed across all the traced cores. This needs
+    # one Trace CPU per traced core, so turn it off to replay only some of
+    # the traces of a multi-core capture.
+    syncReplay = Param.Bool(True, "Replay instructions that synchronise "\
+                            "with other cores in the captured order")
+
     # Enable exiting when any one Trace CPU completes execution which is set to
     # false by default
     enableEarlyExit = Param.Bool(False, "Exit when any one Trace CPU "\
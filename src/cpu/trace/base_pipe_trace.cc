@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/trace/base_pipe_trace.hh"
+
+#include <algorithm>
+
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+
+BasePipeTrace::BasePipeTrace(const BasePipeTraceParams *params)
+    : ProbeListenerObject(params),
+      traceSquashed(params->traceSquashed),
+      blockSize(params->blockSize),
+      traceStream(nullptr),
+      blockRecords(0),
+      lastSeqNum(0), lastPC(0), lastFetch(0)
+{
+    fatal_if(params->traceFile == "", "Assign the pipeline trace file "
+             "path to traceFile");
+    fatal_if(blockSize == 0, "%s: blockSize must be non-zero", name());
+
+    traceStream = new ProtoOutputStream(
+        simout.resolve(name() + "." + params->traceFile));
+
+    ProtoMessage::PipeTraceHeader header;
+    header.set_obj_id(name());
+    header.set_tick_freq(SimClock::Frequency);
+    traceStream->write(header);
+
+    registerExitCallback(new MakeCallback<BasePipeTrace,
+                         &BasePipeTrace::flushTrace>(this));
+}
+
+const std::string
+BasePipeTrace::name() const
+{
+    return ProbeListenerObject::name();
+}
+
+void
+BasePipeTrace::addInst(const InstRecord &rec, const StaticInstPtr &inst)
+{
+    const Tick fetch = rec.tick[Fetch];
+
+    block.add_seq_num((int64_t)(rec.seqNum - lastSeqNum));
+    block.add_pc((int64_t)(rec.pc - lastPC));
+    block.add_upc(rec.upc);
+    block.add_fetch((int64_t)(fetch - lastFetch));
+    lastSeqNum = rec.seqNum;
+    lastPC = rec.pc;
+    lastFetch = fetch;
+
+    // Stages that weren't reached are zero, the rest are offsets from
+    // fetch plus one so that an instruction can reach a stage in the
+    // cycle it was fetched.
+    uint32_t offset[NumStages];
+    for (int stage = Decode; stage < NumStages; ++stage) {
+        const Tick tick = rec.tick[stage];
+        offset[stage] = (tick == MaxTick || tick < fetch) ? 0 :
+            (uint32_t)std::min<Tick>(tick - fetch + 1, UINT32_MAX);
+    }
+    block.add_decode(offset[Decode]);
+    block.add_rename(offset[Rename]);
+    block.add_dispatch(offset[Dispatch]);
+    block.add_issue(offset[Issue]);
+    block.add_complete(offset[Complete]);
+    block.add_retire(offset[Retire]);
+    block.add_store(offset[Store]);
+
+    if (disassembled.emplace(rec.pc, rec.upc).second) {
+        block.add_disasm_pc(rec.pc);
+        block.add_disasm_upc(rec.upc);
+        block.add_disasm(inst->disassemble(rec.pc));
+    }
+
+    if (++blockRecords == blockSize)
+        writeBlock();
+}
+
+void
+BasePipeTrace::writeBlock()
+{
+    if (blockRecords == 0)
+        return;
+
+    traceStream->write(block);
+    block.Clear();
+    blockRecords = 0;
+    lastSeqNum = 0;
+    lastPC = 0;
+    lastFetch = 0;
+}
+
+void
+BasePipeTrace::flushTrace()
+{
+    writeBlock();
+    delete traceStream;
+    traceStream = nullptr;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * CPU model independent part of the pipeline trace probe listeners,
+ * which record the tick at which every instruction reached each stage
+ * of the pipeline for util/o3-pipeview.py.
+ */
+
+#ifndef __CPU_TRACE_BASE_PIPE_TRACE_HH__
+#define __CPU_TRACE_BASE_PIPE_TRACE_HH__
+
+#include <unordered_set>
+#include <utility>
+
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/static_inst.hh"
+#include "params/BasePipeTrace.hh"
+#include "proto/pipe_trace.pb.h"
+#include "proto/protoio.hh"
+#include "sim/probe/probe.hh"
+
+/**
+ * The pipeline trace replaces the text O3PipeView debug output with a
+ * binary stream. Instruction records are buffered and written in
+ * blocks, one column per stage, see proto/pipe_trace.proto. The
+ * subclass for each CPU model listens to its probe points and hands
+ * the stage ticks of each instruction that leaves the pipeline to
+ * addInst().
+ */
+class BasePipeTrace : public ProbeListenerObject
+{
+  public:
+    /** Pipeline stages, in the order the viewer shows them */
+    enum Stage {
+        Fetch,
+        Decode,
+        Rename,
+        Dispatch,
+        Issue,
+        Complete,
+        Retire,
+        Store,
+        NumStages
+    };
+
+    /** An instruction and the tick at which it reached each stage,
+     *  MaxTick for the stages it never reached */
+    struct InstRecord
+    {
+        InstSeqNum seqNum;
+        Addr pc;
+        MicroPC upc;
+        Tick tick[NumStages];
+    };
+
+    BasePipeTrace(const BasePipeTraceParams *params);
+
+    /** Returns the name of the trace probe listener */
+    const std::string name() const override;
+
+    /** Write out the records that are still buffered and close the
+     *  stream at simulation exit */
+    virtual void flushTrace();
+
+  protected:
+    /** Add an instruction to the trace */
+    void addInst(const InstRecord &rec, const StaticInstPtr &inst);
+
+    /** Write the block being built to the stream */
+    void writeBlock();
+
+    /** Whether to trace squashed instructions as well */
+    const bool traceSquashed;
+
+  private:
+    struct PCHash
+    {
+        size_t
+        operator()(const std::pair<Addr, MicroPC> &pc) const
+        {
+            return std::hash<Addr>()(pc.first ^ ((Addr)pc.second << 48));
+        }
+    };
+
+    /** Number of records in a block */
+    const unsigned blockSize;
+
+    ProtoOutputStream *traceStream;
+
+    /** The block being built and the number of records in it */
+    ProtoMessage::PipeTraceBlock block;
+    unsigned blockRecords;
+
+    /** Previous record of the block, for the delta encoded columns */
+    InstSeqNum lastSeqNum;
+    Addr lastPC;
+    Tick lastFetch;
+
+    /** The pc.upc pairs whose disassembly has been written */
+    std::unordered_set<std::pair<Addr, MicroPC>, PCHash> disassembled;
+};
+
+#endif // __CPU_TRACE_BASE_PIPE_TRACE_HH__
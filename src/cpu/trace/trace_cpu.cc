@@ -46,6 +46,10 @@
 // Declare and initialize the static counter for number of trace CPUs.
 int TraceCPU::numTraceCPUs = 0;
 
+// The order of synchronising nodes is shared by all Trace CPUs.
+uint64_t TraceCPU::ElasticDataGen::lastSyncSeq = 0;
+std::set<TraceCPU::ElasticDataGen*> TraceCPU::ElasticDataGen::syncWaiters;
+
 TraceCPU::TraceCPU(TraceCPUParams *params)
     :   BaseCPU(params),
         icachePort(this),
@@ -304,6 +308,11 @@ TraceCPU::ElasticDataGen::regStats()
     .desc("Number of strictly ordered stores")
     ;
 
+    numSyncWaits
+    .name(name() + ".numSyncWaits")
+    .desc("Number of nodes that waited for nodes of other cores to execute")
+    ;
+
     dataLastTick
     .name(name() + ".dataLastTick")
     .desc("Last tick simulated from the elastic data trace")
@@ -350,6 +359,7 @@ TraceCPU::ElasticDataGen::adjustInitTraceOffset(Tick& offset) {
 void
 TraceCPU::ElasticDataGen::exit()
 {
+    syncWaiters.erase(this);
     trace.reset();
 }
 
@@ -381,9 +391,14 @@ TraceCPU::ElasticDataGen::readNextWindow()
         if (!trace.read(new_node)) {
             DPRINTF(TraceCPUData, "\tTrace complete!\n");
             traceComplete = true;
+            delete new_node;
             return false;
         }
 
+        panic_if(!depGraph.empty() && new_node->seqNum < depGraph.end(),
+                 "Trace records are out of order at seq. num %lli.\n",
+                 new_node->seqNum);
+
         // Annotate the ROB dependencies of the new node onto the parent nodes.
         addDepsOnParent(new_node, new_node->robDep, new_node->numRobDep);
         // Annotate the register dependencies of the new node onto the parent
@@ -391,8 +406,8 @@ TraceCPU::ElasticDataGen::readNextWindow()
         addDepsOnParent(new_node, new_node->regDep, new_node->numRegDep);
 
         num_read++;
-        // Add to map
-        depGraph[new_node->seqNum] = new_node;
+        // Add to the graph
+        depGraph.push_at(new_node->seqNum, new_node);
         if (new_node->numRobDep == 0 && new_node->numRegDep == 0) {
             // Source dependencies are already complete, check if resources
             // are available and issue. The execution time is approximated
@@ -418,13 +433,13 @@ TraceCPU::ElasticDataGen::addDepsOnParent(GraphNode *new_node,
         if (a_dep == 0)
             break;
         // We look up the valid dependency, i.e. the parent of this node
-        auto parent_itr = depGraph.find(a_dep);
-        if (parent_itr != depGraph.end()) {
+        GraphNode *parent = findNode(a_dep);
+        if (parent) {
             // If the parent is found, it is yet to be executed. Append a
             // pointer to the new node to the dependents list of the parent
             // node.
-            parent_itr->second->dependents.push_back(new_node);
-            auto num_depts = parent_itr->second->dependents.size();
+            parent->dependents.push_back(new_node);
+            auto num_depts = parent->dependents.size();
             maxDependents = std::max<double>(num_depts, maxDependents.value());
         } else {
             // The dependency is not found in the graph. So consider
@@ -464,17 +479,14 @@ TraceCPU::ElasticDataGen::execute()
             break;
         }
     }
-    // Proceed to execute from readyList
-    auto graph_itr = depGraph.begin();
-    auto free_itr = readyList.begin();
-    // Iterate through readyList until the next free node has its execute
-    // tick later than curTick or the end of readyList is reached
-    while (free_itr->execTick <= curTick() && free_itr != readyList.end()) {
+    // Proceed to execute from readyList. Iterate through readyList until
+    // the next free node has its execute tick later than curTick or the end
+    // of readyList is reached
+    while (!readyList.empty() && readyList.front().execTick <= curTick()) {
 
         // Get pointer to the node to be executed
-        graph_itr = depGraph.find(free_itr->seqNum);
-        assert(graph_itr != depGraph.end());
-        GraphNode* node_ptr = graph_itr->second;
+        GraphNode* node_ptr = findNode(readyList.front().seqNum);
+        assert(node_ptr);
 
         // If there is a retryPkt send that else execute the load
         if (retryPkt) {
@@ -557,7 +569,14 @@ TraceCPU::ElasticDataGen::execute()
         }
 
         // After executing the node, remove from readyList and delete node.
-        readyList.erase(free_itr);
+        // Its dependents have later execute ticks or higher sequence
+        // numbers, so the node is still at the head of the list.
+        assert(readyList.front().seqNum == node_ptr->seqNum);
+        readyList.pop_front();
+        // Let the nodes that synchronise after this one issue, on this and
+        // the other Trace CPUs.
+        if (node_ptr->syncSeq != 0)
+            syncExecuted(node_ptr->syncSeq);
         // If it is a cacheable load which was sent, don't delete
         // just yet.  Delete it in completeMemAccess() after the
         // response is received. If it is an strictly ordered
@@ -572,13 +591,11 @@ TraceCPU::ElasticDataGen::execute()
             (node_ptr->dependents).clear();
             // Update the stat for numOps simulated
             owner.updateNumOps(node_ptr->robNum);
+            // remove from graph
+            depGraph.erase(node_ptr->seqNum);
             // delete node
             delete node_ptr;
-            // remove from graph
-            depGraph.erase(graph_itr);
         }
-        // Point to first node to continue to next iteration of while loop
-        free_itr = readyList.begin();
     } // end of while loop
 
     // Print readyList, sizes of queues and resource status after updating
@@ -715,6 +732,17 @@ TraceCPU::ElasticDataGen::checkAndIssue(const GraphNode* node_ptr, bool first)
             node_ptr->robNum);
     }
 
+    // A node that synchronises with other cores waits, without holding
+    // any resources, until the nodes before it have executed.
+    if (node_ptr->syncSeq != 0 && !isSyncTurn(node_ptr)) {
+        DPRINTFR(TraceCPUData, "\t\tseq. num %lli waits for sync op %lli"
+            " to execute.\n", node_ptr->seqNum, node_ptr->syncSeq - 1);
+        syncWaiting[node_ptr->syncSeq] = node_ptr;
+        syncWaiters.insert(this);
+        ++numSyncWaits;
+        return true;
+    }
+
     // Check if resources are available to issue the specific node
     if (hwResource.isAvailable(node_ptr)) {
         // If resources are free only then add to readyList
@@ -742,6 +770,39 @@ TraceCPU::ElasticDataGen::checkAndIssue(const GraphNode* node_ptr, bool first)
     }
 }
 
+void
+TraceCPU::ElasticDataGen::issueSyncWaiting()
+{
+    bool issued = false;
+    while (!syncWaiting.empty() &&
+           isSyncTurn(syncWaiting.begin()->second)) {
+        const GraphNode* node_ptr = syncWaiting.begin()->second;
+        syncWaiting.erase(syncWaiting.begin());
+        DPRINTFR(TraceCPUData, "\t\tseq. num %lli may now issue.\n",
+                 node_ptr->seqNum);
+        checkAndIssue(node_ptr);
+        issued = true;
+    }
+
+    if (syncWaiting.empty())
+        syncWaiters.erase(this);
+
+    if (issued)
+        owner.schedDcacheNextEvent(owner.clockEdge());
+}
+
+void
+TraceCPU::ElasticDataGen::syncExecuted(uint64_t sync_seq)
+{
+    lastSyncSeq = std::max(lastSyncSeq, sync_seq);
+
+    // Issuing removes generators from the set, so go through a copy.
+    std::vector<ElasticDataGen*> waiters(syncWaiters.begin(),
+                                         syncWaiters.end());
+    for (auto gen : waiters)
+        gen->issueSyncWaiting();
+}
+
 void
 TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
 {
@@ -756,9 +817,8 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
     } else {
         // If it is a load response then release the dependents waiting on it.
         // Get pointer to the completed load
-        auto graph_itr = depGraph.find(pkt->req->getReqInstSeqNum());
-        assert(graph_itr != depGraph.end());
-        GraphNode* node_ptr = graph_itr->second;
+        GraphNode* node_ptr = findNode(pkt->req->getReqInstSeqNum());
+        assert(node_ptr);
 
         // Release resources occupied by the load
         hwResource.release(node_ptr);
@@ -776,10 +836,10 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
         (node_ptr->dependents).clear();
         // Update the stat for numOps completed
         owner.updateNumOps(node_ptr->robNum);
+        // remove from graph
+        depGraph.erase(node_ptr->seqNum);
         // delete node
         delete node_ptr;
-        // remove from graph
-        depGraph.erase(graph_itr);
     }
 
     if (DTRACE(TraceCPUData)) {
@@ -876,8 +936,7 @@ TraceCPU::ElasticDataGen::printReadyList() {
     }
     DPRINTF(TraceCPUData, "Printing readyList:\n");
     while (itr != readyList.end()) {
-        auto graph_itr = depGraph.find(itr->seqNum);
-        GraphNode* node_ptr M5_VAR_USED = graph_itr->second;
+        GraphNode* node_ptr M5_VAR_USED = findNode(itr->seqNum);
         DPRINTFR(TraceCPUData, "\t%lld(%s), %lld\n", itr->seqNum,
             node_ptr->typeToStr(), itr->execTick);
         itr++;
@@ -1266,10 +1325,18 @@ TraceCPU::DcachePort::recvReqRetry()
 
 TraceCPU::ElasticDataGen::InputStream::InputStream(
     const std::string& filename,
-    const double time_multiplier)
+    const double time_multiplier,
+    size_t read_ahead)
     : trace(filename),
       timeMultiplier(time_multiplier),
-      microOpCount(0)
+      microOpCount(0),
+      readAheadSize(read_ahead),
+      readAhead(read_ahead),
+      readAheadHead(0),
+      readAheadCount(0),
+      decodedMicroOps(0),
+      decodeDone(false),
+      decodeStop(false)
 {
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::InstDepRecordHeader header_msg;
@@ -1285,16 +1352,110 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
         // when the data dependency trace was captured in the o3cpu model
         windowSize = header_msg.window_size();
     }
+
+    startDecoder();
+}
+
+TraceCPU::ElasticDataGen::InputStream::~InputStream()
+{
+    stopDecoder();
 }
 
 void
 TraceCPU::ElasticDataGen::InputStream::reset()
 {
+    stopDecoder();
     trace.reset();
+    microOpCount = 0;
+    decodedMicroOps = 0;
+    startDecoder();
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::startDecoder()
+{
+    if (!readAheadSize)
+        return;
+
+    decodeDone = false;
+    decodeStop = false;
+    decoder = std::thread([this]{ decodeLoop(); });
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::stopDecoder()
+{
+    if (!decoder.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(readAheadLock);
+        decodeStop = true;
+    }
+    readAheadNotFull.notify_one();
+    decoder.join();
+
+    readAheadHead = 0;
+    readAheadCount = 0;
+}
+
+void
+TraceCPU::ElasticDataGen::InputStream::decodeLoop()
+{
+    GraphNode node;
+    bool more = true;
+    while (more) {
+        more = decode(&node);
+
+        std::unique_lock<std::mutex> lock(readAheadLock);
+        readAheadNotFull.wait(lock, [this]{
+            return decodeStop || readAheadCount < readAheadSize;
+        });
+        if (decodeStop)
+            return;
+
+        if (more) {
+            const size_t tail = (readAheadHead + readAheadCount) %
+                readAheadSize;
+            readAhead[tail] = node;
+            ++readAheadCount;
+        } else {
+            decodeDone = true;
+        }
+        lock.unlock();
+        readAheadNotEmpty.notify_one();
+    }
 }
 
 bool
 TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
+{
+    if (!readAheadSize) {
+        if (!decode(element))
+            return false;
+        microOpCount = element->robNum;
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(readAheadLock);
+    readAheadNotEmpty.wait(lock, [this]{
+        return readAheadCount || decodeDone;
+    });
+    if (!readAheadCount)
+        return false;
+
+    *element = readAhead[readAheadHead];
+    readAheadHead = (readAheadHead + 1) % readAheadSize;
+    --readAheadCount;
+    lock.unlock();
+    readAheadNotFull.notify_one();
+
+    microOpCount = element->robNum;
+    return true;
+}
+
+bool
+TraceCPU::ElasticDataGen::InputStream::decode(GraphNode* element)
 {
     ProtoMessage::InstDepRecord pkt_msg;
     if (trace.read(pkt_msg)) {
@@ -1360,12 +1521,17 @@ TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
         else
             element->pc = 0;
 
+        if (pkt_msg.has_sync_seq())
+            element->syncSeq = pkt_msg.sync_seq();
+        else
+            element->syncSeq = 0;
+
         // ROB occupancy number
-        ++microOpCount;
+        ++decodedMicroOps;
         if (pkt_msg.has_weight()) {
-            microOpCount += pkt_msg.weight();
+            decodedMicroOps += pkt_msg.weight();
         }
-        element->robNum = microOpCount;
+        element->robNum = decodedMicroOps;
         return true;
     }
 
@@ -1451,6 +1617,8 @@ TraceCPU::ElasticDataGen::GraphNode::writeElementAsTrace() const
         DPRINTFR(TraceCPUData, ",%i", flags);
     }
     DPRINTFR(TraceCPUData, ",%lli", compDelay);
+    if (syncSeq != 0)
+        DPRINTFR(TraceCPUData, ",sync:%lli", syncSeq);
     int i = 0;
     DPRINTFR(TraceCPUData, "robDep:");
     while (robDep[i] != 0) {
@@ -43,12 +43,18 @@
 #define __CPU_TRACE_TRACE_CPU_HH__
 
 #include <array>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
 #include <queue>
 #include <set>
-#include <unordered_map>
+#include <thread>
 
 #include "arch/registers.hh"
+#include "base/index_ring.hh"
+#include "base/pool_alloc.hh"
 #include "base/statistics.hh"
 #include "cpu/base.hh"
 #include "debug/TraceCPUData.hh"
@@ -61,12 +67,13 @@
 
 /**
  * The trace cpu replays traces generated using the elastic trace probe
- * attached to the O3 CPU model. The elastic trace is an execution trace with
- * register data dependencies and ordering dependencies annotated to it. The
- * trace cpu also replays a fixed timestamp fetch trace that is also generated
- * by the elastic trace probe. This trace cpu model aims at achieving faster
- * simulation compared to the detailed cpu model and good correlation when the
- * same trace is used for playback on different memory sub-systems.
+ * attached to the O3 or Minor CPU model. The elastic trace is an execution
+ * trace with register data dependencies and ordering dependencies annotated
+ * to it. The trace cpu also replays a fixed timestamp fetch trace that is
+ * also generated by the elastic trace probe. This trace cpu model aims at
+ * achieving faster simulation compared to the detailed cpu model and good
+ * correlation when the same trace is used for playback on different memory
+ * sub-systems.
  *
  * The TraceCPU inherits from BaseCPU so some virtual methods need to be
  * defined. It has two port subclasses inherited from MasterPort for
@@ -118,6 +125,11 @@
  * inspect top N pending nodes where N is the issue-width. This is left for
  * future as the timing correlation looks good as it is.
  *
+ * The dependency graph is kept in a ring indexed by sequence number, as nodes
+ * are read in program order and looked up by sequence number. Trace records
+ * are decoded ahead of time by a separate thread, which keeps protobuf
+ * decoding off the critical path of the replay.
+ *
  * At the start of an execution event, first we attempt to issue such pending
  * nodes by checking if appropriate resources have become available. If yes, we
  * compute the execute tick with respect to the time then. Then we proceed to
@@ -139,6 +151,16 @@
  * A CountedExitEvent that contains a static int belonging to the Trace CPU
  * class as a down counter is used to implement multi Trace CPU simulation
  * exit.
+ *
+ * To replay the traces captured from all the cores of a multi-core system,
+ * one Trace CPU per core shares the memory system. Nodes that synchronise
+ * with other cores, e.g. barriers and atomic accesses, carry their position
+ * in the order in which they committed across all cores during capture. Such
+ * a node only issues when the nodes before it have executed on any Trace
+ * CPU, which keeps the cores in step as they were in the capture. This
+ * requires the traces of all the cores to be replayed, otherwise the Trace
+ * CPUs wait forever for the missing nodes; the syncReplay parameter turns
+ * the ordering off.
  */
 
 class TraceCPU : public BaseCPU
@@ -618,6 +640,13 @@ class TraceCPU : public BaseCPU
             /** Instruction PC */
             Addr pc;
 
+            /**
+             * Position in the order of synchronising instructions across
+             * the traces of all cores, or zero if the node doesn't
+             * synchronise with other cores
+             */
+            uint64_t syncSeq;
+
             /** Array of order dependencies. */
             RobDepArray robDep;
 
@@ -679,6 +708,24 @@ class TraceCPU : public BaseCPU
 
             /** Return string specifying the type of the node */
             std::string typeToStr() const;
+
+            /**
+             * @{
+             * Nodes are allocated and freed for every instruction in
+             * the trace, so they are taken from a pool.
+             */
+            typedef PoolAllocator<GraphNode> Pool;
+
+            static void *operator new(size_t size)
+            {
+                return Pool::allocate(size);
+            }
+
+            static void operator delete(void *p, size_t size)
+            {
+                Pool::deallocate(p, size);
+            }
+            /** @} */
         };
 
         /** Struct to store a ready-to-execute node and its execution tick. */
@@ -816,6 +863,49 @@ class TraceCPU : public BaseCPU
              * trace and used to process the dependency trace
              */
             uint32_t windowSize;
+
+            /**
+             * Decode the next record of the trace into a node.
+             *
+             * @param element Node to populate
+             * @return True if a record could be decoded
+             */
+            bool decode(GraphNode* element);
+
+            /** Main loop of the decoder thread */
+            void decodeLoop();
+
+            /** Start decoding ahead, if enabled */
+            void startDecoder();
+
+            /** Stop the decoder thread and drop decoded records */
+            void stopDecoder();
+
+            /**
+             * Number of records decoded ahead of the replay. Decoding
+             * happens on the replay thread if this is 0.
+             */
+            const size_t readAheadSize;
+
+            /**
+             * @{
+             * Bounded ring of records decoded by the decoder thread and
+             * not read yet. The decoder thread only owns the protobuf
+             * stream and decodedMicroOps, all other state is protected
+             * by readAheadLock.
+             */
+            std::vector<GraphNode> readAhead;
+            size_t readAheadHead;
+            size_t readAheadCount;
+            uint64_t decodedMicroOps;
+            bool decodeDone;
+            bool decodeStop;
+            std::mutex readAheadLock;
+            std::condition_variable readAheadNotEmpty;
+            std::condition_variable readAheadNotFull;
+            std::thread decoder;
+            /** @} */
+
           public:
 
             /**
@@ -823,9 +913,14 @@ class TraceCPU : public BaseCPU
              *
              * @param filename Path to the file to read from
              * @param time_multiplier used to scale the compute delays
+             * @param read_ahead number of records to decode ahead on a
+             *                   separate thread, 0 to decode on demand
              */
             InputStream(const std::string& filename,
-                        const double time_multiplier);
+                        const double time_multiplier,
+                        size_t read_ahead);
+
+            ~InputStream();
 
             /**
              * Reset the stream such that it can be played once
@@ -859,7 +954,8 @@ class TraceCPU : public BaseCPU
             : owner(_owner),
               port(_port),
               masterID(master_id),
-              trace(trace_file, 1.0 / params->freqMultiplier),
+              trace(trace_file, 1.0 / params->freqMultiplier,
+                    params->readAheadSize),
               genName(owner.name() + ".elastic" + _name),
               retryPkt(nullptr),
               traceComplete(false),
@@ -867,7 +963,8 @@ class TraceCPU : public BaseCPU
               execComplete(false),
               windowSize(trace.getWindowSize()),
               hwResource(params->sizeROB, params->sizeStoreBuffer,
-                         params->sizeLoadBuffer)
+                         params->sizeLoadBuffer),
+              syncReplay(params->syncReplay)
         {
             DPRINTF(TraceCPUData, "Window size in the trace is %d.\n",
                     windowSize);
@@ -972,14 +1069,31 @@ class TraceCPU : public BaseCPU
          * Attempts to issue a node once the node's source dependencies are
          * complete. If resources are available then add it to the readyList,
          * otherwise the node is not issued and is stored in depFreeQueue
-         * until resources become available.
+         * until resources become available. A node that synchronises with
+         * other cores is held in syncWaiting until it is its turn.
          *
          * @param node_ptr pointer to node to be issued
          * @param first true if this is the first attempt to issue this node
-         * @return true if node was added to readyList
+         * @return true if node was added to readyList or syncWaiting
          */
         bool checkAndIssue(const GraphNode* node_ptr, bool first = true);
 
+        /**
+         * Issue the nodes held in syncWaiting whose turn has come, and
+         * schedule an event to execute them.
+         */
+        void issueSyncWaiting();
+
+        /**
+         * Record that a node that synchronises with other cores has
+         * executed, and let the generators of all Trace CPUs issue the
+         * nodes that were waiting for it.
+         *
+         * @param sync_seq position of the node in the order of
+         *                 synchronising nodes
+         */
+        static void syncExecuted(uint64_t sync_seq);
+
         /** Get number of micro-ops modelled in the TraceCPU replay */
         uint64_t getMicroOpCount() const { return trace.getMicroOpCount(); }
 
@@ -1031,8 +1145,19 @@ class TraceCPU : public BaseCPU
          */
         HardwareResource hwResource;
 
-        /** Store the depGraph of GraphNodes */
-        std::unordered_map<NodeSeqNum, GraphNode*> depGraph;
+        /**
+         * Store the depGraph of GraphNodes, indexed by sequence number.
+         * Nodes are added in program order and the gaps in the sequence
+         * numbers become holes.
+         */
+        IndexRing<GraphNode*> depGraph;
+
+        /** Find a node in the depGraph, or nullptr if it isn't there */
+        GraphNode *
+        findNode(NodeSeqNum seq_num) const
+        {
+            return depGraph.valid(seq_num) ? depGraph[seq_num] : nullptr;
+        }
 
         /**
          * Queue of dependency-free nodes that are pending issue because
@@ -1043,8 +1168,46 @@ class TraceCPU : public BaseCPU
          */
         std::queue<const GraphNode*> depFreeQueue;
 
-        /** List of nodes that are ready to execute */
-        std::list<ReadyNode> readyList;
+        /**
+         * List of nodes that are ready to execute, sorted by execute
+         * tick. It is bounded by the ROB size, so a deque, which
+         * doesn't allocate per node, beats a list.
+         */
+        std::deque<ReadyNode> readyList;
+
+        /**
+         * Whether nodes that synchronise with other cores are issued in the
+         * order recorded across the traces of all cores.
+         */
+        const bool syncReplay;
+
+        /**
+         * Dependency-free nodes that synchronise with other cores and wait
+         * for the nodes before them in the traces of other cores to
+         * execute, sorted by their position in that order.
+         */
+        std::map<uint64_t, const GraphNode*> syncWaiting;
+
+        /**
+         * Position of the last synchronising node executed by any Trace
+         * CPU. A node can issue once all the nodes before it have
+         * executed, which allows several Trace CPUs replaying the same
+         * trace to each execute a copy of the node.
+         */
+        static uint64_t lastSyncSeq;
+
+        /** Generators with nodes in syncWaiting. */
+        static std::set<ElasticDataGen*> syncWaiters;
+
+        /**
+         * Can a node that synchronises with other cores issue, i.e. have
+         * all the synchronising nodes before it executed?
+         */
+        bool
+        isSyncTurn(const GraphNode* node_ptr) const
+        {
+            return !syncReplay || node_ptr->syncSeq <= lastSyncSeq + 1;
+        }
 
         /** Stats for data memory accesses replayed. */
         Stats::Scalar maxDependents;
@@ -1056,6 +1219,7 @@ class TraceCPU : public BaseCPU
         Stats::Scalar numSplitReqs;
         Stats::Scalar numSOLoads;
         Stats::Scalar numSOStores;
+        Stats::Scalar numSyncWaits;
         /** Tick when ElasticDataGen completes execution */
         Stats::Scalar dataLastTick;
     };
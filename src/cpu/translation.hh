@@ -46,6 +46,7 @@
 #define __CPU_TRANSLATION_HH__
 
 #include "arch/generic/tlb.hh"
+#include "base/pool_alloc.hh"
 #include "sim/faults.hh"
 
 /**
@@ -74,6 +75,22 @@ class WholeTranslationState
     uint64_t *res;
     BaseTLB::Mode mode;
 
+    /**
+     * @{
+     * Translation states are allocated from a thread-local free-list
+     * pool, see PoolAllocator, as every memory access creates one.
+     */
+    typedef PoolAllocator<WholeTranslationState> Pool;
+
+    static void *operator new(size_t size) { return Pool::allocate(size); }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        Pool::deallocate(p, size);
+    }
+    /** @} */
+
     /**
      * Single translation state.  We set the number of outstanding
      * translations to one and indicate that it is not split.
@@ -223,6 +240,22 @@ class DataTranslation : public BaseTLB::Translation
     int index;
 
   public:
+    /**
+     * @{
+     * Data translations are allocated from a thread-local free-list
+     * pool, see PoolAllocator.
+     */
+    typedef PoolAllocator<DataTranslation> Pool;
+
+    static void *operator new(size_t size) { return Pool::allocate(size); }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        Pool::deallocate(p, size);
+    }
+    /** @} */
+
     DataTranslation(ExecContextPtr _xc, WholeTranslationState* _state)
         : xc(_xc), state(_state), index(0)
     {
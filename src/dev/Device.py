@@ -83,6 +83,15 @@ class DmaDevice(PioDevice):
     abstract = True
     dma = MasterPort("DMA port")
 
+    bulk_dma = Param.Bool(False, "Copy DMA data functionally in bulk "
+                          "instead of sending cache line sized packets")
+    bulk_dma_bandwidth = Param.MemoryBandwidth('4GB/s',
+                                               "Bulk DMA bandwidth")
+    bulk_dma_latency = Param.Latency('100ns', "Bulk DMA latency")
+    dma_chunk_size = Param.Unsigned(0, "Largest DMA packet in bytes, 0 for "
+                                    "the cache line size. Only Ruby DMA "
+                                    "sequencers accept larger packets")
+
 
 class IsaFake(BasicPioDevice):
     type = 'IsaFake'
@@ -0,0 +1,50 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from SimpleMemory import SimpleMemory
+
+class M5Mailbox(SimpleMemory):
+    """Shared-memory mailbox for m5ops that don't need to stop the guest.
+
+    The mailbox is a small memory the guest maps (see util/m5/m5_mailbox.c)
+    and posts work and region markers to without trapping, even under KVM.
+    gem5 drains it every poll_period, so markers are timestamped with that
+    granularity. It also holds counters the guest updates in place, which
+    are reported as the mailbox's counters stat.
+    """
+
+    type = 'M5Mailbox'
+    cxx_header = "dev/m5_mailbox.hh"
+
+    system = Param.System(Parent.any, "System the mailbox belongs to")
+    num_entries = Param.Unsigned(4096, "Entries in the m5op ring")
+    num_counters = Param.Unsigned(64, "Guest-updated counters")
+    poll_period = Param.Latency('100us', "Time between drains of the ring")
+
+    # The guest must not treat the mailbox as RAM
+    conf_table_reported = False
@@ -46,6 +46,7 @@
 #include "mem/packet_access.hh"
 #include "params/GenericTimer.hh"
 #include "params/GenericTimerMem.hh"
+#include "sim/timer_wheel.hh"
 
 SystemCounter::SystemCounter()
     : _freq(0), _period(0), _resetTick(0), _regCntkctl(0)
@@ -95,10 +96,20 @@ ArchTimer::ArchTimer(const std::string &name,
     : _name(name), _parent(parent), _systemCounter(sysctr),
       _interrupt(interrupt),
       _control(0), _counterLimit(0), _offset(0),
-      _counterLimitReachedEvent([this]{ counterLimitReached(); }, name)
+      _counterLimitReachedEvent([this]{ counterLimitReached(); }, name),
+      _wheel(nullptr), _wheelSlot(0)
 {
 }
 
+void
+ArchTimer::useWheel(TimerWheel *wheel, std::function<bool()> idle)
+{
+    assert(!_wheel && !_counterLimitReachedEvent.scheduled());
+    _wheel = wheel;
+    _wheelSlot = wheel->add([this]{ counterLimitReached(); });
+    _idle = idle;
+}
+
 void
 ArchTimer::counterLimitReached()
 {
@@ -123,15 +134,28 @@ ArchTimer::updateCounter()
 {
     if (_counterLimitReachedEvent.scheduled())
         _parent.deschedule(_counterLimitReachedEvent);
+    if (_wheel)
+        _wheel->deactivate(_wheelSlot);
     if (value() >= _counterLimit) {
         counterLimitReached();
     } else {
         _control.istatus = 0;
-        if (scheduleEvents()) {
-            const auto period(_systemCounter.period());
-            _parent.schedule(_counterLimitReachedEvent,
-                 curTick() + (_counterLimit - value()) * period);
-        }
+        scheduleCounterEvent();
+    }
+}
+
+void
+ArchTimer::scheduleCounterEvent()
+{
+    if (!scheduleEvents())
+        return;
+
+    const auto period(_systemCounter.period());
+    const Tick when = curTick() + (_counterLimit - value()) * period;
+    if (!_wheel) {
+        _parent.schedule(_counterLimitReachedEvent, when);
+    } else if (_control.enable && !_control.imask) {
+        _wheel->activate(_wheelSlot, when, _idle());
     }
 }
 
@@ -164,6 +188,24 @@ ArchTimer::setControl(uint32_t val)
     }
     _control.enable = new_ctl.enable;
     _control.imask = new_ctl.imask;
+
+    if (_wheel) {
+        // The limit is only scheduled while it can raise an interrupt.
+        _wheel->deactivate(_wheelSlot);
+        if (value() < _counterLimit)
+            scheduleCounterEvent();
+    }
+}
+
+uint32_t
+ArchTimer::control() const
+{
+    ArchTimerCtrl ctl = _control;
+    // A tickless timer doesn't update ISTATUS when the limit is
+    // reached without an interrupt.
+    if (_wheel && value() >= _counterLimit)
+        ctl.istatus = 1;
+    return ctl;
 }
 
 void
@@ -206,6 +248,8 @@ ArchTimer::drain()
 {
     if (_counterLimitReachedEvent.scheduled())
         _parent.deschedule(_counterLimitReachedEvent);
+    if (_wheel)
+        _wheel->deactivate(_wheelSlot);
 
     return DrainState::Drained;
 }
@@ -41,6 +41,8 @@
 #ifndef __DEV_ARM_GENERIC_TIMER_HH__
 #define __DEV_ARM_GENERIC_TIMER_HH__
 
+#include <functional>
+
 #include "arch/arm/isa_device.hh"
 #include "arch/arm/system.hh"
 #include "base/bitunion.hh"
@@ -56,6 +58,7 @@
 class Checkpoint;
 class GenericTimerParams;
 class GenericTimerMemParams;
+class TimerWheel;
 
 /// Global system counter.  It is shared by the architected timers.
 /// @todo: implement memory-mapped controls
@@ -160,6 +163,20 @@ class ArchTimer : public Serializable, public Drainable
     void counterLimitReached();
     EventFunctionWrapper _counterLimitReachedEvent;
 
+    /**
+     * Shared timer event used instead of _counterLimitReachedEvent
+     * with tickless timers. The counter limit is then only scheduled
+     * while the timer can raise an interrupt; ISTATUS is computed when
+     * the control register is read.
+     */
+    TimerWheel *_wheel;
+    unsigned _wheelSlot;
+    /** Is the core of this timer idle, i.e., can expiry be deferred? */
+    std::function<bool()> _idle;
+
+    /// Schedule the event of the counter limit, which isn't reached yet.
+    void scheduleCounterEvent();
+
     virtual bool scheduleEvents() { return true; }
 
   public:
@@ -171,6 +188,14 @@ class ArchTimer : public Serializable, public Drainable
     /// Returns the timer name.
     std::string name() const { return _name; }
 
+    /**
+     * Use a shared timer event rather than a private one.
+     *
+     * @param wheel Timer wheel of the system.
+     * @param idle Whether the core of the timer is idle.
+     */
+    void useWheel(TimerWheel *wheel, std::function<bool()> idle);
+
     /// Returns the CompareValue view of the timer.
     uint64_t compareValue() const { return _counterLimit; }
     /// Sets the CompareValue view of the timer.
@@ -182,7 +207,7 @@ class ArchTimer : public Serializable, public Drainable
     void setTimerValue(uint32_t val);
 
     /// Sets the control register.
-    uint32_t control() const { return _control; }
+    uint32_t control() const;
     void setControl(uint32_t val);
 
     uint64_t offset() const { return _offset; }
@@ -252,7 +277,17 @@ class GenericTimer : public ClockedObject
               virt(csprintf("%s.virt_timer%d", parent.name(), cpu),
                    system, parent, parent.systemCounter,
                    irqVirt)
-        {}
+        {
+            TimerWheel *wheel = system.timerWheel(parent.eventQueue());
+            if (wheel) {
+                auto idle = [&system, cpu]() {
+                    return cpu < system.numContexts() &&
+                        system.contextIdle(cpu);
+                };
+                phys.useWheel(wheel, idle);
+                virt.useWheel(wheel, idle);
+            }
+        }
 
         ArchTimer::Interrupt irqPhys;
         ArchTimer::Interrupt irqVirt;
@@ -87,7 +87,8 @@ HDLcd::HDLcd(const HDLcdParams *p)
       virtRefreshEvent([this]{ virtRefresh(); }, name()),
       // Other
       imgFormat(p->frame_format), pic(NULL), conv(PixelConverter::rgba8888_le),
-      pixelPump(*this, *p->pxl_clk, p->pixel_chunk)
+      pixelPump(*this, *p->pxl_clk, p->pixel_chunk),
+      lastFrameVersion(0), forceFrameUpdate(true)
 {
     if (vnc)
         vnc->setFrameBuffer(&pixelPump.fb);
@@ -206,6 +207,10 @@ HDLcd::drainResume()
 {
     AmbaDmaDevice::drainResume();
 
+    // The frame buffer version isn't checkpointed, so always send the
+    // first frame after a resume.
+    forceFrameUpdate = true;
+
     if (enabled()) {
         if (sys->bypassCaches()) {
             // We restart the HDLCD if we are in KVM mode. This
@@ -569,6 +574,14 @@ HDLcd::pxlFrameDone()
         pixelPump.dumpSettings();
     }
 
+    const FrameBuffer &fb(pixelPump.fb);
+    if (!forceFrameUpdate && !fb.changedSince(lastFrameVersion)) {
+        DPRINTF(HDLcd, "Frame unchanged.\n");
+        return;
+    }
+    lastFrameVersion = fb.version();
+    forceFrameUpdate = false;
+
     if (vnc)
         vnc->setDirty();
 
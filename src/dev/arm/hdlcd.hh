@@ -363,6 +363,15 @@ class HDLcd: public AmbaDmaDevice
 
     PixelPump pixelPump;
 
+    /**
+     * Frame buffer version at the end of the last frame. Frames that
+     * didn't change any pixels aren't sent to the VNC server or
+     * captured.
+     */
+    uint64_t lastFrameVersion;
+    /** Force the next frame to be sent and captured */
+    bool forceFrameUpdate;
+
   protected: // DMA handling
     class DmaEngine : public DmaReadFifo
     {
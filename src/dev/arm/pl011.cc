@@ -44,6 +44,7 @@
 #include "dev/arm/pl011.hh"
 
 #include "base/trace.hh"
+#include "config/use_kvm.hh"
 #include "debug/Checkpoint.hh"
 #include "debug/Uart.hh"
 #include "dev/arm/amba_device.hh"
@@ -52,6 +53,11 @@
 #include "mem/packet_access.hh"
 #include "params/Pl011.hh"
 #include "sim/sim_exit.hh"
+#include "sim/system.hh"
+
+#if USE_KVM
+#include "cpu/kvm/vm.hh"
+#endif
 
 Pl011::Pl011(const Pl011Params *p)
     : Uart(p, 0xfff),
@@ -63,6 +69,21 @@ Pl011::Pl011(const Pl011Params *p)
 {
 }
 
+void
+Pl011::init()
+{
+    Uart::init();
+
+#if USE_KVM
+    // Writing to the data register only queues a character and
+    // re-raises the TX interrupt, so a KVM guest can batch its
+    // console output without exiting on every character.
+    KvmVM *vm = sys->getKvmVM();
+    if (vm && vm->coalesceDeviceMMIO(pioAddr + UART_DR, sizeof(uint32_t)))
+        DPRINTF(Uart, "Coalescing writes to the data register\n");
+#endif
+}
+
 Tick
 Pl011::read(PacketPtr pkt)
 {
@@ -436,6 +436,7 @@ Pl111::updateVideoParams()
 
     fb.resize(width, height);
     converter = pixelConverter();
+    lastFrame.clear();
 
     // Workaround configuration bugs where multiple display
     // controllers are attached to the same VNC server by reattaching
@@ -519,11 +520,7 @@ Pl111::dmaDone()
         }
 
         assert(!readEvent.scheduled());
-        fb.copyIn(dmaBuffer, converter);
-        if (vnc)
-            vnc->setDirty();
-
-        if (enableCapture) {
+        if (updateFrameBuffer() && enableCapture) {
             DPRINTF(PL111, "-- write out frame buffer into bmp\n");
 
             if (!pic)
@@ -748,12 +745,30 @@ Pl111::unserialize(CheckpointIn &cp)
 
     if (lcdControl.lcdpwr) {
         updateVideoParams();
-        fb.copyIn(dmaBuffer, converter);
-        if (vnc)
-            vnc->setDirty();
+        updateFrameBuffer();
     }
 }
 
+bool
+Pl111::updateFrameBuffer()
+{
+    const size_t frame_size = fb.area() * converter.length;
+    assert(frame_size <= buffer_size);
+
+    if (lastFrame.size() == frame_size &&
+        !memcmp(lastFrame.data(), dmaBuffer, frame_size)) {
+        DPRINTF(PL111, "Frame unchanged, skipping conversion\n");
+        return false;
+    }
+
+    lastFrame.assign(dmaBuffer, dmaBuffer + frame_size);
+    fb.copyIn(dmaBuffer, converter);
+    if (vnc)
+        vnc->setDirty();
+
+    return true;
+}
+
 void
 Pl111::generateInterrupt()
 {
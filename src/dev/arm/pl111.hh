@@ -48,6 +48,7 @@
 
 #include <fstream>
 #include <memory>
+#include <vector>
 
 #include "base/bmpwriter.hh"
 #include "base/framebuffer.hh"
@@ -283,6 +284,14 @@ class Pl111: public AmbaDmaDevice
     /** CLCDC supports up to 1024x768 */
     uint8_t *dmaBuffer;
 
+    /**
+     * Raw contents of the last frame that was converted into the
+     * frame buffer. Frames that haven't changed are neither converted
+     * nor sent to the VNC server. Empty if the next frame must be
+     * converted regardless.
+     */
+    std::vector<uint8_t> lastFrame;
+
     /** Start time for frame buffer dma read */
     Tick startTime;
 
@@ -312,6 +321,14 @@ class Pl111: public AmbaDmaDevice
     /** Generate dma framebuffer read event */
     void generateReadEvent();
 
+    /**
+     * Convert the frame in the DMA buffer into the frame buffer, unless
+     * it is identical to the last one.
+     *
+     * @return true if the frame buffer was updated
+     */
+    bool updateFrameBuffer();
+
     /** Function to generate interrupt */
     void generateInterrupt();
 
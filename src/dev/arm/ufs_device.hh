@@ -150,11 +150,11 @@
 #include "base/bitfield.hh"
 #include "base/statistics.hh"
 #include "debug/UFSHostDevice.hh"
-#include "dev/arm/abstract_nvm.hh"
 #include "dev/arm/base_gic.hh"
-#include "dev/storage/disk_image.hh"
 #include "dev/dma_device.hh"
 #include "dev/io_device.hh"
+#include "dev/storage/abstract_nvm.hh"
+#include "dev/storage/disk_image.hh"
 #include "mem/packet.hh"
 #include "mem/packet_access.hh"
 #include "params/UFSHostDevice.hh"
@@ -45,6 +45,7 @@
 
 #include "dev/dma_device.hh"
 
+#include <algorithm>
 #include <utility>
 
 #include "base/chunk_generator.hh"
@@ -57,9 +58,19 @@ DmaPort::DmaPort(MemObject *dev, System *s)
     : MasterPort(dev->name() + ".dma", dev),
       device(dev), sys(s), masterId(s->getMasterId(dev->name())),
       sendEvent([this]{ sendDma(); }, dev->name()),
-      pendingCount(0), inRetry(false)
+      pendingCount(0), inRetry(false),
+      bulk(false), bulkTicksPerByte(0), bulkLatency(0), bulkBusyUntil(0),
+      chunkSize(s->cacheLineSize())
 { }
 
+void
+DmaPort::enableBulkTransfers(double ticks_per_byte, Tick latency)
+{
+    bulk = true;
+    bulkTicksPerByte = ticks_per_byte;
+    bulkLatency = latency;
+}
+
 void
 DmaPort::handleResp(PacketPtr pkt, Tick delay)
 {
@@ -118,7 +129,13 @@ DmaPort::recvTimingResp(PacketPtr pkt)
 
 DmaDevice::DmaDevice(const Params *p)
     : PioDevice(p), dmaPort(this, sys)
-{ }
+{
+    if (p->bulk_dma)
+        dmaPort.enableBulkTransfers(p->bulk_dma_bandwidth,
+                                    p->bulk_dma_latency);
+    if (p->dma_chunk_size)
+        dmaPort.setChunkSize(p->dma_chunk_size);
+}
 
 void
 DmaDevice::init()
@@ -150,9 +167,12 @@ RequestPtr
 DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
                    uint8_t *data, Tick delay, Request::Flags flag)
 {
+    if (bulk && bulkDmaAction(cmd, addr, size, event, data, delay, flag))
+        return NULL;
+
     // one DMA request sender state for every action, that is then
-    // split into many requests and packets based on the block size,
-    // i.e. cache line size
+    // split into many requests and packets based on the chunk size,
+    // by default the cache line size
     DmaReqState *reqState = new DmaReqState(event, size, delay);
 
     // (functionality added for Table Walker statistics)
@@ -163,7 +183,7 @@ DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
 
     DPRINTF(DMA, "Starting DMA for addr: %#x size: %d sched: %d\n", addr, size,
             event ? event->scheduled() : -1);
-    for (ChunkGenerator gen(addr, size, sys->cacheLineSize());
+    for (ChunkGenerator gen(addr, size, chunkSize);
          !gen.done(); gen.next()) {
         req = new Request(gen.addr(), gen.size(), flag, masterId);
         req->taskId(ContextSwitchTaskId::DMA);
@@ -188,6 +208,39 @@ DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
     return req;
 }
 
+bool
+DmaPort::bulkDmaAction(Packet::Command cmd, Addr addr, int size,
+                       Event *event, uint8_t *data, Tick delay,
+                       Request::Flags flag)
+{
+    // Uncacheable accesses may have side effects and need real
+    // packets, as do commands other than plain reads and writes. Keep
+    // everything in order if packets are still in flight.
+    if (!data || (flag & Request::UNCACHEABLE) || pendingCount ||
+        (cmd != MemCmd::ReadReq && cmd != MemCmd::WriteReq))
+        return false;
+
+    PortProxy proxy(*this, sys->cacheLineSize());
+    if (cmd == MemCmd::ReadReq)
+        proxy.readBlob(addr, data, size);
+    else
+        proxy.writeBlob(addr, data, size);
+
+    // Transfers are serialized on the port, and each one pays a fixed
+    // latency on top of its transfer time.
+    const Tick start = std::max(curTick(), bulkBusyUntil);
+    bulkBusyUntil = start + (Tick)(size * bulkTicksPerByte);
+    const Tick when = bulkBusyUntil + bulkLatency + delay;
+
+    DPRINTF(DMA, "Bulk %s for addr: %#x size: %d done: %d\n",
+            cmd == MemCmd::ReadReq ? "read" : "write", addr, size, when);
+
+    if (event)
+        device->schedule(event, when);
+
+    return true;
+}
+
 void
 DmaPort::queueDma(PacketPtr pkt)
 {
@@ -132,6 +132,28 @@ class DmaPort : public MasterPort, public Drainable
      * send whatever it is that it's sending. */
     bool inRetry;
 
+    /** @{
+     * @name Bulk transfers
+     *
+     * In bulk mode, reads and writes are copied functionally in one
+     * go instead of being split into cache line sized packets, and
+     * the completion event is scheduled based on a simple bandwidth
+     * and latency model. This requires a memory system that can
+     * service functional accesses at any time.
+     */
+    /** Are bulk transfers enabled? */
+    bool bulk;
+    /** Time to transfer a byte in bulk mode */
+    double bulkTicksPerByte;
+    /** Fixed latency of a bulk transfer */
+    Tick bulkLatency;
+    /** Time at which the last bulk transfer leaves the port */
+    Tick bulkBusyUntil;
+    /** @} */
+
+    /** Largest packet a DMA action is split into */
+    unsigned chunkSize;
+
   protected:
 
     bool recvTimingResp(PacketPtr pkt) override;
@@ -139,6 +161,16 @@ class DmaPort : public MasterPort, public Drainable
 
     void queueDma(PacketPtr pkt);
 
+    /**
+     * Try to perform a DMA action as a bulk transfer.
+     *
+     * @return true if the transfer was handled, false if it has to go
+     * through the normal packet-based path.
+     */
+    bool bulkDmaAction(Packet::Command cmd, Addr addr, int size,
+                       Event *event, uint8_t *data, Tick delay,
+                       Request::Flags flag);
+
   public:
 
     DmaPort(MemObject *dev, System *s);
@@ -146,6 +178,21 @@ class DmaPort : public MasterPort, public Drainable
     RequestPtr dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
                          uint8_t *data, Tick delay, Request::Flags flag = 0);
 
+    /**
+     * Switch the port to bulk transfers.
+     *
+     * @param ticks_per_byte Inverse of the transfer bandwidth.
+     * @param latency Fixed latency added to every transfer.
+     */
+    void enableBulkTransfers(double ticks_per_byte, Tick latency);
+
+    /**
+     * Split DMA actions into packets of up to size bytes instead of
+     * cache lines. Only memory systems that accept packets spanning
+     * several lines, such as a Ruby DMA sequencer, can be used.
+     */
+    void setChunkSize(unsigned size) { chunkSize = size; }
+
     bool dmaPending() const { return pendingCount > 0; }
 
     DrainState drain() override;
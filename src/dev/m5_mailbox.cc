@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dev/m5_mailbox.hh"
+
+#include "base/callback.hh"
+#include "base/logging.hh"
+#include "debug/M5Mailbox.hh"
+#include "gem5/asm/generic/m5ops.h"
+#include "sim/pseudo_inst.hh"
+#include "sim/system.hh"
+
+M5Mailbox::M5Mailbox(const M5MailboxParams *p)
+    : SimpleMemory(p), system(p->system), numEntries(p->num_entries),
+      numCounters(p->num_counters), pollPeriod(p->poll_period),
+      pollEvent([this]{ poll(); }, name()),
+      counterBase(p->num_counters, 0)
+{
+    const uint64_t needed = sizeof(m5_mailbox_header) +
+        numEntries * sizeof(m5_mailbox_entry) + numCounters * sizeof(uint64_t);
+    fatal_if(range.size() < needed,
+             "%s: range of %d bytes is too small for %d entries and %d "
+             "counters (%d bytes)\n", name(), range.size(), numEntries,
+             numCounters, needed);
+    fatal_if(numEntries == 0, "%s: the ring needs at least one entry\n",
+             name());
+    fatal_if(pollPeriod == 0, "%s: poll_period must be non-zero\n", name());
+}
+
+void
+M5Mailbox::initState()
+{
+    SimpleMemory::initState();
+
+    fatal_if(!pmemAddr, "%s: the mailbox needs a backing store\n", name());
+    memset(pmemAddr, 0, range.size());
+
+    m5_mailbox_header *hdr = header();
+    hdr->magic = M5_MAILBOX_MAGIC;
+    hdr->version = M5_MAILBOX_VERSION;
+    hdr->num_entries = numEntries;
+    hdr->num_counters = numCounters;
+}
+
+void
+M5Mailbox::startup()
+{
+    SimpleMemory::startup();
+
+    Stats::registerDumpCallback(
+        new MakeCallback<M5Mailbox, &M5Mailbox::readCounters>(this, true));
+    Stats::registerResetCallback(
+        new MakeCallback<M5Mailbox, &M5Mailbox::resetCounters>(this, true));
+
+    schedule(pollEvent, curTick() + pollPeriod);
+}
+
+DrainState
+M5Mailbox::drain()
+{
+    // Run anything posted so far so that a checkpoint or CPU switch
+    // doesn't see markers from before it applied after it.
+    poll();
+    return SimpleMemory::drain();
+}
+
+void
+M5Mailbox::poll()
+{
+    m5_mailbox_header *hdr = header();
+    m5_mailbox_entry *ring = entries();
+
+    uint64_t tail = hdr->tail;
+    while (true) {
+        m5_mailbox_entry &entry = ring[tail % numEntries];
+        // The guest may be running concurrently on another thread
+        // under KVM; only trust the entry once its seq is published.
+        if (__atomic_load_n(&entry.seq, __ATOMIC_ACQUIRE) != tail + 1)
+            break;
+        process(entry);
+        ++tail;
+        __atomic_store_n(&hdr->tail, tail, __ATOMIC_RELEASE);
+    }
+
+    if (!pollEvent.scheduled())
+        schedule(pollEvent, curTick() + pollPeriod);
+}
+
+void
+M5Mailbox::process(const m5_mailbox_entry &entry)
+{
+    DPRINTF(M5Mailbox, "op %#x from context %d: %#x %#x\n", entry.op,
+            entry.context, entry.args[0], entry.args[1]);
+
+    ContextID ctx = entry.context;
+    if (ctx >= system->numContexts()) {
+        warn_once("%s: m5op posted by unknown context %d, using context 0\n",
+                  name(), ctx);
+        ctx = 0;
+    }
+    ThreadContext *tc = system->getThreadContext(ctx);
+
+    switch (entry.op) {
+      case M5OP_WORK_BEGIN:
+        PseudoInst::workbegin(tc, entry.args[0], entry.args[1]);
+        break;
+
+      case M5OP_WORK_END:
+        PseudoInst::workend(tc, entry.args[0], entry.args[1]);
+        break;
+
+      case M5OP_REGION_BEGIN:
+        PseudoInst::regionbegin(tc, entry.args[0]);
+        break;
+
+      case M5OP_REGION_END:
+        PseudoInst::regionend(tc, entry.args[0]);
+        break;
+
+      default:
+        warn_once("%s: m5op %#x can't be posted to the mailbox\n",
+                  name(), entry.op);
+        return;
+    }
+    ++opsProcessed;
+}
+
+void
+M5Mailbox::readCounters()
+{
+    const uint64_t *values = counters();
+    for (unsigned i = 0; i < numCounters; ++i) {
+        counterStats[i] =
+            __atomic_load_n(&values[i], __ATOMIC_RELAXED) - counterBase[i];
+    }
+}
+
+void
+M5Mailbox::resetCounters()
+{
+    const uint64_t *values = counters();
+    for (unsigned i = 0; i < numCounters; ++i)
+        counterBase[i] = __atomic_load_n(&values[i], __ATOMIC_RELAXED);
+}
+
+void
+M5Mailbox::regStats()
+{
+    SimpleMemory::regStats();
+
+    opsProcessed
+        .name(name() + ".opsProcessed")
+        .desc("Number of m5ops run from the mailbox")
+        ;
+
+    counterStats
+        .init(numCounters)
+        .name(name() + ".counters")
+        .desc("Guest counters updated through the mailbox")
+        .flags(Stats::nozero)
+        ;
+}
+
+M5Mailbox *
+M5MailboxParams::create()
+{
+    return new M5Mailbox(this);
+}
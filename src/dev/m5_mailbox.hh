@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DEV_M5_MAILBOX_HH__
+#define __DEV_M5_MAILBOX_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "gem5/m5_mailbox.h"
+#include "mem/simple_mem.hh"
+#include "params/M5Mailbox.hh"
+#include "sim/eventq.hh"
+
+class System;
+
+/**
+ * A memory holding an m5op ring and a set of counters, laid out as
+ * described in gem5/m5_mailbox.h. Guests post high-frequency m5ops
+ * (work and region markers) to the ring with plain stores, so they
+ * never trap into gem5, and gem5 runs them when it next polls the
+ * ring. The counters are read whenever stats are dumped.
+ */
+class M5Mailbox : public SimpleMemory
+{
+  public:
+    M5Mailbox(const M5MailboxParams *p);
+
+    void initState() override;
+    void startup() override;
+    DrainState drain() override;
+    void regStats() override;
+
+    /** Run every complete entry in the ring */
+    void poll();
+
+  private:
+    m5_mailbox_header *header() const
+    { return reinterpret_cast<m5_mailbox_header *>(pmemAddr); }
+
+    m5_mailbox_entry *entries() const
+    { return reinterpret_cast<m5_mailbox_entry *>(header() + 1); }
+
+    uint64_t *counters() const
+    { return reinterpret_cast<uint64_t *>(entries() + numEntries); }
+
+    void process(const m5_mailbox_entry &entry);
+
+    /** Copy the counters into the stats, relative to the last reset */
+    void readCounters();
+    void resetCounters();
+
+    System *system;
+    const unsigned numEntries;
+    const unsigned numCounters;
+    const Tick pollPeriod;
+
+    EventFunctionWrapper pollEvent;
+
+    /** Counter values at the last stats reset */
+    std::vector<uint64_t> counterBase;
+
+    Stats::Scalar opsProcessed;
+    Stats::Vector counterStats;
+};
+
+#endif // __DEV_M5_MAILBOX_HH__
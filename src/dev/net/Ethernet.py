@@ -59,6 +59,8 @@ class EtherLink(EtherObject):
     speed = Param.NetworkBandwidth('1Gbps', "link speed")
     dump = Param.EtherDump(NULL, "dump object")
 
+class DistTransport(Enum): vals = ['tcp', 'shm']
+
 class DistEtherLink(EtherObject):
     type = 'DistEtherLink'
     cxx_header = "dev/net/dist_etherlink.hh"
@@ -71,11 +73,18 @@ class DistEtherLink(EtherObject):
     dist_size = Param.UInt32('1', "Number of gem5 processes (dist run)")
     sync_start = Param.Latency('5200000000000t', "first dist sync barrier")
     sync_repeat = Param.Latency('10us', "dist sync barrier repeat")
+    adaptive_sync = Param.Bool(False, "Let gem5 peers run ahead of each "
+        "other by up to the link delay, which is then worth a sync_repeat "
+        "of a fraction of the delay")
     server_name = Param.String('localhost', "Message server name")
     server_port = Param.UInt32('2200', "Message server port")
     is_switch = Param.Bool(False, "true if this a link in etherswitch")
     dist_sync_on_pseudo_op = Param.Bool(False, "Start sync with pseudo_op")
     num_nodes = Param.UInt32('2', "Number of simulate nodes")
+    transport = Param.DistTransport('tcp', "Transport to the peer gem5 "
+        "processes, shm needs all of them on this host")
+    shm_ring_size = Param.MemorySize('4MB', "Size of each direction of a "
+        "shared memory link")
 
 class EtherBus(EtherObject):
     type = 'EtherBus'
@@ -111,6 +120,8 @@ if buildEnv['USE_TUNTAP']:
         tun_clone_device = Param.String('/dev/net/tun',
                                         "Path to the tun clone device node")
         tap_device_name = Param.String('gem5-tap', "Tap device name")
+        num_queues = Param.Unsigned(1, "Number of queues of the tap device, "
+            "more than one needs a multi-queue capable kernel")
 
 class EtherTapStub(EtherTapBase):
     type = 'EtherTapStub'
@@ -63,6 +63,7 @@
 #include "dev/net/etherlink.hh"
 #include "dev/net/etherobject.hh"
 #include "dev/net/etherpkt.hh"
+#include "dev/net/shm_iface.hh"
 #include "dev/net/tcp_iface.hh"
 #include "params/EtherLink.hh"
 #include "sim/core.hh"
@@ -83,7 +84,7 @@ DistEtherLink::DistEtherLink(const Params *p)
 
     Tick sync_repeat;
     if (p->sync_repeat != 0) {
-        if (p->sync_repeat != p->delay)
+        if (p->sync_repeat != p->delay && !p->adaptive_sync)
             warn("DistEtherLink(): sync_repeat is %lu and linkdelay is %lu",
                  p->sync_repeat, p->delay);
         sync_repeat = p->sync_repeat;
@@ -91,12 +92,20 @@ DistEtherLink::DistEtherLink(const Params *p)
         sync_repeat = p->delay;
     }
 
-    // create the dist (TCP) interface to talk to the peer gem5 processes.
-    distIface = new TCPIface(p->server_name, p->server_port,
-                             p->dist_rank, p->dist_size,
-                             p->sync_start, sync_repeat, this,
-                             p->dist_sync_on_pseudo_op, p->is_switch,
-                             p->num_nodes);
+    // create the dist interface to talk to the peer gem5 processes.
+    if (p->transport == Enums::shm) {
+        distIface = new ShmIface(p->server_port, p->shm_ring_size,
+                                 p->dist_rank, p->dist_size,
+                                 p->sync_start, sync_repeat, this,
+                                 p->dist_sync_on_pseudo_op, p->is_switch,
+                                 p->num_nodes);
+    } else {
+        distIface = new TCPIface(p->server_name, p->server_port,
+                                 p->dist_rank, p->dist_size,
+                                 p->sync_start, sync_repeat, this,
+                                 p->dist_sync_on_pseudo_op, p->is_switch,
+                                 p->num_nodes);
+    }
 
     localIface = new LocalIface(name() + ".int0", txLink, rxLink, distIface);
 }
@@ -140,7 +149,7 @@ void
 DistEtherLink::init()
 {
     DPRINTF(DistEthernet,"DistEtherLink::init() called\n");
-    distIface->init(rxLink->doneEvent(), linkDelay);
+    distIface->init(rxLink->doneEvent(), linkDelay, params()->adaptive_sync);
 }
 
 void
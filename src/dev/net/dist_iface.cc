@@ -43,6 +43,7 @@
 
 #include "dev/net/dist_iface.hh"
 
+#include <algorithm>
 #include <queue>
 #include <thread>
 
@@ -66,7 +67,7 @@ DistIface *DistIface::master = nullptr;
 bool DistIface::isSwitch = false;
 
 void
-DistIface::Sync::init(Tick start_tick, Tick repeat_tick)
+DistIface::Sync::init(Tick start_tick, Tick repeat_tick, Tick lookahead_tick)
 {
     if (start_tick < nextAt) {
         nextAt = start_tick;
@@ -81,13 +82,15 @@ DistIface::Sync::init(Tick start_tick, Tick repeat_tick)
         inform("Dist synchronisation interval is changed to %lu.\n",
                nextRepeat);
     }
+
+    if (lookahead_tick < lookahead)
+        lookahead = lookahead_tick;
 }
 
 void
 DistIface::Sync::abort()
 {
     std::unique_lock<std::mutex> sync_lock(lock);
-    waitNum = 0;
     isAbort = true;
     sync_lock.unlock();
     cv.notify_one();
@@ -96,21 +99,23 @@ DistIface::Sync::abort()
 DistIface::SyncSwitch::SyncSwitch(int num_nodes)
 {
     numNodes = num_nodes;
-    waitNum = num_nodes;
     numExitReq = 0;
     numCkptReq = 0;
     numStopSyncReq = 0;
+    numAcked = 0;
     doExit = false;
     doCkpt = false;
     doStopSync = false;
     nextAt = std::numeric_limits<Tick>::max();
     nextRepeat = std::numeric_limits<Tick>::max();
+    lookahead = std::numeric_limits<Tick>::max();
+    round = 0;
+    numCompleted = 0;
     isAbort = false;
 }
 
 DistIface::SyncNode::SyncNode()
 {
-    waitNum = 0;
     needExit = ReqType::none;
     needCkpt = ReqType::none;
     needStopSync = ReqType::none;
@@ -119,22 +124,32 @@ DistIface::SyncNode::SyncNode()
     doStopSync = false;
     nextAt = std::numeric_limits<Tick>::max();
     nextRepeat = std::numeric_limits<Tick>::max();
+    lookahead = std::numeric_limits<Tick>::max();
+    round = 0;
+    numCompleted = 0;
     isAbort = false;
 }
 
 bool
-DistIface::SyncNode::run(bool same_tick)
+DistIface::SyncNode::acked(uint64_t r) const
+{
+    auto it = acks.find(r);
+    return it != acks.end() && it->second.count == DistIface::recvThreadsNum;
+}
+
+bool
+DistIface::SyncNode::run(bool same_tick, unsigned ahead)
 {
     std::unique_lock<std::mutex> sync_lock(lock);
     Header header;
 
-    assert(waitNum == 0);
     assert(!isAbort);
-    waitNum = DistIface::recvThreadsNum;
     // initiate the global synchronisation
     header.msgType = MsgType::cmdSyncReq;
     header.sendTick = curTick();
     header.syncRepeat = nextRepeat;
+    header.syncRound = round++;
+    header.syncLookahead = lookahead;
     header.needCkpt = needCkpt;
     header.needStopSync = needStopSync;
     if (needCkpt != ReqType::none)
@@ -145,61 +160,126 @@ DistIface::SyncNode::run(bool same_tick)
     if (needStopSync != ReqType::none)
         needStopSync = ReqType::pending;
     DistIface::master->sendCmd(header);
-    // now wait until all receiver threads complete the synchronisation
-    auto lf = [this]{ return waitNum == 0; };
-    cv.wait(sync_lock, lf);
+
+    // Now complete the rounds we have to wait for, in order. Each of them
+    // is complete when all receiver threads have got its ack.
+    doCkpt = false;
+    doExit = false;
+    doStopSync = false;
+    while (numCompleted + ahead < round) {
+        auto lf = [this]{ return isAbort || acked(numCompleted); };
+        cv.wait(sync_lock, lf);
+        if (isAbort)
+            return false;
+        auto it = acks.find(numCompleted++);
+        nextAt = it->second.nextAt;
+        nextRepeat = it->second.nextRepeat;
+        lookahead = it->second.lookahead;
+        doCkpt |= it->second.doCkpt;
+        doExit |= it->second.doExit;
+        doStopSync |= it->second.doStopSync;
+        acks.erase(it);
+        // The receiver threads do not get any further acks.
+        if (doExit)
+            break;
+    }
     // global synchronisation is done.
-    assert(isAbort || !same_tick || (nextAt == curTick()));
-    return !isAbort;
+    assert(!same_tick || ahead > 0 || (nextAt == curTick()));
+    return true;
 }
 
-
 bool
-DistIface::SyncSwitch::run(bool same_tick)
+DistIface::SyncSwitch::requested(uint64_t r) const
+{
+    auto it = rounds.find(r);
+    return it != rounds.end() && it->second.count == numNodes;
+}
+
+void
+DistIface::SyncSwitch::sendAck(Round &r)
 {
-    std::unique_lock<std::mutex> sync_lock(lock);
     Header header;
-    // Wait for the sync requests from the nodes
-    if (waitNum > 0) {
-        auto lf = [this]{ return waitNum == 0; };
-        cv.wait(sync_lock, lf);
-    }
-    assert(waitNum == 0);
-    if (isAbort) // sync aborted
-        return false;
-    assert(!same_tick || (nextAt == curTick()));
-    waitNum = numNodes;
-    // Complete the global synchronisation
+
+    // Requests from the nodes are counted in round order, so all the
+    // peers see the same ack for the same round.
+    numCkptReq += r.numCkptReq;
+    numExitReq += r.numExitReq;
+    numStopSyncReq += r.numStopSyncReq;
+    r.nextAt = std::max(r.nextAt, nextAt);
+    r.nextRepeat = std::min(r.nextRepeat, nextRepeat);
+    r.lookahead = std::min(r.lookahead, lookahead);
+
     header.msgType = MsgType::cmdSyncAck;
-    header.sendTick = nextAt;
-    header.syncRepeat = nextRepeat;
-    if (doCkpt || numCkptReq == numNodes) {
-        doCkpt = true;
+    header.sendTick = r.nextAt;
+    header.syncRepeat = r.nextRepeat;
+    header.syncRound = numAcked++;
+    header.syncLookahead = r.lookahead;
+    if (r.doCkpt || numCkptReq == numNodes) {
+        r.doCkpt = true;
         header.needCkpt = ReqType::immediate;
         numCkptReq = 0;
     } else {
         header.needCkpt = ReqType::none;
     }
-    if (doExit || numExitReq == numNodes) {
-        doExit = true;
+    if (r.doExit || numExitReq == numNodes) {
+        r.doExit = true;
         header.needExit = ReqType::immediate;
     } else {
         header.needExit = ReqType::none;
     }
-    if (doStopSync || numStopSyncReq == numNodes) {
-        doStopSync = true;
+    if (r.doStopSync || numStopSyncReq == numNodes) {
+        r.doStopSync = true;
         numStopSyncReq = 0;
         header.needStopSync = ReqType::immediate;
     } else {
         header.needStopSync = ReqType::none;
     }
     DistIface::master->sendCmd(header);
+}
+
+bool
+DistIface::SyncSwitch::run(bool same_tick, unsigned ahead)
+{
+    std::unique_lock<std::mutex> sync_lock(lock);
+
+    assert(!isAbort);
+    // We have reached a new round
+    round++;
+    doCkpt = false;
+    doExit = false;
+    doStopSync = false;
+    for (;;) {
+        // Ack every round that all the nodes (and we) have reached
+        while (numAcked < round && requested(numAcked))
+            sendAck(rounds[numAcked]);
+        // Complete the acked rounds we have to wait for, in order
+        while (numCompleted < numAcked && numCompleted + ahead < round) {
+            auto it = rounds.find(numCompleted++);
+            nextAt = it->second.nextAt;
+            nextRepeat = it->second.nextRepeat;
+            lookahead = it->second.lookahead;
+            doCkpt |= it->second.doCkpt;
+            doExit |= it->second.doExit;
+            doStopSync |= it->second.doStopSync;
+            rounds.erase(it);
+        }
+        if (numCompleted + ahead >= round || doExit)
+            break;
+        // Wait for the sync requests from the nodes
+        auto lf = [this]{ return isAbort || requested(numAcked); };
+        cv.wait(sync_lock, lf);
+        if (isAbort) // sync aborted
+            return false;
+    }
+    assert(!same_tick || ahead > 0 || (nextAt == curTick()));
     return true;
 }
 
 bool
-DistIface::SyncSwitch::progress(Tick send_tick,
+DistIface::SyncSwitch::progress(uint64_t r,
+                                 Tick send_tick,
                                  Tick sync_repeat,
+                                 Tick lookahead_tick,
                                  ReqType need_ckpt,
                                  ReqType need_exit,
                                  ReqType need_stop_sync)
@@ -207,29 +287,36 @@ DistIface::SyncSwitch::progress(Tick send_tick,
     std::unique_lock<std::mutex> sync_lock(lock);
     if (isAbort) // sync aborted
         return false;
-    assert(waitNum > 0);
+    assert(r >= numAcked);
 
-    if (send_tick > nextAt)
-        nextAt = send_tick;
-    if (nextRepeat > sync_repeat)
-        nextRepeat = sync_repeat;
+    Round &req = rounds[r];
+    if (req.count == 0) {
+        req.nextAt = send_tick;
+        req.nextRepeat = sync_repeat;
+        req.lookahead = lookahead_tick;
+    } else {
+        req.nextAt = std::max(req.nextAt, send_tick);
+        req.nextRepeat = std::min(req.nextRepeat, sync_repeat);
+        req.lookahead = std::min(req.lookahead, lookahead_tick);
+    }
 
     if (need_ckpt == ReqType::collective)
-        numCkptReq++;
+        req.numCkptReq++;
     else if (need_ckpt == ReqType::immediate)
-        doCkpt = true;
+        req.doCkpt = true;
     if (need_exit == ReqType::collective)
-        numExitReq++;
+        req.numExitReq++;
     else if (need_exit == ReqType::immediate)
-        doExit = true;
+        req.doExit = true;
     if (need_stop_sync == ReqType::collective)
-        numStopSyncReq++;
+        req.numStopSyncReq++;
     else if (need_stop_sync == ReqType::immediate)
-        doStopSync = true;
+        req.doStopSync = true;
 
-    waitNum--;
-    // Notify the simulation thread if the on-going sync is complete
-    if (waitNum == 0) {
+    req.count++;
+    assert(req.count <= numNodes);
+    // Notify the simulation thread if all requests for the round are in
+    if (req.count == numNodes) {
         sync_lock.unlock();
         cv.notify_one();
     }
@@ -239,8 +326,10 @@ DistIface::SyncSwitch::progress(Tick send_tick,
 }
 
 bool
-DistIface::SyncNode::progress(Tick max_send_tick,
+DistIface::SyncNode::progress(uint64_t r,
+                               Tick max_send_tick,
                                Tick next_repeat,
+                               Tick lookahead_tick,
                                ReqType do_ckpt,
                                ReqType do_exit,
                                ReqType do_stop_sync)
@@ -248,22 +337,25 @@ DistIface::SyncNode::progress(Tick max_send_tick,
     std::unique_lock<std::mutex> sync_lock(lock);
     if (isAbort) // sync aborted
         return false;
-    assert(waitNum > 0);
-
-    nextAt = max_send_tick;
-    nextRepeat = next_repeat;
-    doCkpt = (do_ckpt != ReqType::none);
-    doExit = (do_exit != ReqType::none);
-    doStopSync = (do_stop_sync != ReqType::none);
-
-    waitNum--;
-    // Notify the simulation thread if the on-going sync is complete
-    if (waitNum == 0) {
+    assert(r >= numCompleted);
+
+    Ack &ack = acks[r];
+    ack.nextAt = max_send_tick;
+    ack.nextRepeat = next_repeat;
+    ack.lookahead = lookahead_tick;
+    ack.doCkpt = (do_ckpt != ReqType::none);
+    ack.doExit = (do_exit != ReqType::none);
+    ack.doStopSync = (do_stop_sync != ReqType::none);
+    bool do_exit_now = ack.doExit;
+
+    ack.count++;
+    // Notify the simulation thread if all receiver threads got the ack
+    if (ack.count == DistIface::recvThreadsNum) {
         sync_lock.unlock();
         cv.notify_one();
     }
     // The receive thread must finish when simulation is about to exit
-    return !doExit;
+    return !do_exit_now;
 }
 
 void
@@ -296,7 +388,7 @@ DistIface::Sync::drainComplete()
         // checkpoint. We need to drain the underlying physical network here.
         // Note that other gem5 peers may enter this barrier at different
         // ticks due to draining.
-        run(false);
+        run(false, 0);
         // Only the "first" DistIface object has to perform the sync
         doCkpt = false;
     }
@@ -340,7 +432,7 @@ DistIface::SyncEvent::start()
     repeat = DistIface::sync->nextRepeat;
     // Do a global barrier to agree on a common repeat value (the smallest
     // one from all participating nodes.
-    if (!DistIface::sync->run(false))
+    if (!DistIface::sync->run(false, 0))
         panic("DistIface::SyncEvent::start() aborted\n");
 
     assert(!DistIface::sync->doCkpt);
@@ -361,6 +453,15 @@ DistIface::SyncEvent::start()
 
     inform("Dist sync scheduled at %lu and repeats %lu\n",  when(),
            DistIface::sync->nextRepeat);
+
+    // With adaptive sync, any message a peer sends after it has reached a
+    // barrier arrives at least a lookahead later, so we only have to
+    // complete the barrier from that far back before going on. All the
+    // peers agree on the same window here.
+    window = std::max<Tick>(1, DistIface::sync->lookahead /
+                            DistIface::sync->nextRepeat);
+    if (window > 1)
+        inform("Dist sync runs ahead by up to %u periods\n", window);
 }
 
 void
@@ -393,7 +494,7 @@ DistIface::SyncEvent::process()
         EventQueue::ScopedRelease sr(curEventQueue());
         // we do a global sync here that is supposed to happen at the same
         // tick in all gem5 peers
-        if (!DistIface::sync->run(true))
+        if (!DistIface::sync->run(true, window - 1))
             return; // global sync aborted
         // global sync completed
     }
@@ -506,11 +607,14 @@ DistIface::RecvScheduler::pushPacket(EthPacketPtr new_packet,
     DPRINTF(DistEthernetPkt, "DistIface::recvScheduler::pushPacket "
             "send_tick:%llu send_delay:%llu link_delay:%llu recv_tick:%llu\n",
             send_tick, send_delay, linkDelay, recv_tick);
-    // Every packet must be sent and arrive in the same quantum
-    assert(send_tick > master->syncEvent->when() -
-           master->syncEvent->repeat);
+    // Every packet must be sent and arrive in the same quantum, unless the
+    // peers may run ahead of each other (calcReceiveTick() still checks that
+    // we have not missed the receive tick).
+    assert(master->syncEvent->window > 1 ||
+           send_tick > master->syncEvent->when() - master->syncEvent->repeat);
     // No packet may be scheduled for receive in the arrival quantum
-    assert(send_tick + send_delay + linkDelay > master->syncEvent->when());
+    assert(master->syncEvent->window > 1 ||
+           send_tick + send_delay + linkDelay > master->syncEvent->when());
 
     // Now we are about to schedule a recvDone event for the new data packet.
     // We use the same recvDone object for all incoming data packets. Packet
@@ -704,8 +808,10 @@ DistIface::recvThreadFunc(Event *recv_done, Tick link_delay)
                                      header.sendDelay);
         } else {
             // everything else must be synchronisation related command
-            if (!sync->progress(header.sendTick,
+            if (!sync->progress(header.syncRound,
+                                header.sendTick,
                                 header.syncRepeat,
+                                header.syncLookahead,
                                 header.needCkpt,
                                 header.needExit,
                                 header.needStopSync))
@@ -784,7 +890,7 @@ DistIface::unserialize(CheckpointIn &cp)
 }
 
 void
-DistIface::init(const Event *done_event, Tick link_delay)
+DistIface::init(const Event *done_event, Tick link_delay, bool adaptive_sync)
 {
     // Init hook for the underlaying message transport to setup/finalize
     // communication channels
@@ -799,9 +905,9 @@ DistIface::init(const Event *done_event, Tick link_delay)
 
     // Adjust the periodic sync start and interval. Different DistIface
     // might have different requirements. The singleton sync object
-    // will select the minimum values for both params.
+    // will select the minimum values for all params.
     assert(sync != nullptr);
-    sync->init(syncStart, syncRepeat);
+    sync->init(syncStart, syncRepeat, adaptive_sync ? link_delay : 0);
 
     // Initialize the seed for random generator to avoid the same sequence
     // in all gem5 peer processes
@@ -67,17 +67,25 @@
  * is that no gem5 process can go ahead further than the simulated link
  * transmission delay to ensure that a corresponding receive event can always
  * be scheduled for any message coming in from a peer gem5 process.
+ * With adaptive sync, the barrier is split into sync rounds that are
+ * sync_repeat apart and pipelined: a gem5 process only waits for the round
+ * that lies a full link delay behind, so peers may run ahead of each other
+ * as long as they stay within the link delay (which is the earliest any of
+ * their future messages can arrive).
  *
  *
  *
  * This interface is an abstract class. It can work with various low level
  * send/receive service implementations (e.g. TCP/IP, MPI,...). A TCP
- * stream socket version is implemented in src/dev/net/tcp_iface.[hh,cc].
+ * stream socket version is implemented in src/dev/net/tcp_iface.[hh,cc],
+ * and a shared memory version for peers on the same host in
+ * src/dev/net/shm_iface.[hh,cc].
  */
 #ifndef __DEV_DIST_IFACE_HH__
 #define __DEV_DIST_IFACE_HH__
 
 #include <array>
+#include <map>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -128,11 +136,6 @@ class DistIface : public Drainable, public Serializable
          * synchronisation.
          */
         std::condition_variable cv;
-        /**
-         * Number of receiver threads that not yet completed the current global
-         * synchronisation.
-         */
-        unsigned waitNum;
         /**
          * Flag is set if exit is permitted upon sync completion
          */
@@ -153,6 +156,21 @@ class DistIface : public Drainable, public Serializable
          * Tick for the next periodic sync (if the event is not scheduled yet)
          */
         Tick nextAt;
+        /**
+         * How far gem5 peers may run ahead of the last completed sync
+         * round, i.e. the smallest link delay if adaptive sync is enabled
+         * on all links, zero otherwise.
+         */
+        Tick lookahead;
+        /**
+         * Sequence number of the next sync round started by this process.
+         * Every gem5 peer goes through the same sequence of sync rounds.
+         */
+        uint64_t round;
+        /**
+         * Number of sync rounds completed (in order) by this process.
+         */
+        uint64_t numCompleted;
         /**
          *  Flag is set if the sync is aborted (e.g. due to connection lost)
          */
@@ -166,23 +184,32 @@ class DistIface : public Drainable, public Serializable
          *
          * @param start Start tick for dist synchronisation
          * @param repeat Frequency of dist synchronisation
+         * @param lookahead Lookahead for adaptive sync (zero to disable)
          *
          */
-        void init(Tick start, Tick repeat);
+        void init(Tick start, Tick repeat, Tick lookahead);
         /**
-         *  Core method to perform a full dist sync.
+         *  Core method to perform a dist sync. This starts a new sync
+         *  round and completes the pending ones up to the given distance
+         *  from the new round.
          *
+         * @param same_tick True if all peers start this round at the same
+         * tick
+         * @param ahead Number of the most recent rounds (including the new
+         * one) that may be left pending, zero for a full dist sync
          * @return true if the sync completes, false if it gets aborted
          */
-        virtual bool run(bool same_tick) = 0;
+        virtual bool run(bool same_tick, unsigned ahead) = 0;
         /**
-         * Callback when the receiver thread gets a sync ack message.
+         * Callback when the receiver thread gets a sync message.
          *
          * @return false if the receiver thread needs to stop (e.g.
          * simulation is to exit)
          */
-        virtual bool progress(Tick send_tick,
+        virtual bool progress(uint64_t round,
+                              Tick send_tick,
                               Tick next_repeat,
+                              Tick lookahead,
                               ReqType do_ckpt,
                               ReqType do_exit,
                               ReqType do_stop_sync) = 0;
@@ -218,13 +245,39 @@ class DistIface : public Drainable, public Serializable
          */
         ReqType needStopSync;
 
+        /**
+         * Sync ack of a round as seen by the receiver threads.
+         */
+        struct Ack
+        {
+            /**
+             * Number of receiver threads that got this ack
+             */
+            unsigned count;
+            Tick nextAt;
+            Tick nextRepeat;
+            Tick lookahead;
+            bool doCkpt;
+            bool doExit;
+            bool doStopSync;
+        };
+        /**
+         * Sync acks of the rounds not completed yet, by round.
+         */
+        std::map<uint64_t, Ack> acks;
+
+        /** Have all the receiver threads got the ack of a round? */
+        bool acked(uint64_t round) const;
+
       public:
 
         SyncNode();
         ~SyncNode() {}
-        bool run(bool same_tick) override;
-        bool progress(Tick max_req_tick,
+        bool run(bool same_tick, unsigned ahead) override;
+        bool progress(uint64_t round,
+                      Tick max_req_tick,
                       Tick next_repeat,
+                      Tick lookahead,
                       ReqType do_ckpt,
                       ReqType do_exit,
                       ReqType do_stop_sync) override;
@@ -257,13 +310,48 @@ class DistIface : public Drainable, public Serializable
          */
         unsigned numNodes;
 
+        /**
+         * Sync requests of a round from the nodes, and the resulting ack.
+         */
+        struct Round
+        {
+            /**
+             * Number of nodes that have sent their request
+             */
+            unsigned count;
+            Tick nextAt;
+            Tick nextRepeat;
+            Tick lookahead;
+            unsigned numCkptReq;
+            unsigned numExitReq;
+            unsigned numStopSyncReq;
+            bool doCkpt;
+            bool doExit;
+            bool doStopSync;
+        };
+        /**
+         * Rounds not completed yet by the switch, by round.
+         */
+        std::map<uint64_t, Round> rounds;
+        /**
+         * Number of rounds acked to the nodes so far.
+         */
+        uint64_t numAcked;
+
+        /** Have all the nodes sent their request for a round? */
+        bool requested(uint64_t round) const;
+        /** Send the ack of the oldest round not acked yet. */
+        void sendAck(Round &r);
+
       public:
         SyncSwitch(int num_nodes);
         ~SyncSwitch() {}
 
-        bool run(bool same_tick) override;
-        bool progress(Tick max_req_tick,
+        bool run(bool same_tick, unsigned ahead) override;
+        bool progress(uint64_t round,
+                      Tick max_req_tick,
                       Tick next_repeat,
+                      Tick lookahead,
                       ReqType do_ckpt,
                       ReqType do_exit,
                       ReqType do_stop_sync) override;
@@ -293,6 +381,9 @@ class DistIface : public Drainable, public Serializable
      * for each simulated Ethernet link.
      * 3. Simulation thread(s) then waits until all receiver threads
      * complete the ongoing barrier. The global sync event is done.
+     *
+     * With adaptive sync, step 3 only waits for the barrier started
+     * window - 1 periods earlier.
      */
     class SyncEvent : public GlobalSyncEvent
     {
@@ -302,11 +393,18 @@ class DistIface : public Drainable, public Serializable
          */
         bool _draining;
       public:
+        /**
+         * Number of sync periods this process may run ahead of the last
+         * completed barrier (1 means lock-step).
+         */
+        unsigned window;
         /**
          * Only the firstly instantiated DistIface object will
          * call this constructor.
          */
-        SyncEvent() : GlobalSyncEvent(Sim_Exit_Pri, 0), _draining(false) {}
+        SyncEvent()
+            : GlobalSyncEvent(Sim_Exit_Pri, 0), _draining(false), window(1)
+        {}
 
         ~SyncEvent() {}
         /**
@@ -601,7 +699,13 @@ class DistIface : public Drainable, public Serializable
 
     DrainState drain() override;
     void drainResume() override;
-    void init(const Event *e, Tick link_delay);
+    /**
+     * @param e The receive done event of the simulated link
+     * @param link_delay The delay of the simulated link
+     * @param adaptive_sync Let the peers run ahead of each other by up to
+     * the link delay
+     */
+    void init(const Event *e, Tick link_delay, bool adaptive_sync);
     void startup();
 
     void serialize(CheckpointOut &cp) const override;
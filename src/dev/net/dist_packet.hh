@@ -105,6 +105,17 @@ class DistHeaderPkt
                 ReqType needCkpt;
                 ReqType needStopSync;
                 ReqType needExit;
+                /**
+                 * Sequence number of the sync round a sync request or
+                 * ack belongs to.
+                 */
+                uint64_t syncRound;
+                /**
+                 * How far the sender lets its peers run ahead of the
+                 * last completed sync round (zero if adaptive sync is
+                 * disabled).
+                 */
+                Tick syncLookahead;
             };
         };
     };
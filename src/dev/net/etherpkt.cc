@@ -55,9 +55,11 @@ EthPacketData::unserialize(const string &base, CheckpointIn &cp)
     if (optParamIn(cp, base + ".bufLength", chkpt_buf_length)) {
         // If bufLength is in the checkpoint, make sure that the current buffer
         // is unallocated or that the checkpoint requested size is smaller than
-        // the current buffer.
+        // the current buffer (which we keep, as its size is needed to free
+        // it).
         assert(!data || chkpt_buf_length <= bufLength);
-        bufLength = chkpt_buf_length;
+        if (!data)
+            bufLength = chkpt_buf_length;
     } else {
         // If bufLength is not in the checkpoint, try to use the existing
         // buffer or use length to size the buffer
@@ -66,7 +68,7 @@ EthPacketData::unserialize(const string &base, CheckpointIn &cp)
     }
     assert(length <= bufLength);
     if (!data)
-        data = new uint8_t[bufLength];
+        allocData();
     arrayParamIn(cp, base + ".data", data, length);
     if (!optParamIn(cp, base + ".simLength", simLength))
         simLength = length;
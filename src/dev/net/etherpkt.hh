@@ -40,6 +40,7 @@
 #include <iosfwd>
 #include <memory>
 
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "sim/serialize.hh"
 
@@ -48,7 +49,17 @@
  */
 class EthPacketData
 {
+  private:
+    struct DataTag {};
+
   public:
+    /**
+     * Data buffers are allocated from a thread-local free-list pool (see
+     * PoolAllocator), since NICs allocate a full-sized buffer for every
+     * packet they send.
+     */
+    typedef PoolAllocator<DataTag, 16384, 64> DataPool;
+
     /**
      * Pointer to packet data will be deleted
      */
@@ -73,18 +84,48 @@ class EthPacketData
      */
     unsigned simLength;
 
+    /**
+     * Is the data buffer allocated from the pool? Buffers filled by
+     * threads other than the simulation thread (e.g., dist-gem5 receiver
+     * threads) must not be, as they would end up on the free list of the
+     * simulation thread and never be reused.
+     */
+    const bool pooled;
+
     EthPacketData()
-        : data(nullptr), bufLength(0), length(0), simLength(0)
+        : data(nullptr), bufLength(0), length(0), simLength(0), pooled(true)
     { }
 
-    explicit EthPacketData(unsigned size)
-        : data(new uint8_t[size]), bufLength(size), length(0), simLength(0)
-    { }
+    explicit EthPacketData(unsigned size, bool use_pool = true)
+        : data(nullptr), bufLength(size), length(0), simLength(0),
+          pooled(use_pool)
+    {
+        allocData();
+    }
 
-    ~EthPacketData() { if (data) delete [] data; }
+    ~EthPacketData()
+    {
+        if (!data)
+            return;
+        if (pooled)
+            DataPool::deallocate(data, bufLength);
+        else
+            delete [] data;
+    }
 
     void serialize(const std::string &base, CheckpointOut &cp) const;
     void unserialize(const std::string &base, CheckpointIn &cp);
+
+  private:
+    /** Allocate a data buffer of bufLength bytes. */
+    void
+    allocData()
+    {
+        if (pooled)
+            data = static_cast<uint8_t *>(DataPool::allocate(bufLength));
+        else
+            data = new uint8_t[bufLength];
+    }
 };
 
 typedef std::shared_ptr<EthPacketData> EthPacketPtr;
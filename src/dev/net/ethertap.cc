@@ -53,8 +53,10 @@
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <cerrno>
 #include <cstring>
 #include <deque>
 #include <string>
@@ -186,6 +188,12 @@ EtherTapBase::sendSimulated(void *data, size_t len)
     packet->simLength = len;
     memcpy(packet->data, data, len);
 
+    sendSimulated(packet);
+}
+
+void
+EtherTapBase::sendSimulated(EthPacketPtr packet)
+{
     DPRINTF(Ethernet, "EtherTap real->sim len=%d\n", packet->length);
     DDUMP(EthernetData, packet->data, packet->length);
     if (!packetBuffer.empty() || !interface->sendPacket(packet)) {
@@ -385,11 +393,14 @@ EtherTapStub::recvReal(int revent)
 bool
 EtherTapStub::sendReal(const void *data, size_t len)
 {
+    // Send the length and the frame with a single system call.
     uint32_t frame_len = htonl(len);
-    ssize_t ret = write(socket, &frame_len, sizeof(frame_len));
-    if (ret != sizeof(frame_len))
-        return false;
-    return write(socket, data, len) == len;
+    struct iovec iov[2];
+    iov[0].iov_base = &frame_len;
+    iov[0].iov_len = sizeof(frame_len);
+    iov[1].iov_base = const_cast<void *>(data);
+    iov[1].iov_len = len;
+    return writev(socket, iov, 2) == (ssize_t)(sizeof(frame_len) + len);
 }
 
 
@@ -397,27 +408,48 @@ EtherTapStub::sendReal(const void *data, size_t len)
 
 EtherTap::EtherTap(const Params *p) : EtherTapBase(p)
 {
-    int fd = open(p->tun_clone_device.c_str(), O_RDWR);
-    if (fd < 0)
-        panic("Couldn't open %s.\n", p->tun_clone_device);
-
-    struct ifreq ifr;
-    memset(&ifr, 0, sizeof(ifr));
-    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
-    strncpy(ifr.ifr_name, p->tap_device_name.c_str(), IFNAMSIZ - 1);
-
-    if (ioctl(fd, TUNSETIFF, (void *)&ifr) < 0)
-        panic("Failed to access tap device %s.\n", ifr.ifr_name);
-    // fd now refers to the tap device.
-    tap = fd;
-    pollFd(tap);
+    fatal_if(p->num_queues == 0, "%s: A tap device needs a queue.\n",
+             name());
+
+    // Each queue of a multi-queue tap device is attached by opening the
+    // clone device again with the same name.
+    for (unsigned q = 0; q < p->num_queues; ++q) {
+        int fd = open(p->tun_clone_device.c_str(), O_RDWR);
+        if (fd < 0)
+            panic("Couldn't open %s.\n", p->tun_clone_device);
+
+        struct ifreq ifr;
+        memset(&ifr, 0, sizeof(ifr));
+        ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+        if (p->num_queues > 1)
+            ifr.ifr_flags |= IFF_MULTI_QUEUE;
+        strncpy(ifr.ifr_name, p->tap_device_name.c_str(), IFNAMSIZ - 1);
+
+        if (ioctl(fd, TUNSETIFF, (void *)&ifr) < 0)
+            panic("Failed to access tap device %s.\n", ifr.ifr_name);
+        // fd now refers to a queue of the tap device. Make it non-blocking
+        // so that we can read frames until it is empty.
+        if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0)
+            panic("Failed to make tap device %s non-blocking.\n",
+                  ifr.ifr_name);
+        taps.push_back(fd);
+    }
+
+    pollFd(taps[0]);
+    for (unsigned q = 1; q < taps.size(); ++q) {
+        queueEvents.push_back(new TapEvent(this, taps[q], POLLIN|POLLERR));
+        pollQueue.schedule(queueEvents.back());
+    }
 }
 
 EtherTap::~EtherTap()
 {
     stopPolling();
-    close(tap);
-    tap = -1;
+    for (auto event : queueEvents)
+        delete event;
+    for (auto fd : taps)
+        close(fd);
+    taps.clear();
 }
 
 void
@@ -429,17 +461,31 @@ EtherTap::recvReal(int revent)
     if (!(revent & POLLIN))
         return;
 
-    ssize_t ret = read(tap, buffer, buflen);
-    if (ret < 0)
-        panic("Failed to read from tap device.\n");
-
-    sendSimulated(buffer, ret);
+    // We only get notified when new frames arrive, so read all the frames
+    // that are pending in any of the queues, straight into the packets.
+    for (auto fd : taps) {
+        for (;;) {
+            EthPacketPtr packet = make_shared<EthPacketData>(buflen);
+            ssize_t ret = read(fd, packet->data, buflen);
+            if (ret < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+                panic("Failed to read from tap device.\n");
+            }
+
+            packet->length = ret;
+            packet->simLength = ret;
+            sendSimulated(packet);
+        }
+    }
 }
 
 bool
 EtherTap::sendReal(const void *data, size_t len)
 {
-    if (write(tap, data, len) != len)
+    // The kernel processes the frame in this system call, so writing all
+    // frames to the same queue keeps them in order.
+    if (write(taps[0], data, len) != len)
         panic("Failed to write data to tap device.\n");
     return true;
 }
@@ -37,6 +37,7 @@
 
 #include <queue>
 #include <string>
+#include <vector>
 
 #include "base/pollevent.hh"
 #include "config/use_tuntap.hh"
@@ -105,6 +106,7 @@ class EtherTapBase : public EtherObject
 
     bool recvSimulated(EthPacketPtr packet);
     void sendSimulated(void *data, size_t len);
+    void sendSimulated(EthPacketPtr packet);
 
   protected:
     std::queue<EthPacketPtr> packetBuffer;
@@ -185,7 +187,16 @@ class EtherTap : public EtherTapBase
 
 
   protected:
-    int tap;
+    /**
+     * File descriptors of the queues of the tap device. Frames are
+     * written to the first one, and read from all of them.
+     */
+    std::vector<int> taps;
+    /**
+     * Poll events of the queues after the first one, which is polled by
+     * EtherTapBase.
+     */
+    std::vector<TapEvent *> queueEvents;
 
     void recvReal(int revent) override;
     bool sendReal(const void *data, size_t len) override;
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Shared memory based interface class implementation for dist-gem5 runs.
+ */
+
+#include "dev/net/shm_iface.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include "base/cprintf.hh"
+#include "base/types.hh"
+#include "debug/DistEthernet.hh"
+#include "debug/DistEthernetCmd.hh"
+#include "sim/sim_exit.hh"
+
+using namespace std;
+
+vector<ShmIface *> ShmIface::registry;
+
+namespace {
+
+/**
+ * Sleep until word no longer holds val, or a spurious wake up. The
+ * segments are shared between processes, so the futexes can't be
+ * private. Other hosts fall back to yielding.
+ */
+void
+futexWait(atomic<uint32_t> &word, uint32_t val)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, val,
+            nullptr, nullptr, 0);
+#else
+    if (word.load() == val)
+        this_thread::yield();
+#endif
+}
+
+void
+futexWake(atomic<uint32_t> &word)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE,
+            INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+} // anonymous namespace
+
+ShmIface::ShmIface(unsigned server_port, uint64_t ring_size,
+                   unsigned dist_rank, unsigned dist_size,
+                   Tick sync_start, Tick sync_repeat,
+                   EventManager *em, bool use_pseudo_op, bool is_switch,
+                   int num_nodes) :
+    DistIface(dist_rank, dist_size, sync_start, sync_repeat, em, use_pseudo_op,
+              is_switch, num_nodes), ringSize(ring_size), seg(nullptr),
+    segSize(0), txRing(nullptr), rxRing(nullptr), txData(nullptr),
+    rxData(nullptr), serverPort(server_port), isSwitch(is_switch),
+    detached(false)
+{
+    panic_if(ring_size == 0 || ring_size > UINT32_MAX,
+             "Invalid shared memory ring size %d", ring_size);
+}
+
+ShmIface::~ShmIface()
+{
+    if (!seg)
+        return;
+
+    // Tell the peer we are gone, whether it's reading or writing.
+    txRing->closed = 1;
+    txRing->written++;
+    futexWake(txRing->written);
+    rxRing->consumed++;
+    futexWake(rxRing->consumed);
+
+    // Stop our own receiver thread. The mapping is left alone since
+    // that thread may still use it until DistIface joins it.
+    detached = true;
+    rxRing->written++;
+    futexWake(rxRing->written);
+
+    if (!isSwitch)
+        shm_unlink(segName.c_str());
+}
+
+string
+ShmIface::linkName(unsigned rank, unsigned iface_id) const
+{
+    return csprintf("/gem5-dist.%d.%d.%d", serverPort, rank, iface_id);
+}
+
+void
+ShmIface::create()
+{
+    segName = linkName(rank, distIfaceId);
+    segSize = sizeof(Segment) + 2 * (size_t)ringSize;
+
+    // Remove a segment that a crashed run may have left behind.
+    shm_unlink(segName.c_str());
+    int fd = shm_open(segName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    panic_if(fd < 0, "shm_open(%s) failed: %s", segName, strerror(errno));
+    panic_if(ftruncate(fd, segSize) != 0, "ftruncate(%s) failed: %s",
+             segName, strerror(errno));
+    void *addr = mmap(nullptr, segSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+    panic_if(addr == MAP_FAILED, "mmap(%s) failed: %s", segName,
+             strerror(errno));
+    close(fd);
+
+    seg = new (addr) Segment();
+    seg->ringSize = ringSize;
+    seg->rank = rank;
+    seg->distIfaceId = distIfaceId;
+    seg->distIfaceNum = distIfaceNum;
+
+    uint8_t *data = reinterpret_cast<uint8_t *>(seg) + sizeof(Segment);
+    txRing = &seg->toSwitch;
+    txData = data;
+    rxRing = &seg->toNode;
+    rxData = data + ringSize;
+
+    seg->state = Ready;
+    futexWake(seg->state);
+
+    DPRINTF(DistEthernet, "Created %s, waiting for ack (distIfaceId:%d)\n",
+            segName, distIfaceId);
+    uint32_t state;
+    while ((state = seg->state) != Connected)
+        futexWait(seg->state, state);
+    inform("Link okay  (iface:%d -> switch iface:%d)", distIfaceId,
+           seg->switchIfaceId);
+}
+
+void
+ShmIface::attach()
+{
+    // The links of the switch are matched to the compute node interfaces
+    // in (rank, interface id) order, like the TCP interface does.
+    static unsigned cur_rank = 0;
+    static unsigned cur_id = 0;
+
+    segName = linkName(cur_rank, cur_id);
+
+    // Wait for the compute node to create and size the segment.
+    int fd;
+    struct stat st;
+    for (;;) {
+        fd = shm_open(segName.c_str(), O_RDWR, 0);
+        if (fd >= 0) {
+            panic_if(fstat(fd, &st) != 0, "fstat(%s) failed: %s", segName,
+                     strerror(errno));
+            if (st.st_size >= (off_t)sizeof(Segment))
+                break;
+            close(fd);
+        } else {
+            panic_if(errno != ENOENT, "shm_open(%s) failed: %s", segName,
+                     strerror(errno));
+        }
+        usleep(1000);
+    }
+
+    segSize = st.st_size;
+    void *addr = mmap(nullptr, segSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+    panic_if(addr == MAP_FAILED, "mmap(%s) failed: %s", segName,
+             strerror(errno));
+    close(fd);
+    seg = static_cast<Segment *>(addr);
+
+    DPRINTF(DistEthernet, "Attached to %s, waiting for link info\n",
+            segName);
+    uint32_t state;
+    while ((state = seg->state) != Ready)
+        futexWait(seg->state, state);
+    panic_if(segSize != sizeof(Segment) + 2 * (size_t)seg->ringSize,
+             "Malformed shared memory segment %s", segName);
+    assert(seg->rank == cur_rank);
+    assert(seg->distIfaceId == cur_id);
+
+    inform("Link okay  (iface:%d -> (node:%d, iface:%d))",
+           distIfaceId, seg->rank, seg->distIfaceId);
+    if (seg->distIfaceId < seg->distIfaceNum - 1) {
+        cur_id++;
+    } else {
+        cur_rank++;
+        cur_id = 0;
+    }
+
+    uint8_t *data = reinterpret_cast<uint8_t *>(seg) + sizeof(Segment);
+    txRing = &seg->toNode;
+    txData = data + seg->ringSize;
+    rxRing = &seg->toSwitch;
+    rxData = data;
+
+    // send ack
+    seg->switchIfaceId = distIfaceId;
+    seg->state = Connected;
+    futexWake(seg->state);
+
+    // Both sides have it mapped, the name isn't needed any more.
+    shm_unlink(segName.c_str());
+}
+
+void
+ShmIface::establishConnection()
+{
+    if (isSwitch)
+        attach();
+    else
+        create();
+    registry.push_back(this);
+}
+
+void
+ShmIface::write(const void *buf, unsigned length)
+{
+    const uint8_t *src = static_cast<const uint8_t *>(buf);
+    const uint64_t size = seg->ringSize;
+    uint64_t head = txRing->head.load(memory_order_relaxed);
+
+    while (length > 0) {
+        uint32_t seq = txRing->consumed;
+        uint64_t tail = txRing->tail.load(memory_order_acquire);
+        uint64_t space = size - (head - tail);
+        if (space == 0) {
+            if (rxRing->closed) {
+                exitSimLoop("Message server closed connection, simulation "
+                            "is exiting");
+                return;
+            }
+            txRing->writeSleepers++;
+            futexWait(txRing->consumed, seq);
+            txRing->writeSleepers--;
+            continue;
+        }
+
+        uint64_t n = min<uint64_t>(space, length);
+        uint64_t offset = head % size;
+        uint64_t first = min(n, size - offset);
+        memcpy(txData + offset, src, first);
+        memcpy(txData, src + first, n - first);
+        head += n;
+        src += n;
+        length -= n;
+
+        txRing->head.store(head, memory_order_release);
+        txRing->written++;
+        if (txRing->readSleepers)
+            futexWake(txRing->written);
+    }
+}
+
+bool
+ShmIface::read(void *buf, unsigned length)
+{
+    uint8_t *dst = static_cast<uint8_t *>(buf);
+    const uint64_t size = seg->ringSize;
+    uint64_t tail = rxRing->tail.load(memory_order_relaxed);
+
+    while (length > 0) {
+        uint32_t seq = rxRing->written;
+        // The producer closes after its last write, so check for that
+        // before looking for data.
+        bool closed = rxRing->closed;
+        uint64_t avail = rxRing->head.load(memory_order_acquire) - tail;
+        if (avail == 0) {
+            if (closed || detached) {
+                inform("recv(): Connection closed");
+                return false;
+            }
+            rxRing->readSleepers++;
+            futexWait(rxRing->written, seq);
+            rxRing->readSleepers--;
+            continue;
+        }
+
+        uint64_t n = min<uint64_t>(avail, length);
+        uint64_t offset = tail % size;
+        uint64_t first = min(n, size - offset);
+        memcpy(dst, rxData + offset, first);
+        memcpy(dst + first, rxData, n - first);
+        tail += n;
+        dst += n;
+        length -= n;
+
+        rxRing->tail.store(tail, memory_order_release);
+        rxRing->consumed++;
+        if (rxRing->writeSleepers)
+            futexWake(rxRing->consumed);
+    }
+    return true;
+}
+
+void
+ShmIface::sendPacket(const Header &header, const EthPacketPtr &packet)
+{
+    lock_guard<mutex> lock(txLock);
+    write(&header, sizeof(header));
+    write(packet->data, packet->length);
+}
+
+void
+ShmIface::sendCmd(const Header &header)
+{
+    DPRINTF(DistEthernetCmd, "ShmIface::sendCmd() type: %d\n",
+            static_cast<int>(header.msgType));
+    // Global commands (i.e. sync request) are always sent by the master
+    // DistIface, to every link of this process.
+    for (auto iface: registry) {
+        lock_guard<mutex> lock(iface->txLock);
+        iface->write(&header, sizeof(header));
+    }
+}
+
+bool
+ShmIface::recvHeader(Header &header)
+{
+    bool ret = read(&header, sizeof(header));
+    DPRINTF(DistEthernetCmd, "ShmIface::recvHeader() type: %d ret: %d\n",
+            static_cast<int>(header.msgType), ret);
+    return ret;
+}
+
+void
+ShmIface::recvPacket(const Header &header, EthPacketPtr &packet)
+{
+    // This runs in the receiver thread, so the buffer is not pooled.
+    packet = make_shared<EthPacketData>(header.dataPacketLength, false);
+    bool ret = read(packet->data, header.dataPacketLength);
+    panic_if(!ret, "Error while reading shared memory link");
+    packet->simLength = header.simLength;
+    packet->length = header.dataPacketLength;
+}
+
+void
+ShmIface::initTransport()
+{
+    // As with TCP, the links can only be set up once the number of dist
+    // interfaces of this process is known.
+    establishConnection();
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Shared memory based interface class for dist-gem5 runs on one host.
+ *
+ * For a high level description about dist-gem5 see comments in
+ * header file dist_iface.hh.
+ *
+ * This is a drop-in replacement for the TCP interface (tcp_iface.hh) when
+ * all the gem5 peers run on the same host. Each link between a compute
+ * node and the switch process is a shared memory segment holding a ring
+ * buffer per direction. Readers that find their ring empty, and writers
+ * that find it full, sleep on a futex until the peer moves the ring
+ * along, so the messages of a global synchronisation are passed on
+ * without going through the network stack.
+ */
+#ifndef __DEV_NET_SHM_IFACE_HH__
+#define __DEV_NET_SHM_IFACE_HH__
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "dev/net/dist_iface.hh"
+
+class EventManager;
+
+class ShmIface : public DistIface
+{
+  private:
+    /**
+     * Control block of a single producer, single consumer byte ring.
+     * The data area is kept elsewhere in the segment. The counters only
+     * grow, the ring holds head - tail bytes.
+     */
+    struct Ring
+    {
+        /** Bytes written so far by the producer. */
+        std::atomic<uint64_t> head;
+        /** Bytes consumed so far by the consumer. */
+        std::atomic<uint64_t> tail;
+        /** Futex word bumped whenever data is written. */
+        std::atomic<uint32_t> written;
+        /** Futex word bumped whenever data is consumed. */
+        std::atomic<uint32_t> consumed;
+        /** Number of threads sleeping on written and consumed. */
+        std::atomic<uint32_t> readSleepers;
+        std::atomic<uint32_t> writeSleepers;
+        /** Set when the producer has gone away. */
+        std::atomic<uint32_t> closed;
+    };
+
+    enum SegmentState : uint32_t {
+        Created = 0,
+        Ready,
+        Connected,
+    };
+
+    /**
+     * Layout of the shared memory segment of a link, followed by the
+     * data areas of the two rings. The compute node creates the
+     * segment and fills in its link info, the switch process attaches
+     * to it and acknowledges with its own interface id.
+     */
+    struct Segment
+    {
+        /** Futex word holding a SegmentState. */
+        std::atomic<uint32_t> state;
+        uint32_t ringSize;
+        unsigned rank;
+        unsigned distIfaceId;
+        unsigned distIfaceNum;
+        unsigned switchIfaceId;
+        Ring toSwitch;
+        Ring toNode;
+    };
+
+    /** Name of the segment, unique to the run and link. */
+    std::string segName;
+    /** Ring size requested for the links this process creates. */
+    uint32_t ringSize;
+    Segment *seg;
+    size_t segSize;
+
+    /** The rings this side writes to and reads from. */
+    Ring *txRing;
+    Ring *rxRing;
+    uint8_t *txData;
+    uint8_t *rxData;
+
+    /**
+     * Serialises writers, so that the header and payload of a packet
+     * can't be interleaved with a command sent by another thread.
+     */
+    std::mutex txLock;
+
+    int serverPort;
+    bool isSwitch;
+
+    /** Set on destruction to stop the receiver thread. */
+    std::atomic<bool> detached;
+
+    /**
+     * All the links of this process, global commands are sent to each
+     * of them.
+     */
+    static std::vector<ShmIface *> registry;
+
+  private:
+    /**
+     * Write a message to the outgoing ring, waiting for space as needed.
+     * The caller must hold txLock.
+     *
+     * @param buf Start address of the message.
+     * @param length Size of the message in bytes.
+     */
+    void write(const void *buf, unsigned length);
+
+    /**
+     * Read the next incoming message from the incoming ring, waiting
+     * for data as needed.
+     *
+     * @param buf Start address of buffer to store the message.
+     * @param length Exact size of the expected message in bytes.
+     * @return false if the peer went away.
+     */
+    bool read(void *buf, unsigned length);
+
+    std::string linkName(unsigned rank, unsigned iface_id) const;
+    void create();
+    void attach();
+    void establishConnection();
+
+  protected:
+
+    void sendPacket(const Header &header,
+                    const EthPacketPtr &packet) override;
+
+    void sendCmd(const Header &header) override;
+
+    bool recvHeader(Header &header) override;
+
+    void recvPacket(const Header &header, EthPacketPtr &packet) override;
+
+    void initTransport() override;
+
+  public:
+    /**
+     * @param server_port The port number of the run, which only serves
+     * to tell the segments of concurrent runs apart.
+     * @param ring_size Size in bytes of each direction of a link.
+     * @param sync_start The tick for the first dist synchronisation.
+     * @param sync_repeat The frequency of dist synchronisation.
+     * @param em The EventManager object associated with the simulated
+     * Ethernet link.
+     */
+    ShmIface(unsigned server_port, uint64_t ring_size,
+             unsigned dist_rank, unsigned dist_size,
+             Tick sync_start, Tick sync_repeat, EventManager *em,
+             bool use_pseudo_op, bool is_switch, int num_nodes);
+
+    ~ShmIface() override;
+};
+
+#endif // __DEV_NET_SHM_IFACE_HH__
@@ -327,7 +327,8 @@ TCPIface::recvHeader(Header &header)
 void
 TCPIface::recvPacket(const Header &header, EthPacketPtr &packet)
 {
-    packet = make_shared<EthPacketData>(header.dataPacketLength);
+    // This runs in the receiver thread, so the buffer is not pooled.
+    packet = make_shared<EthPacketData>(header.dataPacketLength, false);
     bool ret = recvTCP(sock, packet->data, header.dataPacketLength);
     panic_if(!ret, "Error while reading socket");
     packet->simLength = header.simLength;
@@ -231,13 +231,13 @@ BasePixelPump::renderPixels()
             onUnderrun(_posX, pos_y);
             pixel = underrun_pixel;
         }
-        fb.pixel(_posX, pos_y) = pixel;
+        fb.setPixel(_posX, pos_y, pixel);
     }
 
     // Fill remaining pixels with a dummy pixel value if we ran out of
     // data
     for (; _posX < x_end; ++_posX)
-        fb.pixel(_posX, pos_y) = underrun_pixel;
+        fb.setPixel(_posX, pos_y, underrun_pixel);
 
     // Schedule a new event to handle the next block of pixels
     if (_posX < _timings.width) {
@@ -291,7 +291,7 @@ BasePixelPump::renderLine()
             panic("Unexpected underrun in BasePixelPump (%u, %u)\n",
                  _posX, pos_y);
         }
-        fb.pixel(_posX, pos_y) = pixel;
+        fb.setPixel(_posX, pos_y, pixel);
     }
 }
 
@@ -43,4 +43,4 @@ from m5.SimObject import SimObject
 class AbstractNVM(SimObject):
     type = 'AbstractNVM'
     abstract = True
-    cxx_header = "dev/arm/abstract_nvm.hh"
+    cxx_header = "dev/storage/abstract_nvm.hh"
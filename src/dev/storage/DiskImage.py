@@ -44,5 +44,10 @@ class CowDiskImage(DiskImage):
     cxx_header = "dev/storage/disk_image.hh"
     child = Param.DiskImage(RawDiskImage(read_only=True),
                             "child image")
-    table_size = Param.Int(65536, "initial table size")
     image_file = ""
+
+class Qcow2DiskImage(DiskImage):
+    type = 'Qcow2DiskImage'
+    cxx_header = "dev/storage/qcow2_disk_image.hh"
+    read_only = True
+    l2_cache_size = Param.Unsigned(32, "Number of cached L2 tables")
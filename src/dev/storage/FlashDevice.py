@@ -48,7 +48,7 @@ class DataDistribution(Enum): vals = ['sequential', 'stripe']
 
 class FlashDevice(AbstractNVM):
     type = 'FlashDevice'
-    cxx_header = "dev/arm/flash_device.hh"
+    cxx_header = "dev/storage/flash_device.hh"
     # default blocksize is 128 kB.This seems to be the most common size in
     # mobile devices (not the image blocksize)
     blk_size = Param.MemorySize("128kB", "Size of one disk block")
@@ -0,0 +1,68 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.SimObject import SimObject
+from m5.params import *
+from PciDevice import PciDevice
+
+class NvmeController(PciDevice):
+    type = 'NvmeController'
+    cxx_header = "dev/storage/nvme.hh"
+
+    image = Param.DiskImage("Disk image backing the namespace")
+    media = Param.AbstractNVM(NULL, "Timing model of the storage medium, "
+                              "media_latency is used if there is none")
+    media_latency = Param.Latency('20us', "Fixed medium access latency")
+
+    num_queues = Param.UInt16(16, "Number of I/O queue pairs")
+    max_queue_entries = Param.UInt16(1024, "Maximum entries in a queue")
+    max_transfer_size = Param.MemorySize('1MB',
+        "Maximum data transfer size of a command")
+    max_outstanding = Param.Unsigned(256,
+        "Maximum number of commands in flight")
+
+    VendorID = 0x8086
+    DeviceID = 0x5845
+    Command = 0x0
+    # Capabilities list
+    Status = 0x0010
+    Revision = 0x0
+    ClassCode = 0x01
+    SubClassCode = 0x08
+    ProgIF = 0x02
+    BAR0 = 0x00000000
+    BAR0Size = '16kB'
+    InterruptLine = 0x1f
+    InterruptPin = 0x01
+
+    # One MSI-X vector per I/O queue and one for the admin queue. The
+    # table and the pending bit array live in BAR0 after the doorbells.
+    CapabilityPtr = 0x40
+    MSIXCAPBaseOffset = 0x40
+    MSIXCAPCapId = 0x11
+    MSIXMsgCtrl = 0x0010
+    MSIXTableOffset = 0x00002000
+    MSIXPbaOffset = 0x00003000
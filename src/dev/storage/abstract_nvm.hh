@@ -37,8 +37,8 @@
  * Authors: Rene de Jong
  */
 
-#ifndef __DEV_ARM_ABSTRACT_NVM_HH__
-#define __DEV_ARM_ABSTRACT_NVM_HH__
+#ifndef __DEV_STORAGE_ABSTRACT_NVM_HH__
+#define __DEV_STORAGE_ABSTRACT_NVM_HH__
 
 #include "base/callback.hh"
 #include "params/AbstractNVM.hh"
@@ -106,4 +106,4 @@ class AbstractNVM : public SimObject
                              Callback *event) = 0;
 };
 
-#endif //__DEV_ARM_ABSTRACT_NVM_HH__
+#endif //__DEV_STORAGE_ABSTRACT_NVM_HH__
@@ -34,16 +34,20 @@
 
 #include "dev/storage/disk_image.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <fstream>
 #include <string>
 
 #include "base/callback.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/DiskImageRead.hh"
@@ -53,12 +57,42 @@
 
 using namespace std;
 
+std::streampos
+DiskImage::readSectors(uint8_t *data, std::streampos offset,
+                       size_t count) const
+{
+    std::streampos bytes(0);
+    for (size_t i = 0; i < count; ++i) {
+        std::streampos done(read(data + i * SectorSize,
+                                 offset + (std::streamoff)i));
+        bytes += done;
+        if (done != SectorSize)
+            break;
+    }
+    return bytes;
+}
+
+std::streampos
+DiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                        size_t count)
+{
+    std::streampos bytes(0);
+    for (size_t i = 0; i < count; ++i) {
+        std::streampos done(write(data + i * SectorSize,
+                                  offset + (std::streamoff)i));
+        bytes += done;
+        if (done != SectorSize)
+            break;
+    }
+    return bytes;
+}
+
 ////////////////////////////////////////////////////////////////////////
 //
 // Raw Disk image
 //
 RawDiskImage::RawDiskImage(const Params* p)
-    : DiskImage(p), disk_size(0)
+    : DiskImage(p), fd(-1), mapping(NULL), disk_size(0)
 { open(p->image_file, p->read_only); }
 
 RawDiskImage::~RawDiskImage()
@@ -83,58 +117,95 @@ RawDiskImage::open(const string &filename, bool rd_only)
         readonly = rd_only;
         file = filename;
 
-        ios::openmode mode = ios::in | ios::binary;
-        if (!readonly)
-            mode |= ios::out;
-        stream.open(file.c_str(), mode);
-        if (!stream.is_open())
+        fd = ::open(file.c_str(), readonly ? O_RDONLY : O_RDWR);
+        if (fd < 0)
             panic("Error opening %s", filename);
+
+        const off_t end = lseek(fd, 0, SEEK_END);
+        if (end < 0)
+            panic("Could not determine the size of %s", filename);
+        disk_size = end;
+
+        if (disk_size == 0)
+            return;
+
+        const int prot = readonly ? PROT_READ : PROT_READ | PROT_WRITE;
+        void *addr = mmap(NULL, disk_size, prot, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            warn("Could not map disk image %s (%s), using system calls.\n",
+                 filename, strerror(errno));
+        } else {
+            mapping = (uint8_t *)addr;
+        }
     }
 }
 
 void
 RawDiskImage::close()
 {
-    stream.close();
+    if (mapping) {
+        munmap(mapping, disk_size);
+        mapping = NULL;
+    }
+
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
 }
 
 std::streampos
 RawDiskImage::size() const
 {
-    if (disk_size == 0) {
-        if (!stream.is_open())
-            panic("file not open!\n");
-        stream.seekg(0, ios::end);
-        disk_size = stream.tellg();
-    }
+    if (fd < 0)
+        panic("file not open!\n");
 
     return disk_size / SectorSize;
 }
 
 std::streampos
 RawDiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+RawDiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    return writeSectors(data, offset, 1);
+}
+
+std::streampos
+RawDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          size_t count) const
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
 
-    if (!stream.is_open())
+    if (fd < 0)
         panic("file not open!\n");
 
-    stream.seekg(offset * SectorSize, ios::beg);
-    if (!stream.good())
-        panic("Could not seek to location in file");
+    const uint64_t pos = (uint64_t)offset * SectorSize;
+    if (pos >= disk_size)
+        return 0;
+    const size_t len = min<uint64_t>(count * SectorSize, disk_size - pos);
 
-    streampos pos = stream.tellg();
-    stream.read((char *)data, SectorSize);
+    if (mapping) {
+        memcpy(data, mapping + pos, len);
+    } else if (pread(fd, data, len, pos) != (ssize_t)len) {
+        panic("Could not read from disk image: %s", strerror(errno));
+    }
 
-    DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageRead, data, SectorSize);
+    DPRINTF(DiskImageRead, "read: offset=%d count=%d\n",
+            (uint64_t)offset, count);
+    DDUMP(DiskImageRead, data, len);
 
-    return stream.tellg() - pos;
+    return len;
 }
 
 std::streampos
-RawDiskImage::write(const uint8_t *data, std::streampos offset)
+RawDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           size_t count)
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
@@ -142,19 +213,25 @@ RawDiskImage::write(const uint8_t *data, std::streampos offset)
     if (readonly)
         panic("Cannot write to a read only disk image");
 
-    if (!stream.is_open())
+    if (fd < 0)
         panic("file not open!\n");
 
-    stream.seekp(offset * SectorSize, ios::beg);
-    if (!stream.good())
-        panic("Could not seek to location in file");
+    const uint64_t pos = (uint64_t)offset * SectorSize;
+    if (pos >= disk_size)
+        return 0;
+    const size_t len = min<uint64_t>(count * SectorSize, disk_size - pos);
 
-    DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageWrite, data, SectorSize);
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n",
+            (uint64_t)offset, count);
+    DDUMP(DiskImageWrite, data, len);
 
-    streampos pos = stream.tellp();
-    stream.write((const char *)data, SectorSize);
-    return stream.tellp() - pos;
+    if (mapping) {
+        memcpy(mapping + pos, data, len);
+    } else if (pwrite(fd, data, len, pos) != (ssize_t)len) {
+        panic("Could not write to disk image: %s", strerror(errno));
+    }
+
+    return len;
 }
 
 RawDiskImage *
@@ -167,8 +244,13 @@ RawDiskImageParams::create()
 //
 // Copy on Write Disk image
 //
-const uint32_t CowDiskImage::VersionMajor = 1;
+// Version 1 images store individual sectors, version 2 images store
+// the pages of the overlay. Both versions can be loaded.
+//
+const uint32_t CowDiskImage::VersionMajor = 2;
 const uint32_t CowDiskImage::VersionMinor = 0;
+const size_t CowDiskImage::PageSize;
+const size_t CowDiskImage::SectorsPerPage;
 
 class CowDiskCallback : public Callback
 {
@@ -181,15 +263,15 @@ class CowDiskCallback : public Callback
 };
 
 CowDiskImage::CowDiskImage(const Params *p)
-    : DiskImage(p), filename(p->image_file), child(p->child), table(NULL)
+    : DiskImage(p), filename(p->image_file), child(p->child),
+      overlay(NULL), overlaySize(0), dirtyPages(0)
 {
-    if (filename.empty()) {
-        initSectorTable(p->table_size);
-    } else {
+    initOverlay();
+
+    if (!filename.empty()) {
         if (!open(filename)) {
             if (p->read_only)
                 fatal("could not open read-only file");
-            initSectorTable(p->table_size);
         }
 
         if (!p->read_only)
@@ -199,13 +281,8 @@ CowDiskImage::CowDiskImage(const Params *p)
 
 CowDiskImage::~CowDiskImage()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
-
-    while (i != end) {
-        delete (*i).second;
-        ++i;
-    }
+    if (overlay)
+        munmap(overlay, overlaySize);
 }
 
 void
@@ -267,24 +344,46 @@ CowDiskImage::open(const string &file)
     SafeReadSwap(stream, major);
     SafeReadSwap(stream, minor);
 
-    if (major != VersionMajor && minor != VersionMinor)
+    if (major != 1 && major != VersionMajor)
         panic("Could not open %s: invalid version %d.%d != %d.%d",
               file, major, minor, VersionMajor, VersionMinor);
 
-    uint64_t sector_count;
-    SafeReadSwap(stream, sector_count);
-    table = new SectorTable(sector_count);
-
+    initOverlay();
 
-    for (uint64_t i = 0; i < sector_count; i++) {
-        uint64_t offset;
-        SafeReadSwap(stream, offset);
+    if (major == 1) {
+        uint64_t sector_count;
+        SafeReadSwap(stream, sector_count);
 
-        Sector *sector = new Sector;
-        SafeRead(stream, sector, sizeof(Sector));
-
-        assert(table->find(offset) == table->end());
-        (*table)[offset] = sector;
+        uint8_t sector[SectorSize];
+        for (uint64_t i = 0; i < sector_count; i++) {
+            uint64_t offset;
+            SafeReadSwap(stream, offset);
+            SafeRead(stream, sector, sizeof(sector));
+            writeSectors(sector, offset, 1);
+        }
+    } else {
+        uint32_t page_size;
+        SafeReadSwap(stream, page_size);
+        if (page_size != PageSize)
+            panic("Could not open %s: page size %d != %d",
+                  file, page_size, PageSize);
+
+        uint64_t page_count;
+        SafeReadSwap(stream, page_count);
+
+        for (uint64_t i = 0; i < page_count; i++) {
+            uint64_t page;
+            SafeReadSwap(stream, page);
+            if (page >= dirty.size())
+                panic("Could not open %s: page %d out of bounds",
+                      file, page);
+
+            SafeRead(stream, sectorPtr(page * SectorsPerPage), PageSize);
+            if (!dirty[page]) {
+                dirty[page] = true;
+                ++dirtyPages;
+            }
+        }
     }
 
     stream.close();
@@ -294,9 +393,27 @@ CowDiskImage::open(const string &file)
 }
 
 void
-CowDiskImage::initSectorTable(int hash_size)
+CowDiskImage::initOverlay()
 {
-    table = new SectorTable(hash_size);
+    if (overlay)
+        munmap(overlay, overlaySize);
+
+    const uint64_t pages =
+        divCeil((uint64_t)child->size() * SectorSize, PageSize);
+
+    overlay = NULL;
+    overlaySize = pages * PageSize;
+    if (overlaySize) {
+        void *addr = mmap(NULL, overlaySize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                          -1, 0);
+        if (addr == MAP_FAILED)
+            fatal("Could not allocate COW overlay: %s", strerror(errno));
+        overlay = (uint8_t *)addr;
+    }
+
+    dirty.assign(pages, false);
+    dirtyPages = 0;
 
     initialized = true;
 }
@@ -355,82 +472,155 @@ CowDiskImage::save(const string &file) const
 
     SafeWriteSwap(stream, (uint32_t)VersionMajor);
     SafeWriteSwap(stream, (uint32_t)VersionMinor);
-    SafeWriteSwap(stream, (uint64_t)table->size());
+    SafeWriteSwap(stream, (uint32_t)PageSize);
+    SafeWriteSwap(stream, (uint64_t)dirtyPages);
 
-    uint64_t size = table->size();
-    SectorTable::iterator iter = table->begin();
-    SectorTable::iterator end = table->end();
+    uint64_t written = 0;
+    for (uint64_t page = 0; page < dirty.size(); page++) {
+        if (!dirty[page])
+            continue;
 
-    for (uint64_t i = 0; i < size; i++) {
-        if (iter == end)
-            panic("Incorrect Table Size during save of COW disk image");
-
-        SafeWriteSwap(stream, (uint64_t)(*iter).first);
-        SafeWrite(stream, (*iter).second->data, sizeof(Sector));
-        ++iter;
+        SafeWriteSwap(stream, page);
+        SafeWrite(stream, sectorPtr(page * SectorsPerPage), PageSize);
+        ++written;
     }
 
+    if (written != dirtyPages)
+        panic("Incorrect page count during save of COW disk image");
+
     stream.close();
 }
 
 void
 CowDiskImage::writeback()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
-
-    while (i != end) {
-        child->write((*i).second->data, (*i).first);
-        ++i;
+    const uint64_t sectors = size();
+    for (uint64_t page = 0; page < dirty.size(); page++) {
+        if (!dirty[page])
+            continue;
+
+        const uint64_t sector = page * SectorsPerPage;
+        child->writeSectors(sectorPtr(sector), sector,
+                            min<uint64_t>(SectorsPerPage, sectors - sector));
     }
 }
 
+void
+CowDiskImage::copyUp(uint64_t page)
+{
+    assert(!dirty[page]);
+
+    const uint64_t sector = page * SectorsPerPage;
+    const uint64_t sectors = size();
+    child->readSectors(sectorPtr(sector), sector,
+                       min<uint64_t>(SectorsPerPage, sectors - sector));
+    dirty[page] = true;
+    ++dirtyPages;
+}
+
 std::streampos
 CowDiskImage::size() const
 { return child->size(); }
 
 std::streampos
 CowDiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    return writeSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          size_t count) const
 {
     if (!initialized)
         panic("CowDiskImage not initialized");
 
-    if (offset > size())
+    const uint64_t sectors = size();
+    if ((uint64_t)offset > sectors)
         panic("access out of bounds");
 
-    SectorTable::const_iterator i = table->find(offset);
-    if (i == table->end())
-        return child->read(data, offset);
-    else {
-        memcpy(data, (*i).second->data, SectorSize);
-        DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
-        DDUMP(DiskImageRead, data, SectorSize);
-        return SectorSize;
+    uint64_t sector = offset;
+    count = min<uint64_t>(count, sectors - sector);
+
+    // Split the access into runs of pages that are either all in the
+    // overlay or all in the child.
+    std::streampos bytes(0);
+    while (count) {
+        const bool in_overlay = dirty[sector / SectorsPerPage];
+        size_t run = 0;
+        do {
+            run += min<uint64_t>(count - run,
+                SectorsPerPage - (sector + run) % SectorsPerPage);
+        } while (run < count &&
+                 dirty[(sector + run) / SectorsPerPage] == in_overlay);
+
+        if (in_overlay) {
+            memcpy(data, sectorPtr(sector), run * SectorSize);
+            DPRINTF(DiskImageRead, "read: offset=%d count=%d\n",
+                    sector, run);
+            DDUMP(DiskImageRead, data, run * SectorSize);
+            bytes += run * SectorSize;
+        } else {
+            std::streampos done(child->readSectors(data, sector, run));
+            bytes += done;
+            if (done != (std::streamoff)(run * SectorSize))
+                break;
+        }
+
+        data += run * SectorSize;
+        sector += run;
+        count -= run;
     }
+
+    return bytes;
 }
 
 std::streampos
-CowDiskImage::write(const uint8_t *data, std::streampos offset)
+CowDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           size_t count)
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
 
-    if (offset > size())
+    const uint64_t sectors = size();
+    if ((uint64_t)offset > sectors)
         panic("access out of bounds");
 
-    SectorTable::iterator i = table->find(offset);
-    if (i == table->end()) {
-        Sector *sector = new Sector;
-        memcpy(sector, data, SectorSize);
-        table->insert(make_pair(offset, sector));
-    } else {
-        memcpy((*i).second->data, data, SectorSize);
+    const uint64_t sector = offset;
+    count = min<uint64_t>(count, sectors - sector);
+    if (!count)
+        return 0;
+
+    // Pages that are only partially overwritten need the rest of
+    // their contents from the child first.
+    const uint64_t first = sector / SectorsPerPage;
+    const uint64_t last = (sector + count - 1) / SectorsPerPage;
+    for (uint64_t page = first; page <= last; ++page) {
+        if (dirty[page])
+            continue;
+
+        const uint64_t start = page * SectorsPerPage;
+        const uint64_t end = min<uint64_t>(start + SectorsPerPage, sectors);
+        if (start < sector || end > sector + count) {
+            copyUp(page);
+        } else {
+            dirty[page] = true;
+            ++dirtyPages;
+        }
     }
 
-    DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageWrite, data, SectorSize);
+    memcpy(sectorPtr(sector), data, count * SectorSize);
+
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n", sector, count);
+    DDUMP(DiskImageWrite, data, count * SectorSize);
 
-    return SectorSize;
+    return count * SectorSize;
 }
 
 void
@@ -36,7 +36,7 @@
 #define __DEV_STORAGE_DISK_IMAGE_HH__
 
 #include <fstream>
-#include <unordered_map>
+#include <vector>
 
 #include "params/CowDiskImage.hh"
 #include "params/DiskImage.hh"
@@ -64,18 +64,48 @@ class DiskImage : public SimObject
                                 std::streampos offset) const = 0;
     virtual std::streampos write(const uint8_t *data,
                                  std::streampos offset) = 0;
+
+    /**
+     * Read a run of consecutive sectors. The default implementation
+     * reads one sector at a time.
+     *
+     * @param data Destination buffer of count * SectorSize bytes.
+     * @param offset First sector to read.
+     * @param count Number of sectors to read.
+     * @return Number of bytes read.
+     */
+    virtual std::streampos readSectors(uint8_t *data, std::streampos offset,
+                                       size_t count) const;
+    /**
+     * Write a run of consecutive sectors. The default implementation
+     * writes one sector at a time.
+     *
+     * @param data Source buffer of count * SectorSize bytes.
+     * @param offset First sector to write.
+     * @param count Number of sectors to write.
+     * @return Number of bytes written.
+     */
+    virtual std::streampos writeSectors(const uint8_t *data,
+                                        std::streampos offset, size_t count);
 };
 
 /**
  * Specialization for accessing a raw disk image
+ *
+ * The image is mapped into the simulator's address space, so reads
+ * are served from the host's page cache without any system calls,
+ * and a read-only image is shared by every simulator that uses it.
+ * If the image can't be mapped, accesses fall back to pread() and
+ * pwrite().
  */
 class RawDiskImage : public DiskImage
 {
   protected:
-    mutable std::fstream stream;
+    int fd;
+    uint8_t *mapping;
     std::string file;
     bool readonly;
-    mutable std::streampos disk_size;
+    uint64_t disk_size;
 
   public:
     typedef RawDiskImageParams Params;
@@ -91,6 +121,11 @@ class RawDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+
+    std::streampos readSectors(uint8_t *data, std::streampos offset,
+                               size_t count) const override;
+    std::streampos writeSectors(const uint8_t *data, std::streampos offset,
+                                size_t count) override;
 };
 
 /**
@@ -102,6 +137,13 @@ class RawDiskImage : public DiskImage
  * This object is designed to provide a mechanism for persistant
  * changes to a main disk image, or to provide a place for temporary
  * changes to the image to take place that later may be thrown away.
+ *
+ * Changes are tracked in pages of PageSize bytes. Modified pages are
+ * kept in an anonymous mapping covering the whole image, which the
+ * host only backs with memory once a page is written, and a bitmap
+ * records which pages are present. The first write to a page copies
+ * the rest of the page from the child unless the write covers it
+ * completely.
  */
 class CowDiskImage : public DiskImage
 {
@@ -109,16 +151,32 @@ class CowDiskImage : public DiskImage
     static const uint32_t VersionMajor;
     static const uint32_t VersionMinor;
 
-  protected:
-    struct Sector {
-        uint8_t data[SectorSize];
-    };
-    typedef std::unordered_map<uint64_t, Sector *> SectorTable;
+    /** Size of the pages tracked by the overlay */
+    static const size_t PageSize = 4096;
+    static const size_t SectorsPerPage = PageSize / SectorSize;
 
   protected:
     std::string filename;
     DiskImage *child;
-    SectorTable *table;
+
+    /** Modified pages, indexed by page number */
+    uint8_t *overlay;
+    /** Size of the overlay mapping in bytes */
+    size_t overlaySize;
+    /** Which pages are present in the overlay */
+    std::vector<bool> dirty;
+    /** Number of pages present in the overlay */
+    uint64_t dirtyPages;
+
+    /** Get a pointer to a sector in the overlay. */
+    uint8_t *
+    sectorPtr(uint64_t sector) const
+    {
+        return overlay + sector * SectorSize;
+    }
+
+    /** Copy a page from the child into the overlay. */
+    void copyUp(uint64_t page);
 
   public:
     typedef CowDiskImageParams Params;
@@ -127,7 +185,8 @@ class CowDiskImage : public DiskImage
 
     void notifyFork() override;
 
-    void initSectorTable(int hash_size);
+    /** Create an empty overlay, discarding any existing one. */
+    void initOverlay();
     bool open(const std::string &file);
     void save() const;
     void save(const std::string &file) const;
@@ -140,6 +199,11 @@ class CowDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+
+    std::streampos readSectors(uint8_t *data, std::streampos offset,
+                               size_t count) const override;
+    std::streampos writeSectors(const uint8_t *data, std::streampos offset,
+                                size_t count) override;
 };
 
 void SafeRead(std::ifstream &stream, void *data, int count);
@@ -52,7 +52,7 @@
  * IMPORTANT: number of planes should be a power of 2.
  */
 
-#include "dev/arm/flash_device.hh"
+#include "dev/storage/flash_device.hh"
 
 #include "base/trace.hh"
 #include "debug/Drain.hh"
@@ -36,14 +36,14 @@
  *
  * Authors: Rene de Jong
  */
-#ifndef __DEV_ARM_FLASH_DEVICE_HH__
-#define __DEV_ARM_FLASH_DEVICE_HH__
+#ifndef __DEV_STORAGE_FLASH_DEVICE_HH__
+#define __DEV_STORAGE_FLASH_DEVICE_HH__
 
 #include <deque>
 
 #include "base/statistics.hh"
 #include "debug/FlashDevice.hh"
-#include "dev/arm/abstract_nvm.hh"
+#include "dev/storage/abstract_nvm.hh"
 #include "enums/DataDistribution.hh"
 #include "params/FlashDevice.hh"
 #include "sim/serialize.hh"
@@ -194,4 +194,4 @@ class FlashDevice : public AbstractNVM
     /** Completion event */
     EventFunctionWrapper planeEvent;
 };
-#endif //__DEV_ARM_FLASH_DEVICE_HH__
+#endif //__DEV_STORAGE_FLASH_DEVICE_HH__
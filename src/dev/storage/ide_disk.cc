@@ -451,13 +451,12 @@ IdeDisk::doDmaRead()
         return;
     } else if (!dmaReadCG->done()) {
         assert(dmaReadCG->complete() < MAX_DMA_SIZE);
-        ctrl->dmaRead(pciToDma(dmaReadCG->addr()), dmaReadCG->size(),
-                &dmaReadWaitEvent, dataBuffer + dmaReadCG->complete());
-        dmaReadBytes += dmaReadCG->size();
+        const Addr addr = pciToDma(dmaReadCG->addr());
+        uint8_t *data = dataBuffer + dmaReadCG->complete();
+        const unsigned size = nextDmaRun(dmaReadCG, dmaReadFullPages);
+        ctrl->dmaRead(addr, size, &dmaReadWaitEvent, data);
+        dmaReadBytes += size;
         dmaReadTxs++;
-        if (dmaReadCG->size() == TheISA::PageBytes)
-            dmaReadFullPages++;
-        dmaReadCG->next();
     } else {
         assert(dmaReadCG->done());
         delete dmaReadCG;
@@ -466,18 +465,30 @@ IdeDisk::doDmaRead()
     }
 }
 
+unsigned
+IdeDisk::nextDmaRun(ChunkGenerator *cg, Stats::Scalar &full_pages)
+{
+    const Addr start = pciToDma(cg->addr());
+    unsigned size = 0;
+    do {
+        if (cg->size() == TheISA::PageBytes)
+            full_pages++;
+        size += cg->size();
+        cg->next();
+    } while (!cg->done() && pciToDma(cg->addr()) == start + size);
+
+    return size;
+}
+
 void
 IdeDisk::dmaReadDone()
 {
-    uint32_t bytesWritten = 0;
-
     // write the data to the disk image
-    for (bytesWritten = 0; bytesWritten < curPrd.getByteCount();
-         bytesWritten += SectorSize) {
-
-        cmdBytesLeft -= SectorSize;
-        writeDisk(curSector++, (uint8_t *)(dataBuffer + bytesWritten));
-    }
+    const uint32_t sectors =
+        (curPrd.getByteCount() + SectorSize - 1) / SectorSize;
+    writeDisk(curSector, dataBuffer, sectors);
+    curSector += sectors;
+    cmdBytesLeft -= sectors * SectorSize;
 
     // check for the EOT
     if (curPrd.getEOT()) {
@@ -501,11 +512,12 @@ IdeDisk::doDmaDataWrite()
 
     memset(dataBuffer, 0, MAX_DMA_SIZE);
     assert(cmdBytesLeft <= MAX_DMA_SIZE);
-    while (bytesRead < curPrd.getByteCount()) {
-        readDisk(curSector++, (uint8_t *)(dataBuffer + bytesRead));
-        bytesRead += SectorSize;
-        cmdBytesLeft -= SectorSize;
-    }
+    const uint32_t sectors =
+        (curPrd.getByteCount() + SectorSize - 1) / SectorSize;
+    readDisk(curSector, dataBuffer, sectors);
+    curSector += sectors;
+    bytesRead = sectors * SectorSize;
+    cmdBytesLeft -= bytesRead;
     DPRINTF(IdeDisk, "doDmaWrite, bytesRead: %d cmdBytesLeft: %d\n",
             bytesRead, cmdBytesLeft);
 
@@ -534,15 +546,14 @@ IdeDisk::doDmaWrite()
         return;
     } else if (!dmaWriteCG->done()) {
         assert(dmaWriteCG->complete() < MAX_DMA_SIZE);
-        ctrl->dmaWrite(pciToDma(dmaWriteCG->addr()), dmaWriteCG->size(),
-                &dmaWriteWaitEvent, dataBuffer + dmaWriteCG->complete());
+        const Addr addr = pciToDma(dmaWriteCG->addr());
+        uint8_t *data = dataBuffer + dmaWriteCG->complete();
+        const unsigned size = nextDmaRun(dmaWriteCG, dmaWriteFullPages);
+        ctrl->dmaWrite(addr, size, &dmaWriteWaitEvent, data);
         DPRINTF(IdeDisk, "doDmaWrite: not done curPrd byte count %d, eot %#x\n",
                 curPrd.getByteCount(), curPrd.getEOT());
-        dmaWriteBytes += dmaWriteCG->size();
+        dmaWriteBytes += size;
         dmaWriteTxs++;
-        if (dmaWriteCG->size() == TheISA::PageBytes)
-            dmaWriteFullPages++;
-        dmaWriteCG->next();
     } else {
         DPRINTF(IdeDisk, "doDmaWrite: done curPrd byte count %d, eot %#x\n",
                 curPrd.getByteCount(), curPrd.getEOT());
@@ -573,23 +584,23 @@ IdeDisk::dmaWriteDone()
 ///
 
 void
-IdeDisk::readDisk(uint32_t sector, uint8_t *data)
+IdeDisk::readDisk(uint32_t sector, uint8_t *data, uint32_t count)
 {
-    uint32_t bytesRead = image->read(data, sector);
+    uint32_t bytesRead = image->readSectors(data, sector, count);
 
-    if (bytesRead != SectorSize)
+    if (bytesRead != count * SectorSize)
         panic("Can't read from %s. Only %d of %d read. errno=%d\n",
-              name(), bytesRead, SectorSize, errno);
+              name(), bytesRead, count * SectorSize, errno);
 }
 
 void
-IdeDisk::writeDisk(uint32_t sector, uint8_t *data)
+IdeDisk::writeDisk(uint32_t sector, uint8_t *data, uint32_t count)
 {
-    uint32_t bytesWritten = image->write(data, sector);
+    uint32_t bytesWritten = image->writeSectors(data, sector, count);
 
-    if (bytesWritten != SectorSize)
+    if (bytesWritten != count * SectorSize)
         panic("Can't write to %s. Only %d of %d written. errno=%d\n",
-              name(), bytesWritten, SectorSize, errno);
+              name(), bytesWritten, count * SectorSize, errno);
 }
 
 ////
@@ -329,9 +329,20 @@ class IdeDisk : public SimObject
     void dmaWriteDone();
     EventFunctionWrapper dmaWriteEvent;
 
+    /**
+     * Advance a DMA chunk generator over as many pages as map to
+     * contiguous DMA addresses, so that they can be transferred with
+     * a single DMA request.
+     *
+     * @param cg Chunk generator over the current PRD.
+     * @param full_pages Statistic counting full pages transferred.
+     * @return Size of the run in bytes.
+     */
+    unsigned nextDmaRun(ChunkGenerator *cg, Stats::Scalar &full_pages);
+
     // Disk image read/write
-    void readDisk(uint32_t sector, uint8_t *data);
-    void writeDisk(uint32_t sector, uint8_t *data);
+    void readDisk(uint32_t sector, uint8_t *data, uint32_t count = 1);
+    void writeDisk(uint32_t sector, uint8_t *data, uint32_t count = 1);
 
     // State machine management
     void updateState(DevAction_t action);
@@ -0,0 +1,1253 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dev/storage/nvme.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/Drain.hh"
+#include "debug/Nvme.hh"
+#include "dev/storage/abstract_nvm.hh"
+#include "dev/storage/disk_image.hh"
+#include "mem/packet_access.hh"
+#include "params/NvmeController.hh"
+
+using namespace NvmeReg;
+
+const Addr NvmeController::PageBytes;
+
+NvmeController::Command::Command(NvmeController &_ctrl, unsigned index)
+    : ctrl(_ctrl), _name(csprintf("%s.cmd%d", _ctrl.name(), index)),
+      generation(0), sqid(0), cqid(0), cqSlot(0), dir(DirNone),
+      media(false), lba(0), prpsLeft(0), prpListAddr(0), prpListEntries(0),
+      fetchEvent([this]{ ctrl.fetchDone(*this); }, _name),
+      prpEvent([this]{ ctrl.prpListDone(*this); }, _name),
+      mediaEvent([this]{ ctrl.mediaDone(*this); }, _name),
+      cqeEvent([this]{ ctrl.completionWritten(*this); }, _name),
+      mediaCallback(this)
+{
+    memset(&sqe, 0, sizeof(sqe));
+    memset(&cqe, 0, sizeof(cqe));
+}
+
+NvmeController::NvmeController(const Params *p)
+    : PciDevice(p), image(p->image), nvm(p->media), sectors(0),
+      mediaLatency(p->media_latency), numQueues(p->num_queues),
+      maxQueueEntries(p->max_queue_entries),
+      maxTransfer(p->max_transfer_size),
+      regCC(0), regCSTS(0), regAQA(0), regASQ(0), regACQ(0), intMask(0),
+      intxAsserted(false), generation(0),
+      sqs(p->num_queues + 1), cqs(p->num_queues + 1), nextSq(0),
+      kickEvent([this]{ kick(); }, name())
+{
+    if (maxQueueEntries < 2)
+        fatal("%s: Queues need at least two entries\n", name());
+    if (maxTransfer < PageBytes || !isPowerOf2(maxTransfer))
+        fatal("%s: Maximum transfer size must be a power of two of at "
+              "least %d bytes\n", name(), PageBytes);
+    if (MSIXCAP_BASE && ((msixcap.mtab & 0x7) || (msixcap.mpba & 0x7)))
+        fatal("%s: The MSI-X table and PBA must be in BAR0\n", name());
+    if (DOORBELL + 8 * (numQueues + 1) > BARSize[0] ||
+        (MSIXCAP_BASE && std::max(MSIX_TABLE_END, MSIX_PBA_END) >
+         (int)BARSize[0]))
+        fatal("%s: BAR0 is too small\n", name());
+
+    sectors = image->size();
+    if (nvm)
+        nvm->initializeMemory(sectors, SectorSize);
+
+    for (unsigned i = 0; i < p->max_outstanding; ++i) {
+        commands.emplace_back(new Command(*this, i));
+        freeCommands.push_back(commands.back().get());
+    }
+}
+
+NvmeController::~NvmeController()
+{
+}
+
+void
+NvmeController::regStats()
+{
+    PciDevice::regStats();
+
+    using namespace Stats;
+
+    adminCommands
+        .name(name() + ".adminCommands")
+        .desc("Number of admin commands")
+        ;
+    readCommands
+        .name(name() + ".readCommands")
+        .desc("Number of read commands")
+        ;
+    writeCommands
+        .name(name() + ".writeCommands")
+        .desc("Number of write commands")
+        ;
+    readBytes
+        .name(name() + ".readBytes")
+        .desc("Number of bytes read")
+        ;
+    writeBytes
+        .name(name() + ".writeBytes")
+        .desc("Number of bytes written")
+        ;
+    completionStalls
+        .name(name() + ".completionStalls")
+        .desc("Number of completions delayed by a full completion queue")
+        ;
+    msixMessages
+        .name(name() + ".msixMessages")
+        .desc("Number of MSI-X messages sent")
+        ;
+}
+
+////
+// Register interface
+////
+
+Tick
+NvmeController::read(PacketPtr pkt)
+{
+    int bar;
+    Addr offset;
+    if (!getBAR(pkt->getAddr(), bar, offset) || bar != 0)
+        panic("Invalid PCI memory access to unmapped memory.\n");
+
+    const unsigned size = pkt->getSize();
+    uint64_t value = 0;
+    if (size != sizeof(uint32_t) && size != sizeof(uint64_t)) {
+        warn("%s: Unsupported %d byte read at %#x\n", name(), size, offset);
+    } else if (isMsixAccess(offset)) {
+        value = readMsix(offset, size);
+    } else if (offset < DOORBELL) {
+        value = readReg(offset);
+        if (size == sizeof(uint64_t))
+            value |= (uint64_t)readReg(offset + 4) << 32;
+    }
+
+    DPRINTF(Nvme, "Read %#x size: %d data: %#x\n", offset, size, value);
+
+    switch (size) {
+      case sizeof(uint8_t):
+        pkt->set<uint8_t>(value);
+        break;
+      case sizeof(uint16_t):
+        pkt->set<uint16_t>(value);
+        break;
+      case sizeof(uint32_t):
+        pkt->set<uint32_t>(value);
+        break;
+      case sizeof(uint64_t):
+        pkt->set<uint64_t>(value);
+        break;
+      default:
+        panic("%s: Invalid access size %d\n", name(), size);
+    }
+
+    pkt->makeAtomicResponse();
+    return pioDelay;
+}
+
+Tick
+NvmeController::write(PacketPtr pkt)
+{
+    int bar;
+    Addr offset;
+    if (!getBAR(pkt->getAddr(), bar, offset) || bar != 0)
+        panic("Invalid PCI memory access to unmapped memory.\n");
+
+    const unsigned size = pkt->getSize();
+    uint64_t value;
+    switch (size) {
+      case sizeof(uint32_t):
+        value = pkt->get<uint32_t>();
+        break;
+      case sizeof(uint64_t):
+        value = pkt->get<uint64_t>();
+        break;
+      default:
+        warn("%s: Unsupported %d byte write at %#x\n", name(), size, offset);
+        pkt->makeAtomicResponse();
+        return pioDelay;
+    }
+
+    DPRINTF(Nvme, "Write %#x size: %d data: %#x\n", offset, size, value);
+
+    if (isMsixAccess(offset)) {
+        writeMsix(offset, size, value);
+    } else if (offset >= DOORBELL) {
+        writeDoorbell(offset, value);
+    } else {
+        writeReg(offset, value);
+        if (size == sizeof(uint64_t))
+            writeReg(offset + 4, value >> 32);
+    }
+
+    pkt->makeAtomicResponse();
+    return pioDelay;
+}
+
+uint32_t
+NvmeController::readReg(Addr offset) const
+{
+    switch (offset) {
+      case CAP:
+        return (maxQueueEntries - 1) | CAP_CQR | (0x20 << CAP_TO_SHIFT);
+      case CAP + 4:
+        return CAP_CSS_NVM >> 32;
+      case VS:
+        return VERSION;
+      case INTMS:
+      case INTMC:
+        return intMask;
+      case CC:
+        return regCC;
+      case CSTS:
+        return regCSTS;
+      case AQA:
+        return regAQA;
+      case ASQ:
+        return regASQ;
+      case ASQ + 4:
+        return regASQ >> 32;
+      case ACQ:
+        return regACQ;
+      case ACQ + 4:
+        return regACQ >> 32;
+      default:
+        return 0;
+    }
+}
+
+void
+NvmeController::writeReg(Addr offset, uint32_t value)
+{
+    switch (offset) {
+      case INTMS:
+        intMask |= value;
+        updateIntx();
+        break;
+      case INTMC:
+        intMask &= ~value;
+        updateIntx();
+        break;
+      case CC: {
+        const uint32_t old = regCC;
+        regCC = value;
+        if (!(old & CC_EN) && (value & CC_EN))
+            enable();
+        else if ((old & CC_EN) && !(value & CC_EN))
+            reset();
+
+        // Nothing is cached, so shutting down is instantaneous.
+        if ((value >> CC_SHN_SHIFT) & CC_SHN_MASK)
+            regCSTS |= CSTS_SHST_DONE;
+        break;
+      }
+      case AQA:
+        regAQA = value;
+        break;
+      case ASQ:
+        regASQ = insertBits(regASQ, 31, 0, value);
+        break;
+      case ASQ + 4:
+        regASQ = insertBits(regASQ, 63, 32, value);
+        break;
+      case ACQ:
+        regACQ = insertBits(regACQ, 31, 0, value);
+        break;
+      case ACQ + 4:
+        regACQ = insertBits(regACQ, 63, 32, value);
+        break;
+      default:
+        DPRINTF(Nvme, "Ignoring write to read-only register %#x\n", offset);
+        break;
+    }
+}
+
+void
+NvmeController::writeDoorbell(Addr offset, uint32_t value)
+{
+    const unsigned qid = (offset - DOORBELL) / 8;
+    const bool completion = (offset - DOORBELL) % 8;
+
+    if (qid > numQueues || (offset & 0x3)) {
+        warn("%s: Write to invalid doorbell %#x\n", name(), offset);
+        return;
+    }
+
+    if (!completion) {
+        SubmissionQueue &sq = sqs[qid];
+        if (!sq.valid || value >= sq.size) {
+            warn("%s: Invalid tail %d for SQ %d\n", name(), value, qid);
+            return;
+        }
+        sq.tail = value;
+        if (!kickEvent.scheduled())
+            schedule(kickEvent, curTick());
+    } else {
+        CompletionQueue &cq = cqs[qid];
+        if (!cq.valid || value >= cq.size) {
+            warn("%s: Invalid head %d for CQ %d\n", name(), value, qid);
+            return;
+        }
+        cq.head = value;
+        while (!cq.waiting.empty() && !cq.full()) {
+            Command *cmd = cq.waiting.front();
+            cq.waiting.pop_front();
+            postCompletion(*cmd);
+        }
+        updateIntx();
+    }
+}
+
+void
+NvmeController::enable()
+{
+    const unsigned sq_size = (regAQA & AQA_ASQS_MASK) + 1;
+    const unsigned cq_size = ((regAQA >> AQA_ACQS_SHIFT) & AQA_ASQS_MASK) + 1;
+    if (sq_size < 2 || cq_size < 2 || !regASQ || !regACQ) {
+        warn("%s: Invalid admin queue configuration\n", name());
+        regCSTS |= CSTS_CFS;
+        return;
+    }
+
+    DPRINTF(Nvme, "Enabling controller, admin SQ %#x/%d CQ %#x/%d\n",
+            regASQ, sq_size, regACQ, cq_size);
+
+    SubmissionQueue &sq = sqs[0];
+    sq = SubmissionQueue();
+    sq.valid = true;
+    sq.base = regASQ & ~(PageBytes - 1);
+    sq.size = sq_size;
+
+    CompletionQueue &cq = cqs[0];
+    cq = CompletionQueue();
+    cq.valid = true;
+    cq.base = regACQ & ~(PageBytes - 1);
+    cq.size = cq_size;
+    cq.ien = true;
+
+    regCSTS = CSTS_RDY;
+}
+
+void
+NvmeController::reset()
+{
+    DPRINTF(Nvme, "Resetting controller\n");
+
+    // Commands in flight finish their current step and are then
+    // dropped, see stale(). Commands waiting for room in a completion
+    // queue aren't waiting for anything else.
+    ++generation;
+    for (auto &cq : cqs) {
+        for (Command *cmd : cq.waiting)
+            release(*cmd);
+        cq = CompletionQueue();
+    }
+    for (auto &sq : sqs)
+        sq = SubmissionQueue();
+
+    regCSTS = 0;
+    intMask = 0;
+    updateIntx();
+}
+
+////
+// PCI configuration space
+////
+
+Tick
+NvmeController::readConfig(PacketPtr pkt)
+{
+    const int offset = pkt->getAddr() & PCI_CONFIG_SIZE;
+    if (offset < PCI_DEVICE_SPECIFIC)
+        return PciDevice::readConfig(pkt);
+
+    // Only the MSI-X capability is implemented, everything else in the
+    // device specific area reads as zero.
+    uint8_t data[sizeof(uint32_t)] = {};
+    const unsigned size = pkt->getSize();
+    assert(size <= sizeof(data));
+    for (unsigned i = 0; i < size; ++i) {
+        const int reg = offset + i - MSIXCAP_BASE;
+        if (MSIXCAP_BASE && reg >= 0 && reg < MSIXCAP_SIZE)
+            data[i] = msixcap.data[reg];
+    }
+    pkt->setData(data);
+
+    DPRINTF(Nvme, "Config read %#x size: %d\n", offset, size);
+    pkt->makeAtomicResponse();
+    return configDelay;
+}
+
+Tick
+NvmeController::writeConfig(PacketPtr pkt)
+{
+    const int offset = pkt->getAddr() & PCI_CONFIG_SIZE;
+    if (offset < PCI_DEVICE_SPECIFIC)
+        return PciDevice::writeConfig(pkt);
+
+    // Only the MSI-X Enable and Function Mask bits are writable.
+    const unsigned size = pkt->getSize();
+    const int mxc_hi = MSIXCAP_BASE + MSIXCAP_MXC + 1;
+    if (MSIXCAP_BASE && offset <= mxc_hi && offset + size > mxc_hi) {
+        const uint8_t *data = pkt->getConstPtr<uint8_t>();
+        const uint8_t ctrl = data[mxc_hi - offset] & 0xC0;
+        const bool was_masked = msixcap.mxc & 0x4000;
+        msixcap.mxc = (msixcap.mxc & 0x3FFF) | (ctrl << 8);
+
+        DPRINTF(Nvme, "MSI-X control %#x\n", msixcap.mxc);
+
+        // Deliver pending messages when the function is unmasked.
+        if (was_masked && msixEnabled()) {
+            for (unsigned v = 0; v < msix_table.size(); ++v) {
+                if (!msixMasked(v) &&
+                    bits(msix_pba[v / MSIXVECS_PER_PBA].bits,
+                         v % MSIXVECS_PER_PBA))
+                    sendMsix(v);
+            }
+        }
+        updateIntx();
+    }
+
+    pkt->makeAtomicResponse();
+    return configDelay;
+}
+
+////
+// Interrupts
+////
+
+bool
+NvmeController::msixEnabled() const
+{
+    return MSIXCAP_BASE && (msixcap.mxc & 0x8000);
+}
+
+bool
+NvmeController::msixMasked(unsigned vector) const
+{
+    return (msixcap.mxc & 0x4000) || (msix_table[vector].fields.vec_ctrl & 1);
+}
+
+void
+NvmeController::sendMsix(unsigned vector)
+{
+    if (vector >= msix_table.size()) {
+        warn("%s: Invalid MSI-X vector %d\n", name(), vector);
+        return;
+    }
+
+    MSIXPbaEntry &pba = msix_pba[vector / MSIXVECS_PER_PBA];
+    const unsigned bit = vector % MSIXVECS_PER_PBA;
+    if (msixMasked(vector)) {
+        DPRINTF(Nvme, "MSI-X vector %d masked, setting pending bit\n",
+                vector);
+        pba.bits |= 1ULL << bit;
+        return;
+    }
+    pba.bits &= ~(1ULL << bit);
+
+    MSIXTable &entry = msix_table[vector];
+    const Addr addr = ((Addr)entry.fields.addr_hi << 32) |
+        entry.fields.addr_lo;
+    DPRINTF(Nvme, "MSI-X vector %d: writing %#x to %#x\n", vector,
+            entry.fields.msg_data, addr);
+    dmaWrite(pciToDma(addr), sizeof(entry.fields.msg_data), NULL,
+             (uint8_t *)&entry.fields.msg_data);
+    msixMessages++;
+}
+
+void
+NvmeController::updateIntx()
+{
+    // The interrupt pin is level triggered, and stays asserted as long
+    // as there are unmasked completions the host hasn't consumed.
+    bool level = false;
+    if (!msixEnabled()) {
+        for (const auto &cq : cqs) {
+            if (cq.valid && cq.ien && cq.head != cq.writtenTail &&
+                !(intMask & (1U << (cq.vector & 0x1F)))) {
+                level = true;
+                break;
+            }
+        }
+    }
+
+    if (level == intxAsserted)
+        return;
+
+    DPRINTF(Nvme, "%s interrupt pin\n", level ? "Asserting" : "Clearing");
+    intxAsserted = level;
+    if (level)
+        intrPost();
+    else
+        intrClear();
+}
+
+bool
+NvmeController::isMsixAccess(Addr offset) const
+{
+    return MSIXCAP_BASE &&
+        ((offset >= MSIX_TABLE_OFFSET && offset < MSIX_TABLE_END) ||
+         (offset >= MSIX_PBA_OFFSET && offset < MSIX_PBA_END));
+}
+
+uint64_t
+NvmeController::readMsix(Addr offset, unsigned size) const
+{
+    const uint8_t *base;
+    if (offset >= MSIX_TABLE_OFFSET && offset < MSIX_TABLE_END) {
+        offset -= MSIX_TABLE_OFFSET;
+        base = (const uint8_t *)msix_table.data();
+    } else {
+        offset -= MSIX_PBA_OFFSET;
+        base = (const uint8_t *)msix_pba.data();
+    }
+
+    uint64_t value = 0;
+    memcpy(&value, base + offset, size);
+    return value;
+}
+
+void
+NvmeController::writeMsix(Addr offset, unsigned size, uint64_t value)
+{
+    // The pending bit array is read-only.
+    if (offset < MSIX_TABLE_OFFSET || offset >= MSIX_TABLE_END)
+        return;
+
+    offset -= MSIX_TABLE_OFFSET;
+    memcpy((uint8_t *)msix_table.data() + offset, &value, size);
+
+    // Unmasking a vector delivers its pending message.
+    const unsigned vector = offset / sizeof(MSIXTable);
+    const MSIXPbaEntry &pba = msix_pba[vector / MSIXVECS_PER_PBA];
+    if (msixEnabled() && !msixMasked(vector) &&
+        bits(pba.bits, vector % MSIXVECS_PER_PBA))
+        sendMsix(vector);
+}
+
+////
+// Command processing
+////
+
+void
+NvmeController::kick()
+{
+    if (!(regCSTS & CSTS_RDY) || drainState() != DrainState::Running)
+        return;
+
+    // Fetch one command at a time from each queue that has any, until
+    // all queues are empty or there are no free command slots.
+    bool fetched = true;
+    while (fetched && !freeCommands.empty()) {
+        fetched = false;
+        for (unsigned i = 0; i <= numQueues && !freeCommands.empty(); ++i) {
+            const uint16_t qid = nextSq;
+            nextSq = (nextSq + 1) % (numQueues + 1);
+
+            SubmissionQueue &sq = sqs[qid];
+            if (!sq.valid || sq.head == sq.tail)
+                continue;
+
+            Command &cmd = *freeCommands.back();
+            freeCommands.pop_back();
+
+            cmd.generation = generation;
+            cmd.sqid = qid;
+            cmd.cqid = sq.cqid;
+            const Addr addr = sq.base + sq.head * SQE_SIZE;
+            sq.head = (sq.head + 1) % sq.size;
+
+            DPRINTF(Nvme, "Fetching SQ %d entry at %#x\n", qid, addr);
+            dmaRead(pciToDma(addr), SQE_SIZE, &cmd.fetchEvent,
+                    (uint8_t *)&cmd.sqe);
+            fetched = true;
+        }
+    }
+}
+
+bool
+NvmeController::stale(Command &cmd)
+{
+    if (cmd.generation == generation)
+        return false;
+
+    DPRINTF(Nvme, "Dropping command %d after reset\n", cmd.sqe.cid);
+    release(cmd);
+    return true;
+}
+
+void
+NvmeController::fetchDone(Command &cmd)
+{
+    if (stale(cmd))
+        return;
+
+    DPRINTF(Nvme, "SQ %d command %d opcode %#x\n", cmd.sqid,
+            letoh(cmd.sqe.cid), cmd.sqe.opcode);
+
+    cmd.dir = DirNone;
+    cmd.media = false;
+    cmd.data.clear();
+    execute(cmd);
+}
+
+void
+NvmeController::execute(Command &cmd)
+{
+    if (cmd.sqid == 0)
+        executeAdmin(cmd);
+    else
+        executeIO(cmd);
+}
+
+void
+NvmeController::executeAdmin(Command &cmd)
+{
+    const SubmissionEntry &sqe = cmd.sqe;
+    adminCommands++;
+
+    switch (sqe.opcode) {
+      case ADMIN_CREATE_CQ:
+        complete(cmd, createCQ(sqe));
+        break;
+      case ADMIN_CREATE_SQ:
+        complete(cmd, createSQ(sqe));
+        break;
+      case ADMIN_DELETE_CQ:
+        complete(cmd, deleteCQ(sqe));
+        break;
+      case ADMIN_DELETE_SQ:
+        complete(cmd, deleteSQ(sqe));
+        break;
+      case ADMIN_IDENTIFY:
+        identify(cmd);
+        break;
+      case ADMIN_GET_LOG: {
+        // No log pages are implemented, they all read as zero.
+        const size_t size = (bits(letoh(sqe.cdw10), 27, 16) + 1) * 4;
+        startTransfer(cmd, DirToHost, std::min<size_t>(size, PageBytes));
+        break;
+      }
+      case ADMIN_SET_FEATURES:
+      case ADMIN_GET_FEATURES: {
+        // The number of queues is the only feature that matters,
+        // everything else is accepted and ignored.
+        uint32_t result = 0;
+        if (bits(letoh(sqe.cdw10), 7, 0) == FEAT_NUM_QUEUES)
+            result = (numQueues - 1) | ((numQueues - 1) << 16);
+        complete(cmd, SC_SUCCESS, result);
+        break;
+      }
+      case ADMIN_ABORT:
+        // Commands aren't aborted, which bit 0 of the result reports.
+        complete(cmd, SC_SUCCESS, 1);
+        break;
+      case ADMIN_ASYNC_EVENT:
+        // No events are ever reported, so the request stays
+        // outstanding forever. It doesn't need a command slot.
+        release(cmd);
+        break;
+      default:
+        warn("%s: Unsupported admin opcode %#x\n", name(), sqe.opcode);
+        complete(cmd, SC_INVALID_OPCODE);
+        break;
+    }
+}
+
+uint16_t
+NvmeController::createCQ(const SubmissionEntry &sqe)
+{
+    const uint16_t qid = bits(letoh(sqe.cdw10), 15, 0);
+    const unsigned size = bits(letoh(sqe.cdw10), 31, 16) + 1;
+    const uint32_t flags = letoh(sqe.cdw11);
+    const uint16_t vector = bits(flags, 31, 16);
+
+    if (qid == 0 || qid > numQueues || cqs[qid].valid)
+        return SC_INVALID_QID;
+    if (size < 2 || size > maxQueueEntries)
+        return SC_INVALID_QSIZE;
+    if (!(flags & 0x1))
+        return SC_INVALID_FIELD;
+    if (vector >= std::max<size_t>(msix_table.size(), 1))
+        return SC_INVALID_VECTOR;
+
+    CompletionQueue &cq = cqs[qid];
+    cq = CompletionQueue();
+    cq.valid = true;
+    cq.base = letoh(sqe.prp1);
+    cq.size = size;
+    cq.ien = flags & 0x2;
+    cq.vector = vector;
+
+    DPRINTF(Nvme, "Created CQ %d at %#x size %d vector %d\n", qid, cq.base,
+            size, vector);
+    return SC_SUCCESS;
+}
+
+uint16_t
+NvmeController::createSQ(const SubmissionEntry &sqe)
+{
+    const uint16_t qid = bits(letoh(sqe.cdw10), 15, 0);
+    const unsigned size = bits(letoh(sqe.cdw10), 31, 16) + 1;
+    const uint32_t flags = letoh(sqe.cdw11);
+    const uint16_t cqid = bits(flags, 31, 16);
+
+    if (qid == 0 || qid > numQueues || sqs[qid].valid)
+        return SC_INVALID_QID;
+    if (size < 2 || size > maxQueueEntries)
+        return SC_INVALID_QSIZE;
+    if (!(flags & 0x1))
+        return SC_INVALID_FIELD;
+    if (cqid == 0 || cqid > numQueues || !cqs[cqid].valid)
+        return SC_INVALID_CQ;
+
+    SubmissionQueue &sq = sqs[qid];
+    sq = SubmissionQueue();
+    sq.valid = true;
+    sq.base = letoh(sqe.prp1);
+    sq.size = size;
+    sq.cqid = cqid;
+
+    DPRINTF(Nvme, "Created SQ %d at %#x size %d CQ %d\n", qid, sq.base,
+            size, cqid);
+    return SC_SUCCESS;
+}
+
+uint16_t
+NvmeController::deleteCQ(const SubmissionEntry &sqe)
+{
+    const uint16_t qid = bits(letoh(sqe.cdw10), 15, 0);
+    if (qid == 0 || qid > numQueues || !cqs[qid].valid)
+        return SC_INVALID_QID;
+
+    for (const auto &sq : sqs) {
+        if (sq.valid && sq.cqid == qid)
+            return SC_INVALID_DELETE;
+    }
+
+    // Completions that are still waiting for room are lost with the
+    // queue.
+    CompletionQueue &cq = cqs[qid];
+    for (Command *cmd : cq.waiting)
+        release(*cmd);
+    cq = CompletionQueue();
+    updateIntx();
+
+    DPRINTF(Nvme, "Deleted CQ %d\n", qid);
+    return SC_SUCCESS;
+}
+
+uint16_t
+NvmeController::deleteSQ(const SubmissionEntry &sqe)
+{
+    const uint16_t qid = bits(letoh(sqe.cdw10), 15, 0);
+    if (qid == 0 || qid > numQueues || !sqs[qid].valid)
+        return SC_INVALID_QID;
+
+    sqs[qid] = SubmissionQueue();
+
+    DPRINTF(Nvme, "Deleted SQ %d\n", qid);
+    return SC_SUCCESS;
+}
+
+void
+NvmeController::identify(Command &cmd)
+{
+    const SubmissionEntry &sqe = cmd.sqe;
+    const uint8_t cns = bits(letoh(sqe.cdw10), 7, 0);
+    std::vector<uint8_t> data(IDENTIFY_SIZE, 0);
+
+    // Copy a string into a space padded field
+    auto set_string = [&data](unsigned offset, unsigned size,
+                              const std::string &str) {
+        memset(data.data() + offset, ' ', size);
+        memcpy(data.data() + offset, str.data(),
+               std::min<size_t>(str.size(), size));
+    };
+
+    switch (cns) {
+      case CNS_CONTROLLER: {
+        // Both IDs are already little endian in the config header.
+        memcpy(data.data() + 0, &config.vendor, sizeof(config.vendor));
+        memcpy(data.data() + 2, &config.subsystemVendorID,
+               sizeof(config.subsystemVendorID));
+        set_string(4, 20, csprintf("%02x%02x%x", _busAddr.bus,
+                                   _busAddr.dev, _busAddr.func));
+        set_string(24, 40, "gem5 NVMe Controller");
+        set_string(64, 8, "1.0");
+        // Maximum data transfer size in units of the page size
+        data[77] = floorLog2(maxTransfer / PageBytes);
+        const uint32_t version = htole(VERSION);
+        memcpy(data.data() + 80, &version, sizeof(version));
+        // Abort and asynchronous event request limits (zero based)
+        data[258] = 3;
+        data[259] = 3;
+        data[512] = (SQES << 4) | SQES;
+        data[513] = (CQES << 4) | CQES;
+        const uint32_t nn = htole(1);
+        memcpy(data.data() + 516, &nn, sizeof(nn));
+        break;
+      }
+      case CNS_NAMESPACE: {
+        if (letoh(sqe.nsid) != 1) {
+            complete(cmd, SC_INVALID_NAMESPACE);
+            return;
+        }
+        const uint64_t size = htole(sectors);
+        // Namespace size, capacity and utilization
+        memcpy(data.data() + 0, &size, sizeof(size));
+        memcpy(data.data() + 8, &size, sizeof(size));
+        memcpy(data.data() + 16, &size, sizeof(size));
+        // A single LBA format with 512 byte sectors
+        data[128 + 2] = floorLog2(SectorSize);
+        break;
+      }
+      case CNS_ACTIVE_NS_LIST: {
+        if (letoh(sqe.nsid) == 0) {
+            const uint32_t nsid = htole(1);
+            memcpy(data.data(), &nsid, sizeof(nsid));
+        }
+        break;
+      }
+      default:
+        complete(cmd, SC_INVALID_FIELD);
+        return;
+    }
+
+    cmd.data.swap(data);
+    startTransfer(cmd, DirToHost, cmd.data.size());
+}
+
+void
+NvmeController::executeIO(Command &cmd)
+{
+    const SubmissionEntry &sqe = cmd.sqe;
+
+    if (letoh(sqe.nsid) != 1) {
+        complete(cmd, SC_INVALID_NAMESPACE);
+        return;
+    }
+
+    switch (sqe.opcode) {
+      case NVM_FLUSH:
+        // Writes go straight to the image, there is no cache to flush.
+        complete(cmd, SC_SUCCESS);
+        break;
+      case NVM_READ:
+      case NVM_WRITE: {
+        const bool is_read = sqe.opcode == NVM_READ;
+        const uint64_t lba =
+            letoh(sqe.cdw10) | ((uint64_t)letoh(sqe.cdw11) << 32);
+        const uint64_t count = bits(letoh(sqe.cdw12), 15, 0) + 1;
+        const size_t size = count * SectorSize;
+
+        if (lba + count > sectors || lba + count < lba) {
+            complete(cmd, SC_LBA_RANGE);
+            return;
+        }
+        if (size > maxTransfer) {
+            complete(cmd, SC_INVALID_FIELD);
+            return;
+        }
+
+        DPRINTF(Nvme, "%s LBA %d count %d\n", is_read ? "Read" : "Write",
+                lba, count);
+
+        cmd.lba = lba;
+        cmd.media = true;
+        if (is_read) {
+            readCommands++;
+            readBytes += size;
+        } else {
+            writeCommands++;
+            writeBytes += size;
+        }
+        startTransfer(cmd, is_read ? DirToHost : DirFromHost, size);
+        break;
+      }
+      default:
+        warn("%s: Unsupported I/O opcode %#x\n", name(), sqe.opcode);
+        complete(cmd, SC_INVALID_OPCODE);
+        break;
+    }
+}
+
+////
+// Data transfers
+////
+
+void
+NvmeController::startTransfer(Command &cmd, Direction dir, size_t size)
+{
+    cmd.dir = dir;
+    cmd.data.resize(size);
+    cmd.prps.clear();
+
+    // PRP1 may start anywhere in a page. If the rest of the data
+    // doesn't fit in one more page, PRP2 points to a list of pages.
+    const Addr prp1 = letoh(cmd.sqe.prp1);
+    const size_t first = std::min<size_t>(size,
+                                          PageBytes - (prp1 % PageBytes));
+    const unsigned pages = divCeil(size - first, PageBytes);
+    if (pages == 0) {
+        prpsReady(cmd);
+    } else if (pages == 1) {
+        cmd.prps.push_back(letoh(cmd.sqe.prp2));
+        prpsReady(cmd);
+    } else {
+        cmd.prpsLeft = pages;
+        cmd.prpListAddr = letoh(cmd.sqe.prp2);
+        readPrpList(cmd);
+    }
+}
+
+void
+NvmeController::readPrpList(Command &cmd)
+{
+    // Read up to the end of the list page. If there are more entries
+    // than that, the last one points to the next list page.
+    const unsigned avail =
+        (PageBytes - (cmd.prpListAddr % PageBytes)) / sizeof(uint64_t);
+    cmd.prpListEntries = cmd.prpsLeft <= avail ? cmd.prpsLeft : avail;
+
+    DPRINTF(Nvme, "Reading %d PRP entries at %#x\n", cmd.prpListEntries,
+            cmd.prpListAddr);
+    dmaRead(pciToDma(cmd.prpListAddr),
+            cmd.prpListEntries * sizeof(uint64_t), &cmd.prpEvent,
+            (uint8_t *)cmd.prpListBuf);
+}
+
+void
+NvmeController::prpListDone(Command &cmd)
+{
+    if (stale(cmd))
+        return;
+
+    unsigned entries = cmd.prpListEntries;
+    const bool chained = entries < cmd.prpsLeft;
+    if (chained)
+        --entries;
+
+    for (unsigned i = 0; i < entries; ++i)
+        cmd.prps.push_back(letoh(cmd.prpListBuf[i]));
+    cmd.prpsLeft -= entries;
+
+    if (chained) {
+        cmd.prpListAddr = letoh(cmd.prpListBuf[entries]);
+        readPrpList(cmd);
+    } else {
+        prpsReady(cmd);
+    }
+}
+
+void
+NvmeController::prpsReady(Command &cmd)
+{
+    // Reads access the medium before the data is sent to the host,
+    // writes after it has been received from the host.
+    if (cmd.dir == DirToHost && cmd.media) {
+        image->readSectors(cmd.data.data(), cmd.lba,
+                           cmd.data.size() / SectorSize);
+        startMedia(cmd);
+    } else {
+        startDma(cmd);
+    }
+}
+
+void
+NvmeController::startDma(Command &cmd)
+{
+    TransferCallback *cb = new TransferCallback(cmd);
+
+    // Issue one DMA request per run of physically contiguous pages.
+    const size_t size = cmd.data.size();
+    Addr addr = letoh(cmd.sqe.prp1);
+    size_t len = std::min<size_t>(size, PageBytes - (addr % PageBytes));
+    size_t offset = 0;
+    for (unsigned i = 0; i <= cmd.prps.size(); ++i) {
+        const size_t next_len = std::min<size_t>(size - offset - len,
+                                                 PageBytes);
+        const bool contiguous =
+            i < cmd.prps.size() && cmd.prps[i] == addr + len;
+        if (contiguous) {
+            len += next_len;
+            continue;
+        }
+
+        uint8_t *data = cmd.data.data() + offset;
+        if (cmd.dir == DirToHost)
+            dmaWrite(pciToDma(addr), len, cb->getChunkEvent(), data);
+        else
+            dmaRead(pciToDma(addr), len, cb->getChunkEvent(), data);
+
+        offset += len;
+        if (i < cmd.prps.size()) {
+            addr = cmd.prps[i];
+            len = next_len;
+        }
+    }
+    assert(offset == size);
+}
+
+void
+NvmeController::transferDone(Command &cmd)
+{
+    if (stale(cmd))
+        return;
+
+    if (cmd.dir == DirFromHost && cmd.media) {
+        image->writeSectors(cmd.data.data(), cmd.lba,
+                            cmd.data.size() / SectorSize);
+        startMedia(cmd);
+    } else {
+        complete(cmd, SC_SUCCESS);
+    }
+}
+
+void
+NvmeController::startMedia(Command &cmd)
+{
+    const uint64_t addr = cmd.lba * SectorSize;
+    const uint32_t size = cmd.data.size();
+    if (!nvm)
+        schedule(cmd.mediaEvent, curTick() + mediaLatency);
+    else if (cmd.dir == DirToHost)
+        nvm->readMemory(addr, size, &cmd.mediaCallback);
+    else
+        nvm->writeMemory(addr, size, &cmd.mediaCallback);
+}
+
+void
+NvmeController::mediaDone(Command &cmd)
+{
+    if (stale(cmd))
+        return;
+
+    if (cmd.dir == DirToHost)
+        startDma(cmd);
+    else
+        complete(cmd, SC_SUCCESS);
+}
+
+////
+// Completions
+////
+
+void
+NvmeController::complete(Command &cmd, uint16_t status, uint32_t result)
+{
+    DPRINTF(Nvme, "Command %d on SQ %d done, status %#x result %#x\n",
+            letoh(cmd.sqe.cid), cmd.sqid, status, result);
+
+    cmd.cqe.result = htole(result);
+    cmd.cqe.reserved = 0;
+    cmd.cqe.sqid = htole(cmd.sqid);
+    cmd.cqe.cid = cmd.sqe.cid;
+    cmd.cqe.status = status << 1;
+
+    CompletionQueue &cq = cqs[cmd.cqid];
+    if (!cq.valid) {
+        warn("%s: Dropping completion for invalid CQ %d\n", name(),
+             cmd.cqid);
+        release(cmd);
+    } else if (cq.full() || !cq.waiting.empty()) {
+        DPRINTF(Nvme, "CQ %d full, delaying completion\n", cmd.cqid);
+        completionStalls++;
+        cq.waiting.push_back(&cmd);
+    } else {
+        postCompletion(cmd);
+    }
+}
+
+void
+NvmeController::postCompletion(Command &cmd)
+{
+    CompletionQueue &cq = cqs[cmd.cqid];
+    assert(cq.valid && !cq.full());
+
+    const SubmissionQueue &sq = sqs[cmd.sqid];
+    cmd.cqe.sqHead = htole(sq.head);
+    cmd.cqe.status = htole((uint16_t)((cmd.cqe.status & ~1) | cq.phase));
+    cmd.cqSlot = cq.tail;
+
+    const Addr addr = cq.base + cq.tail * CQE_SIZE;
+    cq.tail = (cq.tail + 1) % cq.size;
+    if (cq.tail == 0)
+        cq.phase = !cq.phase;
+
+    dmaWrite(pciToDma(addr), CQE_SIZE, &cmd.cqeEvent, (uint8_t *)&cmd.cqe);
+}
+
+void
+NvmeController::completionWritten(Command &cmd)
+{
+    if (stale(cmd))
+        return;
+
+    // Completion entries of a queue are written in order.
+    CompletionQueue &cq = cqs[cmd.cqid];
+    if (cq.valid) {
+        cq.writtenTail = (cmd.cqSlot + 1) % cq.size;
+        if (cq.ien) {
+            if (msixEnabled())
+                sendMsix(cq.vector);
+            else
+                updateIntx();
+        }
+    }
+
+    release(cmd);
+    if (!kickEvent.scheduled())
+        schedule(kickEvent, curTick());
+}
+
+void
+NvmeController::release(Command &cmd)
+{
+    freeCommands.push_back(&cmd);
+    if (drainState() == DrainState::Draining &&
+        freeCommands.size() == commands.size())
+        signalDrainDone();
+}
+
+////
+// Draining and checkpointing
+////
+
+DrainState
+NvmeController::drain()
+{
+    // No new commands are fetched while draining, see kick().
+    if (freeCommands.size() == commands.size())
+        return DrainState::Drained;
+
+    DPRINTF(Drain, "%s: %d commands in flight\n", name(),
+            commands.size() - freeCommands.size());
+    return DrainState::Draining;
+}
+
+void
+NvmeController::drainResume()
+{
+    PciDevice::drainResume();
+    if (!kickEvent.scheduled())
+        schedule(kickEvent, curTick());
+}
+
+void
+NvmeController::serialize(CheckpointOut &cp) const
+{
+    PciDevice::serialize(cp);
+
+    SERIALIZE_SCALAR(regCC);
+    SERIALIZE_SCALAR(regCSTS);
+    SERIALIZE_SCALAR(regAQA);
+    SERIALIZE_SCALAR(regASQ);
+    SERIALIZE_SCALAR(regACQ);
+    SERIALIZE_SCALAR(intMask);
+    SERIALIZE_SCALAR(intxAsserted);
+    SERIALIZE_SCALAR(nextSq);
+
+    for (unsigned i = 0; i <= numQueues; ++i) {
+        const SubmissionQueue &sq = sqs[i];
+        paramOut(cp, csprintf("sq%d.valid", i), sq.valid);
+        paramOut(cp, csprintf("sq%d.base", i), sq.base);
+        paramOut(cp, csprintf("sq%d.size", i), sq.size);
+        paramOut(cp, csprintf("sq%d.head", i), sq.head);
+        paramOut(cp, csprintf("sq%d.tail", i), sq.tail);
+        paramOut(cp, csprintf("sq%d.cqid", i), sq.cqid);
+
+        const CompletionQueue &cq = cqs[i];
+        assert(cq.waiting.empty());
+        paramOut(cp, csprintf("cq%d.valid", i), cq.valid);
+        paramOut(cp, csprintf("cq%d.base", i), cq.base);
+        paramOut(cp, csprintf("cq%d.size", i), cq.size);
+        paramOut(cp, csprintf("cq%d.head", i), cq.head);
+        paramOut(cp, csprintf("cq%d.tail", i), cq.tail);
+        paramOut(cp, csprintf("cq%d.phase", i), cq.phase);
+        paramOut(cp, csprintf("cq%d.ien", i), cq.ien);
+        paramOut(cp, csprintf("cq%d.vector", i), cq.vector);
+    }
+}
+
+void
+NvmeController::unserialize(CheckpointIn &cp)
+{
+    PciDevice::unserialize(cp);
+
+    UNSERIALIZE_SCALAR(regCC);
+    UNSERIALIZE_SCALAR(regCSTS);
+    UNSERIALIZE_SCALAR(regAQA);
+    UNSERIALIZE_SCALAR(regASQ);
+    UNSERIALIZE_SCALAR(regACQ);
+    UNSERIALIZE_SCALAR(intMask);
+    UNSERIALIZE_SCALAR(intxAsserted);
+    UNSERIALIZE_SCALAR(nextSq);
+
+    for (unsigned i = 0; i <= numQueues; ++i) {
+        SubmissionQueue &sq = sqs[i];
+        paramIn(cp, csprintf("sq%d.valid", i), sq.valid);
+        paramIn(cp, csprintf("sq%d.base", i), sq.base);
+        paramIn(cp, csprintf("sq%d.size", i), sq.size);
+        paramIn(cp, csprintf("sq%d.head", i), sq.head);
+        paramIn(cp, csprintf("sq%d.tail", i), sq.tail);
+        paramIn(cp, csprintf("sq%d.cqid", i), sq.cqid);
+
+        // All completions had been written when the checkpoint was
+        // taken.
+        CompletionQueue &cq = cqs[i];
+        paramIn(cp, csprintf("cq%d.valid", i), cq.valid);
+        paramIn(cp, csprintf("cq%d.base", i), cq.base);
+        paramIn(cp, csprintf("cq%d.size", i), cq.size);
+        paramIn(cp, csprintf("cq%d.head", i), cq.head);
+        paramIn(cp, csprintf("cq%d.tail", i), cq.tail);
+        paramIn(cp, csprintf("cq%d.phase", i), cq.phase);
+        paramIn(cp, csprintf("cq%d.ien", i), cq.ien);
+        paramIn(cp, csprintf("cq%d.vector", i), cq.vector);
+        cq.writtenTail = cq.tail;
+    }
+
+    if (!kickEvent.scheduled())
+        schedule(kickEvent, curTick());
+}
+
+NvmeController *
+NvmeControllerParams::create()
+{
+    return new NvmeController(this);
+}
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * NVM Express controller with a single namespace backed by a disk image
+ */
+
+#ifndef __DEV_STORAGE_NVME_HH__
+#define __DEV_STORAGE_NVME_HH__
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "base/callback.hh"
+#include "base/statistics.hh"
+#include "dev/pci/device.hh"
+#include "dev/storage/nvme_defs.hh"
+#include "sim/eventq.hh"
+
+class AbstractNVM;
+class DiskImage;
+struct NvmeControllerParams;
+
+/**
+ * NVMe controller.
+ *
+ * The controller exposes one namespace backed by a DiskImage. The host
+ * creates up to num_queues pairs of I/O submission and completion
+ * queues in addition to the admin queue pair. Commands are fetched
+ * from the submission queues in round-robin order into a fixed pool
+ * of command slots, so many commands from different queues can be in
+ * flight at the same time. Data is moved with DMA using the PRP
+ * entries of each command.
+ *
+ * The time spent accessing the storage medium is either modelled by
+ * an AbstractNVM, such as a FlashDevice, or is a fixed latency.
+ *
+ * Completions are signalled with MSI-X messages if the host has
+ * enabled MSI-X, and with the legacy interrupt pin otherwise. The
+ * MSI-X table and pending bit array live in BAR0 after the doorbells.
+ */
+class NvmeController : public PciDevice
+{
+  public:
+    typedef NvmeControllerParams Params;
+    NvmeController(const Params *p);
+    ~NvmeController();
+
+    void regStats() override;
+
+    Tick read(PacketPtr pkt) override;
+    Tick write(PacketPtr pkt) override;
+
+    Tick readConfig(PacketPtr pkt) override;
+    Tick writeConfig(PacketPtr pkt) override;
+
+    DrainState drain() override;
+    void drainResume() override;
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
+  protected:
+    /** Memory page size, CC.MPS is fixed at 0 */
+    static const Addr PageBytes = 4096;
+
+    /** Data transfer direction of a command */
+    enum Direction {
+        DirNone,
+        DirToHost,
+        DirFromHost,
+    };
+
+    struct SubmissionQueue
+    {
+        SubmissionQueue()
+            : valid(false), base(0), size(0), head(0), tail(0), cqid(0)
+        { }
+
+        bool valid;
+        Addr base;
+        uint16_t size;
+        uint16_t head;
+        uint16_t tail;
+        uint16_t cqid;
+    };
+
+    class Command;
+
+    struct CompletionQueue
+    {
+        CompletionQueue()
+            : valid(false), base(0), size(0), head(0), tail(0),
+              writtenTail(0), phase(true), ien(false), vector(0)
+        { }
+
+        bool full() const { return (tail + 1) % size == head; }
+
+        bool valid;
+        Addr base;
+        uint16_t size;
+        uint16_t head;
+        /** Next entry to fill */
+        uint16_t tail;
+        /** Entry after the last one that has reached memory */
+        uint16_t writtenTail;
+        bool phase;
+        bool ien;
+        uint16_t vector;
+        /** Completed commands waiting for room in the queue */
+        std::deque<Command *> waiting;
+    };
+
+    /**
+     * Command slot. Holds a fetched submission entry and its state
+     * until its completion entry has been written to memory.
+     */
+    class Command
+    {
+      public:
+        Command(NvmeController &_ctrl, unsigned index);
+
+        const std::string name() const { return _name; }
+
+        NvmeController &ctrl;
+        const std::string _name;
+
+        /** Controller reset generation the command was fetched in */
+        uint64_t generation;
+
+        uint16_t sqid;
+        uint16_t cqid;
+        NvmeReg::SubmissionEntry sqe;
+        NvmeReg::CompletionEntry cqe;
+        /** Completion queue entry index, used to track written entries */
+        uint16_t cqSlot;
+
+        Direction dir;
+        /** Does the command access the storage medium? */
+        bool media;
+        /** First sector accessed by a read or write */
+        uint64_t lba;
+        std::vector<uint8_t> data;
+
+        /** @{ */
+        /**
+         * Memory pages after the first one (PRP1), and the state of
+         * the PRP list walk that collects them.
+         */
+        std::vector<Addr> prps;
+        unsigned prpsLeft;
+        Addr prpListAddr;
+        uint64_t prpListBuf[PageBytes / sizeof(uint64_t)];
+        unsigned prpListEntries;
+        /** @} */
+
+        EventFunctionWrapper fetchEvent;
+        EventFunctionWrapper prpEvent;
+        EventFunctionWrapper mediaEvent;
+        EventFunctionWrapper cqeEvent;
+
+        void mediaDone() { ctrl.mediaDone(*this); }
+        /** Called by the media model when an access has completed */
+        MakeCallback<Command, &Command::mediaDone> mediaCallback;
+    };
+
+    /** Completion of all DMA chunks of a command's data transfer */
+    class TransferCallback : public DmaCallback
+    {
+      public:
+        TransferCallback(Command &cmd) : cmd(cmd) { }
+        const std::string name() const override { return cmd.name(); }
+
+      protected:
+        void process() override { cmd.ctrl.transferDone(cmd); }
+
+        Command &cmd;
+    };
+
+    /** @{ */
+    /** Register interface */
+    uint32_t readReg(Addr offset) const;
+    void writeReg(Addr offset, uint32_t value);
+    void writeDoorbell(Addr offset, uint32_t value);
+    /** @} */
+
+    /** @{ */
+    /** Controller state transitions */
+    void enable();
+    void reset();
+    /** @} */
+
+    /** @{ */
+    /** Command processing */
+    void kick();
+    void fetchDone(Command &cmd);
+    void execute(Command &cmd);
+    void executeAdmin(Command &cmd);
+    void executeIO(Command &cmd);
+    uint16_t createCQ(const NvmeReg::SubmissionEntry &sqe);
+    uint16_t createSQ(const NvmeReg::SubmissionEntry &sqe);
+    uint16_t deleteCQ(const NvmeReg::SubmissionEntry &sqe);
+    uint16_t deleteSQ(const NvmeReg::SubmissionEntry &sqe);
+    void identify(Command &cmd);
+
+    /** Prepare a transfer of size bytes and start the PRP walk. */
+    void startTransfer(Command &cmd, Direction dir, size_t size);
+    void readPrpList(Command &cmd);
+    void prpListDone(Command &cmd);
+    void prpsReady(Command &cmd);
+    void startDma(Command &cmd);
+    void transferDone(Command &cmd);
+    void startMedia(Command &cmd);
+    void mediaDone(Command &cmd);
+
+    void complete(Command &cmd, uint16_t status, uint32_t result = 0);
+    void postCompletion(Command &cmd);
+    void completionWritten(Command &cmd);
+    void release(Command &cmd);
+    /** Was the command fetched before the last controller reset? */
+    bool stale(Command &cmd);
+    /** @} */
+
+    /** @{ */
+    /** Interrupts */
+    bool msixEnabled() const;
+    bool msixMasked(unsigned vector) const;
+    void sendMsix(unsigned vector);
+    void updateIntx();
+    /** @} */
+
+    /** @{ */
+    /** MSI-X table and PBA accesses */
+    bool isMsixAccess(Addr offset) const;
+    uint64_t readMsix(Addr offset, unsigned size) const;
+    void writeMsix(Addr offset, unsigned size, uint64_t value);
+    /** @} */
+
+    DiskImage *image;
+    AbstractNVM *nvm;
+    /** Number of sectors in the namespace */
+    uint64_t sectors;
+
+    const Tick mediaLatency;
+    const uint16_t numQueues;
+    const uint16_t maxQueueEntries;
+    const size_t maxTransfer;
+
+    /** @{ */
+    /** Controller registers */
+    uint32_t regCC;
+    uint32_t regCSTS;
+    uint32_t regAQA;
+    uint64_t regASQ;
+    uint64_t regACQ;
+    uint32_t intMask;
+    /** @} */
+
+    bool intxAsserted;
+    uint64_t generation;
+
+    /** Queues, indexed by queue ID. Queue 0 is the admin queue. */
+    std::vector<SubmissionQueue> sqs;
+    std::vector<CompletionQueue> cqs;
+    /** Next submission queue to fetch from */
+    uint16_t nextSq;
+
+    std::vector<std::unique_ptr<Command>> commands;
+    std::vector<Command *> freeCommands;
+
+    EventFunctionWrapper kickEvent;
+
+    Stats::Scalar adminCommands;
+    Stats::Scalar readCommands;
+    Stats::Scalar writeCommands;
+    Stats::Scalar readBytes;
+    Stats::Scalar writeBytes;
+    Stats::Scalar completionStalls;
+    Stats::Scalar msixMessages;
+};
+
+#endif // __DEV_STORAGE_NVME_HH__
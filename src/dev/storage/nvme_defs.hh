@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Register, queue entry and command definitions from the NVM Express
+ * 1.2 specification.
+ */
+
+#ifndef __DEV_STORAGE_NVME_DEFS_HH__
+#define __DEV_STORAGE_NVME_DEFS_HH__
+
+#include <cstdint>
+
+namespace NvmeReg {
+
+// Controller registers in BAR0
+const uint32_t CAP      = 0x00;
+const uint32_t VS       = 0x08;
+const uint32_t INTMS    = 0x0C;
+const uint32_t INTMC    = 0x10;
+const uint32_t CC       = 0x14;
+const uint32_t CSTS     = 0x1C;
+const uint32_t AQA      = 0x24;
+const uint32_t ASQ      = 0x28;
+const uint32_t ACQ      = 0x30;
+
+/**
+ * Doorbells start at 0x1000. With a stride of 0 (CAP.DSTRD), queue y
+ * has its submission tail doorbell at 0x1000 + 8 * y and its
+ * completion head doorbell at 0x1000 + 8 * y + 4.
+ */
+const uint32_t DOORBELL = 0x1000;
+
+/** Version 1.2 */
+const uint32_t VERSION = 0x00010200;
+
+// CAP fields
+const uint64_t CAP_CQR = 1ULL << 16;
+const int CAP_TO_SHIFT = 24;
+const uint64_t CAP_CSS_NVM = 1ULL << 37;
+
+// CC fields
+const uint32_t CC_EN = 0x1;
+const int CC_MPS_SHIFT = 7;
+const uint32_t CC_MPS_MASK = 0xF;
+const int CC_SHN_SHIFT = 14;
+const uint32_t CC_SHN_MASK = 0x3;
+
+// CSTS fields
+const uint32_t CSTS_RDY = 0x1;
+const uint32_t CSTS_CFS = 0x2;
+const uint32_t CSTS_SHST_DONE = 0x2 << 2;
+
+// AQA fields
+const uint32_t AQA_ASQS_MASK = 0xFFF;
+const int AQA_ACQS_SHIFT = 16;
+
+/** Size of a submission queue entry */
+const unsigned SQE_SIZE = 64;
+/** Size of a completion queue entry */
+const unsigned CQE_SIZE = 16;
+/** log2 of the entry sizes, as reported by Identify */
+const uint8_t SQES = 6;
+const uint8_t CQES = 4;
+
+/** Size of Identify and log page data */
+const unsigned IDENTIFY_SIZE = 4096;
+
+// Admin command opcodes
+const uint8_t ADMIN_DELETE_SQ   = 0x00;
+const uint8_t ADMIN_CREATE_SQ   = 0x01;
+const uint8_t ADMIN_GET_LOG     = 0x02;
+const uint8_t ADMIN_DELETE_CQ   = 0x04;
+const uint8_t ADMIN_CREATE_CQ   = 0x05;
+const uint8_t ADMIN_IDENTIFY    = 0x06;
+const uint8_t ADMIN_ABORT       = 0x08;
+const uint8_t ADMIN_SET_FEATURES = 0x09;
+const uint8_t ADMIN_GET_FEATURES = 0x0A;
+const uint8_t ADMIN_ASYNC_EVENT = 0x0C;
+
+// NVM command opcodes
+const uint8_t NVM_FLUSH = 0x00;
+const uint8_t NVM_WRITE = 0x01;
+const uint8_t NVM_READ  = 0x02;
+
+// Identify CNS values
+const uint8_t CNS_NAMESPACE = 0x00;
+const uint8_t CNS_CONTROLLER = 0x01;
+const uint8_t CNS_ACTIVE_NS_LIST = 0x02;
+
+// Feature identifiers
+const uint8_t FEAT_NUM_QUEUES = 0x07;
+
+// Status codes (generic command status, SCT 0)
+const uint16_t SC_SUCCESS           = 0x00;
+const uint16_t SC_INVALID_OPCODE    = 0x01;
+const uint16_t SC_INVALID_FIELD     = 0x02;
+const uint16_t SC_INTERNAL          = 0x06;
+const uint16_t SC_INVALID_NAMESPACE = 0x0B;
+const uint16_t SC_LBA_RANGE         = 0x80;
+
+// Status codes (command specific status, SCT 1)
+const uint16_t SC_INVALID_CQ        = 0x100;
+const uint16_t SC_INVALID_QID       = 0x101;
+const uint16_t SC_INVALID_QSIZE     = 0x102;
+const uint16_t SC_INVALID_VECTOR    = 0x108;
+const uint16_t SC_INVALID_DELETE    = 0x10C;
+
+/** Submission queue entry */
+struct SubmissionEntry {
+    uint8_t opcode;
+    uint8_t flags;
+    uint16_t cid;
+    uint32_t nsid;
+    uint64_t reserved;
+    uint64_t mptr;
+    uint64_t prp1;
+    uint64_t prp2;
+    uint32_t cdw10;
+    uint32_t cdw11;
+    uint32_t cdw12;
+    uint32_t cdw13;
+    uint32_t cdw14;
+    uint32_t cdw15;
+};
+
+/** Completion queue entry */
+struct CompletionEntry {
+    uint32_t result;
+    uint32_t reserved;
+    uint16_t sqHead;
+    uint16_t sqid;
+    uint16_t cid;
+    /** Phase tag in bit 0, status field in bits 1-15 */
+    uint16_t status;
+};
+
+static_assert(sizeof(SubmissionEntry) == SQE_SIZE,
+              "Unexpected submission entry size");
+static_assert(sizeof(CompletionEntry) == CQE_SIZE,
+              "Unexpected completion entry size");
+
+} // namespace NvmeReg
+
+#endif // __DEV_STORAGE_NVME_DEFS_HH__
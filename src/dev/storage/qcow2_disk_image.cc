@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dev/storage/qcow2_disk_image.hh"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/DiskImageRead.hh"
+#include "sim/byteswap.hh"
+
+using namespace std;
+
+namespace
+{
+
+/** Header of a qcow2 file (big endian) */
+struct Qcow2Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t backing_file_offset;
+    uint32_t backing_file_size;
+    uint32_t cluster_bits;
+    uint64_t size;
+    uint32_t crypt_method;
+    uint32_t l1_size;
+    uint64_t l1_table_offset;
+    uint64_t refcount_table_offset;
+    uint32_t refcount_table_clusters;
+    uint32_t nb_snapshots;
+    uint64_t snapshots_offset;
+
+    // Version 3 and later
+    uint64_t incompatible_features;
+    uint64_t compatible_features;
+    uint64_t autoclear_features;
+    uint32_t refcount_order;
+    uint32_t header_length;
+} M5_ATTR_PACKED;
+
+const uint32_t Qcow2Magic = 0x514649fb; // "QFI\xfb"
+
+/** Size of a version 2 header */
+const size_t Qcow2HeaderV2Size = offsetof(Qcow2Header, incompatible_features);
+
+/** Incompatible feature bits that don't prevent reading */
+const uint64_t Qcow2DirtyBit = 1ULL << 0;
+
+/** @{
+ * @name L1 and L2 table entry fields
+ */
+const uint64_t Qcow2OffsetMask = 0x00fffffffffffe00ULL;
+const uint64_t Qcow2Compressed = 1ULL << 62;
+const uint64_t Qcow2ZeroCluster = 1ULL << 0;
+/** @} */
+
+} // anonymous namespace
+
+Qcow2DiskImage::Layer::Layer(const string &_file, size_t l2_cache_size)
+    : file(_file), fd(-1), qcow(false), _size(0),
+      clusterBits(0), clusterSize(0), l2Bits(0),
+      l2CacheSize(max<size_t>(l2_cache_size, 1)), compressedEntry(0)
+{
+    fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Error opening %s: %s\n", file, strerror(errno));
+
+    Qcow2Header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    const ssize_t hdr_len = pread(fd, &hdr, sizeof(hdr), 0);
+
+    if (hdr_len < (ssize_t)sizeof(hdr.magic) ||
+        betoh(hdr.magic) != Qcow2Magic) {
+        // Not a qcow2 file, treat it as a raw image.
+        const off_t end = lseek(fd, 0, SEEK_END);
+        if (end < 0)
+            fatal("Could not determine the size of %s\n", file);
+        _size = end;
+        return;
+    }
+
+    if (hdr_len < (ssize_t)Qcow2HeaderV2Size)
+        fatal("%s: Truncated qcow2 header\n", file);
+
+    qcow = true;
+    const uint32_t version = betoh(hdr.version);
+    if (version != 2 && version != 3)
+        fatal("%s: Unsupported qcow2 version %i\n", file, version);
+
+    if (version >= 3) {
+        const uint64_t features = betoh(hdr.incompatible_features);
+        if (features & ~Qcow2DirtyBit)
+            fatal("%s: Unsupported qcow2 features: %#x\n", file, features);
+    }
+
+    if (betoh(hdr.crypt_method) != 0)
+        fatal("%s: Encrypted qcow2 images are not supported\n", file);
+
+    clusterBits = betoh(hdr.cluster_bits);
+    if (clusterBits < 9 || clusterBits > 21)
+        fatal("%s: Invalid cluster size (%i bits)\n", file, clusterBits);
+    clusterSize = 1ULL << clusterBits;
+    l2Bits = clusterBits - 3;
+    _size = betoh(hdr.size);
+
+    l1.resize(betoh(hdr.l1_size));
+    readFile(l1.data(), l1.size() * sizeof(uint64_t),
+             betoh(hdr.l1_table_offset));
+    for (auto &entry : l1)
+        entry = betoh(entry);
+
+    const uint64_t backing_offset = betoh(hdr.backing_file_offset);
+    if (backing_offset) {
+        string name(betoh(hdr.backing_file_size), '\0');
+        readFile(&name[0], name.size(), backing_offset);
+
+        // Relative backing file names are relative to this image.
+        if (name[0] != '/') {
+            const size_t slash = file.rfind('/');
+            if (slash != string::npos)
+                name = file.substr(0, slash + 1) + name;
+        }
+
+        backing.reset(new Layer(name, l2_cache_size));
+    }
+}
+
+Qcow2DiskImage::Layer::~Layer()
+{
+    ::close(fd);
+}
+
+void
+Qcow2DiskImage::Layer::readFile(void *dst, size_t len, uint64_t pos) const
+{
+    uint8_t *buf = (uint8_t *)dst;
+    while (len) {
+        const ssize_t ret = pread(fd, buf, len, pos);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            panic("%s: Failed to read %i bytes @ %#x\n", file, len, pos);
+        buf += ret;
+        pos += ret;
+        len -= ret;
+    }
+}
+
+void
+Qcow2DiskImage::Layer::readRaw(uint8_t *dst, uint64_t pos, size_t len) const
+{
+    const size_t avail = pos < _size ? min<uint64_t>(len, _size - pos) : 0;
+    if (avail)
+        readFile(dst, avail, pos);
+    memset(dst + avail, 0, len - avail);
+}
+
+const vector<uint64_t> &
+Qcow2DiskImage::Layer::l2Table(uint64_t offset)
+{
+    auto it = l2Index.find(offset);
+    if (it != l2Index.end()) {
+        l2Cache.splice(l2Cache.begin(), l2Cache, it->second);
+        return it->second->second;
+    }
+
+    // Reuse the least recently used table when the cache is full.
+    if (l2Cache.size() >= l2CacheSize) {
+        l2Index.erase(l2Cache.back().first);
+        l2Cache.splice(l2Cache.begin(), l2Cache, prev(l2Cache.end()));
+    } else {
+        l2Cache.emplace_front();
+    }
+
+    auto &table = l2Cache.front();
+    table.first = offset;
+    table.second.resize(clusterSize / sizeof(uint64_t));
+    readFile(table.second.data(), clusterSize, offset);
+    for (auto &entry : table.second)
+        entry = betoh(entry);
+    l2Index[offset] = l2Cache.begin();
+
+    return table.second;
+}
+
+void
+Qcow2DiskImage::Layer::readCompressed(uint64_t entry)
+{
+    if (entry == compressedEntry)
+        return;
+
+    // The entry holds the host offset and the number of additional
+    // 512 byte sectors that the compressed data extends into.
+    const unsigned shift = 62 - (clusterBits - 8);
+    const uint64_t offset = entry & ((1ULL << shift) - 1);
+    const uint64_t sectors =
+        ((entry >> shift) & ((1ULL << (clusterBits - 8)) - 1)) + 1;
+    const size_t len = sectors * 512 - (offset & 511);
+
+    // The last cluster in the file may be shorter than the length in
+    // its entry.
+    vector<uint8_t> in(len);
+    const ssize_t got = pread(fd, in.data(), len, offset);
+    if (got <= 0)
+        panic("%s: Failed to read compressed cluster @ %#x\n", file, offset);
+
+    compressedData.resize(clusterSize);
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    strm.next_in = in.data();
+    strm.avail_in = got;
+    strm.next_out = compressedData.data();
+    strm.avail_out = clusterSize;
+
+    // Clusters are compressed as raw deflate streams.
+    if (inflateInit2(&strm, -12) != Z_OK)
+        panic("%s: Failed to initialize zlib\n", file);
+    const int ret = inflate(&strm, Z_FINISH);
+    const uint64_t out = strm.total_out;
+    inflateEnd(&strm);
+
+    if ((ret != Z_STREAM_END && ret != Z_BUF_ERROR) || out != clusterSize)
+        panic("%s: Corrupt compressed cluster @ %#x\n", file, offset);
+
+    compressedEntry = entry;
+}
+
+void
+Qcow2DiskImage::Layer::read(uint8_t *dst, uint64_t pos, size_t len)
+{
+    if (!qcow) {
+        readRaw(dst, pos, len);
+        return;
+    }
+
+    if (pos >= _size) {
+        memset(dst, 0, len);
+        return;
+    }
+    if (len > _size - pos) {
+        memset(dst + (_size - pos), 0, len - (_size - pos));
+        len = _size - pos;
+    }
+
+    // Reads of clusters that are contiguous in the file are merged
+    // into a single system call.
+    uint8_t *run_dst = NULL;
+    uint64_t run_pos = 0;
+    size_t run_len = 0;
+
+    while (len) {
+        const uint64_t cluster = pos >> clusterBits;
+        const uint64_t l1_idx = cluster >> l2Bits;
+        const uint64_t l2_idx = cluster & ((1ULL << l2Bits) - 1);
+        const uint64_t in_cluster = pos & (clusterSize - 1);
+        const size_t chunk = min<uint64_t>(len, clusterSize - in_cluster);
+
+        uint64_t entry = 0;
+        if (l1_idx < l1.size() && (l1[l1_idx] & Qcow2OffsetMask))
+            entry = l2Table(l1[l1_idx] & Qcow2OffsetMask)[l2_idx];
+
+        const uint64_t host = entry & Qcow2OffsetMask;
+        const bool allocated = !(entry & Qcow2Compressed) && host &&
+            !(entry & Qcow2ZeroCluster);
+
+        const bool contiguous = host + in_cluster == run_pos + run_len;
+        if (run_len && (!allocated || !contiguous)) {
+            readFile(run_dst, run_len, run_pos);
+            run_len = 0;
+        }
+
+        if (allocated) {
+            if (!run_len) {
+                run_dst = dst;
+                run_pos = host + in_cluster;
+            }
+            run_len += chunk;
+        } else if (entry & Qcow2Compressed) {
+            readCompressed(entry);
+            memcpy(dst, compressedData.data() + in_cluster, chunk);
+        } else if (backing && !(entry & Qcow2ZeroCluster)) {
+            backing->read(dst, pos, chunk);
+        } else {
+            memset(dst, 0, chunk);
+        }
+
+        dst += chunk;
+        pos += chunk;
+        len -= chunk;
+    }
+
+    if (run_len)
+        readFile(run_dst, run_len, run_pos);
+}
+
+Qcow2DiskImage::Qcow2DiskImage(const Params *p)
+    : DiskImage(p)
+{
+    if (!p->read_only)
+        fatal("%s: qcow2 images can only be opened read-only, use a "
+              "CowDiskImage on top of the image to modify it.\n", name());
+
+    image.reset(new Layer(p->image_file, p->l2_cache_size));
+    initialized = true;
+}
+
+Qcow2DiskImage::~Qcow2DiskImage()
+{
+}
+
+std::streampos
+Qcow2DiskImage::size() const
+{
+    return image->size() / SectorSize;
+}
+
+std::streampos
+Qcow2DiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+Qcow2DiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    panic("Cannot write to a read only disk image");
+}
+
+std::streampos
+Qcow2DiskImage::readSectors(uint8_t *data, std::streampos offset,
+                            size_t count) const
+{
+    const uint64_t sectors = size();
+    if ((uint64_t)offset >= sectors)
+        return 0;
+    count = min<uint64_t>(count, sectors - offset);
+
+    image->read(data, (uint64_t)offset * SectorSize, count * SectorSize);
+
+    DPRINTF(DiskImageRead, "read: offset=%d count=%d\n",
+            (uint64_t)offset, count);
+    DDUMP(DiskImageRead, data, count * SectorSize);
+
+    return count * SectorSize;
+}
+
+Qcow2DiskImage *
+Qcow2DiskImageParams::create()
+{
+    return new Qcow2DiskImage(this);
+}
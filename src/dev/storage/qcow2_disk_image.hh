@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Read-only access to qcow2 disk images
+ */
+
+#ifndef __DEV_STORAGE_QCOW2_DISK_IMAGE_HH__
+#define __DEV_STORAGE_QCOW2_DISK_IMAGE_HH__
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dev/storage/disk_image.hh"
+#include "params/Qcow2DiskImage.hh"
+
+/**
+ * Disk image backed by a qcow2 file.
+ *
+ * Only the clusters that have been written are stored in a qcow2
+ * file. The rest is read from an optional backing file or reads as
+ * zeros, so many images can share a common base. Clusters may also
+ * be zlib compressed.
+ *
+ * The image is opened read-only. Use a CowDiskImage on top of it to
+ * let the guest write to the disk.
+ *
+ * Guest addresses are translated in two levels. The L1 table is read
+ * when the image is opened. L2 tables are read on demand and kept in
+ * an LRU cache of l2_cache_size tables. The most recently used
+ * compressed cluster is also cached, since consecutive sector reads
+ * usually hit the same cluster.
+ */
+class Qcow2DiskImage : public DiskImage
+{
+  protected:
+    /**
+     * One image in a chain of backing files. The image is either a
+     * qcow2 file or a raw file, which can only appear as a backing
+     * file.
+     */
+    class Layer
+    {
+      public:
+        Layer(const std::string &file, size_t l2_cache_size);
+        ~Layer();
+
+        /** Size of the image in bytes. */
+        uint64_t size() const { return _size; }
+
+        /**
+         * Read from the image. Data beyond the end of the image reads
+         * as zeros.
+         *
+         * @param dst Destination buffer.
+         * @param pos Guest byte offset.
+         * @param len Number of bytes to read.
+         */
+        void read(uint8_t *dst, uint64_t pos, size_t len);
+
+      protected:
+        /** Get an L2 table from the cache, reading it on a miss. */
+        const std::vector<uint64_t> &l2Table(uint64_t offset);
+        /** Read a compressed cluster into compressedData. */
+        void readCompressed(uint64_t entry);
+        /** Read from the file, failing on short reads. */
+        void readFile(void *dst, size_t len, uint64_t pos) const;
+        /** Read from the file in a raw layer. */
+        void readRaw(uint8_t *dst, uint64_t pos, size_t len) const;
+
+        const std::string file;
+        int fd;
+        bool qcow;
+        uint64_t _size;
+
+        unsigned clusterBits;
+        uint64_t clusterSize;
+        unsigned l2Bits;
+
+        std::vector<uint64_t> l1;
+        std::unique_ptr<Layer> backing;
+
+        typedef std::list<std::pair<uint64_t, std::vector<uint64_t>>>
+            L2List;
+        /** L2 tables, most recently used first */
+        L2List l2Cache;
+        std::unordered_map<uint64_t, L2List::iterator> l2Index;
+        const size_t l2CacheSize;
+
+        /** L2 entry of the cluster in compressedData, or 0 */
+        uint64_t compressedEntry;
+        std::vector<uint8_t> compressedData;
+    };
+
+    std::unique_ptr<Layer> image;
+
+  public:
+    typedef Qcow2DiskImageParams Params;
+    Qcow2DiskImage(const Params *p);
+    ~Qcow2DiskImage();
+
+    std::streampos size() const override;
+
+    std::streampos read(uint8_t *data, std::streampos offset) const override;
+    std::streampos write(const uint8_t *data, std::streampos offset) override;
+
+    std::streampos readSectors(uint8_t *data, std::streampos offset,
+                               size_t count) const override;
+};
+
+#endif // __DEV_STORAGE_QCOW2_DISK_IMAGE_HH__
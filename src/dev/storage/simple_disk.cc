@@ -68,8 +68,7 @@ SimpleDisk::read(Addr addr, baddr_t block, int count) const
     if (count & (SectorSize - 1))
         panic("Not reading a multiple of a sector (count = %d)", count);
 
-    for (int i = 0, j = 0; i < count; i += SectorSize, j++)
-        image->read(data + i, block + j);
+    image->readSectors(data, block, count / SectorSize);
 
     system->physProxy.writeBlob(addr, data, count);
 
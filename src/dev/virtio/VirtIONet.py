@@ -0,0 +1,50 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from VirtIO import VirtIODeviceBase
+
+class VirtIONet(VirtIODeviceBase):
+    type = 'VirtIONet'
+    cxx_header = 'dev/virtio/net.hh'
+
+    interface = MasterPort("Ethernet Interface")
+    hardware_address = Param.EthernetAddr(NextEthernetAddr,
+        "Ethernet Hardware Address")
+
+    numQueuePairs = Param.Unsigned(1, "Number of receive/transmit queue pairs")
+    queueSize = Param.Unsigned(256,
+        "Size of each receive and transmit queue (descriptors)")
+    mergeableRxBufs = Param.Bool(True, "Offer mergeable receive buffers")
+
+    rxFifoSize = Param.MemorySize('384kB', "Size of the receive FIFO")
+    txFifoSize = Param.MemorySize('384kB', "Size of the transmit FIFO")
+
+    intDelay = Param.Latency('10us',
+        "Maximum time to hold back a guest notification (0 to disable)")
+    intMaxPackets = Param.Unsigned(32,
+        "Number of completed packets that forces a guest notification")
@@ -286,6 +286,27 @@ VirtQueue::consumeDescriptor()
     return d;
 }
 
+uint16_t
+VirtQueue::pendingDescriptors()
+{
+    avail.readHeader();
+    return avail.header.index - _last_avail;
+}
+
+VirtDescriptor *
+VirtQueue::peekDescriptor(uint16_t offset)
+{
+    avail.read();
+    if ((uint16_t)(avail.header.index - _last_avail) <= offset)
+        return NULL;
+
+    const uint16_t slot(_last_avail + offset);
+    VirtDescriptor *d(&descriptors[avail.ring[slot % used.ring.size()]]);
+    d->updateChain();
+
+    return d;
+}
+
 void
 VirtQueue::produceDescriptor(VirtDescriptor *desc, uint32_t len)
 {
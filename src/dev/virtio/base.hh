@@ -371,6 +371,25 @@ public:
      * descriptors are available.
      */
     VirtDescriptor *consumeDescriptor();
+    /**
+     * Get the number of descriptor chains that the guest has made
+     * available but that haven't been consumed yet.
+     *
+     * @return Number of pending descriptor chains.
+     */
+    uint16_t pendingDescriptors();
+    /**
+     * Look at a pending descriptor chain without consuming it.
+     *
+     * This allows device models to check that enough buffer space is
+     * available before committing to consume a series of descriptor
+     * chains.
+     *
+     * @param offset Offset from the next chain to be consumed.
+     * @return Pointer to descriptor on success, NULL if fewer than
+     * offset + 1 chains are pending.
+     */
+    VirtDescriptor *peekDescriptor(uint16_t offset = 0);
     /**
      * Send a descriptor chain to the guest.
      *
@@ -773,6 +792,9 @@ class VirtIODeviceBase : public SimObject
      */
     QueueID getQueueSelect() const { return _queueSelect; }
 
+    /** Get the number of queues registered by the device model. */
+    QueueID numQueues() const { return _queues.size(); }
+
     /**
      * Change the host physical address of the currently active queue.
      *
@@ -80,12 +80,11 @@ VirtIOBlock::read(const BlkRequest &req, VirtDescriptor *desc_chain,
     if (size % SectorSize != 0)
         panic("Unexpected request/sector size relationship\n");
 
-    for (Addr offset = 0; offset < size; offset += SectorSize) {
-        if (image.read(data + offset, sector) != SectorSize) {
-            warn("Failed to read sector %i\n", sector);
-            return S_IOERR;
-        }
-        ++sector;
+    if (image.readSectors(data, sector, size / SectorSize) !=
+        (std::streamoff)size) {
+        warn("Failed to read sectors %i-%i\n",
+             sector, sector + size / SectorSize - 1);
+        return S_IOERR;
     }
 
     desc_chain->chainWrite(off_data, data, size);
@@ -109,12 +108,11 @@ VirtIOBlock::write(const BlkRequest &req, VirtDescriptor *desc_chain,
 
     desc_chain->chainRead(off_data, data, size);
 
-    for (Addr offset = 0; offset < size; offset += SectorSize) {
-        if (image.write(data + offset, sector) != SectorSize) {
-            warn("Failed to write sector %i\n", sector);
-            return S_IOERR;
-        }
-        ++sector;
+    if (image.writeSectors(data, sector, size / SectorSize) !=
+        (std::streamoff)size) {
+        warn("Failed to write sectors %i-%i\n",
+             sector, sector + size / SectorSize - 1);
+        return S_IOERR;
     }
 
     return S_OK;
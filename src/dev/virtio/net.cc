@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dev/virtio/net.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/inet.hh"
+#include "debug/VIONet.hh"
+#include "params/VirtIONet.hh"
+#include "sim/system.hh"
+
+using namespace Net;
+
+VirtIONet::VirtIONet(Params *params)
+    : VirtIODeviceBase(params, ID_NET, sizeof(Config),
+                       F_MAC | F_STATUS |
+                       (params->mergeableRxBufs ? F_MRG_RXBUF : 0) |
+                       (params->numQueuePairs > 1 ? F_CTRL_VQ | F_MQ : 0)),
+      ctrlQueue(params->system->physProxy, 64, *this),
+      activePairs(1),
+      interface(new VirtIONetInt(name() + ".int0", this)),
+      rxFifo(params->rxFifoSize), txFifo(params->txFifoSize),
+      intDelay(params->intDelay), intMaxPackets(params->intMaxPackets),
+      intPending(0),
+      intEvent([this]{ sendInterrupt(); }, name())
+{
+    fatal_if(params->numQueuePairs < 1 ||
+             params->numQueuePairs > 0x8000,
+             "%s: Invalid number of queue pairs (%i)\n",
+             name(), params->numQueuePairs);
+
+    // The guest driver expects the receive and transmit queues of
+    // each pair to be interleaved, followed by the control queue.
+    for (unsigned i = 0; i < params->numQueuePairs; ++i) {
+        rxQueues.emplace_back(new RxQueue(params->system->physProxy,
+                                          params->queueSize, *this, i));
+        txQueues.emplace_back(new TxQueue(params->system->physProxy,
+                                          params->queueSize, *this, i));
+        registerQueue(*rxQueues.back());
+        registerQueue(*txQueues.back());
+    }
+    if (deviceFeatures & F_CTRL_VQ)
+        registerQueue(ctrlQueue);
+
+    memcpy(config.mac, params->hardware_address.bytes(), ETH_ADDR_LEN);
+    config.status = S_LINK_UP;
+    config.max_virtqueue_pairs = params->numQueuePairs;
+}
+
+VirtIONet::~VirtIONet()
+{
+    delete interface;
+}
+
+void
+VirtIONet::readConfig(PacketPtr pkt, Addr cfgOffset)
+{
+    Config cfg_out(config);
+    cfg_out.status = htov_legacy(config.status);
+    cfg_out.max_virtqueue_pairs = htov_legacy(config.max_virtqueue_pairs);
+
+    readConfigBlob(pkt, cfgOffset, (uint8_t *)&cfg_out);
+}
+
+void
+VirtIONet::reset()
+{
+    VirtIODeviceBase::reset();
+
+    activePairs = 1;
+    rxFifo.clear();
+    txFifo.clear();
+
+    intPending = 0;
+    if (intEvent.scheduled())
+        deschedule(intEvent);
+}
+
+void
+VirtIONet::serialize(CheckpointOut &cp) const
+{
+    VirtIODeviceBase::serialize(cp);
+
+    SERIALIZE_SCALAR(activePairs);
+    SERIALIZE_SCALAR(intPending);
+    Tick int_time = intEvent.scheduled() ? intEvent.when() : 0;
+    SERIALIZE_SCALAR(int_time);
+
+    rxFifo.serialize("rxFifo", cp);
+    txFifo.serialize("txFifo", cp);
+}
+
+void
+VirtIONet::unserialize(CheckpointIn &cp)
+{
+    VirtIODeviceBase::unserialize(cp);
+
+    UNSERIALIZE_SCALAR(activePairs);
+    UNSERIALIZE_SCALAR(intPending);
+    Tick int_time;
+    UNSERIALIZE_SCALAR(int_time);
+    if (int_time)
+        schedule(intEvent, int_time);
+
+    rxFifo.unserialize("rxFifo", cp);
+    txFifo.unserialize("txFifo", cp);
+}
+
+void
+VirtIONet::regStats()
+{
+    VirtIODeviceBase::regStats();
+
+    rxPackets
+        .name(name() + ".rxPackets")
+        .desc("Number of packets delivered to the guest")
+        ;
+
+    rxBytes
+        .name(name() + ".rxBytes")
+        .desc("Number of bytes delivered to the guest")
+        ;
+
+    rxBuffers
+        .name(name() + ".rxBuffers")
+        .desc("Number of receive buffers used")
+        ;
+
+    txPackets
+        .name(name() + ".txPackets")
+        .desc("Number of packets sent to the network")
+        ;
+
+    txBytes
+        .name(name() + ".txBytes")
+        .desc("Number of bytes sent to the network")
+        ;
+
+    rxFifoDrops
+        .name(name() + ".rxFifoDrops")
+        .desc("Number of packets dropped because the receive FIFO was full")
+        ;
+
+    interrupts
+        .name(name() + ".interrupts")
+        .desc("Number of guest notifications")
+        ;
+
+    packetsPerInterrupt
+        .name(name() + ".packetsPerInterrupt")
+        .desc("Average number of packets completed per notification")
+        .precision(2)
+        ;
+    packetsPerInterrupt = (rxPackets + txPackets) / interrupts;
+}
+
+EtherInt *
+VirtIONet::getEthPort(const std::string &if_name, int idx)
+{
+    if (if_name == "interface") {
+        if (interface->getPeer())
+            panic("interface already connected to\n");
+        return interface;
+    }
+    return NULL;
+}
+
+size_t
+VirtIONet::headerSize() const
+{
+    if (guestFeatures & F_MRG_RXBUF)
+        return sizeof(NetHeader);
+    else
+        return sizeof(NetHeader) - sizeof(uint16_t);
+}
+
+bool
+VirtIONet::recvPacket(EthPacketPtr pkt)
+{
+    if (!getDeviceStatus().driver_ok) {
+        DPRINTF(VIONet, "Driver not ready, dropping packet\n");
+        return true;
+    }
+
+    if (!rxFifo.push(pkt)) {
+        DPRINTF(VIONet, "Receive FIFO full, dropping packet\n");
+        ++rxFifoDrops;
+        return false;
+    }
+
+    rxDeliver();
+    return true;
+}
+
+void
+VirtIONet::transferDone()
+{
+    txKick();
+
+    // The transmit queues stop consuming descriptors when the FIFO
+    // fills up, so check them for more work now that there is space.
+    for (auto &q : txQueues) {
+        if (q->getAddress() != 0)
+            q->onNotify();
+    }
+}
+
+unsigned
+VirtIONet::rxSteer(EthPacketPtr pkt) const
+{
+    if (activePairs == 1)
+        return 0;
+
+    IpPtr ip(pkt);
+    if (!ip)
+        return 0;
+
+    uint32_t hash(ip->src() ^ ip->dst());
+    TcpPtr tcp(ip);
+    UdpPtr udp(ip);
+    if (tcp)
+        hash ^= (tcp->sport() << 16) ^ tcp->dport();
+    else if (udp)
+        hash ^= (udp->sport() << 16) ^ udp->dport();
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+
+    return hash % activePairs;
+}
+
+void
+VirtIONet::rxDeliver()
+{
+    unsigned completed(0);
+    while (!rxFifo.empty()) {
+        EthPacketPtr pkt(rxFifo.front());
+        if (!rxQueues[rxSteer(pkt)]->deliver(pkt))
+            break;
+
+        rxFifo.pop();
+        ++completed;
+    }
+
+    if (completed)
+        postInterrupt(completed);
+}
+
+bool
+VirtIONet::RxQueue::deliver(EthPacketPtr pkt)
+{
+    const bool mergeable(parent.guestFeatures & F_MRG_RXBUF);
+    const size_t hdr_size(parent.headerSize());
+    const size_t total(hdr_size + pkt->length);
+
+    // Make sure that the guest has posted enough buffers for the
+    // whole packet before consuming any of them.
+    uint16_t chains(0);
+    size_t space(0);
+    do {
+        VirtDescriptor *d(peekDescriptor(chains));
+        if (!d) {
+            DPRINTF(VIONet, "%s: Out of receive buffers\n", name());
+            return false;
+        }
+        space += d->chainSize();
+        ++chains;
+    } while (mergeable && space < total);
+
+    if (space < total) {
+        warn("%s: Dropping %i byte packet that doesn't fit the guest's "
+             "%i byte receive buffer\n", name(), pkt->length, space);
+        return true;
+    }
+
+    DPRINTF(VIONet, "%s: Delivering %i byte packet in %i buffer(s)\n",
+            name(), pkt->length, chains);
+
+    NetHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.num_buffers = htov_legacy(chains);
+
+    size_t offset(0);
+    for (uint16_t i = 0; i < chains; ++i) {
+        VirtDescriptor *d(consumeDescriptor());
+        assert(d);
+
+        size_t len(0);
+        if (i == 0) {
+            d->chainWrite(0, (uint8_t *)&hdr, hdr_size);
+            len = hdr_size;
+        }
+
+        const size_t chunk(std::min(d->chainSize() - len,
+                                    pkt->length - offset));
+        if (chunk) {
+            d->chainWrite(len, pkt->data + offset, chunk);
+            offset += chunk;
+            len += chunk;
+        }
+
+        produceDescriptor(d, len);
+    }
+    assert(offset == pkt->length);
+
+    parent.rxPackets++;
+    parent.rxBytes += pkt->length;
+    parent.rxBuffers += chains;
+
+    return true;
+}
+
+void
+VirtIONet::TxQueue::onNotify()
+{
+    const size_t hdr_size(parent.headerSize());
+    unsigned completed(0);
+
+    VirtDescriptor *d;
+    while ((d = peekDescriptor()) != NULL) {
+        const size_t size(d->chainSize());
+        const size_t len(size > hdr_size ? size - hdr_size : 0);
+
+        // Leave the descriptor to the guest until there is room for
+        // its packet, transferDone() will pick it up later.
+        if (len && parent.txFifo.avail() < len) {
+            DPRINTF(VIONet, "%s: Transmit FIFO full\n", name());
+            break;
+        }
+
+        consumeDescriptor();
+        if (len) {
+            EthPacketPtr pkt = std::make_shared<EthPacketData>(len);
+            d->chainRead(hdr_size, pkt->data, len);
+            pkt->length = len;
+            pkt->simLength = len;
+            parent.txFifo.push(pkt);
+            DPRINTF(VIONet, "%s: Queued %i byte packet\n", name(), len);
+        } else {
+            warn("%s: Ignoring empty transmit descriptor\n", name());
+        }
+
+        produceDescriptor(d, 0);
+        ++completed;
+    }
+
+    if (completed) {
+        parent.postInterrupt(completed);
+        parent.txKick();
+    }
+}
+
+void
+VirtIONet::txKick()
+{
+    while (!txFifo.empty()) {
+        EthPacketPtr pkt(txFifo.front());
+        if (!interface->sendPacket(pkt)) {
+            DPRINTF(VIONet, "Network busy, deferring transmit\n");
+            break;
+        }
+
+        txPackets++;
+        txBytes += pkt->length;
+        txFifo.pop();
+    }
+}
+
+void
+VirtIONet::CtrlQueue::onNotifyDescriptor(VirtDescriptor *desc)
+{
+    struct {
+        uint8_t cls;
+        uint8_t cmd;
+    } M5_ATTR_PACKED hdr;
+    desc->chainRead(0, (uint8_t *)&hdr, sizeof(hdr));
+
+    uint8_t ack(CTRL_ERR);
+    if (hdr.cls == CTRL_MQ && hdr.cmd == CTRL_MQ_VQ_PAIRS_SET) {
+        uint16_t pairs;
+        desc->chainRead(sizeof(hdr), (uint8_t *)&pairs, sizeof(pairs));
+        pairs = vtoh_legacy(pairs);
+        if (pairs >= 1 && pairs <= parent.rxQueues.size()) {
+            DPRINTF(VIONet, "Enabling %i queue pair(s)\n", pairs);
+            parent.activePairs = pairs;
+            ack = CTRL_OK;
+        }
+    } else {
+        DPRINTF(VIONet, "Unsupported control command %i:%i\n",
+                hdr.cls, hdr.cmd);
+    }
+
+    // The acknowledgement is the last byte of the chain.
+    desc->chainWrite(desc->chainSize() - sizeof(ack), &ack, sizeof(ack));
+    produceDescriptor(desc, sizeof(ack));
+    parent.kick();
+}
+
+void
+VirtIONet::postInterrupt(unsigned packets)
+{
+    intPending += packets;
+    if (intDelay == 0 || intPending >= intMaxPackets) {
+        if (intEvent.scheduled())
+            deschedule(intEvent);
+        sendInterrupt();
+    } else if (!intEvent.scheduled()) {
+        schedule(intEvent, curTick() + intDelay);
+    }
+}
+
+void
+VirtIONet::sendInterrupt()
+{
+    DPRINTF(VIONet, "Notifying guest of %i packet(s)\n", intPending);
+    ++interrupts;
+    intPending = 0;
+    kick();
+}
+
+VirtIONet *
+VirtIONetParams::create()
+{
+    return new VirtIONet(this);
+}
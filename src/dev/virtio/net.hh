@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DEV_VIRTIO_NET_HH__
+#define __DEV_VIRTIO_NET_HH__
+
+#include <memory>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "dev/net/etherint.hh"
+#include "dev/net/pktfifo.hh"
+#include "dev/virtio/base.hh"
+
+struct VirtIONetParams;
+class VirtIONetInt;
+
+/**
+ * VirtIO network device
+ *
+ * The network device uses the following queues:
+ *  -# Receive queue for queue pair 0
+ *  -# Transmit queue for queue pair 0
+ *  -# ...
+ *  -# Receive and transmit queues for queue pair N - 1
+ *  -# Control queue
+ *
+ * Every packet is preceded by a virtio_net_hdr in its descriptor
+ * chain. Checksum and segmentation offloads are not offered, so the
+ * header is ignored on transmit and zeroed on receive, except for the
+ * buffer count used by mergeable receive buffers.
+ *
+ * When the guest negotiates mergeable receive buffers (F_MRG_RXBUF),
+ * a received packet may be spread over several receive descriptor
+ * chains, which lets the driver post small buffers instead of
+ * buffers sized for the largest frame. When it negotiates multiple
+ * queue pairs (F_MQ), received packets are steered to a receive
+ * queue by hashing their IP flow, so that each guest CPU can service
+ * its own queue pair.
+ *
+ * Guest notifications are moderated: the device waits up to intDelay
+ * after producing a descriptor before kicking the guest, unless
+ * intMaxPackets packets have been completed in the meantime. A single
+ * interrupt then covers all the packets completed in that window.
+ *
+ * @see http://docs.oasis-open.org/virtio/virtio/v1.0/virtio-v1.0.html
+ */
+class VirtIONet : public VirtIODeviceBase
+{
+  public:
+    typedef VirtIONetParams Params;
+    VirtIONet(Params *params);
+    virtual ~VirtIONet();
+
+    void readConfig(PacketPtr pkt, Addr cfgOffset) override;
+    void reset() override;
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
+    void regStats() override;
+
+    /** Get the Ethernet interface of this device. */
+    EtherInt *getEthPort(const std::string &if_name, int idx);
+
+    /** @{
+     * @name Ethernet Interface Callbacks
+     */
+    /** Accept a packet from the simulated network. */
+    bool recvPacket(EthPacketPtr pkt);
+    /** The network is ready to accept another packet. */
+    void transferDone();
+    /** @} */
+
+  protected:
+    /** VirtIO device ID */
+    static const DeviceId ID_NET = 0x01;
+
+    /** @{
+     * @name Feature bits
+     */
+    /** Device has a MAC address in its configuration space */
+    static const FeatureBits F_MAC = (1 << 5);
+    /** Guest can merge receive buffers */
+    static const FeatureBits F_MRG_RXBUF = (1 << 15);
+    /** Configuration status field is available */
+    static const FeatureBits F_STATUS = (1 << 16);
+    /** Control channel is available */
+    static const FeatureBits F_CTRL_VQ = (1 << 17);
+    /** Device supports multiple queue pairs */
+    static const FeatureBits F_MQ = (1 << 22);
+    /** @} */
+
+    /** Link is up (configuration status field) */
+    static const uint16_t S_LINK_UP = 1;
+
+    /** @{
+     * @name Control commands
+     */
+    static const uint8_t CTRL_MQ = 4;
+    static const uint8_t CTRL_MQ_VQ_PAIRS_SET = 0;
+
+    static const uint8_t CTRL_OK = 0;
+    static const uint8_t CTRL_ERR = 1;
+    /** @} */
+
+    /**
+     * Network device configuration structure
+     */
+    struct Config {
+        uint8_t mac[6];
+        uint16_t status;
+        uint16_t max_virtqueue_pairs;
+    } M5_ATTR_PACKED;
+
+    /** Currently active configuration (host byte order) */
+    Config config;
+
+    /**
+     * Packet header preceding every packet in a descriptor chain.
+     *
+     * @note The num_buffers field is only present if the guest has
+     * negotiated F_MRG_RXBUF.
+     */
+    struct NetHeader {
+        uint8_t flags;
+        uint8_t gso_type;
+        uint16_t hdr_len;
+        uint16_t gso_size;
+        uint16_t csum_start;
+        uint16_t csum_offset;
+        uint16_t num_buffers;
+    } M5_ATTR_PACKED;
+
+    /** Size of the packet header negotiated with the guest */
+    size_t headerSize() const;
+
+  protected:
+    /**
+     * Virtqueue for packets going from the host to the guest.
+     */
+    class RxQueue
+        : public VirtQueue
+    {
+      public:
+        RxQueue(PortProxy &proxy, uint16_t size, VirtIONet &_parent,
+                unsigned _id)
+            : VirtQueue(proxy, size), parent(_parent), id(_id) {}
+        virtual ~RxQueue() {}
+
+        void onNotify() override { parent.rxDeliver(); }
+
+        /**
+         * Copy a packet into one or more descriptor chains.
+         *
+         * @return false if the guest hasn't posted enough buffers.
+         */
+        bool deliver(EthPacketPtr pkt);
+
+        std::string name() const {
+            return csprintf("%s.rxq%i", parent.name(), id);
+        }
+
+      protected:
+        VirtIONet &parent;
+        const unsigned id;
+    };
+
+    /**
+     * Virtqueue for packets going from the guest to the host.
+     */
+    class TxQueue
+        : public VirtQueue
+    {
+      public:
+        TxQueue(PortProxy &proxy, uint16_t size, VirtIONet &_parent,
+                unsigned _id)
+            : VirtQueue(proxy, size), parent(_parent), id(_id) {}
+        virtual ~TxQueue() {}
+
+        /**
+         * Move packets into the transmit FIFO for as long as there is
+         * space for them.
+         */
+        void onNotify() override;
+
+        std::string name() const {
+            return csprintf("%s.txq%i", parent.name(), id);
+        }
+
+      protected:
+        VirtIONet &parent;
+        const unsigned id;
+    };
+
+    /**
+     * Virtqueue for control commands from the guest.
+     */
+    class CtrlQueue
+        : public VirtQueue
+    {
+      public:
+        CtrlQueue(PortProxy &proxy, uint16_t size, VirtIONet &_parent)
+            : VirtQueue(proxy, size), parent(_parent) {}
+        virtual ~CtrlQueue() {}
+
+        void onNotifyDescriptor(VirtDescriptor *desc) override;
+
+        std::string name() const { return parent.name() + ".ctrlq"; }
+
+      protected:
+        VirtIONet &parent;
+    };
+
+    /** Receive queues, one per queue pair */
+    std::vector<std::unique_ptr<RxQueue>> rxQueues;
+    /** Transmit queues, one per queue pair */
+    std::vector<std::unique_ptr<TxQueue>> txQueues;
+    /** Control queue */
+    CtrlQueue ctrlQueue;
+
+    /** Number of queue pairs enabled by the guest */
+    uint16_t activePairs;
+
+  protected:
+    /** Pick the receive queue that a packet should be steered to. */
+    unsigned rxSteer(EthPacketPtr pkt) const;
+    /** Move as many packets as possible from rxFifo to the guest. */
+    void rxDeliver();
+    /** Send as many packets as possible from txFifo to the network. */
+    void txKick();
+
+    /**
+     * Note that descriptors have been returned to the guest and
+     * notify it now or when the moderation timer expires.
+     *
+     * @param packets Number of packets completed.
+     */
+    void postInterrupt(unsigned packets);
+    /** Notify the guest of all completed packets. */
+    void sendInterrupt();
+
+    VirtIONetInt *interface;
+
+    PacketFifo rxFifo;
+    PacketFifo txFifo;
+
+    /** Maximum time to hold back a guest notification */
+    const Tick intDelay;
+    /** Number of completed packets that forces a notification */
+    const unsigned intMaxPackets;
+    /** Number of completed packets not notified yet */
+    unsigned intPending;
+    EventFunctionWrapper intEvent;
+
+    Stats::Scalar rxPackets;
+    Stats::Scalar rxBytes;
+    Stats::Scalar rxBuffers;
+    Stats::Scalar txPackets;
+    Stats::Scalar txBytes;
+    Stats::Scalar rxFifoDrops;
+    Stats::Scalar interrupts;
+    Stats::Formula packetsPerInterrupt;
+};
+
+class VirtIONetInt : public EtherInt
+{
+  private:
+    VirtIONet *dev;
+
+  public:
+    VirtIONetInt(const std::string &name, VirtIONet *d)
+        : EtherInt(name), dev(d)
+    { }
+
+    bool recvPacket(EthPacketPtr pkt) override { return dev->recvPacket(pkt); }
+    void sendDone() override { dev->transferDone(); }
+};
+
+#endif // __DEV_VIRTIO_NET_HH__
@@ -40,13 +40,19 @@
 #include "dev/virtio/pci.hh"
 
 #include "base/bitfield.hh"
+#include "config/use_kvm.hh"
 #include "debug/VIOIface.hh"
 #include "mem/packet_access.hh"
 #include "params/PciVirtIO.hh"
+#include "sim/system.hh"
+
+#if USE_KVM
+#include "cpu/kvm/vm.hh"
+#endif
 
 PciVirtIO::PciVirtIO(const Params *params)
     : PciDevice(params), queueNotify(0), interruptDeliveryPending(false),
-      vio(*params->vio), callbackKick(this)
+      vio(*params->vio), callbackKick(this), doorbellBase(0)
 {
     // Override the subsystem ID with the device ID from VirtIO
     config.subsystemID = htole(vio.deviceId);
@@ -64,6 +70,64 @@ PciVirtIO::~PciVirtIO()
 {
 }
 
+void
+PciVirtIO::init()
+{
+    PciDevice::init();
+    updateDoorbells();
+}
+
+Tick
+PciVirtIO::writeConfig(PacketPtr pkt)
+{
+    const Tick delay = PciDevice::writeConfig(pkt);
+    updateDoorbells();
+    return delay;
+}
+
+void
+PciVirtIO::unserialize(CheckpointIn &cp)
+{
+    PciDevice::unserialize(cp);
+    updateDoorbells();
+}
+
+void
+PciVirtIO::updateDoorbells()
+{
+#if USE_KVM
+    KvmVM *vm = sys->getKvmVM();
+    if (!vm || BARAddrs[0] == doorbellBase)
+        return;
+
+    for (int id : doorbells)
+        vm->unregisterIOEventFD(id);
+    doorbells.clear();
+
+    doorbellBase = BARAddrs[0];
+    if (!doorbellBase)
+        return;
+
+    // The doorbell doesn't tell which value was written, so each
+    // queue gets its own.
+    for (VirtIODeviceBase::QueueID q = 0; q < vio.numQueues(); ++q) {
+        const int id = vm->registerIOEventFD(
+            doorbellBase + OFF_QUEUE_NOTIFY, sizeof(uint16_t), q,
+            [this, q]() {
+                DPRINTF(VIOIface, "Doorbell for queue %i\n", q);
+                queueNotify = q;
+                vio.onNotify(q);
+            });
+        if (id == -1)
+            break;
+        doorbells.push_back(id);
+    }
+
+    DPRINTF(VIOIface, "Registered %i doorbells at 0x%x\n",
+            doorbells.size(), doorbellBase + OFF_QUEUE_NOTIFY);
+#endif
+}
+
 Tick
 PciVirtIO::read(PacketPtr pkt)
 {
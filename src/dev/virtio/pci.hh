@@ -40,6 +40,8 @@
 #ifndef __DEV_VIRTIO_PCI_HH__
 #define __DEV_VIRTIO_PCI_HH__
 
+#include <vector>
+
 #include "base/statistics.hh"
 #include "dev/virtio/base.hh"
 #include "dev/pci/device.hh"
@@ -53,8 +55,13 @@ class PciVirtIO : public PciDevice
     PciVirtIO(const Params *params);
     virtual ~PciVirtIO();
 
+    void init() override;
+
     Tick read(PacketPtr pkt);
     Tick write(PacketPtr pkt);
+    Tick writeConfig(PacketPtr pkt) override;
+
+    void unserialize(CheckpointIn &cp) override;
 
     void kick();
 
@@ -84,6 +91,20 @@ class PciVirtIO : public PciDevice
     VirtIODeviceBase &vio;
 
     MakeCallback<PciVirtIO, &PciVirtIO::kick> callbackKick;
+
+  private:
+    /**
+     * Let the guest notify queues through KVM doorbells at the
+     * current address of BAR0, rather than exiting to gem5 on every
+     * write to the queue notify register. Does nothing unless the
+     * system runs in a KVM VM that supports doorbells.
+     */
+    void updateDoorbells();
+
+    /** Base address the doorbells are registered at, 0 if none */
+    Addr doorbellBase;
+    /** IDs of the registered doorbells, one per queue */
+    std::vector<int> doorbells;
 };
 
 #endif // __DEV_VIRTIO_PCI_HH__
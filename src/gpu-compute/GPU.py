@@ -152,6 +152,9 @@ class Shader(ClockedObject):
         acquire and release?""")
     globalmem = Param.MemorySize('64kB', 'Memory size')
     timing = Param.Bool(False, 'timing memory accesses')
+    functional_exec = Param.Bool(False, "Execute work-groups functionally, "
+        "without the CU pipeline, and estimate their execution time with a "
+        "simple throughput model. Implies functional memory accesses.")
 
     cpu_pointer = Param.BaseCPU(NULL, "pointer to base CPU")
     translation = Param.Bool(False, "address translation");
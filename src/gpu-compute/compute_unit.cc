@@ -34,6 +34,8 @@
  */
 #include "gpu-compute/compute_unit.hh"
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 
 #include "base/output.hh"
@@ -74,6 +76,9 @@ ComputeUnit::ComputeUnit(const Params *p) : MemObject(p), fetchStage(p),
     coalescerToVrfBusWidth(p->coalescer_to_vrf_bus_width),
     req_tick_latency(p->mem_req_latency * p->clk_domain->clockPeriod()),
     resp_tick_latency(p->mem_resp_latency * p->clk_domain->clockPeriod()),
+    simdFreeAt(p->num_SIMDs, 0),
+    retireEvent([this]{ retireFunctional(); }, name() + ".retireEvent"),
+    sleeping(false),
     _masterId(p->system->getMasterId(name() + ".ComputeUnit")),
     lds(*p->localDataStore), _cacheLineSize(p->system->cacheLineSize()),
     globalSeqNum(0), wavefrontSize(p->wfSize),
@@ -315,6 +320,8 @@ ComputeUnit::StartWorkgroup(NDRange *ndr)
     LdsChunk *ldsChunk = lds.reserveSpace(ndr->dispatchId, ndr->globalWgId,
                                           ndr->q.ldsSize);
 
+    wakeUp();
+
     // Send L1 cache acquire
     // isKernel + isAcquire = Kernel Begin
     if (shader->impl_kern_boundary_sync) {
@@ -531,6 +538,16 @@ ComputeUnit::cedeSIMD(int simdId, int wfSlotId)
 void
 ComputeUnit::exec()
 {
+    if (shader->functionalExec) {
+        execFunctional();
+        return;
+    }
+
+    if (sleeping) {
+        skipCycles(1);
+        return;
+    }
+
     updateEvents();
     // Execute pipeline stages in reverse order to simulate
     // the pipeline latency
@@ -542,6 +559,232 @@ ComputeUnit::exec()
     fetchStage.exec();
 
     totalCycles++;
+
+    sleeping = canSleep();
+    if (sleeping) {
+        DPRINTF(GPUExec, "CU%d: sleeping until a response comes back\n",
+                cu_id);
+    }
+}
+
+bool
+ComputeUnit::canSleep() const
+{
+    // Pending scheduled adds and register events don't wake us up
+    if (shader->sa_n || !timestampVec.empty()) {
+        return false;
+    }
+
+    for (const auto &ready_list : readyList) {
+        if (!ready_list.empty()) {
+            return false;
+        }
+    }
+
+    for (const auto &dispatch : dispatchList) {
+        if (dispatch.second != EMPTY) {
+            return false;
+        }
+    }
+
+    // A busy resource may let a wave issue once it becomes available
+    auto busy = [](const WaitClass &res) {
+        return !res.rdy() || !res.prerdy();
+    };
+
+    for (const auto &res : aluPipe) {
+        if (busy(res)) {
+            return false;
+        }
+    }
+
+    for (const auto &res : wfWait) {
+        if (busy(res)) {
+            return false;
+        }
+    }
+
+    for (const auto &res : vrfToGlobalMemPipeBus) {
+        if (busy(res)) {
+            return false;
+        }
+    }
+
+    for (const auto &res : vrfToLocalMemPipeBus) {
+        if (busy(res)) {
+            return false;
+        }
+    }
+
+    if (busy(glbMemToVrfBus) || busy(locMemToVrfBus)) {
+        return false;
+    }
+
+    return globalMemoryPipe.isIdle() && localMemoryPipe.isIdle() &&
+        fetchStage.isIdle();
+}
+
+void
+ComputeUnit::wakeUp()
+{
+    if (sleeping) {
+        DPRINTF(GPUExec, "CU%d: waking up\n", cu_id);
+        sleeping = false;
+        shader->wakeUp();
+    }
+}
+
+void
+ComputeUnit::skipCycles(uint64_t num_cycles)
+{
+    execStage.skipIdleCycles(num_cycles);
+    totalCycles += num_cycles;
+    sleepCycles += num_cycles;
+}
+
+void
+ComputeUnit::execFunctional()
+{
+    std::vector<uint64_t> num_insts(numSIMDs, 0);
+    bool progress = true;
+
+    while (progress) {
+        progress = false;
+
+        for (int simd = 0; simd < numSIMDs; ++simd) {
+            for (int slot = 0; slot < shader->n_wf; ++slot) {
+                Wavefront *w = wfList[simd][slot];
+
+                while (w->status == Wavefront::S_RUNNING) {
+                    if (w->stalledAtBarrier) {
+                        if (!AllAtBarrier(w->barrierId, w->barrierCnt,
+                                          getRefCounter(w->dispatchId,
+                                                        w->wgId))) {
+                            break;
+                        }
+
+                        // release all the waves at the barrier at
+                        // once, before the first of them moves on to
+                        // the next one
+                        for (auto &simd_waves : wfList) {
+                            for (auto wave : simd_waves) {
+                                if (wave->status == Wavefront::S_RUNNING &&
+                                    wave->stalledAtBarrier &&
+                                    wave->barrierId == w->barrierId) {
+                                    wave->oldBarrierCnt = wave->barrierCnt;
+                                    wave->stalledAtBarrier = false;
+                                }
+                            }
+                        }
+                    }
+
+                    // fetches are functional, so they return right away
+                    while (w->instructionBuffer.empty()) {
+                        w->pendingFetch = true;
+                        fetchStage.initiateFetch(w);
+                    }
+
+                    w->updateResources();
+                    w->exec();
+                    ++num_insts[simd];
+                    progress = true;
+
+                    auto &gm_reqs = globalMemoryPipe.getGMReqFIFO();
+                    while (!gm_reqs.empty()) {
+                        GPUDynInstPtr m = gm_reqs.front();
+                        gm_reqs.pop();
+                        completeFunctionalAccess(m, true);
+                    }
+
+                    auto &lm_reqs = localMemoryPipe.getLMReqFIFO();
+                    while (!lm_reqs.empty()) {
+                        GPUDynInstPtr m = lm_reqs.front();
+                        lm_reqs.pop();
+                        completeFunctionalAccess(m, false);
+                    }
+                }
+            }
+        }
+    }
+
+    // Charge the instructions to the SIMDs that executed them. The
+    // work-groups that ended retire once all of them are done.
+    Tick done = curTick();
+    for (int simd = 0; simd < numSIMDs; ++simd) {
+        if (num_insts[simd]) {
+            simdFreeAt[simd] = std::max(simdFreeAt[simd], curTick()) +
+                shader->ticks(num_insts[simd] * issuePeriod);
+            done = std::max(done, simdFreeAt[simd]);
+        }
+    }
+
+    if (!retiringWaves.empty())
+        done = std::max(done, retiringWaves.back().first);
+
+    for (auto w : returningWaves) {
+        DPRINTF(GPUExec, "CU%d: WF[%d][%d]: retiring at tick %d\n",
+                cu_id, w->simdId, w->wfSlotId, done);
+        retiringWaves.emplace_back(done, w);
+    }
+    returningWaves.clear();
+
+    if (!retiringWaves.empty() && !retireEvent.scheduled())
+        schedule(retireEvent, retiringWaves.front().first);
+}
+
+void
+ComputeUnit::completeFunctionalAccess(GPUDynInstPtr gpuDynInst, bool global)
+{
+    Wavefront *w = gpuDynInst->wavefront();
+
+    gpuDynInst->initiateAcc(gpuDynInst);
+
+    // memory accesses complete immediately, so do whatever would
+    // have been done once the response was received
+    if (gpuDynInst->useContinuation) {
+        assert(!gpuDynInst->isNoScope());
+        gpuDynInst->execContinuation(gpuDynInst->staticInstruction(),
+                                     gpuDynInst);
+    }
+
+    if (!gpuDynInst->isMemFence())
+        gpuDynInst->completeAcc(gpuDynInst);
+
+    --w->outstandingReqs;
+
+    if (gpuDynInst->isStore() || gpuDynInst->isAtomic()) {
+        if (global)
+            --w->outstandingReqsWrGm;
+        else
+            --w->outstandingReqsWrLm;
+    }
+
+    if (gpuDynInst->isLoad() || gpuDynInst->isAtomic()) {
+        if (global)
+            --w->outstandingReqsRdGm;
+        else
+            --w->outstandingReqsRdLm;
+    }
+}
+
+void
+ComputeUnit::retireFunctional()
+{
+    while (!retiringWaves.empty() &&
+           retiringWaves.front().first <= curTick()) {
+        Wavefront *w = retiringWaves.front().second;
+        retiringWaves.pop_front();
+
+        DPRINTF(GPUDisp, "CU%d: WF[%d][%d][wv=%d]: WG id completed %d\n",
+                cu_id, w->simdId, w->wfSlotId, w->wfDynId, w->kernId);
+
+        assert(w->status == Wavefront::S_RETURNING);
+        shader->dispatcher->notifyWgCompl(w);
+        w->status = Wavefront::S_STOPPED;
+    }
+
+    if (!retiringWaves.empty())
+        schedule(retireEvent, retiringWaves.front().first);
 }
 
 void
@@ -627,6 +870,8 @@ ComputeUnit::DataPort::recvTimingResp(PacketPtr pkt)
 
     // Is the packet returned a Kernel End or Barrier
     if (pkt->req->isKernel() && pkt->req->isRelease()) {
+        computeUnit->wakeUp();
+
         Wavefront *w =
             computeUnit->wfList[gpuDynInst->simdId][gpuDynInst->wfSlotId];
 
@@ -657,6 +902,8 @@ ComputeUnit::DataPort::recvTimingResp(PacketPtr pkt)
         delete pkt;
         return true;
     } else if (pkt->req->isKernel() && pkt->req->isAcquire()) {
+        computeUnit->wakeUp();
+
         if (gpuDynInst->useContinuation) {
             assert(!gpuDynInst->isNoScope());
             gpuDynInst->execContinuation(gpuDynInst->staticInstruction(),
@@ -711,6 +958,7 @@ ComputeUnit::DataPort::recvReqRetry()
 bool
 ComputeUnit::SQCPort::recvTimingResp(PacketPtr pkt)
 {
+    computeUnit->wakeUp();
     computeUnit->fetchStage.processFetchReturn(pkt);
 
     return true;
@@ -784,7 +1032,7 @@ ComputeUnit::sendRequest(GPUDynInstPtr gpuDynInst, int index, PacketPtr pkt)
             Addr paddr;
 
             if (!p->pTable->translate(vaddr, paddr)) {
-                if (!p->fixupStackFault(vaddr)) {
+                if (!p->fixupFault(vaddr)) {
                     panic("CU%d: WF[%d][%d]: Fault on addr %#x!\n",
                           cu_id, gpuDynInst->simdId, gpuDynInst->wfSlotId,
                           vaddr);
@@ -901,7 +1149,29 @@ ComputeUnit::sendRequest(GPUDynInstPtr gpuDynInst, int index, PacketPtr pkt)
         new_pkt->dataStatic(pkt->getPtr<uint8_t>());
 
         // Translation is done. It is safe to send the packet to memory.
-        memPort[0]->sendFunctional(new_pkt);
+        if (new_pkt->isAtomicOp()) {
+            // functional accesses don't perform atomic operations, so
+            // read the old value, which is what the atomic returns, and
+            // write back the updated one
+            const unsigned size = new_pkt->getSize();
+            std::vector<uint8_t> value(size);
+
+            PacketPtr rd_pkt = new Packet(pkt->req, MemCmd::ReadReq);
+            rd_pkt->dataStatic(value.data());
+            memPort[0]->sendFunctional(rd_pkt);
+            memcpy(new_pkt->getPtr<uint8_t>(), value.data(), size);
+
+            (*new_pkt->getAtomicOp())(value.data());
+
+            PacketPtr wr_pkt = new Packet(pkt->req, MemCmd::WriteReq);
+            wr_pkt->dataStatic(value.data());
+            memPort[0]->sendFunctional(wr_pkt);
+
+            delete rd_pkt;
+            delete wr_pkt;
+        } else {
+            memPort[0]->sendFunctional(new_pkt);
+        }
 
         DPRINTF(GPUMem, "CU%d: WF[%d][%d]: index %d: addr %#x\n", cu_id,
                 gpuDynInst->simdId, gpuDynInst->wfSlotId, index,
@@ -960,6 +1230,27 @@ ComputeUnit::injectGlobalMemFence(GPUDynInstPtr gpuDynInst, bool kernelLaunch,
     // a mem fence must correspond to an acquire/release request
     assert(req->isAcquire() || req->isRelease());
 
+    if (shader->functionalExec) {
+        // Memory is only accessed functionally, so there is nothing to
+        // order and the fence completes right away. The kernel end
+        // release retires the wave once its time is up.
+        if (req->isKernel() && req->isRelease()) {
+            Wavefront *w = wfList[gpuDynInst->simdId][gpuDynInst->wfSlotId];
+            if (w->status == Wavefront::S_RETURNING)
+                returningWaves.push_back(w);
+        }
+
+        delete req;
+
+        if (gpuDynInst->useContinuation) {
+            assert(!gpuDynInst->isNoScope());
+            gpuDynInst->execContinuation(gpuDynInst->staticInstruction(),
+                                         gpuDynInst);
+        }
+
+        return;
+    }
+
     // create packet
     PacketPtr pkt = new Packet(req, MemCmd::MemFenceReq);
 
@@ -982,6 +1273,8 @@ ComputeUnit::DataPort::processMemRespEvent(PacketPtr pkt)
 
     assert(gpuDynInst);
 
+    compute_unit->wakeUp();
+
     DPRINTF(GPUPort, "CU%d: WF[%d][%d]: Response for addr %#x, index %d\n",
             compute_unit->cu_id, gpuDynInst->simdId, gpuDynInst->wfSlotId,
             pkt->req->getPaddr(), index);
@@ -1601,6 +1894,11 @@ ComputeUnit::regStats()
         .desc("number of cycles the CU ran for")
         ;
 
+    sleepCycles
+        .name(name() + ".num_sleep_cycles")
+        .desc("number of cycles the CU pipeline slept while idle")
+        ;
+
     ipc
         .name(name() + ".ipc")
         .desc("Instructions per cycle (this CU only)")
@@ -1831,6 +2129,7 @@ ComputeUnit::LDSPort::recvTimingResp(PacketPtr packet)
     delete packet;
 
     computeUnit->localMemoryPipe.getLMRespFIFO().push(gpuDynInst);
+    computeUnit->wakeUp();
     return true;
 }
 
@@ -208,6 +208,25 @@ class ComputeUnit : public MemObject
     Tick req_tick_latency;
     Tick resp_tick_latency;
 
+    /**
+     * @{
+     * State of the functional execution mode. The work-groups resident
+     * on the CU run to completion without the pipeline, and retire
+     * after the time given by a simple throughput model, where every
+     * wavefront instruction occupies its SIMD for issuePeriod cycles.
+     */
+    /** When each SIMD is done with the instructions given to it */
+    std::vector<Tick> simdFreeAt;
+    /** Waves that reached their kernel end release in the current run */
+    std::vector<Wavefront*> returningWaves;
+    /** Waves waiting to retire, and when they do, in retire order */
+    std::deque<std::pair<Tick, Wavefront*>> retiringWaves;
+    EventFunctionWrapper retireEvent;
+    /** @} */
+
+    // is the pipeline idle until some external event wakes it up?
+    bool sleeping;
+
     // number of vector registers being reserved for each SIMD unit
     std::vector<int> vectorRegsReserved;
     // number of vector registers per SIMD unit
@@ -252,6 +271,40 @@ class ComputeUnit : public MemObject
 
     void resizeRegFiles(int num_cregs, int num_sregs, int num_dregs);
     void exec();
+
+    /**
+     * Can the CU sleep until a response comes back, or a work-group is
+     * dispatched to it? This is the case when none of its waves can
+     * issue, and the pipeline has no work left that completes on its
+     * own, e.g., when all the waves wait for global memory.
+     */
+    bool canSleep() const;
+    bool isSleeping() const { return sleeping; }
+
+    /** Resume clocking the pipeline of a sleeping CU. */
+    void wakeUp();
+
+    /** Account for cycles the CU didn't execute because it slept. */
+    void skipCycles(uint64_t num_cycles);
+
+    /**
+     * Run the wavefronts resident on this CU until they end or wait at
+     * a barrier, executing their instructions and memory accesses
+     * functionally instead of clocking the pipeline.
+     */
+    void execFunctional();
+
+    /**
+     * Perform a memory instruction issued by a functionally executed
+     * wavefront, and write back its results.
+     *
+     * @param gpuDynInst memory instruction
+     * @param global whether it was issued to the global memory pipeline
+     */
+    void completeFunctionalAccess(GPUDynInstPtr gpuDynInst, bool global);
+
+    /** Retire the functionally executed waves whose time is up. */
+    void retireFunctional();
     void initiateFetch(Wavefront *wavefront);
     void fetch(PacketPtr pkt, Wavefront *wavefront);
     void fillKernelState(Wavefront *w, NDRange *ndr);
@@ -354,6 +407,7 @@ class ComputeUnit : public MemObject
     Stats::Scalar numVecOpsExecuted;
     // Total cycles that something is running on the GPU
     Stats::Scalar totalCycles;
+    Stats::Scalar sleepCycles;
     Stats::Formula vpc; // vector ops per cycle
     Stats::Formula ipc; // vector instructions per cycle
     Stats::Distribution controlFlowDivergenceDist;
@@ -148,6 +148,28 @@ ExecStage::exec()
     collectStatistics(PostExec, 0);
 }
 
+void
+ExecStage::skipIdleCycles(uint64_t num_cycles)
+{
+    for (int unitId = 0; unitId < (numSIMDs + numMemUnits); ++unitId) {
+        if ((computeUnit->isVecAlu(unitId) &&
+             vectorAluInstAvail->at(unitId)) ||
+            (computeUnit->isGlbMem(unitId) && *glbMemInstAvail > 0) ||
+            (computeUnit->isShrMem(unitId) && *shrMemInstAvail > 0)) {
+            numCyclesWithNoInstrTypeIssued[unitId] += num_cycles;
+        }
+    }
+
+    if (lastTimeInstExecuted) {
+        ++numTransActiveIdle;
+    }
+
+    lastTimeInstExecuted = false;
+    idle_dur += num_cycles;
+    numCyclesWithNoIssue += num_cycles;
+    spc.sample(0, num_cycles);
+}
+
 void
 ExecStage::regStats()
 {
@@ -74,6 +74,14 @@ class ExecStage
     void init(ComputeUnit *cu);
     void exec();
 
+    /**
+     * Account for cycles during which the CU was asleep. Nothing is
+     * dispatched while the CU sleeps, and the oldest instructions of
+     * its waves don't change, so each of these cycles counts as the
+     * idle cycle that would have followed the last one executed.
+     */
+    void skipIdleCycles(uint64_t num_cycles);
+
     std::string name() { return _name; }
     void regStats();
     // number of idle cycles
@@ -94,6 +94,24 @@ FetchStage::fetch(PacketPtr pkt, Wavefront *wavefront)
     fetchUnit[wavefront->simdId].fetch(pkt, wavefront);
 }
 
+void
+FetchStage::initiateFetch(Wavefront *wavefront)
+{
+    fetchUnit[wavefront->simdId].initiateFetch(wavefront);
+}
+
+bool
+FetchStage::isIdle() const
+{
+    for (int j = 0; j < numSIMDs; ++j) {
+        if (!fetchUnit[j].isIdle()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void
 FetchStage::regStats()
 {
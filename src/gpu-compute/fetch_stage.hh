@@ -59,6 +59,8 @@ class FetchStage
     void exec();
     void processFetchReturn(PacketPtr pkt);
     void fetch(PacketPtr pkt, Wavefront *wave);
+    void initiateFetch(Wavefront *wave);
+    bool isIdle() const;
 
     // Stats related variables and methods
     std::string name() { return _name; }
@@ -60,6 +60,8 @@ class FetchUnit
     void initiateFetch(Wavefront *wavefront);
     void fetch(PacketPtr pkt, Wavefront *wavefront);
     void processFetchReturn(PacketPtr pkt);
+    // are all the waves that need instructions already being fetched?
+    bool isIdle() const { return fetchQueue.empty(); }
     static uint32_t globalFetchUnitID;
 
   private:
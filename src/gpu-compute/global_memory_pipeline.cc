@@ -171,6 +171,21 @@ GlobalMemPipeline::getNextReadyResp()
     return nullptr;
 }
 
+bool
+GlobalMemPipeline::isIdle() const
+{
+    if (!gmIssuedRequests.empty()) {
+        return false;
+    }
+
+    if (outOfOrderDataDelivery) {
+        return gmReturnedLoads.empty() && gmReturnedStores.empty();
+    }
+
+    return gmOrderedRespBuffer.empty() ||
+        !gmOrderedRespBuffer.begin()->second.second;
+}
+
 void
 GlobalMemPipeline::completeRequest(GPUDynInstPtr gpuDynInst)
 {
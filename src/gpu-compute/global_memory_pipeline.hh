@@ -62,6 +62,7 @@ class GlobalMemPipeline
     void init(ComputeUnit *cu);
     void exec();
 
+    std::queue<GPUDynInstPtr> &getGMReqFIFO() { return gmIssuedRequests; }
     std::queue<GPUDynInstPtr> &getGMStRespFIFO() { return gmReturnedStores; }
     std::queue<GPUDynInstPtr> &getGMLdRespFIFO() { return gmReturnedLoads; }
 
@@ -74,6 +75,12 @@ class GlobalMemPipeline
      */
     GPUDynInstPtr getNextReadyResp();
 
+    /**
+     * is there nothing for the pipeline to do until another response
+     * comes back from memory? requests that are in flight don't count.
+     */
+    bool isIdle() const;
+
     /**
      * once a memory request is finished we remove it from the
      * buffer. this method determines which response buffer
@@ -76,6 +76,13 @@ class LocalMemPipeline
         return (lmIssuedRequests.size() + pendReqs) < lmQueueSize;
     }
 
+    // is there nothing for the pipeline to do until the LDS responds?
+    bool
+    isIdle() const
+    {
+        return lmIssuedRequests.empty() && lmReturnedRequests.empty();
+    }
+
     const std::string& name() const { return _name; }
     void regStats();
 
@@ -44,9 +44,19 @@
 
 class GPUDynInst;
 
-typedef std::bitset<std::numeric_limits<unsigned long long>::digits> VectorMask;
+// maximum number of lanes of a wavefront, one per bit of a VectorMask
+const int MaxLanes = std::numeric_limits<unsigned long long>::digits;
+
+typedef std::bitset<MaxLanes> VectorMask;
 typedef std::shared_ptr<GPUDynInst> GPUDynInstPtr;
 
+// are the first num_lanes lanes of a mask all active?
+inline bool
+allLanesActive(const VectorMask &mask, int num_lanes)
+{
+    return (~mask << (MaxLanes - num_lanes)).none();
+}
+
 class WaitClass
 {
   public:
@@ -35,10 +35,12 @@
 
 #include "gpu-compute/shader.hh"
 
+#include <algorithm>
 #include <limits>
 
 #include "arch/x86/linux/linux.hh"
 #include "base/chunk_generator.hh"
+#include "base/intmath.hh"
 #include "debug/GPUDisp.hh"
 #include "debug/GPUMem.hh"
 #include "debug/HSAIL.hh"
@@ -54,8 +56,9 @@ Shader::Shader(const Params *p)
     : ClockedObject(p), clock(p->clk_domain->clockPeriod()),
       cpuThread(nullptr), gpuTc(nullptr), cpuPointer(p->cpu_pointer),
       tickEvent([this]{ processTick(); }, "Shader tick",
-                false, Event::CPU_Tick_Pri),
-      timingSim(p->timing), hsail_mode(SIMT),
+                false, Event::CPU_Tick_Pri), sleeping(false),
+      timingSim(p->timing && !p->functional_exec),
+      functionalExec(p->functional_exec), hsail_mode(SIMT),
       impl_kern_boundary_sync(p->impl_kern_boundary_sync),
       separate_acquire_release(p->separate_acquire_release), coissue_return(1),
       trace_vgpr_all(1), n_cu((p->CUs).size()), n_wf(p->n_wf),
@@ -324,12 +327,48 @@ Shader::ScheduleAdd(uint32_t *val,Tick when,int x)
 void
 Shader::processTick()
 {
+    if (sleeping) {
+        // the CUs did nothing in the cycles we skipped
+        uint64_t skipped = (curTick() - tick_cnt) / ticks(1) - 1;
+        for (int i = 0; i < n_cu; ++i)
+            cuList[i]->skipCycles(skipped);
+        sleeping = false;
+    }
+
     if (busy()) {
         exec();
-        schedule(tickEvent, curTick() + ticks(1));
+
+        // In functional mode the CUs run their work-groups to
+        // completion in one go, and dispatching more work-groups
+        // wakes us up again.
+        if (functionalExec)
+            return;
+
+        bool all_asleep = !sa_n;
+        for (int i = 0; i < n_cu && all_asleep; ++i)
+            all_asleep = cuList[i]->isSleeping();
+
+        if (all_asleep) {
+            DPRINTF(GPUDisp, "All CUs are asleep\n");
+            sleeping = true;
+        } else {
+            schedule(tickEvent, curTick() + ticks(1));
+        }
     }
 }
 
+void
+Shader::wakeUp()
+{
+    if (!sleeping || tickEvent.scheduled())
+        return;
+
+    // stay in phase with the cycles we skipped
+    Tick period = ticks(1);
+    Tick cycles = std::max<Tick>(divCeil(curTick() - tick_cnt, period), 1);
+    schedule(tickEvent, tick_cnt + cycles * period);
+}
+
 void
 Shader::AccessMem(uint64_t address, void *ptr, uint32_t size, int cu_id,
                   MemCmd cmd, bool suppress_func_errors)
@@ -102,8 +102,15 @@ class Shader : public ClockedObject
     void processTick();
     EventFunctionWrapper tickEvent;
 
+    // Stop ticking while all the CUs sleep, and resume on the next
+    // cycle once one of them wakes up.
+    bool sleeping;
+    void wakeUp();
+
     // is this simulation going to be timing mode in the memory?
     bool timingSim;
+    // are work-groups executed functionally, bypassing the CU pipeline?
+    bool functionalExec;
     hsail_mode_e hsail_mode;
 
     // If set, issue acq packet @ kernel launch
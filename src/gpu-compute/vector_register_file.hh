@@ -87,7 +87,23 @@ class VectorRegisterFile : public SimObject
         vgprState->write<T>(regIdx, value, threadId);
     }
 
-    uint8_t regBusy(int idx, uint32_t operandSize) const;
+    // Read or write all the lanes of a register at once
+    template<typename T>
+    void
+    readLanes(int regIdx, T *vals, int num_lanes)
+    {
+        vgprState->readLanes<T>(regIdx, vals, num_lanes);
+    }
+
+    template<typename T>
+    void
+    writeLanes(int regIdx, const T *vals, int num_lanes,
+               const VectorMask &mask)
+    {
+        vgprState->writeLanes<T>(regIdx, vals, num_lanes, mask);
+    }
+
+        uint8_t regBusy(int idx, uint32_t operandSize) const;
     uint8_t regNxtBusy(int idx, uint32_t operandSize) const;
 
     int numRegs() const { return numRegsPerSimd; }
@@ -36,6 +36,7 @@
 #ifndef __VECTOR_REGISTER_STATE_HH__
 #define __VECTOR_REGISTER_STATE_HH__
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <string>
@@ -86,6 +87,40 @@ class VecRegisterState
         *p0 = value;
     }
 
+    // Access all the lanes of a register at once. The lanes of a
+    // register are contiguous, so the copies, and the loops over the
+    // values of the lanes, can be vectorized by the compiler.
+    template<typename T>
+    void
+    readLanes(int regIdx, T *vals, int num_lanes)
+    {
+        assert(sizeof(T) == 4 || sizeof(T) == 8);
+        const T *p0 = sizeof(T) == 4 ? (const T*)s_reg[regIdx].data() :
+                                       (const T*)d_reg[regIdx].data();
+
+        std::copy(p0, p0 + num_lanes, vals);
+    }
+
+    template<typename T>
+    void
+    writeLanes(int regIdx, const T *vals, int num_lanes,
+               const VectorMask &mask)
+    {
+        assert(sizeof(T) == 4 || sizeof(T) == 8);
+        T *p0 = sizeof(T) == 4 ? (T*)s_reg[regIdx].data() :
+                                 (T*)d_reg[regIdx].data();
+
+        if (allLanesActive(mask, num_lanes)) {
+            std::copy(vals, vals + num_lanes, p0);
+        } else {
+            for (int lane = 0; lane < num_lanes; ++lane) {
+                if (mask[lane]) {
+                    p0[lane] = vals[lane];
+                }
+            }
+        }
+    }
+
     // (Single Precision) Vector Register File size.
     int regSize() { return s_reg.size(); }
 
@@ -661,8 +661,9 @@ Wavefront::exec()
 
     ii->execute(ii);
     computeUnit->updateInstStats(ii);
-    // access the VRF
-    computeUnit->vrf[simdId]->exec(ii, this);
+    // access the VRF, which only matters to the timing of the pipeline
+    if (!computeUnit->shader->functionalExec)
+        computeUnit->vrf[simdId]->exec(ii, this);
     srcRegOpDist.sample(ii->numSrcRegOperands());
     dstRegOpDist.sample(ii->numDstRegOperands());
     computeUnit->numInstrExecuted++;
@@ -694,6 +695,10 @@ Wavefront::exec()
         }
     }
 
+    // There is no pipeline when executing functionally
+    if (computeUnit->shader->functionalExec)
+        return;
+
     // ---- Update Vector ALU pipeline and other resources ------------------ //
     // Single precision ALU or Branch or Return or Special instruction
     if (ii->isALU() || ii->isSpecialOp() ||
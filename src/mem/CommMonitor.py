@@ -73,6 +73,14 @@ class CommMonitor(MemObject):
     # latency from request to response (not using sample period)
     latency_bins = Param.Unsigned('20', "# bins in latency histograms")
     disable_latency_hists = Param.Bool(False, "Disable latency histograms")
+    # only tag one in this many timing requests to measure their latency,
+    # which avoids pushing a sender state on every request
+    latency_sample_period = Param.Unsigned(1, "Measure the latency of one "
+                                           "in this many timing requests")
+    # fixed power of two buckets, which are cheaper to update than the
+    # resizing bins of the default histograms
+    latency_log2_hists = Param.Bool(False, "Use log2 buckets for latency "
+                                    "histograms")
 
     # inter transaction time (ITT) distributions in uniformly sized
     # bins up to the maximum, independently for read-to-read,
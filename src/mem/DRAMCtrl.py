@@ -128,10 +128,15 @@ class DRAMCtrl(AbstractMemory):
     # update per memory class when bank group architecture is supported
     bank_groups_per_rank = Param.Unsigned(0, "Number of bank groups per rank")
     banks_per_rank = Param.Unsigned("Number of banks per rank")
-    # only used for the address mapping as the controller by
-    # construction is a single channel and multiple controllers have
-    # to be instantiated for a multi-channel configuration
+    # by default only used for the address mapping, as the controller
+    # is a single channel and multiple controllers are instantiated
+    # for a multi-channel configuration; alternatively a single
+    # controller serves all channels if their interleaved ranges are
+    # given in channel_ranges
     channels = Param.Unsigned(1, "Number of channels")
+    channel_ranges = VectorParam.AddrRange([], "Interleaved ranges of the "
+                                           "channels served by this "
+                                           "controller, if more than one")
 
     # For power modelling we need to know if the DRAM has a DLL or not
     dll = Param.Bool(True, "DRAM has DLL or not")
@@ -183,6 +188,27 @@ class DRAMCtrl(AbstractMemory):
     # for CAS-to-CAS delay for bursts to different bank groups
     tCCD_L = Param.Latency("0ns", "Same bank group CAS to CAS delay")
 
+    # CAS-to-CAS delay for writes to the same bank group, which is
+    # longer than tCCD_L for some devices
+    tCCD_L_WR = Param.Latency(Self.tCCD_L, "Same bank group Write to Write "
+                              "delay")
+
+    # Some devices (e.g. LPDDR5 in bank group mode with BL32) split a
+    # burst into two halves separated by a gap, and a burst to a
+    # different bank group of the same rank can be interleaved into
+    # the gap. In this case tBURST is the duration of the whole burst,
+    # including the gap, and tBURST_MIN is the duration of one half
+    burst_interleave = Param.Bool(False, "Interleave bursts to different "
+                                  "bank groups")
+    tBURST_MIN = Param.Latency(Self.tBURST, "Duration of half a burst when "
+                               "interleaving bursts")
+
+    # Devices with a separate data clock (e.g. WCK for LPDDR5) stop the
+    # data clock when the data bus is idle, and a burst that follows an
+    # idle period sees an additional delay to synchronise the data
+    # clock again; set to 0 for devices without a data clock
+    tWCK_SYNC = Param.Latency("0ns", "Data clock synchronisation delay")
+
     # time taken to complete one refresh cycle (N rows in all banks)
     tRFC = Param.Latency("Refresh cycle time")
 
@@ -1186,3 +1212,248 @@ class HBM_1000_4H_1x64(HBM_1000_4H_1x128):
 
     # self refresh exit time
     tXS = '65ns'
+
+# A single HBM2 x64 pseudo-channel, with default timings based on
+# published HBM2 data and the HBM gen1 classes where no data is
+# available.
+# A 4H stack is defined, 8Gb per die for a total of 4GB of memory.
+# Each of the 8 channels is split into two pseudo-channels, which
+# have separate banks and data buses, but share the command and
+# address bus of the channel. A controller can serve both
+# pseudo-channels of a channel if 'channel_ranges' is set (see
+# --mem-shared-ctrl in MemConfig), although the sharing of the
+# command bus is not modelled.
+class HBM_2000_4H_1x64(DRAMCtrl):
+    # Configuration defines a single pseudo-channel, with the capacity
+    # set to (full_stack_capacity / 16) based on 8Gb dies
+    # To use all 16 pseudo-channels, set 'channels' parameter to 16 in
+    # system configuration
+
+    # 64-bit pseudo-channel interface
+    device_bus_width = 64
+
+    # HBM2 pseudo-channel mode only supports BL4
+    burst_length = 4
+
+    # size of pseudo-channel in bytes, 4H stack of 8Gb dies is 4GB per
+    # stack; with 16 pseudo-channels, 256MB per pseudo-channel
+    device_size = '256MB'
+
+    # page size is halved with pseudo-channel mode
+    device_rowbuffer_size = '1kB'
+
+    # 1x64 configuration
+    devices_per_rank = 1
+
+    # HBM does not have a CS pin; set rank to 1
+    ranks_per_channel = 1
+
+    # 8Gb dies have 16 banks per pseudo-channel in 4 bank groups
+    banks_per_rank = 16
+    bank_groups_per_rank = 4
+
+    # 1000 MHz for 2Gbps DDR data rate
+    tCK = '1ns'
+
+    # BL4 across a DDR interface translates to 2 clocks @ 1000 MHz
+    # tBURST is equivalent to the CAS-to-CAS delay for bursts to
+    # different bank groups (tCCD_S, 2 CK)
+    tBURST = '2ns'
+
+    # tCCD_L is 4 CK @ 1000 MHz
+    tCCD_L = '4ns'
+
+    tRCD = '14ns'
+    tCL = '14ns'
+    tRP = '14ns'
+    tRAS = '33ns'
+
+    # value for 8Gb device
+    tRFC = '350ns'
+    tREFI = '3.9us'
+
+    tWR = '16ns'
+    tRTP = '5ns'
+
+    # Here using the average of WTR_S and WTR_L
+    tWTR = '6ns'
+
+    # start with 2 cycles turnaround, similar to other memory classes
+    tRTW = '2ns'
+
+    # single rank device, set to 0
+    tCS = '0ns'
+
+    # tRRD_S is 4 CK and tRRD_L is 6 CK @ 1000 MHz
+    tRRD = '4ns'
+    tRRD_L = '6ns'
+
+    tXAW = '16ns'
+    activation_limit = 4
+
+    # active powerdown and precharge powerdown exit time
+    tXP = '8ns'
+
+    # start with tRFC + tXP -> 350ns + 8ns = 358ns
+    tXS = '358ns'
+
+# A single HBM2E x64 pseudo-channel, scaling the HBM2 class to a
+# 3.2Gbps data rate, with the core timings in ns kept constant.
+# An 8H stack is defined, 16Gb per die for a total of 16GB of memory.
+class HBM_3200_8H_1x64(HBM_2000_4H_1x64):
+    # 8H stack of 16Gb dies is 16GB per stack; with 16 pseudo-channels,
+    # 1GB per pseudo-channel
+    device_size = '1GB'
+
+    # 1600 MHz for 3.2Gbps DDR data rate
+    tCK = '0.625ns'
+
+    # BL4 across a DDR interface translates to 2 clocks @ 1600 MHz
+    tBURST = '1.25ns'
+
+    # tCCD_L is 4 CK @ 1600 MHz
+    tCCD_L = '2.5ns'
+
+    # tRRD_S is 4 CK and tRRD_L is 6 CK @ 1600 MHz
+    tRRD = '2.5ns'
+    tRRD_L = '3.75ns'
+
+    # 2 cycles turnaround @ 1600 MHz
+    tRTW = '1.25ns'
+
+    # tRFC + tXP -> 350ns + 8ns = 358ns
+    tXS = '358ns'
+
+# A single LPDDR5 x16 interface (one command/address bus), with
+# default timings based on an LPDDR5-5500 8 Gbit part in bank group
+# mode with BL32.
+# The command and address clock (CK) runs at 687.5 MHz, and the data
+# clock (WCK) at 4x that rate, i.e. 8 beats per CK.
+# IDD values are not defined yet, and hence the energy reported by
+# DRAMPower is zero.
+class LPDDR5_5500_1x16_BG_BL32(DRAMCtrl):
+    # No DLL for LPDDR5
+    dll = False
+
+    # size of device
+    device_size = '1GB'
+
+    # 1x16 configuration, 1 device with a 16-bit interface
+    device_bus_width = 16
+
+    # BL32 in bank group mode
+    burst_length = 32
+
+    # Each device has a page (row buffer) size of 2KB
+    device_rowbuffer_size = '2kB'
+
+    # 1x16 configuration, so 1 device
+    devices_per_rank = 1
+
+    # Use a single rank
+    ranks_per_channel = 1
+
+    # LPDDR5 has 16 banks, in bank group mode as 4 bank groups of 4
+    # banks
+    banks_per_rank = 16
+    bank_groups_per_rank = 4
+
+    # 687.5 MHz
+    tCK = '1.455ns'
+
+    # In bank group mode a BL32 burst is transferred as two halves of
+    # BL16 (2 CK each) with a gap of 2 CK in between, which is used by
+    # a burst to a different bank group. The full burst is 6 CK
+    burst_interleave = True
+    tBURST = '8.73ns'
+    tBURST_MIN = '2.91ns'
+
+    # tCCD_L is 8 CK for BL32 @ 687.5 MHz
+    tCCD_L = '11.64ns'
+
+    tRCD = '18ns'
+
+    # 15 CK read latency @ 687.5 MHz, 1.455 ns cycle time
+    tCL = '21.82ns'
+
+    tRAS = '42ns'
+    tWR = '34ns'
+    tRTP = '7.5ns'
+
+    # Pre-charge one bank 18 ns
+    tRP = '18ns'
+
+    # LPDDR5, 8 Gb
+    tRFC = '210ns'
+    tREFI = '3.9us'
+
+    # active powerdown and precharge powerdown exit time
+    tXP = '7.5ns'
+
+    # self refresh exit time, tRFC + 7.5 ns
+    tXS = '217.5ns'
+
+    tWTR = '12ns'
+
+    # Default same rank rd-to-wr bus turnaround to 2 CK
+    tRTW = '2.91ns'
+
+    # single rank device, set to 0
+    tCS = '0ns'
+
+    # Activate to activate is 5 ns, irrespective of the bank group
+    tRRD = '5ns'
+    tRRD_L = '5ns'
+
+    tXAW = '20ns'
+    activation_limit = 4
+
+    # The data clock is synchronised with an extra CAS command once it
+    # has been stopped
+    tWCK_SYNC = '1.455ns'
+
+# LPDDR5-5500 in bank group mode with BL16, which needs no burst
+# interleaving
+class LPDDR5_5500_1x16_BG_BL16(LPDDR5_5500_1x16_BG_BL32):
+    burst_length = 16
+
+    # 16 beats at 8 beats per CK take 2 CK
+    burst_interleave = False
+    tBURST = '2.91ns'
+    tBURST_MIN = '2.91ns'
+
+    # tCCD_L is 4 CK for BL16 @ 687.5 MHz
+    tCCD_L = '5.82ns'
+
+# LPDDR5-5500 in 8 bank mode, which only supports BL32 and has no bank
+# groups
+class LPDDR5_5500_1x16_8B_BL32(LPDDR5_5500_1x16_BG_BL32):
+    banks_per_rank = 8
+    bank_groups_per_rank = 0
+
+    # 32 beats at 8 beats per CK take 4 CK, without a gap as there
+    # are no bank groups to interleave with
+    burst_interleave = False
+    tBURST = '5.82ns'
+    tBURST_MIN = '5.82ns'
+    tCCD_L = '0ns'
+
+# LPDDR5-6400 in bank group mode with BL32
+class LPDDR5_6400_1x16_BG_BL32(LPDDR5_5500_1x16_BG_BL32):
+    # 800 MHz
+    tCK = '1.25ns'
+
+    # two halves of 2 CK with a gap of 2 CK
+    tBURST = '7.5ns'
+    tBURST_MIN = '2.5ns'
+
+    # tCCD_L is 8 CK for BL32 @ 800 MHz
+    tCCD_L = '10ns'
+
+    # 17 CK read latency @ 800 MHz
+    tCL = '21.25ns'
+
+    # Default same rank rd-to-wr bus turnaround to 2 CK
+    tRTW = '2.5ns'
+
+    tWCK_SYNC = '1.25ns'
@@ -71,3 +71,9 @@ from XBar import *
 class HMCController(NoncoherentXBar):
         type = 'HMCController'
         cxx_header = "mem/hmc_controller.hh"
+
+        # Ask the serial links for space before sending a request, and
+        # skip the ones that are full rather than having the request
+        # rejected. The master ports must be connected to ports that
+        # answer tryTiming(), such as those of a SerialLink or a Bridge.
+        link_credits = Param.Bool(False, "Skip serial links that are full")
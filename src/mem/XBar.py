@@ -73,6 +73,15 @@ class BaseXBar(MemObject):
     # Width governing the throughput of the crossbar
     width = Param.Unsigned("Datapath width per port (bytes)")
 
+    # Layers either hold a single packet and release themselves with
+    # an event, or, with analytic layers, keep track of the tick each
+    # of their channels is free again, allowing several packets per
+    # layer in flight and avoiding an event per packet
+    analytic_layers = Param.Bool(False, "Account for layer occupancy " \
+                                     "analytically")
+    layer_channels = Param.Unsigned(1, "Packets in flight per layer " \
+                                        "(requires analytic_layers if > 1)")
+
     # The default port can be left unconnected, or be used to connect
     # a default slave port
     default = MasterPort("Port for connecting an optional default slave")
@@ -112,6 +121,29 @@ class CoherentXBar(BaseXBar):
 
     system = Param.System(Parent.any, "System that the crossbar belongs to.")
 
+# A distributed alternative to the coherent crossbar, where the ports
+# connect at the stops of a mesh (or with wrap-around links a torus,
+# and with a single row a ring), and packets pay for the hops between
+# the stops they enter and leave at.
+class MeshXBar(CoherentXBar):
+    type = 'MeshXBar'
+    cxx_header = "mem/mesh_xbar.hh"
+
+    rows = Param.Unsigned(1, "Number of rows of stops")
+    columns = Param.Unsigned("Number of stops per row")
+    torus = Param.Bool(False, "Add wrap-around links at the edges, a " \
+                           "torus with a single row is a ring")
+    hop_latency = Param.Cycles(1, "Latency of a hop between neighbouring " \
+                                   "stops")
+
+    # By default the ports are spread over the stops in contiguous
+    # blocks in connection order, e.g. with one stop per core, the L1
+    # caches of each core share a stop
+    slave_stops = VectorParam.Unsigned([], "Stop of each slave port " \
+                                           "(empty to spread them evenly)")
+    master_stops = VectorParam.Unsigned([], "Stop of each master port " \
+                                            "(empty to spread them evenly)")
+
 class SnoopFilter(SimObject):
     type = 'SnoopFilter'
     cxx_header = "mem/snoop_filter.hh"
@@ -125,6 +157,13 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MB', "Maximum capacity of snoop filter")
 
+    # By default the filter is unbounded and max_capacity is merely a
+    # sanity check. With a non-zero associativity, the filter is
+    # organised in sets and tracks at most max_capacity worth of
+    # lines. Lines are replaced in LRU order, and the copies held by
+    # the caches above are invalidated when a line is evicted.
+    assoc = Param.Unsigned(0, "Associativity (0 for an unbounded filter)")
+
 # We use a coherent crossbar to connect multiple masters to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
@@ -148,6 +187,22 @@ class L2XBar(CoherentXBar):
     # to the first level of unified cache.
     point_of_unification = True
 
+# A mesh connecting the private caches to a sliced shared L2, with
+# one layer of the mesh per stop. The snoop filter is looked up at the
+# stop of the slice an address maps to, and is thus distributed.
+class L2MeshXBar(MeshXBar):
+    width = 32
+
+    frontend_latency = 1
+    forward_latency = 0
+    response_latency = 1
+    snoop_response_latency = 1
+    hop_latency = 1
+
+    snoop_filter = SnoopFilter(lookup_latency = 0)
+
+    point_of_unification = True
+
 # One of the key coherent crossbar instances is the system
 # interconnect, tying together the CPU clusters, GPUs, and any I/O
 # coherent masters, and DRAM controllers.
@@ -224,6 +224,14 @@ RangeAddrMapper::RangeAddrMapper(const RangeAddrMapperParams* p) :
             fatal("AddrMapper: original and shadowed range list elements"
                   " aren't all of the same size\n");
     }
+
+    AddrRangeMap<size_t> range_map;
+    for (size_t x = 0; x < originalRanges.size(); x++) {
+        fatal_if(range_map.insert(originalRanges[x], x) == range_map.end(),
+                 "AddrMapper: original range %s is overlapping\n",
+                 originalRanges[x].to_string());
+    }
+    rangeDecoder.build(range_map);
 }
 
 RangeAddrMapper*
@@ -235,11 +243,10 @@ RangeAddrMapperParams::create()
 Addr
 RangeAddrMapper::remapAddr(Addr addr) const
 {
-    for (int i = 0; i < originalRanges.size(); ++i) {
-        if (originalRanges[i].contains(addr)) {
-            Addr offset = addr - originalRanges[i].start();
-            return offset + remappedRanges[i].start();
-        }
+    const auto r = rangeDecoder.find(addr);
+    if (r) {
+        Addr offset = addr - r->first.start();
+        return offset + remappedRanges[r->second].start();
     }
 
     return addr;
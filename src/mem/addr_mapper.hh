@@ -40,6 +40,7 @@
 #ifndef __MEM_ADDR_MAPPER_HH__
 #define __MEM_ADDR_MAPPER_HH__
 
+#include "base/addr_decoder.hh"
 #include "mem/mem_object.hh"
 #include "params/AddrMapper.hh"
 #include "params/RangeAddrMapper.hh"
@@ -266,6 +267,9 @@ class RangeAddrMapper : public AddrMapper
      */
     std::vector<AddrRange> remappedRanges;
 
+    /** Decoder mapping original ranges to their index. */
+    AddrDecoder<size_t> rangeDecoder;
+
     Addr remapAddr(Addr addr) const;
 
 };
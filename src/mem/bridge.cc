@@ -61,7 +61,8 @@ Bridge::BridgeSlavePort::BridgeSlavePort(const std::string& _name,
                                          std::vector<AddrRange> _ranges)
     : SlavePort(_name, &_bridge), bridge(_bridge), masterPort(_masterPort),
       delay(_delay), ranges(_ranges.begin(), _ranges.end()),
-      outstandingResponses(0), retryReq(false), respQueueLimit(_resp_limit),
+      outstandingResponses(0), retryReq(false), retryReqNeedsResp(false),
+      respQueueLimit(_resp_limit),
       sendEvent([this]{ trySendTiming(); }, _name)
 {
 }
@@ -205,15 +206,25 @@ Bridge::BridgeSlavePort::recvTimingReq(PacketPtr pkt)
 
     // remember that we are now stalling a packet and that we have to
     // tell the sending master to retry once space becomes available,
-    // we make no distinction whether the stalling is due to the
-    // request queue or response queue being full
+    // which for requests expecting a response means space in both
+    // queues
+    if (retryReq)
+        retryReqNeedsResp = pkt->needsResponse();
+
     return !retryReq;
 }
 
+bool
+Bridge::BridgeSlavePort::tryTiming(PacketPtr pkt)
+{
+    return !retryReq && !masterPort.reqQueueFull() &&
+        (!pkt->needsResponse() || !respQueueFull());
+}
+
 void
 Bridge::BridgeSlavePort::retryStalledReq()
 {
-    if (retryReq) {
+    if (retryReq && (!retryReqNeedsResp || !respQueueFull())) {
         DPRINTF(Bridge, "Request waiting for retry, now retrying\n");
         retryReq = false;
         sendRetryReq();
@@ -132,6 +132,13 @@ class Bridge : public MemObject
         /** If we should send a retry when space becomes available. */
         bool retryReq;
 
+        /**
+         * Does the stalled request need space in the response queue?
+         * If so, we hold off the retry until there is space in both
+         * queues, as the request would just be rejected again.
+         */
+        bool retryReqNeedsResp;
+
         /** Max queue size for reserved responses. */
         unsigned int respQueueLimit;
 
@@ -196,6 +203,14 @@ class Bridge : public MemObject
             pass it to the bridge. */
         bool recvTimingReq(PacketPtr pkt);
 
+        /**
+         * Check if there is space for a timing request in the queues
+         * without affecting their state. Senders with a choice of
+         * destinations use this to avoid having their requests
+         * rejected.
+         */
+        bool tryTiming(PacketPtr pkt) override;
+
         /** When receiving a retry request from the peer port,
             pass it to the bridge. */
         void recvRespRetry();
@@ -77,6 +77,10 @@ class BaseCache(MemObject):
     tags = Param.BaseTags(LRU(), "Tag store (replacement policy)")
     sequential_access = Param.Bool(False,
         "Whether to access tags and data sequentially")
+    num_banks = Param.Unsigned(0, "Number of address-interleaved banks "
+                               "(0 to not model bank conflicts)")
+    pipelined_banks = Param.Bool(False,
+        "Whether a bank can start a new access every cycle")
 
     cpu_side = SlavePort("Upstream port closer to the CPU and/or device")
     mem_side = MasterPort("Downstream port closer to memory")
@@ -90,6 +94,10 @@ class BaseCache(MemObject):
 # exclusive.
 class Clusivity(Enum): vals = ['mostly_incl', 'mostly_excl']
 
+# Enum for the accesses a cache holds lines for, used to pick the
+# lines of a cache snapshot that belong to a cache.
+class CacheSnapshotKind(Enum): vals = ['unified', 'data', 'inst']
+
 class Cache(BaseCache):
     type = 'Cache'
     cxx_header = 'mem/cache/cache.hh'
@@ -113,3 +121,22 @@ class Cache(BaseCache):
     # this should be set to True for anything but the last-level
     # cache.
     writeback_clean = Param.Bool(False, "Writeback clean lines")
+
+    # Allocate the data of miss packets in reference counted buffers,
+    # so that forwarded responses can reference the data of the
+    # response from below instead of copying it. The data is copied
+    # as soon as either packet is written to.
+    share_response_data = Param.Bool(False,
+        "Forward response data by reference instead of copying it")
+
+    # Store the addresses of the valid lines in a cache snapshot when
+    # checkpointing, and warm up the cache from the snapshots of the
+    # checkpoint (written by classic caches or by Ruby) when
+    # restoring. Lines are restored clean, so the caches have to be
+    # written back before checkpointing, which draining does.
+    cache_snapshot = Param.Bool(False,
+        "Save and restore the cache contents in checkpoints")
+    snapshot_core = Param.Int(-1,
+        "Core whose lines are restored in this cache (-1 for all)")
+    snapshot_kind = Param.CacheSnapshotKind('unified',
+        "Kind of accesses whose lines are restored in this cache")
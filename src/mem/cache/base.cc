@@ -78,6 +78,9 @@ BaseCache::BaseCache(const BaseCacheParams *p, unsigned blk_size)
       forwardLatency(p->tag_latency),
       fillLatency(p->data_latency),
       responseLatency(p->response_latency),
+      numBanks(p->num_banks),
+      pipelinedBanks(p->pipelined_banks),
+      bankBusyUntil(p->num_banks, 0),
       numTarget(p->tgts_per_mshr),
       forwardSnoops(true),
       isReadOnly(p->is_read_only),
@@ -760,4 +763,36 @@ BaseCache::regStats()
         overallAvgMshrUncacheableLatency.subname(i, system->getMasterName(i));
     }
 
+    bankConflicts
+        .name(name() + ".bank_conflicts")
+        .desc("number of accesses delayed by a busy bank")
+        .flags(nozero)
+        ;
+
+    bankConflictCycles
+        .name(name() + ".bank_conflict_cycles")
+        .desc("number of cycles accesses waited for a busy bank")
+        .flags(nozero)
+        ;
+}
+
+Cycles
+BaseCache::accessBank(Addr addr, Cycles lat)
+{
+    if (numBanks == 0)
+        return Cycles(0);
+
+    Tick &busy_until = bankBusyUntil[(addr / blkSize) % numBanks];
+    const Tick now = clockEdge();
+    const Cycles delay = busy_until > now ?
+        ticksToCycles(busy_until - now) : Cycles(0);
+
+    busy_until = clockEdge(delay + (pipelinedBanks ? Cycles(1) : lat));
+
+    if (delay > 0) {
+        bankConflicts++;
+        bankConflictCycles += delay;
+    }
+
+    return delay;
 }
@@ -286,6 +286,32 @@ class BaseCache : public MemObject
      */
     const Cycles responseLatency;
 
+    /**
+     * Number of banks the blocks are interleaved over, or 0 if bank
+     * conflicts are not modelled.
+     */
+    const unsigned numBanks;
+
+    /**
+     * Whether a bank can start a new access every cycle, rather than
+     * only after the previous access has completed.
+     */
+    const bool pipelinedBanks;
+
+    /** Tick at which each bank can start a new access. */
+    std::vector<Tick> bankBusyUntil;
+
+    /**
+     * Reserve the bank of a block for an access. Does nothing if bank
+     * conflicts are not modelled.
+     *
+     * @param addr Address of the access.
+     * @param lat Latency of the access, which the bank is busy for
+     *            unless the banks are pipelined.
+     * @return Cycles the access has to wait for the bank.
+     */
+    Cycles accessBank(Addr addr, Cycles lat);
+
     /** The number of targets for each MSHR. */
     const int numTarget;
 
@@ -453,6 +479,12 @@ class BaseCache : public MemObject
     /** The average overall latency of an MSHR miss. */
     Stats::Formula overallAvgMshrUncacheableLatency;
 
+    /** Number of accesses that had to wait for a busy bank. */
+    Stats::Scalar bankConflicts;
+
+    /** Total cycles spent waiting for busy banks. */
+    Stats::Scalar bankConflictCycles;
+
     /**
      * @}
      */
@@ -468,6 +500,15 @@ class BaseCache : public MemObject
 
     virtual void init() override;
 
+    /**
+     * The cache stats only depend on the cache itself and the
+     * (already initialised) master names of the system.
+     */
+    bool parallelSetup(SetupPhase phase) const override
+    {
+        return phase == SetupPhase::RegStats;
+    }
+
     virtual BaseMasterPort &getMasterPort(const std::string &if_name,
                                           PortID idx = InvalidPortID) override;
     virtual BaseSlavePort &getSlavePort(const std::string &if_name,
@@ -51,6 +51,7 @@
 #include <list>
 
 #include "base/printable.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 
@@ -76,7 +77,7 @@ enum CacheBlkStatusBits : unsigned {
  * A Basic Cache block.
  * Contains the tag, status, and a pointer to data.
  */
-class CacheBlk
+class CacheBlk : public ReplaceableEntry
 {
   public:
     /** Task Id associated with this block */
@@ -119,6 +120,9 @@ class CacheBlk
 
     Tick tickInserted;
 
+    /** Tick of the most recent access, starting with the insertion. */
+    Tick tickLastTouched;
+
   protected:
     /**
      * Represents that the indicated thread context has a "lock" on
@@ -216,6 +220,7 @@ class CacheBlk
         refCount = 0;
         srcMasterId = Request::invldMasterId;
         tickInserted = MaxTick;
+        tickLastTouched = MaxTick;
         lockList.clear();
     }
 
@@ -54,8 +54,14 @@
 
 #include "mem/cache/cache.hh"
 
+#include <cstring>
+#include <map>
+
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/types.hh"
+#include "cpu/base.hh"
+#include "cpu/thread_context.hh"
 #include "debug/Cache.hh"
 #include "debug/CachePort.hh"
 #include "debug/CacheTags.hh"
@@ -63,7 +69,9 @@
 #include "mem/cache/blk.hh"
 #include "mem/cache/mshr.hh"
 #include "mem/cache/prefetch/base.hh"
+#include "mem/cache_snapshot.hh"
 #include "sim/sim_exit.hh"
+#include "sim/system.hh"
 
 Cache::Cache(const CacheParams *p)
     : BaseCache(p, p->system->cacheLineSize()),
@@ -73,7 +81,12 @@ Cache::Cache(const CacheParams *p)
       prefetchOnAccess(p->prefetch_on_access),
       clusivity(p->clusivity),
       writebackClean(p->writeback_clean),
+      shareResponseData(p->share_response_data),
+      cacheSnapshot(p->cache_snapshot),
+      snapshotCore(p->snapshot_core),
+      snapshotKind(p->snapshot_kind),
       tempBlockWriteback(nullptr),
+      atomicMissData(new uint8_t[blkSize]),
       writebackTempBlockAtomicEvent([this]{ writebackTempBlockAtomic(); },
                                     name(), false,
                                     EventBase::Delayed_Writeback_Pri)
@@ -389,7 +402,7 @@ Cache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
 
         if (blk == nullptr) {
             // need to do a replacement
-            blk = allocateBlock(pkt->getAddr(), pkt->isSecure(), writebacks);
+            blk = allocateBlock(pkt, writebacks);
             if (blk == nullptr) {
                 // no replaceable block available: give up, fwd to next level.
                 incMissCount(pkt);
@@ -450,8 +463,7 @@ Cache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
                 return false;
             } else {
                 // a writeback that misses needs to allocate a new block
-                blk = allocateBlock(pkt->getAddr(), pkt->isSecure(),
-                                    writebacks);
+                blk = allocateBlock(pkt, writebacks);
                 if (!blk) {
                     // no replaceable block available: give up, fwd to
                     // next level.
@@ -748,6 +760,14 @@ Cache::recvTimingReq(PacketPtr pkt)
         // access() calls accessBlock() which can modify lat value.
         satisfied = access(pkt, blk, lat, writebacks);
 
+        // Wait for the bank of the block to be free before accessing
+        // it, which also delays any miss
+        if (!pkt->req->isUncacheable()) {
+            const Cycles bank_delay = accessBank(pkt->getAddr(), lat);
+            lat += bank_delay;
+            forward_time += cyclesToTicks(bank_delay);
+        }
+
         // copy writebacks to write buffer here to ensure they logically
         // proceed anything happening below
         doWritebacks(writebacks, forward_time);
@@ -776,6 +796,11 @@ Cache::recvTimingReq(PacketPtr pkt)
 
         // hit (for all other request types)
 
+        if (prefetcher && blk && blk->wasPrefetched() &&
+            !pkt->cmd.isSWPrefetch() && !pkt->isEviction()) {
+            prefetcher->prefetchUseful();
+        }
+
         if (prefetcher && (prefetchOnAccess ||
                            (blk && blk->wasPrefetched()))) {
             if (blk)
@@ -889,6 +914,15 @@ Cache::recvTimingReq(PacketPtr pkt)
 
                     assert(pkt->req->masterId() < system->maxMasters());
                     mshr_hits[pkt->cmdToIndex()][pkt->req->masterId()]++;
+                    // The first demand request to find an outstanding
+                    // prefetch means that the prefetch was useful,
+                    // but issued too late
+                    if (prefetcher && !pkt->cmd.isSWPrefetch() &&
+                        mshr->getNumTargets() == 1 &&
+                        mshr->getTarget()->source ==
+                        MSHR::Target::FromPrefetcher) {
+                        prefetcher->prefetchLate();
+                    }
                     // We use forward_time here because it is the same
                     // considering new targets. We have multiple
                     // requests for the same address here. It
@@ -959,6 +993,12 @@ Cache::recvTimingReq(PacketPtr pkt)
                            pkt->req->isCacheMaintenance());
                     blk->status &= ~BlkReadable;
                 }
+                if (prefetcher && !pkt->req->isUncacheable() &&
+                    !pkt->cmd.isSWPrefetch() &&
+                    !pkt->req->isCacheMaintenance()) {
+                    prefetcher->demandMiss();
+                }
+
                 // Here we are using forward_time, modelling the latency of
                 // a miss (outbound) just as forwardLatency, neglecting the
                 // lookupLatency component.
@@ -980,9 +1020,8 @@ Cache::recvTimingReq(PacketPtr pkt)
     return true;
 }
 
-PacketPtr
-Cache::createMissPacket(PacketPtr cpu_pkt, CacheBlk *blk,
-                        bool needsWritable) const
+MemCmd
+Cache::missCmd(PacketPtr cpu_pkt, CacheBlk *blk, bool needsWritable) const
 {
     // should never see evictions here
     assert(!cpu_pkt->isEviction());
@@ -994,7 +1033,7 @@ Cache::createMissPacket(PacketPtr cpu_pkt, CacheBlk *blk,
         cpu_pkt->cmd == MemCmd::InvalidateReq || cpu_pkt->isClean()) {
         // uncacheable requests and upgrades from upper-level caches
         // that missed completely just go through as is
-        return nullptr;
+        return MemCmd::InvalidCmd;
     }
 
     assert(cpu_pkt->needsResponse());
@@ -1039,8 +1078,13 @@ Cache::createMissPacket(PacketPtr cpu_pkt, CacheBlk *blk,
         cmd = needsWritable ? MemCmd::ReadExReq :
             (force_clean_rsp ? MemCmd::ReadCleanReq : MemCmd::ReadSharedReq);
     }
-    PacketPtr pkt = new Packet(cpu_pkt->req, cmd, blkSize);
+    return cmd;
+}
 
+void
+Cache::setupMissPacket(PacketPtr cpu_pkt, PacketPtr pkt,
+                       bool needsWritable) const
+{
     // if there are upstream caches that have already marked the
     // packet as having sharers (not passing writable), pass that info
     // downstream
@@ -1056,14 +1100,93 @@ Cache::createMissPacket(PacketPtr cpu_pkt, CacheBlk *blk,
 
     // the packet should be block aligned
     assert(pkt->getAddr() == pkt->getBlockAddr(blkSize));
+}
 
-    pkt->allocate();
+PacketPtr
+Cache::createMissPacket(PacketPtr cpu_pkt, CacheBlk *blk,
+                        bool needsWritable) const
+{
+    MemCmd cmd = missCmd(cpu_pkt, blk, needsWritable);
+    if (cmd == MemCmd::InvalidCmd)
+        return nullptr;
+
+    PacketPtr pkt = new Packet(cpu_pkt->req, cmd, blkSize);
+    setupMissPacket(cpu_pkt, pkt, needsWritable);
+
+    if (shareResponseData)
+        pkt->allocateShared();
+    else
+        pkt->allocate();
     DPRINTF(Cache, "%s: created %s from %s\n", __func__, pkt->print(),
             cpu_pkt->print());
     return pkt;
 }
 
 
+Cycles
+Cache::handleAtomicReqMiss(PacketPtr pkt, PacketPtr bus_pkt, CacheBlk *&blk,
+                           PacketList &writebacks)
+{
+    bool is_forward = (bus_pkt == pkt);
+
+    DPRINTF(Cache, "%s: Sending an atomic %s\n", __func__,
+            bus_pkt->print());
+
+#if TRACING_ON
+    CacheBlk::State old_state = blk ? blk->status : 0;
+#endif
+
+    Cycles lat = ticksToCycles(memSidePort->sendAtomic(bus_pkt));
+
+    bool is_invalidate = bus_pkt->isInvalidate();
+
+    // We are now dealing with the response handling
+    DPRINTF(Cache, "%s: Receive response: %s in state %i\n", __func__,
+            bus_pkt->print(), old_state);
+
+    // If packet was a forward, the response (if any) is already
+    // in place in the bus_pkt == pkt structure, so we don't need
+    // to do anything.  Otherwise, use the separate bus_pkt to
+    // generate response to pkt.
+    if (!is_forward) {
+        if (pkt->needsResponse()) {
+            assert(bus_pkt->isResponse());
+            if (bus_pkt->isError()) {
+                pkt->makeAtomicResponse();
+                pkt->copyError(bus_pkt);
+            } else if (pkt->cmd == MemCmd::WriteLineReq) {
+                // note the use of pkt, not bus_pkt here.
+
+                // write-line request to the cache that promoted
+                // the write to a whole line
+                blk = handleFill(pkt, blk, writebacks,
+                                 allocOnFill(pkt->cmd));
+                assert(blk != NULL);
+                is_invalidate = false;
+                satisfyRequest(pkt, blk);
+            } else if (bus_pkt->isRead() ||
+                       bus_pkt->cmd == MemCmd::UpgradeResp) {
+                // we're updating cache state to allow us to
+                // satisfy the upstream request from the cache
+                blk = handleFill(bus_pkt, blk, writebacks,
+                                 allocOnFill(pkt->cmd));
+                satisfyRequest(pkt, blk);
+                maintainClusivity(pkt->fromCache(), blk);
+            } else {
+                // we're satisfying the upstream request without
+                // modifying cache state, e.g., a write-through
+                pkt->makeAtomicResponse();
+            }
+        }
+    }
+
+    if (is_invalidate && blk && blk->isValid()) {
+        invalidateBlock(blk);
+    }
+
+    return lat;
+}
+
 Tick
 Cache::recvAtomic(PacketPtr pkt)
 {
@@ -1128,70 +1251,17 @@ Cache::recvAtomic(PacketPtr pkt)
         }
         // only misses left
 
-        PacketPtr bus_pkt = createMissPacket(pkt, blk, pkt->needsWritable());
-
-        bool is_forward = (bus_pkt == nullptr);
-
-        if (is_forward) {
+        MemCmd cmd = missCmd(pkt, blk, pkt->needsWritable());
+        if (cmd == MemCmd::InvalidCmd) {
             // just forwarding the same request to the next level
             // no local cache operation involved
-            bus_pkt = pkt;
-        }
-
-        DPRINTF(Cache, "%s: Sending an atomic %s\n", __func__,
-                bus_pkt->print());
-
-#if TRACING_ON
-        CacheBlk::State old_state = blk ? blk->status : 0;
-#endif
-
-        lat += ticksToCycles(memSidePort->sendAtomic(bus_pkt));
-
-        bool is_invalidate = bus_pkt->isInvalidate();
-
-        // We are now dealing with the response handling
-        DPRINTF(Cache, "%s: Receive response: %s in state %i\n", __func__,
-                bus_pkt->print(), old_state);
-
-        // If packet was a forward, the response (if any) is already
-        // in place in the bus_pkt == pkt structure, so we don't need
-        // to do anything.  Otherwise, use the separate bus_pkt to
-        // generate response to pkt and then delete it.
-        if (!is_forward) {
-            if (pkt->needsResponse()) {
-                assert(bus_pkt->isResponse());
-                if (bus_pkt->isError()) {
-                    pkt->makeAtomicResponse();
-                    pkt->copyError(bus_pkt);
-                } else if (pkt->cmd == MemCmd::WriteLineReq) {
-                    // note the use of pkt, not bus_pkt here.
-
-                    // write-line request to the cache that promoted
-                    // the write to a whole line
-                    blk = handleFill(pkt, blk, writebacks,
-                                     allocOnFill(pkt->cmd));
-                    assert(blk != NULL);
-                    is_invalidate = false;
-                    satisfyRequest(pkt, blk);
-                } else if (bus_pkt->isRead() ||
-                           bus_pkt->cmd == MemCmd::UpgradeResp) {
-                    // we're updating cache state to allow us to
-                    // satisfy the upstream request from the cache
-                    blk = handleFill(bus_pkt, blk, writebacks,
-                                     allocOnFill(pkt->cmd));
-                    satisfyRequest(pkt, blk);
-                    maintainClusivity(pkt->fromCache(), blk);
-                } else {
-                    // we're satisfying the upstream request without
-                    // modifying cache state, e.g., a write-through
-                    pkt->makeAtomicResponse();
-                }
-            }
-            delete bus_pkt;
-        }
-
-        if (is_invalidate && blk && blk->isValid()) {
-            invalidateBlock(blk);
+            lat += handleAtomicReqMiss(pkt, pkt, blk, writebacks);
+        } else {
+            Packet bus_pkt(pkt->req, cmd, blkSize);
+            setupMissPacket(pkt, &bus_pkt, pkt->needsWritable());
+            if (bus_pkt.hasData() || bus_pkt.hasRespData())
+                bus_pkt.dataStatic(atomicMissData.get());
+            lat += handleAtomicReqMiss(pkt, &bus_pkt, blk, writebacks);
         }
     }
 
@@ -1408,6 +1478,9 @@ Cache::recvTimingResp(PacketPtr pkt)
 
         blk = handleFill(pkt, blk, writebacks, mshr->allocOnFill());
         assert(blk != nullptr);
+
+        // The fill is buffered, but writing it keeps the bank busy
+        accessBank(pkt->getAddr(), fillLatency);
     }
 
     // allow invalidation responses originating from write-line
@@ -1526,7 +1599,10 @@ Cache::recvTimingResp(PacketPtr pkt)
                     assert(pkt->getAddr() == tgt_pkt->getAddr());
                     assert(pkt->getSize() >= tgt_pkt->getSize());
 
-                    tgt_pkt->setData(pkt->getConstPtr<uint8_t>());
+                    if (shareResponseData)
+                        tgt_pkt->shareData(pkt);
+                    else
+                        tgt_pkt->setData(pkt->getConstPtr<uint8_t>());
                 }
             }
             tgt_pkt->makeTimingResponse();
@@ -1814,42 +1890,57 @@ Cache::invalidateVisitor(CacheBlk &blk)
 }
 
 CacheBlk*
-Cache::allocateBlock(Addr addr, bool is_secure, PacketList &writebacks)
+Cache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
 {
-    CacheBlk *blk = tags->findVictim(addr);
+    Addr addr = pkt->getAddr();
+    const uint8_t *data = pkt->hasData() ? pkt->getConstPtr<uint8_t>() :
+        nullptr;
+
+    std::vector<CacheBlk*> evict_blks;
+    CacheBlk *blk = tags->findReplacement(addr, data, evict_blks);
 
     // It is valid to return nullptr if there is no victim
     if (!blk)
         return nullptr;
 
-    if (blk->isValid()) {
-        Addr repl_addr = tags->regenerateBlkAddr(blk);
-        MSHR *repl_mshr = mshrQueue.findMatch(repl_addr, blk->isSecure());
+    for (const auto &evict_blk : evict_blks) {
+        Addr repl_addr = tags->regenerateBlkAddr(evict_blk);
+        MSHR *repl_mshr = mshrQueue.findMatch(repl_addr,
+                                              evict_blk->isSecure());
         if (repl_mshr) {
             // must be an outstanding upgrade request
             // on a block we're about to replace...
-            assert(!blk->isWritable() || blk->isDirty());
+            assert(!evict_blk->isWritable() || evict_blk->isDirty());
             assert(repl_mshr->needsWritable());
             // too hard to replace block with transient state
             // allocation failed, block not inserted
             return nullptr;
+        }
+    }
+
+    for (const auto &evict_blk : evict_blks) {
+        DPRINTF(Cache, "replacement: replacing %#llx (%s) with %#llx "
+                "(%s): %s\n", tags->regenerateBlkAddr(evict_blk),
+                evict_blk->isSecure() ? "s" : "ns",
+                addr, pkt->isSecure() ? "s" : "ns",
+                evict_blk->isDirty() ? "writeback" : "clean");
+
+        if (evict_blk->wasPrefetched()) {
+            unusedPrefetches++;
+        }
+        // Will send up Writeback/CleanEvict snoops via isCachedAbove
+        // when pushing this writeback list into the write buffer.
+        if (evict_blk->isDirty() || writebackClean) {
+            // Save writeback packet for handling by caller
+            writebacks.push_back(writebackBlk(evict_blk));
         } else {
-            DPRINTF(Cache, "replacement: replacing %#llx (%s) with %#llx "
-                    "(%s): %s\n", repl_addr, blk->isSecure() ? "s" : "ns",
-                    addr, is_secure ? "s" : "ns",
-                    blk->isDirty() ? "writeback" : "clean");
+            writebacks.push_back(cleanEvictBlk(evict_blk));
+        }
 
-            if (blk->wasPrefetched()) {
-                unusedPrefetches++;
-            }
-            // Will send up Writeback/CleanEvict snoops via isCachedAbove
-            // when pushing this writeback list into the write buffer.
-            if (blk->isDirty() || writebackClean) {
-                // Save writeback packet for handling by caller
-                writebacks.push_back(writebackBlk(blk));
-            } else {
-                writebacks.push_back(cleanEvictBlk(blk));
-            }
+        // the replaced block is invalidated when the new block is
+        // inserted, any other block has to go now
+        if (evict_blk != blk) {
+            invalidateBlock(evict_blk);
         }
     }
 
@@ -1895,7 +1986,7 @@ Cache::handleFill(PacketPtr pkt, CacheBlk *blk, PacketList &writebacks,
 
         // need to do a replacement if allocating, otherwise we stick
         // with the temporary storage
-        blk = allocate ? allocateBlock(addr, is_secure, writebacks) : nullptr;
+        blk = allocate ? allocateBlock(pkt, writebacks) : nullptr;
 
         if (blk == nullptr) {
             // No replaceable block or a mostly exclusive
@@ -2720,6 +2811,48 @@ Cache::serialize(CheckpointOut &cp) const
     // cache contains dirty data.
     bool bad_checkpoint(dirty);
     SERIALIZE_SCALAR(bad_checkpoint);
+
+    if (!cacheSnapshot)
+        return;
+
+    // Blocks are accounted to the master that brought them in, which
+    // tells the core and whether they were fetched for instructions
+    std::map<MasterID, std::pair<int, bool>> masters;
+    for (auto tc : system->threadContexts) {
+        BaseCPU *cpu = tc->getCpuPtr();
+        masters[cpu->dataMasterId()] = std::make_pair(cpu->cpuId(), false);
+        masters[cpu->instMasterId()] = std::make_pair(cpu->cpuId(), true);
+    }
+
+    CacheBlkCollectVisitor visitor;
+    tags->forEachBlk(visitor);
+
+    CacheSnapshot snapshot;
+    for (const auto blk : visitor.blks) {
+        CacheSnapshot::Line line;
+        line.addr = tags->regenerateBlkAddr(blk);
+        line.size = blkSize;
+        line.core = snapshotCore;
+        line.secure = blk->isSecure();
+        line.lastTouch = blk->tickLastTouched;
+
+        bool inst = snapshotKind == Enums::inst;
+        auto master = masters.find(blk->srcMasterId);
+        if (master != masters.end()) {
+            if (line.core < 0)
+                line.core = master->second.first;
+            inst = inst || master->second.second;
+        }
+
+        if (inst)
+            line.kind = CacheSnapshot::Kind::IFetch;
+        else if (blk->isWritable())
+            line.kind = CacheSnapshot::Kind::Store;
+        else
+            line.kind = CacheSnapshot::Kind::Load;
+        snapshot.lines.push_back(line);
+    }
+    snapshot.write(name());
 }
 
 void
@@ -2734,6 +2867,97 @@ Cache::unserialize(CheckpointIn &cp)
     }
 }
 
+void
+Cache::loadState(CheckpointIn &cp)
+{
+    BaseCache::loadState(cp);
+
+    // The snapshot may have been written by another memory system,
+    // so look for it even if the checkpoint has no section for us
+    if (cacheSnapshot)
+        snapshotDir = cp.cptDir;
+}
+
+void
+Cache::startup()
+{
+    BaseCache::startup();
+
+    if (snapshotDir.empty())
+        return;
+
+    // Account the restored blocks to the masters of their core
+    std::map<int, std::pair<MasterID, MasterID>> masters;
+    for (auto tc : system->threadContexts) {
+        BaseCPU *cpu = tc->getCpuPtr();
+        masters[cpu->cpuId()] =
+            std::make_pair(cpu->dataMasterId(), cpu->instMasterId());
+    }
+
+    // Lines are least recently used first, so installing them in
+    // order leaves the most recently used ones in the cache
+    for (const auto &line : CacheSnapshot::load(snapshotDir)) {
+        const bool inst = line.kind == CacheSnapshot::Kind::IFetch;
+        if (snapshotCore >= 0 && line.core >= 0 && line.core != snapshotCore)
+            continue;
+        if ((snapshotKind == Enums::inst && !inst) ||
+            (snapshotKind == Enums::data && inst))
+            continue;
+
+        MasterID master_id = Request::funcMasterId;
+        auto master = masters.find(line.core);
+        if (master != masters.end()) {
+            master_id = inst ? master->second.second :
+                master->second.first;
+        }
+
+        // The line size of the snapshot need not be ours
+        const Addr end = line.addr + line.size;
+        for (Addr addr = roundDown(line.addr, blkSize); addr < end;
+             addr += blkSize) {
+            installSnapshotBlk(addr, line.secure, master_id);
+        }
+    }
+    snapshotDir.clear();
+}
+
+void
+Cache::installSnapshotBlk(Addr addr, bool is_secure, MasterID master_id)
+{
+    if (tags->findBlock(addr, is_secure))
+        return;
+
+    Request request(addr, blkSize, 0, master_id);
+    if (is_secure) {
+        request.setFlags(Request::SECURE);
+    }
+
+    Packet packet(&request, MemCmd::ReadReq);
+    packet.allocate();
+    memSidePort->sendFunctional(&packet);
+
+    std::vector<CacheBlk*> evict_blks;
+    CacheBlk *blk = tags->findReplacement(addr,
+        packet.getConstPtr<uint8_t>(), evict_blks);
+    if (!blk)
+        return;
+
+    // The cache only holds clean blocks while warming up, so the
+    // victims are dropped without a writeback
+    for (const auto &evict_blk : evict_blks) {
+        if (evict_blk != blk) {
+            invalidateBlock(evict_blk);
+        }
+    }
+
+    tags->insertBlock(&packet, blk);
+    blk->status |= BlkValid | BlkReadable;
+    if (is_secure) {
+        blk->status |= BlkSecure;
+    }
+    std::memcpy(blk->data, packet.getConstPtr<uint8_t>(), blkSize);
+}
+
 ///////////////
 //
 // CpuSidePort
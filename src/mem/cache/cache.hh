@@ -55,6 +55,7 @@
 #include <unordered_set>
 
 #include "base/logging.hh" // fatal, panic, and warn
+#include "enums/CacheSnapshotKind.hh"
 #include "enums/Clusivity.hh"
 #include "mem/cache/base.hh"
 #include "mem/cache/blk.hh"
@@ -227,6 +228,28 @@ class Cache : public BaseCache
      */
     const bool writebackClean;
 
+    /**
+     * Allocate the data of miss packets in shared buffers, and hand
+     * the buffer of a response to the packets it is forwarded to
+     * rather than copying the data.
+     */
+    const bool shareResponseData;
+
+    /** Save and restore the cache contents using cache snapshots. */
+    const bool cacheSnapshot;
+
+    /** Core whose snapshot lines are restored, -1 for all cores. */
+    const int snapshotCore;
+
+    /** Kind of accesses whose snapshot lines are restored. */
+    const Enums::CacheSnapshotKind snapshotKind;
+
+    /**
+     * Checkpoint to warm up the cache from on startup, empty if not
+     * restoring or if cache snapshots are disabled.
+     */
+    std::string snapshotDir;
+
     /**
      * Upstream caches need this packet until true is returned, so
      * hold it for deletion until a subsequent call
@@ -242,6 +265,14 @@ class Cache : public BaseCache
      */
     PacketPtr tempBlockWriteback;
 
+    /**
+     * Buffer receiving the data of atomic miss responses. An atomic
+     * miss packet does not outlive the call that creates it, so it is
+     * built on the stack and its data is stored here rather than in a
+     * new allocation.
+     */
+    std::unique_ptr<uint8_t[]> atomicMissData;
+
     /**
      * Send the outstanding tempBlock writeback. To be called after
      * recvAtomic finishes in cases where the block we filled is in
@@ -285,13 +316,14 @@ class Cache : public BaseCache
     void cmpAndSwap(CacheBlk *blk, PacketPtr pkt);
 
     /**
-     * Find a block frame for new block at address addr targeting the
-     * given security space, assuming that the block is not currently
-     * in the cache.  Append writebacks if any to provided packet
-     * list.  Return free block frame.  May return nullptr if there are
-     * no replaceable blocks at the moment.
+     * Find a block frame for the block of packet pkt, assuming that
+     * the block is not currently in the cache. The data of the packet,
+     * if any, is used by tags that need to know the block contents
+     * (e.g., to compress them). Append writebacks if any to provided
+     * packet list.  Return free block frame.  May return nullptr if
+     * there are no replaceable blocks at the moment.
      */
-    CacheBlk *allocateBlock(Addr addr, bool is_secure, PacketList &writebacks);
+    CacheBlk *allocateBlock(const PacketPtr pkt, PacketList &writebacks);
 
     /**
      * Invalidate a cache block.
@@ -488,6 +520,17 @@ class Cache : public BaseCache
      */
     bool invalidateVisitor(CacheBlk &blk);
 
+    /**
+     * Install a clean copy of a block read from memory, unless the
+     * block is already in the cache. Used to warm up the cache from a
+     * cache snapshot, replacing blocks without writing them back.
+     *
+     * @param addr Block aligned address.
+     * @param is_secure Whether the block is in the secure space.
+     * @param master_id Master the block is accounted to.
+     */
+    void installSnapshotBlk(Addr addr, bool is_secure, MasterID master_id);
+
     /**
      * Create an appropriate downstream bus request packet for the
      * given parameters.
@@ -502,6 +545,41 @@ class Cache : public BaseCache
     PacketPtr createMissPacket(PacketPtr cpu_pkt, CacheBlk *blk,
                                bool needsWritable) const;
 
+    /**
+     * Determine the command of the downstream bus request for a miss.
+     * @param cpu_pkt  The miss that needs to be satisfied.
+     * @param blk The block currently in the cache corresponding to
+     * cpu_pkt (nullptr if none).
+     * @param needsWritable Indicates that the block must be writable
+     * even if the request in cpu_pkt doesn't indicate that.
+     * @return The command, or MemCmd::InvalidCmd if the current
+     * request in cpu_pkt should just be forwarded on.
+     */
+    MemCmd missCmd(PacketPtr cpu_pkt, CacheBlk *blk,
+                   bool needsWritable) const;
+
+    /**
+     * Pass the state of a miss on to the bus request created for it.
+     * @param cpu_pkt  The miss that needs to be satisfied.
+     * @param pkt The downstream bus request.
+     * @param needsWritable Indicates that the block must be writable.
+     */
+    void setupMissPacket(PacketPtr cpu_pkt, PacketPtr pkt,
+                         bool needsWritable) const;
+
+    /**
+     * Send an atomic miss downstream and use the response to fill the
+     * cache and satisfy the request.
+     * @param pkt The miss that needs to be satisfied.
+     * @param bus_pkt The downstream bus request, pkt if the request
+     * is just forwarded on.
+     * @param blk The block corresponding to pkt, updated on a fill.
+     * @param writebacks List of writebacks resulting from a fill.
+     * @return The latency of the downstream access.
+     */
+    Cycles handleAtomicReqMiss(PacketPtr pkt, PacketPtr bus_pkt,
+                               CacheBlk *&blk, PacketList &writebacks);
+
     /**
      * Return the next queue entry to service, either a pending miss
      * from the MSHR queue, a buffered write from the write buffer, or
@@ -571,10 +649,14 @@ class Cache : public BaseCache
     bool sendWriteQueuePacket(WriteQueueEntry* wq_entry);
 
     /** serialize the state of the caches
-     * We currently don't support checkpointing cache state, so this panics.
+     * The data in the cache is not checkpointed, but the addresses
+     * of the valid blocks are stored in a cache snapshot if enabled.
      */
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
+
+    void loadState(CheckpointIn &cp) override;
+    void startup() override;
 };
 
 /**
@@ -602,6 +684,24 @@ class CacheBlkVisitorWrapper : public CacheBlkVisitor
     VisitorPtr visitor;
 };
 
+/**
+ * Cache block visitor that collects the valid blocks of a cache.
+ *
+ * Use with the forEachBlk method in the tag array to get the blocks
+ * to store in a cache snapshot.
+ */
+class CacheBlkCollectVisitor : public CacheBlkVisitor
+{
+  public:
+    bool operator()(CacheBlk &blk) override {
+        if (blk.isValid())
+            blks.push_back(&blk);
+        return true;
+    }
+
+    std::vector<const CacheBlk *> blks;
+};
+
 /**
  * Cache block visitor that determines if there are dirty blocks in a
  * cache.
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of the base class of the cache block compressors.
+ */
+
+#include "mem/cache/compressors/base.hh"
+
+BaseCacheCompressor::BaseCacheCompressor(const Params *p)
+    : SimObject(p), blkSize(p->block_size),
+      compressionLatency(p->compression_latency),
+      decompressionLatency(p->decompression_latency)
+{
+}
+
+std::size_t
+BaseCacheCompressor::compress(const uint8_t *data, Cycles &comp_lat,
+                              Cycles &decomp_lat)
+{
+    const std::size_t uncompressed_bits = blkSize * 8;
+
+    if (!data) {
+        comp_lat = Cycles(0);
+        decomp_lat = Cycles(0);
+        return uncompressed_bits;
+    }
+
+    const std::size_t bits = compressedBits(data);
+
+    compressions++;
+    comp_lat = compressionLatency;
+    if (bits < uncompressed_bits) {
+        compressedSize += bits;
+        decomp_lat = decompressionLatency;
+        return bits;
+    } else {
+        uncompressible++;
+        compressedSize += uncompressed_bits;
+        decomp_lat = Cycles(0);
+        return uncompressed_bits;
+    }
+}
+
+void
+BaseCacheCompressor::regStats()
+{
+    SimObject::regStats();
+
+    compressions
+        .name(name() + ".compressions")
+        .desc("Total number of compressions")
+        ;
+
+    uncompressible
+        .name(name() + ".uncompressible")
+        .desc("Number of blocks that could not be compressed")
+        ;
+
+    compressedSize
+        .name(name() + ".compressed_size")
+        .desc("Total size of the compressed blocks, in bits")
+        ;
+
+    compressionRatio
+        .name(name() + ".compression_ratio")
+        .desc("Average compression ratio")
+        ;
+
+    compressionRatio = compressions * Stats::constant(blkSize * 8) /
+        compressedSize;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the base class of the cache block compressors.
+ */
+
+#ifndef __MEM_CACHE_COMPRESSORS_BASE_HH__
+#define __MEM_CACHE_COMPRESSORS_BASE_HH__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "params/BaseCacheCompressor.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * A cache block compressor. Compressors only model the size a block
+ * would have once compressed and the latency of doing so; the cache
+ * keeps the uncompressed data, so that reading and writing blocks is
+ * unaffected.
+ */
+class BaseCacheCompressor : public SimObject
+{
+  protected:
+    /** Uncompressed size of a block, in bytes. */
+    const unsigned blkSize;
+
+    /** Latency of compressing a block. */
+    const Cycles compressionLatency;
+
+    /** Latency of decompressing a compressed block. */
+    const Cycles decompressionLatency;
+
+    /**
+     * Compute the size of a compressed block. The result may exceed
+     * the uncompressed size, in which case the block is stored
+     * uncompressed.
+     * @param data The uncompressed data of the block.
+     * @return The size of the compressed block, in bits.
+     */
+    virtual std::size_t compressedBits(const uint8_t *data) const = 0;
+
+    /** Number of blocks compressed. */
+    Stats::Scalar compressions;
+
+    /** Number of blocks that could not be compressed. */
+    Stats::Scalar uncompressible;
+
+    /** Total size of the compressed blocks, in bits. */
+    Stats::Scalar compressedSize;
+
+    /** Average compression ratio. */
+    Stats::Formula compressionRatio;
+
+  public:
+    /** Convenience typedef. */
+    typedef BaseCacheCompressorParams Params;
+
+    BaseCacheCompressor(const Params *p);
+    virtual ~BaseCacheCompressor() {}
+
+    /**
+     * Compress a block.
+     * @param data The uncompressed data of the block, nullptr if
+     * unknown, in which case the block is considered uncompressible.
+     * @param comp_lat The latency of the compression.
+     * @param decomp_lat The latency of decompressing the block.
+     * @return The size of the stored block, in bits, which is at most
+     * the uncompressed size.
+     */
+    std::size_t compress(const uint8_t *data, Cycles &comp_lat,
+                         Cycles &decomp_lat);
+
+    void regStats() override;
+};
+
+#endif // __MEM_CACHE_COMPRESSORS_BASE_HH__
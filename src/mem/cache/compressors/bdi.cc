@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a Base-Delta-Immediate compressor.
+ */
+
+#include "mem/cache/compressors/bdi.hh"
+
+#include <algorithm>
+#include <cstring>
+
+/** Number of bits identifying the encoding of a block. */
+static const std::size_t encodingBits = 4;
+
+/**
+ * Read a word of the given size, sign-extended to 64 bits.
+ * @param data Pointer to the word.
+ * @param size Size of the word, in bytes.
+ */
+static int64_t
+readSigned(const uint8_t *data, unsigned size)
+{
+    uint64_t value = 0;
+    std::memcpy(&value, data, size);
+    if (size < sizeof(value)) {
+        const unsigned shift = 64 - 8 * size;
+        return (int64_t)(value << shift) >> shift;
+    }
+    return (int64_t)value;
+}
+
+/** Whether a value fits in a signed integer of the given size. */
+static bool
+fitsSigned(int64_t value, unsigned size)
+{
+    if (size >= sizeof(value))
+        return true;
+    const int64_t limit = (int64_t)1 << (8 * size - 1);
+    return value >= -limit && value < limit;
+}
+
+/**
+ * Check whether a block can be encoded with the given base and delta
+ * sizes, using an implicit base of zero and the first word that does
+ * not fit next to it as the explicit base.
+ */
+static bool
+fitsBaseDelta(const uint8_t *data, unsigned blk_size, unsigned base_size,
+              unsigned delta_size)
+{
+    bool has_base = false;
+    int64_t base = 0;
+
+    for (unsigned i = 0; i < blk_size; i += base_size) {
+        const int64_t value = readSigned(data + i, base_size);
+        if (fitsSigned(value, delta_size))
+            continue;
+
+        if (!has_base) {
+            has_base = true;
+            base = value;
+        }
+
+        // compute the difference modulo 2^64 to avoid overflows
+        const int64_t delta = (int64_t)((uint64_t)value - (uint64_t)base);
+        if (!fitsSigned(delta, delta_size))
+            return false;
+    }
+
+    return true;
+}
+
+BDI::BDI(const Params *p)
+    : BaseCacheCompressor(p)
+{
+}
+
+std::size_t
+BDI::compressedBits(const uint8_t *data) const
+{
+    // a block of zeros only needs its encoding
+    if (std::all_of(data, data + blkSize, [](uint8_t b) { return b == 0; }))
+        return encodingBits;
+
+    // a repeated 8-byte value is stored once
+    bool repeated = blkSize % 8 == 0;
+    for (unsigned i = 8; repeated && i < blkSize; i += 8)
+        repeated = std::memcmp(data, data + i, 8) == 0;
+    if (repeated)
+        return encodingBits + 64;
+
+    static const struct { unsigned base; unsigned delta; } encodings[] = {
+        { 8, 1 }, { 8, 2 }, { 8, 4 }, { 4, 1 }, { 4, 2 }, { 2, 1 },
+    };
+
+    std::size_t best = blkSize * 8;
+    for (const auto &enc : encodings) {
+        if (blkSize % enc.base != 0 ||
+            !fitsBaseDelta(data, blkSize, enc.base, enc.delta)) {
+            continue;
+        }
+
+        // the base, a delta and a base selection bit per word
+        const unsigned words = blkSize / enc.base;
+        best = std::min(best, encodingBits + 8 * enc.base +
+                        words * (8 * enc.delta + 1));
+    }
+
+    return best;
+}
+
+BDI*
+BDIParams::create()
+{
+    return new BDI(this);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a C-Pack compressor.
+ */
+
+#include "mem/cache/compressors/cpack.hh"
+
+#include <cstring>
+
+/** Number of entries of the dictionary. */
+static const unsigned dictionarySize = 16;
+
+/** Number of bits of a dictionary index. */
+static const std::size_t indexBits = 4;
+
+CPack::CPack(const Params *p)
+    : BaseCacheCompressor(p)
+{
+}
+
+std::size_t
+CPack::compressedBits(const uint8_t *data) const
+{
+    uint32_t dictionary[dictionarySize];
+    unsigned num_entries = 0;
+    unsigned next_entry = 0;
+    std::size_t bits = 0;
+
+    for (unsigned i = 0; i < blkSize; i += sizeof(uint32_t)) {
+        uint32_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+
+        if (word == 0) {
+            // zzzz: code only
+            bits += 2;
+            continue;
+        } else if ((word & 0xffffff00) == 0) {
+            // zzzx: code and the low byte
+            bits += 4 + 8;
+            continue;
+        }
+
+        // find the dictionary entry matching the most upper bytes
+        unsigned matched = 0;
+        for (unsigned e = 0; e < num_entries && matched < 4; ++e) {
+            const uint32_t diff = word ^ dictionary[e];
+            const unsigned bytes = diff == 0 ? 4 :
+                (diff & 0xffffff00) == 0 ? 3 :
+                (diff & 0xffff0000) == 0 ? 2 : 0;
+            if (bytes > matched)
+                matched = bytes;
+        }
+
+        if (matched == 4) {
+            // mmmm: code and index
+            bits += 2 + indexBits;
+            continue;
+        } else if (matched == 3) {
+            // mmmx: code, index and the unmatched byte
+            bits += 4 + indexBits + 8;
+        } else if (matched == 2) {
+            // mmxx: code, index and the unmatched halfword
+            bits += 4 + indexBits + 16;
+        } else {
+            // xxxx: code and the word
+            bits += 2 + 32;
+        }
+
+        // words that were not fully matched enter the dictionary
+        dictionary[next_entry] = word;
+        next_entry = (next_entry + 1) % dictionarySize;
+        if (num_entries < dictionarySize)
+            ++num_entries;
+    }
+
+    return bits;
+}
+
+CPack*
+CPackParams::create()
+{
+    return new CPack(this);
+}
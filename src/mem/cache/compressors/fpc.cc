@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a Frequent Pattern Compression compressor.
+ */
+
+#include "mem/cache/compressors/fpc.hh"
+
+#include <cstring>
+
+/** Number of bits of a pattern prefix. */
+static const std::size_t prefixBits = 3;
+
+/** Maximum number of zero words encoded by a single prefix. */
+static const unsigned maxZeroRun = 8;
+
+/** Whether a word is a sign-extended value of the given number of bits. */
+static bool
+isSignExtended(uint32_t word, unsigned bits)
+{
+    const int32_t value = (int32_t)word;
+    const int32_t limit = (int32_t)1 << (bits - 1);
+    return value >= -limit && value < limit;
+}
+
+FPC::FPC(const Params *p)
+    : BaseCacheCompressor(p)
+{
+}
+
+std::size_t
+FPC::compressedBits(const uint8_t *data) const
+{
+    const unsigned num_words = blkSize / sizeof(uint32_t);
+    std::size_t bits = 0;
+
+    for (unsigned i = 0; i < num_words; ) {
+        uint32_t word;
+        std::memcpy(&word, data + i * sizeof(word), sizeof(word));
+
+        if (word == 0) {
+            // a run of zero words, with the run length as data
+            unsigned run = 1;
+            while (run < maxZeroRun && i + run < num_words) {
+                uint32_t next;
+                std::memcpy(&next, data + (i + run) * sizeof(next),
+                            sizeof(next));
+                if (next != 0)
+                    break;
+                ++run;
+            }
+            bits += prefixBits + 3;
+            i += run;
+            continue;
+        }
+
+        const uint16_t upper = word >> 16;
+        const uint16_t lower = word & 0xffff;
+        const uint8_t byte = word & 0xff;
+        if (isSignExtended(word, 4)) {
+            bits += prefixBits + 4;
+        } else if (isSignExtended(word, 8)) {
+            bits += prefixBits + 8;
+        } else if (isSignExtended(word, 16)) {
+            bits += prefixBits + 16;
+        } else if (lower == 0) {
+            // halfword padded with a zero halfword
+            bits += prefixBits + 16;
+        } else if ((int16_t)upper == (int8_t)(upper & 0xff) &&
+                   (int16_t)lower == (int8_t)(lower & 0xff)) {
+            // two halfwords, each a sign-extended byte
+            bits += prefixBits + 16;
+        } else if (word == byte * 0x01010101U) {
+            // word consisting of repeated bytes
+            bits += prefixBits + 8;
+        } else {
+            bits += prefixBits + 32;
+        }
+        ++i;
+    }
+
+    return bits;
+}
+
+FPC*
+FPCParams::create()
+{
+    return new FPC(this);
+}
@@ -42,6 +42,7 @@
 from ClockedObject import ClockedObject
 from m5.params import *
 from m5.proxy import *
+from ReplacementPolicies import *
 
 class BasePrefetcher(ClockedObject):
     type = 'BasePrefetcher'
@@ -81,6 +82,8 @@ class StridePrefetcher(QueuedPrefetcher):
     table_sets = Param.Int(16, "Number of sets in PC lookup table")
     table_assoc = Param.Int(4, "Associativity of PC lookup table")
     use_master_id = Param.Bool(True, "Use master id based history")
+    table_replacement_policy = Param.BaseReplacementPolicy(RandomRP(),
+        "Replacement policy of the PC lookup table")
 
     degree = Param.Int(4, "Number of prefetches to generate")
 
@@ -90,3 +93,48 @@ class TaggedPrefetcher(QueuedPrefetcher):
     cxx_header = "mem/cache/prefetch/tagged.hh"
 
     degree = Param.Int(2, "Number of prefetches to generate")
+
+class BOPPrefetcher(QueuedPrefetcher):
+    type = 'BOPPrefetcher'
+    cxx_class = 'BOPPrefetcher'
+    cxx_header = "mem/cache/prefetch/bop.hh"
+
+    score_max = Param.Unsigned(31, "Score that ends a learning phase")
+    round_max = Param.Unsigned(100, "Maximum number of rounds in a phase")
+    bad_score = Param.Unsigned(1, "Best score below which prefetching "
+                               "is disabled")
+    rr_size = Param.Unsigned(64, "Number of entries of the recent "
+                             "requests table")
+    max_offset = Param.Unsigned(63, "Largest candidate offset (in blocks)")
+    negative_offsets = Param.Bool(False, "Also learn negative offsets")
+
+    degree = Param.Unsigned(1, "Number of prefetches to generate")
+
+class AMPMPrefetcher(QueuedPrefetcher):
+    type = 'AMPMPrefetcher'
+    cxx_class = 'AMPMPrefetcher'
+    cxx_header = "mem/cache/prefetch/ampm.hh"
+
+    num_maps = Param.Unsigned(64, "Number of page access maps")
+
+    degree = Param.Unsigned(4, "Maximum number of prefetches to generate")
+
+class SPPPrefetcher(QueuedPrefetcher):
+    type = 'SPPPrefetcher'
+    cxx_class = 'SPPPrefetcher'
+    cxx_header = "mem/cache/prefetch/spp.hh"
+
+    signature_table_entries = Param.Unsigned(256,
+        "Number of entries of the signature table")
+    signature_bits = Param.Unsigned(12, "Number of bits of a signature")
+    signature_shift = Param.Unsigned(3,
+        "Shift applied to a signature before adding a delta")
+    pattern_table_deltas = Param.Unsigned(4,
+        "Number of deltas per pattern table entry")
+    counter_bits = Param.Unsigned(4,
+        "Number of bits of the pattern table counters")
+
+    prefetch_confidence_threshold = Param.Float(0.5,
+        "Minimum path confidence to issue a prefetch")
+    lookahead_confidence_threshold = Param.Float(0.75,
+        "Minimum path confidence to continue the lookahead")
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Access map pattern matching prefetcher definitions.
+ */
+
+#include "mem/cache/prefetch/ampm.hh"
+
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+
+AMPMPrefetcher::AMPMPrefetcher(const AMPMPrefetcherParams *p)
+    : QueuedPrefetcher(p), degree(p->degree), maps(p->num_maps),
+      accessCount(0)
+{
+    fatal_if(maps.empty(), "%s: at least one access map is needed\n",
+             name());
+}
+
+AMPMPrefetcher::AccessMap &
+AMPMPrefetcher::getMap(Addr page, bool is_secure)
+{
+    AccessMap *victim = &maps[0];
+    for (AccessMap &map : maps) {
+        if (map.valid && map.page == page && map.isSecure == is_secure) {
+            map.lastUse = ++accessCount;
+            return map;
+        }
+        if (!map.valid) {
+            victim = &map;
+        } else if (victim->valid && map.lastUse < victim->lastUse) {
+            victim = &map;
+        }
+    }
+
+    victim->page = page;
+    victim->isSecure = is_secure;
+    victim->valid = true;
+    victim->lastUse = ++accessCount;
+    victim->states.assign(pageBytes >> lBlkSize, Init);
+    return *victim;
+}
+
+void
+AMPMPrefetcher::calculatePrefetch(const PacketPtr &pkt,
+        std::vector<AddrPriority> &addresses)
+{
+    const Addr addr = pkt->getAddr();
+    const Addr page = pageAddress(addr);
+    AccessMap &map = getMap(page, pkt->isSecure());
+    std::vector<BlockState> &states = map.states;
+
+    const int num_blocks = states.size();
+    const int t = pageOffset(addr) >> lBlkSize;
+    states[t] = Access;
+
+    auto accessed = [&states, num_blocks](int i) {
+        return i >= 0 && i < num_blocks && states[i] == Access;
+    };
+
+    unsigned issued = 0;
+    for (int k = 1; k <= num_blocks / 2 && issued < degree; k++) {
+        // Forward stride
+        if (t + k < num_blocks && states[t + k] == Init &&
+            accessed(t - k) && accessed(t - 2 * k)) {
+            states[t + k] = Prefetch;
+            addresses.push_back(
+                AddrPriority(pageIthBlockAddress(page, t + k), 0));
+            issued++;
+        }
+        // Backward stride
+        if (issued < degree && t - k >= 0 && states[t - k] == Init &&
+            accessed(t + k) && accessed(t + 2 * k)) {
+            states[t - k] = Prefetch;
+            addresses.push_back(
+                AddrPriority(pageIthBlockAddress(page, t - k), 0));
+            issued++;
+        }
+    }
+
+    if (issued)
+        DPRINTF(HWPrefetch, "AMPM: %u candidates for access to %#x\n",
+                issued, addr);
+}
+
+AMPMPrefetcher*
+AMPMPrefetcherParams::create()
+{
+   return new AMPMPrefetcher(this);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes an access map pattern matching prefetcher.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_AMPM_HH__
+#define __MEM_CACHE_PREFETCH_AMPM_HH__
+
+#include <vector>
+
+#include "mem/cache/prefetch/queued.hh"
+#include "params/AMPMPrefetcher.hh"
+
+/**
+ * Access Map Pattern Matching prefetcher (Y. Ishii et al., "Access
+ * Map Pattern Matching for Data Cache Prefetch", ICS 2009).
+ *
+ * The prefetcher keeps a map of the state of every block of the
+ * recently accessed pages. On an access to block t, a stride k is
+ * detected in the forward direction if blocks t-k and t-2k have been
+ * accessed, in which case block t+k becomes a prefetch candidate if
+ * it has neither been accessed nor prefetched yet. Backward strides
+ * are detected the same way. Candidates closest to t are issued
+ * first, up to the prefetch degree.
+ */
+class AMPMPrefetcher : public QueuedPrefetcher
+{
+  protected:
+    /** Maximum number of prefetches issued per access. */
+    const unsigned degree;
+
+    /** State of a block in an access map. */
+    enum BlockState : uint8_t
+    {
+        Init,
+        Access,
+        Prefetch
+    };
+
+    /** Access map of a page. */
+    struct AccessMap
+    {
+        AccessMap() : page(0), isSecure(false), valid(false), lastUse(0) {}
+
+        Addr page;
+        bool isSecure;
+        bool valid;
+        /** Access counter value at the last use, for LRU replacement. */
+        uint64_t lastUse;
+        std::vector<BlockState> states;
+    };
+
+    /** Fully associative table of access maps. */
+    std::vector<AccessMap> maps;
+
+    /** Number of accesses to the map table. */
+    uint64_t accessCount;
+
+    /** Find the map of a page, or replace the LRU map with it. */
+    AccessMap &getMap(Addr page, bool is_secure);
+
+  public:
+    AMPMPrefetcher(const AMPMPrefetcherParams *p);
+
+    void calculatePrefetch(const PacketPtr &pkt,
+                           std::vector<AddrPriority> &addresses);
+};
+
+#endif // __MEM_CACHE_PREFETCH_AMPM_HH__
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a generic set-associative table of entries, for use
+ * by prefetchers and predictors.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_ASSOCIATIVE_SET_HH__
+#define __MEM_CACHE_PREFETCH_ASSOCIATIVE_SET_HH__
+
+#include <type_traits>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+
+/**
+ * An entry of an AssociativeSet, identified by its full key and
+ * security state.
+ */
+class TaggedEntry : public ReplaceableEntry
+{
+  public:
+    TaggedEntry() : tag(0), isSecure(false), valid(false) {}
+
+    /** Key the entry was inserted with. */
+    Addr tag;
+
+    /** Whether the entry belongs to the secure address space. */
+    bool isSecure;
+
+    /** Whether the entry holds valid information. */
+    bool valid;
+};
+
+/**
+ * A set-associative table of Entry objects, which must derive from
+ * TaggedEntry. All entries are stored contiguously, with the ways of
+ * a set next to each other, so a lookup touches a single stretch of
+ * host memory. A key is mapped to a set by shifting out its low bits
+ * and folding the upper bits onto the set index, and victims are
+ * chosen by a replacement policy.
+ */
+template <class Entry>
+class AssociativeSet
+{
+    static_assert(std::is_base_of<TaggedEntry, Entry>::value,
+                  "Entry must derive from TaggedEntry");
+
+  public:
+    typedef typename std::vector<Entry>::iterator iterator;
+    typedef typename std::vector<Entry>::const_iterator const_iterator;
+
+    /**
+     * @param assoc Number of ways of each set.
+     * @param num_entries Total number of entries, a power of 2
+     *                    multiple of assoc.
+     * @param rpl Replacement policy used to choose victims.
+     * @param index_shift Low key bits that are ignored when indexing.
+     * @param init_val Value every entry is initialised with.
+     */
+    AssociativeSet(int assoc, int num_entries, BaseReplacementPolicy *rpl,
+                   unsigned index_shift, const Entry &init_val = Entry());
+
+    /**
+     * Find a valid entry.
+     * @param key Key of the entry.
+     * @param is_secure Security state of the entry.
+     * @return The entry, or nullptr if it is not in the table.
+     */
+    Entry *findEntry(Addr key, bool is_secure) const;
+
+    /** Update the replacement state on an access to an entry. */
+    void accessEntry(Entry *entry);
+
+    /**
+     * Choose the entry of the set of key that should be replaced.
+     * The returned entry may be valid, and it is up to the caller to
+     * write it back or drop it before calling insertEntry.
+     */
+    Entry *findVictim(Addr key);
+
+    /** All the entries a key may be stored in. */
+    std::vector<Entry *> getPossibleEntries(Addr key) const;
+
+    /**
+     * Insert a key in a victim entry, resetting its replacement
+     * state. The other fields of the entry are left to the caller.
+     */
+    void insertEntry(Addr key, bool is_secure, Entry *entry);
+
+    /** Invalidate an entry, making it a preferred victim. */
+    void invalidate(Entry *entry);
+
+    /** @{ Iterate over all the entries of the table. */
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+    /** @} */
+
+  private:
+    /** Number of ways of each set. */
+    const int associativity;
+
+    /** Number of sets, a power of 2. */
+    const int numSets;
+
+    /** Low key bits that are ignored when indexing. */
+    const unsigned indexShift;
+
+    /** log2(numSets). */
+    const unsigned setBits;
+
+    /** Replacement policy of the table. */
+    BaseReplacementPolicy *replacementPolicy;
+
+    /** The entries, set by set. */
+    std::vector<Entry> entries;
+
+    /** Victim candidates of the last findVictim. */
+    ReplacementCandidates candidates;
+
+    /** Index of the set a key maps to. */
+    int extractSet(Addr key) const;
+};
+
+#endif // __MEM_CACHE_PREFETCH_ASSOCIATIVE_SET_HH__
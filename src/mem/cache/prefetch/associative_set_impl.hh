@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of the AssociativeSet template. Include this file from
+ * the translation units that instantiate the template.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_ASSOCIATIVE_SET_IMPL_HH__
+#define __MEM_CACHE_PREFETCH_ASSOCIATIVE_SET_IMPL_HH__
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "mem/cache/prefetch/associative_set.hh"
+
+template <class Entry>
+AssociativeSet<Entry>::AssociativeSet(int assoc, int num_entries,
+        BaseReplacementPolicy *rpl, unsigned index_shift,
+        const Entry &init_val)
+    : associativity(assoc), numSets(num_entries / assoc),
+      indexShift(index_shift), setBits(floorLog2(num_entries / assoc)),
+      replacementPolicy(rpl), entries(num_entries, init_val),
+      candidates(assoc)
+{
+    fatal_if(num_entries % assoc != 0,
+             "The number of entries of an associative set must be a "
+             "multiple of its associativity\n");
+    fatal_if(!isPowerOf2(numSets),
+             "The number of sets of an associative set must be a power "
+             "of 2\n");
+    fatal_if(!replacementPolicy,
+             "An associative set needs a replacement policy\n");
+
+    for (Entry &entry : entries)
+        entry.replacementData = replacementPolicy->instantiateEntry();
+}
+
+template <class Entry>
+int
+AssociativeSet<Entry>::extractSet(Addr key) const
+{
+    const Addr hash = key >> indexShift;
+    return (hash ^ (hash >> setBits)) & (numSets - 1);
+}
+
+template <class Entry>
+Entry *
+AssociativeSet<Entry>::findEntry(Addr key, bool is_secure) const
+{
+    const int first = extractSet(key) * associativity;
+    for (int way = 0; way < associativity; way++) {
+        const Entry &entry = entries[first + way];
+        if (entry.valid && entry.tag == key && entry.isSecure == is_secure)
+            return const_cast<Entry *>(&entry);
+    }
+    return nullptr;
+}
+
+template <class Entry>
+void
+AssociativeSet<Entry>::accessEntry(Entry *entry)
+{
+    replacementPolicy->touch(entry->replacementData);
+}
+
+template <class Entry>
+Entry *
+AssociativeSet<Entry>::findVictim(Addr key)
+{
+    const int first = extractSet(key) * associativity;
+    for (int way = 0; way < associativity; way++)
+        candidates[way] = &entries[first + way];
+
+    return static_cast<Entry *>(replacementPolicy->getVictim(candidates));
+}
+
+template <class Entry>
+std::vector<Entry *>
+AssociativeSet<Entry>::getPossibleEntries(Addr key) const
+{
+    const int first = extractSet(key) * associativity;
+    std::vector<Entry *> result;
+    result.reserve(associativity);
+    for (int way = 0; way < associativity; way++)
+        result.push_back(const_cast<Entry *>(&entries[first + way]));
+    return result;
+}
+
+template <class Entry>
+void
+AssociativeSet<Entry>::insertEntry(Addr key, bool is_secure, Entry *entry)
+{
+    entry->tag = key;
+    entry->isSecure = is_secure;
+    entry->valid = true;
+    replacementPolicy->reset(entry->replacementData);
+}
+
+template <class Entry>
+void
+AssociativeSet<Entry>::invalidate(Entry *entry)
+{
+    entry->valid = false;
+    replacementPolicy->invalidate(entry->replacementData);
+}
+
+#endif // __MEM_CACHE_PREFETCH_ASSOCIATIVE_SET_IMPL_HH__
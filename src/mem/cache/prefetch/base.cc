@@ -82,6 +82,38 @@ BasePrefetcher::regStats()
         .desc("number of hwpf issued")
         ;
 
+    pfUseful
+        .name(name() + ".pfUseful")
+        .desc("number of demand accesses that hit a prefetched block")
+        ;
+
+    pfLate
+        .name(name() + ".pfLate")
+        .desc("number of demand accesses that hit an in-flight prefetch")
+        ;
+
+    pfDemandMisses
+        .name(name() + ".pfDemandMisses")
+        .desc("number of demand misses not covered by a prefetch")
+        ;
+
+    pfAccuracy
+        .name(name() + ".accuracy")
+        .desc("fraction of issued prefetches that were used")
+        ;
+    pfAccuracy = (pfUseful + pfLate) / pfIssued;
+
+    pfCoverage
+        .name(name() + ".coverage")
+        .desc("fraction of demand misses covered by prefetches")
+        ;
+    pfCoverage = (pfUseful + pfLate) / (pfUseful + pfLate + pfDemandMisses);
+
+    pfLateness
+        .name(name() + ".lateness")
+        .desc("fraction of used prefetches that were late")
+        ;
+    pfLateness = pfLate / (pfUseful + pfLate);
 }
 
 bool
@@ -119,6 +119,27 @@ class BasePrefetcher : public ClockedObject
 
     Stats::Scalar pfIssued;
 
+    /** Demand accesses that hit a block brought in by a prefetch. */
+    Stats::Scalar pfUseful;
+
+    /**
+     * Demand accesses that found the prefetch of their block still
+     * in flight.
+     */
+    Stats::Scalar pfLate;
+
+    /** Demand misses that were not covered by any prefetch. */
+    Stats::Scalar pfDemandMisses;
+
+    /** Fraction of the issued prefetches that were used. */
+    Stats::Formula pfAccuracy;
+
+    /** Fraction of the demand misses removed by prefetching. */
+    Stats::Formula pfCoverage;
+
+    /** Fraction of the used prefetches that arrived too late. */
+    Stats::Formula pfLateness;
+
   public:
 
     BasePrefetcher(const BasePrefetcherParams *p);
@@ -138,6 +159,16 @@ class BasePrefetcher : public ClockedObject
 
     virtual Tick nextPrefetchReadyTime() const = 0;
 
+    /**
+     * @{
+     * Notify the prefetcher of the outcome of a demand access. These
+     * only update the usefulness statistics of the prefetcher.
+     */
+    void prefetchUseful() { pfUseful++; }
+    void prefetchLate() { pfLate++; }
+    void demandMiss() { pfDemandMisses++; }
+    /** @} */
+
     virtual void regStats();
 };
 #endif //__MEM_CACHE_PREFETCH_BASE_HH__
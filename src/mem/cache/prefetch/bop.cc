@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Best-offset prefetcher definitions.
+ */
+
+#include "mem/cache/prefetch/bop.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+
+BOPPrefetcher::BOPPrefetcher(const BOPPrefetcherParams *p)
+    : QueuedPrefetcher(p), scoreMax(p->score_max), roundMax(p->round_max),
+      badScore(p->bad_score), degree(p->degree), testIndex(0), round(0),
+      bestOffset(1), issuePrefetches(true), rrTable(p->rr_size)
+{
+    fatal_if(!isPowerOf2(p->rr_size),
+             "%s: the recent requests table size must be a power of 2\n",
+             name());
+
+    // Offsets whose only prime factors are 2, 3 and 5
+    for (int off = 1; off <= (int)p->max_offset; off++) {
+        int n = off;
+        for (int f : { 2, 3, 5 }) {
+            while (n % f == 0)
+                n /= f;
+        }
+        if (n == 1) {
+            offsets.push_back(off);
+            if (p->negative_offsets)
+                offsets.push_back(-off);
+        }
+    }
+    fatal_if(offsets.empty(), "%s: no offsets to learn from\n", name());
+    scores.resize(offsets.size(), 0);
+}
+
+unsigned
+BOPPrefetcher::rrIndex(Addr blk_index) const
+{
+    const unsigned bits = floorLog2(rrTable.size());
+    return (blk_index ^ (blk_index >> bits)) & (rrTable.size() - 1);
+}
+
+bool
+BOPPrefetcher::rrHit(Addr blk_index, bool is_secure) const
+{
+    const RREntry &entry = rrTable[rrIndex(blk_index)];
+    return entry.valid && entry.blkIndex == blk_index &&
+        entry.isSecure == is_secure;
+}
+
+void
+BOPPrefetcher::rrInsert(Addr blk_index, bool is_secure)
+{
+    RREntry &entry = rrTable[rrIndex(blk_index)];
+    entry.blkIndex = blk_index;
+    entry.isSecure = is_secure;
+    entry.valid = true;
+}
+
+void
+BOPPrefetcher::learn(Addr blk_index, bool is_secure)
+{
+    const int off = offsets[testIndex];
+    if (rrHit(blk_index - off, is_secure) && ++scores[testIndex] >= scoreMax) {
+        endPhase();
+        return;
+    }
+
+    if (++testIndex == offsets.size()) {
+        testIndex = 0;
+        if (++round == roundMax)
+            endPhase();
+    }
+}
+
+void
+BOPPrefetcher::endPhase()
+{
+    auto best = std::max_element(scores.begin(), scores.end());
+    bestOffset = offsets[best - scores.begin()];
+    issuePrefetches = *best > badScore;
+
+    DPRINTF(HWPrefetch, "BOP: best offset %d (score %u)%s\n", bestOffset,
+            *best, issuePrefetches ? "" : ", prefetching disabled");
+
+    std::fill(scores.begin(), scores.end(), 0);
+    testIndex = 0;
+    round = 0;
+}
+
+void
+BOPPrefetcher::calculatePrefetch(const PacketPtr &pkt,
+        std::vector<AddrPriority> &addresses)
+{
+    const Addr blk_addr = blockAddress(pkt->getAddr());
+    const Addr blk_index = blockIndex(blk_addr);
+    const bool is_secure = pkt->isSecure();
+
+    learn(blk_index, is_secure);
+    rrInsert(blk_index, is_secure);
+
+    if (!issuePrefetches)
+        return;
+
+    for (unsigned d = 1; d <= degree; d++) {
+        Addr new_addr = blk_addr + (int64_t)d * bestOffset * blkSize;
+        if (!samePage(blk_addr, new_addr)) {
+            // Count number of unissued prefetches due to page crossing
+            pfSpanPage += degree - d + 1;
+            return;
+        }
+        addresses.push_back(AddrPriority(new_addr, 0));
+    }
+}
+
+BOPPrefetcher*
+BOPPrefetcherParams::create()
+{
+   return new BOPPrefetcher(this);
+}
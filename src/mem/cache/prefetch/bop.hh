@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a best-offset prefetcher.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_BOP_HH__
+#define __MEM_CACHE_PREFETCH_BOP_HH__
+
+#include <vector>
+
+#include "mem/cache/prefetch/queued.hh"
+#include "params/BOPPrefetcher.hh"
+
+/**
+ * Best-Offset prefetcher (P. Michaud, "Best-Offset Hardware
+ * Prefetching", HPCA 2016).
+ *
+ * The prefetcher issues a prefetch for the block at a fixed offset
+ * from every triggering access. The offset is learnt in phases: each
+ * triggering access tests one candidate offset d by looking up the
+ * block d blocks behind it in a table of recent requests. A hit means
+ * that a prefetch with offset d would have been issued for the
+ * current block, and the score of d is incremented. A phase ends when
+ * a score saturates or after a number of rounds over all candidates,
+ * and the best scoring offset is used during the next phase.
+ * Prefetching is turned off if no offset scores above a threshold.
+ *
+ * The original design inserts blocks in the recent requests table
+ * when their prefetch completes. The prefetcher does not observe
+ * fills here, so the base address of each triggering access is
+ * inserted instead.
+ */
+class BOPPrefetcher : public QueuedPrefetcher
+{
+  protected:
+    /** Score at which a learning phase is ended early. */
+    const unsigned scoreMax;
+
+    /** Number of rounds over the offsets in a learning phase. */
+    const unsigned roundMax;
+
+    /** Best score below which prefetching is turned off. */
+    const unsigned badScore;
+
+    /** Number of prefetches issued per triggering access. */
+    const unsigned degree;
+
+    /** Candidate offsets, in blocks. */
+    std::vector<int> offsets;
+
+    /** Score of each candidate offset in the current phase. */
+    std::vector<unsigned> scores;
+
+    /** Candidate offset tested by the next triggering access. */
+    unsigned testIndex;
+
+    /** Number of completed rounds in the current phase. */
+    unsigned round;
+
+    /** Offset used for prefetching, in blocks. */
+    int bestOffset;
+
+    /** Disable prefetching until the next phase ends. */
+    bool issuePrefetches;
+
+    /** Entry of the recent requests table. */
+    struct RREntry
+    {
+        RREntry() : blkIndex(0), isSecure(false), valid(false) {}
+
+        Addr blkIndex;
+        bool isSecure;
+        bool valid;
+    };
+
+    /** Direct-mapped table of recent requests. */
+    std::vector<RREntry> rrTable;
+
+    unsigned rrIndex(Addr blk_index) const;
+    bool rrHit(Addr blk_index, bool is_secure) const;
+    void rrInsert(Addr blk_index, bool is_secure);
+
+    /** Test the next candidate offset against a triggering access. */
+    void learn(Addr blk_index, bool is_secure);
+
+    /** End the current learning phase and select the best offset. */
+    void endPhase();
+
+  public:
+    BOPPrefetcher(const BOPPrefetcherParams *p);
+
+    void calculatePrefetch(const PacketPtr &pkt,
+                           std::vector<AddrPriority> &addresses);
+};
+
+#endif // __MEM_CACHE_PREFETCH_BOP_HH__
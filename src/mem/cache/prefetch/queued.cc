@@ -39,13 +39,16 @@
 
 #include "mem/cache/prefetch/queued.hh"
 
+#include <iterator>
+
 #include "debug/HWPrefetch.hh"
 #include "mem/cache/base.hh"
 
 QueuedPrefetcher::QueuedPrefetcher(const QueuedPrefetcherParams *p)
-    : BasePrefetcher(p), queueSize(p->queue_size), latency(p->latency),
-      queueSquash(p->queue_squash), queueFilter(p->queue_filter),
-      cacheSnoop(p->cache_snoop), tagPrefetch(p->tag_prefetch)
+    : BasePrefetcher(p), pfqOrder(0), queueSize(p->queue_size),
+      latency(p->latency), queueSquash(p->queue_squash),
+      queueFilter(p->queue_filter), cacheSnoop(p->cache_snoop),
+      tagPrefetch(p->tag_prefetch)
 {
 
 }
@@ -53,7 +56,7 @@ QueuedPrefetcher::QueuedPrefetcher(const QueuedPrefetcherParams *p)
 QueuedPrefetcher::~QueuedPrefetcher()
 {
     // Delete the queued prefetch packets
-    for (DeferredPacket &p : pfq) {
+    for (const DeferredPacket &p : pfq) {
         delete p.pkt->req;
         delete p.pkt;
     }
@@ -69,16 +72,12 @@ QueuedPrefetcher::notify(const PacketPtr &pkt)
 
         // Squash queued prefetches if demand miss to same line
         if (queueSquash) {
-            auto itr = pfq.begin();
-            while (itr != pfq.end()) {
-                if (itr->pkt->getAddr() == blk_addr &&
-                    itr->pkt->isSecure() == is_secure) {
-                    delete itr->pkt->req;
-                    delete itr->pkt;
-                    itr = pfq.erase(itr);
-                } else {
-                    ++itr;
-                }
+            iterator itr;
+            while ((itr = inPrefetch(blk_addr, is_secure)) != pfq.end()) {
+                PacketPtr pf_pkt = itr->pkt;
+                dequeue(itr);
+                delete pf_pkt->req;
+                delete pf_pkt;
             }
         }
 
@@ -108,7 +107,7 @@ QueuedPrefetcher::notify(const PacketPtr &pkt)
         }
     }
 
-    return pfq.empty() ? MaxTick : pfq.front().tick;
+    return pfq.empty() ? MaxTick : pfq.begin()->tick;
 }
 
 PacketPtr
@@ -122,7 +121,7 @@ QueuedPrefetcher::getPacket()
     }
 
     PacketPtr pkt = pfq.begin()->pkt;
-    pfq.pop_front();
+    dequeue(pfq.begin());
 
     pfIssued++;
     assert(pkt != nullptr);
@@ -130,26 +129,35 @@ QueuedPrefetcher::getPacket()
     return pkt;
 }
 
-std::list<QueuedPrefetcher::DeferredPacket>::const_iterator
+QueuedPrefetcher::iterator
 QueuedPrefetcher::inPrefetch(Addr address, bool is_secure) const
 {
-    for (const_iterator dp = pfq.begin(); dp != pfq.end(); dp++) {
-        if ((*dp).pkt->getAddr() == address &&
-            (*dp).pkt->isSecure() == is_secure) return dp;
-    }
+    auto it = pfqIndex.find(indexKey(address, is_secure));
+    return it == pfqIndex.end() ? pfq.end() : it->second;
+}
 
-    return pfq.end();
+void
+QueuedPrefetcher::enqueue(const DeferredPacket &dp)
+{
+    auto res = pfq.insert(dp);
+    assert(res.second);
+    pfqIndex.emplace(indexKey(dp.pkt->getAddr(), dp.pkt->isSecure()),
+                     res.first);
 }
 
-QueuedPrefetcher::iterator
-QueuedPrefetcher::inPrefetch(Addr address, bool is_secure)
+void
+QueuedPrefetcher::dequeue(iterator it)
 {
-    for (iterator dp = pfq.begin(); dp != pfq.end(); dp++) {
-        if (dp->pkt->getAddr() == address &&
-            dp->pkt->isSecure() == is_secure) return dp;
+    // Without queue filtering a block may be queued more than once
+    auto range = pfqIndex.equal_range(
+        indexKey(it->pkt->getAddr(), it->pkt->isSecure()));
+    for (auto idx = range.first; idx != range.second; ++idx) {
+        if (idx->second == it) {
+            pfqIndex.erase(idx);
+            break;
+        }
     }
-
-    return pfq.end();
+    pfq.erase(it);
 }
 
 void
@@ -188,17 +196,10 @@ QueuedPrefetcher::insert(AddrPriority &pf_info, bool is_secure)
             pfBufferHit++;
             if (it->priority < pf_info.second) {
                 /* Update priority value and position in the queue */
-                it->priority = pf_info.second;
-                iterator prev = it;
-                bool cont = true;
-                while (cont && prev != pfq.begin()) {
-                    prev--;
-                    /* If the packet has higher priority, swap */
-                    if (*it > *prev) {
-                        std::swap(*it, *prev);
-                        it = prev;
-                    }
-                }
+                DeferredPacket dp(it->tick, it->pkt, pf_info.second,
+                                  it->order);
+                dequeue(it);
+                enqueue(dp);
                 DPRINTF(HWPrefetch, "Prefetch addr already in "
                     "prefetch queue, priority updated\n");
             } else {
@@ -231,28 +232,16 @@ QueuedPrefetcher::insert(AddrPriority &pf_info, bool is_secure)
     /* Verify prefetch buffer space for request */
     if (pfq.size() == queueSize) {
         pfRemovedFull++;
-        /* Lowest priority packet */
-        iterator it = pfq.end();
-        panic_if (it == pfq.begin(), "Prefetch queue is both full and empty!");
-        --it;
-        /* Look for oldest in that level of priority */
-        panic_if (it == pfq.begin(), "Prefetch queue is full with 1 element!");
-        iterator prev = it;
-        bool cont = true;
-        /* While not at the head of the queue */
-        while (cont && prev != pfq.begin()) {
-            prev--;
-            /* While at the same level of priority */
-            cont = (*prev).priority == (*it).priority;
-            if (cont)
-                /* update pointer */
-                it = prev;
-        }
+        panic_if (pfq.empty(), "Prefetch queue is both full and empty!");
+        /* Oldest packet of the lowest priority */
+        iterator it = pfq.lower_bound(
+            DeferredPacket(0, nullptr, std::prev(pfq.end())->priority, 0));
+        PacketPtr victim = it->pkt;
         DPRINTF(HWPrefetch, "Prefetch queue full, removing lowest priority "
-                            "oldest packet, addr: %#x", it->pkt->getAddr());
-        delete it->pkt->req;
-        delete it->pkt;
-        pfq.erase(it);
+                            "oldest packet, addr: %#x", victim->getAddr());
+        dequeue(it);
+        delete victim->req;
+        delete victim;
     }
 
     Tick pf_time = curTick() + clockPeriod() * latency;
@@ -260,20 +249,8 @@ QueuedPrefetcher::insert(AddrPriority &pf_info, bool is_secure)
             "addr:%#x priority: %3d tick:%lld.\n",
             pf_info.first, pf_info.second, pf_time);
 
-    /* Create the packet and find the spot to insert it */
-    DeferredPacket dpp(pf_time, pf_pkt, pf_info.second);
-    if (pfq.size() == 0) {
-        pfq.emplace_back(dpp);
-    } else {
-        iterator it = pfq.end();
-        while (it != pfq.begin() && dpp > *it)
-            --it;
-        /* If we reach the head, we have to see if the new element is new head
-         * or not */
-        if (it == pfq.begin() && dpp <= *it)
-            it++;
-        pfq.insert(it, dpp);
-    }
+    /* Queue the packet behind all packets of the same priority */
+    enqueue(DeferredPacket(pf_time, pf_pkt, pf_info.second, pfqOrder++));
 
     return pf_pkt;
 }
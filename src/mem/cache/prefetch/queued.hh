@@ -40,7 +40,8 @@
 #ifndef __MEM_CACHE_PREFETCH_QUEUED_HH__
 #define __MEM_CACHE_PREFETCH_QUEUED_HH__
 
-#include <list>
+#include <set>
+#include <unordered_map>
 
 #include "mem/cache/prefetch/base.hh"
 #include "params/QueuedPrefetcher.hh"
@@ -52,24 +53,29 @@ class QueuedPrefetcher : public BasePrefetcher
         Tick tick;
         PacketPtr pkt;
         int32_t priority;
-        DeferredPacket(Tick t, PacketPtr p, int32_t pr) : tick(t), pkt(p),
-                                                        priority(pr)  {}
-        bool operator>(const DeferredPacket& that) const
-        {
-            return priority > that.priority;
-        }
+        /** Insertion order, to issue packets of equal priority FIFO. */
+        uint64_t order;
+        DeferredPacket(Tick t, PacketPtr p, int32_t pr, uint64_t o)
+            : tick(t), pkt(p), priority(pr), order(o) {}
+        /** Orders packets by decreasing priority, then by age. */
         bool operator<(const DeferredPacket& that) const
         {
-            return priority < that.priority;
-        }
-        bool operator<=(const DeferredPacket& that) const
-        {
-            return !(*this > that);
+            return priority > that.priority ||
+                (priority == that.priority && order < that.order);
         }
     };
     using AddrPriority = std::pair<Addr, int32_t>;
 
-    std::list<DeferredPacket> pfq;
+    /** Queued prefetches, in the order they are issued. */
+    std::set<DeferredPacket> pfq;
+
+    using iterator = std::set<DeferredPacket>::iterator;
+
+    /** Queued prefetches, indexed by block address and security. */
+    std::unordered_multimap<Addr, iterator> pfqIndex;
+
+    /** Insertion order of the next queued prefetch. */
+    uint64_t pfqOrder;
 
     // PARAMETERS
 
@@ -91,12 +97,20 @@ class QueuedPrefetcher : public BasePrefetcher
     /** Tag prefetch with PC of generating access? */
     const bool tagPrefetch;
 
-    using const_iterator = std::list<DeferredPacket>::const_iterator;
-    std::list<DeferredPacket>::const_iterator inPrefetch(Addr address,
-            bool is_secure) const;
-    using iterator = std::list<DeferredPacket>::iterator;
-    std::list<DeferredPacket>::iterator inPrefetch(Addr address,
-            bool is_secure);
+    /** Key of a block in the prefetch queue index. */
+    static Addr
+    indexKey(Addr blk_addr, bool is_secure)
+    {
+        return blk_addr | is_secure;
+    }
+
+    iterator inPrefetch(Addr address, bool is_secure) const;
+
+    /** Queue a prefetch packet. */
+    void enqueue(const DeferredPacket &dp);
+
+    /** Remove a prefetch from the queue, leaving its packet alone. */
+    void dequeue(iterator it);
 
     // STATS
     Stats::Scalar pfIdentified;
@@ -119,7 +133,7 @@ class QueuedPrefetcher : public BasePrefetcher
 
     Tick nextPrefetchReadyTime() const
     {
-        return pfq.empty() ? MaxTick : pfq.front().tick;
+        return pfq.empty() ? MaxTick : pfq.begin()->tick;
     }
 
     void regStats();
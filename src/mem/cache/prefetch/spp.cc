@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Signature path prefetcher definitions.
+ */
+
+#include "mem/cache/prefetch/spp.hh"
+
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+
+SPPPrefetcher::SPPPrefetcher(const SPPPrefetcherParams *p)
+    : QueuedPrefetcher(p), signatureBits(p->signature_bits),
+      signatureShift(p->signature_shift),
+      counterMax((1 << p->counter_bits) - 1),
+      prefetchThreshold(p->prefetch_confidence_threshold),
+      lookaheadThreshold(p->lookahead_confidence_threshold),
+      signatureTable(p->signature_table_entries),
+      patternTable(1 << p->signature_bits)
+{
+    fatal_if(!isPowerOf2(p->signature_table_entries),
+             "%s: the signature table size must be a power of 2\n", name());
+    fatal_if(p->pattern_table_deltas == 0,
+             "%s: pattern table entries need at least one delta\n", name());
+
+    for (PatternEntry &entry : patternTable) {
+        entry.counter = 0;
+        entry.deltas.resize(p->pattern_table_deltas);
+    }
+}
+
+unsigned
+SPPPrefetcher::nextSignature(unsigned sig, int delta) const
+{
+    return ((sig << signatureShift) ^ (unsigned)delta) &
+        ((1 << signatureBits) - 1);
+}
+
+void
+SPPPrefetcher::updatePattern(unsigned sig, int delta)
+{
+    PatternEntry &entry = patternTable[sig];
+
+    DeltaEntry *match = nullptr;
+    DeltaEntry *victim = &entry.deltas[0];
+    for (DeltaEntry &d : entry.deltas) {
+        if (d.counter && d.delta == delta) {
+            match = &d;
+            break;
+        }
+        if (d.counter < victim->counter)
+            victim = &d;
+    }
+
+    if (!match) {
+        match = victim;
+        match->delta = delta;
+        match->counter = 0;
+    }
+
+    match->counter++;
+    entry.counter++;
+
+    // Halve all counters on saturation to keep their ratios
+    if (entry.counter > counterMax) {
+        entry.counter /= 2;
+        for (DeltaEntry &d : entry.deltas)
+            d.counter /= 2;
+    }
+}
+
+void
+SPPPrefetcher::calculatePrefetch(const PacketPtr &pkt,
+        std::vector<AddrPriority> &addresses)
+{
+    const Addr addr = pkt->getAddr();
+    const Addr page = pageAddress(addr);
+    const bool is_secure = pkt->isSecure();
+    const int num_blocks = pageBytes >> lBlkSize;
+    const int block = pageOffset(addr) >> lBlkSize;
+
+    SignatureEntry &st = signatureTable[
+        (page / pageBytes) & (signatureTable.size() - 1)];
+
+    if (st.valid && st.page == page && st.isSecure == is_secure) {
+        const int delta = block - st.lastBlock;
+        if (delta == 0)
+            return;
+
+        updatePattern(st.signature, delta);
+        st.signature = nextSignature(st.signature, delta);
+    } else {
+        st.page = page;
+        st.isSecure = is_secure;
+        st.valid = true;
+        st.signature = 0;
+    }
+    st.lastBlock = block;
+
+    // Walk the predicted delta path
+    unsigned sig = st.signature;
+    int base = block;
+    double confidence = 1.0;
+    for (int depth = 0; depth < num_blocks; depth++) {
+        const PatternEntry &entry = patternTable[sig];
+        if (entry.counter == 0)
+            break;
+
+        const DeltaEntry *best = nullptr;
+        for (const DeltaEntry &d : entry.deltas) {
+            if (d.counter == 0)
+                continue;
+
+            const double pf_confidence =
+                confidence * d.counter / entry.counter;
+            const int target = base + d.delta;
+            if (pf_confidence >= prefetchThreshold) {
+                if (target >= 0 && target < num_blocks) {
+                    addresses.push_back(AddrPriority(
+                        pageIthBlockAddress(page, target),
+                        pf_confidence * 100));
+                } else {
+                    pfSpanPage++;
+                }
+            }
+            if (!best || d.counter > best->counter)
+                best = &d;
+        }
+
+        if (!best)
+            break;
+
+        confidence *= (double)best->counter / entry.counter;
+        base += best->delta;
+        if (confidence < lookaheadThreshold || base < 0 ||
+            base >= num_blocks)
+            break;
+
+        sig = nextSignature(sig, best->delta);
+    }
+
+    DPRINTF(HWPrefetch, "SPP: %u candidates for access to %#x\n",
+            addresses.size(), addr);
+}
+
+SPPPrefetcher*
+SPPPrefetcherParams::create()
+{
+   return new SPPPrefetcher(this);
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a signature path prefetcher.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_SPP_HH__
+#define __MEM_CACHE_PREFETCH_SPP_HH__
+
+#include <vector>
+
+#include "mem/cache/prefetch/queued.hh"
+#include "params/SPPPrefetcher.hh"
+
+/**
+ * Signature Path Prefetcher (J. Kim et al., "Path Confidence based
+ * Lookahead Prefetching", MICRO 2016).
+ *
+ * The signature table tracks, for each recently accessed page, the
+ * last accessed block and a signature that compresses the history of
+ * block deltas observed in the page. The pattern table records, for
+ * each signature, the deltas that followed it along with saturating
+ * counters. On an access the prefetcher walks the predicted delta
+ * path: every delta whose path confidence is above the prefetch
+ * threshold is prefetched, and the walk continues along the most
+ * likely delta while the path confidence stays above the lookahead
+ * threshold.
+ */
+class SPPPrefetcher : public QueuedPrefetcher
+{
+  protected:
+    /** Number of bits of a signature. */
+    const unsigned signatureBits;
+
+    /** Bits a signature is shifted by before adding a new delta. */
+    const unsigned signatureShift;
+
+    /** Maximum value of the pattern table counters. */
+    const unsigned counterMax;
+
+    /** Minimum path confidence of a prefetch. */
+    const double prefetchThreshold;
+
+    /** Minimum path confidence to continue the lookahead walk. */
+    const double lookaheadThreshold;
+
+    /** Entry of the signature table. */
+    struct SignatureEntry
+    {
+        SignatureEntry()
+            : page(0), isSecure(false), valid(false), lastBlock(0),
+              signature(0)
+        {}
+
+        Addr page;
+        bool isSecure;
+        bool valid;
+        int lastBlock;
+        unsigned signature;
+    };
+
+    /** A delta that followed a signature. */
+    struct DeltaEntry
+    {
+        DeltaEntry() : delta(0), counter(0) {}
+
+        int delta;
+        unsigned counter;
+    };
+
+    /** Entry of the pattern table. */
+    struct PatternEntry
+    {
+        /** Number of times the signature has been followed by a delta. */
+        unsigned counter;
+        std::vector<DeltaEntry> deltas;
+    };
+
+    /** Direct-mapped signature table, indexed by page. */
+    std::vector<SignatureEntry> signatureTable;
+
+    /** Pattern table, indexed by signature. */
+    std::vector<PatternEntry> patternTable;
+
+    /** Compute the signature that follows sig with delta. */
+    unsigned nextSignature(unsigned sig, int delta) const;
+
+    /** Record that sig was followed by delta. */
+    void updatePattern(unsigned sig, int delta);
+
+  public:
+    SPPPrefetcher(const SPPPrefetcherParams *p);
+
+    void calculatePrefetch(const PacketPtr &pkt,
+                           std::vector<AddrPriority> &addresses);
+};
+
+#endif // __MEM_CACHE_PREFETCH_SPP_HH__
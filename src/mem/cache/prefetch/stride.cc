@@ -48,9 +48,9 @@
 
 #include "mem/cache/prefetch/stride.hh"
 
-#include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/HWPrefetch.hh"
+#include "mem/cache/prefetch/associative_set_impl.hh"
 
 StridePrefetcher::StridePrefetcher(const StridePrefetcherParams *p)
     : QueuedPrefetcher(p),
@@ -62,7 +62,7 @@ StridePrefetcher::StridePrefetcher(const StridePrefetcherParams *p)
       pcTableSets(p->table_sets),
       useMasterId(p->use_master_id),
       degree(p->degree),
-      pcTable(pcTableAssoc, pcTableSets, name())
+      pcTable(pcTableAssoc, pcTableSets, p->table_replacement_policy, name())
 {
     // Don't consult stride prefetcher on instruction accesses
     onInst = false;
@@ -70,32 +70,18 @@ StridePrefetcher::StridePrefetcher(const StridePrefetcherParams *p)
     assert(isPowerOf2(pcTableSets));
 }
 
-StridePrefetcher::StrideEntry**
+StridePrefetcher::PCTableSet &
 StridePrefetcher::PCTable::allocateNewContext(int context)
 {
-    auto res = entries.insert(std::make_pair(context,
-                              new StrideEntry*[pcTableSets]));
-    auto it = res.first;
-    chatty_assert(res.second, "Allocating an already created context\n");
-    assert(it->first == context);
-
-    DPRINTF(HWPrefetch, "Adding context %i with stride entries at %p\n",
-            context, it->second);
-
-    StrideEntry** entry = it->second;
-    for (int s = 0; s < pcTableSets; s++) {
-        entry[s] = new StrideEntry[pcTableAssoc];
-    }
-    return entry;
-}
+    DPRINTF(HWPrefetch, "Adding context %i with stride entries\n", context);
 
-StridePrefetcher::PCTable::~PCTable() {
-    for (auto entry : entries) {
-        for (int s = 0; s < pcTableSets; s++) {
-            delete[] entry.second[s];
-        }
-        delete[] entry.second;
-    }
+    // Instruction addresses are at least 2-byte aligned
+    std::unique_ptr<PCTableSet> table(new PCTableSet(pcTableAssoc,
+        pcTableAssoc * pcTableSets, replacementPolicy, 1));
+    PCTableSet &ref = *table;
+    auto res = entries.emplace(context, std::move(table));
+    chatty_assert(res.second, "Allocating an already created context\n");
+    return ref;
 }
 
 void
@@ -114,10 +100,12 @@ StridePrefetcher::calculatePrefetch(const PacketPtr &pkt,
     MasterID master_id = useMasterId ? pkt->req->masterId() : 0;
 
     // Lookup pc-based information
-    StrideEntry *entry;
+    PCTableSet &table = pcTable[master_id];
+    StrideEntry *entry = table.findEntry(pc, is_secure);
 
-    if (pcTableHit(pc, is_secure, master_id, entry)) {
+    if (entry) {
         // Hit in table
+        table.accessEntry(entry);
         int new_stride = pkt_addr - entry->lastAddr;
         bool stride_match = (new_stride == entry->stride);
 
@@ -168,52 +156,14 @@ StridePrefetcher::calculatePrefetch(const PacketPtr &pkt,
         DPRINTF(HWPrefetch, "Miss: PC %x pkt_addr %x (%s)\n", pc, pkt_addr,
                 is_secure ? "s" : "ns");
 
-        StrideEntry* entry = pcTableVictim(pc, master_id);
-        entry->instAddr = pc;
+        entry = table.findVictim(pc);
+        table.insertEntry(pc, is_secure, entry);
         entry->lastAddr = pkt_addr;
-        entry->isSecure= is_secure;
         entry->stride = 0;
         entry->confidence = startConf;
     }
 }
 
-inline Addr
-StridePrefetcher::pcHash(Addr pc) const
-{
-    Addr hash1 = pc >> 1;
-    Addr hash2 = hash1 >> floorLog2(pcTableSets);
-    return (hash1 ^ hash2) & (Addr)(pcTableSets - 1);
-}
-
-inline StridePrefetcher::StrideEntry*
-StridePrefetcher::pcTableVictim(Addr pc, int master_id)
-{
-    // Rand replacement for now
-    int set = pcHash(pc);
-    int way = random_mt.random<int>(0, pcTableAssoc - 1);
-
-    DPRINTF(HWPrefetch, "Victimizing lookup table[%d][%d].\n", set, way);
-    return &pcTable[master_id][set][way];
-}
-
-inline bool
-StridePrefetcher::pcTableHit(Addr pc, bool is_secure, int master_id,
-                             StrideEntry* &entry)
-{
-    int set = pcHash(pc);
-    StrideEntry* set_entries = pcTable[master_id][set];
-    for (int way = 0; way < pcTableAssoc; way++) {
-        // Search ways for match
-        if (set_entries[way].instAddr == pc &&
-            set_entries[way].isSecure == is_secure) {
-            DPRINTF(HWPrefetch, "Lookup hit table[%d][%d].\n", set, way);
-            entry = &set_entries[way];
-            return true;
-        }
-    }
-    return false;
-}
-
 StridePrefetcher*
 StridePrefetcherParams::create()
 {
@@ -48,8 +48,11 @@
 #ifndef __MEM_CACHE_PREFETCH_STRIDE_HH__
 #define __MEM_CACHE_PREFETCH_STRIDE_HH__
 
+#include <memory>
+#include <string>
 #include <unordered_map>
 
+#include "mem/cache/prefetch/associative_set.hh"
 #include "mem/cache/prefetch/queued.hh"
 #include "params/StridePrefetcher.hh"
 
@@ -68,48 +71,46 @@ class StridePrefetcher : public QueuedPrefetcher
 
     const int degree;
 
-    struct StrideEntry
+    /** Stride history of a PC, tagged with the PC. */
+    struct StrideEntry : public TaggedEntry
     {
-        StrideEntry() : instAddr(0), lastAddr(0), isSecure(false), stride(0),
-                        confidence(0)
+        StrideEntry() : lastAddr(0), stride(0), confidence(0)
         { }
 
-        Addr instAddr;
         Addr lastAddr;
-        bool isSecure;
         int stride;
         int confidence;
     };
 
+    typedef AssociativeSet<StrideEntry> PCTableSet;
+
+    /** Per-context tables of stride entries, indexed by PC. */
     class PCTable
     {
       public:
-        PCTable(int assoc, int sets, const std::string name) :
-            pcTableAssoc(assoc), pcTableSets(sets), _name(name) {}
-        StrideEntry** operator[] (int context) {
+        PCTable(int assoc, int sets, BaseReplacementPolicy *rpl,
+                const std::string name) :
+            pcTableAssoc(assoc), pcTableSets(sets), replacementPolicy(rpl),
+            _name(name) {}
+        PCTableSet &operator[] (int context) {
             auto it = entries.find(context);
             if (it != entries.end())
-                return it->second;
+                return *it->second;
 
             return allocateNewContext(context);
         }
 
-        ~PCTable();
       private:
         const std::string name() {return _name; }
         const int pcTableAssoc;
         const int pcTableSets;
+        BaseReplacementPolicy *replacementPolicy;
         const std::string _name;
-        std::unordered_map<int, StrideEntry**> entries;
+        std::unordered_map<int, std::unique_ptr<PCTableSet>> entries;
 
-        StrideEntry** allocateNewContext(int context);
+        PCTableSet &allocateNewContext(int context);
     };
     PCTable pcTable;
-
-    bool pcTableHit(Addr pc, bool is_secure, int master_id, StrideEntry* &entry);
-    StrideEntry* pcTableVictim(Addr pc, int master_id);
-
-    Addr pcHash(Addr pc) const;
   public:
 
     StridePrefetcher(const StridePrefetcherParams *p);
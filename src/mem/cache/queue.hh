@@ -50,7 +50,9 @@
 #define __MEM_CACHE_QUEUE_HH__
 
 #include <cassert>
+#include <vector>
 
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/Drain.hh"
 #include "mem/cache/queue_entry.hh"
@@ -92,6 +94,56 @@ class Queue : public Drainable
     /** Holds non allocated entries. */
     typename Entry::List freeList;
 
+    /**
+     * Index of the allocated entries by block address. Each bucket
+     * holds a chain of entries, linked through QueueEntry::hashNext,
+     * in allocation order, so that walking a chain finds matches in
+     * the same order as walking the allocatedList. The table has at
+     * least twice as many buckets as there are entries, which keeps
+     * the chains short.
+     */
+    std::vector<QueueEntry *> hashTable;
+
+    /** Amount to shift the hashed address to get the bucket. */
+    const unsigned hashShift;
+
+    /** Get the bucket of the address index for a block address. */
+    unsigned hashIndex(Addr blk_addr) const
+    {
+        return (blk_addr * 0x9e3779b97f4a7c15ULL) >> hashShift;
+    }
+
+    /** First entry in the chain of a block address, if any. */
+    Entry *hashChain(Addr blk_addr) const
+    {
+        return static_cast<Entry *>(hashTable[hashIndex(blk_addr)]);
+    }
+
+    /**
+     * Add a newly allocated entry to the address index. Must be
+     * called after the entry's block address is set.
+     */
+    void addToHashTable(Entry *entry)
+    {
+        QueueEntry **link = &hashTable[hashIndex(entry->blkAddr)];
+        while (*link)
+            link = &(*link)->hashNext;
+        *link = entry;
+        entry->hashNext = nullptr;
+    }
+
+    /** Remove an entry from the address index. */
+    void removeFromHashTable(Entry *entry)
+    {
+        QueueEntry **link = &hashTable[hashIndex(entry->blkAddr)];
+        while (*link != entry) {
+            assert(*link);
+            link = &(*link)->hashNext;
+        }
+        *link = entry->hashNext;
+        entry->hashNext = nullptr;
+    }
+
     typename Entry::Iterator addToReadyList(Entry* entry)
     {
         if (readyList.empty() ||
@@ -124,8 +176,10 @@ class Queue : public Drainable
      */
     Queue(const std::string &_label, int num_entries, int reserve) :
         label(_label), numEntries(num_entries + reserve),
-        numReserve(reserve), entries(numEntries), _numInService(0),
-        allocated(0)
+        numReserve(reserve), entries(numEntries),
+        hashTable(2 << ceilLog2(numEntries), nullptr),
+        hashShift(64 - (ceilLog2(numEntries) + 1)),
+        _numInService(0), allocated(0)
     {
         for (int i = 0; i < numEntries; ++i) {
             freeList.push_back(&entries[i]);
@@ -155,7 +209,8 @@ class Queue : public Drainable
      */
     Entry* findMatch(Addr blk_addr, bool is_secure) const
     {
-        for (const auto& entry : allocatedList) {
+        for (Entry *entry = hashChain(blk_addr); entry;
+             entry = static_cast<Entry *>(entry->hashNext)) {
             // we ignore any entries allocated for uncacheable
             // accesses and simply ignore them when matching, in the
             // cache we never check for matches when adding new
@@ -173,7 +228,8 @@ class Queue : public Drainable
     bool checkFunctional(PacketPtr pkt, Addr blk_addr)
     {
         pkt->pushLabel(label);
-        for (const auto& entry : allocatedList) {
+        for (Entry *entry = hashChain(blk_addr); entry;
+             entry = static_cast<Entry *>(entry->hashNext)) {
             if (entry->blkAddr == blk_addr && entry->checkFunctional(pkt)) {
                 pkt->popLabel();
                 return true;
@@ -191,12 +247,26 @@ class Queue : public Drainable
      */
     Entry* findPending(Addr blk_addr, bool is_secure) const
     {
-        for (const auto& entry : readyList) {
-            if (entry->blkAddr == blk_addr && entry->isSecure == is_secure) {
-                return entry;
+        // entries that are not in service are on the readyList
+        Entry *match = nullptr;
+        for (Entry *entry = hashChain(blk_addr); entry;
+             entry = static_cast<Entry *>(entry->hashNext)) {
+            if (!entry->inService && entry->blkAddr == blk_addr &&
+                entry->isSecure == is_secure) {
+                if (match) {
+                    // more than one candidate, the earliest one
+                    // is the first on the readyList
+                    for (const auto& ready : readyList) {
+                        if (ready->blkAddr == blk_addr &&
+                            ready->isSecure == is_secure) {
+                            return ready;
+                        }
+                    }
+                }
+                match = entry;
             }
         }
-        return nullptr;
+        return match;
     }
 
     /**
@@ -225,6 +295,7 @@ class Queue : public Drainable
     void deallocate(Entry *entry)
     {
         allocatedList.erase(entry->allocIter);
+        removeFromHashTable(entry);
         freeList.push_front(entry);
         allocated--;
         if (entry->inService) {
@@ -74,6 +74,9 @@ class QueueEntry : public Packet::SenderState
     /** True if the entry is uncacheable */
     bool _isUncacheable;
 
+    /** Next entry in the same bucket of the queue's address index. */
+    QueueEntry *hashNext;
+
   public:
 
     /** True if the entry has been sent downstream. */
@@ -91,7 +94,7 @@ class QueueEntry : public Packet::SenderState
     /** True if the entry targets the secure memory space. */
     bool isSecure;
 
-    QueueEntry() : readyTime(0), _isUncacheable(false),
+    QueueEntry() : readyTime(0), _isUncacheable(false), hashNext(nullptr),
                    inService(false), order(0), blkAddr(0), blkSize(0),
                    isSecure(false)
     {}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the base class of the cache replacement policies.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
+
+#include <memory>
+
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "params/BaseReplacementPolicy.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * A replacement policy decides which of a number of candidate entries
+ * is evicted. Policies never reorder the entries; all of their state
+ * lives in the ReplacementData of each entry, which the policy
+ * instantiates, so that updating it on a hit is a constant time
+ * operation.
+ */
+class BaseReplacementPolicy : public SimObject
+{
+  public:
+    /** Convenience typedef. */
+    typedef BaseReplacementPolicyParams Params;
+
+    BaseReplacementPolicy(const Params *p) : SimObject(p) {}
+    virtual ~BaseReplacementPolicy() {}
+
+    /**
+     * Invalidate replacement data, making the entry a preferred
+     * victim.
+     * @param replacement_data Replacement data to be invalidated.
+     */
+    virtual void invalidate(
+        const std::shared_ptr<ReplacementData> &replacement_data) = 0;
+
+    /**
+     * Update replacement data on an access to the entry.
+     * @param replacement_data Replacement data to be touched.
+     */
+    virtual void touch(
+        const std::shared_ptr<ReplacementData> &replacement_data) = 0;
+
+    /**
+     * Reset replacement data when a new entry is inserted.
+     * @param replacement_data Replacement data to be reset.
+     */
+    virtual void reset(
+        const std::shared_ptr<ReplacementData> &replacement_data) = 0;
+
+    /**
+     * Find the victim among the replacement candidates.
+     * @param candidates Replacement candidates, must not be empty.
+     * @return The entry to be evicted.
+     */
+    virtual ReplaceableEntry *getVictim(
+        const ReplacementCandidates &candidates) = 0;
+
+    /**
+     * Instantiate the replacement data of a new entry.
+     * @return The new replacement data.
+     */
+    virtual std::shared_ptr<ReplacementData> instantiateEntry() = 0;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a Bimodal Re-Reference Interval Prediction replacement
+ * policy.
+ */
+
+#include "mem/cache/replacement_policies/brrip_rp.hh"
+
+#include <cassert>
+
+#include "base/logging.hh"
+
+BRRIPRP::BRRIPRP(const Params *p)
+    : BaseReplacementPolicy(p), maxRRPV(p->max_RRPV),
+      hitPriority(p->hit_priority), btp(p->btp), rng(name())
+{
+    fatal_if(p->max_RRPV <= 0, "max_RRPV should be greater than zero.\n");
+}
+
+void
+BRRIPRP::invalidate(const std::shared_ptr<ReplacementData> &replacement_data)
+{
+    static_cast<BRRIPReplData *>(replacement_data.get())->rrpv = maxRRPV;
+}
+
+void
+BRRIPRP::touch(const std::shared_ptr<ReplacementData> &replacement_data)
+{
+    auto data = static_cast<BRRIPReplData *>(replacement_data.get());
+
+    if (hitPriority)
+        data->rrpv = 0;
+    else if (data->rrpv > 0)
+        data->rrpv--;
+}
+
+void
+BRRIPRP::reset(const std::shared_ptr<ReplacementData> &replacement_data)
+{
+    auto data = static_cast<BRRIPReplData *>(replacement_data.get());
+
+    // Insert with a distant re-reference, except for btp percent of the
+    // entries, which get a long one
+    data->rrpv = maxRRPV;
+    if (rng.random<unsigned>(1, 100) <= btp)
+        data->rrpv--;
+}
+
+ReplaceableEntry *
+BRRIPRP::getVictim(const ReplacementCandidates &candidates)
+{
+    assert(!candidates.empty());
+
+    ReplaceableEntry *victim = candidates[0];
+    unsigned victim_rrpv = static_cast<BRRIPReplData *>(
+        victim->replacementData.get())->rrpv;
+    for (const auto &candidate : candidates) {
+        const unsigned rrpv = static_cast<BRRIPReplData *>(
+            candidate->replacementData.get())->rrpv;
+        if (rrpv > victim_rrpv) {
+            victim = candidate;
+            victim_rrpv = rrpv;
+        }
+    }
+
+    // Age all candidates so that the victim reaches the maximum RRPV
+    const unsigned diff = maxRRPV - victim_rrpv;
+    if (diff > 0) {
+        for (const auto &candidate : candidates) {
+            static_cast<BRRIPReplData *>(
+                candidate->replacementData.get())->rrpv += diff;
+        }
+    }
+
+    return victim;
+}
+
+std::shared_ptr<ReplacementData>
+BRRIPRP::instantiateEntry()
+{
+    return std::shared_ptr<ReplacementData>(new BRRIPReplData(maxRRPV));
+}
+
+BRRIPRP*
+BRRIPRPParams::create()
+{
+    return new BRRIPRP(this);
+}
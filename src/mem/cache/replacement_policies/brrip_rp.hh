@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a Bimodal Re-Reference Interval Prediction replacement
+ * policy, as described in "High Performance Cache Replacement Using
+ * Re-Reference Interval Prediction (RRIP)" by Jaleel et al.
+ *
+ * Each entry has a re-reference prediction value (RRPV). The victim is
+ * an entry with the maximum RRPV; if there is none, all candidates are
+ * aged until one of them reaches it. New entries are inserted with a
+ * distant RRPV, and only btp percent of them with a long RRPV. Setting
+ * btp to 100 gives Static RRIP (SRRIP).
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_BRRIP_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_BRRIP_RP_HH__
+
+#include "base/random.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/BRRIPRP.hh"
+
+class BRRIPRP : public BaseReplacementPolicy
+{
+  protected:
+    /** BRRIP-specific implementation of replacement data. */
+    struct BRRIPReplData : ReplacementData
+    {
+        /** Re-reference prediction value. */
+        unsigned rrpv;
+
+        BRRIPReplData(unsigned rrpv) : rrpv(rrpv) {}
+    };
+
+    /** Maximum re-reference prediction value (distant re-reference). */
+    const unsigned maxRRPV;
+
+    /**
+     * Whether a hit predicts a near-immediate re-reference (hit
+     * priority) or only decreases the RRPV by one (frequency priority).
+     */
+    const bool hitPriority;
+
+    /** Bimodal throttle parameter, in percent. */
+    const unsigned btp;
+
+    /** Random numbers for the bimodal insertion */
+    RandomStream rng;
+
+  public:
+    /** Convenience typedef. */
+    typedef BRRIPRPParams Params;
+
+    BRRIPRP(const Params *p);
+    ~BRRIPRP() {}
+
+    /** Predict a distant re-reference for the entry. */
+    void invalidate(const std::shared_ptr<ReplacementData> &replacement_data)
+        override;
+
+    /** Predict a nearer re-reference on a hit. */
+    void touch(const std::shared_ptr<ReplacementData> &replacement_data)
+        override;
+
+    /** Predict a long or distant re-reference for a new entry. */
+    void reset(const std::shared_ptr<ReplacementData> &replacement_data)
+        override;
+
+    /** Find a candidate with a distant RRPV, aging them if needed. */
+    ReplaceableEntry *getVictim(const ReplacementCandidates &candidates)
+        override;
+
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_BRRIP_RP_HH__
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a Least Recently Used replacement policy.
+ */
+
+#include "mem/cache/replacement_policies/lru_rp.hh"
+
+#include <cassert>
+
+LRURP::LRURP(const Params *p)
+    : BaseReplacementPolicy(p), accessCount(0)
+{
+}
+
+void
+LRURP::invalidate(const std::shared_ptr<ReplacementData> &replacement_data)
+{
+    static_cast<LRUReplData *>(replacement_data.get())->lastTouch = 0;
+}
+
+void
+LRURP::touch(const std::shared_ptr<ReplacementData> &replacement_data)
+{
+    static_cast<LRUReplData *>(replacement_data.get())->lastTouch =
+        ++accessCount;
+}
+
+void
+LRURP::reset(const std::shared_ptr<ReplacementData> &replacement_data)
+{
+    touch(replacement_data);
+}
+
+ReplaceableEntry *
+LRURP::getVictim(const ReplacementCandidates &candidates)
+{
+    assert(!candidates.empty());
+
+    ReplaceableEntry *victim = candidates[0];
+    uint64_t oldest = static_cast<LRUReplData *>(
+        victim->replacementData.get())->lastTouch;
+    for (const auto &candidate : candidates) {
+        const uint64_t last_touch = static_cast<LRUReplData *>(
+            candidate->replacementData.get())->lastTouch;
+        if (last_touch < oldest) {
+            victim = candidate;
+            oldest = last_touch;
+        }
+    }
+
+    return victim;
+}
+
+std::shared_ptr<ReplacementData>
+LRURP::instantiateEntry()
+{
+    return std::shared_ptr<ReplacementData>(new LRUReplData());
+}
+
+LRURP*
+LRURPParams::create()
+{
+    return new LRURP(this);
+}
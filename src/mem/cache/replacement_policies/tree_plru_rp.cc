@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a tree pseudo-LRU replacement policy.
+ */
+
+#include "mem/cache/replacement_policies/tree_plru_rp.hh"
+
+#include <cassert>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+/** Index of the parent of a node. */
+static inline unsigned
+parentIndex(unsigned node)
+{
+    return (node - 1) / 2;
+}
+
+/** Whether a node is the right child of its parent. */
+static inline bool
+isRightChild(unsigned node)
+{
+    return (node % 2) == 0;
+}
+
+TreePLRURP::TreePLRURP(const Params *p)
+    : BaseReplacementPolicy(p), numLeaves(p->num_leaves), count(0)
+{
+    fatal_if(!isPowerOf2(numLeaves),
+             "Number of leaves of a tree PLRU must be a power of 2");
+}
+
+void
+TreePLRURP::updatePath(const TreePLRUReplData &data, bool towards) const
+{
+    PLRUTree &tree = *data.tree;
+
+    // leaves are numbered after the inner nodes
+    unsigned node = numLeaves - 1 + data.index;
+    while (node != 0) {
+        const bool right = isRightChild(node);
+        node = parentIndex(node);
+        tree[node] = towards ? right : !right;
+    }
+}
+
+void
+TreePLRURP::invalidate(
+    const std::shared_ptr<ReplacementData> &replacement_data)
+{
+    updatePath(*static_cast<TreePLRUReplData *>(replacement_data.get()),
+               true);
+}
+
+void
+TreePLRURP::touch(const std::shared_ptr<ReplacementData> &replacement_data)
+{
+    updatePath(*static_cast<TreePLRUReplData *>(replacement_data.get()),
+               false);
+}
+
+void
+TreePLRURP::reset(const std::shared_ptr<ReplacementData> &replacement_data)
+{
+    touch(replacement_data);
+}
+
+ReplaceableEntry *
+TreePLRURP::getVictim(const ReplacementCandidates &candidates)
+{
+    assert(!candidates.empty());
+
+    const PLRUTree &tree = *static_cast<TreePLRUReplData *>(
+        candidates[0]->replacementData.get())->tree;
+
+    unsigned node = 0;
+    while (node < numLeaves - 1)
+        node = 2 * node + (tree[node] ? 2 : 1);
+    const unsigned index = node - (numLeaves - 1);
+
+    for (const auto &candidate : candidates) {
+        const auto data = static_cast<TreePLRUReplData *>(
+            candidate->replacementData.get());
+        assert(data->tree.get() == &tree);
+        if (data->index == index)
+            return candidate;
+    }
+
+    // The tree points to an entry that is not a candidate (e.g.,
+    // because the allocatable ways are limited); fall back to the
+    // first candidate.
+    return candidates[0];
+}
+
+std::shared_ptr<ReplacementData>
+TreePLRURP::instantiateEntry()
+{
+    if (count % numLeaves == 0)
+        treeInstance = std::make_shared<PLRUTree>(numLeaves - 1, false);
+
+    return std::shared_ptr<ReplacementData>(
+        new TreePLRUReplData(count++ % numLeaves, treeInstance));
+}
+
+TreePLRURP*
+TreePLRURPParams::create()
+{
+    return new TreePLRURP(this);
+}
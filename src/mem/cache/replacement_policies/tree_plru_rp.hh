@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a tree pseudo-LRU replacement policy.
+ * Each set is managed by a binary tree with one bit per inner node;
+ * a bit points to the half of its subtree that holds the pseudo-LRU
+ * entry. Touching an entry flips the bits on its path to point away
+ * from it, and the victim is found by following the bits from the
+ * root. Both take log2(num_leaves) steps.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_TREE_PLRU_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_TREE_PLRU_RP_HH__
+
+#include <vector>
+
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/TreePLRURP.hh"
+
+class TreePLRURP : public BaseReplacementPolicy
+{
+  protected:
+    /**
+     * The bits of the inner nodes of a tree, stored in breadth-first
+     * order. A set bit points to the right subtree.
+     */
+    typedef std::vector<bool> PLRUTree;
+
+    /**
+     * Tree-PLRU-specific implementation of replacement data. The tree
+     * is shared by all entries of a set.
+     */
+    struct TreePLRUReplData : ReplacementData
+    {
+        /** Index of the entry's leaf in the tree. */
+        const unsigned index;
+
+        /** The tree of the set this entry belongs to. */
+        const std::shared_ptr<PLRUTree> tree;
+
+        TreePLRUReplData(unsigned index, std::shared_ptr<PLRUTree> tree)
+            : index(index), tree(tree) {}
+    };
+
+    /** Number of leaves, i.e., the entries sharing a tree. */
+    const unsigned numLeaves;
+
+    /** Number of entries instantiated so far. */
+    unsigned count;
+
+    /** The tree handed out to the entries currently being instantiated. */
+    std::shared_ptr<PLRUTree> treeInstance;
+
+    /**
+     * Point the bits on the path of an entry towards it or away from
+     * it.
+     * @param data The replacement data of the entry.
+     * @param towards True to make the entry the next victim.
+     */
+    void updatePath(const TreePLRUReplData &data, bool towards) const;
+
+  public:
+    /** Convenience typedef. */
+    typedef TreePLRURPParams Params;
+
+    TreePLRURP(const Params *p);
+    ~TreePLRURP() {}
+
+    /** Make the entry the next victim of its tree. */
+    void invalidate(const std::shared_ptr<ReplacementData> &replacement_data)
+        override;
+
+    /** Point the tree away from the entry. */
+    void touch(const std::shared_ptr<ReplacementData> &replacement_data)
+        override;
+
+    /** Point the tree away from a newly inserted entry. */
+    void reset(const std::shared_ptr<ReplacementData> &replacement_data)
+        override;
+
+    /**
+     * Follow the tree of the candidates from its root. The candidates
+     * must all belong to the same tree.
+     */
+    ReplaceableEntry *getVictim(const ReplacementCandidates &candidates)
+        override;
+
+    /**
+     * Entries are assumed to be instantiated set by set, so every
+     * num_leaves consecutive entries share a tree.
+     */
+    std::shared_ptr<ReplacementData> instantiateEntry() override;
+};
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_TREE_PLRU_RP_HH__
@@ -38,6 +38,8 @@
 from m5.params import *
 from m5.proxy import *
 from ClockedObject import ClockedObject
+from Compressors import *
+from ReplacementPolicies import *
 
 class BaseTags(ClockedObject):
     type = 'BaseTags'
@@ -80,6 +82,30 @@ class RandomRepl(BaseSetAssoc):
     cxx_class = 'RandomRepl'
     cxx_header = "mem/cache/tags/random_repl.hh"
 
+class SetAssoc(BaseSetAssoc):
+    type = 'SetAssoc'
+    cxx_class = 'SetAssoc'
+    cxx_header = "mem/cache/tags/set_assoc.hh"
+    replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy")
+
+class CompressedTags(SetAssoc):
+    type = 'CompressedTags'
+    cxx_class = 'CompressedTags'
+    cxx_header = "mem/cache/tags/compressed_tags.hh"
+    max_compression_ratio = Param.Unsigned(2,
+        "Maximum number of blocks stored in the space of one block")
+    compressor = Param.BaseCacheCompressor(BDI(), "Block compressor")
+
+class SectorTags(BaseTags):
+    type = 'SectorTags'
+    cxx_class = 'SectorTags'
+    cxx_header = "mem/cache/tags/sector_tags.hh"
+    assoc = Param.Int(Parent.assoc, "associativity (sectors per set)")
+    num_blocks_per_sector = Param.Int(4, "Number of blocks per sector")
+    replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy")
+
 class FALRU(BaseTags):
     type = 'FALRU'
     cxx_class = 'FALRU'
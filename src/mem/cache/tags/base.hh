@@ -50,6 +50,7 @@
 #define __MEM_CACHE_TAGS_BASE_HH__
 
 #include <string>
+#include <vector>
 
 #include "base/callback.hh"
 #include "base/statistics.hh"
@@ -265,6 +266,27 @@ class BaseTags : public ClockedObject
 
     virtual CacheBlk* findVictim(Addr addr) = 0;
 
+    /**
+     * Find the block to replace with a new block, along with all the
+     * blocks that have to be evicted to make room for it. This allows
+     * tags that store blocks of different sizes (e.g., compressed) to
+     * evict more than one block. By default it is the same as
+     * findVictim().
+     * @param addr The address of the new block.
+     * @param data The data of the new block, nullptr if not known.
+     * @param evict_blks Valid blocks to be evicted, including the
+     * returned block if it is valid.
+     * @return The block to replace, nullptr if there is none.
+     */
+    virtual CacheBlk* findReplacement(Addr addr, const uint8_t *data,
+                                      std::vector<CacheBlk*> &evict_blks)
+    {
+        CacheBlk *blk = findVictim(addr);
+        if (blk && blk->isValid())
+            evict_blks.push_back(blk);
+        return blk;
+    }
+
     virtual int extractSet(Addr addr) const = 0;
 
     virtual void forEachBlk(CacheBlkVisitor &visitor) = 0;
@@ -47,20 +47,24 @@
 
 #include "mem/cache/tags/base_set_assoc.hh"
 
+#include <algorithm>
 #include <string>
 
+#include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "sim/core.hh"
 
 using namespace std;
 
-BaseSetAssoc::BaseSetAssoc(const Params *p)
-    :BaseTags(p), assoc(p->assoc), allocAssoc(p->assoc),
-     blks(p->size / p->block_size),
-     dataBlks(new uint8_t[p->size]), // Allocate data storage in one big chunk
+BaseSetAssoc::BaseSetAssoc(const Params *p, unsigned blks_per_way)
+    :BaseTags(p), assoc(p->assoc * blks_per_way), allocAssoc(assoc),
+     blks(p->size / p->block_size * blks_per_way),
+     // Allocate data storage in one big chunk
+     dataBlks(new uint8_t[p->size * blks_per_way]),
      numSets(p->size / (p->block_size * p->assoc)),
      sequentialAccess(p->sequential_access),
-     sets(p->size / (p->block_size * p->assoc))
+     sets(p->size / (p->block_size * p->assoc)),
+     wayTags(p->size / p->block_size * blks_per_way)
 {
     // Check parameters
     if (blkSize < 4 || !isPowerOf2(blkSize)) {
@@ -97,6 +101,7 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
             // Setting the tag to j is just to prevent long chains in the
             // hash table; won't matter because the block is invalid
             blk->tag = j;
+            wayTags[blkIndex] = j;
 
             // Set its set and way
             blk->set = i;
@@ -113,8 +118,30 @@ BaseSetAssoc::findBlock(Addr addr, bool is_secure) const
 {
     Addr tag = extractTag(addr);
     unsigned set = extractSet(addr);
-    BlkType *blk = sets[set].findBlk(tag, is_secure);
-    return blk;
+    const Addr *set_tags = &wayTags[set * assoc];
+
+    for (unsigned first = 0; first < assoc; first += 64) {
+        const unsigned ways = std::min(assoc - first, 64U);
+
+        // compare all tags of (up to 64 ways of) the set at once, the
+        // loop has no early exit so that it can be vectorized
+        uint64_t matches = 0;
+        for (unsigned i = 0; i < ways; ++i)
+            matches |= (uint64_t)(set_tags[first + i] == tag) << i;
+
+        // stale tags of invalid blocks may match, and a secure and a
+        // non-secure block may share a tag
+        for (; matches; matches &= matches - 1) {
+            const unsigned way = first + findLsbSet(matches);
+            const BlkType *blk = &blks[set * assoc + way];
+            if (blk->isValid() && blk->isSecure() == is_secure) {
+                assert(blk->tag == tag);
+                return const_cast<BlkType *>(blk);
+            }
+        }
+    }
+
+    return nullptr;
 }
 
 CacheBlk*
@@ -102,6 +102,16 @@ class BaseSetAssoc : public BaseTags
     /** The cache sets. */
     std::vector<SetType> sets;
 
+    /**
+     * The tags of all blocks, indexed by set and way, in one
+     * contiguous array. A set is searched with a single branch-free
+     * pass over its tags, which the compiler vectorizes, and only the
+     * matching ways are checked further. The tag of a valid block is
+     * always up to date, whereas an invalid block may leave a stale
+     * tag behind.
+     */
+    std::vector<Addr> wayTags;
+
     /** The amount to shift the address to get the set. */
     int setShift;
     /** The amount to shift the address to get the tag. */
@@ -109,6 +119,17 @@ class BaseSetAssoc : public BaseTags
     /** Mask out all bits that aren't part of the set index. */
     unsigned setMask;
 
+    /**
+     * Construct a tag store with more than one block per way of data
+     * storage, e.g., to hold compressed blocks. The number of sets is
+     * that of an uncompressed cache of the same size and
+     * associativity, and each set has blks_per_way times as many
+     * blocks.
+     * @param p The parameters of the tag store.
+     * @param blks_per_way Number of blocks per way of each set.
+     */
+    BaseSetAssoc(const BaseSetAssocParams *p, unsigned blks_per_way);
+
 public:
 
     /** Convenience typedef. */
@@ -117,7 +138,7 @@ public:
     /**
      * Construct and initialize this tag store.
      */
-    BaseSetAssoc(const Params *p);
+    BaseSetAssoc(const Params *p) : BaseSetAssoc(p, 1) {}
 
     /**
      * Destructor
@@ -170,6 +191,7 @@ public:
                 accessLatency;
             }
             blk->refCount += 1;
+            blk->tickLastTouched = curTick();
         } else {
             // If a cache miss
             lat = lookupLatency;
@@ -188,6 +210,16 @@ public:
      */
     CacheBlk* findBlock(Addr addr, bool is_secure) const override;
 
+    /**
+     * Update the tags when a block is invalidated.
+     * @param blk The block to invalidate.
+     */
+    void invalidate(CacheBlk *blk) override
+    {
+        BaseTags::invalidate(blk);
+        wayTags[blk->set * assoc + blk->way] = MaxAddr;
+    }
+
     /**
      * Find an invalid block to evict for the address provided.
      * If there are no invalid blocks, this will return the block
@@ -248,6 +280,7 @@ public:
 
          // Set tag for new block.  Caller is responsible for setting status.
          blk->tag = extractTag(addr);
+         wayTags[blk->set * assoc + blk->way] = blk->tag;
 
          // deal with what we are bringing in
          assert(master_id < cache->system->maxMasters());
@@ -255,6 +288,7 @@ public:
          blk->srcMasterId = master_id;
          blk->task_id = task_id;
          blk->tickInserted = curTick();
+         blk->tickLastTouched = curTick();
 
          // We only need to write into one tag and one data block.
          tagAccesses += 1;
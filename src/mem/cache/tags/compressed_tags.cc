@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a set associative tag store holding compressed blocks.
+ */
+
+#include "mem/cache/tags/compressed_tags.hh"
+
+#include <algorithm>
+
+#include "debug/CacheRepl.hh"
+#include "mem/cache/base.hh"
+
+CompressedTags::CompressedTags(const Params *p)
+    : SetAssoc(p, p->max_compression_ratio), compressor(p->compressor),
+      setCapacity(p->assoc * p->block_size * 8),
+      blkBits(numSets * assoc, 0), blkDecompressionLat(numSets * assoc),
+      pendingBlk(nullptr), pendingBits(0)
+{
+    fatal_if(!compressor, "%s: a compressor is required", name());
+}
+
+CacheBlk*
+CompressedTags::accessBlock(Addr addr, bool is_secure, Cycles &lat)
+{
+    CacheBlk *blk = SetAssoc::accessBlock(addr, is_secure, lat);
+
+    if (blk != nullptr)
+        lat += blkDecompressionLat[blkIndex(blk)];
+
+    return blk;
+}
+
+CacheBlk*
+CompressedTags::findReplacement(Addr addr, const uint8_t *data,
+                                std::vector<CacheBlk*> &evict_blks)
+{
+    Cycles compression_lat;
+    pendingBits = compressor->compress(data, compression_lat,
+                                       pendingDecompressionLat);
+
+    // find the space in use, and a free tag if there is one
+    const SetType &set = sets[extractSet(addr)];
+    CacheBlk *victim = nullptr;
+    std::size_t used = 0;
+    candidates.clear();
+    for (int i = 0; i < allocAssoc; ++i) {
+        CacheBlk *blk = set.blks[i];
+        if (blk->isValid()) {
+            used += blkBits[blkIndex(blk)];
+            candidates.push_back(blk);
+        } else if (!victim) {
+            victim = blk;
+        }
+    }
+    for (int i = allocAssoc; i < assoc; ++i) {
+        if (set.blks[i]->isValid())
+            used += blkBits[blkIndex(set.blks[i])];
+    }
+
+    // evict blocks until there is both a tag and enough space
+    while ((!victim || used + pendingBits > setCapacity) &&
+           !candidates.empty()) {
+        CacheBlk *blk = static_cast<CacheBlk*>(
+            replacementPolicy->getVictim(candidates));
+        candidates.erase(std::find(candidates.begin(), candidates.end(),
+                                   blk));
+
+        DPRINTF(CacheRepl, "set %x: selecting blk %x for replacement\n",
+                blk->set, regenerateBlkAddr(blk));
+
+        evict_blks.push_back(blk);
+        used -= blkBits[blkIndex(blk)];
+        if (!victim)
+            victim = blk;
+        else
+            extraEvictions++;
+    }
+
+    pendingBlk = victim;
+    return victim;
+}
+
+void
+CompressedTags::insertBlock(PacketPtr pkt, BlkType *blk)
+{
+    SetAssoc::insertBlock(pkt, blk);
+
+    // blocks are normally inserted right after their victims were
+    // found, otherwise the size of the block is not known
+    const unsigned idx = blkIndex(blk);
+    if (blk == pendingBlk) {
+        blkBits[idx] = pendingBits;
+        blkDecompressionLat[idx] = pendingDecompressionLat;
+    } else {
+        blkBits[idx] = blkSize * 8;
+        blkDecompressionLat[idx] = Cycles(0);
+    }
+    pendingBlk = nullptr;
+}
+
+void
+CompressedTags::regStats()
+{
+    SetAssoc::regStats();
+
+    extraEvictions
+        .name(name() + ".extra_evictions")
+        .desc("Number of blocks evicted to make room for a compressed "
+              "block, in addition to the replaced block")
+        ;
+
+    effectiveCapacity
+        .name(name() + ".effective_capacity")
+        .desc("Average amount of uncompressed data held, in bytes")
+        ;
+
+    effectiveCapacity = tagsInUse * Stats::constant(blkSize);
+
+    capacityRatio
+        .name(name() + ".capacity_ratio")
+        .desc("Effective capacity relative to the size of the cache")
+        ;
+
+    capacityRatio = effectiveCapacity / Stats::constant(size);
+}
+
+CompressedTags*
+CompressedTagsParams::create()
+{
+    return new CompressedTags(this);
+}
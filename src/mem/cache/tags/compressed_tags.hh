@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a set associative tag store holding compressed blocks.
+ */
+
+#ifndef __MEM_CACHE_TAGS_COMPRESSED_TAGS_HH__
+#define __MEM_CACHE_TAGS_COMPRESSED_TAGS_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/cache/compressors/base.hh"
+#include "mem/cache/tags/set_assoc.hh"
+#include "params/CompressedTags.hh"
+
+/**
+ * Set associative tags for a compressed cache, modelled after
+ * decoupled sector caches: every set has max_compression_ratio times
+ * as many tags as ways, and the blocks of a set share the data storage
+ * of its ways. The size of a block is determined by the compressor
+ * when the block is inserted, and more than one block may be evicted
+ * to make room for it. Compressed blocks pay the decompression latency
+ * on each hit.
+ *
+ * The uncompressed data of every block is kept, so that the cache
+ * operates on blocks as usual; only the capacity is modelled. Block
+ * sizes are not updated when a block is written to.
+ */
+class CompressedTags : public SetAssoc
+{
+  protected:
+    /** The compressor determining the size of the blocks. */
+    BaseCacheCompressor *compressor;
+
+    /** Size of the data storage of a set, in bits. */
+    const std::size_t setCapacity;
+
+    /** Stored size of each block, in bits, indexed by set and way. */
+    std::vector<std::size_t> blkBits;
+
+    /** Decompression latency of each block, indexed by set and way. */
+    std::vector<Cycles> blkDecompressionLat;
+
+    /**
+     * @{
+     * The block chosen by the last call to findReplacement(), and the
+     * size and decompression latency of the block replacing it.
+     */
+    const CacheBlk *pendingBlk;
+    std::size_t pendingBits;
+    Cycles pendingDecompressionLat;
+    /** @} */
+
+    /** Number of blocks evicted in addition to the replaced block. */
+    Stats::Scalar extraEvictions;
+
+    /** Average amount of uncompressed data held, in bytes. */
+    Stats::Formula effectiveCapacity;
+
+    /** Ratio of the effective capacity and the size of the cache. */
+    Stats::Formula capacityRatio;
+
+    /** Index of a block in the per block vectors. */
+    unsigned blkIndex(const CacheBlk *blk) const
+    {
+        return blk->set * assoc + blk->way;
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef CompressedTagsParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    CompressedTags(const Params *p);
+
+    /**
+     * Destructor
+     */
+    ~CompressedTags() {}
+
+    CacheBlk* accessBlock(Addr addr, bool is_secure, Cycles &lat) override;
+    CacheBlk* findReplacement(Addr addr, const uint8_t *data,
+                              std::vector<CacheBlk*> &evict_blks) override;
+    void insertBlock(PacketPtr pkt, BlkType *blk) override;
+
+    void regStats() override;
+};
+
+#endif // __MEM_CACHE_TAGS_COMPRESSED_TAGS_HH__
@@ -193,6 +193,7 @@ FALRU::accessBlock(Addr addr, bool is_secure, Cycles &lat, int *inCache)
             accessLatency;
         }
         assert(blk->tag == blkAddr);
+        blk->tickLastTouched = curTick();
         tmp_in_cache = blk->inCache;
         for (unsigned i = 0; i < numCaches; i++) {
             if (1<<i & blk->inCache) {
@@ -268,6 +269,7 @@ FALRU::findVictim(Addr addr)
 void
 FALRU::insertBlock(PacketPtr pkt, CacheBlk *blk)
 {
+    blk->tickLastTouched = curTick();
 }
 
 void
@@ -48,13 +48,11 @@
 
 #include "mem/cache/tags/random_repl.hh"
 
-#include "base/random.hh"
 #include "debug/CacheRepl.hh"
 #include "mem/cache/base.hh"
 
 RandomRepl::RandomRepl(const Params *p)
-    : BaseSetAssoc(p)
-
+    : BaseSetAssoc(p), rng(name())
 {
 }
 
@@ -73,7 +71,7 @@ RandomRepl::findVictim(Addr addr)
     // if all blocks are valid, pick a replacement at random
     if (blk && blk->isValid()) {
         // find a random index within the bounds of the set
-        int idx = random_mt.random<int>(0, assoc - 1);
+        int idx = rng.random<int>(0, assoc - 1);
         blk = sets[set].blks[idx];
         // Enforce allocation limit
         while (blk->way >= allocAssoc) {
@@ -51,6 +51,7 @@
 #ifndef __MEM_CACHE_TAGS_RANDOM_REPL_HH__
 #define __MEM_CACHE_TAGS_RANDOM_REPL_HH__
 
+#include "base/random.hh"
 #include "mem/cache/tags/base_set_assoc.hh"
 #include "params/RandomRepl.hh"
 
@@ -73,6 +74,10 @@ class RandomRepl : public BaseSetAssoc
     CacheBlk* accessBlock(Addr addr, bool is_secure, Cycles &lat);
     CacheBlk* findVictim(Addr addr);
     void insertBlock(PacketPtr pkt, BlkType *blk);
+
+  private:
+    /** Random numbers for picking victims */
+    RandomStream rng;
 };
 
 #endif // __MEM_CACHE_TAGS_RANDOM_REPL_HH__
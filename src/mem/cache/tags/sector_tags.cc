@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a sector set associative tag store.
+ */
+
+#include "mem/cache/tags/sector_tags.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "debug/CacheRepl.hh"
+#include "mem/cache/base.hh"
+#include "sim/core.hh"
+
+SectorTags::SectorTags(const Params *p)
+    : BaseTags(p), assoc(p->assoc), allocAssoc(p->assoc),
+      numBlocksPerSector(p->num_blocks_per_sector),
+      numSets(p->size / (p->block_size * p->assoc *
+                         p->num_blocks_per_sector)),
+      sequentialAccess(p->sequential_access),
+      blks(p->size / p->block_size),
+      dataBlks(new uint8_t[p->size]),
+      sectors(p->size / (p->block_size * p->num_blocks_per_sector)),
+      replacementPolicy(p->replacement_policy)
+{
+    // Check parameters
+    if (blkSize < 4 || !isPowerOf2(blkSize)) {
+        fatal("Block size must be at least 4 and a power of 2");
+    }
+    if (numBlocksPerSector == 0 || !isPowerOf2(numBlocksPerSector)) {
+        fatal("# of blocks per sector must be non-zero and a power of 2");
+    }
+    if (!isPowerOf2(numSets)) {
+        fatal("# of sets must be non-zero and a power of 2");
+    }
+    if (assoc <= 0) {
+        fatal("associativity must be greater than zero");
+    }
+    fatal_if(!replacementPolicy, "%s: a replacement policy is required",
+             name());
+
+    sectorShift = floorLog2(blkSize);
+    sectorBits = floorLog2(numBlocksPerSector);
+    sectorMask = numBlocksPerSector - 1;
+    setShift = sectorShift + sectorBits;
+    setMask = numSets - 1;
+    tagShift = setShift + floorLog2(numSets);
+
+    unsigned blk_index = 0;
+    for (unsigned i = 0; i < numSets; ++i) {
+        for (unsigned j = 0; j < assoc; ++j) {
+            SectorBlk &sector = sectors[i * assoc + j];
+            sector.replacementData = replacementPolicy->instantiateEntry();
+
+            for (unsigned k = 0; k < numBlocksPerSector; ++k) {
+                CacheBlk *blk = &blks[blk_index];
+
+                // Associate a data chunk to the block
+                blk->data = &dataBlks[blkSize * blk_index];
+
+                blk->set = i;
+                blk->way = j * numBlocksPerSector + k;
+                sector.blks.push_back(blk);
+
+                ++blk_index;
+            }
+        }
+    }
+
+    candidates.reserve(assoc);
+}
+
+CacheBlk*
+SectorTags::findBlockBySetAndWay(int set, int way) const
+{
+    return const_cast<CacheBlk*>(
+        &blks[(set * assoc * numBlocksPerSector) + way]);
+}
+
+CacheBlk*
+SectorTags::accessBlock(Addr addr, bool is_secure, Cycles &lat)
+{
+    CacheBlk *blk = findBlock(addr, is_secure);
+
+    // Access all tags in parallel, hence one in each way.  The data side
+    // either accesses all blocks in parallel, or one block sequentially on
+    // a hit.  Sequential access with a miss doesn't access data.
+    tagAccesses += allocAssoc;
+    if (sequentialAccess) {
+        if (blk != nullptr) {
+            dataAccesses += 1;
+        }
+    } else {
+        dataAccesses += allocAssoc;
+    }
+
+    if (blk != nullptr) {
+        // If a cache hit
+        lat = accessLatency;
+        // Check if the block to be accessed is available. If not,
+        // apply the accessLatency on top of block->whenReady.
+        if (blk->whenReady > curTick() &&
+            cache->ticksToCycles(blk->whenReady - curTick()) >
+            accessLatency) {
+            lat = cache->ticksToCycles(blk->whenReady - curTick()) +
+            accessLatency;
+        }
+        blk->refCount += 1;
+        blk->tickLastTouched = curTick();
+
+        replacementPolicy->touch(sectorOf(blk)->replacementData);
+    } else {
+        // If a cache miss
+        lat = lookupLatency;
+    }
+
+    return blk;
+}
+
+CacheBlk*
+SectorTags::findBlock(Addr addr, bool is_secure) const
+{
+    const Addr tag = extractTag(addr);
+    const unsigned offset = extractSectorOffset(addr);
+    const SectorBlk *set_sectors = &sectors[extractSet(addr) * assoc];
+
+    for (unsigned i = 0; i < assoc; ++i) {
+        CacheBlk *blk = set_sectors[i].blks[offset];
+        if (blk->isValid() && blk->tag == tag &&
+            blk->isSecure() == is_secure) {
+            return blk;
+        }
+    }
+
+    return nullptr;
+}
+
+void
+SectorTags::invalidate(CacheBlk *blk)
+{
+    BaseTags::invalidate(blk);
+
+    SectorBlk *sector = sectorOf(blk);
+    assert(sector->numValid > 0);
+    if (--sector->numValid == 0) {
+        // an empty sector should be replaced first
+        replacementPolicy->invalidate(sector->replacementData);
+    }
+}
+
+CacheBlk*
+SectorTags::findVictim(Addr addr)
+{
+    panic("%s: sector tags have to be replaced with findReplacement()",
+          name());
+}
+
+CacheBlk*
+SectorTags::findReplacement(Addr addr, const uint8_t *data,
+                            std::vector<CacheBlk*> &evict_blks)
+{
+    const Addr sector_tag = addr >> tagShift;
+    const unsigned offset = extractSectorOffset(addr);
+    SectorBlk *set_sectors = &sectors[extractSet(addr) * assoc];
+
+    // if the sector is present the block goes into it
+    for (unsigned i = 0; i < assoc; ++i) {
+        SectorBlk &sector = set_sectors[i];
+        if (sector.numValid > 0 && sector.tag == sector_tag) {
+            CacheBlk *blk = sector.blks[offset];
+            // the block may be present in the other security space
+            if (blk->isValid())
+                evict_blks.push_back(blk);
+            return blk;
+        }
+    }
+
+    // otherwise prefer an empty sector, and ask the replacement
+    // policy if there is none
+    SectorBlk *victim = nullptr;
+    candidates.clear();
+    for (unsigned i = 0; i < allocAssoc; ++i) {
+        if (set_sectors[i].numValid == 0) {
+            victim = &set_sectors[i];
+            break;
+        }
+        candidates.push_back(&set_sectors[i]);
+    }
+
+    if (!victim) {
+        victim = static_cast<SectorBlk*>(
+            replacementPolicy->getVictim(candidates));
+
+        DPRINTF(CacheRepl, "set %x: selecting sector %x for replacement\n",
+                extractSet(addr), victim->tag);
+
+        for (const auto &blk : victim->blks) {
+            if (blk->isValid())
+                evict_blks.push_back(blk);
+        }
+    }
+
+    return victim->blks[offset];
+}
+
+void
+SectorTags::insertBlock(PacketPtr pkt, CacheBlk *blk)
+{
+    Addr addr = pkt->getAddr();
+    MasterID master_id = pkt->req->masterId();
+    uint32_t task_id = pkt->req->taskId();
+
+    if (!blk->isTouched) {
+        if (!warmedUp && tagsInUse.value() >= warmupBound) {
+            warmedUp = true;
+            warmupCycle = curTick();
+        }
+    }
+
+    // If we're replacing a block that was previously valid update
+    // stats for it. This can't be done in findBlock() because a
+    // found block might not actually be replaced there if the
+    // coherence protocol says it can't be.
+    if (blk->isValid()) {
+        replacements[0]++;
+        totalRefs += blk->refCount;
+        ++sampledRefs;
+
+        invalidate(blk);
+        blk->invalidate();
+    }
+
+    // Previous block, if existed, has been removed, and now we have
+    // to insert the new one and mark it as touched
+    tagsInUse++;
+    blk->isTouched = true;
+
+    // Set tag for new block.  Caller is responsible for setting status.
+    blk->tag = extractTag(addr);
+
+    // The first block of a sector (re)allocates the sector
+    SectorBlk *sector = sectorOf(blk);
+    if (sector->numValid++ == 0) {
+        sector->tag = addr >> tagShift;
+        replacementPolicy->reset(sector->replacementData);
+    } else {
+        assert(sector->tag == addr >> tagShift);
+        replacementPolicy->touch(sector->replacementData);
+    }
+
+    // deal with what we are bringing in
+    assert(master_id < cache->system->maxMasters());
+    occupancies[master_id]++;
+    blk->srcMasterId = master_id;
+    blk->task_id = task_id;
+    blk->tickInserted = curTick();
+    blk->tickLastTouched = curTick();
+
+    // We only need to write into one tag and one data block.
+    tagAccesses += 1;
+    dataAccesses += 1;
+}
+
+std::string
+SectorTags::print() const
+{
+    std::string cache_state;
+    for (unsigned i = 0; i < numSets * assoc; ++i) {
+        for (unsigned j = 0; j < numBlocksPerSector; ++j) {
+            const CacheBlk *blk = sectors[i].blks[j];
+            if (blk->isValid())
+                cache_state += csprintf("\tset: %d block: %d %s\n",
+                                        blk->set, blk->way, blk->print());
+        }
+    }
+    if (cache_state.empty())
+        cache_state = "no valid tags\n";
+    return cache_state;
+}
+
+void
+SectorTags::cleanupRefs()
+{
+    for (const auto &blk : blks) {
+        if (blk.isValid()) {
+            totalRefs += blk.refCount;
+            ++sampledRefs;
+        }
+    }
+}
+
+void
+SectorTags::computeStats()
+{
+    for (unsigned i = 0; i < ContextSwitchTaskId::NumTaskId; ++i) {
+        occupanciesTaskId[i] = 0;
+        for (unsigned j = 0; j < 5; ++j) {
+            ageTaskId[i][j] = 0;
+        }
+    }
+
+    for (const auto &blk : blks) {
+        if (blk.isValid()) {
+            assert(blk.task_id < ContextSwitchTaskId::NumTaskId);
+            occupanciesTaskId[blk.task_id]++;
+            assert(blk.tickInserted <= curTick());
+            Tick age = curTick() - blk.tickInserted;
+
+            int age_index;
+            if (age / SimClock::Int::us < 10) { // <10us
+                age_index = 0;
+            } else if (age / SimClock::Int::us < 100) { // <100us
+                age_index = 1;
+            } else if (age / SimClock::Int::ms < 1) { // <1ms
+                age_index = 2;
+            } else if (age / SimClock::Int::ms < 10) { // <10ms
+                age_index = 3;
+            } else
+                age_index = 4; // >10ms
+
+            ageTaskId[blk.task_id][age_index]++;
+        }
+    }
+}
+
+SectorTags*
+SectorTagsParams::create()
+{
+    return new SectorTags(this);
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a sector set associative tag store.
+ */
+
+#ifndef __MEM_CACHE_TAGS_SECTOR_TAGS_HH__
+#define __MEM_CACHE_TAGS_SECTOR_TAGS_HH__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mem/cache/blk.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/tags/base.hh"
+#include "mem/packet.hh"
+#include "params/SectorTags.hh"
+
+/**
+ * A sector set associative tag store.
+ *
+ * Contiguous blocks are grouped into sectors that share a single
+ * address tag, and replacement is done at sector granularity. Each
+ * block of a sector keeps its own valid, dirty and coherence state,
+ * and is filled and written back on its own, which allows modelling
+ * large lines (the sector) that are transferred in smaller pieces (the
+ * blocks) without the tag overhead of small lines.
+ *
+ * The tag of each block also holds the block's offset within its
+ * sector, so that a block address can be regenerated from the tag and
+ * set alone.
+ */
+class SectorTags : public BaseTags
+{
+  protected:
+    /** A sector: the blocks sharing an address tag. */
+    class SectorBlk : public ReplaceableEntry
+    {
+      public:
+        /** Tag of the sector, valid if any of its blocks is valid. */
+        Addr tag;
+
+        /** Number of valid blocks in the sector. */
+        unsigned numValid;
+
+        /** The blocks of the sector, ordered by their offset. */
+        std::vector<CacheBlk*> blks;
+
+        SectorBlk() : tag(MaxAddr), numValid(0) {}
+    };
+
+    /** The associativity (number of sectors per set) of the cache. */
+    const unsigned assoc;
+    /** The allocatable associativity of the cache (alloc mask). */
+    unsigned allocAssoc;
+
+    /** Number of blocks per sector. */
+    const unsigned numBlocksPerSector;
+
+    /** The number of sets in the cache. */
+    const unsigned numSets;
+
+    /** Whether tags and data are accessed sequentially. */
+    const bool sequentialAccess;
+
+    /** The cache blocks, indexed by set and way. */
+    std::vector<CacheBlk> blks;
+    /** The data blocks, 1 per cache block. */
+    std::unique_ptr<uint8_t[]> dataBlks;
+
+    /** The sectors, indexed by set and sector way. */
+    std::vector<SectorBlk> sectors;
+
+    /** The replacement policy choosing sectors to evict. */
+    BaseReplacementPolicy *replacementPolicy;
+
+    /** Scratch vector holding the candidates of a victim search. */
+    ReplacementCandidates candidates;
+
+    /** The amount to shift the address to get the sector offset. */
+    int sectorShift;
+    /** The number of bits of the sector offset. */
+    int sectorBits;
+    /** Mask out all bits that aren't part of the sector offset. */
+    unsigned sectorMask;
+    /** The amount to shift the address to get the set. */
+    int setShift;
+    /** The amount to shift the address to get the tag. */
+    int tagShift;
+    /** Mask out all bits that aren't part of the set index. */
+    unsigned setMask;
+
+    /** Get the sector a block belongs to. */
+    SectorBlk *sectorOf(const CacheBlk *blk)
+    {
+        return &sectors[blk->set * assoc + blk->way / numBlocksPerSector];
+    }
+
+    /** Get the offset of the block of an address within its sector. */
+    unsigned extractSectorOffset(Addr addr) const
+    {
+        return (addr >> sectorShift) & sectorMask;
+    }
+
+  public:
+    /** Convenience typedef. */
+    typedef SectorTagsParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    SectorTags(const Params *p);
+
+    /**
+     * Destructor
+     */
+    virtual ~SectorTags() {}
+
+    /**
+     * Find the cache block given set and way. The ways of a set are
+     * numbered by sector, and by block within each sector.
+     * @param set The set of the block.
+     * @param way The way of the block.
+     * @return The cache block.
+     */
+    CacheBlk *findBlockBySetAndWay(int set, int way) const override;
+
+    CacheBlk* accessBlock(Addr addr, bool is_secure, Cycles &lat) override;
+    CacheBlk* findBlock(Addr addr, bool is_secure) const override;
+    void invalidate(CacheBlk *blk) override;
+    void insertBlock(PacketPtr pkt, CacheBlk *blk) override;
+
+    /**
+     * Replacing a sector may evict several blocks, which findVictim()
+     * cannot report, so sector tags only support findReplacement().
+     */
+    CacheBlk* findVictim(Addr addr) override;
+
+    /**
+     * Find the block to place a new block in. If the sector of the
+     * block is present the block goes there, otherwise a sector is
+     * chosen by the replacement policy and all its blocks are evicted.
+     */
+    CacheBlk* findReplacement(Addr addr, const uint8_t *data,
+                              std::vector<CacheBlk*> &evict_blks) override;
+
+    /**
+     * Limit the allocation for the cache ways.
+     * @param ways The maximum number of sector ways available for
+     * replacement.
+     */
+    void setWayAllocationMax(int ways) override
+    {
+        fatal_if(ways < 1, "Allocation limit must be greater than zero");
+        allocAssoc = ways;
+    }
+
+    int getWayAllocationMax() const override
+    {
+        return allocAssoc;
+    }
+
+    /**
+     * Generate the tag from the given address. The tag holds the
+     * sector tag and the offset of the block within the sector.
+     * @param addr The address to get the tag from.
+     * @return The tag of the address.
+     */
+    Addr extractTag(Addr addr) const override
+    {
+        return ((addr >> tagShift) << sectorBits) | extractSectorOffset(addr);
+    }
+
+    int extractSet(Addr addr) const override
+    {
+        return ((addr >> setShift) & setMask);
+    }
+
+    Addr regenerateBlkAddr(const CacheBlk* blk) const override
+    {
+        const Addr sector_tag = blk->tag >> sectorBits;
+        return (sector_tag << tagShift) | ((Addr)blk->set << setShift) |
+            ((blk->tag & sectorMask) << sectorShift);
+    }
+
+    void cleanupRefs() override;
+    std::string print() const override;
+    void computeStats() override;
+
+    void forEachBlk(CacheBlkVisitor &visitor) override
+    {
+        for (auto &blk : blks) {
+            if (!visitor(blk))
+                return;
+        }
+    }
+};
+
+#endif //__MEM_CACHE_TAGS_SECTOR_TAGS_HH__
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a set associative tag store with a pluggable
+ * replacement policy.
+ */
+
+#include "mem/cache/tags/set_assoc.hh"
+
+#include "debug/CacheRepl.hh"
+#include "mem/cache/base.hh"
+
+SetAssoc::SetAssoc(const Params *p, unsigned blks_per_way)
+    : BaseSetAssoc(p, blks_per_way), replacementPolicy(p->replacement_policy)
+{
+    fatal_if(!replacementPolicy, "%s: a replacement policy is required",
+             name());
+
+    // Instantiate the replacement data set by set, which is the order
+    // policies with per-set state (e.g., tree PLRU) expect
+    for (auto &blk : blks)
+        blk.replacementData = replacementPolicy->instantiateEntry();
+
+    candidates.reserve(assoc);
+}
+
+CacheBlk*
+SetAssoc::accessBlock(Addr addr, bool is_secure, Cycles &lat)
+{
+    CacheBlk *blk = BaseSetAssoc::accessBlock(addr, is_secure, lat);
+
+    if (blk != nullptr)
+        replacementPolicy->touch(blk->replacementData);
+
+    return blk;
+}
+
+CacheBlk*
+SetAssoc::findVictim(Addr addr)
+{
+    // prefer to evict an invalid block
+    CacheBlk *blk = BaseSetAssoc::findVictim(addr);
+
+    // if all allocatable blocks are valid, ask the replacement policy
+    if (blk && blk->isValid()) {
+        const SetType &set = sets[extractSet(addr)];
+
+        candidates.clear();
+        for (int i = 0; i < allocAssoc; ++i)
+            candidates.push_back(set.blks[i]);
+
+        blk = static_cast<CacheBlk*>(
+            replacementPolicy->getVictim(candidates));
+        assert(blk->way < allocAssoc);
+
+        DPRINTF(CacheRepl, "set %x: selecting blk %x for replacement\n",
+                blk->set, regenerateBlkAddr(blk));
+    }
+
+    return blk;
+}
+
+void
+SetAssoc::insertBlock(PacketPtr pkt, BlkType *blk)
+{
+    BaseSetAssoc::insertBlock(pkt, blk);
+
+    replacementPolicy->reset(blk->replacementData);
+}
+
+void
+SetAssoc::invalidate(CacheBlk *blk)
+{
+    BaseSetAssoc::invalidate(blk);
+
+    replacementPolicy->invalidate(blk->replacementData);
+}
+
+SetAssoc*
+SetAssocParams::create()
+{
+    return new SetAssoc(this);
+}
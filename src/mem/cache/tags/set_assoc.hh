@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a set associative tag store with a pluggable
+ * replacement policy.
+ */
+
+#ifndef __MEM_CACHE_TAGS_SET_ASSOC_HH__
+#define __MEM_CACHE_TAGS_SET_ASSOC_HH__
+
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/tags/base_set_assoc.hh"
+#include "params/SetAssoc.hh"
+
+/**
+ * Set associative tags that delegate victim selection to a
+ * replacement policy. Unlike the LRU tags, the blocks of a set are
+ * never reordered; touching a block on a hit only updates its
+ * replacement data.
+ */
+class SetAssoc : public BaseSetAssoc
+{
+  protected:
+    /** The replacement policy of the cache. */
+    BaseReplacementPolicy *replacementPolicy;
+
+    /** Scratch vector holding the candidates of a victim search. */
+    ReplacementCandidates candidates;
+
+    /**
+     * Construct a tag store with more than one block per way.
+     * @sa BaseSetAssoc::BaseSetAssoc(const Params *, unsigned)
+     */
+    SetAssoc(const SetAssocParams *p, unsigned blks_per_way);
+
+  public:
+    /** Convenience typedef. */
+    typedef SetAssocParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    SetAssoc(const Params *p) : SetAssoc(p, 1) {}
+
+    /**
+     * Destructor
+     */
+    ~SetAssoc() {}
+
+    CacheBlk* accessBlock(Addr addr, bool is_secure, Cycles &lat) override;
+    CacheBlk* findVictim(Addr addr) override;
+    void insertBlock(PacketPtr pkt, BlkType *blk) override;
+    void invalidate(CacheBlk *blk) override;
+};
+
+#endif // __MEM_CACHE_TAGS_SET_ASSOC_HH__
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache_snapshot.hh"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include "base/logging.hh"
+#include "sim/serialize.hh"
+
+const std::string CacheSnapshot::suffix = ".snapshot.gz";
+
+// A snapshot file is a magic string, a version and the number of
+// lines, followed by the lines as fixed size records in host byte
+// order (like the rest of the checkpoint).
+static const char snapshotMagic[8] = {
+    'g', 'e', 'm', '5', 'c', 's', 'n', 'p' };
+static const uint32_t snapshotVersion = 1;
+static const size_t recordSize = 8 + 4 + 4 + 1 + 1 + 8;
+
+static void
+writeOrDie(gzFile file, const void *data, size_t size,
+           const std::string &name)
+{
+    if (gzwrite(file, data, size) != (int)size)
+        fatal("Write failed on cache snapshot '%s'\n", name);
+}
+
+static void
+readOrDie(gzFile file, void *data, size_t size, const std::string &name)
+{
+    if (gzread(file, data, size) != (int)size)
+        fatal("Unable to read cache snapshot '%s'\n", name);
+}
+
+void
+CacheSnapshot::write(const std::string &obj_name) const
+{
+    const std::string name = CheckpointIn::dir() + obj_name + suffix;
+    gzFile file = gzopen(name.c_str(), "wb");
+    if (file == NULL)
+        fatal("Can't open cache snapshot '%s'\n", name);
+
+    writeOrDie(file, snapshotMagic, sizeof(snapshotMagic), name);
+    writeOrDie(file, &snapshotVersion, sizeof(snapshotVersion), name);
+    const uint64_t count = lines.size();
+    writeOrDie(file, &count, sizeof(count), name);
+
+    std::vector<uint8_t> buf(recordSize * lines.size());
+    uint8_t *p = buf.data();
+    for (const auto &line : lines) {
+        std::memcpy(p, &line.addr, 8);
+        std::memcpy(p + 8, &line.size, 4);
+        std::memcpy(p + 12, &line.core, 4);
+        p[16] = static_cast<uint8_t>(line.kind);
+        p[17] = line.secure;
+        std::memcpy(p + 18, &line.lastTouch, 8);
+        p += recordSize;
+    }
+    if (!buf.empty())
+        writeOrDie(file, buf.data(), buf.size(), name);
+
+    if (gzclose(file) != Z_OK)
+        fatal("Close failed on cache snapshot '%s'\n", name);
+}
+
+void
+CacheSnapshot::read(const std::string &name, std::vector<Line> &lines)
+{
+    gzFile file = gzopen(name.c_str(), "rb");
+    if (file == NULL)
+        fatal("Can't open cache snapshot '%s'\n", name);
+
+    char magic[sizeof(snapshotMagic)];
+    uint32_t version;
+    uint64_t count;
+    readOrDie(file, magic, sizeof(magic), name);
+    fatal_if(std::memcmp(magic, snapshotMagic, sizeof(magic)),
+             "'%s' is not a cache snapshot\n", name);
+    readOrDie(file, &version, sizeof(version), name);
+    fatal_if(version != snapshotVersion,
+             "Unsupported version %d of cache snapshot '%s'\n",
+             version, name);
+    readOrDie(file, &count, sizeof(count), name);
+
+    std::vector<uint8_t> buf(recordSize * count);
+    if (!buf.empty())
+        readOrDie(file, buf.data(), buf.size(), name);
+    gzclose(file);
+
+    const uint8_t *p = buf.data();
+    for (uint64_t i = 0; i < count; ++i, p += recordSize) {
+        Line line;
+        std::memcpy(&line.addr, p, 8);
+        std::memcpy(&line.size, p + 8, 4);
+        std::memcpy(&line.core, p + 12, 4);
+        line.kind = static_cast<Kind>(p[16]);
+        line.secure = p[17];
+        std::memcpy(&line.lastTouch, p + 18, 8);
+        lines.push_back(line);
+    }
+}
+
+const std::vector<CacheSnapshot::Line> &
+CacheSnapshot::load(const std::string &cpt_dir)
+{
+    static std::mutex lock;
+    static std::map<std::string, std::vector<Line>> loaded;
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = loaded.find(cpt_dir);
+    if (it != loaded.end())
+        return it->second;
+
+    std::vector<std::string> files;
+    DIR *dir = opendir(cpt_dir.c_str());
+    fatal_if(!dir, "Can't open checkpoint directory '%s'\n", cpt_dir);
+    while (struct dirent *entry = readdir(dir)) {
+        const std::string file(entry->d_name);
+        if (file.size() > suffix.size() &&
+            file.compare(file.size() - suffix.size(), suffix.size(),
+                         suffix) == 0) {
+            files.push_back(file);
+        }
+    }
+    closedir(dir);
+
+    // Read the files in a fixed order, so that lines touched at the
+    // same tick are installed in the same order on every host.
+    std::sort(files.begin(), files.end());
+    std::vector<Line> &lines = loaded[cpt_dir];
+    for (const auto &file : files)
+        read(cpt_dir + "/" + file, lines);
+
+    std::stable_sort(lines.begin(), lines.end(),
+                     [](const Line &a, const Line &b) {
+                         return a.lastTouch < b.lastTouch;
+                     });
+    return lines;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Cache contents stored in checkpoints independently of the memory
+ * system that recorded them.
+ */
+
+#ifndef __MEM_CACHE_SNAPSHOT_HH__
+#define __MEM_CACHE_SNAPSHOT_HH__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * Snapshot of the lines held by one or more caches. The classic
+ * caches and the Ruby system each write their lines to a snapshot
+ * file in the checkpoint directory. When restoring, a cache reads the
+ * lines of all snapshot files of the checkpoint, keeps the ones that
+ * belong to it (by core and kind of access) and installs them, so a
+ * checkpoint warmed up with one memory system can warm up the caches
+ * of any other.
+ *
+ * Only the addresses are stored. The caches are written back before
+ * a checkpoint is taken, so the data is read from memory when the
+ * lines are installed.
+ */
+class CacheSnapshot
+{
+  public:
+    /** Access that brought a line into the cache. */
+    enum class Kind : uint8_t {
+        Load,
+        Store,
+        IFetch,
+    };
+
+    struct Line
+    {
+        Addr addr;
+        uint32_t size;
+        /** Core that accessed the line, -1 if unknown or shared */
+        int32_t core;
+        Kind kind;
+        bool secure;
+        /** Last access, used to install lines in recency order */
+        Tick lastTouch;
+    };
+
+    std::vector<Line> lines;
+
+    /**
+     * Write the snapshot to a file in the checkpoint being created.
+     *
+     * @param obj_name Name of the object the lines come from.
+     */
+    void write(const std::string &obj_name) const;
+
+    /**
+     * Get the lines of all the snapshots in a checkpoint, least
+     * recently used first. The result is cached, so that every cache
+     * restored from the checkpoint doesn't read the files again.
+     *
+     * @param cpt_dir Checkpoint directory.
+     * @return The lines, empty if the checkpoint has no snapshot.
+     */
+    static const std::vector<Line> &load(const std::string &cpt_dir);
+
+    /** Suffix of the snapshot files in a checkpoint directory. */
+    static const std::string suffix;
+
+  private:
+    /** Read the lines of one snapshot file. */
+    static void read(const std::string &file, std::vector<Line> &lines);
+};
+
+#endif // __MEM_CACHE_SNAPSHOT_HH__
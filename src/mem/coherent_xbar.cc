@@ -99,8 +99,6 @@ CoherentXBar::CoherentXBar(const CoherentXBarParams *p)
                                            csprintf(".respLayer%d", i)));
         snoopRespPorts.push_back(new SnoopRespPort(*bp, *this));
     }
-
-    clearPortCache();
 }
 
 CoherentXBar::~CoherentXBar()
@@ -175,8 +173,11 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     // store the old header delay so we can restore it if needed
     Tick old_header_delay = pkt->headerDelay;
 
-    // a request sees the frontend and forward latency
-    Tick xbar_delay = (frontendLatency + forwardLatency) * clockPeriod();
+    // a request sees the frontend and forward latency, and the
+    // latency of getting to the destination port
+    Tick xbar_delay = (frontendLatency + forwardLatency +
+                       routeLatency(*src_port, *masterPorts[master_port_id])) *
+        clockPeriod();
 
     // set the packet header and payload delay
     calcPacketTiming(pkt, xbar_delay);
@@ -299,6 +300,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     if (snoopFilter && snoop_caches) {
         // Let the snoop filter know about the success of the send operation
         snoopFilter->finishRequest(!success, addr, pkt->isSecure());
+        backInvalidate(true);
     }
 
     // check if we were successful in sending the packet onwards
@@ -463,8 +465,11 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     unsigned int pkt_size = pkt->hasData() ? pkt->getSize() : 0;
     unsigned int pkt_cmd = pkt->cmdToIndex();
 
-    // a response sees the response latency
-    Tick xbar_delay = responseLatency * clockPeriod();
+    // a response sees the response latency, and the latency of
+    // getting to the destination port
+    Tick xbar_delay = (responseLatency +
+                       routeLatency(*src_port, *slavePorts[slave_port_id])) *
+        clockPeriod();
 
     // set the packet header and payload delay
     calcPacketTiming(pkt, xbar_delay);
@@ -562,6 +567,19 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
     // determine the source port based on the id
     SlavePort* src_port = slavePorts[slave_port_id];
 
+    // responses to our own invalidations of lines evicted from the
+    // snoop filter end here
+    auto inv_lookup = outstandingBackInvalidations.find(pkt->req);
+    if (inv_lookup != outstandingBackInvalidations.end()) {
+        DPRINTF(CoherentXBar, "%s: src %s packet %s BACK INVALIDATION\n",
+                __func__, src_port->name(), pkt->print());
+        outstandingBackInvalidations.erase(inv_lookup);
+        writebackEvicted(pkt);
+        delete pkt->req;
+        delete pkt;
+        return true;
+    }
+
     // get the destination
     const auto route_lookup = routeTo.find(pkt->req);
     assert(route_lookup != routeTo.end());
@@ -610,9 +628,12 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
 
     // a snoop response sees the snoop response latency, and if it is
     // forwarded as a normal response, the response latency
+    const Port &dest_port = forwardAsSnoop ?
+        static_cast<const Port&>(*masterPorts[dest_port_id]) :
+        static_cast<const Port&>(*slavePorts[dest_port_id]);
     Tick xbar_delay =
-        (forwardAsSnoop ? snoopResponseLatency : responseLatency) *
-        clockPeriod();
+        ((forwardAsSnoop ? snoopResponseLatency : responseLatency) +
+         routeLatency(*src_port, dest_port)) * clockPeriod();
 
     // set the packet header and payload delay
     calcPacketTiming(pkt, xbar_delay);
@@ -682,9 +703,10 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
 }
 
 
+template <typename Ports>
 void
 CoherentXBar::forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id,
-                           const std::vector<QueuedSlavePort*>& dests)
+                            const Ports& dests)
 {
     DPRINTF(CoherentXBar, "%s for %s\n", __func__, pkt->print());
 
@@ -756,6 +778,7 @@ CoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
             // avoid situations where atomic upward snoops sneak in
             // between and change the filter state
             snoopFilter->finishRequest(false, pkt->getAddr(), pkt->isSecure());
+            backInvalidate(false);
 
             if (pkt->isEviction()) {
                 // for block-evicting packets, i.e. writebacks and
@@ -907,10 +930,11 @@ CoherentXBar::recvAtomicSnoop(PacketPtr pkt, PortID master_port_id)
     return snoop_response_latency;
 }
 
+template <typename Ports>
 std::pair<MemCmd, Tick>
 CoherentXBar::forwardAtomic(PacketPtr pkt, PortID exclude_slave_port_id,
-                           PortID source_master_port_id,
-                           const std::vector<QueuedSlavePort*>& dests)
+                            PortID source_master_port_id,
+                            const Ports& dests)
 {
     // the packet may be changed on snoops, record the original
     // command to enable us to restore it between snoops so that
@@ -978,6 +1002,62 @@ CoherentXBar::forwardAtomic(PacketPtr pkt, PortID exclude_slave_port_id,
     return std::make_pair(snoop_response_cmd, snoop_response_latency);
 }
 
+void
+CoherentXBar::backInvalidate(bool is_timing)
+{
+    for (const auto& e : snoopFilter->takeEvictions()) {
+        Request *req = new Request(e.addr, system->cacheLineSize(), 0,
+                                   Request::wbMasterId);
+        if (e.isSecure)
+            req->setFlags(Request::SECURE);
+        PacketPtr pkt = new Packet(req, MemCmd::ReadExReq);
+        pkt->allocate();
+
+        DPRINTF(CoherentXBar, "%s: %s to %d ports\n", __func__,
+                pkt->print(), e.holders.size());
+
+        bool responded = false;
+        if (is_timing) {
+            forwardTiming(pkt, InvalidPortID, e.holders);
+            pkt->snoopDelay = 0;
+            responded = pkt->cacheResponding();
+        } else {
+            MemCmd orig_cmd = pkt->cmd;
+            for (const auto& p : e.holders) {
+                p->sendAtomicSnoop(pkt);
+                if (pkt->isResponse()) {
+                    writebackEvicted(pkt);
+                    pkt->cmd = orig_cmd;
+                }
+            }
+            snoopFanout.sample(e.holders.size());
+        }
+
+        // in timing mode a responding cache sends a copy of the
+        // packet, so keep the request around until the response
+        if (responded)
+            outstandingBackInvalidations.insert(req);
+        else
+            delete req;
+        delete pkt;
+    }
+}
+
+void
+CoherentXBar::writebackEvicted(PacketPtr pkt)
+{
+    assert(pkt->isResponse() && pkt->hasData());
+
+    Request req(pkt->getAddr(), pkt->getSize(), 0, Request::funcMasterId);
+    if (pkt->isSecure())
+        req.setFlags(Request::SECURE);
+    Packet wb_pkt(&req, MemCmd::WriteReq);
+    wb_pkt.dataStatic(pkt->getPtr<uint8_t>());
+
+    DPRINTF(CoherentXBar, "%s: %s\n", __func__, wb_pkt.print());
+    masterPorts[findPort(pkt->getAddr())]->sendFunctional(&wb_pkt);
+}
+
 void
 CoherentXBar::recvFunctional(PacketPtr pkt, PortID slave_port_id)
 {
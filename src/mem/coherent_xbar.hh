@@ -270,6 +270,12 @@ class CoherentXBar : public BaseXBar
      */
     std::unordered_map<PacketId, PacketPtr> outstandingCMO;
 
+    /**
+     * Store the invalidations of lines evicted from a bounded snoop
+     * filter that a dirty copy is responding to.
+     */
+    std::unordered_set<RequestPtr> outstandingBackInvalidations;
+
     /**
      * Keep a pointer to the system to be allow to querying memory system
      * properties.
@@ -334,10 +340,12 @@ class CoherentXBar : public BaseXBar
      *
      * @param pkt Packet to forward
      * @param exclude_slave_port_id Id of slave port to exclude
-     * @param dests Vector of destination ports for the forwarded pkt
+     * @param dests Destination ports for the forwarded pkt, either a
+     *              vector or a snoop filter selection
      */
+    template <typename Ports>
     void forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id,
-                       const std::vector<QueuedSlavePort*>& dests);
+                       const Ports& dests);
 
     /** Function called by the port when the crossbar is recieving a Atomic
       transaction.*/
@@ -372,15 +380,16 @@ class CoherentXBar : public BaseXBar
      * @param pkt Packet to forward
      * @param exclude_slave_port_id Id of slave port to exclude
      * @param source_master_port_id Id of the master port for snoops from below
-     * @param dests Vector of destination ports for the forwarded pkt
+     * @param dests Destination ports for the forwarded pkt, either a
+     *              vector or a snoop filter selection
      *
      * @return a pair containing the snoop response and snoop latency
      */
+    template <typename Ports>
     std::pair<MemCmd, Tick> forwardAtomic(PacketPtr pkt,
                                           PortID exclude_slave_port_id,
                                           PortID source_master_port_id,
-                                          const std::vector<QueuedSlavePort*>&
-                                          dests);
+                                          const Ports& dests);
 
     /** Function called by the port when the crossbar is recieving a Functional
         transaction.*/
@@ -400,6 +409,24 @@ class CoherentXBar : public BaseXBar
      */
     void forwardFunctional(PacketPtr pkt, PortID exclude_slave_port_id);
 
+    /**
+     * Invalidate the copies of the lines evicted from a bounded snoop
+     * filter. The holders are sent an invalidating read, and the data
+     * of a dirty copy is written to the memory below. The write is
+     * done functionally, and is hence not part of the timing.
+     *
+     * @param is_timing Send timing rather than atomic snoops
+     */
+    void backInvalidate(bool is_timing);
+
+    /**
+     * Write the data of a dirty copy responding to an invalidation of
+     * a line evicted from the snoop filter to the memory below.
+     *
+     * @param pkt The response carrying the data
+     */
+    void writebackEvicted(PacketPtr pkt);
+
     /**
      * Determine if the crossbar should sink the packet, as opposed to
      * forwarding it, or responding.
@@ -429,6 +456,20 @@ class CoherentXBar : public BaseXBar
             (pkt->req->isToPOU() && pointOfUnification);
     }
 
+    /**
+     * Latency of moving a packet between the points where two ports
+     * connect to the crossbar. All ports of a plain crossbar meet in
+     * one point, whereas distributed interconnects (see MeshXBar)
+     * charge for the distance between the two ports.
+     *
+     * @param src Port the packet is received on
+     * @param dst Port the packet is sent out on
+     *
+     * @return Additional cycles spent in the interconnect
+     */
+    virtual Cycles routeLatency(const Port &src, const Port &dst) const
+    { return Cycles(0); }
+
     Stats::Scalar snoops;
     Stats::Scalar snoopTraffic;
     Stats::Distribution snoopFanout;
@@ -44,6 +44,7 @@
 
 #include "mem/comm_monitor.hh"
 
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/CommMonitor.hh"
 #include "sim/stats.hh"
@@ -55,8 +56,14 @@ CommMonitor::CommMonitor(Params* params)
       samplePeriodicEvent([this]{ samplePeriodic(); }, name()),
       samplePeriodTicks(params->sample_period),
       samplePeriod(params->sample_period / SimClock::Float::s),
+      latencySamplePeriod(params->latency_sample_period),
+      untilLatencySample(0),
+      taggedOutstanding(0),
       stats(params)
 {
+    fatal_if(latencySamplePeriod == 0,
+             "%s: latency_sample_period must be at least 1\n", name());
+
     DPRINTF(CommMonitor,
             "Created monitor %s with sample period %d ticks (%f ms)\n",
             name(), samplePeriodTicks, samplePeriod * 1E3);
@@ -184,8 +191,11 @@ CommMonitor::MonitorStats::updateReqStats(
 
 void
 CommMonitor::MonitorStats::updateRespStats(
-    const ProbePoints::PacketInfo& pkt_info, Tick latency, bool is_atomic)
+    const ProbePoints::PacketInfo& pkt_info, Tick latency, bool is_atomic,
+    bool has_latency)
 {
+    const bool sample_latency = has_latency && !disableLatencyHists;
+
     if (pkt_info.cmd.isRead()) {
         // Decrement number of outstanding read requests
         if (!is_atomic && !disableOutstandingHists) {
@@ -193,8 +203,12 @@ CommMonitor::MonitorStats::updateRespStats(
             --outstandingReadReqs;
         }
 
-        if (!disableLatencyHists)
-            readLatencyHist.sample(latency);
+        if (sample_latency) {
+            if (latencyLog2Hists)
+                readLatencyLog2Hist[latency ? floorLog2(latency) : 0]++;
+            else
+                readLatencyHist.sample(latency);
+        }
 
         // Update the bandwidth stats based on responses for reads
         if (!disableBandwidthHists) {
@@ -209,8 +223,12 @@ CommMonitor::MonitorStats::updateRespStats(
             --outstandingWriteReqs;
         }
 
-        if (!disableLatencyHists)
-            writeLatencyHist.sample(latency);
+        if (sample_latency) {
+            if (latencyLog2Hists)
+                writeLatencyLog2Hist[latency ? floorLog2(latency) : 0]++;
+            else
+                writeLatencyHist.sample(latency);
+        }
     }
 }
 
@@ -226,7 +244,7 @@ CommMonitor::recvAtomic(PacketPtr pkt)
 
     stats.updateReqStats(req_pkt_info, true, expects_response);
     if (expects_response)
-        stats.updateRespStats(req_pkt_info, delay, true);
+        stats.updateRespStats(req_pkt_info, delay, true, true);
 
     assert(pkt->isResponse());
     ProbePoints::PacketInfo resp_pkt_info(pkt);
@@ -257,18 +275,30 @@ CommMonitor::recvTimingReq(PacketPtr pkt)
     // would see a request which needs a response, but this response
     // would not come back from the memory. Therefore we additionally
     // have to check the cacheResponding flag
-    if (expects_response && !stats.disableLatencyHists) {
-        pkt->pushSenderState(new CommMonitorSenderState(curTick()));
+    bool tagged = false;
+    if (expects_response && !stats.disableLatencyHists &&
+        untilLatencySample == 0) {
+        pkt->pushSenderState(new CommMonitorSenderState(this, curTick()));
+        tagged = true;
     }
 
     // Attempt to send the packet
     bool successful = masterPort.sendTimingReq(pkt);
 
     // If not successful, restore the sender state
-    if (!successful && expects_response && !stats.disableLatencyHists) {
+    if (!successful && tagged) {
         delete pkt->popSenderState();
     }
 
+    if (successful && expects_response && !stats.disableLatencyHists) {
+        if (tagged) {
+            ++taggedOutstanding;
+            untilLatencySample = latencySamplePeriod - 1;
+        } else {
+            --untilLatencySample;
+        }
+    }
+
     if (successful) {
         ppPktReq->notify(pkt_info);
     }
@@ -292,28 +322,38 @@ CommMonitor::recvTimingResp(PacketPtr pkt)
     const ProbePoints::PacketInfo pkt_info(pkt);
 
     Tick latency = 0;
-    CommMonitorSenderState* received_state =
-        dynamic_cast<CommMonitorSenderState*>(pkt->senderState);
+    CommMonitorSenderState* received_state = NULL;
+
+    // Only look for our sender state if there are tagged requests in
+    // flight, and make sure it isn't another monitor's
+    if (taggedOutstanding) {
+        received_state =
+            dynamic_cast<CommMonitorSenderState*>(pkt->senderState);
+        if (received_state && received_state->monitor != this)
+            received_state = NULL;
+    }
 
     if (!stats.disableLatencyHists) {
         // Restore initial sender state
-        if (received_state == NULL)
+        if (received_state == NULL && latencySamplePeriod == 1)
             panic("Monitor got a response without monitor sender state\n");
 
         // Restore the sate
-        pkt->senderState = received_state->predecessor;
+        if (received_state)
+            pkt->senderState = received_state->predecessor;
     }
 
     // Attempt to send the packet
     bool successful = slavePort.sendTimingResp(pkt);
 
-    if (!stats.disableLatencyHists) {
+    if (received_state) {
         // If packet successfully send, sample value of latency,
         // afterwards delete sender state, otherwise restore state
         if (successful) {
             latency = curTick() - received_state->transmitTime;
             DPRINTF(CommMonitor, "Latency: %d\n", latency);
             delete received_state;
+            --taggedOutstanding;
         } else {
             // Don't delete anything and let the packet look like we
             // did not touch it
@@ -325,7 +365,8 @@ CommMonitor::recvTimingResp(PacketPtr pkt)
         ppPktResp->notify(pkt_info);
         DPRINTF(CommMonitor, "Received %s response\n", pkt->isRead() ? "read" :
                 pkt->isWrite() ?  "write" : "non read/write");
-        stats.updateRespStats(pkt_info, latency, false);
+        stats.updateRespStats(pkt_info, latency, false,
+                              received_state != NULL);
     }
     return successful;
 }
@@ -442,13 +483,34 @@ CommMonitor::regStats()
         .init(params()->latency_bins)
         .name(name() + ".readLatencyHist")
         .desc("Read request-response latency")
-        .flags(stats.disableLatencyHists ? nozero : pdf);
+        .flags(stats.disableLatencyHists || stats.latencyLog2Hists ?
+               nozero : pdf);
 
     stats.writeLatencyHist
         .init(params()->latency_bins)
         .name(name() + ".writeLatencyHist")
         .desc("Write request-response latency")
-        .flags(stats.disableLatencyHists ? nozero : pdf);
+        .flags(stats.disableLatencyHists || stats.latencyLog2Hists ?
+               nozero : pdf);
+
+    stats.readLatencyLog2Hist
+        .init(64)
+        .name(name() + ".readLatencyLog2Hist")
+        .desc("Read request-response latency, in log2 buckets of ticks")
+        .flags(stats.disableLatencyHists || !stats.latencyLog2Hists ?
+               nozero : pdf);
+
+    stats.writeLatencyLog2Hist
+        .init(64)
+        .name(name() + ".writeLatencyLog2Hist")
+        .desc("Write request-response latency, in log2 buckets of ticks")
+        .flags(stats.disableLatencyHists || !stats.latencyLog2Hists ?
+               nozero : pdf);
+
+    for (int i = 0; i < 64; i++) {
+        stats.readLatencyLog2Hist.subname(i, csprintf("2^%d", i));
+        stats.writeLatencyLog2Hist.subname(i, csprintf("2^%d", i));
+    }
 
     stats.ittReadRead
         .init(1, params()->itt_max_bin, params()->itt_max_bin /
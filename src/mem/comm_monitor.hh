@@ -60,6 +60,11 @@
  * (read-read, write-write, read/write-read/write). Furthermore it allows
  * to capture the number of accesses to an address over time ("heat map").
  * All stats can be disabled from Python.
+ *
+ * To reduce the overhead of measuring latencies, only one in every
+ * latency_sample_period timing requests can be tagged with its
+ * transmit time, and latencies can be recorded in fixed log2 buckets.
+ * All the other stats, including bandwidth, still see every packet.
  */
 class CommMonitor : public MemObject
 {
@@ -107,13 +112,17 @@ class CommMonitor : public MemObject
          *
          * @param _transmitTime Time of packet transmission
          */
-        CommMonitorSenderState(Tick _transmitTime)
-            : transmitTime(_transmitTime)
+        CommMonitorSenderState(const CommMonitor *_monitor,
+                               Tick _transmitTime)
+            : monitor(_monitor), transmitTime(_transmitTime)
         { }
 
         /** Destructor */
         ~CommMonitorSenderState() { }
 
+        /** Monitor that tagged the request */
+        const CommMonitor *monitor;
+
         /** Tick when request is transmitted */
         Tick transmitTime;
 
@@ -312,6 +321,17 @@ class CommMonitor : public MemObject
         /** Histogram of write request-to-response latencies */
         Stats::Histogram writeLatencyHist;
 
+        /** Use the log2 latency histograms instead of the ones above */
+        bool latencyLog2Hists;
+
+        /**
+         * Read and write latencies in log2 buckets, where bucket i
+         * counts latencies in [2^i, 2^(i+1)) ticks, and bucket 0 also
+         * counts zero latencies
+         */
+        Stats::Vector readLatencyLog2Hist;
+        Stats::Vector writeLatencyLog2Hist;
+
         /** Disable flag for ITT distributions. */
         bool disableITTDists;
 
@@ -389,6 +409,7 @@ class CommMonitor : public MemObject
             disableBandwidthHists(params->disable_bandwidth_hists),
             readBytes(0), writtenBytes(0),
             disableLatencyHists(params->disable_latency_hists),
+            latencyLog2Hists(params->latency_log2_hists),
             disableITTDists(params->disable_itt_dists),
             timeOfLastRead(0), timeOfLastWrite(0), timeOfLastReq(0),
             disableOutstandingHists(params->disable_outstanding_hists),
@@ -403,7 +424,7 @@ class CommMonitor : public MemObject
         void updateReqStats(const ProbePoints::PacketInfo& pkt, bool is_atomic,
                             bool expects_response);
         void updateRespStats(const ProbePoints::PacketInfo& pkt, Tick latency,
-                             bool is_atomic);
+                             bool is_atomic, bool has_latency);
     };
 
     /** This function is called periodically at the end of each time bin */
@@ -422,8 +443,17 @@ class CommMonitor : public MemObject
     /** Sample period in seconds */
     const double samplePeriod;
 
+    /** Tag one in this many timing requests to measure latency */
+    const unsigned latencySamplePeriod;
+
     /** @} */
 
+    /** Requests to go before the next one is tagged */
+    unsigned untilLatencySample;
+
+    /** Tagged requests still waiting for a response */
+    uint64_t taggedOutstanding;
+
     /** Instantiate stats */
     MonitorStats stats;
 
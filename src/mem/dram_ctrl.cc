@@ -47,6 +47,8 @@
 
 #include "mem/dram_ctrl.hh"
 
+#include <algorithm>
+
 #include "base/bitfield.hh"
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
@@ -61,11 +63,9 @@ using namespace Data;
 DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     AbstractMemory(p),
     port(name() + ".port", *this), isTimingMode(false),
-    retryRdReq(false), retryWrReq(false),
-    busState(READ),
-    busStateNext(READ),
     nextReqEvent([this]{ processNextReqEvent(); }, name()),
     respondEvent([this]{ processRespondEvent(); }, name()),
+    nextSeqNum(0), channelRanges(p->channel_ranges),
     deviceSize(p->device_size),
     deviceBusWidth(p->device_bus_width), burstLength(p->burst_length),
     deviceRowBufferSize(p->device_rowbuffer_size),
@@ -73,19 +73,24 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     burstSize((devicesPerRank * burstLength * deviceBusWidth) / 8),
     rowBufferSize(devicesPerRank * deviceRowBufferSize),
     columnsPerRowBuffer(rowBufferSize / burstSize),
-    columnsPerStripe(range.interleaved() ? range.granularity() / burstSize : 1),
+    columnsPerStripe(!channelRanges.empty() ?
+                     channelRanges.front().granularity() / burstSize :
+                     range.interleaved() ?
+                     range.granularity() / burstSize : 1),
     ranksPerChannel(p->ranks_per_channel),
     bankGroupsPerRank(p->bank_groups_per_rank),
     bankGroupArch(p->bank_groups_per_rank > 0),
+    burstInterleave(p->burst_interleave),
     banksPerRank(p->banks_per_rank), channels(p->channels), rowsPerBank(0),
     readBufferSize(p->read_buffer_size),
     writeBufferSize(p->write_buffer_size),
     writeHighThreshold(writeBufferSize * p->write_high_thresh_perc / 100.0),
     writeLowThreshold(writeBufferSize * p->write_low_thresh_perc / 100.0),
     minWritesPerSwitch(p->min_writes_per_switch),
-    writesThisTime(0), readsThisTime(0),
     tCK(p->tCK), tWTR(p->tWTR), tRTW(p->tRTW), tCS(p->tCS), tBURST(p->tBURST),
-    tCCD_L(p->tCCD_L), tRCD(p->tRCD), tCL(p->tCL), tRP(p->tRP), tRAS(p->tRAS),
+    tCCD_L(p->tCCD_L), tCCD_L_WR(p->tCCD_L_WR), tBURST_MIN(p->tBURST_MIN),
+    tWCK_SYNC(p->tWCK_SYNC), tRCD(p->tRCD), tCL(p->tCL), tRP(p->tRP),
+    tRAS(p->tRAS),
     tWR(p->tWR), tRTP(p->tRTP), tRFC(p->tRFC), tREFI(p->tREFI), tRRD(p->tRRD),
     tRRD_L(p->tRRD_L), tXAW(p->tXAW), tXP(p->tXP), tXS(p->tXS),
     activationLimit(p->activation_limit),
@@ -94,8 +99,7 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     maxAccessesPerRow(p->max_accesses_per_row),
     frontendLatency(p->static_frontend_latency),
     backendLatency(p->static_backend_latency),
-    busBusyUntil(0), prevArrival(0),
-    nextReqTime(0), activeRank(0), timeStampOffset(0),
+    prevArrival(0), timeStampOffset(0),
     lastStatsResetTick(0)
 {
     // sanity check the ranks since we rely on bit slicing for the
@@ -106,9 +110,30 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
     fatal_if(!isPowerOf2(burstSize), "DRAM burst size %d is not allowed, "
              "must be a power of two\n", burstSize);
 
-    for (int i = 0; i < ranksPerChannel; i++) {
-        Rank* rank = new Rank(*this, p, i);
-        ranks.push_back(rank);
+    // when serving several channels, the channel ranges have to
+    // cover our range exactly
+    if (!channelRanges.empty()) {
+        fatal_if(range.interleaved(), "%s serves %d channels and cannot "
+                 "have an interleaved range\n", name(), channelRanges.size());
+        fatal_if(channels != channelRanges.size(), "%s has %d channel "
+                 "ranges but %d channel(s)\n", name(), channelRanges.size(),
+                 channels);
+        const AddrRange merged(channelRanges);
+        fatal_if(merged.start() != range.start() ||
+                 merged.end() != range.end(), "Channel ranges of %s do not "
+                 "match its range %s\n", name(), range.to_string());
+    }
+
+    const unsigned int num_channels = std::max(channelRanges.size(),
+                                               size_t(1));
+    for (int c = 0; c < num_channels; c++) {
+        Channel* channel = new Channel(c, ranksPerChannel * banksPerRank);
+        for (int i = 0; i < ranksPerChannel; i++) {
+            Rank* rank = new Rank(*this, p, i, *channel);
+            channel->ranks.push_back(rank);
+            ranks.push_back(rank);
+        }
+        ctrlChannels.push_back(channel);
     }
 
     // perform a basic check of the write thresholds
@@ -117,8 +142,10 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
               "high threshold %d\n", p->write_low_thresh_perc,
               p->write_high_thresh_perc);
 
-    // determine the rows per bank by looking at the total capacity
-    uint64_t capacity = ULL(1) << ceilLog2(AbstractMemory::size());
+    // determine the rows per bank by looking at the capacity of a
+    // channel
+    uint64_t capacity = ULL(1) << ceilLog2(AbstractMemory::size() /
+                                           num_channels);
 
     // determine the dram actual capacity from the DRAM config in Mbytes
     uint64_t deviceCapacity = deviceSize / (1024 * 1024) * devicesPerRank *
@@ -171,8 +198,24 @@ DRAMCtrl::DRAMCtrl(const DRAMCtrlParams* p) :
                   "bank groups per rank (%d) is greater than 1\n",
                   tRRD_L, tRRD, bankGroupsPerRank);
         }
+        // the same holds for writes to the same bank group
+        if (tCCD_L_WR <= tBURST) {
+            fatal("tCCD_L_WR (%d) should be larger than tBURST (%d) when "
+                  "bank groups per rank (%d) is greater than 1\n",
+                  tCCD_L_WR, tBURST, bankGroupsPerRank);
+        }
     }
 
+    // bursts are only interleaved across bank groups, and the gap
+    // between the two halves of a burst has to fit another half
+    if (burstInterleave) {
+        fatal_if(!bankGroupArch, "%s: burst interleaving requires a bank "
+                 "group architecture\n", name());
+        fatal_if(tBURST_MIN == 0 || 3 * tBURST_MIN > tBURST,
+                 "%s: tBURST_MIN (%d) must be non-zero and at most a third "
+                 "of tBURST (%d) for burst interleaving\n", name(),
+                 tBURST_MIN, tBURST);
+    }
 }
 
 void
@@ -187,14 +230,17 @@ DRAMCtrl::init()
     }
 
     // a bit of sanity checks on the interleaving, save it for here to
-    // ensure that the system pointer is initialised
-    if (range.interleaved()) {
-        if (channels != range.stripes())
+    // ensure that the system pointer is initialised, if we serve
+    // several channels then check the interleaving of those
+    const AddrRange& intlv_range = channelRanges.empty() ? range :
+        channelRanges.front();
+    if (intlv_range.interleaved()) {
+        if (channels != intlv_range.stripes())
             fatal("%s has %d interleaved address stripes but %d channel(s)\n",
-                  name(), range.stripes(), channels);
+                  name(), intlv_range.stripes(), channels);
 
         if (addrMapping == Enums::RoRaBaChCo) {
-            if (rowBufferSize != range.granularity()) {
+            if (rowBufferSize != intlv_range.granularity()) {
                 fatal("Channel interleaving of %s doesn't match RoRaBaChCo "
                       "address map\n", name());
             }
@@ -211,13 +257,13 @@ DRAMCtrl::init()
 
             // channel striping has to be done at a granularity that
             // is equal or larger to a cache line
-            if (system()->cacheLineSize() > range.granularity()) {
+            if (system()->cacheLineSize() > intlv_range.granularity()) {
                 fatal("Channel interleaving of %s must be at least as large "
                       "as the cache line size\n", name());
             }
 
             // ...and equal or smaller than the row-buffer size
-            if (rowBufferSize < range.granularity()) {
+            if (rowBufferSize < intlv_range.granularity()) {
                 fatal("Channel interleaving of %s must be at most as large "
                       "as the row-buffer size\n", name());
             }
@@ -247,7 +293,9 @@ DRAMCtrl::startup()
         // have to worry about negative values when computing the time for
         // the next request, this will add an insignificant bubble at the
         // start of simulation
-        busBusyUntil = curTick() + tRP + tRCD + tCL;
+        for (auto c : ctrlChannels) {
+            c->busBusyUntil = curTick() + tRP + tRCD + tCL;
+        }
     }
 }
 
@@ -272,27 +320,42 @@ DRAMCtrl::recvAtomic(PacketPtr pkt)
 }
 
 bool
-DRAMCtrl::readQueueFull(unsigned int neededEntries) const
+DRAMCtrl::readQueueFull(const Channel& channel,
+                        unsigned int neededEntries) const
 {
     DPRINTF(DRAM, "Read queue limit %d, current size %d, entries needed %d\n",
-            readBufferSize, readQueue.size() + respQueue.size(),
+            readBufferSize, channel.readQueue.size() + channel.respEntries,
             neededEntries);
 
-    return
-        (readQueue.size() + respQueue.size() + neededEntries) > readBufferSize;
+    return (channel.readQueue.size() + channel.respEntries +
+            neededEntries) > readBufferSize;
 }
 
 bool
-DRAMCtrl::writeQueueFull(unsigned int neededEntries) const
+DRAMCtrl::writeQueueFull(const Channel& channel,
+                         unsigned int neededEntries) const
 {
     DPRINTF(DRAM, "Write queue limit %d, current size %d, entries needed %d\n",
-            writeBufferSize, writeQueue.size(), neededEntries);
-    return (writeQueue.size() + neededEntries) > writeBufferSize;
+            writeBufferSize, channel.writeQueue.size(), neededEntries);
+    return (channel.writeQueue.size() + neededEntries) > writeBufferSize;
+}
+
+DRAMCtrl::Channel&
+DRAMCtrl::decodeChannel(Addr addr)
+{
+    // the channel is selected by the interleaving bits of the
+    // channel ranges, including any hashing
+    if (channelRanges.empty())
+        return *ctrlChannels.front();
+
+    const uint64_t channel = channelRanges.front().intlvSelect(addr);
+    assert(channel < ctrlChannels.size());
+    return *ctrlChannels[channel];
 }
 
 DRAMCtrl::DRAMPacket*
-DRAMCtrl::decodeAddr(PacketPtr pkt, Addr dramPktAddr, unsigned size,
-                       bool isRead)
+DRAMCtrl::decodeAddr(Channel& channel, PacketPtr pkt, Addr dramPktAddr,
+                     unsigned size, bool isRead)
 {
     // decode the address based on the address mapping scheme, with
     // Ro, Ra, Co, Ba and Ch denoting row, rank, column, bank and
@@ -392,12 +455,14 @@ DRAMCtrl::decodeAddr(PacketPtr pkt, Addr dramPktAddr, unsigned size,
     // ready time set to the current tick, the latter will be updated
     // later
     uint16_t bank_id = banksPerRank * rank + bank;
+    Rank& rank_ref = *channel.ranks[rank];
     return new DRAMPacket(pkt, isRead, rank, bank, row, bank_id, dramPktAddr,
-                          size, ranks[rank]->banks[bank], *ranks[rank]);
+                          size, rank_ref.banks[bank], rank_ref, channel);
 }
 
 void
-DRAMCtrl::addToReadQueue(PacketPtr pkt, unsigned int pktCount)
+DRAMCtrl::addToReadQueue(Channel& channel, PacketPtr pkt,
+                         unsigned int pktCount)
 {
     // only add to the read queue here. whenever the request is
     // eventually done, set the readyTime, and call schedule()
@@ -426,8 +491,9 @@ DRAMCtrl::addToReadQueue(PacketPtr pkt, unsigned int pktCount)
         Addr burst_addr = burstAlign(addr);
         // if the burst address is not present then there is no need
         // looking any further
-        if (isInWriteQueue.find(burst_addr) != isInWriteQueue.end()) {
-            for (const auto& p : writeQueue) {
+        if (channel.isInWriteQueue.find(burst_addr) !=
+            channel.isInWriteQueue.end()) {
+            for (const auto& p : channel.writeQueue) {
                 // check if the read is subsumed in the write queue
                 // packet we are looking at
                 if (p->addr <= addr && (addr + size) <= (p->addr + p->size)) {
@@ -453,21 +519,24 @@ DRAMCtrl::addToReadQueue(PacketPtr pkt, unsigned int pktCount)
                 burst_helper = new BurstHelper(pktCount);
             }
 
-            DRAMPacket* dram_pkt = decodeAddr(pkt, addr, size, true);
+            DRAMPacket* dram_pkt = decodeAddr(channel, pkt, addr, size,
+                                              true);
             dram_pkt->burstHelper = burst_helper;
 
-            assert(!readQueueFull(1));
-            rdQLenPdf[readQueue.size() + respQueue.size()]++;
+            assert(!readQueueFull(channel, 1));
+            rdQLenPdf[channel.readQueue.size() + channel.respEntries]++;
 
             DPRINTF(DRAM, "Adding to read queue\n");
 
-            readQueue.push_back(dram_pkt);
+            dram_pkt->seqNum = nextSeqNum++;
+            channel.readQueue.push_back(dram_pkt);
+            channel.readBankQueues[dram_pkt->bankId].push_back(dram_pkt);
 
             // increment read entries of the rank
             ++dram_pkt->rankRef.readEntries;
 
             // Update stats
-            avgRdQLen = readQueue.size() + respQueue.size();
+            avgRdQLen = channel.readQueue.size() + channel.respEntries;
         }
 
         // Starting address of next dram pkt (aligend to burstSize boundary)
@@ -486,14 +555,15 @@ DRAMCtrl::addToReadQueue(PacketPtr pkt, unsigned int pktCount)
 
     // If we are not already scheduled to get a request out of the
     // queue, do so now
-    if (!nextReqEvent.scheduled()) {
+    if (!channel.nextReqScheduled()) {
         DPRINTF(DRAM, "Request scheduled immediately\n");
-        schedule(nextReqEvent, curTick());
+        scheduleNextReq(channel, curTick());
     }
 }
 
 void
-DRAMCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pktCount)
+DRAMCtrl::addToWriteQueue(Channel& channel, PacketPtr pkt,
+                          unsigned int pktCount)
 {
     // only add to the write queue here. whenever the request is
     // eventually done, set the readyTime, and call schedule()
@@ -510,25 +580,29 @@ DRAMCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pktCount)
 
         // see if we can merge with an existing item in the write
         // queue and keep track of whether we have merged or not
-        bool merged = isInWriteQueue.find(burstAlign(addr)) !=
-            isInWriteQueue.end();
+        bool merged = channel.isInWriteQueue.find(burstAlign(addr)) !=
+            channel.isInWriteQueue.end();
 
         // if the item was not merged we need to create a new write
         // and enqueue it
         if (!merged) {
-            DRAMPacket* dram_pkt = decodeAddr(pkt, addr, size, false);
+            DRAMPacket* dram_pkt = decodeAddr(channel, pkt, addr, size,
+                                              false);
 
-            assert(writeQueue.size() < writeBufferSize);
-            wrQLenPdf[writeQueue.size()]++;
+            assert(channel.writeQueue.size() < writeBufferSize);
+            wrQLenPdf[channel.writeQueue.size()]++;
 
             DPRINTF(DRAM, "Adding to write queue\n");
 
-            writeQueue.push_back(dram_pkt);
-            isInWriteQueue.insert(burstAlign(addr));
-            assert(writeQueue.size() == isInWriteQueue.size());
+            dram_pkt->seqNum = nextSeqNum++;
+            channel.writeQueue.push_back(dram_pkt);
+            channel.writeBankQueues[dram_pkt->bankId].push_back(dram_pkt);
+            channel.isInWriteQueue.insert(burstAlign(addr));
+            assert(channel.writeQueue.size() ==
+                   channel.isInWriteQueue.size());
 
             // Update stats
-            avgWrQLen = writeQueue.size();
+            avgWrQLen = channel.writeQueue.size();
 
             // increment write entries of the rank
             ++dram_pkt->rankRef.writeEntries;
@@ -553,25 +627,30 @@ DRAMCtrl::addToWriteQueue(PacketPtr pkt, unsigned int pktCount)
 
     // If we are not already scheduled to get a request out of the
     // queue, do so now
-    if (!nextReqEvent.scheduled()) {
+    if (!channel.nextReqScheduled()) {
         DPRINTF(DRAM, "Request scheduled immediately\n");
-        schedule(nextReqEvent, curTick());
+        scheduleNextReq(channel, curTick());
     }
 }
 
 void
 DRAMCtrl::printQs() const {
-    DPRINTF(DRAM, "===READ QUEUE===\n\n");
-    for (auto i = readQueue.begin() ;  i != readQueue.end() ; ++i) {
-        DPRINTF(DRAM, "Read %lu\n", (*i)->addr);
+    for (auto c : ctrlChannels) {
+        DPRINTF(DRAM, "===READ QUEUE %d===\n\n", c->channel);
+        for (auto i = c->readQueue.begin() ;  i != c->readQueue.end() ; ++i) {
+            DPRINTF(DRAM, "Read %lu\n", (*i)->addr);
+        }
     }
     DPRINTF(DRAM, "\n===RESP QUEUE===\n\n");
     for (auto i = respQueue.begin() ;  i != respQueue.end() ; ++i) {
         DPRINTF(DRAM, "Response %lu\n", (*i)->addr);
     }
-    DPRINTF(DRAM, "\n===WRITE QUEUE===\n\n");
-    for (auto i = writeQueue.begin() ;  i != writeQueue.end() ; ++i) {
-        DPRINTF(DRAM, "Write %lu\n", (*i)->addr);
+    for (auto c : ctrlChannels) {
+        DPRINTF(DRAM, "\n===WRITE QUEUE %d===\n\n", c->channel);
+        for (auto i = c->writeQueue.begin() ;  i != c->writeQueue.end() ;
+             ++i) {
+            DPRINTF(DRAM, "Write %lu\n", (*i)->addr);
+        }
     }
 }
 
@@ -603,31 +682,33 @@ DRAMCtrl::recvTimingReq(PacketPtr pkt)
     unsigned offset = pkt->getAddr() & (burstSize - 1);
     unsigned int dram_pkt_count = divCeil(offset + size, burstSize);
 
+    Channel& channel = decodeChannel(pkt->getAddr());
+
     // check local buffers and do not accept if full
     if (pkt->isRead()) {
         assert(size != 0);
-        if (readQueueFull(dram_pkt_count)) {
+        if (readQueueFull(channel, dram_pkt_count)) {
             DPRINTF(DRAM, "Read queue full, not accepting\n");
             // remember that we have to retry this port
-            retryRdReq = true;
+            channel.retryRdReq = true;
             numRdRetry++;
             return false;
         } else {
-            addToReadQueue(pkt, dram_pkt_count);
+            addToReadQueue(channel, pkt, dram_pkt_count);
             readReqs++;
             bytesReadSys += size;
         }
     } else {
         assert(pkt->isWrite());
         assert(size != 0);
-        if (writeQueueFull(dram_pkt_count)) {
+        if (writeQueueFull(channel, dram_pkt_count)) {
             DPRINTF(DRAM, "Write queue full, not accepting\n");
             // remember that we have to retry this port
-            retryWrReq = true;
+            channel.retryWrReq = true;
             numWrRetry++;
             return false;
         } else {
-            addToWriteQueue(pkt, dram_pkt_count);
+            addToWriteQueue(channel, pkt, dram_pkt_count);
             writeReqs++;
             bytesWrittenSys += size;
         }
@@ -643,6 +724,7 @@ DRAMCtrl::processRespondEvent()
             "processRespondEvent(): Some req has reached its readyTime\n");
 
     DRAMPacket* dram_pkt = respQueue.front();
+    Channel& channel = dram_pkt->channelRef;
 
     // if a read has reached its ready-time, decrement the number of reads
     // At this point the packet has been handled and there is a possibility
@@ -707,6 +789,7 @@ DRAMCtrl::processRespondEvent()
 
     delete respQueue.front();
     respQueue.pop_front();
+    --channel.respEntries;
 
     if (!respQueue.empty()) {
         assert(respQueue.front()->readyTime >= curTick());
@@ -715,7 +798,7 @@ DRAMCtrl::processRespondEvent()
     } else {
         // if there is nothing left in any queue, signal a drain
         if (drainState() == DrainState::Draining &&
-            writeQueue.empty() && readQueue.empty() && allRanksDrained()) {
+            allQueuesEmpty() && allRanksDrained()) {
 
             DPRINTF(Drain, "DRAM controller done draining\n");
             signalDrainDone();
@@ -724,14 +807,15 @@ DRAMCtrl::processRespondEvent()
 
     // We have made a location in the queue available at this point,
     // so if there is a read that was forced to wait, retry now
-    if (retryRdReq) {
-        retryRdReq = false;
+    if (channel.retryRdReq) {
+        channel.retryRdReq = false;
         port.sendRetryReq();
     }
 }
 
 bool
-DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
+DRAMCtrl::chooseNext(const Channel& channel, std::deque<DRAMPacket*>& queue,
+                     const BankQueues& bank_queues, Tick extra_col_delay)
 {
     // This method does the arbitration between requests. The chosen
     // packet is simply moved to the head of the queue. The other
@@ -744,7 +828,7 @@ DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
     if (queue.size() == 1) {
         DRAMPacket* dram_pkt = queue.front();
         // available rank corresponds to state refresh idle
-        if (ranks[dram_pkt->rank]->inRefIdleState()) {
+        if (dram_pkt->rankRef.inRefIdleState()) {
             found_packet = true;
             DPRINTF(DRAM, "Single request, going to a free rank\n");
         } else {
@@ -757,7 +841,7 @@ DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
         // check if there is a packet going to a free rank
         for (auto i = queue.begin(); i != queue.end() ; ++i) {
             DRAMPacket* dram_pkt = *i;
-            if (ranks[dram_pkt->rank]->inRefIdleState()) {
+            if (dram_pkt->rankRef.inRefIdleState()) {
                 queue.erase(i);
                 queue.push_front(dram_pkt);
                 found_packet = true;
@@ -765,102 +849,106 @@ DRAMCtrl::chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
             }
         }
     } else if (memSchedPolicy == Enums::frfcfs) {
-        found_packet = reorderQueue(queue, extra_col_delay);
+        found_packet = reorderQueue(channel, queue, bank_queues,
+                                    extra_col_delay);
     } else
         panic("No scheduling policy chosen\n");
     return found_packet;
 }
 
 bool
-DRAMCtrl::reorderQueue(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
+DRAMCtrl::reorderQueue(const Channel& channel, std::deque<DRAMPacket*>& queue,
+                       const BankQueues& bank_queues, Tick extra_col_delay)
 {
-    // Only determine this if needed
-    uint64_t earliest_banks = 0;
-    bool hidden_bank_prep = false;
-
     // search for seamless row hits first, if no seamless row hit is
     // found then determine if there are other packets that can be issued
     // without incurring additional bus delay due to bank timing
     // Will select closed rows first to enable more open row possibilies
     // in future selections
-    bool found_hidden_bank = false;
-
-    // remember if we found a row hit, not seamless, but bank prepped
-    // and ready
-    bool found_prepped_pkt = false;
 
-    // if we have no row hit, prepped or not, and no seamless packet,
-    // just go for the earliest possible
-    bool found_earliest_pkt = false;
+    // oldest row hit that can issue seamlessly
+    DRAMPacket* seamless_pkt = nullptr;
 
-    auto selected_pkt_it = queue.end();
+    // oldest row hit, not seamless, but bank prepped and ready
+    DRAMPacket* prepped_pkt = nullptr;
 
     // time we need to issue a column command to be seamless
-    const Tick min_col_at = std::max(busBusyUntil - tCL + extra_col_delay,
-                                     curTick());
+    const Tick min_col_at = std::max(channel.busFreeAt() - tCL +
+                                     extra_col_delay, curTick());
+
+    // FCFS within the row hits, considering the oldest hit of every
+    // bank
+    for (const auto& bank_queue : bank_queues) {
+        if (bank_queue.empty())
+            continue;
+
+        // check if rank is not doing a refresh and thus is available,
+        // if not, jump to the next bank
+        if (!bank_queue.front()->rankRef.inRefIdleState())
+            continue;
+
+        const Bank& bank = bank_queue.front()->bankRef;
+        DRAMPacket* row_hit = nullptr;
+        for (const auto& p : bank_queue) {
+            if (p->row == bank.openRow) {
+                row_hit = p;
+                break;
+            }
+        }
 
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        DRAMPacket* dram_pkt = *i;
-        const Bank& bank = dram_pkt->bankRef;
+        if (!row_hit)
+            continue;
 
-        // check if rank is not doing a refresh and thus is available, if not,
-        // jump to the next packet
-        if (dram_pkt->rankRef.inRefIdleState()) {
-            // check if it is a row hit
-            if (bank.openRow == dram_pkt->row) {
-                // no additional rank-to-rank or same bank-group
-                // delays, or we switched read/write and might as well
-                // go for the row hit
-                if (bank.colAllowedAt <= min_col_at) {
-                    // FCFS within the hits, giving priority to
-                    // commands that can issue seamlessly, without
-                    // additional delay, such as same rank accesses
-                    // and/or different bank-group accesses
-                    DPRINTF(DRAM, "Seamless row buffer hit\n");
-                    selected_pkt_it = i;
-                    // no need to look through the remaining queue entries
-                    break;
-                } else if (!found_hidden_bank && !found_prepped_pkt) {
-                    // if we did not find a packet to a closed row that can
-                    // issue the bank commands without incurring delay, and
-                    // did not yet find a packet to a prepped row, remember
-                    // the current one
-                    selected_pkt_it = i;
-                    found_prepped_pkt = true;
-                    DPRINTF(DRAM, "Prepped row buffer hit\n");
-                }
-            } else if (!found_earliest_pkt) {
-                // if we have not initialised the bank status, do it
-                // now, and only once per scheduling decisions
-                if (earliest_banks == 0) {
-                    // determine entries with earliest bank delay
-                    pair<uint64_t, bool> bankStatus =
-                        minBankPrep(queue, min_col_at);
-                    earliest_banks = bankStatus.first;
-                    hidden_bank_prep = bankStatus.second;
-                }
+        // no additional rank-to-rank or same bank-group delays, or we
+        // switched read/write and might as well go for the row hit,
+        // giving priority to commands that can issue seamlessly, such
+        // as same rank accesses and/or different bank-group accesses
+        DRAMPacket*& selected = bank.colAllowedAt <= min_col_at ?
+            seamless_pkt : prepped_pkt;
+        if (!selected || row_hit->seqNum < selected->seqNum)
+            selected = row_hit;
+    }
 
-                // bank is amongst first available banks
-                // minBankPrep will give priority to packets that can
-                // issue seamlessly
-                if (bits(earliest_banks, dram_pkt->bankId, dram_pkt->bankId)) {
-                    found_earliest_pkt = true;
-                    found_hidden_bank = hidden_bank_prep;
-
-                    // give priority to packets that can issue
-                    // bank commands 'behind the scenes'
-                    // any additional delay if any will be due to
-                    // col-to-col command requirements
-                    if (hidden_bank_prep || !found_prepped_pkt)
-                        selected_pkt_it = i;
+    DRAMPacket* selected_pkt = seamless_pkt;
+    if (selected_pkt) {
+        DPRINTF(DRAM, "Seamless row buffer hit\n");
+    } else {
+        // determine entries with earliest bank delay
+        pair<uint64_t, bool> bank_status =
+            minBankPrep(channel, bank_queues, min_col_at);
+        const uint64_t earliest_banks = bank_status.first;
+        const bool hidden_bank_prep = bank_status.second;
+
+        // oldest request to a closed row amongst the first available
+        // banks, note that minBankPrep gives priority to banks that
+        // can issue seamlessly
+        DRAMPacket* earliest_pkt = nullptr;
+        for (int i = 0; i < bank_queues.size(); i++) {
+            if (!bits(earliest_banks, i, i))
+                continue;
+            for (const auto& p : bank_queues[i]) {
+                if (p->row != p->bankRef.openRow) {
+                    if (!earliest_pkt || p->seqNum < earliest_pkt->seqNum)
+                        earliest_pkt = p;
+                    break;
                 }
             }
         }
+
+        // give priority to packets that can issue bank commands
+        // 'behind the scenes', any additional delay if any will be
+        // due to col-to-col command requirements
+        if (earliest_pkt && (hidden_bank_prep || !prepped_pkt))
+            selected_pkt = earliest_pkt;
+    }
+
+    if (!selected_pkt && prepped_pkt) {
+        DPRINTF(DRAM, "Prepped row buffer hit\n");
+        selected_pkt = prepped_pkt;
     }
 
-    if (selected_pkt_it != queue.end()) {
-        DRAMPacket* selected_pkt = *selected_pkt_it;
-        queue.erase(selected_pkt_it);
+    if (selected_pkt) {
+        queue.erase(std::find(queue.begin(), queue.end(), selected_pkt));
         queue.push_front(selected_pkt);
         return true;
     }
@@ -868,6 +956,15 @@ DRAMCtrl::reorderQueue(std::deque<DRAMPacket*>& queue, Tick extra_col_delay)
     return false;
 }
 
+void
+DRAMCtrl::removeFromBankQueue(BankQueues& bank_queues, DRAMPacket* dram_pkt)
+{
+    auto& bank_queue = bank_queues[dram_pkt->bankId];
+    auto it = std::find(bank_queue.begin(), bank_queue.end(), dram_pkt);
+    assert(it != bank_queue.end());
+    bank_queue.erase(it);
+}
+
 void
 DRAMCtrl::accessAndRespond(PacketPtr pkt, Tick static_latency)
 {
@@ -928,7 +1025,7 @@ DRAMCtrl::activateBank(Rank& rank_ref, Bank& bank_ref,
 
     DPRINTF(DRAM, "Activate bank %d, rank %d at tick %lld, now got %d active\n",
             bank_ref.bank, rank_ref.rank, act_tick,
-            ranks[rank_ref.rank]->numBanksActive);
+            rank_ref.numBanksActive);
 
     rank_ref.cmdList.push_back(Command(MemCommand::ACT, bank_ref.bank,
                                act_tick));
@@ -1059,7 +1156,8 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
     DPRINTF(DRAM, "Timing access to addr %lld, rank/bank/row %d %d %d\n",
             dram_pkt->addr, dram_pkt->rank, dram_pkt->bank, dram_pkt->row);
 
-    // get the rank
+    // get the channel and the rank
+    Channel& channel = dram_pkt->channelRef;
     Rank& rank = dram_pkt->rankRef;
 
     // are we in or transitioning to a low-power state and have not scheduled
@@ -1102,15 +1200,37 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
         cmd_at = bank.colAllowedAt;
     }
 
+    // if the data clock has been stopped since the last burst to
+    // this rank, it has to be synchronised before the burst
+    if (tWCK_SYNC != 0 && cmd_at > rank.lastBurstTick + tCL + tBURST) {
+        cmd_at += tWCK_SYNC;
+    }
+
     // we need to wait until the bus is available before we can issue
-    // the command
-    cmd_at = std::max(cmd_at, busBusyUntil - tCL);
+    // the command, with burst interleaving a burst that is ready in
+    // time can use the gap in the previous one
+    const bool interleaved = channel.interleaveAt != MaxTick &&
+        cmd_at + tCL <= channel.interleaveAt;
+    if (interleaved) {
+        cmd_at = channel.interleaveAt - tCL;
+    } else {
+        cmd_at = std::max(cmd_at, channel.busBusyUntil - tCL);
+    }
 
     // update the packet ready time
     dram_pkt->readyTime = cmd_at + tCL + tBURST;
+    rank.lastBurstTick = cmd_at;
+
+    // only one burst can use the bus at any one point in time, an
+    // interleaved burst ends at most tBURST_MIN after the previous
+    // burst
+    assert(dram_pkt->readyTime - channel.busBusyUntil >=
+           (interleaved ? tBURST_MIN : tBURST));
 
-    // only one burst can use the bus at any one point in time
-    assert(dram_pkt->readyTime - busBusyUntil >= tBURST);
+    // a burst that does not interleave itself leaves a gap for a
+    // burst to a different bank group
+    const Tick burst_gap = burstInterleave && !interleaved ? tBURST_MIN :
+        tBURST;
 
     // update the time for the next read/write burst for each
     // bank (add a max with tCCD/tCCD_L here)
@@ -1118,21 +1238,22 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
     for (int j = 0; j < ranksPerChannel; j++) {
         for (int i = 0; i < banksPerRank; i++) {
             // next burst to same bank group in this rank must not happen
-            // before tCCD_L.  Different bank group timing requirement is
-            // tBURST; Add tCS for different ranks
+            // before tCCD_L, or tCCD_L_WR for writes.  Different bank
+            // group timing requirement is tBURST, or tBURST_MIN with
+            // burst interleaving; Add tCS for different ranks
             if (dram_pkt->rank == j) {
                 if (bankGroupArch &&
-                   (bank.bankgr == ranks[j]->banks[i].bankgr)) {
+                   (bank.bankgr == channel.ranks[j]->banks[i].bankgr)) {
                     // bank group architecture requires longer delays between
                     // RD/WR burst commands to the same bank group.
                     // Use tCCD_L in this case
-                    cmd_dly = tCCD_L;
+                    cmd_dly = dram_pkt->isRead ? tCCD_L : tCCD_L_WR;
                 } else {
                     // use tBURST (equivalent to tCCD_S), the shorter
                     // cas-to-cas delay value, when either:
                     // 1) bank group architecture is not supportted
                     // 2) bank is in a different bank group
-                    cmd_dly = tBURST;
+                    cmd_dly = burst_gap;
                 }
             } else {
                 // different rank is by default in a different bank group
@@ -1141,13 +1262,14 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
                 // Add tCS to account for rank-to-rank bus delay requirements
                 cmd_dly = tBURST + tCS;
             }
-            ranks[j]->banks[i].colAllowedAt = std::max(cmd_at + cmd_dly,
-                                             ranks[j]->banks[i].colAllowedAt);
+            Bank& other = channel.ranks[j]->banks[i];
+            other.colAllowedAt = std::max(cmd_at + cmd_dly,
+                                          other.colAllowedAt);
         }
     }
 
     // Save rank of current access
-    activeRank = dram_pkt->rank;
+    channel.activeRank = dram_pkt->rank;
 
     // If this is a write, we also need to respect the write recovery
     // time before a precharge, in the case of a read, respect the
@@ -1180,26 +1302,24 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
         bool got_more_hits = false;
         bool got_bank_conflict = false;
 
-        // either look at the read queue or write queue
-        const deque<DRAMPacket*>& queue = dram_pkt->isRead ? readQueue :
-            writeQueue;
-        auto p = queue.begin();
-        // make sure we are not considering the packet that we are
-        // currently dealing with (which is the head of the queue)
-        ++p;
+        // either look at the read queue or write queue of this bank
+        const deque<DRAMPacket*>& queue = (dram_pkt->isRead ?
+            channel.readBankQueues :
+            channel.writeBankQueues)[dram_pkt->bankId];
 
         // keep on looking until we find a hit or reach the end of the queue
         // 1) if a hit is found, then both open and close adaptive policies keep
         // the page open
         // 2) if no hit is found, got_bank_conflict is set to true if a bank
         // conflict request is waiting in the queue
-        while (!got_more_hits && p != queue.end()) {
-            bool same_rank_bank = (dram_pkt->rank == (*p)->rank) &&
-                (dram_pkt->bank == (*p)->bank);
+        for (auto p = queue.begin(); !got_more_hits && p != queue.end(); ++p) {
+            // make sure we are not considering the packet that we are
+            // currently dealing with
+            if (*p == dram_pkt)
+                continue;
             bool same_row = dram_pkt->row == (*p)->row;
-            got_more_hits |= same_rank_bank && same_row;
-            got_bank_conflict |= same_rank_bank && !same_row;
-            ++p;
+            got_more_hits |= same_row;
+            got_bank_conflict |= !same_row;
         }
 
         // auto pre-charge when either
@@ -1218,10 +1338,12 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
                                                    MemCommand::WR;
 
     // Update bus state
-    busBusyUntil = dram_pkt->readyTime;
+    channel.busBusyUntil = dram_pkt->readyTime;
+    channel.interleaveAt = burst_gap < tBURST ? cmd_at + tCL + burst_gap :
+        MaxTick;
 
     DPRINTF(DRAM, "Access to %lld, ready at %lld bus busy until %lld.\n",
-            dram_pkt->addr, dram_pkt->readyTime, busBusyUntil);
+            dram_pkt->addr, dram_pkt->readyTime, channel.busBusyUntil);
 
     dram_pkt->rankRef.cmdList.push_back(Command(command, dram_pkt->bank,
                                         cmd_at));
@@ -1243,34 +1365,77 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
     // conservative estimate of when we have to schedule the next
     // request to not introduce any unecessary bubbles. In most cases
     // we will wake up sooner than we have to.
-    nextReqTime = busBusyUntil - (tRP + tRCD + tCL);
+    channel.nextReqTime = channel.busFreeAt() - (tRP + tRCD + tCL);
 
-    // Update the stats and schedule the next request
+    // Update the stats and schedule the next request, the banks of
+    // all channels are accounted for separately
+    const unsigned int bank_stat_id = dram_pkt->bankId +
+        channel.channel * ranksPerChannel * banksPerRank;
     if (dram_pkt->isRead) {
-        ++readsThisTime;
+        ++channel.readsThisTime;
         if (row_hit)
             readRowHits++;
         bytesReadDRAM += burstSize;
-        perBankRdBursts[dram_pkt->bankId]++;
+        perBankRdBursts[bank_stat_id]++;
 
         // Update latency stats
         totMemAccLat += dram_pkt->readyTime - dram_pkt->entryTime;
         totBusLat += tBURST;
         totQLat += cmd_at - dram_pkt->entryTime;
     } else {
-        ++writesThisTime;
+        ++channel.writesThisTime;
         if (row_hit)
             writeRowHits++;
         bytesWritten += burstSize;
-        perBankWrBursts[dram_pkt->bankId]++;
+        perBankWrBursts[bank_stat_id]++;
     }
 }
 
 void
 DRAMCtrl::processNextReqEvent()
+{
+    // look at all the channels that are due, note that the scheduling
+    // of a channel can make it due again in the current tick, in
+    // which case the event is scheduled again
+    Tick next_req_at = MaxTick;
+    for (auto c : ctrlChannels) {
+        if (c->nextReqAt <= curTick()) {
+            c->nextReqAt = MaxTick;
+            scheduleChannel(*c);
+        }
+        next_req_at = std::min(next_req_at, c->nextReqAt);
+    }
+
+    // the channels that were not due, or that did not schedule
+    // themselves again, still need the event for when they are due
+    if (next_req_at == MaxTick)
+        return;
+
+    if (!nextReqEvent.scheduled())
+        schedule(nextReqEvent, next_req_at);
+    else if (nextReqEvent.when() > next_req_at)
+        reschedule(nextReqEvent, next_req_at);
+}
+
+void
+DRAMCtrl::scheduleNextReq(Channel& channel, Tick when)
+{
+    if (channel.nextReqScheduled())
+        return;
+
+    channel.nextReqAt = when;
+
+    if (!nextReqEvent.scheduled())
+        schedule(nextReqEvent, when);
+    else if (nextReqEvent.when() > when)
+        reschedule(nextReqEvent, when);
+}
+
+void
+DRAMCtrl::scheduleChannel(Channel& channel)
 {
     int busyRanks = 0;
-    for (auto r : ranks) {
+    for (auto r : channel.ranks) {
         if (!r->inRefIdleState()) {
             if (r->pwrState != PWR_SREF) {
                 // rank is busy refreshing
@@ -1312,44 +1477,49 @@ DRAMCtrl::processNextReqEvent()
     // pre-emptively set to false.  Overwrite if in transitioning to
     // a new state
     bool switched_cmd_type = false;
-    if (busState != busStateNext) {
-        if (busState == READ) {
+    if (channel.busState != channel.busStateNext) {
+        if (channel.busState == READ) {
             DPRINTF(DRAM, "Switching to writes after %d reads with %d reads "
-                    "waiting\n", readsThisTime, readQueue.size());
+                    "waiting\n", channel.readsThisTime,
+                    channel.readQueue.size());
 
             // sample and reset the read-related stats as we are now
             // transitioning to writes, and all reads are done
-            rdPerTurnAround.sample(readsThisTime);
-            readsThisTime = 0;
+            rdPerTurnAround.sample(channel.readsThisTime);
+            channel.readsThisTime = 0;
 
             // now proceed to do the actual writes
             switched_cmd_type = true;
         } else {
             DPRINTF(DRAM, "Switching to reads after %d writes with %d writes "
-                    "waiting\n", writesThisTime, writeQueue.size());
+                    "waiting\n", channel.writesThisTime,
+                    channel.writeQueue.size());
 
-            wrPerTurnAround.sample(writesThisTime);
-            writesThisTime = 0;
+            wrPerTurnAround.sample(channel.writesThisTime);
+            channel.writesThisTime = 0;
 
             switched_cmd_type = true;
         }
         // update busState to match next state until next transition
-        busState = busStateNext;
+        channel.busState = channel.busStateNext;
+
+        // bursts in opposite directions are never interleaved
+        channel.interleaveAt = MaxTick;
     }
 
     // when we get here it is either a read or a write
-    if (busState == READ) {
+    if (channel.busState == READ) {
 
         // track if we should switch or not
         bool switch_to_writes = false;
 
-        if (readQueue.empty()) {
+        if (channel.readQueue.empty()) {
             // In the case there is no read request to go next,
             // trigger writes if we have passed the low threshold (or
             // if we are draining)
-            if (!writeQueue.empty() &&
+            if (!channel.writeQueue.empty() &&
                 (drainState() == DrainState::Draining ||
-                 writeQueue.size() > writeLowThreshold)) {
+                 channel.writeQueue.size() > writeLowThreshold)) {
 
                 switch_to_writes = true;
             } else {
@@ -1358,7 +1528,8 @@ DRAMCtrl::processNextReqEvent()
                 // ensuring all banks are closed and
                 // have exited low power states
                 if (drainState() == DrainState::Draining &&
-                    respQueue.empty() && allRanksDrained()) {
+                    respQueue.empty() && allQueuesEmpty() &&
+                    allRanksDrained()) {
 
                     DPRINTF(Drain, "DRAM controller done draining\n");
                     signalDrainDone();
@@ -1376,8 +1547,9 @@ DRAMCtrl::processNextReqEvent()
             // front of the read queue
             // If we are changing command type, incorporate the minimum
             // bus turnaround delay which will be tCS (different rank) case
-            found_read = chooseNext(readQueue,
-                             switched_cmd_type ? tCS : 0);
+            found_read = chooseNext(channel, channel.readQueue,
+                                    channel.readBankQueues,
+                                    switched_cmd_type ? tCS : 0);
 
             // if no read to an available rank is found then return
             // at this point. There could be writes to the available ranks
@@ -1387,7 +1559,7 @@ DRAMCtrl::processNextReqEvent()
             if (!found_read)
                 return;
 
-            DRAMPacket* dram_pkt = readQueue.front();
+            DRAMPacket* dram_pkt = channel.readQueue.front();
             assert(dram_pkt->rankRef.inRefIdleState());
 
             // here we get a bit creative and shift the bus busy time not
@@ -1395,14 +1567,15 @@ DRAMCtrl::processNextReqEvent()
             // that we are allowed to prepare a new bank, but not issue a
             // read command until after tWTR, in essence we capture a
             // bubble on the data bus that is tWTR + tCL
-            if (switched_cmd_type && dram_pkt->rank == activeRank) {
-                busBusyUntil += tWTR + tCL;
+            if (switched_cmd_type && dram_pkt->rank == channel.activeRank) {
+                channel.busBusyUntil += tWTR + tCL;
             }
 
             doDRAMAccess(dram_pkt);
 
             // At this point we're done dealing with the request
-            readQueue.pop_front();
+            channel.readQueue.pop_front();
+            removeFromBankQueue(channel.readBankQueues, dram_pkt);
 
             // Every respQueue which will generate an event, increment count
             ++dram_pkt->rankRef.outstandingEvents;
@@ -1412,19 +1585,28 @@ DRAMCtrl::processNextReqEvent()
             assert(dram_pkt->readyTime >= curTick());
 
             // Insert into response queue. It will be sent back to the
-            // requestor at its readyTime
-            if (respQueue.empty()) {
-                assert(!respondEvent.scheduled());
-                schedule(respondEvent, dram_pkt->readyTime);
+            // requestor at its readyTime. The ready times of a channel
+            // are increasing, but the channels are independent, so
+            // find the place of the packet from the back of the queue
+            auto pos = respQueue.end();
+            while (pos != respQueue.begin() &&
+                   (*(pos - 1))->readyTime > dram_pkt->readyTime)
+                --pos;
+
+            if (pos == respQueue.begin()) {
+                if (!respondEvent.scheduled())
+                    schedule(respondEvent, dram_pkt->readyTime);
+                else
+                    reschedule(respondEvent, dram_pkt->readyTime);
             } else {
-                assert(respQueue.back()->readyTime <= dram_pkt->readyTime);
                 assert(respondEvent.scheduled());
             }
 
-            respQueue.push_back(dram_pkt);
+            respQueue.insert(pos, dram_pkt);
+            ++channel.respEntries;
 
             // we have so many writes that we have to transition
-            if (writeQueue.size() > writeHighThreshold) {
+            if (channel.writeQueue.size() > writeHighThreshold) {
                 switch_to_writes = true;
             }
         }
@@ -1434,7 +1616,7 @@ DRAMCtrl::processNextReqEvent()
         // draining), or because the writes hit the hight threshold
         if (switch_to_writes) {
             // transition to writing
-            busStateNext = WRITE;
+            channel.busStateNext = WRITE;
         }
     } else {
         // bool to check if write to free rank is found
@@ -1442,7 +1624,8 @@ DRAMCtrl::processNextReqEvent()
 
         // If we are changing command type, incorporate the minimum
         // bus turnaround delay
-        found_write = chooseNext(writeQueue,
+        found_write = chooseNext(channel, channel.writeQueue,
+                                 channel.writeBankQueues,
                                  switched_cmd_type ? std::min(tRTW, tCS) : 0);
 
         // if there are no writes to a rank that is available to service
@@ -1453,7 +1636,7 @@ DRAMCtrl::processNextReqEvent()
         if (!found_write)
             return;
 
-        DRAMPacket* dram_pkt = writeQueue.front();
+        DRAMPacket* dram_pkt = channel.writeQueue.front();
         assert(dram_pkt->rankRef.inRefIdleState());
         // sanity check
         assert(dram_pkt->size <= burstSize);
@@ -1462,13 +1645,14 @@ DRAMCtrl::processNextReqEvent()
         // tRTW when access is to the same rank as previous burst
         // Different rank timing is handled with tCS, which is
         // applied to colAllowedAt
-        if (switched_cmd_type && dram_pkt->rank == activeRank) {
-            busBusyUntil += tRTW;
+        if (switched_cmd_type && dram_pkt->rank == channel.activeRank) {
+            channel.busBusyUntil += tRTW;
         }
 
         doDRAMAccess(dram_pkt);
 
-        writeQueue.pop_front();
+        channel.writeQueue.pop_front();
+        removeFromBankQueue(channel.writeBankQueues, dram_pkt);
 
         // removed write from queue, decrement count
         --dram_pkt->rankRef.writeEntries;
@@ -1489,19 +1673,20 @@ DRAMCtrl::processNextReqEvent()
             reschedule(dram_pkt->rankRef.writeDoneEvent, dram_pkt->readyTime);
         }
 
-        isInWriteQueue.erase(burstAlign(dram_pkt->addr));
+        channel.isInWriteQueue.erase(burstAlign(dram_pkt->addr));
         delete dram_pkt;
 
         // If we emptied the write queue, or got sufficiently below the
         // threshold (using the minWritesPerSwitch as the hysteresis) and
         // are not draining, or we have reads waiting and have done enough
         // writes, then switch to reads.
-        if (writeQueue.empty() ||
-            (writeQueue.size() + minWritesPerSwitch < writeLowThreshold &&
-             drainState() != DrainState::Draining) ||
-            (!readQueue.empty() && writesThisTime >= minWritesPerSwitch)) {
+        if (channel.writeQueue.empty() ||
+            (channel.writeQueue.size() + minWritesPerSwitch <
+             writeLowThreshold && drainState() != DrainState::Draining) ||
+            (!channel.readQueue.empty() &&
+             channel.writesThisTime >= minWritesPerSwitch)) {
             // turn the bus back around for reads again
-            busStateNext = READ;
+            channel.busStateNext = READ;
 
             // note that the we switch back to reads also in the idle
             // case, which eventually will check for any draining and
@@ -1511,21 +1696,21 @@ DRAMCtrl::processNextReqEvent()
     }
     // It is possible that a refresh to another rank kicks things back into
     // action before reaching this point.
-    if (!nextReqEvent.scheduled())
-        schedule(nextReqEvent, std::max(nextReqTime, curTick()));
+    scheduleNextReq(channel, std::max(channel.nextReqTime, curTick()));
 
     // If there is space available and we have writes waiting then let
     // them retry. This is done here to ensure that the retry does not
     // cause a nextReqEvent to be scheduled before we do so as part of
     // the next request processing
-    if (retryWrReq && writeQueue.size() < writeBufferSize) {
-        retryWrReq = false;
+    if (channel.retryWrReq &&
+        channel.writeQueue.size() < writeBufferSize) {
+        channel.retryWrReq = false;
         port.sendRetryReq();
     }
 }
 
 pair<uint64_t, bool>
-DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
+DRAMCtrl::minBankPrep(const Channel& channel, const BankQueues& bank_queues,
                       Tick min_col_at) const
 {
     uint64_t bank_mask = 0;
@@ -1542,14 +1727,6 @@ DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
     // delay on the data bus
     bool hidden_bank_prep = false;
 
-    // determine if we have queued transactions targetting the
-    // bank in question
-    vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->rankRef.inRefIdleState())
-            got_waiting[p->bankId] = true;
-    }
-
     // Find command with optimal bank timing
     // Will prioritize commands that can issue seamlessly.
     for (int i = 0; i < ranksPerChannel; i++) {
@@ -1557,20 +1734,21 @@ DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
             uint16_t bank_id = i * banksPerRank + j;
 
             // if we have waiting requests for the bank, and it is
-            // amongst the first available, update the mask
-            if (got_waiting[bank_id]) {
-                // make sure this rank is not currently refreshing.
-                assert(ranks[i]->inRefIdleState());
+            // amongst the first available, update the mask, making
+            // sure this rank is not currently refreshing
+            if (!bank_queues[bank_id].empty() &&
+                channel.ranks[i]->inRefIdleState()) {
+                const Bank& bank = channel.ranks[i]->banks[j];
+
                 // simplistic approximation of when the bank can issue
                 // an activate, ignoring any rank-to-rank switching
                 // cost in this calculation
-                Tick act_at = ranks[i]->banks[j].openRow == Bank::NO_ROW ?
-                    std::max(ranks[i]->banks[j].actAllowedAt, curTick()) :
-                    std::max(ranks[i]->banks[j].preAllowedAt, curTick()) + tRP;
+                Tick act_at = bank.openRow == Bank::NO_ROW ?
+                    std::max(bank.actAllowedAt, curTick()) :
+                    std::max(bank.preAllowedAt, curTick()) + tRP;
 
                 // When is the earliest the R/W burst can issue?
-                Tick col_at = std::max(ranks[i]->banks[j].colAllowedAt,
-                                       act_at + tRCD);
+                Tick col_at = std::max(bank.colAllowedAt, act_at + tRCD);
 
                 // bank can issue burst back-to-back (seamlessly) with
                 // previous burst
@@ -1607,13 +1785,15 @@ DRAMCtrl::minBankPrep(const deque<DRAMPacket*>& queue,
     return make_pair(bank_mask, hidden_bank_prep);
 }
 
-DRAMCtrl::Rank::Rank(DRAMCtrl& _memory, const DRAMCtrlParams* _p, int rank)
-    : EventManager(&_memory), memory(_memory),
+DRAMCtrl::Rank::Rank(DRAMCtrl& _memory, const DRAMCtrlParams* _p, int rank,
+                     Channel& _channel)
+    : EventManager(&_memory), memory(_memory), channel(_channel),
       pwrStateTrans(PWR_IDLE), pwrStatePostRefresh(PWR_IDLE),
       pwrStateTick(0), refreshDueAt(0), pwrState(PWR_IDLE),
       refreshState(REF_IDLE), inLowPowerState(false), rank(rank),
       readEntries(0), writeEntries(0), outstandingEvents(0),
-      wakeUpAllowedAt(0), power(_p, false), banks(_p->banks_per_rank),
+      wakeUpAllowedAt(0), lastBurstTick(0), power(_p, false),
+      banks(_p->banks_per_rank),
       numBanksActive(0), actTicks(_p->activation_limit, 0),
       writeDoneEvent([this]{ processWriteDoneEvent(); }, name()),
       activateEvent([this]{ processActivateEvent(); }, name()),
@@ -1643,6 +1823,15 @@ DRAMCtrl::Rank::Rank(DRAMCtrl& _memory, const DRAMCtrlParams* _p, int rank)
     }
 }
 
+const std::string
+DRAMCtrl::Rank::name() const
+{
+    if (memory.channelRanges.empty())
+        return csprintf("%s_%d", memory.name(), rank);
+    else
+        return csprintf("%s_ch%d_%d", memory.name(), channel.channel, rank);
+}
+
 void
 DRAMCtrl::Rank::startup(Tick ref_tick)
 {
@@ -1670,8 +1859,9 @@ DRAMCtrl::Rank::suspend()
 bool
 DRAMCtrl::Rank::lowPowerEntryReady() const
 {
-    bool no_queued_cmds = ((memory.busStateNext == READ) && (readEntries == 0))
-                          || ((memory.busStateNext == WRITE) &&
+    bool no_queued_cmds = ((channel.busStateNext == READ) &&
+                           (readEntries == 0))
+                          || ((channel.busStateNext == WRITE) &&
                               (writeEntries == 0));
 
     if (refreshState == REF_RUN) {
@@ -1685,6 +1875,13 @@ DRAMCtrl::Rank::lowPowerEntryReady() const
     }
 }
 
+bool
+DRAMCtrl::Rank::forceSelfRefreshExit() const
+{
+    return (readEntries != 0) ||
+           ((channel.busStateNext == WRITE) && (writeEntries != 0));
+}
+
 void
 DRAMCtrl::Rank::checkDrainDone()
 {
@@ -1803,8 +2000,8 @@ DRAMCtrl::Rank::processRefreshEvent()
     if (refreshState == REF_DRAIN) {
         // if a request is at the moment being handled and this request is
         // accessing the current rank then wait for it to finish
-        if ((rank == memory.activeRank)
-            && (memory.nextReqEvent.scheduled())) {
+        if ((rank == channel.activeRank)
+            && (channel.nextReqScheduled())) {
             // hand control over to the request loop until it is
             // evaluated next
             DPRINTF(DRAM, "Refresh awaiting draining\n");
@@ -2165,10 +2362,10 @@ DRAMCtrl::Rank::processPowerEvent()
         }
         // a request event could be already scheduled by the state
         // machine of the other rank
-        if (!memory.nextReqEvent.scheduled()) {
+        if (!channel.nextReqScheduled()) {
             DPRINTF(DRAM, "Scheduling next request after refreshing rank %d\n",
                     rank);
-            schedule(memory.nextReqEvent, curTick());
+            memory.scheduleNextReq(channel, curTick());
         }
     } else if (pwrState == PWR_ACT) {
         if (refreshState == REF_PD_EXIT) {
@@ -2414,12 +2611,12 @@ DRAMCtrl::regStats()
         .desc("Number of requests that are neither read nor write");
 
     perBankRdBursts
-        .init(banksPerRank * ranksPerChannel)
+        .init(banksPerRank * ranksPerChannel * ctrlChannels.size())
         .name(name() + ".perBankRdBursts")
         .desc("Per bank write bursts");
 
     perBankWrBursts
-        .init(banksPerRank * ranksPerChannel)
+        .init(banksPerRank * ranksPerChannel * ctrlChannels.size())
         .name(name() + ".perBankWrBursts")
         .desc("Per bank write bursts");
 
@@ -2588,7 +2785,11 @@ DRAMCtrl::regStats()
         .desc("Theoretical peak bandwidth in MiByte/s")
         .precision(2);
 
-    peakBW = (SimClock::Frequency / tBURST) * burstSize / 1000000;
+    // every channel has its own data bus, and with burst
+    // interleaving the two halves of a burst take 2 * tBURST_MIN
+    const Tick burst_time = burstInterleave ? 2 * tBURST_MIN : tBURST;
+    peakBW = (SimClock::Frequency / burst_time) * burstSize *
+        ctrlChannels.size() / 1000000;
 
     busUtil
         .name(name() + ".busUtil")
@@ -2653,17 +2854,20 @@ DRAMCtrl::drain()
 {
     // if there is anything in any of our internal queues, keep track
     // of that as well
-    if (!(writeQueue.empty() && readQueue.empty() && respQueue.empty() &&
-          allRanksDrained())) {
+    if (!(allQueuesEmpty() && respQueue.empty() && allRanksDrained())) {
 
-        DPRINTF(Drain, "DRAM controller not drained, write: %d, read: %d,"
-                " resp: %d\n", writeQueue.size(), readQueue.size(),
+        DPRINTF(Drain, "DRAM controller not drained, resp: %d\n",
                 respQueue.size());
 
         // the only queue that is not drained automatically over time
         // is the write queue, thus kick things into action if needed
-        if (!writeQueue.empty() && !nextReqEvent.scheduled()) {
-            schedule(nextReqEvent, curTick());
+        for (auto c : ctrlChannels) {
+            DPRINTF(Drain, "Channel %d write: %d, read: %d\n", c->channel,
+                    c->writeQueue.size(), c->readQueue.size());
+
+            if (!c->writeQueue.empty() && !c->nextReqScheduled()) {
+                scheduleNextReq(*c, curTick());
+            }
         }
 
         // also need to kick off events to exit self-refresh
@@ -2682,6 +2886,16 @@ DRAMCtrl::drain()
     }
 }
 
+bool
+DRAMCtrl::allQueuesEmpty() const
+{
+    for (auto c : ctrlChannels) {
+        if (!c->readQueue.empty() || !c->writeQueue.empty())
+            return false;
+    }
+    return true;
+}
+
 bool
 DRAMCtrl::allRanksDrained() const
 {
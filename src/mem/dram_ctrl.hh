@@ -74,7 +74,12 @@
  * the most important timing constraints associated with a
  * contemporary DRAM. For multi-channel memory systems, the controller
  * is combined with a crossbar model, with the channel address
- * interleaving taking part in the crossbar.
+ * interleaving taking part in the crossbar. Alternatively, a single
+ * controller can serve all the channels itself, given the
+ * interleaved ranges the individual channels would have had. The
+ * channels still have their own queues, data bus and ranks, but
+ * share the port, the response queue and the events that drive the
+ * scheduling and the responses.
  *
  * As a basic design principle, this controller
  * model is not cycle callable, but instead uses events to: 1) decide
@@ -93,6 +98,13 @@
  * The low-power functionality implements a staggered powerdown
  * similar to that described in "Optimized Active and Power-Down Mode
  * Refresh Control in 3D-DRAMs" by Jung et al, VLSI-SoC, 2014.
+ * A rank without queued requests drops into precharge power-down
+ * after its next refresh, and into self-refresh after the one
+ * following that. No refresh or power events are scheduled for a rank
+ * in self-refresh, so an idle channel costs at most two refresh
+ * sequences per rank, however long it stays idle. The energy of the
+ * self-refresh period is accounted for by DRAMPower when the rank
+ * exits it, or when the stats are dumped.
  */
 class DRAMCtrl : public AbstractMemory
 {
@@ -134,12 +146,6 @@ class DRAMCtrl : public AbstractMemory
      */
     bool isTimingMode;
 
-    /**
-     * Remember if we have to retry a request when available.
-     */
-    bool retryRdReq;
-    bool retryWrReq;
-
     /**
      * Bus state used to control the read/write switching and drive
      * the scheduling of the next request.
@@ -149,11 +155,6 @@ class DRAMCtrl : public AbstractMemory
         WRITE,
     };
 
-    BusState busState;
-
-    /* bus state for next request event triggered */
-    BusState busStateNext;
-
     /**
      * Simple structure to hold the values needed to keep track of
      * commands for DRAMPower
@@ -287,6 +288,8 @@ class DRAMCtrl : public AbstractMemory
      * rank. This class allows the implementation of rank-wise refresh
      * and rank-wise power-down.
      */
+    class Channel;
+
     class Rank : public EventManager
     {
 
@@ -297,6 +300,11 @@ class DRAMCtrl : public AbstractMemory
          */
         DRAMCtrl& memory;
 
+        /**
+         * The channel the rank is part of
+         */
+        Channel& channel;
+
         /**
          * Since we are taking decisions out of order, we need to keep
          * track of what power transition is happening at what time
@@ -424,6 +432,12 @@ class DRAMCtrl : public AbstractMemory
          */
         Tick wakeUpAllowedAt;
 
+        /**
+         * Command time of the last burst to this rank, used to
+         * determine if the data clock has to be synchronised again
+         */
+        Tick lastBurstTick;
+
         /**
          * One DRAMPower instance per rank
          */
@@ -452,12 +466,10 @@ class DRAMCtrl : public AbstractMemory
         /** List to keep track of activate ticks */
         std::deque<Tick> actTicks;
 
-        Rank(DRAMCtrl& _memory, const DRAMCtrlParams* _p, int rank);
+        Rank(DRAMCtrl& _memory, const DRAMCtrlParams* _p, int rank,
+             Channel& _channel);
 
-        const std::string name() const
-        {
-            return csprintf("%s_%d", memory.name(), rank);
-        }
+        const std::string name() const;
 
         /**
          * Kick off accounting for power and refresh states and
@@ -499,10 +511,7 @@ class DRAMCtrl : public AbstractMemory
          *
          * @return boolean indicating self-refresh exit should be scheduled
          */
-        bool forceSelfRefreshExit() const {
-            return (readEntries != 0) ||
-                   ((memory.busStateNext == WRITE) && (writeEntries != 0));
-        }
+        bool forceSelfRefreshExit() const;
 
         /**
          * Check if the current rank is idle and should enter a low-pwer state
@@ -689,18 +698,132 @@ class DRAMCtrl : public AbstractMemory
         BurstHelper* burstHelper;
         Bank& bankRef;
         Rank& rankRef;
+        Channel& channelRef;
+
+        /** Arrival order of the packet, set when it is queued */
+        uint64_t seqNum;
 
         DRAMPacket(PacketPtr _pkt, bool is_read, uint8_t _rank, uint8_t _bank,
                    uint32_t _row, uint16_t bank_id, Addr _addr,
-                   unsigned int _size, Bank& bank_ref, Rank& rank_ref)
+                   unsigned int _size, Bank& bank_ref, Rank& rank_ref,
+                   Channel& channel_ref)
             : entryTime(curTick()), readyTime(curTick()),
               pkt(_pkt), isRead(is_read), rank(_rank), bank(_bank), row(_row),
               bankId(bank_id), addr(_addr), size(_size), burstHelper(NULL),
-              bankRef(bank_ref), rankRef(rank_ref)
+              bankRef(bank_ref), rankRef(rank_ref), channelRef(channel_ref),
+              seqNum(0)
         { }
 
     };
 
+    /**
+     * Queued requests split by bank, indexed by bank id. Each bank
+     * queue is in arrival order.
+     */
+    typedef std::vector<std::deque<DRAMPacket*>> BankQueues;
+
+    /**
+     * A channel holds the queues, the data bus state and the ranks
+     * that are scheduled independently of any other channel served
+     * by the controller.
+     */
+    class Channel
+    {
+
+      public:
+
+        /** Index of the channel within the controller */
+        const uint8_t channel;
+
+        /** The main read and write queues */
+        std::deque<DRAMPacket*> readQueue;
+        std::deque<DRAMPacket*> writeQueue;
+
+        /**
+         * The read and write queues split by bank, so that the
+         * scheduler does not have to search the whole queue for
+         * requests to a given bank
+         */
+        BankQueues readBankQueues;
+        BankQueues writeBankQueues;
+
+        /**
+         * To avoid iterating over the write queue to check for
+         * overlapping transactions, maintain a set of burst addresses
+         * that are currently queued. Since we merge writes to the same
+         * location we never have more than one address to the same burst
+         * address.
+         */
+        std::unordered_set<Addr> isInWriteQueue;
+
+        /**
+         * Number of reads of the channel in the shared response
+         * queue, which count towards the read buffer of the channel
+         */
+        uint32_t respEntries;
+
+        /** The ranks of the channel */
+        std::vector<Rank*> ranks;
+
+        /**
+         * Remember if we have to retry a request when available.
+         */
+        bool retryRdReq;
+        bool retryWrReq;
+
+        BusState busState;
+
+        /* bus state for next request event triggered */
+        BusState busStateNext;
+
+        /**
+         * Till when has the data bus been spoken for already?
+         */
+        Tick busBusyUntil;
+
+        /**
+         * With burst interleaving, the time a burst to a different
+         * bank group can start its data transfer in the gap of the
+         * previous burst, MaxTick if there is no such gap.
+         */
+        Tick interleaveAt;
+
+        /**
+         * The soonest you have to start thinking about the next request
+         * is the longest access time that can occur before
+         * busBusyUntil. Assuming you need to precharge, open a new row,
+         * and access, it is tRP + tRCD + tCL.
+         */
+        Tick nextReqTime;
+
+        /** Holds the value of the rank of burst issued */
+        uint8_t activeRank;
+
+        uint32_t writesThisTime;
+        uint32_t readsThisTime;
+
+        /**
+         * When the scheduler is due to look at this channel, MaxTick
+         * if it is not.
+         */
+        Tick nextReqAt;
+
+        Channel(uint8_t _channel, unsigned int num_banks)
+            : channel(_channel), readBankQueues(num_banks),
+              writeBankQueues(num_banks), respEntries(0),
+              retryRdReq(false), retryWrReq(false),
+              busState(READ), busStateNext(READ), busBusyUntil(0),
+              interleaveAt(MaxTick), nextReqTime(0), activeRank(0),
+              writesThisTime(0), readsThisTime(0), nextReqAt(MaxTick)
+        { }
+
+        /** Earliest time the data bus can take another burst. */
+        Tick busFreeAt() const { return std::min(busBusyUntil, interleaveAt); }
+
+        /** Is the scheduler due to look at this channel? */
+        bool nextReqScheduled() const { return nextReqAt != MaxTick; }
+    };
+
     /**
      * Bunch of things requires to setup "events" in gem5
      * When event "respondEvent" occurs for example, the method
@@ -710,24 +833,46 @@ class DRAMCtrl : public AbstractMemory
     void processNextReqEvent();
     EventFunctionWrapper nextReqEvent;
 
+    /**
+     * Pick the next request out of the queues of a channel, and issue
+     * it, unless the channel is blocked. This is what the scheduling
+     * event does for every channel it is due to look at.
+     *
+     * @param channel The channel to schedule
+     */
+    void scheduleChannel(Channel& channel);
+
+    /**
+     * Make sure the scheduler looks at a channel at the given tick,
+     * unless it is already due to do so. All channels share the
+     * scheduling event, which is kept scheduled for the channel that
+     * is due first.
+     *
+     * @param channel The channel to look at
+     * @param when Tick when the channel should be looked at
+     */
+    void scheduleNextReq(Channel& channel, Tick when);
+
     void processRespondEvent();
     EventFunctionWrapper respondEvent;
 
     /**
      * Check if the read queue has room for more entries
      *
+     * @param channel The channel the entries are for
      * @param pktCount The number of entries needed in the read queue
      * @return true if read queue is full, false otherwise
      */
-    bool readQueueFull(unsigned int pktCount) const;
+    bool readQueueFull(const Channel& channel, unsigned int pktCount) const;
 
     /**
      * Check if the write queue has room for more entries
      *
+     * @param channel The channel the entries are for
      * @param pktCount The number of entries needed in the write queue
      * @return true if write queue is full, false otherwise
      */
-    bool writeQueueFull(unsigned int pktCount) const;
+    bool writeQueueFull(const Channel& channel, unsigned int pktCount) const;
 
     /**
      * When a new read comes in, first check if the write q has a
@@ -738,12 +883,14 @@ class DRAMCtrl : public AbstractMemory
      * read request in the system, schedule an event to start
      * servicing it.
      *
+     * @param channel The channel the packet is for
      * @param pkt The request packet from the outside world
      * @param pktCount The number of DRAM bursts the pkt
      * translate to. If pkt size is larger then one full burst,
      * then pktCount is greater than one.
      */
-    void addToReadQueue(PacketPtr pkt, unsigned int pktCount);
+    void addToReadQueue(Channel& channel, PacketPtr pkt,
+                        unsigned int pktCount);
 
     /**
      * Decode the incoming pkt, create a dram_pkt and push to the
@@ -751,12 +898,22 @@ class DRAMCtrl : public AbstractMemory
      * the threshold specified by the user, ie the queue is beginning
      * to get full, stop reads, and start draining writes.
      *
+     * @param channel The channel the packet is for
      * @param pkt The request packet from the outside world
      * @param pktCount The number of DRAM bursts the pkt
      * translate to. If pkt size is larger then one full burst,
      * then pktCount is greater than one.
      */
-    void addToWriteQueue(PacketPtr pkt, unsigned int pktCount);
+    void addToWriteQueue(Channel& channel, PacketPtr pkt,
+                         unsigned int pktCount);
+
+    /**
+     * Remove a scheduled packet from its bank queue.
+     *
+     * @param bank_queues Bank queues holding the packet
+     * @param dram_pkt The packet to remove
+     */
+    void removeFromBankQueue(BankQueues& bank_queues, DRAMPacket* dram_pkt);
 
     /**
      * Actually do the DRAM access - figure out the latency it
@@ -787,14 +944,25 @@ class DRAMCtrl : public AbstractMemory
      * system packet if the pakcet is larger than burst of the memory. The
      * dramPktAddr is used for the offset within the packet.
      *
+     * @param channel The channel the packet is for
      * @param pkt The packet from the outside world
      * @param dramPktAddr The starting address of the DRAM packet
      * @param size The size of the DRAM packet in bytes
      * @param isRead Is the request for a read or a write to DRAM
      * @return A DRAMPacket pointer with the decoded information
      */
-    DRAMPacket* decodeAddr(PacketPtr pkt, Addr dramPktAddr, unsigned int size,
-                           bool isRead);
+    DRAMPacket* decodeAddr(Channel& channel, PacketPtr pkt, Addr dramPktAddr,
+                           unsigned int size, bool isRead);
+
+    /**
+     * Find the channel serving an address. Like the crossbar would
+     * for separate controllers, the whole packet goes to the channel
+     * of its start address.
+     *
+     * @param addr The address of the packet
+     * @return The channel serving the address
+     */
+    Channel& decodeChannel(Addr addr);
 
     /**
      * The memory schduler/arbiter - picks which request needs to
@@ -803,35 +971,46 @@ class DRAMCtrl : public AbstractMemory
      * Prioritizes accesses to the same rank as previous burst unless
      * controller is switching command type.
      *
+     * @param channel The channel holding the queue
      * @param queue Queued requests to consider
+     * @param bank_queues The same requests, split by bank
      * @param extra_col_delay Any extra delay due to a read/write switch
      * @return true if a packet is scheduled to a rank which is available else
      * false
      */
-    bool chooseNext(std::deque<DRAMPacket*>& queue, Tick extra_col_delay);
+    bool chooseNext(const Channel& channel, std::deque<DRAMPacket*>& queue,
+                    const BankQueues& bank_queues, Tick extra_col_delay);
 
     /**
      * For FR-FCFS policy reorder the read/write queue depending on row buffer
-     * hits and earliest bursts available in DRAM
+     * hits and earliest bursts available in DRAM. Only the oldest row
+     * hit and the oldest row miss of each bank can be selected, so the
+     * search looks at the head of the bank queues rather than at every
+     * queued request.
      *
+     * @param channel The channel holding the queue
      * @param queue Queued requests to consider
+     * @param bank_queues The same requests, split by bank
      * @param extra_col_delay Any extra delay due to a read/write switch
      * @return true if a packet is scheduled to a rank which is available else
      * false
      */
-    bool reorderQueue(std::deque<DRAMPacket*>& queue, Tick extra_col_delay);
+    bool reorderQueue(const Channel& channel, std::deque<DRAMPacket*>& queue,
+                      const BankQueues& bank_queues, Tick extra_col_delay);
 
     /**
      * Find which are the earliest banks ready to issue an activate
      * for the enqueued requests. Assumes maximum of 64 banks per DIMM
      * Also checks if the bank is already prepped.
      *
-     * @param queue Queued requests to consider
+     * @param channel The channel holding the banks
+     * @param bank_queues Queued requests to consider, split by bank
      * @param time of seamless burst command
      * @return One-hot encoded mask of bank indices
      * @return boolean indicating burst can issue seamlessly, with no gaps
      */
-    std::pair<uint64_t, bool> minBankPrep(const std::deque<DRAMPacket*>& queue,
+    std::pair<uint64_t, bool> minBankPrep(const Channel& channel,
+                                          const BankQueues& bank_queues,
                                           Tick min_col_at) const;
 
     /**
@@ -876,32 +1055,35 @@ class DRAMCtrl : public AbstractMemory
     Addr burstAlign(Addr addr) const { return (addr & ~(Addr(burstSize - 1))); }
 
     /**
-     * The controller's main read and write queues
-     */
-    std::deque<DRAMPacket*> readQueue;
-    std::deque<DRAMPacket*> writeQueue;
-
-    /**
-     * To avoid iterating over the write queue to check for
-     * overlapping transactions, maintain a set of burst addresses
-     * that are currently queued. Since we merge writes to the same
-     * location we never have more than one address to the same burst
-     * address.
+     * Arrival order of the next queued DRAM packet, used to keep FCFS
+     * order across the bank queues
      */
-    std::unordered_set<Addr> isInWriteQueue;
+    uint64_t nextSeqNum;
 
     /**
      * Response queue where read packets wait after we're done working
      * with them, but it's not time to send the response yet. The
      * responses are stored seperately mostly to keep the code clean
      * and help with events scheduling. For all logical purposes such
-     * as sizing the read queue, this and the main read queue need to
-     * be added together.
+     * as sizing the read queue, this and the main read queue of the
+     * channel need to be added together. The queue is shared by all
+     * channels, and is kept in the order of the ready time.
      */
     std::deque<DRAMPacket*> respQueue;
 
     /**
-     * Vector of ranks
+     * The interleaved ranges of the channels, if the controller
+     * serves more than one channel
+     */
+    const std::vector<AddrRange> channelRanges;
+
+    /**
+     * The channels served by the controller
+     */
+    std::vector<Channel*> ctrlChannels;
+
+    /**
+     * Vector of ranks, across all channels
      */
     std::vector<Rank*> ranks;
 
@@ -923,6 +1105,7 @@ class DRAMCtrl : public AbstractMemory
     const uint32_t ranksPerChannel;
     const uint32_t bankGroupsPerRank;
     const bool bankGroupArch;
+    const bool burstInterleave;
     const uint32_t banksPerRank;
     const uint32_t channels;
     uint32_t rowsPerBank;
@@ -931,8 +1114,6 @@ class DRAMCtrl : public AbstractMemory
     const uint32_t writeHighThreshold;
     const uint32_t writeLowThreshold;
     const uint32_t minWritesPerSwitch;
-    uint32_t writesThisTime;
-    uint32_t readsThisTime;
 
     /**
      * Basic memory timing parameters initialized based on parameter
@@ -944,6 +1125,9 @@ class DRAMCtrl : public AbstractMemory
     const Tick tCS;
     const Tick tBURST;
     const Tick tCCD_L;
+    const Tick tCCD_L_WR;
+    const Tick tBURST_MIN;
+    const Tick tWCK_SYNC;
     const Tick tRCD;
     const Tick tCL;
     const Tick tRP;
@@ -987,21 +1171,8 @@ class DRAMCtrl : public AbstractMemory
      */
     const Tick backendLatency;
 
-    /**
-     * Till when has the main data bus been spoken for already?
-     */
-    Tick busBusyUntil;
-
     Tick prevArrival;
 
-    /**
-     * The soonest you have to start thinking about the next request
-     * is the longest access time that can occur before
-     * busBusyUntil. Assuming you need to precharge, open a new row,
-     * and access, it is tRP + tRCD + tCL.
-     */
-    Tick nextReqTime;
-
     // All statistics that the model needs to capture
     Stats::Scalar readReqs;
     Stats::Scalar writeReqs;
@@ -1062,9 +1233,6 @@ class DRAMCtrl : public AbstractMemory
     // DRAM Power Calculation
     Stats::Formula pageHitRate;
 
-    // Holds the value of the rank of burst issued
-    uint8_t activeRank;
-
     // timestamp offset
     uint64_t timeStampOffset;
 
@@ -1125,6 +1293,12 @@ class DRAMCtrl : public AbstractMemory
      */
     bool allRanksDrained() const;
 
+    /**
+     * Return true if the read and write queues of all channels are
+     * empty.
+     */
+    bool allQueuesEmpty() const;
+
   protected:
 
     Tick recvAtomic(PacketPtr pkt);
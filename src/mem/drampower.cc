@@ -85,6 +85,18 @@ DRAMPower::getTimingParams(const DRAMCtrlParams* p)
     timingSpec.RP = divCeil(p->tRP, p->tCK);
     timingSpec.RFC = divCeil(p->tRFC, p->tCK);
     timingSpec.RAS = divCeil(p->tRAS, p->tCK);
+    // Bank group timings are only used by the command scheduler of
+    // DRAMPower, but keep them consistent with the controller
+    timingSpec.CCD = divCeil(p->tBURST, p->tCK);
+    timingSpec.CCD_S = timingSpec.CCD;
+    timingSpec.CCD_L = divCeil(p->tCCD_L, p->tCK);
+    timingSpec.RRD = divCeil(p->tRRD, p->tCK);
+    timingSpec.RRD_S = timingSpec.RRD;
+    timingSpec.RRD_L = divCeil(p->tRRD_L, p->tCK);
+    timingSpec.FAW = divCeil(p->tXAW, p->tCK);
+    timingSpec.WTR = divCeil(p->tWTR, p->tCK);
+    timingSpec.WTR_S = timingSpec.WTR;
+    timingSpec.WTR_L = timingSpec.WTR;
     // Write latency is read latency - 1 cycle
     // Source: B.Jacob Memory Systems Cache, DRAM, Disk
     timingSpec.WL = timingSpec.RL - 1;
@@ -154,10 +166,14 @@ DRAMPower::hasTwoVDD(const DRAMCtrlParams* p)
 uint8_t
 DRAMPower::getDataRate(const DRAMCtrlParams* p)
 {
-    uint32_t burst_cycles = divCeil(p->tBURST, p->tCK);
+    // with burst interleaving the data is transferred in two halves
+    // of tBURST_MIN each
+    uint32_t burst_cycles = p->burst_interleave ?
+        2 * divCeil(p->tBURST_MIN, p->tCK) : divCeil(p->tBURST, p->tCK);
     uint8_t data_rate = p->burst_length / burst_cycles;
-    // 4 for GDDR5
-    if (data_rate != 1 && data_rate != 2 && data_rate != 4)
-        fatal("Got unexpected data rate %d, should be 1 or 2 or 4\n");
+    // 4 for GDDR5, 8 for LPDDR5 with a 4:1 data clock
+    if (data_rate != 1 && data_rate != 2 && data_rate != 4 && data_rate != 8)
+        fatal("Got unexpected data rate %d, should be 1, 2, 4 or 8\n",
+              data_rate);
     return data_rate;
 }
@@ -76,7 +76,7 @@ class DRAMPower
     static Data::MemPowerSpec getPowerParams(const DRAMCtrlParams* p);
 
     /**
-     * Determine data rate, either one or two.
+     * Determine the data rate in beats per clock cycle.
      */
     static uint8_t getDataRate(const DRAMCtrlParams* p);
 
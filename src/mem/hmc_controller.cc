@@ -6,6 +6,7 @@
 HMCController::HMCController(const HMCControllerParams* p) :
     NoncoherentXBar(p),
     n_master_ports(p->port_master_connection_count),
+    linkCredits(p->link_credits),
     rr_counter(0)
 {
     assert(p->port_slave_connection_count == 1);
@@ -39,6 +40,20 @@ int HMCController::rotate_counter()
     return current_value;
 }
 
+PortID HMCController::selectLink(PacketPtr pkt)
+{
+    for (int i = 0; i < n_master_ports; ++i) {
+        PortID link = (rr_counter + i) % n_master_ports;
+        if (reqLayers[link]->isFree() &&
+            masterPorts[link]->tryTiming(pkt)) {
+            rr_counter = (link + 1) % n_master_ports;
+            return link;
+        }
+    }
+
+    return rotate_counter();
+}
+
 bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
 {
     // determine the source port based on the id
@@ -49,7 +64,8 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
 
     // For now, this is a simple round robin counter, for distribution the
     //  load among the serial links
-    PortID master_port_id = rotate_counter();
+    PortID master_port_id = linkCredits ? selectLink(pkt) :
+        rotate_counter();
 
     // test if the layer should be considered occupied for the current
     // port
@@ -91,6 +91,9 @@ private:
 
     int n_master_ports;
 
+    /** Only send requests to serial links with space for them */
+    const bool linkCredits;
+
     // The round-robin counter
     int rr_counter;
     /**
@@ -98,6 +101,16 @@ private:
      * @return the next value of the counter
      */
     int rotate_counter();
+
+    /**
+     * Find the next serial link, in round robin order, that can accept
+     * a request. If none can, the next link in round robin order is
+     * returned anyway and the request is rejected by it.
+     *
+     * @param pkt Request to send
+     * @return Master port of the link
+     */
+    PortID selectLink(PacketPtr pkt);
 };
 
 #endif //__MEM_HMC_CONTROLLER_HH__
@@ -40,6 +40,7 @@
 
 #include "mem/mem_checker.hh"
 
+#include <algorithm>
 #include <cassert>
 
 void
@@ -65,14 +66,15 @@ MemChecker::WriteCluster::startWrite(MemChecker::Serial serial, Tick _start,
     }
 
     // Create new transaction, and denote completion time to be in the future.
-    writes.insert(std::make_pair(serial,
-                  MemChecker::Transaction(serial, _start, TICK_FUTURE, data)));
+    writes.emplace_back(serial, _start, TICK_FUTURE, data);
 }
 
 void
 MemChecker::WriteCluster::completeWrite(MemChecker::Serial serial, Tick _complete)
 {
-    auto it = writes.find(serial);
+    auto it = std::find_if(writes.begin(), writes.end(),
+                           [serial](const Transaction &t)
+                           { return t.serial == serial; });
 
     if (it == writes.end()) {
         warn("Could not locate write transaction: serial = %d, complete = %d\n",
@@ -81,8 +83,8 @@ MemChecker::WriteCluster::completeWrite(MemChecker::Serial serial, Tick _complet
     }
 
     // Record completion time of the write
-    assert(it->second.complete == TICK_FUTURE);
-    it->second.complete = _complete;
+    assert(it->complete == TICK_FUTURE);
+    it->complete = _complete;
 
     // Update max completion time for the cluster
     if (completeMax < _complete) {
@@ -103,10 +105,15 @@ MemChecker::WriteCluster::completeWrite(MemChecker::Serial serial, Tick _complet
 void
 MemChecker::WriteCluster::abortWrite(MemChecker::Serial serial)
 {
-    if (!writes.erase(serial)) {
+    auto it = std::find_if(writes.begin(), writes.end(),
+                           [serial](const Transaction &t)
+                           { return t.serial == serial; });
+
+    if (it == writes.end()) {
         warn("Could not locate write transaction: serial = %d\n", serial);
         return;
     }
+    writes.erase(it);
 
     if (--numIncomplete == 0 && !writes.empty()) {
         // This write cluster is now complete, and we can assign the current
@@ -122,14 +129,32 @@ MemChecker::WriteCluster::abortWrite(MemChecker::Serial serial)
 void
 MemChecker::ByteTracker::startRead(MemChecker::Serial serial, Tick start)
 {
-    outstandingReads.insert(std::make_pair(serial,
-            MemChecker::Transaction(serial, start, TICK_FUTURE)));
+    assert(outstandingReads.empty() ||
+           outstandingReads.back().serial < serial);
+    outstandingReads.emplace_back(serial, start, TICK_FUTURE);
+}
+
+bool
+MemChecker::ByteTracker::pristine() const
+{
+    if (!outstandingReads.empty() || readObservations.size() != 1 ||
+        readObservations.front().complete != TICK_INITIAL) {
+        return false;
+    }
+
+    for (const auto& cluster : writeClusters) {
+        if (!cluster.writes.empty())
+            return false;
+    }
+    return true;
 }
 
 bool
-MemChecker::ByteTracker::inExpectedData(Tick start, Tick complete, uint8_t data)
+MemChecker::ByteTracker::inExpectedData(Tick start, Tick complete,
+                                        uint8_t data,
+                                        std::vector<uint8_t> &expected)
 {
-    _lastExpectedData.clear();
+    expected.clear();
 
     bool wc_overlap = true;
 
@@ -142,8 +167,7 @@ MemChecker::ByteTracker::inExpectedData(Tick start, Tick complete, uint8_t data)
     // preceding & overlapping writes.
     for (auto cluster = writeClusters.rbegin();
          cluster != writeClusters.rend() && wc_overlap; ++cluster) {
-        for (const auto& addr_write : cluster->writes) {
-            const Transaction& write = addr_write.second;
+        for (const Transaction& write : cluster->writes) {
 
             if (write.complete < last_obs.start) {
                 // If this write transaction completed before the last
@@ -158,7 +182,7 @@ MemChecker::ByteTracker::inExpectedData(Tick start, Tick complete, uint8_t data)
             }
 
             // Record possible, but non-matching data for debugging
-            _lastExpectedData.push_back(write.data);
+            expected.push_back(write.data);
 
             if (write.complete > start) {
                 // This write overlapped with the transaction we want to check
@@ -194,7 +218,7 @@ MemChecker::ByteTracker::inExpectedData(Tick start, Tick complete, uint8_t data)
             return true;
         }
         // Record non-matching, but possible value
-        _lastExpectedData.push_back(last_obs.data);
+        expected.push_back(last_obs.data);
     } else {
         // We have not seen any valid observation, and the only writes
         // observed are overlapping, so anything (in particular the
@@ -208,11 +232,11 @@ MemChecker::ByteTracker::inExpectedData(Tick start, Tick complete, uint8_t data)
         }
     }
 
-    if (_lastExpectedData.empty()) {
+    if (expected.empty()) {
         assert(last_obs.complete == TICK_INITIAL);
         // We have not found any possible (non-matching data). Can happen in
         // initial system state
-        DPRINTF(MemChecker, "no last observation nor write! start = %d, "\
+        DPRINTFR(MemChecker, "no last observation nor write! start = %d, "\
                 "complete = %d, data = %#x\n", start, complete, data);
         return true;
     }
@@ -221,22 +245,26 @@ MemChecker::ByteTracker::inExpectedData(Tick start, Tick complete, uint8_t data)
 
 bool
 MemChecker::ByteTracker::completeRead(MemChecker::Serial serial,
-                                      Tick complete, uint8_t data)
+                                      Tick complete, uint8_t data,
+                                      std::vector<uint8_t> &expected)
 {
-    auto it = outstandingReads.find(serial);
+    auto it = std::lower_bound(outstandingReads.begin(),
+                               outstandingReads.end(), serial,
+                               [](const Transaction &t, Serial s)
+                               { return t.serial < s; });
 
-    if (it == outstandingReads.end()) {
+    if (it == outstandingReads.end() || it->serial != serial) {
         // Can happen if concurrent with reset_address_range
         warn("Could not locate read transaction: serial = %d, complete = %d\n",
              serial, complete);
         return true;
     }
 
-    Tick start = it->second.start;
+    Tick start = it->start;
     outstandingReads.erase(it);
 
     // Verify data
-    const bool result = inExpectedData(start, complete, data);
+    const bool result = inExpectedData(start, complete, data, expected);
 
     readObservations.emplace_back(serial, start, complete, data);
     pruneTransactions();
@@ -281,7 +309,7 @@ MemChecker::ByteTracker::pruneTransactions()
     // reads, we use curTick(), i.e. we will remove all readObservation except
     // the most recent one.
     const Tick before = outstandingReads.empty() ? curTick() :
-                        outstandingReads.begin()->second.start;
+                        outstandingReads.front().start;
 
     // Pruning of readObservations
     readObservations.erase(readObservations.begin(),
@@ -294,6 +322,52 @@ MemChecker::ByteTracker::pruneTransactions()
     }
 }
 
+void
+MemChecker::ByteTracker::trim()
+{
+    // Only give back storage if a burst of transactions left a lot of it
+    // unused, the common case is to reuse it for the next transactions.
+    const size_t slack = 16;
+
+    if (outstandingReads.capacity() > outstandingReads.size() + slack)
+        outstandingReads.shrink_to_fit();
+    if (readObservations.capacity() > readObservations.size() + slack)
+        readObservations.shrink_to_fit();
+    if (writeClusters.capacity() > writeClusters.size() + slack)
+        writeClusters.shrink_to_fit();
+}
+
+void
+MemChecker::LineTracker::reset(unsigned offset, unsigned size)
+{
+    assert(offset + size <= LINE_SIZE);
+
+    for (unsigned i = offset; i < offset + size; ++i) {
+        const uint64_t bit = 1ULL << i;
+        if (valid & bit) {
+            bytes[i].clear();
+            valid &= ~bit;
+        }
+    }
+}
+
+void
+MemChecker::LineTracker::collectGarbage()
+{
+    for (unsigned i = 0; i < LINE_SIZE; ++i) {
+        const uint64_t bit = 1ULL << i;
+        if (!(valid & bit) || !bytes[i].idle())
+            continue;
+
+        bytes[i].pruneTransactions();
+        if (bytes[i].pristine()) {
+            bytes[i].clear();
+            valid &= ~bit;
+        }
+        bytes[i].trim();
+    }
+}
+
 bool
 MemChecker::completeRead(MemChecker::Serial serial, Tick complete,
                          Addr addr, size_t size, uint8_t *data)
@@ -304,10 +378,9 @@ MemChecker::completeRead(MemChecker::Serial serial, Tick complete,
             "completing read: serial = %d, complete = %d, "
             "addr = %#llx, size = %d\n", serial, complete, addr, size);
 
-    for (size_t i = 0; i < size; ++i) {
-        ByteTracker *tracker = getByteTracker(addr + i);
-
-        if (!tracker->completeRead(serial, complete, data[i])) {
+    forEachByte(addr, size, [&](ByteTracker *tracker, size_t i) {
+        if (!tracker->completeRead(serial, complete, data[i],
+                                   expectedData)) {
             // Generate error message, and aggregate all failures for the bytes
             // considered in this transaction in one message.
             if (result) {
@@ -321,29 +394,66 @@ MemChecker::completeRead(MemChecker::Serial serial, Tick complete,
                                      "failed: received %#x, expected ",
                                      (unsigned long long)(addr + i), data[i]);
 
-            for (size_t j = 0; j < tracker->lastExpectedData().size(); ++j) {
+            for (size_t j = 0; j < expectedData.size(); ++j) {
                 errorMessage +=
-                    csprintf("%#x%s",
-                             tracker->lastExpectedData()[j],
-                             (j == tracker->lastExpectedData().size() - 1)
-                             ? "" : "|");
+                    csprintf("%#x%s", expectedData[j],
+                             (j == expectedData.size() - 1) ? "" : "|");
             }
         }
-    }
+    });
 
     if (!result) {
         DPRINTF(MemChecker, "read of %#llx @ cycle %d failed:\n%s\n", addr,
                 complete, errorMessage);
     }
 
+    maybeCollectGarbage();
+
     return result;
 }
 
 void
 MemChecker::reset(Addr addr, size_t size)
 {
-    for (size_t i = 0; i < size; ++i) {
-        byte_trackers.erase(addr + i);
+    size_t i = 0;
+    while (i < size) {
+        const Addr line_addr = (addr + i) & ~Addr(LINE_SIZE - 1);
+        const unsigned offset = addr + i - line_addr;
+        const unsigned len = std::min<size_t>(LINE_SIZE - offset, size - i);
+        i += len;
+
+        auto it = line_trackers.find(line_addr);
+        if (it == line_trackers.end())
+            continue;
+
+        it->second->reset(offset, len);
+        if (it->second->empty())
+            releaseLine(it);
+    }
+}
+
+void
+MemChecker::releaseLine(
+    std::unordered_map<Addr, std::unique_ptr<LineTracker>>::iterator it)
+{
+    assert(it->second->empty());
+
+    if (linePool.size() < MAX_POOLED_LINES)
+        linePool.push_back(std::move(it->second));
+    line_trackers.erase(it);
+}
+
+void
+MemChecker::collectGarbage()
+{
+    DPRINTF(MemChecker, "collecting garbage: %d lines tracked\n",
+            line_trackers.size());
+
+    for (auto it = line_trackers.begin(); it != line_trackers.end(); ) {
+        auto cur = it++;
+        cur->second->collectGarbage();
+        if (cur->second->empty())
+            releaseLine(cur);
     }
 }
 
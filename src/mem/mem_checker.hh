@@ -41,8 +41,8 @@
 #ifndef __MEM_MEM_CHECKER_HH__
 #define __MEM_MEM_CHECKER_HH__
 
-#include <list>
-#include <map>
+#include <array>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -182,40 +182,76 @@ class MemChecker : public SimObject
         Tick complete;  //!< Completion of last write in cluster
 
         /**
-         * Map of Serial --> Transaction of all writes in cluster; contains
-         * all, in-flight or already completed.
+         * All writes in cluster, in-flight or already completed. Clusters
+         * rarely hold more than a handful of writes, so a vector searched
+         * linearly is cheaper than a map.
          */
-        std::unordered_map<Serial, Transaction> writes;
+        std::vector<Transaction> writes;
 
       private:
         Tick completeMax;
         size_t numIncomplete;
     };
 
-    typedef std::list<Transaction> TransactionList;
-    typedef std::list<WriteCluster> WriteClusterList;
+    /**
+     * Transactions and write clusters are kept in vectors rather than lists.
+     * Pruning only ever removes a short prefix, and a cleared vector keeps
+     * its storage, so the records of a tracker are recycled instead of being
+     * allocated per transaction.
+     */
+    typedef std::vector<Transaction> TransactionList;
+    typedef std::vector<WriteCluster> WriteClusterList;
 
     /**
      * The ByteTracker keeps track of transactions for the *same byte* -- all
      * outstanding reads, the completed reads (and what they observed) and write
      * clusters (see WriteCluster).
      */
-    class ByteTracker : public Named
+    class ByteTracker
     {
       public:
 
-        ByteTracker(Addr addr = 0, const MemChecker *parent = NULL)
-            : Named((parent != NULL ? parent->name() : "") +
-                     csprintf(".ByteTracker@%#llx", addr))
+        /**
+         * Puts the tracker into its pristine state. The initial transaction
+         * has start == complete == TICK_INITIAL, indicating that there has
+         * been no real write to this location; therefore, upon checking, we
+         * do not expect any particular value.
+         */
+        void init()
+        {
+            clear();
+            readObservations.emplace_back(SERIAL_INITIAL, TICK_INITIAL,
+                                          TICK_INITIAL, DATA_INITIAL);
+        }
+
+        /**
+         * Drops all transactions, but keeps the storage allocated for them
+         * so that it can be reused.
+         */
+        void clear()
+        {
+            outstandingReads.clear();
+            readObservations.clear();
+            writeClusters.clear();
+        }
+
+        /**
+         * @return true if there are no outstanding reads nor writes.
+         */
+        bool idle() const
         {
-            // The initial transaction has start == complete == TICK_INITIAL,
-            // indicating that there has been no real write to this location;
-            // therefore, upon checking, we do not expect any particular value.
-            readObservations.emplace_back(
-                    Transaction(SERIAL_INITIAL, TICK_INITIAL, TICK_INITIAL,
-                                DATA_INITIAL));
+            return outstandingReads.empty() &&
+                (writeClusters.empty() || writeClusters.back().isComplete() ||
+                 writeClusters.back().writes.empty());
         }
 
+        /**
+         * @return true if the tracker is idle and holds no information about
+         *         the value of the byte, i.e. it is equivalent to a tracker
+         *         in its pristine state.
+         */
+        bool pristine() const;
+
         /**
          * Starts a read transaction.
          *
@@ -245,10 +281,15 @@ class MemChecker : public SimObject
          * @param start     Start time of transaction to validate.
          * @param complete  End time of transaction to validate.
          * @param data      The value that we have actually seen.
+         * @param expected  Filled with the expected data iterated through. If
+         *                  the function returns true, the set may be
+         *                  incomplete; if it returns false, the vector will
+         *                  contain the full set.
          *
          * @return          True if a match is found, false otherwise.
          */
-        bool inExpectedData(Tick start, Tick complete, uint8_t data);
+        bool inExpectedData(Tick start, Tick complete, uint8_t data,
+                            std::vector<uint8_t> &expected);
 
         /**
          * Completes a read transaction that is still outstanding.
@@ -256,8 +297,10 @@ class MemChecker : public SimObject
          * @param serial   Unique identifier of a read *previously started*.
          * @param complete When the read got a response.
          * @param data     The data returned by the memory subsystem.
+         * @param expected See inExpectedData().
          */
-        bool completeRead(Serial serial, Tick complete, uint8_t data);
+        bool completeRead(Serial serial, Tick complete, uint8_t data,
+                          std::vector<uint8_t> &expected);
 
         /**
          * Starts a write transaction. Wrapper to startWrite of WriteCluster
@@ -288,16 +331,20 @@ class MemChecker : public SimObject
         void abortWrite(Serial serial);
 
         /**
-         * This function returns the expected data that inExpectedData iterated
-         * through in the last call. If inExpectedData last returned true, the
-         * set may be incomplete; if inExpectedData last returned false, the
-         * vector will contain the full set.
+         * Prunes no longer needed transactions. We only keep up to the last /
+         * most recent of each, readObservations and writeClusters, before the
+         * first outstanding read.
          *
-         * @return Reference to internally maintained vector maintaining last
-         *         expected data that inExpectedData iterated through.
+         * It depends on the contention / overlap between memory operations to
+         * the same location of a particular workload how large each of them
+         * would grow.
          */
-        const std::vector<uint8_t>& lastExpectedData() const
-        { return _lastExpectedData; }
+        void pruneTransactions();
+
+        /**
+         * Releases excess storage left behind by a burst of transactions.
+         */
+        void trim();
 
       private:
 
@@ -333,26 +380,14 @@ class MemChecker : public SimObject
             return it;
         }
 
-        /**
-         * Prunes no longer needed transactions. We only keep up to the last /
-         * most recent of each, readObservations and writeClusters, before the
-         * first outstanding read.
-         *
-         * It depends on the contention / overlap between memory operations to
-         * the same location of a particular workload how large each of them
-         * would grow.
-         */
-        void pruneTransactions();
-
       private:
 
         /**
-         * Maintains a map of Serial -> Transaction for all outstanding reads.
-         *
-         * Use an ordered map here, as this makes pruneTransactions() more
-         * efficient (find first outstanding read).
+         * All outstanding reads, ordered by serial. Serials are handed out
+         * in increasing order, so new reads are simply appended, and the
+         * first element is the oldest read (see pruneTransactions()).
          */
-        std::map<Serial, Transaction> outstandingReads;
+        TransactionList outstandingReads;
 
         /**
          * List of completed reads, i.e. observations of reads.
@@ -363,18 +398,68 @@ class MemChecker : public SimObject
          * List of write clusters for this address.
          */
         WriteClusterList writeClusters;
+    };
+
+    /**
+     * Number of bytes tracked together by a LineTracker. Must not exceed the
+     * width of the LineTracker byte mask.
+     */
+    static const unsigned LINE_SIZE = 64;
+
+    /**
+     * The LineTracker groups the ByteTrackers of one aligned line, so that an
+     * access only needs a single lookup per line it touches. A byte mask
+     * records which of the trackers are in use; the others are in pristine
+     * state and are initialised upon first access.
+     */
+    class LineTracker
+    {
+      public:
+        LineTracker() : valid(0) {}
 
         /**
-         * See lastExpectedData().
+         * Returns the tracker of the byte at the given offset into the line,
+         * initialising it if it is not yet in use.
          */
-        std::vector<uint8_t> _lastExpectedData;
+        ByteTracker* getByteTracker(unsigned offset)
+        {
+            const uint64_t bit = 1ULL << offset;
+            if (!(valid & bit)) {
+                bytes[offset].init();
+                valid |= bit;
+            }
+            return &bytes[offset];
+        }
+
+        /**
+         * Returns a range of bytes to their pristine state.
+         */
+        void reset(unsigned offset, unsigned size);
+
+        /**
+         * Prunes and trims all idle byte trackers, and returns the ones
+         * without any useful information to their pristine state.
+         */
+        void collectGarbage();
+
+        /**
+         * @return true if none of the bytes in the line are in use.
+         */
+        bool empty() const { return valid == 0; }
+
+      private:
+        uint64_t valid;
+        std::array<ByteTracker, LINE_SIZE> bytes;
     };
 
+    static_assert(LINE_SIZE <= 64, "LineTracker byte mask is too narrow");
+
   public:
 
     MemChecker(const MemCheckerParams *p)
         : SimObject(p),
-          nextSerial(SERIAL_INITIAL)
+          nextSerial(SERIAL_INITIAL),
+          gcInterval(p->gc_interval), opsSinceGc(0)
     {}
 
     virtual ~MemChecker() {}
@@ -450,7 +535,7 @@ class MemChecker : public SimObject
      * the reset with serial S.
      */
     void reset()
-    { byte_trackers.clear(); }
+    { line_trackers.clear(); }
 
     /**
      * Resets an address-range. This may be useful in case other unmonitored
@@ -475,17 +560,67 @@ class MemChecker : public SimObject
 
   private:
     /**
-     * Returns the instance of ByteTracker for the requested location.
+     * Returns the instance of LineTracker for the requested line address,
+     * taking one from the pool if the line is not tracked yet.
      */
-    ByteTracker* getByteTracker(Addr addr)
+    LineTracker* getLineTracker(Addr line_addr)
     {
-        auto it = byte_trackers.find(addr);
-        if (it == byte_trackers.end()) {
-            it = byte_trackers.insert(
-                std::make_pair(addr, ByteTracker(addr, this))).first;
+        auto it = line_trackers.find(line_addr);
+        if (it == line_trackers.end()) {
+            std::unique_ptr<LineTracker> line;
+            if (linePool.empty()) {
+                line.reset(new LineTracker);
+            } else {
+                line = std::move(linePool.back());
+                linePool.pop_back();
+            }
+            it = line_trackers.emplace(line_addr, std::move(line)).first;
         }
-        return &it->second;
-    };
+        return it->second.get();
+    }
+
+    /**
+     * Calls f(tracker, i) for the ByteTracker of every byte i in the range,
+     * looking up each line only once.
+     */
+    template <typename F>
+    void forEachByte(Addr addr, size_t size, F f)
+    {
+        size_t i = 0;
+        while (i < size) {
+            const Addr line_addr = (addr + i) & ~Addr(LINE_SIZE - 1);
+            unsigned offset = addr + i - line_addr;
+            LineTracker *line = getLineTracker(line_addr);
+            for (; offset < LINE_SIZE && i < size; ++offset, ++i) {
+                f(line->getByteTracker(offset), i);
+            }
+        }
+    }
+
+    /**
+     * Stops tracking a line that has no bytes in use any more, and keeps
+     * the tracker for reuse.
+     */
+    void releaseLine(
+        std::unordered_map<Addr, std::unique_ptr<LineTracker>>::iterator it);
+
+    /**
+     * Counts completed transactions and runs collectGarbage() every
+     * gcInterval of them.
+     */
+    void maybeCollectGarbage()
+    {
+        if (gcInterval && ++opsSinceGc >= gcInterval) {
+            opsSinceGc = 0;
+            collectGarbage();
+        }
+    }
+
+    /**
+     * Prunes all trackers that have not seen any recent activity, and stops
+     * tracking lines that no longer hold any useful information.
+     */
+    void collectGarbage();
 
   private:
     /**
@@ -500,7 +635,23 @@ class MemChecker : public SimObject
     Serial nextSerial;
 
     /**
-     * Maintain a map of address --> byte-tracker. Per-byte entries are
+     * Number of completed transactions between garbage collection passes; 0
+     * disables periodic garbage collection.
+     */
+    const unsigned gcInterval;
+
+    /**
+     * Completed transactions since the last garbage collection pass.
+     */
+    unsigned opsSinceGc;
+
+    /**
+     * Scratch space for the expected data of a byte in completeRead.
+     */
+    std::vector<uint8_t> expectedData;
+
+    /**
+     * Maintain a map of line address --> line-tracker. Per-line entries are
      * initialized as needed.
      *
      * The required space for this obviously grows with the number of distinct
@@ -508,9 +659,20 @@ class MemChecker : public SimObject
      * the number of nodes in the system, those may affect the size of per-byte
      * tracking information.
      *
-     * Access via getByteTracker()!
+     * Access via getLineTracker()!
+     */
+    std::unordered_map<Addr, std::unique_ptr<LineTracker>> line_trackers;
+
+    /**
+     * Line trackers no longer in use, kept around together with the storage
+     * of their byte trackers to avoid reallocating them.
+     */
+    std::vector<std::unique_ptr<LineTracker>> linePool;
+
+    /**
+     * Upper bound on the size of linePool.
      */
-    std::unordered_map<Addr, ByteTracker> byte_trackers;
+    static const size_t MAX_POOLED_LINES = 256;
 };
 
 inline MemChecker::Serial
@@ -520,9 +682,10 @@ MemChecker::startRead(Tick start, Addr addr, size_t size)
             "starting read: serial = %d, start = %d, addr = %#llx, "
             "size = %d\n", nextSerial, start, addr , size);
 
-    for (size_t i = 0; i < size; ++i) {
-        getByteTracker(addr + i)->startRead(nextSerial, start);
-    }
+    const Serial serial = nextSerial;
+    forEachByte(addr, size, [serial, start](ByteTracker *tracker, size_t i) {
+        tracker->startRead(serial, start);
+    });
 
     return nextSerial++;
 }
@@ -534,9 +697,11 @@ MemChecker::startWrite(Tick start, Addr addr, size_t size, const uint8_t *data)
             "starting write: serial = %d, start = %d, addr = %#llx, "
             "size = %d\n", nextSerial, start, addr, size);
 
-    for (size_t i = 0; i < size; ++i) {
-        getByteTracker(addr + i)->startWrite(nextSerial, start, data[i]);
-    }
+    const Serial serial = nextSerial;
+    forEachByte(addr, size, [serial, start, data](ByteTracker *tracker,
+                                                  size_t i) {
+        tracker->startWrite(serial, start, data[i]);
+    });
 
     return nextSerial++;
 }
@@ -549,9 +714,11 @@ MemChecker::completeWrite(MemChecker::Serial serial, Tick complete,
             "completing write: serial = %d, complete = %d, "
             "addr = %#llx, size = %d\n", serial, complete, addr, size);
 
-    for (size_t i = 0; i < size; ++i) {
-        getByteTracker(addr + i)->completeWrite(serial, complete);
-    }
+    forEachByte(addr, size, [serial, complete](ByteTracker *tracker,
+                                               size_t i) {
+        tracker->completeWrite(serial, complete);
+    });
+    maybeCollectGarbage();
 }
 
 inline void
@@ -561,9 +728,10 @@ MemChecker::abortWrite(MemChecker::Serial serial, Addr addr, size_t size)
             "aborting write: serial = %d, addr = %#llx, size = %d\n",
             serial, addr, size);
 
-    for (size_t i = 0; i < size; ++i) {
-        getByteTracker(addr + i)->abortWrite(serial);
-    }
+    forEachByte(addr, size, [serial](ByteTracker *tracker, size_t i) {
+        tracker->abortWrite(serial);
+    });
+    maybeCollectGarbage();
 }
 
 #endif // __MEM_MEM_CHECKER_HH__
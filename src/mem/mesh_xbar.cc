@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definition of a mesh interconnect for the classic memory system.
+ */
+
+#include "mem/mesh_xbar.hh"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "base/logging.hh"
+
+MeshXBar::MeshXBar(const MeshXBarParams *p)
+    : CoherentXBar(p), rows(p->rows), columns(p->columns),
+      torus(p->torus), hopLatency(p->hop_latency)
+{
+    fatal_if(rows == 0 || columns == 0,
+             "%s needs at least one row and column\n", name());
+
+    // the snoop response ports mirror the slave ports, and share
+    // their stops
+    assignStops(slavePorts, p->slave_stops, "slave");
+    assignStops(snoopRespPorts, p->slave_stops, "slave");
+    assignStops(masterPorts, p->master_stops, "master");
+}
+
+template <typename PortType>
+void
+MeshXBar::assignStops(const std::vector<PortType*> &ports,
+                      const std::vector<unsigned> &stops,
+                      const char *kind)
+{
+    const unsigned num_stops = rows * columns;
+
+    fatal_if(!stops.empty() && stops.size() != ports.size(),
+             "%s has %d %s ports but %d %s stops\n", name(), ports.size(),
+             kind, stops.size(), kind);
+
+    for (size_t i = 0; i < ports.size(); ++i) {
+        const unsigned stop = stops.empty() ?
+            i * num_stops / ports.size() : stops[i];
+        fatal_if(stop >= num_stops, "%s %s port %d at stop %d beyond the "
+                 "%d stops\n", name(), kind, i, stop, num_stops);
+        portStops[ports[i]] = stop;
+    }
+}
+
+unsigned
+MeshXBar::hops(unsigned src_stop, unsigned dst_stop) const
+{
+    unsigned dx = std::abs(int(src_stop % columns) - int(dst_stop % columns));
+    unsigned dy = std::abs(int(src_stop / columns) - int(dst_stop / columns));
+
+    if (torus) {
+        dx = std::min(dx, columns - dx);
+        dy = std::min(dy, rows - dy);
+    }
+
+    return dx + dy;
+}
+
+Cycles
+MeshXBar::routeLatency(const Port &src, const Port &dst) const
+{
+    const auto src_stop = portStops.find(&src);
+    const auto dst_stop = portStops.find(&dst);
+    assert(src_stop != portStops.end() && dst_stop != portStops.end());
+
+    return Cycles(hops(src_stop->second, dst_stop->second) * hopLatency);
+}
+
+MeshXBar *
+MeshXBarParams::create()
+{
+    return new MeshXBar(this);
+}
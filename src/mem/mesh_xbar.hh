@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a mesh interconnect for the classic memory system.
+ */
+
+#ifndef __MEM_MESH_XBAR_HH__
+#define __MEM_MESH_XBAR_HH__
+
+#include <unordered_map>
+#include <vector>
+
+#include "mem/coherent_xbar.hh"
+#include "params/MeshXBar.hh"
+
+/**
+ * A coherent interconnect where the ports connect at the stops of a
+ * two-dimensional mesh, rather than at a single point. Packets pay
+ * for the number of hops between the stop they enter at and the stop
+ * they leave from, using dimension-ordered routing. With wrap-around
+ * links the mesh becomes a torus, and a single row torus is a ring.
+ *
+ * The arbitration and flow control is that of the CoherentXBar, with
+ * one layer per destination port, and thus per stop. Last-level
+ * cache slices connected to the master ports are selected by their
+ * (interleaved) address ranges, and the snoop filter is looked up at
+ * the stop of the slice the address maps to, i.e. it is distributed
+ * with the slices.
+ */
+class MeshXBar : public CoherentXBar
+{
+  public:
+
+    MeshXBar(const MeshXBarParams *p);
+
+    /**
+     * Number of hops between two stops of the mesh.
+     */
+    unsigned hops(unsigned src_stop, unsigned dst_stop) const;
+
+  protected:
+
+    Cycles routeLatency(const Port &src, const Port &dst) const override;
+
+  private:
+
+    /**
+     * Assign the ports of one kind to stops, either as given, or by
+     * spreading them over the stops in contiguous blocks so that
+     * neighbouring ports (e.g. the L1 caches of one core) share a
+     * stop.
+     *
+     * @param ports The ports in connection order
+     * @param stops Stop of each port, or empty for the default
+     * @param kind Port kind for error messages
+     */
+    template <typename PortType>
+    void assignStops(const std::vector<PortType*> &ports,
+                     const std::vector<unsigned> &stops,
+                     const char *kind);
+
+    /** Number of rows of the mesh. */
+    const unsigned rows;
+
+    /** Number of columns (stops per row) of the mesh. */
+    const unsigned columns;
+
+    /** Are there wrap-around links at the edges? */
+    const bool torus;
+
+    /** Latency of a hop between neighbouring stops. */
+    const Cycles hopLatency;
+
+    /** The stop every port connects at. */
+    std::unordered_map<const Port*, unsigned> portStops;
+};
+
+#endif //__MEM_MESH_XBAR_HH__
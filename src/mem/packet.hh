@@ -53,14 +53,18 @@
 #ifndef __MEM_PACKET_HH__
 #define __MEM_PACKET_HH__
 
+#include <atomic>
 #include <bitset>
 #include <cassert>
+#include <cstring>
 #include <list>
+#include <new>
 
 #include "base/cast.hh"
 #include "base/compiler.hh"
 #include "base/flags.hh"
 #include "base/logging.hh"
+#include "base/pool_alloc.hh"
 #include "base/printable.hh"
 #include "base/types.hh"
 #include "mem/request.hh"
@@ -299,6 +303,17 @@ class Packet : public Printable
         /// the packet is destroyed. The pointer is assumed to be pointing
         /// to an array, and delete [] is consequently called
         DYNAMIC_DATA           = 0x00002000,
+        /// The data pointer points to a buffer from the packet data
+        /// pool, which is returned to the pool when the packet is
+        /// destroyed. See allocate().
+        POOLED_DATA            = 0x00004000,
+        /// The data pointer points to a reference counted, copy on
+        /// write buffer that may be shared with other packets. See
+        /// allocateShared() and shareData().
+        SHARED_DATA            = 0x00020000,
+        /// The packet holds data, regardless of who owns it.
+        HAS_DATA               = STATIC_DATA | DYNAMIC_DATA | POOLED_DATA |
+                                 SHARED_DATA,
 
         /// suppress the error if this packet encounters a functional
         /// access failure.
@@ -311,7 +326,98 @@ class Packet : public Printable
 
     Flags flags;
 
+    struct DataTag {};
+
+    /**
+     * Header of a shared data buffer. The header is placed right in
+     * front of the payload, so that the data pointer of every packet
+     * sharing the buffer also identifies the buffer.
+     */
+    struct SharedData
+    {
+        static const size_t HeaderSize = 16;
+
+        std::atomic<uint32_t> refs;
+        const uint32_t size;
+
+        explicit SharedData(uint32_t size) : refs(1), size(size) {}
+
+        static SharedData *
+        create(unsigned size)
+        {
+            void *p = DataPool::allocate(HeaderSize + size);
+            return new (p) SharedData(size);
+        }
+
+        static SharedData *
+        of(PacketDataPtr data)
+        {
+            return reinterpret_cast<SharedData *>(data - HeaderSize);
+        }
+
+        PacketDataPtr
+        bytes()
+        {
+            return reinterpret_cast<PacketDataPtr>(this) + HeaderSize;
+        }
+
+        void
+        release()
+        {
+            if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                const size_t total = HeaderSize + size;
+                this->~SharedData();
+                DataPool::deallocate(this, total);
+            }
+        }
+    };
+
+    static_assert(sizeof(SharedData) <= SharedData::HeaderSize,
+                  "Shared data header does not fit in front of the payload");
+
+    /**
+     * Make sure this packet is the only user of its shared buffer,
+     * moving to a private copy of the data if needed.
+     *
+     * @param keep_data Copy the current contents to the private buffer
+     */
+    void
+    makeExclusive(bool keep_data)
+    {
+        SharedData *shared = SharedData::of(data);
+        if (shared->refs.load(std::memory_order_acquire) == 1)
+            return;
+
+        PacketDataPtr copy = static_cast<PacketDataPtr>(
+            DataPool::allocate(getSize()));
+        if (keep_data)
+            std::memcpy(copy, data, getSize());
+        shared->release();
+
+        flags.clear(SHARED_DATA);
+        flags.set(POOLED_DATA);
+        data = copy;
+    }
+
   public:
+    /**
+     * @{
+     * Packets and their payloads are allocated from thread-local
+     * free-list pools (see PoolAllocator), since memory-bound
+     * workloads create and destroy packets for every single access.
+     */
+    typedef PoolAllocator<Packet> Pool;
+    typedef PoolAllocator<DataTag, 4096, 16> DataPool;
+
+    static void *operator new(size_t size) { return Pool::allocate(size); }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        Pool::deallocate(p, size);
+    }
+    /** @} */
+
     typedef MemCmd::Command Command;
 
     /// The command field of the packet.
@@ -392,12 +498,26 @@ class Packet : public Printable
      * back. For this reason, the predecessor should always be
      * populated with the current SenderState of a packet before
      * modifying the senderState field in the request packet.
+     *
+     * Sender states are pushed and popped at every hop, so they are
+     * allocated from a thread-local pool shared by all subclasses
+     * rather than from the heap.
      */
     struct SenderState
     {
         SenderState* predecessor;
         SenderState() : predecessor(NULL) {}
         virtual ~SenderState() {}
+
+        typedef PoolAllocator<SenderState> Pool;
+
+        static void *operator new(size_t size) { return Pool::allocate(size); }
+
+        static void
+        operator delete(void *p, size_t size)
+        {
+            Pool::deallocate(p, size);
+        }
     };
 
     /**
@@ -959,7 +1079,7 @@ class Packet : public Printable
     void
     dataStatic(T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(HAS_DATA));
         data = (PacketDataPtr)p;
         flags.set(STATIC_DATA);
     }
@@ -976,7 +1096,7 @@ class Packet : public Printable
     void
     dataStaticConst(const T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(HAS_DATA));
         data = const_cast<PacketDataPtr>(p);
         flags.set(STATIC_DATA);
     }
@@ -997,7 +1117,7 @@ class Packet : public Printable
     void
     dataDynamic(T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(HAS_DATA));
         data = (PacketDataPtr)p;
         flags.set(DYNAMIC_DATA);
     }
@@ -1009,7 +1129,10 @@ class Packet : public Printable
     T*
     getPtr()
     {
-        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.isSet(HAS_DATA));
+        // the caller may write to the data, so stop sharing it
+        if (flags.isSet(SHARED_DATA))
+            makeExclusive(true);
         return (T*)data;
     }
 
@@ -1017,7 +1140,7 @@ class Packet : public Printable
     const T*
     getConstPtr() const
     {
-        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.isSet(HAS_DATA));
         return (const T*)data;
     }
 
@@ -1077,12 +1200,48 @@ class Packet : public Printable
         // we should never be copying data onto itself, which means we
         // must idenfity packets with static data, as they carry the
         // same pointer from source to destination and back
-        assert(p != getPtr<uint8_t>() || flags.isSet(STATIC_DATA));
+        assert(p != getConstPtr<uint8_t>() ||
+               flags.isSet(STATIC_DATA | SHARED_DATA));
+
+        if (p != getConstPtr<uint8_t>()) {
+            // the current contents are overwritten, so there is no
+            // need to copy them when we stop sharing the buffer
+            if (flags.isSet(SHARED_DATA))
+                makeExclusive(false);
 
-        if (p != getPtr<uint8_t>())
             // for packet with allocated dynamic data, we copy data from
             // one to the other, e.g. a forwarded response to a response
             std::memcpy(getPtr<uint8_t>(), p, getSize());
+        }
+    }
+
+    /**
+     * Take the data of another packet for the same address. If the
+     * other packet holds a shared buffer, this packet references the
+     * same buffer instead of copying it, and either packet gets a
+     * private copy as soon as it is written to. Otherwise, and if
+     * this packet points to static data that the requester expects
+     * to be filled in, the data is copied as with setData().
+     */
+    void
+    shareData(const PacketPtr other)
+    {
+        assert(getAddr() == other->getAddr());
+        assert(getSize() <= other->getSize());
+
+        if (!other->flags.isSet(SHARED_DATA) || flags.isSet(STATIC_DATA)) {
+            setData(other->getConstPtr<uint8_t>());
+            return;
+        }
+
+        if (data == other->data)
+            return;
+
+        deleteData();
+        SharedData::of(other->data)->refs.fetch_add(
+            1, std::memory_order_relaxed);
+        data = other->data;
+        flags.set(SHARED_DATA);
     }
 
     /**
@@ -1123,21 +1282,46 @@ class Packet : public Printable
     {
         if (flags.isSet(DYNAMIC_DATA))
             delete [] data;
+        else if (flags.isSet(POOLED_DATA))
+            DataPool::deallocate(data, getSize());
+        else if (flags.isSet(SHARED_DATA))
+            SharedData::of(data)->release();
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA);
+        flags.clear(HAS_DATA);
         data = NULL;
     }
 
-    /** Allocate memory for the packet. */
+    /**
+     * Allocate memory for the packet. The buffer comes from a pool of
+     * size-classed buffers that are recycled when the packet is
+     * destroyed, which avoids a trip to the heap for the common
+     * case of cache line sized payloads.
+     */
     void
     allocate()
     {
         // if either this command or the response command has a data
         // payload, actually allocate space
         if (hasData() || hasRespData()) {
-            assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
-            flags.set(DYNAMIC_DATA);
-            data = new uint8_t[getSize()];
+            assert(flags.noneSet(HAS_DATA));
+            flags.set(POOLED_DATA);
+            data = static_cast<PacketDataPtr>(
+                DataPool::allocate(getSize()));
+        }
+    }
+
+    /**
+     * Allocate a shared buffer for the packet. Packets allocated this
+     * way can hand their data to other packets with shareData()
+     * without copying it, e.g., when a response is forwarded.
+     */
+    void
+    allocateShared()
+    {
+        if (hasData() || hasRespData()) {
+            assert(flags.noneSet(HAS_DATA));
+            flags.set(SHARED_DATA);
+            data = SharedData::create(getSize())->bytes();
         }
     }
 
@@ -43,16 +43,23 @@
 
 #include "mem/packet_queue.hh"
 
+#include <algorithm>
+#include <iterator>
+
+#include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/Drain.hh"
 #include "debug/PacketQueue.hh"
 
 using namespace std;
 
+size_t PacketQueue::sizeWarning = 100;
+
 PacketQueue::PacketQueue(EventManager& _em, const std::string& _label,
                          const std::string& _sendEventName,
                          bool disable_sanity_check)
-    : em(_em), sendEvent([this]{ processSendEvent(); }, _sendEventName),
+    : transmitListSorted(true), nextSizeWarning(0),
+      em(_em), sendEvent([this]{ processSendEvent(); }, _sendEventName),
       _disableSanityCheck(disable_sanity_check),
       label(_label), waitingOnRetry(false)
 {
@@ -118,14 +125,20 @@ PacketQueue::schedSendTiming(PacketPtr pkt, Tick when, bool force_order)
 
     // add a very basic sanity check on the port to ensure the
     // invisible buffer is not growing beyond reasonable limits
-    if (!_disableSanityCheck && transmitList.size() > 100) {
-        panic("Packet queue %s has grown beyond 100 packets\n",
-              name());
+    if (!_disableSanityCheck && sizeWarning) {
+        if (!nextSizeWarning)
+            nextSizeWarning = sizeWarning;
+        if (transmitList.size() > nextSizeWarning) {
+            warn("Packet queue %s has grown to %d packets\n",
+                 name(), transmitList.size());
+            nextSizeWarning *= 2;
+        }
     }
 
     // nothing on the list
     if (transmitList.empty()) {
         transmitList.emplace_front(when, pkt);
+        transmitListSorted = true;
         schedSendEvent(when);
         return;
     }
@@ -138,19 +151,48 @@ PacketQueue::schedSendTiming(PacketPtr pkt, Tick when, bool force_order)
     // ourselves again before we had a chance to update waitingOnRetry
     // assert(waitingOnRetry || sendEvent.scheduled());
 
+    // the common case is a packet that goes at the end
+    if (when >= transmitList.back().tick) {
+        transmitList.emplace_back(when, pkt);
+        return;
+    }
+
     // this belongs in the middle somewhere, so search from the end to
     // order by tick; however, if force_order is set, also make sure
     // not to re-order in front of some existing packet with the same
-    // address
+    // address. Note that the packet is never put in front of the
+    // head of the list.
     auto i = transmitList.end();
-    --i;
-    while (i != transmitList.begin() && when < i->tick &&
-           !(force_order && i->pkt->getAddr() == pkt->getAddr()))
+    if (transmitListSorted && !force_order) {
+        // without address constraints, and with all packets in tick
+        // order, the search from the end ends after the last packet
+        // that is due no later than this one
+        i = std::upper_bound(transmitList.begin() + 1, transmitList.end(),
+                             when, [](Tick t, const DeferredPacket &dp) {
+                                 return t < dp.tick; });
+    } else {
         --i;
+        while (i != transmitList.begin() && when < i->tick &&
+               !(force_order && i->pkt->getAddr() == pkt->getAddr()))
+            --i;
+
+        // emplace inserts the element before the position pointed to
+        // by the iterator, so advance it one step
+        ++i;
+    }
+
+    insertDeferred(i, when, pkt);
+}
+
+void
+PacketQueue::insertDeferred(DeferredPacketList::iterator pos,
+                            Tick when, PacketPtr pkt)
+{
+    if ((pos != transmitList.begin() && when < std::prev(pos)->tick) ||
+        (pos != transmitList.end() && pos->tick < when))
+        transmitListSorted = false;
 
-    // emplace inserts the element before the position pointed to by
-    // the iterator, so advance it one step
-    transmitList.emplace(++i, when, pkt);
+    transmitList.emplace(pos, when, pkt);
 }
 
 void
@@ -215,7 +257,7 @@ PacketQueue::sendDeferredPacket()
         schedSendEvent(deferredPacketReadyTime());
     } else {
         // put the packet back at the front of the list
-        transmitList.emplace_front(dp);
+        insertDeferred(transmitList.begin(), dp.tick, dp.pkt);
     }
 }
 
@@ -52,7 +52,7 @@
  * for the flow control of the port.
  */
 
-#include <list>
+#include <deque>
 
 #include "mem/port.hh"
 #include "sim/drain.hh"
@@ -75,11 +75,30 @@ class PacketQueue : public Drainable
         {}
     };
 
-    typedef std::list<DeferredPacket> DeferredPacketList;
+    typedef std::deque<DeferredPacket> DeferredPacketList;
 
-    /** A list of outgoing packets. */
+    /**
+     * A list of outgoing packets. Packets are normally added in tick
+     * order, which makes adding them an append at the back, and the
+     * deque keeps them in contiguous chunks rather than in
+     * individually allocated list nodes.
+     */
     DeferredPacketList transmitList;
 
+    /**
+     * Is the transmit list sorted by tick? Forced ordering of packets
+     * to the same address can break the order, and as long as it is
+     * broken, the insertion point has to be found by a linear search.
+     */
+    bool transmitListSorted;
+
+    /** Transmit list size that triggers the next size warning. */
+    size_t nextSizeWarning;
+
+    /** Insert a packet and keep track of the ordering. */
+    void insertDeferred(DeferredPacketList::iterator pos,
+                        Tick when, PacketPtr pkt);
+
     /** The manager which is used for the event queue */
     EventManager& em;
 
@@ -206,6 +225,13 @@ class PacketQueue : public Drainable
       */
     void disableSanityCheck() { _disableSanityCheck = true; }
 
+    /**
+     * Size of the transmit list above which a queue warns that it
+     * keeps growing, 0 disables the warning. A queue warns again
+     * every time its size doubles.
+     */
+    static size_t sizeWarning;
+
     DrainState drain() override;
 };
 
@@ -42,38 +42,206 @@
 #include "base/compiler.hh"
 #include "base/trace.hh"
 #include "debug/MMU.hh"
+#include "sim/eventq.hh"
 #include "sim/faults.hh"
 #include "sim/serialize.hh"
 
 using namespace std;
 
+thread_local EmulationPageTable::Entry EmulationPageTable::hugePage;
+
+std::unique_lock<std::mutex>
+EmulationPageTable::lockTable()
+{
+    std::unique_lock<std::mutex> lock(tableMutex, std::defer_lock);
+    if (inParallelMode)
+        lock.lock();
+    return lock;
+}
+
+bool
+EmulationPageTable::Dir::empty() const
+{
+    if (huge.any())
+        return false;
+    for (const auto &leaf : leaves) {
+        if (leaf)
+            return false;
+    }
+    return true;
+}
+
+EmulationPageTable::Dir &
+EmulationPageTable::getDir(Addr vaddr, bool clobber)
+{
+    auto it = pTable.find(vaddr >> dirShift);
+    if (it == pTable.end()) {
+        Top top;
+        top.dir.reset(new Dir);
+        it = pTable.emplace(vaddr >> dirShift, std::move(top)).first;
+    }
+
+    Top &top = it->second;
+    if (!top.dir) {
+        panic_if(!clobber,
+                 "EmulationPageTable::allocate: addr %#x already mapped",
+                 vaddr);
+        // split the huge mapping into one for each slot
+        top.dir.reset(new Dir);
+        top.dir->huge.set();
+        for (unsigned i = 0; i < LevelSize; ++i) {
+            top.dir->hugeEntries[i] = Entry(
+                top.huge.paddr + ((Addr)i << leafShift), top.huge.flags);
+        }
+    }
+    return *top.dir;
+}
+
 void
-EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
+EmulationPageTable::splitSlot(Dir &dir, unsigned idx)
+{
+    assert(dir.huge[idx]);
+    const Entry &huge = dir.hugeEntries[idx];
+    Leaf *leaf = new Leaf;
+    leaf->valid.set();
+    for (unsigned i = 0; i < LevelSize; ++i)
+        leaf->entries[i] = Entry(huge.paddr + ((Addr)i << pageShift),
+                                 huge.flags);
+    dir.leaves[idx].reset(leaf);
+    dir.huge.reset(idx);
+}
+
+void
+EmulationPageTable::mapRange(Addr vaddr, Addr paddr, int64_t size,
+                             uint64_t flags)
 {
     bool clobber = flags & Clobber;
-    // starting address must be page aligned
-    assert(pageOffset(vaddr) == 0);
 
-    DPRINTF(MMU, "Allocating Page: %#x-%#x\n", vaddr, vaddr + size);
+    while (size > 0) {
+        Addr step = pageSize;
+
+        if (fits(vaddr, paddr, size, dirShift) &&
+            (clobber || pTable.find(vaddr >> dirShift) == pTable.end())) {
+            // a huge mapping covering a whole directory
+            Top &top = pTable[vaddr >> dirShift];
+            top.dir.reset();
+            top.huge = Entry(paddr, flags);
+            step = (Addr)1 << dirShift;
+        } else {
+            Dir &dir = getDir(vaddr, clobber);
+            unsigned idx = slot(vaddr, leafShift);
+            if (fits(vaddr, paddr, size, leafShift) &&
+                (clobber || (!dir.leaves[idx] && !dir.huge[idx]))) {
+                // a huge mapping covering a whole leaf
+                dir.leaves[idx].reset();
+                dir.huge.set(idx);
+                dir.hugeEntries[idx] = Entry(paddr, flags);
+                step = (Addr)1 << leafShift;
+            } else {
+                if (dir.huge[idx]) {
+                    panic_if(!clobber, "EmulationPageTable::allocate: "
+                             "addr %#x already mapped", vaddr);
+                    splitSlot(dir, idx);
+                } else if (!dir.leaves[idx]) {
+                    dir.leaves[idx].reset(new Leaf);
+                }
+                Leaf &leaf = *dir.leaves[idx];
+                unsigned page = slot(vaddr, pageShift);
+                // already mapped
+                panic_if(leaf.valid[page] && !clobber,
+                         "EmulationPageTable::allocate: addr %#x already "
+                         "mapped", vaddr);
+                leaf.valid.set(page);
+                leaf.entries[page] = Entry(paddr, flags);
+            }
+        }
+
+        size -= step;
+        vaddr += step;
+        paddr += step;
+    }
+}
 
+void
+EmulationPageTable::unmapRange(Addr vaddr, int64_t size)
+{
     while (size > 0) {
-        auto it = pTable.find(vaddr);
-        if (it != pTable.end()) {
-            // already mapped
-            panic_if(!clobber,
-                     "EmulationPageTable::allocate: addr %#x already mapped",
-                     vaddr);
-            it->second = Entry(paddr, flags);
+        Addr step = pageSize;
+
+        auto it = pTable.find(vaddr >> dirShift);
+        assert(it != pTable.end());
+
+        if (fits(vaddr, 0, size, dirShift)) {
+            pTable.erase(it);
+            step = (Addr)1 << dirShift;
         } else {
-            pTable.emplace(vaddr, Entry(paddr, flags));
+            Dir &dir = getDir(vaddr, true);
+            unsigned idx = slot(vaddr, leafShift);
+            if (fits(vaddr, 0, size, leafShift)) {
+                assert(dir.leaves[idx] || dir.huge[idx]);
+                dir.leaves[idx].reset();
+                dir.huge.reset(idx);
+                step = (Addr)1 << leafShift;
+            } else {
+                if (dir.huge[idx])
+                    splitSlot(dir, idx);
+                Leaf *leaf = dir.leaves[idx].get();
+                unsigned page = slot(vaddr, pageShift);
+                assert(leaf && leaf->valid[page]);
+                leaf->valid.reset(page);
+                if (leaf->valid.none())
+                    dir.leaves[idx].reset();
+            }
+            if (dir.empty())
+                pTable.erase(vaddr >> dirShift);
         }
 
-        size -= pageSize;
-        vaddr += pageSize;
-        paddr += pageSize;
+        size -= step;
+        vaddr += step;
+    }
+}
+
+template <class F>
+void
+EmulationPageTable::forEachMapping(F f) const
+{
+    for (const auto &t : pTable) {
+        Addr dir_base = t.first << dirShift;
+        const Top &top = t.second;
+        if (!top.dir) {
+            f(dir_base, top.huge, dirShift);
+            continue;
+        }
+
+        const Dir &dir = *top.dir;
+        for (unsigned i = 0; i < LevelSize; ++i) {
+            Addr leaf_base = dir_base + ((Addr)i << leafShift);
+            if (dir.huge[i]) {
+                f(leaf_base, dir.hugeEntries[i], leafShift);
+            } else if (const Leaf *leaf = dir.leaves[i].get()) {
+                for (unsigned j = 0; j < LevelSize; ++j) {
+                    if (leaf->valid[j]) {
+                        f(leaf_base + ((Addr)j << pageShift),
+                          leaf->entries[j], pageShift);
+                    }
+                }
+            }
+        }
     }
 }
 
+void
+EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
+{
+    // starting address must be page aligned
+    assert(pageOffset(vaddr) == 0);
+
+    DPRINTF(MMU, "Allocating Page: %#x-%#x\n", vaddr, vaddr + size);
+
+    auto lock = lockTable();
+    mapRange(vaddr, paddr, size, flags);
+}
+
 void
 EmulationPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
 {
@@ -83,24 +251,64 @@ EmulationPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
     DPRINTF(MMU, "moving pages from vaddr %08p to %08p, size = %d\n", vaddr,
             new_vaddr, size);
 
+    auto lock = lockTable();
     while (size > 0) {
-        auto new_it M5_VAR_USED = pTable.find(new_vaddr);
-        auto old_it = pTable.find(vaddr);
-        assert(old_it != pTable.end() && new_it == pTable.end());
+        Addr step = pageSize;
 
-        pTable.emplace(new_vaddr, old_it->second);
-        pTable.erase(old_it);
-        size -= pageSize;
-        vaddr += pageSize;
-        new_vaddr += pageSize;
+        auto old_it = pTable.find(vaddr >> dirShift);
+        assert(old_it != pTable.end());
+
+        if (fits(vaddr, new_vaddr, size, dirShift)) {
+            // move a whole directory
+            assert(pTable.find(new_vaddr >> dirShift) == pTable.end());
+            Top top = std::move(old_it->second);
+            pTable.erase(old_it);
+            pTable.emplace(new_vaddr >> dirShift, std::move(top));
+            step = (Addr)1 << dirShift;
+        } else if (fits(vaddr, new_vaddr, size, leafShift)) {
+            // move a whole leaf, or a huge mapping of the same size
+            Dir &old_dir = getDir(vaddr, true);
+            Dir &new_dir = getDir(new_vaddr, false);
+            unsigned old_idx = slot(vaddr, leafShift);
+            unsigned new_idx = slot(new_vaddr, leafShift);
+            assert(old_dir.leaves[old_idx] || old_dir.huge[old_idx]);
+            assert(!new_dir.leaves[new_idx] && !new_dir.huge[new_idx]);
+
+            new_dir.leaves[new_idx] = std::move(old_dir.leaves[old_idx]);
+            new_dir.huge[new_idx] = old_dir.huge[old_idx];
+            new_dir.hugeEntries[new_idx] = old_dir.hugeEntries[old_idx];
+            old_dir.huge.reset(old_idx);
+            if (old_dir.empty())
+                pTable.erase(vaddr >> dirShift);
+            step = (Addr)1 << leafShift;
+        } else {
+            const Entry *old_entry = find(vaddr);
+            assert(old_entry);
+            Entry entry = *old_entry;
+            assert(!find(new_vaddr));
+
+            unmapRange(vaddr, pageSize);
+            mapRange(new_vaddr, entry.paddr, pageSize, entry.flags);
+        }
+
+        size -= step;
+        vaddr += step;
+        new_vaddr += step;
     }
 }
 
 void
 EmulationPageTable::getMappings(std::vector<std::pair<Addr, Addr>> *addr_maps)
 {
-    for (auto &iter : pTable)
-        addr_maps->push_back(make_pair(iter.first, iter.second.paddr));
+    auto lock = lockTable();
+    forEachMapping([this, addr_maps](Addr vaddr, const Entry &entry,
+                                     unsigned shift) {
+        for (Addr offset = 0; offset < ((Addr)1 << shift);
+             offset += pageSize) {
+            addr_maps->push_back(make_pair(vaddr + offset,
+                                           entry.paddr + offset));
+        }
+    });
 }
 
 void
@@ -110,13 +318,8 @@ EmulationPageTable::unmap(Addr vaddr, int64_t size)
 
     DPRINTF(MMU, "Unmapping page: %#x-%#x\n", vaddr, vaddr + size);
 
-    while (size > 0) {
-        auto it = pTable.find(vaddr);
-        assert(it != pTable.end());
-        pTable.erase(it);
-        size -= pageSize;
-        vaddr += pageSize;
-    }
+    auto lock = lockTable();
+    unmapRange(vaddr, size);
 }
 
 bool
@@ -125,9 +328,35 @@ EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
     // starting address must be page aligned
     assert(pageOffset(vaddr) == 0);
 
-    for (int64_t offset = 0; offset < size; offset += pageSize)
-        if (pTable.find(vaddr + offset) != pTable.end())
+    auto lock = lockTable();
+    const Addr end = vaddr + size;
+    while (vaddr < end) {
+        auto it = pTable.find(vaddr >> dirShift);
+        if (it == pTable.end()) {
+            vaddr = roundDown(vaddr, (Addr)1 << dirShift) +
+                ((Addr)1 << dirShift);
+            continue;
+        }
+
+        const Top &top = it->second;
+        if (!top.dir)
+            return false;
+
+        unsigned idx = slot(vaddr, leafShift);
+        if (top.dir->huge[idx])
+            return false;
+
+        const Leaf *leaf = top.dir->leaves[idx].get();
+        if (!leaf) {
+            vaddr = roundDown(vaddr, (Addr)1 << leafShift) +
+                ((Addr)1 << leafShift);
+            continue;
+        }
+
+        if (leaf->valid[slot(vaddr, pageShift)])
             return false;
+        vaddr += pageSize;
+    }
 
     return true;
 }
@@ -135,11 +364,39 @@ EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
 const EmulationPageTable::Entry *
 EmulationPageTable::lookup(Addr vaddr)
 {
-    Addr page_addr = pageAlign(vaddr);
-    PTableItr iter = pTable.find(page_addr);
-    if (iter == pTable.end())
+    auto lock = lockTable();
+    return find(vaddr);
+}
+
+const EmulationPageTable::Entry *
+EmulationPageTable::find(Addr vaddr)
+{
+    auto it = pTable.find(vaddr >> dirShift);
+    if (it == pTable.end())
         return nullptr;
-    return &(iter->second);
+
+    const Top &top = it->second;
+    if (!top.dir) {
+        hugePage = Entry(top.huge.paddr +
+                         (pageAlign(vaddr) & mask(dirShift)),
+                         top.huge.flags);
+        return &hugePage;
+    }
+
+    const Dir &dir = *top.dir;
+    unsigned idx = slot(vaddr, leafShift);
+    if (dir.huge[idx]) {
+        const Entry &huge = dir.hugeEntries[idx];
+        hugePage = Entry(huge.paddr + (pageAlign(vaddr) & mask(leafShift)),
+                         huge.flags);
+        return &hugePage;
+    }
+
+    const Leaf *leaf = dir.leaves[idx].get();
+    unsigned page = slot(vaddr, pageShift);
+    if (!leaf || !leaf->valid[page])
+        return nullptr;
+    return &leaf->entries[page];
 }
 
 bool
@@ -174,17 +431,23 @@ EmulationPageTable::translate(RequestPtr req)
 void
 EmulationPageTable::serialize(CheckpointOut &cp) const
 {
-    paramOut(cp, "ptable.size", pTable.size());
-
     PTable::size_type count = 0;
-    for (auto &pte : pTable) {
-        ScopedCheckpointSection sec(cp, csprintf("Entry%d", count++));
+    forEachMapping([&count](Addr, const Entry &, unsigned) { ++count; });
+    paramOut(cp, "ptable.size", count);
 
-        paramOut(cp, "vaddr", pte.first);
-        paramOut(cp, "paddr", pte.second.paddr);
-        paramOut(cp, "flags", pte.second.flags);
-    }
-    assert(count == pTable.size());
+    PTable::size_type i = 0;
+    forEachMapping([this, &cp, &i](Addr vaddr, const Entry &entry,
+                                   unsigned shift) {
+        ScopedCheckpointSection sec(cp, csprintf("Entry%d", i++));
+
+        paramOut(cp, "vaddr", vaddr);
+        paramOut(cp, "paddr", entry.paddr);
+        paramOut(cp, "flags", entry.flags);
+        // checkpoints without a size only have single pages
+        if (shift != pageShift)
+            paramOut(cp, "size", (Addr)1 << shift);
+    });
+    assert(i == count);
 }
 
 void
@@ -202,8 +465,9 @@ EmulationPageTable::unserialize(CheckpointIn &cp)
         uint64_t flags;
         UNSERIALIZE_SCALAR(paddr);
         UNSERIALIZE_SCALAR(flags);
+        Addr size = pageSize;
+        optParamIn(cp, "size", size, false);
 
-        pTable.emplace(vaddr, Entry(paddr, flags));
+        mapRange(vaddr, paddr, size, flags);
     }
 }
-
@@ -37,6 +37,9 @@
 #ifndef __MEM_PAGE_TABLE_HH__
 #define __MEM_PAGE_TABLE_HH__
 
+#include <bitset>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -60,21 +63,112 @@ class EmulationPageTable : public Serializable
     };
 
   protected:
-    typedef std::unordered_map<Addr, Entry> PTable;
-    typedef PTable::iterator PTableItr;
+    /**
+     * The table is a radix tree with three levels. Each leaf maps
+     * LevelSize consecutive pages, each directory LevelSize consecutive
+     * leaves, and directories are kept in a hash table. A directory
+     * slot or a whole directory can instead hold a single huge mapping
+     * (2MB and 1GB with 4KB pages), which is used when a mapping is
+     * large and aligned enough.
+     */
+    static const unsigned LevelBits = 9;
+    static const unsigned LevelSize = 1 << LevelBits;
+
+    struct Leaf
+    {
+        std::bitset<LevelSize> valid;
+        Entry entries[LevelSize];
+    };
+
+    struct Dir
+    {
+        std::unique_ptr<Leaf> leaves[LevelSize];
+        std::bitset<LevelSize> huge;
+        Entry hugeEntries[LevelSize];
+
+        bool empty() const;
+    };
+
+    /** A directory, or a huge mapping if there is no directory. */
+    struct Top
+    {
+        std::unique_ptr<Dir> dir;
+        Entry huge;
+    };
+
+    typedef std::unordered_map<Addr, Top> PTable;
     PTable pTable;
 
     const Addr pageSize;
     const Addr offsetMask;
 
+    /** log2 of the size covered by a page, a leaf and a directory. */
+    const unsigned pageShift;
+    const unsigned leafShift;
+    const unsigned dirShift;
+
+    /** The entry of a page within a huge mapping, for lookup(). */
+    static thread_local Entry hugePage;
+
+    /**
+     * Lock for the table, which threads of a process running on
+     * different event queues may use at the same time. It is only
+     * taken in parallel mode.
+     */
+    std::mutex tableMutex;
+
     const uint64_t _pid;
     const std::string _name;
 
+  private:
+    /** Index of the slot covering vaddr in a node of the given level. */
+    unsigned
+    slot(Addr vaddr, unsigned shift) const
+    {
+        return (vaddr >> shift) & (LevelSize - 1);
+    }
+
+    /**
+     * Can a huge mapping of the given size start at vaddr (and paddr)
+     * for a region of the given size?
+     */
+    static bool
+    fits(Addr vaddr, Addr paddr, int64_t size, unsigned shift)
+    {
+        return ((vaddr | paddr) & mask(shift)) == 0 &&
+            size >= (int64_t)1 << shift;
+    }
+
+    /** Lock the table if several event queues may use it. */
+    std::unique_lock<std::mutex> lockTable();
+
+    /** lookup() without locking the table. */
+    const Entry *find(Addr vaddr);
+
+    /** Get the directory covering vaddr, creating it if needed. */
+    Dir &getDir(Addr vaddr, bool clobber);
+
+    /** Replace a huge directory slot by a leaf. */
+    void splitSlot(Dir &dir, unsigned idx);
+
+    void mapRange(Addr vaddr, Addr paddr, int64_t size, uint64_t flags);
+    void unmapRange(Addr vaddr, int64_t size);
+
+    /**
+     * Call f(vaddr, entry, shift) for every mapping, where shift is
+     * log2 of the size of the mapping.
+     */
+    template <class F>
+    void forEachMapping(F f) const;
+
   public:
 
     EmulationPageTable(
             const std::string &__name, uint64_t _pid, Addr _pageSize) :
             pageSize(_pageSize), offsetMask(mask(floorLog2(_pageSize))),
+            pageShift(floorLog2(_pageSize)),
+            leafShift(pageShift + LevelBits),
+            dirShift(leafShift + LevelBits),
             _pid(_pid), _name(__name)
     {
         assert(isPowerOf2(pageSize));
@@ -127,7 +221,9 @@ class EmulationPageTable : public Serializable
     /**
      * Lookup function
      * @param vaddr The virtual address.
-     * @return The page table entry corresponding to vaddr.
+     * @return The page table entry corresponding to vaddr. The entry
+     *         of a page within a huge mapping is only valid until the
+     *         calling thread uses the table again.
      */
     const Entry *lookup(Addr vaddr);
 
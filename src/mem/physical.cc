@@ -41,21 +41,35 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/user.h>
 #include <unistd.h>
 #include <zlib.h>
 
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <string>
+#include <thread>
 
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
 #include "mem/abstract_mem.hh"
+#include "sim/byteswap.hh"
 
 /**
  * On Linux, MAP_NORESERVE allow us to simulate a very large memory
@@ -69,17 +83,110 @@
 #endif
 #endif
 
+/**
+ * Size of the pages in the hugetlb pool. This is the default huge
+ * page size on x86 and on ARM with a 4KB translation granule.
+ */
+static const uint64_t hugePageSize = 2 * 1024 * 1024;
+
 using namespace std;
 
+/**
+ * Magic number at the end of a block compressed memory image.
+ */
+static const uint64_t blockStoreMagic = 0x7a6d656d70356d67ULL;
+
+/**
+ * Granularity at which incremental checkpoints track changes.
+ */
+static const uint64_t deltaPageSize = 4096;
+
+/**
+ * Hash a page of memory, eight bytes at a time (FNV-1a on words).
+ */
+static uint64_t
+hashPage(const uint8_t* data, uint64_t len)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    uint64_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ULL;
+    }
+    for (; i < len; ++i)
+        hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    return hash;
+}
+
+/**
+ * Get the absolute path of a file in an existing directory, so that
+ * later checkpoints can refer to it from wherever they are.
+ */
+static string
+absolutePath(const string& dir, const string& filename)
+{
+    char* real_dir = realpath(dir.c_str(), NULL);
+    if (!real_dir)
+        fatal("Can't resolve checkpoint directory '%s'\n", dir);
+    string path = string(real_dir) + "/" + filename;
+    free(real_dir);
+    return path;
+}
+
+/**
+ * Call a function for all indices in [first, last) using a number of
+ * host threads, including the calling one.
+ */
+static void
+parallelFor(unsigned num_threads, uint64_t first, uint64_t last,
+            const function<void(uint64_t)>& func)
+{
+    atomic<uint64_t> next(first);
+    auto worker = [&next, last, &func]() {
+        for (uint64_t i = next++; i < last; i = next++)
+            func(i);
+    };
+
+    vector<thread> threads;
+    for (unsigned i = 1; i < num_threads; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& t : threads)
+        t.join();
+}
+
 PhysicalMemory::PhysicalMemory(const string& _name,
                                const vector<AbstractMemory*>& _memories,
-                               bool mmap_using_noreserve) :
-    _name(_name), rangeCache(addrMap.end()), size(0),
-    mmapUsingNoReserve(mmap_using_noreserve)
+                               bool mmap_using_noreserve,
+                               Enums::BackingStorePages backing_store_pages,
+                               const vector<uint32_t>& numa_nodes,
+                               unsigned prefault_threads,
+                               bool compress_checkpoints,
+                               unsigned checkpoint_threads,
+                               uint64_t checkpoint_block_size,
+                               bool incremental_checkpoints) :
+    _name(_name), size(0),
+    mmapUsingNoReserve(mmap_using_noreserve),
+    backingStorePages(backing_store_pages), numaNodes(numa_nodes),
+    prefaultThreads(prefault_threads),
+    compressCheckpoints(compress_checkpoints),
+    checkpointThreads(checkpoint_threads),
+    checkpointBlockSize(checkpoint_block_size),
+    incrementalCheckpoints(incremental_checkpoints)
 {
+    fatal_if(checkpoint_threads && !checkpoint_block_size,
+             "Checkpoint memory block size must be non-zero\n");
+
     if (mmap_using_noreserve)
         warn("Not reserving swap space. May cause SIGSEGV on actual usage\n");
 
+#ifndef MADV_HUGEPAGE
+    if (backing_store_pages != Enums::normal)
+        warn("Huge pages are not supported on this host, using normal "
+             "pages for the backing store\n");
+#endif
+
     // add the memories from the system to the address map as
     // appropriate
     for (const auto& m : _memories) {
@@ -118,6 +225,8 @@ PhysicalMemory::PhysicalMemory(const string& _name,
         }
     }
 
+    addrDecoder.build(addrMap);
+
     // iterate over the increasing addresses and chunks of contiguous
     // space to be mapped to backing store, create it and inform the
     // memories
@@ -180,6 +289,8 @@ PhysicalMemory::PhysicalMemory(const string& _name,
                            f->isConfReported(), f->isInAddrMap(),
                            f->isKvmMap());
     }
+
+    storeHistory.resize(backingStore.size());
 }
 
 void
@@ -195,17 +306,7 @@ PhysicalMemory::createBackingStore(AddrRange range,
     // perform the actual mmap
     DPRINTF(AddrRanges, "Creating backing store for range %s with size %d\n",
             range.to_string(), range.size());
-    int map_flags = MAP_ANON | MAP_PRIVATE;
-
-    // to be able to simulate very large memories, the user can opt to
-    // pass noreserve to mmap
-    if (mmapUsingNoReserve) {
-        map_flags |= MAP_NORESERVE;
-    }
-
-    uint8_t* pmem = (uint8_t*) mmap(NULL, range.size(),
-                                    PROT_READ | PROT_WRITE,
-                                    map_flags, -1, 0);
+    uint8_t* pmem = mapBackingStore(range.size());
 
     if (pmem == (uint8_t*) MAP_FAILED) {
         perror("mmap");
@@ -213,6 +314,17 @@ PhysicalMemory::createBackingStore(AddrRange range,
               range.to_string());
     }
 
+    // place the store close to the event queue thread accessing it,
+    // all memories sharing a store are expected to be on one queue
+    if (!numaNodes.empty()) {
+        const uint32_t eventq = _memories.front()->params()->eventq_index;
+        bindBackingStore(pmem, range.size(),
+                         numaNodes[eventq % numaNodes.size()]);
+    }
+
+    if (prefaultThreads)
+        prefaultBackingStore(pmem, range.size());
+
     // remember this backing store so we can checkpoint it and unmap
     // it appropriately
     backingStore.emplace_back(range, pmem,
@@ -226,6 +338,100 @@ PhysicalMemory::createBackingStore(AddrRange range,
     }
 }
 
+uint8_t*
+PhysicalMemory::mapBackingStore(uint64_t size)
+{
+    int map_flags = MAP_ANON | MAP_PRIVATE;
+
+    // to be able to simulate very large memories, the user can opt to
+    // pass noreserve to mmap
+    if (mmapUsingNoReserve) {
+        map_flags |= MAP_NORESERVE;
+    }
+
+    uint8_t* pmem = (uint8_t*) MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    // the store is unmapped using the size of its range, which for
+    // hugetlb mappings has to be a multiple of the huge page size
+    if (backingStorePages == Enums::hugetlb) {
+        if (size % hugePageSize == 0) {
+            pmem = (uint8_t*) mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                   map_flags | MAP_HUGETLB, -1, 0);
+            if (pmem == (uint8_t*) MAP_FAILED)
+                warn("Could not map %d bytes from the hugetlb pool, "
+                     "using transparent huge pages instead\n", size);
+        } else {
+            warn("Backing store size %d is not a multiple of the huge "
+                 "page size, using transparent huge pages instead\n", size);
+        }
+    }
+#endif
+
+    if (pmem == (uint8_t*) MAP_FAILED) {
+        pmem = (uint8_t*) mmap(NULL, size, PROT_READ | PROT_WRITE,
+                               map_flags, -1, 0);
+
+#ifdef MADV_HUGEPAGE
+        if (pmem != (uint8_t*) MAP_FAILED &&
+            backingStorePages != Enums::normal &&
+            madvise(pmem, size, MADV_HUGEPAGE) != 0)
+            warn("Could not enable transparent huge pages for the "
+                 "backing store: %s\n", strerror(errno));
+#endif
+    }
+
+    return pmem;
+}
+
+void
+PhysicalMemory::bindBackingStore(uint8_t* pmem, uint64_t size,
+                                 uint32_t node)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    // use a preferred rather than a strict policy, so that a node
+    // running out of memory does not take the simulator down
+    const size_t bits = sizeof(unsigned long) * CHAR_BIT;
+    vector<unsigned long> mask(node / bits + 1, 0);
+    mask[node / bits] = 1UL << (node % bits);
+
+    DPRINTF(AddrRanges, "Binding backing store to host node %d\n", node);
+    if (syscall(SYS_mbind, pmem, size, MPOL_PREFERRED, mask.data(),
+                mask.size() * bits + 1, 0) != 0)
+        warn("Could not bind backing store to host NUMA node %d: %s\n",
+             node, strerror(errno));
+#else
+    warn_once("NUMA binding of the backing store is not supported on "
+              "this host\n");
+#endif
+}
+
+void
+PhysicalMemory::prefaultBackingStore(uint8_t* pmem, uint64_t size)
+{
+    const uint64_t page_size = sysconf(_SC_PAGESIZE);
+    const uint64_t num_pages = divCeil(size, page_size);
+    const uint64_t num_threads = min<uint64_t>(prefaultThreads, num_pages);
+    const uint64_t chunk = divCeil(num_pages, num_threads);
+
+    DPRINTF(AddrRanges, "Pre-faulting %d pages using %d threads\n",
+            num_pages, num_threads);
+
+    // writing a byte of every page forces the kernel to allocate it,
+    // the store is zero-filled so the content does not change
+    auto touch = [pmem, page_size](uint64_t first, uint64_t last) {
+        for (uint64_t page = first; page < last; ++page)
+            ((volatile uint8_t*) pmem)[page * page_size] = 0;
+    };
+
+    vector<thread> threads;
+    for (uint64_t i = 0; i < num_threads; ++i)
+        threads.emplace_back(touch, min(num_pages, i * chunk),
+                             min(num_pages, (i + 1) * chunk));
+    for (auto& t : threads)
+        t.join();
+}
+
 PhysicalMemory::~PhysicalMemory()
 {
     // unmap the backing store
@@ -236,20 +442,19 @@ PhysicalMemory::~PhysicalMemory()
 bool
 PhysicalMemory::isMemAddr(Addr addr) const
 {
-    // see if the address is within the last matched range
-    if (rangeCache != addrMap.end() && rangeCache->first.contains(addr)) {
-        return true;
-    } else {
-        // lookup in the interval tree
-        const auto& r = addrMap.find(addr);
-        if (r == addrMap.end()) {
-            // not in the cache, and not in the tree
-            return false;
-        }
-        // the range is in the tree, update the cache
-        rangeCache = r;
-        return true;
+    return addrDecoder.find(addr) != nullptr;
+}
+
+uint8_t *
+PhysicalMemory::hostAddr(Addr addr, Addr size) const
+{
+    assert(size > 0);
+    for (const auto& s : backingStore) {
+        if (s.inAddrMap && s.range.start() <= addr &&
+            addr + size - 1 <= s.range.end())
+            return s.pmem + (addr - s.range.start());
     }
+    return nullptr;
 }
 
 AddrRangeList
@@ -293,15 +498,9 @@ PhysicalMemory::access(PacketPtr pkt)
 {
     assert(pkt->isRequest());
     Addr addr = pkt->getAddr();
-    if (rangeCache != addrMap.end() && rangeCache->first.contains(addr)) {
-        rangeCache->second->access(pkt);
-    } else {
-        // do not update the cache here, as we typically call
-        // isMemAddr before calling access
-        const auto& m = addrMap.find(addr);
-        assert(m != addrMap.end());
-        m->second->access(pkt);
-    }
+    const auto m = addrDecoder.find(addr);
+    assert(m);
+    m->second->access(pkt);
 }
 
 void
@@ -309,15 +508,9 @@ PhysicalMemory::functionalAccess(PacketPtr pkt)
 {
     assert(pkt->isRequest());
     Addr addr = pkt->getAddr();
-    if (rangeCache != addrMap.end() && rangeCache->first.contains(addr)) {
-        rangeCache->second->functionalAccess(pkt);
-    } else {
-        // do not update the cache here, as we typically call
-        // isMemAddr before calling functionalAccess
-        const auto& m = addrMap.find(addr);
-        assert(m != addrMap.end());
-        m->second->functionalAccess(pkt);
-    }
+    const auto m = addrDecoder.find(addr);
+    assert(m);
+    m->second->functionalAccess(pkt);
 }
 
 void
@@ -354,9 +547,22 @@ void
 PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
                                AddrRange range, uint8_t* pmem) const
 {
+    if (incrementalCheckpoints) {
+        StoreHistory& history = storeHistory[store_id];
+        vector<uint64_t> hashes = hashPages(pmem, range.size());
+        if (!history.baseFile.empty()) {
+            serializeDelta(cp, store_id, range, pmem, hashes);
+            return;
+        }
+        history.pageHashes.swap(hashes);
+    }
+
     // we cannot use the address range for the name as the
     // memories that are not part of the address map can overlap
-    string filename = name() + ".store" + to_string(store_id) + ".pmem";
+    bool compressed = compressCheckpoints;
+    bool blocked = compressed && checkpointThreads;
+    string filename = name() + ".store" + to_string(store_id) +
+        (!compressed ? ".raw" : blocked ? ".pmemz" : ".pmem");
     long range_size = range.size();
 
     DPRINTF(Checkpoint, "Serializing physical memory %s with size %d\n",
@@ -365,9 +571,28 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     SERIALIZE_SCALAR(store_id);
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
+    SERIALIZE_SCALAR(compressed);
+    SERIALIZE_SCALAR(blocked);
+
+    // this image is the base of the following incremental checkpoints
+    if (incrementalCheckpoints) {
+        StoreHistory& history = storeHistory[store_id];
+        history.baseFile = absolutePath(CheckpointIn::dir(), filename);
+        history.baseCompressed = compressed;
+        history.baseBlocked = blocked;
+        history.deltas.clear();
+    }
 
     // write memory file
     string filepath = CheckpointIn::dir() + "/" + filename.c_str();
+    if (!compressed) {
+        writeRawStore(filepath, pmem, range.size());
+        return;
+    } else if (blocked) {
+        writeBlockStore(filepath, pmem, range.size());
+        return;
+    }
+
     gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
     if (compressed_mem == NULL)
         fatal("Can't open physical memory checkpoint file '%s'\n",
@@ -396,6 +621,180 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
 
 }
 
+vector<uint64_t>
+PhysicalMemory::hashPages(const uint8_t* pmem, uint64_t size) const
+{
+    const uint64_t num_pages = divCeil(size, deltaPageSize);
+    vector<uint64_t> hashes(num_pages);
+
+    // hand out the pages in chunks to keep the threads busy
+    const uint64_t chunk = 256;
+    parallelFor(checkpointThreads, 0, divCeil(num_pages, chunk),
+                [&](uint64_t c) {
+        const uint64_t last = min(num_pages, (c + 1) * chunk);
+        for (uint64_t p = c * chunk; p < last; ++p) {
+            const uint64_t offset = p * deltaPageSize;
+            hashes[p] = hashPage(pmem + offset,
+                                 min(deltaPageSize, size - offset));
+        }
+    });
+
+    return hashes;
+}
+
+void
+PhysicalMemory::serializeDelta(CheckpointOut &cp, unsigned int store_id,
+                               AddrRange range, const uint8_t* pmem,
+                               vector<uint64_t>& hashes) const
+{
+    StoreHistory& history = storeHistory[store_id];
+    string filename = name() + ".store" + to_string(store_id) + ".delta";
+    long range_size = range.size();
+    bool incremental = true;
+
+    SERIALIZE_SCALAR(store_id);
+    SERIALIZE_SCALAR(filename);
+    SERIALIZE_SCALAR(range_size);
+    SERIALIZE_SCALAR(incremental);
+
+    // the delta is only meaningful on top of the earlier checkpoints,
+    // which therefore have to be kept around
+    history.deltas.push_back(absolutePath(CheckpointIn::dir(), filename));
+    paramOut(cp, "base_file", history.baseFile);
+    paramOut(cp, "base_compressed", history.baseCompressed);
+    paramOut(cp, "base_blocked", history.baseBlocked);
+    unsigned num_deltas = history.deltas.size();
+    SERIALIZE_SCALAR(num_deltas);
+    for (unsigned i = 0; i < num_deltas; ++i)
+        paramOut(cp, csprintf("delta%d", i), history.deltas[i]);
+
+    // a delta is a sequence of changed pages, each preceded by its
+    // index, written as a gzip stream or as plain data
+    string filepath = CheckpointIn::dir() + "/" + filename;
+    gzFile delta = gzopen(filepath.c_str(),
+                          compressCheckpoints ? "wb" : "wbT");
+    if (delta == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filename);
+
+    uint64_t changed = 0;
+    for (uint64_t p = 0; p < hashes.size(); ++p) {
+        if (hashes[p] == history.pageHashes[p])
+            continue;
+
+        const uint64_t offset = p * deltaPageSize;
+        const unsigned len = min(deltaPageSize, range.size() - offset);
+        const uint64_t index = htole(p);
+        if (gzwrite(delta, &index, sizeof(index)) != (int) sizeof(index) ||
+            gzwrite(delta, pmem + offset, len) != (int) len)
+            fatal("Write failed on physical memory checkpoint file '%s'\n",
+                  filename);
+        ++changed;
+    }
+
+    if (gzclose(delta))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filename);
+
+    DPRINTF(Checkpoint, "Serialized %d of %d pages of physical memory "
+            "to %s\n", changed, hashes.size(), filename);
+
+    history.pageHashes.swap(hashes);
+}
+
+void
+PhysicalMemory::writeRawStore(const string& filepath, const uint8_t* pmem,
+                              uint64_t size) const
+{
+    int fd = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    // write the store a page at a time and seek past the pages that
+    // are all zero, most of a large memory is typically untouched
+    const uint64_t page_size = sysconf(_SC_PAGESIZE);
+    const vector<uint8_t> zero_page(page_size, 0);
+    for (uint64_t offset = 0; offset < size; offset += page_size) {
+        const uint64_t len = min(page_size, size - offset);
+        if (memcmp(pmem + offset, zero_page.data(), len) == 0)
+            continue;
+
+        if (pwrite(fd, pmem + offset, len, offset) != (ssize_t) len)
+            fatal("Write failed on physical memory checkpoint file '%s'\n",
+                  filepath);
+    }
+
+    // make sure trailing holes are part of the file
+    if (ftruncate(fd, size) != 0 || close(fd) != 0)
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
+void
+PhysicalMemory::writeBlockStore(const string& filepath, const uint8_t* pmem,
+                                uint64_t size) const
+{
+    FILE* f = fopen(filepath.c_str(), "wb");
+    if (f == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    const uint64_t block_size = checkpointBlockSize;
+    const uint64_t num_blocks = divCeil(size, block_size);
+
+    // compress a bounded number of blocks at a time, and write them
+    // in order while remembering their compressed sizes
+    const uint64_t batch = 4 * checkpointThreads;
+    vector<vector<uint8_t>> blocks(batch);
+    vector<uint64_t> index;
+    index.reserve(num_blocks + 3);
+
+    for (uint64_t first = 0; first < num_blocks; first += batch) {
+        const uint64_t last = min(num_blocks, first + batch);
+
+        parallelFor(checkpointThreads, first, last, [&](uint64_t b) {
+            const uint8_t* src = pmem + b * block_size;
+            const uint64_t len = min(block_size, size - b * block_size);
+            vector<uint8_t>& dst = blocks[b - first];
+
+            // a compressed block is never empty, so an empty block
+            // marks one that is all zero
+            dst.clear();
+            if (all_of(src, src + len, [](uint8_t v) { return v == 0; }))
+                return;
+
+            uLongf dst_len = compressBound(len);
+            dst.resize(dst_len);
+            if (compress2(dst.data(), &dst_len, src, len,
+                          Z_DEFAULT_COMPRESSION) != Z_OK)
+                panic("Failed to compress block %d of '%s'\n", b, filepath);
+            dst.resize(dst_len);
+        });
+
+        for (uint64_t b = first; b < last; ++b) {
+            const vector<uint8_t>& data = blocks[b - first];
+            if (fwrite(data.data(), 1, data.size(), f) != data.size())
+                fatal("Write failed on physical memory checkpoint file "
+                      "'%s'\n", filepath);
+            index.push_back(htole((uint64_t) data.size()));
+        }
+    }
+
+    // the index is followed by a footer to locate it
+    index.push_back(htole(block_size));
+    index.push_back(htole(num_blocks));
+    index.push_back(htole(blockStoreMagic));
+    if (fwrite(index.data(), sizeof(uint64_t), index.size(), f) !=
+        index.size())
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              filepath);
+
+    if (fclose(f))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
 void
 PhysicalMemory::unserialize(CheckpointIn &cp)
 {
@@ -424,8 +823,6 @@ PhysicalMemory::unserialize(CheckpointIn &cp)
 void
 PhysicalMemory::unserializeStore(CheckpointIn &cp)
 {
-    const uint32_t chunk_size = 16384;
-
     unsigned int store_id;
     UNSERIALIZE_SCALAR(store_id);
 
@@ -433,11 +830,6 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     string filepath = cp.cptDir + "/" + filename;
 
-    // mmap memoryfile
-    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
-
     // we've already got the actual backing store mapped
     uint8_t* pmem = backingStore[store_id].pmem;
     AddrRange range = backingStore[store_id].range;
@@ -452,11 +844,74 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
+    StoreHistory& history = storeHistory[store_id];
+    bool incremental = false;
+    UNSERIALIZE_OPT_SCALAR(incremental);
+    if (incremental) {
+        // restore the base image, and then replay all the deltas
+        // taken since in order
+        paramIn(cp, "base_file", history.baseFile);
+        paramIn(cp, "base_compressed", history.baseCompressed);
+        paramIn(cp, "base_blocked", history.baseBlocked);
+        unsigned num_deltas;
+        UNSERIALIZE_SCALAR(num_deltas);
+        history.deltas.resize(num_deltas);
+        for (unsigned i = 0; i < num_deltas; ++i)
+            paramIn(cp, csprintf("delta%d", i), history.deltas[i]);
+
+        readStore(history.baseFile, history.baseCompressed,
+                  history.baseBlocked, pmem, range.size());
+        for (const auto& delta : history.deltas)
+            readDelta(delta, pmem, range.size());
+    } else {
+        // checkpoints predating uncompressed images are all compressed
+        bool compressed = true;
+        UNSERIALIZE_OPT_SCALAR(compressed);
+        bool blocked = false;
+        UNSERIALIZE_OPT_SCALAR(blocked);
+        readStore(filepath, compressed, blocked, pmem, range.size());
+
+        if (incrementalCheckpoints) {
+            history.baseFile = absolutePath(cp.cptDir, filename);
+            history.baseCompressed = compressed;
+            history.baseBlocked = blocked;
+            history.deltas.clear();
+        }
+    }
+
+    // the next checkpoint only needs what changes from here on
+    if (incrementalCheckpoints)
+        history.pageHashes = hashPages(pmem, range.size());
+}
+
+void
+PhysicalMemory::readStore(const string& filepath, bool compressed,
+                          bool blocked, uint8_t* pmem, uint64_t size)
+{
+    if (!compressed)
+        mapRawStore(filepath, pmem, size);
+    else if (blocked)
+        readBlockStore(filepath, pmem, size);
+    else
+        readGzStore(filepath, pmem, size);
+}
+
+void
+PhysicalMemory::readGzStore(const string& filepath, uint8_t* pmem,
+                            uint64_t size) const
+{
+    const uint32_t chunk_size = 16384;
+
+    // mmap memoryfile
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", filepath);
+
     uint64_t curr_size = 0;
     long* temp_page = new long[chunk_size];
     long* pmem_current;
     uint32_t bytes_read;
-    while (curr_size < range.size()) {
+    while (curr_size < size) {
         bytes_read = gzread(compressed_mem, temp_page, chunk_size);
         if (bytes_read == 0)
             break;
@@ -478,5 +933,149 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
 
     if (gzclose(compressed_mem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
+              filepath);
+}
+
+void
+PhysicalMemory::readDelta(const string& filepath, uint8_t* pmem,
+                          uint64_t size) const
+{
+    // gzread also reads deltas that were written uncompressed
+    gzFile delta = gzopen(filepath.c_str(), "rb");
+    if (delta == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    uint64_t index;
+    int bytes_read;
+    while ((bytes_read = gzread(delta, &index, sizeof(index))) > 0) {
+        const uint64_t offset = letoh(index) * deltaPageSize;
+        if (bytes_read != (int) sizeof(index) || offset >= size)
+            fatal("Physical memory checkpoint file '%s' is corrupt\n",
+                  filepath);
+
+        const unsigned len = min(deltaPageSize, size - offset);
+        if (gzread(delta, pmem + offset, len) != (int) len)
+            fatal("Read failed on physical memory checkpoint file '%s'\n",
+                  filepath);
+    }
+
+    if (bytes_read < 0 || gzclose(delta))
+        fatal("Read failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
+void
+PhysicalMemory::mapRawStore(const string& filepath, uint8_t* pmem,
+                            uint64_t size)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t) st.st_size != size)
+        fatal("Physical memory checkpoint file '%s' does not match the "
+              "size of the memory\n", filepath);
+
+    int map_flags = MAP_PRIVATE | MAP_FIXED;
+    if (mmapUsingNoReserve)
+        map_flags |= MAP_NORESERVE;
+
+    // replace the anonymous store with a private mapping of the file,
+    // the store stays at the same address so the memories pointing to
+    // it do not need to be updated
+    if (mmap(pmem, size, PROT_READ | PROT_WRITE, map_flags, fd, 0) ==
+        MAP_FAILED) {
+        warn("Could not map physical memory checkpoint file '%s', "
+             "reading it instead: %s\n", filepath, strerror(errno));
+
+        // a failed fixed mapping may have discarded the old store
+        if (mmap(pmem, size, PROT_READ | PROT_WRITE, map_flags | MAP_ANON,
+                 -1, 0) == MAP_FAILED)
+            fatal("Could not remap the backing store for '%s'\n", filepath);
+
+        for (uint64_t offset = 0; offset < size; ) {
+            ssize_t bytes_read = pread(fd, pmem + offset,
+                                       min<uint64_t>(size - offset, INT_MAX),
+                                       offset);
+            if (bytes_read <= 0)
+                fatal("Read failed on physical memory checkpoint file "
+                      "'%s'\n", filepath);
+            offset += bytes_read;
+        }
+    }
+
+    if (close(fd) != 0)
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
+void
+PhysicalMemory::readBlockStore(const string& filepath, uint8_t* pmem,
+                               uint64_t size) const
+{
+    FILE* f = fopen(filepath.c_str(), "rb");
+    if (f == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    // locate the index using the footer
+    uint64_t footer[3];
+    if (fseeko(f, -(off_t) sizeof(footer), SEEK_END) != 0 ||
+        fread(footer, sizeof(footer), 1, f) != 1 ||
+        letoh(footer[2]) != blockStoreMagic)
+        fatal("Physical memory checkpoint file '%s' is not a block "
+              "compressed image\n", filepath);
+
+    const uint64_t block_size = letoh(footer[0]);
+    const uint64_t num_blocks = letoh(footer[1]);
+    if (!block_size || num_blocks != divCeil(size, block_size))
+        fatal("Physical memory checkpoint file '%s' does not match the "
+              "size of the memory\n", filepath);
+
+    vector<uint64_t> index(num_blocks);
+    if (fseeko(f, -(off_t) ((num_blocks + 3) * sizeof(uint64_t)),
+               SEEK_END) != 0 ||
+        fread(index.data(), sizeof(uint64_t), num_blocks, f) != num_blocks ||
+        fseeko(f, 0, SEEK_SET) != 0)
+        fatal("Read failed on physical memory checkpoint file '%s'\n",
+              filepath);
+
+    // read a bounded number of blocks at a time and decompress them
+    // in parallel, the store is zero-filled so empty blocks are
+    // simply skipped
+    const unsigned num_threads = max(checkpointThreads, 1U);
+    const uint64_t batch = 4 * num_threads;
+    vector<vector<uint8_t>> blocks(batch);
+
+    for (uint64_t first = 0; first < num_blocks; first += batch) {
+        const uint64_t last = min(num_blocks, first + batch);
+
+        for (uint64_t b = first; b < last; ++b) {
+            vector<uint8_t>& data = blocks[b - first];
+            data.resize(letoh(index[b]));
+            if (fread(data.data(), 1, data.size(), f) != data.size())
+                fatal("Read failed on physical memory checkpoint file "
+                      "'%s'\n", filepath);
+        }
+
+        parallelFor(num_threads, first, last, [&](uint64_t b) {
+            const vector<uint8_t>& src = blocks[b - first];
+            if (src.empty())
+                return;
+
+            const uint64_t len = min(block_size, size - b * block_size);
+            uLongf dst_len = len;
+            if (uncompress(pmem + b * block_size, &dst_len, src.data(),
+                           src.size()) != Z_OK || dst_len != len)
+                fatal("Block %d of physical memory checkpoint file '%s' "
+                      "is corrupt\n", b, filepath);
+        });
+    }
+
+    if (fclose(f))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
 }
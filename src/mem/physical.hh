@@ -40,7 +40,9 @@
 #ifndef __MEM_PHYSICAL_HH__
 #define __MEM_PHYSICAL_HH__
 
+#include "base/addr_decoder.hh"
 #include "base/addr_range_map.hh"
+#include "enums/BackingStorePages.hh"
 #include "mem/packet.hh"
 
 /**
@@ -120,9 +122,8 @@ class PhysicalMemory : public Serializable
     // Global address map
     AddrRangeMap<AbstractMemory*> addrMap;
 
-    // a mutable cache for the last address map iterator that matched
-    // an address
-    mutable AddrRangeMap<AbstractMemory*>::const_iterator rangeCache;
+    // flattened copy of the address map used to decode accesses
+    AddrDecoder<AbstractMemory*> addrDecoder;
 
     // All address-mapped memories
     std::vector<AbstractMemory*> memories;
@@ -133,6 +134,47 @@ class PhysicalMemory : public Serializable
     // Let the user choose if we reserve swap space when calling mmap
     const bool mmapUsingNoReserve;
 
+    // Host pages to use for the backing store
+    const Enums::BackingStorePages backingStorePages;
+
+    // Host NUMA nodes to bind the backing store to, by event queue
+    const std::vector<uint32_t> numaNodes;
+
+    // Number of host threads touching the backing store up front
+    const unsigned prefaultThreads;
+
+    // Compress the backing store when writing a checkpoint
+    const bool compressCheckpoints;
+
+    // Threads compressing blocks of the backing store, if any
+    const unsigned checkpointThreads;
+
+    // Size of the independently compressed blocks
+    const uint64_t checkpointBlockSize;
+
+    // Only store the pages changed since the previous checkpoint
+    const bool incrementalCheckpoints;
+
+    /**
+     * What is needed to write a backing store incrementally: the image
+     * the store was last completely written to or restored from, the
+     * deltas applied on top of it since, and a hash of every page as
+     * of the most recent of them.
+     */
+    struct StoreHistory
+    {
+        std::string baseFile;
+        bool baseCompressed;
+        bool baseBlocked;
+        std::vector<std::string> deltas;
+        std::vector<uint64_t> pageHashes;
+
+        StoreHistory() : baseCompressed(false), baseBlocked(false) {}
+    };
+
+    // History of each backing store, if checkpoints are incremental
+    mutable std::vector<StoreHistory> storeHistory;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
@@ -157,6 +199,35 @@ class PhysicalMemory : public Serializable
                             bool conf_table_reported,
                             bool in_addr_map, bool kvm_map);
 
+    /**
+     * Map an anonymous region for a backing store, using huge pages
+     * if requested and available.
+     *
+     * @param size Size of the region in bytes
+     * @return Pointer to the region
+     */
+    uint8_t* mapBackingStore(uint64_t size);
+
+    /**
+     * Bind a backing store to a host NUMA node. This is only a hint,
+     * failures are reported but not fatal.
+     *
+     * @param pmem The backing store
+     * @param size Size of the backing store in bytes
+     * @param node The host node
+     */
+    void bindBackingStore(uint8_t* pmem, uint64_t size, uint32_t node);
+
+    /**
+     * Fault in all pages of a backing store using a number of host
+     * threads, so that this does not happen one page at a time during
+     * simulation.
+     *
+     * @param pmem The backing store
+     * @param size Size of the backing store in bytes
+     */
+    void prefaultBackingStore(uint8_t* pmem, uint64_t size);
+
   public:
 
     /**
@@ -164,7 +235,14 @@ class PhysicalMemory : public Serializable
      */
     PhysicalMemory(const std::string& _name,
                    const std::vector<AbstractMemory*>& _memories,
-                   bool mmap_using_noreserve);
+                   bool mmap_using_noreserve,
+                   Enums::BackingStorePages backing_store_pages,
+                   const std::vector<uint32_t>& numa_nodes,
+                   unsigned prefault_threads,
+                   bool compress_checkpoints,
+                   unsigned checkpoint_threads,
+                   uint64_t checkpoint_block_size,
+                   bool incremental_checkpoints);
 
     /**
      * Unmap all the backing store we have used.
@@ -218,6 +296,19 @@ class PhysicalMemory : public Serializable
     std::vector<BackingStoreEntry> getBackingStore() const
     { return backingStore; }
 
+    /**
+     * Get a host pointer to a range of the global address map, for
+     * copying data in and out without going through the memory
+     * system. Like the backing store itself, this bypasses any caches
+     * and does not update any statistics.
+     *
+     * @param addr Start of the range in the guest
+     * @param size Size of the range in bytes
+     * @return Pointer to the data, or nullptr if the range is not
+     *         entirely backed by a single backing store
+     */
+    uint8_t *hostAddr(Addr addr, Addr size) const;
+
     /**
      * Perform an untimed memory access and update all the state
      * (e.g. locked addresses) and statistics accordingly. The packet
@@ -257,6 +348,54 @@ class PhysicalMemory : public Serializable
     void serializeStore(CheckpointOut &cp, unsigned int store_id,
                         AddrRange range, uint8_t* pmem) const;
 
+    /**
+     * Write a backing store to an uncompressed file. Pages that are
+     * all zero are skipped, leaving holes in the file.
+     *
+     * @param filepath The file to write
+     * @param pmem The host pointer to the backing store
+     * @param size The size of the backing store
+     */
+    void writeRawStore(const std::string& filepath, const uint8_t* pmem,
+                       uint64_t size) const;
+
+    /**
+     * Write a backing store as a sequence of independently compressed
+     * blocks, followed by an index of the compressed block sizes. The
+     * blocks are compressed in parallel, and blocks that are all zero
+     * are left out.
+     *
+     * @param filepath The file to write
+     * @param pmem The host pointer to the backing store
+     * @param size The size of the backing store
+     */
+    void writeBlockStore(const std::string& filepath, const uint8_t* pmem,
+                         uint64_t size) const;
+
+    /**
+     * Hash every page of a backing store, to find the pages changed
+     * between two checkpoints.
+     *
+     * @param pmem The host pointer to the backing store
+     * @param size The size of the backing store
+     * @return One hash per page
+     */
+    std::vector<uint64_t> hashPages(const uint8_t* pmem,
+                                    uint64_t size) const;
+
+    /**
+     * Serialize a store as the pages that changed since the previous
+     * checkpoint, referring to the checkpoints that hold the rest.
+     *
+     * @param store_id Unique identifier of this backing store
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     * @param hashes The current hashes of the pages of the store
+     */
+    void serializeDelta(CheckpointOut &cp, unsigned int store_id,
+                        AddrRange range, const uint8_t* pmem,
+                        std::vector<uint64_t>& hashes) const;
+
     /**
      * Unserialize the memories in the system. As with the
      * serialization, this action is independent of how the address
@@ -269,6 +408,62 @@ class PhysicalMemory : public Serializable
      */
     void unserializeStore(CheckpointIn &cp);
 
+    /**
+     * Restore a backing store from an uncompressed file by mapping
+     * the file copy-on-write in place of the store. The pages are
+     * read on first touch, and writes never reach the file. If the
+     * file cannot be mapped, it is read into the store instead.
+     *
+     * @param filepath The file to restore from
+     * @param pmem The host pointer to the backing store
+     * @param size The size of the backing store
+     */
+    void mapRawStore(const std::string& filepath, uint8_t* pmem,
+                     uint64_t size);
+
+    /**
+     * Restore a backing store written by writeBlockStore,
+     * decompressing the blocks in parallel.
+     *
+     * @param filepath The file to restore from
+     * @param pmem The host pointer to the backing store
+     * @param size The size of the backing store
+     */
+    void readBlockStore(const std::string& filepath, uint8_t* pmem,
+                        uint64_t size) const;
+
+    /**
+     * Restore a backing store from a single gzip stream.
+     *
+     * @param filepath The file to restore from
+     * @param pmem The host pointer to the backing store
+     * @param size The size of the backing store
+     */
+    void readGzStore(const std::string& filepath, uint8_t* pmem,
+                     uint64_t size) const;
+
+    /**
+     * Restore a backing store from a complete image in any format.
+     *
+     * @param filepath The file to restore from
+     * @param compressed Whether the image is compressed
+     * @param blocked Whether the image is block compressed
+     * @param pmem The host pointer to the backing store
+     * @param size The size of the backing store
+     */
+    void readStore(const std::string& filepath, bool compressed,
+                   bool blocked, uint8_t* pmem, uint64_t size);
+
+    /**
+     * Apply the pages written by serializeDelta to a backing store.
+     *
+     * @param filepath The delta to apply
+     * @param pmem The host pointer to the backing store
+     * @param size The size of the backing store
+     */
+    void readDelta(const std::string& filepath, uint8_t* pmem,
+                   uint64_t size) const;
+
 };
 
 #endif //__MEM_PHYSICAL_HH__
@@ -50,9 +50,11 @@
 
 #include "base/trace.hh"
 #include "mem/mem_object.hh"
+#include "mem/port_trace.hh"
 
 Port::Port(const std::string &_name, MemObject& _owner, PortID _id)
-    : portName(_name), id(_id), owner(_owner)
+    : portName(_name), id(_id), owner(_owner),
+      trace(PortTrace::create(_name))
 {
 }
 
@@ -180,7 +182,13 @@ bool
 MasterPort::sendTimingReq(PacketPtr pkt)
 {
     assert(pkt->isRequest());
-    return _slavePort->recvTimingReq(pkt);
+    if (!trace)
+        return _slavePort->recvTimingReq(pkt);
+
+    // the packet may be gone after the call, so record it before
+    PortTrace::Entry &entry = trace->record(pkt, PortTrace::Req);
+    entry.success = _slavePort->recvTimingReq(pkt);
+    return entry.success;
 }
 
 bool
@@ -200,6 +208,8 @@ MasterPort::sendTimingSnoopResp(PacketPtr pkt)
 void
 MasterPort::sendRetryResp()
 {
+    if (trace)
+        trace->recordRetry(PortTrace::RetryResp);
     _slavePort->recvRespRetry();
 }
 
@@ -258,7 +268,12 @@ bool
 SlavePort::sendTimingResp(PacketPtr pkt)
 {
     assert(pkt->isResponse());
-    return _masterPort->recvTimingResp(pkt);
+    if (!trace)
+        return _masterPort->recvTimingResp(pkt);
+
+    PortTrace::Entry &entry = trace->record(pkt, PortTrace::Resp);
+    entry.success = _masterPort->recvTimingResp(pkt);
+    return entry.success;
 }
 
 void
@@ -271,6 +286,8 @@ SlavePort::sendTimingSnoopReq(PacketPtr pkt)
 void
 SlavePort::sendRetryReq()
 {
+    if (trace)
+        trace->recordRetry(PortTrace::RetryReq);
     _masterPort->recvReqRetry();
 }
 
@@ -50,10 +50,13 @@
 #ifndef __MEM_PORT_HH__
 #define __MEM_PORT_HH__
 
+#include <memory>
+
 #include "base/addr_range.hh"
 #include "mem/packet.hh"
 
 class MemObject;
+class PortTrace;
 
 /**
  * Ports are used to interface memory objects to each other. A port is
@@ -79,6 +82,9 @@ class Port
     /** A reference to the MemObject that owns this port. */
     MemObject& owner;
 
+    /** Record of the recent timing traffic, if enabled for the port */
+    std::unique_ptr<PortTrace> trace;
+
     /**
      * Abstract base class for ports
      *
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/port_trace.hh"
+
+#include <algorithm>
+#include <iostream>
+
+#include "base/cprintf.hh"
+#include "base/match.hh"
+#include "base/output.hh"
+#include "base/str.hh"
+
+unsigned PortTrace::traceSize = 0;
+
+/** Ports to trace, all of them if empty */
+static ObjectMatch tracedPorts;
+static bool traceAllPorts = true;
+
+std::vector<PortTrace *> &
+PortTrace::traces()
+{
+    static std::vector<PortTrace *> the_traces;
+    return the_traces;
+}
+
+PortTrace::PortTrace(const std::string &port_name, unsigned size)
+    : portName(port_name), entries(size), count(0)
+{
+    traces().push_back(this);
+}
+
+PortTrace::~PortTrace()
+{
+    auto &all = traces();
+    all.erase(std::remove(all.begin(), all.end(), this), all.end());
+}
+
+void
+PortTrace::dump(std::ostream &os) const
+{
+    static const char *kind_names[] = {
+        "req", "resp", "retry_req", "retry_resp" };
+
+    ccprintf(os, "%s: last %d of %d\n", portName,
+             std::min<uint64_t>(count, entries.size()), count);
+
+    uint64_t first = count > entries.size() ? count - entries.size() : 0;
+    for (uint64_t i = first; i < count; ++i) {
+        const Entry &entry = entries[i % entries.size()];
+        if (entry.kind == RetryReq || entry.kind == RetryResp) {
+            ccprintf(os, "  %d: %s\n", entry.when, kind_names[entry.kind]);
+        } else {
+            ccprintf(os, "  %d: %s %s addr %#x size %d %s\n", entry.when,
+                     kind_names[entry.kind], MemCmd(entry.cmd).toString(),
+                     entry.addr, entry.size,
+                     entry.success ? "accepted" : "rejected");
+        }
+    }
+}
+
+void
+PortTrace::configure(unsigned size, const std::string &ports)
+{
+    traceSize = size;
+    traceAllPorts = ports.empty();
+
+    std::vector<std::string> names;
+    tokenize(names, ports, ',');
+    tracedPorts.setExpression(names);
+}
+
+PortTrace *
+PortTrace::create(const std::string &port_name)
+{
+    if (traceSize == 0 || !(traceAllPorts || tracedPorts.match(port_name)))
+        return nullptr;
+
+    return new PortTrace(port_name, traceSize);
+}
+
+void
+PortTrace::dumpAll(std::ostream &os)
+{
+    for (auto trace : traces()) {
+        if (trace->count)
+            trace->dump(os);
+    }
+}
+
+void
+PortTrace::dumpAll(const std::string &file_name)
+{
+    if (traces().empty())
+        return;
+
+    OutputStream *os = simout.create(file_name);
+    dumpAll(*os->stream());
+    simout.close(os);
+}
+
+void
+debugDumpPortTraces()
+{
+    PortTrace::dumpAll(std::cerr);
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Lightweight recording of the timing traffic through ports.
+ */
+
+#ifndef __MEM_PORT_TRACE_HH__
+#define __MEM_PORT_TRACE_HH__
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/packet.hh"
+#include "sim/core.hh"
+
+/**
+ * Ring buffer of the last timing packets and retries that went through
+ * a port. Ports only have a trace if tracing was enabled for them with
+ * configure() before they were created, in which case every
+ * sendTimingReq(), sendTimingResp() and retry costs a few stores. The
+ * traces are dumped on demand, and when gem5 aborts (e.g., when a
+ * deadlock is detected), to help finding out where packets got stuck.
+ */
+class PortTrace
+{
+  public:
+    enum Kind : uint8_t { Req, Resp, RetryReq, RetryResp };
+
+    struct Entry
+    {
+        Tick when;
+        Addr addr;
+        unsigned size;
+        MemCmd::Command cmd;
+        Kind kind;
+        /** Was the packet accepted by the peer? */
+        bool success;
+    };
+
+  private:
+    const std::string portName;
+
+    std::vector<Entry> entries;
+
+    /** Number of entries ever recorded */
+    uint64_t count;
+
+    /** Size of the ring buffer of new traces, 0 if tracing is off */
+    static unsigned traceSize;
+
+    /** All traces, in order of creation */
+    static std::vector<PortTrace *> &traces();
+
+  public:
+    PortTrace(const std::string &port_name, unsigned size);
+    ~PortTrace();
+
+    /**
+     * Record a packet. The entry can be updated with the outcome of
+     * the send once the peer has handled the packet, since the packet
+     * may be gone by then.
+     */
+    Entry &
+    record(const PacketPtr pkt, Kind kind)
+    {
+        Entry &entry = entries[count++ % entries.size()];
+        entry.when = curTick();
+        entry.addr = pkt->getAddr();
+        entry.size = pkt->getSize();
+        entry.cmd = (MemCmd::Command)pkt->cmd.toInt();
+        entry.kind = kind;
+        entry.success = true;
+        return entry;
+    }
+
+    /** Record a retry sent to the peer. */
+    void
+    recordRetry(Kind kind)
+    {
+        Entry &entry = entries[count++ % entries.size()];
+        entry.when = curTick();
+        entry.addr = 0;
+        entry.size = 0;
+        entry.cmd = MemCmd::InvalidCmd;
+        entry.kind = kind;
+        entry.success = true;
+    }
+
+    /** Print the recorded entries, oldest first. */
+    void dump(std::ostream &os) const;
+
+    /**
+     * Enable tracing for ports that are created from now on.
+     *
+     * @param size Number of entries kept per port, 0 disables tracing.
+     * @param ports Comma separated names of the ports to trace, or of
+     *        objects to trace all ports of, where * matches any
+     *        name component. All ports are traced if empty.
+     */
+    static void configure(unsigned size, const std::string &ports);
+
+    /**
+     * Create a trace for a new port if it should be traced.
+     *
+     * @return The trace, or nullptr if the port isn't traced.
+     */
+    static PortTrace *create(const std::string &port_name);
+
+    /** Dump all traces that have seen any traffic. */
+    static void dumpAll(std::ostream &os);
+
+    /** Dump all traces to a file in the output directory. */
+    static void dumpAll(const std::string &file_name);
+};
+
+/** Dump all port traces to stderr, meant to be called from gdb. */
+void debugDumpPortTraces();
+
+#endif // __MEM_PORT_TRACE_HH__
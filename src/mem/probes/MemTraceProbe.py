@@ -49,6 +49,11 @@ class MemTraceProbe(BaseMemProbe):
     # For requests with a valid PC, include the PC in the trace
     with_pc = Param.Bool(False, "Include PC info in the trace")
 
+    # Serialize and compress the trace on a separate thread, buffering
+    # this many records from the simulation thread (0 to disable)
+    write_buffer = Param.Unsigned(65536, "Number of records buffered for "
+                                  "the trace writer thread")
+
     # packet trace output file, disabled by default
     trace_file = Param.String("", "Packet trace output file")
 
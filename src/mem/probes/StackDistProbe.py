@@ -55,6 +55,10 @@ class StackDistProbe(BaseMemProbe):
     # enable verification stack
     verify = Param.Bool(False, "Verify behaviuor with reference implementation")
 
+    # spatial sampling of the cache lines (SHARDS), 1.0 profiles them all
+    sample_rate = Param.Float(1.0, "Fraction of the cache lines to profile, "
+                              "distances are scaled up accordingly")
+
     # linear histogram bins and enable/disable
     linear_hist_bins = Param.Unsigned('16', "Bins in linear histograms")
     disable_linear_hists = Param.Bool(False, "Disable linear histograms")
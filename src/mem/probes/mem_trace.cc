@@ -40,6 +40,8 @@
 
 #include "mem/probes/mem_trace.hh"
 
+#include <algorithm>
+
 #include "base/callback.hh"
 #include "base/output.hh"
 #include "params/MemTraceProbe.hh"
@@ -50,7 +52,11 @@ MemTraceProbe::MemTraceProbe(MemTraceProbeParams *p)
     : BaseMemProbe(p),
       traceStream(nullptr),
       system(p->system),
-      withPC(p->with_pc)
+      withPC(p->with_pc),
+      ring(p->write_buffer ? p->write_buffer : 1),
+      batchSize(std::max<size_t>(ring.capacity() / 8, 1)),
+      unsignaled(0),
+      writerStop(false)
 {
     std::string filename;
     if (p->trace_file != "") {
@@ -97,32 +103,104 @@ MemTraceProbe::startup()
     }
 
     traceStream->write(header_msg);
+
+    // From now on, the writer thread owns the stream
+    const auto *p = dynamic_cast<const MemTraceProbeParams *>(params());
+    assert(p);
+    if (p->write_buffer)
+        writer = std::thread([this]{ writeLoop(); });
 }
 
 void
 MemTraceProbe::closeStreams()
 {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(writerLock);
+            writerStop = true;
+        }
+        writerWake.notify_one();
+        writer.join();
+    }
+
     if (traceStream != NULL)
         delete traceStream;
+    traceStream = NULL;
 }
 
 void
-MemTraceProbe::handleRequest(const ProbePoints::PacketInfo &pkt_info)
+MemTraceProbe::signalWriter()
+{
+    // Taking the lock orders this with the writer checking whether it
+    // should sleep, so the wake up can't be lost
+    {
+        std::lock_guard<std::mutex> lock(writerLock);
+    }
+    writerWake.notify_one();
+    unsignaled = 0;
+}
+
+void
+MemTraceProbe::writeLoop()
+{
+    Record rec;
+    bool stop = false;
+    while (!stop) {
+        {
+            std::unique_lock<std::mutex> lock(writerLock);
+            writerWake.wait(lock, [this]{
+                return writerStop || ring.size() >= batchSize;
+            });
+            stop = writerStop;
+        }
+
+        // Drain everything, including the last partial batch on exit
+        while (ring.pop(rec))
+            write(rec);
+    }
+}
+
+void
+MemTraceProbe::write(const Record &rec)
 {
     ProtoMessage::Packet pkt_msg;
 
-    pkt_msg.set_tick(curTick());
-    pkt_msg.set_cmd(pkt_info.cmd.toInt());
-    pkt_msg.set_flags(pkt_info.flags);
-    pkt_msg.set_addr(pkt_info.addr);
-    pkt_msg.set_size(pkt_info.size);
-    if (withPC && pkt_info.pc != 0)
-        pkt_msg.set_pc(pkt_info.pc);
-    pkt_msg.set_pkt_id(pkt_info.master);
+    pkt_msg.set_tick(rec.tick);
+    pkt_msg.set_cmd(rec.cmd);
+    pkt_msg.set_flags(rec.flags);
+    pkt_msg.set_addr(rec.addr);
+    pkt_msg.set_size(rec.size);
+    if (withPC && rec.pc != 0)
+        pkt_msg.set_pc(rec.pc);
+    pkt_msg.set_pkt_id(rec.master);
 
     traceStream->write(pkt_msg);
 }
 
+void
+MemTraceProbe::handleRequest(const ProbePoints::PacketInfo &pkt_info)
+{
+    const Record rec = {
+        curTick(), pkt_info.addr, pkt_info.pc,
+        (uint32_t)pkt_info.cmd.toInt(), pkt_info.flags, pkt_info.size,
+        (uint32_t)pkt_info.master
+    };
+
+    if (!writer.joinable()) {
+        write(rec);
+        return;
+    }
+
+    // Wait for the writer if it fell behind by a whole ring
+    while (!ring.push(rec)) {
+        signalWriter();
+        std::this_thread::yield();
+    }
+
+    if (++unsignaled == batchSize)
+        signalWriter();
+}
+
 
 MemTraceProbe *
 MemTraceProbeParams::create()
@@ -40,6 +40,11 @@
 #ifndef __MEM_PROBES_MEM_TRACE_HH__
 #define __MEM_PROBES_MEM_TRACE_HH__
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "base/spsc_ring.hh"
 #include "mem/packet.hh"
 #include "mem/probes/base.hh"
 #include "proto/protoio.hh"
@@ -72,8 +77,45 @@ class MemTraceProbe : public BaseMemProbe
 
   private:
 
+    /** Fields of a traced request, as queued for the writer thread */
+    struct Record
+    {
+        Tick tick;
+        Addr addr;
+        Addr pc;
+        uint32_t cmd;
+        Request::FlagsType flags;
+        uint32_t size;
+        uint32_t master;
+    };
+
+    /** Serialize a record to the trace stream */
+    void write(const Record &rec);
+
+    /** Main loop of the writer thread */
+    void writeLoop();
+
     /** Include the Program Counter in the memory trace */
     const bool withPC;
+
+    /**
+     * @{
+     * Records are passed to the writer thread, which owns traceStream
+     * once it's started, through a lock-free ring. The simulation
+     * thread only takes writerLock to wake the writer up once every
+     * batchSize records, or when the ring is full.
+     */
+    SPSCRing<Record> ring;
+    const size_t batchSize;
+    size_t unsignaled;
+    bool writerStop;
+    std::mutex writerLock;
+    std::condition_variable writerWake;
+    std::thread writer;
+    /** @} */
+
+    /** Wake the writer thread up */
+    void signalWriter();
 };
 
 #endif //__MEM_PROBES_MEM_TRACE_HH__
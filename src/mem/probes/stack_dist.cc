@@ -47,11 +47,15 @@ StackDistProbe::StackDistProbe(StackDistProbeParams *p)
       lineSize(p->line_size),
       disableLinearHists(p->disable_linear_hists),
       disableLogHists(p->disable_log_hists),
+      sampleThreshold(p->sample_rate * (1 << 24)),
+      sampleRate(p->sample_rate),
       calc(p->verify)
 {
     fatal_if(p->system->cacheLineSize() > p->line_size,
              "The stack distance probe must use a cache line size that is "
              "larger or equal to the system's cahce line size.");
+    fatal_if(p->sample_rate <= 0 || p->sample_rate > 1,
+             "The stack distance probe's sample rate must be in (0, 1].");
 }
 
 void
@@ -106,12 +110,21 @@ StackDistProbe::handleRequest(const ProbePoints::PacketInfo &pkt_info)
     // Align the address to a cache line size
     const Addr aligned_addr(roundDown(pkt_info.addr, lineSize));
 
+    // Only profile the sampled lines
+    if (sampleThreshold < (1 << 24)) {
+        const uint64_t hash((aligned_addr / lineSize) * 0x9e3779b97f4a7c15ULL);
+        if ((hash >> 40) >= sampleThreshold)
+            return;
+    }
+
     // Calculate the stack distance
-    const uint64_t sd(calc.calcStackDistAndUpdate(aligned_addr).first);
+    uint64_t sd(calc.calcStackDistAndUpdate(aligned_addr).first);
     if (sd == StackDistCalc::Infinity) {
         infiniteSD++;
         return;
     }
+    if (sampleThreshold < (1 << 24))
+        sd = sd / sampleRate;
 
     // Sample the stack distance of the address in linear bins
     if (!disableLinearHists) {
@@ -67,6 +67,18 @@ class StackDistProbe : public BaseMemProbe
     // Disable the logarithmic histograms
     const bool disableLogHists;
 
+    /**
+     * Lines are sampled spatially: a line is profiled if a hash of
+     * its address is below this threshold, out of 2^24. Since all
+     * the accesses to a sampled line are profiled, the stack distance
+     * among the sampled lines, divided by the sampling rate, estimates
+     * the stack distance among all lines.
+     */
+    const uint64_t sampleThreshold;
+
+    // Fraction of the lines that are sampled
+    const double sampleRate;
+
   protected:
     // Reads linear histogram
     Stats::Histogram readLinearHist;
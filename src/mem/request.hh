@@ -57,6 +57,7 @@
 
 #include "base/flags.hh"
 #include "base/logging.hh"
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
 #include "sim/core.hh"
@@ -87,6 +88,22 @@ typedef uint16_t MasterID;
 class Request
 {
   public:
+    /**
+     * @{
+     * Requests are allocated from a thread-local free-list pool, see
+     * PoolAllocator.
+     */
+    typedef PoolAllocator<Request> Pool;
+
+    static void *operator new(size_t size) { return Pool::allocate(size); }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        Pool::deallocate(p, size);
+    }
+    /** @} */
+
     typedef uint64_t FlagsType;
     typedef uint8_t ArchFlagsType;
     typedef ::Flags<FlagsType> Flags;
@@ -35,8 +35,9 @@
 #ifndef __MEM_RUBY_COMMON_CONSUMER_HH__
 #define __MEM_RUBY_COMMON_CONSUMER_HH__
 
+#include <algorithm>
 #include <iostream>
-#include <set>
+#include <vector>
 
 #include "sim/clocked_object.hh"
 
@@ -59,22 +60,34 @@ class Consumer
     bool
     alreadyScheduled(Tick time)
     {
-        return m_scheduled_wakeups.find(time) != m_scheduled_wakeups.end();
+        return std::binary_search(m_scheduled_wakeups.begin(),
+                                  m_scheduled_wakeups.end(), time);
     }
 
     void
     insertScheduledWakeupTime(Tick time)
     {
-        m_scheduled_wakeups.insert(time);
+        auto it = std::lower_bound(m_scheduled_wakeups.begin(),
+                                   m_scheduled_wakeups.end(), time);
+        if (it == m_scheduled_wakeups.end() || *it != time)
+            m_scheduled_wakeups.insert(it, time);
     }
 
     void scheduleEventAbsolute(Tick timeAbs);
 
+    /** The event queue the wakeups of this consumer run on. */
+    EventQueue *eventQueue() const { return em->eventQueue(); }
+
   protected:
     void scheduleEvent(Cycles timeDelta);
 
   private:
-    std::set<Tick> m_scheduled_wakeups;
+    /**
+     * Sorted times of the pending wakeups. A consumer rarely has more
+     * than a handful of wakeups pending, so a sorted vector beats a
+     * tree and stops allocating once it has reached its working size.
+     */
+    std::vector<Tick> m_scheduled_wakeups;
     ClockedObject *em;
 };
 
@@ -33,7 +33,8 @@
 
 DataBlock::DataBlock(const DataBlock &cp)
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
+    m_data = static_cast<uint8_t *>(
+        Pool::allocate(RubySystem::getBlockSizeBytes()));
     memcpy(m_data, cp.m_data, RubySystem::getBlockSizeBytes());
     m_alloc = true;
 }
@@ -41,11 +42,18 @@ DataBlock::DataBlock(const DataBlock &cp)
 void
 DataBlock::alloc()
 {
-    m_data = new uint8_t[RubySystem::getBlockSizeBytes()];
+    m_data = static_cast<uint8_t *>(
+        Pool::allocate(RubySystem::getBlockSizeBytes()));
     m_alloc = true;
     clear();
 }
 
+void
+DataBlock::release()
+{
+    Pool::deallocate(m_data, RubySystem::getBlockSizeBytes());
+}
+
 void
 DataBlock::clear()
 {
@@ -61,19 +69,16 @@ DataBlock::equal(const DataBlock& obj) const
 void
 DataBlock::copyPartial(const DataBlock &dblk, const WriteMask &mask)
 {
-    for (int i = 0; i < RubySystem::getBlockSizeBytes(); i++) {
-        if (mask.getMask(i, 1)) {
-            m_data[i] = dblk.m_data[i];
-        }
-    }
+    // copy whole runs of masked bytes rather than byte by byte
+    mask.forEachRun([this, &dblk](int offset, int len) {
+        memcpy(&m_data[offset], &dblk.m_data[offset], len);
+    });
 }
 
 void
 DataBlock::atomicPartial(const DataBlock &dblk, const WriteMask &mask)
 {
-    for (int i = 0; i < RubySystem::getBlockSizeBytes(); i++) {
-        m_data[i] = dblk.m_data[i];
-    }
+    memcpy(m_data, dblk.m_data, RubySystem::getBlockSizeBytes());
     mask.performAtomic(m_data);
 }
 
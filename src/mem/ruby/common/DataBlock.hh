@@ -35,6 +35,8 @@
 #include <iomanip>
 #include <iostream>
 
+#include "base/pool_alloc.hh"
+
 class WriteMask;
 
 class DataBlock
@@ -50,7 +52,7 @@ class DataBlock
     ~DataBlock()
     {
         if (m_alloc)
-            delete [] m_data;
+            release();
     }
 
     DataBlock& operator=(const DataBlock& obj);
@@ -70,7 +72,14 @@ class DataBlock
     void print(std::ostream& out) const;
 
   private:
+    /**
+     * Blocks are served from a free-list pool, since every message and
+     * cache entry carrying data holds one.
+     */
+    typedef PoolAllocator<DataBlock> Pool;
+
     void alloc();
+    void release();
     uint8_t *m_data;
     bool m_alloc;
 };
@@ -80,7 +89,7 @@ DataBlock::assign(uint8_t *data)
 {
     assert(data != NULL);
     if (m_alloc) {
-        delete [] m_data;
+        release();
     }
     m_data = data;
     m_alloc = false;
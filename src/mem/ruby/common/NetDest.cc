@@ -30,24 +30,56 @@
 
 #include <algorithm>
 
+#include "base/bitfield.hh"
+
 NetDest::NetDest()
 {
   resize();
 }
 
+uint64_t
+NetDest::broadcastMask(MachineType machine, int word)
+{
+    int bits = MachineType_base_count(machine) - word * BitsPerWord;
+    if (bits <= 0)
+        return 0;
+    if (bits >= BitsPerWord)
+        return ~0ULL;
+    return (1ULL << bits) - 1;
+}
+
+MachineID
+NetDest::lowestElement(int w, uint64_t bits)
+{
+    assert(bits != 0);
+    int vec_index = w / WordsPerType;
+    MachineID mach = {MachineType_from_base_level(vec_index),
+                      (NodeID)((w % WordsPerType) * BitsPerWord +
+                               findLsbSet(bits))};
+    return mach;
+}
+
+void
+NetDest::checkSize(int size)
+{
+    if (size > NUMBER_BITS_PER_SET)
+        fatal("Number of bits(%d) < size specified(%d). "
+              "Increase the number of bits and recompile.\n",
+              NUMBER_BITS_PER_SET, size);
+}
+
 void
 NetDest::add(MachineID newElement)
 {
-    assert(bitIndex(newElement.num) < m_bits[vecIndex(newElement)].getSize());
-    m_bits[vecIndex(newElement)].add(bitIndex(newElement.num));
+    checkSize(newElement.num + 1);
+    word(newElement) |= mask(newElement);
 }
 
 void
 NetDest::addNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].addSet(netDest.m_bits[i]);
+    for (int i = 0; i < NumWords; i++) {
+        m_bits[i] |= netDest.m_bits[i];
     }
 }
 
@@ -57,30 +89,32 @@ NetDest::setNetDest(MachineType machine, const Set& set)
     // assure that there is only one set of destinations for this machine
     assert(MachineType_base_level((MachineType)(machine + 1)) -
            MachineType_base_level(machine) == 1);
-    m_bits[MachineType_base_level(machine)] = set;
+    uint64_t *bits = &m_bits[MachineType_base_level(machine) * WordsPerType];
+    std::fill(bits, bits + WordsPerType, 0);
+    for (NodeID i = 0; i < set.getSize(); i++) {
+        if (set.isElement(i))
+            bits[i / BitsPerWord] |= 1ULL << (i % BitsPerWord);
+    }
 }
 
 void
 NetDest::remove(MachineID oldElement)
 {
-    m_bits[vecIndex(oldElement)].remove(bitIndex(oldElement.num));
+    word(oldElement) &= ~mask(oldElement);
 }
 
 void
 NetDest::removeNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].removeSet(netDest.m_bits[i]);
+    for (int i = 0; i < NumWords; i++) {
+        m_bits[i] &= ~netDest.m_bits[i];
     }
 }
 
 void
 NetDest::clear()
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].clear();
-    }
+    std::fill(m_bits, m_bits + NumWords, 0);
 }
 
 void
@@ -95,9 +129,11 @@ NetDest::broadcast()
 void
 NetDest::broadcast(MachineType machineType)
 {
-    for (NodeID i = 0; i < MachineType_base_count(machineType); i++) {
-        MachineID mach = {machineType, i};
-        add(mach);
+    checkSize(MachineType_base_count(machineType));
+    uint64_t *bits =
+        &m_bits[MachineType_base_level(machineType) * WordsPerType];
+    for (int w = 0; w < WordsPerType; w++) {
+        bits[w] |= broadcastMask(machineType, w);
     }
 }
 
@@ -106,13 +142,12 @@ std::vector<NodeID>
 NetDest::getAllDest()
 {
     std::vector<NodeID> dest;
-    dest.clear();
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                int id = MachineType_base_number((MachineType)i) + j;
-                dest.push_back((NodeID)id);
-            }
+    dest.reserve(count());
+    for (int w = 0; w < NumWords; w++) {
+        for (uint64_t bits = m_bits[w]; bits; bits &= bits - 1) {
+            MachineID mach = lowestElement(w, bits);
+            int id = MachineType_base_number(mach.type) + mach.num;
+            dest.push_back((NodeID)id);
         }
     }
     return dest;
@@ -122,8 +157,8 @@ int
 NetDest::count() const
 {
     int counter = 0;
-    for (int i = 0; i < m_bits.size(); i++) {
-        counter += m_bits[i].count();
+    for (int i = 0; i < NumWords; i++) {
+        counter += popCount(m_bits[i]);
     }
     return counter;
 }
@@ -131,20 +166,16 @@ NetDest::count() const
 NodeID
 NetDest::elementAt(MachineID index)
 {
-    return m_bits[vecIndex(index)].elementAt(bitIndex(index.num));
+    return isElement(index);
 }
 
 MachineID
 NetDest::smallestElement() const
 {
     assert(count() > 0);
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (NodeID j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                MachineID mach = {MachineType_from_base_level(i), j};
-                return mach;
-            }
-        }
+    for (int w = 0; w < NumWords; w++) {
+        if (m_bits[w])
+            return lowestElement(w, m_bits[w]);
     }
     panic("No smallest element of an empty set.");
 }
@@ -152,12 +183,10 @@ NetDest::smallestElement() const
 MachineID
 NetDest::smallestElement(MachineType machine) const
 {
-    int size = m_bits[MachineType_base_level(machine)].getSize();
-    for (NodeID j = 0; j < size; j++) {
-        if (m_bits[MachineType_base_level(machine)].isElement(j)) {
-            MachineID mach = {machine, j};
-            return mach;
-        }
+    int first = MachineType_base_level(machine) * WordsPerType;
+    for (int w = first; w < first + WordsPerType; w++) {
+        if (m_bits[w])
+            return lowestElement(w, m_bits[w]);
     }
 
     panic("No smallest element of given MachineType.");
@@ -167,8 +196,9 @@ NetDest::smallestElement(MachineType machine) const
 bool
 NetDest::isBroadcast() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isBroadcast()) {
+    for (int w = 0; w < NumWords; w++) {
+        MachineType machine = MachineType_from_base_level(w / WordsPerType);
+        if (m_bits[w] != broadcastMask(machine, w % WordsPerType)) {
             return false;
         }
     }
@@ -179,8 +209,8 @@ NetDest::isBroadcast() const
 bool
 NetDest::isEmpty() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isEmpty()) {
+    for (int i = 0; i < NumWords; i++) {
+        if (m_bits[i]) {
             return false;
         }
     }
@@ -191,10 +221,9 @@ NetDest::isEmpty() const
 NetDest
 NetDest::OR(const NetDest& orNetDest) const
 {
-    assert(m_bits.size() == orNetDest.getSize());
     NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].OR(orNetDest.m_bits[i]);
+    for (int i = 0; i < NumWords; i++) {
+        result.m_bits[i] = m_bits[i] | orNetDest.m_bits[i];
     }
     return result;
 }
@@ -203,10 +232,9 @@ NetDest::OR(const NetDest& orNetDest) const
 NetDest
 NetDest::AND(const NetDest& andNetDest) const
 {
-    assert(m_bits.size() == andNetDest.getSize());
     NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
-        result.m_bits[i] = m_bits[i].AND(andNetDest.m_bits[i]);
+    for (int i = 0; i < NumWords; i++) {
+        result.m_bits[i] = m_bits[i] & andNetDest.m_bits[i];
     }
     return result;
 }
@@ -215,9 +243,8 @@ NetDest::AND(const NetDest& andNetDest) const
 bool
 NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 {
-    assert(m_bits.size() == other_netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].intersectionIsEmpty(other_netDest.m_bits[i])) {
+    for (int i = 0; i < NumWords; i++) {
+        if (m_bits[i] & other_netDest.m_bits[i]) {
             return true;
         }
     }
@@ -227,10 +254,8 @@ NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 bool
 NetDest::isSuperset(const NetDest& test) const
 {
-    assert(m_bits.size() == test.getSize());
-
-    for (int i = 0; i < m_bits.size(); i++) {
-        if (!m_bits[i].isSuperset(test.m_bits[i])) {
+    for (int i = 0; i < NumWords; i++) {
+        if (test.m_bits[i] & ~m_bits[i]) {
             return false;
         }
     }
@@ -240,28 +265,26 @@ NetDest::isSuperset(const NetDest& test) const
 bool
 NetDest::isElement(MachineID element) const
 {
-    return ((m_bits[vecIndex(element)])).isElement(bitIndex(element.num));
+    return word(element) & mask(element);
 }
 
 void
 NetDest::resize()
 {
-    m_bits.resize(MachineType_base_level(MachineType_NUM));
-    assert(m_bits.size() == MachineType_NUM);
-
-    for (int i = 0; i < m_bits.size(); i++) {
-        m_bits[i].setSize(MachineType_base_count((MachineType)i));
-    }
+    assert(MachineType_base_level(MachineType_NUM) == MachineType_NUM);
+    clear();
 }
 
 void
 NetDest::print(std::ostream& out) const
 {
-    out << "[NetDest (" << m_bits.size() << ") ";
+    out << "[NetDest (" << getSize() << ") ";
 
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            out << (bool) m_bits[i].isElement(j) << " ";
+    for (MachineType machine = MachineType_FIRST;
+         machine < MachineType_NUM; ++machine) {
+        for (NodeID j = 0; j < MachineType_base_count(machine); j++) {
+            MachineID mach = {machine, j};
+            out << isElement(mach) << " ";
         }
         out << " - ";
     }
@@ -271,10 +294,5 @@ NetDest::print(std::ostream& out) const
 bool
 NetDest::isEqual(const NetDest& n) const
 {
-    assert(m_bits.size() == n.m_bits.size());
-    for (unsigned int i = 0; i < m_bits.size(); ++i) {
-        if (!m_bits[i].isEqual(n.m_bits[i]))
-            return false;
-    }
-    return true;
+    return std::equal(m_bits, m_bits + NumWords, n.m_bits);
 }
@@ -29,13 +29,20 @@
 #ifndef __MEM_RUBY_COMMON_NETDEST_HH__
 #define __MEM_RUBY_COMMON_NETDEST_HH__
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
 #include "mem/ruby/common/Set.hh"
 #include "mem/ruby/common/MachineID.hh"
 
-// NetDest specifies the network destination of a Message
+// NetDest specifies the network destination of a Message.
+//
+// The destinations are kept in a fixed-size bitmap with
+// NUMBER_BITS_PER_SET bits for every machine type, so NetDests
+// can be built, copied and combined without touching the heap. Set
+// operations work a word at a time, and elements are found by
+// scanning for set bits rather than testing every machine.
 class NetDest
 {
   public:
@@ -85,7 +92,7 @@ class NetDest
     MachineID smallestElement(MachineType machine) const;
 
     void resize();
-    int getSize() const { return m_bits.size(); }
+    int getSize() const { return MachineType_NUM; }
 
     // get element for a index
     NodeID elementAt(MachineID index);
@@ -93,19 +100,59 @@ class NetDest
     void print(std::ostream& out) const;
 
   private:
+    static const int BitsPerWord = 64;
+    static const int WordsPerType =
+        (NUMBER_BITS_PER_SET + BitsPerWord - 1) / BitsPerWord;
+    static const int NumWords = MachineType_NUM * WordsPerType;
+
     // returns a value >= MachineType_base_level("this machine")
     // and < MachineType_base_level("next highest machine")
     int
     vecIndex(MachineID m) const
     {
         int vec_index = MachineType_base_level(m.type);
-        assert(vec_index < m_bits.size());
+        assert(vec_index < MachineType_NUM);
         return vec_index;
     }
 
     NodeID bitIndex(NodeID index) const { return index; }
 
-    std::vector<Set> m_bits;  // a vector of bit vectors - i.e. Sets
+    // The word holding the bit of a machine
+    uint64_t &
+    word(MachineID m)
+    {
+        assert(bitIndex(m.num) < NUMBER_BITS_PER_SET);
+        return m_bits[vecIndex(m) * WordsPerType +
+                      bitIndex(m.num) / BitsPerWord];
+    }
+
+    const uint64_t &
+    word(MachineID m) const
+    {
+        assert(bitIndex(m.num) < NUMBER_BITS_PER_SET);
+        return m_bits[vecIndex(m) * WordsPerType +
+                      bitIndex(m.num) / BitsPerWord];
+    }
+
+    // Fail if a machine type has more machines than a bitmap can hold
+    static void checkSize(int size);
+
+    static uint64_t
+    mask(MachineID m)
+    {
+        return 1ULL << (m.num % BitsPerWord);
+    }
+
+    // The bits of the given word of a machine type that belong to
+    // existing machines
+    static uint64_t broadcastMask(MachineType machine, int word);
+
+    // The lowest element in word w of the bitmap, which has the
+    // given (non-zero) bits set
+    static MachineID lowestElement(int w, uint64_t bits);
+
+    // one bitmap of WordsPerType words for each machine type
+    uint64_t m_bits[NumWords];
 };
 
 inline std::ostream&
@@ -37,7 +37,7 @@ WriteMask::print(std::ostream& out) const
 {
     std::string str(mSize,'0');
     for (int i = 0; i < mSize; i++) {
-        str[i] = mMask[i] ? ('1') : ('0');
+        str[i] = getMask(i, 1) ? ('1') : ('0');
     }
     out << "dirty mask="
         << str
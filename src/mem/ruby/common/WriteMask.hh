@@ -29,11 +29,14 @@
 #ifndef __MEM_RUBY_COMMON_WRITEMASK_HH__
 #define __MEM_RUBY_COMMON_WRITEMASK_HH__
 
+#include <algorithm>
 #include <cassert>
 #include <iomanip>
 #include <iostream>
 #include <vector>
 
+#include "base/bitfield.hh"
+#include "base/types.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 #include "mem/ruby/system/RubySystem.hh"
 
@@ -41,22 +44,27 @@ class WriteMask
 {
   public:
     WriteMask()
-      : mSize(RubySystem::getBlockSizeBytes()), mMask(mSize, false),
+      : mSize(RubySystem::getBlockSizeBytes()), mMask(numWords(mSize), 0),
         mAtomic(false)
     {}
 
     WriteMask(int size)
-      : mSize(size), mMask(size, false), mAtomic(false)
+      : mSize(size), mMask(numWords(size), 0), mAtomic(false)
     {}
 
     WriteMask(int size, std::vector<bool> & mask)
-      : mSize(size), mMask(mask), mAtomic(false)
-    {}
+      : mSize(size), mMask(numWords(size), 0), mAtomic(false)
+    {
+        setMask(mask);
+    }
 
     WriteMask(int size, std::vector<bool> &mask,
               std::vector<std::pair<int, AtomicOpFunctor*> > atomicOp)
-      : mSize(size), mMask(mask), mAtomic(true), mAtomicOp(atomicOp)
-    {}
+      : mSize(size), mMask(numWords(size), 0), mAtomic(true),
+        mAtomicOp(atomicOp)
+    {
+        setMask(mask);
+    }
 
     ~WriteMask()
     {}
@@ -64,73 +72,69 @@ class WriteMask
     void
     clear()
     {
-        mMask = std::vector<bool>(mSize, false);
+        std::fill(mMask.begin(), mMask.end(), 0);
     }
 
     bool
     test(int offset)
     {
         assert(offset < mSize);
-        return mMask[offset];
+        return mMask[offset / WordBits] & (ULL(1) << (offset % WordBits));
     }
 
     void
     setMask(int offset, int len)
     {
         assert(mSize >= (offset + len));
-        for (int i = 0; i < len; i++) {
-            mMask[offset + i] = true;
-        }
+        forEachWord(offset, len, [this](int w, uint64_t bits) {
+            mMask[w] |= bits;
+            return true;
+        });
     }
+
     void
     fillMask()
     {
-        for (int i = 0; i < mSize; i++) {
-            mMask[i] = true;
-        }
+        setMask(0, mSize);
     }
 
     bool
     getMask(int offset, int len) const
     {
-        bool tmp = true;
         assert(mSize >= (offset + len));
-        for (int i = 0; i < len; i++) {
-            tmp = tmp & mMask.at(offset + i);
-        }
-        return tmp;
+        return forEachWord(offset, len, [this](int w, uint64_t bits) {
+            return (mMask[w] & bits) == bits;
+        });
     }
 
     bool
     isOverlap(const WriteMask &readMask) const
     {
-        bool tmp = false;
         assert(mSize == readMask.mSize);
-        for (int i = 0; i < mSize; i++) {
-            if (readMask.mMask.at(i)) {
-                tmp = tmp | mMask.at(i);
+        for (int w = 0; w < mMask.size(); w++) {
+            if (readMask.mMask[w] & mMask[w]) {
+                return true;
             }
         }
-        return tmp;
+        return false;
     }
 
     bool
     cmpMask(const WriteMask &readMask) const
     {
-        bool tmp = true;
         assert(mSize == readMask.mSize);
-        for (int i = 0; i < mSize; i++) {
-            if (readMask.mMask.at(i)) {
-                tmp = tmp & mMask.at(i);
+        for (int w = 0; w < mMask.size(); w++) {
+            if (readMask.mMask[w] & ~mMask[w]) {
+                return false;
             }
         }
-        return tmp;
+        return true;
     }
 
     bool isEmpty() const
     {
-        for (int i = 0; i < mSize; i++) {
-            if (mMask.at(i)) {
+        for (int w = 0; w < mMask.size(); w++) {
+            if (mMask[w]) {
                 return false;
             }
         }
@@ -140,20 +144,15 @@ class WriteMask
     bool
     isFull() const
     {
-        for (int i = 0; i < mSize; i++) {
-            if (!mMask.at(i)) {
-                return false;
-            }
-        }
-        return true;
+        return getMask(0, mSize);
     }
 
     void
     orMask(const WriteMask & writeMask)
     {
         assert(mSize == writeMask.mSize);
-        for (int i = 0; i < mSize; i++) {
-            mMask[i] = (mMask.at(i)) | (writeMask.mMask.at(i));
+        for (int w = 0; w < mMask.size(); w++) {
+            mMask[w] |= writeMask.mMask[w];
         }
 
         if (writeMask.mAtomic) {
@@ -162,6 +161,43 @@ class WriteMask
         }
     }
 
+    /**
+     * Call f(offset, len) for every run of consecutive bytes that are
+     * set in the mask, in increasing order of offset.
+     */
+    template <typename F>
+    void
+    forEachRun(F f) const
+    {
+        int offset = 0;
+        while (offset < mSize) {
+            // skip to the first byte that is set
+            const int bit = offset % WordBits;
+            const uint64_t set = mMask[offset / WordBits] >> bit;
+            if (!set) {
+                offset += WordBits - bit;
+                continue;
+            }
+            offset += findLsbSet(set);
+
+            // and find the end of the run, which may span several
+            // words
+            int end = offset;
+            while (end < mSize) {
+                const int b = end % WordBits;
+                const int run = findLsbSet(~(mMask[end / WordBits] >> b));
+                end += run;
+                if (b + run < WordBits) {
+                    break;
+                }
+            }
+            end = std::min(end, mSize);
+
+            f(offset, end - offset);
+            offset = end;
+        }
+    }
+
     void print(std::ostream& out) const;
 
     void
@@ -185,8 +221,50 @@ class WriteMask
         }
     }
   private:
+    /**
+     * The mask holds one bit per byte, packed in words, so that a 64
+     * byte block fits in a single word.
+     */
+    static const int WordBits = 64;
+
+    static int numWords(int size) { return (size + WordBits - 1) / WordBits; }
+
+    /**
+     * Call f(word, bits) for every word covering the byte range, with
+     * the bits of the range within that word. Stop and return false
+     * as soon as f does.
+     */
+    template <typename F>
+    static bool
+    forEachWord(int offset, int len, F f)
+    {
+        while (len > 0) {
+            const int bit = offset % WordBits;
+            const int n = std::min(len, WordBits - bit);
+            const uint64_t bits = (n == WordBits ? ~ULL(0) :
+                                   ((ULL(1) << n) - 1)) << bit;
+            if (!f(offset / WordBits, bits)) {
+                return false;
+            }
+            offset += n;
+            len -= n;
+        }
+        return true;
+    }
+
+    void
+    setMask(const std::vector<bool> &mask)
+    {
+        assert(mask.size() <= mSize);
+        for (int i = 0; i < mask.size(); i++) {
+            if (mask[i]) {
+                mMask[i / WordBits] |= ULL(1) << (i % WordBits);
+            }
+        }
+    }
+
     int mSize;
-    std::vector<bool> mMask;
+    std::vector<uint64_t> mMask;
     bool mAtomic;
     std::vector<std::pair<int, AtomicOpFunctor*> > mAtomicOp;
 };
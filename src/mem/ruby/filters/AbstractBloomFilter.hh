@@ -45,6 +45,20 @@ class AbstractBloomFilter
     virtual void unset(Addr addr) = 0;
 
     virtual bool isSet(Addr addr) = 0;
+
+    /**
+     * Look up several addresses at once, setting results[i] to
+     * isSet(addrs[i]). Filters override this when they can share work
+     * across the batch, e.g. by evaluating one hash for every address
+     * before moving on to the next.
+     */
+    virtual void
+    isSetBatch(const Addr *addrs, int count, bool *results)
+    {
+        for (int i = 0; i < count; ++i)
+            results[i] = isSet(addrs[i]);
+    }
+
     virtual int getCount(Addr addr) = 0;
     virtual int getTotalCount() = 0;
 
@@ -37,20 +37,12 @@
 using namespace std;
 
 BulkBloomFilter::BulkBloomFilter(int size)
+    : m_filter(size)
 {
     m_filter_size = size;
     m_filter_size_bits = floorLog2(m_filter_size);
     // split the filter bits in half, c0 and c1
     m_sector_bits = m_filter_size_bits - 1;
-
-    m_temp_filter.resize(m_filter_size);
-    m_filter.resize(m_filter_size);
-    clear();
-
-    // clear temp filter
-    for (int i = 0; i < m_filter_size; ++i) {
-        m_temp_filter[i] = 0;
-    }
 }
 
 BulkBloomFilter::~BulkBloomFilter()
@@ -60,9 +52,7 @@ BulkBloomFilter::~BulkBloomFilter()
 void
 BulkBloomFilter::clear()
 {
-    for (int i = 0; i < m_filter_size; i++) {
-        m_filter[i] = 0;
-    }
+    m_filter.clear();
 }
 
 void
@@ -80,11 +70,13 @@ BulkBloomFilter::decrement(Addr addr)
 void
 BulkBloomFilter::merge(AbstractBloomFilter * other_filter)
 {
-    // TODO
+    // assumes both filters are the same size!
+    BulkBloomFilter * temp = (BulkBloomFilter*) other_filter;
+    m_filter.merge(temp->m_filter);
 }
 
 void
-BulkBloomFilter::set(Addr addr)
+BulkBloomFilter::get_bits(Addr addr, int &v1, int &v0)
 {
     // c0 contains the cache index bits
     int set_bits = m_sector_bits;
@@ -94,13 +86,17 @@ BulkBloomFilter::set(Addr addr)
     //Address permuted_bits = permute(addr);
     //int c1 = permuted_bits.bitSelect(0, set_bits-1);
     int c1 = bitSelect(addr, block_bits+set_bits, (block_bits+2*set_bits) - 1);
-    //assert(c0 < (m_filter_size/2));
-    //assert(c0 + (m_filter_size/2) < m_filter_size);
-    //assert(c1 < (m_filter_size/2));
-    // set v0 bit
-    m_filter[c0 + (m_filter_size/2)] = 1;
-    // set v1 bit
-    m_filter[c1] = 1;
+    v1 = c1;
+    v0 = c0 + (m_filter_size / 2);
+}
+
+void
+BulkBloomFilter::set(Addr addr)
+{
+    int v1, v0;
+    get_bits(addr, v1, v0);
+    m_filter.set(v0);
+    m_filter.set(v1);
 }
 
 void
@@ -112,57 +108,13 @@ BulkBloomFilter::unset(Addr addr)
 bool
 BulkBloomFilter::isSet(Addr addr)
 {
-    // c0 contains the cache index bits
-    int set_bits = m_sector_bits;
-    int block_bits = RubySystem::getBlockSizeBits();
-    int c0 = bitSelect(addr, block_bits, block_bits + set_bits - 1);
-    // c1 contains the lower 10 permuted bits
-    //Address permuted_bits = permute(addr);
-    //int c1 = permuted_bits.bitSelect(0, set_bits-1);
-    int c1 = bitSelect(addr, block_bits+set_bits, (block_bits+2*set_bits) - 1);
-    //assert(c0 < (m_filter_size/2));
-    //assert(c0 + (m_filter_size/2) < m_filter_size);
-    //assert(c1 < (m_filter_size/2));
-    // set v0 bit
-    m_temp_filter[c0 + (m_filter_size/2)] = 1;
-    // set v1 bit
-    m_temp_filter[c1] = 1;
-
-    // perform filter intersection. If any c part is 0, no possibility
-    // of address being in signature.  get first c intersection part
-    bool zero = false;
-    for (int i = 0; i < m_filter_size/2; ++i){
-        // get intersection of signatures
-        m_temp_filter[i] = m_temp_filter[i] && m_filter[i];
-        zero = zero || m_temp_filter[i];
-    }
-    zero = !zero;
-    if (zero) {
-        // one section is zero, no possiblility of address in signature
-        // reset bits we just set
-        m_temp_filter[c0 + (m_filter_size / 2)] = 0;
-        m_temp_filter[c1] = 0;
-        return false;
-    }
-
-    // check second section
-    zero = false;
-    for (int i = m_filter_size / 2; i < m_filter_size; ++i) {
-        // get intersection of signatures
-        m_temp_filter[i] =  m_temp_filter[i] && m_filter[i];
-        zero = zero || m_temp_filter[i];
-    }
-    zero = !zero;
-    if (zero) {
-        // one section is zero, no possiblility of address in signature
-        m_temp_filter[c0 + (m_filter_size / 2)] = 0;
-        m_temp_filter[c1] = 0;
-        return false;
-    }
-    // one section has at least one bit set
-    m_temp_filter[c0 + (m_filter_size / 2)] = 0;
-    m_temp_filter[c1] = 0;
-    return true;
+    // Intersecting the address's own signature with the filter leaves
+    // at most the v1 bit in the first section and the v0 bit in the
+    // second. The address may be present only if neither section of
+    // the intersection is empty.
+    int v1, v0;
+    get_bits(addr, v1, v0);
+    return m_filter.test(v1) && m_filter.test(v0);
 }
 
 int
@@ -175,13 +127,7 @@ BulkBloomFilter::getCount(Addr addr)
 int
 BulkBloomFilter::getTotalCount()
 {
-    int count = 0;
-    for (int i = 0; i < m_filter_size; i++) {
-        if (m_filter[i]) {
-            count++;
-        }
-    }
-    return count;
+    return m_filter.count();
 }
 
 int
@@ -34,6 +34,7 @@
 
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/filters/AbstractBloomFilter.hh"
+#include "mem/ruby/filters/BitFilter.hh"
 
 class BulkBloomFilter : public AbstractBloomFilter
 {
@@ -60,9 +61,10 @@ class BulkBloomFilter : public AbstractBloomFilter
   private:
     int get_index(Addr addr);
     Addr permute(Addr addr);
+    /** The v1 bit (first half) and v0 bit (second half) for addr */
+    void get_bits(Addr addr, int &v1, int &v0);
 
-    std::vector<int> m_filter;
-    std::vector<int> m_temp_filter;
+    BitFilter m_filter;
 
     int m_filter_size;
     int m_filter_size_bits;
@@ -355,29 +355,8 @@ static int H3[64][16] = {
 };
 
 H3BloomFilter::H3BloomFilter(int size, int hashes, bool parallel)
+    : m_filter(size)
 {
-    //TODO: change this ugly init code...
-    primes_list[0] = 9323;
-    primes_list[1] = 11279;
-    primes_list[2] = 10247;
-    primes_list[3] = 30637;
-    primes_list[4] = 25717;
-    primes_list[5] = 43711;
-
-    mults_list[0] = 255;
-    mults_list[1] = 29;
-    mults_list[2] = 51;
-    mults_list[3] = 3;
-    mults_list[4] = 77;
-    mults_list[5] = 43;
-
-    adds_list[0] = 841;
-    adds_list[1] = 627;
-    adds_list[2] = 1555;
-    adds_list[3] = 241;
-    adds_list[4] = 7777;
-    adds_list[5] = 65931;
-
     m_filter_size = size;
     m_num_hashes = hashes;
     isParallel = parallel;
@@ -387,8 +366,13 @@ H3BloomFilter::H3BloomFilter(int size, int hashes, bool parallel)
     m_par_filter_size = m_filter_size / m_num_hashes;
     m_par_filter_size_bits = floorLog2(m_par_filter_size);
 
-    m_filter.resize(m_filter_size);
-    clear();
+    assert(m_num_hashes <= 16);
+    for (int i = 0; i < m_num_hashes; i++) {
+        vector<uint64_t> rows(64);
+        for (int bit = 0; bit < 64; bit++)
+            rows[bit] = H3[bit][i];
+        m_hashes.push_back(XorHash(rows));
+    }
 }
 
 H3BloomFilter::~H3BloomFilter()
@@ -398,9 +382,7 @@ H3BloomFilter::~H3BloomFilter()
 void
 H3BloomFilter::clear()
 {
-    for (int i = 0; i < m_filter_size; i++) {
-        m_filter[i] = 0;
-    }
+    m_filter.clear();
 }
 
 void
@@ -420,17 +402,14 @@ H3BloomFilter::merge(AbstractBloomFilter *other_filter)
 {
     // assumes both filters are the same size!
     H3BloomFilter * temp = (H3BloomFilter*) other_filter;
-    for (int i = 0; i < m_filter_size; ++i){
-        m_filter[i] |= (*temp)[i];
-    }
+    m_filter.merge(temp->m_filter);
 }
 
 void
 H3BloomFilter::set(Addr addr)
 {
     for (int i = 0; i < m_num_hashes; i++) {
-        int idx = get_index(addr, i);
-        m_filter[idx] = 1;
+        m_filter.set(get_index(addr, i));
     }
 }
 
@@ -444,13 +423,27 @@ H3BloomFilter::unset(Addr addr)
 bool
 H3BloomFilter::isSet(Addr addr)
 {
-    bool res = true;
+    for (int i = 0; i < m_num_hashes; i++) {
+        if (!m_filter.test(get_index(addr, i)))
+            return false;
+    }
+    return true;
+}
+
+void
+H3BloomFilter::isSetBatch(const Addr *addrs, int count, bool *results)
+{
+    // Walk the batch once per hash so that only one hash's tables are
+    // live at a time, skipping addresses already known to miss.
+    for (int j = 0; j < count; j++)
+        results[j] = true;
 
     for (int i = 0; i < m_num_hashes; i++) {
-        int idx = get_index(addr, i);
-        res = res && m_filter[idx];
+        for (int j = 0; j < count; j++) {
+            if (results[j])
+                results[j] = m_filter.test(get_index(addrs[j], i));
+        }
     }
-    return res;
 }
 
 int
@@ -479,12 +472,7 @@ H3BloomFilter::writeBit(const int index, const int value)
 int
 H3BloomFilter::getTotalCount()
 {
-    int count = 0;
-
-    for (int i = 0; i < m_filter_size; i++) {
-        count += m_filter[i];
-    }
-    return count;
+    return m_filter.count();
 }
 
 void
@@ -496,8 +484,7 @@ int
 H3BloomFilter::get_index(Addr addr, int i)
 {
     uint64_t x = makeLineAddress(addr);
-    // uint64_t y = (x*mults_list[i] + adds_list[i]) % primes_list[i];
-    int y = hash_H3(x,i);
+    int y = m_hashes[i](x);
 
     if (isParallel) {
         return (y % m_par_filter_size) + i*m_par_filter_size;
@@ -505,18 +492,3 @@ H3BloomFilter::get_index(Addr addr, int i)
         return y % m_filter_size;
     }
 }
-
-int
-H3BloomFilter::hash_H3(uint64_t value, int index)
-{
-    uint64_t mask = 1;
-    uint64_t val = value;
-    int result = 0;
-
-    for (int i = 0; i < 64; i++) {
-        if (val&mask) result ^= H3[i][index];
-        val = val >> 1;
-    }
-    return result;
-}
-
@@ -34,6 +34,8 @@
 
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/filters/AbstractBloomFilter.hh"
+#include "mem/ruby/filters/BitFilter.hh"
+#include "mem/ruby/filters/XorHash.hh"
 
 class H3BloomFilter : public AbstractBloomFilter
 {
@@ -49,6 +51,7 @@ class H3BloomFilter : public AbstractBloomFilter
     void unset(Addr addr);
 
     bool isSet(Addr addr);
+    void isSetBatch(const Addr *addrs, int count, bool *results);
     int getCount(Addr addr);
     int getTotalCount();
     void print(std::ostream& out) const;
@@ -60,15 +63,15 @@ class H3BloomFilter : public AbstractBloomFilter
     int
     operator[](const int index) const
     {
-        return this->m_filter[index];
+        return m_filter.test(index);
     }
 
   private:
     int get_index(Addr addr, int hashNumber);
 
-    int hash_H3(uint64_t value, int index);
-
-    std::vector<int> m_filter;
+    BitFilter m_filter;
+    /** One table-driven H3 hash per hash function */
+    std::vector<XorHash> m_hashes;
     int m_filter_size;
     int m_num_hashes;
     int m_filter_size_bits;
@@ -76,10 +79,6 @@ class H3BloomFilter : public AbstractBloomFilter
     int m_par_filter_size;
     int m_par_filter_size_bits;
 
-    int primes_list[6];// = {9323,11279,10247,30637,25717,43711};
-    int mults_list[6]; //= {255,29,51,3,77,43};
-    int adds_list[6]; //= {841,627,1555,241,7777,65391};
-
     bool isParallel;
 };
 
@@ -60,8 +60,12 @@ MultiBitSelBloomFilter::MultiBitSelBloomFilter(string str)
     m_par_filter_size = m_filter_size / m_num_hashes;
     m_par_filter_size_bits = floorLog2(m_par_filter_size);
 
-    m_filter.resize(m_filter_size);
-    clear();
+    m_filter = BitFilter(m_filter_size);
+    for (int i = 0; i < m_num_hashes; i++) {
+        //36-bit addresses, 6-bit cache lines
+        m_hashes.push_back(hash_bitsel(i, m_num_hashes, 30,
+                                       m_filter_size_bits));
+    }
 }
 
 MultiBitSelBloomFilter::~MultiBitSelBloomFilter()
@@ -71,9 +75,7 @@ MultiBitSelBloomFilter::~MultiBitSelBloomFilter()
 void
 MultiBitSelBloomFilter::clear()
 {
-    for (int i = 0; i < m_filter_size; i++) {
-        m_filter[i] = 0;
-    }
+    m_filter.clear();
 }
 
 void
@@ -94,17 +96,14 @@ MultiBitSelBloomFilter::merge(AbstractBloomFilter *other_filter)
 {
     // assumes both filters are the same size!
     MultiBitSelBloomFilter * temp = (MultiBitSelBloomFilter*) other_filter;
-    for (int i = 0; i < m_filter_size; ++i){
-        m_filter[i] |= (*temp)[i];
-    }
+    m_filter.merge(temp->m_filter);
 }
 
 void
 MultiBitSelBloomFilter::set(Addr addr)
 {
     for (int i = 0; i < m_num_hashes; i++) {
-        int idx = get_index(addr, i);
-        m_filter[idx] = 1;
+        m_filter.set(get_index(addr, i));
     }
 }
 
@@ -118,13 +117,26 @@ MultiBitSelBloomFilter::unset(Addr addr)
 bool
 MultiBitSelBloomFilter::isSet(Addr addr)
 {
-    bool res = true;
+    for (int i = 0; i < m_num_hashes; i++) {
+        if (!m_filter.test(get_index(addr, i)))
+            return false;
+    }
+    return true;
+}
 
-    for (int i=0; i < m_num_hashes; i++) {
-        int idx = get_index(addr, i);
-        res = res && m_filter[idx];
+void
+MultiBitSelBloomFilter::isSetBatch(const Addr *addrs, int count,
+                                   bool *results)
+{
+    for (int j = 0; j < count; j++)
+        results[j] = true;
+
+    for (int i = 0; i < m_num_hashes; i++) {
+        for (int j = 0; j < count; j++) {
+            if (results[j])
+                results[j] = m_filter.test(get_index(addrs[j], i));
+        }
     }
-    return res;
 }
 
 int
@@ -153,12 +165,7 @@ MultiBitSelBloomFilter::writeBit(const int index, const int value)
 int
 MultiBitSelBloomFilter::getTotalCount()
 {
-    int count = 0;
-
-    for (int i = 0; i < m_filter_size; i++) {
-        count += m_filter[i];
-    }
-    return count;
+    return m_filter.count();
 }
 
 void
@@ -173,8 +180,7 @@ MultiBitSelBloomFilter::get_index(Addr addr, int i)
     // bits. Used to simulate BitSel hashing on larger than cache-line
     // granularities
     uint64_t x = (makeLineAddress(addr) >> m_skip_bits);
-    int y = hash_bitsel(x, i, m_num_hashes, 30, m_filter_size_bits);
-    //36-bit addresses, 6-bit cache lines
+    int y = m_hashes[i](x);
 
     if (isParallel) {
         return (y % m_par_filter_size) + i*m_par_filter_size;
@@ -183,17 +189,16 @@ MultiBitSelBloomFilter::get_index(Addr addr, int i)
     }
 }
 
-int
-MultiBitSelBloomFilter::hash_bitsel(uint64_t value, int index, int jump,
-                                    int maxBits, int numBits)
+XorHash
+MultiBitSelBloomFilter::hash_bitsel(int index, int jump, int maxBits,
+                                    int numBits)
 {
-    uint64_t mask = 1;
-    int result = 0;
-    int bit, i;
-
-    for (i = 0; i < numBits; i++) {
-        bit = (index + jump*i) % maxBits;
-        if (value & (mask << bit)) result += mask << i;
+    // Bit i of the result is input bit (index + jump*i) % maxBits, so
+    // each input bit contributes the result bits that select it.
+    vector<uint64_t> rows(maxBits, 0);
+    for (int i = 0; i < numBits; i++) {
+        int bit = (index + jump*i) % maxBits;
+        rows[bit] |= uint64_t(1) << i;
     }
-    return result;
+    return XorHash(rows);
 }
@@ -36,6 +36,8 @@
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 #include "mem/ruby/filters/AbstractBloomFilter.hh"
+#include "mem/ruby/filters/BitFilter.hh"
+#include "mem/ruby/filters/XorHash.hh"
 
 class MultiBitSelBloomFilter : public AbstractBloomFilter
 {
@@ -51,6 +53,7 @@ class MultiBitSelBloomFilter : public AbstractBloomFilter
     void unset(Addr addr);
 
     bool isSet(Addr addr);
+    void isSetBatch(const Addr *addrs, int count, bool *results);
     int getCount(Addr addr);
     int getTotalCount();
     void print(std::ostream& out) const;
@@ -62,16 +65,18 @@ class MultiBitSelBloomFilter : public AbstractBloomFilter
     int
     operator[](const int index) const
     {
-        return this->m_filter[index];
+        return m_filter.test(index);
     }
 
   private:
     int get_index(Addr addr, int hashNumber);
 
-    int hash_bitsel(uint64_t value, int index, int jump, int maxBits,
-                    int numBits);
+    static XorHash hash_bitsel(int index, int jump, int maxBits,
+                               int numBits);
 
-    std::vector<int> m_filter;
+    BitFilter m_filter;
+    /** One bit-select hash per hash function */
+    std::vector<XorHash> m_hashes;
     int m_filter_size;
     int m_num_hashes;
     int m_filter_size_bits;
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_FILTERS_XORHASH_HH__
+#define __MEM_RUBY_FILTERS_XORHASH_HH__
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * A hash that is linear over GF(2): the result is the XOR of one
+ * fixed row for every bit set in the input. H3 hashes are of this
+ * form, and so is selecting and packing a subset of the input bits.
+ *
+ * Rather than looping over the input bits, the rows are folded into
+ * one 256-entry table per input byte when the hash is built, so
+ * evaluating it takes one lookup per byte of input.
+ */
+class XorHash
+{
+  public:
+    XorHash() {}
+    /** @param rows Contribution of input bit i; at most 64 rows */
+    explicit XorHash(const std::vector<uint64_t> &rows);
+
+    uint64_t
+    operator()(uint64_t value) const
+    {
+        uint64_t result = 0;
+        const uint64_t *table = m_tables.data();
+        for (int b = 0; b < m_numBytes; ++b, table += 256) {
+            result ^= table[value & 0xff];
+            value >>= 8;
+        }
+        return result;
+    }
+
+  private:
+    int m_numBytes = 0;
+    std::vector<uint64_t> m_tables;
+};
+
+#endif // __MEM_RUBY_FILTERS_XORHASH_HH__
@@ -32,7 +32,6 @@
 
 #include "base/cprintf.hh"
 #include "base/logging.hh"
-#include "base/random.hh"
 #include "base/stl_helpers.hh"
 #include "debug/RubyQueue.hh"
 #include "mem/ruby/system/RubySystem.hh"
@@ -45,7 +44,7 @@ MessageBuffer::MessageBuffer(const Params *p)
     m_max_size(p->buffer_size), m_time_last_time_size_checked(0),
     m_time_last_time_enqueue(0), m_time_last_time_pop(0),
     m_last_arrival_time(0), m_strict_fifo(p->ordered),
-    m_randomization(p->randomization)
+    m_randomization(p->randomization), m_rng(name())
 {
     m_msg_counter = 0;
     m_consumer = NULL;
@@ -62,6 +61,11 @@ MessageBuffer::MessageBuffer(const Params *p)
     m_stall_time = 0;
 
     m_dequeue_callback = nullptr;
+
+    m_functional_lines.fill(0);
+    m_functional_any = 0;
+
+    m_in_order = true;
 }
 
 unsigned int
@@ -127,14 +131,13 @@ MessageBuffer::peek() const
     return msg_ptr;
 }
 
-// FIXME - move me somewhere else
 Tick
-random_time()
+MessageBuffer::random_time()
 {
     Tick time = 1;
-    time += random_mt.random(0, 3);  // [0...3]
-    if (random_mt.random(0, 7) == 0) {  // 1 in 8 chance
-        time += 100 + random_mt.random(1, 15); // 100 + [1...15]
+    time += m_rng.random(0, 3);  // [0...3]
+    if (m_rng.random(0, 7) == 0) {  // 1 in 8 chance
+        time += 100 + m_rng.random(1, 15); // 100 + [1...15]
     }
     return time;
 }
@@ -198,9 +201,21 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
     msg_ptr->setLastEnqueueTime(arrival_time);
     msg_ptr->setMsgCounter(m_msg_counter);
 
+    assert(m_consumer != NULL);
+    if (inParallelMode && m_consumer->eventQueue() != curEventQueue()) {
+        enqueueRemote(message, current_time, arrival_time);
+        return;
+    }
+
+    insertMessage(message, arrival_time);
+}
+
+void
+MessageBuffer::insertMessage(const MsgPtr &message, Tick arrival_time)
+{
     // Insert the message into the priority heap
-    m_prio_heap.push_back(message);
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    pushMessage(message);
+    updateFunctionalFilter(message, 1);
     // Increment the number of messages statistic
     m_buf_msgs++;
 
@@ -208,11 +223,33 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
             arrival_time, *(message.get()));
 
     // Schedule the wakeup
-    assert(m_consumer != NULL);
     m_consumer->scheduleEventAbsolute(arrival_time);
     m_consumer->storeEventInfo(m_vnet_id);
 }
 
+void
+MessageBuffer::enqueueRemote(const MsgPtr &message, Tick current_time,
+                             Tick arrival_time)
+{
+    fatal_if(m_max_size != 0, "%s: Finite message buffers can't connect "
+             "objects on different event queues.\n", name());
+    fatal_if(arrival_time - current_time < simQuantum,
+             "%s: A message to another event queue arrives after %d ticks, "
+             "less than the simulation quantum (%d ticks).\n", name(),
+             arrival_time - current_time, simQuantum);
+
+    // The message arrives in a later quantum, by which time the
+    // producer has let go of it, so it can be passed without locking.
+    // The delivery runs ahead of the wakeups of the consumer that are
+    // due in the same tick, so that they see the message.
+    auto *evt = new EventFunctionWrapper(
+        [this, message, arrival_time]{
+            insertMessage(message, arrival_time);
+        }, "MessageBuffer Delivery Event", true, Event::Default_Pri - 1);
+
+    m_consumer->eventQueue()->schedule(evt, arrival_time);
+}
+
 Tick
 MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
 {
@@ -235,8 +272,8 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
         m_time_last_time_pop = current_time;
     }
 
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
-    m_prio_heap.pop_back();
+    popMessage();
+    updateFunctionalFilter(message, -1);
     if (decrement_messages) {
         // If the message will be removed from the queue, decrement the
         // number of message in the queue.
@@ -263,10 +300,44 @@ MessageBuffer::unregisterDequeueCallback()
     m_dequeue_callback = nullptr;
 }
 
+void
+MessageBuffer::pushMessage(const MsgPtr &message)
+{
+    if (m_in_order && !m_prio_heap.empty() && m_prio_heap.back() > message)
+        m_in_order = false;
+
+    m_prio_heap.push_back(message);
+    if (!m_in_order)
+        push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+}
+
+void
+MessageBuffer::popMessage()
+{
+    if (m_in_order) {
+        m_prio_heap.pop_front();
+        return;
+    }
+
+    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    m_prio_heap.pop_back();
+    if (m_prio_heap.size() <= 1)
+        m_in_order = true;
+}
+
 void
 MessageBuffer::clear()
 {
     m_prio_heap.clear();
+    m_in_order = true;
+
+    // only the stalled messages are left
+    m_functional_lines.fill(0);
+    m_functional_any = 0;
+    for (auto &stalled : m_stall_msg_map) {
+        for (auto &message : m_stall_lists[stalled.second])
+            updateFunctionalFilter(message, 1);
+    }
 
     m_msg_counter = 0;
     m_time_last_time_enqueue = 0;
@@ -281,32 +352,42 @@ MessageBuffer::recycle(Tick current_time, Tick recycle_latency)
     DPRINTF(RubyQueue, "Recycling.\n");
     assert(isReady(current_time));
     MsgPtr node = m_prio_heap.front();
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    popMessage();
 
     Tick future_time = current_time + recycle_latency;
     node->setLastEnqueueTime(future_time);
 
-    m_prio_heap.back() = node;
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    pushMessage(node);
     m_consumer->scheduleEventAbsolute(future_time);
 }
 
 void
-MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick schdTick)
+MessageBuffer::reanalyzeList(StallList &lt, Tick schdTick)
 {
-    while (!lt.empty()) {
+    for (auto &m : lt) {
         m_msg_counter++;
-        MsgPtr m = lt.front();
         m->setLastEnqueueTime(schdTick);
         m->setMsgCounter(m_msg_counter);
 
-        m_prio_heap.push_back(m);
-        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                  greater<MsgPtr>());
+        pushMessage(m);
 
         m_consumer->scheduleEventAbsolute(schdTick);
-        lt.pop_front();
     }
+    lt.clear();
+}
+
+void
+MessageBuffer::reanalyzeLine(Addr addr, Tick current_time)
+{
+    auto it = m_stall_msg_map.find(addr);
+    assert(it != m_stall_msg_map.end());
+
+    unsigned idx = it->second;
+    m_stall_map_size -= m_stall_lists[idx].size();
+    assert(m_stall_map_size >= 0);
+    reanalyzeList(m_stall_lists[idx], current_time);
+    m_free_stall_lists.push_back(idx);
+    m_stall_msg_map.erase(it);
 }
 
 void
@@ -321,10 +402,7 @@ MessageBuffer::reanalyzeMessages(Addr addr, Tick current_time)
     // scheduled for the current cycle so that the previously stalled messages
     // will be observed before any younger messages that may arrive this cycle
     //
-    m_stall_map_size -= m_stall_msg_map[addr].size();
-    assert(m_stall_map_size >= 0);
-    reanalyzeList(m_stall_msg_map[addr], current_time);
-    m_stall_msg_map.erase(addr);
+    reanalyzeLine(addr, current_time);
 }
 
 void
@@ -338,13 +416,16 @@ MessageBuffer::reanalyzeAllMessages(Tick current_time)
     // scheduled for the current cycle so that the previously stalled messages
     // will be observed before any younger messages that may arrive this cycle.
     //
-    for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
-         map_iter != m_stall_msg_map.end(); ++map_iter) {
-        m_stall_map_size -= map_iter->second.size();
-        assert(m_stall_map_size >= 0);
-        reanalyzeList(map_iter->second, current_time);
-    }
-    m_stall_msg_map.clear();
+    // Visit the lines in address order, as the order in which the
+    // messages are put back determines the order they are handled in.
+    std::vector<Addr> lines;
+    lines.reserve(m_stall_msg_map.size());
+    for (auto &stalled : m_stall_msg_map)
+        lines.push_back(stalled.first);
+    std::sort(lines.begin(), lines.end());
+
+    for (auto addr : lines)
+        reanalyzeLine(addr, current_time);
 }
 
 void
@@ -364,7 +445,19 @@ MessageBuffer::stallMessage(Addr addr, Tick current_time)
     // Instead the controller is responsible to call reanalyzeMessages when
     // these addresses change state.
     //
-    (m_stall_msg_map[addr]).push_back(message);
+    auto it = m_stall_msg_map.find(addr);
+    if (it == m_stall_msg_map.end()) {
+        unsigned idx;
+        if (m_free_stall_lists.empty()) {
+            idx = m_stall_lists.size();
+            m_stall_lists.emplace_back();
+        } else {
+            idx = m_free_stall_lists.back();
+            m_free_stall_lists.pop_back();
+        }
+        it = m_stall_msg_map.emplace(addr, idx).first;
+    }
+    m_stall_lists[it->second].push_back(message);
     m_stall_map_size++;
     m_stall_count++;
 }
@@ -377,7 +470,7 @@ MessageBuffer::print(ostream& out) const
         ccprintf(out, " consumer-yes ");
     }
 
-    vector<MsgPtr> copy(m_prio_heap);
+    vector<MsgPtr> copy(m_prio_heap.begin(), m_prio_heap.end());
     sort_heap(copy.begin(), copy.end(), greater<MsgPtr>());
     ccprintf(out, "%s] %s", copy, name());
 }
@@ -424,11 +517,36 @@ MessageBuffer::regStats()
     }
 }
 
+void
+MessageBuffer::updateFunctionalFilter(const MsgPtr &message, int delta)
+{
+    Addr line = 0;
+    switch (message->functionalScope(line)) {
+      case Message::FunctionalAny:
+        m_functional_any += delta;
+        break;
+      case Message::FunctionalLine:
+        m_functional_lines[(line >> RubySystem::getBlockSizeBits()) %
+                           FunctionalFilterSize] += delta;
+        break;
+      case Message::FunctionalNone:
+        break;
+    }
+}
+
 uint32_t
 MessageBuffer::functionalWrite(Packet *pkt)
 {
     uint32_t num_functional_writes = 0;
 
+    // skip the buffer if none of its messages can match the packet
+    const Addr line = makeLineAddress(pkt->getAddr());
+    if (m_functional_any == 0 &&
+        m_functional_lines[(line >> RubySystem::getBlockSizeBits()) %
+                           FunctionalFilterSize] == 0) {
+        return 0;
+    }
+
     // Check the priority heap and write any messages that may
     // correspond to the address in the packet.
     for (unsigned int i = 0; i < m_prio_heap.size(); ++i) {
@@ -440,15 +558,9 @@ MessageBuffer::functionalWrite(Packet *pkt)
 
     // Check the stall queue and write any messages that may
     // correspond to the address in the packet.
-    for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
-         map_iter != m_stall_msg_map.end();
-         ++map_iter) {
-
-        for (std::list<MsgPtr>::iterator it = (map_iter->second).begin();
-            it != (map_iter->second).end(); ++it) {
-
-            Message *msg = (*it).get();
-            if (msg->functionalWrite(pkt)) {
+    for (auto &stalled : m_stall_msg_map) {
+        for (auto &message : m_stall_lists[stalled.second]) {
+            if (message->functionalWrite(pkt)) {
                 num_functional_writes++;
             }
         }
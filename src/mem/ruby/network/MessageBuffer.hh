@@ -35,12 +35,16 @@
 #define __MEM_RUBY_NETWORK_MESSAGEBUFFER_HH__
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/RubyQueue.hh"
 #include "mem/ruby/common/Address.hh"
@@ -67,9 +71,7 @@ class MessageBuffer : public SimObject
     delayHead(Tick current_time, Tick delta)
     {
         MsgPtr m = m_prio_heap.front();
-        std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                      std::greater<MsgPtr>());
-        m_prio_heap.pop_back();
+        popMessage();
         enqueue(m, current_time, delta);
     }
 
@@ -97,6 +99,14 @@ class MessageBuffer : public SimObject
 
     const MsgPtr &peekMsgPtr() const { return m_prio_heap.front(); }
 
+    /**
+     * Enqueue a message that can be dequeued delta ticks from now. If
+     * the consumer runs on another event queue than the caller, the
+     * message is handed over through an event on the queue of the
+     * consumer, which requires delta to be at least one simulation
+     * quantum. Such buffers must have a single producer and be
+     * infinite, as the producer can't see the state of the consumer.
+     */
     void enqueue(MsgPtr message, Tick curTime, Tick delta);
 
     //! Updates the delay cycles of the message at the head of the queue,
@@ -108,7 +118,7 @@ class MessageBuffer : public SimObject
 
     void recycle(Tick current_time, Tick recycle_latency);
     bool isEmpty() const { return m_prio_heap.size() == 0; }
-    bool isStallMapEmpty() { return m_stall_msg_map.size() == 0; }
+    bool isStallMapEmpty() { return m_stall_msg_map.empty(); }
     unsigned int getStallMapSize() { return m_stall_msg_map.size(); }
 
     unsigned int getSize(Tick curTime);
@@ -129,22 +139,63 @@ class MessageBuffer : public SimObject
     uint32_t functionalWrite(Packet *pkt);
 
   private:
-    void reanalyzeList(std::list<MsgPtr> &, Tick);
+    typedef std::vector<MsgPtr> StallList;
+
+    void reanalyzeList(StallList &, Tick);
+
+    /**
+     * Add an enqueued message to m_prio_heap and wake up the consumer
+     * when it arrives. This runs on the event queue of the consumer.
+     */
+    void insertMessage(const MsgPtr &message, Tick arrival_time);
+
+    /** Pass a message to a consumer on another event queue. */
+    void enqueueRemote(const MsgPtr &message, Tick current_time,
+                       Tick arrival_time);
+
+    /** Move the stalled messages of a line back to m_prio_heap. */
+    void reanalyzeLine(Addr addr, Tick current_time);
+
+    /**
+     * @{
+     * Insert a message into, or remove the head from, m_prio_heap,
+     * keeping it either sorted or a heap.
+     */
+    void pushMessage(const MsgPtr &message);
+    void popMessage();
+    /** @} */
+
+    /** Add (or remove) a message to the functional write filter. */
+    void updateFunctionalFilter(const MsgPtr &message, int delta);
+
+    /** Random delay of a message when randomization is enabled */
+    Tick random_time();
 
   private:
     // Data Members (m_ prefix)
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
-    std::vector<MsgPtr> m_prio_heap;
+
+    /**
+     * Messages waiting in the buffer, ordered by arrival time. Most
+     * buffers see their messages arrive in order, so the messages are
+     * kept as a sorted FIFO until a message arrives before the tail.
+     * A sorted sequence is also a valid heap, which makes the switch to
+     * heap operations free. The buffer reverts to a FIFO once it has
+     * drained.
+     */
+    std::deque<MsgPtr> m_prio_heap;
+    bool m_in_order;
 
     std::function<void()> m_dequeue_callback;
 
-    // use a std::map for the stalled messages as this container is
-    // sorted and ensures a well-defined iteration order
-    typedef std::map<Addr, std::list<MsgPtr> > StallMsgMapType;
+    typedef std::unordered_map<Addr, unsigned> StallMsgMapType;
 
     /**
      * A map from line addresses to lists of stalled messages for that line.
+     * The map holds the index of the list in m_stall_lists. Lists are
+     * recycled through m_free_stall_lists, so they keep their storage
+     * once a buffer has reached its working set of stalled lines.
      * If this buffer allows the receiver to stall messages, on a stall
      * request, the stalled message is removed from the m_prio_heap and placed
      * in the m_stall_msg_map. Messages are held there until the receiver
@@ -154,9 +205,24 @@ class MessageBuffer : public SimObject
      * NOTE: The stall map holds messages in the order in which they were
      * initially received, and when a line is unblocked, the messages are
      * moved back to the m_prio_heap in the same order. This prevents starving
-     * older requests with younger ones.
+     * older requests with younger ones. When all lines are unblocked at
+     * once, they are visited in address order to keep the simulation
+     * deterministic.
      */
     StallMsgMapType m_stall_msg_map;
+    std::vector<StallList> m_stall_lists;
+    std::vector<unsigned> m_free_stall_lists;
+
+    /**
+     * Filter for functional writes. Messages that can only match a
+     * single line are counted in the slot of their line, and messages
+     * that can match any address are counted separately. A functional
+     * write only has to search the buffer if either count of its line
+     * is non-zero.
+     */
+    static const int FunctionalFilterSize = 64;
+    std::array<uint32_t, FunctionalFilterSize> m_functional_lines;
+    uint32_t m_functional_any;
 
     /**
      * Current size of the stall map.
@@ -192,6 +258,7 @@ class MessageBuffer : public SimObject
     int m_priority_rank;
     const bool m_strict_fifo;
     const bool m_randomization;
+    RandomStream m_rng;
 
     int m_input_link_id;
     int m_vnet_id;
@@ -202,8 +269,6 @@ class MessageBuffer : public SimObject
     Stats::Formula m_occupancy;
 };
 
-Tick random_time();
-
 inline std::ostream&
 operator<<(std::ostream& out, const MessageBuffer& obj)
 {
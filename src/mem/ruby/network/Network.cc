@@ -184,6 +184,14 @@ Network::setToNetQueue(NodeID id, bool ordered, int network_num,
     m_toNetQueues[id][network_num] = b;
 }
 
+MessageBuffer *
+Network::getToNetQueue(NodeID id, int network_num) const
+{
+    if (id >= m_toNetQueues.size() || network_num >= m_toNetQueues[id].size())
+        return nullptr;
+    return m_toNetQueues[id][network_num];
+}
+
 void
 Network::setFromNetQueue(NodeID id, bool ordered, int network_num,
                                    std::string vnet_type, MessageBuffer *b)
@@ -93,6 +93,10 @@ class Network : public ClockedObject
     virtual void setFromNetQueue(NodeID id, bool ordered, int netNumber,
                                  std::string vnet_type, MessageBuffer *b);
 
+    // returns the queue of a component into the network on the given
+    // virtual network, or nullptr if the component doesn't use it
+    MessageBuffer *getToNetQueue(NodeID id, int netNumber) const;
+
     virtual void checkNetworkAllocation(NodeID id, bool ordered,
         int network_num, std::string vnet_type);
 
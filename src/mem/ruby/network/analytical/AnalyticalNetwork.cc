@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/network/analytical/AnalyticalNetwork.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "debug/RubyNetwork.hh"
+#include "mem/ruby/network/BasicLink.hh"
+#include "mem/ruby/network/BasicRouter.hh"
+#include "mem/ruby/network/MessageBuffer.hh"
+#include "mem/ruby/slicc_interface/Message.hh"
+
+using namespace std;
+
+AnalyticalNetwork::AnalyticalNetwork(const Params *p)
+    : Network(p), Consumer(this),
+      m_contention_window(p->contention_window),
+      m_max_utilization(p->max_utilization),
+      m_window_start(0)
+{
+    fatal_if(m_contention_window == 0,
+             "%s: contention_window must be at least one cycle\n", name());
+    fatal_if(m_max_utilization < 0 || m_max_utilization >= 1,
+             "%s: max_utilization must be in [0, 1)\n", name());
+
+    m_switch_links.resize(p->routers.size());
+    m_router_latency.resize(p->routers.size());
+    for (auto router : p->routers) {
+        int id = router->params()->router_id;
+        assert(id < m_router_latency.size());
+        m_router_latency[id] = router->params()->latency;
+    }
+
+    m_node_links.resize(m_nodes, -1);
+    for (int m = 0; m < MachineType_NUM; m++) {
+        MachineType type = (MachineType)m;
+        for (NodeID i = 0; i < MachineType_base_count(type); i++)
+            m_machines.push_back((MachineID) {type, i});
+    }
+    assert(m_machines.size() == m_nodes);
+}
+
+AnalyticalNetwork::~AnalyticalNetwork()
+{
+}
+
+void
+AnalyticalNetwork::init()
+{
+    Network::init();
+
+    // The topology pointer should have already been initialized in
+    // the parent class network constructor.
+    assert(m_topology_ptr != NULL);
+    m_topology_ptr->createLinks(this);
+    buildPaths();
+
+    m_last_arrival.assign(m_nodes, vector<Tick>(m_virtual_networks, 0));
+    for (auto &queues : m_toNetQueues) {
+        for (auto buffer : queues) {
+            if (buffer)
+                buffer->setConsumer(this);
+        }
+    }
+}
+
+int
+AnalyticalNetwork::addLink(BasicLink *link, const NetDest &routing,
+                           int dest_switch)
+{
+    fatal_if(link->m_bandwidth_factor <= 0,
+             "%s: Link %s needs a positive bandwidth_factor\n", name(),
+             link->name());
+
+    Link l;
+    l.latency = link->m_latency;
+    l.bandwidth = link->m_bandwidth_factor;
+    l.routing = routing;
+    l.dest_switch = dest_switch;
+    l.bytes = 0;
+    l.utilization = 0;
+    m_links.push_back(l);
+    return m_links.size() - 1;
+}
+
+// From a switch to an endpoint node
+void
+AnalyticalNetwork::makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
+                                  const NetDest& routing_table_entry)
+{
+    assert(dest < m_nodes);
+    assert(src < m_switch_links.size());
+    m_switch_links[src].push_back(addLink(link, routing_table_entry, -1));
+}
+
+// From an endpoint node to a switch
+void
+AnalyticalNetwork::makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
+                                 const NetDest& routing_table_entry)
+{
+    assert(src < m_nodes);
+    assert(dest < m_switch_links.size());
+    m_node_links[src] = addLink(link, routing_table_entry, dest);
+}
+
+// From a switch to a switch
+void
+AnalyticalNetwork::makeInternalLink(SwitchID src, SwitchID dest,
+                                    BasicLink* link,
+                                    const NetDest& routing_table_entry,
+                                    PortDirection src_outport,
+                                    PortDirection dst_inport)
+{
+    assert(src < m_switch_links.size());
+    assert(dest < m_switch_links.size());
+    m_switch_links[src].push_back(addLink(link, routing_table_entry, dest));
+}
+
+// A message for a node leaves a switch through the first link whose
+// routing table entry contains the node, as in the simple network
+// without adaptive routing.
+void
+AnalyticalNetwork::buildPaths()
+{
+    m_paths.assign(m_nodes * m_nodes, Path());
+
+    for (NodeID src = 0; src < m_nodes; src++) {
+        for (NodeID dest = 0; dest < m_nodes; dest++) {
+            Path &path = m_paths[src * m_nodes + dest];
+            path.latency = Cycles(0);
+
+            int link_id = m_node_links[src];
+            while (link_id != -1) {
+                const Link &link = m_links[link_id];
+                path.links.push_back(link_id);
+                path.latency += link.latency;
+                if (link.dest_switch == -1)
+                    break;
+
+                fatal_if(path.links.size() > m_links.size(),
+                         "%s: Routing loop between nodes %d and %d\n",
+                         name(), src, dest);
+                path.latency += m_router_latency[link.dest_switch];
+
+                link_id = -1;
+                for (int out : m_switch_links[link.dest_switch]) {
+                    if (m_links[out].routing.isElement(m_machines[dest])) {
+                        link_id = out;
+                        break;
+                    }
+                }
+            }
+
+            // Nodes without a route are only detected when they are
+            // sent a message
+            if (link_id == -1)
+                path.links.clear();
+        }
+    }
+}
+
+// Start a new contention window if the current one is over. The
+// utilization of a window that ended more than a window ago is zero.
+void
+AnalyticalNetwork::updateUtilization()
+{
+    const uint64_t window = m_contention_window;
+    const uint64_t elapsed = curCycle() - m_window_start;
+    if (elapsed < window)
+        return;
+
+    for (auto &link : m_links) {
+        link.utilization = elapsed < 2 * window ?
+            (double)link.bytes / ((uint64_t)link.bandwidth * window) : 0.0;
+        link.bytes = 0;
+    }
+    m_window_start += Cycles(elapsed - elapsed % window);
+}
+
+Cycles
+AnalyticalNetwork::pathLatency(NodeID src, NodeID dest, int vnet, int bytes)
+{
+    Path &path = m_paths[src * m_nodes + dest];
+    fatal_if(path.links.empty(), "%s: No route from node %d to node %d\n",
+             name(), src, dest);
+
+    // The message is pipelined across the links, so only the
+    // narrowest one adds serialization latency. At every link, it
+    // waits for the mean queueing delay of an M/D/1 queue.
+    uint64_t serialization = 1;
+    double queueing = 0;
+    for (int link_id : path.links) {
+        Link &link = m_links[link_id];
+        uint64_t service = divCeil(bytes, link.bandwidth);
+        double rho = min(link.utilization, m_max_utilization);
+
+        serialization = max(serialization, service);
+        queueing += rho / (2 * (1 - rho)) * service;
+        link.bytes += bytes;
+    }
+
+    Cycles queueing_cycles((uint64_t)queueing);
+    Cycles latency = path.latency + Cycles(serialization - 1) +
+        queueing_cycles;
+    if (latency == 0)
+        latency = Cycles(1);
+
+    m_msg_count[vnet]++;
+    m_msg_latency[vnet] += latency;
+    m_queueing_latency[vnet] += queueing_cycles;
+    return latency;
+}
+
+bool
+AnalyticalNetwork::deliver(NodeID src, int vnet, MessageBuffer *buffer)
+{
+    Tick current_time = clockEdge();
+    MsgPtr msg_ptr = buffer->peekMsgPtr();
+    vector<NodeID> dests = msg_ptr->getDestination().getAllDest();
+
+    // Check for resources - for all destinations
+    for (NodeID dest : dests) {
+        MessageBuffer *out = m_fromNetQueues[dest].size() > vnet ?
+            m_fromNetQueues[dest][vnet] : nullptr;
+        fatal_if(!out, "%s: Node %d has no buffer for vnet %d\n",
+                 name(), dest, vnet);
+        if (!out->areNSlotsAvailable(1, current_time)) {
+            DPRINTF(RubyNetwork, "Can't deliver message from node %d "
+                    "since node %d is blocked\n", src, dest);
+            return false;
+        }
+    }
+
+    buffer->dequeue(current_time);
+
+    // Every destination gets a private copy of the message, which only
+    // names that destination
+    MsgPtr unmodified_msg_ptr;
+    if (dests.size() > 1)
+        unmodified_msg_ptr = msg_ptr->clone();
+
+    int bytes = MessageSizeType_to_int(msg_ptr->getMessageSize());
+    for (int i = 0; i < dests.size(); i++) {
+        NodeID dest = dests[i];
+        if (i > 0)
+            msg_ptr = unmodified_msg_ptr->clone();
+        if (dests.size() > 1) {
+            NetDest personal_dest;
+            personal_dest.add(m_machines[dest]);
+            msg_ptr->getDestination() = personal_dest;
+        }
+
+        Cycles latency = pathLatency(src, dest, vnet, bytes);
+        Tick &last_arrival = m_last_arrival[dest][vnet];
+        Tick arrival = max(current_time + cyclesToTicks(latency),
+                           last_arrival);
+        last_arrival = arrival;
+
+        DPRINTF(RubyNetwork, "Delivering message from node %d to node %d "
+                "in vnet %d after %d cycles: %s\n", src, dest, vnet,
+                latency, *msg_ptr);
+        m_fromNetQueues[dest][vnet]->enqueue(msg_ptr, current_time,
+                                             arrival - current_time);
+    }
+
+    return true;
+}
+
+void
+AnalyticalNetwork::wakeup()
+{
+    updateUtilization();
+
+    bool blocked = false;
+    Tick current_time = clockEdge();
+    for (NodeID src = 0; src < m_nodes; src++) {
+        for (int vnet = 0; vnet < m_toNetQueues[src].size(); vnet++) {
+            MessageBuffer *buffer = m_toNetQueues[src][vnet];
+            if (!buffer)
+                continue;
+
+            while (buffer->isReady(current_time)) {
+                if (!deliver(src, vnet, buffer)) {
+                    blocked = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Try again next cycle if a destination was out of buffers
+    if (blocked)
+        scheduleEvent(Cycles(1));
+}
+
+void
+AnalyticalNetwork::regStats()
+{
+    Network::regStats();
+
+    m_msg_count
+        .init(m_virtual_networks)
+        .name(name() + ".msg_count")
+        .desc("Number of messages delivered to each node")
+        .flags(Stats::total | Stats::nozero | Stats::oneline)
+        ;
+
+    m_msg_latency
+        .init(m_virtual_networks)
+        .name(name() + ".msg_latency")
+        .desc("Total latency of the delivered messages (cycles)")
+        .flags(Stats::total | Stats::nozero | Stats::oneline)
+        ;
+
+    m_queueing_latency
+        .init(m_virtual_networks)
+        .name(name() + ".queueing_latency")
+        .desc("Part of the latency that is due to contention (cycles)")
+        .flags(Stats::total | Stats::nozero | Stats::oneline)
+        ;
+
+    m_avg_msg_latency
+        .name(name() + ".average_msg_latency")
+        .desc("Average latency of a delivered message (cycles)")
+        ;
+    m_avg_msg_latency = sum(m_msg_latency) / sum(m_msg_count);
+
+    m_avg_queueing_latency
+        .name(name() + ".average_queueing_latency")
+        .desc("Average contention latency of a delivered message (cycles)")
+        ;
+    m_avg_queueing_latency = sum(m_queueing_latency) / sum(m_msg_count);
+}
+
+void
+AnalyticalNetwork::print(ostream& out) const
+{
+    out << "[AnalyticalNetwork]";
+}
+
+AnalyticalNetwork *
+AnalyticalNetworkParams::create()
+{
+    return new AnalyticalNetwork(this);
+}
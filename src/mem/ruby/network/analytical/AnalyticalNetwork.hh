@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
+#define __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
+
+#include <iostream>
+#include <vector>
+
+#include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/common/NetDest.hh"
+#include "mem/ruby/network/Network.hh"
+#include "params/AnalyticalNetwork.hh"
+
+class MessageBuffer;
+
+/**
+ * A network that does not model switches and links cycle by cycle.
+ *
+ * The route between every pair of nodes is derived from the topology
+ * at init time, and a message is moved from the buffer of its source
+ * straight into the buffer of its destination, with a delay made up
+ * of the zero-load latency of the route, the serialization latency of
+ * its narrowest link, and an M/D/1 queueing estimate for every link it
+ * traverses. The utilization of a link is measured over fixed windows
+ * of contention_window cycles, and the estimate uses the utilization
+ * of the last complete window.
+ */
+class AnalyticalNetwork : public Network, public Consumer
+{
+  public:
+    typedef AnalyticalNetworkParams Params;
+    AnalyticalNetwork(const Params *p);
+    ~AnalyticalNetwork();
+
+    void init();
+    void wakeup();
+
+    // Methods used by Topology to setup the network
+    void makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
+                        const NetDest& routing_table_entry);
+    void makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
+                       const NetDest& routing_table_entry);
+    void makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
+                          const NetDest& routing_table_entry,
+                          PortDirection src_outport,
+                          PortDirection dst_inport);
+
+    void regStats();
+    void collateStats() {}
+    void print(std::ostream& out) const;
+
+    // Messages are only held by the buffers of the controllers
+    bool functionalRead(Packet *pkt) { return false; }
+    uint32_t functionalWrite(Packet *pkt) { return 0; }
+
+  private:
+    /** A unidirectional link of the topology. */
+    struct Link
+    {
+        Cycles latency;
+        // Bytes per cycle
+        int bandwidth;
+        // Nodes routed through this link
+        NetDest routing;
+        // The switch at the receiving end, or -1 for a link to a node
+        int dest_switch;
+        // Bytes sent in the current contention window
+        uint64_t bytes;
+        // Utilization in the last complete contention window
+        double utilization;
+    };
+
+    struct Path
+    {
+        std::vector<int> links;
+        // Latency of the links and routers, without contention
+        Cycles latency;
+    };
+
+    int addLink(BasicLink *link, const NetDest &routing, int dest_switch);
+    void buildPaths();
+    void updateUtilization();
+
+    // Move the first message of a buffer to its destinations, or
+    // return false if one of them has no free buffer slot
+    bool deliver(NodeID src, int vnet, MessageBuffer *buffer);
+    Cycles pathLatency(NodeID src, NodeID dest, int vnet, int bytes);
+
+    // Private copy constructor and assignment operator
+    AnalyticalNetwork(const AnalyticalNetwork& obj);
+    AnalyticalNetwork& operator=(const AnalyticalNetwork& obj);
+
+    const Cycles m_contention_window;
+    const double m_max_utilization;
+
+    std::vector<Link> m_links;
+    // Outgoing links of every switch, in the order they were made
+    std::vector<std::vector<int>> m_switch_links;
+    // Router latency of every switch
+    std::vector<Cycles> m_router_latency;
+    // Link from every node into the network
+    std::vector<int> m_node_links;
+    // Path between every pair of nodes, indexed by src * m_nodes + dest
+    std::vector<Path> m_paths;
+    std::vector<MachineID> m_machines;
+
+    Cycles m_window_start;
+
+    // Last arrival time at every buffer feeding a node, which keeps
+    // messages in order
+    std::vector<std::vector<Tick>> m_last_arrival;
+
+    Stats::Vector m_msg_count;
+    Stats::Vector m_msg_latency;
+    Stats::Vector m_queueing_latency;
+    Stats::Formula m_avg_msg_latency;
+    Stats::Formula m_avg_queueing_latency;
+};
+
+inline std::ostream&
+operator<<(std::ostream& out, const AnalyticalNetwork& obj)
+{
+    obj.print(out);
+    out << std::flush;
+    return out;
+}
+
+#endif // __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
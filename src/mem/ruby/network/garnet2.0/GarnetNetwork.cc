@@ -35,7 +35,9 @@
 
 #include <cassert>
 
+#include "base/callback.hh"
 #include "base/cast.hh"
+#include "base/output.hh"
 #include "base/stl_helpers.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
@@ -45,6 +47,7 @@
 #include "mem/ruby/network/garnet2.0/NetworkInterface.hh"
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
+#include "mem/ruby/slicc_interface/AbstractController.hh"
 #include "mem/ruby/system/RubySystem.hh"
 
 using namespace std;
@@ -57,7 +60,11 @@ using m5::stl_helpers::deletePointers;
  */
 
 GarnetNetwork::GarnetNetwork(const Params *p)
-    : Network(p)
+    : Network(p), m_trace_replay(false),
+      m_sample_interval(p->sample_interval), m_sample_file(p->sample_file),
+      m_sample_stream(NULL),
+      m_sample_event([this]{ sample(); }, name() + ".sample_event"),
+      ppMsgInjected(NULL), ppMsgDelivered(NULL)
 {
     m_num_rows = p->num_rows;
     m_ni_flit_size = p->ni_flit_size;
@@ -65,6 +72,7 @@ GarnetNetwork::GarnetNetwork(const Params *p)
     m_buffers_per_data_vc = p->buffers_per_data_vc;
     m_buffers_per_ctrl_vc = p->buffers_per_ctrl_vc;
     m_routing_algorithm = p->routing_algorithm;
+    m_bypass_hpc_max = p->bypass_hpc_max;
 
     m_enable_fault_model = p->enable_fault_model;
     if (m_enable_fault_model)
@@ -90,10 +98,21 @@ GarnetNetwork::GarnetNetwork(const Params *p)
     }
 
     // record the network interfaces
-    for (vector<ClockedObject*>::const_iterator i = p->netifs.begin();
-         i != p->netifs.end(); ++i) {
-        NetworkInterface *ni = safe_cast<NetworkInterface *>(*i);
-        m_nis.push_back(ni);
+    // The configuration creates one network interface per external
+    // link. It serves the controller of that link, so that it can be
+    // placed on the event queue of the router the link attaches to.
+    fatal_if(p->netifs.size() != p->ext_links.size(),
+             "%s: Expected one network interface per external link\n",
+             name());
+    m_nis.resize(p->netifs.size());
+    for (int i = 0; i < p->ext_links.size(); i++) {
+        AbstractController *abs_cntrl = p->ext_links[i]->params()->ext_node;
+        NodeID node = MachineType_base_number(abs_cntrl->getType()) +
+            abs_cntrl->getVersion();
+        assert(node < m_nis.size() && m_nis[node] == NULL);
+
+        NetworkInterface *ni = safe_cast<NetworkInterface *>(p->netifs[i]);
+        m_nis[node] = ni;
         ni->init_net_ptr(this);
     }
 }
@@ -104,7 +123,7 @@ GarnetNetwork::init()
     Network::init();
 
     for (int i=0; i < m_nodes; i++) {
-        m_nis[i]->addNode(m_toNetQueues[i], m_fromNetQueues[i]);
+        m_nis[i]->addNode(i, m_toNetQueues[i], m_fromNetQueues[i]);
     }
 
     // The topology pointer should have already been initialized in the
@@ -112,6 +131,11 @@ GarnetNetwork::init()
     assert(m_topology_ptr != NULL);
     m_topology_ptr->createLinks(this);
 
+    for (vector<Router*>::const_iterator i = m_routers.begin();
+         i != m_routers.end(); ++i) {
+        (*i)->build_routing_table();
+    }
+
     // Initialize topology specific parameters
     if (getNumRows() > 0) {
         // Only for Mesh topology
@@ -125,6 +149,15 @@ GarnetNetwork::init()
         m_num_cols = -1;
     }
 
+    if (m_routing_algorithm == WEST_FIRST_ ||
+        m_routing_algorithm == ODD_EVEN_ ||
+        m_routing_algorithm == ADAPTIVE_) {
+        fatal_if(m_num_rows <= 0, "Adaptive routing (routing_algorithm %d) "
+                 "requires a Mesh topology\n", m_routing_algorithm);
+    }
+    fatal_if(m_routing_algorithm == ADAPTIVE_ && m_vcs_per_vnet < 2,
+             "Fully adaptive routing requires at least 2 VCs per vnet\n");
+
     // FaultModel: declare each router to the fault model
     if (isFaultModelEnabled()) {
         for (vector<Router*>::const_iterator i= m_routers.begin();
@@ -143,6 +176,75 @@ GarnetNetwork::init()
     }
 }
 
+void
+GarnetNetwork::startup()
+{
+    Network::startup();
+
+    if (m_sample_interval == 0)
+        return;
+
+    m_sample_stream = simout.create(m_sample_file);
+    registerExitCallback(
+        new MakeCallback<GarnetNetwork,
+                         &GarnetNetwork::closeSampleStream>(this));
+
+    // One column per link with the fraction of cycles it carried a
+    // flit, and one per router with the flits in its input buffers
+    ostream &os = *m_sample_stream->stream();
+    os << "tick";
+    for (NetworkLink *link : m_networklinks)
+        os << "," << link->name();
+    for (Router *router : m_routers)
+        os << "," << router->name();
+    os << "\n";
+
+    m_sampled_link_utilization.resize(m_networklinks.size());
+    for (int i = 0; i < m_networklinks.size(); i++) {
+        m_sampled_link_utilization[i] =
+            m_networklinks[i]->getLinkUtilization();
+    }
+    schedule(m_sample_event, clockEdge(m_sample_interval));
+}
+
+void
+GarnetNetwork::sample()
+{
+    ostream &os = *m_sample_stream->stream();
+    os << curTick();
+    for (int i = 0; i < m_networklinks.size(); i++) {
+        unsigned int utilization = m_networklinks[i]->getLinkUtilization();
+        // The counters start over when the statistics are reset
+        unsigned int flits = utilization >= m_sampled_link_utilization[i] ?
+            utilization - m_sampled_link_utilization[i] : utilization;
+        m_sampled_link_utilization[i] = utilization;
+        os << "," << double(flits) / m_sample_interval;
+    }
+    for (Router *router : m_routers)
+        os << "," << router->get_num_buffered_flits();
+    os << "\n";
+
+    schedule(m_sample_event, clockEdge(m_sample_interval));
+}
+
+void
+GarnetNetwork::closeSampleStream()
+{
+    if (m_sample_stream) {
+        simout.close(m_sample_stream);
+        m_sample_stream = NULL;
+    }
+}
+
+void
+GarnetNetwork::regProbePoints()
+{
+    ppMsgInjected = new ProbePoints::NetworkMsg(getProbeManager(),
+                                                "MsgInjected");
+    ppMsgDelivered = new ProbePoints::NetworkMsg(getProbeManager(),
+                                                 "MsgDelivered");
+}
+
 GarnetNetwork::~GarnetNetwork()
 {
     deletePointers(m_routers);
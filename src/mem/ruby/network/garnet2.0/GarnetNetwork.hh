@@ -35,20 +35,44 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_GARNETNETWORK_HH__
 
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/network/fault_model/FaultModel.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "params/GarnetNetwork.hh"
+#include "sim/core.hh"
+#include "sim/eventq.hh"
+#include "sim/probe/probe.hh"
 
 class FaultModel;
+class Message;
 class NetworkInterface;
+class OutputStream;
 class Router;
 class NetDest;
 class NetworkLink;
 class CreditLink;
 
+namespace ProbePoints {
+
+/**
+ * A unicast message entering the network at its source node
+ * (MsgInjected) or leaving it at its destination node (MsgDelivered).
+ * The message must not be kept beyond the notification.
+ */
+struct NetworkMsgInfo
+{
+    const Message *msg;
+    NodeID node;
+    int vnet;
+};
+
+typedef ProbePointArg<NetworkMsgInfo> NetworkMsg;
+
+}
+
 class GarnetNetwork : public Network
 {
   public:
@@ -57,6 +81,7 @@ class GarnetNetwork : public Network
 
     ~GarnetNetwork();
     void init();
+    void startup() override;
 
     // Configuration (set externally)
 
@@ -70,10 +95,19 @@ class GarnetNetwork : public Network
     uint32_t getBuffersPerDataVC() { return m_buffers_per_data_vc; }
     uint32_t getBuffersPerCtrlVC() { return m_buffers_per_ctrl_vc; }
     int getRoutingAlgorithm() const { return m_routing_algorithm; }
+    uint32_t getBypassHpcMax() const { return m_bypass_hpc_max; }
 
     bool isFaultModelEnabled() const { return m_enable_fault_model; }
     FaultModel* fault_model;
 
+    /**
+     * Remove messages from the network at their destination instead
+     * of handing them to the controllers. Used by trace replays, which
+     * inject messages that the controllers can't handle.
+     */
+    void setTraceReplay() { m_trace_replay = true; }
+    bool isTraceReplay() const { return m_trace_replay; }
+
 
     // Internal configuration
     bool isVNetOrdered(int vnet) const { return m_ordered[vnet]; }
@@ -101,45 +135,89 @@ class GarnetNetwork : public Network
     //! indicates the number of messages that were written.
     uint32_t functionalWrite(Packet *pkt);
 
+    // Probe points, notified by the network interfaces
+    void regProbePoints() override;
+
+    void
+    notifyMsgInjected(const ProbePoints::NetworkMsgInfo &info)
+    {
+        ppMsgInjected->notify(info);
+    }
+
+    void
+    notifyMsgDelivered(const ProbePoints::NetworkMsgInfo &info)
+    {
+        ppMsgDelivered->notify(info);
+    }
+
     // Stats
     void collateStats();
     void regStats();
     void print(std::ostream& out) const;
 
     // increment counters
-    void increment_injected_packets(int vnet) { m_packets_injected[vnet]++; }
-    void increment_received_packets(int vnet) { m_packets_received[vnet]++; }
+    // The network interfaces of a network that is split over several
+    // event queues update the counters concurrently.
+    void
+    increment_injected_packets(int vnet)
+    {
+        auto lock = statsLock();
+        m_packets_injected[vnet]++;
+    }
+
+    void
+    increment_received_packets(int vnet)
+    {
+        auto lock = statsLock();
+        m_packets_received[vnet]++;
+    }
 
     void
     increment_packet_network_latency(Cycles latency, int vnet)
     {
+        auto lock = statsLock();
         m_packet_network_latency[vnet] += latency;
     }
 
     void
     increment_packet_queueing_latency(Cycles latency, int vnet)
     {
+        auto lock = statsLock();
         m_packet_queueing_latency[vnet] += latency;
     }
 
-    void increment_injected_flits(int vnet) { m_flits_injected[vnet]++; }
-    void increment_received_flits(int vnet) { m_flits_received[vnet]++; }
+    void
+    increment_injected_flits(int vnet)
+    {
+        auto lock = statsLock();
+        m_flits_injected[vnet]++;
+    }
+
+    void
+    increment_received_flits(int vnet)
+    {
+        auto lock = statsLock();
+        m_flits_received[vnet]++;
+    }
 
     void
     increment_flit_network_latency(Cycles latency, int vnet)
     {
+        auto lock = statsLock();
         m_flit_network_latency[vnet] += latency;
     }
 
     void
     increment_flit_queueing_latency(Cycles latency, int vnet)
     {
+        auto lock = statsLock();
         m_flit_queueing_latency[vnet] += latency;
     }
 
     void
     increment_total_hops(int hops)
     {
+        auto lock = statsLock();
         m_total_hops += hops;
     }
 
@@ -152,6 +230,7 @@ class GarnetNetwork : public Network
     uint32_t m_buffers_per_ctrl_vc;
     uint32_t m_buffers_per_data_vc;
     int m_routing_algorithm;
+    uint32_t m_bypass_hpc_max;
     bool m_enable_fault_model;
 
     // Statistical variables
@@ -195,6 +274,34 @@ class GarnetNetwork : public Network
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
     std::vector<CreditLink *> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface *> m_nis;   // All NI's in Network
+
+    bool m_trace_replay;
+
+    // Time series of the link utilization and the router buffer
+    // occupancy, sampled every m_sample_interval cycles
+    void sample();
+    void closeSampleStream();
+
+    const Cycles m_sample_interval;
+    const std::string m_sample_file;
+    OutputStream *m_sample_stream;
+    std::vector<unsigned int> m_sampled_link_utilization;
+    EventFunctionWrapper m_sample_event;
+
+    ProbePoints::NetworkMsg *ppMsgInjected;
+    ProbePoints::NetworkMsg *ppMsgDelivered;
+
+    // Lock for the statistical variables, only taken when running in
+    // parallel
+    std::unique_lock<std::mutex>
+    statsLock()
+    {
+        if (inParallelMode)
+            return std::unique_lock<std::mutex>(m_stats_mutex);
+        return std::unique_lock<std::mutex>();
+    }
+
+    std::mutex m_stats_mutex;
 };
 
 inline std::ostream&
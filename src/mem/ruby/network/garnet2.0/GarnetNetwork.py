@@ -43,11 +43,18 @@ class GarnetNetwork(RubyNetwork):
     buffers_per_data_vc = Param.UInt32(4, "buffers per data virtual channel");
     buffers_per_ctrl_vc = Param.UInt32(1, "buffers per ctrl virtual channel");
     routing_algorithm = Param.Int(0,
-        "0: Weight-based Table, 1: XY, 2: Custom");
+        "0: Weight-based Table, 1: XY, 2: Custom, 3: West-first, "
+        "4: Odd-even, 5: Adaptive with escape VCs");
+    bypass_hpc_max = Param.UInt32(0, "maximum number of routers a flit "
+        "may bypass in a row (SMART HPCmax), 0 to disable bypassing")
     enable_fault_model = Param.Bool(False, "enable network fault model");
     fault_model = Param.FaultModel(NULL, "network fault model");
     garnet_deadlock_threshold = Param.UInt32(50000,
                               "network-level deadlock threshold")
+    sample_interval = Param.Cycles(0, "cycles between samples of the "
+        "link utilization and router buffer occupancy, 0 to disable")
+    sample_file = Param.String("garnet_samples.csv", "file in the output "
+        "directory for the samples, compressed if it ends in .gz")
 
 class GarnetNetworkInterface(ClockedObject):
     type = 'GarnetNetworkInterface'
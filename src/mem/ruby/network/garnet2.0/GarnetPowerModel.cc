@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/network/garnet2.0/GarnetPowerModel.hh"
+
+#include "DSENT.h"
+#include "base/logging.hh"
+#include "mem/ruby/network/garnet2.0/NetworkLink.hh"
+#include "mem/ruby/network/garnet2.0/Router.hh"
+#include "sim/clocked_object.hh"
+#include "sim/core.hh"
+
+std::map<std::string, GarnetPowerModel::Energies>
+GarnetPowerModel::energyCache;
+
+GarnetPowerModel::GarnetPowerModel(const Params *p)
+    : PowerModelState(p), config(p->dsent_config),
+      flitBits(p->flit_size * 8), lastEnergies(nullptr), lastFrequency(0),
+      lastSample(0), lastDynamicPower(0)
+{
+}
+
+const GarnetPowerModel::Energies &
+GarnetPowerModel::energies() const
+{
+    uint64_t frequency = clocked_object->frequency();
+    if (lastEnergies && frequency == lastFrequency)
+        return *lastEnergies;
+
+    std::map<std::string, std::string> params;
+    dsentParams(frequency, params);
+
+    std::string key = config;
+    for (const auto &param : params)
+        key += ";" + param.first + "=" + param.second;
+
+    auto it = energyCache.find(key);
+    if (it == energyCache.end()) {
+        std::map<LibUtil::String, LibUtil::String> overrides;
+        for (const auto &param : params)
+            overrides[param.first] = param.second;
+
+        std::map<LibUtil::String, LibUtil::String> dsent_config;
+        DSENT::Model *model = DSENT::initialize(config.c_str(),
+                                                dsent_config, overrides);
+
+        Energies e;
+        for (const auto &query : eventQueries())
+            e.event.push_back(DSENT::query(model, query));
+        e.cycle = cycleQuery().empty() ? 0 :
+            DSENT::query(model, cycleQuery());
+        e.leakage = DSENT::query(model, leakageQuery());
+
+        DSENT::finalize(dsent_config, model);
+        it = energyCache.emplace(key, e).first;
+    }
+
+    lastEnergies = &it->second;
+    lastFrequency = frequency;
+    return *lastEnergies;
+}
+
+double
+GarnetPowerModel::getDynamicPower() const
+{
+    if (curTick() == lastSample)
+        return lastDynamicPower;
+
+    const Energies &e = energies();
+    std::vector<double> counts;
+    activity(counts);
+    lastCounts.resize(counts.size(), 0);
+
+    double energy = 0;
+    for (int i = 0; i < counts.size(); i++) {
+        // The counters restart from zero when the stats are reset
+        double delta = counts[i] >= lastCounts[i] ?
+            counts[i] - lastCounts[i] : counts[i];
+        energy += e.event[i] * delta;
+    }
+
+    double seconds = double(curTick() - lastSample) / SimClock::Frequency;
+    lastDynamicPower = energy / seconds +
+        e.cycle * clocked_object->frequency();
+    lastCounts = counts;
+    lastSample = curTick();
+
+    return lastDynamicPower;
+}
+
+double
+GarnetPowerModel::getStaticPower() const
+{
+    return energies().leakage;
+}
+
+GarnetRouterPowerModel::GarnetRouterPowerModel(const Params *p)
+    : GarnetPowerModel(p), buffersPerVC(p->buffers_per_vc), router(nullptr)
+{
+}
+
+void
+GarnetRouterPowerModel::startup()
+{
+    router = dynamic_cast<Router *>(clocked_object);
+    fatal_if(!router, "%s: GarnetRouterPowerModel needs a Garnet router\n",
+             name());
+}
+
+void
+GarnetRouterPowerModel::dsentParams(uint64_t frequency,
+    std::map<std::string, std::string> &params) const
+{
+    std::string vcs = "[";
+    std::string buffers = "[";
+    for (int i = 0; i < router->get_num_vnets(); i++) {
+        std::string sep = i ? ", " : "";
+        vcs += sep + std::to_string(router->get_vc_per_vnet());
+        buffers += sep + std::to_string(buffersPerVC);
+    }
+
+    params["Frequency"] = std::to_string(frequency);
+    params["NumberInputPorts"] = std::to_string(router->get_num_inports());
+    params["NumberOutputPorts"] = std::to_string(router->get_num_outports());
+    params["NumberVirtualNetworks"] = std::to_string(router->get_num_vnets());
+    params["NumberVirtualChannelsPerVirtualNetwork"] = vcs + "]";
+    params["NumberBuffersPerVirtualChannel"] = buffers + "]";
+    params["NumberBitsPerFlit"] = std::to_string(flitBits);
+}
+
+const std::vector<std::string> &
+GarnetRouterPowerModel::eventQueries() const
+{
+    static const std::vector<std::string> queries = {
+        "Energy>>Router:ReadBuffer",
+        "Energy>>Router:WriteBuffer",
+        "Energy>>Router:ArbitrateSwitch->ArbitrateStage1",
+        "Energy>>Router:ArbitrateSwitch->ArbitrateStage2",
+        "Energy>>Router:TraverseCrossbar->Multicast1",
+    };
+    return queries;
+}
+
+std::string
+GarnetRouterPowerModel::cycleQuery() const
+{
+    return "Energy>>Router:DistributeClock";
+}
+
+std::string
+GarnetRouterPowerModel::leakageQuery() const
+{
+    return "NddPower>>Router:Leakage";
+}
+
+void
+GarnetRouterPowerModel::activity(std::vector<double> &counts) const
+{
+    counts = {
+        router->get_buffer_read_activity(),
+        router->get_buffer_write_activity(),
+        router->get_sw_input_arbiter_activity(),
+        router->get_sw_output_arbiter_activity(),
+        router->get_crossbar_activity(),
+    };
+}
+
+GarnetLinkPowerModel::GarnetLinkPowerModel(const Params *p)
+    : GarnetPowerModel(p), link(nullptr)
+{
+}
+
+void
+GarnetLinkPowerModel::startup()
+{
+    link = dynamic_cast<NetworkLink *>(clocked_object);
+    fatal_if(!link, "%s: GarnetLinkPowerModel needs a Garnet network link\n",
+             name());
+}
+
+void
+GarnetLinkPowerModel::dsentParams(uint64_t frequency,
+    std::map<std::string, std::string> &params) const
+{
+    params["Frequency"] = std::to_string(frequency);
+    params["NumberBits"] = std::to_string(flitBits);
+}
+
+const std::vector<std::string> &
+GarnetLinkPowerModel::eventQueries() const
+{
+    static const std::vector<std::string> queries = {
+        "Energy>>RepeatedLink:Send",
+    };
+    return queries;
+}
+
+std::string
+GarnetLinkPowerModel::leakageQuery() const
+{
+    return "NddPower>>RepeatedLink:Leakage";
+}
+
+void
+GarnetLinkPowerModel::activity(std::vector<double> &counts) const
+{
+    counts = { double(link->getLinkUtilization()) };
+}
+
+GarnetRouterPowerModel *
+GarnetRouterPowerModelParams::create()
+{
+    return new GarnetRouterPowerModel(this);
+}
+
+GarnetLinkPowerModel *
+GarnetLinkPowerModelParams::create()
+{
+    return new GarnetLinkPowerModel(this);
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_GARNETPOWERMODEL_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_GARNETPOWERMODEL_HH__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "params/GarnetLinkPowerModel.hh"
+#include "params/GarnetPowerModel.hh"
+#include "params/GarnetRouterPowerModel.hh"
+#include "sim/power/power_model.hh"
+
+class NetworkLink;
+class Router;
+
+/**
+ * A power model that evaluates DSENT while simulating. DSENT is run
+ * once for every distinct configuration and clock frequency to get the
+ * energy of each event and the leakage power of the modelled hardware,
+ * and the results are shared by all objects with the same
+ * configuration. A power sample then only weighs these energies with
+ * the activity counted since the previous sample, so the power can be
+ * fed back to the simulation, e.g. to a thermal model or a DVFS
+ * controller.
+ */
+class GarnetPowerModel : public PowerModelState
+{
+  public:
+    typedef GarnetPowerModelParams Params;
+    GarnetPowerModel(const Params *p);
+
+    /**
+     * Dynamic power averaged over the time since the previous sample.
+     * Samples taken at the same tick return the same value.
+     */
+    double getDynamicPower() const override;
+    double getStaticPower() const override;
+
+  protected:
+    /** Results of a DSENT evaluation */
+    struct Energies
+    {
+        /** Energy of each event returned by activity() (Joules) */
+        std::vector<double> event;
+        /** Energy spent every cycle (Joules) */
+        double cycle;
+        /** Leakage power (Watts) */
+        double leakage;
+    };
+
+    /** DSENT parameters that differ from the config file */
+    virtual void dsentParams(uint64_t frequency,
+                             std::map<std::string, std::string> &params)
+        const = 0;
+
+    /** DSENT queries for the energy of each event */
+    virtual const std::vector<std::string> &eventQueries() const = 0;
+
+    /** DSENT query for the energy spent every cycle, if any */
+    virtual std::string cycleQuery() const { return ""; }
+
+    /** DSENT query for the leakage power */
+    virtual std::string leakageQuery() const = 0;
+
+    /**
+     * The number of times each event happened since the last stats
+     * reset, in the order of eventQueries().
+     */
+    virtual void activity(std::vector<double> &counts) const = 0;
+
+    /** Look up (or evaluate) the DSENT results for the current clock */
+    const Energies &energies() const;
+
+    /** DSENT configuration file */
+    const std::string config;
+
+    /** Flit size in bits */
+    const unsigned flitBits;
+
+  private:
+    /** DSENT results, keyed by configuration and parameters */
+    static std::map<std::string, Energies> energyCache;
+
+    /** Results used by the previous sample and their frequency */
+    mutable const Energies *lastEnergies;
+    mutable uint64_t lastFrequency;
+
+    /** State at the previous sample */
+    mutable Tick lastSample;
+    mutable std::vector<double> lastCounts;
+    mutable double lastDynamicPower;
+};
+
+/**
+ * DSENT power model of a Garnet router, counting buffer reads and
+ * writes, switch arbitration and crossbar traversals.
+ */
+class GarnetRouterPowerModel : public GarnetPowerModel
+{
+  public:
+    typedef GarnetRouterPowerModelParams Params;
+    GarnetRouterPowerModel(const Params *p);
+
+    void startup() override;
+
+  protected:
+    void dsentParams(uint64_t frequency,
+                     std::map<std::string, std::string> &params)
+        const override;
+    const std::vector<std::string> &eventQueries() const override;
+    std::string cycleQuery() const override;
+    std::string leakageQuery() const override;
+    void activity(std::vector<double> &counts) const override;
+
+    const unsigned buffersPerVC;
+
+    Router *router;
+};
+
+/**
+ * DSENT power model of a Garnet link, counting the flits it sends.
+ */
+class GarnetLinkPowerModel : public GarnetPowerModel
+{
+  public:
+    typedef GarnetLinkPowerModelParams Params;
+    GarnetLinkPowerModel(const Params *p);
+
+    void startup() override;
+
+  protected:
+    void dsentParams(uint64_t frequency,
+                     std::map<std::string, std::string> &params)
+        const override;
+    const std::vector<std::string> &eventQueries() const override;
+    std::string leakageQuery() const override;
+    void activity(std::vector<double> &counts) const override;
+
+    NetworkLink *link;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_GARNETPOWERMODEL_HH__
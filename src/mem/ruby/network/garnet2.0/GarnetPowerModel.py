@@ -0,0 +1,56 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from PowerModelState import PowerModelState
+
+# Garnet power models evaluate DSENT while simulating. DSENT runs once for
+# every distinct configuration and clock frequency, and every power sample
+# weighs the resulting energies with the activity since the last sample.
+# The DSENT configuration files name their technology files relative to
+# the gem5 root, so gem5 has to be run from there.
+class GarnetPowerModel(PowerModelState):
+    type = 'GarnetPowerModel'
+    cxx_header = "mem/ruby/network/garnet2.0/GarnetPowerModel.hh"
+    abstract = True
+
+    dsent_config = Param.String("DSENT configuration file")
+    flit_size = Param.UInt32(Parent.ni_flit_size, "flit size in bytes")
+
+class GarnetRouterPowerModel(GarnetPowerModel):
+    type = 'GarnetRouterPowerModel'
+    cxx_header = "mem/ruby/network/garnet2.0/GarnetPowerModel.hh"
+
+    dsent_config = "ext/dsent/configs/router.cfg"
+    buffers_per_vc = Param.UInt32(Parent.buffers_per_data_vc,
+                                  "buffers per virtual channel")
+
+class GarnetLinkPowerModel(GarnetPowerModel):
+    type = 'GarnetLinkPowerModel'
+    cxx_header = "mem/ruby/network/garnet2.0/GarnetPowerModel.hh"
+
+    dsent_config = "ext/dsent/configs/electrical-link.cfg"
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/network/garnet2.0/GarnetTraceProbe.hh"
+
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "mem/ruby/slicc_interface/Message.hh"
+#include "proto/network_trace.pb.h"
+#include "sim/core.hh"
+
+GarnetTraceProbe::GarnetTraceProbe(const GarnetTraceProbeParams *p)
+    : ProbeListenerObject(p), network(p->network), traceStream(nullptr),
+      nextId(0)
+{
+    std::string filename = p->trace_file;
+    if (filename.empty())
+        filename = name() + ".trc";
+
+    const std::string suffix = ".gz";
+    if (p->trace_compress &&
+        (filename.size() < suffix.size() ||
+         filename.compare(filename.size() - suffix.size(), suffix.size(),
+                          suffix) != 0))
+        filename += suffix;
+
+    // If the trace file is not specified as an absolute path, it is
+    // put in the simulation output directory
+    traceStream = new ProtoOutputStream(simout.resolve(filename));
+
+    registerExitCallback(
+        new MakeCallback<GarnetTraceProbe,
+                         &GarnetTraceProbe::closeStreams>(this));
+}
+
+void
+GarnetTraceProbe::regProbeListeners()
+{
+    typedef ProbeListenerArg<GarnetTraceProbe, ProbePoints::NetworkMsgInfo>
+        NetworkMsgListener;
+    listeners.push_back(new NetworkMsgListener(
+        this, "MsgInjected", &GarnetTraceProbe::msgInjected));
+    listeners.push_back(new NetworkMsgListener(
+        this, "MsgDelivered", &GarnetTraceProbe::msgDelivered));
+}
+
+void
+GarnetTraceProbe::startup()
+{
+    ProtoMessage::NetworkHeader header_msg;
+    header_msg.set_obj_id(name());
+    header_msg.set_tick_freq(SimClock::Frequency);
+    header_msg.set_num_nodes(network->getNumNodes());
+    traceStream->write(header_msg);
+}
+
+void
+GarnetTraceProbe::closeStreams()
+{
+    delete traceStream;
+    traceStream = nullptr;
+}
+
+void
+GarnetTraceProbe::msgInjected(const ProbePoints::NetworkMsgInfo &info)
+{
+    std::lock_guard<std::mutex> lock(traceMutex);
+    const Message *msg = info.msg;
+    const uint64_t id = nextId++;
+    inFlight[msg] = id;
+
+    MachineID dest = msg->getDestination().smallestElement();
+
+    ProtoMessage::NetworkMessage msg_record;
+    msg_record.set_id(id);
+    msg_record.set_tick(curTick());
+    msg_record.set_src(info.node);
+    msg_record.set_dest(MachineType_base_number(dest.getType()) +
+                        dest.getNum());
+    msg_record.set_vnet(info.vnet);
+    msg_record.set_size(msg->getMessageSize());
+
+    Addr line;
+    if (msg->getLineAddr(line)) {
+        msg_record.set_addr(line);
+        auto it = lastDelivery.find(std::make_pair(info.node, line));
+        if (it != lastDelivery.end()) {
+            msg_record.set_dep_id(it->second.id);
+            msg_record.set_dep_delay(curTick() - it->second.tick);
+        }
+    }
+
+    traceStream->write(msg_record);
+}
+
+void
+GarnetTraceProbe::msgDelivered(const ProbePoints::NetworkMsgInfo &info)
+{
+    std::lock_guard<std::mutex> lock(traceMutex);
+    auto it = inFlight.find(info.msg);
+    if (it == inFlight.end())
+        return;
+
+    Addr line;
+    if (info.msg->getLineAddr(line)) {
+        Delivery &delivery = lastDelivery[std::make_pair(info.node, line)];
+        delivery.id = it->second;
+        delivery.tick = curTick();
+    }
+    inFlight.erase(it);
+}
+
+GarnetTraceProbe *
+GarnetTraceProbeParams::create()
+{
+    return new GarnetTraceProbe(this);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Probe that records the messages of a Garnet network into a trace.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_GARNETTRACEPROBE_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_GARNETTRACEPROBE_HH__
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
+#include "params/GarnetTraceProbe.hh"
+#include "proto/protoio.hh"
+#include "sim/probe/probe.hh"
+
+/**
+ * Records every unicast message that enters the network as it leaves
+ * its source network interface. The trace can be replayed into a
+ * network without the protocol by a GarnetTraceReplay.
+ *
+ * The probe infers the dependencies between messages from the line
+ * addresses they carry: a message sent by a node depends on the last
+ * message for the same line that the node received, which pairs up
+ * requests, forwards and responses.
+ */
+class GarnetTraceProbe : public ProbeListenerObject
+{
+  public:
+    GarnetTraceProbe(const GarnetTraceProbeParams *p);
+
+    void regProbeListeners() override;
+    void startup() override;
+
+  private:
+    void msgInjected(const ProbePoints::NetworkMsgInfo &info);
+    void msgDelivered(const ProbePoints::NetworkMsgInfo &info);
+
+    /**
+     * Callback to flush and close the output stream on exit, as the
+     * destructor is not called.
+     */
+    void closeStreams();
+
+    struct Delivery
+    {
+        uint64_t id;
+        Tick tick;
+    };
+
+    GarnetNetwork *network;
+
+    ProtoOutputStream *traceStream;
+
+    /** The interfaces of a parallel network notify concurrently. */
+    std::mutex traceMutex;
+
+    uint64_t nextId;
+
+    /** Trace ids of the messages in the network */
+    std::unordered_map<const Message *, uint64_t> inFlight;
+
+    /** Last message delivered to each node for each line */
+    std::map<std::pair<NodeID, Addr>, Delivery> lastDelivery;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_GARNETTRACEPROBE_HH__
@@ -33,6 +33,8 @@
 
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
 
+#include "base/bitfield.hh"
+#include "base/logging.hh"
 #include "base/stl_helpers.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/Credit.hh"
@@ -57,6 +59,9 @@ InputUnit::InputUnit(int id, PortDirection direction, Router *router)
         m_num_buffer_writes[i] = 0;
     }
 
+    m_active_vcs.resize((m_num_vcs + 63) / 64, 0);
+    m_num_active_vcs = 0;
+
     creditQueue = new flitBuffer();
     // Instantiating the virtual channels
     m_vcs.resize(m_num_vcs);
@@ -76,8 +81,10 @@ InputUnit::~InputUnit()
  * Each flit arrives with an input VC.
  * For HEAD/HEAD_TAIL flits, performs route computation,
  * and updates route in the input VC.
- * The flit is buffered for (m_latency - 1) cycles in the input VC
- * and marked as valid for SwitchAllocation starting that cycle.
+ * If bypassing is enabled, the flit is handed to the SwitchAllocator,
+ * which may send it straight on to the output link.
+ * Otherwise the flit is buffered for (m_latency - 1) cycles in the input
+ * VC and marked as valid for SwitchAllocation starting that cycle.
  *
  */
 
@@ -110,9 +117,13 @@ InputUnit::wakeup()
             assert(m_vcs[vc]->get_state() == ACTIVE_);
         }
 
+        if (m_router->try_bypass(m_id, vc, t_flit))
+            return;
 
         // Buffer the flit
+        t_flit->reset_bypassed_hops();
         m_vcs[vc]->insertFlit(t_flit);
+        set_vc_active_bit(vc);
 
         int vnet = vc/m_vc_per_vnet;
         // number of writes same as reads
@@ -139,6 +150,39 @@ InputUnit::wakeup()
     }
 }
 
+int
+InputUnit::next_active_vc(int vc) const
+{
+    if (m_num_active_vcs == 0)
+        return -1;
+    if (vc >= m_num_vcs)
+        vc = 0;
+
+    // Start with the bits at or after vc in its word, and come back
+    // to the ones before it after visiting every other word.
+    const int num_words = m_active_vcs.size();
+    int word = vc / 64;
+    uint64_t bits = m_active_vcs[word] & (~0ULL << (vc % 64));
+    for (int i = 0; i <= num_words; i++) {
+        if (bits)
+            return word * 64 + findLsbSet(bits);
+        word = (word + 1) % num_words;
+        bits = m_active_vcs[word];
+    }
+
+    panic("InputUnit %d has %d active VCs but none is set\n",
+          m_id, m_num_active_vcs);
+}
+
+int
+InputUnit::get_num_buffered_flits() const
+{
+    int num_flits = 0;
+    for (int vc = 0; vc < m_num_vcs; vc++)
+        num_flits += m_vcs[vc]->getSize();
+    return num_flits;
+}
+
 // Send a credit back to upstream router for this VC.
 // Called by SwitchAllocator when the flit in this VC wins the Switch.
 void
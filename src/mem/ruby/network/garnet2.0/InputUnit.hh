@@ -34,6 +34,7 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_INPUTUNIT_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_INPUTUNIT_HH__
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
@@ -109,7 +110,10 @@ class InputUnit : public Consumer
     inline flit*
     getTopFlit(int vc)
     {
-        return m_vcs[vc]->getTopFlit();
+        flit *t_flit = m_vcs[vc]->getTopFlit();
+        if (m_vcs[vc]->isEmpty())
+            clear_vc_active_bit(vc);
+        return t_flit;
     }
 
     inline bool
@@ -124,6 +128,16 @@ class InputUnit : public Consumer
         return m_vcs[invc]->isReady(curTime);
     }
 
+    // Does any VC of this input port hold a flit?
+    inline bool has_active_vcs() const { return m_num_active_vcs > 0; }
+
+    // First VC at or after vc (wrapping around) that holds a flit,
+    // or -1 if all VCs are empty.
+    int next_active_vc(int vc) const;
+
+    // Number of flits held by all VCs of this input port
+    int get_num_buffered_flits() const;
+
     flitBuffer* getCreditQueue() { return creditQueue; }
 
     inline void
@@ -149,11 +163,38 @@ class InputUnit : public Consumer
     void resetStats();
 
   private:
+    inline void
+    set_vc_active_bit(int vc)
+    {
+        uint64_t &word = m_active_vcs[vc / 64];
+        const uint64_t mask = 1ULL << (vc % 64);
+        if (!(word & mask)) {
+            word |= mask;
+            m_num_active_vcs++;
+        }
+    }
+
+    inline void
+    clear_vc_active_bit(int vc)
+    {
+        uint64_t &word = m_active_vcs[vc / 64];
+        const uint64_t mask = 1ULL << (vc % 64);
+        if (word & mask) {
+            word &= ~mask;
+            m_num_active_vcs--;
+        }
+    }
+
     int m_id;
     PortDirection m_direction;
     int m_num_vcs;
     int m_vc_per_vnet;
 
+    // Bitmap of the VCs that hold at least one flit, which lets the
+    // SwitchAllocator skip empty VCs
+    std::vector<uint64_t> m_active_vcs;
+    int m_num_active_vcs;
+
     Router *m_router;
     NetworkLink *m_in_link;
     CreditLink *m_credit_link;
@@ -55,6 +55,7 @@ NetworkInterface::NetworkInterface(const Params *p)
       vc_busy_counter(m_virtual_networks, 0)
 {
     m_router_id = -1;
+    m_node = -1;
     m_vc_round_robin = 0;
     m_ni_out_vcs.resize(m_num_vcs);
     m_ni_out_vcs_enqueue_time.resize(m_num_vcs);
@@ -116,9 +117,10 @@ NetworkInterface::addOutPort(NetworkLink *out_link,
 }
 
 void
-NetworkInterface::addNode(vector<MessageBuffer *>& in,
-                            vector<MessageBuffer *>& out)
+NetworkInterface::addNode(NodeID node, vector<MessageBuffer *>& in,
+                          vector<MessageBuffer *>& out)
 {
+    m_node = node;
     inNode_ptr = in;
     outNode_ptr = out;
 
@@ -216,9 +218,16 @@ NetworkInterface::wakeup()
         // If a tail flit is received, enqueue into the protocol buffers if
         // space is available. Otherwise, exchange non-tail flits for credits.
         if (t_flit->get_type() == TAIL_ || t_flit->get_type() == HEAD_TAIL_) {
-            if (!messageEnqueuedThisCycle &&
+            if (m_net_ptr->isTraceReplay()) {
+                // Replayed messages leave the network here
+                ejectMessage(t_flit);
+                sendCredit(t_flit, true);
+                incrementStats(t_flit);
+                delete t_flit;
+            } else if (!messageEnqueuedThisCycle &&
                 outNode_ptr[vnet]->areNSlotsAvailable(1, curTime)) {
                 // Space is available. Enqueue to protocol buffer.
+                ejectMessage(t_flit);
                 outNode_ptr[vnet]->enqueue(t_flit->get_msg_ptr(), curTime,
                                            cyclesToTicks(Cycles(1)));
 
@@ -277,6 +286,16 @@ NetworkInterface::sendCredit(flit *t_flit, bool is_free)
     outCreditQueue->insert(credit_flit);
 }
 
+void
+NetworkInterface::ejectMessage(flit *t_flit)
+{
+    ProbePoints::NetworkMsgInfo info;
+    info.msg = t_flit->get_msg_ptr().get();
+    info.node = m_node;
+    info.vnet = t_flit->get_vnet();
+    m_net_ptr->notifyMsgDelivered(info);
+}
+
 bool
 NetworkInterface::checkStallQueue()
 {
@@ -291,6 +310,7 @@ NetworkInterface::checkStallQueue()
 
             // If we can now eject to the protocol buffer, send back credits
             if (outNode_ptr[vnet]->areNSlotsAvailable(1, curTime)) {
+                ejectMessage(stallFlit);
                 outNode_ptr[vnet]->enqueue(stallFlit->get_msg_ptr(), curTime,
                                            cyclesToTicks(Cycles(1)));
 
@@ -385,6 +405,12 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         // so that the first router increments it to 0
         route.hops_traversed = -1;
 
+        ProbePoints::NetworkMsgInfo info;
+        info.msg = new_net_msg_ptr;
+        info.node = m_node;
+        info.vnet = vnet;
+        m_net_ptr->notifyMsgInjected(info);
+
         m_net_ptr->increment_injected_packets(vnet);
         for (int i = 0; i < num_flits; i++) {
             m_net_ptr->increment_injected_flits(vnet);
@@ -64,7 +64,7 @@ class NetworkInterface : public ClockedObject, public Consumer
 
     void dequeueCallback();
     void wakeup();
-    void addNode(std::vector<MessageBuffer *> &inNode,
+    void addNode(NodeID node, std::vector<MessageBuffer *> &inNode,
                  std::vector<MessageBuffer *> &outNode);
 
     void print(std::ostream& out) const;
@@ -79,6 +79,7 @@ class NetworkInterface : public ClockedObject, public Consumer
     const NodeID m_id;
     const int m_virtual_networks, m_vc_per_vnet, m_num_vcs;
     int m_router_id; // id of my router
+    NodeID m_node; // node of the controller I serve
     std::vector<OutVcState *> m_out_vc_state;
     std::vector<int> m_vc_allocator;
     int m_vc_round_robin; // For round robin scheduling
@@ -114,6 +115,7 @@ class NetworkInterface : public ClockedObject, public Consumer
     void scheduleOutputLink();
     void checkReschedule();
     void sendCredit(flit *t_flit, bool is_free);
+    void ejectMessage(flit *t_flit);
 
     void incrementStats(flit *t_flit);
 };
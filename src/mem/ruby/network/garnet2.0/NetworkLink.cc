@@ -33,14 +33,16 @@
 
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 
+#include "base/logging.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
+#include "sim/eventq.hh"
 
 NetworkLink::NetworkLink(const Params *p)
     : ClockedObject(p), Consumer(this), m_id(p->link_id),
       m_type(NUM_LINK_TYPES_),
       m_latency(p->link_latency),
       linkBuffer(new flitBuffer()), link_consumer(nullptr),
-      link_srcQueue(nullptr), m_link_utilized(0),
+      link_srcQueue(nullptr), m_last_send(MaxTick), m_link_utilized(0),
       m_vc_load(p->vcs_per_vnet * p->virt_nets)
 {
 }
@@ -65,16 +67,65 @@ NetworkLink::setSourceQueue(flitBuffer *srcQueue)
 void
 NetworkLink::wakeup()
 {
-    if (link_srcQueue->isReady(curCycle())) {
-        flit *t_flit = link_srcQueue->getTopFlit();
-        t_flit->set_time(curCycle() + m_latency);
+    if (link_srcQueue->isReady(curCycle()))
+        send(link_srcQueue->getTopFlit());
+}
+
+bool
+NetworkLink::isIdle()
+{
+    return m_last_send != clockEdge() && link_srcQueue->isEmpty();
+}
+
+void
+NetworkLink::bypass(flit *t_flit)
+{
+    assert(isIdle());
+    send(t_flit);
+}
+
+void
+NetworkLink::send(flit *t_flit)
+{
+    t_flit->set_time(curCycle() + m_latency);
+    m_last_send = clockEdge();
+    m_link_utilized++;
+    m_vc_load[t_flit->get_vc()]++;
+
+    if (inParallelMode &&
+        link_consumer->eventQueue() != curEventQueue()) {
+        sendRemote(t_flit);
+    } else {
         linkBuffer->insert(t_flit);
         link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
-        m_link_utilized++;
-        m_vc_load[t_flit->get_vc()]++;
     }
 }
 
+// A link between routers on different event queues runs on the queue
+// of its source. The link buffer belongs to the consumer, so flits are
+// inserted into it by an event on the queue of the consumer. The link
+// latency has to cover the simulation quantum, so that the flit is
+// not touched by the source anymore when the event runs.
+void
+NetworkLink::sendRemote(flit *t_flit)
+{
+    Tick arrival_time = clockEdge(m_latency);
+    fatal_if(arrival_time - curTick() < simQuantum,
+             "%s: A flit to another event queue arrives after %d ticks, "
+             "less than the simulation quantum (%d ticks).\n", name(),
+             arrival_time - curTick(), simQuantum);
+
+    // The delivery runs ahead of the wakeups of the consumer that are
+    // due in the same tick, so that they see the flit.
+    auto *evt = new EventFunctionWrapper(
+        [this, t_flit, arrival_time]{
+            linkBuffer->insert(t_flit);
+            link_consumer->scheduleEventAbsolute(arrival_time);
+        }, "NetworkLink Delivery Event", true, Event::Default_Pri - 1);
+
+    link_consumer->eventQueue()->schedule(evt, arrival_time);
+}
+
 void
 NetworkLink::resetStats()
 {
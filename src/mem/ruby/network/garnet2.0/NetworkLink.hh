@@ -60,6 +60,11 @@ class NetworkLink : public ClockedObject, public Consumer
     int get_id() const { return m_id; }
     void wakeup();
 
+    // Has the link sent nothing this cycle, and has nothing to send?
+    bool isIdle();
+    // Send a flit that bypassed the source queue this cycle
+    void bypass(flit *t_flit);
+
     unsigned int getLinkUtilization() const { return m_link_utilized; }
     const std::vector<unsigned int> & getVcLoad() const { return m_vc_load; }
 
@@ -73,6 +78,9 @@ class NetworkLink : public ClockedObject, public Consumer
     void resetStats();
 
   private:
+    void send(flit *t_flit);
+    void sendRemote(flit *t_flit);
+
     const int m_id;
     link_type m_type;
     const Cycles m_latency;
@@ -80,6 +88,7 @@ class NetworkLink : public ClockedObject, public Consumer
     flitBuffer *linkBuffer;
     Consumer *link_consumer;
     flitBuffer *link_srcQueue;
+    Tick m_last_send;
 
     // Statistical variables
     unsigned int m_link_utilized;
@@ -58,8 +58,8 @@ class OutputUnit : public Consumer
     void decrement_credit(int out_vc);
     void increment_credit(int out_vc);
     bool has_credit(int out_vc);
-    bool has_free_vc(int vnet);
-    int select_free_vc(int vnet);
+    bool has_free_vc(int vnet, bool escape_vc = true);
+    int select_free_vc(int vnet, bool escape_vc = true);
 
     inline PortDirection get_direction() { return m_direction; }
 
@@ -94,6 +94,16 @@ class OutputUnit : public Consumer
         m_out_link->scheduleEventAbsolute(m_router->clockEdge(Cycles(1)));
     }
 
+    // Can a flit bypass the CrossbarSwitch onto the output link this
+    // cycle?
+    inline bool is_link_idle() { return m_out_link->isIdle(); }
+
+    inline void
+    bypass_flit(flit *t_flit)
+    {
+        m_out_link->bypass(t_flit);
+    }
+
     uint32_t functionalWrite(Packet *pkt);
 
   private:
@@ -158,18 +158,43 @@ Router::getInportDirection(int inport)
     return m_input_unit[inport]->get_direction();
 }
 
+// Called by the GarnetNetwork once all links have been created
+void
+Router::build_routing_table()
+{
+    m_routing_unit->buildDestinationTable(m_network_ptr->getNumNodes());
+}
+
 int
 Router::route_compute(RouteInfo route, int inport, PortDirection inport_dirn)
 {
     return m_routing_unit->outportCompute(route, inport, inport_dirn);
 }
 
+bool
+Router::escape_vc_allowed(RouteInfo route, int outport)
+{
+    return m_routing_unit->escapeVcAllowed(route, outport);
+}
+
+int
+Router::escape_outport(RouteInfo route)
+{
+    return m_routing_unit->escapeOutport(route);
+}
+
 void
 Router::grant_switch(int inport, flit *t_flit)
 {
     m_switch->update_sw_winner(inport, t_flit);
 }
 
+bool
+Router::try_bypass(int inport, int invc, flit *t_flit)
+{
+    return m_sw_alloc->try_bypass(inport, invc, t_flit);
+}
+
 void
 Router::schedule_wakeup(Cycles time)
 {
@@ -216,6 +241,11 @@ Router::regStats()
         .name(name() + ".sw_output_arbiter_activity")
         .flags(Stats::nozero)
     ;
+
+    m_bypassed_flits
+        .name(name() + ".bypassed_flits")
+        .flags(Stats::nozero)
+    ;
 }
 
 void
@@ -231,6 +261,54 @@ Router::collateStats()
     m_sw_input_arbiter_activity = m_sw_alloc->get_input_arbiter_activity();
     m_sw_output_arbiter_activity = m_sw_alloc->get_output_arbiter_activity();
     m_crossbar_activity = m_switch->get_crossbar_activity();
+    m_bypassed_flits = m_sw_alloc->get_bypass_activity();
+}
+
+int
+Router::get_num_buffered_flits() const
+{
+    int num_flits = 0;
+    for (const InputUnit *input_unit : m_input_unit)
+        num_flits += input_unit->get_num_buffered_flits();
+    return num_flits;
+}
+
+double
+Router::get_buffer_read_activity() const
+{
+    double reads = 0;
+    for (const InputUnit *input_unit : m_input_unit)
+        for (int j = 0; j < m_virtual_networks; j++)
+            reads += input_unit->get_buf_read_activity(j);
+    return reads;
+}
+
+double
+Router::get_buffer_write_activity() const
+{
+    double writes = 0;
+    for (const InputUnit *input_unit : m_input_unit)
+        for (int j = 0; j < m_virtual_networks; j++)
+            writes += input_unit->get_buf_write_activity(j);
+    return writes;
+}
+
+double
+Router::get_sw_input_arbiter_activity() const
+{
+    return m_sw_alloc->get_input_arbiter_activity();
+}
+
+double
+Router::get_sw_output_arbiter_activity() const
+{
+    return m_sw_alloc->get_output_arbiter_activity();
+}
+
+double
+Router::get_crossbar_activity() const
+{
+    return m_switch->get_crossbar_activity();
 }
 
 void
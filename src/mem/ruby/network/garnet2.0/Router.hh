@@ -91,8 +91,12 @@ class Router : public BasicRouter, public Consumer
     PortDirection getOutportDirection(int outport);
     PortDirection getInportDirection(int inport);
 
+    void build_routing_table();
     int route_compute(RouteInfo route, int inport, PortDirection direction);
+    bool escape_vc_allowed(RouteInfo route, int outport);
+    int escape_outport(RouteInfo route);
     void grant_switch(int inport, flit *t_flit);
+    bool try_bypass(int inport, int invc, flit *t_flit);
     void schedule_wakeup(Cycles time);
 
     std::string getPortDirectionName(PortDirection direction);
@@ -103,6 +107,16 @@ class Router : public BasicRouter, public Consumer
     void collateStats();
     void resetStats();
 
+    // Number of flits held by the input buffers of the router
+    int get_num_buffered_flits() const;
+
+    // Activity since the last stats reset, for power models
+    double get_buffer_read_activity() const;
+    double get_buffer_write_activity() const;
+    double get_sw_input_arbiter_activity() const;
+    double get_sw_output_arbiter_activity() const;
+    double get_crossbar_activity() const;
+
     // For Fault Model:
     bool get_fault_vector(int temperature, float fault_vector[]) {
         return m_network_ptr->fault_model->fault_vector(m_id, temperature,
@@ -135,6 +149,8 @@ class Router : public BasicRouter, public Consumer
     Stats::Scalar m_sw_output_arbiter_activity;
 
     Stats::Scalar m_crossbar_activity;
+
+    Stats::Scalar m_bypassed_flits;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTER_HH__
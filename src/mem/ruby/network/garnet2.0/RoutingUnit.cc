@@ -35,6 +35,7 @@
 
 #include "base/cast.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
+#include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
@@ -62,43 +63,55 @@ RoutingUnit::addWeight(int link_weight)
  * The routing table is populated during topology creation.
  * Routes can be biased via weight assignments in the topology file.
  * Correct weight assignments are critical to provide deadlock avoidance.
+ *
+ * Flits are unicast (the NetworkInterface splits multicast messages),
+ * so the candidate output links for every destination node are found
+ * once, after the topology has been created, and head flits only look
+ * them up.
  */
 
+void
+RoutingUnit::buildDestinationTable(int num_nodes)
+{
+    m_dest_candidates.assign(num_nodes, std::vector<int>());
+
+    for (int m = 0; m < MachineType_NUM; m++) {
+        MachineType type = (MachineType)m;
+        for (NodeID i = 0; i < MachineType_base_count(type); i++) {
+            MachineID mach = {type, i};
+            std::vector<int> &candidates =
+                m_dest_candidates[MachineType_base_number(type) + i];
+
+            // Identify the minimum weight among the candidate output
+            // links
+            int min_weight = INFINITE_;
+            for (int link = 0; link < m_routing_table.size(); link++) {
+                if (m_routing_table[link].isElement(mach) &&
+                    m_weight_table[link] <= min_weight)
+                    min_weight = m_weight_table[link];
+            }
+
+            // Collect all candidate output links with this minimum weight
+            for (int link = 0; link < m_routing_table.size(); link++) {
+                if (m_routing_table[link].isElement(mach) &&
+                    m_weight_table[link] == min_weight)
+                    candidates.push_back(link);
+            }
+        }
+    }
+}
+
 int
-RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
+RoutingUnit::lookupRoutingTable(int vnet, NodeID dest)
 {
-    // First find all possible output link candidates
     // For ordered vnet, just choose the first
     // (to make sure different packets don't choose different routes)
     // For unordered vnet, randomly choose any of the links
     // To have a strict ordering between links, they should be given
     // different weights in the topology file
 
-    int output_link = -1;
-    int min_weight = INFINITE_;
-    std::vector<int> output_link_candidates;
-    int num_candidates = 0;
-
-    // Identify the minimum weight among the candidate output links
-    for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
-
-        if (m_weight_table[link] <= min_weight)
-            min_weight = m_weight_table[link];
-        }
-    }
-
-    // Collect all candidate output links with this minimum weight
-    for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
-
-            if (m_weight_table[link] == min_weight) {
-
-                num_candidates++;
-                output_link_candidates.push_back(link);
-            }
-        }
-    }
+    assert(dest < m_dest_candidates.size());
+    const std::vector<int> &output_link_candidates = m_dest_candidates[dest];
 
     if (output_link_candidates.size() == 0) {
         fatal("Fatal Error:: No Route exists from this Router.");
@@ -108,10 +121,9 @@ RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
     // Randomly select any candidate output link
     int candidate = 0;
     if (!(m_router->get_net_ptr())->isVNetOrdered(vnet))
-        candidate = rand() % num_candidates;
+        candidate = rand() % output_link_candidates.size();
 
-    output_link = output_link_candidates.at(candidate);
-    return output_link;
+    return output_link_candidates.at(candidate);
 }
 
 
@@ -146,7 +158,7 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
         // Multiple NIs may be connected to this router,
         // all with output port direction = "Local"
         // Get exact outport id from table
-        outport = lookupRoutingTable(route.vnet, route.net_dest);
+        outport = lookupRoutingTable(route.vnet, route.dest_ni);
         return outport;
     }
 
@@ -157,14 +169,18 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
 
     switch (routing_algorithm) {
         case TABLE_:  outport =
-            lookupRoutingTable(route.vnet, route.net_dest); break;
+            lookupRoutingTable(route.vnet, route.dest_ni); break;
         case XY_:     outport =
             outportComputeXY(route, inport, inport_dirn); break;
+        case WEST_FIRST_:
+        case ODD_EVEN_:
+        case ADAPTIVE_: outport =
+            outportComputeAdaptive(route, routing_algorithm); break;
         // any custom algorithm
         case CUSTOM_: outport =
             outportComputeCustom(route, inport, inport_dirn); break;
         default: outport =
-            lookupRoutingTable(route.vnet, route.net_dest); break;
+            lookupRoutingTable(route.vnet, route.dest_ni); break;
     }
 
     assert(outport != -1);
@@ -230,6 +246,170 @@ RoutingUnit::outportComputeXY(RouteInfo route,
     return m_outports_dirn2idx[outport_dirn];
 }
 
+void
+RoutingUnit::meshDistance(RouteInfo route, int &x_hops, int &y_hops)
+{
+    int num_cols = m_router->get_net_ptr()->getNumCols();
+    assert(num_cols > 0);
+
+    int my_id = m_router->get_id();
+    x_hops = route.dest_router % num_cols - my_id % num_cols;
+    y_hops = route.dest_router / num_cols - my_id / num_cols;
+}
+
+PortDirection
+RoutingUnit::xyDirection(int x_hops, int y_hops)
+{
+    assert(x_hops != 0 || y_hops != 0);
+    if (x_hops != 0)
+        return x_hops > 0 ? "East" : "West";
+    else
+        return y_hops > 0 ? "North" : "South";
+}
+
+// The credits of the VCs of a vnet at an output port count the free
+// buffer slots at the downstream router, so the candidate with the
+// most credits is the least congested one. Ties go to the earlier
+// candidate.
+int
+RoutingUnit::selectOutport(const std::vector<PortDirection> &candidates,
+                           int vnet)
+{
+    int vc_per_vnet = m_router->get_vc_per_vnet();
+    int vc_base = vnet * vc_per_vnet;
+
+    int best_outport = -1;
+    int best_credits = -1;
+    for (auto dirn : candidates) {
+        auto it = m_outports_dirn2idx.find(dirn);
+        if (it == m_outports_dirn2idx.end()) {
+            fatal("Router %d has no %s output port for adaptive routing\n",
+                  m_router->get_id(), dirn);
+        }
+
+        OutputUnit *output_unit = m_router->get_outputUnit_ref()[it->second];
+        int credits = 0;
+        for (int vc = vc_base; vc < vc_base + vc_per_vnet; vc++)
+            credits += output_unit->get_credit_count(vc);
+
+        if (credits > best_credits) {
+            best_credits = credits;
+            best_outport = it->second;
+        }
+    }
+
+    assert(best_outport != -1);
+    return best_outport;
+}
+
+// Minimal adaptive routing in a Mesh
+// West-first and odd-even are turn models that prohibit enough turns
+// to be deadlock free on their own. The fully adaptive algorithm may
+// use any minimal direction, and relies on an escape VC in every vnet
+// that is only used along the XY route (see escapeVcAllowed).
+int
+RoutingUnit::outportComputeAdaptive(RouteInfo route,
+                                    RoutingAlgorithm routing_algorithm)
+{
+    int x_hops, y_hops;
+    meshDistance(route, x_hops, y_hops);
+
+    // already checked that in outportCompute() function
+    assert(!(x_hops == 0 && y_hops == 0));
+
+    // Packets in an ordered vnet all have to take the same path
+    if ((m_router->get_net_ptr())->isVNetOrdered(route.vnet))
+        return escapeOutport(route);
+
+    PortDirection x_dirn = x_hops > 0 ? "East" : "West";
+    PortDirection y_dirn = y_hops > 0 ? "North" : "South";
+    std::vector<PortDirection> candidates;
+
+    switch (routing_algorithm) {
+      case WEST_FIRST_:
+        // Turns into the west are prohibited,
+        // so all west hops are taken first
+        if (x_hops < 0) {
+            candidates.push_back(x_dirn);
+        } else {
+            if (x_hops > 0)
+                candidates.push_back(x_dirn);
+            if (y_hops != 0)
+                candidates.push_back(y_dirn);
+        }
+        break;
+
+      case ODD_EVEN_: {
+        // Chiu's odd-even turn model: no turns from the east into the
+        // north or south in even columns, and no turns from the north
+        // or south into the west in odd columns
+        int num_cols = m_router->get_net_ptr()->getNumCols();
+        int my_x = m_router->get_id() % num_cols;
+        int src_x = route.src_router % num_cols;
+        int dest_x = route.dest_router % num_cols;
+
+        if (x_hops == 0) {
+            candidates.push_back(y_dirn);
+        } else if (x_hops > 0) {
+            if (y_hops == 0) {
+                candidates.push_back(x_dirn);
+            } else {
+                if (my_x % 2 == 1 || my_x == src_x)
+                    candidates.push_back(y_dirn);
+                if (dest_x % 2 == 1 || x_hops != 1)
+                    candidates.push_back(x_dirn);
+            }
+        } else {
+            candidates.push_back(x_dirn);
+            if (y_hops != 0 && my_x % 2 == 0)
+                candidates.push_back(y_dirn);
+        }
+        break;
+      }
+
+      case ADAPTIVE_:
+        if (x_hops != 0)
+            candidates.push_back(x_dirn);
+        if (y_hops != 0)
+            candidates.push_back(y_dirn);
+        break;
+
+      default:
+        panic("Routing algorithm %d is not adaptive\n", routing_algorithm);
+    }
+
+    return selectOutport(candidates, route.vnet);
+}
+
+// With fully adaptive routing, the first VC of every vnet is an escape
+// VC, which may only be allocated to packets that follow the XY
+// route. XY routing is deadlock free, and a packet can always fall
+// back to it, so the adaptive VCs cannot deadlock either.
+bool
+RoutingUnit::escapeVcAllowed(RouteInfo route, int outport)
+{
+    if (m_router->get_net_ptr()->getRoutingAlgorithm() != ADAPTIVE_ ||
+        route.dest_router == m_router->get_id())
+        return true;
+
+    return outport == escapeOutport(route);
+}
+
+int
+RoutingUnit::escapeOutport(RouteInfo route)
+{
+    int x_hops, y_hops;
+    meshDistance(route, x_hops, y_hops);
+
+    PortDirection dirn = xyDirection(x_hops, y_hops);
+    auto it = m_outports_dirn2idx.find(dirn);
+    if (it == m_outports_dirn2idx.end()) {
+        fatal("Router %d has no %s output port for XY routing\n",
+              m_router->get_id(), dirn);
+    }
+    return it->second;
+}
+
 // Template for implementing custom routing algorithm
 // using port directions. (Example adaptive)
 int
@@ -55,8 +55,12 @@ class RoutingUnit
     void addRoute(const NetDest& routing_table_entry);
     void addWeight(int link_weight);
 
+    // Resolve the candidate output ports of every destination node
+    // once all routes have been added
+    void buildDestinationTable(int num_nodes);
+
     // get output port from routing table
-    int  lookupRoutingTable(int vnet, NetDest net_dest);
+    int  lookupRoutingTable(int vnet, NodeID dest);
 
     // Topology-specific direction based routing
     void addInDirection(PortDirection inport_dirn, int inport);
@@ -67,18 +71,40 @@ class RoutingUnit
                          int inport,
                          PortDirection inport_dirn);
 
+    // Minimal adaptive routing for Mesh
+    int outportComputeAdaptive(RouteInfo route,
+                               RoutingAlgorithm routing_algorithm);
+
     // Custom Routing Algorithm using Port Directions
     int outportComputeCustom(RouteInfo route,
                              int inport,
                              PortDirection inport_dirn);
 
+    // Escape VCs for the fully adaptive algorithm:
+    // may a packet routed through outport use the escape VC, and
+    // the outport of the escape (XY) route
+    bool escapeVcAllowed(RouteInfo route, int outport);
+    int escapeOutport(RouteInfo route);
+
   private:
+    // Signed hops left along X and Y towards the destination router
+    void meshDistance(RouteInfo route, int &x_hops, int &y_hops);
+    PortDirection xyDirection(int x_hops, int y_hops);
+
+    // Pick the least congested of the candidate output directions
+    int selectOutport(const std::vector<PortDirection> &candidates,
+                      int vnet);
+
     Router *m_router;
 
     // Routing Table
     std::vector<NetDest> m_routing_table;
     std::vector<int> m_weight_table;
 
+    // Output ports with the minimum weight towards each destination
+    // node, derived from the routing and weight tables
+    std::vector<std::vector<int>> m_dest_candidates;
+
     // Inport and Outport direction to idx maps
     std::map<PortDirection, int> m_inports_dirn2idx;
     std::map<int, PortDirection> m_inports_idx2dirn;
@@ -48,6 +48,23 @@ SwitchAllocator::SwitchAllocator(Router *router)
 
     m_input_arbiter_activity = 0;
     m_output_arbiter_activity = 0;
+    m_bypass_activity = 0;
+}
+
+// Direction in which a flit that arrives from inport_dirn continues
+// straight through the router
+static PortDirection
+straight_direction(PortDirection inport_dirn)
+{
+    if (inport_dirn == "West")
+        return "East";
+    if (inport_dirn == "East")
+        return "West";
+    if (inport_dirn == "South")
+        return "North";
+    if (inport_dirn == "North")
+        return "South";
+    return "";
 }
 
 void
@@ -58,6 +75,8 @@ SwitchAllocator::init()
 
     m_num_inports = m_router->get_num_inports();
     m_num_outports = m_router->get_num_outports();
+    m_escape_vcs =
+        m_router->get_net_ptr()->getRoutingAlgorithm() == ADAPTIVE_;
     m_round_robin_inport.resize(m_num_outports);
     m_round_robin_invc.resize(m_num_inports);
     m_port_requests.resize(m_num_outports);
@@ -67,6 +86,17 @@ SwitchAllocator::init()
         m_round_robin_invc[i] = 0;
     }
 
+    m_bypass_hpc_max = m_router->get_net_ptr()->getBypassHpcMax();
+    m_bypass_outport.assign(m_num_inports, -1);
+    for (int inport = 0; inport < m_num_inports; inport++) {
+        PortDirection dirn =
+            straight_direction(m_router->getInportDirection(inport));
+        for (int outport = 0; outport < m_num_outports; outport++) {
+            if (m_router->getOutportDirection(outport) == dirn)
+                m_bypass_outport[inport] = outport;
+        }
+    }
+
     for (int i = 0; i < m_num_outports; i++) {
         m_port_requests[i].resize(m_num_inports);
         m_vc_winners[i].resize(m_num_inports);
@@ -113,19 +143,27 @@ SwitchAllocator::arbitrate_inports()
 {
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
+    // Only VCs that hold flits are visited, in the same order as a
+    // scan over all VCs starting at the round robin pointer.
     for (int inport = 0; inport < m_num_inports; inport++) {
-        int invc = m_round_robin_invc[inport];
-
-        for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
+        InputUnit *input_unit = m_input_unit[inport];
+        const int first_vc =
+            input_unit->next_active_vc(m_round_robin_invc[inport]);
+        if (first_vc == -1)
+            continue;
 
-            if (m_input_unit[inport]->need_stage(invc, SA_,
-                m_router->curCycle())) {
+        int invc = first_vc;
+        do {
+            if (input_unit->need_stage(invc, SA_, m_router->curCycle())) {
 
                 // This flit is in SA stage
 
                 int  outport = m_input_unit[inport]->get_outport(invc);
                 int  outvc   = m_input_unit[inport]->get_outvc(invc);
 
+                if (outvc == -1 && m_escape_vcs)
+                    outport = escape_fallback(inport, invc, outport);
+
                 // check if the flit in this InputVC is allowed to be sent
                 // send_allowed conditions described in that function.
                 bool make_request =
@@ -145,10 +183,8 @@ SwitchAllocator::arbitrate_inports()
                 }
             }
 
-            invc++;
-            if (invc >= m_num_vcs)
-                invc = 0;
-        }
+            invc = input_unit->next_active_vc(invc + 1);
+        } while (invc != first_vc);
     }
 }
 
@@ -296,7 +332,8 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
         // needs outvc
         // this is only true for HEAD and HEAD_TAIL flits.
 
-        if (m_output_unit[outport]->has_free_vc(vnet)) {
+        if (m_output_unit[outport]->has_free_vc(vnet,
+                escape_vc_allowed(inport, invc, outport))) {
 
             has_outvc = true;
 
@@ -342,7 +379,8 @@ int
 SwitchAllocator::vc_allocate(int outport, int inport, int invc)
 {
     // Select a free VC from the output port
-    int outvc = m_output_unit[outport]->select_free_vc(get_vnet(invc));
+    int outvc = m_output_unit[outport]->select_free_vc(get_vnet(invc),
+        escape_vc_allowed(inport, invc, outport));
 
     // has to get a valid VC since it checked before performing SA
     assert(outvc != -1);
@@ -350,6 +388,109 @@ SwitchAllocator::vc_allocate(int outport, int inport, int invc)
     return outvc;
 }
 
+// With fully adaptive routing, may the head flit in invc be allocated
+// the escape VC of outport?
+bool
+SwitchAllocator::escape_vc_allowed(int inport, int invc, int outport)
+{
+    if (!m_escape_vcs)
+        return true;
+
+    flit *t_flit = m_input_unit[inport]->peekTopFlit(invc);
+    return m_router->escape_vc_allowed(t_flit->get_route(), outport);
+}
+
+// A head flit that was routed adaptively, but finds no free adaptive
+// VC at its output port, switches to the escape route if that has a
+// free VC. Returns the output port to request.
+int
+SwitchAllocator::escape_fallback(int inport, int invc, int outport)
+{
+    int vnet = get_vnet(invc);
+    if (escape_vc_allowed(inport, invc, outport) ||
+        m_output_unit[outport]->has_free_vc(vnet, false))
+        return outport;
+
+    flit *t_flit = m_input_unit[inport]->peekTopFlit(invc);
+    int escape_outport = m_router->escape_outport(t_flit->get_route());
+    if (!m_output_unit[escape_outport]->has_free_vc(vnet))
+        return outport;
+
+    DPRINTF(RubyNetwork, "Router %d rerouting invc %d at inport %d "
+            "to escape outport %d\n", m_router->get_id(), invc, inport,
+            escape_outport);
+    m_input_unit[inport]->grant_outport(invc, escape_outport);
+    return escape_outport;
+}
+
+/*
+ * SMART-style bypassing: a flit that arrives at an input port with no
+ * buffered flits, and continues straight through the router, skips
+ * buffering and both stages of allocation. It is sent onto the output
+ * link in the cycle it arrives, so the router adds no latency, if
+ *    - it has bypassed fewer than bypass_hpc_max routers since it was
+ *      last buffered,
+ *    - the output link sends nothing else this cycle, and
+ *    - a free output VC (HEAD/HEAD_TAIL) or a credit in its output VC
+ *      (BODY/TAIL) is available.
+ * The credit for the input VC is returned as if the flit had won SA.
+ * Returns false, leaving the input VC untouched apart from the route of
+ * HEAD/HEAD_TAIL flits, if the flit has to be buffered.
+ */
+
+bool
+SwitchAllocator::try_bypass(int inport, int invc, flit *t_flit)
+{
+    InputUnit *input_unit = m_input_unit[inport];
+    int outport = input_unit->get_outport(invc);
+
+    if (t_flit->get_bypassed_hops() >= m_bypass_hpc_max ||
+        outport != m_bypass_outport[inport] ||
+        input_unit->has_active_vcs())
+        return false;
+
+    OutputUnit *output_unit = m_output_unit[outport];
+    if (!output_unit->is_link_idle())
+        return false;
+
+    int outvc = input_unit->get_outvc(invc);
+    if (outvc == -1) {
+        bool escape_vc = !m_escape_vcs ||
+            m_router->escape_vc_allowed(t_flit->get_route(), outport);
+        outvc = output_unit->select_free_vc(get_vnet(invc), escape_vc);
+        if (outvc == -1)
+            return false;
+        input_unit->grant_outvc(invc, outvc);
+    } else if (!output_unit->has_credit(outvc)) {
+        return false;
+    }
+
+    DPRINTF(RubyNetwork, "Router %d bypassed invc %d at inport %d to "
+            "outvc %d at outport %d for flit %s at time: %lld\n",
+            m_router->get_id(), invc,
+            m_router->getPortDirectionName(input_unit->get_direction()),
+            outvc,
+            m_router->getPortDirectionName(output_unit->get_direction()),
+            *t_flit, m_router->curCycle());
+
+    t_flit->set_outport(outport);
+    t_flit->set_vc(outvc);
+    t_flit->increment_bypassed_hops();
+    output_unit->decrement_credit(outvc);
+
+    bool is_tail = t_flit->get_type() == TAIL_ ||
+        t_flit->get_type() == HEAD_TAIL_;
+    if (is_tail)
+        input_unit->set_vc_idle(invc, m_router->curCycle());
+    input_unit->increment_credit(invc, is_tail, m_router->curCycle());
+
+    t_flit->advance_stage(LT_, m_router->curCycle());
+    output_unit->bypass_flit(t_flit);
+    m_bypass_activity++;
+
+    return true;
+}
+
 // Wakeup the router next cycle to perform SA again
 // if there are flits ready.
 void
@@ -358,12 +499,18 @@ SwitchAllocator::check_for_wakeup()
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
-        for (int j = 0; j < m_num_vcs; j++) {
+        const int first_vc = m_input_unit[i]->next_active_vc(0);
+        if (first_vc == -1)
+            continue;
+
+        int j = first_vc;
+        do {
             if (m_input_unit[i]->need_stage(j, SA_, nextCycle)) {
                 m_router->schedule_wakeup(Cycles(1));
                 return;
             }
-        }
+            j = m_input_unit[i]->next_active_vc(j + 1);
+        } while (j > first_vc);
     }
 }
 
@@ -393,4 +540,5 @@ SwitchAllocator::resetStats()
 {
     m_input_arbiter_activity = 0;
     m_output_arbiter_activity = 0;
+    m_bypass_activity = 0;
 }
\ No newline at end of file
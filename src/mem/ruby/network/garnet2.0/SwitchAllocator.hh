@@ -43,6 +43,7 @@
 class Router;
 class InputUnit;
 class OutputUnit;
+class flit;
 
 class SwitchAllocator : public Consumer
 {
@@ -58,6 +59,9 @@ class SwitchAllocator : public Consumer
     void arbitrate_outports();
     bool send_allowed(int inport, int invc, int outport, int outvc);
     int vc_allocate(int outport, int inport, int invc);
+    bool escape_vc_allowed(int inport, int invc, int outport);
+    int escape_fallback(int inport, int invc, int outport);
+    bool try_bypass(int inport, int invc, flit *t_flit);
 
     inline double
     get_input_arbiter_activity()
@@ -70,13 +74,29 @@ class SwitchAllocator : public Consumer
         return m_output_arbiter_activity;
     }
 
+    inline double
+    get_bypass_activity()
+    {
+        return m_bypass_activity;
+    }
+
     void resetStats();
 
   private:
     int m_num_inports, m_num_outports;
     int m_num_vcs, m_vc_per_vnet;
+    // Is the first VC of every vnet an escape VC?
+    bool m_escape_vcs;
+
+    // Maximum number of routers a flit may bypass in a row, 0 if
+    // bypassing is disabled
+    uint32_t m_bypass_hpc_max;
+    // Output port that continues in the direction of each input port,
+    // or -1 if there is none
+    std::vector<int> m_bypass_outport;
 
     double m_input_arbiter_activity, m_output_arbiter_activity;
+    double m_bypass_activity;
 
     Router *m_router;
     std::vector<int> m_round_robin_invc;
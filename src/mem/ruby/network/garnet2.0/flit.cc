@@ -46,6 +46,7 @@ flit::flit(int id, int  vc, int vnet, RouteInfo route, int size,
     m_vnet = vnet;
     m_vc = vc;
     m_route = route;
+    m_bypassed_hops = 0;
     m_stage.first = I_;
     m_stage.second = m_time;
 
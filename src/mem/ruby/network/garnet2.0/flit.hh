@@ -37,6 +37,7 @@
 #include <cassert>
 #include <iostream>
 
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
@@ -44,6 +45,22 @@
 class flit
 {
   public:
+    /**
+     * Flits and credits are created for every hop of every packet and
+     * freed at the other end of the link, so they are pooled. The
+     * pool is shared by flits and credits; freed blocks go to the
+     * free lists of the thread that frees them.
+     */
+    typedef PoolAllocator<flit> Pool;
+
+    static void *operator new(size_t size) { return Pool::allocate(size); }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        Pool::deallocate(p, size);
+    }
+
     flit() {}
     flit(int id, int vc, int vnet, RouteInfo route, int size,
          MsgPtr msg_ptr, Cycles curTime);
@@ -61,6 +78,7 @@ class flit
     flit_type get_type() { return m_type; }
     std::pair<flit_stage, Cycles> get_stage() { return m_stage; }
     Cycles get_src_delay() { return src_delay; }
+    int get_bypassed_hops() { return m_bypassed_hops; }
 
     void set_outport(int port) { m_outport = port; }
     void set_time(Cycles time) { m_time = time; }
@@ -70,6 +88,10 @@ class flit
     void set_dequeue_time(Cycles time) { m_dequeue_time = time; }
 
     void increment_hops() { m_route.hops_traversed++; }
+
+    // Routers bypassed since the flit was last buffered
+    void increment_bypassed_hops() { m_bypassed_hops++; }
+    void reset_bypassed_hops() { m_bypassed_hops = 0; }
     void print(std::ostream& out) const;
 
     bool
@@ -110,6 +132,7 @@ class flit
     MsgPtr m_msg_ptr;
     int m_outport;
     Cycles src_delay;
+    int m_bypassed_hops;
     std::pair<flit_stage, Cycles> m_stage;
 };
 
@@ -67,6 +67,35 @@ PerfectSwitch::init(SimpleNetwork *network_ptr)
     }
 }
 
+// Called by the SimpleNetwork once all links have been created
+void
+PerfectSwitch::buildRoutingTable(int num_nodes)
+{
+    m_dest_link.assign(num_nodes, -1);
+    m_link_dests.clear();
+
+    NetDest covered;
+    for (int link = 0; link < m_routing_table.size(); link++) {
+        NetDest dests = m_routing_table[link];
+        dests.removeNetDest(covered);
+        covered.addNetDest(dests);
+        m_link_dests.push_back(dests);
+    }
+
+    for (int m = 0; m < MachineType_NUM; m++) {
+        MachineType type = (MachineType)m;
+        for (NodeID i = 0; i < MachineType_base_count(type); i++) {
+            MachineID mach = {type, i};
+            for (int link = 0; link < m_link_dests.size(); link++) {
+                if (m_link_dests[link].isElement(mach)) {
+                    m_dest_link[MachineType_base_number(type) + i] = link;
+                    break;
+                }
+            }
+        }
+    }
+}
+
 void
 PerfectSwitch::addInPort(const vector<MessageBuffer*>& in)
 {
@@ -178,7 +207,8 @@ PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
                 for (int out = 0; out < m_out.size(); out++) {
                     int out_queue_length = 0;
                     for (int v = 0; v < m_virtual_networks; v++) {
-                        out_queue_length += m_out[out][v]->getSize(current_time);
+                        out_queue_length +=
+                            m_out[out][v]->getSize(current_time);
                     }
                     int value =
                         (out_queue_length << 8) |
@@ -190,32 +220,53 @@ PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
                 // Look at the most empty link first
                 sort(m_link_order.begin(), m_link_order.end());
             }
-        }
 
-        for (int i = 0; i < m_routing_table.size(); i++) {
-            // pick the next link to look at
-            int link = m_link_order[i].m_link;
-            NetDest dst = m_routing_table[link];
-            DPRINTF(RubyNetwork, "dst: %s\n", dst);
+            for (int i = 0; i < m_routing_table.size(); i++) {
+                // pick the next link to look at
+                int link = m_link_order[i].m_link;
+                const NetDest &dst = m_routing_table[link];
+                DPRINTF(RubyNetwork, "dst: %s\n", dst);
 
-            if (!msg_dsts.intersectionIsNotEmpty(dst))
-                continue;
+                if (!msg_dsts.intersectionIsNotEmpty(dst))
+                    continue;
 
-            // Remember what link we're using
-            output_links.push_back(link);
+                // Remember what link we're using
+                output_links.push_back(link);
 
-            // Need to remember which destinations need this message in
-            // another vector.  This Set is the intersection of the
-            // routing_table entry and the current destination set.  The
-            // intersection must not be empty, since we are inside "if"
-            output_link_destinations.push_back(msg_dsts.AND(dst));
+                // Need to remember which destinations need this message
+                // in another vector.  This Set is the intersection of the
+                // routing_table entry and the current destination set.
+                // The intersection must not be empty, since we are inside
+                // "if"
+                output_link_destinations.push_back(msg_dsts.AND(dst));
 
-            // Next, we update the msg_destination not to include
-            // those nodes that were already handled by this link
-            msg_dsts.removeNetDest(dst);
-        }
+                // Next, we update the msg_destination not to include
+                // those nodes that were already handled by this link
+                msg_dsts.removeNetDest(dst);
+            }
 
-        assert(msg_dsts.count() == 0);
+            assert(msg_dsts.count() == 0);
+        } else {
+            // The links are always looked at in order, so the link of
+            // every destination is known up front. Collect the links in
+            // that order.
+            for (NodeID dest : msg_dsts.getAllDest()) {
+                assert(dest < m_dest_link.size());
+                int link = m_dest_link[dest];
+                assert(link != -1);
+
+                int pos = 0;
+                while (pos < output_links.size() && output_links[pos] < link)
+                    pos++;
+                if (pos == output_links.size() || output_links[pos] != link)
+                    output_links.insert(output_links.begin() + pos, link);
+            }
+
+            for (int i = 0; i < output_links.size(); i++) {
+                output_link_destinations.push_back(
+                    msg_dsts.AND(m_link_dests[output_links[i]]));
+            }
+        }
 
         // Check for resources - for all outgoing queues
         bool enough = true;
@@ -66,6 +66,7 @@ class PerfectSwitch : public Consumer
     { return csprintf("PerfectSwitch-%i", m_switch_id); }
 
     void init(SimpleNetwork *);
+    void buildRoutingTable(int num_nodes);
     void addInPort(const std::vector<MessageBuffer*>& in);
     void addOutPort(const std::vector<MessageBuffer*>& out,
                     const NetDest& routing_table_entry);
@@ -98,6 +99,13 @@ class PerfectSwitch : public Consumer
     std::vector<NetDest> m_routing_table;
     std::vector<LinkOrder> m_link_order;
 
+    // Without adaptive routing, a message for a node goes out on the
+    // first link whose routing table entry contains the node.
+    // m_dest_link holds that link for every node, and m_link_dests the
+    // nodes each link is responsible for.
+    std::vector<int> m_dest_link;
+    std::vector<NetDest> m_link_dests;
+
     uint32_t m_virtual_networks;
     int m_round_robin_start;
     int m_wakeups_wo_switch;
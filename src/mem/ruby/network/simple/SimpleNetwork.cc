@@ -46,7 +46,8 @@ using m5::stl_helpers::deletePointers;
 SimpleNetwork::SimpleNetwork(const Params *p)
     : Network(p), m_buffer_size(p->buffer_size),
       m_endpoint_bandwidth(p->endpoint_bandwidth),
-      m_adaptive_routing(p->adaptive_routing)
+      m_adaptive_routing(p->adaptive_routing),
+      m_event_driven_throttles(p->event_driven_throttles)
 {
     // record the routers
     for (vector<BasicRouter*>::const_iterator i = p->routers.begin();
@@ -69,6 +70,9 @@ SimpleNetwork::init()
     // the parent class network constructor.
     assert(m_topology_ptr != NULL);
     m_topology_ptr->createLinks(this);
+
+    for (auto sw : m_switches)
+        sw->buildRoutingTable(m_nodes);
 }
 
 SimpleNetwork::~SimpleNetwork()
@@ -52,6 +52,7 @@ class SimpleNetwork : public Network
     int getBufferSize() { return m_buffer_size; }
     int getEndpointBandwidth() { return m_endpoint_bandwidth; }
     bool getAdaptiveRouting() {return m_adaptive_routing; }
+    bool getEventDrivenThrottles() { return m_event_driven_throttles; }
 
     void collateStats();
     void regStats();
@@ -89,6 +90,7 @@ class SimpleNetwork : public Network
     const int m_buffer_size;
     const int m_endpoint_bandwidth;
     const bool m_adaptive_routing;
+    const bool m_event_driven_throttles;
 
     //Statistical variables
     Stats::Formula m_msg_counts[MessageSizeType_NUM];
@@ -40,6 +40,9 @@ class SimpleNetwork(RubyNetwork):
         "default buffer size; 0 indicates infinite buffering");
     endpoint_bandwidth = Param.Int(1000, "bandwidth adjustment factor");
     adaptive_routing = Param.Bool(False, "enable adaptive routing");
+    event_driven_throttles = Param.Bool(False, "compute the departure time "
+        "of every message from the link bandwidth instead of waking up "
+        "the throttles every cycle");
     int_link_buffers = VectorParam.MessageBuffer("Buffers for int_links")
 
     def setup_buffers(self):
@@ -79,10 +79,10 @@ Switch::addOutPort(const vector<MessageBuffer*>& out,
 {
     // Create a throttle
     RubySystem *rs = m_network_ptr->params()->ruby_system;
-    Throttle* throttle_ptr = new Throttle(m_id, rs, m_throttles.size(),
-                                          link_latency, bw_multiplier,
-                                          m_network_ptr->getEndpointBandwidth(),
-                                          this);
+    Throttle* throttle_ptr =
+        new Throttle(m_id, rs, m_throttles.size(), link_latency,
+                     bw_multiplier, m_network_ptr->getEndpointBandwidth(),
+                     m_network_ptr->getEventDrivenThrottles(), this);
 
     m_throttles.push_back(throttle_ptr);
 
@@ -103,6 +103,12 @@ Switch::addOutPort(const vector<MessageBuffer*>& out,
     throttle_ptr->addLinks(intermediateBuffers, out);
 }
 
+void
+Switch::buildRoutingTable(int num_nodes)
+{
+    m_perfect_switch->buildRoutingTable(num_nodes);
+}
+
 const Throttle*
 Switch::getThrottle(LinkID link_number) const
 {
@@ -66,6 +66,7 @@ class Switch : public BasicRouter
     void addOutPort(const std::vector<MessageBuffer*>& out,
                     const NetDest& routing_table_entry,
                     Cycles link_latency, int bw_multiplier);
+    void buildRoutingTable(int num_nodes);
 
     const Throttle* getThrottle(LinkID link_number) const;
 
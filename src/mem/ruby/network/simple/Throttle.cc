@@ -32,6 +32,7 @@
 
 #include "base/cast.hh"
 #include "base/cprintf.hh"
+#include "base/intmath.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/network/Network.hh"
@@ -50,9 +51,9 @@ static int network_message_to_size(Message* net_msg_ptr);
 
 Throttle::Throttle(int sID, RubySystem *rs, NodeID node, Cycles link_latency,
                    int link_bandwidth_multiplier, int endpoint_bandwidth,
-                   Switch *em)
+                   bool event_driven, Switch *em)
     : Consumer(em), m_switch_id(sID), m_switch(em), m_node(node),
-      m_ruby_system(rs)
+      m_ruby_system(rs), m_event_driven(event_driven), m_link_free_time(0)
 {
     m_vnets = 0;
 
@@ -146,6 +147,11 @@ Throttle::operateVnet(int vnet, int &bw_remaining, bool &schedule_wakeup,
 void
 Throttle::wakeup()
 {
+    if (m_event_driven) {
+        wakeupEventDriven();
+        return;
+    }
+
     // Limits the number of message sent to a limited number of bytes/cycle.
     assert(getLinkBandwidth() > 0);
     int bw_remaining = getLinkBandwidth();
@@ -199,6 +205,88 @@ Throttle::wakeup()
     }
 }
 
+int
+Throttle::readyVnet(Tick current_time, bool iteration_direction,
+                    bool &blocked) const
+{
+    for (int i = 0; i < m_vnets; ++i) {
+        int vnet = iteration_direction ? i : m_vnets - 1 - i;
+        MessageBuffer *in = m_in[vnet];
+        MessageBuffer *out = m_out[vnet];
+        if (out == nullptr || in == nullptr || !in->isReady(current_time))
+            continue;
+
+        if (out->areNSlotsAvailable(1, current_time))
+            return vnet;
+        blocked = true;
+    }
+    return -1;
+}
+
+void
+Throttle::wakeupEventDriven()
+{
+    assert(getLinkBandwidth() > 0);
+    Tick current_time = m_switch->clockEdge();
+    Tick period = m_switch->clockPeriod();
+
+    m_wakeups_wo_switch++;
+    bool iteration_direction = false;
+    if (m_wakeups_wo_switch > PRIORITY_SWITCH_LIMIT) {
+        m_wakeups_wo_switch = 0;
+        iteration_direction = true;
+    }
+
+    // A message can be started as long as the link has bandwidth left
+    // in the current cycle, in the same way as wakeup() carries the
+    // unused part of a cycle over to the next message.
+    bool blocked = false;
+    int vnet;
+    while (m_link_free_time < current_time + period &&
+           (vnet = readyVnet(current_time, iteration_direction,
+                             blocked)) >= 0) {
+        MessageBuffer *in = m_in[vnet];
+        MessageBuffer *out = m_out[vnet];
+        MsgPtr msg_ptr = in->peekMsgPtr();
+        Message *net_msg_ptr = msg_ptr.get();
+
+        Tick serialization =
+            divCeil((Tick)network_message_to_size(net_msg_ptr) * period,
+                    (Tick)getLinkBandwidth());
+        m_link_free_time = max(m_link_free_time, current_time) +
+            serialization;
+        m_link_utilization_proxy += double(serialization) / period;
+
+        DPRINTF(RubyNetwork, "throttle: %d my bw %d link busy until "
+                "%lld, time: %lld.\n", m_node, getLinkBandwidth(),
+                m_link_free_time, m_ruby_system->curCycle());
+
+        in->dequeue(current_time);
+        out->enqueue(msg_ptr, current_time,
+                     m_switch->cyclesToTicks(m_link_latency));
+
+        m_msg_counts[net_msg_ptr->getMessageSize()][vnet]++;
+        DPRINTF(RubyNetwork, "%s\n", *out);
+    }
+
+    if (m_link_free_time >= current_time + period) {
+        // Out of bandwidth, continue in the cycle in which the link
+        // finishes the last message. New messages schedule a wakeup
+        // of their own, so this is only needed if some are waiting.
+        if (readyVnet(current_time, iteration_direction, blocked) >= 0) {
+            Tick next = current_time +
+                (m_link_free_time - current_time) / period * period;
+            DPRINTF(RubyNetwork, "%s scheduled again at %lld\n", *this,
+                    next);
+            scheduleEventAbsolute(next);
+        }
+    } else if (blocked) {
+        // Waiting for an output buffer to become available
+        DPRINTF(RubyNetwork, "%s scheduled again\n", *this);
+        scheduleEvent(Cycles(1));
+    }
+}
+
 void
 Throttle::regStats(string parent)
 {
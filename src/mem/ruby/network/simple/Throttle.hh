@@ -54,7 +54,7 @@ class Throttle : public Consumer
   public:
     Throttle(int sID, RubySystem *rs, NodeID node, Cycles link_latency,
              int link_bandwidth_multiplier, int endpoint_bandwidth,
-             Switch *em);
+             bool event_driven, Switch *em);
     ~Throttle() {}
 
     std::string name()
@@ -86,6 +86,22 @@ class Throttle : public Consumer
     void operateVnet(int vnet, int &bw_remainin, bool &schedule_wakeup,
                      MessageBuffer *in, MessageBuffer *out);
 
+    /**
+     * Event driven version of wakeup(). Every message is charged the
+     * time it takes to serialize it onto the link, and the throttle is
+     * only woken up again when the link has bandwidth left for the
+     * next message.
+     */
+    void wakeupEventDriven();
+
+    /**
+     * The highest priority vnet with a message that can be sent now,
+     * or -1 if there is none. Sets blocked if a message is held back
+     * because its output buffer is full.
+     */
+    int readyVnet(Tick current_time, bool iteration_direction,
+                  bool &blocked) const;
+
     // Private copy constructor and assignment operator
     Throttle(const Throttle& obj);
     Throttle& operator=(const Throttle& obj);
@@ -105,6 +121,10 @@ class Throttle : public Consumer
     int m_endpoint_bandwidth;
     RubySystem *m_ruby_system;
 
+    const bool m_event_driven;
+    // Time at which the link has serialized the last message it started
+    Tick m_link_free_time;
+
     // Statistical variables
     Stats::Scalar m_link_utilization;
     Stats::Vector m_msg_counts[MessageSizeType_NUM];
@@ -38,6 +38,24 @@ AccessTraceForAddress::~AccessTraceForAddress()
     }
 }
 
+void
+AccessTraceForAddress::reset(Addr addr, uint64_t error)
+{
+    m_addr = addr;
+    m_loads = 0;
+    m_stores = 0;
+    m_atomics = 0;
+    m_total = 0;
+    m_user = 0;
+    m_sharing = 0;
+    m_error = error;
+    m_touched_by.clear();
+    if (m_histogram_ptr) {
+        delete m_histogram_ptr;
+        m_histogram_ptr = NULL;
+    }
+}
+
 void
 AccessTraceForAddress::print(std::ostream& out) const
 {
@@ -52,6 +70,8 @@ AccessTraceForAddress::print(std::ostream& out) const
         out << " " << m_total-m_user;
         out << " | " << m_sharing;
         out << " | " << m_touched_by.count();
+        if (m_error > 0)
+            out << " | +/- " << m_error;
     } else {
         assert(m_total == 0);
         out << " " << (*m_histogram_ptr);
@@ -42,15 +42,25 @@ class AccessTraceForAddress
 {
   public:
     AccessTraceForAddress()
-        : m_loads(0), m_stores(0), m_atomics(0), m_total(0), m_user(0),
-          m_sharing(0), m_histogram_ptr(NULL)
+        : m_addr(0), m_loads(0), m_stores(0), m_atomics(0), m_total(0),
+          m_user(0), m_sharing(0), m_error(0), m_histogram_ptr(NULL)
     { }
     ~AccessTraceForAddress();
 
     void setAddress(Addr addr) { m_addr = addr; }
+
+    /**
+     * Recycle this record for a new address. The error is the count
+     * inherited from the record it replaced, which bounds how far the
+     * reported weight may overestimate the accesses to the new address.
+     */
+    void reset(Addr addr, uint64_t error);
     void update(RubyRequestType type, RubyAccessMode access_mode, NodeID cpu,
                 bool sharing_miss);
     int getTotal() const;
+    uint64_t getError() const { return m_error; }
+    /** Estimated count used to rank records: total plus the error bound */
+    uint64_t getWeight() const { return getTotal() + m_error; }
     int getSharing() const { return m_sharing; }
     int getTouchedBy() const { return m_touched_by.count(); }
     Addr getAddress() const { return m_addr; }
@@ -59,10 +69,10 @@ class AccessTraceForAddress
     void print(std::ostream& out) const;
 
     static inline bool
-    less_equal(const AccessTraceForAddress* n1,
-        const AccessTraceForAddress* n2)
+    heavier(const AccessTraceForAddress* n1,
+            const AccessTraceForAddress* n2)
     {
-        return n1->getTotal() <= n2->getTotal();
+        return n1->getWeight() > n2->getWeight();
     }
 
   private:
@@ -73,6 +83,7 @@ class AccessTraceForAddress
     uint64_t m_total;
     uint64_t m_user;
     uint64_t m_sharing;
+    uint64_t m_error;
     Set m_touched_by;
     Histogram* m_histogram_ptr;
 };
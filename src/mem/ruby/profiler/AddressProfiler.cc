@@ -39,27 +39,126 @@ typedef AddressProfiler::AddressMap AddressMap;
 
 using m5::stl_helpers::operator<<;
 
-// Helper functions
-AccessTraceForAddress&
-lookupTraceForAddress(Addr addr, AddressMap& record_map)
+void
+AddressProfiler::AddressMap::init(unsigned capacity, unsigned sample_rate)
+{
+    assert(capacity > 0);
+    m_sampleRate = sample_rate > 0 ? sample_rate : 1;
+    m_records.clear();
+    m_records.resize(capacity);
+    m_heap.reserve(capacity);
+    m_heapPos.resize(capacity);
+    m_index.reserve(capacity);
+    clear();
+}
+
+void
+AddressProfiler::AddressMap::clear()
+{
+    for (unsigned idx : m_heap)
+        m_records[idx].reset(0, 0);
+    m_heap.clear();
+    m_index.clear();
+    m_offered = 0;
+    m_sampled = 0;
+}
+
+bool
+AddressProfiler::AddressMap::inSample(Addr addr) const
+{
+    if (m_sampleRate == 1)
+        return true;
+
+    // Mix the address bits so that strided addresses are not all
+    // accepted or all rejected together.
+    uint64_t h = addr;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h % m_sampleRate == 0;
+}
+
+AccessTraceForAddress *
+AddressProfiler::AddressMap::lookup(Addr addr)
+{
+    m_offered++;
+    if (!inSample(addr))
+        return NULL;
+    m_sampled++;
+
+    auto it = m_index.find(addr);
+    if (it != m_index.end())
+        return &m_records[it->second];
+
+    unsigned idx;
+    if (m_heap.size() < m_records.size()) {
+        // Still room: take the next free record. Its weight is zero,
+        // so it belongs at the root of the heap.
+        idx = m_heap.size();
+        m_heap.push_back(idx);
+        m_heapPos[idx] = m_heap.size() - 1;
+        for (unsigned pos = m_heap.size() - 1; pos > 0; pos = (pos - 1) / 2) {
+            unsigned parent = (pos - 1) / 2;
+            std::swap(m_heap[pos], m_heap[parent]);
+            m_heapPos[m_heap[pos]] = pos;
+            m_heapPos[m_heap[parent]] = parent;
+        }
+        m_records[idx].reset(addr, 0);
+    } else {
+        // Full: replace the lightest record and keep its weight as
+        // the error bound of the new one.
+        idx = m_heap[0];
+        AccessTraceForAddress &victim = m_records[idx];
+        m_index.erase(victim.getAddress());
+        victim.reset(addr, victim.getWeight());
+    }
+    m_index[addr] = idx;
+    return &m_records[idx];
+}
+
+void
+AddressProfiler::AddressMap::siftDown(unsigned pos)
 {
-    // we create a static default object here that is used to insert
-    // since the insertion will create a copy of the object in the
-    // process.  Perhaps this is optimizing early, but it doesn't seem
-    // like it could hurt.
-    static const AccessTraceForAddress dflt;
-
-    pair<AddressMap::iterator, bool> r =
-        record_map.insert(make_pair(addr, dflt));
-    AddressMap::iterator i = r.first;
-    AccessTraceForAddress &access_trace = i->second;
-    if (r.second) {
-        // there was nothing there and the insert succeed, so we need
-        // to actually set the address.
-        access_trace.setAddress(addr);
+    const unsigned n = m_heap.size();
+    while (true) {
+        unsigned smallest = pos;
+        for (unsigned child = 2 * pos + 1; child <= 2 * pos + 2; ++child) {
+            if (child < n && m_records[m_heap[child]].getWeight() <
+                m_records[m_heap[smallest]].getWeight()) {
+                smallest = child;
+            }
+        }
+        if (smallest == pos)
+            return;
+        std::swap(m_heap[pos], m_heap[smallest]);
+        m_heapPos[m_heap[pos]] = pos;
+        m_heapPos[m_heap[smallest]] = smallest;
+        pos = smallest;
     }
+}
 
-    return access_trace;
+void
+AddressProfiler::AddressMap::update(Addr addr, RubyRequestType type,
+                                    RubyAccessMode access_mode, NodeID cpu,
+                                    bool sharing_miss)
+{
+    AccessTraceForAddress *record = lookup(addr);
+    if (record) {
+        record->update(type, access_mode, cpu, sharing_miss);
+        siftDown(m_heapPos[record - &m_records[0]]);
+    }
+}
+
+void
+AddressProfiler::AddressMap::addSample(Addr addr, int value)
+{
+    AccessTraceForAddress *record = lookup(addr);
+    if (record) {
+        record->addSample(value);
+        siftDown(m_heapPos[record - &m_records[0]]);
+    }
 }
 
 void
@@ -68,24 +167,30 @@ printSorted(ostream& out, int num_of_sequencers, const AddressMap &record_map,
 {
     const int records_printed = 100;
 
-    uint64_t misses = 0;
     std::vector<const AccessTraceForAddress *> sorted;
 
     AddressMap::const_iterator i = record_map.begin();
     AddressMap::const_iterator end = record_map.end();
     for (; i != end; ++i) {
-        const AccessTraceForAddress* record = &i->second;
-        misses += record->getTotal();
+        const AccessTraceForAddress* record = &*i;
         sorted.push_back(record);
     }
-    sort(sorted.begin(), sorted.end(), AccessTraceForAddress::less_equal);
+    sort(sorted.begin(), sorted.end(), AccessTraceForAddress::heavier);
 
     out << "Total_entries_" << description << ": " << record_map.size()
         << endl;
-    if (profiler->getAllInstructions())
-        out << "Total_Instructions_" << description << ": " << misses << endl;
-    else
-        out << "Total_data_misses_" << description << ": " << misses << endl;
+    if (profiler->getAllInstructions()) {
+        out << "Total_Instructions_" << description << ": "
+            << record_map.offered() << endl;
+    } else {
+        out << "Total_data_misses_" << description << ": "
+            << record_map.offered() << endl;
+    }
+    if (record_map.sampleRate() > 1) {
+        out << "Sampled_" << description << ": " << record_map.sampled()
+            << " (1 in " << record_map.sampleRate() << " addresses)"
+            << endl;
+    }
 
     out << "total | load store atomic | user supervisor | sharing | touched-by"
         << endl;
@@ -109,7 +214,8 @@ printSorted(ostream& out, int num_of_sequencers, const AddressMap &record_map,
     int max = sorted.size();
     while (counter < max && counter < records_printed) {
         const AccessTraceForAddress* record = sorted[counter];
-        double percent = 100.0 * (record->getTotal() / double(misses));
+        double percent =
+            100.0 * (record->getTotal() / double(record_map.sampled()));
         out << description << " | " << percent << " % " << *record << endl;
         all_records.add(record->getTotal());
         all_records_log.add(record->getTotal());
@@ -124,6 +230,7 @@ printSorted(ostream& out, int num_of_sequencers, const AddressMap &record_map,
         remaining_records.add(record->getTotal());
         all_records_log.add(record->getTotal());
         remaining_records_log.add(record->getTotal());
+        counter++;
         m_touched_vec[record->getTouchedBy()]++;
         m_touched_weighted_vec[record->getTouchedBy()] += record->getTotal();
     }
@@ -143,10 +250,15 @@ printSorted(ostream& out, int num_of_sequencers, const AddressMap &record_map,
         << endl;
 }
 
-AddressProfiler::AddressProfiler(int num_of_sequencers, Profiler *profiler)
+AddressProfiler::AddressProfiler(int num_of_sequencers, Profiler *profiler,
+                                 unsigned max_entries, unsigned sample_rate)
     : m_profiler(profiler)
 {
     m_num_of_sequencers = num_of_sequencers;
+    m_dataAccessTrace.init(max_entries, sample_rate);
+    m_macroBlockAccessTrace.init(max_entries, sample_rate);
+    m_programCounterAccessTrace.init(max_entries, sample_rate);
+    m_retryProfileMap.init(max_entries, sample_rate);
     clearStats();
 }
 
@@ -285,34 +397,34 @@ AddressProfiler::addTraceSample(Addr data_addr, Addr pc_addr,
                                 RubyAccessMode access_mode, NodeID id,
                                 bool sharing_miss)
 {
-    if (m_all_instructions) {
+    if (m_hot_lines) {
         if (sharing_miss) {
             m_sharing_miss_counter++;
         }
 
         // record data address trace info
         data_addr = makeLineAddress(data_addr);
-        lookupTraceForAddress(data_addr, m_dataAccessTrace).
-            update(type, access_mode, id, sharing_miss);
+        m_dataAccessTrace.update(data_addr, type, access_mode, id,
+                                 sharing_miss);
 
         // record macro data address trace info
 
         // 6 for datablock, 4 to make it 16x more coarse
         Addr macro_addr = maskLowOrderBits(data_addr, 10);
-        lookupTraceForAddress(macro_addr, m_macroBlockAccessTrace).
-            update(type, access_mode, id, sharing_miss);
+        m_macroBlockAccessTrace.update(macro_addr, type, access_mode, id,
+                                       sharing_miss);
 
         // record program counter address trace info
-        lookupTraceForAddress(pc_addr, m_programCounterAccessTrace).
-            update(type, access_mode, id, sharing_miss);
+        m_programCounterAccessTrace.update(pc_addr, type, access_mode, id,
+                                           sharing_miss);
     }
 
     if (m_all_instructions) {
         // This code is used if the address profiler is an
         // all-instructions profiler record program counter address
         // trace info
-        lookupTraceForAddress(pc_addr, m_programCounterAccessTrace).
-            update(type, access_mode, id, sharing_miss);
+        m_programCounterAccessTrace.update(pc_addr, type, access_mode, id,
+                                           sharing_miss);
     }
 }
 
@@ -326,6 +438,6 @@ AddressProfiler::profileRetry(Addr data_addr, AccessType type, int count)
         m_retryProfileHistoWrite.add(count);
     }
     if (count > 1) {
-        lookupTraceForAddress(data_addr, m_retryProfileMap).addSample(count);
+        m_retryProfileMap.addSample(data_addr, count);
     }
 }
@@ -31,6 +31,7 @@
 
 #include <iostream>
 #include <unordered_map>
+#include <vector>
 
 #include "mem/protocol/AccessType.hh"
 #include "mem/protocol/RubyRequest.hh"
@@ -44,10 +45,66 @@ class Set;
 class AddressProfiler
 {
   public:
-    typedef std::unordered_map<Addr, AccessTraceForAddress> AddressMap;
+    /**
+     * A bounded table of access records, kept as a Space-Saving
+     * heavy-hitter sketch. Each address is first filtered by a hash
+     * so that only about one in sample_rate addresses is tracked at
+     * all; a tracked address either updates its record or, once the
+     * table is full, takes over the record with the smallest weight
+     * and inherits that weight as its error bound. The records are
+     * kept in a min-heap on weight, so both cases cost O(log K) and
+     * the memory used never grows past the capacity given to init().
+     */
+    class AddressMap
+    {
+      public:
+        typedef std::vector<AccessTraceForAddress>::const_iterator
+            const_iterator;
+
+        AddressMap() : m_sampleRate(1), m_offered(0), m_sampled(0) {}
+
+        void init(unsigned capacity, unsigned sample_rate);
+        void clear();
+
+        /** Record an access to addr if it falls in the sample */
+        void update(Addr addr, RubyRequestType type,
+                    RubyAccessMode access_mode, NodeID cpu,
+                    bool sharing_miss);
+        /** Record a histogram sample for addr if it falls in the sample */
+        void addSample(Addr addr, int value);
+
+        const_iterator begin() const { return m_records.begin(); }
+        const_iterator end() const
+        { return m_records.begin() + m_heap.size(); }
+        size_t size() const { return m_heap.size(); }
+
+        unsigned sampleRate() const { return m_sampleRate; }
+        /** Number of accesses seen, whether or not they were sampled */
+        uint64_t offered() const { return m_offered; }
+        /** Number of accesses that fell in the sample */
+        uint64_t sampled() const { return m_sampled; }
+
+      private:
+        bool inSample(Addr addr) const;
+        AccessTraceForAddress *lookup(Addr addr);
+        void siftDown(unsigned pos);
+
+        unsigned m_sampleRate;
+        uint64_t m_offered;
+        uint64_t m_sampled;
+
+        /** Record storage, allocated once in init() */
+        std::vector<AccessTraceForAddress> m_records;
+        /** Record indices ordered as a min-heap on weight */
+        std::vector<unsigned> m_heap;
+        /** Position of each record in m_heap */
+        std::vector<unsigned> m_heapPos;
+        std::unordered_map<Addr, unsigned> m_index;
+    };
 
   public:
-    AddressProfiler(int num_of_sequencers, Profiler *profiler);
+    AddressProfiler(int num_of_sequencers, Profiler *profiler,
+                    unsigned max_entries, unsigned sample_rate);
     ~AddressProfiler();
 
     void printStats(std::ostream& out) const;
@@ -96,10 +153,6 @@ class AddressProfiler
     int m_num_of_sequencers;
 };
 
-AccessTraceForAddress& lookupTraceForAddress(Addr addr,
-                                             AddressProfiler::AddressMap&
-                                             record_map);
-
 void printSorted(std::ostream& out, int num_of_sequencers,
                  const AddressProfiler::AddressMap &record_map,
                  std::string description, Profiler *profiler);
@@ -36,6 +36,7 @@
 #include <iostream>
 
 #include "base/logging.hh"
+#include "base/pool_alloc.hh"
 #include "mem/protocol/AccessPermission.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/slicc_interface/AbstractEntry.hh"
@@ -45,6 +46,21 @@ class DataBlock;
 class AbstractCacheEntry : public AbstractEntry
 {
   public:
+    /**
+     * Cache and directory entries are allocated by the generated
+     * protocol code whenever a line is filled, so all entry types
+     * share a pool (sized per entry type by the allocator).
+     */
+    typedef PoolAllocator<AbstractCacheEntry> Pool;
+
+    static void *operator new(size_t size) { return Pool::allocate(size); }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        Pool::deallocate(p, size);
+    }
+
     AbstractCacheEntry();
     virtual ~AbstractCacheEntry() = 0;
 
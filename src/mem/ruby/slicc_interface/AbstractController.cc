@@ -40,6 +40,8 @@
 
 #include "mem/ruby/slicc_interface/AbstractController.hh"
 
+#include <algorithm>
+
 #include "debug/RubyQueue.hh"
 #include "mem/protocol/MemoryMsg.hh"
 #include "mem/ruby/network/Network.hh"
@@ -52,9 +54,11 @@ AbstractController::AbstractController(const Params *p)
     : MemObject(p), Consumer(this), m_version(p->version),
       m_clusterID(p->cluster_id),
       m_masterId(p->system->getMasterId(name())), m_is_blocking(false),
+      m_index_lines(false),
       m_number_of_TBEs(p->number_of_TBEs),
       m_transitions_per_cycle(p->transitions_per_cycle),
       m_buffer_size(p->buffer_size), m_recycle_latency(p->recycle_latency),
+      m_profile_transitions(p->profile_transitions),
       memoryPort(csprintf("%s.memory", name()), this, ""),
       addrRanges(p->addr_ranges.begin(), p->addr_ranges.end())
 {
@@ -68,6 +72,7 @@ AbstractController::AbstractController(const Params *p)
 void
 AbstractController::init()
 {
+    m_index_lines = params()->functional_line_index && canIndexLines();
     params()->ruby_system->registerAbstractController(this);
     m_delayHistogram.init(10);
     uint32_t size = Network::getNumberOfVirtualNetworks();
@@ -106,60 +111,81 @@ AbstractController::profileMsgDelay(uint32_t virtualNetwork, Cycles delay)
     m_delayVCHistogram[virtualNetwork]->sample(delay);
 }
 
+void
+AbstractController::updateLineIndex(Addr addr)
+{
+    if (m_index_lines)
+        params()->ruby_system->updateLineHolder(this, addr);
+}
+
+bool
+AbstractController::installLine(Addr addr, RubyRequestType type,
+                                const MachineID &requestor,
+                                const DataBlock &data)
+{
+    bool installed = warmupLine(addr, type, requestor, data);
+    updateLineIndex(addr);
+    return installed;
+}
+
 void
 AbstractController::stallBuffer(MessageBuffer* buf, Addr addr)
 {
-    if (m_waiting_buffers.count(addr) == 0) {
-        MsgVecType* msgVec = new MsgVecType;
-        msgVec->resize(m_in_ports, NULL);
-        m_waiting_buffers[addr] = msgVec;
+    auto it = m_waiting_buffers.find(addr);
+    if (it == m_waiting_buffers.end()) {
+        unsigned idx;
+        if (m_free_waiting_vecs.empty()) {
+            idx = m_waiting_vecs.size();
+            m_waiting_vecs.emplace_back();
+        } else {
+            idx = m_free_waiting_vecs.back();
+            m_free_waiting_vecs.pop_back();
+        }
+        m_waiting_vecs[idx].assign(m_in_ports, NULL);
+        it = m_waiting_buffers.emplace(addr, idx).first;
     }
     DPRINTF(RubyQueue, "stalling %s port %d addr %#x\n", buf, m_cur_in_port,
             addr);
     assert(m_in_ports > m_cur_in_port);
-    (*(m_waiting_buffers[addr]))[m_cur_in_port] = buf;
+    m_waiting_vecs[it->second][m_cur_in_port] = buf;
 }
 
 void
-AbstractController::wakeUpBuffers(Addr addr)
+AbstractController::wakeUpBuffers(Addr addr, int top_rank)
 {
-    if (m_waiting_buffers.count(addr) > 0) {
-        //
-        // Wake up all possible lower rank (i.e. lower priority) buffers that could
-        // be waiting on this message.
-        //
-        for (int in_port_rank = m_cur_in_port - 1;
+    auto it = m_waiting_buffers.find(addr);
+    if (it != m_waiting_buffers.end()) {
+        const MsgVecType &msgVec = m_waiting_vecs[it->second];
+        for (int in_port_rank = top_rank;
              in_port_rank >= 0;
              in_port_rank--) {
-            if ((*(m_waiting_buffers[addr]))[in_port_rank] != NULL) {
-                (*(m_waiting_buffers[addr]))[in_port_rank]->
-                    reanalyzeMessages(addr, clockEdge());
+            if (msgVec[in_port_rank] != NULL) {
+                msgVec[in_port_rank]->reanalyzeMessages(addr, clockEdge());
             }
         }
-        delete m_waiting_buffers[addr];
-        m_waiting_buffers.erase(addr);
+        m_free_waiting_vecs.push_back(it->second);
+        m_waiting_buffers.erase(it);
     }
 }
 
+void
+AbstractController::wakeUpBuffers(Addr addr)
+{
+    //
+    // Wake up all possible lower rank (i.e. lower priority) buffers that could
+    // be waiting on this message.
+    //
+    wakeUpBuffers(addr, m_cur_in_port - 1);
+}
+
 void
 AbstractController::wakeUpAllBuffers(Addr addr)
 {
-    if (m_waiting_buffers.count(addr) > 0) {
-        //
-        // Wake up all possible lower rank (i.e. lower priority) buffers that could
-        // be waiting on this message.
-        //
-        for (int in_port_rank = m_in_ports - 1;
-             in_port_rank >= 0;
-             in_port_rank--) {
-            if ((*(m_waiting_buffers[addr]))[in_port_rank] != NULL) {
-                (*(m_waiting_buffers[addr]))[in_port_rank]->
-                    reanalyzeMessages(addr, clockEdge());
-            }
-        }
-        delete m_waiting_buffers[addr];
-        m_waiting_buffers.erase(addr);
-    }
+    //
+    // Wake up all possible lower rank (i.e. lower priority) buffers that could
+    // be waiting on this message.
+    //
+    wakeUpBuffers(addr, m_in_ports - 1);
 }
 
 void
@@ -169,36 +195,34 @@ AbstractController::wakeUpAllBuffers()
     // Wake up all possible buffers that could be waiting on any message.
     //
 
-    std::vector<MsgVecType*> wokeUpMsgVecs;
-    MsgBufType wokeUpMsgBufs;
+    if (m_waiting_buffers.empty())
+        return;
 
-    if (m_waiting_buffers.size() > 0) {
-        for (WaitingBufType::iterator buf_iter = m_waiting_buffers.begin();
-             buf_iter != m_waiting_buffers.end();
-             ++buf_iter) {
-             for (MsgVecType::iterator vec_iter = buf_iter->second->begin();
-                  vec_iter != buf_iter->second->end();
-                  ++vec_iter) {
-                  //
-                  // Make sure the MessageBuffer has not already be reanalyzed
-                  //
-                  if (*vec_iter != NULL &&
-                      (wokeUpMsgBufs.count(*vec_iter) == 0)) {
-                      (*vec_iter)->reanalyzeAllMessages(clockEdge());
-                      wokeUpMsgBufs.insert(*vec_iter);
-                  }
-             }
-             wokeUpMsgVecs.push_back(buf_iter->second);
-        }
+    // Visit the lines in address order to keep the order in which the
+    // buffers are reanalyzed deterministic.
+    std::vector<Addr> lines;
+    lines.reserve(m_waiting_buffers.size());
+    for (auto &waiting : m_waiting_buffers)
+        lines.push_back(waiting.first);
+    std::sort(lines.begin(), lines.end());
 
-        for (std::vector<MsgVecType*>::iterator wb_iter = wokeUpMsgVecs.begin();
-             wb_iter != wokeUpMsgVecs.end();
-             ++wb_iter) {
-             delete (*wb_iter);
+    MsgBufType wokeUpMsgBufs;
+    for (auto addr : lines) {
+        for (auto buf : m_waiting_vecs[m_waiting_buffers[addr]]) {
+            //
+            // Make sure the MessageBuffer has not already be reanalyzed
+            //
+            if (buf != NULL && (wokeUpMsgBufs.count(buf) == 0)) {
+                buf->reanalyzeAllMessages(clockEdge());
+                wokeUpMsgBufs.insert(buf);
+            }
         }
-
-        m_waiting_buffers.clear();
     }
+
+    m_waiting_buffers.clear();
+    m_free_waiting_vecs.clear();
+    for (unsigned idx = 0; idx < m_waiting_vecs.size(); ++idx)
+        m_free_waiting_vecs.push_back(idx);
 }
 
 void
@@ -333,7 +357,7 @@ AbstractController::recvTimingResp(PacketPtr pkt)
     assert(getMemoryQueue());
     assert(pkt->isResponse());
 
-    std::shared_ptr<MemoryMsg> msg = std::make_shared<MemoryMsg>(clockEdge());
+    RefCountingPtr<MemoryMsg> msg = new MemoryMsg(clockEdge());
     (*msg).m_addr = pkt->getAddr();
     (*msg).m_Sender = m_machineID;
 
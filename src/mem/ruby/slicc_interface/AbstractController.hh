@@ -44,6 +44,7 @@
 #include <exception>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 
 #include "base/addr_range.hh"
 #include "base/callback.hh"
@@ -112,6 +113,25 @@ class AbstractController : public MemObject, public Consumer
     virtual int functionalWrite(const Addr &addr, PacketPtr) = 0;
     int functionalMemoryWrite(PacketPtr);
 
+    //! True if the permissions of a line only change in transitions on
+    //! that line, which lets the ruby system keep track of the
+    //! controllers that hold each line.
+    virtual bool canIndexLines() const { return false; }
+    bool indexesLines() const { return m_index_lines; }
+
+    //! These functions are used to restore a cache trace by installing
+    //! lines in their stable states instead of replaying the trace. A
+    //! line is first installed in the controller that recorded it. If
+    //! that succeeds, all other controllers update their state (e.g.,
+    //! directory owners) to match.
+    virtual bool canWarmupLines() const { return false; }
+    virtual bool warmupLine(const Addr &addr, const RubyRequestType &type,
+                            const MachineID &requestor,
+                            const DataBlock &data)
+    { panic("warmupLine() not implemented!"); }
+    bool installLine(Addr addr, RubyRequestType type,
+                     const MachineID &requestor, const DataBlock &data);
+
     //! Function for enqueuing a prefetch request
     virtual void enqueuePrefetch(const Addr &, const RubyRequestType&)
     { fatal("Prefetches not implemented!");}
@@ -172,6 +192,9 @@ class AbstractController : public MemObject, public Consumer
     void wakeUpAllBuffers(Addr addr);
     void wakeUpAllBuffers();
 
+    //! Update the line index of the ruby system after a transition
+    void updateLineIndex(Addr addr);
+
   protected:
     const NodeID m_version;
     MachineID m_machineID;
@@ -182,12 +205,24 @@ class AbstractController : public MemObject, public Consumer
 
     Network *m_net_ptr;
     bool m_is_blocking;
+    bool m_index_lines;
     std::map<Addr, MessageBuffer*> m_block_map;
 
     typedef std::vector<MessageBuffer*> MsgVecType;
     typedef std::set<MessageBuffer*> MsgBufType;
-    typedef std::map<Addr, MsgVecType* > WaitingBufType;
+
+    /**
+     * The buffers stalled on each line, by in_port rank. The map holds
+     * the index of the vector in m_waiting_vecs. Vectors are recycled
+     * through m_free_waiting_vecs rather than allocated per line.
+     */
+    typedef std::unordered_map<Addr, unsigned> WaitingBufType;
     WaitingBufType m_waiting_buffers;
+    std::vector<MsgVecType> m_waiting_vecs;
+    std::vector<unsigned> m_free_waiting_vecs;
+
+    /** Wake up the buffers stalled on a line, from the given rank down */
+    void wakeUpBuffers(Addr addr, int top_rank);
 
     unsigned int m_in_ports;
     unsigned int m_cur_in_port;
@@ -196,6 +231,9 @@ class AbstractController : public MemObject, public Consumer
     const unsigned int m_buffer_size;
     Cycles m_recycle_latency;
 
+    //! Measure the host time spent in each transition
+    const bool m_profile_transitions;
+
     //! Counter for the number of cycles when the transitions carried out
     //! were equal to the maximum allowed
     Stats::Scalar m_fully_busy_cycles;
@@ -60,6 +60,10 @@ class RubyController(MemObject):
     recycle_latency = Param.Cycles(10, "")
     number_of_TBEs = Param.Int(256, "")
     ruby_system = Param.RubySystem("")
+    functional_line_index = Param.Bool(True, "Only search this controller "
+        "for functional accesses to the lines it holds")
+    profile_transitions = Param.Bool(False, "Record the host time spent "
+        "in each transition")
 
     memory = MasterPort("Port for attaching a memory controller")
     system = Param.System(Parent.any, "system object parameter")
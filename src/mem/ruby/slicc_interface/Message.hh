@@ -30,19 +30,38 @@
 #define __MEM_RUBY_SLICC_INTERFACE_MESSAGE_HH__
 
 #include <iostream>
-#include <memory>
 #include <stack>
 
+#include "base/pool_alloc.hh"
+#include "base/refcnt.hh"
 #include "mem/packet.hh"
 #include "mem/protocol/MessageSizeType.hh"
 #include "mem/ruby/common/NetDest.hh"
 
 class Message;
-typedef std::shared_ptr<Message> MsgPtr;
+typedef RefCountingPtr<Message> MsgPtr;
 
-class Message
+/**
+ * Base class of all messages exchanged by Ruby controllers.
+ *
+ * Messages are reference counted through MsgPtr. Ruby runs on a single
+ * thread, so the count is a plain integer kept in the message itself.
+ * Messages are allocated from a free-list pool; SLICC gives every
+ * message type a pool of its own.
+ */
+class Message : public RefCounted
 {
   public:
+    typedef PoolAllocator<Message> Pool;
+
+    static void *operator new(size_t size) { return Pool::allocate(size); }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        Pool::deallocate(p, size);
+    }
+
     Message(Tick curTime)
         : m_time(curTime),
           m_LastEnqueueTime(curTime),
@@ -50,7 +69,7 @@ class Message
     { }
 
     Message(const Message &other)
-        : m_time(other.m_time),
+        : RefCounted(), m_time(other.m_time),
           m_LastEnqueueTime(other.m_LastEnqueueTime),
           m_DelayedTicks(other.m_DelayedTicks),
           m_msg_counter(other.m_msg_counter)
@@ -76,6 +95,32 @@ class Message
     virtual bool functionalRead(Packet *pkt) = 0;
     virtual bool functionalWrite(Packet *pkt) = 0;
 
+    /** The addresses a functional write can match in a message. */
+    enum FunctionalScope {
+        FunctionalAny,  //!< Any address, the message must be checked
+        FunctionalLine, //!< Only addresses in a single line
+        FunctionalNone  //!< The message is never written functionally
+    };
+
+    /**
+     * Determine which functional writes can match this message, which
+     * lets message buffers skip the messages of other lines.
+     *
+     * @param line Set to the line address for FunctionalLine
+     * @return The scope of the functional writes matching the message
+     */
+    virtual FunctionalScope functionalScope(Addr &line) const
+    { return FunctionalAny; }
+
+    /**
+     * The line the message is about, which relates the messages of a
+     * transaction to each other when tracing the network.
+     *
+     * @param line Set to the line address if the message has one
+     * @return Whether the message carries an address
+     */
+    virtual bool getLineAddr(Addr &line) const { return false; }
+
     //! Update the delay this message has experienced so far.
     void updateDelayedTicks(Tick curTime)
     {
@@ -31,7 +31,6 @@
 #define __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "base/statistics.hh"
@@ -160,6 +159,19 @@ class CacheMemory : public SimObject
     int findTagInSet(int64_t line, Addr tag) const;
     int findTagInSetIgnorePermissions(int64_t cacheSet, Addr tag) const;
 
+    // The entry in the given set and way
+    AbstractCacheEntry *&
+    entryAt(int64_t cacheSet, int way)
+    {
+        return m_cache[cacheSet * m_cache_assoc + way];
+    }
+
+    AbstractCacheEntry *
+    entryAt(int64_t cacheSet, int way) const
+    {
+        return m_cache[cacheSet * m_cache_assoc + way];
+    }
+
     // Private copy constructor and assignment operator
     CacheMemory(const CacheMemory& obj);
     CacheMemory& operator=(const CacheMemory& obj);
@@ -168,10 +180,12 @@ class CacheMemory : public SimObject
     // Data Members (m_prefix)
     bool m_is_instruction_only_cache;
 
-    // The first index is the # of cache lines.
-    // The second index is the the amount associativity.
-    std::unordered_map<Addr, int> m_tag_index;
-    std::vector<std::vector<AbstractCacheEntry*> > m_cache;
+    // Entries and line addresses, both stored set by set with
+    // m_cache_assoc ways per set. The tags of a set are contiguous so
+    // that lookups only scan a few adjacent words; ways without an
+    // allocated entry hold MaxAddr, which is never a line address.
+    std::vector<Addr> m_tags;
+    std::vector<AbstractCacheEntry*> m_cache;
 
     AbstractReplacementPolicy *m_replacementPolicy_ptr;
 
@@ -68,20 +68,18 @@ void
 DirectoryMemory::init()
 {
     m_num_entries = m_size_bytes / RubySystem::getBlockSizeBytes();
-    m_entries = new AbstractEntry*[m_num_entries];
-    for (int i = 0; i < m_num_entries; i++)
-        m_entries[i] = NULL;
+    m_pages.resize(divCeil(m_num_entries, pageEntries));
 }
 
 DirectoryMemory::~DirectoryMemory()
 {
     // free up all the directory entries
-    for (uint64_t i = 0; i < m_num_entries; i++) {
-        if (m_entries[i] != NULL) {
-            delete m_entries[i];
-        }
+    for (auto &page : m_pages) {
+        if (!page)
+            continue;
+        for (uint64_t i = 0; i < pageEntries; i++)
+            delete page[i];
     }
-    delete [] m_entries;
 }
 
 bool
@@ -117,7 +115,8 @@ DirectoryMemory::lookup(Addr address)
 
     uint64_t idx = mapAddressToLocalIdx(address);
     assert(idx < m_num_entries);
-    return m_entries[idx];
+    const Page &page = m_pages[idx >> pageBits];
+    return page ? page[idx & (pageEntries - 1)] : NULL;
 }
 
 AbstractEntry*
@@ -129,8 +128,13 @@ DirectoryMemory::allocate(Addr address, AbstractEntry *entry)
 
     idx = mapAddressToLocalIdx(address);
     assert(idx < m_num_entries);
+    Page &page = m_pages[idx >> pageBits];
+    if (!page) {
+        // value-initialise the page to start with no entries
+        page.reset(new AbstractEntry*[pageEntries]());
+    }
     entry->changePermission(AccessPermission_Read_Only);
-    m_entries[idx] = entry;
+    page[idx & (pageEntries - 1)] = entry;
 
     return entry;
 }
@@ -42,7 +42,9 @@
 #define __MEM_RUBY_STRUCTURES_DIRECTORYMEMORY_HH__
 
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "base/addr_range.hh"
 #include "mem/protocol/DirectoryRequestType.hh"
@@ -88,8 +90,17 @@ class DirectoryMemory : public SimObject
     DirectoryMemory& operator=(const DirectoryMemory& obj);
 
   private:
+    /**
+     * The entries are kept in pages of 2^pageBits entries, which are
+     * only allocated once an entry in them is. Large memories thus do
+     * not need a pointer per block up front, only one per page.
+     */
+    static const unsigned pageBits = 12;
+    static const uint64_t pageEntries = ULL(1) << pageBits;
+    typedef std::unique_ptr<AbstractEntry*[]> Page;
+
     const std::string m_name;
-    AbstractEntry **m_entries;
+    std::vector<Page> m_pages;
     // int m_size;  // # of memory module blocks this directory is
                     // responsible for
     uint64_t m_size_bytes;
@@ -28,6 +28,8 @@
 
 #include "mem/ruby/structures/Prefetcher.hh"
 
+#include <algorithm>
+
 #include "debug/RubyPrefetcher.hh"
 #include "mem/ruby/slicc_interface/RubySlicc_ComponentMapping.hh"
 #include "mem/ruby/system/RubySystem.hh"
@@ -40,48 +42,32 @@ PrefetcherParams::create()
 
 Prefetcher::Prefetcher(const Params *p)
     : SimObject(p), m_num_streams(p->num_streams),
+    m_stream_assoc(p->stream_assoc ? p->stream_assoc : p->num_streams),
+    m_stream_sets(p->num_streams / m_stream_assoc),
+    m_degree(p->pf_per_stream),
+    m_stream_window(std::max(p->num_startup_pfs, p->pf_per_stream)),
     m_array(p->num_streams), m_train_misses(p->train_misses),
     m_num_startup_pfs(p->num_startup_pfs), m_num_unit_filters(p->unit_filter),
     m_num_nonunit_filters(p->nonunit_filter),
-    m_unit_filter(p->unit_filter, 0),
-    m_negative_filter(p->unit_filter, 0),
+    m_unit_filter(p->unit_filter),
+    m_negative_filter(p->unit_filter),
     m_nonunit_filter(p->nonunit_filter, 0),
+    m_nonunit_stride(p->nonunit_filter, 0),
+    m_nonunit_hit(p->nonunit_filter, 0),
+    m_nonunit_index(0),
     m_prefetch_cross_pages(p->cross_page),
     m_page_shift(p->sys->getPageShift())
 {
     assert(m_num_streams > 0);
     assert(m_num_startup_pfs <= MAX_PF_INFLIGHT);
-
-    // create +1 stride filter
-    m_unit_filter_index = 0;
-    m_unit_filter_hit = new uint32_t[m_num_unit_filters];
-    for (uint32_t i =0; i < m_num_unit_filters; i++) {
-        m_unit_filter_hit[i] = 0;
-    }
-
-    // create -1 stride filter
-    m_negative_filter_index = 0;
-    m_negative_filter_hit = new uint32_t[m_num_unit_filters];
-    for (int i =0; i < m_num_unit_filters; i++) {
-        m_negative_filter_hit[i] = 0;
-    }
-
-    // create nonunit stride filter
-    m_nonunit_index = 0;
-    m_nonunit_stride = new int[m_num_nonunit_filters];
-    m_nonunit_hit    = new uint32_t[m_num_nonunit_filters];
-    for (int i =0; i < m_num_nonunit_filters; i++) {
-        m_nonunit_stride[i] = 0;
-        m_nonunit_hit[i]    = 0;
-    }
+    assert(m_degree > 0 && m_degree <= MAX_PF_INFLIGHT);
+    fatal_if(m_num_streams % m_stream_assoc != 0,
+             "%s: num_streams (%d) must be a multiple of stream_assoc (%d)\n",
+             name(), m_num_streams, m_stream_assoc);
 }
 
 Prefetcher::~Prefetcher()
 {
-    delete m_unit_filter_hit;
-    delete m_negative_filter_hit;
-    delete m_nonunit_stride;
-    delete m_nonunit_hit;
 }
 
 void
@@ -129,6 +115,11 @@ Prefetcher::regStats()
         .desc("number of prefetches across pages")
         ;
 
+    numResumedStreams
+        .name(name() + ".resumed_streams")
+        .desc("number of streams resumed after stopping at a page boundary")
+        ;
+
     numMissedPrefetchedBlocks
         .name(name() + ".misses_on_prefetched_blocks")
         .desc("number of misses for blocks that were prefetched, yet missed")
@@ -146,6 +137,22 @@ Prefetcher::observeMiss(Addr address, const RubyRequestType& type)
     uint32_t index = 0;
     PrefetchEntry *pfEntry = getPrefetchEntry(line_addr, index);
     if (pfEntry != NULL) {
+        if (pfEntry->m_parked && line_addr ==
+            makeNextStrideAddress(pfEntry->m_address, pfEntry->m_stride)) {
+            // The demand stream crossed the page boundary this stream
+            // stopped at, so continue prefetching in the new page.
+            DPRINTF(RubyPrefetcher, "  *** resuming stream at %#x\n",
+                    line_addr);
+            numResumedStreams++;
+            uint32_t stream_index = pfEntry - m_array.data();
+            unmapStream(stream_index);
+            pfEntry->m_parked = false;
+            pfEntry->m_address = line_addr;
+            mapStream(stream_index);
+            issueNextPrefetch(line_addr, pfEntry);
+            return;
+        }
+
         if (pfEntry->requestIssued[index]) {
             if (pfEntry->requestCompleted[index]) {
                 // We prefetched too early and now the prefetch block no
@@ -168,22 +175,20 @@ Prefetcher::observeMiss(Addr address, const RubyRequestType& type)
 
     // check to see if this address is in the unit stride filter
     bool alloc = false;
-    bool hit = accessUnitFilter(m_unit_filter, m_unit_filter_hit,
-                                m_unit_filter_index, line_addr, 1, alloc);
+    bool hit = accessUnitFilter(m_unit_filter, line_addr, 1, alloc);
     if (alloc) {
         // allocate a new prefetch stream
-        initializeStream(line_addr, 1, getLRUindex(), type);
+        initializeStream(line_addr, 1, getLRUindex(line_addr), type);
     }
     if (hit) {
         DPRINTF(RubyPrefetcher, "  *** hit in unit stride buffer\n");
         return;
     }
 
-    hit = accessUnitFilter(m_negative_filter, m_negative_filter_hit,
-        m_negative_filter_index, line_addr, -1, alloc);
+    hit = accessUnitFilter(m_negative_filter, line_addr, -1, alloc);
     if (alloc) {
         // allocate a new prefetch stream
-        initializeStream(line_addr, -1, getLRUindex(), type);
+        initializeStream(line_addr, -1, getLRUindex(line_addr), type);
     }
     if (hit) {
         DPRINTF(RubyPrefetcher, "  *** hit in unit negative unit buffer\n");
@@ -195,7 +200,7 @@ Prefetcher::observeMiss(Addr address, const RubyRequestType& type)
     hit = accessNonunitFilter(address, &stride, alloc);
     if (alloc) {
         assert(stride != 0);  // ensure non-zero stride prefetches
-        initializeStream(line_addr, stride, getLRUindex(), type);
+        initializeStream(line_addr, stride, getLRUindex(line_addr), type);
     }
     if (hit) {
         DPRINTF(RubyPrefetcher, "  *** hit in non-unit stride buffer\n");
@@ -234,36 +239,49 @@ Prefetcher::issueNextPrefetch(Addr address, PrefetchEntry *stream)
         return;
     }
 
-    // extend this prefetching stream by 1 (or more)
-    Addr page_addr = pageAddress(stream->m_address);
-    Addr line_addr = makeNextStrideAddress(stream->m_address,
-                                         stream->m_stride);
-
-    // possibly stop prefetching at page boundaries
-    if (page_addr != pageAddress(line_addr)) {
-        numPagesCrossed++;
-        if (!m_prefetch_cross_pages) {
-            // Deallocate the stream since we are not prefetching
-            // across page boundries
-            stream->m_is_valid = false;
-            return;
-        }
+    // a parked stream waits for the demand stream to cross the page
+    if (stream->m_parked) {
+        DPRINTF(RubyPrefetcher, "Stream parked at page boundary\n");
+        return;
     }
 
-    // launch next prefetch
-    stream->m_address = line_addr;
-    stream->m_use_time = m_controller->curCycle();
-    DPRINTF(RubyPrefetcher, "Requesting prefetch for %#x\n", line_addr);
-    m_controller->enqueuePrefetch(line_addr, stream->m_type);
+    // extend this prefetching stream by m_degree lines
+    uint32_t index = stream - m_array.data();
+    unmapStream(index);
+    for (int k = 0; k < m_degree; k++) {
+        Addr page_addr = pageAddress(stream->m_address);
+        Addr line_addr = makeNextStrideAddress(stream->m_address,
+                                               stream->m_stride);
+
+        // possibly stop prefetching at page boundaries
+        if (page_addr != pageAddress(line_addr)) {
+            numPagesCrossed++;
+            if (!m_prefetch_cross_pages) {
+                // Stop at the page boundary. The stream is resumed if the
+                // demand stream misses on the first line past it.
+                stream->m_parked = true;
+                break;
+            }
+        }
+
+        // launch next prefetch
+        stream->m_address = line_addr;
+        stream->m_use_time = m_controller->curCycle();
+        DPRINTF(RubyPrefetcher, "Requesting prefetch for %#x\n", line_addr);
+        m_controller->enqueuePrefetch(line_addr, stream->m_type);
+    }
+    mapStream(index);
 }
 
 uint32_t
-Prefetcher::getLRUindex(void)
+Prefetcher::getLRUindex(Addr address)
 {
-    uint32_t lru_index = 0;
+    // streams are placed in a set chosen by the page they start in
+    uint32_t set = (address >> m_page_shift) % m_stream_sets;
+    uint32_t lru_index = set * m_stream_assoc;
     Cycles lru_access = m_array[lru_index].m_use_time;
 
-    for (uint32_t i = 0; i < m_num_streams; i++) {
+    for (uint32_t i = lru_index; i < (set + 1) * m_stream_assoc; i++) {
         if (!m_array[i].m_is_valid) {
             return i;
         }
@@ -276,9 +294,56 @@ Prefetcher::getLRUindex(void)
     return lru_index;
 }
 
+void
+Prefetcher::mapStream(uint32_t index)
+{
+    const PrefetchEntry &stream = m_array[index];
+    if (!stream.m_is_valid) {
+        return;
+    }
+
+    for (int j = 0; j < m_stream_window; j++) {
+        m_stream_map[makeNextStrideAddress(stream.m_address,
+                                           -(stream.m_stride * j))] = index;
+    }
+    if (stream.m_parked) {
+        m_stream_map[makeNextStrideAddress(stream.m_address,
+                                           stream.m_stride)] = index;
+    }
+}
+
+void
+Prefetcher::unmapStream(uint32_t index)
+{
+    const PrefetchEntry &stream = m_array[index];
+    if (!stream.m_is_valid) {
+        return;
+    }
+
+    // another stream may have claimed an address since, leave it alone
+    auto unmap = [this, index](Addr addr) {
+        auto it = m_stream_map.find(addr);
+        if (it != m_stream_map.end() && it->second == index) {
+            m_stream_map.erase(it);
+        }
+    };
+
+    for (int j = 0; j < m_stream_window; j++) {
+        unmap(makeNextStrideAddress(stream.m_address,
+                                    -(stream.m_stride * j)));
+    }
+    if (stream.m_parked) {
+        unmap(makeNextStrideAddress(stream.m_address, stream.m_stride));
+    }
+}
+
 void
 Prefetcher::clearNonunitEntry(uint32_t index)
 {
+    auto it = m_nonunit_lookup.find(pageAddress(m_nonunit_filter[index]));
+    if (it != m_nonunit_lookup.end() && it->second == index) {
+        m_nonunit_lookup.erase(it);
+    }
     m_nonunit_filter[index] = 0;
     m_nonunit_stride[index] = 0;
     m_nonunit_hit[index]    = 0;
@@ -292,10 +357,12 @@ Prefetcher::initializeStream(Addr address, int stride,
 
     // initialize the stream prefetcher
     PrefetchEntry *mystream = &(m_array[index]);
+    unmapStream(index);
     mystream->m_address = makeLineAddress(address);
     mystream->m_stride = stride;
     mystream->m_use_time = m_controller->curCycle();
     mystream->m_is_valid = true;
+    mystream->m_parked = false;
     mystream->m_type = type;
 
     // create a number of initial prefetches for this stream
@@ -304,16 +371,17 @@ Prefetcher::initializeStream(Addr address, int stride,
 
     // insert a number of prefetches into the prefetch table
     for (int k = 0; k < m_num_startup_pfs; k++) {
-        line_addr = makeNextStrideAddress(line_addr, stride);
+        Addr next_addr = makeNextStrideAddress(line_addr, stride);
         // possibly stop prefetching at page boundaries
-        if (page_addr != pageAddress(line_addr)) {
+        if (page_addr != pageAddress(next_addr)) {
             numPagesCrossed++;
             if (!m_prefetch_cross_pages) {
-                // deallocate this stream prefetcher
-                mystream->m_is_valid = false;
-                return;
+                // wait for the demand stream to cross the page
+                mystream->m_parked = true;
+                break;
             }
         }
+        line_addr = next_addr;
 
         // launch prefetch
         numPrefetchRequested++;
@@ -323,56 +391,56 @@ Prefetcher::initializeStream(Addr address, int stride,
 
     // update the address to be the last address prefetched
     mystream->m_address = line_addr;
+    mapStream(index);
 }
 
 PrefetchEntry *
 Prefetcher::getPrefetchEntry(Addr address, uint32_t &index)
 {
-    // search all streams for a match
-    for (int i = 0; i < m_num_streams; i++) {
-        // search all the outstanding prefetches for this stream
-        if (m_array[i].m_is_valid) {
-            for (int j = 0; j < m_num_startup_pfs; j++) {
-                if (makeNextStrideAddress(m_array[i].m_address,
-                    -(m_array[i].m_stride*j)) == address) {
-                    return &(m_array[i]);
-                }
-            }
-        }
+    // look up the stream that has this address outstanding
+    auto it = m_stream_map.find(address);
+    if (it == m_stream_map.end()) {
+        return NULL;
     }
-    return NULL;
+    return &(m_array[it->second]);
 }
 
 bool
-Prefetcher::accessUnitFilter(std::vector<Addr>& filter_table,
-    uint32_t *filter_hit, uint32_t &index, Addr address,
+Prefetcher::accessUnitFilter(UnitFilter &filter, Addr address,
     int stride, bool &alloc)
 {
     //reset the alloc flag
     alloc = false;
 
     Addr line_addr = makeLineAddress(address);
-    for (int i = 0; i < m_num_unit_filters; i++) {
-        if (filter_table[i] == line_addr) {
-            filter_table[i] = makeNextStrideAddress(filter_table[i], stride);
-            filter_hit[i]++;
-            if (filter_hit[i] >= m_train_misses) {
-                alloc = true;
-            }
-            return true;
+    auto it = filter.lookup.find(line_addr);
+    if (it != filter.lookup.end()) {
+        uint32_t i = it->second;
+        filter.lookup.erase(it);
+        filter.address[i] = makeNextStrideAddress(filter.address[i], stride);
+        filter.lookup.emplace(filter.address[i], i);
+        filter.hit[i]++;
+        if (filter.hit[i] >= m_train_misses) {
+            alloc = true;
         }
+        return true;
     }
 
-    // enter this address in the table
-    int local_index = index;
-    filter_table[local_index] = makeNextStrideAddress(line_addr, stride);
-    filter_hit[local_index] = 0;
+    // enter this address in the table, replacing the round robin victim
+    uint32_t local_index = filter.index;
+    it = filter.lookup.find(filter.address[local_index]);
+    if (it != filter.lookup.end() && it->second == local_index) {
+        filter.lookup.erase(it);
+    }
+    filter.address[local_index] = makeNextStrideAddress(line_addr, stride);
+    filter.hit[local_index] = 0;
+    filter.lookup.emplace(filter.address[local_index], local_index);
     local_index = local_index + 1;
     if (local_index >= m_num_unit_filters) {
         local_index = 0;
     }
 
-    index = local_index;
+    filter.index = local_index;
     return false;
 }
 
@@ -387,50 +455,50 @@ Prefetcher::accessNonunitFilter(Addr address, int *stride,
     Addr page_addr = pageAddress(address);
     Addr line_addr = makeLineAddress(address);
 
-    for (uint32_t i = 0; i < m_num_nonunit_filters; i++) {
-        if (pageAddress(m_nonunit_filter[i]) == page_addr) {
-            // hit in the non-unit filter
-            // compute the actual stride (for this reference)
-            int delta = line_addr - m_nonunit_filter[i];
-
-            if (delta != 0) {
-                // no zero stride prefetches
-                // check that the stride matches (for the last N times)
-                if (delta == m_nonunit_stride[i]) {
-                    // -> stride hit
-                    // increment count (if > 2) allocate stream
-                    m_nonunit_hit[i]++;
-                    if (m_nonunit_hit[i] > m_train_misses) {
-                        // This stride HAS to be the multiplicative constant of
-                        // dataBlockBytes (bc makeNextStrideAddress is
-                        // calculated based on this multiplicative constant!)
-                        *stride = m_nonunit_stride[i] /
-                                    RubySystem::getBlockSizeBytes();
-
-                        // clear this filter entry
-                        clearNonunitEntry(i);
-                        alloc = true;
-                    }
-                } else {
-                    // delta didn't match ... reset m_nonunit_hit count for
-                    // this entry
+    auto it = m_nonunit_lookup.find(page_addr);
+    if (it != m_nonunit_lookup.end()) {
+        uint32_t i = it->second;
+        // hit in the non-unit filter
+        // compute the actual stride (for this reference)
+        int delta = line_addr - m_nonunit_filter[i];
+
+        if (delta != 0) {
+            // no zero stride prefetches
+            // check that the stride matches (for the last N times)
+            if (delta == m_nonunit_stride[i]) {
+                // -> stride hit
+                // increment count (if > 2) allocate stream
+                m_nonunit_hit[i]++;
+                if (m_nonunit_hit[i] > m_train_misses) {
+                    // This stride HAS to be the multiplicative constant of
+                    // dataBlockBytes (bc makeNextStrideAddress is
+                    // calculated based on this multiplicative constant!)
+                    *stride = m_nonunit_stride[i] /
+                                RubySystem::getBlockSizeBytes();
+
+                    // restart training this filter entry
                     m_nonunit_hit[i] = 0;
+                    alloc = true;
                 }
-
-                // update the last address seen & the stride
-                m_nonunit_stride[i] = delta;
-                m_nonunit_filter[i] = line_addr;
-                return true;
             } else {
-                return false;
+                // delta didn't match ... reset m_nonunit_hit count for
+                // this entry
+                m_nonunit_hit[i] = 0;
             }
+
+            // update the last address seen & the stride
+            m_nonunit_stride[i] = delta;
+            m_nonunit_filter[i] = line_addr;
+            return true;
+        } else {
+            return false;
         }
     }
 
     // not found: enter this address in the table
+    clearNonunitEntry(m_nonunit_index);
     m_nonunit_filter[m_nonunit_index] = line_addr;
-    m_nonunit_stride[m_nonunit_index] = 0;
-    m_nonunit_hit[m_nonunit_index]    = 0;
+    m_nonunit_lookup[page_addr] = m_nonunit_index;
 
     m_nonunit_index = m_nonunit_index + 1;
     if (m_nonunit_index >= m_num_nonunit_filters) {
@@ -446,12 +514,12 @@ Prefetcher::print(std::ostream& out) const
     // print out unit filter
     out << "unit table:\n";
     for (int i = 0; i < m_num_unit_filters; i++) {
-        out << m_unit_filter[i] << std::endl;
+        out << m_unit_filter.address[i] << std::endl;
     }
 
     out << "negative table:\n";
     for (int i = 0; i < m_num_unit_filters; i++) {
-        out << m_negative_filter[i] << std::endl;
+        out << m_negative_filter.address[i] << std::endl;
     }
 
     // print out non-unit stride filter
@@ -468,6 +536,7 @@ Prefetcher::print(std::ostream& out) const
         out << m_array[i].m_address << " "
             << m_array[i].m_stride << " "
             << m_array[i].m_is_valid << " "
+            << m_array[i].m_parked << " "
             << m_array[i].m_use_time << std::endl;
     }
 }
@@ -32,6 +32,8 @@
 // Implements Power 4 like prefetching
 
 #include <bitset>
+#include <unordered_map>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "mem/ruby/common/Address.hh"
@@ -55,6 +57,7 @@ class PrefetchEntry
             m_stride   = (1 << RubySystem::getBlockSizeBits());
             m_use_time = Cycles(0);
             m_is_valid = false;
+            m_parked = false;
         }
 
         //! The base address for the stream prefetch
@@ -69,6 +72,10 @@ class PrefetchEntry
         //! valid bit for each stream
         bool m_is_valid;
 
+        //! the stream reached a page boundary it may not cross and waits
+        //! for a demand miss on the next line to resume
+        bool m_parked;
+
         //! L1D prefetches loads and stores
         RubyRequestType m_type;
 
@@ -112,12 +119,39 @@ class Prefetcher : public SimObject
         void regStats();
 
     private:
+        /**
+         * A round robin filter used to train unit and negative unit stride
+         * streams. Entries are found through a hash table keyed by the
+         * line address each entry expects next.
+         */
+        struct UnitFilter
+        {
+            UnitFilter(uint32_t size)
+                : address(size, 0), hit(size, 0), index(0)
+            {}
+
+            //! the next line address expected by each entry
+            std::vector<Addr> address;
+            //! number of times each entry has been hit
+            std::vector<uint32_t> hit;
+            //! maps an expected line address to its entry
+            std::unordered_map<Addr, uint32_t> lookup;
+            //! a round robin pointer into the filter
+            uint32_t index;
+        };
+
         /**
          * Returns an unused stream buffer (or if all are used, returns the
-         * least recently used (accessed) stream buffer).
+         * least recently used (accessed) stream buffer) from the set
+         * the address maps to.
          * @return  The index of the least recently used stream buffer.
          */
-        uint32_t getLRUindex(void);
+        uint32_t getLRUindex(Addr address);
+
+        //! add (remove) the addresses a stream answers for to (from) the
+        //! stream lookup table
+        void mapStream(uint32_t index);
+        void unmapStream(uint32_t index);
 
         //! clear a non-unit stride prefetcher entry
         void clearNonunitEntry(uint32_t index);
@@ -132,8 +166,7 @@ class Prefetcher : public SimObject
             uint32_t &index);
 
         /// access a unit stride filter to determine if there is a hit
-        bool accessUnitFilter(std::vector<Addr>& filter_table,
-            uint32_t *hit_table, uint32_t &index, Addr address,
+        bool accessUnitFilter(UnitFilter &filter, Addr address,
             int stride, bool &alloc);
 
         /// access a unit stride filter to determine if there is a hit
@@ -145,8 +178,18 @@ class Prefetcher : public SimObject
 
         //! number of prefetch streams available
         uint32_t m_num_streams;
+        //! number of ways in each set of the stream table
+        uint32_t m_stream_assoc;
+        //! number of sets in the stream table
+        uint32_t m_stream_sets;
+        //! number of prefetches issued each time a stream advances
+        uint32_t m_degree;
+        //! number of trailing prefetched lines each stream answers for
+        uint32_t m_stream_window;
         //! an array of the active prefetch streams
         std::vector<PrefetchEntry> m_array;
+        //! maps the outstanding prefetch addresses to their stream
+        std::unordered_map<Addr, uint32_t> m_stream_map;
 
         //! number of misses I must see before allocating a stream
         uint32_t m_train_misses;
@@ -157,32 +200,24 @@ class Prefetcher : public SimObject
         //! number of non-stride filters
         uint32_t m_num_nonunit_filters;
 
-        /// a unit stride filter array: helps reduce BW requirement of
+        /// a unit stride filter: helps reduce BW requirement of
         /// prefetching
-        std::vector<Addr> m_unit_filter;
-        /// a round robin pointer into the unit filter group
-        uint32_t m_unit_filter_index;
-        //! An array used to count the of times particular filter entries
-        //! have been hit
-        uint32_t *m_unit_filter_hit;
+        UnitFilter m_unit_filter;
 
-        //! a negative nit stride filter array: helps reduce BW requirement
+        //! a negative unit stride filter: helps reduce BW requirement
         //! of prefetching
-        std::vector<Addr> m_negative_filter;
-        /// a round robin pointer into the negative filter group
-        uint32_t m_negative_filter_index;
-        /// An array used to count the of times particular filter entries
-        /// have been hit
-        uint32_t *m_negative_filter_hit;
+        UnitFilter m_negative_filter;
 
         /// a non-unit stride filter array: helps reduce BW requirement of
         /// prefetching
         std::vector<Addr> m_nonunit_filter;
         /// An array of strides (in # of cache lines) for the filter entries
-        int *m_nonunit_stride;
+        std::vector<int> m_nonunit_stride;
         /// An array used to count the of times particular filter entries
         /// have been hit
-        uint32_t *m_nonunit_hit;
+        std::vector<uint32_t> m_nonunit_hit;
+        /// maps a page address to the non-unit filter entry tracking it
+        std::unordered_map<Addr, uint32_t> m_nonunit_lookup;
         /// a round robin pointer into the unit filter group
         uint32_t m_nonunit_index;
 
@@ -209,6 +244,8 @@ class Prefetcher : public SimObject
         Stats::Scalar numPartialHits;
         //! Count of pages crossed
         Stats::Scalar numPagesCrossed;
+        //! Count of streams resumed after stopping at a page boundary
+        Stats::Scalar numResumedStreams;
         //! Count of misses incurred for blocks that were prefetched
         Stats::Scalar numMissedPrefetchedBlocks;
 };
@@ -38,7 +38,10 @@ class Prefetcher(SimObject):
 
     num_streams = Param.UInt32(4,
         "Number of prefetch streams to be allocated")
-    pf_per_stream = Param.UInt32(1, "Number of prefetches per stream")
+    stream_assoc = Param.UInt32(4,
+        "Associativity of the stream table, 0 for fully associative")
+    pf_per_stream = Param.UInt32(1,
+        "Number of prefetches issued each time a stream advances")
     unit_filter  = Param.UInt32(8,
         "Number of entries in the unit filter array")
     nonunit_filter = Param.UInt32(8,
@@ -46,5 +49,6 @@ class Prefetcher(SimObject):
     train_misses = Param.UInt32(4, "")
     num_startup_pfs = Param.UInt32(1, "")
     cross_page = Param.Bool(False, """True if prefetched address can be on a
-            page different from the observed address""")
+            page different from the observed address. Otherwise streams stop
+            at page boundaries and resume once a demand miss crosses it""")
     sys = Param.System(Parent.any, "System this prefetcher belongs to")
@@ -30,6 +30,8 @@
 #include "mem/ruby/system/CacheRecorder.hh"
 
 #include "debug/RubyCacheTrace.hh"
+#include "mem/cache_snapshot.hh"
+#include "mem/ruby/slicc_interface/AbstractController.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/ruby/system/Sequencer.hh"
 
@@ -145,6 +147,47 @@ CacheRecorder::enqueueNextFetchRequest()
     }
 }
 
+void
+CacheRecorder::installRecords(const std::vector<AbstractController *> &cntrls)
+{
+    const int block_size = RubySystem::getBlockSizeBytes();
+    uint64_t installed = 0;
+    DataBlock data;
+
+    for (; m_bytes_read < m_uncompressed_trace_size;
+         m_bytes_read += sizeof(TraceRecord) + m_block_size_bytes) {
+        TraceRecord* traceRecord = (TraceRecord*) (m_uncompressed_trace +
+                                                   m_bytes_read);
+        DPRINTF(RubyCacheTrace, "Installing %s\n", *traceRecord);
+
+        assert(traceRecord->m_cntrl_id < (int)cntrls.size());
+        AbstractController *owner = cntrls[traceRecord->m_cntrl_id];
+        const MachineID &requestor = owner->getMachineID();
+
+        for (int rec_bytes_read = 0; rec_bytes_read < m_block_size_bytes;
+             rec_bytes_read += block_size) {
+            Addr addr = traceRecord->m_data_address + rec_bytes_read;
+            data.setData(traceRecord->m_data + rec_bytes_read, 0, block_size);
+
+            if (!owner->installLine(addr, traceRecord->m_type, requestor,
+                                    data)) {
+                continue;
+            }
+
+            for (auto cntrl : cntrls) {
+                if (cntrl != owner)
+                    cntrl->installLine(addr, traceRecord->m_type, requestor,
+                                       data);
+            }
+            installed++;
+        }
+        m_records_read++;
+    }
+
+    DPRINTF(RubyCacheTrace, "Installed %d lines of %d records\n", installed,
+            m_records_read);
+}
+
 void
 CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                          RubyRequestType type, Tick time, DataBlock& data)
@@ -162,6 +205,33 @@ CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
     m_records.push_back(rec);
 }
 
+void
+CacheRecorder::snapshot(const std::vector<int> &cores,
+                        CacheSnapshot &snapshot) const
+{
+    for (const auto rec : m_records) {
+        CacheSnapshot::Line line;
+        line.addr = rec->m_data_address;
+        line.size = m_block_size_bytes;
+        line.core = cores[rec->m_cntrl_id];
+        line.secure = false;
+        line.lastTouch = rec->m_time;
+
+        switch (rec->m_type) {
+          case RubyRequestType_IFETCH:
+            line.kind = CacheSnapshot::Kind::IFetch;
+            break;
+          case RubyRequestType_ST:
+            line.kind = CacheSnapshot::Kind::Store;
+            break;
+          default:
+            line.kind = CacheSnapshot::Kind::Load;
+            break;
+        }
+        snapshot.lines.push_back(line);
+    }
+}
+
 uint64_t
 CacheRecorder::aggregateRecords(uint8_t **buf, uint64_t total_size)
 {
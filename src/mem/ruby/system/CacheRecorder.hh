@@ -43,6 +43,8 @@
 #include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
+class AbstractController;
+class CacheSnapshot;
 class Sequencer;
 
 /*!
@@ -97,6 +99,23 @@ class CacheRecorder
      */
     void enqueueNextFetchRequest();
 
+    /*!
+     * Function for installing all the recorded cache contents directly
+     * in the controllers, see AbstractController::warmupLine. Lines
+     * that the recording controller can't hold are left in memory.
+     */
+    void installRecords(const std::vector<AbstractController *> &cntrls);
+
+    /*!
+     * Function for adding the recorded cache contents to a cache
+     * snapshot, so that other memory systems can warm up from them.
+     *
+     * @param cores Core of each controller, -1 if it is shared.
+     * @param snapshot Snapshot the lines are added to.
+     */
+    void snapshot(const std::vector<int> &cores,
+                  CacheSnapshot &snapshot) const;
+
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
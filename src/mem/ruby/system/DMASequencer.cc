@@ -40,15 +40,18 @@ DMARequest::DMARequest(uint64_t start_paddr, int len, bool write,
                        int bytes_completed, int bytes_issued, uint8_t *data,
                        PacketPtr pkt)
     : start_paddr(start_paddr), len(len), write(write),
-      bytes_completed(bytes_completed), bytes_issued(bytes_issued), data(data),
-      pkt(pkt)
+      bytes_completed(bytes_completed), bytes_issued(bytes_issued),
+      lines_outstanding(0), data(data), pkt(pkt)
 {
 }
 
 DMASequencer::DMASequencer(const Params *p)
     : RubyPort(p), m_outstanding_count(0),
-      m_max_outstanding_requests(p->max_outstanding_requests)
+      m_max_outstanding_requests(p->max_outstanding_requests),
+      m_max_outstanding_lines(p->max_outstanding_lines)
 {
+    fatal_if(m_max_outstanding_lines < 1,
+             "%s: max_outstanding_lines must be at least 1\n", name());
 }
 
 void
@@ -75,44 +78,28 @@ DMASequencer::makeRequest(PacketPtr pkt)
 
     assert(m_outstanding_count < m_max_outstanding_requests);
     Addr line_addr = makeLineAddress(paddr);
-    auto emplace_pair =
-        m_RequestTable.emplace(std::piecewise_construct,
-                               std::forward_as_tuple(line_addr),
-                               std::forward_as_tuple(paddr, len, write, 0,
-                                                     0, data, pkt));
-    DMARequest& active_request = emplace_pair.first->second;
+    Addr last_line_addr = makeLineAddress(paddr + len - 1);
 
     // This is pretty conservative.  A regular Sequencer with a  more beefy
     // request table that can track multiple requests for a cache line should
     // be used if a more aggressive policy is needed.
-    if (!emplace_pair.second) {
+    for (const auto &r : m_RequestTable) {
+        const DMARequest &other = r.second;
+        if (line_addr <= makeLineAddress(other.start_paddr + other.len - 1) &&
+            makeLineAddress(other.start_paddr) <= last_line_addr) {
             DPRINTF(RubyDma, "DMA aliased: addr %p, len %d\n", line_addr, len);
             return RequestStatus_Aliased;
+        }
     }
 
+    m_RequestTable.emplace(std::piecewise_construct,
+                           std::forward_as_tuple(line_addr),
+                           std::forward_as_tuple(paddr, len, write, 0,
+                                                 0, data, pkt));
     DPRINTF(RubyDma, "DMA req created: addr %p, len %d\n", line_addr, len);
 
-    std::shared_ptr<SequencerMsg> msg =
-        std::make_shared<SequencerMsg>(clockEdge());
-    msg->getPhysicalAddress() = paddr;
-    msg->getLineAddress() = line_addr;
-    msg->getType() = write ? SequencerRequestType_ST : SequencerRequestType_LD;
-    int offset = paddr & m_data_block_mask;
-
-    msg->getLen() = (offset + len) <= RubySystem::getBlockSizeBytes() ?
-        len : RubySystem::getBlockSizeBytes() - offset;
-
-    if (write && (data != NULL)) {
-        if (active_request.data != NULL) {
-            msg->getDataBlk().setData(data, offset, msg->getLen());
-        }
-    }
-
     m_outstanding_count++;
-
-    assert(m_mandatory_q_ptr != NULL);
-    m_mandatory_q_ptr->enqueue(msg, clockEdge(), cyclesToTicks(Cycles(1)));
-    active_request.bytes_issued += msg->getLen();
+    issueNext(line_addr);
 
     return RequestStatus_Issued;
 }
@@ -126,10 +113,65 @@ DMASequencer::issueNext(const Addr& address)
     DMARequest &active_request = i->second;
 
     assert(m_outstanding_count <= m_max_outstanding_requests);
-    active_request.bytes_completed = active_request.bytes_issued;
+    while (active_request.bytes_issued < active_request.len &&
+           active_request.lines_outstanding < m_max_outstanding_lines) {
+        RefCountingPtr<SequencerMsg> msg = new SequencerMsg(clockEdge());
+        msg->getPhysicalAddress() = active_request.start_paddr +
+                                    active_request.bytes_issued;
+        msg->getLineAddress() = makeLineAddress(msg->getPhysicalAddress());
+
+        msg->getType() = (active_request.write ? SequencerRequestType_ST :
+                         SequencerRequestType_LD);
+
+        int offset = msg->getPhysicalAddress() & m_data_block_mask;
+        int remaining = active_request.len - active_request.bytes_issued;
+        msg->getLen() =
+            (offset + remaining) <= RubySystem::getBlockSizeBytes() ?
+            remaining : RubySystem::getBlockSizeBytes() - offset;
+
+        if (active_request.write && (active_request.data != NULL)) {
+            msg->getDataBlk().
+                setData(&active_request.data[active_request.bytes_issued],
+                        offset, msg->getLen());
+        }
+
+        auto emplace_pair =
+            m_LineTable.emplace(msg->getLineAddress(),
+                                DMALine{address, active_request.bytes_issued,
+                                        msg->getLen()});
+        assert(emplace_pair.second);
+
+        assert(m_mandatory_q_ptr != NULL);
+        m_mandatory_q_ptr->enqueue(msg, clockEdge(),
+                                   cyclesToTicks(Cycles(1)));
+        active_request.bytes_issued += msg->getLen();
+        active_request.lines_outstanding++;
+    }
+
+    DPRINTF(RubyDma,
+            "DMA request bytes issued %d, bytes completed %d, total len %d\n",
+            active_request.bytes_issued, active_request.bytes_completed,
+            active_request.len);
+}
+
+void
+DMASequencer::lineCompleted(const Addr& address)
+{
+    LineTable::iterator l = m_LineTable.find(address);
+    assert(l != m_LineTable.end());
+
+    Addr request_addr = l->second.request;
+    RequestTable::iterator i = m_RequestTable.find(request_addr);
+    assert(i != m_RequestTable.end());
+
+    DMARequest &active_request = i->second;
+    active_request.bytes_completed += l->second.len;
+    active_request.lines_outstanding--;
+    m_LineTable.erase(l);
+
     if (active_request.len == active_request.bytes_completed) {
         DPRINTF(RubyDma, "DMA request completed: addr %p, size %d\n",
-                address, active_request.len);
+                request_addr, active_request.len);
         m_outstanding_count--;
         PacketPtr pkt = active_request.pkt;
         m_RequestTable.erase(i);
@@ -137,63 +179,34 @@ DMASequencer::issueNext(const Addr& address)
         return;
     }
 
-    std::shared_ptr<SequencerMsg> msg =
-        std::make_shared<SequencerMsg>(clockEdge());
-    msg->getPhysicalAddress() = active_request.start_paddr +
-                                active_request.bytes_completed;
-
-    assert((msg->getPhysicalAddress() & m_data_block_mask) == 0);
-    msg->getLineAddress() = makeLineAddress(msg->getPhysicalAddress());
-
-    msg->getType() = (active_request.write ? SequencerRequestType_ST :
-                     SequencerRequestType_LD);
-
-    msg->getLen() =
-        (active_request.len -
-         active_request.bytes_completed < RubySystem::getBlockSizeBytes() ?
-         active_request.len - active_request.bytes_completed :
-         RubySystem::getBlockSizeBytes());
-
-    if (active_request.write) {
-        msg->getDataBlk().
-            setData(&active_request.data[active_request.bytes_completed],
-                    0, msg->getLen());
-    }
-
-    assert(m_mandatory_q_ptr != NULL);
-    m_mandatory_q_ptr->enqueue(msg, clockEdge(), cyclesToTicks(Cycles(1)));
-    active_request.bytes_issued += msg->getLen();
-    DPRINTF(RubyDma,
-            "DMA request bytes issued %d, bytes completed %d, total len %d\n",
-            active_request.bytes_issued, active_request.bytes_completed,
-            active_request.len);
+    issueNext(request_addr);
 }
 
 void
 DMASequencer::dataCallback(const DataBlock & dblk, const Addr& address)
 {
+    LineTable::iterator l = m_LineTable.find(address);
+    assert(l != m_LineTable.end());
 
-    RequestTable::iterator i = m_RequestTable.find(address);
+    const DMALine &line = l->second;
+    RequestTable::iterator i = m_RequestTable.find(line.request);
     assert(i != m_RequestTable.end());
 
     DMARequest &active_request = i->second;
-    int len = active_request.bytes_issued - active_request.bytes_completed;
-    int offset = 0;
-    if (active_request.bytes_completed == 0)
-        offset = active_request.start_paddr & m_data_block_mask;
+    int offset = (active_request.start_paddr + line.offset) &
+        m_data_block_mask;
     assert(!active_request.write);
     if (active_request.data != NULL) {
-        memcpy(&active_request.data[active_request.bytes_completed],
-               dblk.getData(offset, len), len);
+        memcpy(&active_request.data[line.offset],
+               dblk.getData(offset, line.len), line.len);
     }
-    issueNext(address);
+    lineCompleted(address);
 }
 
 void
 DMASequencer::ackCallback(const Addr& address)
 {
-    assert(m_RequestTable.find(address) != m_RequestTable.end());
-    issueNext(address);
+    lineCompleted(address);
 }
 
 void
@@ -49,10 +49,21 @@ struct DMARequest
     bool write;
     int bytes_completed;
     int bytes_issued;
+    int lines_outstanding;
     uint8_t *data;
     PacketPtr pkt;
 };
 
+/** A cache line of a DMA request that has been sent into Ruby */
+struct DMALine
+{
+    /** Request table key of the DMA request the line belongs to */
+    Addr request;
+    /** Offset of the line's data within the DMA request */
+    int offset;
+    int len;
+};
+
 class DMASequencer : public RubyPort
 {
   public:
@@ -74,15 +85,31 @@ class DMASequencer : public RubyPort
     void recordRequestType(DMASequencerRequestType requestType);
 
   private:
+    /**
+     * Send the next lines of a DMA request into Ruby until the request
+     * has m_max_outstanding_lines lines in flight or has been issued
+     * completely.
+     */
     void issueNext(const Addr &addr);
 
+    /**
+     * Retire a line of a DMA request. The request completes once all
+     * its lines have been retired, in whatever order they responded.
+     */
+    void lineCompleted(const Addr &addr);
+
     uint64_t m_data_block_mask;
 
     typedef std::unordered_map<Addr, DMARequest> RequestTable;
     RequestTable m_RequestTable;
 
+    /** The lines in flight, indexed by their line address */
+    typedef std::unordered_map<Addr, DMALine> LineTable;
+    LineTable m_LineTable;
+
     int m_outstanding_count;
     int m_max_outstanding_requests;
+    int m_max_outstanding_lines;
 };
 
 #endif // __MEM_RUBY_SYSTEM_DMASEQUENCER_HH__
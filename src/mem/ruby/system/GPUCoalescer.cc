@@ -33,6 +33,7 @@
  * Author: Sooraj Puthoor
  */
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/str.hh"
 #include "config/the_isa.hh"
@@ -115,10 +116,115 @@ reqSegmentToHSASegment(Request* req)
     return accessSegment;
 }
 
+CoalescingTable::CoalescingTable(int capacity)
+    : slots(capacity), indexBits(0), lastFound(nullptr), numLines(0)
+{
+    for (auto it = slots.rbegin(); it != slots.rend(); ++it)
+        freeSlots.push_back(&*it);
+
+    size_t buckets = 2;
+    while (buckets < 2 * slots.size())
+        buckets <<= 1;
+    resizeIndex(buckets);
+}
+
+size_t
+CoalescingTable::home(Addr line_addr) const
+{
+    return (line_addr * 0x9e3779b97f4a7c15ULL) >> (64 - indexBits);
+}
+
+size_t
+CoalescingTable::bucketOf(Addr line_addr) const
+{
+    size_t mask = index.size() - 1;
+    size_t i = home(line_addr);
+    while (index[i] && index[i]->addr != line_addr)
+        i = (i + 1) & mask;
+    return i;
+}
+
+void
+CoalescingTable::resizeIndex(size_t buckets)
+{
+    std::vector<Line *> old_index(buckets, nullptr);
+    index.swap(old_index);
+    indexBits = floorLog2(buckets);
+    for (auto line : old_index) {
+        if (line)
+            index[bucketOf(line->addr)] = line;
+    }
+}
+
+CoalescingTable::Line *
+CoalescingTable::find(Addr line_addr)
+{
+    if (lastFound && lastFound->addr == line_addr)
+        return lastFound;
+
+    Line *line = index[bucketOf(line_addr)];
+    if (line)
+        lastFound = line;
+    return line;
+}
+
+CoalescingTable::Line &
+CoalescingTable::insert(Addr line_addr)
+{
+    assert(!find(line_addr));
+
+    if (2 * (numLines + 1) > index.size())
+        resizeIndex(2 * index.size());
+
+    if (freeSlots.empty()) {
+        slots.emplace_back();
+        freeSlots.push_back(&slots.back());
+    }
+    Line *line = freeSlots.back();
+    freeSlots.pop_back();
+
+    assert(line->reqs.empty());
+    line->addr = line_addr;
+    index[bucketOf(line_addr)] = line;
+    lastFound = line;
+    numLines++;
+
+    return *line;
+}
+
+void
+CoalescingTable::erase(Line *line)
+{
+    size_t mask = index.size() - 1;
+    size_t hole = bucketOf(line->addr);
+    assert(index[hole] == line);
+    index[hole] = nullptr;
+
+    // Shift the rest of the probe sequence back into the hole, skipping
+    // the lines that would then be ahead of their home bucket.
+    for (size_t i = (hole + 1) & mask; index[i]; i = (i + 1) & mask) {
+        size_t h = home(index[i]->addr);
+        if (((i - h) & mask) >= ((i - hole) & mask)) {
+            index[hole] = index[i];
+            index[i] = nullptr;
+            hole = i;
+        }
+    }
+
+    if (lastFound == line)
+        lastFound = nullptr;
+
+    line->reqs.clear();
+    line->request = GPUCoalescerRequest();
+    freeSlots.push_back(line);
+    numLines--;
+}
+
 GPUCoalescer::GPUCoalescer(const Params *p)
     : RubyPort(p),
       issueEvent([this]{ completeIssue(); }, "Issue coalesced request",
                  false, Event::Progress_Event_Pri),
+      reqCoalescer(p->max_outstanding_requests),
       deadlockCheckEvent([this]{ wakeup(); }, "GPUCoalescer deadlock check")
 {
     m_store_waiting_on_load_cycles = 0;
@@ -328,6 +434,10 @@ GPUCoalescer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
     }
 
     Addr line_addr = makeLineAddress(pkt->getAddr());
+    // The request lives in the coalescing table entry of its line
+    CoalescingTable::Line *line = reqCoalescer.find(line_addr);
+    assert(line);
+
     if ((request_type == RubyRequestType_ST) ||
         (request_type == RubyRequestType_ATOMIC) ||
         (request_type == RubyRequestType_ATOMIC_RETURN) ||
@@ -345,8 +455,8 @@ GPUCoalescer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
                                        (GPUCoalescerRequest*) NULL));
         if (r.second) {
             RequestTable::iterator i = r.first;
-            i->second = new GPUCoalescerRequest(pkt, request_type,
-                                                curCycle());
+            i->second = &line->request;
+            *i->second = GPUCoalescerRequest(pkt, request_type, curCycle());
             DPRINTF(GPUCoalescer,
                     "Inserting write request for paddr %#x for type %d\n",
                     pkt->req->getPaddr(), i->second->m_type);
@@ -361,8 +471,8 @@ GPUCoalescer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
 
         if (r.second) {
             RequestTable::iterator i = r.first;
-            i->second = new GPUCoalescerRequest(pkt, request_type,
-                                             curCycle());
+            i->second = &line->request;
+            *i->second = GPUCoalescerRequest(pkt, request_type, curCycle());
             DPRINTF(GPUCoalescer,
                     "Inserting read request for paddr %#x for type %d\n",
                     pkt->req->getPaddr(), i->second->m_type);
@@ -625,11 +735,13 @@ GPUCoalescer::hitCallback(GPUCoalescerRequest* srequest,
     // update the data
     //
     // MUST AD DOING THIS FOR EACH REQUEST IN COALESCER
-    int len = reqCoalescer[request_line_address].size();
+    CoalescingTable::Line *line = reqCoalescer.find(request_line_address);
+    assert(line);
+    int len = line->reqs.size();
     std::vector<PacketPtr> mylist;
     for (int i = 0; i < len; ++i) {
-        PacketPtr pkt = reqCoalescer[request_line_address][i].pkt;
-        assert(type == reqCoalescer[request_line_address][i].primaryType);
+        PacketPtr pkt = line->reqs[i].pkt;
+        assert(type == line->reqs[i].primaryType);
         request_address = pkt->getAddr();
         request_line_address = makeLineAddress(pkt->getAddr());
         if (pkt->getPtr<uint8_t>()) {
@@ -670,9 +782,8 @@ GPUCoalescer::hitCallback(GPUCoalescerRequest* srequest,
 
         mylist.push_back(pkt);
     }
-    delete srequest;
-    reqCoalescer.erase(request_line_address);
-    assert(!reqCoalescer.count(request_line_address));
+    // This also releases srequest, which lives in the line
+    reqCoalescer.erase(line);
 
 
 
@@ -839,33 +950,34 @@ GPUCoalescer::makeRequest(PacketPtr pkt)
 
     // Check if this request can be coalesced with previous
     // requests from this cycle.
-    if (!reqCoalescer.count(line_addr)) {
+    CoalescingTable::Line *line = reqCoalescer.find(line_addr);
+    if (!line) {
         // This is the first access to this cache line.
         // A new request to the memory subsystem has to be
         // made in the next cycle for this cache line, so
         // add this line addr to the "newRequests" queue
         newRequests.push_back(line_addr);
+        line = &reqCoalescer.insert(line_addr);
 
     // There was a request to this cache line in this cycle,
     // let us see if we can coalesce this request with the previous
     // requests from this cycle
-    } else if (primary_type !=
-               reqCoalescer[line_addr][0].primaryType) {
+    } else if (primary_type != line->reqs[0].primaryType) {
         // can't coalesce loads, stores and atomics!
         return RequestStatus_Aliased;
     } else if (pkt->req->isLockedRMW() ||
-               reqCoalescer[line_addr][0].pkt->req->isLockedRMW()) {
+               line->reqs[0].pkt->req->isLockedRMW()) {
         // can't coalesce locked accesses, but can coalesce atomics!
         return RequestStatus_Aliased;
     } else if (pkt->req->hasContextId() && pkt->req->isRelease() &&
                pkt->req->contextId() !=
-               reqCoalescer[line_addr][0].pkt->req->contextId()) {
+               line->reqs[0].pkt->req->contextId()) {
         // can't coalesce releases from different wavefronts
         return RequestStatus_Aliased;
     }
 
     // in addition to the packet, we need to save both request types
-    reqCoalescer[line_addr].emplace_back(pkt, primary_type, secondary_type);
+    line->reqs.emplace_back(pkt, primary_type, secondary_type);
     if (!issueEvent.scheduled())
         schedule(issueEvent, curTick());
     // TODO: issue hardware prefetches here
@@ -907,9 +1019,10 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     uint32_t blockSize = RubySystem::getBlockSizeBytes();
     std::vector<bool> accessMask(blockSize,false);
     std::vector< std::pair<int,AtomicOpFunctor*> > atomicOps;
-    uint32_t tableSize = reqCoalescer[line_addr].size();
+    const std::vector<RequestDesc> &reqs = reqCoalescer.find(line_addr)->reqs;
+    uint32_t tableSize = reqs.size();
     for (int i = 0; i < tableSize; i++) {
-        PacketPtr tmpPkt = reqCoalescer[line_addr][i].pkt;
+        PacketPtr tmpPkt = reqs[i].pkt;
         uint32_t tmpOffset = (tmpPkt->getAddr()) - line_addr;
         uint32_t tmpSize = tmpPkt->getSize();
         if (tmpPkt->isAtomicOp()) {
@@ -924,9 +1037,9 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
             accessMask[tmpOffset + j] = true;
         }
     }
-    std::shared_ptr<RubyRequest> msg;
+    RefCountingPtr<RubyRequest> msg;
     if (pkt->isAtomicOp()) {
-        msg = std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
+        msg = new RubyRequest(clockEdge(), pkt->getAddr(),
                               pkt->getPtr<uint8_t>(),
                               pkt->getSize(), pc, secondary_type,
                               RubyAccessMode_Supervisor, pkt,
@@ -935,7 +1048,7 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
                               dataBlock, atomicOps,
                               accessScope, accessSegment);
     } else {
-        msg = std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
+        msg = new RubyRequest(clockEdge(), pkt->getAddr(),
                               pkt->getPtr<uint8_t>(),
                               pkt->getSize(), pc, secondary_type,
                               RubyAccessMode_Supervisor, pkt,
@@ -1013,7 +1126,7 @@ GPUCoalescer::completeIssue()
         // first request for each cacheline, the remaining requests
         // can be coalesced with the first request. So, only
         // one request is issued per cacheline.
-        RequestDesc info = reqCoalescer[newRequests[i]][0];
+        RequestDesc info = reqCoalescer.find(newRequests[i])->reqs[0];
         PacketPtr pkt = info.pkt;
         DPRINTF(GPUCoalescer, "Completing for newReq %d: paddr %#x\n",
                 i, pkt->req->getPaddr());
@@ -1086,12 +1199,13 @@ GPUCoalescer::atomicCallback(Addr address,
     Addr request_address = pkt->getAddr();
     Addr request_line_address = makeLineAddress(pkt->getAddr());
 
-    int len = reqCoalescer[request_line_address].size();
+    CoalescingTable::Line *line = reqCoalescer.find(request_line_address);
+    assert(line);
+    int len = line->reqs.size();
     std::vector<PacketPtr> mylist;
     for (int i = 0; i < len; ++i) {
-        PacketPtr pkt = reqCoalescer[request_line_address][i].pkt;
-        assert(srequest->m_type ==
-               reqCoalescer[request_line_address][i].primaryType);
+        PacketPtr pkt = line->reqs[i].pkt;
+        assert(srequest->m_type == line->reqs[i].primaryType);
         request_address = (pkt->getAddr());
         request_line_address = makeLineAddress(request_address);
         if (pkt->getPtr<uint8_t>() &&
@@ -1123,9 +1237,8 @@ GPUCoalescer::atomicCallback(Addr address,
 
         mylist.push_back(pkt);
     }
-    delete srequest;
-    reqCoalescer.erase(request_line_address);
-    assert(!reqCoalescer.count(request_line_address));
+    // This also releases srequest, which lives in the line
+    reqCoalescer.erase(line);
 
     completeHitCallback(mylist, len);
 }
@@ -36,8 +36,10 @@
 #ifndef __MEM_RUBY_SYSTEM_GPU_COALESCER_HH__
 #define __MEM_RUBY_SYSTEM_GPU_COALESCER_HH__
 
+#include <deque>
 #include <iostream>
 #include <unordered_map>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "mem/protocol/HSAScope.hh"
@@ -71,6 +73,10 @@ struct GPUCoalescerRequest
                         Cycles _issue_time)
         : pkt(_pkt), m_type(_m_type), issue_time(_issue_time)
     {}
+
+    GPUCoalescerRequest()
+        : pkt(nullptr), m_type(RubyRequestType_NULL), issue_time(0)
+    {}
 };
 
 class RequestDesc
@@ -91,6 +97,62 @@ class RequestDesc
     RubyRequestType secondaryType;
 };
 
+/**
+ * Requests coalesced per cache line, from the first access to a line
+ * until the response for that line has been handed back.
+ *
+ * Lines are kept in a slab of slots that are recycled through a free
+ * list. A slot keeps the storage of its request list, as well as the
+ * GPUCoalescerRequest that tracks the line in the read or write request
+ * table, so coalescing the lanes of a wavefront access does not
+ * allocate once the table has warmed up. The slab only grows when
+ * more lines are in flight than it was sized for.
+ *
+ * Lines are found through an open-addressed index, and the line that
+ * was found last is checked first since consecutive lanes mostly
+ * access the same line.
+ */
+class CoalescingTable
+{
+  public:
+    struct Line
+    {
+        Addr addr;
+        std::vector<RequestDesc> reqs;
+        GPUCoalescerRequest request;
+    };
+
+    explicit CoalescingTable(int capacity);
+
+    /** The line with address line_addr, or nullptr if there is none. */
+    Line *find(Addr line_addr);
+
+    /** Start coalescing requests to a line that isn't in the table. */
+    Line &insert(Addr line_addr);
+
+    /** Release a line, and recycle its slot. */
+    void erase(Line *line);
+
+    int size() const { return numLines; }
+    bool empty() const { return numLines == 0; }
+
+  private:
+    size_t home(Addr line_addr) const;
+    size_t bucketOf(Addr line_addr) const;
+    void resizeIndex(size_t buckets);
+
+    /** Slots of the slab; a deque keeps them in place as it grows. */
+    std::deque<Line> slots;
+    std::vector<Line *> freeSlots;
+
+    /** Index from line address to slot, with linear probing. */
+    std::vector<Line *> index;
+    int indexBits;
+
+    Line *lastFound;
+    int numLines;
+};
+
 std::ostream& operator<<(std::ostream& out, const GPUCoalescerRequest& obj);
 
 class GPUCoalescer : public RubyPort
@@ -275,7 +337,6 @@ class GPUCoalescer : public RubyPort
     // The secondary request type comprises a subset of RubyRequestTypes that
     // are understood by the L1 Controller. A primary request type can be any
     // RubyRequestType.
-    typedef std::unordered_map<Addr, std::vector<RequestDesc>> CoalescingTable;
     CoalescingTable reqCoalescer;
     std::vector<Addr> newRequests;
 
@@ -31,13 +31,18 @@
 #include <fcntl.h>
 #include <zlib.h>
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <list>
+#include <unordered_set>
 
+#include "arch/isa_traits.hh"
 #include "base/intmath.hh"
 #include "base/statistics.hh"
 #include "debug/RubyCacheTrace.hh"
 #include "debug/RubySystem.hh"
+#include "mem/cache_snapshot.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/network/Network.hh"
 #include "mem/simple_mem.hh"
@@ -58,6 +63,7 @@ bool RubySystem::m_cooldown_enabled = false;
 
 RubySystem::RubySystem(const Params *p)
     : ClockedObject(p), m_access_backing_store(p->access_backing_store),
+      m_fast_warmup(p->fast_warmup), m_cache_snapshot(p->cache_snapshot),
       m_cache_recorder(NULL)
 {
     m_randomization = p->randomization;
@@ -87,11 +93,48 @@ void
 RubySystem::registerAbstractController(AbstractController* cntrl)
 {
     m_abs_cntrl_vec.push_back(cntrl);
+    if (!cntrl->indexesLines())
+        m_unindexed_cntrls.push_back(cntrl);
 
     MachineID id = cntrl->getMachineID();
     m_abstract_controls[id.getType()][id.getNum()] = cntrl;
 }
 
+void
+RubySystem::updateLineHolder(AbstractController *cntrl, Addr line_addr)
+{
+    AccessPermission perm = cntrl->getAccessPermission(line_addr);
+    bool holds = perm != AccessPermission_Invalid &&
+        perm != AccessPermission_NotPresent;
+
+    auto it = m_line_holders.find(line_addr);
+    if (it == m_line_holders.end()) {
+        if (holds)
+            m_line_holders[line_addr].push_back(cntrl);
+        return;
+    }
+
+    std::vector<AbstractController *> &holders = it->second;
+    auto pos = std::find(holders.begin(), holders.end(), cntrl);
+    if (holds && pos == holders.end()) {
+        holders.push_back(cntrl);
+    } else if (!holds && pos != holders.end()) {
+        holders.erase(pos);
+        if (holders.empty())
+            m_line_holders.erase(it);
+    }
+}
+
+std::vector<AbstractController *>
+RubySystem::lineCandidates(Addr line_addr) const
+{
+    std::vector<AbstractController *> cntrls(m_unindexed_cntrls);
+    auto it = m_line_holders.find(line_addr);
+    if (it != m_line_holders.end())
+        cntrls.insert(cntrls.end(), it->second.begin(), it->second.end());
+    return cntrls;
+}
+
 RubySystem::~RubySystem()
 {
     delete m_network;
@@ -134,6 +177,10 @@ RubySystem::makeCacheRecorder(uint8_t *uncompressed_trace,
 void
 RubySystem::memWriteback()
 {
+    // The flush is simulated on the event queue of the Ruby system
+    fatal_if(numMainEventQueues > 1, "%s: Ruby caches can't be written "
+             "back with multiple event queues.\n", name());
+
     m_cooldown_enabled = true;
 
     // Make the trace so we know what to write back.
@@ -248,6 +295,13 @@ RubySystem::serialize(CheckpointOut &cp) const
         fatal("Call memWriteback() before serialize() to create ruby trace");
     }
 
+    // Export the lines before the records are handed over to the trace
+    if (m_cache_snapshot) {
+        CacheSnapshot snapshot;
+        m_cache_recorder->snapshot(snapshotCores(), snapshot);
+        snapshot.write(name());
+    }
+
     // Aggregate the trace entries together into a single array
     uint8_t *raw_data = new uint8_t[4096];
     uint64_t cache_trace_size = m_cache_recorder->aggregateRecords(&raw_data,
@@ -328,6 +382,107 @@ RubySystem::unserialize(CheckpointIn &cp)
     makeCacheRecorder(uncompressed_trace, cache_trace_size, block_size_bytes);
 }
 
+void
+RubySystem::loadState(CheckpointIn &cp)
+{
+    ClockedObject::loadState(cp);
+
+    // A checkpoint taken without Ruby has no cache trace, but may
+    // have cache snapshots. Their lines are read from memory in
+    // startup(), once all the state is restored.
+    if (m_cache_snapshot && !cp.sectionExists(name()))
+        m_snapshot_dir = cp.cptDir;
+}
+
+std::vector<int>
+RubySystem::snapshotCores() const
+{
+    std::vector<int> cores;
+    int core = 0;
+    for (auto cntrl : m_abs_cntrl_vec)
+        cores.push_back(cntrl->getCPUSequencer() ? core++ : -1);
+    return cores;
+}
+
+bool
+RubySystem::makeSnapshotRecorder(const std::string &cpt_dir)
+{
+    const std::vector<CacheSnapshot::Line> &lines =
+        CacheSnapshot::load(cpt_dir);
+
+    std::vector<int> owners;
+    const std::vector<int> cores = snapshotCores();
+    for (int cntrl = 0; cntrl < cores.size(); cntrl++) {
+        if (cores[cntrl] >= 0)
+            owners.push_back(cntrl);
+    }
+    fatal_if(owners.empty(), "%s: No controller is attached to a CPU.\n",
+             name());
+
+    // Lines of shared caches are handed out round-robin, unless a
+    // core holds them anyway
+    std::unordered_set<Addr> private_lines;
+    for (const auto &line : lines) {
+        if (line.core >= 0)
+            private_lines.insert(makeLineAddress(line.addr));
+    }
+
+    const uint64_t record_size = sizeof(TraceRecord) + m_block_size_bytes;
+    std::vector<uint8_t> trace;
+    unsigned next_owner = 0;
+
+    // The trace is replayed most recently used line first
+    for (auto line = lines.rbegin(); line != lines.rend(); ++line) {
+        const Addr end = line->addr + line->size;
+        for (Addr addr = makeLineAddress(line->addr); addr < end;
+             addr += m_block_size_bytes) {
+            if (line->core < 0 && private_lines.count(addr))
+                continue;
+
+            trace.resize(trace.size() + record_size);
+            TraceRecord *rec = reinterpret_cast<TraceRecord *>(
+                &trace[trace.size() - record_size]);
+
+            Request req(addr, m_block_size_bytes, 0, Request::funcMasterId);
+            Packet pkt(&req, MemCmd::ReadReq);
+            pkt.dataStatic(rec->m_data);
+            if (!functionalRead(&pkt)) {
+                trace.resize(trace.size() - record_size);
+                continue;
+            }
+
+            rec->m_cntrl_id = line->core < 0 ?
+                owners[next_owner++ % owners.size()] :
+                owners[line->core % owners.size()];
+            rec->m_time = line->lastTouch;
+            rec->m_data_address = addr;
+            rec->m_pc_address = 0;
+            switch (line->kind) {
+              case CacheSnapshot::Kind::IFetch:
+                rec->m_type = RubyRequestType_IFETCH;
+                break;
+              case CacheSnapshot::Kind::Store:
+                rec->m_type = RubyRequestType_ST;
+                break;
+              default:
+                rec->m_type = RubyRequestType_LD;
+                break;
+            }
+        }
+    }
+
+    DPRINTF(RubyCacheTrace, "Read %d cache trace records from the cache "
+            "snapshots\n", trace.size() / record_size);
+    if (trace.empty())
+        return false;
+
+    // The cache recorder owns the trace
+    uint8_t *raw_data = new uint8_t[trace.size()];
+    std::memcpy(raw_data, trace.data(), trace.size());
+    makeCacheRecorder(raw_data, trace.size(), m_block_size_bytes);
+    return true;
+}
+
 void
 RubySystem::startup()
 {
@@ -348,7 +503,36 @@ RubySystem::startup()
     // Ruby finishes restoring the state is less than the time when the
     // state was checkpointed.
 
-    if (m_warmup_enabled) {
+    if (!m_snapshot_dir.empty()) {
+        if (makeSnapshotRecorder(m_snapshot_dir)) {
+            m_warmup_enabled = true;
+            m_systems_to_warmup++;
+        }
+        m_snapshot_dir.clear();
+    }
+
+    if (m_warmup_enabled && m_fast_warmup && !canWarmupLines()) {
+        warn("%s: The protocol can't install cache lines directly, "
+             "replaying the cache trace instead.", name());
+    }
+
+    if (m_warmup_enabled && m_fast_warmup && canWarmupLines()) {
+        // The recorded lines are installed in their stable states
+        // without simulating the protocol, so time doesn't advance.
+        DPRINTF(RubyCacheTrace, "Installing ruby cache trace\n");
+        m_cache_recorder->installRecords(m_abs_cntrl_vec);
+
+        delete m_cache_recorder;
+        m_cache_recorder = NULL;
+        m_systems_to_warmup--;
+        if (m_systems_to_warmup == 0) {
+            m_warmup_enabled = false;
+        }
+    } else if (m_warmup_enabled) {
+        fatal_if(numMainEventQueues > 1, "%s: Ruby cache traces can only "
+                 "be replayed on a single event queue, set fast_warmup "
+                 "to install them instead.\n", name());
+
         DPRINTF(RubyCacheTrace, "Starting ruby cache warmup\n");
         // save the current tick value
         Tick curtick_original = curTick();
@@ -379,6 +563,67 @@ RubySystem::startup()
     resetStats();
 }
 
+bool
+RubySystem::canWarmupLines() const
+{
+    for (auto cntrl : m_abs_cntrl_vec) {
+        if (!cntrl->canWarmupLines())
+            return false;
+    }
+    return true;
+}
+
+void
+RubySystem::warmupPages(const std::vector<Addr> &pages)
+{
+    fatal_if(!canWarmupLines(), "%s: The protocol can't install cache "
+             "lines directly.\n", name());
+
+    std::vector<AbstractController *> owners;
+    for (auto cntrl : m_abs_cntrl_vec) {
+        if (cntrl->getCPUSequencer())
+            owners.push_back(cntrl);
+    }
+    fatal_if(owners.empty(), "%s: No controller is attached to a CPU.\n",
+             name());
+
+    const Addr page_bytes = TheISA::PageBytes;
+    uint64_t installed = 0;
+    DataBlock data;
+    std::vector<uint8_t> buf(m_block_size_bytes);
+
+    for (size_t i = 0; i < pages.size(); ++i) {
+        AbstractController *owner = owners[i % owners.size()];
+        const MachineID &requestor = owner->getMachineID();
+        const Addr base = roundDown(pages[i], page_bytes);
+
+        for (Addr addr = base; addr < base + page_bytes;
+             addr += m_block_size_bytes) {
+            Request req(addr, m_block_size_bytes, 0, Request::funcMasterId);
+            Packet pkt(&req, MemCmd::ReadReq);
+            pkt.dataStatic(buf.data());
+            if (!functionalRead(&pkt))
+                continue;
+            data.setData(buf.data(), 0, m_block_size_bytes);
+
+            if (!owner->installLine(addr, RubyRequestType_LD, requestor,
+                                    data)) {
+                continue;
+            }
+
+            for (auto cntrl : m_abs_cntrl_vec) {
+                if (cntrl != owner)
+                    cntrl->installLine(addr, RubyRequestType_LD, requestor,
+                                       data);
+            }
+            installed++;
+        }
+    }
+
+    DPRINTF(RubyCacheTrace, "Installed %d lines of %d pages\n", installed,
+            pages.size());
+}
+
 void
 RubySystem::processRubyEvent()
 {
@@ -404,18 +649,23 @@ RubySystem::functionalRead(PacketPtr pkt)
     AccessPermission access_perm = AccessPermission_NotPresent;
     int num_controllers = m_abs_cntrl_vec.size();
 
+    // Controllers that index their lines and don't hold this one have
+    // it in state Invalid or NotPresent.
+    const std::vector<AbstractController *> cntrls =
+        lineCandidates(line_address);
+
     DPRINTF(RubySystem, "Functional Read request for %#x\n", address);
 
     unsigned int num_ro = 0;
     unsigned int num_rw = 0;
     unsigned int num_busy = 0;
     unsigned int num_backing_store = 0;
-    unsigned int num_invalid = 0;
+    unsigned int num_invalid = num_controllers - cntrls.size();
 
     // In this loop we count the number of controllers that have the given
     // address in read only, read write and busy states.
-    for (unsigned int i = 0; i < num_controllers; ++i) {
-        access_perm = m_abs_cntrl_vec[i]-> getAccessPermission(line_address);
+    for (auto cntrl : cntrls) {
+        access_perm = cntrl->getAccessPermission(line_address);
         if (access_perm == AccessPermission_Read_Only)
             num_ro++;
         else if (access_perm == AccessPermission_Read_Write)
@@ -444,10 +694,10 @@ RubySystem::functionalRead(PacketPtr pkt)
     // it only if it's not in the cache hierarchy at all.
     if (num_invalid == (num_controllers - 1) && num_backing_store == 1) {
         DPRINTF(RubySystem, "only copy in Backing_Store memory, read from it\n");
-        for (unsigned int i = 0; i < num_controllers; ++i) {
-            access_perm = m_abs_cntrl_vec[i]->getAccessPermission(line_address);
+        for (auto cntrl : cntrls) {
+            access_perm = cntrl->getAccessPermission(line_address);
             if (access_perm == AccessPermission_Backing_Store) {
-                m_abs_cntrl_vec[i]->functionalRead(line_address, pkt);
+                cntrl->functionalRead(line_address, pkt);
                 return true;
             }
         }
@@ -461,11 +711,11 @@ RubySystem::functionalRead(PacketPtr pkt)
         // In this loop, we try to figure which controller has a read only or
         // a read write copy of the given address. Any valid copy would suffice
         // for a functional read.
-        for (unsigned int i = 0;i < num_controllers;++i) {
-            access_perm = m_abs_cntrl_vec[i]->getAccessPermission(line_address);
+        for (auto cntrl : cntrls) {
+            access_perm = cntrl->getAccessPermission(line_address);
             if (access_perm == AccessPermission_Read_Only ||
                 access_perm == AccessPermission_Read_Write) {
-                m_abs_cntrl_vec[i]->functionalRead(line_address, pkt);
+                cntrl->functionalRead(line_address, pkt);
                 return true;
             }
         }
@@ -493,12 +743,13 @@ RubySystem::functionalWrite(PacketPtr pkt)
     for (unsigned int i = 0; i < num_controllers;++i) {
         num_functional_writes +=
             m_abs_cntrl_vec[i]->functionalWriteBuffers(pkt);
+    }
 
-        access_perm = m_abs_cntrl_vec[i]->getAccessPermission(line_addr);
+    for (auto cntrl : lineCandidates(line_addr)) {
+        access_perm = cntrl->getAccessPermission(line_addr);
         if (access_perm != AccessPermission_Invalid &&
             access_perm != AccessPermission_NotPresent) {
-            num_functional_writes +=
-                m_abs_cntrl_vec[i]->functionalWrite(line_addr, pkt);
+            num_functional_writes += cntrl->functionalWrite(line_addr, pkt);
         }
     }
 
@@ -35,6 +35,10 @@
 #ifndef __MEM_RUBY_SYSTEM_RUBYSYSTEM_HH__
 #define __MEM_RUBY_SYSTEM_RUBYSYSTEM_HH__
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "base/callback.hh"
 #include "base/output.hh"
 #include "mem/packet.hh"
@@ -84,14 +88,27 @@ class RubySystem : public ClockedObject
     void memWriteback() override;
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
+    void loadState(CheckpointIn &cp) override;
     void drainResume() override;
     void process();
     void startup() override;
     bool functionalRead(Packet *ptr);
     bool functionalWrite(Packet *ptr);
 
+    /**
+     * Install every line of the given physical pages in the caches
+     * without simulating the protocol, e.g., to warm the caches with
+     * the pages touched while fast-forwarding using KVM. Pages are
+     * handed out to the controllers attached to a CPU round-robin,
+     * and the lines are installed as clean loads.
+     *
+     * @param pages Physical page addresses to install.
+     */
+    void warmupPages(const std::vector<Addr> &pages);
+
     void registerNetwork(Network*);
     void registerAbstractController(AbstractController*);
+    void updateLineHolder(AbstractController *cntrl, Addr line_addr);
 
     bool eventQueueEmpty() { return eventq->empty(); }
     void enqueueRubyEvent(Tick tick)
@@ -117,6 +134,29 @@ class RubySystem : public ClockedObject
                                      uint64_t uncompressed_trace_size);
 
     void processRubyEvent();
+
+    /**
+     * Core of each controller in cache snapshots: the controller
+     * attached to the k-th CPU sequencer holds the lines of core k,
+     * the other controllers are shared (-1).
+     */
+    std::vector<int> snapshotCores() const;
+
+    /**
+     * Create a cache trace from the cache snapshots of a checkpoint,
+     * reading the data of the lines from memory.
+     *
+     * @param cpt_dir Checkpoint directory.
+     * @return True if the snapshots hold any line.
+     */
+    bool makeSnapshotRecorder(const std::string &cpt_dir);
+
+    /** True if all controllers can install trace lines directly. */
+    bool canWarmupLines() const;
+
+    /** Controllers that may hold a copy of the given line */
+    std::vector<AbstractController *> lineCandidates(Addr line_addr) const;
+
   private:
     // configuration parameters
     static bool m_randomization;
@@ -129,9 +169,22 @@ class RubySystem : public ClockedObject
     static bool m_cooldown_enabled;
     SimpleMemory *m_phys_mem;
     const bool m_access_backing_store;
+    const bool m_fast_warmup;
+    const bool m_cache_snapshot;
+    /** Checkpoint to warm up from the cache snapshots of, if any */
+    std::string m_snapshot_dir;
 
     Network* m_network;
     std::vector<AbstractController *> m_abs_cntrl_vec;
+
+    /**
+     * Controllers that hold a valid, busy or backing store copy of a
+     * line, for the controllers that index their lines. Controllers
+     * that don't are always searched on a functional access.
+     */
+    std::unordered_map<Addr, std::vector<AbstractController *>>
+        m_line_holders;
+    std::vector<AbstractController *> m_unindexed_cntrls;
     Cycles m_start_cycle;
 
   public:
@@ -28,12 +28,17 @@
 #          Brad Beckmann
 
 from m5.params import *
+from m5.SimObject import PyBindMethod
 from ClockedObject import ClockedObject
 from SimpleMemory import *
 
 class RubySystem(ClockedObject):
     type = 'RubySystem'
     cxx_header = "mem/ruby/system/RubySystem.hh"
+    cxx_exports = [
+        PyBindMethod("warmupPages"),
+    ]
+
     randomization = Param.Bool(False,
         "insert random delays on message enqueue times");
     block_size_bytes = Param.UInt32(64,
@@ -46,8 +51,19 @@ class RubySystem(ClockedObject):
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
 
+    fast_warmup = Param.Bool(False, "Restore the caches from a checkpoint "
+        "by installing the recorded lines directly in the controllers, "
+        "if the protocol supports it, rather than replaying the trace")
+    cache_snapshot = Param.Bool(False, "Store the recorded lines in a "
+        "cache snapshot when checkpointing, and warm up the caches from "
+        "the cache snapshots of checkpoints taken without Ruby")
+
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
     all_instructions = Param.Bool(False, "")
+    hot_lines_entries = Param.Unsigned(1024, "Records kept per address "
+        "profiler table; the lightest record is replaced when it is full")
+    hot_lines_sample_rate = Param.Unsigned(1, "Profile roughly one in "
+        "this many addresses, chosen by hash")
     num_of_sequencers = Param.Int("")
     number_of_virtual_networks = Param.Unsigned("")
@@ -29,6 +29,7 @@
 #include "mem/ruby/system/Sequencer.hh"
 
 #include "arch/x86/ldstflags.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/str.hh"
 #include "cpu/testers/rubytest/RubyTester.hh"
@@ -52,8 +53,94 @@ RubySequencerParams::create()
     return new Sequencer(this);
 }
 
+void
+SequencerRequestTable::init(int max_entries)
+{
+    // keep the load factor at or below one half to keep probing short
+    const size_t capacity = std::max<size_t>(ceilPow2(2 * max_entries), 2);
+    slots.assign(capacity, Slot{0, NULL});
+    mask = capacity - 1;
+    used = 0;
+}
+
+size_t
+SequencerRequestTable::home(Addr line_addr) const
+{
+    // line addresses have their low bits cleared, so mix them in
+    // before masking
+    const uint64_t h = (line_addr >> RubySystem::getBlockSizeBits()) *
+        ULL(0x9e3779b97f4a7c15);
+    return (h >> 32) & mask;
+}
+
+size_t
+SequencerRequestTable::lookup(Addr line_addr) const
+{
+    size_t i = home(line_addr);
+    while (slots[i].request && slots[i].addr != line_addr)
+        i = (i + 1) & mask;
+    return i;
+}
+
+SequencerRequest *
+SequencerRequestTable::find(Addr line_addr) const
+{
+    return slots[lookup(line_addr)].request;
+}
+
+bool
+SequencerRequestTable::insert(Addr line_addr, SequencerRequest *request)
+{
+    assert(request);
+    const size_t i = lookup(line_addr);
+    if (slots[i].request)
+        return false;
+
+    assert(used < slots.size() - 1);
+    slots[i].addr = line_addr;
+    slots[i].request = request;
+    used++;
+    return true;
+}
+
+SequencerRequest *
+SequencerRequestTable::erase(Addr line_addr)
+{
+    size_t i = lookup(line_addr);
+    SequencerRequest *request = slots[i].request;
+    assert(request);
+    slots[i].request = NULL;
+    used--;
+
+    // shift back any following entries that would no longer be found
+    // across the hole we just created
+    for (size_t j = (i + 1) & mask; slots[j].request; j = (j + 1) & mask) {
+        const size_t k = home(slots[j].addr);
+        const bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+        if (!stays) {
+            slots[i] = slots[j];
+            slots[j].request = NULL;
+            i = j;
+        }
+    }
+
+    return request;
+}
+
+void
+SequencerRequestTable::print(ostream &out) const
+{
+    out << "[";
+    for (const auto &slot : slots) {
+        if (slot.request)
+            out << " " << slot.addr << "=" << slot.request;
+    }
+    out << " ]";
+}
+
 Sequencer::Sequencer(const Params *p)
-    : RubyPort(p), m_IncompleteTimes(MachineType_NUM),
+    : RubyPort(p), m_oldestRequest(NULL), m_youngestRequest(NULL),
+      m_IncompleteTimes(MachineType_NUM),
       deadlockCheckEvent([this]{ wakeup(); }, "Sequencer deadlock check")
 {
     m_outstanding_count = 0;
@@ -74,6 +161,12 @@ Sequencer::Sequencer(const Params *p)
     assert(m_inst_cache_hit_latency > 0);
 
     m_runningGarnetStandalone = p->garnet_standalone;
+
+    m_writeRequestTable.init(m_max_outstanding_requests);
+    m_readRequestTable.init(m_max_outstanding_requests);
+    m_requestPool.resize(m_max_outstanding_requests);
+    for (auto &request : m_requestPool)
+        m_freeRequests.push_back(&request);
 }
 
 Sequencer::~Sequencer()
@@ -88,43 +181,27 @@ Sequencer::wakeup()
     // Check for deadlock of any of the requests
     Cycles current_time = curCycle();
 
-    // Check across all outstanding requests
-    int total_outstanding = 0;
-
-    RequestTable::iterator read = m_readRequestTable.begin();
-    RequestTable::iterator read_end = m_readRequestTable.end();
-    for (; read != read_end; ++read) {
-        SequencerRequest* request = read->second;
-        if (current_time - request->issue_time < m_deadlock_threshold)
-            continue;
-
+    // Requests are kept in order of issue, so it is enough to check
+    // the oldest one
+    SequencerRequest* request = m_oldestRequest;
+    if (request &&
+        current_time - request->issue_time >= m_deadlock_threshold) {
+        const bool is_read =
+            m_readRequestTable.find(makeLineAddress(request->pkt->getAddr()))
+            == request;
         panic("Possible Deadlock detected. Aborting!\n"
-              "version: %d request.paddr: 0x%x m_readRequestTable: %d "
+              "version: %d request.paddr: 0x%x %s: %d "
               "current time: %u issue_time: %d difference: %d\n", m_version,
-              request->pkt->getAddr(), m_readRequestTable.size(),
+              request->pkt->getAddr(),
+              is_read ? "m_readRequestTable" : "m_writeRequestTable",
+              is_read ? m_readRequestTable.size() :
+              m_writeRequestTable.size(),
               current_time * clockPeriod(), request->issue_time * clockPeriod(),
               (current_time * clockPeriod()) - (request->issue_time * clockPeriod()));
     }
 
-    RequestTable::iterator write = m_writeRequestTable.begin();
-    RequestTable::iterator write_end = m_writeRequestTable.end();
-    for (; write != write_end; ++write) {
-        SequencerRequest* request = write->second;
-        if (current_time - request->issue_time < m_deadlock_threshold)
-            continue;
-
-        panic("Possible Deadlock detected. Aborting!\n"
-              "version: %d request.paddr: 0x%x m_writeRequestTable: %d "
-              "current time: %u issue_time: %d difference: %d\n", m_version,
-              request->pkt->getAddr(), m_writeRequestTable.size(),
-              current_time * clockPeriod(), request->issue_time * clockPeriod(),
-              (current_time * clockPeriod()) - (request->issue_time * clockPeriod()));
-    }
-
-    total_outstanding += m_writeRequestTable.size();
-    total_outstanding += m_readRequestTable.size();
-
-    assert(m_outstanding_count == total_outstanding);
+    assert(m_outstanding_count ==
+           m_writeRequestTable.size() + m_readRequestTable.size());
 
     if (m_outstanding_count > 0) {
         // If there are still outstanding requests, keep checking
@@ -185,11 +262,6 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
         return RequestStatus_Aliased;
     }
 
-    // Create a default entry, mapping the address to NULL, the cast is
-    // there to make gcc 4.4 happy
-    RequestTable::value_type default_entry(line_addr,
-                                           (SequencerRequest*) NULL);
-
     if ((request_type == RubyRequestType_ST) ||
         (request_type == RubyRequestType_RMW_Read) ||
         (request_type == RubyRequestType_RMW_Write) ||
@@ -206,11 +278,9 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
             return RequestStatus_Aliased;
         }
 
-        pair<RequestTable::iterator, bool> r =
-            m_writeRequestTable.insert(default_entry);
-        if (r.second) {
-            RequestTable::iterator i = r.first;
-            i->second = new SequencerRequest(pkt, request_type, curCycle());
+        if (!m_writeRequestTable.count(line_addr)) {
+            m_writeRequestTable.insert(line_addr,
+                                       allocRequest(pkt, request_type));
             m_outstanding_count++;
         } else {
           // There is an outstanding write request for the cache line
@@ -225,12 +295,9 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
             return RequestStatus_Aliased;
         }
 
-        pair<RequestTable::iterator, bool> r =
-            m_readRequestTable.insert(default_entry);
-
-        if (r.second) {
-            RequestTable::iterator i = r.first;
-            i->second = new SequencerRequest(pkt, request_type, curCycle());
+        if (!m_readRequestTable.count(line_addr)) {
+            m_readRequestTable.insert(line_addr,
+                                      allocRequest(pkt, request_type));
             m_outstanding_count++;
         } else {
             // There is an outstanding read request for the cache line
@@ -246,6 +313,48 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
     return RequestStatus_Ready;
 }
 
+SequencerRequest *
+Sequencer::allocRequest(PacketPtr pkt, RubyRequestType type)
+{
+    assert(!m_freeRequests.empty());
+    SequencerRequest *request = m_freeRequests.back();
+    m_freeRequests.pop_back();
+
+    request->pkt = pkt;
+    request->m_type = type;
+    request->issue_time = curCycle();
+
+    // issue times never decrease, so appending keeps the list sorted
+    assert(!m_youngestRequest ||
+           m_youngestRequest->issue_time <= request->issue_time);
+    request->older = m_youngestRequest;
+    request->younger = NULL;
+    if (m_youngestRequest)
+        m_youngestRequest->younger = request;
+    else
+        m_oldestRequest = request;
+    m_youngestRequest = request;
+
+    return request;
+}
+
+void
+Sequencer::releaseRequest(SequencerRequest *request)
+{
+    if (request->older)
+        request->older->younger = request->younger;
+    else
+        m_oldestRequest = request->younger;
+    if (request->younger)
+        request->younger->older = request->older;
+    else
+        m_youngestRequest = request->older;
+
+    request->pkt = NULL;
+    request->older = request->younger = NULL;
+    m_freeRequests.push_back(request);
+}
+
 void
 Sequencer::markRemoved()
 {
@@ -367,11 +476,7 @@ Sequencer::writeCallback(Addr address, DataBlock& data,
     assert(address == makeLineAddress(address));
     assert(m_writeRequestTable.count(makeLineAddress(address)));
 
-    RequestTable::iterator i = m_writeRequestTable.find(address);
-    assert(i != m_writeRequestTable.end());
-    SequencerRequest* request = i->second;
-
-    m_writeRequestTable.erase(i);
+    SequencerRequest* request = m_writeRequestTable.erase(address);
     markRemoved();
 
     assert((request->m_type == RubyRequestType_ST) ||
@@ -422,11 +527,7 @@ Sequencer::readCallback(Addr address, DataBlock& data,
     assert(address == makeLineAddress(address));
     assert(m_readRequestTable.count(makeLineAddress(address)));
 
-    RequestTable::iterator i = m_readRequestTable.find(address);
-    assert(i != m_readRequestTable.end());
-    SequencerRequest* request = i->second;
-
-    m_readRequestTable.erase(i);
+    SequencerRequest* request = m_readRequestTable.erase(address);
     markRemoved();
 
     assert((request->m_type == RubyRequestType_LD) ||
@@ -511,7 +612,7 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
         testerSenderState->subBlock.mergeFrom(data);
     }
 
-    delete srequest;
+    releaseRequest(srequest);
 
     RubySystem *rs = m_ruby_system;
     if (RubySystem::getWarmupEnabled()) {
@@ -641,13 +742,12 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
 
     // check if the packet has data as for example prefetch and flush
     // requests do not
-    std::shared_ptr<RubyRequest> msg =
-        std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
-                                      pkt->isFlush() ?
-                                      nullptr : pkt->getPtr<uint8_t>(),
-                                      pkt->getSize(), pc, secondary_type,
-                                      RubyAccessMode_Supervisor, pkt,
-                                      PrefetchBit_No, proc_id, core_id);
+    RefCountingPtr<RubyRequest> msg =
+        new RubyRequest(clockEdge(), pkt->getAddr(),
+                        pkt->isFlush() ? nullptr : pkt->getPtr<uint8_t>(),
+                        pkt->getSize(), pc, secondary_type,
+                        RubyAccessMode_Supervisor, pkt,
+                        PrefetchBit_No, proc_id, core_id);
 
     DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %#x %s\n",
             curTick(), m_version, "Seq", "Begin", "", "",
@@ -673,21 +773,6 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     m_mandatory_q_ptr->enqueue(msg, clockEdge(), cyclesToTicks(latency));
 }
 
-template <class KEY, class VALUE>
-std::ostream &
-operator<<(ostream &out, const std::unordered_map<KEY, VALUE> &map)
-{
-    auto i = map.begin();
-    auto end = map.end();
-
-    out << "[";
-    for (; i != end; ++i)
-        out << " " << i->first << "=" << i->second;
-    out << " ]";
-
-    return out;
-}
-
 void
 Sequencer::print(ostream& out) const
 {
@@ -30,7 +30,7 @@
 #define __MEM_RUBY_SYSTEM_SEQUENCER_HH__
 
 #include <iostream>
-#include <unordered_map>
+#include <vector>
 
 #include "mem/protocol/MachineType.hh"
 #include "mem/protocol/RubyRequestType.hh"
@@ -46,14 +46,76 @@ struct SequencerRequest
     RubyRequestType m_type;
     Cycles issue_time;
 
-    SequencerRequest(PacketPtr _pkt, RubyRequestType _m_type,
-                     Cycles _issue_time)
-        : pkt(_pkt), m_type(_m_type), issue_time(_issue_time)
+    //! Neighbours in the list of outstanding requests, oldest first
+    SequencerRequest *older;
+    SequencerRequest *younger;
+
+    SequencerRequest()
+        : pkt(NULL), m_type(RubyRequestType_NULL), issue_time(0),
+          older(NULL), younger(NULL)
     {}
 };
 
 std::ostream& operator<<(std::ostream& out, const SequencerRequest& obj);
 
+/**
+ * Table of outstanding requests indexed by line address. The table is
+ * open addressed with linear probing, and is sized for the maximum
+ * number of outstanding requests when created, so that it never needs
+ * to grow or allocate.
+ */
+class SequencerRequestTable
+{
+  public:
+    SequencerRequestTable() : mask(0), used(0) {}
+
+    /** Size the table for at most max_entries requests. */
+    void init(int max_entries);
+
+    SequencerRequest *find(Addr line_addr) const;
+    size_t count(Addr line_addr) const { return find(line_addr) != NULL; }
+
+    /**
+     * Insert a request for a line.
+     *
+     * @return false if there is already a request for the line
+     */
+    bool insert(Addr line_addr, SequencerRequest *request);
+
+    /**
+     * Remove the request for a line, which must be present.
+     *
+     * @return the request that was removed
+     */
+    SequencerRequest *erase(Addr line_addr);
+
+    size_t size() const { return used; }
+    bool empty() const { return used == 0; }
+
+    void print(std::ostream& out) const;
+
+  private:
+    struct Slot
+    {
+        Addr addr;
+        SequencerRequest *request; //!< NULL if the slot is free
+    };
+
+    size_t home(Addr line_addr) const;
+    size_t lookup(Addr line_addr) const;
+
+    std::vector<Slot> slots;
+    size_t mask;
+    size_t used;
+};
+
+inline std::ostream&
+operator<<(std::ostream& out, const SequencerRequestTable& obj)
+{
+    obj.print(out);
+    return out;
+}
+
 class Sequencer : public RubyPort
 {
   public:
@@ -166,6 +228,18 @@ class Sequencer : public RubyPort
                            Cycles completionTime);
 
     RequestStatus insertRequest(PacketPtr pkt, RubyRequestType request_type);
+
+    /**
+     * Take a request from the pool and append it to the list of
+     * outstanding requests.
+     */
+    SequencerRequest *allocRequest(PacketPtr pkt, RubyRequestType type);
+
+    /**
+     * Remove a request from the list of outstanding requests and
+     * return it to the pool.
+     */
+    void releaseRequest(SequencerRequest *request);
     bool handleLlsc(Addr address, SequencerRequest* request);
 
     // Private copy constructor and assignment operator
@@ -186,9 +260,18 @@ class Sequencer : public RubyPort
     Cycles m_data_cache_hit_latency;
     Cycles m_inst_cache_hit_latency;
 
-    typedef std::unordered_map<Addr, SequencerRequest*> RequestTable;
+    typedef SequencerRequestTable RequestTable;
     RequestTable m_writeRequestTable;
     RequestTable m_readRequestTable;
+
+    //! Storage for m_max_outstanding_requests requests
+    std::vector<SequencerRequest> m_requestPool;
+    std::vector<SequencerRequest*> m_freeRequests;
+
+    //! Outstanding requests in order of issue, which makes the oldest
+    //! one, and thus the deadlock check, available in constant time
+    SequencerRequest *m_oldestRequest;
+    SequencerRequest *m_youngestRequest;
     // Global outstanding request count, across all request tables
     int m_outstanding_count;
     bool m_deadlock_check_scheduled;
@@ -82,3 +82,5 @@ class DMASequencer(RubyPort):
    type = 'DMASequencer'
    cxx_header = "mem/ruby/system/DMASequencer.hh"
    max_outstanding_requests = Param.Int(64, "max outstanding requests")
+   max_outstanding_lines = Param.Int(8,
+       "max cache lines in flight for each outstanding request")
@@ -44,6 +44,7 @@
 
 #include "mem/se_translating_port_proxy.hh"
 
+#include <cstring>
 #include <string>
 
 #include "arch/isa_traits.hh"
@@ -64,6 +65,15 @@ SETranslatingPortProxy::SETranslatingPortProxy(MasterPort& port, Process *p,
 SETranslatingPortProxy::~SETranslatingPortProxy()
 { }
 
+uint8_t *
+SETranslatingPortProxy::hostAddr(Addr paddr, int size) const
+{
+    System *system = process->system;
+    if (!system->directMemoryAccess())
+        return nullptr;
+    return system->getPhysMem().hostAddr(paddr, size);
+}
+
 bool
 SETranslatingPortProxy::tryReadBlob(Addr addr, uint8_t *p, int size) const
 {
@@ -72,10 +82,17 @@ SETranslatingPortProxy::tryReadBlob(Addr addr, uint8_t *p, int size) const
     for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
         Addr paddr;
 
-        if (!pTable->translate(gen.addr(),paddr))
-            return false;
+        // Pages of file mappings are populated on first touch
+        if (!pTable->translate(gen.addr(), paddr)) {
+            if (!process->fixupFault(gen.addr()))
+                return false;
+            pTable->translate(gen.addr(), paddr);
+        }
 
-        PortProxy::readBlobPhys(paddr, 0, p + prevSize, gen.size());
+        if (uint8_t *host = hostAddr(paddr, gen.size()))
+            std::memcpy(p + prevSize, host, gen.size());
+        else
+            PortProxy::readBlobPhys(paddr, 0, p + prevSize, gen.size());
         prevSize += gen.size();
     }
 
@@ -100,21 +117,24 @@ SETranslatingPortProxy::tryWriteBlob(Addr addr, const uint8_t *p,
         Addr paddr;
 
         if (!pTable->translate(gen.addr(), paddr)) {
-            if (allocating == Always) {
+            if (process->fixupFault(gen.addr())) {
+                // a stack or file mapping page that wasn't populated yet
+            } else if (allocating == Always) {
                 process->allocateMem(roundDown(gen.addr(), PageBytes),
                                      PageBytes);
             } else if (allocating == NextPage) {
-                // check if we've accessed the next page on the stack
-                if (!process->fixupStackFault(gen.addr()))
-                    panic("Page table fault when accessing virtual address %#x "
-                            "during functional write\n", gen.addr());
+                panic("Page table fault when accessing virtual address %#x "
+                        "during functional write\n", gen.addr());
             } else {
                 return false;
             }
             pTable->translate(gen.addr(), paddr);
         }
 
-        PortProxy::writeBlobPhys(paddr, 0, p + prevSize, gen.size());
+        if (uint8_t *host = hostAddr(paddr, gen.size()))
+            std::memcpy(host, p + prevSize, gen.size());
+        else
+            PortProxy::writeBlobPhys(paddr, 0, p + prevSize, gen.size());
         prevSize += gen.size();
     }
 
@@ -136,16 +156,21 @@ SETranslatingPortProxy::tryMemsetBlob(Addr addr, uint8_t val, int size) const
         Addr paddr;
 
         if (!pTable->translate(gen.addr(), paddr)) {
-            if (allocating == Always) {
+            if (process->fixupFault(gen.addr())) {
+                // a stack or file mapping page that wasn't populated yet
+            } else if (allocating == Always) {
                 process->allocateMem(roundDown(gen.addr(), PageBytes),
                                      PageBytes);
-                pTable->translate(gen.addr(), paddr);
             } else {
                 return false;
             }
+            pTable->translate(gen.addr(), paddr);
         }
 
-        PortProxy::memsetBlobPhys(paddr, 0, val, gen.size());
+        if (uint8_t *host = hostAddr(paddr, gen.size()))
+            std::memset(host, val, gen.size());
+        else
+            PortProxy::memsetBlobPhys(paddr, 0, val, gen.size());
     }
 
     return true;
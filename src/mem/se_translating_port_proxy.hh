@@ -79,6 +79,14 @@ class SETranslatingPortProxy : public PortProxy
     Process *process;
     AllocType allocating;
 
+    /**
+     * Get a host pointer to a range of physical memory within a page
+     * if the system lets us bypass the memory system.
+     *
+     * @return The host pointer, or nullptr to use a functional access
+     */
+    uint8_t *hostAddr(Addr paddr, int size) const;
+
   public:
     SETranslatingPortProxy(MasterPort& port, Process* p, AllocType alloc);
     ~SETranslatingPortProxy();
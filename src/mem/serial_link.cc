@@ -65,7 +65,7 @@ SerialLink::SerialLinkSlavePort::SerialLinkSlavePort(const std::string& _name,
     : SlavePort(_name, &_serial_link), serial_link(_serial_link),
       masterPort(_masterPort), delay(_delay),
       ranges(_ranges.begin(), _ranges.end()),
-      outstandingResponses(0), retryReq(false),
+      outstandingResponses(0), retryReq(false), retryReqNeedsResp(false),
       respQueueLimit(_resp_limit),
       sendEvent([this]{ trySendTiming(); }, _name)
 {
@@ -231,15 +231,26 @@ SerialLink::SerialLinkSlavePort::recvTimingReq(PacketPtr pkt)
 
     // remember that we are now stalling a packet and that we have to
     // tell the sending master to retry once space becomes available,
-    // we make no distinction whether the stalling is due to the
-    // request queue or response queue being full
+    // which for requests expecting a response means space in both
+    // queues
+    if (retryReq)
+        retryReqNeedsResp = pkt->needsResponse() && !pkt->cacheResponding();
+
     return !retryReq;
 }
 
+bool
+SerialLink::SerialLinkSlavePort::tryTiming(PacketPtr pkt)
+{
+    bool expects_response = pkt->needsResponse() && !pkt->cacheResponding();
+    return !retryReq && !masterPort.reqQueueFull() &&
+        (!expects_response || !respQueueFull());
+}
+
 void
 SerialLink::SerialLinkSlavePort::retryStalledReq()
 {
-    if (retryReq) {
+    if (retryReq && (!retryReqNeedsResp || !respQueueFull())) {
         DPRINTF(SerialLink, "Request waiting for retry, now retrying\n");
         retryReq = false;
         sendRetryReq();
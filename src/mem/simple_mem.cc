@@ -44,7 +44,6 @@
 
 #include "mem/simple_mem.hh"
 
-#include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/Drain.hh"
 
@@ -53,7 +52,8 @@ using namespace std;
 SimpleMemory::SimpleMemory(const SimpleMemoryParams* p) :
     AbstractMemory(p),
     port(name() + ".port", *this), latency(p->latency),
-    latency_var(p->latency_var), bandwidth(p->bandwidth), isBusy(false),
+    latency_var(p->latency_var), rng(name()), bandwidth(p->bandwidth),
+    isBusy(false),
     retryReq(false), retryResp(false),
     releaseEvent([this]{ release(); }, name()),
     dequeueEvent([this]{ dequeue(); }, name())
@@ -222,7 +222,7 @@ Tick
 SimpleMemory::getLatency() const
 {
     return latency +
-        (latency_var ? random_mt.random<Tick>(0, latency_var) : 0);
+        (latency_var ? rng.random<Tick>(0, latency_var) : 0);
 }
 
 void
@@ -51,6 +51,7 @@
 
 #include <list>
 
+#include "base/random.hh"
 #include "mem/abstract_mem.hh"
 #include "mem/port.hh"
 #include "params/SimpleMemory.hh"
@@ -120,6 +121,11 @@ class SimpleMemory : public AbstractMemory
      */
     const Tick latency_var;
 
+    /**
+     * Random numbers for the latency fudge factor.
+     */
+    mutable RandomStream rng;
+
     /**
      * Internal (unbounded) storage to mimic the delay caused by the
      * actual memory access. Note that this is where the packet spends
@@ -213,7 +213,7 @@ class StateMachine(Symbol):
         self.printControllerPython(path)
         self.printControllerHH(path)
         self.printControllerCC(path, includes)
-        self.printCSwitch(path)
+        self.printCSwitch(path, includes)
         self.printCWakeup(path, includes)
 
     def printControllerPython(self, path):
@@ -313,12 +313,16 @@ class $c_ident : public AbstractController
     GPUCoalescer* getGPUCoalescer() const;
 
     int functionalWriteBuffers(PacketPtr&);
+    bool canIndexLines() const override;
+    bool canWarmupLines() const override;
 
     void countTransition(${ident}_State state, ${ident}_Event event);
     void possibleTransition(${ident}_State state, ${ident}_Event event);
     uint64_t getEventCount(${ident}_Event event);
     bool isPossible(${ident}_State state, ${ident}_Event event);
     uint64_t getTransitionCount(${ident}_State state, ${ident}_Event event);
+    double getTransitionHostTime(${ident}_State state,
+                                 ${ident}_Event event);
 
 private:
 ''')
@@ -367,9 +371,12 @@ TransitionResult doTransitionWorker(${ident}_Event event,
 int m_counters[${ident}_State_NUM][${ident}_Event_NUM];
 int m_event_counters[${ident}_Event_NUM];
 bool m_possible[${ident}_State_NUM][${ident}_Event_NUM];
+// Host seconds spent in each transition, if profile_transitions is set
+double m_transition_host_time[${ident}_State_NUM][${ident}_Event_NUM];
 
 static std::vector<Stats::Vector *> eventVec;
 static std::vector<std::vector<Stats::Vector *> > transVec;
+static std::vector<std::vector<Stats::Vector *> > transTimeVec;
 static int m_num_controllers;
 
 // Internal functions
@@ -501,6 +508,7 @@ ${c_ident}Params::create()
 int $c_ident::m_num_controllers = 0;
 std::vector<Stats::Vector *>  $c_ident::eventVec;
 std::vector<std::vector<Stats::Vector *> >  $c_ident::transVec;
+std::vector<std::vector<Stats::Vector *> >  $c_ident::transTimeVec;
 
 // for adding information to the protocol debug trace
 stringstream ${ident}_transitionComment;
@@ -549,6 +557,7 @@ for (int state = 0; state < ${ident}_State_NUM; state++) {
     for (int event = 0; event < ${ident}_Event_NUM; event++) {
         m_possible[state][event] = false;
         m_counters[state][event] = 0;
+        m_transition_host_time[state][event] = 0;
     }
 }
 for (int event = 0; event < ${ident}_Event_NUM; event++) {
@@ -772,6 +781,28 @@ $c_ident::regStats()
                 transVec[state].push_back(t);
             }
         }
+
+        if (m_profile_transitions) {
+            for (${ident}_State state = ${ident}_State_FIRST;
+                 state < ${ident}_State_NUM; ++state) {
+
+                transTimeVec.push_back(std::vector<Stats::Vector *>());
+
+                for (${ident}_Event event = ${ident}_Event_FIRST;
+                     event < ${ident}_Event_NUM; ++event) {
+
+                    Stats::Vector *t = new Stats::Vector();
+                    t->init(m_num_controllers);
+                    t->name(params()->ruby_system->name() + ".${c_ident}." +
+                            ${ident}_State_to_string(state) +
+                            "." + ${ident}_Event_to_string(event) +
+                            ".host_seconds");
+                    t->desc("host seconds spent in this transition");
+                    t->flags(Stats::total | Stats::oneline | Stats::nozero);
+                    transTimeVec[state].push_back(t);
+                }
+            }
+        }
     }
 }
 
@@ -806,6 +837,20 @@ $c_ident::collateStats()
             }
         }
     }
+
+    for (int state = 0; state < transTimeVec.size(); ++state) {
+        for (int event = 0; event < transTimeVec[state].size(); ++event) {
+            for (unsigned int i = 0; i < m_num_controllers; ++i) {
+                RubySystem *rs = params()->ruby_system;
+                std::map<uint32_t, AbstractController *>::iterator it =
+                         rs->m_abstract_controls[MachineType_${ident}].find(i);
+                assert(it != rs->m_abstract_controls[MachineType_${ident}].end());
+                (*transTimeVec[state][event])[i] =
+                    (($c_ident *)(*it).second)->getTransitionHostTime(
+                        (${ident}_State)state, (${ident}_Event)event);
+            }
+        }
+    }
 }
 
 void
@@ -841,6 +886,13 @@ $c_ident::getTransitionCount(${ident}_State state,
     return m_counters[state][event];
 }
 
+double
+$c_ident::getTransitionHostTime(${ident}_State state,
+                                ${ident}_Event event)
+{
+    return m_transition_host_time[state][event];
+}
+
 int
 $c_ident::getNumControllers()
 {
@@ -870,6 +922,7 @@ void $c_ident::resetStats()
     for (int state = 0; state < ${ident}_State_NUM; state++) {
         for (int event = 0; event < ${ident}_Event_NUM; event++) {
             m_counters[state][event] = 0;
+            m_transition_host_time[state][event] = 0;
         }
     }
 
@@ -934,74 +987,38 @@ $c_ident::recordCacheTrace(int cntrl, CacheRecorder* tr)
         code('''
 }
 
-// Actions
-''')
-        if self.TBEType != None and self.EntryType != None:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
-void
-$c_ident::${{action.ident}}(${{self.TBEType.c_ident}}*& m_tbe_ptr, ${{self.EntryType.c_ident}}*& m_cache_entry_ptr, Addr addr)
+bool
+$c_ident::canIndexLines() const
 {
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    try {
-       ${{action["c_code"]}}
-    } catch (const RejectException & e) {
-       fatal("Error in action ${{ident}}:${{action.ident}}: "
-             "executed a peek statement with the wrong message "
-             "type specified. ");
-    }
-}
-
 ''')
-        elif self.TBEType != None:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
-void
-$c_ident::${{action.ident}}(${{self.TBEType.c_ident}}*& m_tbe_ptr, Addr addr)
-{
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    ${{action["c_code"]}}
+        # The permissions of cache controllers only change in transitions
+        # on the line itself, which makes it possible for the RubySystem
+        # to track the controllers that hold a line. Directories are
+        # always searched, since they hold every line in memory.
+        types = [ param.type_ast.type.ident
+                  for param in self.config_parameters ]
+        if "CacheMemory" in types and "DirectoryMemory" not in types:
+            code('    return true;')
+        else:
+            code('    return false;')
+        code('''
 }
 
-''')
-        elif self.EntryType != None:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
-void
-$c_ident::${{action.ident}}(${{self.EntryType.c_ident}}*& m_cache_entry_ptr, Addr addr)
+bool
+$c_ident::canWarmupLines() const
 {
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    ${{action["c_code"]}}
-}
-
 ''')
+        # Machines can restore a cache trace without replaying it if they
+        # define how to install a line in a stable state.
+        if [ func for func in self.functions
+             if func.c_name == "warmupLine" and "external" not in func ]:
+            code('    return true;')
         else:
-            for action in self.actions.itervalues():
-                if "c_code" not in action:
-                 continue
-
-                code('''
-/** \\brief ${{action.desc}} */
-void
-$c_ident::${{action.ident}}(Addr addr)
-{
-    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
-    ${{action["c_code"]}}
+            code('    return false;')
+        code('''
 }
-
 ''')
+
         for func in self.functions:
             code(func.generateCode())
 
@@ -1156,7 +1173,83 @@ ${ident}_Controller::wakeup()
 
         code.write(path, "%s_Wakeup.cc" % self.ident)
 
-    def printCSwitch(self, path):
+    def printActions(self, code):
+        '''Output the definitions of the actions'''
+
+        ident = self.ident
+        c_ident = "%s_Controller" % self.ident
+
+        code('''
+// Actions
+''')
+        if self.TBEType != None and self.EntryType != None:
+            for action in self.actions.itervalues():
+                if "c_code" not in action:
+                 continue
+
+                code('''
+/** \\brief ${{action.desc}} */
+void
+$c_ident::${{action.ident}}(${{self.TBEType.c_ident}}*& m_tbe_ptr, ${{self.EntryType.c_ident}}*& m_cache_entry_ptr, Addr addr)
+{
+    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
+    try {
+       ${{action["c_code"]}}
+    } catch (const RejectException & e) {
+       fatal("Error in action ${{ident}}:${{action.ident}}: "
+             "executed a peek statement with the wrong message "
+             "type specified. ");
+    }
+}
+
+''')
+        elif self.TBEType != None:
+            for action in self.actions.itervalues():
+                if "c_code" not in action:
+                 continue
+
+                code('''
+/** \\brief ${{action.desc}} */
+void
+$c_ident::${{action.ident}}(${{self.TBEType.c_ident}}*& m_tbe_ptr, Addr addr)
+{
+    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
+    ${{action["c_code"]}}
+}
+
+''')
+        elif self.EntryType != None:
+            for action in self.actions.itervalues():
+                if "c_code" not in action:
+                 continue
+
+                code('''
+/** \\brief ${{action.desc}} */
+void
+$c_ident::${{action.ident}}(${{self.EntryType.c_ident}}*& m_cache_entry_ptr, Addr addr)
+{
+    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
+    ${{action["c_code"]}}
+}
+
+''')
+        else:
+            for action in self.actions.itervalues():
+                if "c_code" not in action:
+                 continue
+
+                code('''
+/** \\brief ${{action.desc}} */
+void
+$c_ident::${{action.ident}}(Addr addr)
+{
+    DPRINTF(RubyGenerated, "executing ${{action.ident}}\\n");
+    ${{action["c_code"]}}
+}
+
+''')
+
+    def printCSwitch(self, path, includes):
         '''Output switch statement for transition table'''
 
         code = self.symtab.codeFormatter()
@@ -1167,22 +1260,57 @@ ${ident}_Controller::wakeup()
 // ${ident}: ${{self.short}}
 
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <typeinfo>
 
+#include "base/cprintf.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
-#include "debug/ProtocolTrace.hh"
-#include "debug/RubyGenerated.hh"
+''')
+        for f in sorted(self.debug_flags | set(['ProtocolTrace'])):
+            code('#include "debug/${{f}}.hh"')
+        code('''
 #include "mem/protocol/${ident}_Controller.hh"
 #include "mem/protocol/${ident}_Event.hh"
 #include "mem/protocol/${ident}_State.hh"
 #include "mem/protocol/Types.hh"
 #include "mem/ruby/system/RubySystem.hh"
 
+''')
+        # The actions are defined here, where they can be inlined into
+        # doTransitionWorker, so this file needs the includes of the
+        # controller.
+        for include_path in includes:
+            code('#include "${{include_path}}"')
+
+        seen_types = set()
+        for var in self.objects:
+            if var.type.ident not in seen_types and not var.type.isPrimitive:
+                code('#include "mem/protocol/${{var.type.c_ident}}.hh"')
+            seen_types.add(var.type.ident)
+
+        code('''
+
+using namespace std;
+
 #define HASH_FUN(state, event)  ((int(state)*${ident}_Event_NUM)+int(event))
 
 #define GET_TRANSITION_COMMENT() (${ident}_transitionComment.str())
 #define CLEAR_TRANSITION_COMMENT() (${ident}_transitionComment.str(""))
 
+#ifndef NDEBUG
+#define APPEND_TRANSITION_COMMENT(str) (${ident}_transitionComment << str)
+#else
+#define APPEND_TRANSITION_COMMENT(str) do {} while (0)
+#endif
+''')
+
+        self.printActions(code)
+
+        code('''
 TransitionResult
 ${ident}_Controller::doTransition(${ident}_Event event,
 ''')
@@ -1216,16 +1344,28 @@ DPRINTF(RubyGenerated, "%s, Time: %lld, state: %s, event: %s, addr: %#x\\n",
         *this, curCycle(), ${ident}_State_to_string(state),
         ${ident}_Event_to_string(event), addr);
 
-TransitionResult result =
 ''')
         if self.TBEType != None and self.EntryType != None:
-            code('doTransitionWorker(event, state, next_state, m_tbe_ptr, m_cache_entry_ptr, addr);')
+            worker = 'doTransitionWorker(event, state, next_state, m_tbe_ptr, m_cache_entry_ptr, addr)'
         elif self.TBEType != None:
-            code('doTransitionWorker(event, state, next_state, m_tbe_ptr, addr);')
+            worker = 'doTransitionWorker(event, state, next_state, m_tbe_ptr, addr)'
         elif self.EntryType != None:
-            code('doTransitionWorker(event, state, next_state, m_cache_entry_ptr, addr);')
+            worker = 'doTransitionWorker(event, state, next_state, m_cache_entry_ptr, addr)'
         else:
-            code('doTransitionWorker(event, state, next_state, addr);')
+            worker = 'doTransitionWorker(event, state, next_state, addr)'
+
+        code('''
+TransitionResult result;
+if (m_profile_transitions) {
+    auto start = std::chrono::steady_clock::now();
+    result = $worker;
+    std::chrono::duration<double> host_time =
+        std::chrono::steady_clock::now() - start;
+    m_transition_host_time[state][event] += host_time.count();
+} else {
+    result = $worker;
+}
+''')
 
         port_to_buf_map, in_msg_bufs, msg_bufs = self.getBufferMaps(ident)
 
@@ -1257,6 +1397,7 @@ if (result == TransitionResult_Valid) {
         else:
             code('setState(addr, next_state);')
             code('setAccessPermission(addr, next_state);')
+        code('updateLineIndex(addr);')
 
         code('''
 } else if (result == TransitionResult_ResourceStall) {
@@ -1299,8 +1440,8 @@ ${ident}_Controller::doTransitionWorker(${ident}_Event event,
         code('''
                                         Addr addr)
 {
-    switch(HASH_FUN(state, event)) {
 ''')
+        code.indent()
 
         # This map will allow suppress generating duplicate code
         cases = orderdict()
@@ -1388,23 +1529,54 @@ if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
 
             cases[case].append(case_string)
 
+        # Number the unique code blocks from 1 and look the transitions
+        # up in a table of block numbers, which keeps the jump table of
+        # the switch down to one entry per block. 0 is an invalid
+        # transition.
+        index_type = "uint8_t" if len(cases) < 256 else "uint16_t"
+        code('''
+// The code block of each (state, event) pair, 0 if there is none
+struct TransitionTable
+{
+    $index_type block[${ident}_State_NUM * ${ident}_Event_NUM];
+
+    TransitionTable()
+        : block()
+    {
+''')
+        code.indent()
+        code.indent()
+        for block, (case, transitions) in enumerate(cases.iteritems()):
+            for trans in transitions:
+                code('block[HASH_FUN($trans)] = ${{block + 1}};')
+        code.dedent()
+        code.dedent()
+        code('''
+    }
+};
+
+static const TransitionTable table;
+
+switch (table.block[HASH_FUN(state, event)]) {
+''')
+
         # Walk through all of the unique code blocks and spit out the
         # corresponding case statement elements
-        for case,transitions in cases.iteritems():
-            # Iterative over all the multiple transitions that share
-            # the same code
-            for trans in transitions:
-                code('  case HASH_FUN($trans):')
+        for block, (case, transitions) in enumerate(cases.iteritems()):
+            code('  case ${{block + 1}}: // ${{transitions[0]}}')
             code('    $case\n')
 
         code('''
-      default:
-        panic("Invalid transition\\n"
-              "%s time: %d addr: %s event: %s state: %s\\n",
-              name(), curCycle(), addr, event, state);
-    }
+  default:
+    panic("Invalid transition\\n"
+          "%s time: %d addr: %s event: %s state: %s\\n",
+          name(), curCycle(), addr, event, state);
+}
 
-    return TransitionResult_Valid;
+return TransitionResult_Valid;
+''')
+        code.dedent()
+        code('''
 }
 ''')
         code.write(path, "%s_Transitions.cc" % self.ident)
@@ -25,6 +25,8 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+import re
+
 from m5.util import orderdict
 
 from slicc.util import PairContainer
@@ -287,10 +289,20 @@ $klass ${{self.c_ident}}$parent
         # create a clone member
         if self.isMessage:
             code('''
+typedef PoolAllocator<${{self.c_ident}}> Pool;
+
+static void *operator new(size_t size) { return Pool::allocate(size); }
+
+static void
+operator delete(void *p, size_t size)
+{
+    Pool::deallocate(p, size);
+}
+
 MsgPtr
 clone() const
 {
-     return std::shared_ptr<Message>(new ${{self.c_ident}}(*this));
+     return MsgPtr(new ${{self.c_ident}}(*this));
 }
 ''')
         else:
@@ -302,6 +314,10 @@ clone() const
 }
 ''')
 
+        if self.isMessage:
+            self.printFunctionalScope(code)
+            self.printLineAddr(code)
+
         if not self.isGlobal:
             # const Get methods for each field
             code('// Const accessors methods for each field')
@@ -392,6 +408,55 @@ operator<<(std::ostream& out, const ${{self.c_ident}}& obj)
 
         code.write(path, "%s.hh" % self.c_ident)
 
+    def printFunctionalScope(self, code):
+        '''Let message buffers filter functional writes if the
+        functionalWrite method only writes the data of a single line, or
+        never writes anything'''
+
+        func = None
+        for method in self.methods.itervalues():
+            if method.ident == "functionalWrite":
+                func = method
+        if func is None or func.body is None:
+            return
+
+        body = " ".join(str(func.body).split())
+        test = re.match(r"^return \(testAndWrite\(m_(\w+), m_DataBlk, "
+                        r"param_pkt\)\);$", body)
+        if test and test.group(1) in self.data_members and \
+           self.data_members[test.group(1)].type.c_ident == "Addr":
+            code('''
+Message::FunctionalScope
+functionalScope(Addr &line) const
+{
+    line = makeLineAddress(m_${{test.group(1)}});
+    return FunctionalLine;
+}
+''')
+        elif body == "return (false);":
+            code('''
+Message::FunctionalScope
+functionalScope(Addr &line) const
+{
+    return FunctionalNone;
+}
+''')
+
+    def printLineAddr(self, code):
+        '''Expose the line of messages that carry an address in a data
+        member named addr'''
+
+        dm = self.data_members.get("addr")
+        if dm is not None and dm.type.c_ident == "Addr":
+            code('''
+bool
+getLineAddr(Addr &line) const
+{
+    line = makeLineAddress(m_addr);
+    return true;
+}
+''')
+
     def printTypeCC(self, path):
         code = self.symtab.codeFormatter()
 
@@ -44,6 +44,8 @@
 
 #include "mem/snoop_filter.hh"
 
+#include <algorithm>
+
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
@@ -54,13 +56,61 @@ SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
 {
     SnoopItem& sf_item = sf_it->second;
     if (!(sf_item.requested | sf_item.holder)) {
+        if (assoc) {
+            auto& set = getSet(sf_it->first);
+            set.erase(std::find(set.begin(), set.end(), sf_it->first));
+        }
         cachedLocations.erase(sf_it);
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
     }
 }
 
-std::pair<SnoopFilter::SnoopList, Cycles>
+void
+SnoopFilter::touchEntry(Addr line_addr)
+{
+    auto& set = getSet(line_addr);
+    auto it = std::find(set.begin(), set.end(), line_addr);
+    assert(it != set.end());
+    std::rotate(it, it + 1, set.end());
+}
+
+void
+SnoopFilter::evictEntry(Addr line_addr)
+{
+    auto& set = getSet(line_addr);
+    if (set.size() < assoc)
+        return;
+
+    for (auto it = set.begin(); it != set.end(); ++it) {
+        auto sf_it = cachedLocations.find(*it);
+        assert(sf_it != cachedLocations.end());
+        const SnoopItem& sf_item = sf_it->second;
+
+        // lines with requests in flight have to stay until the
+        // responses are seen
+        if (sf_item.requested)
+            continue;
+
+        DPRINTF(SnoopFilter, "%s:   evicting line %#x SF value %x.%x\n",
+                __func__, *it, sf_item.requested, sf_item.holder);
+
+        evictions.push_back(Eviction{*it & ~Addr(LineSecure),
+                                     bool(*it & LineSecure),
+                                     maskToPortList(sf_item.holder)});
+        capacityEvictions++;
+
+        cachedLocations.erase(sf_it);
+        set.erase(it);
+        return;
+    }
+
+    DPRINTF(SnoopFilter, "%s:   no line to evict for %#x\n", __func__,
+            line_addr);
+    setOverflows++;
+}
+
+std::pair<SnoopFilter::SnoopPorts, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 {
     DPRINTF(SnoopFilter, "%s: src %s packet %s\n", __func__,
@@ -79,13 +129,21 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
-    // portlist.
-    if (!is_hit && !allocate)
+    // portlist. A bounded filter may also miss on an eviction of a
+    // line that it has evicted (and invalidated) itself.
+    if (!is_hit && (!allocate || (assoc && !cpkt->needsResponse())))
         return snoopDown(lookupLatency);
 
     // If no hit in snoop filter create a new element and update iterator
-    if (!is_hit)
+    if (!is_hit) {
+        if (assoc)
+            evictEntry(line_addr);
         reqLookupResult = cachedLocations.emplace(line_addr, SnoopItem()).first;
+        if (assoc)
+            getSet(line_addr).push_back(line_addr);
+    } else if (assoc && allocate) {
+        touchEntry(line_addr);
+    }
     SnoopItem& sf_item = reqLookupResult->second;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
@@ -133,6 +191,11 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
         }
     } else { // if (!cpkt->needsResponse())
         assert(cpkt->isEviction());
+        // the line may have been evicted and allocated again since the
+        // sender dropped it, in which case it is no longer a holder
+        if (assoc && !(sf_item.holder & req_port))
+            return snoopSelected(maskToPortList(interested & ~req_port),
+                                 lookupLatency);
         // make sure that the sender actually had the line
         panic_if(!(sf_item.holder & req_port), "requester %x is not a " \
                  "holder :( SF value %x.%x\n", req_port,
@@ -174,7 +237,7 @@ SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
     }
 }
 
-std::pair<SnoopFilter::SnoopList, Cycles>
+std::pair<SnoopFilter::SnoopPorts, Cycles>
 SnoopFilter::lookupSnoop(const Packet* cpkt)
 {
     DPRINTF(SnoopFilter, "%s: packet %s\n", __func__, cpkt->print());
@@ -188,7 +251,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     auto sf_it = cachedLocations.find(line_addr);
     bool is_hit = (sf_it != cachedLocations.end());
 
-    panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
+    panic_if(!assoc && !is_hit && (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
              maxEntryCount);
 
@@ -414,6 +477,18 @@ SnoopFilter::regStats()
         .name(name() + ".hit_multi_snoops")
         .desc("Number of snoops hitting in the snoop filter with multiple "\
               "(>1) holders of the requested data.");
+
+    capacityEvictions
+        .name(name() + ".capacity_evictions")
+        .desc("Number of lines evicted, and invalidated above, to make "\
+              "room for new lines.")
+        .flags(Stats::nozero);
+
+    setOverflows
+        .name(name() + ".set_overflows")
+        .desc("Number of times a set exceeded its associativity as all "\
+              "its lines had requests in flight.")
+        .flags(Stats::nozero);
 }
 
 SnoopFilter *
@@ -47,7 +47,9 @@
 
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "base/bitfield.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "mem/qport.hh"
@@ -82,17 +84,96 @@
  * (3) there are no clean evict messages telling the snoop filter that a local,
  *     upper cache dropped a line, making the snoop filter pessimistic for now
  * (4) ordering: there is no single point of order in the system.  Instead,
- *     requesting MSHRs track order between local requests and remote snoops
+ *     requesting MSHRs track order between local requests and remote snoops *
+ * By default the filter is unbounded. With a non-zero associativity
+ * it is organised in sets of a fixed size, and a new line may evict
+ * the least recently used line of its set that has no requests in
+ * flight. The crossbar then invalidates the copies of the evicted
+ * line above (see takeEvictions()), as an inclusive directory would.
  */
 class SnoopFilter : public SimObject {
   public:
     typedef std::vector<QueuedSlavePort*> SnoopList;
 
+    /**
+     * The underlying type for the bitmask we use for tracking. This
+     * limits the number of snooping ports supported per crossbar. For
+     * the moment it is an uint64_t to offer maximum
+     * scalability. However, it is possible to use e.g. a uint16_t or
+     * uint32_to slim down the footprint of the hash map (and
+     * ultimately improve the simulation performance).
+     */
+    typedef uint64_t SnoopMask;
+
+    /**
+     * The snooping ports selected by a bitmask. Iterating over the
+     * selection visits the ports in the order of their bits, without
+     * building a list of the ports.
+     */
+    class SnoopPorts
+    {
+      public:
+        class const_iterator
+        {
+          public:
+            const_iterator(const SnoopList& ports, SnoopMask mask)
+                : ports(&ports), mask(mask)
+            {}
+
+            QueuedSlavePort* operator*() const
+            {
+                return (*ports)[findLsbSet(mask)];
+            }
+
+            const_iterator& operator++()
+            {
+                // clear the lowest bit that is set
+                mask &= mask - 1;
+                return *this;
+            }
+
+            bool operator==(const const_iterator& other) const
+            {
+                return mask == other.mask;
+            }
+
+            bool operator!=(const const_iterator& other) const
+            {
+                return mask != other.mask;
+            }
+
+          private:
+            const SnoopList* ports;
+            SnoopMask mask;
+        };
+
+        SnoopPorts(const SnoopList& ports, SnoopMask mask)
+            : ports(&ports), mask(mask)
+        {}
+
+        const_iterator begin() const { return const_iterator(*ports, mask); }
+        const_iterator end() const { return const_iterator(*ports, 0); }
+
+        bool empty() const { return !mask; }
+        size_t size() const { return popCount(mask); }
+
+      private:
+        const SnoopList* ports;
+        SnoopMask mask;
+    };
+
     SnoopFilter (const SnoopFilterParams *p) :
         SimObject(p), reqLookupResult(cachedLocations.end()), retryItem{0, 0},
         linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency),
-        maxEntryCount(p->max_capacity / p->system->cacheLineSize())
+        maxEntryCount(p->max_capacity / p->system->cacheLineSize()),
+        assoc(p->assoc), numSets(assoc ? maxEntryCount / assoc : 0),
+        sets(numSets)
     {
+        fatal_if(assoc && !numSets,
+                 "Snoop filter capacity of %d lines is below its "
+                 "associativity %d\n", maxEntryCount, assoc);
+        for (auto& set : sets)
+            set.reserve(assoc);
     }
 
     /**
@@ -131,7 +212,7 @@ class SnoopFilter : public SimObject {
      * @param slave_port    Slave port where the request came from.
      * @return Pair of a vector of snoop target ports and lookup latency.
      */
-    std::pair<SnoopList, Cycles> lookupRequest(const Packet* cpkt,
+    std::pair<SnoopPorts, Cycles> lookupRequest(const Packet* cpkt,
                                                const SlavePort& slave_port);
 
     /**
@@ -154,7 +235,7 @@ class SnoopFilter : public SimObject {
      * @return Pair with a vector of SlavePorts that need snooping and a lookup
      *         latency.
      */
-    std::pair<SnoopList, Cycles> lookupSnoop(const Packet* cpkt);
+    std::pair<SnoopPorts, Cycles> lookupSnoop(const Packet* cpkt);
 
     /**
      * Let the snoop filter see any snoop responses that turn into
@@ -192,19 +273,32 @@ class SnoopFilter : public SimObject {
      */
     void updateResponse(const Packet *cpkt, const SlavePort& slave_port);
 
-    virtual void regStats();
-
-  protected:
+    /**
+     * A line evicted from a bounded snoop filter, the copies held
+     * above the listed ports have to be invalidated.
+     */
+    struct Eviction {
+        Addr addr;
+        bool isSecure;
+        SnoopPorts holders;
+    };
 
     /**
-     * The underlying type for the bitmask we use for tracking. This
-     * limits the number of snooping ports supported per crossbar. For
-     * the moment it is an uint64_t to offer maximum
-     * scalability. However, it is possible to use e.g. a uint16_t or
-     * uint32_to slim down the footprint of the hash map (and
-     * ultimately improve the simulation performance).
+     * Get the lines evicted to make room for new entries since the
+     * last call. Only a bounded snoop filter evicts lines.
+     *
+     * @return The evicted lines
      */
-    typedef uint64_t SnoopMask;
+    std::vector<Eviction> takeEvictions()
+    {
+        std::vector<Eviction> res;
+        res.swap(evictions);
+        return res;
+    }
+
+    virtual void regStats();
+
+  protected:
 
     /**
     * Per cache line item tracking a bitmask of SlavePorts who have an
@@ -223,19 +317,19 @@ class SnoopFilter : public SimObject {
     /**
      * Simple factory methods for standard return values.
      */
-    std::pair<SnoopList, Cycles> snoopAll(Cycles latency) const
+    std::pair<SnoopPorts, Cycles> snoopAll(Cycles latency) const
     {
-        return std::make_pair(slavePorts, latency);
+        return std::make_pair(maskToPortList(mask(slavePorts.size())),
+                              latency);
     }
-    std::pair<SnoopList, Cycles> snoopSelected(const SnoopList& slave_ports,
-                                               Cycles latency) const
+    std::pair<SnoopPorts, Cycles> snoopSelected(const SnoopPorts& slave_ports,
+                                                Cycles latency) const
     {
         return std::make_pair(slave_ports, latency);
     }
-    std::pair<SnoopList, Cycles> snoopDown(Cycles latency) const
+    std::pair<SnoopPorts, Cycles> snoopDown(Cycles latency) const
     {
-        SnoopList empty;
-        return std::make_pair(empty , latency);
+        return std::make_pair(maskToPortList(0), latency);
     }
 
     /**
@@ -247,9 +341,9 @@ class SnoopFilter : public SimObject {
     /**
      * Converts a bitmask of ports into the corresponing list of ports
      * @param ports SnoopMask of the requested ports
-     * @return SnoopList containing all the requested SlavePorts
+     * @return SnoopPorts selecting all the requested SlavePorts
      */
-    SnoopList maskToPortList(SnoopMask ports) const;
+    SnoopPorts maskToPortList(SnoopMask ports) const;
 
   private:
 
@@ -258,6 +352,28 @@ class SnoopFilter : public SimObject {
      */
     void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
 
+    /**
+     * Get the set of a bounded snoop filter that a line maps to. The
+     * lines in a set are ordered from least to most recently used.
+     */
+    std::vector<Addr>& getSet(Addr line_addr)
+    {
+        return sets[(line_addr / linesize) % numSets];
+    }
+
+    /**
+     * Make the line the most recently used one in its set.
+     */
+    void touchEntry(Addr line_addr);
+
+    /**
+     * Make room for a new line in a bounded snoop filter by evicting
+     * the least recently used line of its set that has no requests in
+     * flight. If all lines have requests in flight, the set
+     * temporarily holds more lines than its associativity.
+     */
+    void evictEntry(Addr line_addr);
+
     /** Simple hash set of cached addresses. */
     SnoopFilterCache cachedLocations;
     /**
@@ -281,6 +397,14 @@ class SnoopFilter : public SimObject {
     const Cycles lookupLatency;
     /** Max capacity in terms of cache blocks tracked, for sanity checking */
     const unsigned maxEntryCount;
+    /** Associativity of a bounded snoop filter, zero if unbounded */
+    const unsigned assoc;
+    /** Number of sets of a bounded snoop filter */
+    const unsigned numSets;
+    /** Lines tracked in each set of a bounded snoop filter */
+    std::vector<std::vector<Addr>> sets;
+    /** Lines evicted but not yet invalidated above */
+    std::vector<Eviction> evictions;
 
     /**
      * Use the lower bits of the address to keep track of the line status
@@ -298,6 +422,9 @@ class SnoopFilter : public SimObject {
     Stats::Scalar totSnoops;
     Stats::Scalar hitSingleSnoops;
     Stats::Scalar hitMultiSnoops;
+
+    Stats::Scalar capacityEvictions;
+    Stats::Scalar setOverflows;
 };
 
 inline SnoopFilter::SnoopMask
@@ -309,14 +436,10 @@ SnoopFilter::portToMask(const SlavePort& port) const
         ((SnoopMask)1) << localSlavePortIds[port.getId()];
 }
 
-inline SnoopFilter::SnoopList
+inline SnoopFilter::SnoopPorts
 SnoopFilter::maskToPortList(SnoopMask port_mask) const
 {
-    SnoopList res;
-    for (const auto& p : slavePorts)
-        if (port_mask & portToMask(*p))
-            res.push_back(p);
-    return res;
+    return SnoopPorts(slavePorts, port_mask);
 }
 
 #endif // __MEM_SNOOP_FILTER_HH__
@@ -61,11 +61,19 @@ BaseXBar::BaseXBar(const BaseXBarParams *p)
       forwardLatency(p->forward_latency),
       responseLatency(p->response_latency),
       width(p->width),
+      analyticLayers(p->analytic_layers),
+      layerChannels(p->layer_channels),
       gotAddrRanges(p->port_default_connection_count +
                           p->port_master_connection_count, false),
       gotAllAddrRanges(false), defaultPortID(InvalidPortID),
       useDefaultRange(p->use_default_range)
-{}
+{
+    fatal_if(layerChannels == 0, "%s needs at least one layer channel\n",
+             name());
+    fatal_if(layerChannels > 1 && !analyticLayers,
+             "%s needs analytic layers to use several layer channels\n",
+             name());
+}
 
 BaseXBar::~BaseXBar()
 {
@@ -147,8 +155,55 @@ template <typename SrcType, typename DstType>
 BaseXBar::Layer<SrcType,DstType>::Layer(DstType& _port, BaseXBar& _xbar,
                                        const std::string& _name) :
     port(_port), xbar(_xbar), _name(_name), state(IDLE),
-    waitingForPeer(NULL), releaseEvent([this]{ releaseLayer(); }, name())
+    waitingForPeer(NULL), releaseEvent([this]{ releaseLayer(); }, name()),
+    channelFree(xbar.analyticLayers ? xbar.layerChannels : 0, 0),
+    claimed(0)
+{
+}
+
+template <typename SrcType, typename DstType>
+bool
+BaseXBar::Layer<SrcType,DstType>::busy() const
+{
+    if (state == BUSY || !xbar.analyticLayers)
+        return state == BUSY;
+
+    return *std::min_element(channelFree.begin(), channelFree.end()) >
+        curTick();
+}
+
+template <typename SrcType, typename DstType>
+void
+BaseXBar::Layer<SrcType,DstType>::claimChannel()
 {
+    assert(xbar.analyticLayers);
+    claimed = std::min_element(channelFree.begin(), channelFree.end()) -
+        channelFree.begin();
+    assert(channelFree[claimed] <= curTick());
+}
+
+template <typename SrcType, typename DstType>
+void
+BaseXBar::Layer<SrcType,DstType>::scheduleRelease()
+{
+    assert(xbar.analyticLayers);
+
+    Tick when;
+    if (!waitingForLayer.empty() && waitingForPeer == NULL) {
+        // wake up once the first channel frees up
+        when = *std::min_element(channelFree.begin(), channelFree.end());
+    } else if (drainState() == DrainState::Draining) {
+        // or once all the channels are done
+        when = *std::max_element(channelFree.begin(), channelFree.end());
+    } else {
+        return;
+    }
+
+    when = std::max(when, curTick());
+    if (!releaseEvent.scheduled())
+        xbar.schedule(releaseEvent, when);
+    else if (releaseEvent.when() > when)
+        xbar.reschedule(releaseEvent, when);
 }
 
 template <typename SrcType, typename DstType>
@@ -162,11 +217,20 @@ void BaseXBar::Layer<SrcType,DstType>::occupyLayer(Tick until)
 
     // until should never be 0 as express snoops never occupy the layer
     assert(until != 0);
-    xbar.schedule(releaseEvent, until);
 
     // account for the occupied ticks
     occupancy += until - curTick();
 
+    if (xbar.analyticLayers) {
+        // the channel remembers when it is free again, and the layer
+        // can take another packet straight away
+        channelFree[claimed] = until;
+        state = IDLE;
+        scheduleRelease();
+    } else {
+        xbar.schedule(releaseEvent, until);
+    }
+
     DPRINTF(BaseXBar, "The crossbar layer is now busy from tick %d to %d\n",
             curTick(), until);
 }
@@ -183,8 +247,11 @@ BaseXBar::Layer<SrcType,DstType>::tryTiming(SrcType* src_port)
 
     // first we see if the layer is busy, next we check if the
     // destination port is already engaged in a transaction waiting
-    // for a retry from the peer
-    if (state == BUSY || waitingForPeer != NULL) {
+    // for a retry from the peer, analytic layers also make new ports
+    // queue up behind the ones already waiting to preserve their order
+    if (busy() || waitingForPeer != NULL ||
+        (xbar.analyticLayers && state != RETRY &&
+         !waitingForLayer.empty())) {
         // the port should not be waiting already
         assert(std::find(waitingForLayer.begin(), waitingForLayer.end(),
                          src_port) == waitingForLayer.end());
@@ -194,9 +261,13 @@ BaseXBar::Layer<SrcType,DstType>::tryTiming(SrcType* src_port)
         // that transaction to go through, and then the layer to free
         // up)
         waitingForLayer.push_back(src_port);
+        if (xbar.analyticLayers)
+            scheduleRelease();
         return false;
     }
 
+    if (xbar.analyticLayers)
+        claimChannel();
     state = BUSY;
 
     return true;
@@ -240,6 +311,27 @@ template <typename SrcType, typename DstType>
 void
 BaseXBar::Layer<SrcType,DstType>::releaseLayer()
 {
+    if (xbar.analyticLayers) {
+        // the layer is not occupied between events, so retry as many
+        // waiting ports as there are free channels
+        assert(state == IDLE);
+        while (!waitingForLayer.empty() && waitingForPeer == NULL &&
+               !busy()) {
+            retryWaiting();
+        }
+
+        if (waitingForLayer.empty() && waitingForPeer == NULL &&
+            drainState() == DrainState::Draining &&
+            *std::max_element(channelFree.begin(), channelFree.end()) <=
+            curTick()) {
+            DPRINTF(Drain, "Crossbar done draining, signaling drain manager\n");
+            signalDrainDone();
+        } else {
+            scheduleRelease();
+        }
+        return;
+    }
+
     // releasing the bus means we should now be idle
     assert(state == BUSY);
     assert(!releaseEvent.scheduled());
@@ -289,6 +381,8 @@ BaseXBar::Layer<SrcType,DstType>::retryWaiting()
         // update the state to busy and reset the retrying port, we
         // have done our bit and sent the retry
         state = BUSY;
+        if (xbar.analyticLayers)
+            claimChannel();
 
         // occupy the crossbar layer until the next clock edge
         occupyLayer(xbar.clockEdge());
@@ -313,7 +407,12 @@ BaseXBar::Layer<SrcType,DstType>::recvRetry()
 
     // if the layer is idle, retry this port straight away, if we
     // are busy, then simply let the port wait for its turn
-    if (state == IDLE) {
+    if (xbar.analyticLayers) {
+        assert(state == IDLE);
+        if (!busy())
+            retryWaiting();
+        scheduleRelease();
+    } else if (state == IDLE) {
         retryWaiting();
     } else {
         assert(state == BUSY);
@@ -327,18 +426,10 @@ BaseXBar::findPort(Addr addr)
     // ranges of all connected slave modules
     assert(gotAllAddrRanges);
 
-    // Check the cache
-    PortID dest_id = checkPortCache(addr);
-    if (dest_id != InvalidPortID)
-        return dest_id;
-
-    // Check the address map interval tree
-    auto i = portMap.find(addr);
-    if (i != portMap.end()) {
-        dest_id = i->second;
-        updatePortCache(dest_id, i->first);
-        return dest_id;
-    }
+    // Check the decoded address map
+    const auto i = portDecoder.find(addr);
+    if (i)
+        return i->second;
 
     // Check if this matches the default range
     if (useDefaultRange) {
@@ -518,7 +609,7 @@ BaseXBar::recvRangeChange(PortID master_port_id)
             s->sendRangeChange();
     }
 
-    clearPortCache();
+    portDecoder.build(portMap);
 }
 
 AddrRangeList
@@ -594,7 +685,17 @@ BaseXBar::Layer<SrcType,DstType>::drain()
     //We should check that we're not "doing" anything, and that noone is
     //waiting. We might be idle but have someone waiting if the device we
     //contacted for a retry didn't actually retry.
-    if (state != IDLE) {
+    if (xbar.analyticLayers) {
+        const Tick done = *std::max_element(channelFree.begin(),
+                                            channelFree.end());
+        if (state == IDLE && done <= curTick())
+            return DrainState::Drained;
+
+        DPRINTF(Drain, "Crossbar not drained\n");
+        if (!releaseEvent.scheduled())
+            xbar.schedule(releaseEvent, std::max(done, curTick()));
+        return DrainState::Draining;
+    } else if (state != IDLE) {
         DPRINTF(Drain, "Crossbar not drained\n");
         return DrainState::Draining;
     } else {
@@ -619,7 +720,8 @@ BaseXBar::Layer<SrcType,DstType>::regStats()
         .precision(1)
         .flags(nozero);
 
-    utilization = 100 * occupancy / simTicks;
+    // analytic layers spread their occupancy over all channels
+    utilization = 100 * occupancy / simTicks / xbar.layerChannels;
 }
 
 /**
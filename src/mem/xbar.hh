@@ -53,7 +53,9 @@
 
 #include <deque>
 #include <unordered_map>
+#include <vector>
 
+#include "base/addr_decoder.hh"
 #include "base/addr_range_map.hh"
 #include "base/types.hh"
 #include "mem/mem_object.hh"
@@ -88,6 +90,13 @@ class BaseXBar : public MemObject
      * ports or slave ports, depending on the direction of the
      * layer. Thus, a request layer has a retry list containing slave
      * ports, whereas a response layer holds master ports.
+     *
+     * By default a layer holds one packet at a time and schedules an
+     * event to release itself once the packet has passed. With
+     * analytic layers, the layer instead has a number of channels,
+     * each remembering the tick it is next free, and packets are
+     * accepted as long as a channel is free. Events are then only
+     * needed to wake up ports waiting for the layer.
      */
     template <typename SrcType, typename DstType>
     class Layer : public Drainable
@@ -134,6 +143,18 @@ class BaseXBar : public MemObject
          */
         bool tryTiming(SrcType* src_port);
 
+        /**
+         * Check if the layer would accept a packet, without changing
+         * its state or adding anything to the retry list.
+         *
+         * @return True if the layer is neither busy nor waiting
+         */
+        bool isFree() const
+        {
+            return !busy() && waitingForPeer == NULL &&
+                (!xbar.analyticLayers || waitingForLayer.empty());
+        }
+
         /**
          * Deal with a destination port accepting a packet by potentially
          * removing the source port from the retry list (if retrying) and
@@ -236,9 +257,38 @@ class BaseXBar : public MemObject
          */
         void releaseLayer();
 
+        /**
+         * Check if the layer is occupied, i.e. it has accepted a
+         * packet that is still in transit (analytic layers: on all of
+         * its channels), or a port is in the middle of sending.
+         */
+        bool busy() const;
+
+        /**
+         * Pick the channel that the packet accepted by tryTiming or
+         * retryWaiting will occupy. Only used for analytic layers.
+         */
+        void claimChannel();
+
+        /**
+         * Schedule the release event for the next tick a waiting port
+         * can be retried, or the layer be considered drained. Only
+         * used for analytic layers.
+         */
+        void scheduleRelease();
+
         /** event used to schedule a release of the layer */
         EventFunctionWrapper releaseEvent;
 
+        /**
+         * Tick at which each of the channels of an analytic layer is
+         * next free to accept a packet.
+         */
+        std::vector<Tick> channelFree;
+
+        /** The channel claimed by the packet currently being sent. */
+        unsigned claimed;
+
         /**
          * Stats for occupancy and utilization. These stats capture
          * the time the layer spends in the busy state and are thus only
@@ -318,9 +368,22 @@ class BaseXBar : public MemObject
     const Cycles responseLatency;
     /** the width of the xbar in bytes */
     const uint32_t width;
+    /**
+     * Account for layer occupancy analytically rather than with
+     * release events
+     */
+    const bool analyticLayers;
+    /** number of packets an analytic layer can have in flight */
+    const unsigned layerChannels;
 
     AddrRangeMap<PortID> portMap;
 
+    /**
+     * Flattened copy of the port map used by findPort, rebuilt on
+     * every range change.
+     */
+    AddrDecoder<PortID> portDecoder;
+
     /**
      * Remember where request packets came from so that we can route
      * responses to the appropriate port. This relies on the fact that
@@ -350,53 +413,6 @@ class BaseXBar : public MemObject
      */
     PortID findPort(Addr addr);
 
-    // Cache for the findPort function storing recently used ports from portMap
-    struct PortCache {
-        bool valid;
-        PortID id;
-        AddrRange range;
-    };
-
-    PortCache portCache[3];
-
-    // Checks the cache and returns the id of the port that has the requested
-    // address within its range
-    inline PortID checkPortCache(Addr addr) const {
-        if (portCache[0].valid && portCache[0].range.contains(addr)) {
-            return portCache[0].id;
-        }
-        if (portCache[1].valid && portCache[1].range.contains(addr)) {
-            return portCache[1].id;
-        }
-        if (portCache[2].valid && portCache[2].range.contains(addr)) {
-            return portCache[2].id;
-        }
-
-        return InvalidPortID;
-    }
-
-    // Clears the earliest entry of the cache and inserts a new port entry
-    inline void updatePortCache(short id, const AddrRange& range) {
-        portCache[2].valid = portCache[1].valid;
-        portCache[2].id    = portCache[1].id;
-        portCache[2].range = portCache[1].range;
-
-        portCache[1].valid = portCache[0].valid;
-        portCache[1].id    = portCache[0].id;
-        portCache[1].range = portCache[0].range;
-
-        portCache[0].valid = true;
-        portCache[0].id    = id;
-        portCache[0].range = range;
-    }
-
-    // Clears the cache. Needs to be called in constructor.
-    inline void clearPortCache() {
-        portCache[2].valid = false;
-        portCache[1].valid = false;
-        portCache[0].valid = false;
-    }
-
     /**
      * Return the address ranges the crossbar is responsible for.
      *
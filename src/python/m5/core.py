@@ -26,4 +26,4 @@
 #
 # Authors: Nathan Binkert
 
-from _m5.core import setOutputDir
+from _m5.core import setOutputDir, setBinaryCheckpoints
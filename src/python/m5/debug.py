@@ -33,6 +33,7 @@ from UserDict import DictMixin
 import _m5.debug
 from _m5.debug import SimpleFlag, CompoundFlag
 from _m5.debug import schedBreak, setRemoteGDBPort
+from _m5.debug import configurePortTraces, dumpPortTraces
 from m5.util import printList
 
 def help():
@@ -105,6 +105,8 @@ def parse_options():
     group("Statistics Options")
     option("--stats-file", metavar="FILE", default="stats.txt",
         help="Sets the output file for statistics [Default: %default]")
+    option("--stats-arena", action="store_true", default=False,
+        help="Allocate vector stats contiguously for cheaper stats resets")
 
     # Configuration Options
     group("Configuration Options")
@@ -117,6 +119,19 @@ def parse_options():
     option("--dot-dvfs-config", metavar="FILE", default=None,
         help="Create DOT & pdf outputs of the DVFS configuration" + \
              " [Default: %default]")
+    option("--config-cache", metavar="FILE", default=None,
+        help="Instantiate the configuration from FILE without running " \
+        "the script if FILE exists, otherwise write the configuration " \
+        "of the script to FILE [Default: %default]")
+    option("--setup-threads", metavar="N", type="int", default=1,
+        help="Use N threads for the init and regStats passes of objects " \
+        "that support it [Default: %default]")
+    option("--checkpoint-threads", metavar="N", type="int", default=1,
+        help="Use N threads to write and restore the checkpoint sections " \
+        "of objects that support it [Default: %default]")
+    option("--checkpoint-format", choices=("ini", "binary"), default="ini",
+        help="Write checkpoints as INI text, or in a binary format that " \
+        "is much faster to restore [Default: %default]")
 
     # Debugging options
     group("Debugging Options")
@@ -133,8 +148,24 @@ def parse_options():
         help="End debug output at TICK")
     option("--debug-file", metavar="FILE", default="cout",
         help="Sets the output file for debug [Default: %default]")
+    option("--debug-format", choices=("text", "binary", "ring"),
+        default="text",
+        help="Write debug output as text, or as a compact binary trace " \
+        "to be decoded with util/decode_binary_trace.py. A ring only " \
+        "keeps the latest messages in memory, and writes them out on " \
+        "exit, panic or fatal [Default: %default]")
+    option("--debug-ring-size", metavar="SIZE", default="16MB",
+        help="Memory used per thread by --debug-format=ring " \
+        "[Default: %default]")
     option("--debug-ignore", metavar="EXPR", action='append', split=':',
         help="Ignore EXPR sim objects")
+    option("--port-trace-size", metavar="N", type='int', default=0,
+        help="Record the last N timing packets and retries sent by each " \
+        "port, and write them to port_traces.txt if gem5 aborts " \
+        "[Default: %default]")
+    option("--port-trace-ports", metavar="NAME[,NAME]", default="",
+        help="Only record the ports with these names, or of the objects " \
+        "with these names (* matches any name component)")
     option("--remote-gdb-port", type='int', default=7000,
         help="Remote gdb base port (set to 0 to disable listening)")
 
@@ -328,8 +359,14 @@ def main(*args):
         print("command line:", " ".join(map(pipes.quote, sys.argv)))
         print()
 
+    # a config cache replaces the script, which only needs to run to
+    # create the cache
+    use_config_cache = options.config_cache and \
+        os.path.isfile(options.config_cache)
+
     # check to make sure we can find the listed script
-    if not arguments or not os.path.isfile(arguments[0]):
+    if not use_config_cache and \
+       (not arguments or not os.path.isfile(arguments[0])):
         if arguments and not os.path.isfile(arguments[0]):
             print("Script %s not found" % arguments[0])
 
@@ -337,12 +374,15 @@ def main(*args):
 
     # tell C++ about output directory
     core.setOutputDir(options.outdir)
+    core.setBinaryCheckpoints(options.checkpoint_format == "binary")
 
     # update the system path with elements from the -p option
     sys.path[0:0] = options.path
 
     # set stats options
     stats.addStatVisitor(options.stats_file)
+    if options.stats_arena:
+        stats.enableStorageArena()
 
     # Disable listeners unless running interactively or explicitly
     # enabled
@@ -365,6 +405,10 @@ def main(*args):
     for when in options.debug_break:
         debug.schedBreak(int(when))
 
+    if options.port_trace_size:
+        debug.configurePortTraces(options.port_trace_size,
+                                  options.port_trace_ports)
+
     if options.debug_flags:
         check_tracing()
 
@@ -397,12 +441,26 @@ def main(*args):
         e = event.create(trace.disable, event.Event.Debug_Enable_Pri)
         event.mainq.schedule(e, options.debug_end)
 
-    trace.output(options.debug_file)
+    if options.debug_format == "binary":
+        trace.outputBinary(options.debug_file)
+    elif options.debug_format == "ring":
+        from m5.util.convert import toMemorySize
+        trace.outputBinary(options.debug_file,
+                           toMemorySize(options.debug_ring_size))
+    else:
+        trace.output(options.debug_file)
 
     for ignore in options.debug_ignore:
         check_tracing()
         trace.ignore(ignore)
 
+    if use_config_cache:
+        m5.instantiateFromCache(options.config_cache)
+        exit_event = m5.simulate()
+        print('Exiting @ tick %i because %s' %
+              (m5.curTick(), exit_event.getCause()))
+        return
+
     sys.argv = arguments
     sys.path = [ os.path.dirname(sys.argv[0]) ] + sys.path
 
@@ -43,8 +43,12 @@
 from __future__ import print_function
 
 import atexit
+import cPickle
 import os
+import shutil
 import sys
+import tempfile
+import traceback
 
 # import the wrapped C++ functions
 import _m5.drain
@@ -55,7 +59,9 @@ import stats
 import SimObject
 import ticks
 import objects
+from m5.util.config_cache import write_config_cache
 from m5.util.dot_writer import do_dot, do_dvfs_dot
+from m5.util import partition
 
 from util import fatal
 from util import attrdict
@@ -88,9 +94,28 @@ def instantiate(ckpt_dir=None):
     # hierarchy so we catch them with future descendants() walks
     for obj in root.descendants(): obj.adoptOrphanParams()
 
+    # Spread the system over multiple event queues if requested. This
+    # must happen before unproxying so that children inherit the
+    # event queue of their parent.
+    if int(root.auto_event_queues) > 1:
+        partition.partition(root, int(root.auto_event_queues))
+    elif root.kvm_event_queues and partition.partition_kvm(root):
+        if int(root.sim_quantum) == 0:
+            root.sim_quantum = root.kvm_sim_quantum.getValue()
+        print("Running KVM CPUs on separate threads with a quantum of "
+              "%d ticks" % int(root.sim_quantum))
+
     # Unproxy in sorted order for determinism
     for obj in root.descendants(): obj.unproxyParams()
 
+    if str(root.sim_quantum_mode) == 'Lookahead' and \
+       int(root.sim_quantum) == 0:
+        quantum = partition.lookahead(root)
+        if quantum is not None:
+            print("Using a lookahead of %d ticks between event queues" %
+                  quantum)
+            root.sim_quantum = quantum
+
     if options.dump_config:
         ini_file = file(os.path.join(options.outdir, options.dump_config), 'w')
         # Print ini sections in sorted order for easier diffing
@@ -108,6 +133,9 @@ def instantiate(ckpt_dir=None):
         except ImportError:
             pass
 
+    if options.config_cache:
+        write_config_cache(root, options.config_cache, ticks.tps)
+
     do_dot(root, options.outdir, options.dot_config)
 
     # Initialize the global statistics
@@ -117,11 +145,18 @@ def instantiate(ckpt_dir=None):
     for obj in root.descendants(): obj.createCCObject()
     for obj in root.descendants(): obj.connectPorts()
 
-    # Do a second pass to finish initializing the sim objects
-    for obj in root.descendants(): obj.init()
-
-    # Do a third pass to initialize statistics
-    for obj in root.descendants(): obj.regStats()
+    # Do a second pass to finish initializing the sim objects, and a
+    # third pass to initialize statistics. Objects that declare
+    # themselves independent may run these on several threads.
+    if options.setup_threads > 1:
+        cc_objs = [ obj.getCCObject() for obj in root.descendants() ]
+        _m5.core.setupAll(cc_objs, _m5.core.SetupPhase.Init,
+                          options.setup_threads)
+        _m5.core.setupAll(cc_objs, _m5.core.SetupPhase.RegStats,
+                          options.setup_threads)
+    else:
+        for obj in root.descendants(): obj.init()
+        for obj in root.descendants(): obj.regStats()
 
     # Do a fourth pass to initialize probe points
     for obj in root.descendants(): obj.regProbePoints()
@@ -143,7 +178,11 @@ def instantiate(ckpt_dir=None):
         _drain_manager.preCheckpointRestore()
         ckpt = _m5.core.getCheckpoint(ckpt_dir)
         _m5.core.unserializeGlobals(ckpt);
-        for obj in root.descendants(): obj.loadState(ckpt)
+        if options.checkpoint_threads > 1:
+            cc_objs = [ obj.getCCObject() for obj in root.descendants() ]
+            _m5.core.loadStateAll(cc_objs, ckpt, options.checkpoint_threads)
+        else:
+            for obj in root.descendants(): obj.loadState(ckpt)
     else:
         for obj in root.descendants(): obj.initState()
 
@@ -151,13 +190,49 @@ def instantiate(ckpt_dir=None):
     # a checkpoint, If so, this call will shift them to be at a valid time.
     updateStatEvents()
 
+# The config cache and the manager holding the objects instantiated
+# from it, if any
+_config_cache = None
+_config_manager = None
+
+def instantiateFromCache(filename):
+    """Instantiate the objects of a config cache written by an earlier
+    run, without a Python configuration."""
+    global _config_cache, _config_manager
+
+    _config_cache = _m5.core.CxxBinFile()
+    if not _config_cache.load(filename):
+        fatal("Can't read config cache %s" % filename)
+
+    # the values in the cache are in the ticks of the original run
+    ticks.setGlobalFrequency(_config_cache.ticksPerSecond())
+    ticks.fixGlobalFrequency()
+
+    # Initialize the global statistics
+    stats.initSimStats()
+
+    # Create, connect and initialise the C++ sim objects, register
+    # their statistics and probes
+    _config_manager = _m5.core.CxxConfigManager(_config_cache)
+    _config_manager.instantiate()
+
+    # We're done registering statistics.  Enable the stats package now.
+    stats.enable()
+
+    _config_manager.initState()
+
+    updateStatEvents()
+
 need_startup = True
 def simulate(*args, **kwargs):
     global need_startup
 
     if need_startup:
-        root = objects.Root.getInstance()
-        for obj in root.descendants(): obj.startup()
+        if _config_manager:
+            _config_manager.startup()
+        else:
+            root = objects.Root.getInstance()
+            for obj in root.descendants(): obj.startup()
         need_startup = False
 
         # Python exit handlers happen in reverse order.
@@ -173,17 +248,30 @@ def simulate(*args, **kwargs):
     if _drain_manager.isDrained():
         _drain_manager.resume()
 
-    return _m5.event.simulate(*args, **kwargs)
+    exit_event = _m5.event.simulate(*args, **kwargs)
+    stats.update()
+    return exit_event
 
-def drain():
+def drain(objs=None):
     """Drain the simulator in preparation of a checkpoint or memory mode
     switch.
 
     This operation is a no-op if the simulator is already in the
-    Drained state.
+    Drained state, unless only a subset of the objects were drained,
+    in which case the requested objects are drained again.
+
+    Arguments:
+      objs -- Only drain these SimObjects and leave the rest of the
+              simulator running (default: drain all objects).
 
     """
 
+    if objs is None:
+        try_drain = _drain_manager.tryDrain
+    else:
+        cc_objs = [ obj.getCCObject() for obj in objs ]
+        try_drain = lambda: _drain_manager.tryDrainObjects(cc_objs)
+
     # Try to drain all objects. Draining might not be completed unless
     # all objects return that they are drained on the first call. This
     # is because as objects drain they may cause other objects to no
@@ -192,7 +280,7 @@ def drain():
         # Try to drain the system. The drain is successful if all
         # objects are done without simulation. We need to simulate
         # more if not.
-        if _drain_manager.tryDrain():
+        if try_drain():
             return True
 
         # WARNING: if a valid exit event occurs while draining, it
@@ -203,8 +291,10 @@ def drain():
 
         return False
 
-    # Don't try to drain a system that is already drained
-    is_drained = _drain_manager.isDrained()
+    # Don't try to drain a system that is already drained. A partial
+    # drain left other objects running, so they still need to drain.
+    is_drained = _drain_manager.isDrained() and \
+                 not _drain_manager.isPartiallyDrained()
     while not is_drained:
         is_drained = _drain()
 
@@ -226,7 +316,8 @@ def checkpoint(dir):
     drain()
     memWriteback(root)
     print("Writing checkpoint")
-    _m5.core.serializeAll(dir)
+    from m5 import options
+    _m5.core.serializeAll(dir, options.checkpoint_threads)
 
 def _changeMemoryMode(system, mode):
     if not isinstance(system, (objects.Root, objects.System)):
@@ -237,7 +328,7 @@ def _changeMemoryMode(system, mode):
     else:
         print("System already in target mode. Memory mode unchanged.")
 
-def switchCpus(system, cpuList, verbose=True):
+def switchCpus(system, cpuList, verbose=True, drain_cpus_only=False):
     """Switch CPUs in a system.
 
     Note: This method may switch the memory mode of the system if that
@@ -247,6 +338,13 @@ def switchCpus(system, cpuList, verbose=True):
     Arguments:
       system -- Simulated system.
       cpuList -- (old_cpu, new_cpu) tuples
+      drain_cpus_only -- Only drain the CPUs instead of the whole
+                         simulator. Caches and memories keep their
+                         state and keep running, which makes frequent
+                         switches (e.g., when sampling) cheap. This is
+                         ignored when leaving the timing memory mode or
+                         disabling caches, as those need a drained
+                         memory system.
     """
 
     if verbose:
@@ -292,7 +390,15 @@ def switchCpus(system, cpuList, verbose=True):
     except KeyError:
         raise RuntimeError, "Invalid memory mode (%s)" % memory_mode_name
 
-    drain()
+    # The CPUs only have to stop issuing requests, unless the memory
+    # system may have requests in flight that the new memory mode
+    # can't handle.
+    if drain_cpus_only and \
+       (memory_mode == system.getMemoryMode() or
+        memory_mode == objects.params.timing):
+        drain(old_cpus + new_cpus + [ system ])
+    else:
+        drain()
 
     # Now all of the CPUs are ready to be switched out
     for old_cpu, new_cpu in cpuList:
@@ -313,6 +419,86 @@ def switchCpus(system, cpuList, verbose=True):
     for old_cpu, new_cpu in cpuList:
         new_cpu.takeOverFrom(old_cpu)
 
+def sample(system, controller, cpuList, verbose=False,
+           drain_cpus_only=True):
+    """Run statistical sampling driven by a SamplingController.
+
+    The loop asks the controller for the next phase, switches between
+    the functional and detailed CPUs when the phase needs it, and
+    simulates until the phase ends. Sampling stops when the controller
+    has met its target error, or when the simulation exits for any
+    other reason.
+
+    Arguments:
+      system -- Simulated system.
+      controller -- SamplingController sequencing the phases.
+      cpuList -- (functional_cpu, detailed_cpu) tuples. The functional
+                 CPUs must be running when sampling starts.
+      verbose -- Print a message on every CPU switch.
+      drain_cpus_only -- Passed on to switchCpus().
+
+    Return Value:
+      The exit event that stopped the simulation, or None if sampling
+      finished. The functional CPUs are running again in the latter
+      case.
+    """
+
+    detailed = False
+    while True:
+        phase = controller.nextPhase()
+        if phase == "done":
+            if detailed:
+                switchCpus(system, [ (d, f) for f, d in cpuList ],
+                           verbose=verbose, drain_cpus_only=drain_cpus_only)
+            return None
+
+        need_detailed = phase != "functional_warming"
+        if need_detailed != detailed:
+            if need_detailed:
+                switch_list = cpuList
+            else:
+                switch_list = [ (d, f) for f, d in cpuList ]
+            switchCpus(system, switch_list, verbose=verbose,
+                       drain_cpus_only=drain_cpus_only)
+            detailed = need_detailed
+
+        controller.startPhase()
+        exit_event = simulate()
+        if exit_event.getCause() != "sampling phase done":
+            return exit_event
+
+def warmCachesFromKvm(system, cpus):
+    """Warm the caches with the pages recently written by KVM CPUs.
+
+    The pages come from the dirty page log of the system's KvmVM,
+    which must have dirtyPageLog set. Ruby systems install the lines
+    directly. Classic caches are warmed by reading the pages through
+    the given CPUs, so this must be called after switching from the
+    KVM CPUs to CPUs that use the atomic memory mode. The pages are
+    spread over the CPUs round-robin.
+
+    Arguments:
+      system -- Simulated system.
+      cpus -- Running atomic CPUs to warm the classic caches through.
+    """
+
+    if not system.kvm_vm:
+        fatal("%s has no KVM VM to get the written pages from." %
+              system.path())
+
+    pages = system.kvm_vm.recentDirtyPages()
+    if not pages:
+        return
+
+    if getattr(system, "ruby", None):
+        system.ruby.warmupPages(pages)
+        return
+
+    if not cpus:
+        fatal("No CPU to warm the caches of %s through." % system.path())
+    for i, cpu in enumerate(cpus):
+        cpu.warmCaches(pages[i::len(cpus)])
+
 def notifyFork(root):
     for obj in root.descendants():
         obj.notifyFork()
@@ -369,6 +555,171 @@ def fork(simout="%(parent)s.f%(fork_seq)i"):
 
     return pid
 
+def forkSamples(samples, max_jobs=None, stats_file=None, dump_stats=True,
+                simout="%(parent)s.s%(fork_seq)i"):
+    """Run samples in parallel in forked copies of the simulator.
+
+    Every sample is a function without arguments that is run in a
+    child forked from the current state of the simulator, e.g., after
+    restoring a checkpoint once and warming up. The children share the
+    guest memory with the parent copy-on-write. A sample typically
+    changes some parameters and simulates its own region. The child
+    exits as soon as the sample returns, so the state of the parent is
+    the same for all samples.
+
+    Keyword Arguments:
+      max_jobs -- Number of children running at the same time
+                  (default: number of host CPUs).
+      stats_file -- File in the parent's output directory to
+                    concatenate the statistics of all samples into, in
+                    the order of the samples.
+      dump_stats -- Dump the statistics when a sample returns.
+      simout -- Output directory of the children, as for fork().
+
+    Return Value:
+      List of the values returned by the samples, which must be
+      picklable, with None for samples that failed.
+    """
+    from m5 import options
+
+    if max_jobs is None:
+        import multiprocessing
+        max_jobs = multiprocessing.cpu_count()
+    if max_jobs < 1:
+        raise ValueError("max_jobs must be at least 1")
+
+    result_dir = tempfile.mkdtemp(prefix="m5samples")
+    results = [ None ] * len(samples)
+    outdirs = [ None ] * len(samples)
+    running = {}
+    next_sample = 0
+
+    try:
+        while next_sample < len(samples) or running:
+            while next_sample < len(samples) and len(running) < max_jobs:
+                index = next_sample
+                next_sample += 1
+
+                pid = fork(simout)
+                if pid == 0:
+                    _runForkedSample(samples[index], dump_stats,
+                                     os.path.join(result_dir, str(index)))
+                running[pid] = index
+
+            pid, status = os.wait()
+            if pid not in running:
+                continue
+
+            index = running.pop(pid)
+            if status != 0:
+                print("Sample %d failed with status %d" % (index, status),
+                      file=sys.stderr)
+                continue
+
+            with open(os.path.join(result_dir, str(index)), "rb") as f:
+                results[index], outdirs[index] = cPickle.load(f)
+    finally:
+        shutil.rmtree(result_dir, ignore_errors=True)
+
+    if stats_file:
+        name = os.path.basename(options.stats_file)
+        with open(os.path.join(options.outdir, stats_file), "w") as merged:
+            for index, outdir in enumerate(outdirs):
+                if outdir is None:
+                    continue
+                path = os.path.join(outdir, name)
+                if not os.path.isfile(path):
+                    continue
+                merged.write("\n# Sample %d (%s)\n" % (index, outdir))
+                with open(path) as f:
+                    shutil.copyfileobj(f, merged)
+
+    return results
+
+# Pipe to the process holding the most recent snapshot
+_snapshot_fd = None
+
+def snapshot(simout="%(parent)s.r%(fork_seq)i"):
+    """Take an in-memory snapshot of the simulator to roll back to.
+
+    The snapshot is a forked copy of the simulator that waits while
+    the simulation continues in a child process, so guest memory is
+    shared copy-on-write and nothing is written to disk. When the
+    child calls rollback(), it exits and the snapshot forks a new
+    child that returns from snapshot() again, with the state the
+    simulator had when the snapshot was taken. When the child exits
+    any other way, the snapshot exits with the same status.
+
+    Each child gets its own output directory, named as for fork().
+    Like fork(), this requires listeners to be disabled.
+
+    Return Value:
+      The number of times the simulator has been rolled back to this
+      snapshot, to select the parameters of an iteration.
+    """
+    global _snapshot_fd
+
+    rollbacks = 0
+    while True:
+        sys.stdout.flush()
+        sys.stderr.flush()
+        r, w = os.pipe()
+        pid = fork(simout)
+        if pid == 0:
+            os.close(r)
+            _snapshot_fd = w
+            return rollbacks
+
+        os.close(w)
+        _, status = os.waitpid(pid, 0)
+        rolled_back = os.read(r, 1) == "r"
+        os.close(r)
+        if not rolled_back:
+            if os.WIFEXITED(status):
+                os._exit(os.WEXITSTATUS(status))
+            os._exit(1)
+        rollbacks += 1
+
+def rollback():
+    """Discard the current simulation and return to the latest snapshot.
+
+    This does not return. Execution continues where the snapshot was
+    taken, in a new copy of the simulator.
+    """
+    if _snapshot_fd is None:
+        raise RuntimeError("No snapshot to roll back to")
+
+    # finish the output of this iteration, but skip the Python exit
+    # handlers that belong to the snapshot
+    _m5.core.doExitCleanup()
+    sys.stdout.flush()
+    sys.stderr.flush()
+    os.write(_snapshot_fd, "r")
+    os._exit(0)
+
+def _runForkedSample(sample, dump_stats, result_path):
+    """Run a sample in a child forked by forkSamples() and exit."""
+    from m5 import options
+
+    status = 1
+    try:
+        result = sample()
+        if dump_stats:
+            stats.dump()
+        with open(result_path, "wb") as f:
+            cPickle.dump((result, options.outdir), f,
+                         cPickle.HIGHEST_PROTOCOL)
+        status = 0
+    except:
+        traceback.print_exc()
+    finally:
+        # skip the parent's Python exit handlers, but let the C++
+        # objects finish their output
+        _m5.core.doExitCleanup()
+        sys.stdout.flush()
+        sys.stderr.flush()
+        os._exit(status)
+
 from _m5.core import disableAllListeners, listenersDisabled
 from _m5.core import listenersLoopbackOnly
 from _m5.core import curTick
@@ -101,25 +101,50 @@ def _url_factory(func):
 
     return wrapper
 
+def _background(output, background):
+    """Write the dumps of output on a background thread if requested."""
+
+    return _m5.stats.initBackground(output) if background else output
+
 @_url_factory
-def _textFactory(fn, desc=True):
+def _textFactory(fn, desc=True, background=False):
     """Output stats in text format.
 
     Text stat files contain one stat per line with an optional
     description. The description is enabled by default, but can be
-    disabled by setting the desc parameter to False.
+    disabled by setting the desc parameter to False. Setting the
+    background parameter to True formats and writes the dumps on a
+    background thread.
 
     Example: text://stats.txt?desc=False
 
     """
 
-    return _m5.stats.initText(fn, desc)
+    return _background(_m5.stats.initText(fn, desc), background)
+
+@_url_factory
+def _binaryFactory(fn, background=False):
+    """Output stats in a binary, column oriented format.
+
+    Each dump is appended as one row of doubles, with the column names
+    written once at the start of the file. This is much cheaper than
+    the text format for frequent periodic dumps. The file can be read
+    into a pandas DataFrame using util/read_stats_binary.py. As for
+    text, the background parameter moves the writes to a background
+    thread.
+
+    Example: binary://stats.bin?background=True
+
+    """
+
+    return _background(_m5.stats.initBinary(fn), background)
 
 factories = {
     # Default to the text factory if we're given a naked path
     "" : _textFactory,
     "file" : _textFactory,
     "text" : _textFactory,
+    "binary" : _binaryFactory,
 }
 
 def addStatVisitor(url):
@@ -146,6 +171,16 @@ def addStatVisitor(url):
 
     outputList.append(factory(parsed))
 
+def enableStorageArena():
+    """Allocate the storage of vector stats contiguously.
+
+    This makes resetting stats cheaper. It has to be called before any
+    stat is initialised, i.e., before m5.instantiate().
+
+    """
+
+    _m5.stats.enableStorageArena()
+
 def initSimStats():
     _m5.stats.initSimStats()
     _m5.stats.registerPythonStatsHandlers()
@@ -179,14 +214,62 @@ def enable():
         stats_dict[stat.name] = stat
         stat.enable()
 
+    _m5.stats.setStatsOrder(stats_list)
     _m5.stats.enable();
 
+def _counterView(stat):
+    view = stat.counters()
+    if view is None:
+        return None
+    try:
+        import numpy
+        return numpy.asarray(view)
+    except ImportError:
+        return memoryview(view)
+
+def counters(name):
+    '''Return a view of the counters of the named stat.
+
+    The view shares memory with the stat, so it reflects the current
+    values without copying them; keep it around instead of looking it
+    up again. Some objects accumulate counts outside of their stats and
+    add them when update() is called; simulate() does so before
+    returning, so the views are current whenever the simulation is
+    paused. It is a NumPy array if NumPy is installed and a
+    memoryview otherwise, and must not be written to.
+
+    Scalars, vectors and 2d vectors have views of their counters, and
+    distributions and histograms have views of their buckets. Averages
+    expose the current count rather than the average. None is returned
+    for stats that don't keep plain counters, such as formulas.'''
+
+    if name not in stats_dict:
+        fatal("No statistic called '%s'\n", name)
+    return _counterView(stats_dict[name])
+
+def allCounters(prefix=''):
+    '''Return a dictionary of views of the counters of all stats whose
+    name starts with prefix. See counters().'''
+
+    views = {}
+    for stat in stats_list:
+        if stat.name.startswith(prefix):
+            view = _counterView(stat)
+            if view is not None:
+                views[stat.name] = view
+    return views
+
+def update():
+    '''Add the counts that objects accumulate outside of their stats to
+    the stats, so their values and counter views are current.'''
+
+    _m5.stats.processPrepareQueue()
+
 def prepare():
     '''Prepare all stats for data access.  This must be done before
     dumping and serialization.'''
 
-    for stat in stats_list:
-        stat.prepare()
+    _m5.stats.prepareAll()
 
 lastDump = 0
 def dump():
@@ -207,8 +290,7 @@ def dump():
     for output in outputList:
         if output.valid():
             output.begin()
-            for stat in stats_list:
-                stat.visit(output)
+            _m5.stats.visitAll(output)
             output.end()
 
 def reset():
@@ -220,8 +302,7 @@ def reset():
         for obj in root.descendants(): obj.resetStats()
 
     # call any other registered stats reset callbacks
-    for stat in stats_list:
-        stat.reset()
+    _m5.stats.resetAll()
 
     _m5.stats.processResetQueue()
 
@@ -0,0 +1,77 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#####################################################################
+#
+# Config caches
+#
+# A config cache holds the fully resolved object graph of a
+# configuration, i.e., the same objects and entries as config.ini,
+# in a compact binary form that C++ can instantiate through
+# CxxConfigManager without running the configuration script again
+# (see src/sim/cxx_config_bin.hh for the format).
+#
+#####################################################################
+
+from __future__ import print_function
+
+import struct
+
+_magic = b'gem5cfg\0'
+_version = 1
+
+def write_config_cache(root, filename, ticks_per_second):
+    """Write the objects under root, after their parameters have been
+    resolved, to a config cache."""
+
+    strings = []
+    string_index = {}
+    def intern(s):
+        idx = string_index.get(s)
+        if idx is None:
+            idx = string_index[s] = len(strings)
+            strings.append(s)
+        return idx
+
+    objects = []
+    for obj in sorted(root.descendants(), key=lambda o: o.path()):
+        entries = [ (intern(k), intern(v)) for k, v in obj.ini_entries() ]
+        objects.append((intern(obj.path()), entries))
+
+    data = [ _magic, struct.pack('<IQI', _version, int(ticks_per_second),
+                                 len(strings)) ]
+    for s in strings:
+        data.append(struct.pack('<I', len(s)))
+        data.append(s)
+
+    data.append(struct.pack('<I', len(objects)))
+    for name, entries in objects:
+        data.append(struct.pack('<II', name, len(entries)))
+        for key, value in entries:
+            data.append(struct.pack('<II', key, value))
+
+    with open(filename, 'wb') as f:
+        f.write(b''.join(data))
@@ -0,0 +1,425 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#####################################################################
+#
+# Automatic event queue partitioning
+#
+# partition() spreads a system over several event queues (and hence
+# host threads) without the need to set eventq_index by hand. Every
+# CPU seeds a partition that holds the CPU, its children and any
+# object reachable from it through the port graph that is not shared
+# with another CPU (e.g., private caches hanging off a private
+# crossbar). Objects reachable from more than one CPU, and everything
+# behind them, stay on the queue of the Root. CPU partitions are
+# distributed round-robin over queues 1..N-1.
+#
+# Ruby controllers are kept together with their sequencers and their
+# other children, and CPUs that share a controller share a partition.
+# The Ruby network does not tie controllers together, as messages can
+# cross event queues. A SimpleNetwork router joins the partition of
+# the controllers attached to it if they all belong to the same one.
+#
+# A Garnet network is split into regions of routers instead, one per
+# queue apart from the queue of the Root. Meshes are cut into
+# rectangles, other topologies into blocks of consecutive routers. A
+# region holds its routers, their network interfaces and the
+# controllers attached to them, and the CPUs reachable from those
+# controllers. Only the links between regions cross event queues.
+#
+# lookahead() derives the smallest safe synchronization window from
+# the latency parameters of the objects at both ends of every port
+# connection, and the latency of every Ruby link, that crosses
+# partitions.
+#
+#####################################################################
+
+import re
+
+import m5
+from m5.params import Cycles, Latency, isNullPointer, VectorPortRef
+from m5.proxy import isproxy
+from m5.util import fatal, inform
+
+# Parameters that describe how far into the future an object
+# schedules events in response to a request on one of its ports.
+_latency_param_re = re.compile(r'(^|_)(latency|delay)$')
+
+def _port_peers(obj):
+    """Yield the objects connected to the ports of obj"""
+    for ref in obj._port_refs.itervalues():
+        elements = ref.elements if isinstance(ref, VectorPortRef) else [ref]
+        for el in elements:
+            if el.peer is not None and not isproxy(el.peer):
+                yield el.peer.simobj
+
+def _instances(root, type_name):
+    """Objects below root of the given type, if it has been compiled in"""
+    cls = getattr(m5.objects, type_name, None)
+    if cls is None:
+        return []
+    return [ obj for obj in root.descendants() if isinstance(obj, cls) ]
+
+def _ruby_ports(cntrl):
+    """The sequencers and other Ruby ports of a Ruby controller"""
+    cls = m5.objects.RubyPort
+    ports = set(obj for obj in cntrl.descendants() if isinstance(obj, cls))
+    for value in cntrl._values.itervalues():
+        if isinstance(value, cls):
+            ports.add(value)
+    return ports
+
+def _port_graph(root):
+    graph = {}
+    def connect(a, b):
+        graph.setdefault(a, set()).add(b)
+        graph.setdefault(b, set()).add(a)
+
+    # Message buffers connect Ruby controllers to the network through
+    # ports, but pass messages between event queues by themselves.
+    networks = set(_instances(root, 'RubyNetwork'))
+    for obj in root.descendants():
+        graph.setdefault(obj, set())
+        if obj in networks:
+            continue
+        for peer in _port_peers(obj):
+            if peer not in networks:
+                connect(obj, peer)
+
+    # A controller calls into its sequencers, caches and buffers
+    # directly.
+    for cntrl in _instances(root, 'RubyController'):
+        for obj in cntrl.descendants():
+            if obj is not cntrl:
+                connect(cntrl, obj)
+        for port in _ruby_ports(cntrl):
+            connect(cntrl, port)
+    return graph
+
+def _merge_ruby_seeds(root, seeds):
+    """Merge the seeds of CPUs that share a Ruby controller.
+
+    The sequencers of a controller have to be on the queue of the
+    controller, and a CPU has to be on the queue of its sequencers.
+    """
+    seed_of = {}
+    for idx, objs in seeds.iteritems():
+        for obj in objs:
+            seed_of[obj] = idx
+
+    for cntrl in _instances(root, 'RubyController'):
+        idxs = set()
+        for port in _ruby_ports(cntrl):
+            idxs.update(seed_of[peer] for peer in _port_peers(port)
+                        if peer in seed_of)
+        if len(idxs) < 2:
+            continue
+        target = min(idxs)
+        for idx in idxs - set([target]):
+            for obj in seeds.pop(idx):
+                seed_of[obj] = target
+                seeds[target].append(obj)
+
+    return dict(enumerate(seeds[idx] for idx in sorted(seeds)))
+
+def _place_routers(root, owner):
+    """Move routers to the partition of their external nodes"""
+    for network in _instances(root, 'RubyNetwork'):
+        if not isinstance(network, m5.objects.SimpleNetwork):
+            fatal("Ruby can only be split over multiple event queues with "
+                  "the simple network")
+
+        attached = {}
+        for link in network.ext_links:
+            attached.setdefault(link.int_node, set()).add(
+                owner.get(link.ext_node))
+        for router in network.routers:
+            idxs = attached.get(router, set())
+            if len(idxs) == 1 and None not in idxs:
+                idx = iter(idxs).next()
+                for obj in router.descendants():
+                    owner[obj] = idx
+
+def _grid(num_rows, num_cols, num_regions):
+    """Rows and columns of regions to cut a mesh into.
+
+    Uses as many regions as possible without exceeding num_regions,
+    and prefers regions that are close to square.
+    """
+    best = (1, 1)
+    for rows in range(1, min(num_rows, num_regions) + 1):
+        cols = min(num_cols, num_regions // rows)
+        key = (rows * cols, -abs(rows - cols))
+        if key > (best[0] * best[1], -abs(best[0] - best[1])):
+            best = (rows, cols)
+    return best
+
+def _garnet_regions(network, num_regions):
+    """Map the routers of a Garnet network to regions"""
+    routers = sorted(network.routers, key=lambda r: int(r.router_id))
+    num_routers = len(routers)
+    num_rows = int(network.num_rows)
+    region = {}
+    if num_rows > 0:
+        num_cols = num_routers // num_rows
+        grid_rows, grid_cols = _grid(num_rows, num_cols, num_regions)
+        for router in routers:
+            row, col = divmod(int(router.router_id), num_cols)
+            region[router] = (row * grid_rows // num_rows) * grid_cols + \
+                col * grid_cols // num_cols
+    else:
+        count = min(num_routers, num_regions)
+        for idx, router in enumerate(routers):
+            region[router] = idx * count // num_routers
+    return region
+
+def _garnet_seeds(root, num_regions):
+    """Seed a partition with every region of the Garnet networks"""
+    seeds = {}
+    def add(idx, objs):
+        seeds.setdefault(idx, []).extend(objs)
+
+    for network in _instances(root, 'GarnetNetwork'):
+        region = _garnet_regions(network, num_regions)
+        for router, idx in region.iteritems():
+            add(idx, router.descendants())
+
+        if len(network.netifs) != len(network.ext_links):
+            fatal("%s needs one network interface per external link" %
+                  network.path())
+        for link, netif in zip(network.ext_links, network.netifs):
+            idx = region[link.int_node]
+            add(idx, link.descendants())
+            add(idx, link.ext_node.descendants())
+            add(idx, netif.descendants())
+
+        # Flits are sent from the queue of the upstream router, credits
+        # from the queue of the downstream router.
+        for link in network.int_links:
+            add(region[link.src_node], [ link, link.network_link ])
+            add(region[link.dst_node], link.credit_link.descendants())
+
+    return seeds
+
+def _label(seeds, graph):
+    """Find the objects private to each seed in the port graph.
+
+    seeds maps a seed index to the objects that belong to it up
+    front. Labels are flooded through the port graph, and objects
+    reached from more than one seed are marked as shared. Shared
+    objects neither belong to a seed nor forward labels, so the
+    flooding is repeated until the set of shared objects is stable.
+    """
+    shared = set()
+    while True:
+        labels = {}
+        frontier = []
+        for idx, objs in seeds.iteritems():
+            for obj in objs:
+                labels.setdefault(obj, set()).add(idx)
+                frontier.append((obj, idx))
+
+        while frontier:
+            obj, idx = frontier.pop()
+            for peer in graph.get(obj, ()):
+                if peer in shared:
+                    continue
+                peer_labels = labels.setdefault(peer, set())
+                if idx not in peer_labels:
+                    peer_labels.add(idx)
+                    frontier.append((peer, idx))
+
+        new_shared = set(obj for obj, l in labels.iteritems() if len(l) > 1)
+        if new_shared <= shared:
+            return dict((obj, iter(l).next())
+                        for obj, l in labels.iteritems()
+                        if len(l) == 1 and obj not in shared)
+        shared |= new_shared
+
+def partition(root, num_queues):
+    """Assign eventq_index to every object in the hierarchy below root"""
+
+    if num_queues < 2:
+        return
+
+    cpus = [ obj for obj in root.descendants()
+             if isinstance(obj, m5.objects.BaseCPU) ]
+    garnet = _instances(root, 'GarnetNetwork')
+    if not cpus and not garnet:
+        fatal("Automatic event queue partitioning requires CPUs")
+
+    kvm_cpu = getattr(m5.objects, 'BaseKvmCPU', None)
+
+    if garnet:
+        seeds = _garnet_seeds(root, num_queues - 1)
+    else:
+        seeds = {}
+        for idx, cpu in enumerate(cpus):
+            # KVM CPUs access devices directly from their own thread, so
+            # only the CPU itself is moved to a separate queue.
+            if kvm_cpu and isinstance(cpu, kvm_cpu):
+                seeds[idx] = [ cpu ]
+            else:
+                seeds[idx] = list(cpu.descendants())
+        seeds = _merge_ruby_seeds(root, seeds)
+
+    graph = _port_graph(root)
+    for cpu in cpus:
+        if kvm_cpu and isinstance(cpu, kvm_cpu):
+            for peer in graph.pop(cpu, ()):
+                graph[peer].discard(cpu)
+    owner = _label(seeds, graph)
+    if garnet:
+        inform("Partitioned %d Garnet regions over %d event queues",
+               len(seeds), num_queues)
+    else:
+        _place_routers(root, owner)
+
+    for obj in root.descendants():
+        if obj is root:
+            continue
+        idx = owner.get(obj)
+        if idx is None:
+            obj.eventq_index = int(root.eventq_index)
+        else:
+            obj.eventq_index = 1 + idx % (num_queues - 1)
+
+    if not garnet:
+        inform("Partitioned %d CPUs over %d event queues", len(cpus),
+               num_queues)
+
+def _queues_assigned(root):
+    """Have event queues been assigned by hand below root?"""
+    for obj in root.descendants():
+        if not isproxy(obj.eventq_index) and \
+           int(obj.eventq_index) != int(root.eventq_index):
+            return True
+    return False
+
+def partition_kvm(root):
+    """Run every KVM CPU on its own event queue (and host thread)
+
+    This only applies to systems whose CPUs are all KVM CPUs, and
+    where no event queue has been assigned by hand. Returns the number
+    of event queues, or None if the system was left alone.
+    """
+
+    kvm_cpu = getattr(m5.objects, 'BaseKvmCPU', None)
+    if kvm_cpu is None:
+        return None
+
+    cpus = [ obj for obj in root.descendants()
+             if isinstance(obj, m5.objects.BaseCPU) ]
+    if len(cpus) < 2 or not all(isinstance(c, kvm_cpu) for c in cpus):
+        return None
+    if _queues_assigned(root):
+        return None
+
+    partition(root, len(cpus) + 1)
+    return len(cpus) + 1
+
+def _clock_period(obj):
+    """Smallest clock period (in ticks) of obj, or None if unclocked"""
+    try:
+        domain = obj.clk_domain
+    except AttributeError:
+        return None
+
+    divider = 1
+    while hasattr(domain, 'clk_divider'):
+        divider *= int(domain.clk_divider)
+        domain = domain.clk_domain
+
+    clocks = domain.clock
+    if not isinstance(clocks, (list, tuple)):
+        clocks = [ clocks ]
+    return min(c.getValue() for c in clocks) * divider
+
+def _min_latency(obj):
+    """Smallest non-zero latency parameter of obj, in ticks"""
+    latencies = []
+    for name, desc in obj._params.iteritems():
+        if not _latency_param_re.search(name):
+            continue
+        value = getattr(obj, name, None)
+        if value is None or isproxy(value) or isNullPointer(value):
+            continue
+        if isinstance(value, Cycles):
+            period = _clock_period(obj)
+            if period is not None:
+                latencies.append(int(value) * period)
+        elif isinstance(value, Latency):
+            latencies.append(value.getValue())
+
+    latencies = [ l for l in latencies if l > 0 ]
+    return min(latencies) if latencies else None
+
+def _crossing_latency(obj, peer):
+    """Smallest latency of the objects at the ends of a connection"""
+    ends = [ l for l in (_min_latency(obj), _min_latency(peer))
+             if l is not None ]
+    if not ends:
+        fatal("Can't derive the lookahead between %s and %s, "
+              "set sim_quantum explicitly" % (obj.path(), peer.path()))
+    return min(ends)
+
+def _ruby_link_latencies(root):
+    """Latencies of the Ruby links between event queues"""
+    for network in _instances(root, 'RubyNetwork'):
+        for link in network.int_links:
+            src, dst = link.src_node, link.dst_node
+            if int(src.eventq_index) != int(dst.eventq_index):
+                yield int(link.latency) * _clock_period(src)
+
+        for link in network.ext_links:
+            cntrl, router = link.ext_node, link.int_node
+            if int(cntrl.eventq_index) != int(router.eventq_index):
+                # Messages to the controller are delayed by the link,
+                # messages from it by the controller itself.
+                yield int(link.latency) * _clock_period(router)
+                latency = _min_latency(cntrl)
+                if latency is None:
+                    fatal("Can't derive the lookahead between %s and %s, "
+                          "set sim_quantum explicitly" % (cntrl.path(),
+                                                          router.path()))
+                yield latency
+
+def lookahead(root):
+    """Smallest latency of a connection between event queues"""
+
+    networks = set(_instances(root, 'RubyNetwork'))
+    latencies = []
+    for obj in root.descendants():
+        for peer in _port_peers(obj):
+            if int(obj.eventq_index) == int(peer.eventq_index):
+                continue
+            # Ruby networks are covered by their links
+            if obj in networks or peer in networks:
+                continue
+            latencies.append(_crossing_latency(obj, peer))
+
+    latencies += _ruby_link_latencies(root)
+    return min(latencies) if latencies else None
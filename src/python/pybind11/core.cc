@@ -45,6 +45,7 @@
  */
 
 #include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
 
 #include "python/pybind11/core.hh"
 
@@ -57,6 +58,8 @@
 #include "base/socket.hh"
 #include "base/types.hh"
 #include "sim/core.hh"
+#include "sim/cxx_config_bin.hh"
+#include "sim/cxx_manager.hh"
 #include "sim/drain.hh"
 #include "sim/serialize.hh"
 #include "sim/sim_object.hh"
@@ -74,6 +77,9 @@ PybindSimObjectResolver pybindSimObjectResolver;
 SimObject *
 PybindSimObjectResolver::resolveSimObject(const std::string &name)
 {
+    // Objects may be restored on several threads, see loadStateAll
+    py::gil_scoped_acquire gil;
+
     // TODO
     py::module m = py::module::import("m5.SimObject");
     auto f = m.attr("resolveSimObject");
@@ -117,11 +123,15 @@ init_drain(py::module &m_native)
     py::class_<DrainManager, std::unique_ptr<DrainManager, py::nodelete>>(
         m, "DrainManager")
         .def("tryDrain", &DrainManager::tryDrain)
+        .def("tryDrainObjects", &DrainManager::tryDrainObjects)
         .def("resume", &DrainManager::resume)
         .def("preCheckpointRestore", &DrainManager::preCheckpointRestore)
         .def("isDrained", &DrainManager::isDrained)
+        .def("isPartiallyDrained", &DrainManager::isPartiallyDrained)
         .def("state", &DrainManager::state)
         .def("signalDrainDone", &DrainManager::signalDrainDone)
+        .def("slowestDrainables", &DrainManager::slowestDrainables,
+             py::arg("count") = 10)
         .def_static("instance", &DrainManager::instance,
                     py::return_value_policy::reference)
         ;
@@ -242,7 +252,10 @@ pybind_init_core(py::module &m_native)
         .def("disableAllListeners", &ListenSocket::disableAll)
         .def("listenersDisabled", &ListenSocket::allDisabled)
         .def("listenersLoopbackOnly", &ListenSocket::loopbackOnly)
-        .def("seedRandom", [](uint64_t seed) { random_mt.init(seed); })
+        .def("seedRandom", [](uint64_t seed) {
+                random_mt.init(seed);
+                RandomStream::setGlobalSeed(seed);
+            })
 
 
         .def("setClockFrequency", &setClockFrequency)
@@ -264,6 +277,9 @@ pybind_init_core(py::module &m_native)
      */
     m_core
         .def("serializeAll", &Serializable::serializeAll)
+        .def("setBinaryCheckpoints", [](bool binary) {
+            Serializable::binaryFormat = binary;
+        })
         .def("unserializeGlobals", &Serializable::unserializeGlobals)
         .def("getCheckpoint", [](const std::string &cpt_dir) {
             return new CheckpointIn(cpt_dir, pybindSimObjectResolver);
@@ -271,6 +287,56 @@ pybind_init_core(py::module &m_native)
 
         ;
 
+    /*
+     * Config caches, which are instantiated by the C++ config manager
+     * rather than from Python
+     */
+    py::class_<CxxConfigFileBase>(m_core, "CxxConfigFileBase");
+
+    py::class_<CxxBinFile, CxxConfigFileBase>(m_core, "CxxBinFile")
+        .def(py::init<>())
+        .def("load", &CxxBinFile::load)
+        .def("ticksPerSecond", &CxxBinFile::ticksPerSecond)
+        ;
+
+    py::class_<CxxConfigManager>(m_core, "CxxConfigManager")
+        .def(py::init([](CxxConfigFileBase &config_file) {
+                 // the directory of SimObject types is only populated
+                 // when building with --with-cxx-config
+                 if (cxx_config_directory.empty())
+                     cxxConfigInit();
+                 if (cxx_config_directory.empty()) {
+                     fatal("Instantiating a config cache needs a gem5 "
+                           "built with --with-cxx-config\n");
+                 }
+                 return new CxxConfigManager(config_file);
+             }), py::keep_alive<1, 2>())
+        .def("instantiate", [](CxxConfigManager &manager) {
+                try {
+                    manager.instantiate();
+                } catch (CxxConfigManager::Exception &e) {
+                    fatal("Config problem in sim object %s: %s\n",
+                          e.name, e.message);
+                }
+            })
+        .def("initState", &CxxConfigManager::initState)
+        .def("startup", &CxxConfigManager::startup)
+        ;
+
+    /*
+     * Setup phases that SimObjects may run in parallel
+     */
+    py::enum_<SimObject::SetupPhase>(m_core, "SetupPhase")
+        .value("Init", SimObject::SetupPhase::Init)
+        .value("RegStats", SimObject::SetupPhase::RegStats)
+        ;
+
+    m_core
+        .def("setupAll", &SimObject::setupAll)
+        // The workers need the GIL to resolve object names
+        .def("loadStateAll", &SimObject::loadStateAll,
+             py::call_guard<py::gil_scoped_release>())
+        ;
 
     init_drain(m_native);
     init_serialize(m_native);
@@ -51,6 +51,7 @@
 #include "base/debug.hh"
 #include "base/output.hh"
 #include "base/trace.hh"
+#include "mem/port_trace.hh"
 #include "sim/debug.hh"
 
 namespace py = pybind11;
@@ -70,6 +71,18 @@ output(const char *filename)
     Trace::setDebugLogger(new Trace::OstreamLogger(*file_stream->stream()));
 }
 
+static void
+outputBinary(const char *filename, size_t ring_size)
+{
+    OutputStream *file_stream = simout.find(filename);
+
+    if (!file_stream)
+        file_stream = simout.create(filename, true);
+
+    Trace::setDebugLogger(
+        new Trace::BinaryLogger(*file_stream->stream(), ring_size));
+}
+
 static void
 ignore(const char *expr)
 {
@@ -93,6 +106,11 @@ pybind_init_debug(py::module &m_native)
 
         .def("schedBreak", &schedBreak)
         .def("setRemoteGDBPort", &setRemoteGDBPort)
+
+        .def("configurePortTraces", &PortTrace::configure)
+        .def("dumpPortTraces", [](const std::string &file_name) {
+                PortTrace::dumpAll(file_name);
+            })
         ;
 
     py::class_<Debug::Flag> c_flag(m_debug, "Flag");
@@ -112,6 +130,8 @@ pybind_init_debug(py::module &m_native)
     py::module m_trace = m_native.def_submodule("trace");
     m_trace
         .def("output", &output)
+        .def("outputBinary", &outputBinary,
+             py::arg("filename"), py::arg("ring_size") = 0)
         .def("ignore", &ignore)
         .def("enable", &Trace::enable)
         .def("disable", &Trace::disable)
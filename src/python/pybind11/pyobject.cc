@@ -50,6 +50,7 @@
 #include "dev/net/etherdevice.hh"
 #include "dev/net/etherint.hh"
 #include "dev/net/etherobject.hh"
+#include "dev/virtio/net.hh"
 
 #endif
 
@@ -65,7 +66,8 @@ lookupEthPort(SimObject *so, const std::string &name, int i)
 {
     EtherObject *eo = dynamic_cast<EtherObject *>(so);
     EtherDevice *ed = dynamic_cast<EtherDevice *>(so);
-    if (eo == NULL && ed == NULL) {
+    VirtIONet *vn = dynamic_cast<VirtIONet *>(so);
+    if (eo == NULL && ed == NULL && vn == NULL) {
         warn("error casting SimObject %s", so->name());
         return NULL;
     }
@@ -73,8 +75,10 @@ lookupEthPort(SimObject *so, const std::string &name, int i)
     EtherInt *p = NULL;
     if (eo)
         p = eo->getEthPort(name, i);
-    else
+    else if (ed)
         p = ed->getEthPort(name, i);
+    else
+        p = vn->getEthPort(name, i);
     return p;
 }
 #endif
@@ -91,12 +95,15 @@ connectPorts(SimObject *o1, const std::string &name1, int i1,
 #if THE_ISA != NULL_ISA
     EtherObject *eo1, *eo2;
     EtherDevice *ed1, *ed2;
+    VirtIONet *vn1, *vn2;
     eo1 = dynamic_cast<EtherObject*>(o1);
     ed1 = dynamic_cast<EtherDevice*>(o1);
+    vn1 = dynamic_cast<VirtIONet*>(o1);
     eo2 = dynamic_cast<EtherObject*>(o2);
     ed2 = dynamic_cast<EtherDevice*>(o2);
+    vn2 = dynamic_cast<VirtIONet*>(o2);
 
-    if ((eo1 || ed1) && (eo2 || ed2)) {
+    if ((eo1 || ed1 || vn1) && (eo2 || ed2 || vn2)) {
         EtherInt *p1 = lookupEthPort(o1, name1, i1);
         EtherInt *p2 = lookupEthPort(o2, name2, i2);
 
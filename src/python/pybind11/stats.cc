@@ -45,6 +45,8 @@
 #include "pybind11/stl.h"
 
 #include "base/statistics.hh"
+#include "base/stats/background.hh"
+#include "base/stats/binary.hh"
 #include "base/stats/text.hh"
 #include "sim/stat_control.hh"
 #include "sim/stat_register.hh"
@@ -77,6 +79,10 @@ pybind_init_stats(py::module &m_native)
     m
         .def("initSimStats", &Stats::initSimStats)
         .def("initText", &Stats::initText, py::return_value_policy::reference)
+        .def("initBinary", &Stats::initBinary,
+             py::return_value_policy::reference)
+        .def("initBackground", &Stats::initBackground,
+             py::return_value_policy::reference)
         .def("registerPythonStatsHandlers",
              &Stats::registerPythonStatsHandlers)
         .def("schedStatEvent", &Stats::schedStatEvent)
@@ -84,9 +90,17 @@ pybind_init_stats(py::module &m_native)
         .def("updateEvents", &Stats::updateEvents)
         .def("processResetQueue", &Stats::processResetQueue)
         .def("processDumpQueue", &Stats::processDumpQueue)
+        .def("processPrepareQueue", &Stats::processPrepareQueue)
         .def("enable", &Stats::enable)
         .def("enabled", &Stats::enabled)
         .def("statsList", &Stats::statsList)
+        .def("enableStorageArena", []() {
+                Stats::StorageArena::enabled = true;
+            })
+        .def("setStatsOrder", &Stats::setStatsOrder)
+        .def("prepareAll", &Stats::prepareAll)
+        .def("visitAll", &Stats::visitAll)
+        .def("resetAll", &Stats::resetAll)
         ;
 
     py::class_<Stats::Output>(m, "Output")
@@ -95,6 +109,22 @@ pybind_init_stats(py::module &m_native)
         .def("valid", &Stats::Output::valid)
         ;
 
+    // Exposes the counters of a stat through the buffer protocol, so
+    // that e.g. numpy.asarray() reads them in place without copying.
+    py::class_<Stats::CounterView>(m, "CounterView", py::buffer_protocol())
+        .def_buffer([](Stats::CounterView &view) {
+                return py::buffer_info(
+                    const_cast<Stats::Counter *>(view.data),
+                    sizeof(Stats::Counter),
+                    py::format_descriptor<Stats::Counter>::format(),
+                    view.shape.size(),
+                    std::vector<ssize_t>(view.shape.begin(),
+                                         view.shape.end()),
+                    std::vector<ssize_t>(view.strides.begin(),
+                                         view.strides.end()));
+            })
+        ;
+
     py::class_<Stats::Info>(m, "Info")
         .def_readwrite("name", &Stats::Info::name)
         .def_readonly("desc", &Stats::Info::desc)
@@ -109,5 +139,11 @@ pybind_init_stats(py::module &m_native)
         .def("reset", &Stats::Info::reset)
         .def("zero", &Stats::Info::zero)
         .def("visit", &Stats::Info::visit)
+        .def("counters", [](const Stats::Info &info) -> py::object {
+                Stats::CounterView view = info.counters();
+                if (!view.data)
+                    return py::none();
+                return py::cast(view);
+            })
         ;
 }
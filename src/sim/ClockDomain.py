@@ -47,6 +47,13 @@ class ClockDomain(SimObject):
     cxx_header = "sim/clock_domain.hh"
     abstract = True
 
+    # Service all Ticked objects in the domain (e.g., Minor CPU
+    # pipelines) from a single event per edge instead of one event per
+    # object. Objects are evaluated in construction order, which may
+    # differ from the order of their individual events.
+    cycle_wheel = Param.Bool(False, "Use a shared clock event for "
+                             "ticked objects")
+
 # Source clock domain with an actual clock, and a list of voltage and frequency
 # op points
 class SrcClockDomain(ClockDomain):
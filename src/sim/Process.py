@@ -47,6 +47,12 @@ class Process(SimObject):
     kvmInSE = Param.Bool('false', 'initialize the process for KvmCPU in SE')
     maxStackSize = Param.MemorySize('64MB', 'maximum size of the stack')
 
+    # Files opened read-only can be read ahead on a host thread while
+    # the guest consumes them, which hides the latency of slow host
+    # file systems. This does not change what the guest sees.
+    read_ahead = Param.MemorySize('0B',
+        'bytes to read ahead of sequential file reads (0 disables)')
+
     uid = Param.Int(100, 'user id')
     euid = Param.Int(100, 'effective user id')
     gid = Param.Int(100, 'group id')
@@ -32,6 +32,17 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.util import fatal
 
+# Data structure used by the main event queues to keep events sorted.
+# 'List' is a sorted linked list, 'Calendar' is a calendar queue with
+# near constant time insertion that keeps the same event order.
+class EventQueueEngine(Enum): vals = ['List', 'Calendar']
+
+# How multiple event queues synchronize. 'Fixed' synchronizes every
+# sim_quantum ticks. 'Lookahead' treats sim_quantum as the smallest
+# delay between queues and lets all queues run until sim_quantum ticks
+# past the earliest pending event in the system.
+class SimQuantumMode(Enum): vals = ['Fixed', 'Lookahead']
+
 class Root(SimObject):
 
     _the_instance = None
@@ -67,6 +78,43 @@ class Root(SimObject):
     # Simulation Quantum for multiple main event queue simulation.
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
+    sim_quantum_mode = Param.SimQuantumMode('Fixed',
+        "how multiple event queues synchronize")
+
+    # Spread the system over this many event queues automatically
+    # based on the CPUs and the port graph, see m5.util.partition. If
+    # sim_quantum is left at 0 in Lookahead mode, it is derived from
+    # the latency of the connections between queues.
+    auto_event_queues = Param.UInt32(0,
+        "number of event queues to partition the system into (0 disables)")
+
+    # Systems with several KVM CPUs, and nothing else, run each CPU on
+    # its own event queue by default unless queues are assigned by hand.
+    # The queues synchronize every kvm_sim_quantum unless sim_quantum
+    # is set.
+    kvm_event_queues = Param.Bool(True,
+        "run each KVM CPU on its own event queue and host thread")
+    kvm_sim_quantum = Param.Latency('1ms',
+        "simulation quantum when running KVM CPUs on separate queues")
+
+    eventq_engine = Param.EventQueueEngine('List',
+        "data structure used to keep the main event queues sorted")
+
+    packet_queue_warn_size = Param.Unsigned(100,
+        "warn when a packet queue grows beyond this size (0 disables)")
+
+    # Record the host time spent on every type of event and write it
+    # to a JSON file in the output directory on every stats dump.
+    profile_events = Param.Bool(False,
+        "profile the host time spent processing events")
+    event_profile_file = Param.String("event_profile.json",
+        "file to write the event profile to")
+
+    # Charge the host cycles, instructions and cache misses spent on
+    # every event to the SimObject that owns it, reported as
+    # <object>.host_cycles etc. in the stats.
+    host_perf_counters = Param.Bool(False,
+        "attribute host performance counters to SimObjects")
 
     full_system = Param.Bool("if this is a full system simulation")
 
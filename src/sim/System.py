@@ -51,6 +51,9 @@ from SimpleMemory import *
 class MemoryMode(Enum): vals = ['invalid', 'atomic', 'timing',
                                 'atomic_noncaching']
 
+# Host pages used for the backing store of the simulated memories
+class BackingStorePages(Enum): vals = ['normal', 'transparent', 'hugetlb']
+
 class System(MemObject):
     type = 'System'
     cxx_header = "sim/system.hh"
@@ -65,6 +68,15 @@ class System(MemObject):
                                           "All memories in the system")
     mem_mode = Param.MemoryMode('atomic', "The mode the memory system is in")
 
+    # Syscall emulation normally copies guest buffers with functional
+    # packets through the memory system, so that they see any data
+    # held in caches. Systems without caches (or with caches that are
+    # known to be clean at syscalls) can instead let it copy directly
+    # to and from the backing store. This is always done when caches
+    # are bypassed.
+    se_direct_memory_access = Param.Bool(False,
+        "Copy syscall buffers directly to and from the backing store")
+
     thermal_model = Param.ThermalModel(NULL, "Thermal model")
     thermal_components = VectorParam.SimObject([],
             "A collection of all thermal components in the system.")
@@ -76,6 +88,65 @@ class System(MemObject):
     mmap_using_noreserve = Param.Bool(False, "mmap the backing store " \
                                           "without reserving swap")
 
+    # Large memories suffer from host TLB misses on every functional
+    # access. The backing store can be advised to use transparent huge
+    # pages, or be mapped from the hugetlb pool (which the host admin
+    # has to reserve). The latter falls back to transparent huge pages
+    # if the pool is exhausted.
+    backing_store_pages = Param.BackingStorePages('normal',
+        "Host pages to back the simulated memories with")
+
+    # Backing stores can be bound to host NUMA nodes. The store of a
+    # memory prefers the node at position eventq_index (modulo the
+    # number of nodes), so memories accessed by a particular event
+    # queue thread live close to it when that thread is pinned to the
+    # same node. Allocations spill over to other nodes when the
+    # preferred one is full.
+    backing_store_numa_nodes = VectorParam.UInt32([],
+        "Host NUMA nodes to bind backing stores to, by event queue")
+
+    # Faulting in a large backing store on demand, one page at a time,
+    # can dominate start-up. The store can instead be touched up front
+    # by a number of host threads.
+    backing_store_prefault_threads = Param.Unsigned(0,
+        "Host threads used to pre-fault the backing store (0 to disable)")
+
+    # Compressed memory images are small, but have to be read in their
+    # entirety on restore. Uncompressed images are written as sparse
+    # files and mapped copy-on-write on restore, so that only the pages
+    # touched by the simulation are ever read.
+    compress_checkpoint_memory = Param.Bool(True,
+        "Compress the memory images stored in checkpoints")
+
+    # A single gzip stream can only be compressed by one thread. With
+    # a non-zero number of threads, compressed memory images are
+    # instead split into blocks that are compressed (and decompressed
+    # on restore) independently, with an index at the end of the file.
+    # Blocks that are all zero are not stored at all.
+    checkpoint_memory_threads = Param.Unsigned(0,
+        "Host threads compressing memory image blocks (0 for a gzip stream)")
+    checkpoint_memory_block_size = Param.MemorySize('4MB',
+        "Size of the independently compressed memory image blocks")
+
+    # When taking many checkpoints along one execution, each one after
+    # the first can store only the memory pages that changed since the
+    # previous one. Such a checkpoint refers to the memory images of
+    # the earlier checkpoints by path, so they must not be moved or
+    # deleted while it is in use.
+    incremental_checkpoint_memory = Param.Bool(False,
+        "Only store the memory pages changed since the last checkpoint")
+
+    # With tickless timers, the local timers of the cores (x86 local
+    # APIC, Arm generic timer) share one event per event queue, and
+    # timers whose interrupt is masked are not scheduled at all; their
+    # state is computed when the guest reads it. The expiry of the
+    # timers of idle cores may be delayed by up to the slack, so that
+    # the periodic ticks of many idle cores are handled together.
+    tickless_timers = Param.Bool(False,
+        "Handle the per-core timers with a shared event")
+    tickless_timer_slack = Param.Latency('0ns',
+        "Maximum delay of the timer interrupts of idle cores")
+
     # The memory ranges are to be populated when creating the system
     # such that these can be passed from the I/O subsystem through an
     # I/O bridge or cache
@@ -100,6 +171,12 @@ class System(MemObject):
     work_cpus_ckpt_count = Param.Counter(0,
         "create checkpoint when active cpu count value is reached")
 
+    region_stats = VectorParam.String([], "Stats sampled at each "
+        "m5_region_begin/end and accumulated per region, in addition to "
+        "ticks, cycles and instructions")
+    region_file = Param.String("regions.txt", "File the per-region totals "
+        "are written to at exit")
+
     init_param = Param.UInt64(0, "numerical value to pass into simulator")
     boot_osflags = Param.String("a", "boot flags to pass to the kernel")
     kernel = Param.String("", "file that contains the kernel code")
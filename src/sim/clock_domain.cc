@@ -47,6 +47,7 @@
 #include <algorithm>
 #include <functional>
 
+#include "base/cprintf.hh"
 #include "base/trace.hh"
 #include "debug/ClockDomain.hh"
 #include "params/ClockDomain.hh"
@@ -77,6 +78,44 @@ ClockDomain::voltage() const
     return _voltageDomain->voltage();
 }
 
+void
+ClockDomain::setClockPeriod(Tick clock_period)
+{
+    // Nobody to tell about the change
+    if (members.empty()) {
+        _clockPeriod = clock_period;
+        return;
+    }
+
+    if (periodChanges.size() == maxPeriodChanges) {
+        // Bring all the members up to date so that the history can
+        // be dropped, this is rare enough to be amortised over the
+        // changes that came before
+        for (auto m : members)
+            m->updateClockPeriod();
+        periodChanges.clear();
+    }
+
+    periodChanges.push_back({curTick(), _clockPeriod});
+    ++_epoch;
+    _clockPeriod = clock_period;
+}
+
+CycleWheel *
+ClockDomain::cycleWheel(EventQueue *eventq, Event::Priority priority)
+{
+    if (!useCycleWheel)
+        return nullptr;
+
+    std::unique_ptr<CycleWheel> &wheel = wheels[{eventq, priority}];
+    if (!wheel) {
+        wheel.reset(new CycleWheel(
+            csprintf("%s.wheel%d", name(), wheels.size() - 1),
+            eventq, priority));
+    }
+    return wheel.get();
+}
+
 SrcClockDomain::SrcClockDomain(const Params *p) :
     ClockDomain(p, p->voltage_domain),
     freqOpPoints(p->clock),
@@ -118,12 +157,9 @@ SrcClockDomain::clockPeriod(Tick clock_period)
         fatal("%s has a clock period of zero\n", name());
     }
 
-    // Align all members to the current tick
-    for (auto m = members.begin(); m != members.end(); ++m) {
-        (*m)->updateClockPeriod();
-    }
-
-    _clockPeriod = clock_period;
+    // Members align themselves to the current tick when they next
+    // use their clock
+    setClockPeriod(clock_period);
 
     DPRINTF(ClockDomain,
             "Setting clock period to %d ticks for source clock %s\n",
@@ -214,14 +250,10 @@ DerivedClockDomain::DerivedClockDomain(const Params *p) :
 void
 DerivedClockDomain::updateClockPeriod()
 {
-    // Align all members to the current tick
-    for (auto m = members.begin(); m != members.end(); ++m) {
-        (*m)->updateClockPeriod();
-    }
-
     // recalculate the clock period, relying on the fact that changes
-    // propagate downwards in the tree
-    _clockPeriod = parent.clockPeriod() * clockDivider;
+    // propagate downwards in the tree, members align themselves to
+    // the current tick when they next use their clock
+    setClockPeriod(parent.clockPeriod() * clockDivider);
 
     DPRINTF(ClockDomain,
             "Setting clock period to %d ticks for derived clock %s\n",
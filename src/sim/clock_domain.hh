@@ -50,11 +50,16 @@
 #define __SIM_CLOCK_DOMAIN_HH__
 
 #include <algorithm>
+#include <deque>
+#include <map>
+#include <memory>
+#include <utility>
 
 #include "base/statistics.hh"
 #include "params/ClockDomain.hh"
 #include "params/DerivedClockDomain.hh"
 #include "params/SrcClockDomain.hh"
+#include "sim/cycle_wheel.hh"
 #include "sim/sim_object.hh"
 
 /**
@@ -73,8 +78,36 @@ class Clocked;
 class ClockDomain : public SimObject
 {
 
+  public:
+
+    /**
+     * A change of the clock period. Members that haven't seen the
+     * change yet have to align themselves to the tick of the change
+     * using the period that was in use before it.
+     */
+    struct PeriodChange
+    {
+        /** Tick at which the period changed */
+        Tick when;
+        /** Clock period before the change */
+        Tick period;
+    };
+
   private:
 
+    /**
+     * Number of period changes kept for the members to catch up
+     * with. When exceeded, all members are brought up to date and the
+     * history is dropped.
+     */
+    static const size_t maxPeriodChanges = 64;
+
+    /** Number of period changes so far */
+    uint64_t _epoch;
+
+    /** The most recent period changes, ending with the current epoch */
+    std::deque<PeriodChange> periodChanges;
+
     /**
      * Stat to report clock period of clock domain
      */
@@ -105,13 +138,33 @@ class ClockDomain : public SimObject
      */
     std::vector<Clocked *> members;
 
+    /**
+     * Shared clock events of the Ticked members, one per event queue
+     * and priority, if enabled.
+     */
+    std::map<std::pair<EventQueue *, Event::Priority>,
+             std::unique_ptr<CycleWheel>> wheels;
+
+    const bool useCycleWheel;
+
+    /**
+     * Change the clock period. Rather than aligning every member to
+     * the current tick, the change is recorded and the members catch
+     * up the next time they look at their clock.
+     *
+     * @param clock_period The new clock period in ticks
+     */
+    void setClockPeriod(Tick clock_period);
+
   public:
 
     typedef ClockDomainParams Params;
     ClockDomain(const Params *p, VoltageDomain *voltage_domain) :
         SimObject(p),
+        _epoch(0),
         _clockPeriod(0),
-        _voltageDomain(voltage_domain) {}
+        _voltageDomain(voltage_domain),
+        useCycleWheel(p->cycle_wheel) {}
 
     void regStats();
 
@@ -122,6 +175,29 @@ class ClockDomain : public SimObject
      */
     Tick clockPeriod() const { return _clockPeriod; }
 
+    /**
+     * Get the number of clock period changes so far, which members
+     * compare against to see if they have to catch up.
+     */
+    uint64_t epoch() const { return _epoch; }
+
+    /**
+     * Get the period changes a member has missed.
+     *
+     * @param epoch The epoch the member last caught up with
+     * @param[out] first The first change that was missed
+     * @return The number of changes that were missed
+     */
+    size_t
+    periodChangesSince(uint64_t epoch,
+                       std::deque<PeriodChange>::const_iterator &first) const
+    {
+        size_t missed = _epoch - epoch;
+        assert(missed <= periodChanges.size());
+        first = periodChanges.end() - missed;
+        return missed;
+    }
+
     /**
      * Register a Clocked object with this ClockDomain.
      *
@@ -157,6 +233,14 @@ class ClockDomain : public SimObject
     void addDerivedDomain(DerivedClockDomain *clock_domain)
     { children.push_back(clock_domain); }
 
+    /**
+     * Get the shared clock event for Ticked members that run on an
+     * event queue with a given priority.
+     *
+     * @return The cycle wheel, or NULL if cycle wheels are disabled
+     */
+    CycleWheel *cycleWheel(EventQueue *eventq, Event::Priority priority);
+
 };
 
 /**
@@ -43,6 +43,20 @@
 #include "base/logging.hh"
 #include "sim/power/power_model.hh"
 
+void
+Clocked::catchUp() const
+{
+    std::deque<ClockDomain::PeriodChange>::const_iterator change;
+    size_t missed = clockDomain.periodChangesSince(epoch, change);
+
+    // Each change aligned us to the tick it happened at, using the
+    // period that was in use until then
+    for (; missed > 0; --missed, ++change)
+        align(change->when, change->period);
+
+    epoch = clockDomain.epoch();
+}
+
 ClockedObject::ClockedObject(const ClockedObjectParams *p) :
     SimObject(p), Clocked(*p->clk_domain),
     _currPwrState(p->default_p_state),
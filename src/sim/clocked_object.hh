@@ -74,33 +74,57 @@ class Clocked
     // 'tick'
     mutable Cycles cycle;
 
+    // The clock domain epoch that 'tick' and 'cycle' account for
+    mutable uint64_t epoch;
+
     /**
-     *  Align cycle and tick to the next clock edge if not already done. When
-     *  complete, tick must be at least curTick().
+     * Align cycle and tick to the first clock edge at or after a
+     * given tick.
+     *
+     * @param when Tick to align to
+     * @param period Clock period to advance by
      */
-    void update() const
+    void align(Tick when, Tick period) const
     {
         // both tick and cycle are up-to-date and we are done, note
         // that the >= is important as it captures cases where tick
-        // has already passed curTick()
-        if (tick >= curTick())
+        // has already passed when
+        if (tick >= when)
             return;
 
         // optimise for the common case and see if the tick should be
         // advanced by a single clock period
-        tick += clockPeriod();
+        tick += period;
         ++cycle;
 
         // see if we are done at this point
-        if (tick >= curTick())
+        if (tick >= when)
             return;
 
         // if not, we have to recalculate the cycle and tick, we
         // perform the calculations in terms of relative cycles to
         // allow changes to the clock period in the future
-        Cycles elapsedCycles(divCeil(curTick() - tick, clockPeriod()));
+        Cycles elapsedCycles(divCeil(when - tick, period));
         cycle += elapsedCycles;
-        tick += elapsedCycles * clockPeriod();
+        tick += elapsedCycles * period;
+    }
+
+    /**
+     * Replay the clock period changes of the domain that happened
+     * since the last update.
+     */
+    void catchUp() const;
+
+    /**
+     *  Align cycle and tick to the next clock edge if not already done. When
+     *  complete, tick must be at least curTick().
+     */
+    void update() const
+    {
+        if (epoch != clockDomain.epoch())
+            catchUp();
+
+        align(curTick(), clockPeriod());
     }
 
     /**
@@ -115,7 +139,8 @@ class Clocked
      * parameters.
      */
     Clocked(ClockDomain &clk_domain)
-        : tick(0), cycle(0), clockDomain(clk_domain)
+        : tick(0), cycle(0), epoch(clk_domain.epoch()),
+          clockDomain(clk_domain)
     {
         // Register with the clock domain, so that if the clock domain
         // frequency changes, we can update this object's tick.
@@ -140,6 +165,7 @@ class Clocked
         Cycles elapsedCycles(divCeil(curTick(), clockPeriod()));
         cycle = elapsedCycles;
         tick = elapsedCycles * clockPeriod();
+        epoch = clockDomain.epoch();
     }
 
   public:
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/cxx_config_bin.hh"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "base/logging.hh"
+#include "base/str.hh"
+
+static const char configCacheMagic[8] = {
+    'g', 'e', 'm', '5', 'c', 'f', 'g', '\0' };
+static const uint32_t configCacheVersion = 1;
+
+bool
+CxxBinFile::getParam(const std::string &object_name,
+    const std::string &param_name,
+    std::string &value) const
+{
+    auto object = objects.find(object_name);
+    if (object == objects.end())
+        return false;
+
+    auto entry = object->second.find(param_name);
+    if (entry == object->second.end())
+        return false;
+
+    value = strings[entry->second];
+    return true;
+}
+
+bool
+CxxBinFile::getParamVector(const std::string &object_name,
+    const std::string &param_name,
+    std::vector<std::string> &values) const
+{
+    std::string value;
+    bool ret = getParam(object_name, param_name, value);
+
+    if (ret)
+        tokenize(values, value, ' ', true);
+
+    return ret;
+}
+
+bool
+CxxBinFile::getPortPeers(const std::string &object_name,
+    const std::string &port_name,
+    std::vector<std::string> &peers) const
+{
+    return getParamVector(object_name, port_name, peers);
+}
+
+bool
+CxxBinFile::objectExists(const std::string &object) const
+{
+    return objects.find(object) != objects.end();
+}
+
+void
+CxxBinFile::getAllObjectNames(std::vector<std::string> &list) const
+{
+    list.insert(list.end(), objectNames.begin(), objectNames.end());
+}
+
+void
+CxxBinFile::getObjectChildren(const std::string &object_name,
+    std::vector<std::string> &children, bool return_paths) const
+{
+    if (!getParamVector(object_name, "children", children))
+        return;
+
+    if (return_paths && object_name != "root") {
+        for (auto i = children.begin(); i != children.end(); ++i)
+            *i = object_name + "." + *i;
+    }
+}
+
+bool
+CxxBinFile::load(const std::string &filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    char magic[sizeof(configCacheMagic)];
+    if (!file.read(magic, sizeof(magic)) ||
+        memcmp(magic, configCacheMagic, sizeof(magic)) != 0)
+        return false;
+
+    uint32_t version;
+    if (!file.read((char *)&version, sizeof(version)) ||
+        version != configCacheVersion) {
+        warn("Unsupported config cache version in '%s'\n", filename);
+        return false;
+    }
+
+    uint64_t ticks_per_second;
+    if (!file.read((char *)&ticks_per_second, sizeof(ticks_per_second)))
+        return false;
+
+    const std::vector<char> buf((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>());
+
+    const char *p = buf.data();
+    const char *end = p + buf.size();
+    bool truncated = false;
+    auto get_u32 = [&]() {
+        uint32_t v = 0;
+        if (end - p < (ptrdiff_t)sizeof(v)) {
+            truncated = true;
+            p = end;
+        } else {
+            memcpy(&v, p, sizeof(v));
+            p += sizeof(v);
+        }
+        return v;
+    };
+    auto get_string = [&]() -> const std::string & {
+        static const std::string invalid;
+        const uint32_t idx = get_u32();
+        if (idx >= strings.size()) {
+            truncated = true;
+            return invalid;
+        }
+        return strings[idx];
+    };
+
+    strings.clear();
+    objects.clear();
+    objectNames.clear();
+
+    const uint32_t num_strings = get_u32();
+    strings.reserve(num_strings);
+    for (uint32_t i = 0; i < num_strings && !truncated; ++i) {
+        const uint32_t len = get_u32();
+        if (end - p < (ptrdiff_t)len) {
+            truncated = true;
+            break;
+        }
+        strings.emplace_back(p, len);
+        p += len;
+    }
+
+    const uint32_t num_objects = get_u32();
+    objectNames.reserve(num_objects);
+    for (uint32_t i = 0; i < num_objects && !truncated; ++i) {
+        const std::string &name = get_string();
+        auto &entries = objects[name];
+        objectNames.push_back(name);
+
+        const uint32_t num_entries = get_u32();
+        for (uint32_t j = 0; j < num_entries && !truncated; ++j) {
+            const std::string &key = get_string();
+            const uint32_t value = get_u32();
+            if (value >= strings.size())
+                truncated = true;
+            else
+                entries[key] = value;
+        }
+    }
+
+    if (truncated || p != end) {
+        warn("Config cache '%s' is corrupt\n", filename);
+        return false;
+    }
+
+    tps = ticks_per_second;
+    return true;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ *  Binary config cache reading wrapper for use with CxxConfigManager
+ */
+
+#ifndef __SIM_CXX_CONFIG_BIN_HH__
+#define __SIM_CXX_CONFIG_BIN_HH__
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
+#include "sim/cxx_config.hh"
+
+/**
+ * CxxConfigManager interface for config caches. A config cache holds
+ * the same objects and entries as a config.ini file, with all strings
+ * interned in a table, and is written by m5.util.config_cache when a
+ * configuration script is instantiated with --config-cache. It also
+ * records the tick frequency that the values were resolved with.
+ *
+ * The file starts with a magic string, a version and the ticks per
+ * second, followed by the string table and the objects (all integers
+ * are little endian):
+ *
+ *   uint32 string count, then for each string: uint32 length, bytes
+ *   uint32 object count, then for each object: uint32 name,
+ *     uint32 entry count, then for each entry: uint32 key, uint32 value
+ *
+ * where names, keys and values are indices into the string table.
+ */
+class CxxBinFile : public CxxConfigFileBase
+{
+  protected:
+    /** The interned strings */
+    std::vector<std::string> strings;
+
+    /** Entries of each object, as string indices */
+    std::unordered_map<std::string,
+                       std::unordered_map<std::string, uint32_t>> objects;
+
+    /** Object names, in the order of the file */
+    std::vector<std::string> objectNames;
+
+    /** Tick frequency the values were resolved with */
+    Tick tps;
+
+  public:
+    CxxBinFile() : tps(0) { }
+
+    bool getParam(const std::string &object_name,
+        const std::string &param_name,
+        std::string &value) const;
+
+    bool getParamVector(const std::string &object_name,
+        const std::string &param_name,
+        std::vector<std::string> &values) const;
+
+    bool getPortPeers(const std::string &object_name,
+        const std::string &port_name,
+        std::vector<std::string> &peers) const;
+
+    bool objectExists(const std::string &object_name) const;
+
+    void getAllObjectNames(std::vector<std::string> &list) const;
+
+    void getObjectChildren(const std::string &object_name,
+        std::vector<std::string> &children,
+        bool return_paths = false) const;
+
+    /**
+     * Load a config cache.
+     * @return false if the file can't be read or isn't a config cache
+     */
+    bool load(const std::string &filename);
+
+    /** Ticks per second of the configuration */
+    Tick ticksPerSecond() const { return tps; }
+};
+
+#endif // __SIM_CXX_CONFIG_BIN_HH__
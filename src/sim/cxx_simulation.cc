@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/cxx_simulation.hh"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/str.hh"
+#include "sim/core.hh"
+#include "sim/cxx_config_bin.hh"
+#include "sim/cxx_config_ini.hh"
+#include "sim/cxx_manager.hh"
+#include "sim/eventq.hh"
+#include "sim/init_signals.hh"
+#include "sim/sim_events.hh"
+#include "sim/sim_object.hh"
+#include "sim/simulate.hh"
+#include "sim/stat_control.hh"
+
+CxxSimulation *CxxSimulation::instance = nullptr;
+
+CxxSimulation::CxxSimulation(const std::string &config_file,
+                             Tick ticks_per_second)
+    : _exitCode(0)
+{
+    fatal_if(instance, "Only one CxxSimulation can exist at a time\n");
+    instance = this;
+
+    std::unique_ptr<CxxBinFile> bin_file(new CxxBinFile);
+    if (bin_file->load(config_file)) {
+        ticks_per_second = bin_file->ticksPerSecond();
+        configFile = std::move(bin_file);
+    } else {
+        configFile.reset(new CxxIniFile);
+        fatal_if(!configFile->load(config_file),
+                 "Can't read config file %s\n", config_file);
+    }
+
+    if (cxx_config_directory.empty())
+        cxxConfigInit();
+    fatal_if(cxx_config_directory.empty(),
+             "Embedding gem5 needs a build with --with-cxx-config\n");
+
+    initSignals();
+    setClockFrequency(ticks_per_second);
+    curEventQueue(getEventQueue(0));
+
+    Stats::initSimStats();
+    Stats::registerHandlers(statsReset, statsDump);
+
+    configManager.reset(new CxxConfigManager(*configFile));
+}
+
+CxxSimulation::~CxxSimulation()
+{
+    instance = nullptr;
+}
+
+void
+CxxSimulation::instantiate()
+{
+    try {
+        configManager->instantiate();
+    } catch (CxxConfigManager::Exception &e) {
+        fatal("Config problem in sim object %s: %s\n", e.name, e.message);
+    }
+
+    // Enable the stats the way m5.stats.enable() does, which sorts
+    // them by the components of their names
+    std::vector<std::pair<std::vector<std::string>, Stats::Info *>> sorted;
+    for (auto stat : Stats::statsList()) {
+        fatal_if(!stat->check() || !stat->baseCheck(),
+                 "statistic '%s' (%d) was not properly initialized "
+                 "by a regStats() function\n", stat->name, stat->id);
+
+        if (!(stat->flags & Stats::display))
+            stat->name = csprintf("__Stat%06d", stat->id);
+
+        sorted.emplace_back(std::vector<std::string>(), stat);
+        tokenize(sorted.back().first, stat->name, '.', false);
+    }
+
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const decltype(sorted)::value_type &a,
+                        const decltype(sorted)::value_type &b) {
+                         return a.first < b.first;
+                     });
+
+    std::vector<Stats::Info *> stats;
+    for (auto &entry : sorted) {
+        entry.second->enable();
+        stats.push_back(entry.second);
+    }
+
+    Stats::setStatsOrder(stats);
+    Stats::enable();
+
+    try {
+        configManager->initState();
+        configManager->startup();
+    } catch (CxxConfigManager::Exception &e) {
+        fatal("Config problem in sim object %s: %s\n", e.name, e.message);
+    }
+}
+
+bool
+CxxSimulation::step(Tick ticks)
+{
+    GlobalSimLoopExitEvent *exit_event = simulate(ticks);
+
+    _exitCause = exit_event->getCause();
+    _exitCode = exit_event->getCode();
+
+    return exit_event == simulate_limit_event;
+}
+
+void
+CxxSimulation::resetStats()
+{
+    Stats::reset();
+}
+
+void
+CxxSimulation::statsReset()
+{
+    for (auto obj : instance->configManager->objectsInOrder)
+        obj->resetStats();
+
+    Stats::resetAll();
+    Stats::processResetQueue();
+}
+
+void
+CxxSimulation::statsDump()
+{
+    // There are no outputs, the stats are read from memory. Just
+    // bring them up to date for callers of Stats::dump().
+    Stats::processDumpQueue();
+    Stats::prepareAll();
+}
+
+const Stats::Info *
+CxxSimulation::findStat(const std::string &name) const
+{
+    auto &name_map = Stats::nameMap();
+    auto stat = name_map.find(name);
+    return stat == name_map.end() ? nullptr : stat->second;
+}
+
+Stats::Result
+CxxSimulation::value(const Stats::Info *stat)
+{
+    if (auto scalar = dynamic_cast<const Stats::ScalarInfo *>(stat))
+        return scalar->result();
+    if (auto vector = dynamic_cast<const Stats::VectorInfo *>(stat))
+        return vector->total();
+
+    panic("Can't read the value of statistic '%s'\n", stat->name);
+}
+
+Stats::VResult
+CxxSimulation::values(const Stats::Info *stat)
+{
+    if (auto vector = dynamic_cast<const Stats::VectorInfo *>(stat))
+        return vector->result();
+
+    panic("Can't read the values of statistic '%s'\n", stat->name);
+}
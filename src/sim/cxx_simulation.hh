@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * C++ API for embedding gem5 in another program. A CxxSimulation
+ * instantiates a configuration saved by a Python run (a config.ini or
+ * a config cache written with --config-cache), advances it a number
+ * of ticks at a time and gives direct access to the values of the
+ * statistics, all without involving Python.
+ */
+
+#ifndef __SIM_CXX_SIMULATION_HH__
+#define __SIM_CXX_SIMULATION_HH__
+
+#include <memory>
+#include <string>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+class CxxConfigFileBase;
+class CxxConfigManager;
+
+/**
+ * An embedded simulation. There can only be one per process since the
+ * event queues and statistics of gem5 are global.
+ *
+ * Typical use:
+ *
+ *     CxxSimulation sim("m5out/config.ini");
+ *     sim.instantiate();
+ *     const Stats::Info *insts = sim.findStat("system.cpu.committedInsts");
+ *     while (sim.step(1000000))
+ *         consume(CxxSimulation::value(insts));
+ */
+class CxxSimulation
+{
+  protected:
+    std::unique_ptr<CxxConfigFileBase> configFile;
+    std::unique_ptr<CxxConfigManager> configManager;
+
+    /** Cause and code of the event that ended the last step */
+    std::string _exitCause;
+    int _exitCode;
+
+    static CxxSimulation *instance;
+
+    static void statsReset();
+    static void statsDump();
+
+  public:
+    /**
+     * Load a configuration. The ticks per second of a config cache
+     * are used if the file is one, otherwise ticks_per_second must
+     * match the frequency the config.ini was written with.
+     *
+     * @param config_file Path to a config.ini or a config cache.
+     * @param ticks_per_second Tick frequency of a config.ini.
+     */
+    CxxSimulation(const std::string &config_file,
+                  Tick ticks_per_second = 1000000000000ULL);
+    ~CxxSimulation();
+
+    /**
+     * The manager of the configured objects, which can be used to
+     * change parameters before instantiate() or to find objects.
+     */
+    CxxConfigManager &manager() { return *configManager; }
+
+    /**
+     * Create and initialise all objects, and enable the statistics.
+     * Fatal if the configuration is inconsistent.
+     */
+    void instantiate();
+
+    /**
+     * Advance the simulation.
+     *
+     * @param ticks Number of ticks to advance.
+     * @return true if the simulation ran for all the ticks, false if
+     *         it stopped earlier (see exitCause() and exitCode()).
+     */
+    bool step(Tick ticks);
+
+    /** Run until something other than a step limit stops the simulation. */
+    void run() { step(MaxTick); }
+
+    const std::string &exitCause() const { return _exitCause; }
+    int exitCode() const { return _exitCode; }
+
+    /** Reset all stats, as m5.stats.reset() does. */
+    void resetStats();
+
+    /**
+     * Find a statistic by its full name, e.g.
+     * "system.cpu.committedInsts". Look the stats up once and keep the
+     * pointers, they are valid for the lifetime of the simulation.
+     *
+     * @return The stat, or nullptr if there is none with the name.
+     */
+    const Stats::Info *findStat(const std::string &name) const;
+
+    /**
+     * The current value of a scalar stat, or the total of a vector
+     * stat or formula. Distributions and histograms are not supported.
+     */
+    static Stats::Result value(const Stats::Info *stat);
+
+    /** The current values of a vector stat or formula. */
+    static Stats::VResult values(const Stats::Info *stat);
+};
+
+#endif // __SIM_CXX_SIMULATION_HH__
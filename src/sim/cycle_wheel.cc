@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/cycle_wheel.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "sim/ticked_object.hh"
+
+CycleWheel::CycleWheel(const std::string &name, EventQueue *eventq,
+                       Event::Priority priority)
+    : _name(name), eventq(eventq),
+      event([this]{ process(); }, name, false, priority),
+      numActive(0)
+{
+}
+
+unsigned
+CycleWheel::add(Ticked *member)
+{
+    const unsigned slot = members.size();
+    members.push_back(member);
+    due.push_back(MaxTick);
+    if (slot % 64 == 0)
+        activeMask.push_back(0);
+    return slot;
+}
+
+void
+CycleWheel::activate(unsigned slot, Tick when)
+{
+    assert(slot < members.size());
+    if (!active(slot)) {
+        activeMask[slot / 64] |= 1ULL << (slot % 64);
+        ++numActive;
+    }
+    due[slot] = when;
+    scheduleAt(when);
+}
+
+void
+CycleWheel::deactivate(unsigned slot)
+{
+    assert(slot < members.size());
+    if (!active(slot))
+        return;
+
+    activeMask[slot / 64] &= ~(1ULL << (slot % 64));
+    due[slot] = MaxTick;
+    if (--numActive == 0 && event.scheduled())
+        eventq->deschedule(&event);
+}
+
+void
+CycleWheel::scheduleAt(Tick when)
+{
+    if (!event.scheduled())
+        eventq->schedule(&event, when);
+    else if (when < event.when())
+        eventq->reschedule(&event, when);
+}
+
+void
+CycleWheel::process()
+{
+    const Tick now = eventq->getCurTick();
+
+    for (unsigned word = 0; word < activeMask.size(); ++word) {
+        for (uint64_t bits = activeMask[word]; bits; bits &= bits - 1) {
+            const unsigned slot = word * 64 + __builtin_ctzll(bits);
+            // Members evaluated earlier in this pass may have stopped
+            // this one.
+            if (active(slot) && due[slot] == now)
+                members[slot]->processWheelTick();
+        }
+    }
+
+    // Members may have been started or stopped by any of the
+    // evaluations above, so find the next tick from scratch.
+    Tick next = MaxTick;
+    for (unsigned word = 0; word < activeMask.size(); ++word) {
+        for (uint64_t bits = activeMask[word]; bits; bits &= bits - 1) {
+            const unsigned slot = word * 64 + __builtin_ctzll(bits);
+            next = std::min(next, due[slot]);
+        }
+    }
+
+    if (next != MaxTick)
+        scheduleAt(next);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Shared clock event for Ticked objects in the same clock domain.
+ */
+
+#ifndef __SIM_CYCLE_WHEEL_HH__
+#define __SIM_CYCLE_WHEEL_HH__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "sim/eventq.hh"
+
+class Ticked;
+
+/**
+ * A CycleWheel services all Ticked objects of one clock domain that
+ * tick on the same event queue and with the same priority using a
+ * single event. Instead of scheduling their own event every cycle,
+ * members mark themselves active and set the tick of their next
+ * evaluation. Active members are tracked in a bitmap, so idle members
+ * cost nothing when the wheel turns, and members are always evaluated
+ * in the order they were added to the wheel.
+ */
+class CycleWheel
+{
+  public:
+    CycleWheel(const std::string &name, EventQueue *eventq,
+               Event::Priority priority);
+
+    /** Add a member to the wheel and return its slot. */
+    unsigned add(Ticked *member);
+
+    /** Evaluate the member in a slot at the given tick. */
+    void activate(unsigned slot, Tick when);
+
+    /** Stop evaluating the member in a slot. */
+    void deactivate(unsigned slot);
+
+    bool
+    active(unsigned slot) const
+    {
+        return activeMask[slot / 64] & (1ULL << (slot % 64));
+    }
+
+    const std::string &name() const { return _name; }
+
+  private:
+    /** Evaluate all members due at the current tick. */
+    void process();
+
+    /** Make sure the wheel turns no later than when. */
+    void scheduleAt(Tick when);
+
+    const std::string _name;
+
+    EventQueue *eventq;
+
+    EventFunctionWrapper event;
+
+    std::vector<Ticked *> members;
+
+    /** Tick of the next evaluation of each member. */
+    std::vector<Tick> due;
+
+    /** One bit per member, set while the member is ticking. */
+    std::vector<uint64_t> activeMask;
+
+    unsigned numActive;
+};
+
+#endif // __SIM_CYCLE_WHEEL_HH__
@@ -40,10 +40,12 @@
 #include "sim/drain.hh"
 
 #include <algorithm>
+#include <unordered_set>
 
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/Drain.hh"
+#include "sim/core.hh"
 #include "sim/sim_exit.hh"
 #include "sim/sim_object.hh"
 
@@ -51,7 +53,8 @@ DrainManager DrainManager::_instance;
 
 DrainManager::DrainManager()
     : _count(0),
-      _state(DrainState::Running)
+      _state(DrainState::Running),
+      _partial(false)
 {
 }
 
@@ -62,35 +65,128 @@ DrainManager::~DrainManager()
 bool
 DrainManager::tryDrain()
 {
-    panic_if(_state == DrainState::Drained,
+    return tryDrainObjects(_allDrainable);
+}
+
+bool
+DrainManager::tryDrainObjects(const std::vector<Drainable *> &objs)
+{
+    panic_if(_state == DrainState::Drained && !_partial,
              "Trying to drain a drained system\n");
 
     panic_if(_count != 0,
              "Drain counter must be zero at the start of a drain cycle\n");
 
-    DPRINTF(Drain, "Trying to drain %u objects.\n", drainableCount());
-    _state = DrainState::Draining;
-    for (auto *obj : _allDrainable) {
-        DrainState status = obj->dmDrain();
-        if (DTRACE(Drain) && status != DrainState::Drained) {
-            SimObject *temp = dynamic_cast<SimObject*>(obj);
-            if (temp)
-                DPRINTF(Drain, "Failed to drain %s\n", temp->name());
+    if (_state != DrainState::Draining) {
+        // Start of a drain operation, everybody needs to drain. This
+        // includes the objects that a previous partial drain already
+        // drained, they should report that they are still drained.
+        DPRINTF(Drain, "Trying to drain %u objects.\n", objs.size());
+        _state = DrainState::Draining;
+        _partial = &objs != &_allDrainable &&
+            objs.size() < drainableCount();
+        _pending.clear();
+        _drainTimes.clear();
+        for (auto *obj : objs)
+            drainObject(obj);
+    } else {
+        // Only the objects that needed more simulation have anything
+        // new to tell us
+        std::vector<Drainable *> queried;
+        queried.swap(_pending);
+        DPRINTF(Drain, "Trying to drain %u/%u objects.\n",
+                queried.size(), objs.size());
+        for (auto *obj : queried)
+            drainObject(obj);
+
+        // The objects that drained earlier may have been disturbed
+        // by the ones that just finished, so they need to agree that
+        // they are still drained
+        if (_pending.empty()) {
+            DPRINTF(Drain, "Checking that the remaining objects are "
+                    "still drained.\n");
+            std::unordered_set<Drainable *> done(queried.begin(),
+                                                 queried.end());
+            for (auto *obj : objs) {
+                if (!done.count(obj))
+                    drainObject(obj);
+            }
         }
-        _count += status == DrainState::Drained ? 0 : 1;
     }
 
     if (_count == 0) {
         DPRINTF(Drain, "Drain done.\n");
+        if (DTRACE(Drain)) {
+            const auto slowest = slowestDrainables(10);
+            for (auto s = slowest.begin(); s != slowest.end(); ++s) {
+                DPRINTF(Drain, "%s spent %d ticks draining\n",
+                        s->first, s->second);
+            }
+        }
         _state = DrainState::Drained;
         return true;
     } else {
         DPRINTF(Drain, "Need another drain cycle. %u/%u objects not ready.\n",
-                _count, drainableCount());
+                _count, objs.size());
         return false;
     }
 }
 
+void
+DrainManager::drainObject(Drainable *obj)
+{
+    DrainState status = obj->dmDrain();
+    auto time = _drainTimes.find(obj);
+    if (status == DrainState::Drained) {
+        // Close the draining period of objects that needed simulation
+        if (time != _drainTimes.end() && time->second.start != MaxTick) {
+            time->second.total += curTick() - time->second.start;
+            time->second.start = MaxTick;
+        }
+        return;
+    }
+
+    DPRINTF(Drain, "Failed to drain %s\n", drainableName(obj));
+    if (time == _drainTimes.end())
+        _drainTimes.emplace(obj, DrainTime{curTick(), 0});
+    else if (time->second.start == MaxTick)
+        time->second.start = curTick();
+
+    _pending.push_back(obj);
+    ++_count;
+}
+
+std::vector<std::pair<std::string, Tick>>
+DrainManager::slowestDrainables(size_t count) const
+{
+    std::vector<std::pair<std::string, Tick>> slowest;
+    for (const auto &time : _drainTimes) {
+        // Objects that are still draining count up to now
+        Tick ticks = time.second.total;
+        if (time.second.start != MaxTick)
+            ticks += curTick() - time.second.start;
+        slowest.emplace_back(drainableName(time.first), ticks);
+    }
+
+    std::sort(slowest.begin(), slowest.end(),
+              [](const std::pair<std::string, Tick> &a,
+                 const std::pair<std::string, Tick> &b) {
+                  return a.second > b.second ||
+                      (a.second == b.second && a.first < b.first);
+              });
+    if (slowest.size() > count)
+        slowest.resize(count);
+
+    return slowest;
+}
+
+std::string
+DrainManager::drainableName(const Drainable *obj)
+{
+    const SimObject *sim_obj = dynamic_cast<const SimObject *>(obj);
+    return sim_obj ? sim_obj->name() : "<unnamed>";
+}
+
 void
 DrainManager::resume()
 {
@@ -115,6 +211,7 @@ DrainManager::resume()
     // DrainManager, which means we have to resume objects until all
     // objects are in the Running state.
     _state = DrainState::Resuming;
+    _partial = false;
 
     do {
         DPRINTF(Drain, "Resuming %u objects.\n", drainableCount());
@@ -171,6 +268,11 @@ DrainManager::unregisterDrainable(Drainable *obj)
     auto o = std::find(_allDrainable.begin(), _allDrainable.end(), obj);
     assert(o != _allDrainable.end());
     _allDrainable.erase(o);
+
+    auto p = std::find(_pending.begin(), _pending.end(), obj);
+    if (p != _pending.end())
+        _pending.erase(p);
+    _drainTimes.erase(obj);
 }
 
 bool
@@ -42,8 +42,13 @@
 
 #include <atomic>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "base/types.hh"
+
 class Drainable;
 
 /**
@@ -113,11 +118,36 @@ class DrainManager
      * this method should be called again. This cycle should continue
      * until this method returns true.
      *
+     * Only the first call of a drain operation asks every object to
+     * drain. Later calls only ask the objects that were still
+     * draining, and once all of those are done, the rest of the
+     * objects are asked again to make sure they weren't disturbed.
+     *
      * @return true if all objects were drained successfully, false if
      * more simulation is needed.
      */
     bool tryDrain();
 
+    /**
+     * Try to drain a subset of the objects in the system.
+     *
+     * This works like tryDrain(), but only the objects in objs are
+     * asked to drain while everything else keeps running. This is
+     * enough for operations that only touch those objects, e.g., a
+     * CPU handover that keeps caches and memories live. The
+     * following resume() only resumes the objects that were drained.
+     *
+     * The system is only partially drained afterwards, see
+     * isPartiallyDrained(). A partial drain can be extended by
+     * another call to this method or tryDrain() without resuming
+     * first; the objects that are already drained are asked again.
+     *
+     * @param objs Objects to drain.
+     * @return true if all objects in objs were drained successfully,
+     * false if more simulation is needed.
+     */
+    bool tryDrainObjects(const std::vector<Drainable *> &objs);
+
     /**
      * Resume normal simulation in a Drained system.
      */
@@ -136,9 +166,19 @@ class DrainManager
      */
     void preCheckpointRestore();
 
-    /** Check if the system is drained */
+    /**
+     * Check if the system is drained, including systems where only a
+     * subset of the objects were drained.
+     */
     bool isDrained() const { return _state == DrainState::Drained; }
 
+    /**
+     * Check if the system is drained but only a subset of the objects
+     * were asked to drain, in which case the system isn't ready for
+     * operations that need every object drained, e.g., checkpointing.
+     */
+    bool isPartiallyDrained() const { return isDrained() && _partial; }
+
     /** Get the simulators global drain state */
     DrainState state() const { return _state; }
 
@@ -148,6 +188,18 @@ class DrainManager
      */
     void signalDrainDone();
 
+    /**
+     * Get the objects that spent the most time draining during the
+     * current or most recent drain operation. Objects that drained
+     * without further simulation aren't included.
+     *
+     * @param count Maximum number of objects to report
+     * @return Object names and the ticks they spent draining, slowest
+     * first
+     */
+    std::vector<std::pair<std::string, Tick>>
+    slowestDrainables(size_t count) const;
+
   public:
     void registerDrainable(Drainable *obj);
     void unregisterDrainable(Drainable *obj);
@@ -165,12 +217,42 @@ class DrainManager
      */
     size_t drainableCount() const;
 
+    /**
+     * Ask an object to drain, keeping track of it if it needs more
+     * simulation.
+     */
+    void drainObject(Drainable *obj);
+
+    /** Get a printable name of a Drainable */
+    static std::string drainableName(const Drainable *obj);
+
     /** Lock protecting the set of drainable objects */
     mutable std::mutex globalLock;
 
     /** Set of all drainable objects */
     std::vector<Drainable *> _allDrainable;
 
+    /**
+     * Objects that reported that they need more simulation to drain
+     * in the current drain cycle.
+     */
+    std::vector<Drainable *> _pending;
+
+    /** Time spent draining by an object */
+    struct DrainTime
+    {
+        /** Start of the current draining period, MaxTick if drained */
+        Tick start;
+        /** Ticks spent in completed draining periods */
+        Tick total;
+    };
+
+    /**
+     * Time spent draining by the objects that needed simulation to
+     * drain in the current or most recent drain operation.
+     */
+    std::unordered_map<const Drainable *, DrainTime> _drainTimes;
+
     /**
      * Number of objects still draining. This is flagged atomic since
      * it can be manipulated by SimObjects living in different
@@ -181,6 +263,12 @@ class DrainManager
     /** Global simulator drain state */
     DrainState _state;
 
+    /**
+     * True if the current or most recent drain operation didn't
+     * include all objects.
+     */
+    bool _partial;
+
     /** Singleton instance of the drain manager */
     static DrainManager _instance;
 };
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/event_profile.hh"
+
+#include <algorithm>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "base/callback.hh"
+#include "base/cprintf.hh"
+#include "base/output.hh"
+#include "base/statistics.hh"
+#include "sim/eventq.hh"
+
+namespace
+{
+
+unsigned
+bucketIndex(uint64_t ns)
+{
+    const unsigned sub = EventProfile::Entry::SubBuckets;
+    if (ns < 2 * sub)
+        return ns;
+
+    const unsigned exp = 63 - __builtin_clzll(ns);
+    const unsigned shift = exp - 3;
+    return 2 * sub + (exp - 4) * sub + ((ns >> shift) & (sub - 1));
+}
+
+uint64_t
+bucketLimit(unsigned index)
+{
+    const unsigned sub = EventProfile::Entry::SubBuckets;
+    if (index < 2 * sub)
+        return index;
+
+    const unsigned exp = (index - 2 * sub) / sub + 4;
+    const unsigned shift = exp - 3;
+    const uint64_t lower = (uint64_t)(sub + index % sub) << shift;
+    return lower + ((uint64_t)1 << shift) - 1;
+}
+
+void
+writeJsonString(std::ostream &os, const std::string &str)
+{
+    os << '"';
+    for (char c : str) {
+        switch (c) {
+          case '"':
+            os << "\\\"";
+            break;
+          case '\\':
+            os << "\\\\";
+            break;
+          case '\n':
+            os << "\\n";
+            break;
+          default:
+            if ((unsigned char)c < 0x20)
+                ccprintf(os, "\\u%04x", (unsigned)c);
+            else
+                os << c;
+        }
+    }
+    os << '"';
+}
+
+std::string profileFileName;
+
+class ProfileDumpCallback : public Callback
+{
+  public:
+    void
+    process() override
+    {
+        if (profileFileName.empty())
+            return;
+
+        OutputStream *out = simout.create(profileFileName);
+        mainEventQueueProfile().dumpJson(*out->stream());
+        simout.close(out);
+    }
+};
+
+class ProfileResetCallback : public Callback
+{
+  public:
+    void
+    process() override
+    {
+        for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+            if (EventProfile *profile = mainEventQueue[i]->getProfile())
+                profile->reset();
+        }
+    }
+};
+
+} // anonymous namespace
+
+void
+EventProfile::Entry::sample(uint64_t ns)
+{
+    ++count;
+    totalNs += ns;
+    maxNs = std::max(maxNs, ns);
+    ++buckets[bucketIndex(ns)];
+}
+
+void
+EventProfile::Entry::merge(const Entry &other)
+{
+    count += other.count;
+    totalNs += other.totalNs;
+    maxNs = std::max(maxNs, other.maxNs);
+    for (unsigned i = 0; i < NumBuckets; ++i)
+        buckets[i] += other.buckets[i];
+}
+
+uint64_t
+EventProfile::Entry::percentile(double fraction) const
+{
+    const uint64_t target = std::max<uint64_t>(1, fraction * count + 0.5);
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < NumBuckets; ++i) {
+        seen += buckets[i];
+        if (seen >= target)
+            return std::min(bucketLimit(i), maxNs);
+    }
+    return maxNs;
+}
+
+std::string
+EventProfile::key(const Event *event)
+{
+    const std::string desc = event->description();
+    const std::string name = event->name();
+    if (name.compare(0, 6, "Event_") == 0)
+        return desc;
+    return desc + " " + name;
+}
+
+void
+EventProfile::merge(const EventProfile &other)
+{
+    for (const auto &entry : other.entries)
+        entries[entry.first].merge(entry.second);
+}
+
+double
+EventProfile::totalSeconds() const
+{
+    uint64_t total = 0;
+    for (const auto &entry : entries)
+        total += entry.second.totalNs;
+    return total / 1e9;
+}
+
+void
+EventProfile::dumpJson(std::ostream &os) const
+{
+    std::vector<std::pair<std::string, const Entry *>> sorted;
+    for (const auto &entry : entries)
+        sorted.emplace_back(entry.first, &entry.second);
+
+    std::sort(sorted.begin(), sorted.end(),
+              [](const std::pair<std::string, const Entry *> &a,
+                 const std::pair<std::string, const Entry *> &b) {
+                  if (a.second->totalNs != b.second->totalNs)
+                      return a.second->totalNs > b.second->totalNs;
+                  return a.first < b.first;
+              });
+
+    os << "{\n";
+    for (auto it = sorted.begin(); it != sorted.end(); ++it) {
+        const Entry &e = *it->second;
+        os << "  ";
+        writeJsonString(os, it->first);
+        ccprintf(os, ": {\"count\": %d, \"total_ns\": %d, "
+                 "\"mean_ns\": %d, \"p50_ns\": %d, \"p99_ns\": %d, "
+                 "\"max_ns\": %d}",
+                 e.count, e.totalNs, e.count ? e.totalNs / e.count : 0,
+                 e.percentile(0.5), e.percentile(0.99), e.maxNs);
+        os << (it + 1 == sorted.end() ? "\n" : ",\n");
+    }
+    os << "}\n";
+}
+
+void
+setEventProfiling(bool enable, const std::string &file_name)
+{
+    static bool callbacks_registered = false;
+
+    profileFileName = enable ? file_name : "";
+    setMainQueueProfiling(enable);
+
+    if (enable && !callbacks_registered) {
+        Stats::registerDumpCallback(new ProfileDumpCallback());
+        Stats::registerResetCallback(new ProfileResetCallback());
+        callbacks_registered = true;
+    }
+}
+
+EventProfile
+mainEventQueueProfile()
+{
+    EventProfile merged;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        if (const EventProfile *profile = mainEventQueue[i]->getProfile())
+            merged.merge(*profile);
+    }
+    return merged;
+}
+
+double
+eventProfileSeconds()
+{
+    double total = 0;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        if (const EventProfile *profile = mainEventQueue[i]->getProfile())
+            total += profile->totalSeconds();
+    }
+    return total;
+}
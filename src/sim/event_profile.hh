@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Host time profiling of event processing.
+ */
+
+#ifndef __SIM_EVENT_PROFILE_HH__
+#define __SIM_EVENT_PROFILE_HH__
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+
+class Event;
+
+/**
+ * Host time spent processing events, broken down by event type and
+ * owner. Every event queue keeps its own profile when profiling is
+ * enabled, so recording a sample needs no locking. The profiles of
+ * all queues are merged when they are dumped.
+ */
+class EventProfile
+{
+  public:
+    /**
+     * Samples of a single event type. Host times are kept in a
+     * log-linear histogram with 8 buckets per power of two, which
+     * bounds the error of the reported percentiles to 12.5%.
+     */
+    struct Entry
+    {
+        static const unsigned SubBuckets = 8;
+        static const unsigned NumBuckets = 64 * SubBuckets;
+
+        uint64_t count = 0;
+        uint64_t totalNs = 0;
+        uint64_t maxNs = 0;
+        uint64_t buckets[NumBuckets] = {};
+
+        void sample(uint64_t ns);
+        void merge(const Entry &other);
+
+        /** Upper bound of the host time of a fraction of samples. */
+        uint64_t percentile(double fraction) const;
+    };
+
+    typedef std::unordered_map<std::string, Entry> EntryMap;
+
+    /**
+     * Profile key of an event: its description, followed by its name
+     * unless the event only has the default per-instance name.
+     */
+    static std::string key(const Event *event);
+
+    void
+    sample(const std::string &key, uint64_t ns)
+    {
+        entries[key].sample(ns);
+    }
+
+    void merge(const EventProfile &other);
+
+    void reset() { entries.clear(); }
+
+    const EntryMap &getEntries() const { return entries; }
+
+    /** Total host time of all samples in seconds. */
+    double totalSeconds() const;
+
+    /** Write the profile as a JSON object sorted by total time. */
+    void dumpJson(std::ostream &os) const;
+
+  private:
+    EntryMap entries;
+};
+
+/**
+ * Enable or disable profiling of all main event queues. When enabled,
+ * the merged profile is written to the given file in the output
+ * directory on every stats dump, and cleared on every stats reset.
+ */
+void setEventProfiling(bool enable, const std::string &file_name);
+
+/** Merged profile of all main event queues. */
+EventProfile mainEventQueueProfile();
+
+/** Total host time spent in profiled events, in seconds. */
+double eventProfileSeconds();
+
+#endif // __SIM_EVENT_PROFILE_HH__
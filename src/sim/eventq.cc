@@ -32,12 +32,15 @@
  *          Steve Raasch
  */
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "cpu/smt.hh"
@@ -48,6 +51,7 @@
 using namespace std;
 
 Tick simQuantum = 0;
+bool simQuantumLookahead = false;
 
 //
 // Main Event Queues
@@ -59,6 +63,11 @@ uint32_t numMainEventQueues = 0;
 vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
+EventQueue::Engine defaultEventQueueEngine = EventQueue::Engine::List;
+static bool profileMainEventQueues = false;
+static bool hostPerfMainEventQueues = false;
+
+const size_t EventQueue::minBuckets;
 
 EventQueue *
 getEventQueue(uint32_t index)
@@ -67,11 +76,44 @@ getEventQueue(uint32_t index)
         numMainEventQueues++;
         mainEventQueue.push_back(
             new EventQueue(csprintf("MainEventQueue-%d", index)));
+        mainEventQueue.back()->setEngine(defaultEventQueueEngine);
+        mainEventQueue.back()->setProfiling(profileMainEventQueues);
+        mainEventQueue.back()->setHostPerf(hostPerfMainEventQueues);
     }
 
     return mainEventQueue[index];
 }
 
+void
+setMainQueueEngine(EventQueue::Engine engine)
+{
+    assert(!inParallelMode);
+
+    defaultEventQueueEngine = engine;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->setEngine(engine);
+}
+
+void
+setMainQueueProfiling(bool enable)
+{
+    assert(!inParallelMode);
+
+    profileMainEventQueues = enable;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->setProfiling(enable);
+}
+
+void
+setMainQueueHostPerf(bool enable)
+{
+    assert(!inParallelMode);
+
+    hostPerfMainEventQueues = enable;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->setHostPerf(enable);
+}
+
 #ifndef NDEBUG
 Counter Event::instanceCounter = 0;
 #endif
@@ -117,6 +159,11 @@ Event::insertBefore(Event *event, Event *curr)
 void
 EventQueue::insert(Event *event)
 {
+    if (engine == Engine::Calendar) {
+        calendarInsert(event);
+        return;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -176,6 +223,11 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
+    if (engine == Engine::Calendar) {
+        calendarRemove(event);
+        return;
+    }
+
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -200,6 +252,207 @@ EventQueue::remove(Event *event)
     prev->nextBin = Event::removeItem(event, curr);
 }
 
+void
+EventQueue::calendarInsert(Event *event)
+{
+    Event *&bucket = buckets[bucketIndex(event->when())];
+
+    // Find the bin in the bucket, the same way insert() does for the
+    // whole queue.
+    if (!bucket || *event <= *bucket) {
+        bucket = Event::insertBefore(event, bucket);
+    } else {
+        Event *prev = bucket;
+        Event *curr = bucket->nextBin;
+        while (curr && *curr < *event) {
+            prev = curr;
+            curr = curr->nextBin;
+        }
+        prev->nextBin = Event::insertBefore(event, curr);
+    }
+
+    // The event is now the top of its bin, which is a new bin unless
+    // it was pushed on top of an existing one.
+    if (!head || *event <= *head)
+        head = event;
+
+    if (!event->nextInBin && ++numBins > 2 * buckets.size())
+        calendarResize();
+}
+
+void
+EventQueue::calendarRemove(Event *event)
+{
+    Event *&bucket = buckets[bucketIndex(event->when())];
+
+    Event *prev = NULL;
+    Event *curr = bucket;
+    while (curr && *curr < *event) {
+        prev = curr;
+        curr = curr->nextBin;
+    }
+
+    if (!curr || *curr != *event)
+        panic("event not found!");
+
+    Event *top = Event::removeItem(event, curr);
+    if (prev)
+        prev->nextBin = top;
+    else
+        bucket = top;
+
+    // removeItem() returns the next bin if the event was the only
+    // one in its bin.
+    const bool bin_removed = !top || *top != *event;
+    if (event == head)
+        head = bin_removed ? calendarFindHead(event->when()) : top;
+
+    if (bin_removed && --numBins < buckets.size() / 4 &&
+        buckets.size() > minBuckets) {
+        calendarResize();
+    }
+}
+
+Event *
+EventQueue::calendarFindHead(Tick when) const
+{
+    // Walk the calendar one bucket (one bucket width of time) at a
+    // time, starting at the bucket covering 'when'. The first bucket
+    // whose earliest bin falls within the current window holds the
+    // earliest bin in the calendar.
+    const size_t nbuckets = buckets.size();
+    const Tick window = when >> bucketShift;
+    for (size_t i = 0; i < nbuckets; ++i) {
+        Event *top = buckets[(window + i) & (nbuckets - 1)];
+        if (top && (top->when() >> bucketShift) - window <= i)
+            return top;
+    }
+
+    // Nothing within a full revolution of the calendar, fall back to
+    // a direct search of all buckets.
+    Event *earliest = NULL;
+    for (Event *top : buckets) {
+        if (top && (!earliest || *top < *earliest))
+            earliest = top;
+    }
+
+    return earliest;
+}
+
+Event *
+EventQueue::calendarExtract()
+{
+    std::vector<Event *> bins;
+    bins.reserve(numBins);
+    for (Event *&bucket : buckets) {
+        for (Event *bin = bucket; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+        bucket = NULL;
+    }
+
+    // Bins have distinct (when, priority) pairs, so this yields the
+    // same order as the List engine.
+    std::sort(bins.begin(), bins.end(),
+              [](const Event *l, const Event *r) { return *l < *r; });
+
+    Event *list = NULL;
+    for (auto bin = bins.rbegin(); bin != bins.rend(); ++bin) {
+        (*bin)->nextBin = list;
+        list = *bin;
+    }
+
+    head = NULL;
+    numBins = 0;
+
+    return list;
+}
+
+void
+EventQueue::calendarLoad(Event *list)
+{
+    // Size the calendar so that there are one to two bins per bucket
+    // on average.
+    size_t bins = 0;
+    for (Event *bin = list; bin; bin = bin->nextBin)
+        ++bins;
+    buckets.assign(std::max(minBuckets, ceilPow2(bins)), NULL);
+
+    // Make buckets roughly three times as wide as the average spacing
+    // between the first few bins, which keeps the number of bins in
+    // the active part of each bucket small. Gaps much larger than the
+    // average (e.g., exit events at MaxTick) are ignored.
+    static const size_t samples = 64;
+    std::vector<Tick> gaps;
+    for (Event *bin = list; bin && bin->nextBin && gaps.size() < samples;
+         bin = bin->nextBin) {
+        if (bin->nextBin->when() != bin->when())
+            gaps.push_back(bin->nextBin->when() - bin->when());
+    }
+
+    Tick width = 1;
+    if (!gaps.empty()) {
+        Tick average = 0;
+        for (Tick gap : gaps)
+            average += gap / gaps.size();
+
+        Tick sum = 0;
+        size_t count = 0;
+        for (Tick gap : gaps) {
+            if (gap / 2 <= average) {
+                sum += gap;
+                ++count;
+            }
+        }
+
+        if (count) {
+            const Tick spacing = std::min(sum / count, MaxTick / 3);
+            width = std::max<Tick>(3 * spacing, 1);
+        }
+    }
+    bucketShift = std::min(ceilLog2(width), 48);
+
+    // Bins arrive in order, so they can be appended to their bucket.
+    std::vector<Event *> tails(buckets.size(), NULL);
+    head = list;
+    numBins = bins;
+    while (list) {
+        Event *bin = list;
+        list = list->nextBin;
+        bin->nextBin = NULL;
+
+        const size_t index = bucketIndex(bin->when());
+        if (tails[index])
+            tails[index]->nextBin = bin;
+        else
+            buckets[index] = bin;
+        tails[index] = bin;
+    }
+}
+
+void
+EventQueue::calendarResize()
+{
+    calendarLoad(calendarExtract());
+}
+
+void
+EventQueue::setEngine(Engine e)
+{
+    if (e == engine)
+        return;
+
+    Event *list = engine == Engine::Calendar ? calendarExtract() : head;
+
+    head = NULL;
+    engine = e;
+    if (engine == Engine::Calendar) {
+        calendarLoad(list);
+    } else {
+        buckets.clear();
+        head = list;
+    }
+}
+
 Event *
 EventQueue::serviceOne()
 {
@@ -208,7 +461,23 @@ EventQueue::serviceOne()
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
-    if (next) {
+    if (engine == Engine::Calendar) {
+        Event *&bucket = buckets[bucketIndex(event->when())];
+        assert(bucket == event);
+
+        if (next) {
+            next->nextBin = event->nextBin;
+            bucket = next;
+            head = next;
+        } else {
+            bucket = event->nextBin;
+            head = calendarFindHead(event->when());
+            if (--numBins < buckets.size() / 4 &&
+                buckets.size() > minBuckets) {
+                calendarResize();
+            }
+        }
+    } else if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
 
@@ -224,8 +493,19 @@ EventQueue::serviceOne()
     if (!event->squashed()) {
         // forward current cycle to the time when this event occurs.
         setCurTick(event->when());
+        ++_numServiced;
+
+        // The event may delete itself, so find its owner first
+        const SimObject *owner =
+            hostPerf ? hostPerf->owner(event) : nullptr;
+
+        if (profile)
+            processProfiled(event);
+        else
+            event->process();
 
-        event->process();
+        if (hostPerf)
+            hostPerf->record(owner);
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::Managed) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -300,15 +580,9 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
-            Event *nextInBin = nextBin;
-            while (nextInBin) {
-                nextInBin->dump();
-                nextInBin = nextInBin->nextInBin;
-            }
-
-            nextBin = nextBin->nextBin;
+        for (const Event *bin : sortedBins()) {
+            for (const Event *e = bin; e; e = e->nextInBin)
+                e->dump();
         }
     }
 
@@ -321,10 +595,32 @@ EventQueue::debugVerify() const
     std::unordered_map<long, bool> map;
 
     Tick time = 0;
-    short priority = 0;
+    short priority = Event::Minimum_Pri;
+
+    if (engine == Engine::Calendar) {
+        size_t bins = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            for (Event *bin = buckets[i]; bin; bin = bin->nextBin) {
+                if (bucketIndex(bin->when()) != i) {
+                    cprintf("bin in the wrong bucket!");
+                    bin->dump();
+                    return false;
+                }
+                if (bin->nextBin && *bin->nextBin <= *bin) {
+                    cprintf("bucket not sorted!");
+                    bin->dump();
+                    return false;
+                }
+                ++bins;
+            }
+        }
+        if (bins != numBins) {
+            cprintf("bin count mismatch!");
+            return false;
+        }
+    }
 
-    Event *nextBin = head;
-    while (nextBin) {
+    for (Event *nextBin : sortedBins()) {
         Event *nextInBin = nextBin;
         while (nextInBin) {
             if (nextInBin->when() < time) {
@@ -350,16 +646,39 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     return true;
 }
 
+std::vector<Event *>
+EventQueue::sortedBins() const
+{
+    std::vector<Event *> bins;
+    if (engine == Engine::Calendar) {
+        for (Event *bucket : buckets) {
+            for (Event *bin = bucket; bin; bin = bin->nextBin)
+                bins.push_back(bin);
+        }
+        std::sort(bins.begin(), bins.end(),
+                  [](const Event *l, const Event *r) { return *l < *r; });
+    } else {
+        for (Event *bin = head; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+    }
+
+    return bins;
+}
+
 Event*
 EventQueue::replaceHead(Event* s)
 {
+    if (engine == Engine::Calendar) {
+        Event *t = calendarExtract();
+        calendarLoad(s);
+        return t;
+    }
+
     Event* t = head;
     head = s;
     return t;
@@ -414,28 +733,93 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), engine(Engine::List),
+      _numServiced(0), bucketShift(0), numBins(0), async_queue(nullptr)
+{
+}
+
+void
+EventQueue::setProfiling(bool enable)
+{
+    if (!enable)
+        profile.reset();
+    else if (!profile)
+        profile.reset(new EventProfile());
+}
+
+void
+EventQueue::setHostPerf(bool enable)
+{
+    if (!enable)
+        hostPerf.reset();
+    else if (!hostPerf)
+        hostPerf.reset(new HostPerfCounters());
+}
+
+void
+EventQueue::processProfiled(Event *event)
 {
+    // The event may delete itself while being processed, so the key
+    // has to be determined up front.
+    const std::string key = EventProfile::key(event);
+
+    const auto start = std::chrono::steady_clock::now();
+    event->process();
+    const auto end = std::chrono::steady_clock::now();
+
+    profile->sample(key, std::chrono::duration_cast<
+                    std::chrono::nanoseconds>(end - start).count());
 }
 
 void
 EventQueue::asyncInsert(Event *event)
 {
-    async_queue_mutex.lock();
-    async_queue.push_back(event);
-    async_queue_mutex.unlock();
+    Event *top = async_queue.load(std::memory_order_relaxed);
+    do {
+        event->nextBin = top;
+    } while (!async_queue.compare_exchange_weak(top, event,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
+}
+
+Tick
+EventQueue::earliestTick()
+{
+    // Producers only ever push new events in front of the ones
+    // already on the stack, so it can be walked without taking it as
+    // long as the owning thread isn't merging it.
+    Tick earliest = empty() ? MaxTick : nextTick();
+    for (const Event *event = async_queue.load(std::memory_order_acquire);
+         event; event = event->nextBin)
+        earliest = std::min(earliest, event->when());
+
+    return earliest;
 }
 
 void
 EventQueue::handleAsyncInsertions()
 {
     assert(this == curEventQueue());
-    async_queue_mutex.lock();
+    if (!hasAsyncInsertions())
+        return;
 
-    while (!async_queue.empty()) {
-        insert(async_queue.front());
-        async_queue.pop_front();
+    Event *stack = async_queue.exchange(nullptr, std::memory_order_acquire);
+
+    // Reverse the stack to merge the events in the order they were
+    // added, which keeps the order of events within a bin the same
+    // as with a FIFO.
+    Event *fifo = nullptr;
+    while (stack) {
+        Event *next = stack->nextBin;
+        stack->nextBin = fifo;
+        fifo = stack;
+        stack = next;
     }
 
-    async_queue_mutex.unlock();
+    while (fifo) {
+        Event *next = fifo->nextBin;
+        fifo->nextBin = nullptr;
+        insert(fifo);
+        fifo = next;
+    }
 }
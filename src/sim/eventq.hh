@@ -39,17 +39,25 @@
 #define __SIM_EVENTQ_HH__
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <functional>
 #include <iosfwd>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "base/flags.hh"
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "debug/Event.hh"
+#include "sim/event_profile.hh"
+#include "sim/host_perf.hh"
 #include "sim/serialize.hh"
 
 class EventQueue;       // forward declaration
@@ -62,6 +70,14 @@ class BaseGlobalEvent;
 //! Queue B should be at least simQuantum ticks away in future.
 extern Tick simQuantum;
 
+//! Synchronize multiple event queues using lookahead rather than at
+//! fixed intervals. In this mode, simQuantum is the lookahead: the
+//! smallest delay with which an event on one queue can cause an event
+//! on another queue. Queues then only synchronize once every
+//! simQuantum ticks past the earliest pending event in the system,
+//! which skips over windows in which no queue has work to do.
+extern bool simQuantumLookahead;
+
 //! Current number of allocated main event queues.
 extern uint32_t numMainEventQueues;
 
@@ -333,6 +349,29 @@ class Event : public EventBase, public Serializable
 
     /** @} */
 
+  public: /* Allocation */
+    /**
+     * @{
+     * Heap allocated events, which are typically short-lived
+     * AutoDelete events, are served from thread-local size-class free
+     * lists rather than the general purpose heap. Since every event
+     * queue is serviced by a single thread, this gives each queue its
+     * own event pool without any locking.
+     */
+    typedef PoolAllocator<Event> Pool;
+
+    static void *operator new(size_t size) { return Pool::allocate(size); }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        Pool::deallocate(p, size);
+    }
+
+    static void *operator new(size_t size, void *p) { return p; }
+    static void operator delete(void *p, void *place) {}
+    /** @} */
+
   public:
 
     /*
@@ -488,16 +527,96 @@ operator!=(const Event &l, const Event &r)
  */
 class EventQueue
 {
+  public:
+    /**
+     * Data structure used to keep the queue sorted.
+     *
+     * The List engine keeps all bins in a single sorted linked list,
+     * which makes insertion linear in the number of distinct
+     * (when, priority) pairs in the queue. The Calendar engine hashes
+     * bins into an array of time buckets (a calendar queue) whose
+     * size and bucket width adapt to the queue contents, which makes
+     * insertion and removal close to constant time for large queues.
+     *
+     * Both engines service events in exactly the same order: by
+     * time, then priority, then LIFO among events in the same bin.
+     */
+    enum class Engine { List, Calendar };
+
   private:
     std::string objName;
     Event *head;
     Tick _curTick;
 
-    //! Mutex to protect async queue.
-    std::mutex async_queue_mutex;
+    //! Engine currently used to keep track of the scheduled events.
+    Engine engine;
+
+    //! Host time profile of the serviced events, if enabled.
+    std::unique_ptr<EventProfile> profile;
+
+    //! Number of events processed by this queue.
+    uint64_t _numServiced;
+
+    //! Process an event and record the host time it took.
+    void processProfiled(Event *event);
+
+    //! Host performance counters of the owners of the serviced
+    //! events, if enabled.
+    std::unique_ptr<HostPerfCounters> hostPerf;
+
+    /**
+     * @{
+     * Calendar engine state. Each bucket points to the top of the
+     * earliest bin that hashes to it, the remaining bins of the
+     * bucket are chained in sorted order using their nextBin
+     * pointer. The head pointer always refers to the top of the
+     * earliest bin in the whole calendar.
+     */
+    std::vector<Event *> buckets;
+    //! log2 of the number of ticks covered by a bucket.
+    unsigned bucketShift;
+    //! Number of distinct bins currently in the calendar.
+    size_t numBins;
+    /** @} */
+
+    //! Smallest number of buckets in the calendar.
+    static const size_t minBuckets = 16;
+
+    size_t
+    bucketIndex(Tick when) const
+    {
+        return (when >> bucketShift) & (buckets.size() - 1);
+    }
+
+    void calendarInsert(Event *event);
+    void calendarRemove(Event *event);
+
+    //! Find the earliest bin in the calendar, searching forward from
+    //! the bucket covering 'when'. All events must be at or after 'when'.
+    Event *calendarFindHead(Tick when) const;
+
+    //! Remove all events from the calendar and return them as a
+    //! sorted list of bins, in the format used by the List engine.
+    Event *calendarExtract();
 
-    //! List of events added by other threads to this event queue.
-    std::list<Event*> async_queue;
+    //! Load a sorted list of bins into a (resized) empty calendar.
+    void calendarLoad(Event *list);
+
+    //! Rebuild the calendar to match the number of bins in it.
+    void calendarResize();
+
+    //! Top of every bin in the queue, in service order.
+    std::vector<Event *> sortedBins() const;
+
+    /**
+     * Events added by other threads to this event queue, most recent
+     * first. The events are chained through their nextBin pointers,
+     * which are unused until the event is merged into the main
+     * queue. Producers push with a CAS and the owning thread takes
+     * the whole stack with a single exchange, so a null pointer here
+     * doubles as a cheap check for pending insertions.
+     */
+    std::atomic<Event *> async_queue;
 
     /**
      * Lock protecting event handling.
@@ -607,6 +726,32 @@ class EventQueue
     virtual const std::string name() const { return objName; }
     void name(const std::string &st) { objName = st; }
 
+    /**
+     * Switch the data structure used to keep the queue sorted. Any
+     * events already scheduled are moved to the new engine and keep
+     * their relative order.
+     *
+     * @warn Must not be called while the queue is serviced by another
+     * thread.
+     */
+    void setEngine(Engine e);
+    Engine getEngine() const { return engine; }
+
+    /**
+     * Enable or disable recording the host time spent processing each
+     * type of event. Disabling profiling discards the profile.
+     */
+    void setProfiling(bool enable);
+    EventProfile *getProfile() const { return profile.get(); }
+
+    /**
+     * Enable or disable charging the host performance counters of the
+     * thread servicing this queue to the owners of the events.
+     * Disabling the counters discards their counts.
+     */
+    void setHostPerf(bool enable);
+    HostPerfCounters *getHostPerfCounters() const { return hostPerf.get(); }
+
     //! Schedule the given event on this queue. Safe to call from any
     //! thread.
     void schedule(Event *event, Tick when, bool global = false);
@@ -620,10 +765,21 @@ class EventQueue
     void reschedule(Event *event, Tick when, bool always = false);
 
     Tick nextTick() const { return head->when(); }
+
+    /**
+     * Tick of the earliest event on this queue, including events
+     * inserted by other threads that have not been merged yet, or
+     * MaxTick if there are none. Only meaningful while the owning
+     * thread is not servicing events, e.g., during a global barrier.
+     */
+    Tick earliestTick();
     void setCurTick(Tick newVal) { _curTick = newVal; }
     Tick getCurTick() const { return _curTick; }
     Event *getHead() const { return head; }
 
+    /** Number of events processed by this queue, squashed ones excluded */
+    uint64_t numServiced() const { return _numServiced; }
+
     Event *serviceOne();
 
     // process all events up to the given timestamp.  we inline a
@@ -657,6 +813,13 @@ class EventQueue
     //! Function for moving events from the async_queue to the main queue.
     void handleAsyncInsertions();
 
+    //! Check if other threads have added events to this queue.
+    bool
+    hasAsyncInsertions() const
+    {
+        return async_queue.load(std::memory_order_relaxed) != nullptr;
+    }
+
     /**
      *  Function to signal that the event loop should be woken up because
      *  an event has been scheduled by an agent outside the gem5 event
@@ -676,7 +839,8 @@ class EventQueue
      *  function for replacing the head of the event queue, so that a
      *  different set of events can run without disturbing events that have
      *  already been scheduled. Already scheduled events can be processed
-     *  by replacing the original head back.
+     *  by replacing the original head back. Events are passed in and
+     *  returned as a sorted list of bins regardless of the engine.
      *  USING THIS FUNCTION CAN BE DANGEROUS TO THE HEALTH OF THE SIMULATOR.
      *  NOT RECOMMENDED FOR USE.
      */
@@ -716,6 +880,20 @@ class EventQueue
 
 void dumpMainQueue();
 
+//! Engine used by main event queues created from now on.
+extern EventQueue::Engine defaultEventQueueEngine;
+
+//! Change the engine of all existing and future main event queues.
+void setMainQueueEngine(EventQueue::Engine engine);
+
+//! Enable or disable profiling of all existing and future main event
+//! queues.
+void setMainQueueProfiling(bool enable);
+
+//! Enable or disable host performance counters on all existing and
+//! future main event queues.
+void setMainQueueHostPerf(bool enable);
+
 class EventManager
 {
   protected:
@@ -809,24 +987,127 @@ class EventWrapper : public Event
     const char *description() const { return "EventWrapped"; }
 };
 
+/**
+ * Event that calls an arbitrary callable object when processed.
+ *
+ * Callables that are small enough, such as lambdas capturing a couple
+ * of pointers, are stored inside the event itself, so creating an
+ * event does not require a separate heap allocation for the callback
+ * (unlike std::function, which only stores very small callables
+ * locally). Larger callables are copied to the heap.
+ */
 class EventFunctionWrapper : public Event
 {
   private:
-      std::function<void(void)> callback;
-      std::string _name;
+    /** Size of the storage reserved for callables in the event. */
+    static const size_t InlineSize = 4 * sizeof(void *);
+
+    union Storage
+    {
+        void *heap;
+        typename std::aligned_storage<InlineSize,
+                                      alignof(std::max_align_t)>::type local;
+    };
+
+    /** Type-erased operations on the stored callable. */
+    struct Ops
+    {
+        void (*invoke)(Storage &s);
+        void (*copy)(Storage &dst, const Storage &src);
+        void (*destroy)(Storage &s);
+    };
+
+    template <typename F>
+    struct LocalOps
+    {
+        static F &get(Storage &s) { return *reinterpret_cast<F *>(&s.local); }
+
+        static void invoke(Storage &s) { get(s)(); }
+        static void destroy(Storage &s) { get(s).~F(); }
+
+        static void
+        copy(Storage &dst, const Storage &src)
+        {
+            new (&dst.local) F(*reinterpret_cast<const F *>(&src.local));
+        }
+
+        static const Ops ops;
+    };
+
+    template <typename F>
+    struct HeapOps
+    {
+        static F &get(Storage &s) { return *static_cast<F *>(s.heap); }
+
+        static void invoke(Storage &s) { get(s)(); }
+        static void destroy(Storage &s) { delete &get(s); }
+
+        static void
+        copy(Storage &dst, const Storage &src)
+        {
+            dst.heap = new F(*static_cast<const F *>(src.heap));
+        }
+
+        static const Ops ops;
+    };
+
+    template <typename F>
+    struct StoredLocally
+    {
+        static const bool value = sizeof(F) <= sizeof(Storage) &&
+            alignof(Storage) % alignof(F) == 0;
+    };
+
+    Storage storage;
+    const Ops *ops;
+    std::string _name;
+
+    template <typename F>
+    typename std::enable_if<
+        StoredLocally<typename std::decay<F>::type>::value>::type
+    store(F &&f)
+    {
+        typedef typename std::decay<F>::type Fn;
+        new (&storage.local) Fn(std::forward<F>(f));
+        ops = &LocalOps<Fn>::ops;
+    }
+
+    template <typename F>
+    typename std::enable_if<
+        !StoredLocally<typename std::decay<F>::type>::value>::type
+    store(F &&f)
+    {
+        typedef typename std::decay<F>::type Fn;
+        storage.heap = new Fn(std::forward<F>(f));
+        ops = &HeapOps<Fn>::ops;
+    }
 
   public:
-    EventFunctionWrapper(const std::function<void(void)> &callback,
+    template <typename F, typename = typename std::enable_if<
+                  !std::is_same<typename std::decay<F>::type,
+                                EventFunctionWrapper>::value>::type>
+    EventFunctionWrapper(F &&callback,
                          const std::string &name,
                          bool del = false,
                          Priority p = Default_Pri)
-        : Event(p), callback(callback), _name(name)
+        : Event(p), _name(name)
     {
+        store(std::forward<F>(callback));
         if (del)
             setFlags(AutoDelete);
     }
 
-    void process() { callback(); }
+    EventFunctionWrapper(const EventFunctionWrapper &other)
+        : Event(other), ops(other.ops), _name(other._name)
+    {
+        ops->copy(storage, other.storage);
+    }
+
+    EventFunctionWrapper &operator=(const EventFunctionWrapper &) = delete;
+
+    ~EventFunctionWrapper() { ops->destroy(storage); }
+
+    void process() { ops->invoke(storage); }
 
     const std::string
     name() const
@@ -837,4 +1118,14 @@ class EventFunctionWrapper : public Event
     const char *description() const { return "EventFunctionWrapped"; }
 };
 
+template <typename F>
+const EventFunctionWrapper::Ops EventFunctionWrapper::LocalOps<F>::ops = {
+    &LocalOps<F>::invoke, &LocalOps<F>::copy, &LocalOps<F>::destroy
+};
+
+template <typename F>
+const EventFunctionWrapper::Ops EventFunctionWrapper::HeapOps<F>::ops = {
+    &HeapOps<F>::invoke, &HeapOps<F>::copy, &HeapOps<F>::destroy
+};
+
 #endif // __SIM_EVENTQ_HH__
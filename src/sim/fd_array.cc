@@ -339,6 +339,10 @@ FDArray::closeFDEntry(int tgt_fd)
     if (hbfdp)
         sim_fd = hbfdp->getSimFD();
 
+    auto ffdp = std::dynamic_pointer_cast<FileFDEntry>(_fdArray[tgt_fd]);
+    if (ffdp)
+        ffdp->cancelReadAhead();
+
     int status = 0;
     if (sim_fd > 2)
         status = close(sim_fd);
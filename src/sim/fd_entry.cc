@@ -35,6 +35,10 @@
 
 #include "sim/fd_entry.hh"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "sim/read_ahead.hh"
 #include "sim/serialize.hh"
 
 void
@@ -67,6 +71,27 @@ FileFDEntry::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(_fileOffset);
 }
 
+ReadAhead *
+FileFDEntry::getReadAhead(size_t block_size)
+{
+    if (!_readAheadChecked) {
+        _readAheadChecked = true;
+        struct stat st;
+        if ((_flags & O_ACCMODE) == O_RDONLY &&
+            fstat(_simFD, &st) == 0 && S_ISREG(st.st_mode)) {
+            _readAhead = std::make_shared<ReadAhead>(_simFD, block_size);
+        }
+    }
+    return _readAhead.get();
+}
+
+void
+FileFDEntry::cancelReadAhead()
+{
+    if (_readAhead)
+        _readAhead->cancel();
+}
+
 void
 PipeFDEntry::serialize(CheckpointOut &cp) const
 {
@@ -43,6 +43,7 @@
 #include "sim/serialize.hh"
 
 class EmulatedDriver;
+class ReadAhead;
 
 /**
  * Holds a single file descriptor mapping and that mapping's data for
@@ -105,12 +106,15 @@ class FileFDEntry: public HBFDEntry
     FileFDEntry(int sim_fd, int flags, std::string const& file_name,
                 uint64_t file_offset, bool close_on_exec = false)
         : HBFDEntry(flags, sim_fd, close_on_exec),
-          _fileName(file_name), _fileOffset(file_offset)
+          _fileName(file_name), _fileOffset(file_offset),
+          _readAheadChecked(false)
     { }
 
     FileFDEntry(FileFDEntry const& reg, bool close_on_exec = false)
         : HBFDEntry(reg._flags, reg._simFD, close_on_exec),
-          _fileName(reg._fileName), _fileOffset(reg._fileOffset)
+          _fileName(reg._fileName), _fileOffset(reg._fileOffset),
+          _readAhead(reg._readAhead),
+          _readAheadChecked(reg._readAheadChecked)
     { }
 
     inline std::shared_ptr<FDEntry>
@@ -125,12 +129,28 @@ class FileFDEntry: public HBFDEntry
     inline void setFileName(std::string file_name) { _fileName = file_name; }
     inline void setFileOffset (uint64_t f_off) { _fileOffset = f_off; }
 
+    /**
+     * Get the read-ahead of the host file, which is shared by all the
+     * copies of this entry and created on first use. Only regular
+     * files opened read-only are read ahead.
+     *
+     * @param block_size Number of bytes to read ahead at a time
+     * @return The read-ahead, or nullptr if the file is not read ahead
+     */
+    ReadAhead *getReadAhead(size_t block_size);
+
+    /** Stop reading ahead, before the host file is closed. */
+    void cancelReadAhead();
+
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 
   private:
     std::string _fileName;
     uint64_t _fileOffset;
+
+    std::shared_ptr<ReadAhead> _readAhead;
+    bool _readAheadChecked;
 };
 
 /**
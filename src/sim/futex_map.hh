@@ -82,7 +82,9 @@ namespace std {
 typedef std::list<ThreadContext *> ThreadContextList;
 
 /**
- * FutexMap class holds a map of all futexes used in the system
+ * FutexMap class holds a map of all futexes used in the system. It is
+ * only used while emulating a system call, which serializes accesses
+ * from threads running on different event queues.
  */
 class FutexMap : public std::unordered_map<FutexKey, ThreadContextList>
 {
@@ -119,7 +121,7 @@ class FutexMap : public std::unordered_map<FutexKey, ThreadContextList>
         auto &tcList = it->second;
 
         while (!tcList.empty() && woken_up < count) {
-            tcList.front()->activate();
+            remoteActivate(tcList.front());
             tcList.pop_front();
             woken_up++;
         }
@@ -31,6 +31,8 @@
 
 #include "sim/global_event.hh"
 
+#include <algorithm>
+
 std::mutex BaseGlobalEvent::globalQMutex;
 
 BaseGlobalEvent::BaseGlobalEvent(Priority p, Flags f)
@@ -154,9 +156,24 @@ GlobalSyncEvent::BarrierEvent::process()
 void
 GlobalSyncEvent::process()
 {
-    if (repeat) {
-        schedule(curTick() + repeat);
+    if (!repeat)
+        return;
+
+    Tick next = curTick() + repeat;
+    if (lookahead) {
+        // All other queues are waiting on the barrier. An event on one
+        // queue can't cause an event on another queue less than
+        // 'repeat' ticks into the future, so nothing can arrive at any
+        // queue before 'repeat' ticks past the earliest pending event.
+        Tick earliest = MaxTick;
+        for (uint32_t i = 0; i < numMainEventQueues; ++i)
+            earliest = std::min(earliest, mainEventQueue[i]->earliestTick());
+
+        if (earliest > curTick())
+            next = earliest < MaxTick - repeat ? earliest + repeat : MaxTick;
     }
+
+    schedule(next);
 }
 
 const char *
@@ -219,11 +219,12 @@ class GlobalSyncEvent : public BaseGlobalEventTemplate<GlobalSyncEvent>
     };
 
     GlobalSyncEvent(Priority p, Flags f)
-        : Base(p, f), repeat(0)
+        : Base(p, f), repeat(0), lookahead(false)
     { }
 
-    GlobalSyncEvent(Tick when, Tick _repeat, Priority p, Flags f)
-        : Base(p, f), repeat(_repeat)
+    GlobalSyncEvent(Tick when, Tick _repeat, Priority p, Flags f,
+                    bool _lookahead = false)
+        : Base(p, f), repeat(_repeat), lookahead(_lookahead)
     {
         schedule(when);
     }
@@ -233,6 +234,13 @@ class GlobalSyncEvent : public BaseGlobalEventTemplate<GlobalSyncEvent>
     const char *description() const;
 
     Tick repeat;
+
+    /**
+     * Treat repeat as the lookahead between queues and schedule the
+     * next synchronization repeat ticks after the earliest pending
+     * event rather than repeat ticks from now.
+     */
+    bool lookahead;
 };
 
 
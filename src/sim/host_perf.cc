@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/host_perf.hh"
+
+#include <list>
+
+#include "base/callback.hh"
+#include "base/logging.hh"
+#include "base/statistics.hh"
+#include "config/use_host_perf.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+#if USE_HOST_PERF
+#include "cpu/kvm/perfevent.hh"
+#endif
+
+#if USE_HOST_PERF
+
+struct HostPerfCounters::Group
+{
+    PerfKvmCounter counters[NumCounters];
+
+    /** Attach the counters to the calling thread */
+    bool
+    attach()
+    {
+        static const uint64_t configs[NumCounters] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+        };
+
+        for (int i = 0; i < NumCounters; ++i) {
+            // Only count gem5 itself, which also works for
+            // unprivileged users
+            PerfKvmCounterConfig cfg(PERF_TYPE_HARDWARE, configs[i]);
+            cfg.exclude_kernel(true).exclude_hv(true);
+            if (!counters[i].tryAttach(cfg, 0, i ? &counters[0] : nullptr))
+                return false;
+        }
+        return true;
+    }
+
+    Counts
+    read() const
+    {
+        Counts counts;
+        for (int i = 0; i < NumCounters; ++i)
+            counts[i] = counters[i].read();
+        return counts;
+    }
+};
+
+#else
+
+struct HostPerfCounters::Group
+{
+    bool attach() { return false; }
+    Counts read() const { return Counts(); }
+};
+
+#endif
+
+HostPerfCounters::HostPerfCounters()
+    : failed(!supported())
+{
+    last.fill(0);
+}
+
+HostPerfCounters::~HostPerfCounters()
+{
+}
+
+bool
+HostPerfCounters::supported()
+{
+    return USE_HOST_PERF;
+}
+
+const SimObject *
+HostPerfCounters::owner(const Event *event)
+{
+    const std::string name = event->name();
+    auto o = owners.find(name);
+    if (o != owners.end())
+        return o->second;
+
+    // Try the name and its prefixes, longest first
+    const SimObject *obj = nullptr;
+    std::string prefix = name;
+    while (!(obj = SimObject::find(prefix.c_str()))) {
+        size_t dot = prefix.rfind('.');
+        if (dot == std::string::npos)
+            break;
+        prefix.resize(dot);
+    }
+
+    owners.emplace(name, obj);
+    return obj;
+}
+
+void
+HostPerfCounters::record(const SimObject *owner)
+{
+    if (failed)
+        return;
+
+    if (!group) {
+        group.reset(new Group());
+        if (!group->attach()) {
+            warn("Failed to open host performance counters, check "
+                 "/proc/sys/kernel/perf_event_paranoid\n");
+            failed = true;
+            return;
+        }
+        last = group->read();
+        return;
+    }
+
+    const Counts now = group->read();
+    Counts &counts = _counts[owner];
+    for (int i = 0; i < NumCounters; ++i)
+        counts[i] += now[i] - last[i];
+    last = now;
+}
+
+HostPerfCounters::Counts
+HostPerfCounters::counts(const SimObject *obj) const
+{
+    auto c = _counts.find(obj);
+    return c != _counts.end() ? c->second : Counts();
+}
+
+void
+HostPerfCounters::reset()
+{
+    _counts.clear();
+}
+
+namespace
+{
+
+bool enabled = false;
+
+/** Host counter stats of a single SimObject, or of nobody */
+class ObjectStats
+{
+  private:
+    const SimObject *obj;
+
+    Stats::Value cycles;
+    Stats::Value insts;
+    Stats::Value cacheMisses;
+
+    uint64_t
+    sum(HostPerfCounters::Counter counter) const
+    {
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+            if (auto *perf = mainEventQueue[i]->getHostPerfCounters())
+                total += perf->counts(obj)[counter];
+        }
+        return total;
+    }
+
+  public:
+    ObjectStats(const SimObject *_obj, const std::string &prefix)
+        : obj(_obj)
+    {
+        cycles
+            .method(this, &ObjectStats::hostCycles)
+            .name(prefix + "host_cycles")
+            .desc("Host cycles spent processing events")
+            .prereq(cycles)
+            ;
+
+        insts
+            .method(this, &ObjectStats::hostInsts)
+            .name(prefix + "host_insts")
+            .desc("Host instructions executed processing events")
+            .prereq(insts)
+            ;
+
+        cacheMisses
+            .method(this, &ObjectStats::hostCacheMisses)
+            .name(prefix + "host_cache_misses")
+            .desc("Host cache misses processing events")
+            .prereq(cacheMisses)
+            ;
+    }
+
+    uint64_t hostCycles() const { return sum(HostPerfCounters::Cycles); }
+    uint64_t hostInsts() const { return sum(HostPerfCounters::Instructions); }
+
+    uint64_t
+    hostCacheMisses() const
+    {
+        return sum(HostPerfCounters::CacheMisses);
+    }
+};
+
+std::list<ObjectStats> objectStats;
+
+struct ResetCallback : public Callback
+{
+    void
+    process() override
+    {
+        for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+            if (auto *perf = mainEventQueue[i]->getHostPerfCounters())
+                perf->reset();
+        }
+    }
+};
+
+} // anonymous namespace
+
+void
+setHostPerfCounters(bool enable)
+{
+    static bool callback_registered = false;
+
+    if (enable && !HostPerfCounters::supported()) {
+        warn("Host performance counters aren't supported by this build\n");
+        enable = false;
+    }
+
+    enabled = enable;
+    setMainQueueHostPerf(enable);
+
+    if (enable && !callback_registered) {
+        Stats::registerResetCallback(new ResetCallback());
+        callback_registered = true;
+    }
+}
+
+void
+registerHostPerfStats()
+{
+    if (!enabled || !objectStats.empty())
+        return;
+
+    for (const SimObject *obj : SimObject::getSimObjectList())
+        objectStats.emplace_back(obj, obj->name() + ".");
+    objectStats.emplace_back(nullptr, "host_unattributed_");
+}
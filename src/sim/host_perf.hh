@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Host performance counters attributed to SimObjects.
+ */
+
+#ifndef __SIM_HOST_PERF_HH__
+#define __SIM_HOST_PERF_HH__
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class Event;
+class SimObject;
+
+/**
+ * Host cycles, instructions and cache misses of the thread servicing
+ * an event queue, attributed to the SimObjects that own the events
+ * it processes. The counters are read after every event and the
+ * difference to the previous read is charged to the owner of the
+ * event, so the cost of the event loop itself is spread over the
+ * events.
+ *
+ * An event is owned by the SimObject with the longest name that the
+ * event's name starts with. Events that don't match any object are
+ * charged to nobody and reported separately.
+ */
+class HostPerfCounters
+{
+  public:
+    enum Counter { Cycles, Instructions, CacheMisses, NumCounters };
+
+    typedef std::array<uint64_t, NumCounters> Counts;
+
+    HostPerfCounters();
+    ~HostPerfCounters();
+
+    /** Check if this build supports host performance counters. */
+    static bool supported();
+
+    /**
+     * Get the SimObject that owns an event. This has to be called
+     * before the event is processed since it may delete itself.
+     *
+     * @return The owner, or nullptr if it can't be determined
+     */
+    const SimObject *owner(const Event *event);
+
+    /**
+     * Charge the counts since the last call to a SimObject.
+     *
+     * @param owner Owner of the event that was just processed
+     */
+    void record(const SimObject *owner);
+
+    /** Get the counts charged to an object since the last reset. */
+    Counts counts(const SimObject *obj) const;
+
+    void reset();
+
+  private:
+    /** The perf_event counters of the servicing thread */
+    struct Group;
+
+    /**
+     * Counters are per thread, so they are attached by the first
+     * call to record() on the thread that services the queue.
+     */
+    std::unique_ptr<Group> group;
+
+    /** Set if the counters could not be attached */
+    bool failed;
+
+    /** Counter values at the last call to record() */
+    Counts last;
+
+    /** Owners of the event names seen so far */
+    std::unordered_map<std::string, const SimObject *> owners;
+
+    std::unordered_map<const SimObject *, Counts> _counts;
+};
+
+/**
+ * Enable or disable host performance counters on all existing and
+ * future main event queues.
+ */
+void setHostPerfCounters(bool enable);
+
+/**
+ * Register host_cycles, host_insts and host_cache_misses stats for
+ * every SimObject. Does nothing unless the counters are enabled.
+ */
+void registerHostPerfStats();
+
+#endif // __SIM_HOST_PERF_HH__
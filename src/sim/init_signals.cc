@@ -58,6 +58,8 @@
 #include "base/atomicio.hh"
 #include "base/cprintf.hh"
 #include "base/logging.hh"
+#include "base/trace.hh"
+#include "mem/port_trace.hh"
 #include "sim/async.hh"
 #include "sim/backtrace.hh"
 #include "sim/core.hh"
@@ -154,6 +156,8 @@ abortHandler(int sigtype)
     }
 
     print_backtrace();
+    Trace::flushOnError();
+    PortTrace::dumpAll("port_traces.txt");
     raiseFatalSignal(sigtype);
 }
 
@@ -164,6 +168,7 @@ segvHandler(int sigtype)
     STATIC_ERR("gem5 has encountered a segmentation fault!\n\n");
 
     print_backtrace();
+    Trace::flushOnError();
     raiseFatalSignal(SIGSEGV);
 }
 
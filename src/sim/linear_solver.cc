@@ -39,34 +39,44 @@
 
 #include "sim/linear_solver.hh"
 
+#include <cmath>
+
 std::vector <double>
 LinearSystem::solve() const
 {
     // Solve using gauss elimination, not ideal for big matrices
-    std::vector < LinearEquation > smatrix = this->matrix;
+    // (see solveIterative). Work on a dense copy of the equations.
+    unsigned order = matrix.size();
+    std::vector < std::vector <double> > smatrix(
+        order, std::vector <double> (order + 1, 0.0));
+    for (unsigned row = 0; row < order; row++) {
+        for (auto & t: matrix[row].terms())
+            smatrix[row][t.first] = t.second;
+        smatrix[row][order] = matrix[row].get(matrix[row].cnt());
+    }
 
-    unsigned order = smatrix.size();
     for (unsigned row = 0; row < order - 1; row++) {
         // Look for a non-zero row, and swap
         for (unsigned i = row; i < order; i++) {
             if (smatrix[i][row] != 0.0f) {
-                if (i != row) {
-                    LinearEquation tmp = smatrix[i];
-                    smatrix[i] = smatrix[row];
-                    smatrix[row] = tmp;
-                }
+                if (i != row)
+                    smatrix[i].swap(smatrix[row]);
                 break;
             }
         }
 
         // Divide row by leading number to make it 1.0
-        smatrix[row] *= (1.0f / smatrix[row][row]);
+        double lead = 1.0f / smatrix[row][row];
+        for (auto & c: smatrix[row])
+            c *= lead;
 
         // Add it (properly scaled) to the rows below
         for (unsigned i = row + 1; i < order; i++) {
-            LinearEquation t = smatrix[row];
-            t *= -1.0f * smatrix[i][row];
-            smatrix[i] = smatrix[i] + t;
+            double f = -1.0f * smatrix[i][row];
+            if (f == 0.0f)
+                continue;
+            for (unsigned j = row; j <= order; j++)
+                smatrix[i][j] += f * smatrix[row][j];
         }
     }
 
@@ -75,13 +85,111 @@ LinearSystem::solve() const
     std::vector <double> ret(order, 0.0f);
     for (int row = order - 1; row >= 0; row--) {
         // Unknown value
-        ret[row] = -smatrix[row][smatrix[row].cnt()] / smatrix[row][row];
+        ret[row] = -smatrix[row][order] / smatrix[row][row];
         // Propagate variable in the cnt term
         for (int i = row - 1; i >= 0; i--) {
-            smatrix[i][smatrix[i].cnt()] += ret[row] * smatrix[i][row];
+            smatrix[i][order] += ret[row] * smatrix[i][row];
             smatrix[i][row] = 0.0f;
         }
     }
 
     return ret;
 }
+
+bool
+LinearSystem::solveIterative(std::vector <double> &x, double tolerance,
+                             unsigned max_iters) const
+{
+    unsigned order = matrix.size();
+    assert(x.size() == order);
+    if (order == 0)
+        return true;
+
+    // Build the matrix in compressed sparse row form, and move the
+    // constant terms to the right hand side: A * x = b
+    std::vector <unsigned> row_start(order + 1, 0);
+    std::vector <unsigned> col;
+    std::vector <double> val;
+    std::vector <double> b(order);
+    std::vector <double> inv_diag(order, 0.0);
+    for (unsigned row = 0; row < order; row++) {
+        row_start[row] = col.size();
+        for (auto & t: matrix[row].terms()) {
+            if (t.second == 0.0)
+                continue;
+            col.push_back(t.first);
+            val.push_back(t.second);
+            if (t.first == row)
+                inv_diag[row] = 1.0 / t.second;
+        }
+        b[row] = -matrix[row].get(matrix[row].cnt());
+    }
+    row_start[order] = col.size();
+
+    // Conjugate gradients need a positive definite matrix. Nodal
+    // equations are usually written the other way round, so the
+    // Jacobi preconditioner takes care of the sign as well: M^-1 * A
+    // has a positive diagonal either way.
+    for (unsigned row = 0; row < order; row++) {
+        if (inv_diag[row] == 0.0)
+            return false;
+        if ((inv_diag[row] > 0) != (inv_diag[0] > 0))
+            return false;
+    }
+    double sign = inv_diag[0] > 0 ? 1.0 : -1.0;
+
+    auto multiply = [&](const std::vector <double> &v,
+                        std::vector <double> &res) {
+        for (unsigned row = 0; row < order; row++) {
+            double sum = 0;
+            for (unsigned i = row_start[row]; i < row_start[row + 1]; i++)
+                sum += val[i] * v[col[i]];
+            res[row] = sum;
+        }
+    };
+    auto dot = [order](const std::vector <double> &u,
+                       const std::vector <double> &v) {
+        double sum = 0;
+        for (unsigned i = 0; i < order; i++)
+            sum += u[i] * v[i];
+        return sum;
+    };
+
+    double b_norm = std::sqrt(dot(b, b));
+    double target = tolerance * (b_norm > 0 ? b_norm : 1.0);
+
+    // r = b - A * x, z = M^-1 * r, p = z
+    std::vector <double> r(order), z(order), p(order), ap(order);
+    multiply(x, ap);
+    for (unsigned i = 0; i < order; i++) {
+        r[i] = b[i] - ap[i];
+        z[i] = inv_diag[i] * r[i];
+    }
+    p = z;
+    double rz = sign * dot(r, z);
+
+    for (unsigned iter = 0; iter < max_iters; iter++) {
+        if (std::sqrt(dot(r, r)) <= target)
+            return true;
+
+        multiply(p, ap);
+        double pap = sign * dot(p, ap);
+        if (pap <= 0)
+            return false;
+
+        double alpha = rz / pap;
+        for (unsigned i = 0; i < order; i++) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * ap[i];
+            z[i] = inv_diag[i] * r[i];
+        }
+
+        double rz_next = sign * dot(r, z);
+        double beta = rz_next / rz;
+        rz = rz_next;
+        for (unsigned i = 0; i < order; i++)
+            p[i] = z[i] + beta * p[i];
+    }
+
+    return std::sqrt(dot(r, r)) <= target;
+}
@@ -43,54 +43,79 @@
 #include <cassert>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 /**
  * This class describes a linear equation with constant coefficients.
  * The equation has a certain (variable) number of unkowns and it can hold
- * N+1 coefficients.
+ * N+1 coefficients. Only the non-zero coefficients are stored, since the
+ * equations of a large system usually involve just a few unknowns.
  */
 
 class LinearEquation {
   public:
-    LinearEquation(unsigned unknowns) {
-        eq = std::vector <double> (unknowns + 1, 0);
+    LinearEquation(unsigned unknowns)
+        : unknowns(unknowns), constant(0) {
     }
 
     // Add two equations
     LinearEquation operator+ (const LinearEquation& rhs) {
-        assert(this->eq.size() == rhs.eq.size());
+        assert(this->unknowns == rhs.unknowns);
 
-        LinearEquation res(this->eq.size() - 1);
+        LinearEquation res(*this);
 
-        for (unsigned i = 0; i < res.eq.size(); i++)
-            res.eq[i] = this->eq[i] + rhs.eq[i];
+        for (auto & t: rhs.coeffs)
+            res[t.first] += t.second;
+        res.constant += rhs.constant;
 
         return res;
     }
 
     // Multiply the equation by a constant
     LinearEquation & operator*= (const double cnt) {
-        for (auto & c: eq)
-            c *= cnt;
+        for (auto & t: coeffs)
+            t.second *= cnt;
+        constant *= cnt;
 
         return *this;
     }
 
     // Access a certain equation coefficient
     double & operator[] (unsigned unkw) {
-        assert(unkw < eq.size());
-        return eq[unkw];
+        assert(unkw <= unknowns);
+        if (unkw == unknowns)
+            return constant;
+
+        for (auto & t: coeffs) {
+            if (t.first == unkw)
+                return t.second;
+        }
+        coeffs.emplace_back(unkw, 0.0);
+        return coeffs.back().second;
+    }
+
+    // Get a coefficient without adding it to the equation
+    double get(unsigned unkw) const {
+        assert(unkw <= unknowns);
+        if (unkw == unknowns)
+            return constant;
+
+        for (auto & t: coeffs) {
+            if (t.first == unkw)
+                return t.second;
+        }
+        return 0.0;
     }
 
     // Get a string representation
     std::string toStr() const {
         std::ostringstream oss;
-        for (unsigned i = 0; i < eq.size(); i++) {
+        for (unsigned i = 0; i <= unknowns; i++) {
             if (i)
                 oss << " + ";
-            oss << eq[i];
-            if (i != eq.size() - 1)
+            oss << get(i);
+            if (i != unknowns)
                 oss << "*x" << i;
         }
         oss << " = 0";
@@ -98,12 +123,21 @@ class LinearEquation {
     }
 
     // Index for the constant term
-    unsigned cnt() const { return eq.size() - 1; }
+    unsigned cnt() const { return unknowns; }
+
+    // Coefficients that have been set, as (unknown, value) pairs
+    const std::vector <std::pair<unsigned, double>> & terms() const {
+        return coeffs;
+    }
 
   private:
 
-    /** Coefficients */
-    std::vector <double> eq;
+    /** Number of unknowns */
+    unsigned unknowns;
+    /** Coefficients of the unknowns that have been set */
+    std::vector <std::pair<unsigned, double>> coeffs;
+    /** Constant term */
+    double constant;
 };
 
 class LinearSystem {
@@ -125,8 +159,27 @@ class LinearSystem {
         return r;
     }
 
+    /** Solve the system directly using gaussian elimination. */
     std::vector <double> solve() const;
 
+    /**
+     * Solve the system iteratively using the (Jacobi preconditioned)
+     * conjugate gradient method on a compressed sparse row copy of
+     * the matrix. This costs O(non-zero coefficients) per iteration,
+     * and converges in a few iterations when x already holds a close
+     * solution, such as the one of the previous step of a simulation.
+     *
+     * The system has to be symmetric, and positive or negative definite.
+     *
+     * @param x Initial guess, overwritten with the solution.
+     * @param tolerance Residual norm to reach, relative to the norm of
+     *                  the constant terms.
+     * @param max_iters Maximum number of iterations.
+     * @return true if the solution converged, otherwise x is undefined.
+     */
+    bool solveIterative(std::vector <double> &x, double tolerance,
+                        unsigned max_iters) const;
+
   private:
     std::vector < LinearEquation > matrix;
 };
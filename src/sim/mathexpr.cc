@@ -40,6 +40,7 @@
 #include "sim/mathexpr.hh"
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <regex>
 #include <string>
@@ -64,6 +65,8 @@ MathExpr::MathExpr(std::string expr)
 
     root = MathExpr::parse(expr);
     panic_if(!root, "Invalid expression\n");
+
+    stack.resize(compile(root));
 }
 
 /**
@@ -148,21 +151,91 @@ MathExpr::parse(std::string expr) {
     return NULL;
 }
 
+unsigned
+MathExpr::compile(const Node *n)
+{
+    switch (n->op) {
+      case sValue:
+        program.push_back(Instr {sValue, n->value, 0});
+        return 1;
+      case sVariable: {
+        auto it = std::find(variables.begin(), variables.end(), n->variable);
+        unsigned var = it - variables.begin();
+        if (it == variables.end())
+            variables.push_back(n->variable);
+        program.push_back(Instr {sVariable, 0, var});
+        return 1;
+      }
+      case uNeg: {
+        unsigned depth = compile(n->r);
+        program.push_back(Instr {uNeg, 0, 0});
+        return depth;
+      }
+      case nInvalid:
+        panic("Invalid node!\n");
+      default: {
+        unsigned l_depth = compile(n->l);
+        unsigned r_depth = compile(n->r);
+        program.push_back(Instr {n->op, 0, 0});
+        return std::max(l_depth, r_depth + 1);
+      }
+    }
+}
+
 double
-MathExpr::eval(const Node *n, EvalCallback fn) const {
-    if (!n)
-        return 0;
-    else if (n->op == sValue)
-        return n->value;
-    else if (n->op == sVariable)
-        return fn(n->variable);
-
-    for (auto & opt : ops)
-        if (opt.op == n->op)
-            return opt.fn( eval(n->l, fn), eval(n->r, fn) );
-
-    panic("Invalid node!\n");
-    return 0;
+MathExpr::eval(EvalCallback fn) const
+{
+    std::vector<double> values;
+    for (auto & v : variables)
+        values.push_back(fn(v));
+    return evalCompiled(values);
+}
+
+double
+MathExpr::evalCompiled(const std::vector<double> &values) const
+{
+    assert(values.size() == variables.size());
+
+    // sp points to the next free slot
+    double *sp = stack.data();
+    for (auto & i : program) {
+        switch (i.op) {
+          case sValue:
+            *sp++ = i.value;
+            break;
+          case sVariable:
+            *sp++ = values[i.var];
+            break;
+          case uNeg:
+            sp[-1] = -sp[-1];
+            break;
+          case bAdd:
+            --sp;
+            sp[-1] = sp[-1] + sp[0];
+            break;
+          case bSub:
+            --sp;
+            sp[-1] = sp[-1] - sp[0];
+            break;
+          case bMul:
+            --sp;
+            sp[-1] = sp[-1] * sp[0];
+            break;
+          case bDiv:
+            --sp;
+            sp[-1] = sp[-1] / sp[0];
+            break;
+          case bPow:
+            --sp;
+            sp[-1] = std::pow(sp[-1], sp[0]);
+            break;
+          default:
+            panic("Invalid node!\n");
+        }
+    }
+
+    assert(sp == stack.data() + 1);
+    return stack[0];
 }
 
 std::string
@@ -44,6 +44,7 @@
 #include <array>
 #include <functional>
 #include <string>
+#include <vector>
 
 class MathExpr {
   public:
@@ -66,7 +67,27 @@ class MathExpr {
      *
      * @return The value for this expression
      */
-    double eval(EvalCallback fn) const { return eval(root, fn); }
+    double eval(EvalCallback fn) const;
+
+    /**
+     * Get the variables in the expression, in order of first use. A
+     * variable's position in this list is its index in the values
+     * passed to evalCompiled().
+     *
+     * @return The names of the variables
+     */
+    const std::vector<std::string> &getVariables() const { return variables; }
+
+    /**
+     * Evaluates the expression using the values of its variables,
+     * which lets the caller resolve the variables once instead of
+     * looking them up by name on every evaluation.
+     *
+     * @param values Values of the variables, indexed as getVariables()
+     *
+     * @return The value for this expression
+     */
+    double evalCompiled(const std::vector<double> &values) const;
 
   private:
     enum Operator {
@@ -113,14 +134,35 @@ class MathExpr {
     /** Root node */
     Node * root;
 
+    /**
+     * Step of the compiled expression, which is a post-order (reverse
+     * polish) walk of the tree evaluated using a stack.
+     */
+    struct Instr {
+        Operator op;
+        /** Constant for sValue, variable index for sVariable */
+        double value;
+        unsigned var;
+    };
+
+    /** Compiled expression */
+    std::vector<Instr> program;
+
+    /** Variable names, indexed as in the program */
+    std::vector<std::string> variables;
+
+    /** Evaluation stack, sized for the program */
+    mutable std::vector<double> stack;
+
     /** Parse and create nodes from string */
     Node *parse(std::string expr);
 
+    /** Append the program for a node, returning its stack depth */
+    unsigned compile(const Node *n);
+
     /** Print tree as string */
     std::string toStr(Node *n, std::string prefix) const;
 
-    /** Eval a node */
-    double eval(const Node *n, EvalCallback fn) const;
 };
 
 #endif
@@ -31,8 +31,47 @@
 #ifndef SRC_SIM_MEM_STATE_HH
 #define SRC_SIM_MEM_STATE_HH
 
+#include <unistd.h>
+
+#include <map>
+#include <memory>
+
+#include "base/types.hh"
 #include "sim/serialize.hh"
 
+/**
+ * A host file that backs file mappings of the simulated process. The
+ * descriptor is private to the simulator, so that the mappings survive
+ * the target closing its own, and is closed with the last mapping.
+ */
+class MappedFile
+{
+  public:
+    MappedFile(int fd, uint64_t size) : fd(fd), size(size) { }
+    ~MappedFile() { close(fd); }
+
+    const int fd;
+
+    /** Size of the file when it was mapped */
+    const uint64_t size;
+};
+
+/**
+ * A file-backed mmap region whose pages are only populated when they are
+ * first touched.
+ */
+struct FileMapping
+{
+    /** One past the last virtual address of the region */
+    Addr end;
+    std::shared_ptr<MappedFile> file;
+    /** Offset in the file of the start of the region */
+    uint64_t offset;
+    /** Whether pages can alias the host's page cache copy of the file
+     *  rather than being copied */
+    bool alias;
+};
+
 /**
  * This class holds the memory state for the Process class and all of its
  * derived, architecture-specific children.
@@ -70,6 +109,7 @@ class MemState : public Serializable
         _stackMin = in._stackMin;
         _nextThreadStackBase = in._nextThreadStackBase;
         _mmapEnd = in._mmapEnd;
+        _fileMappings = in._fileMappings;
         return *this;
     }
 
@@ -89,6 +129,65 @@ class MemState : public Serializable
     void setNextThreadStackBase(Addr ntsb) { _nextThreadStackBase = ntsb; }
     void setMmapEnd(Addr mmap_end) { _mmapEnd = mmap_end; }
 
+    /**
+     * Add a file mapping that is populated on demand, replacing any
+     * part of other file mappings that it overlaps.
+     */
+    void
+    addFileMapping(Addr start, const FileMapping &mapping)
+    {
+        removeFileMappings(start, mapping.end - start);
+        _fileMappings[start] = mapping;
+    }
+
+    /** Remove the parts of any file mappings in a range */
+    void
+    removeFileMappings(Addr start, Addr length)
+    {
+        const Addr end = start + length;
+        auto it = _fileMappings.upper_bound(start);
+        if (it != _fileMappings.begin())
+            --it;
+        while (it != _fileMappings.end() && it->first < end) {
+            const Addr m_start = it->first;
+            const FileMapping m = it->second;
+            if (m.end <= start) {
+                ++it;
+                continue;
+            }
+            it = _fileMappings.erase(it);
+            if (m_start < start) {
+                FileMapping head = m;
+                head.end = start;
+                _fileMappings[m_start] = head;
+            }
+            if (m.end > end) {
+                FileMapping tail = m;
+                tail.offset += end - m_start;
+                it = _fileMappings.emplace(end, tail).first;
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * Find the file mapping that holds an address.
+     * @param start Set to the start of the mapping
+     * @return The mapping or nullptr if there is none
+     */
+    const FileMapping *
+    findFileMapping(Addr vaddr, Addr &start) const
+    {
+        auto it = _fileMappings.upper_bound(vaddr);
+        if (it == _fileMappings.begin())
+            return nullptr;
+        --it;
+        if (vaddr >= it->second.end)
+            return nullptr;
+        start = it->first;
+        return &it->second;
+    }
+
     void
     serialize(CheckpointOut &cp) const override
     {
@@ -120,6 +219,9 @@ class MemState : public Serializable
     Addr _stackMin;
     Addr _nextThreadStackBase;
     Addr _mmapEnd;
+
+    /** File mappings that are populated on demand, by start address */
+    std::map<Addr, FileMapping> _fileMappings;
 };
 
 #endif
@@ -39,6 +39,7 @@
 
 #include "sim/power/mathexpr_powermodel.hh"
 
+#include <algorithm>
 #include <string>
 
 #include "base/statistics.hh"
@@ -48,7 +49,7 @@
 #include "sim/sim_object.hh"
 
 MathExprPowerModel::MathExprPowerModel(const Params *p)
-    : PowerModelState(p), dyn_expr(p->dyn), st_expr(p->st), failed(false)
+    : PowerModelState(p), dyn_expr(p->dyn), st_expr(p->st)
 {
     // Calculate the name of the object we belong to
     std::vector<std::string> path;
@@ -74,11 +75,8 @@ MathExprPowerModel::startup()
         }
     }
 
-    tryEval(st_expr);
-    const bool st_failed = failed;
-
-    tryEval(dyn_expr);
-    const bool dyn_failed = failed;
+    const bool st_failed = !resolve(st_expr, st_vars);
+    const bool dyn_failed = !resolve(dyn_expr, dyn_vars);
 
     if (st_failed || dyn_failed) {
         const auto *p = dynamic_cast<const Params *>(params());
@@ -89,34 +87,79 @@ MathExprPowerModel::startup()
               st_failed && dyn_failed ? "\n" : "",
               dyn_failed ? p->dyn : "");
     }
+
+    values.resize(std::max(st_vars.size(), dyn_vars.size()));
 }
 
-double
-MathExprPowerModel::eval(const MathExpr &expr) const
+bool
+MathExprPowerModel::resolve(const MathExpr &expr,
+                            std::vector<Variable> &vars) const
 {
-    const double value = tryEval(expr);
+    using namespace Stats;
 
-    // This shouldn't happen unless something went wrong the equations
-    // were verified in startup().
-    panic_if(failed, "Failed to evaluate power expression '%s'\n",
-             expr.toStr());
+    bool ok = true;
+    vars.clear();
+    for (auto & name : expr.getVariables()) {
+        Variable var {Variable::Temp, nullptr, nullptr};
+
+        // Automatic variables:
+        if (name == "temp") {
+            var.kind = Variable::Temp;
+        } else if (name == "voltage") {
+            var.kind = Variable::Voltage;
+        } else {
+            // Try to cast the stat, only these are supported right now
+            const auto it = stats_map.find(name);
+            if (it == stats_map.cend()) {
+                warn("Failed to find stat '%s'\n", name);
+                ok = false;
+            } else if ((var.scalar =
+                        dynamic_cast<const ScalarInfo *>(it->second))) {
+                var.kind = Variable::Scalar;
+            } else if ((var.formula =
+                        dynamic_cast<const FormulaInfo *>(it->second))) {
+                var.kind = Variable::Formula;
+            } else {
+                panic("Unknown stat type!\n");
+            }
+        }
 
-    return value;
+        vars.push_back(var);
+    }
+
+    return ok;
 }
 
 double
-MathExprPowerModel::tryEval(const MathExpr &expr) const
+MathExprPowerModel::eval(const MathExpr &expr,
+                         const std::vector<Variable> &vars) const
 {
-    failed = false;
-    const double value = expr.eval(
-        std::bind(&MathExprPowerModel::getStatValue,
-                  this, std::placeholders::_1)
-        );
+    // Make sure counts kept outside of the stats are included
+    Stats::processSampleQueue();
+
+    // The values vector may be larger than needed by this expression
+    values.resize(vars.size());
+    for (unsigned i = 0; i < vars.size(); i++) {
+        const Variable &var = vars[i];
+        switch (var.kind) {
+          case Variable::Temp:
+            values[i] = _temp;
+            break;
+          case Variable::Voltage:
+            values[i] = clocked_object->voltage();
+            break;
+          case Variable::Scalar:
+            values[i] = var.scalar->value();
+            break;
+          case Variable::Formula:
+            values[i] = var.formula->total();
+            break;
+        }
+    }
 
-    return value;
+    return expr.evalCompiled(values);
 }
 
-
 double
 MathExprPowerModel::getStatValue(const std::string &name) const
 {
@@ -133,12 +176,13 @@ MathExprPowerModel::getStatValue(const std::string &name) const
     const auto it = stats_map.find(name);
     if (it == stats_map.cend()) {
         warn("Failed to find stat '%s'\n", name);
-        failed = true;
         return 0;
     }
 
     const Info *info = it->second;
 
+    processSampleQueue();
+
     auto si = dynamic_cast<const ScalarInfo *>(info);
     if (si)
         return si->value();
@@ -41,6 +41,7 @@
 #define __SIM_MATHEXPR_POWERMODEL_PM_HH__
 
 #include <unordered_map>
+#include <vector>
 
 #include "params/MathExprPowerModel.hh"
 #include "sim/mathexpr.hh"
@@ -48,6 +49,8 @@
 
 namespace Stats {
     class Info;
+    class ScalarInfo;
+    class FormulaInfo;
 }
 
 /**
@@ -66,14 +69,14 @@ class MathExprPowerModel : public PowerModelState
      *
      * @return Power (Watts) consumed by this object (dynamic component)
      */
-    double getDynamicPower() const { return eval(dyn_expr); }
+    double getDynamicPower() const { return eval(dyn_expr, dyn_vars); }
 
     /**
      * Get the static power consumption.
      *
      * @return Power (Watts) consumed by this object (static component)
      */
-    double getStaticPower() const { return eval(st_expr); }
+    double getStaticPower() const { return eval(st_expr, st_vars); }
 
     /**
      * Get the value for a variable (maps to a stat)
@@ -90,22 +93,34 @@ class MathExprPowerModel : public PowerModelState
 
   private:
     /**
-     * Evaluate an expression in the context of this object, fatal if
-     * evaluation fails.
+     * Source of the value of an expression variable, resolved once in
+     * startup() so evaluating an expression doesn't look up any names.
+     */
+    struct Variable {
+        enum Kind { Temp, Voltage, Scalar, Formula };
+        Kind kind;
+        const Stats::ScalarInfo *scalar;
+        const Stats::FormulaInfo *formula;
+    };
+
+    /**
+     * Resolve the variables of an expression.
      *
-     * @param expr Expression to evaluate
-     * @return Value of expression.
+     * @param expr Expression to resolve the variables of
+     * @param vars Filled with the sources of the variables
+     * @return false if a variable can't be resolved
      */
-    double eval(const MathExpr &expr) const;
+    bool resolve(const MathExpr &expr, std::vector<Variable> &vars) const;
 
     /**
-     * Evaluate an expression in the context of this object, set
-     * failed if evaluation failed.
+     * Evaluate an expression in the context of this object.
      *
      * @param expr Expression to evaluate
+     * @param vars Sources of the variables of the expression
      * @return Value of expression.
      */
-    double tryEval(const MathExpr &expr) const;
+    double eval(const MathExpr &expr,
+                const std::vector<Variable> &vars) const;
 
     // Math expressions for dynamic and static power
     MathExpr dyn_expr, st_expr;
@@ -116,9 +131,11 @@ class MathExprPowerModel : public PowerModelState
     // Map that contains relevant stats for this power model
     std::unordered_map<std::string, Stats::Info*> stats_map;
 
-    // Did the expression fail to evaluate (e.g., because a stat value
-    // can't be resolved)
-    mutable bool failed;
+    // Resolved variables of the dynamic and static power expressions
+    std::vector<Variable> dyn_vars, st_vars;
+
+    // Scratch space for the values of the variables
+    mutable std::vector<double> values;
 };
 
 #endif
@@ -84,6 +84,7 @@ class ThermalDomain : public SimObject, public ThermalEntity
     /** Get nodal equation imposed by this node */
     LinearEquation getEquation(ThermalNode * tn, unsigned n,
                                double step) const override;
+    std::vector<ThermalNode *> getNodes() const override { return {node}; }
 
     /**
       *  Emit a temperature update through probe points interface
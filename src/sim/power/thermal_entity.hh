@@ -40,6 +40,8 @@
 #ifndef __SIM_THERMAL_ENTITY_HH__
 #define __SIM_THERMAL_ENTITY_HH__
 
+#include <vector>
+
 #include "sim/sim_object.hh"
 
 class LinearEquation;
@@ -56,6 +58,10 @@ class ThermalEntity
     // Get the equation given a node and a step in seconds (assuming N nodes)
     virtual LinearEquation getEquation(ThermalNode *tn, unsigned n,
                                        double step) const = 0;
+
+    // Get the nodes this entity is connected to, which are the only
+    // ones it can impose a non-empty equation on
+    virtual std::vector<ThermalNode *> getNodes() const = 0;
 };
 
 
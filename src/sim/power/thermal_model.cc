@@ -39,6 +39,9 @@
 
 #include "sim/power/thermal_model.hh"
 
+#include <algorithm>
+
+#include "base/logging.hh"
 #include "base/statistics.hh"
 #include "params/ThermalCapacitor.hh"
 #include "params/ThermalReference.hh"
@@ -221,19 +224,30 @@ ThermalModel::doStep()
 {
     // Calculate new temperatures!
     // For each node in the system, create the kirchhoff nodal equation
+    // Only the entities connected to a node contribute to its equation,
+    // which keeps the system sparse.
     LinearSystem ls(eq_nodes.size());
     for (unsigned i = 0; i < eq_nodes.size(); i++) {
         auto n = eq_nodes[i];
         LinearEquation node_equation (eq_nodes.size());
-        for (auto e : entities) {
+        for (auto e : eq_node_entities[i]) {
             LinearEquation eq = e->getEquation(n, eq_nodes.size(), _step);
             node_equation = node_equation + eq;
         }
         ls[i] = node_equation;
     }
 
-    // Get temperatures for this iteration
-    std::vector <double> temps = ls.solve();
+    // Get temperatures for this iteration, starting from the ones of
+    // the previous iteration. Fall back to the direct solver for
+    // networks the iterative one can't handle.
+    std::vector <double> temps(eq_nodes.size());
+    for (unsigned i = 0; i < eq_nodes.size(); i++)
+        temps[i] = eq_nodes[i]->temp;
+    if (!ls.solveIterative(temps, 1e-9, 2 * eq_nodes.size() + 10)) {
+        warn_once("Thermal model %s did not converge iteratively, "
+                  "using gaussian elimination.\n", name());
+        temps = ls.solve();
+    }
     for (unsigned i = 0; i < eq_nodes.size(); i++)
         eq_nodes[i]->temp = temps[i];
 
@@ -274,6 +288,19 @@ ThermalModel::startup()
     for (unsigned i = 0; i < eq_nodes.size(); i++)
         eq_nodes[i]->id = i;
 
+    // Find the entities connected to each node
+    eq_node_entities.resize(eq_nodes.size());
+    for (auto e : entities) {
+        for (auto n : e->getNodes()) {
+            if (!n || n->isref || n->id < 0)
+                continue;
+            auto & node_entities = eq_node_entities[n->id];
+            if (std::find(node_entities.begin(), node_entities.end(), e) ==
+                node_entities.end())
+                node_entities.push_back(e);
+        }
+    }
+
     // Schedule first thermal update
     schedule(stepEvent, curTick() + SimClock::Int::s * _step);
 }
@@ -74,6 +74,9 @@ class ThermalResistor : public SimObject, public ThermalEntity
 
     LinearEquation getEquation(ThermalNode * tn, unsigned n,
                                double step) const override;
+    std::vector<ThermalNode *> getNodes() const override {
+        return {node1, node2};
+    }
 
   private:
     /* Resistance value in K/W */
@@ -98,6 +101,9 @@ class ThermalCapacitor : public SimObject, public ThermalEntity
 
     LinearEquation getEquation(ThermalNode * tn, unsigned n,
                                double step) const override;
+    std::vector<ThermalNode *> getNodes() const override {
+        return {node1, node2};
+    }
 
     void setNodes(ThermalNode * n1, ThermalNode * n2) {
         node1 = n1;
@@ -127,6 +133,7 @@ class ThermalReference : public SimObject, public ThermalEntity
 
     LinearEquation getEquation(ThermalNode * tn, unsigned n,
                                double step) const override;
+    std::vector<ThermalNode *> getNodes() const override { return {node}; }
 
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
@@ -177,6 +184,8 @@ class ThermalModel : public ClockedObject
     /* Keep a list of the instantiated nodes */
     std::vector <ThermalNode*> nodes;
     std::vector <ThermalNode*> eq_nodes;
+    /* Entities connected to each node in eq_nodes */
+    std::vector <std::vector <ThermalEntity *>> eq_node_entities;
 
     /** Stepping event to update the model values */
     EventFunctionWrapper stepEvent;
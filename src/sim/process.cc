@@ -47,11 +47,14 @@
 #include "sim/process.hh"
 
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
 #include <csignal>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -65,6 +68,7 @@
 #include "mem/se_translating_port_proxy.hh"
 #include "params/Process.hh"
 #include "sim/emul_driver.hh"
+#include "sim/eventq.hh"
 #include "sim/fd_array.hh"
 #include "sim/fd_entry.hh"
 #include "sim/syscall_desc.hh"
@@ -101,11 +105,45 @@
 using namespace std;
 using namespace TheISA;
 
+namespace
+{
+
+/**
+ * Processes share state such as page tables, file descriptors and the
+ * futex map with their threads and with the system, and the CPUs of
+ * those threads may run on different event queues (and host
+ * threads). System calls and stack fault fixups are therefore
+ * emulated one at a time. A thread waiting for another one releases
+ * its event queue, as the other thread may have to migrate to that
+ * queue to wake up a thread context.
+ */
+std::recursive_mutex emulationMutex;
+
+class EmulationLock
+{
+  public:
+    EmulationLock()
+        : lock(emulationMutex, std::defer_lock)
+    {
+        if (!inParallelMode || lock.try_lock())
+            return;
+
+        EventQueue::ScopedRelease release(curEventQueue());
+        lock.lock();
+    }
+
+  private:
+    std::unique_lock<std::recursive_mutex> lock;
+};
+
+} // anonymous namespace
+
 Process::Process(ProcessParams *params, EmulationPageTable *pTable,
                  ObjectFile *obj_file)
     : SimObject(params), system(params->system),
       useArchPT(params->useArchPT),
       kvmInSE(params->kvmInSE),
+      readAheadSize(params->read_ahead),
       pTable(pTable),
       initVirtMem(system->getSystemPort(), this,
                   SETranslatingPortProxy::Always),
@@ -334,8 +372,61 @@ Process::replicatePage(Addr vaddr, Addr new_paddr, ThreadContext *old_tc,
 }
 
 bool
-Process::fixupStackFault(Addr vaddr)
+Process::populateFilePage(Addr vaddr)
 {
+    Addr start;
+    const FileMapping *mapping = memState->findFileMapping(vaddr, start);
+    if (!mapping)
+        return false;
+
+    Addr page = roundDown(vaddr, PageBytes);
+    allocateMem(page, PageBytes);
+
+    // Pages past the end of the file read as zero, and so does the
+    // memory we just allocated.
+    const uint64_t offset = mapping->offset + (page - start);
+    const MappedFile &file = *mapping->file;
+    if (offset >= file.size)
+        return true;
+
+    Addr paddr;
+    pTable->translate(page, paddr);
+    uint8_t *host = system->directMemoryAccess() ?
+        system->getPhysMem().hostAddr(paddr, PageBytes) : nullptr;
+
+    // Map the file over the backing store of the page, so that it
+    // shares the host's page cache until the target writes to it.
+    static const long host_page_bytes = sysconf(_SC_PAGESIZE);
+    if (mapping->alias && host && PageBytes % host_page_bytes == 0 &&
+        (uintptr_t)host % host_page_bytes == 0) {
+        void *p = mmap(host, PageBytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_FIXED, file.fd, offset);
+        if (p != MAP_FAILED)
+            return true;
+    }
+
+    const uint64_t size = std::min<uint64_t>(file.size - offset, PageBytes);
+    std::vector<uint8_t> buf;
+    uint8_t *dst = host;
+    if (!dst) {
+        buf.resize(size);
+        dst = buf.data();
+    }
+    if (pread(file.fd, dst, size, offset) < 0)
+        fatal("mmap: cannot read file page at offset %#x", offset);
+    if (!host)
+        system->physProxy.writeBlob(paddr, dst, size);
+    return true;
+}
+
+bool
+Process::fixupFault(Addr vaddr)
+{
+    EmulationLock lock;
+
+    if (populateFilePage(vaddr))
+        return true;
+
     Addr stack_min = memState->getStackMin();
     Addr stack_base = memState->getStackBase();
     Addr max_stack_size = memState->getMaxStackSize();
@@ -414,6 +505,8 @@ Process::map(Addr vaddr, Addr paddr, int size, bool cacheable)
 void
 Process::syscall(int64_t callnum, ThreadContext *tc, Fault *fault)
 {
+    EmulationLock lock;
+
     numSyscalls++;
 
     SyscallDesc *desc = getDesc(callnum);
@@ -116,9 +116,18 @@ class Process : public SimObject
 
     void allocateMem(Addr vaddr, int64_t size, bool clobber = false);
 
-    /// Attempt to fix up a fault at vaddr by allocating a page on the stack.
+    /// Attempt to fix up a fault at vaddr by allocating a page on the stack
+    /// or populating a page of a file mapping.
     /// @return Whether the fault has been fixed.
-    bool fixupStackFault(Addr vaddr);
+    bool fixupFault(Addr vaddr);
+
+  private:
+    /// Populate the page of a file mapping that holds vaddr, aliasing the
+    /// host's copy of the file if the mapping allows it.
+    /// @return Whether vaddr is in a file mapping.
+    bool populateFilePage(Addr vaddr);
+
+  public:
 
     // After getting registered with system object, tell process which
     // system-wide context id it is assigned.
@@ -176,6 +185,9 @@ class Process : public SimObject
     bool useArchPT; // flag for using architecture specific page table
     bool kvmInSE;   // running KVM requires special initialization
 
+    // bytes to read ahead of sequential file reads, or 0
+    uint64_t readAheadSize;
+
     EmulationPageTable *pTable;
 
     SETranslatingPortProxy initVirtMem; // memory proxy for initial image load
@@ -197,6 +197,14 @@ pseudoInst(ThreadContext *tc, uint8_t func, uint8_t subfunc)
         workend(tc, args[0], args[1]);
         break;
 
+      case M5OP_REGION_BEGIN:
+        regionbegin(tc, args[0]);
+        break;
+
+      case M5OP_REGION_END:
+        regionend(tc, args[0]);
+        break;
+
       case M5OP_ANNOTATE:
       case M5OP_RESERVED2:
       case M5OP_RESERVED3:
@@ -716,4 +724,22 @@ workend(ThreadContext *tc, uint64_t workid, uint64_t threadid)
     }
 }
 
+//
+// Region markers only sample a few counters; the per-region deltas are
+// accumulated by the system and written out at exit.
+//
+void
+regionbegin(ThreadContext *tc, uint64_t regionid)
+{
+    DPRINTF(PseudoInst, "PseudoInst::regionbegin(%i)\n", regionid);
+    tc->getSystemPtr()->regionMarkers.begin(tc, regionid);
+}
+
+void
+regionend(ThreadContext *tc, uint64_t regionid)
+{
+    DPRINTF(PseudoInst, "PseudoInst::regionend(%i)\n", regionid);
+    tc->getSystemPtr()->regionMarkers.end(tc, regionid);
+}
+
 } // namespace PseudoInst
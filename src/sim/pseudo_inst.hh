@@ -88,6 +88,8 @@ void debugbreak(ThreadContext *tc);
 void switchcpu(ThreadContext *tc);
 void workbegin(ThreadContext *tc, uint64_t workid, uint64_t threadid);
 void workend(ThreadContext *tc, uint64_t workid, uint64_t threadid);
+void regionbegin(ThreadContext *tc, uint64_t regionid);
+void regionend(ThreadContext *tc, uint64_t regionid);
 void togglesync(ThreadContext *tc);
 
 } // namespace PseudoInst
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/read_ahead.hh"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+ReadAhead::ReadAhead(int sim_fd, size_t block_size)
+    : simFD(sim_fd), blockSize(block_size), lastEnd(0)
+{
+    assert(blockSize > 0);
+}
+
+ReadAhead::~ReadAhead()
+{
+    cancel();
+}
+
+void
+ReadAhead::prefetch(off_t offset)
+{
+    assert(!pending.valid());
+    next.offset = offset;
+    pending = std::async(std::launch::async, [this]() {
+        next.data.resize(blockSize);
+        next.size = pread(simFD, next.data.data(), blockSize, next.offset);
+    });
+}
+
+void
+ReadAhead::wait()
+{
+    pending.get();
+    std::swap(ready, next);
+}
+
+void
+ReadAhead::cancel()
+{
+    if (pending.valid())
+        pending.get();
+    ready = Block();
+    next = Block();
+    lastEnd = 0;
+}
+
+ssize_t
+ReadAhead::read(uint8_t *buf, size_t size, off_t offset)
+{
+    size_t done = 0;
+    while (done < size) {
+        off_t pos = offset + done;
+        if (!ready.contains(pos) && pending.valid() &&
+            pos >= next.offset && pos < next.offset + (off_t)blockSize) {
+            wait();
+        }
+        if (!ready.contains(pos))
+            break;
+
+        size_t n = std::min<size_t>(ready.offset + ready.size - pos,
+                                    size - done);
+        std::memcpy(buf + done, ready.data.data() + (pos - ready.offset), n);
+        done += n;
+    }
+
+    // Whatever has not been read ahead is read directly. This also
+    // finds the end of the file, or an error.
+    if (done < size) {
+        ssize_t got = pread(simFD, buf + done, size - done, offset + done);
+        if (got < 0) {
+            if (done == 0)
+                return -1;
+        } else {
+            done += got;
+        }
+    }
+
+    const off_t end = offset + done;
+    const bool sequential = offset == lastEnd;
+    lastEnd = end;
+    if (!sequential || done == 0)
+        return done;
+
+    // Read the block after the data the guest is about to read, unless
+    // the end of the file has already been found.
+    off_t from = end;
+    if (ready.contains(end)) {
+        if (ready.size < (ssize_t)blockSize)
+            return done;
+        from = ready.offset + ready.size;
+    }
+
+    if (pending.valid()) {
+        if (next.offset == from)
+            return done;
+        // the guest moved elsewhere, the block is of no use
+        pending.get();
+    }
+    prefetch(from);
+
+    return done;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_READ_AHEAD_HH__
+#define __SIM_READ_AHEAD_HH__
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <future>
+#include <vector>
+
+/**
+ * Read-ahead for a host file read by an emulated process.
+ *
+ * While the guest consumes one block of a file that is read
+ * sequentially, the next block is read on a host thread, so that host
+ * I/O overlaps with simulation. The guest sees exactly the data and
+ * return values of the reads it asked for, so simulated timing is not
+ * affected. Blocks are only kept for files that are opened read-only;
+ * changes made to the file through other file descriptors while it is
+ * being read may not be seen.
+ */
+class ReadAhead
+{
+  public:
+    /**
+     * @param sim_fd Host file descriptor, which must stay open while
+     *               this object exists
+     * @param block_size Number of bytes to read ahead at a time
+     */
+    ReadAhead(int sim_fd, size_t block_size);
+    ~ReadAhead();
+
+    /**
+     * Read from the file like pread().
+     *
+     * @return The number of bytes read, or -1 with errno set
+     */
+    ssize_t read(uint8_t *buf, size_t size, off_t offset);
+
+    /** Wait for the block being read ahead, and drop all blocks. */
+    void cancel();
+
+  private:
+    struct Block
+    {
+        off_t offset;
+        ssize_t size;
+        std::vector<uint8_t> data;
+
+        Block() : offset(0), size(-1) {}
+
+        bool
+        contains(off_t pos) const
+        {
+            return size > 0 && pos >= offset && pos < offset + size;
+        }
+    };
+
+    /** Start reading the block at offset on a host thread. */
+    void prefetch(off_t offset);
+
+    /** Make the block being read ahead the ready one. */
+    void wait();
+
+    const int simFD;
+    const size_t blockSize;
+
+    /** The block the guest is reading from. */
+    Block ready;
+    /** The block being read ahead, if pending is valid. */
+    Block next;
+    std::future<void> pending;
+
+    /** Where the previous read ended, to detect sequential reads. */
+    off_t lastEnd;
+};
+
+#endif // __SIM_READ_AHEAD_HH__
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/region_markers.hh"
+
+#include "base/callback.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/statistics.hh"
+#include "cpu/base.hh"
+#include "cpu/thread_context.hh"
+#include "debug/PseudoInst.hh"
+#include "sim/core.hh"
+
+RegionMarkers::RegionMarkers(const std::vector<std::string> &stat_names,
+                             const std::string &file_name)
+    : statNames(stat_names), statsResolved(false), fileName(file_name)
+{
+    registerExitCallback(
+        new MakeCallback<RegionMarkers, &RegionMarkers::dump>(this));
+}
+
+void
+RegionMarkers::resolveStats()
+{
+    for (const auto &name : statNames) {
+        auto it = Stats::nameMap().find(name);
+        if (it == Stats::nameMap().end())
+            fatal("Unknown region stat '%s'\n", name);
+        Stats::Info *info = it->second;
+        if (!dynamic_cast<Stats::ScalarInfo *>(info) &&
+            !dynamic_cast<Stats::VectorInfo *>(info)) {
+            fatal("Region stat '%s' is not a scalar, vector or formula\n",
+                  name);
+        }
+        stats.push_back(info);
+    }
+    statsResolved = true;
+}
+
+void
+RegionMarkers::sample(ThreadContext *tc, Sample &s)
+{
+    if (!statsResolved)
+        resolveStats();
+
+    BaseCPU *cpu = tc->getCpuPtr();
+    s.tick = curTick();
+    s.cycles = cpu->curCycle();
+    s.insts = cpu->totalInsts();
+
+    s.stats.resize(stats.size());
+    for (int i = 0; i < stats.size(); ++i) {
+        auto scalar = dynamic_cast<Stats::ScalarInfo *>(stats[i]);
+        if (scalar)
+            s.stats[i] = scalar->result();
+        else
+            s.stats[i] = static_cast<Stats::VectorInfo *>(stats[i])->total();
+    }
+}
+
+void
+RegionMarkers::begin(ThreadContext *tc, uint64_t region)
+{
+    auto key = std::make_pair(tc->contextId(), region);
+    auto r = openRegions.insert(std::make_pair(key, Sample()));
+    if (!r.second) {
+        warn_once("Region %d begun again on context %d before it ended; "
+                  "restarting it\n", region, tc->contextId());
+    }
+    sample(tc, r.first->second);
+}
+
+void
+RegionMarkers::end(ThreadContext *tc, uint64_t region)
+{
+    auto it = openRegions.find(std::make_pair(tc->contextId(), region));
+    if (it == openRegions.end()) {
+        warn_once("Region %d ended on context %d without being begun\n",
+                  region, tc->contextId());
+        return;
+    }
+
+    Sample now;
+    sample(tc, now);
+    const Sample &start = it->second;
+
+    Region &totals = regions[region];
+    totals.count++;
+    totals.ticks += now.tick - start.tick;
+    totals.cycles += now.cycles - start.cycles;
+    totals.insts += now.insts - start.insts;
+    totals.stats.resize(stats.size(), 0.0);
+    for (int i = 0; i < stats.size(); ++i)
+        totals.stats[i] += now.stats[i] - start.stats[i];
+
+    openRegions.erase(it);
+}
+
+void
+RegionMarkers::dump()
+{
+    if (regions.empty())
+        return;
+
+    OutputStream *os = simout.create(fileName);
+    std::ostream &out = *os->stream();
+
+    out << "region count ticks cycles insts";
+    for (const auto &name : statNames)
+        out << " " << name;
+    out << "\n";
+
+    for (const auto &r : regions) {
+        const Region &totals = r.second;
+        out << r.first << " " << totals.count << " " << totals.ticks << " "
+            << totals.cycles << " " << totals.insts;
+        for (double v : totals.stats)
+            out << " " << v;
+        out << "\n";
+    }
+
+    simout.close(os);
+}
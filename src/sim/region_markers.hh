@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_REGION_MARKERS_HH__
+#define __SIM_REGION_MARKERS_HH__
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+
+class ThreadContext;
+
+namespace Stats {
+class Info;
+}
+
+/**
+ * Accumulates per-region statistics for the m5_region_begin and
+ * m5_region_end pseudo instructions.
+ *
+ * Unlike work items and stat dumps, a region marker never touches the
+ * statistics themselves: beginning a region samples a few counters of
+ * the executing CPU (ticks, cycles, committed instructions, plus any
+ * stats named in System.region_stats) and ending it adds the deltas to
+ * the region's totals. The totals are written to a single file when
+ * the simulator exits, so guests can mark thousands of regions at the
+ * cost of a few counter reads each.
+ *
+ * Regions are keyed by id and may be entered any number of times and
+ * from several contexts at once; each context tracks its own open
+ * regions. Instruction counts are those of the whole CPU, so regions
+ * on SMT CPUs also count instructions from sibling threads.
+ */
+class RegionMarkers
+{
+  public:
+    RegionMarkers(const std::vector<std::string> &stat_names,
+                  const std::string &file_name);
+
+    void begin(ThreadContext *tc, uint64_t region);
+    void end(ThreadContext *tc, uint64_t region);
+
+    /** Write the accumulated totals; called at exit */
+    void dump();
+
+  private:
+    /** Counter values at the start of an open region */
+    struct Sample
+    {
+        Tick tick;
+        Cycles cycles;
+        Counter insts;
+        std::vector<double> stats;
+    };
+
+    /** Accumulated totals of a region */
+    struct Region
+    {
+        Region() : count(0), ticks(0), cycles(0), insts(0) {}
+
+        uint64_t count;
+        Tick ticks;
+        uint64_t cycles;
+        Counter insts;
+        std::vector<double> stats;
+    };
+
+    void sample(ThreadContext *tc, Sample &s);
+    /** Look up the named stats; they only exist after regStats */
+    void resolveStats();
+
+    const std::vector<std::string> statNames;
+    std::vector<Stats::Info *> stats;
+    bool statsResolved;
+
+    const std::string fileName;
+
+    std::map<std::pair<ContextID, uint64_t>, Sample> openRegions;
+    std::map<uint64_t, Region> regions;
+};
+
+#endif // __SIM_REGION_MARKERS_HH__
@@ -35,6 +35,9 @@
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "debug/TimeSync.hh"
+#include "mem/packet_queue.hh"
+#include "sim/event_profile.hh"
+#include "sim/host_perf.hh"
 #include "sim/eventq_impl.hh"
 #include "sim/full_system.hh"
 #include "sim/root.hh"
@@ -116,6 +119,32 @@ Root::Root(RootParams *p)
     lastTime.setTimer();
 
     simQuantum = p->sim_quantum;
+    simQuantumLookahead = p->sim_quantum_mode == Enums::Lookahead;
+
+    switch (p->eventq_engine) {
+      case Enums::List:
+        setMainQueueEngine(EventQueue::Engine::List);
+        break;
+      case Enums::Calendar:
+        setMainQueueEngine(EventQueue::Engine::Calendar);
+        break;
+      default:
+        panic("Unknown event queue engine\n");
+    }
+
+    setEventProfiling(p->profile_events, p->event_profile_file);
+    setHostPerfCounters(p->host_perf_counters);
+
+    PacketQueue::sizeWarning = p->packet_queue_warn_size;
+}
+
+void
+Root::regStats()
+{
+    SimObject::regStats();
+
+    // All objects exist at this point
+    registerHostPerfStats();
 }
 
 void
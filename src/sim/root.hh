@@ -103,6 +103,8 @@ class Root : public SimObject
 
     Root(Params *p);
 
+    void regStats() override;
+
     /** Schedule the timesync event at startup().
      */
     void startup() override;
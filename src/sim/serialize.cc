@@ -51,10 +51,16 @@
 #include <sys/time.h>
 #include <sys/types.h>
 
+#include <cctype>
 #include <cerrno>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 #include <list>
+#include <sstream>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "arch/generic/vec_reg.hh"
@@ -62,6 +68,7 @@
 #include "base/inifile.hh"
 #include "base/logging.hh"
 #include "base/output.hh"
+#include "base/random.hh"
 #include "base/str.hh"
 #include "base/trace.hh"
 #include "debug/Checkpoint.hh"
@@ -165,15 +172,282 @@ parseParam(const string &s, string &value)
     return true;
 }
 
+//
+// Binary checkpoints are written through the same CheckpointOut
+// stream as INI checkpoints, tagged with binaryStreamIndex() so that
+// paramOut and friends know which format to produce. The file is a
+// magic string and a version, followed by records:
+//
+//   'S' <name>                  starts a section
+//   'E' <name> <type> <value>   entry in the current section
+//
+// where names and strings are a u32 length followed by the bytes.
+// Scalar values are stored as int64 ('i'), uint64 ('u'), double
+// ('d'), bool ('b', one byte) or string ('s'). Types without a
+// numeric representation are stored as the strings an INI
+// checkpoint would contain. Arrays use the upper case type followed
+// by a u32 element count.
+//
+
+static const char binaryCheckpointMagic[8] = {
+    'g', 'e', 'm', '5', 'c', 'p', 't', '\0' };
+static const uint32_t binaryCheckpointVersion = 1;
+
+static int
+binaryStreamIndex()
+{
+    static const int index = ios_base::xalloc();
+    return index;
+}
+
+static bool
+isBinary(CheckpointOut &os)
+{
+    return os.iword(binaryStreamIndex()) != 0;
+}
+
+template <class T>
+static void
+putRaw(CheckpointOut &os, const T &value)
+{
+    os.write((const char *)&value, sizeof(value));
+}
+
+static void
+putString(CheckpointOut &os, const string &s)
+{
+    putRaw<uint32_t>(os, s.size());
+    os.write(s.data(), s.size());
+}
+
+template <class T, class Enable = void>
+struct BinaryParam
+{
+    static const char type = 's';
+
+    static void
+    put(CheckpointOut &os, const T &value)
+    {
+        ostringstream text;
+        showParam(text, value);
+        putString(os, text.str());
+    }
+};
+
+template <class T>
+struct BinaryParam<T, typename enable_if<is_integral<T>::value &&
+                                         is_signed<T>::value>::type>
+{
+    static const char type = 'i';
+    static void put(CheckpointOut &os, T value) { putRaw<int64_t>(os, value); }
+};
+
+template <class T>
+struct BinaryParam<T, typename enable_if<is_integral<T>::value &&
+                                         is_unsigned<T>::value>::type>
+{
+    static const char type = 'u';
+    static void put(CheckpointOut &os, T value) { putRaw<uint64_t>(os, value); }
+};
+
+template <class T>
+struct BinaryParam<T, typename enable_if<is_floating_point<T>::value>::type>
+{
+    static const char type = 'd';
+    static void put(CheckpointOut &os, T value) { putRaw<double>(os, value); }
+};
+
+template <>
+struct BinaryParam<bool>
+{
+    static const char type = 'b';
+    static void put(CheckpointOut &os, bool value) { putRaw<uint8_t>(os, value); }
+};
+
+template <class T>
+static void
+binaryParamOut(CheckpointOut &os, const string &name, const T &param)
+{
+    os.put('E');
+    putString(os, name);
+    os.put(BinaryParam<T>::type);
+    BinaryParam<T>::put(os, param);
+}
+
+template <class Iter>
+static void
+binaryArrayParamOut(CheckpointOut &os, const string &name,
+                    Iter begin, Iter end, size_t size)
+{
+    typedef typename iterator_traits<Iter>::value_type T;
+    os.put('E');
+    putString(os, name);
+    os.put(toupper(BinaryParam<T>::type));
+    putRaw<uint32_t>(os, size);
+    for (; begin != end; ++begin)
+        BinaryParam<T>::put(os, *begin);
+}
+
+/** Where to find a value in a binary checkpoint */
+struct BinaryValue
+{
+    char type;
+    uint32_t count;
+    const char *data;
+};
+
+/**
+ * A binary checkpoint, read into memory in one go. Loading only
+ * indexes the sections and entries by name, the values are decoded
+ * when they are unserialized.
+ */
+class BinaryCheckpoint
+{
+  protected:
+    vector<char> buf;
+    unordered_map<string, unordered_map<string, BinaryValue>> sections;
+
+  public:
+    /**
+     * Load a checkpoint file.
+     * @return false if the file isn't a binary checkpoint
+     */
+    bool load(const string &filename);
+
+    const BinaryValue *find(const string &section,
+                            const string &entry) const;
+
+    bool
+    sectionExists(const string &section) const
+    {
+        return sections.find(section) != sections.end();
+    }
+
+    /** Get a value as the text an INI checkpoint would contain */
+    static string text(const BinaryValue &value);
+};
+
+template <class T, class N>
+static typename enable_if<is_arithmetic<T>::value, bool>::type
+convertNumber(N number, T &value)
+{
+    value = static_cast<T>(number);
+    return true;
+}
+
+template <class T, class N>
+static typename enable_if<!is_arithmetic<T>::value, bool>::type
+convertNumber(N number, T &value)
+{
+    ostringstream text;
+    text << number;
+    return parseParam(text.str(), value);
+}
+
+/** Decode the element at p and advance p past it */
+template <class T>
+static bool
+decodeElement(const char *&p, char type, T &value)
+{
+    switch (type) {
+      case 'i': {
+          int64_t v;
+          memcpy(&v, p, sizeof(v));
+          p += sizeof(v);
+          return convertNumber(v, value);
+      }
+      case 'u': {
+          uint64_t v;
+          memcpy(&v, p, sizeof(v));
+          p += sizeof(v);
+          return convertNumber(v, value);
+      }
+      case 'd': {
+          double v;
+          memcpy(&v, p, sizeof(v));
+          p += sizeof(v);
+          return convertNumber(v, value);
+      }
+      case 'b': {
+          bool v = *p++;
+          return is_arithmetic<T>::value ? convertNumber(v, value) :
+              parseParam(v ? "true" : "false", value);
+      }
+      case 's': {
+          uint32_t len;
+          memcpy(&len, p, sizeof(len));
+          p += sizeof(len);
+          string v(p, len);
+          p += len;
+          return parseParam(v, value);
+      }
+      default:
+        return false;
+    }
+}
+
+/** Decode the elements of an array, passing each one to func */
+template <class T, class Func>
+static void
+decodeArray(const BinaryValue &v, const string &section, const string &name,
+            Func func)
+{
+    const char *p = v.data;
+    const char type = tolower(v.type);
+    for (uint32_t i = 0; i < v.count; ++i) {
+        // need to decode into a local variable to handle vector<bool>
+        T value;
+        if (!decodeElement(p, type, value))
+            fatal("Can't unserialize '%s:%s'\n", section, name);
+        func(i, value);
+    }
+}
+
+/**
+ * Find an array in a binary checkpoint. Returns nullptr for INI
+ * checkpoints and entries that aren't arrays, which are parsed as
+ * text instead.
+ */
+static const BinaryValue *
+findBinaryArray(CheckpointIn &cp, const string &section, const string &name)
+{
+    if (!cp.binary())
+        return nullptr;
+    const BinaryValue *v = cp.binary()->find(section, name);
+    return v && isupper(v->type) ? v : nullptr;
+}
+
+/** Decode a scalar from a binary checkpoint, as for findBinaryArray */
+template <class T>
+static bool
+findBinaryScalar(CheckpointIn &cp, const string &section, const string &name,
+                 T &param, bool &ok)
+{
+    if (!cp.binary())
+        return false;
+    const BinaryValue *v = cp.binary()->find(section, name);
+    if (!v || isupper(v->type))
+        return false;
+    const char *p = v->data;
+    ok = decodeElement(p, v->type, param);
+    return true;
+}
+
 int Serializable::ckptMaxCount = 0;
 int Serializable::ckptCount = 0;
 int Serializable::ckptPrevCount = -1;
-std::stack<std::string> Serializable::path;
+bool Serializable::binaryFormat = false;
+thread_local std::stack<std::string> Serializable::path;
 
 template <class T>
 void
 paramOut(CheckpointOut &os, const string &name, const T &param)
 {
+    if (isBinary(os)) {
+        binaryParamOut(os, name, param);
+        return;
+    }
+
     os << name << "=";
     showParam(os, param);
     os << "\n";
@@ -183,6 +457,12 @@ template <class T>
 void
 arrayParamOut(CheckpointOut &os, const string &name, const vector<T> &param)
 {
+    if (isBinary(os)) {
+        binaryArrayParamOut(os, name, param.begin(), param.end(),
+                            param.size());
+        return;
+    }
+
     typename vector<T>::size_type size = param.size();
     os << name << "=";
     if (size > 0)
@@ -198,6 +478,12 @@ template <class T>
 void
 arrayParamOut(CheckpointOut &os, const string &name, const list<T> &param)
 {
+    if (isBinary(os)) {
+        binaryArrayParamOut(os, name, param.begin(), param.end(),
+                            param.size());
+        return;
+    }
+
     typename list<T>::const_iterator it = param.begin();
 
     os << name << "=";
@@ -216,6 +502,12 @@ template <class T>
 void
 arrayParamOut(CheckpointOut &os, const string &name, const set<T> &param)
 {
+    if (isBinary(os)) {
+        binaryArrayParamOut(os, name, param.begin(), param.end(),
+                            param.size());
+        return;
+    }
+
     typename set<T>::const_iterator it = param.begin();
 
     os << name << "=";
@@ -235,6 +527,13 @@ void
 paramIn(CheckpointIn &cp, const string &name, T &param)
 {
     const string &section(Serializable::currentSection());
+    bool ok;
+    if (findBinaryScalar(cp, section, name, param, ok)) {
+        if (!ok)
+            fatal("Can't unserialize '%s:%s'\n", section, name);
+        return;
+    }
+
     string str;
     if (!cp.find(section, name, str) || !parseParam(str, param)) {
         fatal("Can't unserialize '%s:%s'\n", section, name);
@@ -246,8 +545,10 @@ bool
 optParamIn(CheckpointIn &cp, const string &name, T &param, bool warn)
 {
     const string &section(Serializable::currentSection());
+    bool ok;
     string str;
-    if (!cp.find(section, name, str) || !parseParam(str, param)) {
+    if (findBinaryScalar(cp, section, name, param, ok) ? !ok :
+        !cp.find(section, name, str) || !parseParam(str, param)) {
         if (warn)
             warn("optional parameter %s:%s not present\n", section, name);
         return false;
@@ -261,6 +562,11 @@ void
 arrayParamOut(CheckpointOut &os, const string &name,
               const T *param, unsigned size)
 {
+    if (isBinary(os)) {
+        binaryArrayParamOut(os, name, param, param + size, size);
+        return;
+    }
+
     os << name << "=";
     if (size > 0)
         showParam(os, param[0]);
@@ -277,6 +583,16 @@ void
 arrayParamIn(CheckpointIn &cp, const string &name, T *param, unsigned size)
 {
     const string &section(Serializable::currentSection());
+    if (const BinaryValue *v = findBinaryArray(cp, section, name)) {
+        if (v->count != size)
+            fatal("Array size mismatch on %s:%s'\n", section, name);
+        decodeArray<T>(*v, section, name,
+                       [param](uint32_t i, const T &value) {
+                           param[i] = value;
+                       });
+        return;
+    }
+
     string str;
     if (!cp.find(section, name, str)) {
         fatal("Can't unserialize '%s:%s'\n", section, name);
@@ -321,6 +637,15 @@ void
 arrayParamIn(CheckpointIn &cp, const string &name, vector<T> &param)
 {
     const string &section(Serializable::currentSection());
+    if (const BinaryValue *v = findBinaryArray(cp, section, name)) {
+        param.resize(v->count);
+        decodeArray<T>(*v, section, name,
+                       [&param](uint32_t i, const T &value) {
+                           param[i] = value;
+                       });
+        return;
+    }
+
     string str;
     if (!cp.find(section, name, str)) {
         fatal("Can't unserialize '%s:%s'\n", section, name);
@@ -363,6 +688,15 @@ void
 arrayParamIn(CheckpointIn &cp, const string &name, list<T> &param)
 {
     const string &section(Serializable::currentSection());
+    if (const BinaryValue *v = findBinaryArray(cp, section, name)) {
+        param.clear();
+        decodeArray<T>(*v, section, name,
+                       [&param](uint32_t i, const T &value) {
+                           param.push_back(value);
+                       });
+        return;
+    }
+
     string str;
     if (!cp.find(section, name, str)) {
         fatal("Can't unserialize '%s:%s'\n", section, name);
@@ -393,6 +727,15 @@ void
 arrayParamIn(CheckpointIn &cp, const string &name, set<T> &param)
 {
     const string &section(Serializable::currentSection());
+    if (const BinaryValue *v = findBinaryArray(cp, section, name)) {
+        param.clear();
+        decodeArray<T>(*v, section, name,
+                       [&param](uint32_t i, const T &value) {
+                           param.insert(value);
+                       });
+        return;
+    }
+
     string str;
     if (!cp.find(section, name, str)) {
         fatal("Can't unserialize '%s:%s'\n", section, name);
@@ -592,28 +935,37 @@ Serializable::unserializeSection(CheckpointIn &cp, const char *name)
 }
 
 void
-Serializable::serializeAll(const string &cpt_dir)
+Serializable::serializeAll(const string &cpt_dir, unsigned threads)
 {
     string dir = CheckpointIn::setDir(cpt_dir);
     if (mkdir(dir.c_str(), 0775) == -1 && errno != EEXIST)
             fatal("couldn't mkdir %s\n", dir);
 
     string cpt_file = dir + CheckpointIn::baseFilename;
-    ofstream outstream(cpt_file.c_str());
+    ofstream outstream(cpt_file.c_str(),
+                       binaryFormat ? ios::out | ios::binary : ios::out);
     time_t t = time(NULL);
     if (!outstream.is_open())
         fatal("Unable to open file %s for writing\n", cpt_file.c_str());
-    outstream << "## checkpoint generated: " << ctime(&t);
+    if (binaryFormat) {
+        outstream.write(binaryCheckpointMagic, sizeof(binaryCheckpointMagic));
+        putRaw(outstream, binaryCheckpointVersion);
+        outstream.iword(binaryStreamIndex()) = 1;
+    } else {
+        outstream << "## checkpoint generated: " << ctime(&t);
+    }
 
     globals.serializeSection(outstream, "Globals");
+    RandomStream::serializeAll(outstream);
 
-    SimObject::serializeAll(outstream);
+    SimObject::serializeAll(outstream, threads);
 }
 
 void
 Serializable::unserializeGlobals(CheckpointIn &cp)
 {
     globals.unserializeSection(cp, "Globals");
+    RandomStream::unserializeAll(cp);
 
     for (uint32_t i = 0; i < numMainEventQueues; ++i)
         mainEventQueue[i]->setCurTick(globals.unserializedCurTick);
@@ -642,7 +994,12 @@ Serializable::ScopedCheckpointSection::nameOut(CheckpointOut &cp)
 {
     DPRINTF(Checkpoint, "ScopedCheckpointSection::nameOut: %s\n",
             Serializable::currentSection());
-    cp << "\n[" << Serializable::currentSection() << "]\n";
+    if (isBinary(cp)) {
+        cp.put('S');
+        putString(cp, Serializable::currentSection());
+    } else {
+        cp << "\n[" << Serializable::currentSection() << "]\n";
+    }
 }
 
 void
@@ -682,10 +1039,140 @@ CheckpointIn::dir()
 }
 
 
+bool
+BinaryCheckpoint::load(const string &filename)
+{
+    ifstream file(filename.c_str(), ios::in | ios::binary);
+    char magic[sizeof(binaryCheckpointMagic)];
+    if (!file.read(magic, sizeof(magic)) ||
+        memcmp(magic, binaryCheckpointMagic, sizeof(magic)) != 0)
+        return false;
+
+    uint32_t version;
+    if (!file.read((char *)&version, sizeof(version)) ||
+        version != binaryCheckpointVersion)
+        fatal("Unsupported binary checkpoint version in '%s'\n", filename);
+
+    buf.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+
+    const char *p = buf.data();
+    const char *end = p + buf.size();
+    auto need = [&](size_t len) {
+        if (end - p < (ptrdiff_t)len)
+            fatal("Binary checkpoint '%s' is truncated\n", filename);
+    };
+    auto get_string = [&]() {
+        uint32_t len;
+        need(sizeof(len));
+        memcpy(&len, p, sizeof(len));
+        p += sizeof(len);
+        need(len);
+        string s(p, len);
+        p += len;
+        return s;
+    };
+
+    unordered_map<string, BinaryValue> *section = nullptr;
+    while (p < end) {
+        const char kind = *p++;
+        if (kind == 'S') {
+            section = &sections[get_string()];
+        } else if (kind == 'E' && section) {
+            string name = get_string();
+            BinaryValue v;
+            need(1);
+            v.type = *p++;
+            v.count = 1;
+            if (isupper(v.type)) {
+                need(sizeof(v.count));
+                memcpy(&v.count, p, sizeof(v.count));
+                p += sizeof(v.count);
+            }
+            v.data = p;
+
+            // skip past the elements
+            switch (tolower(v.type)) {
+              case 'i': case 'u': case 'd':
+                need(8 * (size_t)v.count);
+                p += 8 * (size_t)v.count;
+                break;
+              case 'b':
+                need(v.count);
+                p += v.count;
+                break;
+              case 's':
+                for (uint32_t i = 0; i < v.count; ++i)
+                    get_string();
+                break;
+              default:
+                fatal("Unknown value type in binary checkpoint '%s'\n",
+                      filename);
+            }
+            (*section)[name] = v;
+        } else {
+            fatal("Binary checkpoint '%s' is corrupt\n", filename);
+        }
+    }
+
+    return true;
+}
+
+const BinaryValue *
+BinaryCheckpoint::find(const string &section, const string &entry) const
+{
+    auto s = sections.find(section);
+    if (s == sections.end())
+        return nullptr;
+    auto e = s->second.find(entry);
+    return e == s->second.end() ? nullptr : &e->second;
+}
+
+string
+BinaryCheckpoint::text(const BinaryValue &value)
+{
+    ostringstream text;
+    text.precision(17);
+    const char *p = value.data;
+    const char type = tolower(value.type);
+    for (uint32_t i = 0; i < value.count; ++i) {
+        if (i)
+            text << " ";
+        if (type == 'i' || type == 'u') {
+            uint64_t v;
+            memcpy(&v, p, sizeof(v));
+            p += sizeof(v);
+            if (type == 'i')
+                text << (int64_t)v;
+            else
+                text << v;
+        } else if (type == 'd') {
+            double v;
+            memcpy(&v, p, sizeof(v));
+            p += sizeof(v);
+            text << v;
+        } else if (type == 'b') {
+            text << (*p++ ? "true" : "false");
+        } else {
+            uint32_t len;
+            memcpy(&len, p, sizeof(len));
+            p += sizeof(len);
+            text.write(p, len);
+            p += len;
+        }
+    }
+    return text.str();
+}
+
 CheckpointIn::CheckpointIn(const string &cpt_dir, SimObjectResolver &resolver)
-    : db(new IniFile), objNameResolver(resolver), cptDir(setDir(cpt_dir))
+    : db(new IniFile), bin(new BinaryCheckpoint), objNameResolver(resolver),
+      cptDir(setDir(cpt_dir))
 {
     string filename = cptDir + "/" + CheckpointIn::baseFilename;
+    if (bin->load(filename))
+        return;
+
+    delete bin;
+    bin = nullptr;
     if (!db->load(filename)) {
         fatal("Can't load checkpoint file '%s'\n", filename);
     }
@@ -693,18 +1180,28 @@ CheckpointIn::CheckpointIn(const string &cpt_dir, SimObjectResolver &resolver)
 
 CheckpointIn::~CheckpointIn()
 {
+    delete bin;
     delete db;
 }
 
 bool
 CheckpointIn::entryExists(const string &section, const string &entry)
 {
+    if (bin)
+        return bin->find(section, entry) != nullptr;
     return db->entryExists(section, entry);
 }
 
 bool
 CheckpointIn::find(const string &section, const string &entry, string &value)
 {
+    if (bin) {
+        const BinaryValue *v = bin->find(section, entry);
+        if (!v)
+            return false;
+        value = BinaryCheckpoint::text(*v);
+        return true;
+    }
     return db->find(section, entry, value);
 }
 
@@ -715,9 +1212,10 @@ CheckpointIn::findObj(const string &section, const string &entry,
 {
     string path;
 
-    if (!db->find(section, entry, path))
+    if (!find(section, entry, path))
         return false;
 
+    std::lock_guard<std::mutex> lock(resolverLock);
     value = objNameResolver.resolveSimObject(path);
     return true;
 }
@@ -726,5 +1224,7 @@ CheckpointIn::findObj(const string &section, const string &entry,
 bool
 CheckpointIn::sectionExists(const string &section)
 {
+    if (bin)
+        return bin->sectionExists(section);
     return db->sectionExists(section);
 }
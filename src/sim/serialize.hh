@@ -54,12 +54,14 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <mutex>
 #include <stack>
 #include <set>
 #include <vector>
 
 #include "base/bitunion.hh"
 
+class BinaryCheckpoint;
 class CheckpointIn;
 class IniFile;
 class Serializable;
@@ -335,11 +337,19 @@ class Serializable
     static int ckptCount;
     static int ckptMaxCount;
     static int ckptPrevCount;
-    static void serializeAll(const std::string &cpt_dir);
+    static void serializeAll(const std::string &cpt_dir,
+                             unsigned threads = 1);
     static void unserializeGlobals(CheckpointIn &cp);
 
+    /**
+     * Write checkpoints as typed binary records instead of INI text.
+     * Checkpoints in either format can be restored.
+     */
+    static bool binaryFormat;
+
   private:
-    static std::stack<std::string> path;
+    /** Active section path, per thread to allow parallel checkpoints */
+    static thread_local std::stack<std::string> path;
 };
 
 void debug_serialize(const std::string &cpt_dir);
@@ -351,8 +361,14 @@ class CheckpointIn
 
     IniFile *db;
 
+    /** The checkpoint, if it is in the binary format rather than INI */
+    BinaryCheckpoint *bin;
+
     SimObjectResolver &objNameResolver;
 
+    /** Serializes name lookups by objects restored in parallel */
+    std::mutex resolverLock;
+
   public:
     CheckpointIn(const std::string &cpt_dir, SimObjectResolver &resolver);
     ~CheckpointIn();
@@ -369,6 +385,9 @@ class CheckpointIn
     bool entryExists(const std::string &section, const std::string &entry);
     bool sectionExists(const std::string &section);
 
+    /** Get the binary checkpoint, or nullptr for an INI checkpoint */
+    BinaryCheckpoint *binary() const { return bin; }
+
     // The following static functions have to do with checkpoint
     // creation rather than restoration.  This class makes a handy
     // namespace for them though.  Currently no Checkpoint object is
@@ -32,6 +32,12 @@
 
 #include "sim/sim_object.hh"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <thread>
+
 #include "base/logging.hh"
 #include "base/match.hh"
 #include "base/trace.hh"
@@ -106,6 +112,76 @@ SimObject::regStats()
 {
 }
 
+/**
+ * Call f(i) for every i in [0, n), sharing the work between the
+ * calling thread and up to threads - 1 helpers.
+ */
+template <class F>
+static void
+parallelFor(size_t n, unsigned threads, F f)
+{
+    std::atomic<size_t> next(0);
+    auto worker = [n, &next, &f]() {
+        for (size_t i = next++; i < n; i = next++)
+            f(i);
+    };
+
+    std::vector<std::thread> workers;
+    unsigned num_workers = std::min<size_t>(threads, n);
+    for (unsigned i = 1; i < num_workers; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto &t : workers)
+        t.join();
+}
+
+static void
+runSetupPhase(SimObject *obj, SimObject::SetupPhase phase)
+{
+    switch (phase) {
+      case SimObject::SetupPhase::Init:
+        obj->init();
+        break;
+      case SimObject::SetupPhase::RegStats:
+        obj->regStats();
+        break;
+    }
+}
+
+void
+SimObject::setupAll(const std::vector<SimObject *> &objs, SetupPhase phase,
+                    unsigned threads)
+{
+    std::vector<SimObject *> parallel;
+    for (auto obj : objs) {
+        if (threads > 1 && obj->parallelSetup(phase))
+            parallel.push_back(obj);
+        else
+            runSetupPhase(obj, phase);
+    }
+
+    parallelFor(parallel.size(), threads, [&parallel, phase](size_t i) {
+            runSetupPhase(parallel[i], phase);
+        });
+}
+
+void
+SimObject::loadStateAll(const std::vector<SimObject *> &objs,
+                        CheckpointIn &cp, unsigned threads)
+{
+    std::vector<SimObject *> parallel;
+    for (auto obj : objs) {
+        if (threads > 1 && obj->parallelCheckpoint())
+            parallel.push_back(obj);
+        else
+            obj->loadState(cp);
+    }
+
+    parallelFor(parallel.size(), threads, [&parallel, &cp](size_t i) {
+            parallel[i]->loadState(cp);
+        });
+}
+
 void
 SimObject::resetStats()
 {
@@ -137,17 +213,48 @@ SimObject::getProbeManager()
 // static function: serialize all SimObjects.
 //
 void
-SimObject::serializeAll(CheckpointOut &cp)
+SimObject::serializeAll(CheckpointOut &cp, unsigned threads)
 {
-    SimObjectList::reverse_iterator ri = simObjectList.rbegin();
-    SimObjectList::reverse_iterator rend = simObjectList.rend();
+    if (threads <= 1) {
+        SimObjectList::reverse_iterator ri = simObjectList.rbegin();
+        SimObjectList::reverse_iterator rend = simObjectList.rend();
 
-    for (; ri != rend; ++ri) {
-        SimObject *obj = *ri;
-        // This works despite name() returning a fully qualified name
-        // since we are at the top level.
-        obj->serializeSection(cp, obj->name());
-   }
+        for (; ri != rend; ++ri) {
+            SimObject *obj = *ri;
+            // This works despite name() returning a fully qualified name
+            // since we are at the top level.
+            obj->serializeSection(cp, obj->name());
+        }
+        return;
+    }
+
+    // Every object gets a buffer that inherits the format (and the
+    // binary checkpoint tag) of the checkpoint stream. The buffers
+    // are copied to the checkpoint in the serial order once all
+    // objects are done.
+    const std::vector<SimObject *> objs(simObjectList.rbegin(),
+                                        simObjectList.rend());
+    std::vector<std::unique_ptr<std::ostringstream>> bufs(objs.size());
+    std::vector<size_t> parallel;
+    for (size_t i = 0; i < objs.size(); ++i) {
+        bufs[i].reset(new std::ostringstream());
+        bufs[i]->copyfmt(cp);
+        if (objs[i]->parallelCheckpoint())
+            parallel.push_back(i);
+        else
+            objs[i]->serializeSection(*bufs[i], objs[i]->name());
+    }
+
+    parallelFor(parallel.size(), threads,
+                [&objs, &bufs, &parallel](size_t i) {
+            SimObject *obj = objs[parallel[i]];
+            obj->serializeSection(*bufs[parallel[i]], obj->name());
+        });
+
+    for (auto &buf : bufs) {
+        cp << buf->str();
+        buf.reset();
+    }
 }
 
 
@@ -149,6 +149,33 @@ class SimObject : public EventManager, public Serializable, public Drainable
      */
     virtual void regStats();
 
+    /** Setup phases that may be run on several threads at once. */
+    enum class SetupPhase { Init, RegStats };
+
+    /**
+     * Can this object run a setup phase concurrently with other
+     * objects? Objects returning true must only touch their own state
+     * (and the thread safe parts of the stats package) in the
+     * phase. Everything else is set up serially, in tree order,
+     * before any of the parallel objects.
+     *
+     * @param phase Setup phase that is about to be run.
+     * @return true if the phase can be run on any thread.
+     */
+    virtual bool parallelSetup(SetupPhase phase) const { return false; }
+
+    /**
+     * Can this object be serialized, and have its state loaded, while
+     * other objects do the same? Objects returning true must only
+     * touch their own state in serialize() and loadState(). Their
+     * sections are written to private buffers and copied to the
+     * checkpoint in the usual order, so the checkpoint is the same
+     * regardless of the number of threads.
+     *
+     * @return true if the object can be checkpointed on any thread.
+     */
+    virtual bool parallelCheckpoint() const { return false; }
+
     /**
      * Reset statistics associated with this object.
      */
@@ -211,8 +238,36 @@ class SimObject : public EventManager, public Serializable, public Drainable
 
     /**
      * Serialize all SimObjects in the system.
+     *
+     * @param cp Checkpoint to write the object sections to.
+     * @param threads Number of threads, 1 writes everything directly.
      */
-    static void serializeAll(CheckpointOut &cp);
+    static void serializeAll(CheckpointOut &cp, unsigned threads = 1);
+
+    /**
+     * Load the state of a list of objects from a checkpoint. Objects
+     * that don't support parallel checkpointing are restored first,
+     * in list order, and the rest are then shared between the worker
+     * threads.
+     *
+     * @param objs Objects in tree order.
+     * @param cp Checkpoint to restore the state from.
+     * @param threads Number of threads, 1 restores everything in order.
+     */
+    static void loadStateAll(const std::vector<SimObject *> &objs,
+                             CheckpointIn &cp, unsigned threads);
+
+    /**
+     * Run a setup phase on a list of objects. Objects that don't
+     * support parallel setup are handled first, in list order, and
+     * the rest are then shared between the worker threads.
+     *
+     * @param objs Objects in tree order.
+     * @param phase Phase to run.
+     * @param threads Number of threads, 1 runs everything in order.
+     */
+    static void setupAll(const std::vector<SimObject *> &objs,
+                         SetupPhase phase, unsigned threads);
 
 #ifdef DEBUG
   public:
@@ -226,6 +281,13 @@ class SimObject : public EventManager, public Serializable, public Drainable
      * char* rather than std::string to make it callable from gdb.
      */
     static SimObject *find(const char *name);
+
+    /** Get all instantiated simulation objects. */
+    static const std::vector<SimObject *> &
+    getSimObjectList()
+    {
+        return simObjectList;
+    }
 };
 
 /**
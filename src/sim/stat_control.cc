@@ -57,6 +57,10 @@
 #include "base/statistics.hh"
 #include "base/time.hh"
 #include "cpu/base.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+#include "sim/event_profile.hh"
+#include "sim/eventq.hh"
 #include "sim/global_event.hh"
 
 using namespace std;
@@ -70,15 +74,26 @@ namespace Stats {
 
 Time statTime(true);
 Tick startTick;
+uint64_t startEvents;
 
 GlobalEvent *dumpEvent;
 
+uint64_t
+statServicedEvents()
+{
+    uint64_t events = 0;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        events += mainEventQueue[i]->numServiced();
+    return events;
+}
+
 struct SimTicksReset : public Callback
 {
     void process()
     {
         statTime.setTimer();
         startTick = curTick();
+        startEvents = statServicedEvents();
     }
 };
 
@@ -92,6 +107,12 @@ statElapsedTime()
     return elapsed;
 }
 
+uint64_t
+statElapsedEvents()
+{
+    return statServicedEvents() - startEvents;
+}
+
 Tick
 statElapsedTicks()
 {
@@ -111,11 +132,20 @@ struct Global
     Stats::Formula hostInstRate;
     Stats::Formula hostOpRate;
     Stats::Formula hostTickRate;
+    Stats::Formula hostEventRate;
     Stats::Value hostMemory;
     Stats::Value hostSeconds;
 
+    Stats::Value hostEventPoolHitRate;
+    Stats::Value hostPacketPoolHitRate;
+    Stats::Value hostPacketDataPoolHitRate;
+    Stats::Value hostRequestPoolHitRate;
+    Stats::Value hostSenderStatePoolHitRate;
+    Stats::Value hostEventProfileSeconds;
+
     Stats::Value simInsts;
     Stats::Value simOps;
+    Stats::Value simEvents;
 
     Global();
 };
@@ -196,10 +226,68 @@ Global::Global()
         .precision(0)
         ;
 
+    simEvents
+        .functor(statElapsedEvents)
+        .name("sim_events")
+        .desc("Number of events processed by the main event queues")
+        .precision(0)
+        ;
+
+    hostEventRate
+        .name("host_event_rate")
+        .desc("Simulator event rate (events/s)")
+        .precision(0)
+        ;
+
+    hostEventPoolHitRate
+        .functor(Event::Pool::hitRate)
+        .name("host_event_pool_hit_rate")
+        .desc("Fraction of event allocations served from the free lists")
+        .precision(6)
+        ;
+
+    hostPacketPoolHitRate
+        .functor(Packet::Pool::hitRate)
+        .name("host_packet_pool_hit_rate")
+        .desc("Fraction of packet allocations served from the free lists")
+        .precision(6)
+        ;
+
+    hostPacketDataPoolHitRate
+        .functor(Packet::DataPool::hitRate)
+        .name("host_packet_data_pool_hit_rate")
+        .desc("Fraction of packet payload allocations served from the "
+              "free lists")
+        .precision(6)
+        ;
+
+    hostRequestPoolHitRate
+        .functor(Request::Pool::hitRate)
+        .name("host_request_pool_hit_rate")
+        .desc("Fraction of request allocations served from the free lists")
+        .precision(6)
+        ;
+
+    hostSenderStatePoolHitRate
+        .functor(Packet::SenderState::Pool::hitRate)
+        .name("host_sender_state_pool_hit_rate")
+        .desc("Fraction of sender state allocations served from the free "
+              "lists")
+        .precision(6)
+        ;
+
+    hostEventProfileSeconds
+        .functor(eventProfileSeconds)
+        .name("host_event_profile_seconds")
+        .desc("Real time spent processing profiled events")
+        .precision(2)
+        ;
+
     simSeconds = simTicks / simFreq;
     hostInstRate = simInsts / hostSeconds;
     hostOpRate = simOps / hostSeconds;
     hostTickRate = simTicks / hostSeconds;
+    hostEventRate = simEvents / hostSeconds;
 
     registerResetCallback(&simTicksReset);
 }
@@ -45,6 +45,7 @@
 #include "cpu/thread_context.hh"
 #include "mem/page_table.hh"
 #include "sim/process.hh"
+#include "sim/read_ahead.hh"
 #include "sim/sim_exit.hh"
 #include "sim/syscall_debug_macros.hh"
 #include "sim/syscall_desc.hh"
@@ -276,7 +277,21 @@ readFunc(SyscallDesc *desc, int num, Process *p, ThreadContext *tc)
     int sim_fd = hbfdp->getSimFD();
 
     BufferArg bufArg(buf_ptr, nbytes);
-    int bytes_read = read(sim_fd, bufArg.bufferPtr(), nbytes);
+    int bytes_read;
+
+    auto ffdp = std::dynamic_pointer_cast<FileFDEntry>(hbfdp);
+    ReadAhead *read_ahead = (ffdp && p->readAheadSize) ?
+        ffdp->getReadAhead(p->readAheadSize) : nullptr;
+    if (read_ahead) {
+        // read at the file offset, and move the offset like read()
+        off_t offset = lseek(sim_fd, 0, SEEK_CUR);
+        bytes_read = read_ahead->read((uint8_t *)bufArg.bufferPtr(),
+                                      nbytes, offset);
+        if (bytes_read > 0)
+            lseek(sim_fd, offset + bytes_read, SEEK_SET);
+    } else {
+        bytes_read = read(sim_fd, bufArg.bufferPtr(), nbytes);
+    }
 
     if (bytes_read > 0)
         bufArg.copyOut(tc->getMemProxy());
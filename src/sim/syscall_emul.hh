@@ -1377,7 +1377,7 @@ cloneFunc(SyscallDesc *desc, int callnum, Process *p, ThreadContext *tc)
 #endif
 
     ctc->pcState(tc->nextInstAddr());
-    ctc->activate();
+    remoteActivate(ctc);
 
     return cp->pid();
 }
@@ -1502,8 +1502,7 @@ mmapImpl(SyscallDesc *desc, int num, Process *p, ThreadContext *tc,
 
     length = roundUp(length, TheISA::PageBytes);
 
-    int sim_fd = -1;
-    uint8_t *pmap = nullptr;
+    std::shared_ptr<MappedFile> file;
     if (!(tgt_flags & OS::TGT_MAP_ANONYMOUS)) {
         std::shared_ptr<FDEntry> fdep = (*p->fds)[tgt_fd];
 
@@ -1517,15 +1516,21 @@ mmapImpl(SyscallDesc *desc, int num, Process *p, ThreadContext *tc,
         auto ffdp = std::dynamic_pointer_cast<FileFDEntry>(fdep);
         if (!ffdp)
             return -EBADF;
-        sim_fd = ffdp->getSimFD();
+        int sim_fd = ffdp->getSimFD();
 
-        pmap = (decltype(pmap))mmap(nullptr, length, PROT_READ, MAP_PRIVATE,
-                                    sim_fd, offset);
+        // It is possible to mmap an area larger than a file, however
+        // accessing unmapped portions the system triggers a "Bus error"
+        // on the host. We must know where the file ends.
+        struct stat file_stat;
+        if (fstat(sim_fd, &file_stat) < 0)
+            return -errno;
 
-        if (pmap == (decltype(pmap))-1) {
-            warn("mmap: failed to map file into host address space");
+        // The target is free to close its descriptor once the file is
+        // mapped, so keep one of our own to populate the mapping.
+        int map_fd = dup(sim_fd);
+        if (map_fd < 0)
             return -errno;
-        }
+        file = std::make_shared<MappedFile>(map_fd, file_stat.st_size);
     }
 
     // Extend global mmap region if necessary. Note that we ignore the
@@ -1554,16 +1559,15 @@ mmapImpl(SyscallDesc *desc, int num, Process *p, ThreadContext *tc,
             tc->getDTBPtr()->flushAll();
             tc->getITBPtr()->flushAll();
         }
+        p->memState->removeFileMappings(start, length);
     }
 
-    // Allocate physical memory and map it in. If the page table is already
-    // mapped and clobber is not set, the simulator will issue throw a
-    // fatal and bail out of the simulation.
-    p->allocateMem(start, length, clobber);
+    if (!file) {
+        // Allocate physical memory and map it in. If the page table is
+        // already mapped and clobber is not set, the simulator will issue
+        // throw a fatal and bail out of the simulation.
+        p->allocateMem(start, length, clobber);
 
-    // Transfer content into target address space.
-    SETranslatingPortProxy &tp = tc->getMemProxy();
-    if (tgt_flags & OS::TGT_MAP_ANONYMOUS) {
         // In general, we should zero the mapped area for anonymous mappings,
         // with something like:
         //     tp.memsetBlob(start, 0, length);
@@ -1574,24 +1578,30 @@ mmapImpl(SyscallDesc *desc, int num, Process *p, ThreadContext *tc,
         // there's no danger of remapping used memory, so for now all
         // newly mapped memory should already be zeroed so we can skip it.
     } else {
-        // It is possible to mmap an area larger than a file, however
-        // accessing unmapped portions the system triggers a "Bus error"
-        // on the host. We must know when to stop copying the file from
-        // the host into the target address space.
-        struct stat file_stat;
-        if (fstat(sim_fd, &file_stat) > 0)
-            fatal("mmap: cannot stat file");
-
-        // Copy the portion of the file that is resident. This requires
-        // checking both the mmap size and the filesize that we are
-        // trying to mmap into this space; the mmap size also depends
-        // on the specified offset into the file.
-        uint64_t size = std::min((uint64_t)file_stat.st_size - offset,
-                                 length);
-        tp.writeBlob(start, pmap, size);
+        // File mappings are populated a page at a time when they are
+        // first touched, see Process::fixupFault(), rather than copied
+        // in as a whole here. Pages of private and read-only mappings
+        // alias the host's page cache until they are written. Writable
+        // shared mappings get copies, which keeps their pages apart from
+        // the file should writes ever be propagated to it (see above).
+        EmulationPageTable *pt = p->pTable;
+        if (clobber) {
+            for (Addr addr = start; addr < start + length;
+                 addr += TheISA::PageBytes) {
+                if (pt->translate(addr))
+                    pt->unmap(addr, TheISA::PageBytes);
+            }
+        } else if (!pt->isUnmapped(start, length)) {
+            fatal("mmap: %#x-%#x is already mapped", start, start + length);
+        }
 
-        // Cleanup the mmap region before exiting this function.
-        munmap(pmap, length);
+        FileMapping mapping;
+        mapping.end = start + length;
+        mapping.file = file;
+        mapping.offset = offset;
+        mapping.alias = (tgt_flags & OS::TGT_MAP_PRIVATE) ||
+            !(prot & PROT_WRITE);
+        p->memState->addFileMapping(start, mapping);
 
         // Maintain the symbol table for dynamic executables.
         // The loader will call mmap to map the images into its address
@@ -1617,10 +1627,6 @@ mmapImpl(SyscallDesc *desc, int num, Process *p, ThreadContext *tc,
                 }
             }
         }
-
-        // Note that we do not zero out the remainder of the mapping. This
-        // is done by a real system, but it probably will not affect
-        // execution (hopefully).
     }
 
     return start;
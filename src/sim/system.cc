@@ -102,7 +102,14 @@ System::System(Params *p)
 #else
       kvmVM(nullptr),
 #endif
-      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve),
+      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve,
+              p->backing_store_pages, p->backing_store_numa_nodes,
+              p->backing_store_prefault_threads,
+              p->compress_checkpoint_memory,
+              p->checkpoint_memory_threads,
+              p->checkpoint_memory_block_size,
+              p->incremental_checkpoint_memory),
+      _directMemoryAccess(p->se_direct_memory_access),
       memoryMode(p->mem_mode),
       _cacheLineSize(p->cache_line_size),
       workItemsBegin(0),
@@ -111,7 +118,8 @@ System::System(Params *p)
       thermalModel(p->thermal_model),
       _params(p),
       totalNumInsts(0),
-      instEventQueue("system instruction-based event queue")
+      instEventQueue("system instruction-based event queue"),
+      regionMarkers(p->region_stats, p->region_file)
 {
     // add self to global system list
     systemList.push_back(this);
@@ -296,6 +304,27 @@ System::numRunningContexts()
     );
 }
 
+bool
+System::contextIdle(ContextID tid) const
+{
+    return threadContexts[tid]->status() == ThreadContext::Suspended;
+}
+
+TimerWheel *
+System::timerWheel(EventQueue *eventq)
+{
+    if (!params()->tickless_timers)
+        return nullptr;
+
+    std::unique_ptr<TimerWheel> &wheel = timerWheels[eventq];
+    if (!wheel) {
+        wheel.reset(new TimerWheel(
+            csprintf("%s.timer_wheel%d", name(), timerWheels.size() - 1),
+            eventq, params()->tickless_timer_slack));
+    }
+    return wheel.get();
+}
+
 void
 System::initState()
 {
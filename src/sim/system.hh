@@ -47,6 +47,8 @@
 #ifndef __SYSTEM_HH__
 #define __SYSTEM_HH__
 
+#include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -63,7 +65,9 @@
 #include "mem/port_proxy.hh"
 #include "params/System.hh"
 #include "sim/futex_map.hh"
+#include "sim/region_markers.hh"
 #include "sim/se_signal.hh"
+#include "sim/timer_wheel.hh"
 
 /**
  * To avoid linking errors with LTO, only include the header if we
@@ -209,6 +213,22 @@ class System : public MemObject
      * system.  These threads could be Active or Suspended. */
     int numRunningContexts();
 
+    /** Is the thread context suspended, e.g., by a halt or quiesce? */
+    bool contextIdle(ContextID tid) const;
+
+    /**
+     * Get the shared event of the per-core timers on an event queue.
+     *
+     * @return The timer wheel, or nullptr unless the system uses
+     *         tickless timers.
+     */
+    TimerWheel *timerWheel(EventQueue *eventq);
+
+  private:
+    /** Shared timer events, one per event queue */
+    std::map<EventQueue *, std::unique_ptr<TimerWheel>> timerWheels;
+
+  public:
     Addr pagePtr;
 
     uint64_t init_param;
@@ -265,6 +285,15 @@ class System : public MemObject
     /** Get a pointer to access the physical memory of the system */
     PhysicalMemory& getPhysMem() { return physmem; }
 
+    /**
+     * May syscall emulation access the backing store directly rather
+     * than through the memory system? This is only correct if no
+     * cache can hold a different copy of the data.
+     */
+    bool directMemoryAccess() const {
+        return _directMemoryAccess || bypassCaches();
+    }
+
     /** Amount of physical memory that is still free */
     Addr freeMemSize() const;
 
@@ -306,6 +335,9 @@ class System : public MemObject
 
     PhysicalMemory physmem;
 
+    /** Let syscall emulation bypass the memory system. */
+    const bool _directMemoryAccess;
+
     Enums::MemoryMode memoryMode;
 
     const unsigned int _cacheLineSize;
@@ -532,6 +564,13 @@ class System : public MemObject
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 
+    /**
+     * The symbol tables and the memory stores only belong to this
+     * system, and compressing the stores dominates the checkpoint
+     * time of large systems.
+     */
+    bool parallelCheckpoint() const override { return true; }
+
     void drainResume() override;
 
   public:
@@ -539,6 +578,8 @@ class System : public MemObject
     EventQueue instEventQueue;
     std::map<std::pair<uint32_t,uint32_t>, Tick>  lastWorkItemStarted;
     std::map<uint32_t, Stats::Histogram*> workItemStats;
+    /** Per-region totals for m5_region_begin/m5_region_end */
+    RegionMarkers regionMarkers;
 
     ////////////////////////////////////////////
     //
@@ -41,6 +41,7 @@
 
 #include "params/TickedObject.hh"
 #include "sim/clocked_object.hh"
+#include "sim/cycle_wheel.hh"
 
 Ticked::Ticked(ClockedObject &object_,
     Stats::Scalar *imported_num_cycles,
@@ -53,18 +54,54 @@ Ticked::Ticked(ClockedObject &object_,
     numCyclesLocal((imported_num_cycles ? NULL : new Stats::Scalar)),
     numCycles((imported_num_cycles ? *imported_num_cycles :
         *numCyclesLocal))
-{ }
+{
+    wheel = object.params()->clk_domain->cycleWheel(
+        object.eventQueue(), priority);
+    wheelSlot = wheel ? wheel->add(this) : 0;
+}
 
 void
-Ticked::processClockEvent() {
+Ticked::tickOnce()
+{
     ++tickCycles;
     ++numCycles;
     countCycles(Cycles(1));
     evaluate();
+}
+
+void
+Ticked::scheduleNextTick()
+{
+    if (wheel)
+        wheel->activate(wheelSlot, object.clockEdge(Cycles(1)));
+    else if (!event.scheduled())
+        object.schedule(event, object.clockEdge(Cycles(1)));
+}
+
+void
+Ticked::cancelNextTick()
+{
+    if (wheel)
+        wheel->deactivate(wheelSlot);
+    else if (event.scheduled())
+        object.deschedule(event);
+}
+
+void
+Ticked::processClockEvent() {
+    tickOnce();
     if (running)
         object.schedule(event, object.clockEdge(Cycles(1)));
 }
 
+void
+Ticked::processWheelTick()
+{
+    tickOnce();
+    if (running)
+        wheel->activate(wheelSlot, object.clockEdge(Cycles(1)));
+}
+
 void
 Ticked::regStats()
 {
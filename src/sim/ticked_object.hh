@@ -50,6 +50,7 @@
 
 #include "sim/clocked_object.hh"
 
+class CycleWheel;
 class TickedObjectParams;
 
 /** Ticked attaches gem5's event queue/scheduler to evaluate
@@ -69,6 +70,24 @@ class Ticked : public Serializable
     /** Evaluate and reschedule */
     void processClockEvent();
 
+    /**
+     * Shared clock event of the clock domain, or NULL if this object
+     * schedules its own event every cycle.
+     */
+    CycleWheel *wheel;
+
+    /** Slot of this object in the wheel */
+    unsigned wheelSlot;
+
+    /** Account for and evaluate a single cycle */
+    void tickOnce();
+
+    /** Schedule the evaluation of the next cycle */
+    void scheduleNextTick();
+
+    /** Cancel the evaluation of the next cycle */
+    void cancelNextTick();
+
     /** Have I been started? and am not stopped */
     bool running;
 
@@ -105,8 +124,7 @@ class Ticked : public Serializable
     start()
     {
         if (!running) {
-            if (!event.scheduled())
-                object.schedule(event, object.clockEdge(Cycles(1)));
+            scheduleNextTick();
             running = true;
             numCycles += cyclesSinceLastStopped();
             countCycles(cyclesSinceLastStopped());
@@ -132,8 +150,7 @@ class Ticked : public Serializable
     stop()
     {
         if (running) {
-            if (event.scheduled())
-                object.deschedule(event);
+            cancelNextTick();
             running = false;
             resetLastStopped();
         }
@@ -158,6 +175,9 @@ class Ticked : public Serializable
      * @param delta Number of cycles since the previous call.
      */
     virtual void countCycles(Cycles delta) {}
+
+    /** Evaluate and reschedule when turned by a CycleWheel */
+    void processWheelTick();
 };
 
 /** TickedObject attaches Ticked to ClockedObject and can be used as
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/timer_wheel.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/intmath.hh"
+
+TimerWheel::TimerWheel(const std::string &name, EventQueue *eventq,
+                       Tick slack)
+    : _name(name), eventq(eventq), slack(slack),
+      event([this]{ process(); }, name),
+      numActive(0)
+{
+}
+
+unsigned
+TimerWheel::add(std::function<void()> callback)
+{
+    const unsigned slot = callbacks.size();
+    callbacks.push_back(callback);
+    _due.push_back(MaxTick);
+    if (slot % 64 == 0)
+        activeMask.push_back(0);
+    return slot;
+}
+
+void
+TimerWheel::activate(unsigned slot, Tick when, bool deferrable)
+{
+    assert(slot < callbacks.size());
+    if (deferrable && slack)
+        when = divCeil(when, slack) * slack;
+
+    if (!active(slot)) {
+        activeMask[slot / 64] |= 1ULL << (slot % 64);
+        ++numActive;
+    }
+    _due[slot] = when;
+    scheduleAt(when);
+}
+
+void
+TimerWheel::deactivate(unsigned slot)
+{
+    assert(slot < callbacks.size());
+    if (!active(slot))
+        return;
+
+    activeMask[slot / 64] &= ~(1ULL << (slot % 64));
+    _due[slot] = MaxTick;
+    if (--numActive == 0 && event.scheduled())
+        eventq->deschedule(&event);
+}
+
+void
+TimerWheel::scheduleAt(Tick when)
+{
+    if (!event.scheduled())
+        eventq->schedule(&event, when);
+    else if (when < event.when())
+        eventq->reschedule(&event, when);
+}
+
+void
+TimerWheel::process()
+{
+    const Tick now = eventq->getCurTick();
+
+    for (unsigned word = 0; word < activeMask.size(); ++word) {
+        for (uint64_t bits = activeMask[word]; bits; bits &= bits - 1) {
+            const unsigned slot = word * 64 + __builtin_ctzll(bits);
+            // Timers are one-shot, callbacks re-arm them if needed.
+            // Callbacks earlier in this pass may have stopped or
+            // re-armed this one.
+            if (active(slot) && _due[slot] <= now) {
+                deactivate(slot);
+                callbacks[slot]();
+            }
+        }
+    }
+
+    Tick next = MaxTick;
+    for (unsigned word = 0; word < activeMask.size(); ++word) {
+        for (uint64_t bits = activeMask[word]; bits; bits &= bits - 1) {
+            const unsigned slot = word * 64 + __builtin_ctzll(bits);
+            next = std::min(next, _due[slot]);
+        }
+    }
+
+    if (next != MaxTick)
+        scheduleAt(next);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Shared event for the architected timers of the cores of a system.
+ */
+
+#ifndef __SIM_TIMER_WHEEL_HH__
+#define __SIM_TIMER_WHEEL_HH__
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "sim/eventq.hh"
+
+/**
+ * A TimerWheel services the per-core timers (local APIC timers,
+ * generic timers) of a system on one event queue using a single
+ * event. Instead of scheduling their own event, timers set the tick
+ * at which their callback is due, and all timers due at the same
+ * tick are handled by one evaluation of the wheel.
+ *
+ * Timers of idle cores may be deferred: their expiry is rounded up
+ * to the next multiple of the slack of the wheel, so that the idle
+ * cores of a large system all wake up on the same event rather than
+ * each at a slightly different tick.
+ */
+class TimerWheel
+{
+  public:
+    /**
+     * @param name Name of the wheel event.
+     * @param eventq Event queue of the timers.
+     * @param slack Maximum delay of deferrable timers, 0 to never
+     *              defer them.
+     */
+    TimerWheel(const std::string &name, EventQueue *eventq, Tick slack);
+
+    /** Add a timer to the wheel and return its slot. */
+    unsigned add(std::function<void()> callback);
+
+    /**
+     * Call the timer in a slot at the given tick.
+     *
+     * @param slot Slot of the timer.
+     * @param when Tick at which the timer expires.
+     * @param deferrable Whether the expiry may be coalesced with
+     *                   other timers, i.e., the core is idle.
+     */
+    void activate(unsigned slot, Tick when, bool deferrable = false);
+
+    /** Stop the timer in a slot. */
+    void deactivate(unsigned slot);
+
+    bool
+    active(unsigned slot) const
+    {
+        return activeMask[slot / 64] & (1ULL << (slot % 64));
+    }
+
+    /** Tick at which the timer in a slot is called, if active. */
+    Tick due(unsigned slot) const { return _due[slot]; }
+
+    const std::string &name() const { return _name; }
+
+  private:
+    /** Call all timers due at the current tick. */
+    void process();
+
+    /** Make sure the wheel turns no later than when. */
+    void scheduleAt(Tick when);
+
+    const std::string _name;
+
+    EventQueue *eventq;
+
+    const Tick slack;
+
+    EventFunctionWrapper event;
+
+    std::vector<std::function<void()>> callbacks;
+
+    /** Tick of the next call of each timer. */
+    std::vector<Tick> _due;
+
+    /** One bit per timer, set while the timer is active. */
+    std::vector<uint64_t> activeMask;
+
+    unsigned numActive;
+};
+
+#endif // __SIM_TIMER_WHEEL_HH__
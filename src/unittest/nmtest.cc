@@ -54,12 +54,8 @@ main(int argc, char *argv[])
     obj->loadLocalSymbols(&symtab);
 
     if (argc == 2) {
-        SymbolTable::ATable::const_iterator i = symtab.getAddrTable().begin();
-        SymbolTable::ATable::const_iterator end = symtab.getAddrTable().end();
-        while (i != end) {
-            cprintf("%#x %s\n", i->first, i->second);
-            ++i;
-        }
+        for (size_t i = 0; i < symtab.size(); ++i)
+            cprintf("%#x %s\n", symtab.address(i), symtab.name(i));
     } else {
         string symbol = argv[2];
         Addr address;
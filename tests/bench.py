@@ -0,0 +1,211 @@
+#!/usr/bin/env python2
+#
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import re
+import sys
+
+import testing.benchmarks as benchmarks
+
+def _select(args):
+    isa = args.isa
+    if isa is None:
+        # Binaries usually live in build/<ISA>/
+        isa = os.path.basename(
+            os.path.dirname(os.path.abspath(args.gem5))).lower()
+
+    workload = args.workload or benchmarks.default_workload(isa)
+    selected = benchmarks.get_benchmarks(isa, workload, args.max_insts,
+                                         kvm=not args.no_kvm)
+    if args.filter:
+        selected = [ b for b in selected if re.search(args.filter, b.name) ]
+
+    return selected
+
+def _add_suite_args(parser):
+    parser.add_argument("gem5", type=str,
+                        help="gem5 binary")
+
+    parser.add_argument("--isa", type=str, default=None,
+                        help="ISA of the binary (default: guess from the "
+                        "binary's build directory)")
+
+    parser.add_argument("--workload", type=str, default=None,
+                        help="SE-mode workload (default: hello)")
+
+    parser.add_argument("--max-insts", type=int, default=100000000,
+                        help="Instructions to simulate per run")
+
+    parser.add_argument("--filter", type=str, default=None,
+                        help="Only use benchmarks whose names match this "
+                        "regular expression")
+
+    parser.add_argument("--no-kvm", action="store_true",
+                        help="Skip the KVM benchmark")
+
+def _add_compare_args(parser):
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        metavar="PERCENT",
+                        help="Largest slowdown that isn't a regression")
+
+def _list_args(subparsers):
+    parser = subparsers.add_parser(
+        "list",
+        help="List the benchmarks",
+        description="List the benchmarks and their command lines")
+
+    _add_suite_args(parser)
+
+def _list(args):
+    for b in _select(args):
+        print("%s: %s" % (b.name, " ".join(b.command(args.gem5, "."))))
+
+def _run_args(subparsers):
+    parser = subparsers.add_parser(
+        "run",
+        help="Run the benchmarks",
+        description="""
+        Run the benchmarks and write a JSON report with the host
+        seconds, events per second, simulated instructions per host
+        second and peak resident memory of each of them. The report
+        can be compared against a baseline report from an earlier
+        run.""")
+
+    _add_suite_args(parser)
+    _add_compare_args(parser)
+
+    parser.add_argument("--directory", "-d",
+                        type=str, default="m5bench",
+                        help="Benchmark work directory")
+
+    parser.add_argument("--timeout", "-t",
+                        type=int, default="0", metavar="MINUTES",
+                        help="Timeout, 0 to disable")
+
+    parser.add_argument("--repeat", "-r",
+                        type=int, default=1,
+                        help="Run each benchmark this many times and keep "
+                        "the fastest run")
+
+    parser.add_argument("--output", "-o",
+                        type=argparse.FileType('w'), default=sys.stdout,
+                        help="Report output file")
+
+    parser.add_argument("--baseline", "-b",
+                        type=argparse.FileType('r'), default=None,
+                        help="Report to compare the results against")
+
+def _run(args):
+    if not os.path.isfile(args.gem5) or not os.access(args.gem5, os.X_OK):
+        print("gem5 binary '%s' not an executable file" % args.gem5,
+            file=sys.stderr)
+        sys.exit(2)
+
+    selected = _select(args)
+    results = benchmarks.OrderedDict()
+    print("Running %i benchmarks" % len(selected), file=sys.stderr)
+    for benchno, bench in enumerate(selected):
+        best = None
+        for run in range(args.repeat):
+            print("%i: Running '%s' (%i/%i)..." %
+                  (benchno, bench, run + 1, args.repeat), file=sys.stderr)
+            result = bench.run(args.gem5,
+                               os.path.join(args.directory, bench.name),
+                               timeout=args.timeout * 60)
+            if result["status"] != "ok":
+                best = result
+                break
+            if best is None or result["host_seconds"] < best["host_seconds"]:
+                best = result
+        results[bench.name] = best
+
+    report = benchmarks.make_report(args.gem5, results)
+    json.dump(report, args.output, indent=4)
+    args.output.write("\n")
+
+    if args.baseline:
+        baseline = benchmarks.load_report(args.baseline)
+        _show_changes(baseline, report, args.threshold, sys.stderr)
+
+def _compare_args(subparsers):
+    parser = subparsers.add_parser(
+        "compare",
+        help="Compare two benchmark reports",
+        description="""
+        Compare a benchmark report against a baseline. The exit code
+        is 1 if any metric of any benchmark got worse by more than
+        the threshold.""")
+
+    _add_compare_args(parser)
+
+    parser.add_argument("baseline", type=argparse.FileType('r'),
+                        help="Baseline report")
+
+    parser.add_argument("report", type=argparse.FileType('r'),
+                        help="Report to compare")
+
+def _compare(args):
+    baseline = benchmarks.load_report(args.baseline)
+    report = benchmarks.load_report(args.report)
+    _show_changes(baseline, report, args.threshold, sys.stdout)
+
+def _show_changes(baseline, report, threshold, fout):
+    changes = benchmarks.compare_reports(baseline, report, threshold)
+    for name, metric, old, new, change, regressed in changes:
+        print("%-24s %-18s %14.2f %14.2f %+7.2f%%%s" %
+              (name, metric, old, new, change,
+               "  REGRESSION" if regressed else ""), file=fout)
+
+    if any(c[5] for c in changes):
+        sys.exit(1)
+
+_commands = {
+    "list" : (_list, _list_args),
+    "run" : (_run, _run_args),
+    "compare" : (_compare, _compare_args),
+}
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="gem5 host performance benchmarks")
+
+    subparsers = parser.add_subparsers(dest="command")
+
+    for key, (impl, cmd_parser) in _commands.items():
+        cmd_parser(subparsers)
+
+    args = parser.parse_args()
+    impl, cmd_parser = _commands[args.command]
+    impl(args)
+
+if __name__ == "__main__":
+    main()
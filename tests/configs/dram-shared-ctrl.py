@@ -0,0 +1,70 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Testers stressing a single DRAM controller that serves two channels.
+# The channels see independent random traffic, so one of them
+# regularly runs out of requests while the other still has some
+# queued. A channel that is never woken up again stalls the testers,
+# which then fail their progress check.
+
+import m5
+from m5.objects import *
+
+nb_testers = 2
+
+# Different injection rates keep the load of the channels uneven
+testers = [ MemTest(interval = 1 + 16 * i, percent_functional = 0,
+                    progress_check = 100000)
+            for i in xrange(nb_testers) ]
+
+# The testers touch addresses below 8MB + 64kB
+mem_range = AddrRange(0, size = '16MB')
+mem_ctrl = DDR3_1600_8x8(range = mem_range, channels = 2)
+mem_ctrl.channel_ranges = [ AddrRange(0, size = '16MB', intlvHighBit = 7,
+                                      intlvBits = 1, intlvMatch = i)
+                            for i in xrange(2) ]
+
+system = System(cpu = testers,
+                mem_ranges = [mem_range],
+                physmem = mem_ctrl,
+                membus = SystemXBar())
+# Dummy voltage domain for all our clock domains
+system.voltage_domain = VoltageDomain()
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+
+for tester in testers:
+    tester.port = system.membus.slave
+
+system.system_port = system.membus.slave
+system.physmem.port = system.membus.master
+
+# -----------------------
+# run simulation
+# -----------------------
+
+root = Root( full_system = False, system = system )
+root.system.mem_mode = 'timing'
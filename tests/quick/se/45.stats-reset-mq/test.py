@@ -0,0 +1,71 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Dump and reset the stats periodically while the CPUs run on separate
+# event queues, and check that the committed instructions reported in
+# the intervals add up to the instructions the CPUs executed.
+
+import struct
+
+for i, cpu in enumerate(root.system.cpu):
+    cpu.workload = Process(cmd = 'hello', executable = binpath('hello'),
+                           pid = 100 + i)
+
+def committed(name):
+    # Views are NumPy arrays or memoryviews, see m5.stats.counters()
+    view = memoryview(m5.stats.counters(name))
+    return struct.unpack_from(view.format, view.tobytes())[0]
+
+def run_test(root):
+    m5.instantiate()
+
+    cpus = root.system.cpu
+    names = [ '%s.committedInsts' % cpu.path() for cpu in cpus ]
+
+    # The stat event dumps the stats from the thread of whichever event
+    # queue reaches the barrier last
+    dumped = [ 0 ]
+    dump_ticks = set()
+    stats_dump = m5.stats.dump
+    def dump():
+        stats_dump()
+        if m5.curTick() not in dump_ticks:
+            dump_ticks.add(m5.curTick())
+            dumped[0] += sum(committed(name) for name in names)
+    m5.stats.dump = dump
+
+    m5.stats.periodicStatDump(1000000)
+    exit_event = m5.simulate(maxtick)
+    print('Exiting @ tick', m5.curTick(), 'because', exit_event.getCause())
+
+    counted = dumped[0] + sum(committed(name) for name in names)
+    executed = sum(cpu.totalInsts() for cpu in cpus)
+    if len(dump_ticks) < 2:
+        m5.fatal("Only %d stats dumps, the workload is too short" %
+                 len(dump_ticks))
+    if counted != executed:
+        m5.fatal("Stats count %d committed instructions, the CPUs "
+                 "executed %d" % (counted, executed))
@@ -0,0 +1,249 @@
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+
+from collections import OrderedDict
+import json
+import os
+import platform
+import re
+import subprocess
+import time
+
+_gem5_base = os.path.abspath(os.path.join(os.path.dirname(__file__),
+                                          "..", ".."))
+
+# CPU models of the suite, by the short names used in benchmark names
+cpu_types = OrderedDict([
+    ("atomic", "AtomicSimpleCPU"),
+    ("timing", "TimingSimpleCPU"),
+    ("o3", "DerivO3CPU"),
+    ("minor", "MinorCPU"),
+])
+
+# Memory systems of the suite. The Ruby variants need a binary built
+# with the MESI_Two_Level protocol.
+mem_systems = OrderedDict([
+    ("classic", ["--caches", "--l2cache"]),
+    ("ruby", ["--ruby"]),
+])
+
+core_counts = [ 1, 16, 64 ]
+
+# KVM CPU models, by ISA
+kvm_cpu_types = {
+    "arm" : "ArmV8KvmCPU",
+    "x86" : "X86KvmCPU",
+}
+
+# Metrics of a benchmark run and whether larger values are better
+metrics = OrderedDict([
+    ("host_seconds", False),
+    ("events_per_second", True),
+    ("insts_per_second", True),
+    ("peak_rss_kb", False),
+])
+
+class Benchmark(object):
+    """A gem5 configuration whose host performance is measured.
+
+    A benchmark runs gem5 with a config script and a list of
+    arguments and measures how long it takes and how much memory it
+    needs. Rates are computed from the last statistics dump, so they
+    cover the measured part of runs that fast-forward or switch CPUs.
+    """
+
+    def __init__(self, name, config, args):
+        self.name = name
+        self.config = config
+        self.args = args
+
+    def __str__(self):
+        return self.name
+
+    def command(self, gem5, output_dir):
+        return [ gem5, "-d", output_dir,
+                 os.path.join(_gem5_base, self.config) ] + self.args
+
+    def run(self, gem5, output_dir, timeout=0):
+        """Run the benchmark once and return its measurements.
+
+        Keyword arguments:
+          timeout -- Host seconds to allow the run, 0 to disable
+        """
+        if not os.path.exists(output_dir):
+            os.makedirs(output_dir)
+
+        with open(os.path.join(output_dir, "simout"), "w") as simout, \
+             open(os.path.join(output_dir, "simerr"), "w") as simerr:
+            start = time.time()
+            p = subprocess.Popen(self.command(gem5, output_dir),
+                                 stdout=simout, stderr=simerr)
+
+            # Wait for this child in particular to get its own peak
+            # memory usage rather than the peak of all children
+            status, rusage = None, None
+            while status is None:
+                pid, wait_status, rusage = os.wait4(p.pid, os.WNOHANG)
+                if pid:
+                    status = wait_status
+                elif timeout and time.time() - start > timeout:
+                    p.kill()
+                    pid, wait_status, rusage = os.wait4(p.pid, 0)
+                    return { "status" : "timeout" }
+                else:
+                    time.sleep(0.1)
+            wall_seconds = time.time() - start
+
+        if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+            return { "status" : "failed" }
+
+        stats = parse_stats(os.path.join(output_dir, "stats.txt"))
+        host_seconds = stats.get("host_seconds", wall_seconds)
+        sim_insts = stats.get("sim_insts", 0)
+        sim_events = stats.get("sim_events", 0)
+
+        def rate(count):
+            return count / host_seconds if host_seconds > 0 else 0.0
+
+        return {
+            "status" : "ok",
+            "wall_seconds" : wall_seconds,
+            "host_seconds" : host_seconds,
+            "sim_insts" : sim_insts,
+            "sim_events" : sim_events,
+            "events_per_second" : rate(sim_events),
+            "insts_per_second" : rate(sim_insts),
+            # Linux reports kilobytes, macOS bytes
+            "peak_rss_kb" : rusage.ru_maxrss if platform.system() != "Darwin"
+                            else rusage.ru_maxrss // 1024,
+        }
+
+_stat_re = re.compile(r"^(\S+)\s+(\S+)")
+
+def parse_stats(path):
+    """Get the global statistics of the last dump in a stats file"""
+
+    stats = {}
+    try:
+        with open(path) as f:
+            for line in f:
+                if line.startswith("---------- Begin"):
+                    stats = {}
+                    continue
+
+                m = _stat_re.match(line)
+                if not m or "." in m.group(1):
+                    continue
+
+                try:
+                    stats[m.group(1)] = float(m.group(2))
+                except ValueError:
+                    pass
+    except IOError:
+        pass
+
+    return stats
+
+def get_benchmarks(isa, workload, max_insts, kvm=True):
+    """Get the benchmark suite for an ISA.
+
+    The SE-mode benchmarks run one copy of the workload per core and
+    stop when a core has executed max_insts instructions. The KVM
+    benchmark boots the default full-system kernel and disk image
+    (see M5_PATH) and runs for max_insts instructions.
+    """
+
+    benchmarks = []
+    for cpu_name, cpu_type in cpu_types.items():
+        for mem_name, mem_args in mem_systems.items():
+            for cores in core_counts:
+                benchmarks.append(Benchmark(
+                    "se/%s/%s/%i" % (cpu_name, mem_name, cores),
+                    "configs/example/se.py",
+                    [ "--cpu-type", cpu_type,
+                      "--num-cpus", str(cores),
+                      "--cmd", ";".join([ workload ] * cores),
+                      "--maxinsts", str(max_insts) ] + mem_args))
+
+    if kvm and isa in kvm_cpu_types:
+        benchmarks.append(Benchmark(
+            "fs/kvm/classic/1",
+            "configs/example/fs.py",
+            [ "--cpu-type", kvm_cpu_types[isa],
+              "--maxinsts", str(max_insts) ]))
+
+    return benchmarks
+
+def default_workload(isa):
+    return os.path.join(_gem5_base, "tests", "test-progs", "hello", "bin",
+                        isa, "linux", "hello")
+
+def make_report(gem5, results):
+    """Wrap benchmark results in a report with host information."""
+
+    return OrderedDict([
+        ("gem5", os.path.abspath(gem5)),
+        ("host", platform.node()),
+        ("machine", platform.machine()),
+        ("date", time.strftime("%Y-%m-%dT%H:%M:%S")),
+        ("benchmarks", results),
+    ])
+
+def load_report(f):
+    return json.load(f, object_pairs_hook=OrderedDict)
+
+def compare_reports(baseline, current, threshold):
+    """Compare two reports.
+
+    Return a list of (benchmark, metric, baseline value, current
+    value, relative change, regressed) tuples, where a positive
+    change is an improvement. A metric regressed if it got worse by
+    more than threshold percent.
+    """
+
+    changes = []
+    base_results = baseline["benchmarks"]
+    for name, result in current["benchmarks"].items():
+        base = base_results.get(name)
+        if not base or base.get("status") != "ok" or \
+           result.get("status") != "ok":
+            continue
+
+        for metric, larger_is_better in metrics.items():
+            old, new = base.get(metric), result.get(metric)
+            if not old or new is None:
+                continue
+
+            if larger_is_better:
+                change = (new - old) / float(old)
+            else:
+                change = (old - new) / float(old)
+            changes.append((name, metric, old, new, change * 100,
+                            change * 100 < -threshold))
+
+    return changes
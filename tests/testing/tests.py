@@ -140,6 +140,7 @@ arch_configs = {
 generic_configs = (
     'simple-atomic',
     'simple-atomic-mp',
+    'simple-atomic-mq',
     'simple-timing',
     'simple-timing-mp',
 
@@ -157,6 +158,7 @@ generic_configs = (
     'tgen-simple-mem',
     'tgen-dram-ctrl',
     'dram-lowp',
+    'dram-shared-ctrl',
 
     'learning-gem5-p1-simple',
     'learning-gem5-p1-two-level',
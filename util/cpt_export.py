@@ -0,0 +1,95 @@
+#!/usr/bin/env python2
+
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Export a checkpoint written with --checkpoint-format=binary as the
+# INI text that gem5 writes by default, e.g., to inspect it or to run
+# util/cpt_upgrader.py on it. gem5 restores checkpoints in either
+# format.
+#
+#   util/cpt_export.py m5out/cpt.1000/m5.cpt > m5.cpt.ini
+
+import struct
+import sys
+
+MAGIC = "gem5cpt\0"
+VERSION = 1
+
+def read_string(f):
+    length, = struct.unpack("=I", f.read(4))
+    return f.read(length)
+
+def read_element(f, kind):
+    if kind == "i":
+        return str(struct.unpack("=q", f.read(8))[0])
+    elif kind == "u":
+        return str(struct.unpack("=Q", f.read(8))[0])
+    elif kind == "d":
+        return repr(struct.unpack("=d", f.read(8))[0])
+    elif kind == "b":
+        return "true" if ord(f.read(1)) else "false"
+    elif kind == "s":
+        return read_string(f)
+    raise ValueError("unknown value type '%s'" % kind)
+
+def export(f, out):
+    if f.read(len(MAGIC)) != MAGIC:
+        raise ValueError("not a binary gem5 checkpoint")
+    version, = struct.unpack("=I", f.read(4))
+    if version != VERSION:
+        raise ValueError("unsupported version %d" % version)
+
+    while True:
+        record = f.read(1)
+        if not record:
+            break
+        elif record == "S":
+            out.write("\n[%s]\n" % read_string(f))
+        elif record == "E":
+            name = read_string(f)
+            kind = f.read(1)
+            if kind.isupper():
+                count, = struct.unpack("=I", f.read(4))
+                values = [ read_element(f, kind.lower())
+                           for i in range(count) ]
+            else:
+                values = [ read_element(f, kind) ]
+            out.write("%s=%s\n" % (name, " ".join(values)))
+        else:
+            raise ValueError("unknown record type '%s' at offset %d" %
+                             (record, f.tell() - 1))
+
+def main():
+    if len(sys.argv) != 2:
+        print >>sys.stderr, "Usage: %s <binary m5.cpt>" % sys.argv[0]
+        sys.exit(1)
+
+    with open(sys.argv[1], "rb") as f:
+        export(f, sys.stdout)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,154 @@
+#!/usr/bin/env python2
+
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Decode a binary debug trace written with --debug-format=binary into
+# the text that the default debug logger would have printed:
+#
+#   util/decode_binary_trace.py m5out/trace.bin > trace.txt
+#
+# Each DPRINTF format string is stored once, and every message only
+# holds its raw arguments, so the cprintf format strings are applied
+# here instead.
+
+import re
+import struct
+import sys
+
+MAGIC = "gem5trc\0"
+VERSION = 1
+MAX_TICK = 2**64 - 1
+
+# A cprintf conversion: flags, width, precision, length and type
+CONVERSION = re.compile(r"%([-#0 +]*)(\d*)(?:\.(\d+))?(?:hh|h|ll|l|q|z|j|t|L)?"
+                        r"([a-zA-Z%])")
+
+def read_string(f):
+    length, = struct.unpack("=I", f.read(4))
+    return f.read(length)
+
+def read_arg(f):
+    tag = f.read(1)
+    if tag == "i":
+        return tag, struct.unpack("=q", f.read(8))[0]
+    elif tag in "up":
+        return tag, struct.unpack("=Q", f.read(8))[0]
+    elif tag == "f":
+        return tag, struct.unpack("=d", f.read(8))[0]
+    elif tag == "c":
+        return tag, f.read(1)
+    elif tag == "s":
+        return tag, read_string(f)
+    raise ValueError("unknown argument type '%s'" % tag)
+
+def format_arg(spec, tag, value):
+    flags, width, prec, conv = spec
+    prefix = "%" + flags + width + ("." + prec if prec else "")
+
+    if tag in "iu":
+        if conv in "dixXo":
+            return (prefix + ("d" if conv == "i" else conv)) % value
+        elif conv == "c":
+            return (prefix + "c") % chr(value & 0xff)
+        elif conv in "eEfFgG":
+            return (prefix + conv) % value
+    elif tag == "p":
+        if conv in "xX":
+            return (prefix + conv) % value
+        return (prefix + "s") % ("0x%x" % value)
+    elif tag == "f":
+        if conv in "eEfFgG":
+            return (prefix + conv) % value
+        elif conv in "dixX":
+            return (prefix + "d") % int(value)
+    elif tag == "c":
+        if conv in "dixXo":
+            return (prefix + ("d" if conv == "i" else conv)) % ord(value)
+        return (prefix + "c") % value
+
+    return (prefix + "s") % (value, )
+
+def format_message(fmt, args):
+    out = []
+    pos = 0
+    args = iter(args)
+    for m in CONVERSION.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        if m.group(4) == "%":
+            out.append("%")
+            continue
+        try:
+            tag, value = next(args)
+        except StopIteration:
+            out.append("<missing arg for format>")
+            continue
+        out.append(format_arg(m.groups(""), tag, value))
+    out.append(fmt[pos:])
+    return "".join(out)
+
+def decode(f, out):
+    if f.read(len(MAGIC)) != MAGIC:
+        raise ValueError("not a gem5 binary trace")
+    version, = struct.unpack("=I", f.read(4))
+    if version != VERSION:
+        raise ValueError("unsupported version %d" % version)
+
+    sites = {}
+    names = { 0 : "" }
+    while True:
+        kind = f.read(1)
+        if not kind:
+            break
+        elif kind == "S":
+            site, = struct.unpack("=I", f.read(4))
+            sites[site] = read_string(f)
+        elif kind == "N":
+            name, = struct.unpack("=I", f.read(4))
+            names[name] = read_string(f)
+        elif kind == "M":
+            when, site, name, nargs = struct.unpack("=QIIB", f.read(17))
+            args = [ read_arg(f) for i in range(nargs) ]
+            if when != MAX_TICK:
+                out.write("%7d: " % when)
+            if names[name]:
+                out.write(names[name] + ": ")
+            out.write(format_message(sites[site], args))
+        else:
+            raise ValueError("unknown record type '%s' at offset %d" %
+                             (kind, f.tell() - 1))
+
+def main():
+    if len(sys.argv) != 2:
+        print >>sys.stderr, "Usage: %s <binary trace>" % sys.argv[0]
+        sys.exit(1)
+
+    with open(sys.argv[1], "rb") as f:
+        decode(f, sys.stdout)
+
+if __name__ == "__main__":
+    main()
@@ -43,7 +43,9 @@
 # generated the Python package for the inst messages. This can
 # be done manually using:
 # protoc --python_out=. inst.proto
-# The ASCII trace format uses one line per request.
+# The ASCII trace format uses one line per request. Instructions
+# traced with their complete encoding (x86) show it as hex bytes, ready
+# to be passed to an offline disassembler.
 
 import protolib
 import sys
@@ -101,7 +103,7 @@ def main():
     print "Tick frequency:", header.tick_freq
     print "Memory addresses included:", header.has_mem
 
-    if header.ver != 0:
+    if header.ver > 1:
         print "Warning: file version newer than decoder:", header.ver
         print "This decoder may not understand how to decode this file"
 
@@ -132,12 +134,24 @@ def main():
         ascii_out.write('%-20d: (%03d/%03d) %#010x @ %#016x ' % (tick, node_id, cpu_id,
                                                   inst.inst, inst.pc))
 
+        if inst.HasField('upc'):
+            ascii_out.write('.%-3d ' % inst.upc)
+
+        if inst.HasField('inst_bytes'):
+            ascii_out.write(' [%s]' % ' '.join('%02x' % ord(b)
+                                               for b in inst.inst_bytes))
+
         if inst.HasField('type'):
             ascii_out.write(' : %10s' % inst_pb2._INST_INSTTYPE.values_by_number[inst.type].name)
 
         for mem_acc in inst.mem_access:
             ascii_out.write(" %#x-%#x;" % (mem_acc.addr, mem_acc.addr + mem_acc.size))
 
+        for reg in inst.reg_write:
+            ascii_out.write(' r%d.%d' % (reg.reg_class, reg.reg_index))
+            if reg.HasField('value'):
+                ascii_out.write('=%#x' % reg.value)
+
         ascii_out.write('\n')
         num_insts += 1
 
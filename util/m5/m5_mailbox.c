@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <gem5/asm/generic/m5ops.h>
+#include <gem5/m5_mailbox.h>
+#include <gem5/m5ops.h>
+
+#include "m5_mailbox.h"
+
+static struct m5_mailbox_header *mailbox = NULL;
+static size_t mailbox_size = 0;
+
+static struct m5_mailbox_entry *
+mailbox_entries()
+{
+    return (struct m5_mailbox_entry *)(mailbox + 1);
+}
+
+static uint64_t *
+mailbox_counters()
+{
+    return (uint64_t *)(mailbox_entries() + mailbox->num_entries);
+}
+
+int
+m5_mailbox_open(uint64_t paddr)
+{
+    int fd = open("/dev/mem", O_RDWR | O_SYNC);
+    if (fd == -1) {
+        perror("Can't open /dev/mem");
+        return -1;
+    }
+
+    // Map the header first to find out how big the mailbox is.
+    size_t page = sysconf(_SC_PAGESIZE);
+    void *hdr = mmap(NULL, page, PROT_READ, MAP_SHARED, fd, paddr);
+    if (hdr == MAP_FAILED) {
+        perror("Can't mmap the m5 mailbox");
+        close(fd);
+        return -1;
+    }
+
+    const struct m5_mailbox_header *h = hdr;
+    if (h->magic != M5_MAILBOX_MAGIC || h->version != M5_MAILBOX_VERSION) {
+        fprintf(stderr, "No m5 mailbox at %#llx\n",
+                (unsigned long long)paddr);
+        munmap(hdr, page);
+        close(fd);
+        return -1;
+    }
+    size_t size = sizeof(struct m5_mailbox_header) +
+        h->num_entries * sizeof(struct m5_mailbox_entry) +
+        h->num_counters * sizeof(uint64_t);
+    munmap(hdr, page);
+
+    void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                     paddr);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        perror("Can't mmap the m5 mailbox");
+        return -1;
+    }
+
+    mailbox = mem;
+    mailbox_size = size;
+    return 0;
+}
+
+void
+m5_mailbox_close(void)
+{
+    if (mailbox) {
+        munmap(mailbox, mailbox_size);
+        mailbox = NULL;
+    }
+}
+
+/* Returns 0 if the op couldn't be posted and must be issued directly */
+static int
+mailbox_post(uint32_t op, uint64_t arg0, uint64_t arg1)
+{
+    if (!mailbox)
+        return 0;
+
+    uint64_t slot = __atomic_load_n(&mailbox->head, __ATOMIC_RELAXED);
+    do {
+        uint64_t tail = __atomic_load_n(&mailbox->tail, __ATOMIC_ACQUIRE);
+        if (slot - tail >= mailbox->num_entries)
+            return 0;
+    } while (!__atomic_compare_exchange_n(&mailbox->head, &slot, slot + 1,
+                                          1, __ATOMIC_ACQ_REL,
+                                          __ATOMIC_RELAXED));
+
+    struct m5_mailbox_entry *entry =
+        &mailbox_entries()[slot % mailbox->num_entries];
+    int cpu = sched_getcpu();
+    entry->op = op;
+    entry->context = cpu < 0 ? 0 : cpu;
+    entry->args[0] = arg0;
+    entry->args[1] = arg1;
+    __atomic_store_n(&entry->seq, slot + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+void
+m5_mailbox_work_begin(uint64_t workid, uint64_t threadid)
+{
+    if (!mailbox_post(M5OP_WORK_BEGIN, workid, threadid))
+        m5_work_begin(workid, threadid);
+}
+
+void
+m5_mailbox_work_end(uint64_t workid, uint64_t threadid)
+{
+    if (!mailbox_post(M5OP_WORK_END, workid, threadid))
+        m5_work_end(workid, threadid);
+}
+
+void
+m5_mailbox_region_begin(uint64_t regionid)
+{
+    if (!mailbox_post(M5OP_REGION_BEGIN, regionid, 0))
+        m5_region_begin(regionid);
+}
+
+void
+m5_mailbox_region_end(uint64_t regionid)
+{
+    if (!mailbox_post(M5OP_REGION_END, regionid, 0))
+        m5_region_end(regionid);
+}
+
+void
+m5_mailbox_counter_add(unsigned counter, uint64_t delta)
+{
+    if (mailbox && counter < mailbox->num_counters)
+        __atomic_fetch_add(&mailbox_counters()[counter], delta,
+                           __ATOMIC_RELAXED);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __UTIL_M5_MAILBOX_H__
+#define __UTIL_M5_MAILBOX_H__
+
+#include <stdint.h>
+
+/*
+ * Guest side of the gem5 m5op mailbox (an M5Mailbox device). Posting
+ * to the mailbox is a handful of ordinary memory accesses, so it does
+ * not trap into gem5 even under KVM. If the mailbox isn't open or its
+ * ring is full, the markers fall back to the regular m5ops.
+ */
+
+/* Map the mailbox at physical address paddr; returns 0 on success */
+int m5_mailbox_open(uint64_t paddr);
+void m5_mailbox_close(void);
+
+void m5_mailbox_work_begin(uint64_t workid, uint64_t threadid);
+void m5_mailbox_work_end(uint64_t workid, uint64_t threadid);
+void m5_mailbox_region_begin(uint64_t regionid);
+void m5_mailbox_region_end(uint64_t regionid);
+
+/* Add delta to one of the mailbox's counters; ignored if not open */
+void m5_mailbox_counter_add(unsigned counter, uint64_t delta);
+
+#endif
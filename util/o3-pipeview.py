@@ -37,12 +37,14 @@
 #
 # Authors: Giacomo Gabrielli
 
-# Pipeline activity viewer for the O3 CPU model.
+# Pipeline activity viewer for the O3 CPU model. It reads either the text
+# output of the O3PipeView debug flag or the binary trace of an O3PipeTrace
+# or MinorPipeTrace probe listener, which is much faster to write and read.
 
 import optparse
 import os
+import protolib
 import sys
-import copy
 
 # Temporary storage for instructions. The queue is filled in out-of-order
 # until it reaches 'max_threshold' number of instructions. It is then
@@ -106,22 +108,7 @@ def process_trace(trace, outfile, cycle_time, width, color, timestamps,
         if not line: return
         fields = line.split(':')
 
-    # Print header
-    outfile.write('// f = fetch, d = decode, n = rename, p = dispatch, '
-                  'i = issue, c = complete, r = retire')
-
-    if store_completions:
-        outfile.write(', s = store-complete')
-    outfile.write('\n\n')
-
-    outfile.write(' ' + 'timeline'.center(width) +
-                  '   ' + 'tick'.center(15) +
-                  '  ' + 'pc.upc'.center(12) +
-                  '  ' + 'disasm'.ljust(25) +
-                  '  ' + 'seq_num'.center(10))
-    if timestamps:
-        outfile.write('timestamps'.center(25))
-    outfile.write('\n')
+    print_header(outfile, width, timestamps, store_completions)
 
     # Region of interest
     curr_inst = {}
@@ -131,7 +118,8 @@ def process_trace(trace, outfile, cycle_time, width, color, timestamps,
             if fields[1] == 'fetch':
                 if ((stop_tick > 0 and int(fields[2]) > stop_tick+insts['tick_drift']) or
                     (stop_sn > 0 and int(fields[5]) > (stop_sn+insts['max_threshold']))):
-                    print_insts(outfile, cycle_time, width, color, timestamps, 0)
+                    print_insts(outfile, cycle_time, width, color, timestamps,
+                                store_completions, 0)
                     return
                 (curr_inst['pc'], curr_inst['upc']) = fields[3:5]
                 curr_inst['sn'] = int(fields[5])
@@ -150,6 +138,105 @@ def process_trace(trace, outfile, cycle_time, width, color, timestamps,
         fields = line.split(':')
 
 
+def read_binary_trace(trace):
+    # Import the pipeline trace proto definitions. If they are not found,
+    # attempt to generate them automatically. This assumes that the script
+    # is executed from the gem5 root.
+    try:
+        import pipe_trace_pb2
+    except:
+        print "Did not find proto definition, attempting to generate"
+        from subprocess import call
+        error = call(['protoc', '--python_out=util', '--proto_path=src/proto',
+                      'src/proto/pipe_trace.proto'])
+        if not error:
+            import pipe_trace_pb2
+            print "Generated proto definitions for the pipeline trace"
+        else:
+            print "Failed to import proto definitions"
+            exit(-1)
+
+    header = pipe_trace_pb2.PipeTraceHeader()
+    if not protolib.decodeMessage(trace, header):
+        return
+
+    # Every pc.upc is disassembled once, in the first block it appears in
+    disasm = {}
+    stages = ('decode', 'rename', 'dispatch', 'issue', 'complete', 'retire',
+              'store')
+    block = pipe_trace_pb2.PipeTraceBlock()
+    while protolib.decodeMessage(trace, block):
+        for pc, upc, text in zip(block.disasm_pc, block.disasm_upc,
+                                 block.disasm):
+            disasm[(pc, upc)] = ' '.join(text.split())
+
+        columns = [getattr(block, stage) for stage in stages]
+        sn = pc = fetch = 0
+        for i in xrange(len(block.seq_num)):
+            sn += block.seq_num[i]
+            pc += block.pc[i]
+            fetch += block.fetch[i]
+            upc = block.upc[i]
+            inst = {'sn': sn, 'pc': '0x%08x' % pc, 'upc': str(upc),
+                    'fetch': fetch, 'disasm': disasm[(pc, upc)]}
+            # Stage ticks are stored as offsets from fetch plus one
+            for stage, column in zip(stages, columns):
+                offset = column[i]
+                inst[stage] = fetch + offset - 1 if offset else 0
+            if inst['retire'] == 0:
+                inst['disasm'] = '-----' + inst['disasm']
+            yield inst
+
+
+def process_binary_trace(trace, outfile, cycle_time, width, color, timestamps,
+                         committed_only, store_completions, start_tick,
+                         stop_tick, start_sn, stop_sn):
+    global insts
+
+    insts['sn_start'] = start_sn
+    insts['sn_stop'] = stop_sn
+    insts['tick_start'] = start_tick
+    insts['tick_stop'] = stop_tick
+    insts['tick_drift'] = insts['tick_drift'] * cycle_time
+    insts['only_committed'] = committed_only
+
+    print_header(outfile, width, timestamps, store_completions)
+
+    for inst in read_binary_trace(trace):
+        # Records are roughly in sequence number order, so anything outside
+        # of the region of interest is dropped before it is queued.
+        if ((stop_tick > 0 and inst['fetch'] > stop_tick+insts['tick_drift']) or
+            (stop_sn > 0 and inst['sn'] > stop_sn+insts['max_threshold'])):
+            break
+        if ((start_tick > 0 and inst['fetch'] < start_tick) or
+            (start_sn > 0 and inst['sn'] < start_sn) or
+            (committed_only and inst['retire'] == 0)):
+            continue
+        queue_inst(outfile, inst, cycle_time, width, color, timestamps,
+                   store_completions)
+
+    print_insts(outfile, cycle_time, width, color, timestamps,
+                store_completions, 0)
+
+
+def print_header(outfile, width, timestamps, store_completions):
+    outfile.write('// f = fetch, d = decode, n = rename, p = dispatch, '
+                  'i = issue, c = complete, r = retire')
+
+    if store_completions:
+        outfile.write(', s = store-complete')
+    outfile.write('\n\n')
+
+    outfile.write(' ' + 'timeline'.center(width) +
+                  '   ' + 'tick'.center(15) +
+                  '  ' + 'pc.upc'.center(12) +
+                  '  ' + 'disasm'.ljust(25) +
+                  '  ' + 'seq_num'.center(10))
+    if timestamps:
+        outfile.write('timestamps'.center(25))
+    outfile.write('\n')
+
+
 #Sorts out instructions according to sequence number
 def compare_by_sn(a, b):
     return cmp(a['sn'], b['sn'])
@@ -158,8 +245,7 @@ def compare_by_sn(a, b):
 # Sorts out and prints instructions when their number reaches threshold value
 def queue_inst(outfile, inst, cycle_time, width, color, timestamps, store_completions):
     global insts
-    l_copy = copy.deepcopy(inst)
-    insts['queue'].append(l_copy)
+    insts['queue'].append(dict(inst))
     if len(insts['queue']) > insts['max_threshold']:
         print_insts(outfile, cycle_time, width, color, timestamps, store_completions, insts['min_threshold'])
 
@@ -359,14 +445,21 @@ def main():
     if not inst_range:
         parser.error('invalid range')
         sys.exit(1)
-    # Process trace
+    # Process trace, binary traces start with the protobuf stream magic
     print 'Processing trace... ',
-    with open(args[0], 'r') as trace:
+    trace = protolib.openFileRd(args[0])
+    if trace.read(4) == 'gem5':
+        process = process_binary_trace
+    else:
+        trace.close()
+        trace = open(args[0], 'r')
+        process = process_trace
+    with trace:
         with open(options.outfile, 'w') as out:
-            process_trace(trace, out, options.cycle_time, options.width,
-                          options.color, options.timestamps,
-                          options.only_committed, options.store_completions,
-                          *(tick_range + inst_range))
+            process(trace, out, options.cycle_time, options.width,
+                    options.color, options.timestamps,
+                    options.only_committed, options.store_completions,
+                    *(tick_range + inst_range))
     print 'done!'
 
 
@@ -0,0 +1,91 @@
+#!/usr/bin/env python2
+
+# Copyright (c) 2018 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+# Read the binary stats written by a binary:// stat visitor.
+#
+# Used as a module, read(path) returns a pandas DataFrame with one row
+# per stats dump and one column per stat value, or a pair of the
+# column names and a 2D numpy array if pandas isn't available. Used as
+# a script, it converts the file to CSV:
+#
+#   util/read_stats_binary.py m5out/stats.bin > stats.csv
+
+import struct
+import sys
+
+import numpy
+
+MAGIC = "gem5stat"
+VERSION = 1
+
+def read_columns(path):
+    """Return the column names and the offset of the first row."""
+    with open(path, "rb") as f:
+        if f.read(len(MAGIC)) != MAGIC:
+            raise ValueError("%s isn't a gem5 binary stats file" % path)
+        version, num_columns = struct.unpack("=II", f.read(8))
+        if version != VERSION:
+            raise ValueError("%s: unsupported version %d" % (path, version))
+        columns = []
+        for i in range(num_columns):
+            length, = struct.unpack("=I", f.read(4))
+            columns.append(f.read(length))
+        return columns, f.tell()
+
+def read_array(path):
+    """Return the column names and a (dumps x columns) array."""
+    columns, offset = read_columns(path)
+    with open(path, "rb") as f:
+        f.seek(offset)
+        data = numpy.fromfile(f, dtype=numpy.float64)
+    # A dump may have been cut short if the simulation was killed
+    num_rows = len(data) // max(len(columns), 1)
+    return columns, data[:num_rows * len(columns)].reshape(
+        num_rows, len(columns))
+
+def read(path):
+    columns, data = read_array(path)
+    try:
+        import pandas
+    except ImportError:
+        return columns, data
+    return pandas.DataFrame(data, columns=columns)
+
+def main():
+    if len(sys.argv) != 2:
+        print "Usage: %s <stats.bin>" % sys.argv[0]
+        sys.exit(1)
+
+    columns, data = read_array(sys.argv[1])
+    print ",".join(columns)
+    for row in data:
+        print ",".join(repr(value) for value in row)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2018 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Pick simulation points from basic block vectors recorded by the
+ * gem5 SimPoint probe.
+ *
+ * Follows the SimPoint 3 method: each interval's BBV is normalised,
+ * randomly projected to a few dimensions and clustered with k-means
+ * for every k up to a limit, trying several random seeds per k. The
+ * smallest k whose BIC score reaches a fraction of the best score is
+ * chosen, and the interval closest to each centroid represents its
+ * cluster. The (k, seed) runs are independent and are spread over a
+ * pool of threads.
+ *
+ * Reads both the binary BBV format (SimPoint.binary_output) and the
+ * text format, optionally gzip compressed. Writes <prefix>.simpoints
+ * and <prefix>.weights in the format --take-simpoint-checkpoints
+ * expects.
+ */
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+
+namespace {
+
+const char binaryMagic[8] = {'g', 'e', 'm', '5', 'b', 'b', 'v', '\0'};
+const uint32_t binaryVersion = 1;
+
+/** One interval: (basic block id, instruction count) pairs */
+typedef std::vector<std::pair<uint32_t, uint64_t>> Bbv;
+typedef std::vector<double> Point;
+
+struct Options
+{
+    std::string input;
+    std::string prefix = "simpoint";
+    int maxK = 30;
+    int dims = 15;
+    int seeds = 5;
+    int iterations = 100;
+    int threads = 0;
+    double bicThreshold = 0.9;
+    uint64_t seed = 493575226;
+};
+
+void
+usage(const char *prog)
+{
+    std::cerr <<
+        "usage: " << prog << " [options] <bbv file>\n"
+        "  -o PREFIX  write PREFIX.simpoints and PREFIX.weights"
+        " [simpoint]\n"
+        "  -k N       largest number of clusters to try [30]\n"
+        "  -d N       dimensions to project the BBVs to [15]\n"
+        "  -n N       random initialisations per k [5]\n"
+        "  -i N       maximum k-means iterations [100]\n"
+        "  -j N       worker threads [number of cores]\n"
+        "  -b F       pick the smallest k scoring F of the best BIC [0.9]\n"
+        "  -s N       random seed\n";
+    exit(1);
+}
+
+/** Read exactly len bytes, returning false at a clean end of file */
+bool
+readExact(gzFile f, void *buf, unsigned len)
+{
+    int got = gzread(f, buf, len);
+    if (got == 0)
+        return false;
+    if (got != (int)len) {
+        std::cerr << "error: truncated BBV file\n";
+        exit(1);
+    }
+    return true;
+}
+
+void
+readBinary(gzFile f, std::vector<Bbv> &bbvs)
+{
+    uint32_t version;
+    if (!readExact(f, &version, sizeof(version)) ||
+        version != binaryVersion) {
+        std::cerr << "error: unsupported binary BBV version\n";
+        exit(1);
+    }
+
+    uint32_t entries;
+    while (readExact(f, &entries, sizeof(entries))) {
+        Bbv bbv(entries);
+        for (auto &e : bbv) {
+            if (!readExact(f, &e.first, sizeof(e.first)) ||
+                !readExact(f, &e.second, sizeof(e.second))) {
+                std::cerr << "error: truncated BBV file\n";
+                exit(1);
+            }
+        }
+        bbvs.push_back(std::move(bbv));
+    }
+}
+
+void
+readText(gzFile f, std::vector<Bbv> &bbvs)
+{
+    // Lines look like "T:id:count :id:count ...".
+    std::string line;
+    char buf[4096];
+    while (gzgets(f, buf, sizeof(buf))) {
+        line += buf;
+        if (line.back() != '\n' && !gzeof(f))
+            continue;
+
+        if (!line.empty() && line[0] == 'T') {
+            Bbv bbv;
+            const char *p = line.c_str() + 1;
+            unsigned long id;
+            unsigned long long count;
+            int n;
+            while (sscanf(p, " :%lu:%llu%n", &id, &count, &n) == 2) {
+                bbv.emplace_back(id, count);
+                p += n;
+            }
+            bbvs.push_back(std::move(bbv));
+        }
+        line.clear();
+    }
+}
+
+std::vector<Bbv>
+readBbvs(const std::string &name)
+{
+    gzFile f = gzopen(name.c_str(), "rb");
+    if (!f) {
+        std::cerr << "error: cannot open " << name << "\n";
+        exit(1);
+    }
+
+    std::vector<Bbv> bbvs;
+    char magic[sizeof(binaryMagic)];
+    if (gzread(f, magic, sizeof(magic)) == sizeof(magic) &&
+        memcmp(magic, binaryMagic, sizeof(magic)) == 0) {
+        readBinary(f, bbvs);
+    } else {
+        gzrewind(f);
+        readText(f, bbvs);
+    }
+    gzclose(f);
+    return bbvs;
+}
+
+/**
+ * Entry of the random projection matrix for basic block id and output
+ * dimension d, uniform in [-1, 1]. Computed from a hash rather than
+ * stored, since block ids are unbounded.
+ */
+double
+projection(uint64_t seed, uint32_t id, int d)
+{
+    uint64_t h = seed ^ (uint64_t(id) << 16) ^ uint64_t(d);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return (h >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+}
+
+std::vector<Point>
+project(const std::vector<Bbv> &bbvs, int dims, uint64_t seed)
+{
+    std::vector<Point> points(bbvs.size(), Point(dims, 0.0));
+    for (size_t i = 0; i < bbvs.size(); ++i) {
+        double total = 0;
+        for (const auto &e : bbvs[i])
+            total += e.second;
+        if (total == 0)
+            continue;
+        for (const auto &e : bbvs[i]) {
+            double w = e.second / total;
+            for (int d = 0; d < dims; ++d)
+                points[i][d] += w * projection(seed, e.first, d);
+        }
+    }
+    return points;
+}
+
+double
+distance2(const Point &a, const Point &b)
+{
+    double sum = 0;
+    for (size_t d = 0; d < a.size(); ++d) {
+        double diff = a[d] - b[d];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+struct Clustering
+{
+    int k = 0;
+    std::vector<Point> centroids;
+    std::vector<int> assignment;
+    double distortion = std::numeric_limits<double>::infinity();
+    double bic = -std::numeric_limits<double>::infinity();
+};
+
+/** Bayesian information criterion of a clustering (Pelleg & Moore) */
+double
+bicScore(const std::vector<Point> &points, const Clustering &c)
+{
+    const double r = points.size();
+    const double m = points[0].size();
+    const int k = c.k;
+    if (r <= k)
+        return -std::numeric_limits<double>::infinity();
+
+    std::vector<double> sizes(k, 0);
+    for (int a : c.assignment)
+        sizes[a]++;
+
+    double variance = c.distortion / (r - k);
+    if (variance <= 0)
+        variance = std::numeric_limits<double>::min();
+
+    double loglik = 0;
+    for (int j = 0; j < k; ++j) {
+        double rn = sizes[j];
+        if (rn == 0)
+            continue;
+        loglik += rn * std::log(rn) - rn * std::log(r) -
+            rn / 2 * std::log(2 * M_PI) - rn * m / 2 * std::log(variance) -
+            (rn - k) / 2;
+    }
+    double params = (k - 1) + m * k + 1;
+    return loglik - params / 2 * std::log(r);
+}
+
+/** Lloyd's k-means from a k-means++ initialisation */
+Clustering
+kmeans(const std::vector<Point> &points, int k, int iterations,
+       uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    const size_t n = points.size();
+
+    Clustering c;
+    c.k = k;
+    c.assignment.assign(n, 0);
+
+    std::vector<double> nearest(n, std::numeric_limits<double>::max());
+    c.centroids.push_back(points[rng() % n]);
+    while (c.centroids.size() < (size_t)k) {
+        double total = 0;
+        for (size_t i = 0; i < n; ++i) {
+            nearest[i] = std::min(nearest[i],
+                                  distance2(points[i], c.centroids.back()));
+            total += nearest[i];
+        }
+        if (total == 0)
+            break;
+        double pick = std::uniform_real_distribution<double>(0, total)(rng);
+        size_t i = 0;
+        for (; i < n - 1 && pick >= nearest[i]; ++i)
+            pick -= nearest[i];
+        c.centroids.push_back(points[i]);
+    }
+    c.k = k = c.centroids.size();
+
+    const int dims = points[0].size();
+    for (int iter = 0; iter < iterations; ++iter) {
+        bool changed = false;
+        c.distortion = 0;
+        for (size_t i = 0; i < n; ++i) {
+            int best = 0;
+            double best_dist = std::numeric_limits<double>::max();
+            for (int j = 0; j < k; ++j) {
+                double dist = distance2(points[i], c.centroids[j]);
+                if (dist < best_dist) {
+                    best_dist = dist;
+                    best = j;
+                }
+            }
+            if (best != c.assignment[i]) {
+                c.assignment[i] = best;
+                changed = true;
+            }
+            c.distortion += best_dist;
+        }
+        if (iter > 0 && !changed)
+            break;
+
+        std::vector<Point> sums(k, Point(dims, 0.0));
+        std::vector<size_t> sizes(k, 0);
+        for (size_t i = 0; i < n; ++i) {
+            int a = c.assignment[i];
+            sizes[a]++;
+            for (int d = 0; d < dims; ++d)
+                sums[a][d] += points[i][d];
+        }
+        for (int j = 0; j < k; ++j) {
+            if (!sizes[j])
+                continue;
+            for (int d = 0; d < dims; ++d)
+                c.centroids[j][d] = sums[j][d] / sizes[j];
+        }
+    }
+
+    c.bic = bicScore(points, c);
+    return c;
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+    Options opts;
+    int ch;
+    while ((ch = getopt(argc, argv, "o:k:d:n:i:j:b:s:")) != -1) {
+        switch (ch) {
+          case 'o': opts.prefix = optarg; break;
+          case 'k': opts.maxK = atoi(optarg); break;
+          case 'd': opts.dims = atoi(optarg); break;
+          case 'n': opts.seeds = atoi(optarg); break;
+          case 'i': opts.iterations = atoi(optarg); break;
+          case 'j': opts.threads = atoi(optarg); break;
+          case 'b': opts.bicThreshold = atof(optarg); break;
+          case 's': opts.seed = strtoull(optarg, NULL, 0); break;
+          default: usage(argv[0]);
+        }
+    }
+    if (optind != argc - 1 || opts.maxK < 1 || opts.dims < 1 ||
+        opts.seeds < 1) {
+        usage(argv[0]);
+    }
+    opts.input = argv[optind];
+    if (opts.threads <= 0)
+        opts.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<Bbv> bbvs = readBbvs(opts.input);
+    if (bbvs.empty()) {
+        std::cerr << "error: no intervals in " << opts.input << "\n";
+        return 1;
+    }
+    std::vector<Point> points = project(bbvs, opts.dims, opts.seed);
+    const int max_k = std::min<size_t>(opts.maxK, points.size());
+
+    // Every (k, seed) run is independent; hand them out to the workers
+    // and keep the lowest distortion run for each k.
+    const int jobs = max_k * opts.seeds;
+    std::vector<Clustering> runs(jobs);
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int job = next++; job < jobs; job = next++) {
+            int k = job / opts.seeds + 1;
+            uint64_t seed = opts.seed + 1 + job;
+            runs[job] = kmeans(points, k, opts.iterations, seed);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 0; t < opts.threads; ++t)
+        pool.emplace_back(worker);
+    for (auto &t : pool)
+        t.join();
+
+    std::vector<Clustering *> best(max_k + 1, nullptr);
+    for (int job = 0; job < jobs; ++job) {
+        int k = job / opts.seeds + 1;
+        if (!best[k] || runs[job].distortion < best[k]->distortion)
+            best[k] = &runs[job];
+    }
+
+    double min_bic = std::numeric_limits<double>::infinity();
+    double max_bic = -std::numeric_limits<double>::infinity();
+    for (int k = 1; k <= max_k; ++k) {
+        if (std::isinf(best[k]->bic))
+            continue;
+        min_bic = std::min(min_bic, best[k]->bic);
+        max_bic = std::max(max_bic, best[k]->bic);
+    }
+    const Clustering *chosen = best[1];
+    if (!std::isinf(min_bic)) {
+        double cutoff = min_bic + opts.bicThreshold * (max_bic - min_bic);
+        for (int k = 1; k <= max_k; ++k) {
+            if (!std::isinf(best[k]->bic) && best[k]->bic >= cutoff) {
+                chosen = best[k];
+                break;
+            }
+        }
+    }
+
+    // The representative of each cluster is the interval closest to
+    // its centroid.
+    const size_t n = points.size();
+    std::vector<int> rep(chosen->k, -1);
+    std::vector<double> rep_dist(chosen->k,
+                                 std::numeric_limits<double>::max());
+    std::vector<size_t> sizes(chosen->k, 0);
+    for (size_t i = 0; i < n; ++i) {
+        int a = chosen->assignment[i];
+        sizes[a]++;
+        double dist = distance2(points[i], chosen->centroids[a]);
+        if (dist < rep_dist[a]) {
+            rep_dist[a] = dist;
+            rep[a] = i;
+        }
+    }
+
+    std::ofstream simpoints(opts.prefix + ".simpoints");
+    std::ofstream weights(opts.prefix + ".weights");
+    if (!simpoints || !weights) {
+        std::cerr << "error: cannot write " << opts.prefix << ".*\n";
+        return 1;
+    }
+    for (int j = 0; j < chosen->k; ++j) {
+        if (rep[j] < 0)
+            continue;
+        simpoints << rep[j] << " " << j << "\n";
+        weights << double(sizes[j]) / n << " " << j << "\n";
+    }
+
+    std::cout << n << " intervals, " << chosen->k << " clusters (BIC "
+              << chosen->bic << ")\n";
+    return 0;
+}
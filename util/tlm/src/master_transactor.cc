@@ -40,11 +40,13 @@ namespace Gem5SystemC
 {
 
 Gem5MasterTransactor::Gem5MasterTransactor(sc_core::sc_module_name name,
-                                           const std::string& portName)
+                                           const std::string& portName,
+                                           bool allowDmi)
     : sc_core::sc_module(name),
       socket(portName.c_str()),
       sim_control("sim_control"),
-      portName(portName)
+      portName(portName),
+      dmiAllowed(allowDmi)
 {
     if (portName.empty()) {
         SC_REPORT_ERROR(name, "No port name specified!\n");
@@ -56,11 +56,23 @@ class Gem5MasterTransactor : public sc_core::sc_module
   private:
     std::string portName;
 
+    bool dmiAllowed;
+
   public:
     SC_HAS_PROCESS(Gem5MasterTransactor);
 
+    /**
+     * @param name Name of the SystemC module
+     * @param portName Name of the gem5 external master port to bind to
+     * @param allowDmi Grant initiators direct access to the gem5
+     *        backing store. This bypasses the gem5 memory system, so it
+     *        is only safe if no gem5 cache holds data of the memory.
+     */
     Gem5MasterTransactor(sc_core::sc_module_name name,
-                         const std::string& portName);
+                         const std::string& portName,
+                         bool allowDmi = false);
+
+    bool isDmiAllowed() const { return dmiAllowed; }
 
     void before_end_of_elaboration();
 };
@@ -127,6 +127,8 @@ SCMasterPort::bindToTransactor(Gem5MasterTransactor* transactor)
 
     transactor->socket.register_transport_dbg(this,
                                               &SCMasterPort::transport_dbg);
+    transactor->socket.register_get_direct_mem_ptr(this,
+                                        &SCMasterPort::get_direct_mem_ptr);
 }
 
 void
@@ -286,6 +288,10 @@ SCMasterPort::b_transport(tlm::tlm_generic_payload& trans,
     if (extension != nullptr)
         destroyPacket(pkt);
 
+    // hint the initiator that it may bypass the transport interface
+    if (transactor->isDmiAllowed() && findBackingStore(trans.get_address()))
+        trans.set_dmi_allowed(true);
+
     trans.set_response_status(tlm::TLM_OK_RESPONSE);
 }
 
@@ -309,11 +315,41 @@ SCMasterPort::transport_dbg(tlm::tlm_generic_payload& trans)
     return trans.get_data_length();
 }
 
+const BackingStoreEntry*
+SCMasterPort::findBackingStore(Addr addr)
+{
+    if (backingStore.empty())
+        backingStore = system->getPhysMem().getBackingStore();
+
+    for (const auto& entry : backingStore) {
+        if (entry.range.contains(addr))
+            return &entry;
+    }
+
+    return nullptr;
+}
+
 bool
 SCMasterPort::get_direct_mem_ptr(tlm::tlm_generic_payload& trans,
                                tlm::tlm_dmi& dmi_data)
 {
-    return false;
+    if (!transactor->isDmiAllowed())
+        return false;
+
+    auto* entry = findBackingStore(trans.get_address());
+    if (entry == nullptr)
+        return false;
+
+    // Memories don't add any latency to functional accesses, so we
+    // don't either. Timing accurate initiators should not use DMI.
+    dmi_data.set_dmi_ptr(entry->pmem);
+    dmi_data.set_start_address(entry->range.start());
+    dmi_data.set_end_address(entry->range.end());
+    dmi_data.allow_read_write();
+    dmi_data.set_read_latency(sc_core::SC_ZERO_TIME);
+    dmi_data.set_write_latency(sc_core::SC_ZERO_TIME);
+
+    return true;
 }
 
 bool
@@ -39,8 +39,10 @@
 
 #include <systemc>
 #include <tlm>
+#include <vector>
 
 #include "mem/external_master.hh"
+#include "mem/physical.hh"
 #include "sc_peq.hh"
 #include "sim_control.hh"
 
@@ -101,6 +103,11 @@ class SCMasterPort : public ExternalMaster::Port
 
     Gem5SimControl& simControl;
 
+    /** Backing store of the system, read on the first DMI request */
+    std::vector<BackingStoreEntry> backingStore;
+
+    const BackingStoreEntry* findBackingStore(Addr addr);
+
   protected:
     // payload event call back
     void peq_cb(tlm::tlm_generic_payload& trans, const tlm::tlm_phase& phase);
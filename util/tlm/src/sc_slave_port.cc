@@ -80,6 +80,59 @@ packet2payload(PacketPtr packet, tlm::tlm_generic_payload &trans)
     }
 }
 
+bool
+SCSlavePort::dmiAccess(PacketPtr packet, sc_core::sc_time& delay)
+{
+    if (!dmiValid || packet->cmd == MemCmd::SwapReq)
+        return false;
+
+    Addr start = packet->getAddr();
+    Addr end = start + packet->getSize() - 1;
+    if (start < dmiData.get_start_address() ||
+        end > dmiData.get_end_address()) {
+        return false;
+    }
+
+    unsigned char *ptr = dmiData.get_dmi_ptr() +
+        (start - dmiData.get_start_address());
+
+    if (packet->isRead()) {
+        if (!dmiData.is_read_allowed())
+            return false;
+        packet->setData(ptr);
+        delay += dmiData.get_read_latency();
+    } else if (packet->isWrite() && !packet->isInvalidate()) {
+        if (!dmiData.is_write_allowed())
+            return false;
+        packet->writeData(ptr);
+        delay += dmiData.get_write_latency();
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+void
+SCSlavePort::requestDmi(tlm::tlm_generic_payload& trans)
+{
+    if (dmiValid || !trans.is_dmi_allowed())
+        return;
+
+    dmiData.init();
+    dmiValid = transactor->socket->get_direct_mem_ptr(trans, dmiData);
+}
+
+void
+SCSlavePort::invalidate_direct_mem_ptr(sc_dt::uint64 start_range,
+                                       sc_dt::uint64 end_range)
+{
+    if (dmiValid && start_range <= dmiData.get_end_address() &&
+        end_range >= dmiData.get_start_address()) {
+        dmiValid = false;
+    }
+}
+
 /**
  * Similar to TLM's blocking transport (LT)
  */
@@ -98,6 +151,12 @@ SCSlavePort::recvAtomic(PacketPtr packet)
 
     sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
 
+    if (dmiAccess(packet, delay)) {
+        if (packet->needsResponse()) {
+            packet->makeResponse();
+        }
+        return delay.value();
+    }
 
     /* Prepare the transaction */
     tlm::tlm_generic_payload * trans = mm.allocate();
@@ -125,6 +184,7 @@ SCSlavePort::recvAtomic(PacketPtr packet)
         packet->makeResponse();
     }
 
+    requestDmi(*trans);
     trans->release();
 
     return delay.value();
@@ -136,6 +196,11 @@ SCSlavePort::recvAtomic(PacketPtr packet)
 void
 SCSlavePort::recvFunctional(PacketPtr packet)
 {
+    sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
+    if (dmiAccess(packet, delay)) {
+        return;
+    }
+
     /* Prepare the transaction */
     tlm::tlm_generic_payload * trans = mm.allocate();
     trans->acquire();
@@ -151,6 +216,7 @@ SCSlavePort::recvFunctional(PacketPtr packet)
         SC_REPORT_FATAL("SCSlavePort","debug transport was not completed");
     }
 
+    requestDmi(*trans);
     trans->release();
 }
 
@@ -369,7 +435,8 @@ SCSlavePort::SCSlavePort(const std::string &name_,
     blockingRequest(NULL),
     needToSendRequestRetry(false),
     blockingResponse(NULL),
-    transactor(nullptr)
+    transactor(nullptr),
+    dmiValid(false)
 {
 }
 
@@ -382,6 +449,8 @@ SCSlavePort::bindToTransactor(Gem5SlaveTransactor* transactor)
 
     transactor->socket.register_nb_transport_bw(this,
                                                 &SCSlavePort::nb_transport_bw);
+    transactor->socket.register_invalidate_direct_mem_ptr(this,
+                                &SCSlavePort::invalidate_direct_mem_ptr);
 }
 
 ExternalSlave::Port*
@@ -67,6 +67,9 @@ class Gem5SlaveTransactor;
  * Then the port issues a TLM transaction in the SystemC world. By storing the
  * original packet as a payload extension, the packet can be restored and send
  * back to the gem5 world upon receiving a response from the SystemC world.
+ *
+ * If a target grants a direct memory interface (DMI) region, atomic and
+ * functional accesses to it bypass the transport interface altogether.
  */
 class SCSlavePort : public ExternalSlave::Port
 {
@@ -105,11 +108,33 @@ class SCSlavePort : public ExternalSlave::Port
 
     Gem5SlaveTransactor* transactor;
 
+    /**
+     * Direct memory region granted by the target. Atomic and
+     * functional accesses that fall into it are served by copying
+     * the data directly instead of calling the transport interface.
+     */
+    tlm::tlm_dmi dmiData;
+    bool dmiValid;
+
+    /**
+     * Try to serve a packet using the direct memory region.
+     *
+     * @param packet Packet to serve
+     * @param delay Annotated delay, updated with the DMI latency
+     * @return true if the packet was served
+     */
+    bool dmiAccess(PacketPtr packet, sc_core::sc_time& delay);
+
+    /** Ask the target for a direct memory region if it offers one. */
+    void requestDmi(tlm::tlm_generic_payload& trans);
+
   public:
     /** The TLM initiator interface */
     tlm::tlm_sync_enum nb_transport_bw(tlm::tlm_generic_payload& trans,
                                        tlm::tlm_phase& phase,
                                        sc_core::sc_time& t);
+    void invalidate_direct_mem_ptr(sc_dt::uint64 start_range,
+                                   sc_dt::uint64 end_range);
 
     SCSlavePort(const std::string &name_,
                 const std::string &systemc_name,